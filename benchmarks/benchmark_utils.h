@@ -0,0 +1,89 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+#include <cstdlib>
+#include <vector>
+#include "rs/core/image_interface.h"
+
+/**
+ * @brief Synthetic frames for the benchmarks.
+ *
+ * Constant or random frames make the codecs and the conversions look either much faster or much slower than they
+ * are on camera frames, so the generated frames mimic the camera content: smooth depth surfaces with edges, noise
+ * and holes, and color gradients with texture. The generator is seeded, so every run measures the same frames.
+ */
+namespace benchmark_utils
+{
+    class frame_generator
+    {
+    public:
+        frame_generator() : m_seed(1) {}
+
+        //a depth image of a slanted wall and a closer box, with sensor noise and zero depth holes
+        std::vector<uint8_t> create_depth_data(int width, int height)
+        {
+            std::vector<uint8_t> data(static_cast<size_t>(width) * height * 2);
+            uint16_t * depth = reinterpret_cast<uint16_t *>(data.data());
+            for(int y = 0; y < height; y++)
+            {
+                int noise = 0;
+                for(int x = 0; x < width; x++)
+                {
+                    //the noise changes in short runs, as the depth of neighboring pixels is correlated
+                    if(x % 8 == 0)
+                        noise = static_cast<int>(next_random() % 9) - 4;
+                    const bool is_box = x > width / 3 && x < width / 2 && y > height / 3 && y < 2 * height / 3;
+                    int value = is_box ? 800 : 1500 + x * 1000 / width;
+                    if(next_random() % 50 == 0)
+                        value = 0;
+                    depth[y * width + x] = static_cast<uint16_t>(value == 0 ? 0 : value + noise);
+                }
+            }
+            return data;
+        }
+
+        //an image of color gradients with a fine texture
+        std::vector<uint8_t> create_color_data(int width, int height, int channels)
+        {
+            std::vector<uint8_t> data(static_cast<size_t>(width) * height * channels);
+            for(int y = 0; y < height; y++)
+            {
+                int texture = 0;
+                for(int x = 0; x < width; x++)
+                {
+                    uint8_t * pixel = &data[(static_cast<size_t>(y) * width + x) * channels];
+                    if(x % 4 == 0)
+                        texture = static_cast<int>(next_random() % 16);
+                    for(int channel = 0; channel < channels; channel++)
+                    {
+                        pixel[channel] = static_cast<uint8_t>((x * 255 / width + y * 255 / height * channel + texture) & 0xff);
+                    }
+                }
+            }
+            return data;
+        }
+
+        //the data of an image of the given format, interleaved yuyv is generated as two channels
+        std::vector<uint8_t> create_data(rs::core::pixel_format format, int width, int height)
+        {
+            switch(format)
+            {
+                case rs::core::pixel_format::z16:
+                case rs::core::pixel_format::y16:
+                    return create_depth_data(width, height);
+                default:
+                    return create_color_data(width, height, rs::core::get_pixel_size(format));
+            }
+        }
+    private:
+        uint32_t m_seed;
+
+        uint32_t next_random()
+        {
+            m_seed = m_seed * 1103515245 + 12345;
+            return (m_seed >> 16) & 0x7fff;
+        }
+    };
+}
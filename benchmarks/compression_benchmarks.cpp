@@ -0,0 +1,98 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "benchmark/benchmark.h"
+#include "benchmark_utils.h"
+#include "compression/lz4_codec.h"
+
+using namespace rs::core;
+using namespace rs::core::file_types;
+
+namespace
+{
+    frame_info create_frame_info(rs_stream stream, rs_format format, int width, int height, int bpp)
+    {
+        frame_info info;
+        memset(&info, 0, sizeof(info));
+        info.width = width;
+        info.height = height;
+        info.format = format;
+        info.bpp = bpp;
+        info.stride = width * bpp;
+        info.stream = stream;
+        info.ctype = compression_type::lz4;
+        return info;
+    }
+
+    std::vector<uint8_t> create_frame_data(const frame_info & info)
+    {
+        benchmark_utils::frame_generator generator;
+        if(info.format == RS_FORMAT_Z16)
+            return generator.create_depth_data(info.width, info.height);
+        return generator.create_color_data(info.width, info.height, info.bpp);
+    }
+
+    //the benchmark argument is the compression level, the label reports the achieved compression ratio
+    void lz4_encode(benchmark::State & state, rs_stream stream, rs_format format, int width, int height, int bpp)
+    {
+        auto info = create_frame_info(stream, format, width, height, bpp);
+        auto input = create_frame_data(info);
+        std::vector<uint8_t> output(input.size());
+        compression::lz4_codec codec(static_cast<rs::record::compression_level>(state.range(0)));
+
+        uint32_t output_size = 0;
+        while(state.KeepRunning())
+        {
+            if(codec.encode(info, input.data(), output.data(), output_size) != status_no_error)
+            {
+                state.SkipWithError("failed to encode the frame");
+                break;
+            }
+            benchmark::DoNotOptimize(output.data());
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * input.size());
+        state.SetLabel("ratio " + std::to_string(output_size > 0 ? static_cast<double>(input.size()) / output_size : 0.));
+    }
+
+    void lz4_decode(benchmark::State & state, rs_stream stream, rs_format format, int width, int height, int bpp)
+    {
+        auto info = create_frame_info(stream, format, width, height, bpp);
+        auto input = create_frame_data(info);
+        std::vector<uint8_t> encoded(input.size());
+        compression::lz4_codec codec(static_cast<rs::record::compression_level>(state.range(0)));
+
+        uint32_t encoded_size = 0;
+        if(codec.encode(info, input.data(), encoded.data(), encoded_size) != status_no_error)
+        {
+            state.SkipWithError("failed to encode the frame");
+        }
+        auto frame = std::make_shared<frame_sample>(info, 0);
+        while(state.KeepRunning())
+        {
+            auto decoded = codec.decode(frame, encoded.data(), encoded_size);
+            if(!decoded)
+            {
+                state.SkipWithError("failed to decode the frame");
+                break;
+            }
+            benchmark::DoNotOptimize(decoded->data);
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * input.size());
+    }
+}
+
+#define LZ4_LEVELS Arg(rs::record::compression_level::low)->Arg(rs::record::compression_level::medium)->Arg(rs::record::compression_level::high)
+
+BENCHMARK_CAPTURE(lz4_encode, depth_z16, RS_STREAM_DEPTH, RS_FORMAT_Z16, 628, 468, 2)->LZ4_LEVELS;
+BENCHMARK_CAPTURE(lz4_encode, color_rgb8, RS_STREAM_COLOR, RS_FORMAT_RGB8, 640, 480, 3)->LZ4_LEVELS;
+BENCHMARK_CAPTURE(lz4_encode, color_rgb8_full_hd, RS_STREAM_COLOR, RS_FORMAT_RGB8, 1920, 1080, 3)->LZ4_LEVELS;
+BENCHMARK_CAPTURE(lz4_encode, infrared_y8, RS_STREAM_INFRARED, RS_FORMAT_Y8, 640, 480, 1)->LZ4_LEVELS;
+
+BENCHMARK_CAPTURE(lz4_decode, depth_z16, RS_STREAM_DEPTH, RS_FORMAT_Z16, 628, 468, 2)->LZ4_LEVELS;
+BENCHMARK_CAPTURE(lz4_decode, color_rgb8, RS_STREAM_COLOR, RS_FORMAT_RGB8, 640, 480, 3)->LZ4_LEVELS;
+BENCHMARK_CAPTURE(lz4_decode, color_rgb8_full_hd, RS_STREAM_COLOR, RS_FORMAT_RGB8, 1920, 1080, 3)->LZ4_LEVELS;
+BENCHMARK_CAPTURE(lz4_decode, infrared_y8, RS_STREAM_INFRARED, RS_FORMAT_Y8, 640, 480, 1)->LZ4_LEVELS;
@@ -0,0 +1,115 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include "benchmark/benchmark.h"
+#include "disk_read_factory.h"
+
+using namespace rs::core;
+using namespace rs::playback;
+
+namespace
+{
+    /**
+     * @brief Opens the recording the benchmarks read, set by the RS_BENCHMARK_FILE environment variable.
+     *
+     * The index benchmarks depend on the recording length and streams, so the results are comparable only between runs
+     * of the same recording. The benchmarks are skipped when no recording is set.
+     */
+    bool open_recording(benchmark::State & state, std::unique_ptr<disk_read_interface> & disk_read)
+    {
+        const char * file_path = std::getenv("RS_BENCHMARK_FILE");
+        if(!file_path)
+        {
+            state.SkipWithError("RS_BENCHMARK_FILE is not set");
+            return false;
+        }
+        if(disk_read_factory::create_disk_read(file_path, disk_read) != status_no_error)
+        {
+            state.SkipWithError((std::string("failed to open ") + file_path).c_str());
+            return false;
+        }
+        return true;
+    }
+
+    //the stream with the most frames, its last frame is indexed last
+    rs_stream query_longest_stream(disk_read_interface & disk_read, uint32_t & frames_count)
+    {
+        rs_stream longest_stream = RS_STREAM_COUNT;
+        frames_count = 0;
+        for(auto & stream_info : disk_read.get_streams_infos())
+        {
+            auto stream_frames_count = disk_read.query_number_of_frames(stream_info.first);
+            if(stream_frames_count > frames_count)
+            {
+                frames_count = stream_frames_count;
+                longest_stream = stream_info.first;
+            }
+        }
+        return longest_stream;
+    }
+
+    //reads the file headers and loads the stored samples index
+    void disk_read_open(benchmark::State & state)
+    {
+        std::unique_ptr<disk_read_interface> disk_read;
+        if(!open_recording(state, disk_read))
+            return;
+        while(state.KeepRunning())
+        {
+            open_recording(state, disk_read);
+            disk_read.reset();
+        }
+    }
+
+    //opens the file and indexes the samples up to the last frame
+    void disk_read_index(benchmark::State & state)
+    {
+        std::unique_ptr<disk_read_interface> disk_read;
+        if(!open_recording(state, disk_read))
+            return;
+        uint32_t frames_count = 0;
+        auto stream = query_longest_stream(*disk_read, frames_count);
+        if(frames_count == 0)
+        {
+            state.SkipWithError("the recording has no frames");
+            return;
+        }
+        while(state.KeepRunning())
+        {
+            open_recording(state, disk_read);
+            auto frames = disk_read->set_frame_by_index(frames_count - 1, stream);
+            benchmark::DoNotOptimize(frames);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * frames_count);
+    }
+
+    //seeks to frames spread over an indexed recording
+    void disk_read_seek(benchmark::State & state)
+    {
+        std::unique_ptr<disk_read_interface> disk_read;
+        if(!open_recording(state, disk_read))
+            return;
+        uint32_t frames_count = 0;
+        auto stream = query_longest_stream(*disk_read, frames_count);
+        if(frames_count == 0)
+        {
+            state.SkipWithError("the recording has no frames");
+            return;
+        }
+        disk_read->set_frame_by_index(frames_count - 1, stream);
+        uint32_t index = 0;
+        while(state.KeepRunning())
+        {
+            index = (index + 7919) % frames_count;
+            auto frames = disk_read->set_frame_by_index(index, stream);
+            benchmark::DoNotOptimize(frames);
+        }
+    }
+}
+
+BENCHMARK(disk_read_open)->Unit(benchmark::kMicrosecond);
+BENCHMARK(disk_read_index)->Unit(benchmark::kMillisecond);
+BENCHMARK(disk_read_seek)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,52 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <vector>
+#include "benchmark/benchmark.h"
+#include "benchmark_utils.h"
+#include "image_conversion_util.h"
+
+using namespace rs::core;
+
+namespace
+{
+    //the arguments are the image width and height
+    void convert(benchmark::State & state, pixel_format src_format, pixel_format dst_format)
+    {
+        const int width = static_cast<int>(state.range(0));
+        const int height = static_cast<int>(state.range(1));
+        image_info src_info = { width, height, src_format, width * get_pixel_size(src_format) };
+        image_info dst_info = { width, height, dst_format, width * get_pixel_size(dst_format) };
+        auto src_data = benchmark_utils::frame_generator().create_data(src_format, width, height);
+        std::vector<uint8_t> dst_data(static_cast<size_t>(dst_info.pitch) * height);
+
+        while(state.KeepRunning())
+        {
+            if(image_conversion_util::convert(src_info, src_data.data(), dst_info, dst_data.data()) != status_no_error)
+            {
+                state.SkipWithError("unsupported conversion");
+                break;
+            }
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * width * height);
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * (src_data.size() + dst_data.size()));
+    }
+}
+
+#define DEPTH_SIZES Args({ 320, 240 })->Args({ 628, 468 })
+#define COLOR_SIZES Args({ 640, 480 })->Args({ 1920, 1080 })
+
+BENCHMARK_CAPTURE(convert, z16_to_rgb8, pixel_format::z16, pixel_format::rgb8)->DEPTH_SIZES;
+BENCHMARK_CAPTURE(convert, z16_to_bgra8, pixel_format::z16, pixel_format::bgra8)->DEPTH_SIZES;
+BENCHMARK_CAPTURE(convert, y16_to_rgb8, pixel_format::y16, pixel_format::rgb8)->DEPTH_SIZES;
+BENCHMARK_CAPTURE(convert, y8_to_rgb8, pixel_format::y8, pixel_format::rgb8)->DEPTH_SIZES;
+BENCHMARK_CAPTURE(convert, y8_to_bgra8, pixel_format::y8, pixel_format::bgra8)->DEPTH_SIZES;
+BENCHMARK_CAPTURE(convert, yuyv_to_rgb8, pixel_format::yuyv, pixel_format::rgb8)->COLOR_SIZES;
+BENCHMARK_CAPTURE(convert, yuyv_to_bgra8, pixel_format::yuyv, pixel_format::bgra8)->COLOR_SIZES;
+BENCHMARK_CAPTURE(convert, yuyv_to_y8, pixel_format::yuyv, pixel_format::y8)->COLOR_SIZES;
+BENCHMARK_CAPTURE(convert, rgb8_to_bgr8, pixel_format::rgb8, pixel_format::bgr8)->COLOR_SIZES;
+BENCHMARK_CAPTURE(convert, rgb8_to_bgra8, pixel_format::rgb8, pixel_format::bgra8)->COLOR_SIZES;
+BENCHMARK_CAPTURE(convert, rgb8_to_y8, pixel_format::rgb8, pixel_format::y8)->COLOR_SIZES;
+BENCHMARK_CAPTURE(convert, bgra8_to_rgb8, pixel_format::bgra8, pixel_format::rgb8)->COLOR_SIZES;
+BENCHMARK_CAPTURE(convert, bgra8_to_y8, pixel_format::bgra8, pixel_format::y8)->COLOR_SIZES;
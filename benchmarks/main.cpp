@@ -0,0 +1,6 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "benchmark/benchmark.h"
+
+BENCHMARK_MAIN()
@@ -0,0 +1,153 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <vector>
+#include "benchmark/benchmark.h"
+#include "benchmark_utils.h"
+#include "math_projection_interface.h"
+
+using namespace rs::core;
+
+namespace
+{
+    //r200 like calibration, the color camera is normalized to the image size as for the uvmap. the camera parameters are ordered as focal x, principal x, focal y, principal y
+    struct calibration
+    {
+        float depth_camera[4];
+        float color_camera[4];
+        float color_distortion[5];
+        float rotation[9];
+        float translation[3];
+
+        explicit calibration(sizeI32 depth_size) :
+            depth_camera{ static_cast<float>(depth_size.width) * 0.75f, static_cast<float>(depth_size.width) / 2.f,
+                          static_cast<float>(depth_size.width) * 0.75f, static_cast<float>(depth_size.height) / 2.f },
+            color_camera{ 0.9f, 0.5f, 1.2f, 0.5f },
+            color_distortion{ 0.1f, -0.25f, 0.001f, 0.001f, 0.1f },
+            rotation{ 0.9999f, 0.0087f, -0.0087f, -0.0086f, 0.9999f, 0.0087f, 0.0088f, -0.0086f, 0.9999f },
+            translation{ 58.f, 0.3f, 0.5f } {}
+    };
+
+    sizeI32 depth_size_of(const benchmark::State & state)
+    {
+        return { static_cast<int32_t>(state.range(0)), static_cast<int32_t>(state.range(1)) };
+    }
+
+    //the projection spec, the rays of the depth pixels, is built once per depth size and reused by the depth projections
+    std::vector<float> create_projection_spec(math_projection & projection, sizeI32 depth_size, calibration & calib)
+    {
+        int spec_size = 0;
+        projection.rs_projection_get_size_32f(depth_size, &spec_size);
+        std::vector<float> spec((spec_size + sizeof(float) - 1) / sizeof(float));
+        projection.rs_projection_init_32f(depth_size, calib.depth_camera, nullptr, reinterpret_cast<projection_spec_32f *>(spec.data()));
+        return spec;
+    }
+
+    void projection_init(benchmark::State & state)
+    {
+        math_projection projection;
+        auto depth_size = depth_size_of(state);
+        calibration calib(depth_size);
+        int spec_size = 0;
+        projection.rs_projection_get_size_32f(depth_size, &spec_size);
+        std::vector<float> spec((spec_size + sizeof(float) - 1) / sizeof(float));
+        while(state.KeepRunning())
+        {
+            projection.rs_projection_init_32f(depth_size, calib.depth_camera, nullptr, reinterpret_cast<projection_spec_32f *>(spec.data()));
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * depth_size.width * depth_size.height);
+    }
+
+    void depth_to_vertices(benchmark::State & state)
+    {
+        math_projection projection;
+        auto depth_size = depth_size_of(state);
+        calibration calib(depth_size);
+        auto spec = create_projection_spec(projection, depth_size, calib);
+        auto depth = benchmark_utils::frame_generator().create_depth_data(depth_size.width, depth_size.height);
+        std::vector<point3dF32> vertices(depth_size.width * depth_size.height);
+        while(state.KeepRunning())
+        {
+            projection.rs_projection_16u32f_c1cxr(reinterpret_cast<const unsigned short *>(depth.data()), depth_size, depth_size.width * 2,
+                                                  reinterpret_cast<float *>(vertices.data()), depth_size.width * static_cast<int>(sizeof(point3dF32)),
+                                                  nullptr, nullptr, nullptr, nullptr, reinterpret_cast<const projection_spec_32f *>(spec.data()));
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * depth_size.width * depth_size.height);
+    }
+
+    void depth_to_uvmap(benchmark::State & state)
+    {
+        math_projection projection;
+        auto depth_size = depth_size_of(state);
+        calibration calib(depth_size);
+        auto spec = create_projection_spec(projection, depth_size, calib);
+        auto depth = benchmark_utils::frame_generator().create_depth_data(depth_size.width, depth_size.height);
+        std::vector<pointF32> uvmap(depth_size.width * depth_size.height);
+        while(state.KeepRunning())
+        {
+            projection.rs_projection_16u32f_c1cxr(reinterpret_cast<const unsigned short *>(depth.data()), depth_size, depth_size.width * 2,
+                                                  reinterpret_cast<float *>(uvmap.data()), depth_size.width * static_cast<int>(sizeof(pointF32)),
+                                                  calib.rotation, calib.translation, calib.color_distortion, calib.color_camera,
+                                                  reinterpret_cast<const projection_spec_32f *>(spec.data()));
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * depth_size.width * depth_size.height);
+    }
+
+    //the argument is the number of points
+    void depth_points_to_color(benchmark::State & state)
+    {
+        math_projection projection;
+        const int points_count = static_cast<int>(state.range(0));
+        calibration calib({ 628, 468 });
+        std::vector<point3dF32> uvz(points_count);
+        for(int i = 0; i < points_count; i++)
+        {
+            uvz[i] = { static_cast<float>(i % 628), static_cast<float>(i / 628 % 468), 1000.f + static_cast<float>(i % 1000) };
+        }
+        std::vector<pointF32> color_points(points_count);
+        while(state.KeepRunning())
+        {
+            projection.rs_3d_array_projection_32f(reinterpret_cast<const float *>(uvz.data()), reinterpret_cast<float *>(color_points.data()), points_count,
+                                                  calib.depth_camera, nullptr, calib.rotation, calib.translation, calib.color_distortion, calib.color_camera);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * points_count);
+    }
+
+    void remap_depth(benchmark::State & state)
+    {
+        math_projection projection;
+        auto depth_size = depth_size_of(state);
+        const sizeI32 color_size = { 640, 480 };
+        auto depth = benchmark_utils::frame_generator().create_depth_data(depth_size.width, depth_size.height);
+        //a slightly scaled and shifted map, as the inverted uvmap of an aligned color camera
+        std::vector<pointF32> map(color_size.width * color_size.height);
+        for(int y = 0; y < color_size.height; y++)
+        {
+            for(int x = 0; x < color_size.width; x++)
+            {
+                map[y * color_size.width + x] = { static_cast<float>(x) * 0.95f + 10.f, static_cast<float>(y) * 0.95f + 5.f };
+            }
+        }
+        std::vector<uint16_t> remapped(color_size.width * color_size.height);
+        while(state.KeepRunning())
+        {
+            projection.rs_remap_16u_c1r(reinterpret_cast<const unsigned short *>(depth.data()), depth_size, depth_size.width * 2,
+                                        reinterpret_cast<const float *>(map.data()), color_size.width * static_cast<int>(sizeof(pointF32)),
+                                        remapped.data(), color_size, color_size.width * 2, 0, 0);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * color_size.width * color_size.height);
+    }
+}
+
+#define DEPTH_SIZES Args({ 320, 240 })->Args({ 480, 360 })->Args({ 628, 468 })
+
+BENCHMARK(projection_init)->DEPTH_SIZES;
+BENCHMARK(depth_to_vertices)->DEPTH_SIZES;
+BENCHMARK(depth_to_uvmap)->DEPTH_SIZES;
+BENCHMARK(depth_points_to_color)->Arg(1)->Arg(64)->Arg(4096)->Arg(628 * 468);
+BENCHMARK(remap_depth)->DEPTH_SIZES;
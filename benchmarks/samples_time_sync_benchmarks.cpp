@@ -0,0 +1,106 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "benchmark/benchmark.h"
+#include "rs/core/image_interface.h"
+#include "rs/utils/samples_time_sync_interface.h"
+#include "rs/utils/smart_ptr_helpers.h"
+
+using namespace rs::core;
+using namespace rs::utils;
+
+namespace
+{
+    const int SECONDS_OF_SAMPLES = 4;
+
+    /**
+     * @brief The images of a few seconds of depth and color streaming, in arrival order.
+     *
+     * The timestamps of both streams are multiples of the tick of the faster stream, so the frames of the same time are
+     * equal, as the camera hardware sync makes them. The images carry no data, the sync only reads their metadata.
+     */
+    class streaming_images
+    {
+    public:
+        streaming_images(int depth_fps, int color_fps)
+        {
+            const int ticks_fps = std::max(depth_fps, color_fps);
+            const double tick_ms = 1000. / ticks_fps;
+            uint64_t frame_numbers[static_cast<int>(stream_type::max)] = {};
+            for(int tick = 0; tick < SECONDS_OF_SAMPLES * ticks_fps; tick++)
+            {
+                const double time_stamp = tick * tick_ms;
+                if(tick % (ticks_fps / depth_fps) == 0)
+                    add_image(stream_type::depth, time_stamp, frame_numbers[static_cast<int>(stream_type::depth)]++);
+                if(tick % (ticks_fps / color_fps) == 0)
+                    add_image(stream_type::color, time_stamp, frame_numbers[static_cast<int>(stream_type::color)]++);
+            }
+        }
+
+        ~streaming_images()
+        {
+            for(auto image : m_images)
+            {
+                image->release();
+            }
+        }
+
+        const std::vector<image_interface *> & images() const { return m_images; }
+    private:
+        std::vector<image_interface *> m_images;
+
+        void add_image(stream_type stream, double time_stamp, uint64_t frame_number)
+        {
+            image_info info = {};
+            m_images.push_back(image_interface::create_instance_from_raw_data(&info, { nullptr, nullptr }, stream, image_interface::flag::any,
+                                                                              time_stamp, frame_number));
+        }
+    };
+
+    //the arguments are the depth and the color frame rates, the faster rate must be a multiple of the slower
+    void samples_time_sync_insert(benchmark::State & state)
+    {
+        const int depth_fps = static_cast<int>(state.range(0));
+        const int color_fps = static_cast<int>(state.range(1));
+        int streams_fps[static_cast<int>(stream_type::max)] = {};
+        int motions_fps[static_cast<int>(motion_type::max)] = {};
+        streams_fps[static_cast<int>(stream_type::depth)] = depth_fps;
+        streams_fps[static_cast<int>(stream_type::color)] = color_fps;
+        auto samples_sync = get_unique_ptr_with_releaser(samples_time_sync_interface::create_instance(streams_fps, motions_fps, "Intel RealSense ZR300"));
+
+        streaming_images streaming(depth_fps, color_fps);
+        auto & images = streaming.images();
+        size_t next_image = 0;
+        int64_t matched_sets_count = 0;
+        correlated_sample_set sample_set = {};
+        while(state.KeepRunning())
+        {
+            //the timestamps restart with the recorded images, as after a stream restart
+            if(next_image == images.size())
+            {
+                samples_sync->flush();
+                next_image = 0;
+            }
+            if(samples_sync->insert(images[next_image++], sample_set))
+            {
+                matched_sets_count++;
+                for(int i = 0; i < static_cast<int>(stream_type::max); i++)
+                {
+                    if(sample_set.images[i])
+                    {
+                        sample_set.images[i]->release();
+                        sample_set.images[i] = nullptr;
+                    }
+                }
+            }
+        }
+        samples_sync->flush();
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+        state.SetLabel(std::to_string(matched_sets_count) + " matched sets");
+    }
+}
+
+BENCHMARK(samples_time_sync_insert)->Args({ 30, 30 })->Args({ 60, 30 })->Args({ 60, 60 })->Args({ 90, 30 })->Args({ 200, 200 });
@@ -7,8 +7,10 @@
 */
 
 #pragma once
+#include <memory>
 #include <librealsense/rs.hpp>
 #include "context_interface.h"
+#include "device_registry.h"
 
 namespace rs
 {
@@ -17,12 +19,14 @@ namespace rs
         /**
         * @brief Implements \c rs::core::context_interface for live camera streaming. 
         *
-		* See the interface class for more details.
+		* See the interface class for more details. The contexts share the devices enumeration of \c device_registry, so a context
+        * which is created while another context is alive doesn't enumerate the devices, unless a device was connected or disconnected.
+        * The devices are closed once all the contexts are released. The context is implemented over the realsense_lrs_image library.
         */
         class context : public context_interface
         {
         public:
-            context() {}
+            context() : m_context(device_registry::acquire()) {}
             virtual ~context() {}
 
             /**
@@ -34,7 +38,7 @@ namespace rs
             */
             virtual int get_device_count() const override
             {
-                return m_context.get_device_count();
+                return m_context->get_device_count();
             }
 
             /**
@@ -47,11 +51,11 @@ namespace rs
             */
             virtual rs::device * get_device(int index) override
             {
-                return m_context.get_device(index);
+                return m_context->get_device(index);
             }
 
         protected:
-            rs::context m_context; /**< the actual libRealSense context. */
+            std::shared_ptr<rs::context> m_context; /**< the actual libRealSense context, shared by the contexts of the same devices enumeration. */
             context(const context &) = delete;
             context & operator = (const context &) = delete;
         };
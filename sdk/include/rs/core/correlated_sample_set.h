@@ -21,14 +21,24 @@ namespace rs
         * A container for synced device samples.
 		*
         * It contains at most a single image of each camera stream, and at most a single motion sample for each motion type.
+        * A time synced sample set also refers to the batch of all the motion samples of each motion type received since the
+        * previous time synced sample set, so high rate motion samples matched with the images aren't lost.
         */
         struct correlated_sample_set
         {
-            inline correlated_sample_set() : images(), motion_samples() {}
+            inline correlated_sample_set() : images(), motion_samples(), motion_batches(), motion_batch_sizes() {}
 
             image_interface* images[static_cast<uint8_t>(stream_type::max)];      /**< images of the correlated sample, index by stream_type             */
             motion_sample motion_samples[static_cast<uint8_t>(motion_type::max)]; /**< motion samples of the correlated sample set, index by motion_type */
 
+            /**
+            * The motion samples received since the previous sample set, in their arrival order, up to the sample of \c motion_samples,
+            * index by motion_type, null if the sample set holds no batch. The samples are owned by the producer of the sample set:
+            * the batches of the sample sets passed to the video modules are valid as long as the sample set is held.
+            */
+            const motion_sample* motion_batches[static_cast<uint8_t>(motion_type::max)];
+            uint32_t motion_batch_sizes[static_cast<uint8_t>(motion_type::max)];  /**< number of samples of each motion batch, index by motion_type   */
+
             /**
              * @brief Accesses image indexed by stream
              *
@@ -90,6 +100,19 @@ namespace rs
             {
                 return motion_samples[static_cast<uint8_t>(motion_type)];
             }
+
+            /**
+             * @brief Returns the batch of the motion samples of \c motion_type received since the previous sample set.
+             *
+             * @param[in]  motion_type Motion type
+             * @param[out] samples     The first sample of the batch, null if the sample set holds no batch of \c motion_type
+             * @return uint32_t Number of samples of the batch
+             */
+            inline uint32_t get_motion_batch(rs::core::motion_type motion_type, const motion_sample** samples) const
+            {
+                *samples = motion_batches[static_cast<uint8_t>(motion_type)];
+                return motion_batch_sizes[static_cast<uint8_t>(motion_type)];
+            }
         };
     }
 }
@@ -0,0 +1,76 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file device_buffer_interface.h
+* @brief Describes the \c rs::core::device_buffer_interface class.
+*/
+
+#pragma once
+#include <stdint.h>
+#include "rs/core/ref_count_interface.h"
+#include "rs/core/status.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief The compute APIs of the device buffers.
+        */
+        enum class device_api : int32_t
+        {
+            cuda   = 0,   /**< The handle is a \c CUdeviceptr */
+            opencl = 1,   /**< The handle is a \c cl_mem */
+            vulkan = 2,   /**< The handle is a \c VkBuffer */
+            max
+        };
+
+        /**
+        * @brief Image data in the memory of a compute device, such as a GPU.
+        *
+        * The SDK doesn't depend on the compute APIs, the buffer is implemented by the module or the application which allocates it,
+        * over its API objects. The buffer holds the rows of an image, of its pitch, from the start of the device allocation.
+        * The buffer is reference counted, each image which carries it holds a reference.
+        */
+        class device_buffer_interface : public ref_count_interface
+        {
+        public:
+            /**
+            * @brief Returns the compute API of the buffer.
+            */
+            virtual device_api query_api() const = 0;
+
+            /**
+            * @brief Returns the API handle of the buffer, \c CUdeviceptr, \c cl_mem or \c VkBuffer, as an integer.
+            */
+            virtual uint64_t query_handle() const = 0;
+
+            /**
+            * @brief Returns the API object the buffer belongs to, a \c CUcontext, a \c cl_context or a \c VkDevice, for the users to check they
+            *        share it with the buffer before using the handle.
+            */
+            virtual void * query_context() const = 0;
+
+            /**
+            * @brief Returns the pitch of the buffer rows, in bytes.
+            */
+            virtual int32_t query_pitch() const = 0;
+
+            /**
+            * @brief Copies the buffer rows to host memory, the copy is complete when the method returns.
+            *
+            * @param[in]  height                  The number of rows to copy
+            * @param[in]  row_size                The bytes of each row to copy
+            * @param[out] host_data               The host memory of the rows
+            * @param[in]  host_pitch              The pitch of the host rows, in bytes
+            * @return status_no_error             Successful execution
+            * @return status_exec_aborted         The device failed to copy the buffer
+            */
+            virtual status download(int32_t height, int32_t row_size, void * host_data, int32_t host_pitch) const = 0;
+        protected:
+            //force deletion using the release function
+            virtual ~device_buffer_interface() {}
+        };
+    }
+}
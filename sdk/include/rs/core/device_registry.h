@@ -0,0 +1,48 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file device_registry.h
+* @brief Describes the \c rs::core::device_registry class.
+*/
+
+#pragma once
+#include <memory>
+#include <librealsense/rs.hpp>
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief The devices enumeration shared by the live contexts of the process.
+        *
+        * Enumerating the devices through librealsense waits on the USB enumeration. The registry shares the librealsense context of the
+        * last enumeration between the contexts which are alive together, so a context created while another context is alive, by a
+        * reconfigured pipeline for example, gets its devices without enumerating them. The registry doesn't own the enumeration, it's
+        * released with its devices once its last context is released, so the devices aren't kept open by an unused enumeration.
+        * The shared enumeration is invalidated when a camera is connected or disconnected, which is detected by the video device nodes
+        * of the system on Linux, and by the application calling \c invalidate() on other platforms. librealsense keeps a single context
+        * per process, so the devices are enumerated again only once the contexts of the previous enumeration are released, until then
+        * the new contexts share the previous devices, unregistered.
+        * The registry is implemented by the realsense_lrs_image library.
+        */
+        class device_registry
+        {
+        public:
+            /**
+            * @brief Returns the librealsense context of the current devices, enumerating them if no context shares the current devices.
+            * @return std::shared_ptr<rs::context> The context, which owns its devices until it's released by all its users
+            */
+            static std::shared_ptr<rs::context> acquire();
+
+            /**
+            * @brief Drops the shared enumeration, the next context enumerates the devices once the current contexts are released.
+            */
+            static void invalidate();
+
+        private:
+            device_registry() = delete;
+        };
+    }
+}
@@ -0,0 +1,142 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file fisheye_projection_interface.h
+* @brief
+* Describes the \c rs::core::fisheye_projection_interface class.
+*
+* Defines the projection of the fisheye camera and the rectification of its images to a pinhole camera.
+*/
+
+#pragma once
+#include "rs/core/status.h"
+#include "rs/core/types.h"
+#include "rs/core/image_interface.h"
+
+#ifdef WIN32
+#ifdef realsense_projection_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_projection_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+DLL_EXPORT extern "C" {
+    void*  rs_projection_create_fisheye_instance_from_intrinsics(rs::core::intrinsics *fisheyeIntrinsics, rs::core::intrinsics *rectifiedIntrinsics);
+}
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * \brief
+        * Defines the projection to and the unprojection from the real world of the fisheye camera, and the rectification of the fisheye
+        * images to a pinhole camera.
+        *
+        * The fisheye camera is described by the f-theta (FOV) model, the \c distortion_ftheta intrinsics, whose first coefficient is the
+        * field of view parameter w in radians: a ray at the normalized radius r of the optical axis is imaged at the normalized radius
+        * <tt>atan(2 r tan(w / 2)) / w</tt>. The model maps the rays in front of the camera plane.
+        *
+        * The rectification maps the fisheye pixels to the pixels of a pinhole camera, which shares the fisheye camera coordinate system.
+        * The fisheye pixel of each rectified pixel is computed once, when the instance is created, and the remap of an image only samples
+        * the precomputed source pixels, so the images can be rectified at the stream rate. The 8 bit images are interpolated
+        * bilinearly, the 16 bit images take the nearest pixel. The rectified pixels outside of the fisheye image are zero.
+        *
+        * Call the \c rs::core::fisheye_projection_interface::create_instance() method to create an instance of this interface.
+        * An instance can be shared by threads once it's created.
+        */
+        class DLL_EXPORT fisheye_projection_interface : public release_interface
+        {
+        public:
+            /**
+            * @brief Projects camera coordinates to fisheye pixel coordinates.
+            *
+            * @param[in]  npoints                 Number of points to be projected
+            * @param[in]  pos3d                   Array of the points in the fisheye camera coordinates, in any unit
+            * @param[out] pos_ij                  Array of the fisheye pixel coordinates, (-1, -1) for a point on or behind the camera plane
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid in or out array passed as parameter
+            * @return status_data_not_initialized \c npoints is not positive
+            */
+            virtual status project_camera_to_fisheye(int32_t npoints, point3dF32 *pos3d, pointF32 *pos_ij) = 0;
+
+            /**
+            * @brief Unprojects fisheye pixel coordinates and their depths to camera coordinates.
+            *
+            * The depth of a pixel is the distance of its point along the optical axis.
+            * @param[in]  npoints                 Number of pixels to be unprojected
+            * @param[in]  pos_ijz                 Array of the fisheye pixel coordinates and their depths
+            * @param[out] pos3d                   Array of the points in the fisheye camera coordinates, in the depth unit, (0, 0, 0) for a pixel
+            *                                     which the model doesn't map to a ray in front of the camera
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid in or out array passed as parameter
+            * @return status_data_not_initialized \c npoints is not positive
+            */
+            virtual status project_fisheye_to_camera(int32_t npoints, point3dF32 *pos_ijz, point3dF32 *pos3d) = 0;
+
+            /**
+            * @brief Returns the intrinsics of the pinhole camera of the rectified images.
+            *
+            * @param[out] rectified               The rectified camera intrinsics, whose model is \c distortion_none
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid out parameter
+            */
+            virtual status query_rectified_intrinsics(intrinsics *rectified) = 0;
+
+            /**
+            * @brief Returns the fisheye pixel coordinates of each rectified pixel.
+            *
+            * @param[out] map                     The fisheye pixel coordinates of the rectified image pixels, of the rectified image size
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid out array passed as parameter
+            */
+            virtual status query_rectification_map(pointF32 *map) = 0;
+
+            /**
+            * @brief Creates a rectified image of a fisheye image.
+            *
+            * The rectified image has the size of the rectified intrinsics, the format, the stream, the time stamp and the frame number of
+            * the fisheye image. Its data is recycled by the instance once the image is released.
+            * @param[in]  fisheye                 The fisheye image, of the fisheye intrinsics size, in the \c raw8, \c y8 or \c y16 format
+            * @return image_interface*            The rectified image
+            * @return nullptr                     The image isn't of the fisheye intrinsics size or of a supported format
+            */
+            virtual image_interface* create_rectified_image(image_interface *fisheye) = 0;
+
+            /**
+            * @brief Creates a rectified image of a fisheye image in the given data.
+            *
+            * As \c create_rectified_image, with the rectified pixels written to the caller's data, which must outlive the image.
+            * @param[in]  fisheye                 The fisheye image, of the fisheye intrinsics size, in the \c raw8, \c y8 or \c y16 format
+            * @param[out] data                    The rectified image data, of the rectified image height times the pitch
+            * @param[in]  pitch                   The rectified image pitch in bytes, at least the rectified image width times the pixel size
+            * @return image_interface*            The rectified image
+            * @return nullptr                     The image isn't of the fisheye intrinsics size or of a supported format, or the data is
+            *                                     null or the pitch is too small
+            */
+            virtual image_interface* create_rectified_image(image_interface *fisheye, uint8_t *data, int32_t pitch) = 0;
+
+            /**
+            * @brief Creates an instance, based on the fisheye camera intrinsics and the rectified camera intrinsics.
+            *
+            * @param[in] fisheyeIntrinsics        The fisheye camera intrinsics, of the \c distortion_ftheta model
+            * @param[in] rectifiedIntrinsics      The pinhole camera intrinsics of the rectified images, of the \c distortion_none model.
+            *                                     nullptr rectifies to a pinhole camera of the fisheye image size, principal point and focal
+            *                                     lengths, which keeps the resolution of the image center
+            * @return fisheye_projection_interface* Instance of fisheye_projection_interface
+            * @return nullptr                     The intrinsics are null or not of the supported models
+            */
+            static __inline fisheye_projection_interface* create_instance(rs::core::intrinsics *fisheyeIntrinsics, rs::core::intrinsics *rectifiedIntrinsics = nullptr)
+            {
+                return (fisheye_projection_interface*)rs_projection_create_fisheye_instance_from_intrinsics(fisheyeIntrinsics, rectifiedIntrinsics);
+            }
+        protected:
+            //force deletion using the release function
+            virtual ~fisheye_projection_interface() {}
+        };
+    }
+}
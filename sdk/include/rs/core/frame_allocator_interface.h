@@ -0,0 +1,144 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file frame_allocator_interface.h
+* @brief Describes the \c rs::core::frame_allocator_interface class and the \c rs::core::frame_buffer class.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Allocates the data buffers of the images and frames the SDK creates.
+        *
+        * The SDK allocates the buffers of the converted images, of the mapped images of the projection, of the decoded playback
+        * frames and of the uncompressed playback frames through the process frame allocator. Setting the process allocator tunes
+        * the frame memory, for example to pinned memory for GPU uploads or to node local memory on multi-socket servers,
+        * without changing the call sites. The SDK provides built-in allocators, and an application may implement its own.
+        */
+        class frame_allocator_interface
+        {
+        public:
+            /**
+            * @brief The built-in frame allocators.
+            */
+            enum class builtin
+            {
+                heap,            /**< The C++ heap, the default process allocator */
+                size_class_pool, /**< Reuses the freed buffers of the same size class, a quarter of a power of two apart, keeps up to 64MB of free buffers */
+                huge_pages,      /**< Maps 2MB huge pages, or transparent huge pages if none are reserved, rounds the buffers up to 2MB */
+                numa_local,      /**< Faults the pages in on the allocating thread, so they're on its NUMA node with the default memory policy */
+                pinned           /**< Locks the pages in physical memory, so a device may DMA from them. Falls back to unlocked pages above the lock limit */
+            };
+
+            /**
+            * @brief Allocates a buffer of at least \c size bytes, aligned to 64 bytes.
+            *
+            * May be called from any thread.
+            * @param[in] size     Buffer size in bytes
+            * @return void *      The buffer, null if the allocation failed
+            */
+            virtual void * allocate(size_t size) = 0;
+
+            /**
+            * @brief Frees a buffer returned by \c allocate.
+            *
+            * May be called from any thread.
+            * @param[in] data     The buffer
+            * @param[in] size     The size the buffer was allocated with
+            */
+            virtual void deallocate(void * data, size_t size) = 0;
+
+            /**
+            * @brief Returns a built-in allocator, which lives as long as the process.
+            *
+            * On platforms which don't support the allocator memory, the heap allocator is returned.
+            * @param[in] type                          The built-in allocator
+            * @return frame_allocator_interface *      The allocator
+            */
+            static frame_allocator_interface * get_builtin(builtin type);
+
+            /**
+            * @brief Sets the allocator of the buffers the SDK allocates from now on.
+            *
+            * A buffer is freed by the allocator it was allocated with, so the allocator must outlive the images and frames
+            * of the buffers it allocated, typically it lives as long as the process.
+            * @param[in] allocator     The process allocator, null restores the heap allocator
+            */
+            static void set_process_allocator(frame_allocator_interface * allocator);
+
+            /**
+            * @brief Returns the allocator of the buffers the SDK allocates.
+            *
+            * @return frame_allocator_interface *      The process allocator
+            */
+            static frame_allocator_interface * get_process_allocator();
+
+        protected:
+            virtual ~frame_allocator_interface() {}
+        };
+
+        /**
+        * @brief Owns a buffer of a frame allocator, and frees it with the allocator it was allocated with.
+        */
+        class frame_buffer
+        {
+        public:
+            frame_buffer() : m_data(nullptr), m_size(0), m_allocator(nullptr) {}
+
+            /**
+            * @brief Allocates a buffer of \c size bytes with the process allocator, or an empty buffer if the allocation failed.
+            */
+            explicit frame_buffer(size_t size) : frame_buffer()
+            {
+                frame_allocator_interface * allocator = frame_allocator_interface::get_process_allocator();
+                m_data = static_cast<uint8_t *>(allocator->allocate(size));
+                if(m_data)
+                {
+                    m_size = size;
+                    m_allocator = allocator;
+                }
+            }
+
+            frame_buffer(frame_buffer && other) : frame_buffer() { swap(other); }
+            frame_buffer & operator=(frame_buffer && other)
+            {
+                frame_buffer moved(std::move(other));
+                swap(moved);
+                return *this;
+            }
+            ~frame_buffer()
+            {
+                if(m_data)
+                {
+                    m_allocator->deallocate(m_data, m_size);
+                }
+            }
+
+            uint8_t * data() const { return m_data; }
+            size_t size() const { return m_size; }
+
+            void swap(frame_buffer & other)
+            {
+                std::swap(m_data, other.m_data);
+                std::swap(m_size, other.m_size);
+                std::swap(m_allocator, other.m_allocator);
+            }
+
+        private:
+            frame_buffer(const frame_buffer &) = delete;
+            frame_buffer & operator=(const frame_buffer &) = delete;
+
+            uint8_t *                   m_data;
+            size_t                      m_size;
+            frame_allocator_interface * m_allocator;
+        };
+    }
+}
@@ -7,8 +7,10 @@
 */
 
 #pragma once
+#include <cstddef>
 #include "metadata_interface.h"
 #include "rs/core/ref_count_interface.h"
+#include "rs/core/device_buffer_interface.h"
 #include "rs/utils/release_self_base.h"
 #include "types.h"
 
@@ -129,10 +131,27 @@ namespace rs
             * 
             * Provides a pointer to the image raw buffer, for read only operations. To convert the pixel format, convert_to function should be called. 
             * To modify the image, the user can copy the image buffer, and create a new image from this data using \c create_instance_from_raw_data.
-            * @return const void* Data 
+            * The image of \c convert_to is converted by its first data query, which reports a failed conversion with null data, so the callers
+            * of \c convert_to check the data of the converted image.
+            * @return const void* Data, null if the conversion of the image failed
             */
             virtual const void * query_data(void) const = 0;
 
+            /**
+            * @brief Gets the image data, of which at least the given rows are valid.
+            *
+            * The image of \c convert_to is converted when its data is first queried, this method converts only the given rows, so a caller
+            * which reads a band of the image doesn't convert the other rows. The other rows are valid once they are queried, or once
+            * \c query_data() is called. The rows are stepped by the image pitch from the returned pointer, which is the pointer of \c query_data().
+            * @param[in]  first_row         The first row the caller reads
+            * @param[in]  rows_count        The number of rows the caller reads
+            * @return const void*           Data, null if the rows are out of the image or their conversion failed
+            */
+            virtual const void * query_data_rows(int32_t first_row, int32_t rows_count) const
+            {
+                return first_row >= 0 && rows_count >= 0 && first_row + rows_count <= query_info().height ? query_data() : nullptr;
+            }
+
             /**
             * @brief Returns the image stream type. 
 			* 
@@ -158,11 +177,25 @@ namespace rs
             */
             virtual metadata_interface* query_metadata() = 0;
 
+            /**
+            * @brief Returns the metadata of the known types as plain values.
+            *
+            * The view is owned by the image and reads the metadata without copies or virtual calls per value, it reflects the metadata
+            * which was added before the image was passed to its consumers.
+            * @return const metadata_view * The view, or null if the image doesn't keep a view
+            */
+            virtual const metadata_view * query_metadata_view() const { return nullptr; }
+
             /**
             * @brief Creates a converted image from the current image and a given pixel format.
             *
             * The function creates a converted image from the current image buffer to the requested pixel format, if such conversion is supported. 
             * The converted image is cached by the original image, so that multiple requests for the same conversion are calculated only once.
+            * The conversion is lazy: the converted image data is allocated and converted on the first \c query_data() call, or by rows on
+            * \c query_data_rows() calls, so an image which is only queried for its info, or passed along without being read, isn't converted.
+            * The original image is kept until its converted image is converted or released. Since the conversion runs on the first data query,
+            * its failure, to allocate the converted data for example, isn't reported by this status but by the null data of the query.
+            * Concurrent first queries of the converted image wait for a single conversion.
             * On a successful conversion the calling user shares the image ownership with the original image instance, the user is obligated to release 
 			* the image in his context. its recommended to use \c sdk/include/rs/utils/smart_ptr_helpers.h helper functions to wrap the image object 
 			* for automatic image release mechanism.
@@ -178,7 +211,9 @@ namespace rs
             /**
             * @brief Creates a rotated image from the current image and a given rotation parameter.
             *
-			* The feature is currently unsupported.
+            * The image is rotated clockwise, and keeps its pixel format. The rotated image is cached by the original image, the same way
+            * converted images are cached, and a 0 degree rotation returns the original image. yuyv images only support the 180 degrees rotation,
+            * since their pixel pairs share the chroma values. On success the caller shares the image ownership and must release it.
             * @param[in]  rotation                  Destination rotation
             * @param[out] converted_image           Converted image allocated internally
             * @return status_no_error               Successful execution
@@ -188,6 +223,105 @@ namespace rs
             */
             virtual status convert_to(rotation rotation, const image_interface** converted_image) = 0;
 
+            /**
+            * @brief Returns a level of the image pyramid, the image downscaled by a power of two.
+            *
+            * Each level halves the width and the height of the previous level, dropping an odd last row or column. z16 and disparity16
+            * levels take the lower median of the non zero pixels of each 2x2 block, so the depth edges are kept sharp, the other formats
+            * take the mean of each block. The levels are cached by the original image, and each level is computed from the cached
+            * previous level, so the modules which process the same image at a lower resolution share a single pyramid.
+            * On success the caller shares the image ownership and must release it.
+            * @param[in]  level                     Pyramid level, 1 for half the resolution, up to \c MAX_PYRAMID_LEVEL
+            * @param[out] downscaled_image          Downscaled image allocated internally
+            * @return status_no_error               Successful execution
+            * @return status_param_unsupported      The level or the image format is unsupported, or the level is smaller than 1x1.
+            */
+            virtual status query_pyramid_level(uint32_t level, const image_interface ** downscaled_image) = 0;
+
+            /**
+            * @brief The deepest level \c query_pyramid_level returns, an eighth of the image resolution.
+            */
+            static const uint32_t MAX_PYRAMID_LEVEL = 3;
+
+            /**
+            * @brief Parameters of a fused crop, rotation, resize and pixel format conversion.
+            */
+            struct image_transform
+            {
+                pixel_format       format;   /**< Destination format, \c pixel_format::any keeps the image format */
+                rs::core::rotation rotation; /**< Clockwise rotation of the cropped region */
+                rect               crop;     /**< Cropped region of the image, in pixels. A region with zero width or height selects the whole image */
+                sizeI32            size;     /**< Destination size, after the rotation. A zero width or height keeps the size of the rotated region */
+            };
+
+            /**
+            * @brief Creates an image which is cropped, rotated, resized and converted to a pixel format, in a single pass.
+            *
+            * Each destination row is gathered from the image in the image format, and converted while it's in the cache, so no
+            * intermediate image is created. The resize samples the nearest pixel, to resize with filtering by a power of two
+            * transform a level of \c query_pyramid_level. The 16 bit formats are scaled to 8 bits by the maximal value of the
+            * cropped region. A transform which only converts or only rotates the image returns the cached image of \c convert_to,
+            * other transforms aren't cached. On success the caller shares the image ownership and must release it.
+            * @param[in]  parameters                The transform parameters
+            * @param[out] transformed_image         Transformed image allocated internally
+            * @return status_no_error               Successful execution
+            * @return status_param_unsupported      The conversion or the rotation of the image format is unsupported, or the cropped region is outside the image.
+            * @return status_invalid_argument       Negative crop or size.
+            */
+            virtual status transform(const image_transform & parameters, const image_interface ** transformed_image) = 0;
+
+            /**
+            * @brief Returns the device buffer of the image data for a compute API.
+            *
+            * An image created by \c create_instance_from_device_buffer() carries its device buffer, and any image carries the device copies
+            * of its data which modules attached by \c attach_device_buffer(). The image is passed unchanged from module to module in the
+            * samples sets, so a chain of modules of the same API uploads the image once.
+            * @param[in] api                        The compute API
+            * @return device_buffer_interface*      The device buffer, valid while the image is alive, the caller adds a reference to keep it longer
+            * @return nullptr                       The image has no device buffer of the API
+            */
+            virtual const device_buffer_interface * query_device_buffer(device_api api) const { return nullptr; }
+
+            /**
+            * @brief Attaches a device copy of the image data, which the image keeps for the other users of the API.
+            *
+            * A module which uploaded the image data attaches its upload, the image holds a reference to the buffer until it's destroyed.
+            * Only the first buffer of each API is attached, a module which loses the race uses the attached buffer instead of its own.
+            * @param[in] buffer                     The device copy of the image data, of the image size and format
+            * @return status_no_error               The buffer is attached
+            * @return status_key_already_exists     The image has a device buffer of the API, returned by \c query_device_buffer()
+            * @return status_handle_invalid         Null buffer or a buffer of an unknown API
+            * @return status_feature_unsupported    The image doesn't carry device buffers
+            */
+            virtual status attach_device_buffer(const device_buffer_interface * buffer) const { return status_feature_unsupported; }
+
+            /**
+            * @brief Returns the data derived from the image which a component attached to it, such as the vertices of a depth image.
+            *
+            * @param[in] owner                      The component which attached the data, the keys of different components don't collide
+            * @param[in] id                         The product of the owner
+            * @return ref_count_interface*          The attached data, valid while the image is alive, the caller adds a reference to keep it longer
+            * @return nullptr                       The image has no data attached under the key
+            */
+            virtual const ref_count_interface * query_attachment(const void * owner, uint32_t id) const { return nullptr; }
+
+            /**
+            * @brief Attaches data derived from the image, which the image keeps for the other modules processing it.
+            *
+            * The images of a samples set are shared by all the modules which process it, so a product of the image which a module attached,
+            * such as the vertices, the UV map or a registered image of a depth image, is computed once for all the modules. The image holds a
+            * reference to the data until it's destroyed. Only the first data of each key is attached, a module which loses the race uses the
+            * attached data instead of its own.
+            * @param[in] owner                      The component which attaches the data
+            * @param[in] id                         The product of the owner
+            * @param[in] data                       The derived data
+            * @return status_no_error               The data is attached
+            * @return status_key_already_exists     The image has data under the key, returned by \c query_attachment()
+            * @return status_handle_invalid         Null data
+            * @return status_feature_unsupported    The image doesn't carry attachments
+            */
+            virtual status attach(const void * owner, uint32_t id, const ref_count_interface * data) const { return status_feature_unsupported; }
+
             /**
             * @brief SDK image implementation for a frame defined by librealsense.
             *
@@ -240,6 +374,121 @@ namespace rs
                                                                    double time_stamp,
                                                                    uint64_t frame_number,
                                                                    timestamp_domain time_stamp_domain = timestamp_domain::camera);
+
+            /**
+             * @brief create_instance_view
+             *
+             * sdk image implementation over data owned by a reference counted object, such as another image, a decoder pool buffer or a
+             * memory mapped region, without copying it. The image adds a reference to the data owner and releases it when the image is
+             * released, so the data stays valid while any image viewing it is alive. The data may point inside the owner buffer, for example
+             * to a region of another image, in which case the info pitch is the pitch of the owner.
+             * @param[in] info                  info required to successfully traverse the image data.
+             * @param[in] data                  the image data, owned by data_owner.
+             * @param[in] data_owner            the reference counted owner of the data, null means the user is managing the image data outside of the image instance.
+             * @param[in] stream                the stream type.
+             * @param[in] flags                 optional flags, place holder for future options.
+             * @param[in] time_stamp            the timestamp of the image, in milliseconds since the device was started.
+             * @param[in] frame_number          the number of the image, since the device was started.
+             * @param[in] time_stamp_domain     the domain in which the timestamp were generated from.
+             * @return image_interface *    an image instance.
+             */
+            static image_interface * create_instance_view(image_info * info,
+                                                          const void * data,
+                                                          const ref_count_interface * data_owner,
+                                                          stream_type stream,
+                                                          image_interface::flag flags,
+                                                          double time_stamp,
+                                                          uint64_t frame_number,
+                                                          timestamp_domain time_stamp_domain = timestamp_domain::camera);
+
+            /**
+             * @brief create_instance_from_device_buffer
+             *
+             * sdk image implementation over a device buffer, such as a GPU module output, whose data stays in the device memory. The image
+             * adds a reference to the buffer and releases it when the image is released. \c query_device_buffer() returns the buffer without
+             * copying it, \c query_data() copies the buffer to host memory on the first call, which the following calls return. The host
+             * copy is of the info pitch. The conversions of the image are computed from its host copy.
+             * @param[in] info                  the image size, format and the pitch of the host copy.
+             * @param[in] buffer                the device buffer of the image data.
+             * @param[in] stream                the stream type.
+             * @param[in] flags                 optional flags, place holder for future options.
+             * @param[in] time_stamp            the timestamp of the image, in milliseconds since the device was started.
+             * @param[in] frame_number          the number of the image, since the device was started.
+             * @param[in] time_stamp_domain     the domain in which the timestamp were generated from.
+             * @return image_interface *    an image instance, null if the info or the buffer is null or the buffer API is unknown.
+             */
+            static image_interface * create_instance_from_device_buffer(image_info * info,
+                                                                        const device_buffer_interface * buffer,
+                                                                        stream_type stream,
+                                                                        image_interface::flag flags,
+                                                                        double time_stamp,
+                                                                        uint64_t frame_number,
+                                                                        timestamp_domain time_stamp_domain = timestamp_domain::camera);
+
+            /**
+             * @brief Sets the limit of the bytes of the converted images cached by their source images.
+             *
+             * Each image caches the few images it was most recently converted to, and the cached images of all the images share this limit.
+             * When the limit is reached, an image evicts its least recently used cached images, and if the new converted image still doesn't fit,
+             * it's returned to the caller without being cached. Converted images data is allocated from a pool, which is reused once the images are released.
+             * @param[in] max_bytes             the maximal bytes of cached converted images, in all the images.
+             */
+            static void set_conversion_cache_limit(size_t max_bytes);
+
+            /**
+             * @brief Returns the bytes of the converted images currently cached by their source images.
+             * @return size_t               the cached bytes.
+             */
+            static size_t query_conversion_cache_bytes();
+
+            /**
+             * @brief Sets the alignment of the rows of the images and the playback frames the SDK allocates.
+             *
+             * The buffers are allocated 64 bytes aligned, see \c frame_allocator_interface, but a tight pitch of width by pixel bytes starts
+             * the rows at any address. With a row alignment, the pitch of the converted, rotated, downscaled and transformed images, and the
+             * stride of the decoded and uncompressed playback frames, is padded to a multiple of the alignment, so every row is aligned and
+             * vectorized consumers don't load across cache lines. The consumers must step the rows by the pitch. Applies to the images and
+             * frames created afterwards, the zero copy playback frames of a mapped recording keep the recorded stride.
+             * @param[in] alignment             the row alignment in bytes, a power of two up to 64. 1 keeps the rows tight, the default.
+             * @return status_no_error          the alignment is set.
+             * @return status_invalid_argument  the alignment isn't a power of two up to 64.
+             */
+            static status set_row_alignment(uint32_t alignment);
+
+            /**
+             * @brief Returns the alignment of the rows of the images and the playback frames the SDK allocates.
+             * @return uint32_t                 the row alignment in bytes, 1 if the rows are tight.
+             */
+            static uint32_t query_row_alignment();
+
+            /**
+             * @brief Returns the pitch of a row of the given bytes, padded to the row alignment.
+             * @param[in] row_bytes             the bytes of the pixels of a row.
+             * @return int32_t                  the padded pitch.
+             */
+            static int32_t query_aligned_pitch(int32_t row_bytes);
+
+            /**
+             * @brief Sets a fixed depth range for the colorization of the z16 images.
+             *
+             * By default the conversion of a z16 image to a color format scales the depth by the image maximal value, clamped to 3000,
+             * which takes a pass over the image before the coloring. With a fixed range, the color of each depth value is precomputed
+             * once, when the range is set, and the conversion is a single lookup per pixel. The depth up to the range minimum is black,
+             * the depth from the range maximum is white. The range applies to the conversions of all the images, and to the viewer.
+             * @param[in] min_depth             the depth of the first colored value, in the depth units.
+             * @param[in] max_depth             the depth of the full colormap intensity. (0, 0) restores scaling each image by its maximal value.
+             * @return status_no_error          the range is set.
+             * @return status_invalid_argument  the maximal depth isn't above the minimal depth.
+             */
+            static status set_depth_colorization_range(uint16_t min_depth, uint16_t max_depth);
+
+            /**
+             * @brief Returns the fixed depth range for the colorization of the z16 images.
+             * @param[out] min_depth            the depth of the first colored value.
+             * @param[out] max_depth            the depth of the full colormap intensity.
+             * @return bool                     false if no range is set, each image is scaled by its maximal value.
+             */
+            static bool query_depth_colorization_range(uint16_t & min_depth, uint16_t & max_depth);
         protected:
             virtual ~image_interface() {}
         };
@@ -21,6 +21,29 @@ namespace rs
             custom          = 0x10000
         };
 
+        /**
+        * @brief The metadata of the known types as plain values, see \c image_interface::query_metadata_view().
+        *
+        * A value is set if its bit is set in \c valid_types, the bit of a metadata type is <tt>1 << type</tt>. The view is updated by
+        * \c metadata_interface::add_metadata() and \c metadata_interface::remove_metadata() for the metadata of a \c double value.
+        */
+        struct metadata_view
+        {
+            uint32_t valid_types;    /**< The bits of the set values */
+            double   actual_exposure;
+            double   actual_fps;
+
+            /**
+            * @brief Checks if the value of the metadata type is set.
+            * @param[in] id Metadata identifier
+            * @return bool True if the value is set
+            */
+            bool is_valid(metadata_type id) const
+            {
+                return id < metadata_type::custom && (valid_types & (1u << static_cast<uint32_t>(id))) != 0;
+            }
+        };
+
         /**
         * @brief Interface for accessing an image's metadata storage.
         *
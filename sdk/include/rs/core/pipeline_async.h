@@ -47,16 +47,24 @@ namespace rs
             enum class testing_mode
             {
                 playback,   /** The streaming source will be a playback file */
-                record      /** The streaming source will be a device which is currently connected to the platform, and the streaming output will
+                record,     /** The streaming source will be a device which is currently connected to the platform, and the streaming output will
                                 be recorded to a file */
+                synthetic,  /** The streaming source will be a synthetic device, which generates its streams without camera hardware, for load testing.
+                                If a file path is given, the streaming output will be recorded to it */
+                replay      /** The streaming source will be a playback file, replayed in lockstep with the modules for benchmarking. The samples are
+                                delivered as fast as the modules process them, the application and sync modules queues block the delivery instead of
+                                dropping samples sets, and the best effort modules aren't throttled, so each replay processes the same samples sets.
+                                The throughput of each module is reported by \c query_module_statistics() */
             };
 
             /**
              * @brief Constructor to initialize a pipeline for testing using record and playback.
              *
-             * @param[in] mode            Select the pipeline testing mode, streaming from a playback file or record mode, which streams from a live camera
-             *                            and records the output to a file.
-             * @param[in] file_path       The input file path for playback mode or record mode output file path.
+             * @param[in] mode            Select the pipeline testing mode, streaming from a playback file, record mode, which streams from a live camera
+             *                            and records the output to a file, synthetic mode, which streams from a synthetic camera, or replay mode,
+             *                            which streams a playback file as fast as the modules process it.
+             * @param[in] file_path       The input file path for playback and replay modes or record mode output file path. In synthetic mode, an optional
+             *                            output file path, nullptr to stream without recording.
              */
             pipeline_async(const testing_mode mode, const char * file_path);
 
@@ -66,6 +74,7 @@ namespace rs
             pipeline_async& operator= (pipeline_async&&) = delete;
 
             virtual status add_cv_module(video_module_interface *cv_module) override;
+            virtual status connect_cv_modules(video_module_interface *upstream_module, video_module_interface *downstream_module) override;
             virtual status query_cv_module(uint32_t index, video_module_interface **cv_module) const override;
             virtual status query_default_config(uint32_t index, video_module_interface::supported_module_config & default_config) const override;
             virtual status set_config(const video_module_interface::supported_module_config & config) override;
@@ -74,6 +83,14 @@ namespace rs
             virtual status start(callback_handler * app_callbacks_handler) override;
             virtual status stop() override;
             virtual rs::device * get_device() override;
+            virtual status query_dropped_sample_sets_count(video_module_interface * cv_module, uint64_t & dropped_count) const override;
+            virtual status pull_sample_set(video_module_interface * cv_module, correlated_sample_set & sample_set) override;
+            virtual status next_sample_set(video_module_interface * cv_module, correlated_sample_set & sample_set, uint32_t timeout_ms) override;
+            virtual status set_trace_handler(pipeline_trace_handler * trace_handler) override;
+            virtual status set_degradation_plan(const pipeline_degradation_plan & plan) override;
+            virtual status set_module_outputs_cache(const char * directory_path) override;
+            virtual status query_statistics(pipeline_statistics & statistics) const override;
+            virtual status query_module_statistics(video_module_interface * cv_module, pipeline_module_statistics & statistics) const override;
             virtual ~pipeline_async();
         private:
             pipeline_async_impl * m_pimpl; /**<The actual pipeline asynchronous implementation. */
@@ -9,6 +9,9 @@
 #pragma once
 #include "rs/core/correlated_sample_set.h"
 #include "rs/core/video_module_interface.h"
+#include "rs/core/pipeline_trace.h"
+#include "rs/core/pipeline_statistics.h"
+#include "rs/core/pipeline_degradation.h"
 
 namespace rs
 {
@@ -115,6 +118,26 @@ namespace rs
             */
             virtual status add_cv_module(video_module_interface * cv_module) = 0;
 
+            /**
+            * @brief Connects the output of a computer vision module to the input of another computer vision module.
+            *
+            * A connected downstream module gets the output samples sets of its upstream modules, instead of the samples sets of the camera.
+            * The output of a module with sync processing model is the samples set it processed successfully, the output of a module with async
+            * processing model is the samples set of its \c module_output_ready() notification, or the last samples set it got if the notification
+            * has no samples set. The connected modules must form an acyclic graph.
+            * The modules of a graph process concurrently, while a downstream module processes a samples set, its upstream module
+            * may process the next samples set. Each module queues its input by its queue policy, \c supported_module_config.queue_policy.
+            * @param[in] upstream_module        Computer vision module that was added to the pipeline, providing the input samples sets
+            * @param[in] downstream_module      Computer vision module that was added to the pipeline, processing the output of the upstream module
+            * @return status_data_not_initialized  One of the given computer vision modules is null
+            * @return status_invalid_state      Computer vision modules cannot be connected after the pipeline is configured or streaming
+            * @return status_item_unavailable   One of the given computer vision modules wasn't added to the pipeline
+            * @return status_param_inplace      The computer vision modules are already connected
+            * @return status_param_unsupported  The connection forms a cycle in the computer vision modules graph
+            * @return status_no_error           The computer vision modules were successfully connected
+            */
+            virtual status connect_cv_modules(video_module_interface * upstream_module, video_module_interface * downstream_module) = 0;
+
             /**
             * @brief Retrieves a computer vision module for a given index.
             *
@@ -154,9 +177,11 @@ namespace rs
             * device on the platform. The method fails if the requested configuration doesn't satisfy one of the above. After this method
             * is called, no more video modules can be added through add_cv_module. A successful configuration enables the device streams, and
             * configures each computer vision module. The configuration may be set multiple times, overriding previous configurations, until
-            * pipeline start is called. Once the pipeline is streaming, configuration change requires pipeline stop. A configured pipeline can
-            * be reset with a new set config or by calling reset. The configuration includes additional fields to define how the captured samples
-            * are delivered to the user.
+            * pipeline start is called. Once the pipeline is streaming, a configuration which the streaming device modes satisfy is applied
+            * without stopping the device: only the computer vision modules whose configuration changed are reconfigured, and the samples
+            * delivery is restarted with the new configuration. A configuration which requires different device streams requires pipeline stop.
+            * A configured pipeline can be reset with a new set config or by calling reset. The configuration includes additional fields to
+            * define how the captured samples are delivered to the user.
 			*
             * The pipeline provides the sample set based on the user requirements provided in \c supported_module_config.samples_time_sync_mode.
             * The sample set should include time synced samples of each enabled stream and motion sensor, or single samples with minimal latency,
@@ -164,7 +189,7 @@ namespace rs
             * @param[in] config                 Camera configuration
             * @return status_item_unavailable   The requested device is unavailable
             * @return status_match_not_found    The device does not support this configuration
-            * @return status_invalid_state      \c set_config() can be called only when the device is not streaming
+            * @return status_invalid_state      The pipeline is streaming and the configuration requires different device streams
             * @return status_no_error           The pipeline was configured successfully
             */
             virtual status set_config(const video_module_interface::supported_module_config & config) = 0;
@@ -233,6 +258,131 @@ namespace rs
             */
             virtual rs::device * get_device() = 0;
 
+            /**
+            * @brief Returns the number of samples sets the pipeline dropped for a computer vision module since the pipeline started streaming.
+            *
+            * Samples sets are dropped when the module processes slower than the camera and its samples queue is full, by the queue policy
+            * set in the module configuration, \c supported_module_config.queue_policy.
+            * @param[in]  cv_module              Computer vision module attached to the pipeline
+            * @param[out] dropped_count          Number of samples sets dropped for the module
+            * @return status_handle_invalid      The given computer vision module handler is invalid
+            * @return status_invalid_state       The pipeline state is not streaming
+            * @return status_item_unavailable    The given computer vision module isn't attached to the pipeline
+            * @return status_no_error            The dropped samples sets count was successfully retrieved
+            */
+            virtual status query_dropped_sample_sets_count(video_module_interface * cv_module, uint64_t & dropped_count) const = 0;
+
+            /**
+            * @brief Pulls the newest samples set of a computer vision module or of the application, which is configured with the
+            * \c samples_queue_policy::pull_latest or \c samples_queue_policy::pull_queued queue policy.
+            *
+            * The samples sets of a pulling consumer aren't pushed to the module processing method or to the application callback, the
+            * thread that processes them pulls the newest samples set directly, so no thread switch is added per samples set. The exchange
+            * with the streaming threads doesn't wait, a samples set which wasn't pulled before a newer one completed is dropped and counted by
+            * \c query_dropped_sample_sets_count(). Each image of the pulled samples set is referenced for the caller, the caller must
+            * release each image once it is processed. The samples sets of a module or of the application are pulled by a single thread.
+            * @param[in]  cv_module              Computer vision module attached to the pipeline, null pulls the samples sets of the application
+            * With \c pull_queued the oldest queued samples set is pulled, and no samples set is dropped while the queue isn't full.
+            * @param[out] sample_set             The newest samples set, unchanged if no samples set completed since the previous pull
+            * @return status_invalid_state       The pipeline state is not streaming
+            * @return status_item_unavailable    The given computer vision module isn't attached to the pipeline
+            * @return status_feature_unsupported The module or the application isn't configured to pull its samples sets
+            * @return status_data_not_changed    No samples set completed since the previous pull
+            * @return status_no_error            The newest samples set was pulled
+            */
+            virtual status pull_sample_set(video_module_interface * cv_module, correlated_sample_set & sample_set) = 0;
+
+            /**
+            * @brief Waits for the next samples set of a computer vision module or of the application, which is configured with the
+            * \c samples_queue_policy::pull_latest or \c samples_queue_policy::pull_queued queue policy.
+            *
+            * The blocking form of \c pull_sample_set(), for an application that consumes the samples sets on its own threads instead of
+            * by callbacks on the pipeline threads. The streaming threads wake the waiting thread only while it waits, a samples set
+            * that is already pulled returns without waiting. With \c pull_queued the queued samples sets are returned in order, with
+            * \c pull_latest the newest samples set is returned. Each image of the returned samples set is referenced for the caller, the
+            * caller must release each image once it is processed. The samples sets of a module or of the application are pulled by a
+            * single thread.
+            * @param[in]  cv_module              Computer vision module attached to the pipeline, null pulls the samples sets of the application
+            * @param[out] sample_set             The next samples set, unchanged if none completed before the timeout
+            * @param[in]  timeout_ms             The maximal wait in milliseconds, 0 doesn't wait
+            * @return status_invalid_state       The pipeline state is not streaming, or the pipeline stopped streaming while waiting
+            * @return status_item_unavailable    The given computer vision module isn't attached to the pipeline
+            * @return status_feature_unsupported The module or the application isn't configured to pull its samples sets
+            * @return status_exec_timeout        No samples set completed before the timeout
+            * @return status_no_error            The next samples set was pulled
+            */
+            virtual status next_sample_set(video_module_interface * cv_module, correlated_sample_set & sample_set, uint32_t timeout_ms) = 0;
+
+            /**
+            * @brief Sets a handler of the per sample latency trace events.
+            *
+            * When a handler is set, the pipeline stamps each sample with a monotonic clock timestamp at each hop: the device callback,
+            * the consumer time sync, the consumer queue, the computer vision module process call and the application callback.
+            * The events of a sample are correlated by the sample stream and frame number, see \c pipeline_trace_event.
+            * Tracing is off by default, the handler must outlive the streaming. \c chrome_trace_writer writes the events to a
+            * chrome trace json file.
+            * @param[in]  trace_handler          The trace handler, null to disable tracing
+            * @return status_invalid_state       The pipeline state is streaming, the handler is applied on the next start
+            * @return status_no_error            The handler was set
+            */
+            virtual status set_trace_handler(pipeline_trace_handler * trace_handler) = 0;
+
+            /**
+            * @brief Sets the plan the pipeline follows to shed load while the computer vision modules can't keep up with the streams.
+            *
+            * Without a plan, an overloaded pipeline drops the sample sets by the queue policy of each module. With a plan, the pipeline
+            * decimates the input of the best effort and normal modules, or stops processing the best effort modules, step by step while
+            * the overload persists, and restores them once the load recovers. See \c pipeline_degradation_plan. The applied step is
+            * reported by \c query_statistics(). A replay pipeline processes every sample set, so the plan doesn't apply to it.
+            * @param[in]  plan                   The plan, a plan with no steps disables the degradation
+            * @return status_invalid_state       The pipeline state is streaming, the plan is applied on the next start
+            * @return status_invalid_argument    The plan has more than \c pipeline_degradation_plan::MAX_STEPS steps
+            * @return status_no_error            The plan was set
+            */
+            virtual status set_degradation_plan(const pipeline_degradation_plan & plan) = 0;
+
+            /**
+            * @brief Sets the directory of the persistent cache of the computer vision modules outputs, for repeated offline reprocessing.
+            *
+            * With a cache, a playback or replay pipeline memoizes the sync modules which return a hash by
+            * \c video_module_interface::query_module_config_hash(). The outputs are keyed by the module uid, the module hash and the frame
+            * numbers and timestamps of the sample set in the recording, so a module which didn't change since a previous run restores its saved
+            * outputs instead of processing the sample sets, and the runs reprocess only the changed modules. The outputs of each module uid and
+            * hash are appended to a file of their own in the directory, which is kept between the runs and should be removed to reclaim its space.
+            * The sample sets of the multi-device and batched modules are processed.
+            * @param[in]  directory_path         The existing directory of the cache, null or empty to disable the cache
+            * @return status_invalid_state       The pipeline state is streaming, the cache is applied on the next start
+            * @return status_feature_unsupported The pipeline doesn't stream a playback file
+            * @return status_no_error            The cache was set
+            */
+            virtual status set_module_outputs_cache(const char * directory_path) = 0;
+
+            /**
+            * @brief Returns the runtime counters of the streams and of the pipeline workers since the pipeline started streaming.
+            *
+            * The counters are sampled without blocking the streaming and the computer vision modules, the method can be called
+            * periodically while streaming.
+            * @param[out] statistics             The received, unmatched and dropped samples count of each stream, and the cpu and
+            *                                    wait time of the workers
+            * @return status_invalid_state       The pipeline state is not streaming
+            * @return status_no_error            The statistics were successfully retrieved
+            */
+            virtual status query_statistics(pipeline_statistics & statistics) const = 0;
+
+            /**
+            * @brief Returns the runtime counters of a computer vision module since the pipeline started streaming.
+            *
+            * The counters are sampled without blocking the streaming and the computer vision modules, the method can be called
+            * periodically while streaming.
+            * @param[in]  cv_module              Computer vision module attached to the pipeline
+            * @param[out] statistics             The module queue, process time and output rate counters
+            * @return status_handle_invalid      The given computer vision module handler is invalid
+            * @return status_invalid_state       The pipeline state is not streaming
+            * @return status_item_unavailable    The given computer vision module isn't attached to the pipeline
+            * @return status_no_error            The statistics were successfully retrieved
+            */
+            virtual status query_module_statistics(video_module_interface * cv_module, pipeline_module_statistics & statistics) const = 0;
+
             virtual ~pipeline_async_interface() {}
         };
     }
@@ -0,0 +1,49 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file pipeline_degradation.h
+* @brief Describes the \c rs::core::pipeline_degradation_plan struct.
+*/
+
+#pragma once
+#include <stdint.h>
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief The steps the pipeline takes to shed load while the host can't keep up with the streams.
+        *
+        * The pipeline evaluates the load of the sync computer vision modules at each interval: an interval is overloaded if a module
+        * queue held at least \c overload_queue_depth sample sets, or a module process time exceeded \c overload_process_time_ms.
+        * After \c escalation_intervals consecutive overloaded intervals the next step of the plan is applied, after \c recovery_intervals
+        * consecutive intervals which weren't overloaded the previous step is restored, until the pipeline runs undegraded again.
+        * The latency critical modules are never degraded. The sample sets a degraded module skips are counted by
+        * \c pipeline_module_statistics::throttled_sample_sets_count.
+        */
+        struct pipeline_degradation_plan
+        {
+            static const int32_t MAX_STEPS = 8;
+
+            /**
+            * @brief The degradation applied by a step, the steps are expected to degrade more than their previous steps.
+            */
+            struct step
+            {
+                uint32_t best_effort_decimation;    /**< The best effort modules process one of this many sample sets, 0 or 1 doesn't decimate them */
+                bool     skip_best_effort_modules;  /**< The best effort modules process no sample sets */
+                uint32_t normal_decimation;         /**< The normal modules process one of this many sample sets, 0 or 1 doesn't decimate them */
+            };
+
+            uint32_t steps_count;                   /**< The number of steps of the plan, 0 disables the degradation */
+            step     steps[MAX_STEPS];              /**< The steps, in the order they're applied */
+            uint32_t overload_queue_depth;          /**< A module queue which holds this many sample sets overloads the interval, 0 ignores the queues */
+            uint32_t overload_process_time_ms;      /**< A module process time longer than this overloads the interval, 0 ignores the process times */
+            uint32_t evaluation_interval_ms;        /**< The length of the load evaluation interval, 0 is handled as 100 milliseconds */
+            uint32_t escalation_intervals;          /**< Consecutive overloaded intervals before the next step is applied, 0 is handled as 1 */
+            uint32_t recovery_intervals;            /**< Consecutive intervals which weren't overloaded before the previous step is restored, 0 is handled as 1 */
+        };
+    }
+}
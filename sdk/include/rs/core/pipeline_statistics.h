@@ -0,0 +1,67 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file pipeline_statistics.h
+* @brief Describes the \c rs::core::pipeline_statistics and \c rs::core::pipeline_module_statistics structs.
+*/
+
+#pragma once
+#include <stdint.h>
+#include "rs/core/types.h"
+#include "rs/utils/thread_profiler.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Runtime counters of a stream, since the pipeline started streaming.
+        */
+        struct pipeline_stream_statistics
+        {
+            uint64_t received_samples_count;    /**< Samples the device delivered to the pipeline */
+            uint64_t unmatched_samples_count;   /**< Samples the consumers time sync couldn't match, delivered alone */
+            uint64_t dropped_samples_count;     /**< Samples dropped by the queue policy of the application and modules consumers */
+        };
+
+        /**
+        * @brief Runtime counters of the pipeline streams, since the pipeline started streaming.
+        */
+        struct pipeline_statistics
+        {
+            pipeline_stream_statistics streams[static_cast<int32_t>(stream_type::max)]; /**< Counters of each stream, indexed by stream_type */
+            rs::utils::thread_statistics workers;   /**< Counters of the executor workers, which run the consumers and the synchronous modules.
+                                                         Their input wait is their idle time, their lock wait is the time they waited for
+                                                         each other to schedule the tasks */
+            uint32_t degradation_step;              /**< The applied step of the degradation plan, 1 based, 0 while the pipeline isn't degraded */
+            uint64_t degradation_step_changes_count; /**< The times a degradation step was applied or restored */
+
+            pipeline_stream_statistics & operator[](stream_type stream) { return streams[static_cast<int32_t>(stream)]; }
+            const pipeline_stream_statistics & operator[](stream_type stream) const { return streams[static_cast<int32_t>(stream)]; }
+        };
+
+        /**
+        * @brief Runtime counters of a computer vision module, since the pipeline started streaming.
+        *
+        * The process time of a sync module is the duration of its process call, of an async module it is the time from the
+        * process call of its last input until it notified its output.
+        */
+        struct pipeline_module_statistics
+        {
+            static const int32_t PROCESS_TIME_BUCKETS = 16;
+
+            uint32_t queued_sample_sets_count;      /**< Sample sets currently waiting in the module queue */
+            uint64_t processed_sample_sets_count;   /**< Sample sets the module processed */
+            uint64_t dropped_sample_sets_count;     /**< Sample sets dropped by the module queue policy */
+            uint64_t throttled_sample_sets_count;   /**< Sample sets a best effort module skipped while a latency critical module was busy */
+            uint64_t outputs_count;                 /**< Outputs the module notified */
+            double output_rate;                     /**< Recent outputs per second */
+            double throughput;                      /**< Processed sample sets per second, since the pipeline started streaming */
+            double mean_process_time_ms;            /**< Mean process time, in milliseconds */
+            uint64_t process_time_histogram[PROCESS_TIME_BUCKETS]; /**< Process times, bucket 0 counts times under 1 millisecond,
+                                                                        bucket i counts times in [2^(i-1), 2^i) milliseconds,
+                                                                        the last bucket counts all the longer times */
+        };
+    }
+}
@@ -0,0 +1,113 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file pipeline_trace.h
+* @brief Describes the \c rs::core::pipeline_trace_event, \c rs::core::pipeline_trace_handler and \c rs::core::chrome_trace_writer classes.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "rs/core/types.h"
+#include "rs/core/status.h"
+
+#ifdef WIN32
+#ifdef realsense_pipeline_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_pipeline_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief The pipeline hops of a sample, in the order a sample passes them.
+        */
+        enum class pipeline_trace_stage : int32_t
+        {
+            device_callback,    /**< The device delivered the sample to the pipeline */
+            time_synced,        /**< The sample completed a sample set of a consumer time sync */
+            queued,             /**< The sample set was queued to a sync consumer, to be handled on the executor */
+            process_begin,      /**< The computer vision module started processing the sample set */
+            process_end,        /**< The computer vision module process call returned */
+            callback_begin,     /**< The application callback started, \c on_new_sample_set or \c on_cv_module_process_complete */
+            callback_end        /**< The application callback returned */
+        };
+
+        /**
+        * @brief A timestamp of a sample passing a pipeline hop.
+        */
+        struct pipeline_trace_event
+        {
+            pipeline_trace_stage stage;     /**< The pipeline hop */
+            stream_type stream;             /**< The sample stream */
+            uint64_t frame_number;          /**< The sample frame number, correlates the events of the same sample */
+            int32_t module_uid;             /**< The consumer computer vision module unique id, 0 for the application and the device */
+            uint64_t time_ns;               /**< Time of the sdk monotonic clock, \c rs::utils::timebase, in nanoseconds */
+            uint64_t thread_id;             /**< Hash of the id of the thread which passed the hop */
+        };
+
+        /**
+        * @brief Handler of the pipeline trace events.
+        *
+        * The handler is called on the pipeline threads, at each hop, for each sample of the sample set. It must return quickly
+        * and be thread safe, since the events of different hops are reported concurrently.
+        */
+        class pipeline_trace_handler
+        {
+        public:
+            /**
+            * @brief Called when a sample passes a pipeline hop.
+            * @param[in] event  The trace event
+            */
+            virtual void on_trace_event(const pipeline_trace_event & event) = 0;
+            virtual ~pipeline_trace_handler() {}
+        };
+
+        /**
+        * @brief Trace handler that writes the events in the chrome trace event json format.
+        *
+        * The events are kept in memory while streaming and written to the file on \c flush or on destruction. The file can
+        * be opened with chrome://tracing or the perfetto ui, the process and callback hops are drawn as slices on their
+        * thread, the other hops as instant events. The events of a sample share its stream and frame number arguments.
+        */
+        class DLL_EXPORT chrome_trace_writer : public pipeline_trace_handler
+        {
+        public:
+            /**
+            * @brief Constructor.
+            * @param[in] file_path  The output json file path
+            */
+            chrome_trace_writer(const char * file_path);
+
+            void on_trace_event(const pipeline_trace_event & event) override;
+
+            /**
+            * @brief Writes all the events traced so far to the file, overwriting it.
+            * @return status_no_error               The events were written
+            * @return status_file_open_failed       Failed to open the file
+            * @return status_file_write_failed      Failed to write the file
+            */
+            status flush();
+
+            /**
+            * @brief Returns the number of events traced so far.
+            */
+            size_t query_events_count() const;
+
+            virtual ~chrome_trace_writer();
+        private:
+            const std::string m_file_path;
+            mutable std::mutex m_events_lock;
+            std::vector<pipeline_trace_event> m_events;
+        };
+    }
+}
@@ -32,6 +32,31 @@ namespace rs
 {
     namespace core
     {
+        /**
+        * @brief The output of a resident query of the projection, in host memory.
+        *
+        * The projection keeps its last output to write the next output into it, unless the output is still held by a user, whose output
+        * is then left as is and the next output is written to a new buffer. So a held output isn't changed or freed, by other threads
+        * or by the release of the projection, until its user releases it. Device resident data is carried by the images of
+        * \c device_buffer_interface, whose buffers are allocated by the application or its compute modules, since the SDK doesn't
+        * depend on a compute API.
+        */
+        class projection_output_interface : public ref_count_interface
+        {
+        public:
+            /**
+            * @brief Returns the output points, of the \c pointF32 or the \c point3dF32 type of the query.
+            */
+            virtual const void * query_data() const = 0;
+
+            /**
+            * @brief Returns the number of the output points, the number of the depth image pixels.
+            */
+            virtual int32_t query_points_count() const = 0;
+        protected:
+            //force deletion using the release function
+            virtual ~projection_output_interface() {}
+        };
 
         /**
 		* \brief
@@ -43,6 +68,12 @@ namespace rs
 		*
 		* Call the \c rs::core::projection::create_instance() method
         * to create an instance of this interface.
+        *
+        * An instance can be shared by threads once it's created: the queries, mappings and image creations of several threads
+        * run concurrently, without locking each other, since the calibration state is read only and each thread uses its own scratch
+        * buffers. The exceptions are the resident queries, which serialize the reuse of their output buffers, and the incremental registration,
+        * whose state is shared by the frames, which serialize the calls that use them. The registration and precision settings may
+        * be changed while other threads query.
         */
         class DLL_EXPORT projection_interface : public release_interface
         {
@@ -79,6 +110,26 @@ namespace rs
             */
             virtual status map_color_to_depth(image_interface *depth, int32_t npoints, pointF32 *pos_ij, pointF32 *pos_uv) = 0;
 
+            /**
+            * @brief Maps color coordinates to depth coordinates for a few pixels, without creating a UV Map.
+            *
+            * Same as \c map_color_to_depth, but each color pixel is searched for locally: starting from an initial guess, the depth pixel
+            * is moved iteratively until its mapping to color reaches the color pixel, then the nearest match in a small
+            * neighborhood is selected. The cost is proportional to \c npoints rather than to the image size, use it when only a
+            * few color pixels are mapped per frame. The search may end on a different depth pixel than \c map_color_to_depth
+            * near occlusion boundaries, where several depth pixels map to the same color pixel.
+            * Color pixels without a matching depth pixel are mapped to (-1, -1).
+            * @param[in]  depth           Depth map image
+            * @param[in]  npoints         Number of pixels to be mapped
+            * @param[in]  pos_ij          Array of color coordinates
+            * @param[out] pos_uv          Array of depth coordinates to be returned
+            * @return status_no_error             Successful execution
+            * @return status_param_unsupported    \c npoints value passed equals 0
+            * @return status_handle_invalid       Invalid in or out array passed as parameter
+            * @return status_data_unavailable     Incorrect depth or color data passed in projection initialization
+            */
+            virtual status map_color_to_depth_sparse(image_interface *depth, int32_t npoints, pointF32 *pos_ij, pointF32 *pos_uv) = 0;
+
             /**
             * @brief Maps depth coordinates to world coordinates for a few pixels.
             *
@@ -118,7 +169,7 @@ namespace rs
             *
             * Project real world coordinate system (camera) to camera coordinate system (depth image) for a number of points.
             * The real world coordinate system is expected to be the right-handed coordinate system.
-            * This method has optimized performance for a few points.
+            * This method has optimized performance for a few points, large arrays are projected in vectorized blocks.
             * @param[in]    npoints               Number of points to be projected
             * @param[in]    pos3d                 Array of world point coordinates, in millimeters
             * @param[out]   pos_uv                Array of depth pixel coordinates to be returned
@@ -129,12 +180,31 @@ namespace rs
             */
             virtual status project_camera_to_depth(int32_t npoints, point3dF32 *pos3d, pointF32 *pos_uv) = 0;
 
+            /**
+            * @brief Projects camera (real world) points to depth image pixels, with the coordinates in separate arrays.
+            *
+            * Same as \c project_camera_to_depth, for the points kept as a structure of arrays, e.g. the vertex buffers of a renderer.
+            * The arrays are projected as they are, without the transposing of the points, which suits the projection of large arrays.
+            * @param[in]    npoints               Number of points to be projected
+            * @param[in]    pos3d_x               Array of world point x coordinates, in millimeters
+            * @param[in]    pos3d_y               Array of world point y coordinates, in millimeters
+            * @param[in]    pos3d_z               Array of world point z coordinates, in millimeters
+            * @param[out]   pos_u                 Array of depth pixel u coordinates to be returned
+            * @param[out]   pos_v                 Array of depth pixel v coordinates to be returned
+            * @return status_no_error             Successful execution
+            * @return status_param_unsupported    \c npoints value passed equals 0
+            * @return status_handle_invalid       Invalid in or out array passed as parameter
+            * @return status_data_unavailable     Incorrect depth or color data passed in projection initialization
+            */
+            virtual status project_camera_to_depth(int32_t npoints, const float *pos3d_x, const float *pos3d_y, const float *pos3d_z,
+                                                   float *pos_u, float *pos_v) = 0;
+
             /**
             * @brief Projects camera (real world) points to corresponding color image pixels.
             *
             * Project real world coordinate system (camera) to camera coordinate system (color image) for a number of points.
             * The real world coordinate system is expected to be the right-handed coordinate system.
-            * This method has optimized performance for a few points.
+            * This method has optimized performance for a few points, large arrays are projected in vectorized blocks.
             * @param[in]    npoints               Number of points to be mapped
             * @param[in]    pos3d                 Array of world point coordinates, in millimeters
             * @param[out]   pos_ij                Array of color pixel coordinates, to be returned
@@ -145,6 +215,25 @@ namespace rs
             */
             virtual status project_camera_to_color(int32_t npoints, point3dF32 *pos3d, pointF32 *pos_ij) = 0;
 
+            /**
+            * @brief Projects camera (real world) points to color image pixels, with the coordinates in separate arrays.
+            *
+            * Same as \c project_camera_to_color, for the points kept as a structure of arrays, e.g. the vertex buffers of a renderer.
+            * The arrays are projected as they are, without the transposing of the points, which suits the projection of large arrays.
+            * @param[in]    npoints               Number of points to be mapped
+            * @param[in]    pos3d_x               Array of world point x coordinates, in millimeters
+            * @param[in]    pos3d_y               Array of world point y coordinates, in millimeters
+            * @param[in]    pos3d_z               Array of world point z coordinates, in millimeters
+            * @param[out]   pos_i                 Array of color pixel i coordinates to be returned
+            * @param[out]   pos_j                 Array of color pixel j coordinates to be returned
+            * @return status_no_error             Successful execution
+            * @return status_param_unsupported    \c npoints value passed equals 0
+            * @return status_handle_invalid       Invalid in or out array passed as parameter
+            * @return status_data_unavailable     Incorrect depth or color data passed in projection initialization
+            */
+            virtual status project_camera_to_color(int32_t npoints, const float *pos3d_x, const float *pos3d_y, const float *pos3d_z,
+                                                   float *pos_i, float *pos_j) = 0;
+
             /**
             * @brief Retrieves UV map for specific depth image.
             *
@@ -221,6 +310,365 @@ namespace rs
             */
             virtual image_interface* create_depth_image_mapped_to_color(image_interface *depth, image_interface *color) = 0;
 
+            /**
+            * @brief Maps depth coordinates to color coordinates for a batch of point arrays.
+            *
+            * Equivalent to calling \c map_depth_to_color for each array, the projection state is validated once and the arrays
+            * are processed in parallel. Use it for throughput oriented jobs, like offline processing of recorded frames.
+            * @param[in]  nbuffers                Number of point arrays
+            * @param[in]  npoints                 Array of \c nbuffers points counts
+            * @param[in]  pos_uvz                 Array of \c nbuffers depth coordinates arrays
+            * @param[out] pos_ij                  Array of \c nbuffers color coordinates arrays to be filled
+            * @return status_no_error             Successful execution
+            * @return status_param_unsupported    \c nbuffers or a points count equals 0 or depth value is less than <tt>(float)2e-38 </tt> for a certain point.
+            * @return status_handle_invalid       Invalid in or out array passed as parameter
+            * @return status_data_unavailable     Incorrect depth or color data passed in projection initialization
+            */
+            virtual status map_depth_to_color_batch(int32_t nbuffers, const int32_t *npoints, point3dF32 **pos_uvz, pointF32 **pos_ij) = 0;
+
+            /**
+            * @brief Projects camera (real world) points to color image pixels for a batch of point arrays.
+            *
+            * Equivalent to calling \c project_camera_to_color for each array, the projection state is validated once and the arrays
+            * are processed in parallel.
+            * @param[in]  nbuffers                Number of point arrays
+            * @param[in]  npoints                 Array of \c nbuffers points counts
+            * @param[in]  pos3d                   Array of \c nbuffers world point coordinates arrays, in millimeters
+            * @param[out] pos_ij                  Array of \c nbuffers color pixel coordinates arrays to be filled
+            * @return status_no_error             Successful execution
+            * @return status_param_unsupported    \c nbuffers or a points count equals 0 or depth value is less than <tt>(float)2e-38 </tt> for a certain point.
+            * @return status_handle_invalid       Invalid in or out array passed as parameter
+            * @return status_data_unavailable     Incorrect depth or color data passed in projection initialization
+            */
+            virtual status project_camera_to_color_batch(int32_t nbuffers, const int32_t *npoints, point3dF32 **pos3d, pointF32 **pos_ij) = 0;
+
+            /**
+            * @brief Retrieves UV maps for a batch of depth images.
+            *
+            * Equivalent to calling \c query_uvmap for each depth image, the projection state is validated once and the images
+            * are processed in parallel. All the depth images must have the initialized depth resolution.
+            * @param[in]  nframes                Number of depth images
+            * @param[in]  depth                  Array of \c nframes depth image instances
+            * @param[out] uvmap                  Array of \c nframes UV maps to be filled
+            * @return status_no_error            Successful execution
+            * @return status_param_unsupported   \c nframes value passed equals 0
+            * @return status_handle_invalid      Invalid depth image or uvmap array passed as parameter
+            * @return status_data_unavailable    Incorrect depth or color data passed in projection initialization
+            * @return status_feature_unsupported A depth image resolution differs from the initialized depth resolution
+            */
+            virtual status query_uvmap_batch(int32_t nframes, image_interface **depth, pointF32 **uvmap) = 0;
+
+            /**
+            * @brief Retrieves 3D points arrays for a batch of depth images, with units in millimeters.
+            *
+            * Equivalent to calling \c query_vertices for each depth image, the projection state is validated once and the images
+            * are processed in parallel. All the depth images must have the initialized depth resolution.
+            * @param[in]  nframes                Number of depth images
+            * @param[in]  depth                  Array of \c nframes depth image instances
+            * @param[out] vertices               Array of \c nframes vertices arrays to be filled, in real world coordinates
+            * @return status_no_error            Successful execution
+            * @return status_param_unsupported   \c nframes value passed equals 0
+            * @return status_handle_invalid      Invalid depth image or vertices array passed as parameter
+            * @return status_data_unavailable    Incorrect depth data passed in projection initialization
+            * @return status_feature_unsupported A depth image resolution differs from the initialized depth resolution
+            */
+            virtual status query_vertices_batch(int32_t nframes, image_interface **depth, point3dF32 **vertices) = 0;
+
+            /**
+            * @brief Retrieves UV map for specific depth image into a buffer kept by the projection.
+            *
+            * Same as \c query_uvmap, but the UV map is written to a buffer which the projection reuses across calls once its user
+            * released it, so a consumer which releases each output before the next query gets no per frame output allocation or copy.
+            * The output holds a reference for the caller, which releases it once it's done with the UV map.
+            * @param[in]  depth                  Depth image instance
+            * @param[out] uvmap                  The UV map of the depth image size, of \c pointF32 points, null on failure
+            * @return status_no_error            Successful execution
+            * @return status_handle_invalid      Invalid depth image or uvmap pointer passed as parameter
+            * @return status_data_unavailable    Incorrect depth or color data passed in projection initialization
+            */
+            virtual status query_uvmap_resident(image_interface *depth, const projection_output_interface **uvmap) = 0;
+
+            /**
+            * @brief Retrieves 3D points array for specific depth image into a buffer kept by the projection.
+            *
+            * Same as \c query_vertices, but the vertices are written to a buffer which the projection reuses across calls once its user
+            * released it, so a consumer which releases each output before the next query gets no per frame output allocation or copy.
+            * The output holds a reference for the caller, which releases it once it's done with the vertices.
+            * @param[in]  depth                   Depth image instance
+            * @param[out] vertices                The vertices of the depth image size, of \c point3dF32 points in real world coordinates, null on failure
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid depth image or vertices pointer passed as parameter
+            * @return status_data_unavailable     Incorrect depth or color data passed in projection initialization
+            */
+            virtual status query_vertices_resident(image_interface *depth, const projection_output_interface **vertices) = 0;
+
+            /**
+            * @brief Maps every color pixel for every depth pixel into a given buffer and output \c image_interface instance.
+            *
+            * Same as \c create_color_image_mapped_to_depth, but the output image data is written to the buffer of the caller,
+            * which is left owned by the caller and must outlive the returned image. When \c data is null, the data buffer is taken
+            * from a pool held by the projection, and is returned to the pool when the image is released, so mapping images of the
+            * same size at frame rate doesn't allocate.
+            * @param[in] depth        Depth image instance
+            * @param[in] color        Color image instance
+            * @param[in] data         Output image data of at least <tt>depth height * pitch</tt> bytes, or null to use the projection pool
+            * @param[in] pitch        Output image pitch in bytes, at least <tt>depth width * color pixel size</tt>. Ignored when \c data is null
+            * @return image_interface*     Output image in the depth image resolution
+            * @return nullptr              Invalid depth or color image or pitch passed as a parameter or uvmap failed to create.
+            */
+            virtual image_interface* create_color_image_mapped_to_depth(image_interface *depth, image_interface *color, uint8_t *data, int32_t pitch) = 0;
+
+            /**
+            * @brief Maps every depth pixel to the color image resolution into a given buffer and outputs a depth image.
+            *
+            * Same as \c create_depth_image_mapped_to_color, but the output image data is written to the buffer of the caller,
+            * which is left owned by the caller and must outlive the returned image. When \c data is null, the data buffer is taken
+            * from a pool held by the projection, and is returned to the pool when the image is released.
+            * @param[in] depth                   Depth image instance
+            * @param[in] color                   Color image instance
+            * @param[in] data                    Output image data of at least <tt>color height * pitch</tt> bytes, or null to use the projection pool
+            * @param[in] pitch                   Output image pitch in bytes, at least <tt>color width * 2</tt>. Ignored when \c data is null
+            * @return image_interface*           Output image in the color image resolution
+            * @return nullptr                    Invalid depth or color image or pitch passed as parameter or uvmap failed to create
+            */
+            virtual image_interface* create_depth_image_mapped_to_color(image_interface *depth, image_interface *color, uint8_t *data, int32_t pitch) = 0;
+
+            /**
+            * @brief Retrieves UV map for a region of interest of specific depth image.
+            *
+            * Same as \c query_uvmap, but only the depth pixels inside \c roi are mapped, so the computation scales with the roi area.
+            * The UV map is a \c PointF32 array of \c roi.height rows of \c roi.width points, \c pitch bytes apart, the first point
+            * matches the depth pixel at the roi origin.
+            * @param[in]  depth                  Depth image instance
+            * @param[in]  roi                    Region of interest in depth image coordinates, inside the depth image
+            * @param[out] uvmap                  UV map of the roi, to be returned
+            * @param[in]  pitch                  UV map row pitch in bytes, at least <tt>roi.width * sizeof(pointF32)</tt>
+            * @return status_no_error            Successful execution
+            * @return status_handle_invalid      Invalid depth image or uvmap array passed as parameter
+            * @return status_param_unsupported   The roi isn't inside the depth image or the pitch is too small
+            * @return status_data_unavailable    Incorrect depth or color data passed in projection initialization
+            */
+            virtual status query_uvmap(image_interface *depth, rect roi, pointF32 *uvmap, int32_t pitch) = 0;
+
+            /**
+            * @brief Retrieves 3D points array for a region of interest of specific depth image, with units in millimeters.
+            *
+            * Same as \c query_vertices, but only the depth pixels inside \c roi are projected, so the computation scales with the roi area.
+            * The vertices are a \c Point3DF32 array of \c roi.height rows of \c roi.width points, \c pitch bytes apart, the first
+            * point is the projection of the depth pixel at the roi origin.
+            * @param[in]  depth                   Depth image instance
+            * @param[in]  roi                     Region of interest in depth image coordinates, inside the depth image
+            * @param[out] vertices                3D vertices of the roi to be returned, in real world coordinates
+            * @param[in]  pitch                   Vertices row pitch in bytes, at least <tt>roi.width * sizeof(point3dF32)</tt>
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid depth image or vertices array passed as parameter
+            * @return status_param_unsupported    The roi isn't inside the depth image or the pitch is too small
+            * @return status_data_unavailable     Incorrect depth data passed in projection initialization
+            */
+            virtual status query_vertices(image_interface *depth, rect roi, point3dF32 *vertices, int32_t pitch) = 0;
+
+            /**
+            * @brief Maps every color pixel for every depth pixel of a region of interest and output \c image_interface instance.
+            *
+            * Same as \c create_color_image_mapped_to_depth with a given buffer, but only the depth pixels inside \c roi are mapped,
+            * and the output image is the size of the roi, aligned in space to the depth pixels of the roi.
+            * @param[in] depth        Depth image instance
+            * @param[in] color        Color image instance
+            * @param[in] roi          Region of interest in depth image coordinates, inside the depth image
+            * @param[in] data         Output image data of at least <tt>roi.height * pitch</tt> bytes, or null to use the projection pool
+            * @param[in] pitch        Output image pitch in bytes, at least <tt>roi.width * color pixel size</tt>. Ignored when \c data is null
+            * @return image_interface*     Output image in the roi resolution
+            * @return nullptr              Invalid depth or color image, roi or pitch passed as a parameter or uvmap failed to create.
+            */
+            virtual image_interface* create_color_image_mapped_to_depth(image_interface *depth, image_interface *color, rect roi, uint8_t *data, int32_t pitch) = 0;
+
+            /**
+            * @brief Maps the depth pixels of a region of interest to the color image resolution and outputs a depth image.
+            *
+            * Same as \c create_depth_image_mapped_to_color with a given buffer, but only the depth pixels inside \c roi are registered,
+            * the color pixels which no depth pixel of the roi is mapped to are left empty. The output image is in the color image resolution.
+            * @param[in] depth                   Depth image instance
+            * @param[in] color                   Color image instance
+            * @param[in] roi                     Region of interest in depth image coordinates, inside the depth image
+            * @param[in] data                    Output image data of at least <tt>color height * pitch</tt> bytes, or null to use the projection pool
+            * @param[in] pitch                   Output image pitch in bytes, at least <tt>color width * 2</tt>. Ignored when \c data is null
+            * @return image_interface*           Output image in the color image resolution
+            * @return nullptr                    Invalid depth or color image, roi or pitch passed as parameter or uvmap failed to create
+            */
+            virtual image_interface* create_depth_image_mapped_to_color(image_interface *depth, image_interface *color, rect roi, uint8_t *data, int32_t pitch) = 0;
+
+            /**
+            * @brief Retrieves 3D points array for a region of interest of specific depth image, in a compact vertex format.
+            *
+            * Same as \c query_vertices with a region of interest, but the vertices are written in the given format. The 16-bit formats
+            * halve the size of the vertices, the conversion is done while projecting, so no 32-bit float vertices are written.
+            * @param[in]  depth                   Depth image instance
+            * @param[in]  roi                     Region of interest in depth image coordinates, inside the depth image
+            * @param[in]  format                  Format of the vertices, 6 bytes per vertex for the 16-bit formats and 12 bytes for \c xyz32f
+            * @param[out] vertices                3D vertices of the roi to be returned, in real world coordinates
+            * @param[in]  pitch                   Vertices row pitch in bytes, at least <tt>roi.width</tt> vertices
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid depth image or vertices array passed as parameter
+            * @return status_param_unsupported    The roi isn't inside the depth image, the pitch is too small or the format is unknown
+            * @return status_data_unavailable     Incorrect depth data passed in projection initialization
+            */
+            virtual status query_vertices(image_interface *depth, rect roi, vertex_format format, void *vertices, int32_t pitch) = 0;
+
+            /**
+            * @brief Retrieves the ray of every depth pixel, the most compact encoding of the vertices.
+            *
+            * The vertex of a depth pixel is its ray scaled by its depth value: <tt>{ray.x * z, ray.y * z, z}</tt>, which equals the
+            * \c query_vertices output. The rays depend on the depth camera parameters only, so they are retrieved once and the
+            * depth image, 2 bytes per pixel, is passed in place of the vertices of each frame.
+            * @param[out] rays                    Rays array of the initialized depth size \c width*height
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid rays array passed as parameter
+            * @return status_data_unavailable     Incorrect depth data passed in projection initialization
+            */
+            virtual status query_depth_rays(pointF32 *rays) = 0;
+
+            /**
+            * @brief Retrieves the 3D points of the valid depth pixels only, with the pixel index of each point.
+            *
+            * Same as \c query_vertices, but the zero depth pixels are skipped, and the vertices of the valid pixels are packed in
+            * the order of the pixels. The pixel index of a vertex is <tt>y * width + x</tt> of its depth pixel.
+            * The arrays must have room for a vertex per depth pixel, since the number of valid pixels isn't known in advance.
+            * @param[in]  depth                   Depth image instance
+            * @param[out] vertices                Vertices of the valid pixels, in real world coordinates, of depth size \c width*height
+            * @param[out] pixel_indices           Pixel index of each returned vertex, of depth size \c width*height
+            * @param[out] nvertices               Number of returned vertices
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid depth image or arrays passed as parameter
+            * @return status_data_unavailable     Incorrect depth data passed in projection initialization
+            * @return status_feature_unsupported  The depth image resolution differs from the initialized depth resolution
+            */
+            virtual status query_valid_vertices(image_interface *depth, point3dF32 *vertices, int32_t *pixel_indices, int32_t *nvertices) = 0;
+
+            /**
+            * @brief Retrieves the 3D points of specific depth image downsampled to a voxel grid.
+            *
+            * The valid depth pixels are projected and binned to cubic voxels of \c voxel_size millimeters, aligned to the camera origin,
+            * and the centroid of the points of each occupied voxel is returned. The dense vertices array isn't created, the projection
+            * and the binning are done row by row. The centroids are returned in the order the voxels are first hit in pixels order.
+            * The voxels array must have room for a voxel per depth pixel, the number of occupied voxels isn't known in advance.
+            * @param[in]  depth                   Depth image instance
+            * @param[in]  voxel_size              Voxel edge length in millimeters
+            * @param[out] voxels                  Centroid of each occupied voxel, in real world coordinates, of depth size \c width*height
+            * @param[out] nvoxels                 Number of returned voxels
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid depth image or arrays passed as parameter
+            * @return status_param_unsupported    The voxel size isn't positive
+            * @return status_data_unavailable     Incorrect depth data passed in projection initialization
+            * @return status_feature_unsupported  The depth image resolution differs from the initialized depth resolution
+            */
+            virtual status query_voxelized_vertices(image_interface *depth, float voxel_size, point3dF32 *voxels, int32_t *nvoxels) = 0;
+
+            /**
+            * @brief Enables reusing the registration of the previous frames in \c create_depth_image_mapped_to_color, \c query_invuvmap
+            * and \c map_color_to_depth.
+            *
+            * The registration keeps the depth it was computed with, split in tiles. A tile is registered again only if one of its pixels
+            * differs from the kept depth by more than \c depth_threshold, and the inverse mappings are rebuilt only if a tile was registered again,
+            * otherwise only the resampling of the depth values or the copy of the kept inverse UV map is done, and \c map_color_to_depth
+            * searches the kept inverse mapping. Useful for a fixed rig looking at a mostly static scene.
+            * With a zero threshold the output is identical to the output of the full registration.
+            * @param[in] enable             True to reuse the previous registration, false to register every frame
+            * @param[in] depth_threshold    Depth change, in depth units, from which a tile is registered again
+            * @return status_no_error       Successful execution
+            */
+            virtual status set_incremental_registration(bool enable, uint16_t depth_threshold) = 0;
+
+            /**
+            * @brief Enables mapping each depth pixel forward to the color image in \c create_depth_image_mapped_to_color.
+            *
+            * Each depth pixel is splatted to a square of \c splat_size x \c splat_size color pixels around the color pixel it maps to,
+            * and where splats overlap the nearest depth is kept, so the occluded surfaces are hidden. A splat larger than the color to
+            * depth resolution ratio fills the gaps between the mapped depth pixels, a splat of one pixel maps each depth pixel to a single
+            * color pixel. The color image rows are split among the cores, each core resolving the depth of its own rows.
+            * The splatting replaces the inverse UV map registration, so the incremental registration isn't used while it's enabled.
+            * @param[in] enable                 True to splat the depth pixels, false to map by the inverse UV map
+            * @param[in] splat_size             Edge of the square of color pixels a depth pixel covers, 1 to 8
+            * @return status_no_error           Successful execution
+            * @return status_param_unsupported  The splat size is out of range
+            */
+            virtual status set_splatted_registration(bool enable, int32_t splat_size) = 0;
+
+            /**
+            * @brief Selects the fixed point projection of \c query_uvmap and \c query_vertices, for the targets with a slow floating point unit.
+            *
+            * The rays of the depth pixels, the depth to color transformation and the color camera parameters are kept as Q16 integers,
+            * with 16 fractional bits, and the projection is computed in 64-bit integers. Only the conversion of the float outputs uses
+            * the floating point unit, the \c xyz16s vertices are computed without it. The results are of a reduced precision:
+            * - A vertex coordinate differs from the floating point one by at most <tt>z / 65536</tt>, 0.06 millimeters at 4 meters, and the
+            *   \c xyz16s vertices by at most 1. The depth coordinate is exact.
+            * - A UV map coordinate differs from the floating point one by at most <tt>1 / 8192</tt> of the color image size, a quarter of a
+            *   pixel for a 1920 pixels wide image, so a pixel mapped close to the color image border may be mapped outside of it.
+            * The images and mappings built from the UV map, e.g. \c create_depth_image_mapped_to_color, use the fixed point UV map as well.
+            * @param[in] enable             True to project in fixed point, false to project in floating point
+            * @return status_no_error       Successful execution
+            */
+            virtual status set_fixed_point_projection(bool enable) = 0;
+
+            /**
+            * @brief Retrieves the UV map of a depth image, computed once for all the users of the image.
+            *
+            * Same as \c query_uvmap, but the UV map is attached to the depth image, see \c image_interface::attach. The first call computes it,
+            * and the next calls through the same projection, by any module, return the attached map. The modules of a samples set share its
+            * depth image, and the projections of a pipeline forward to a single projection of the device calibration, so the modules
+            * of a pipeline share a single projection pass. The map is computed with the projection settings of the first call.
+            * The returned buffer is valid while the depth image is alive, and must not be modified or freed by the caller.
+            * @param[in]  depth                   Depth image instance
+            * @param[out] uvmap                   Pointer to the shared UV map of the depth image size
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid depth image or uvmap pointer passed as parameter
+            * @return status_feature_unsupported  The depth image doesn't carry attachments
+            * @return status_data_unavailable     Incorrect depth or color data passed in projection initialization
+            */
+            virtual status query_shared_uvmap(image_interface *depth, const pointF32 **uvmap) = 0;
+
+            /**
+            * @brief Retrieves the 3D points of a depth image, computed once for all the users of the image.
+            *
+            * Same as \c query_vertices, but the vertices are attached to the depth image and shared as described in \c query_shared_uvmap.
+            * @param[in]  depth                   Depth image instance
+            * @param[out] vertices                Pointer to the shared vertices of the depth image size, in real world coordinates
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid depth image or vertices pointer passed as parameter
+            * @return status_feature_unsupported  The depth image doesn't carry attachments
+            * @return status_data_unavailable     Incorrect depth or color data passed in projection initialization
+            */
+            virtual status query_shared_vertices(image_interface *depth, const point3dF32 **vertices) = 0;
+
+            /**
+            * @brief Retrieves the color image mapped to a depth image, computed once for all the users of the image pair.
+            *
+            * Same as \c create_color_image_mapped_to_depth, but the mapped image is attached to the depth image and shared as described in
+            * \c query_shared_uvmap, a mapped image is kept for each color image mapped to the depth image.
+            * @param[in]  depth                   Depth image instance
+            * @param[in]  color                   Color image instance
+            * @param[out] mapped                  The shared mapped image, valid while the depth image is alive, the caller adds a reference to keep it longer
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid image or output pointer passed as parameter
+            * @return status_feature_unsupported  The depth image doesn't carry attachments
+            * @return status_data_unavailable     The mapped image couldn't be created
+            */
+            virtual status query_shared_color_image_mapped_to_depth(image_interface *depth, image_interface *color, const image_interface **mapped) = 0;
+
+            /**
+            * @brief Retrieves the depth image mapped to a color image, computed once for all the users of the image pair.
+            *
+            * Same as \c create_depth_image_mapped_to_color, but the mapped image is attached to the depth image and shared as described in
+            * \c query_shared_uvmap, a mapped image is kept for each color image the depth image is mapped to.
+            * @param[in]  depth                   Depth image instance
+            * @param[in]  color                   Color image instance
+            * @param[out] mapped                  The shared mapped image, valid while the depth image is alive, the caller adds a reference to keep it longer
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid image or output pointer passed as parameter
+            * @return status_feature_unsupported  The depth image doesn't carry attachments
+            * @return status_data_unavailable     The mapped image couldn't be created
+            */
+            virtual status query_shared_depth_image_mapped_to_color(image_interface *depth, image_interface *color, const image_interface **mapped) = 0;
+
 
              /**
              * @brief Creates an instance and initializes, based on intrinsic and extrinsic parameters.
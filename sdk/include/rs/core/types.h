@@ -78,6 +78,8 @@ namespace rs
             fisheye                          = 4,  /**< Native stream of color data captured by the fisheye camera                                           */
 
             rectified_color                  = 6,  /**< Synthetic stream containing undistorted color data with no extrinsic rotation from the depth stream  */
+            depth_aligned_to_color           = 7,  /**< Synthetic stream of depth data registered to the color stream by the pipeline, from depth and color  */
+            color_aligned_to_depth           = 8,  /**< Synthetic stream of color data registered to the depth stream by the pipeline, from depth and color  */
             max                                    /**< Maximum number of stream types - must be last                                                        */
         };
 
@@ -163,6 +165,17 @@ namespace rs
             float x, y, z; /**< Represents a three-dimensional point */
         };
 
+        /**
+        * @brief Vertex formats of the projection vertices output
+        */
+        enum class vertex_format : int32_t
+        {
+            xyz32f = 0,   /**< Three 32-bit floats per vertex, in millimeters, as \c point3dF32                                        */
+            xyz16f = 1,   /**< Three 16-bit (half precision) floats per vertex, in millimeters. The precision is 2 millimeters at 2 meters
+                               and 4 millimeters at 4 meters, saturated to 65504                                                          */
+            xyz16s = 2    /**< Three 16-bit signed integers per vertex, in millimeters rounded to the nearest integer and saturated      */
+        };
+
         /**
         * @brief Rectangle
         */
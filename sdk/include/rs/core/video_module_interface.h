@@ -8,6 +8,7 @@
 */
   
 #pragma once
+#include <vector>
 #include "correlated_sample_set.h"
 #include "types.h"
 
@@ -62,6 +63,9 @@ namespace rs
             *
             * The requested streams and their (optional) configuration are set to the stream relevant \c stream_type index in the \c image_streams_configs array.
             * The module sets \c is_enabled for each \c stream_type index it requires for processing. 
+            * The \c stream_type::depth_aligned_to_color and \c stream_type::color_aligned_to_depth streams aren't streamed by the device, the pipeline registers
+            * them once for each time synced sample set of the depth and color streams, which the configuration enables as well. Their size and frame rate are
+            * set by the depth and color streams, the requested size and frame rate of an aligned stream are ignored.
             * The requested motion sensors and their (optional) configuration are set to the motion sensor relevant \c motion_type index in the \c motion_sensors_configs array.
             * The module sets \c is_enabled for each \c motion_type index it requires for processing.
             * The module might require a specific device name. A zero array means it can be ignored. 
@@ -78,8 +82,46 @@ namespace rs
                                                                       Processing should be called only with the full set of samples, and drop any samples that have no match. */
                     time_synced_input_accepting_unmatch_samples, /**< Processing requires time synced samples sets, which preferably include a sample of each enabled stream and motion sensor.
                                                                       Processing should be called also for a subset of the enabled streams or motion sensors, in cases of samples that have no match. */
-                    sync_not_required                            /**< Processing requires minimal latency for each sample, thus it requires no time synchronization of the samples.
+                    sync_not_required,                           /**< Processing requires minimal latency for each sample, thus it requires no time synchronization of the samples.
                                                                       Processing should be called with one or more samples, which are available at the time of calling. */
+                    time_synced_input_with_deadline              /**< Processing requires time synced samples sets, within a bounded latency. Processing should be called with the full set of samples,
+                                                                      or with the partial set of the samples that are available once the newest sample is \c time_sync_deadline milliseconds
+                                                                      later than them, so a stalled stream doesn't delay the processing of the other streams. */
+                };
+
+                /**
+                * @brief Defines how the samples sets waiting for a module that processes slower than the camera are queued.
+                *
+                * The queue holds up to \c queue_depth samples sets, the policy decides which samples sets are dropped once the queue is full.
+                */
+                enum class samples_queue_policy
+                {
+                    keep_latest,                                 /**< The queued samples sets are dropped, only the newest samples set waits for processing. */
+                    drop_oldest,                                 /**< The oldest queued samples set is dropped to queue the newest samples set. */
+                    drop_newest,                                 /**< The newest samples set is dropped, the queued samples sets are processed in order. */
+                    block,                                       /**< The samples delivery waits until the module processes a queued samples set, no samples set is dropped.
+                                                                      The delivery to the other modules waits as well. */
+                    pull_latest,                                 /**< The samples sets aren't pushed to the processing method, the module or application thread pulls the newest
+                                                                      samples set by \c pipeline_async_interface::pull_sample_set(), without a thread switch. A samples set which
+                                                                      wasn't pulled before the next samples set completed is dropped. The pulled samples sets aren't forwarded to
+                                                                      downstream modules. Applies to a single device configuration, a multi-device module uses \c keep_latest. */
+                    pull_queued                                  /**< Like \c pull_latest, but up to \c queue_depth samples sets wait in a lock free queue and are pulled in order,
+                                                                      so the pulling thread can handle the samples sets in batches. The newest samples set is dropped once the
+                                                                      queue is full. */
+                };
+
+                /**
+                * @brief Defines how the module competes with the other modules for the pipeline threads.
+                *
+                * Applies to modules with sync processing model.
+                */
+                enum class module_priority
+                {
+                    normal,                                      /**< The module is scheduled like the other normal modules. */
+                    latency_critical,                            /**< The module gets each samples set before the other modules, and its processing runs before their
+                                                                      queued processing on the pipeline threads. */
+                    best_effort                                  /**< While a latency critical module is busy, the module processes only a part of the samples sets, the
+                                                                      skipped samples sets are counted by \c pipeline_module_statistics::throttled_sample_sets_count. */
                 };
 
                 supported_image_stream_config  image_streams_configs[static_cast<uint32_t>(stream_type::max)];  /**< Requested streams to enable, with optional streams parameters. The index is \c stream_type.*/
@@ -90,6 +132,22 @@ namespace rs
                 bool                           async_processing;                                                /**< The module processing model:
                                                                                                                      async processing implies that the module output data is available when \c processing_event_handler::module_output_ready() is called; 
                                                                                                                      sync processing implies that the module output data might be available when the processing method returns. */
+                uint32_t                       time_sync_deadline;                                              /**< The latency in milliseconds after which a partial samples set is processed, with the \c time_synced_input_with_deadline mode. */
+                samples_queue_policy           queue_policy;                                                    /**< The policy of the samples sets waiting for processing, applies to modules with sync processing model. */
+                uint32_t                       queue_depth;                                                     /**< The maximum number of samples sets waiting for processing, 0 is handled as 1. */
+                uint32_t                       device_count;                                                    /**< The number of devices, named by \c device_name, which stream the configuration to the module, 0 is handled as 1.
+                                                                                                                     With more than one device, the samples sets of all the devices are matched and processed together by
+                                                                                                                     \c process_multi_device_sample_set(). Applies to modules with sync processing model. */
+                module_priority                priority_class;                                                  /**< The scheduling priority of the module among the other modules, applies to modules with sync processing model. */
+                uint32_t                       max_rate;                                                        /**< The maximal rate in frames per second of each image stream the module gets, 0 doesn't limit the rate.
+                                                                                                                     The samples above the rate are skipped before the time sync and before they are referenced for the module,
+                                                                                                                     so a low rate module costs proportionally less than the stream rate. */
+                uint32_t                       max_batch_size;                                                  /**< The maximal number of samples sets the module processes together by \c process_sample_set_batch(),
+                                                                                                                     0 and 1 process each samples set by \c process_sample_set(). Applies to modules with sync processing
+                                                                                                                     model and a single device, which samples sets are pushed. */
+                uint32_t                       max_batch_delay;                                                 /**< The latency in milliseconds after which a partial batch is processed, a batch is processed once it's full
+                                                                                                                     or once a samples set completes \c max_batch_delay after the first samples set of the batch. 0 waits
+                                                                                                                     for full batches. */
 
                 /**
                 * @brief Gets a stream configuration reference by stream type.
@@ -154,6 +212,7 @@ namespace rs
                 rs::core::device_info       device_info;                                                     /**< Active device info */
                 projection_interface *      projection;                                                      /**< [OBSOLETE] projection object for mappings between color and depth images.
                                                                                                                   The object's memory is handled by the caller of the video module.*/
+                uint32_t                    device_count;                                                    /**< The number of devices streaming the configuration, the configuration and the device info apply to each of them */
 
                 /**
                 * @brief Gets a stream config reference by stream type.
@@ -237,6 +296,68 @@ namespace rs
             */
             virtual status process_sample_set(const correlated_sample_set & sample_set) = 0;
 
+            /**
+            * @brief Processes the matched sample sets of the devices of a multi-device configuration.
+            *
+            * Called instead of \c process_sample_set() when the module configuration \c device_count is larger than one. Each device samples are
+            * time synced by the module \c samples_time_sync_mode, then the latest sample set of each device is matched with the latest sample sets
+            * of the other devices, once every device has one. The devices clocks are independent, so the sample sets are matched by their arrival,
+            * like the samples of an external camera. The images lifetime is managed as in \c process_sample_set().
+            * @param[in]  sample_sets    The sample set of each device, indexed by the device order in the pipeline
+            * @param[in]  device_count   Number of sample sets
+            * @return status_no_error             Successful execution
+            * @return status_feature_unsupported  The module doesn't support multi-device configurations
+            */
+            virtual status process_multi_device_sample_set(const correlated_sample_set * sample_sets, uint32_t device_count) { return status_feature_unsupported; }
+
+            /**
+            * @brief Processes a batch of sample sets together.
+            *
+            * Called instead of \c process_sample_set() when the module configuration \c max_batch_size is larger than one, so a module which
+            * runs on an accelerator processes several sample sets with a single dispatch. The sample sets are time synced as the sample sets of
+            * \c process_sample_set(), and are ordered from the oldest to the newest. The images lifetime is managed as in \c process_sample_set().
+            * @param[in]  sample_sets    The sample sets of the batch
+            * @param[in]  count          Number of sample sets, at most the module configuration \c max_batch_size
+            * @return status_no_error             Successful execution
+            * @return status_feature_unsupported  The module doesn't process batches, each sample set is processed by \c process_sample_set()
+            */
+            virtual status process_sample_set_batch(const correlated_sample_set * sample_sets, uint32_t count) { return status_feature_unsupported; }
+
+            /**
+            * @brief Returns a hash of the module parameters which its output depends on, so its output can be memoized.
+            *
+            * A sync module which returns a hash is memoized by a playback pipeline with a module outputs cache, see
+            * \c pipeline_async_interface::set_module_outputs_cache(). The output of each processed sample set is saved by \c save_module_output(),
+            * and a replayed sample set whose output was saved with the same module uid and hash is restored by \c restore_module_output()
+            * instead of being processed. The hash should change with any parameter, model or module version which changes the output.
+            * @param[out] config_hash             The hash of the module configuration and parameters
+            * @return status_no_error             Successful execution
+            * @return status_feature_unsupported  The module output isn't memoized
+            */
+            virtual status query_module_config_hash(uint64_t & config_hash) { return status_feature_unsupported; }
+
+            /**
+            * @brief Serializes the module output of a sample set, called once \c process_sample_set() processed the sample set successfully.
+            *
+            * @param[in]  sample_set              The processed sample set
+            * @param[out] output                  The serialized output, restored by \c restore_module_output()
+            * @return status_no_error             Successful execution
+            * @return status_feature_unsupported  The output of the sample set isn't memoized
+            */
+            virtual status save_module_output(const correlated_sample_set & sample_set, std::vector<uint8_t> & output) { return status_feature_unsupported; }
+
+            /**
+            * @brief Sets the module output of a sample set from its output serialized by \c save_module_output(), instead of processing it.
+            *
+            * The module state and output should be as if the sample set was processed, the images lifetime is managed as in \c process_sample_set().
+            * @param[in]  sample_set              The replayed sample set
+            * @param[in]  output                  The serialized output
+            * @param[in]  size                    The serialized output size, in bytes
+            * @return status_no_error             Successful execution
+            * @return status_feature_unsupported  The output can't be restored, the sample set is processed
+            */
+            virtual status restore_module_output(const correlated_sample_set & sample_set, const uint8_t * output, uint32_t size) { return status_feature_unsupported; }
+
             /**
             * @brief User-provided callback to handle processing events generated by modules and the device.
             *
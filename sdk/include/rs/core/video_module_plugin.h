@@ -0,0 +1,66 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file video_module_plugin.h
+* @brief
+* Describes the entry points of a computer vision module shared library, which is loaded on demand by \c rs::core::video_module_registry.
+*
+* A module library exports its entry points by the \c RS_VIDEO_MODULE_PLUGIN macro, in one of its source files:
+* \code
+* RS_VIDEO_MODULE_PLUGIN(rs::cv_modules::max_depth_value_module)
+* \endcode
+*/
+
+#pragma once
+#include <stdint.h>
+#include "rs_sdk_version.h"
+#include "rs/core/video_module_interface.h"
+
+#ifdef WIN32
+#define RS_VIDEO_MODULE_PLUGIN_EXPORT extern "C" __declspec(dllexport)
+#else
+#define RS_VIDEO_MODULE_PLUGIN_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+/**
+* @brief The entry point names of a module library.
+*/
+#define RS_VIDEO_MODULE_PLUGIN_VERSION_FUNC "rs_video_module_plugin_version"
+#define RS_VIDEO_MODULE_PLUGIN_CREATE_FUNC  "rs_video_module_plugin_create"
+#define RS_VIDEO_MODULE_PLUGIN_DESTROY_FUNC "rs_video_module_plugin_destroy"
+
+extern "C" {
+    /**
+    * @brief Returns the SDK version the library was built with and the size of its \c supported_module_config, the library is
+    *        loaded only if they match the loading SDK.
+    */
+    typedef void (*rs_video_module_plugin_version_func)(int32_t * major, int32_t * minor, uint32_t * supported_config_size);
+    /**
+    * @brief Creates the module instance of the library.
+    */
+    typedef rs::core::video_module_interface * (*rs_video_module_plugin_create_func)();
+    /**
+    * @brief Destroys a module instance, which the library created.
+    */
+    typedef void (*rs_video_module_plugin_destroy_func)(rs::core::video_module_interface * module);
+}
+
+/**
+* @brief Defines the entry points of a module library, whose module class is default constructible.
+*/
+#define RS_VIDEO_MODULE_PLUGIN(module_class)                                                                                            \
+    RS_VIDEO_MODULE_PLUGIN_EXPORT void rs_video_module_plugin_version(int32_t * major, int32_t * minor, uint32_t * supported_config_size) \
+    {                                                                                                                                   \
+        *major = SDK_VER_MAJOR;                                                                                                         \
+        *minor = SDK_VER_MINOR;                                                                                                         \
+        *supported_config_size = sizeof(rs::core::video_module_interface::supported_module_config);                                     \
+    }                                                                                                                                   \
+    RS_VIDEO_MODULE_PLUGIN_EXPORT rs::core::video_module_interface * rs_video_module_plugin_create()                                    \
+    {                                                                                                                                   \
+        return new module_class();                                                                                                      \
+    }                                                                                                                                   \
+    RS_VIDEO_MODULE_PLUGIN_EXPORT void rs_video_module_plugin_destroy(rs::core::video_module_interface * module)                        \
+    {                                                                                                                                   \
+        delete module;                                                                                                                  \
+    }
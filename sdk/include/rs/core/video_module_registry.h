@@ -0,0 +1,166 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file video_module_registry.h
+* @brief Describes the \c rs::core::video_module_registry class.
+*/
+
+#pragma once
+#include "rs/core/video_module_interface.h"
+#include "rs/core/video_module_plugin.h"
+
+#ifdef WIN32
+#ifdef realsense_pipeline_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_pipeline_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Forward declaration for the registry implementation, as part of the pimpl pattern.
+        */
+        class video_module_registry_impl;
+
+        /**
+        * @brief Catalog of the computer vision modules of shared libraries, which are loaded only once a module is configured.
+        *
+        * Each module library, which exports the \c RS_VIDEO_MODULE_PLUGIN entry points, is described by a manifest file next to it,
+        * named as the library with the \c .manifest extension. The manifest holds the module uid and its supported configurations, so
+        * the catalog is enumerated and the modules are matched to a configuration without loading their libraries. The manifest
+        * is written once for a library, by \c write_manifest(), usually when the library is installed.
+        *
+        * \c create_module() returns a module, which answers \c query_module_uid() and \c query_supported_module_config() from the
+        * manifest. The module library is loaded and the module instance is created on the first \c set_module_config(), the other
+        * methods are forwarded to the instance once it's created. The modules are added to the pipeline as any other module, the
+        * pipeline configures each module it was given, so only the libraries of the added modules are loaded. A library is unloaded
+        * once all its modules are destroyed.
+        *
+        * The registry owns the modules it creates, it must outlive the pipeline they're added to.
+        */
+        class DLL_EXPORT video_module_registry
+        {
+        public:
+            /**
+            * @brief Describes a module of the catalog.
+            */
+            struct module_info
+            {
+                int32_t  uid;                      /**< The module uid */
+                char     library_path[1024];       /**< The module library path, null terminated */
+                uint32_t supported_configs_count;  /**< The number of the module supported configurations */
+            };
+
+            video_module_registry();
+
+            video_module_registry(const video_module_registry&) = delete;
+            video_module_registry& operator= (const video_module_registry&) = delete;
+            video_module_registry(video_module_registry&&) = delete;
+            video_module_registry& operator= (video_module_registry&&) = delete;
+
+            /**
+            * @brief Adds the modules of the manifests in a directory to the catalog, the module libraries aren't loaded.
+            *
+            * The manifests which can't be read, or which were written by another SDK version, are skipped.
+            * @param[in] directory_path           The directory of the module libraries and their manifests
+            * @return status_no_error             At least one module was added
+            * @return status_item_unavailable     The directory has no valid manifest
+            * @return status_file_open_failed     The directory can't be opened
+            * @return status_handle_invalid       Null directory path
+            */
+            status add_directory(const char * directory_path);
+
+            /**
+            * @brief Adds the module of a manifest to the catalog, the module library isn't loaded.
+            *
+            * @param[in] manifest_path            The manifest path, the library is in the manifest directory
+            * @return status_no_error             The module was added
+            * @return status_file_open_failed     The manifest can't be opened
+            * @return status_file_read_failed     The manifest is corrupted or was written by another SDK version
+            * @return status_key_already_exists   A module of the same uid is in the catalog
+            * @return status_handle_invalid       Null manifest path
+            */
+            status add_manifest(const char * manifest_path);
+
+            /**
+            * @brief Returns the number of the modules in the catalog.
+            */
+            uint32_t query_modules_count() const;
+
+            /**
+            * @brief Describes the module of an index in the catalog.
+            *
+            * @param[in]  index                   The module index in the catalog
+            * @param[out] info                    The module description
+            * @return status_no_error             Successful execution
+            * @return status_value_out_of_range   The index is out of the catalog range
+            */
+            status query_module_info(uint32_t index, module_info & info) const;
+
+            /**
+            * @brief Returns a supported configuration of a module in the catalog, as its \c query_supported_module_config().
+            *
+            * @param[in]  index                   The module index in the catalog
+            * @param[in]  idx                     The supported configuration index
+            * @param[out] supported_config        The supported configuration
+            * @return status_no_error             Successful execution
+            * @return status_value_out_of_range   The module index or the configuration index is out of range
+            */
+            status query_supported_module_config(uint32_t index, int32_t idx, video_module_interface::supported_module_config & supported_config) const;
+
+            /**
+            * @brief Finds the catalog index of a module uid.
+            *
+            * @param[in]  uid                     The module uid
+            * @param[out] index                   The module index in the catalog
+            * @return status_no_error             Successful execution
+            * @return status_item_unavailable     No module of the uid is in the catalog
+            */
+            status find_module(int32_t uid, uint32_t & index) const;
+
+            /**
+            * @brief Creates a module of the catalog, whose library is loaded on its first \c set_module_config().
+            *
+            * Each call creates another module instance. The module is owned by the registry.
+            * @param[in] index                    The module index in the catalog
+            * @return video_module_interface*     The module
+            * @return nullptr                     The index is out of the catalog range
+            */
+            video_module_interface * create_module(uint32_t index);
+
+            /**
+            * @brief Returns the module instance of the library, which a module of the registry forwards to.
+            *
+            * The instance is used to query the module specific output interface, by \c dynamic_cast.
+            * @param[in] module                   A module created by \c create_module()
+            * @return video_module_interface*     The module instance of the library
+            * @return nullptr                     The module wasn't created by the registry or its library wasn't loaded yet
+            */
+            video_module_interface * query_loaded_module(video_module_interface * module) const;
+
+            /**
+            * @brief Writes the manifest of a module library, the library is loaded and its module is created to query its configurations.
+            *
+            * @param[in] library_path             The module library path
+            * @param[in] manifest_path            The manifest path, nullptr writes the manifest next to the library
+            * @return status_no_error             Successful execution
+            * @return status_init_failed          The library can't be loaded, doesn't export the module entry points or was built by another
+            *                                     SDK version
+            * @return status_file_write_failed    The manifest can't be written
+            * @return status_handle_invalid       Null library path
+            */
+            static status write_manifest(const char * library_path, const char * manifest_path = nullptr);
+
+            ~video_module_registry();
+        private:
+            video_module_registry_impl * m_pimpl;
+        };
+    }
+}
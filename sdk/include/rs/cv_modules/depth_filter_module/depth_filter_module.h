@@ -0,0 +1,72 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/** 
+* \file depth_filter_module.h
+* @brief Describes the \c rs::cv_modules::depth_filter_module class.
+**/
+
+#pragma once
+#include "rs_core.h"
+#include "rs/cv_modules/depth_filter_module/depth_filter_output_interface.h"
+
+#ifdef WIN32 
+#ifdef realsense_depth_filter_module_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_depth_filter_module_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace cv_modules
+    {
+        /**
+        * @brief Forward declaration for the depth filter module implementation, as part of the pimpl pattern.
+        */
+        class DLL_EXPORT depth_filter_module_impl;
+
+        /**
+         * @brief Computer vision module that post-processes the depth images with decimation, edge-preserving spatial filtering,
+         * temporal filtering and hole filling.
+         *
+         * The module processes synchronously, the filtered image of a depth image is available when \c process_sample_set returns.
+         * The filters run in place on the output buffer, in parallel row bands and column strips.
+         * See the interfaces for complete documentation.
+         */
+        class DLL_EXPORT depth_filter_module : public rs::core::video_module_interface,
+                                               public depth_filter_output_interface
+        {
+        public:
+            depth_filter_module();
+
+            depth_filter_module(const depth_filter_module&) = delete;
+            depth_filter_module& operator= (const depth_filter_module&) = delete;
+            depth_filter_module(depth_filter_module&&) = delete;
+            depth_filter_module& operator= (depth_filter_module&&) = delete;
+
+            // video_module_interface interface
+            int32_t query_module_uid() override;
+            core::status query_supported_module_config(int32_t idx, supported_module_config &supported_config) override;
+            core::status query_current_module_config(actual_module_config &module_config) override;
+            core::status set_module_config(const actual_module_config &module_config) override;
+            core::status process_sample_set(const core::correlated_sample_set & sample_set) override;
+            core::status register_event_handler(processing_event_handler *handler) override;
+            core::status unregister_event_handler(processing_event_handler *handler) override;
+            core::status flush_resources() override;
+            core::status reset_config() override;
+
+            // depth_filter_output_interface interface
+            core::status set_options(const depth_filter_options & options) override;
+            depth_filter_options query_options() override;
+            core::image_interface * query_filtered_depth_image() override;
+
+            ~depth_filter_module();
+        private:
+            depth_filter_module_impl * m_pimpl;
+        };
+    }
+}
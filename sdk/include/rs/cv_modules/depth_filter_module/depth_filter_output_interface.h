@@ -0,0 +1,78 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/** 
+* \file depth_filter_output_interface.h
+* @brief Describes the \c rs::cv_modules::depth_filter_output_interface class.
+**/ 
+
+#pragma once
+#include <stdint.h>
+#include "rs/core/image_interface.h"
+#include "rs/core/status.h"
+
+namespace rs
+{
+    namespace cv_modules
+    {
+        /**
+         * @brief Depth post-processing filters output interface, returns the filtered depth images of the depth images stream.
+         *
+         * The input stream is defined through \c rs::core::video_module_interface.
+         */
+        class depth_filter_output_interface
+        {
+        public:
+            /**
+             * @brief Depth post-processing filters parameters, applied in the order of the fields.
+             */
+            struct depth_filter_options
+            {
+                uint32_t decimation_factor;     /**< Downscales the depth image by 1, 2, 4 or 8, taking the lower median of the valid depth of each block */
+                bool     spatial_filter;        /**< Enables the edge-preserving spatial filter, which smooths the depth along the rows and the columns */
+                float    spatial_alpha;         /**< Weight of the current pixel against the smoothed previous pixel, in (0, 1]. Lower values smooth more */
+                uint16_t spatial_delta;         /**< Depth step, in depth units, above which neighbouring pixels are across an edge and aren't smoothed */
+                uint32_t spatial_iterations;    /**< Number of spatial filter passes, 1 to 5 */
+                bool     temporal_filter;       /**< Enables the temporal filter, an exponential moving average of each pixel over the frames */
+                float    temporal_alpha;        /**< Weight of the current frame against the average, in (0, 1]. Lower values smooth more */
+                uint16_t temporal_delta;        /**< Depth step, in depth units, above which the pixel changed and the average restarts */
+                uint32_t persistence_frames;    /**< A hole keeps the last depth of the pixel if it was valid in at least this many of the last 8 frames, 0 keeps the holes */
+                bool     hole_filling;          /**< Fills the remaining holes with the nearest valid depth on their left */
+            };
+
+            /**
+             * @brief Returns the default filters parameters: no decimation, 2 spatial passes and a temporal filter persisting
+             * pixels valid in 3 of the last 8 frames, without hole filling.
+             */
+            static depth_filter_options query_default_options()
+            {
+                return { 1, true, 0.5f, 20, 2, true, 0.4f, 20, 3, false };
+            }
+
+            /**
+             * @brief Sets the filters parameters, applied from the next processed depth image.
+             *
+             * Changing the decimation factor restarts the temporal filter.
+             * @param[in] options                   Filters parameters
+             * @return status_no_error              Successful execution
+             * @return status_param_unsupported     A parameter is out of its range
+             */
+            virtual rs::core::status set_options(const depth_filter_options & options) = 0;
+
+            /**
+             * @brief Returns the current filters parameters.
+             */
+            virtual depth_filter_options query_options() = 0;
+
+            /**
+             * @brief Returns the filtered image of the latest processed depth image.
+             *
+             * The image data is taken from a buffer pool of the module, and is returned to the pool when the image is released.
+             * @return rs::core::image_interface *  The filtered z16 image, the caller shares its ownership and must release it. Null if no image was processed
+             */
+            virtual rs::core::image_interface * query_filtered_depth_image() = 0;
+
+            virtual ~depth_filter_output_interface() {}
+        };
+    }
+}
@@ -66,6 +66,25 @@ namespace rs
             // max_depth_value_output_interface interface
             max_depth_value_output_data get_max_depth_value_data() override;
 
+            /**
+             * @brief Sets the depth image region in which the maximum depth value is searched.
+             *
+             * The region is clamped to the image, a region with zero width or height selects the whole image, which is the default.
+             * @param[in] roi       Region of interest, in pixels
+             * @return status_no_error              Successful execution
+             * @return status_invalid_argument      Negative region coordinates or size
+             */
+            core::status set_roi(const core::rect & roi);
+
+            /**
+             * @brief Sets the number of threads which process each depth image, the image rows are split to as many bands, which run on
+             * the calling thread and on the image processing workers shared by the SDK.
+             * @param[in] number_of_threads     Number of processing threads, 1 by default
+             * @return status_no_error              Successful execution
+             * @return status_param_unsupported     Zero threads or more threads than supported
+             */
+            core::status set_number_of_processing_threads(uint32_t number_of_threads);
+
             ~max_depth_value_module();
         private:
             max_depth_value_module_impl * m_pimpl;
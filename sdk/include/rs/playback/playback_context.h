@@ -7,6 +7,8 @@
 */
 
 #pragma once
+#include <memory>
+#include <vector>
 #include <librealsense/rs.hpp>
 #include "rs/core/context.h"
 
@@ -25,21 +27,40 @@ namespace rs
     namespace playback
     {
         class device;
+        class playback_clock;
         /**
         * @brief Implements \c rs::core::context_interface for playback from recorded files. 
 		*
 		* See the interface class for more details.
+		* Setting the RS_SDK_PLAYBACK_DIRECT_IO environment variable to 1 reads the local recordings with direct io, bypassing the page cache,
+		* for batch jobs which read large recordings once without evicting the cached files of the other processes of the host.
+		* Setting the RS_SDK_PLAYBACK_SHARED_CACHE environment variable to a size in megabytes shares the decoded frames of the intra coded
+		* streams between the processes of the host which play the same recording, through a shared memory cache of that size.
         */
         class DLL_EXPORT context : public rs::core::context_interface
         {
         public:
             context(const char * file_path);
+
+            /**
+            * @brief Creates a context of recordings which are played together, such as the recordings of the cameras of a multi-camera rig.
+            *
+            * Each recording is played by its own device. The devices share a playback clock, the recordings are placed on a common
+            * time line by the host time of their first frames, so the frames captured together by the cameras are played together.
+            * A device which is started while other devices of the context are streaming joins their playback clock.
+            * When the devices aren't playing in real time, the frames of all the streaming devices are delivered in the order of the
+            * common time line, as fast as the files are read, so the recordings are reprocessed reproducibly.
+            * The reads of all the playback devices are scheduled on a single pool of threads.
+            * @param[in] file_paths     The recordings files.
+            * @param[in] files_count    Number of recordings.
+            */
+            context(const char ** file_paths, int files_count);
             ~context();
 
             /**
             * @brief Gets number of available playback devices.
             *
-            * The playback context provides access to the single device that was recorded in the session. Therefore, this method always returns 1.
+            * The playback context provides access to the device that was recorded in each of its recordings.
             * @return int Number of available devices
             */
             int get_device_count() const override;
@@ -61,12 +82,42 @@ namespace rs
              */
              device * get_playback_device();
 
+             /**
+             * @brief Gets the playback device of a recording.
+             * @param[in] index Zero-based index of the recording in the context.
+             * @return playback::device* Requested device, null if the index is out of range.
+             */
+             device * get_playback_device(int index);
+
+             /**
+             * @brief Gets the start of a recording on the common time line of the recordings of the context.
+             * @param[in] index Zero-based index of the recording in the context.
+             * @return uint64_t Microseconds from the start of the earliest recording.
+             */
+             uint64_t get_start_time(int index) const;
+
+             /**
+             * @brief Sets the file read location of all the devices of the context to a time on the common time line.
+             *
+             * Each device is set to the first frame captured at or after the time, see \c rs::playback::device::set_frame_by_timestamp.
+             * A recording which starts after the time is set to its first frame, which is played once the playback clock reaches its start.
+             * The streaming devices are paused while the method executes, and continue together from the time.
+             * @param[in] time  Microseconds from the start of the earliest recording.
+             * @return
+             * - true     All the devices are set to the time
+             * - false    The time is after the end of a recording
+             */
+             bool set_time(uint64_t time);
+
         private:
             context(const context& cxt) = delete;
             context& operator=(const context& cxt) = delete;
 
-            rs_device **    m_devices;
-            bool            m_init_status;
+            rs_device **                        m_devices;
+            int                                 m_devices_count;
+            bool                                m_init_status;
+            std::shared_ptr<playback_clock>     m_clock; //null for the context of a single recording
+            std::vector<uint64_t>               m_start_times;
         };
     }
 }
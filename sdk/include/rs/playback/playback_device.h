@@ -8,6 +8,10 @@
 */
   
 #pragma once
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
 #include <librealsense/rs.hpp>
 
 #ifdef WIN32 
@@ -42,6 +46,24 @@ namespace rs
             rs_linux_format = 1   /**<  Linux SDK format */
         };
 
+        /**
+        * @brief Defines which frame is dropped when a frame arrives to a full stream frames queue in real time mode.
+        */
+        enum frame_drop_policy
+        {
+            drop_oldest_frame = 0, /**<  The oldest queued frame is dropped, the application gets the most recent frames */
+            drop_newest_frame = 1  /**<  The arriving frame is dropped, the queued frames are delivered in order */
+        };
+
+        /**
+        * @brief Allocates the buffer a decoded frame is written to.
+        *
+        * The allocator is called with the frame width, height and bytes per pixel, and with the stride set to the frame row size,
+        * which can be enlarged to pad the rows. The returned buffer must hold height rows of stride bytes, it is released by the playback
+        * once the frame is released. Returning null decodes the frame into a playback owned buffer.
+        */
+        typedef std::function<std::shared_ptr<uint8_t>(int width, int height, int bpp, int & stride)> frame_buffer_allocator;
+
         /**
         * @brief Describes the record software stack versions and file configuration.
         */
@@ -54,6 +76,72 @@ namespace rs
             playback::file_format           type;                        /**<  Indicates the file format, which is derived from the software stack that recorded it: Windows/Android RSSDK or Linux SDK */
         };
 
+        /**
+        * @brief Result of the verification of the checksums of a file.
+        */
+        struct verification_result
+        {
+            uint64_t                        verified_samples_count;      /**<  Samples whose chunks match their checksum */
+            uint64_t                        corrupted_samples_count;     /**<  Samples whose chunks don't match their checksum, or can't be read */
+            uint64_t                        first_corrupted_offset;      /**<  File offset of the first corrupted sample, valid if corrupted samples were found */
+        };
+
+        /**
+        * @brief The timing and metadata of a recorded frame, read without its image data.
+        */
+        struct frame_descriptor
+        {
+            rs::stream                      stream;
+            int32_t                         frame_index;                 /**<  Index of the frame in its stream, see \c rs::playback::device::set_frame_by_index() */
+            unsigned long long              frame_number;                /**<  Camera frame number */
+            double                          time_stamp;                  /**<  Camera time stamp, in milliseconds */
+            rs::timestamp_domain            time_stamp_domain;
+            long long                       system_time;                 /**<  Host time the frame arrived at, in milliseconds */
+            uint64_t                        capture_time;                /**<  Capture time, in microseconds from the beginning of the recording */
+            uint32_t                        metadata_mask;               /**<  Bit i is set if the frame has the value of \c rs::frame_metadata i */
+            double                          metadata[RS_FRAME_METADATA_COUNT];
+        };
+
+        /**
+        * @brief A downscaled frame of the preview track of a recording, see \c rs::record::device::set_preview().
+        */
+        struct preview_frame
+        {
+            int32_t                         width;
+            int32_t                         height;
+            rs::format                      format;
+            int32_t                         stride;                      /**<  Bytes between the starts of consecutive rows */
+            int32_t                         scale;                       /**<  The recorded frame width and height divided by the preview width and height */
+            int32_t                         frame_index;                 /**<  Index of the recorded frame in its stream, see \c rs::playback::device::set_frame_by_index() */
+            unsigned long long              frame_number;                /**<  Camera frame number of the recorded frame */
+            uint64_t                        capture_time;                /**<  Capture time of the recorded frame, in milliseconds from the beginning of the recording */
+            std::shared_ptr<const uint8_t>  data;                        /**<  The preview image, height rows of stride bytes */
+        };
+
+        /**
+        * @brief The motion or time stamp samples of a motion source in a time range, a column per sample field.
+        */
+        struct motion_columns
+        {
+            std::vector<uint64_t>           capture_times;               /**<  Capture times, in microseconds from the beginning of the recording */
+            std::vector<double>             time_stamps;                 /**<  Camera time stamps, in milliseconds */
+            std::vector<unsigned long long> frame_numbers;
+            std::vector<float>              x;                           /**<  Values of the first axis of a motion source, empty for a time stamp source */
+            std::vector<float>              y;                           /**<  Values of the second axis of a motion source, empty for a time stamp source */
+            std::vector<float>              z;                           /**<  Values of the third axis of a motion source, empty for a time stamp source */
+        };
+
+        /**
+        * @brief The time synced frames sets of a recording, see \c rs::playback::device::compute_synced_sets().
+        */
+        struct synced_sets
+        {
+            std::vector<rs::stream>         streams;                     /**<  The synced streams, in the order of the frame indices of a set */
+            std::vector<int32_t>            frame_indices;               /**<  Index in its stream of each frame of each set, the frames of set i start at i * streams.size() */
+            std::vector<double>             time_stamps;                 /**<  Time stamp of each set, the time stamp of its latest frame, in milliseconds */
+            size_t size() const { return time_stamps.size(); }
+        };
+
         /**
         * @brief Extends librealsense \c rs::device to provide playback capabilities. Commonly used for debug, testing and validation with known input.
         *
@@ -105,6 +193,29 @@ namespace rs
             */
             bool set_frame_by_timestamp(uint64_t timestamp);
 
+            /**
+            * @brief Waits for the next time synced frames set, as \c rs::device::wait_for_frames, within a time limit.
+            *
+            * The method is used in synced mode only, by an application which doesn't block indefinitely when the frames stop, e.g.
+            * when the playback is paused by another thread.
+            * @param[in] timeout  Time limit of the wait, in milliseconds.
+            * @return
+            * - true     The frames set is available by \c rs::device::get_frame_data
+            * - false    The time limit passed, or the streaming stopped, before a frames set was available
+            */
+            bool try_wait_for_frames(uint32_t timeout);
+
+            /**
+            * @brief Gets an operating system handle which is signaled while a time synced frames set is available to \c rs::device::poll_for_frames.
+            *
+            * The handle integrates the synced mode playback in the event loop of the application: on linux the handle is an eventfd
+            * descriptor, which is readable in epoll or poll, on windows it's an event handle for WaitForMultipleObjects.
+            * The handle is reset by \c rs::device::poll_for_frames and the wait for frames methods, which consume the frames set.
+            * The handle is owned by the device, and is valid for the device lifetime.
+            * @return intptr_t The handle, -1 if the platform doesn't support it.
+            */
+            intptr_t get_frames_ready_handle();
+
             /**
             * @brief Gets the index of current frame.
             *
@@ -138,6 +249,262 @@ namespace rs
             */
             bool is_real_time();
 
+            /**
+            * @brief Sets the playback rate and direction.
+            *
+            * In real time mode the samples are delivered at the rate multiple of the recorded rate, a negative rate plays the file backwards.
+            * Playing backwards decodes the frames of a stream with temporal compression from their keyframe, which costs up to a keyframe interval
+            * of decodes per frame. When playing faster than the recorded rate, a frame whose next frame of the same stream is already due is skipped
+            * without being read or decoded, the skipped frames are not counted as frame drops. Non-real time mode delivers all the frames in the
+            * playback direction as fast as they're read.
+            * Changing the direction continues the playback from the last delivered sample, a playback which didn't deliver a sample yet
+            * is played backwards from the end of the file. The playback plays backwards from the end of the file after it is stopped.
+            * The method can be called while streaming. The default rate is 1.
+            * @param[in] rate  Playback rate, its absolute value must be between 0.25 and 16
+            * @return
+            * - true     The rate is set
+            * - false    The rate is out of range
+            */
+            bool set_playback_rate(double rate);
+
+            /**
+            * @brief Gets the playback rate, negative while playing backwards.
+            *
+            * For more details, see the \c rs::playback::device::set_playback_rate() method.
+            * @return double Playback rate
+            */
+            double get_playback_rate();
+
+            /**
+            * @brief Sets the frames queue of the stream callback in real time mode.
+            *
+            * In asynced playback each stream callback is called from a dedicated thread, which takes the frames from a bounded queue.
+            * The file is read at the recorded rate regardless of the callbacks processing time, so a slow callback drops frames of its own stream only.
+            * Frames that are dropped by the queue policy are counted as frame drops of the stream.
+            * In non-real time mode the frames are delivered without drops, and a slow callback slows down the playback of all streams.
+            * The method can be called only while the device is not streaming. The default queue size is 1 with \c drop_oldest_frame policy.
+            * @param[in] stream      Stream type for which the queue is set
+            * @param[in] queue_size  Maximal number of frames waiting for the stream callback, must be positive
+            * @param[in] policy      Frame drop policy applied when the queue is full
+            * @return
+            * - true     The queue is set
+            * - false    The device is streaming or the queue size is 0
+            */
+            bool set_frame_queue(rs::stream stream, uint32_t queue_size, frame_drop_policy policy);
+
+            /**
+            * @brief Sets the number of samples that are read and decoded ahead of their delivery.
+            *
+            * The compressed frames in the window are decoded by worker threads, frames of different streams are decoded concurrently.
+            * The samples are delivered in file order regardless of the window size. The window is mostly useful in non-real time mode,
+            * where the playback rate is limited by the decoding rate. The read ahead applies to files which can be memory mapped.
+            * The method can be called only while the device is not streaming. The default window is 0, each sample is decoded when it's delivered.
+            * @param[in] samples_count  Number of samples in the read ahead window
+            * @return
+            * - true     The window is set
+            * - false    The device is streaming
+            */
+            bool set_read_ahead_window(uint32_t samples_count);
+
+            /**
+            * @brief Delivers a part of the frames of the stream, every Nth frame or a frame per period of capture time, for quick looks at long recordings.
+            *
+            * The frames are selected by the samples index, the other frames of the stream are neither read nor decoded and are not counted as frame
+            * drops. A frame is selected if its index in the stream is a multiple of the frames interval, and if it's the first frame of its period
+            * of the frame rate, so the same frames are selected in both playback directions and after a seek. The frames which a stream with temporal
+            * compression skips are decoded as references of its next selected frame, unless a keyframe of the stream is closer. The decimation
+            * applies to the streaming playback, the batch reads and the seeks read the requested frames.
+            * The method can be called only while the device is not streaming. By default every frame is delivered.
+            * @param[in] stream           Stream type for which the decimation is set
+            * @param[in] frames_interval  Frames between the selected frames, 0 or 1 selects every frame
+            * @param[in] frame_rate       Maximal rate of the selected frames in frames per second of capture time, 0 doesn't limit the rate
+            * @return
+            * - true     The decimation is set
+            * - false    The device is streaming or the frame rate is negative
+            */
+            bool set_frame_decimation(rs::stream stream, uint32_t frames_interval, double frame_rate);
+
+            /**
+            * @brief Plays the file in a loop, the samples of the first pass are held in memory and replayed by the next loops.
+            *
+            * The samples delivered by the first pass are copied to memory as they were decoded, so the next loops don't read or decode
+            * the file, and a soak test measures the processing of the application rather than the storage and the decoders.
+            * Each loop is delivered with fresh times: the capture times, time stamps and system times continue from the end of the previous loop,
+            * and the frame numbers continue from the last frame number of the stream. The end of file is never reached while looping.
+            * The file is read again at each loop if the first pass didn't start at the beginning of the file, if it was interrupted by a seek,
+            * or if its samples don't fit the memory size. The loop plays forward, a negative playback rate ends the playback at the end of the file.
+            * The method can be called only while the device is not streaming. The playback doesn't loop by default.
+            * @param[in] looped            Indicates whether the file is played in a loop
+            * @param[in] max_memory_size   Maximal size of the samples held in memory, in bytes
+            * @return
+            * - true     The loop is set
+            * - false    The device is streaming
+            */
+            bool set_looped_playback(bool looped, uint64_t max_memory_size);
+
+            /**
+            * @brief Sets the allocator of the buffers the compressed frames of the stream are decoded into.
+            *
+            * Decoding into application buffers, such as pinned or shared memory, saves the copy of the decoded frame.
+            * The frame stride reported by the delivered frames is the stride of the allocated buffer. Uncompressed frames are delivered as before.
+            * The method can be called only while the device is not streaming. An empty allocator restores the default buffers.
+            * @param[in] stream     Stream type for which the allocator is set
+            * @param[in] allocator  Buffers allocator, called on the playback read or decode threads
+            * @return
+            * - true     The allocator is set
+            * - false    The device is streaming
+            */
+            bool set_frame_buffer_allocator(rs::stream stream, frame_buffer_allocator allocator);
+
+            /**
+            * @brief Reads the next batch of correlated frames sets of the enabled streams, as fast as the file can be read and decoded.
+            *
+            * The batch read is a pull alternative to streaming, designed for offline processing of recordings. No callback threads are used and the
+            * frames are not paced by their capture time, the frames are read in file order and delivered without drops.
+            * A set holds at most a single frame of each enabled stream. It is closed when it holds a frame of each enabled stream, or when the next
+            * frame of a stream which is already in the set is read, so a set of an asynced recording may miss some of the streams.
+            * The read ahead window, set with \c set_read_ahead_window(), decodes the frames of the next sets while the application processes the batch.
+            * Motion samples are not delivered by the batch read. The method can be called only while the device is not streaming.
+            * Seeking with \c set_frame_by_index() or \c set_frame_by_timestamp() sets the position of the next batch read.
+            * @param[out] batch     The frames sets, the vector is cleared before it's filled, so reusing the same vector keeps its allocation between calls
+            * @param[in]  max_sets  Maximal number of sets to read
+            * @return uint32_t Number of sets in the batch, 0 if the end of file was reached
+            */
+            uint32_t read_frames_batch(std::vector<std::map<rs::stream, rs::frame>> & batch, uint32_t max_sets);
+
+            /**
+            * @brief Matches the frames of streams by their time stamps over the whole recording, without reading the frames.
+            *
+            * The offline alternative to \c rs::utils::samples_time_sync_interface, the time stamps of each stream are taken from the index of
+            * the recording and all the sets are matched in a single pass over them, with no buffering latency and no frames inserted one by one.
+            * A set holds a frame of each stream, the frames of a set are within the time difference of the latest frame of the set, and each
+            * stream contributes the frame closest to it. The frames which have no match in the other streams are not in any set.
+            * The sets are read with \c read_synced_sets(), and can be kept to read the same sets again.
+            * The method indexes the whole recording, it can be called only while the device is not streaming.
+            * @param[in]  streams               The synced streams, at least one
+            * @param[in]  max_time_difference   Maximal time difference of the frames of a set in milliseconds, 0 for half the frame period of the fastest stream
+            * @param[out] sets                  The synced sets in time stamp order, cleared before they're filled
+            * @return
+            * - true     The sets were computed
+            * - false    The device is streaming, or a stream isn't recorded
+            */
+            bool compute_synced_sets(const std::vector<rs::stream> & streams, double max_time_difference, synced_sets & sets);
+
+            /**
+            * @brief Reads the frames of synced sets, as \c read_frames_batch() reads the sets of the file order.
+            *
+            * The frames of a set are decoded in parallel by the decoder threads. The frames of a stream which are skipped between the sets are
+            * decoded only if the stream has temporal compression. The method can be called only while the device is not streaming.
+            * @param[in]  sets       Sets computed by \c compute_synced_sets()
+            * @param[in]  first_set  Index of the first set to read
+            * @param[out] batch      The frames sets, the vector is cleared before it's filled
+            * @param[in]  max_sets   Maximal number of sets to read
+            * @return uint32_t Number of sets in the batch, 0 if first_set is past the last set
+            */
+            uint32_t read_synced_sets(const synced_sets & sets, uint32_t first_set, std::vector<std::map<rs::stream, rs::frame>> & batch, uint32_t max_sets);
+
+            /**
+            * @brief Creates a new file from a time range and a subset of the streams of the played file, without decoding the frames.
+            *
+            * The compressed samples are copied from the played file as is, so extracting a clip costs a file copy of the clip size.
+            * The capture times of the clip start at the beginning of the requested range.
+            * A stream with temporal compression is extracted from its first keyframe in the range, so its first frames in the range may be omitted.
+            * The method is supported for files of the current Linux SDK format, and can be called only while the device is not streaming.
+            * @param[in] file_path        Path of the created file, must be different from the played file path
+            * @param[in] start_time       Capture time of the first copied sample, in milliseconds from the beginning of the recording
+            * @param[in] end_time         Capture time of the end of the range, in milliseconds from the beginning of the recording, the samples captured at this time are excluded
+            * @param[in] streams          Streams to extract, the other streams are omitted from the created file
+            * @param[in] include_motions  Indicates whether the motion and time stamp samples in the range are extracted
+            * @return
+            * - true     The clip file was created
+            * - false    The device is streaming, the arguments are invalid, the file format is not supported, or a file operation failed
+            */
+            bool extract(const char * file_path, uint64_t start_time, uint64_t end_time, const std::vector<rs::stream> & streams, bool include_motions);
+
+            /**
+            * @brief Verifies the checksums of the samples of the played file, without decoding the frames.
+            *
+            * The recorder closes the chunks of each sample with their crc32c. The checksums are verified by several threads, each reading
+            * a contiguous part of the file, so the verification is bound by the storage read rate. Files recorded before the checksums
+            * were added have no checksummed samples. The image data of a striped recording is verified by its reference only.
+            * The method can be called only while the device is not streaming.
+            * @param[out] result  The counts of the verified and the corrupted samples
+            * @return
+            * - true     The file was verified, the result holds the corrupted samples count
+            * - false    The device is streaming, the file format is not supported, or the file can't be read
+            */
+            bool verify(verification_result & result);
+
+            /**
+            * @brief Reads the descriptors of the next frames of the played file, without reading or decoding their image data.
+            *
+            * The scan is designed for timing and frame drop analysis of recordings. The descriptors are taken from the samples index,
+            * which is built from the index file next to the recording when there is one, so a scan without metadata reads the
+            * frame headers at most. Reading the metadata adds a read of the metadata chunk of each frame.
+            * The frames of all the streams are returned in file order, enabled or not. The scan doesn't change the playback position.
+            * The method can be called only while the device is not streaming.
+            * @param[in,out] position       Position of the scan in the file samples, 0 scans from the first frame, updated to the position following the returned frames
+            * @param[out]    frames         The frame descriptors, the vector is cleared before it's filled
+            * @param[in]     max_frames     Maximal number of descriptors to read
+            * @param[in]     read_metadata  Indicates whether the frames metadata is read, recordings of legacy formats have no metadata
+            * @return uint32_t Number of descriptors, 0 if the end of file was reached or the device is streaming
+            */
+            uint32_t scan_frames(uint64_t & position, std::vector<frame_descriptor> & frames, uint32_t max_frames, bool read_metadata);
+
+            /**
+            * @brief Reads a frame of the preview track of the played file, without reading or decoding the recorded frames.
+            *
+            * The preview track is a downscaled copy of every Nth frame of the image streams, recorded when the preview is set with
+            * \c rs::record::device::set_preview(). The preview frames are located by a scan of the file chunk headers up to the requested frame,
+            * the scan continues from where the previous reads stopped, so reading the first preview frame for a thumbnail reads the start of the file only.
+            * The preview is read with its own file handle, so the method can be called while streaming.
+            * @param[in]  stream  Stream type for which the preview frame is read
+            * @param[in]  index   Zero-based index of the preview frame in the preview track of the stream
+            * @param[out] frame   The preview frame
+            * @return
+            * - true     The preview frame was read
+            * - false    The stream has no preview frame of the index, or the file format is not supported
+            */
+            bool get_preview_frame(rs::stream stream, int index, preview_frame & frame);
+
+            /**
+            * @brief Reads the motion or time stamp samples of a motion source in a time range, without reading the frames.
+            *
+            * The recorder writes the samples of each motion source in blocks of columns besides the motion samples, and an index of the
+            * blocks at the end of the file, so the samples of a time range are read by a read of each block which overlaps the range.
+            * Recordings without the blocks, such as older recordings or recordings which weren't closed, are read from the samples index,
+            * which indexes the whole recording on the first read. The method can be called only while the device is not streaming.
+            * @param[in]  source      The motion source, e.g. \c rs::event::event_imu_gyro
+            * @param[in]  start_time  Capture time of the first read sample, in milliseconds from the beginning of the recording
+            * @param[in]  end_time    Capture time of the end of the range, in milliseconds from the beginning of the recording, the samples captured at this time are excluded
+            * @param[out] columns     The samples in capture order, the columns are cleared before they're filled
+            * @return
+            * - true     The samples were read, the columns are empty if the source has no samples in the range
+            * - false    The device is streaming, the arguments are invalid, or the file can't be read
+            */
+            bool read_motions(rs::event source, uint64_t start_time, uint64_t end_time, motion_columns & columns);
+
+            /**
+            * @brief Exports streams and motion samples of the played file to an MCAP file of ROS 1 messages, without playing the file.
+            *
+            * Each stream is exported to a sensor_msgs/Image topic, /camera/<stream>/image_raw, and the gyro and accelerometer samples are
+            * exported to sensor_msgs/Imu topics, /camera/gyro/sample and /camera/accel/sample. The log time of a message is its capture time.
+            * Frames recorded uncompressed are exported from the file without a copy to a decoded frame. Frames compressed by a codec which
+            * doesn't depend on other frames or on the codec dictionaries can be exported as they're recorded, to the sensor_msgs/CompressedImage
+            * topic /camera/<stream>/image_raw/compressed, whose format names the image encoding and the codec, e.g. "16UC1; rs_rvl".
+            * The other frames are decoded by the decoder threads, several frames ahead of the exported frame.
+            * The messages are written in LZ4 compressed chunks, which are compressed by a thread per core, so the export is bound by the disk.
+            * The method can be called only while the device is not streaming.
+            * @param[in] file_path        Path of the created file, must be different from the played file path
+            * @param[in] streams          Streams to export, the other streams are omitted from the created file
+            * @param[in] include_motions  Indicates whether the gyro and accelerometer samples are exported
+            * @param[in] decode_frames    Indicates whether all the frames are decoded, otherwise the frames are passed through as recorded when the codec allows
+            * @return
+            * - true     The file was created
+            * - false    The device is streaming, the arguments are invalid, or a file operation failed
+            */
+            bool export_mcap(const char * file_path, const std::vector<rs::stream> & streams, bool include_motions, bool decode_frames);
+
             /**
             * @brief Gets the total frame count of the requested stream captured in the file.
             *
@@ -153,6 +520,15 @@ namespace rs
             */
             int get_frame_count();
 
+            /**
+            * @brief Gets the indexed part of the recording.
+            *
+            * The samples of the recording are indexed while it's played, the file is read by large reads ahead of the indexing.
+            * A recording which was closed with its samples index, or which was recorded in a legacy format, is indexed when it's opened.
+            * @return double The indexed part of the recording, between 0 and 1.
+            */
+            double get_index_progress();
+
             /**
             * @brief Provides information of the software stack, with which the file was captured, and the way it was captured.
             *
@@ -34,8 +34,25 @@ namespace rs
         {
         public:
             context(const char * file_path);
+
+            /**
+            * @brief Creates a record context of the devices of another context, instead of the connected cameras.
+            *
+            * The source context must outlive the record context. This allows recording the output of a synthetic device,
+            * to test the recording throughput without camera hardware.
+            * @param[in] file_path          The output file path
+            * @param[in] source_context     The context of the recorded devices
+            */
+            context(const char * file_path, rs::core::context_interface & source_context);
             virtual ~context();
 
+            /**
+            * @brief Gets the number of recorded devices.
+            *
+            * @return int Number of the connected cameras, or the number of devices of the source context
+            */
+            int get_device_count() const override;
+
             /**
             * @brief Retrieves a device by index.
             *
@@ -59,7 +76,10 @@ namespace rs
             context(const context& cxt) = delete;
             context& operator=(const context& cxt) = delete;
 
+            void create_devices(const char * file_path);
+
             rs_device ** m_devices;
+            rs::core::context_interface * m_source_context;
         };
     }
 }
@@ -9,6 +9,7 @@
 #pragma once
 #include <librealsense/rs.hpp>
 #include "rs/core/status.h"
+#include "rs/utils/thread_profiler.h"
 
 #ifdef WIN32 
 #ifdef realsense_record_EXPORTS
@@ -27,9 +28,96 @@ namespace rs
         enum compression_level
         {
             disabled  = 0,
-            low       = 1,
+            low       = 1,  /**< Fastest compression, with \c codec_rvl depth streams are coded frame by frame with a dedicated lossless depth codec */
             medium    = 2,
-            high      = 3
+            high      = 3,
+            lossy     = 4  /**< Lossy compression of color streams, other streams are compressed as with high */
+        };
+
+        /**
+        * @brief Codecs which record in a format the readers of earlier sdk versions can't decode, see \c device::set_compression_codecs.
+        *
+        * Without them the compressed streams are recorded with lz4, which all the readers decode.
+        */
+        enum compression_codec
+        {
+            codec_delta       = 1 << 0, /**< Depth streams are coded as the difference to the previous frame, a stream with temporal compression */
+            codec_lz4_striped = 1 << 1, /**< Frames are coded with lz4 in independent bands, which are decoded in parallel on playback */
+            codec_rvl         = 1 << 2, /**< Depth streams of the low compression level are coded with the run length and variable length rvl codec */
+            codec_lz4_stream  = 1 << 3  /**< Frames of the high compression level are matched against the previous frame, a stream with temporal compression */
+        };
+
+        /**
+        * @brief Extensions of the recording format which the readers of earlier sdk versions can't read, see \c device::set_format_extensions.
+        *
+        * Without them the recording is written in the format version 2, which all the readers read.
+        */
+        enum format_extension
+        {
+            extension_sample_bundles = 1 << 0, /**< The index entries of the samples of a time window are written before the samples, a recording
+                                                    without its samples index is indexed with a read per window. Writes the format version 3. */
+            extension_motion_blocks  = 1 << 1, /**< The motion and time stamp samples are written in blocks of samples, instead of a sample each */
+            extension_frame_metadata = 1 << 2  /**< The frame metadata is written as a mask of the metadata ids followed by the values, instead of id and value pairs */
+        };
+
+        /**
+        * @brief Defines how the recorded frames wait to be written to the file.
+        */
+        enum frame_copy_mode
+        {
+            hold_camera_frames  = 0, /**< The recorder holds the camera frames until they are written. A slow storage may exhaust the camera frames pool. */
+            copy_to_frame_slots = 1  /**< The recorder copies the frames to preallocated frame slots and releases the camera frames immediately.
+                                          Frames that arrive while all the frame slots of the stream are waiting to be written are not recorded. */
+        };
+
+        /**
+        * @brief Defines the NUMA node the recording threads of the device run on, see \c rs::utils::numa_topology.
+        */
+        enum numa_affinity
+        {
+            usb_controller_node = 0, /**< The threads run on the node of the USB controller of the camera, if the platform reports it */
+            fixed_node          = 1, /**< The threads run on the configured node */
+            any_node            = 2  /**< The threads aren't bound to a node */
+        };
+
+        /**
+        * @brief A crop rectangle and a downscale of the frames of a stream, applied by the recorder, see \c device::set_stream_transform.
+        */
+        struct stream_transform
+        {
+            int32_t x;          /**< Left column of the crop rectangle */
+            int32_t y;          /**< Top row of the crop rectangle */
+            int32_t width;      /**< Width of the crop rectangle, 0 crops up to the right edge of the frame */
+            int32_t height;     /**< Height of the crop rectangle, 0 crops up to the bottom edge of the frame */
+            int32_t scale;      /**< The crop rectangle width and height divided by the recorded width and height, 1 to 8, 1 only crops */
+        };
+
+        /**
+        * @brief Counters of a recorded stream, since the record device started.
+        */
+        struct recording_statistics
+        {
+            uint64_t recorded_frames_count;     /**< Frames written to the file */
+            uint64_t dropped_frames_count;      /**< Frames the recorder dropped, since the storage didn't keep up with the camera */
+            uint64_t raw_bytes;                 /**< Size of the written frames before compression */
+            uint64_t written_bytes;             /**< Size of the written frames data in the file */
+            uint64_t encode_time;               /**< Time the frames were compressed, in microseconds. The average encode time is \c encode_time divided by \c recorded_frames_count */
+            uint64_t repeated_frames_count;     /**< Frames of the recorded frames which the change gate recorded as repeats of an earlier frame, see \c device::set_change_gate */
+        };
+
+        /**
+        * @brief Counters of the recorder, since the record device started.
+        */
+        struct recorder_statistics
+        {
+            uint32_t queued_samples_count;      /**< Samples waiting to be compressed and written */
+            uint32_t queue_high_watermark;      /**< Maximal number of samples that were waiting at once */
+            uint32_t queue_capacity;            /**< Number of samples the recorder holds, the samples captured while it's full are dropped */
+            uint64_t dropped_frames_count;      /**< Frames the recorder dropped, of all the streams */
+            uint64_t written_bytes;             /**< Size of the recording, including the headers and the motion samples */
+            rs::utils::thread_statistics write_thread; /**< Counters of the thread which compresses and writes the samples. Its input wait is
+                                                            its idle time, its io wait is the time the storage took to write, and its tasks
+                                                            wait is the time it waited for the parallel compression of the frames */
         };
 
         /**
@@ -92,6 +180,218 @@ namespace rs
             * @return compression_level Requested compression level
             */
             compression_level get_compression_level(rs::stream stream);
+
+            /**
+            * @brief Allows the compression of the streams with the codecs of the recent recording formats.
+            *
+            * The method can be called only before record device start is called. By default no codec is allowed and the compressed streams
+            * are recorded with lz4, so the recording is read by the earlier sdk versions. A stream is compressed with an allowed codec if the
+            * codec supports its format at its compression level.
+            * @param[in] codecs  The \c compression_codec flags of the allowed codecs, 0 allows none
+            * @return status_no_error Successful execution.
+            * @return status_invalid_argument A flag isn't a \c compression_codec value.
+            * @return status_invalid_state The record device is streaming.
+            */
+            core::status set_compression_codecs(uint32_t codecs);
+
+            /**
+            * @brief Allows the extensions of the recent recording formats.
+            *
+            * The method can be called only before record device start is called. By default no extension is allowed, so the recording
+            * is read by the earlier sdk versions.
+            * @param[in] extensions  The \c format_extension flags of the allowed extensions, 0 allows none
+            * @return status_no_error Successful execution.
+            * @return status_invalid_argument A flag isn't a \c format_extension value.
+            * @return status_invalid_state The record device is streaming.
+            */
+            core::status set_format_extensions(uint32_t extensions);
+            /**
+            * @brief Sets how the recorded frames wait to be written to the file.
+            *
+            * The method can be called only before record device start is called.
+            * The default mode is \c hold_camera_frames.
+            * @param[in] mode  Requested frame copy mode
+            * @param[in] frame_slots_count  Number of frame slots of each stream with \c copy_to_frame_slots mode, 0 sets a frame slot for each frame of a second
+            * @return status_no_error Successful execution.
+            * @return status_invalid_argument Frame copy mode value is out of legal range.
+            * @return status_invalid_state The record device is streaming.
+            */
+            core::status set_frame_copy_mode(frame_copy_mode mode, uint32_t frame_slots_count = 0);
+
+            /**
+            * @brief Sets the NUMA node of the threads which copy, compress and write the recorded frames.
+            *
+            * The method can be called only before record device start is called. The default affinity is \c usb_controller_node.
+            * On a multi-socket host the frame callback threads, the encoder workers, the write thread and the stripe threads of the device
+            * run on the cpus of the node, and the frame slots and the compression buffers they allocate are placed in the memory of the node,
+            * so the frames aren't pulled across the socket interconnect. Recording several cameras attached to the controllers of different
+            * sockets scales with the sockets. The affinity is ignored on a single node host, and on the platforms which don't report the nodes.
+            * @param[in] affinity  Requested node affinity
+            * @param[in] node      The node of the threads with \c fixed_node affinity
+            * @return status_no_error Successful execution.
+            * @return status_invalid_argument The affinity value is out of legal range, or the node is negative.
+            * @return status_invalid_state The record device is streaming.
+            */
+            core::status set_numa_affinity(numa_affinity affinity, int32_t node = 0);
+
+            /**
+            * @brief Sets how far ahead of the writes the recording file space is reserved.
+            *
+            * The method can be called only before record device start is called. By default the file grows with the writes, which fragments
+            * long recordings on a busy volume. With preallocation the file space is reserved in extents of the configured seconds of the
+            * streams uncompressed bandwidth, so the recording is written and later played back sequentially. The unused part of the last extent
+            * is released when the recording stops. Preallocation is available on Linux, and is ignored on file systems which don't support it.
+            * @param[in] preallocated_seconds  Seconds of the streams bandwidth reserved at once, 0 disables the preallocation
+            * @return status_no_error Successful execution.
+            * @return status_invalid_state The record device is streaming.
+            */
+            core::status set_file_preallocation(uint32_t preallocated_seconds);
+
+            /**
+            * @brief Splits the recording into segment files, which rotate while streaming.
+            *
+            * The method can be called only before record device start is called. By default a single file is recorded.
+            * A segment is closed once it reaches the size or the duration limit, and the recording continues in the next segment without
+            * dropping frames. The first segment is the file of the record context, the next segments are numbered before the file extension,
+            * for example record_0001.rssdk. Each segment is a complete recording, with the device and streams information, that plays back
+            * on its own. A recording to a pipe or a socket isn't segmented.
+            * @param[in] max_segment_size     Segment size limit in bytes, 0 doesn't limit the size
+            * @param[in] max_segment_seconds  Segment duration limit in seconds of capture time, 0 doesn't limit the duration
+            * @return status_no_error Successful execution.
+            * @return status_invalid_state The record device is streaming.
+            */
+            core::status set_file_segmentation(uint64_t max_segment_size, uint32_t max_segment_seconds);
+
+            /**
+            * @brief Stripes the image data of the recording over several directories, typically on different disks.
+            *
+            * The method can be called only before record device start is called. By default the image data is written to the recording file.
+            * Each image stream is assigned to a stripe in turn, the stripe file is written by its own thread and is named by the recording file,
+            * for example record.rssdk.stripe0. The recording file keeps the device and streams information and the frames descriptors, and
+            * references the image data in the stripes, so the recording plays back as a single file while the stripe files are found at
+            * their recorded paths or next to the recording file. The recording throughput scales with the number of disks.
+            * A recording to a pipe or a socket and a segmented recording aren't striped.
+            * @param[in] stripe_directories  The directories of the stripe files, the stripes are written to
+            * @param[in] stripes_count       The number of stripe directories, 0 disables the striping
+            * @return status_no_error Successful execution.
+            * @return status_invalid_argument A stripe directory is null.
+            * @return status_invalid_state The record device is streaming.
+            */
+            core::status set_file_striping(const char ** stripe_directories, uint32_t stripes_count);
+
+            /**
+            * @brief Writes the image data of each image stream to a data file of its own, for playbacks of a part of the streams.
+            *
+            * The method can be called only before record device start is called. By default the image data of the streams is interleaved in
+            * the recording file, and a playback of a single stream reads through the image data of all the streams. With the stream data
+            * files each stream is a stripe of its own, written next to the recording file or, if the recording is striped, to the stripe
+            * directories in turn. The recording file keeps the frames descriptors and the samples index of all the streams, and a playback
+            * reads the data file of a stream only if the stream is enabled. A recording to a pipe or a socket and a segmented recording
+            * aren't split.
+            * @param[in] enable  True writes a data file per stream, false writes the image data to the recording file or to its stripes.
+            * @return status_no_error Successful execution.
+            * @return status_invalid_state The record device is streaming.
+            */
+            core::status set_stream_data_files(bool enable);
+
+            /**
+            * @brief Records a preview track of the image streams, a downscaled copy of every Nth frame, for thumbnails and browsing of the recording.
+            *
+            * The method can be called only before record device start is called. By default no preview is recorded.
+            * The preview frame samples every \c scale pixel of every \c scale row of the frame and is compressed losslessly, so at a scale of 8
+            * it adds about 1/64 of the frame size before compression. The preview frames are written in the recording file next to their frames,
+            * and are read by \c rs::playback::device::get_preview_frame() without reading or decoding the recorded frames.
+            * Frames held compressed by the pre trigger recording, and frames of formats without whole byte pixels, have no preview.
+            * @param[in] scale            The frame width and height divided by the preview width and height, 0 disables the preview
+            * @param[in] frames_interval  The preview frame is recorded for the first frame of every \c frames_interval frames of a stream
+            * @return status_no_error Successful execution.
+            * @return status_invalid_argument The scale is 1, or the frames interval is 0.
+            * @return status_invalid_state The record device is streaming.
+            */
+            core::status set_preview(uint32_t scale, uint32_t frames_interval);
+
+            /**
+            * @brief Records the frames of a static scene as repeats of the last changed frame of their stream, instead of in full.
+            *
+            * The method can be called only before record device start is called. By default every frame is recorded in full.
+            * Each frame is compared to the last changed frame of its stream in tiles of 16 rows of 64 bytes, the frame changed if the mean
+            * absolute difference of the bytes of any tile exceeds the threshold. An unchanged frame is neither compressed nor written, it's
+            * recorded with its own number, timestamps and metadata and a reference to the data of the last frame of its stream which was
+            * recorded in full, and the playback delivers it with that data. Streams with temporal compression, and the pre trigger recording,
+            * aren't gated.
+            * @param[in] threshold  Mean absolute difference of the bytes of a tile which changes the frame, 0 records every frame in full
+            * @return status_no_error Successful execution.
+            * @return status_invalid_state The record device is streaming.
+            */
+            core::status set_change_gate(uint32_t threshold);
+
+            /**
+            * @brief Records a region of the frames of a stream, optionally downscaled, instead of the full frames.
+            *
+            * The method can be called only before record device start is called. By default the frames are recorded in full.
+            * The frames are cropped and downscaled as the camera delivers them, before they are compressed, so the recorder neither compresses
+            * nor writes the discarded pixels. The frames are copied to frame slots of the transformed size, as with \c copy_to_frame_slots,
+            * and the camera frames are released right away. The recorded stream profile and intrinsics are of the transformed frames.
+            * The color and infrared streams are downscaled by the mean of each block of scale by scale pixels, the depth streams are decimated
+            * to the first pixel of each block, so no depth is interpolated between surfaces. The Z16, disparity, Y8, Y16, RGB, BGR, RGBA and BGRA
+            * formats are transformed, YUYV frames are cropped on even columns and widths and aren't downscaled. A transform which doesn't fit
+            * the stream format or size when the device starts is logged, and the stream is recorded in full.
+            * The frames the application receives from the device aren't transformed.
+            * @param[in] stream     The stream
+            * @param[in] transform  The crop rectangle and scale, a zero initialized transform with a scale of 1 records the full frames
+            * @return status_no_error Successful execution.
+            * @return status_invalid_argument The crop rectangle is negative, or the scale isn't 1 to 8.
+            * @return status_invalid_state The record device is streaming.
+            */
+            core::status set_stream_transform(rs::stream stream, const stream_transform & transform);
+
+            /**
+            * @brief Records only the samples around the triggers, the recent samples are held in memory until a trigger.
+            *
+            * The method can be called only before record device start is called. By default all the samples are recorded.
+            * The compressed samples of the last \c pre_trigger_seconds are held in memory, up to 512MB, and the older samples are dropped.
+            * \c trigger_recording writes the held samples and the samples captured up to \c post_trigger_seconds after the trigger, then the samples
+            * are held again. A temporal compression stream which lost held frames is written from its next keyframe.
+            * @param[in] pre_trigger_seconds   Seconds of samples held before a trigger, 0 records all the samples
+            * @param[in] post_trigger_seconds  Seconds of samples recorded after a trigger
+            * @return status_no_error Successful execution.
+            * @return status_invalid_state The record device is streaming.
+            */
+            core::status set_pre_trigger_recording(uint32_t pre_trigger_seconds, uint32_t post_trigger_seconds);
+
+            /**
+            * @brief Records the held samples and the samples of the post trigger duration, the method can be called while streaming.
+            *
+            * A trigger during the post trigger duration of a previous trigger extends the recording.
+            * @return status_no_error Successful execution.
+            * @return status_invalid_state The pre trigger recording wasn't set, or the record device didn't start.
+            */
+            core::status trigger_recording();
+
+            /**
+            * @brief Returns the recording counters of a stream.
+            *
+            * The counters are sampled without blocking the recording, the method can be called while streaming.
+            * The ratio of \c raw_bytes to \c written_bytes is the compression ratio of the stream.
+            * @param[in]  stream      The recorded stream
+            * @param[out] statistics  The stream counters
+            * @return status_no_error Successful execution.
+            * @return status_invalid_argument The stream value is out of legal range.
+            */
+            core::status query_recording_statistics(rs::stream stream, recording_statistics & statistics);
+
+            /**
+            * @brief Returns the counters of the recorder, which show how close it's to drop frames.
+            *
+            * The counters are sampled without blocking the recording, the method can be called while streaming. A queue which fills up
+            * means the compression or the storage doesn't keep up with the camera, lowering the compression level of the streams with
+            * the longest encode time, see \c query_recording_statistics, or recording fewer streams prevents the drops. The write thread
+            * counters show whether the recorder is bound by the compression, by the storage or by the locks it shares with the camera.
+            * The threads of all the record devices are counted by \c rs::utils::thread_profiler::query_role_statistics.
+            * @param[out] statistics  The recorder counters
+            * @return status_no_error Successful execution.
+            */
+            core::status query_recorder_statistics(recorder_statistics & statistics);
         };
     }
 }
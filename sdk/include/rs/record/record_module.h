@@ -0,0 +1,129 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file record_module.h
+* @brief Describes the \c rs::record::record_module class.
+*/
+
+#pragma once
+#include "rs_core.h"
+#include "rs/record/record_device.h"
+
+#ifdef WIN32
+#ifdef realsense_record_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_record_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace record
+    {
+        /**
+        * @brief Forward declaration for the record module implementation, as part of the pimpl pattern.
+        */
+        class DLL_EXPORT record_module_impl;
+
+        /**
+        * @brief Recording sink of the pipeline, added to the pipeline like any computer vision module.
+        *
+        * The module writes the time synced samples sets it gets to a file, which is played by the playback device. The images are
+        * referenced while they wait for the write thread, they aren't copied, so recording doesn't add a copy to the camera
+        * frames the other modules share. Connected downstream of a module, the module records the samples sets of the module output,
+        * and with a max rate in its supported configuration it records a decimated rate of the streams.
+        * The file is configured by the first samples set which holds an image of each enabled stream, the samples sets before it
+        * aren't recorded.
+        */
+        class DLL_EXPORT record_module : public rs::core::video_module_interface
+        {
+        public:
+            /**
+            * @brief Creates a record module which writes to a file.
+            * @param[in] file_path  The recording file path, the file is overwritten.
+            */
+            record_module(const char * file_path);
+
+            record_module(const record_module&) = delete;
+            record_module& operator= (const record_module&) = delete;
+            record_module(record_module&&) = delete;
+            record_module& operator= (record_module&&) = delete;
+
+            /**
+            * @brief Requests a stream to be recorded, the module requests the stream from the pipeline.
+            *
+            * Streams are enabled before the module is added to the pipeline.
+            * @param[in] stream  The recorded stream.
+            * @return status_invalid_argument  The stream isn't a camera stream.
+            * @return status_invalid_state     The module is configured.
+            * @return status_no_error          The stream is recorded.
+            */
+            core::status enable_stream(core::stream_type stream);
+
+            /**
+            * @brief Requests a motion sensor to be recorded, the module requests the motion samples from the pipeline.
+            * @param[in] motion  The recorded motion sensor.
+            * @return status_invalid_argument  The motion type isn't valid.
+            * @return status_invalid_state     The module is configured.
+            * @return status_no_error          The motion samples are recorded.
+            */
+            core::status enable_motion(core::motion_type motion);
+
+            /**
+            * @brief Sets the compression level of a recorded stream, see \c rs::record::device::set_compression.
+            * @param[in] stream             The stream.
+            * @param[in] compression_level  The requested compression level.
+            * @return status_invalid_argument  The stream or the compression level isn't valid.
+            * @return status_invalid_state     The module is configured.
+            * @return status_no_error          The compression level is set.
+            */
+            core::status set_compression(core::stream_type stream, compression_level compression_level);
+
+            /**
+            * @brief Allows the compression of the streams with the codecs of the recent recording formats, see \c rs::record::device::set_compression_codecs.
+            * @param[in] codecs  The \c compression_codec flags of the allowed codecs, 0 allows none.
+            * @return status_invalid_argument  A flag isn't a \c compression_codec value.
+            * @return status_invalid_state     The module is configured.
+            * @return status_no_error          The codecs are allowed.
+            */
+            core::status set_compression_codecs(uint32_t codecs);
+
+            /**
+            * @brief Allows the extensions of the recent recording formats, see \c rs::record::device::set_format_extensions.
+            * @param[in] extensions  The \c format_extension flags of the allowed extensions, 0 allows none.
+            * @return status_invalid_argument  A flag isn't a \c format_extension value.
+            * @return status_invalid_state     The module is configured.
+            * @return status_no_error          The extensions are allowed.
+            */
+            core::status set_format_extensions(uint32_t extensions);
+
+            /**
+            * @brief Returns the recording statistics of a stream, see \c rs::record::device::query_recording_statistics.
+            * @param[in]  stream      The stream.
+            * @param[out] statistics  The stream recording statistics, zero before the recording is configured.
+            * @return status_invalid_argument  The stream isn't valid.
+            * @return status_no_error          The statistics are returned.
+            */
+            core::status query_recording_statistics(core::stream_type stream, recording_statistics & statistics);
+
+            // video_module_interface interface
+            int32_t query_module_uid() override;
+            core::status query_supported_module_config(int32_t idx, supported_module_config &supported_config) override;
+            core::status query_current_module_config(actual_module_config &module_config) override;
+            core::status set_module_config(const actual_module_config &module_config) override;
+            core::status process_sample_set(const core::correlated_sample_set & sample_set) override;
+            core::status register_event_handler(processing_event_handler *handler) override;
+            core::status unregister_event_handler(processing_event_handler *handler) override;
+            core::status flush_resources() override;
+            core::status reset_config() override;
+
+            ~record_module();
+        private:
+            record_module_impl * m_pimpl;
+        };
+    }
+}
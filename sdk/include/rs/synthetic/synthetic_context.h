@@ -0,0 +1,81 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file synthetic_context.h
+* @brief Describes the \c rs::synthetic::context class.
+*/
+
+#pragma once
+#include <librealsense/rs.hpp>
+#include "rs/core/context_interface.h"
+#include "rs/synthetic/synthetic_device.h"
+
+#ifdef WIN32
+#ifdef realsense_synthetic_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_synthetic_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace synthetic
+    {
+        /**
+        * @brief Implements \c rs::core::context_interface for a synthetic camera, which generates its streams without camera hardware.
+        *
+        * See the interface class for more details.
+        */
+        class DLL_EXPORT context : public rs::core::context_interface
+        {
+        public:
+            /**
+            * @brief Creates a context of a synthetic device with the default configuration.
+            */
+            context();
+
+            /**
+            * @brief Creates a context of a synthetic device with the given configuration.
+            *
+            * @param[in] configuration  The streams modes and timing of the device
+            */
+            context(const device_configuration & configuration);
+            ~context();
+
+            /**
+            * @brief Gets number of available synthetic devices.
+            *
+            * The synthetic context provides access to a single device. Therefore, this method always returns 1.
+            * @return int Number of available devices
+            */
+            int get_device_count() const override;
+
+            /**
+            * @brief Gets the single synthetic device.
+            *
+            * The method returns \c rs::synthetic::device, down-casted to \c rs::device.
+            * @param[in] index Zero-based index of device to retrieve
+            * @return rs::device* Requested device
+            */
+            rs::device * get_device(int index) override;
+
+            /**
+            * @brief Gets the single synthetic device.
+            *
+            * The function returns \c rs::synthetic::device, to provide access to the synthetic device capabilities, which extend the basic device functionality.
+            * @return synthetic::device* Requested device.
+            */
+            device * get_synthetic_device();
+
+        private:
+            context(const context& cxt) = delete;
+            context& operator=(const context& cxt) = delete;
+
+            rs_device * m_device;
+        };
+    }
+}
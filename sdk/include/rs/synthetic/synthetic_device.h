@@ -0,0 +1,123 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file synthetic_device.h
+* @brief Describes the \c rs::synthetic::device class and the \c rs::synthetic::stream_mode and \c rs::synthetic::device_configuration structs.
+*/
+
+#pragma once
+#include <map>
+#include <vector>
+#include <librealsense/rs.hpp>
+
+#ifdef WIN32
+#ifdef realsense_synthetic_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_synthetic_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace synthetic
+    {
+        /**
+        * @brief Describes a stream mode the synthetic device advertises.
+        */
+        struct stream_mode
+        {
+            int         width;      /**<  Width of the images in pixels */
+            int         height;     /**<  Height of the images in pixels */
+            rs::format  format;     /**<  Pixel format of the images */
+            int         framerate;  /**<  Frames per second */
+        };
+
+        /**
+        * @brief Describes the streams and the timing of a synthetic device.
+        */
+        struct DLL_EXPORT device_configuration
+        {
+            device_configuration();
+
+            /**
+            * @brief The modes advertised for each stream, a stream without modes is not supported by the device.
+            *
+            * The modes are not limited by the camera hardware, any size and frame rate can be added, for example to find the frame rate
+            * at which a pipeline starts dropping frames. The default modes are the common modes of the ZR300 camera.
+            */
+            std::map<rs::stream, std::vector<stream_mode>>  modes;
+            int                                             motion_rate;        /**<  Accelerometer and gyroscope samples per second while motion tracking is enabled, 200 by default */
+            double                                          max_jitter;         /**<  Maximal deviation in milliseconds of the images timestamps from the nominal frame times, 0 by default */
+            uint32_t                                        seed;               /**<  Seed of the timestamps jitter, the same seed reproduces the same timestamps */
+            bool                                            real_time;          /**<  Indicates whether the images are generated at the stream frame rate, true by default */
+        };
+
+        /**
+        * @brief Extends librealsense \c rs::device with a camera which generates its streams, for load testing without camera hardware.
+        *
+        * The device generates depth, color, infrared and fisheye images of a fixed synthetic scene, and accelerometer and gyroscope samples
+        * while motion tracking is enabled. The image timestamps are the nominal frame times of the stream frame rate, since the device start,
+        * shifted by a random jitter bounded by \c device_configuration::max_jitter. The jitter is generated from the configured seed, so
+        * two runs with the same configuration produce the same timestamps. A jitter larger than half of the frame time may reorder the timestamps.
+        * In real time mode each stream generates its images at its frame rate, as a camera does. The images due while the previous image callback
+        * of the same stream has not returned are dropped, the latest of them is delivered once the callback returns, and the frame numbers of the dropped images are skipped.
+        * In non-real time mode each image is generated once the previous image callback returns, without drops, so the stream rate is limited
+        * only by the application processing.
+        * Creating the \c rs::synthetic::device is done using \c rs::synthetic::context.
+        */
+        class DLL_EXPORT device : public rs::device
+        {
+        public:
+            /**
+            * @brief Sets the generation mode to real time or non-real time.
+            *
+            * The method can be called only while the device is not streaming.
+            * @param[in] realtime  Requested state
+            * @return
+            * - true     The mode is set
+            * - false    The device is streaming
+            */
+            bool set_real_time(bool realtime);
+
+            /**
+            * @brief Indicates the real time generation mode.
+            *
+            * For more details, see the \c rs::synthetic::device::set_real_time() method.
+            * @return bool Real time state
+            */
+            bool is_real_time();
+
+            /**
+            * @brief Sets the maximal jitter of the images timestamps.
+            *
+            * The method can be called only while the device is not streaming.
+            * @param[in] max_jitter  Maximal deviation in milliseconds of the timestamps from the nominal frame times, must not be negative
+            * @return
+            * - true     The jitter is set
+            * - false    The device is streaming or the jitter is negative
+            */
+            bool set_max_jitter(double max_jitter);
+
+            /**
+            * @brief Gets the number of images the stream generated since the device started, including the dropped images.
+            *
+            * @param[in] stream  Stream type for which the count is queried
+            * @return uint64_t   Generated images count
+            */
+            uint64_t get_generated_frames_count(rs::stream stream);
+
+            /**
+            * @brief Gets the number of images the stream dropped since the device started, because its callback was busy.
+            *
+            * The total drops of all streams are also available as the \c rs::option::total_frame_drops option.
+            * @param[in] stream  Stream type for which the count is queried
+            * @return uint64_t   Dropped images count
+            */
+            uint64_t get_dropped_frames_count(rs::stream stream);
+        };
+    }
+}
@@ -0,0 +1,406 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* @file async_video_module_base.h
+* @brief Describes the \c rs::utils::async_video_module_base class template.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rs/core/video_module_interface.h"
+#include "rs/core/correlated_sample_set.h"
+#include "rs/utils/concurrent_cyclic_array.h"
+#include "rs/utils/thread_config.h"
+#include "rs/utils/thread_profiler.h"
+#include "rs/utils/timebase.h"
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Counters of an asynchronous video module since it was created.
+        */
+        struct async_module_statistics
+        {
+            uint64_t received_sample_sets_count;    /**< Samples sets passed to the processing method */
+            uint64_t processed_sample_sets_count;   /**< Samples sets whose processing succeeded and whose output was published */
+            uint64_t failed_sample_sets_count;      /**< Samples sets whose processing returned an error */
+            uint64_t dropped_sample_sets_count;     /**< Samples sets dropped since the input queues were full, or flushed */
+            uint64_t total_processing_time;         /**< Time the samples sets processing took, in microseconds */
+            uint64_t max_processing_time;           /**< Longest samples set processing, in microseconds */
+            thread_statistics threads;              /**< Counters of the processing threads of the module */
+        };
+
+        /**
+        * @brief Implements the asynchronous processing model of a video module: the queueing of the samples sets, the processing threads,
+        *        the output publishing and the output handler notification.
+        *
+        * The module derives from the template, implements \c process_samples() and the configuration methods of
+        * \c rs::core::video_module_interface, and reports \c async_processing in its supported configuration. The processing method of
+        * the template holds a reference to the images of the samples set and pushes it to a bounded lock free queue, without waiting
+        * for the processing. With more than one worker, each worker thread has its own queue and the samples sets are pushed to the
+        * queues in turn, so the samples sets are processed concurrently. A samples set which finds the queues full is dropped and
+        * counted, the processing thread keeps its pace rather than the camera's. The motion batches aren't kept with the queued samples
+        * sets, since they're valid only while the processing method runs.
+        *
+        * The outputs are instances of \c output_type, pooled by the template: an output released by its last holder is recycled with
+        * its content, so an output which holds buffers keeps their memory across the samples sets. The latest output is published once
+        * its processing succeeded, an output of an older samples set than the published output, processed by another worker, isn't
+        * published. The registered handler is notified of each published output, on the worker thread.
+        *
+        * The worker threads start with the first samples set. A derived module must call \c stop_processing() in its destructor,
+        * so the workers don't call \c process_samples() of a destroyed module.
+        */
+        template <typename output_type>
+        class async_video_module_base : public rs::core::video_module_interface
+        {
+        public:
+            typedef std::shared_ptr<output_type> output_ptr;
+
+            rs::core::status process_sample_set(const rs::core::correlated_sample_set & sample_set) override
+            {
+                if(m_is_stopped.load(std::memory_order_acquire))
+                    return rs::core::status_exec_aborted;
+                std::call_once(m_workers_started, [this]() { start_workers(); });
+
+                queued_sample_set queued(sample_set, m_next_sequence.fetch_add(1, std::memory_order_relaxed));
+                m_received_count.fetch_add(1, std::memory_order_relaxed);
+                const size_t first_worker = m_next_worker.fetch_add(1, std::memory_order_relaxed);
+                for(size_t i = 0; i < m_workers.size(); i++)
+                {
+                    auto & worker = *m_workers[(first_worker + i) % m_workers.size()];
+                    if(worker.queue.push_back(queued))
+                    {
+                        {
+                            //taking the worker lock orders the push before the worker's empty check, the wakeup isn't lost
+                            std::lock_guard<std::mutex> lock(worker.wake_lock);
+                        }
+                        worker.wake.notify_one();
+                        return rs::core::status_no_error;
+                    }
+                }
+                m_dropped_count.fetch_add(1, std::memory_order_relaxed);
+                return rs::core::status_no_error;
+            }
+
+            rs::core::status register_event_handler(processing_event_handler * handler) override
+            {
+                std::lock_guard<std::mutex> lock(m_handler_lock);
+                if(m_handler != nullptr)
+                    return rs::core::status_handle_invalid;
+                m_handler = handler;
+                return rs::core::status_no_error;
+            }
+
+            rs::core::status unregister_event_handler(processing_event_handler * handler) override
+            {
+                std::lock_guard<std::mutex> lock(m_handler_lock);
+                if(m_handler != handler)
+                    return rs::core::status_handle_invalid;
+                m_handler = nullptr;
+                return rs::core::status_no_error;
+            }
+
+            /**
+            * @brief Drops the queued samples sets, the samples sets being processed complete.
+            */
+            rs::core::status flush_resources() override
+            {
+                m_flushed_sequence.store(m_next_sequence.load(std::memory_order_relaxed), std::memory_order_release);
+                return rs::core::status_no_error;
+            }
+
+            /**
+            * @brief Returns the latest published output, null if no output was published.
+            */
+            output_ptr query_output()
+            {
+                std::lock_guard<std::mutex> lock(m_output_lock);
+                return m_output;
+            }
+
+            /**
+            * @brief Waits for an output which wasn't returned by a previous wait and returns it, null once the processing is stopped.
+            */
+            output_ptr wait_for_output()
+            {
+                std::unique_lock<std::mutex> lock(m_output_lock);
+                m_output_ready.wait(lock, [this]() { return m_is_output_new || m_is_stopped.load(std::memory_order_relaxed); });
+                if(!m_is_output_new)
+                    return nullptr;
+                m_is_output_new = false;
+                return m_output;
+            }
+
+            /**
+            * @brief Returns the counters of the module.
+            */
+            async_module_statistics query_statistics() const
+            {
+                async_module_statistics statistics = {};
+                statistics.received_sample_sets_count = m_received_count.load(std::memory_order_relaxed);
+                statistics.processed_sample_sets_count = m_processed_count.load(std::memory_order_relaxed);
+                statistics.failed_sample_sets_count = m_failed_count.load(std::memory_order_relaxed);
+                statistics.dropped_sample_sets_count = m_dropped_count.load(std::memory_order_relaxed);
+                statistics.total_processing_time = m_total_processing_time.load(std::memory_order_relaxed);
+                statistics.max_processing_time = m_max_processing_time.load(std::memory_order_relaxed);
+                for(auto & worker : m_workers)
+                {
+                    auto worker_statistics = worker->profiler.query_statistics();
+                    statistics.threads.threads_count += worker_statistics.threads_count;
+                    statistics.threads.running_time += worker_statistics.running_time;
+                    statistics.threads.cpu_time += worker_statistics.cpu_time;
+                    for(int32_t i = 0; i < static_cast<int32_t>(thread_wait::max); i++)
+                        statistics.threads.wait_time[i] += worker_statistics.wait_time[i];
+                    statistics.threads.processed_items_count += worker_statistics.processed_items_count;
+                }
+                return statistics;
+            }
+
+            virtual ~async_video_module_base()
+            {
+                stop_processing();
+            }
+
+        protected:
+            /**
+            * @brief Constructs the module processing of the worker threads, which start with the first samples set.
+            * @param[in]  thread_name             The name of the worker threads, truncated to 15 characters on Linux
+            * @param[in]  queue_depth             The samples sets each worker queues, 0 is handled as 1
+            * @param[in]  workers_count           The worker threads, which process the samples sets concurrently, 0 is handled as 1
+            */
+            explicit async_video_module_base(const char * thread_name, uint32_t queue_depth = 1, uint32_t workers_count = 1) :
+                m_thread_name(thread_name ? thread_name : ""), m_outputs(std::make_shared<output_pool>()), m_handler(nullptr),
+                m_is_output_new(false), m_published_sequence(0), m_is_stopped(false), m_next_sequence(1), m_flushed_sequence(0),
+                m_next_worker(0), m_received_count(0), m_processed_count(0), m_failed_count(0), m_dropped_count(0),
+                m_total_processing_time(0), m_max_processing_time(0)
+            {
+                for(uint32_t i = 0; i < std::max(workers_count, 1u); i++)
+                    m_workers.emplace_back(new worker(std::max(queue_depth, 1u)));
+            }
+
+            /**
+            * @brief Processes a samples set to an output, called by the worker threads.
+            *
+            * With more than one worker the method is called concurrently. The output is recycled from a released output, with its content,
+            * or default constructed.
+            * @param[in]  sample_set              The samples set, its images are held until the method returns
+            * @param[out] output                  The output of the samples set
+            * @return status_no_error             The output is published
+            * @return an error                    The samples set is counted as failed and the output isn't published
+            */
+            virtual rs::core::status process_samples(const rs::core::correlated_sample_set & sample_set, output_type & output) = 0;
+
+            /**
+            * @brief Stops the worker threads once they complete their current samples set, the queued samples sets are dropped. Called
+            *        by the destructor of the derived module, the samples sets passed afterwards aren't processed.
+            */
+            void stop_processing()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_output_lock);
+                    if(m_is_stopped.exchange(true))
+                        return;
+                }
+                m_output_ready.notify_all();
+                for(auto & worker : m_workers)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(worker->wake_lock);
+                    }
+                    worker->wake.notify_one();
+                    if(worker->thread.joinable())
+                        worker->thread.join();
+                    queued_sample_set dropped;
+                    while(worker->queue.pop_front(dropped))
+                        m_dropped_count.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+        private:
+            //the samples set images are held while the samples set is queued, the moved from samples set holds no images
+            class queued_sample_set
+            {
+            public:
+                queued_sample_set() : m_sequence(0) {}
+                queued_sample_set(const rs::core::correlated_sample_set & sample_set, uint64_t sequence) : m_sample_set(sample_set), m_sequence(sequence)
+                {
+                    for(auto image : m_sample_set.images)
+                        if(image) image->add_ref();
+                    for(int32_t i = 0; i < static_cast<int32_t>(rs::core::motion_type::max); i++)
+                    {
+                        m_sample_set.motion_batches[i] = nullptr;
+                        m_sample_set.motion_batch_sizes[i] = 0;
+                    }
+                }
+                queued_sample_set & operator=(queued_sample_set && other)
+                {
+                    if(this != &other)
+                    {
+                        release_images();
+                        m_sample_set = other.m_sample_set;
+                        m_sequence = other.m_sequence;
+                        other.m_sample_set = rs::core::correlated_sample_set();
+                    }
+                    return *this;
+                }
+                ~queued_sample_set() { release_images(); }
+
+                const rs::core::correlated_sample_set & sample_set() const { return m_sample_set; }
+                uint64_t sequence() const { return m_sequence; }
+            private:
+                queued_sample_set(const queued_sample_set &) = delete;
+                queued_sample_set & operator=(const queued_sample_set &) = delete;
+                void release_images()
+                {
+                    for(auto & image : m_sample_set.images)
+                    {
+                        if(image) image->release();
+                        image = nullptr;
+                    }
+                }
+                rs::core::correlated_sample_set m_sample_set;
+                uint64_t m_sequence;
+            };
+
+            //the released outputs are kept for the next samples sets, the pool outlives the module while its outputs are held
+            class output_pool : public std::enable_shared_from_this<output_pool>
+            {
+            public:
+                output_ptr acquire()
+                {
+                    std::unique_ptr<output_type> output;
+                    {
+                        std::lock_guard<std::mutex> lock(m_lock);
+                        if(!m_free_outputs.empty())
+                        {
+                            output = std::move(m_free_outputs.back());
+                            m_free_outputs.pop_back();
+                        }
+                    }
+                    if(!output)
+                        output.reset(new output_type());
+                    auto pool = this->shared_from_this();
+                    return output_ptr(output.release(), [pool](output_type * released) { pool->recycle(released); });
+                }
+            private:
+                void recycle(output_type * output)
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    m_free_outputs.emplace_back(output);
+                }
+                std::mutex m_lock;
+                std::vector<std::unique_ptr<output_type>> m_free_outputs;
+            };
+
+            struct worker
+            {
+                explicit worker(uint32_t queue_depth) : queue(queue_depth), profiler(thread_role::cv_module) {}
+                concurrent_cyclic_array<queued_sample_set, producers_model::multiple> queue;
+                std::mutex wake_lock;
+                std::condition_variable wake;
+                thread_profiler profiler;
+                std::thread thread;
+            };
+
+            void start_workers()
+            {
+                for(auto & worker : m_workers)
+                    worker->thread = std::thread(&async_video_module_base::processing_loop, this, worker.get());
+            }
+
+            void processing_loop(worker * current_worker)
+            {
+                thread_configuration::apply(thread_role::cv_module, m_thread_name.c_str());
+                current_worker->profiler.start();
+                while(!m_is_stopped.load(std::memory_order_acquire))
+                {
+                    queued_sample_set queued;
+                    if(!current_worker->queue.pop_front(queued))
+                    {
+                        thread_profiler::wait_scope wait(current_worker->profiler, thread_wait::input);
+                        std::unique_lock<std::mutex> lock(current_worker->wake_lock);
+                        current_worker->wake.wait(lock, [&]() { return m_is_stopped.load(std::memory_order_acquire) || !current_worker->queue.empty(); });
+                        continue;
+                    }
+                    if(queued.sequence() < m_flushed_sequence.load(std::memory_order_acquire))
+                    {
+                        m_dropped_count.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+                    process(queued);
+                    current_worker->profiler.add_processed_items();
+                }
+                current_worker->profiler.stop();
+            }
+
+            void process(const queued_sample_set & queued)
+            {
+                output_ptr output = m_outputs->acquire();
+                auto start_time = timebase::now();
+                auto status = process_samples(queued.sample_set(), *output);
+                auto processing_time = timebase::microseconds_since(start_time);
+                m_total_processing_time.fetch_add(processing_time, std::memory_order_relaxed);
+                auto max_processing_time = m_max_processing_time.load(std::memory_order_relaxed);
+                while(processing_time > max_processing_time &&
+                      !m_max_processing_time.compare_exchange_weak(max_processing_time, processing_time, std::memory_order_relaxed));
+                if(status < rs::core::status_no_error)
+                {
+                    m_failed_count.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                m_processed_count.fetch_add(1, std::memory_order_relaxed);
+
+                {
+                    std::lock_guard<std::mutex> lock(m_output_lock);
+                    if(queued.sequence() < m_published_sequence)
+                        return;
+                    m_published_sequence = queued.sequence();
+                    m_output = std::move(output);
+                    m_is_output_new = true;
+                }
+                m_output_ready.notify_all();
+
+                std::lock_guard<std::mutex> lock(m_handler_lock);
+                if(m_handler)
+                    m_handler->module_output_ready(this, nullptr);
+            }
+
+            const std::string m_thread_name;
+            std::vector<std::unique_ptr<worker>> m_workers;
+            std::once_flag m_workers_started;
+            std::shared_ptr<output_pool> m_outputs;
+
+            std::mutex m_handler_lock;
+            processing_event_handler * m_handler;
+
+            std::mutex m_output_lock;                       // Guards the published output
+            std::condition_variable m_output_ready;
+            output_ptr m_output;
+            bool m_is_output_new;
+            uint64_t m_published_sequence;
+            std::atomic<bool> m_is_stopped;
+
+            std::atomic<uint64_t> m_next_sequence;          // The sequence of the next samples set, starts at 1
+            std::atomic<uint64_t> m_flushed_sequence;       // The samples sets of an earlier sequence are dropped
+            std::atomic<size_t> m_next_worker;
+
+            std::atomic<uint64_t> m_received_count;
+            std::atomic<uint64_t> m_processed_count;
+            std::atomic<uint64_t> m_failed_count;
+            std::atomic<uint64_t> m_dropped_count;
+            std::atomic<uint64_t> m_total_processing_time;
+            std::atomic<uint64_t> m_max_processing_time;
+        };
+    }
+}
@@ -0,0 +1,188 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file concurrent_cyclic_array.h
+* @brief Describes the \c rs::utils::concurrent_cyclic_array class.
+*/
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <stdint.h>
+#include <vector>
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief The threads which may push elements to a \c concurrent_cyclic_array concurrently.
+        */
+        enum class producers_model
+        {
+            single,     /**< A single producer thread pushes elements */
+            multiple    /**< Any number of producer threads push elements concurrently */
+        };
+
+        /**
+        * @brief Implements a lock free cyclic array of elements of type T, for producer threads and a single consumer thread.
+        *
+        * A thread safe companion of \c cyclic_array. The element memory is allocated once, in the constructor, and the capacity is rounded
+        * up to a power of two, so the cyclic index is masked instead of divided.
+        * Unlike \c cyclic_array, a full array doesn't overwrite its oldest element, which the consumer may be reading, the push fails
+        * and the producer decides whether to drop the element or retry.
+        * Each element slot holds a sequence number, which tells the producers whether the slot is free and the consumer whether the
+        * slot is written, so the head and the tail are each written by one side only. They are kept on separate cache lines, the
+        * producers and the consumer don't invalidate each other's cache lines on every element.
+        * This container requires T to have a default constructor and a move assignment.
+        */
+        template <class T, producers_model producers = producers_model::single>
+        class concurrent_cyclic_array
+        {
+          public:
+            /**
+            * @brief Constructor: creates a concurrent cyclic array of at least \c capacity elements.
+            *
+            * The method throws an out-of-range exception, if the capacity is zero.
+            *
+            * @param[in] capacity Minimal number of elements in the cyclic array, rounded up to a power of two
+            */
+            explicit concurrent_cyclic_array(unsigned int capacity) : m_slots(round_up_to_power_of_two(capacity)), m_mask(m_slots.size() - 1),
+                m_head(0), m_tail(0)
+            {
+                for(size_t index = 0; index < m_slots.size(); index++)
+                    m_slots[index].sequence.store(index, std::memory_order_relaxed);
+            }
+
+            /**
+            * @brief Moves a new element to the end of the cyclic array.
+            *
+            * May be called by the producer threads only, by a single thread with the \c producers_model::single model.
+            * The original copy may not be safe to use further, depending on Move Assignment behaviour.
+            *
+            * @param[in] new_element Element to insert at the end of the cyclic array
+            * @return true if the element was inserted, false if the array is full and \c new_element wasn't moved
+            */
+            bool push_back(T& new_element)
+            {
+                size_t position = m_tail.load(std::memory_order_relaxed);
+                slot * target = nullptr;
+                for(;;)
+                {
+                    target = &m_slots[position & m_mask];
+                    const intptr_t distance = static_cast<intptr_t>(target->sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position);
+                    if(distance < 0)
+                        return false; // the slot wasn't popped yet since the previous cycle
+
+                    if(distance == 0)
+                    {
+                        if(producers == producers_model::single)
+                        {
+                            m_tail.store(position + 1, std::memory_order_relaxed);
+                            break;
+                        }
+                        // the producers race for the slot, the loser retries with the position the winner left
+                        if(m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                            break;
+                    }
+                    else
+                        position = m_tail.load(std::memory_order_relaxed);
+                }
+
+                target->value = std::move(new_element);
+                target->sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+
+            /**
+            * @brief Moves the first (oldest) element out of the cyclic array.
+            *
+            * May be called by a single consumer thread at a time. The slot is replaced with a default constructed element,
+            * so the element content isn't held by the array after it was popped.
+            *
+            * @param[out] element The oldest element, unchanged if the array is empty
+            * @return true if an element was popped
+            */
+            bool pop_front(T& element)
+            {
+                const size_t position = m_head.load(std::memory_order_relaxed);
+                slot & source = m_slots[position & m_mask];
+                if(source.sequence.load(std::memory_order_acquire) != position + 1)
+                    return false; // the slot isn't written yet
+
+                element = std::move(source.value);
+                source.value = T();
+                source.sequence.store(position + m_slots.size(), std::memory_order_release);
+                m_head.store(position + 1, std::memory_order_release);
+                return true;
+            }
+
+            /**
+            * @brief Checks whether the first element in the cyclic array is written.
+            *
+            * Exact on the consumer thread, a hint on other threads.
+            *
+            * @return bool true if there is no element to pop
+            */
+            bool empty() const
+            {
+                const size_t position = m_head.load(std::memory_order_acquire);
+                return m_slots[position & m_mask].sequence.load(std::memory_order_acquire) != position + 1;
+            }
+
+            /**
+            * @brief Returns the number of elements in the cyclic array, including elements which are being pushed.
+            *
+            * Safe to call from any thread, the result is a snapshot which may be outdated once returned.
+            *
+            * @return unsigned int Number of elements
+            */
+            unsigned int size() const
+            {
+                const size_t head = m_head.load(std::memory_order_acquire);
+                const size_t tail = m_tail.load(std::memory_order_acquire);
+                return tail > head ? static_cast<unsigned int>(tail - head) : 0;
+            }
+
+            /**
+            * @brief Returns the maximum number of elements in the cyclic array.
+            *
+            * @return unsigned int Capacity, a power of two
+            */
+            unsigned int capacity() const { return static_cast<unsigned int>(m_slots.size()); }
+
+          private:
+            concurrent_cyclic_array(const concurrent_cyclic_array&) = delete;
+            concurrent_cyclic_array& operator=(const concurrent_cyclic_array&) = delete;
+
+            static const size_t CACHE_LINE_SIZE = 64;
+
+            struct slot
+            {
+                slot() : sequence(0), value() {}
+                std::atomic<size_t> sequence;   /**< the position the slot is written at, plus one once the element is written */
+                T                   value;
+            };
+
+            static size_t round_up_to_power_of_two(unsigned int capacity)
+            {
+                if (capacity == 0)
+                    throw std::out_of_range("Can not create a concurrent array of size 0!");
+                size_t size = 1;
+                while (size < capacity)
+                    size <<= 1;
+                return size;
+            }
+
+            std::vector<slot>       m_slots;                                        /**< the elements, allocated once */
+            const size_t            m_mask;                                         /**< capacity - 1, masks a position to its slot index */
+            char                    m_head_padding[CACHE_LINE_SIZE];
+            std::atomic<size_t>     m_head;                                         /**< position of the first element, written by the consumer */
+            char                    m_tail_padding[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+            std::atomic<size_t>     m_tail;                                         /**< position of the next free slot, written by the producers */
+            char                    m_end_padding[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+        };
+    }
+}
@@ -8,9 +8,15 @@
 */
 
 #pragma once
-#include <mutex>
-#include <deque>
+#include <atomic>
+#include <memory>
 #include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <stdint.h>
+#include "rs/utils/timebase.h"
 
 namespace rs
 {
@@ -19,8 +25,8 @@ namespace rs
         /**
          * @brief Provides a common way to measure FPS, regardless of the context it is used in.
          *
-         * The \c fps_counter uses a fixed size buffer to store time values so there should not be any impactful memory allocations (for example, buffer resize)
-         * after approximately 2 seconds of streaming.
+         * The \c fps_counter uses a fixed size ring buffer to store time values, it is allocated once, when the counter is created.
+         * \c tick() is lock free, it may be called from several threads, such as the callbacks of several streams.
 		 *
          * Try to refrain from using time consuming operations (for example, using output stream or allocating large memory chunks) unless it is required,
          * as they can reduce the general performance of the code block which can impact the FPS counting.
@@ -29,10 +35,27 @@ namespace rs
          * however, this clock may have different precision that depends on system, STL implementation.
 		 * 
          * Time values stored have nanoseconds precision by default.
+         * Besides the averages, the counter keeps a histogram of the intervals between ticks, which provides the intervals percentiles,
+         * the jitter and an estimate of the dropped frames.
          */
         class fps_counter
         {
         public:
+            /**
+             * @brief Statistics of the intervals between ticks, since the counter was created.
+             *
+             * The percentiles are resolved by the histogram buckets, within 1/8 of the interval.
+             */
+            struct interval_statistics
+            {
+                uint64_t intervals_count;       /**< Number of intervals between ticks */
+                double   median_interval_ms;    /**< 50th percentile of the intervals, in milliseconds */
+                double   p99_interval_ms;       /**< 99th percentile of the intervals, in milliseconds */
+                double   max_interval_ms;       /**< Longest interval, in milliseconds */
+                double   max_jitter_ms;         /**< Largest deviation of an interval from the frame rate interval, in milliseconds */
+                uint64_t dropped_frames_count;  /**< Estimated number of frames missing from intervals longer than 1.5 frame rate intervals */
+            };
+
             /**
              * @brief Creates an instance of \c fps_counter.
              *
@@ -47,10 +70,17 @@ namespace rs
              * @param[in] frame_rate Frame rate value requested for stream (for example, color stream frame rate)
              */
             fps_counter(unsigned int frame_rate) :
-                m_time_buffer_max_size(static_cast<size_t>(1.3 * frame_rate))
+                m_time_buffer_max_size(std::max<size_t>(1, static_cast<size_t>(1.3 * frame_rate))),
                 // Coefficient is a magic number to balance between better measurement and smaller time interval of getting proper results
                 // as valid value of fps will be counted approx. after [1 sec * coefficient] seconds
-            {}
+                m_time_buffer(new std::atomic<int64_t>[m_time_buffer_max_size]),
+                m_expected_interval(frame_rate > 0 ? BILLION / frame_rate : 0)
+            {
+                for(size_t i = 0; i < m_time_buffer_max_size; i++)
+                    m_time_buffer[i].store(0, std::memory_order_relaxed);
+                for(auto & bucket : m_intervals_histogram)
+                    bucket.store(0, std::memory_order_relaxed);
+            }
 
             /**
              * @brief Captures an event of frame arrival.
@@ -61,26 +91,27 @@ namespace rs
              * The buffer is used later to provide time values to count current or total FPS.
              * The method is the main method for the whole FPS counting and it is mandatory to call it for proper calculations.
              * The first few frames are skipped to avoid jitters of the streams at the beginning of the streaming.
-             * The method processing is guaranteed to be short to prevent FPS changes due to measurement.
+             * The method processing is guaranteed to be short to prevent FPS changes due to measurement, it doesn't lock or allocate.
              */
             void tick()
             {
-                if (m_skip_first_frames != 0) m_skip_first_frames--; // skip first frames as they may be incorrectly processed(for example, assume some buffer allocations)
-                else
-                {
-                    std::lock_guard<std::mutex> lock(m_time_values_mutex);
-                    time_point time_value = std::chrono::steady_clock::now();
-                    if (m_time_buffer.size() == (m_time_buffer_max_size))
-                        m_time_buffer.pop_front();
-                    m_time_buffer.push_back(time_value);
-                    m_frames++;
-
-                    if (!m_first_time_value_set)
-                    {
-                        m_first_time_value = time_value;
-                        m_first_time_value_set = true;
-                    }
-                }
+                // skip first frames as they may be incorrectly processed(for example, assume some buffer allocations)
+                const uint64_t tick_index = m_ticks.fetch_add(1, std::memory_order_relaxed);
+                if (tick_index < SKIP_FIRST_FRAMES) return;
+
+                const int64_t time_value = rs::utils::timebase::now().time_since_epoch().count();
+                const uint64_t frame_index = tick_index - SKIP_FIRST_FRAMES;
+                m_time_buffer[frame_index % m_time_buffer_max_size].store(time_value, std::memory_order_relaxed);
+                if (frame_index == 0)
+                    m_first_time_value.store(time_value, std::memory_order_relaxed);
+
+                // ticks of several threads are ordered by the time they store, a tick which stored an earlier time counts a zero interval
+                const int64_t previous_time_value = m_last_time_value.exchange(time_value, std::memory_order_relaxed);
+                if (previous_time_value != 0)
+                    add_interval(std::max<int64_t>(0, time_value - previous_time_value));
+
+                // publishes the time values to the readers
+                m_frames.fetch_add(1, std::memory_order_release);
             }
 
             /**
@@ -97,16 +128,14 @@ namespace rs
              */
             const double total_average_fps()
             {
-                std::lock_guard<std::mutex> lock(m_time_values_mutex);
-                if (!m_first_time_value_set)
+                const uint64_t frames = m_frames.load(std::memory_order_acquire);
+                if (frames == 0)
                 {
                     throw std::out_of_range("No time values were stored with tick()");
                 }
-                const long billion = 1000000000;
-                const double time_delta = static_cast<double>(
-                        (long double)(std::chrono::duration_cast<std::chrono::nanoseconds>(
-                                          m_time_buffer.back() - m_first_time_value).count()) / billion);
-                return (static_cast<double>(m_frames - 1) / time_delta);
+                const double time_delta = static_cast<double>(m_last_time_value.load(std::memory_order_relaxed) -
+                                                              m_first_time_value.load(std::memory_order_relaxed)) / BILLION;
+                return (static_cast<double>(frames - 1) / time_delta);
             }
 
             /**
@@ -121,35 +150,126 @@ namespace rs
              */
             const double current_fps()
             {
-                std::lock_guard<std::mutex> lock(m_time_values_mutex);
-                const size_t time_buffer_size = m_time_buffer.size();
+                const size_t time_buffer_size = static_cast<size_t>(std::min<uint64_t>(m_frames.load(std::memory_order_acquire), m_time_buffer_max_size));
                 if (!time_buffer_size) return 0;
-                const long billion = 1000000000;
-                const double time_delta = static_cast<double>(
-                        (long double)(std::chrono::duration_cast<std::chrono::nanoseconds>(
-                                          m_time_buffer.back() - m_time_buffer.front()).count()) / billion);
+                // the ring is written concurrently, the buffer time span is taken from its oldest and newest values
+                int64_t oldest_time_value = m_time_buffer[0].load(std::memory_order_relaxed), newest_time_value = oldest_time_value;
+                for (size_t i = 1; i < time_buffer_size; i++)
+                {
+                    const int64_t time_value = m_time_buffer[i].load(std::memory_order_relaxed);
+                    oldest_time_value = std::min(oldest_time_value, time_value);
+                    newest_time_value = std::max(newest_time_value, time_value);
+                }
+                const double time_delta = static_cast<double>(newest_time_value - oldest_time_value) / BILLION;
                 if (time_delta == 0) return 0;
                 return (static_cast<double>(time_buffer_size - 1) / time_delta);
             }
 
+            /**
+             * @brief Returns the statistics of the intervals between ticks.
+             *
+             * The statistics are read without stopping the ticks, a tick which is concurrent with the method may be partially accounted.
+             * The method processing is short, it reads a fixed size histogram.
+             * @return interval_statistics Intervals statistics, zeroed if there were less than two ticks
+             */
+            interval_statistics query_interval_statistics() const
+            {
+                interval_statistics statistics = {};
+                uint64_t buckets[HISTOGRAM_BUCKETS];
+                for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+                {
+                    buckets[i] = m_intervals_histogram[i].load(std::memory_order_relaxed);
+                    statistics.intervals_count += buckets[i];
+                }
+                if (statistics.intervals_count == 0) return statistics;
+
+                auto percentile = [&](double fraction) -> double
+                {
+                    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(statistics.intervals_count))));
+                    uint64_t count = 0;
+                    for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+                    {
+                        count += buckets[i];
+                        if (count >= rank) return bucket_middle_value(i) / 1000.;
+                    }
+                    return bucket_middle_value(HISTOGRAM_BUCKETS - 1) / 1000.;
+                };
+                statistics.median_interval_ms = percentile(0.5);
+                statistics.p99_interval_ms = percentile(0.99);
+
+                const int64_t max_interval = m_max_interval.load(std::memory_order_relaxed);
+                const int64_t min_interval = m_min_interval.load(std::memory_order_relaxed);
+                statistics.max_interval_ms = static_cast<double>(max_interval) / MILLION;
+                if (m_expected_interval > 0)
+                {
+                    statistics.max_jitter_ms = static_cast<double>(std::max(max_interval - m_expected_interval, m_expected_interval - min_interval)) / MILLION;
+                }
+                statistics.dropped_frames_count = m_dropped_frames.load(std::memory_order_relaxed);
+                return statistics;
+            }
+
 
         private:
             fps_counter() = delete;
             fps_counter(const fps_counter&) = delete;
             const fps_counter& operator=(const fps_counter&) = delete;
 
+            static const int64_t   BILLION = 1000000000;
+            static const int64_t   MILLION = 1000000;
+            static const uint64_t  SKIP_FIRST_FRAMES = 5; /**< number of possibly invalid frames at stream start */
+
+            // the intervals histogram has 8 buckets per power of 2 microseconds, up to 2^32 microseconds
+            static const int       SUB_BUCKET_BITS = 3;
+            static const int       SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+            static const int       HISTOGRAM_BUCKETS = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
 
-            int                    m_frames = 0; /**< number of frames */
+            static int bucket_of(uint64_t interval_us)
+            {
+                interval_us = std::min<uint64_t>(interval_us, 0xffffffffull);
+                if (interval_us < SUB_BUCKETS) return static_cast<int>(interval_us);
+                int exponent = 0;
+                while ((interval_us >> (exponent + 1)) != 0) exponent++;
+                const int sub_bucket = static_cast<int>(interval_us >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+                return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub_bucket;
+            }
+
+            // the middle of the bucket values range, in microseconds
+            static double bucket_middle_value(int bucket)
+            {
+                if (bucket < SUB_BUCKETS) return bucket;
+                const int exponent = bucket / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+                const uint64_t bucket_width = 1ull << (exponent - SUB_BUCKET_BITS);
+                const uint64_t lower_value = static_cast<uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) * bucket_width;
+                return static_cast<double>(lower_value) + static_cast<double>(bucket_width) / 2.;
+            }
 
-            //typedef for shorter usage
-            typedef std::chrono::time_point<std::chrono::steady_clock, std::chrono::nanoseconds> time_point;
-            std::deque<time_point> m_time_buffer; /**< time values buffer with nanosecond precision */
-            time_point             m_first_time_value; /**< first time value to calculate total average FPS */
+            void add_interval(int64_t interval)
+            {
+                m_intervals_histogram[bucket_of(static_cast<uint64_t>(interval / 1000))].fetch_add(1, std::memory_order_relaxed);
+
+                int64_t max_interval = m_max_interval.load(std::memory_order_relaxed);
+                while (interval > max_interval && !m_max_interval.compare_exchange_weak(max_interval, interval, std::memory_order_relaxed)) {}
+                int64_t min_interval = m_min_interval.load(std::memory_order_relaxed);
+                while (interval < min_interval && !m_min_interval.compare_exchange_weak(min_interval, interval, std::memory_order_relaxed)) {}
+
+                // an interval of n frame rate intervals is missing n - 1 frames
+                if (m_expected_interval > 0 && 2 * interval > 3 * m_expected_interval)
+                {
+                    m_dropped_frames.fetch_add(static_cast<uint64_t>(std::llround(static_cast<double>(interval) / static_cast<double>(m_expected_interval))) - 1, std::memory_order_relaxed);
+                }
+            }
 
-            const size_t           m_time_buffer_max_size; /**< max supposed size of time values buffer */
-            bool                   m_first_time_value_set = false; /**< flag for the first time value */
-            int                    m_skip_first_frames = 5; /**< number of possibly invalid frames at stream start */
-            std::mutex             m_time_values_mutex; /**< mutex for time values */
+            const size_t                            m_time_buffer_max_size; /**< size of the time values ring */
+            std::unique_ptr<std::atomic<int64_t>[]> m_time_buffer; /**< ring of time values, in sdk timebase nanoseconds */
+            const int64_t                           m_expected_interval; /**< the frame rate interval, in nanoseconds */
+            std::atomic<uint64_t>                   m_ticks{0}; /**< number of ticks, including the skipped ticks */
+            std::atomic<uint64_t>                   m_frames{0}; /**< number of frames whose time values were stored */
+            std::atomic<int64_t>                    m_first_time_value{0}; /**< first time value to calculate total average FPS */
+            std::atomic<int64_t>                    m_last_time_value{0}; /**< last stored time value */
+            std::atomic<int64_t>                    m_max_interval{0};
+            std::atomic<int64_t>                    m_min_interval{std::numeric_limits<int64_t>::max()};
+            std::atomic<uint64_t>                   m_dropped_frames{0};
+            std::atomic<uint32_t>                   m_intervals_histogram[HISTOGRAM_BUCKETS]; /**< intervals count per bucket */
         };
     }
 }
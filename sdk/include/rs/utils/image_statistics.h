@@ -0,0 +1,89 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file image_statistics.h
+* @brief Describes the \c rs::utils::image_statistics class.
+*/
+
+#pragma once
+#include <stdint.h>
+#include "rs/core/image_interface.h"
+#include "rs/core/status.h"
+
+#ifdef WIN32
+#ifdef realsense_image_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_image_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Statistics of the pixels of z16, y16 and y8 images.
+        *
+        * The statistics are computed over a region of interest, in rows of the image pitch, the rows of large regions are
+        * split to bands which are processed in parallel. A zero pixel is counted as an invalid pixel, it doesn't affect
+        * the minimum and the mean, since a zero depth value has no depth data.
+        */
+        class DLL_EXPORT image_statistics
+        {
+        public:
+            /**
+            * @brief Statistics of the region of interest pixels.
+            */
+            struct statistics
+            {
+                uint16_t min_value;         /**< Minimal valid pixel value, 0 if there are no valid pixels */
+                uint16_t max_value;         /**< Maximal pixel value */
+                uint64_t sum;               /**< Sum of the pixel values */
+                uint64_t pixels_count;      /**< Number of pixels in the region of interest */
+                uint64_t valid_pixels_count;/**< Number of non zero pixels */
+
+                /**
+                * @brief Returns the mean of the valid pixel values, 0 if there are no valid pixels.
+                */
+                double mean() const { return valid_pixels_count > 0 ? static_cast<double>(sum) / static_cast<double>(valid_pixels_count) : 0.; }
+            };
+
+            /**
+            * @brief Computes the statistics of the image pixels.
+            * @param[in]  info          Image info, the format must be z16, y16 or y8
+            * @param[in]  data          Image data, rows are \c info.pitch bytes apart
+            * @param[in]  roi           Region of interest, clamped to the image. A region with zero width or height is the whole image.
+            * @param[out] stats         The statistics of the region of interest pixels
+            * @return status_no_error               Successful execution
+            * @return status_handle_invalid         Null image data
+            * @return status_param_unsupported      Unsupported pixel format
+            * @return status_invalid_argument       Negative region coordinates or size
+            */
+            static core::status query_statistics(const core::image_info & info, const void * data, const core::rect & roi, statistics & stats);
+
+            /**
+            * @brief Computes the histogram of the image pixel values.
+            *
+            * The format value range is split to \c bins_count bins of equal width, a pixel of value v is counted in bin
+            * v * bins_count / (max format value + 1). Zero pixels are counted in the first bin.
+            * @param[in]  info          Image info, the format must be z16, y16 or y8
+            * @param[in]  data          Image data, rows are \c info.pitch bytes apart
+            * @param[in]  roi           Region of interest, clamped to the image. A region with zero width or height is the whole image.
+            * @param[out] bins          Array of \c bins_count counters, overwritten by the histogram
+            * @param[in]  bins_count    Number of bins, between 1 and the number of format values
+            * @return status_no_error               Successful execution
+            * @return status_handle_invalid         Null image data or bins
+            * @return status_param_unsupported      Unsupported pixel format
+            * @return status_invalid_argument       Negative region coordinates or size, or invalid number of bins
+            */
+            static core::status query_histogram(const core::image_info & info, const void * data, const core::rect & roi, uint32_t * bins, uint32_t bins_count);
+
+        private:
+            image_statistics() = delete;
+        };
+    }
+}
@@ -17,6 +17,61 @@ namespace rs
 {
     namespace utils
     {
+        namespace conversion_tables
+        {
+            //the conversions of the per frame fields are indexed by the source enum value, the order of each table follows its source enum
+            static constexpr rs::format pixel_format_to_lrs[] =
+            {
+                rs::format::any, rs::format::z16, rs::format::disparity16, rs::format::xyz32f, rs::format::yuyv, rs::format::rgb8, rs::format::bgr8,
+                rs::format::rgba8, rs::format::bgra8, rs::format::y8, rs::format::y16, rs::format::raw8, rs::format::raw10, rs::format::raw16
+            };
+
+            static constexpr rs::core::pixel_format lrs_to_pixel_format[] =
+            {
+                rs::core::pixel_format::any, rs::core::pixel_format::z16, rs::core::pixel_format::disparity16, rs::core::pixel_format::xyz32f,
+                rs::core::pixel_format::yuyv, rs::core::pixel_format::rgb8, rs::core::pixel_format::bgr8, rs::core::pixel_format::rgba8,
+                rs::core::pixel_format::bgra8, rs::core::pixel_format::y8, rs::core::pixel_format::y16, rs::core::pixel_format::raw10,
+                rs::core::pixel_format::raw16, rs::core::pixel_format::raw8
+            };
+
+            static constexpr rs::stream stream_type_to_lrs[] =
+            {
+                rs::stream::depth, rs::stream::color, rs::stream::infrared, rs::stream::infrared2, rs::stream::fisheye,
+                static_cast<rs::stream>(-1), rs::stream::rectified_color
+            };
+
+            //the aligned streams of librealsense have no SDK stream type
+            static constexpr rs::core::stream_type lrs_to_stream_type[] =
+            {
+                rs::core::stream_type::depth, rs::core::stream_type::color, rs::core::stream_type::infrared, rs::core::stream_type::infrared2,
+                rs::core::stream_type::fisheye, static_cast<rs::core::stream_type>(-1), rs::core::stream_type::rectified_color
+            };
+
+            static constexpr rs::timestamp_domain timestamp_domain_to_lrs[] = { rs::timestamp_domain::camera, rs::timestamp_domain::microcontroller };
+
+            static constexpr rs::core::timestamp_domain lrs_to_timestamp_domain[] = { rs::core::timestamp_domain::camera, rs::core::timestamp_domain::microcontroller };
+
+            template<typename to, typename from, size_t count>
+            constexpr to lookup(const to (&table)[count], from value)
+            {
+                return static_cast<size_t>(value) < count ? table[static_cast<size_t>(value)] : static_cast<to>(-1);
+            }
+
+            //the tables are written by value names, checks that each table is the inverse of the other
+            template<typename to, typename from, size_t to_count, size_t from_count>
+            constexpr bool are_inverse(const to (&table)[to_count], const from (&inverse)[from_count], size_t index = 0)
+            {
+                return index == to_count ||
+                       ((static_cast<size_t>(table[index]) >= from_count || static_cast<size_t>(inverse[static_cast<size_t>(table[index])]) == index) &&
+                        are_inverse(table, inverse, index + 1));
+            }
+
+            static_assert(are_inverse(pixel_format_to_lrs, lrs_to_pixel_format) && are_inverse(lrs_to_pixel_format, pixel_format_to_lrs),
+                          "pixel format conversion tables don't match");
+            static_assert(are_inverse(stream_type_to_lrs, lrs_to_stream_type), "stream type conversion tables don't match");
+            static_assert(are_inverse(timestamp_domain_to_lrs, lrs_to_timestamp_domain), "timestamp domain conversion tables don't match");
+        }
+
         /**
         * @brief Converts pixel format from the SDK type to librealsense type.
         *
@@ -25,24 +80,7 @@ namespace rs
         */
         static rs::format convert_pixel_format(rs::core::pixel_format framework_pixel_format)
         {
-            switch(framework_pixel_format)
-            {
-                case rs::core::pixel_format::any         : return rs::format::any;
-                case rs::core::pixel_format::z16         : return rs::format::z16;
-                case rs::core::pixel_format::disparity16 : return rs::format::disparity16;
-                case rs::core::pixel_format::xyz32f      : return rs::format::xyz32f;
-                case rs::core::pixel_format::yuyv        : return rs::format::yuyv;
-                case rs::core::pixel_format::rgb8        : return rs::format::rgb8;
-                case rs::core::pixel_format::bgr8        : return rs::format::bgr8;
-                case rs::core::pixel_format::rgba8       : return rs::format::rgba8;
-                case rs::core::pixel_format::bgra8       : return rs::format::bgra8;
-                case rs::core::pixel_format::y8          : return rs::format::y8;
-                case rs::core::pixel_format::y16         : return rs::format::y16;
-                case rs::core::pixel_format::raw8        : return rs::format::raw8;
-                case rs::core::pixel_format::raw10       : return rs::format::raw10;
-                case rs::core::pixel_format::raw16       : return rs::format::raw16;
-            }
-            return static_cast<rs::format>(-1);
+            return conversion_tables::lookup(conversion_tables::pixel_format_to_lrs, framework_pixel_format);
         }
 
         /**
@@ -53,26 +91,9 @@ namespace rs
         */
         static rs::core::pixel_format convert_pixel_format(rs::format lsr_pixel_format)
         {
-            switch(lsr_pixel_format)
-            {
-                case rs::format::any         : return rs::core::pixel_format::any;
-                case rs::format::z16         : return rs::core::pixel_format::z16;
-                case rs::format::disparity16 : return rs::core::pixel_format::disparity16;
-                case rs::format::xyz32f      : return rs::core::pixel_format::xyz32f;
-                case rs::format::yuyv        : return rs::core::pixel_format::yuyv;
-                case rs::format::rgb8        : return rs::core::pixel_format::rgb8;
-                case rs::format::bgr8        : return rs::core::pixel_format::bgr8;
-                case rs::format::rgba8       : return rs::core::pixel_format::rgba8;
-                case rs::format::bgra8       : return rs::core::pixel_format::bgra8;
-                case rs::format::y8          : return rs::core::pixel_format::y8;
-                case rs::format::y16         : return rs::core::pixel_format::y16;
-                case rs::format::raw8        : return rs::core::pixel_format::raw8;
-                case rs::format::raw10       : return rs::core::pixel_format::raw10;
-                case rs::format::raw16       : return rs::core::pixel_format::raw16;
-            }
-            return static_cast<rs::core::pixel_format>(-1);
+            return conversion_tables::lookup(conversion_tables::lrs_to_pixel_format, lsr_pixel_format);
         }
-    
+
         /**
         * @brief Converts stream type from the librealsense type to the SDK type.
         *
@@ -81,18 +102,7 @@ namespace rs
         */
         static rs::core::stream_type convert_stream_type(rs::stream lrs_stream)
         {
-            switch(lrs_stream)
-            {
-                case rs::stream::depth                            : return rs::core::stream_type::depth;
-                case rs::stream::color                            : return rs::core::stream_type::color;
-                case rs::stream::infrared                         : return rs::core::stream_type::infrared;
-                case rs::stream::infrared2                        : return rs::core::stream_type::infrared2;
-                case rs::stream::fisheye                          : return rs::core::stream_type::fisheye;
-                case rs::stream::rectified_color                  : return rs::core::stream_type::rectified_color;
-            default:
-                return static_cast<rs::core::stream_type>(-1);
-            }
-            return static_cast<rs::core::stream_type>(-1);
+            return conversion_tables::lookup(conversion_tables::lrs_to_stream_type, lrs_stream);
         }
 
         /**
@@ -103,17 +113,7 @@ namespace rs
         */
         static rs::stream convert_stream_type(rs::core::stream_type framework_stream_type)
         {
-            switch(framework_stream_type)
-            {
-                case rs::core::stream_type::depth                            : return rs::stream::depth;
-                case rs::core::stream_type::color                            : return rs::stream::color;
-                case rs::core::stream_type::infrared                         : return rs::stream::infrared;
-                case rs::core::stream_type::infrared2                        : return rs::stream::infrared2;
-                case rs::core::stream_type::fisheye                          : return rs::stream::fisheye;
-                case rs::core::stream_type::rectified_color                  : return rs::stream::rectified_color;
-                default                                            : return static_cast<rs::stream>(-1);
-            }
-            return static_cast<rs::stream>(-1);
+            return conversion_tables::lookup(conversion_tables::stream_type_to_lrs, framework_stream_type);
         }
 
         /**
@@ -229,13 +229,7 @@ namespace rs
         */
         static rs::timestamp_domain convert_timestamp_domain(const rs::core::timestamp_domain framework_timestamp_domain)
         {
-            switch(framework_timestamp_domain)
-            {
-                case rs::core::timestamp_domain::camera : return rs::timestamp_domain::camera;
-                case rs::core::timestamp_domain::microcontroller : return rs::timestamp_domain::microcontroller;
-                default : break;
-            }
-            return static_cast<rs::timestamp_domain>(-1);
+            return conversion_tables::lookup(conversion_tables::timestamp_domain_to_lrs, framework_timestamp_domain);
         }
 
         /**
@@ -246,13 +240,7 @@ namespace rs
         */
         static rs::core::timestamp_domain convert_timestamp_domain(const rs::timestamp_domain lrs_timestamp_domain)
         {
-            switch(lrs_timestamp_domain)
-            {
-                case rs::timestamp_domain::camera :          return rs::core::timestamp_domain::camera;
-                case rs::timestamp_domain::microcontroller : return rs::core::timestamp_domain::microcontroller;
-            default : break;
-            }
-            return static_cast<rs::core::timestamp_domain>(-1);
+            return conversion_tables::lookup(conversion_tables::lrs_to_timestamp_domain, lrs_timestamp_domain);
         }
 
         /**
@@ -12,6 +12,9 @@
 #include <stdio.h>
 #include <string>
 #include <sstream>
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
 
 #ifdef WIN32 
 #ifdef realsense_log_utils_EXPORTS
@@ -40,8 +43,63 @@ namespace rs
             log_util(wchar_t* name = NULL);
             virtual ~log_util();
 
+            /**
+            * @brief Returns true if messages of the given level are logged.
+            *
+            * The check reads the cached minimal enabled level and doesn't call the logger, so disabled log call sites are cheap.
+            * @param[in] level The level to check
+            */
+            bool is_level_enabled(logging_service::log_level level) const { return level >= m_enabled_level.load(std::memory_order_relaxed); }
+
+            /**
+            * @brief Sets the level of the logger and updates the cached level. Setting the level directly on \c m_logger isn't reflected in the cache.
+            * @param[in] level New log level
+            */
+            rs::core::status set_level(logging_service::log_level level);
+
             logging_service* m_logger;      /**< Pointer to an object implementing the \c logging_service interface */
             empty_logger m_empty_logger;    /**< Default (empty) logger, with empty implementation of all log functions. Logs to /dev/null. */
+        private:
+            void update_enabled_level();
+
+            std::atomic<logging_service::log_level> m_enabled_level; /**< Minimal level which the logger logs */
+        };
+
+        /**
+        * @brief Limits the messages of a log call site to a message per interval, and counts the messages it suppresses.
+        *
+        * The per frame warnings are logged the most when the system is overloaded, formatting and writing a message per frame adds to the
+        * overload. A suppressed message costs an atomic increment, the next logged message reports the count of the suppressed messages.
+        */
+        class log_rate_limiter
+        {
+        public:
+            static const uint64_t INTERVAL_MS = 1000;
+
+            log_rate_limiter() : m_last_log_ms(0), m_suppressed_count(0) {}
+
+            /**
+            * @brief Returns true if the message is logged, the first message of an interval is logged.
+            * @param[out] suppressed_count The messages suppressed since the last logged message, set if the message is logged
+            */
+            bool try_log(uint64_t & suppressed_count)
+            {
+                //the clock is offset by an interval, so 0 stands for a call site which didn't log yet
+                const uint64_t now_ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                            std::chrono::steady_clock::now().time_since_epoch()).count()) + INTERVAL_MS;
+                uint64_t last_log_ms = m_last_log_ms.load(std::memory_order_relaxed);
+                if((last_log_ms != 0 && now_ms - last_log_ms < INTERVAL_MS) ||
+                   !m_last_log_ms.compare_exchange_strong(last_log_ms, now_ms, std::memory_order_relaxed))
+                {
+                    m_suppressed_count.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                suppressed_count = m_suppressed_count.exchange(0, std::memory_order_relaxed);
+                return true;
+            }
+        private:
+            std::atomic<uint64_t> m_last_log_ms;
+            std::atomic<uint64_t> m_suppressed_count;
         };
     }
 }
@@ -50,6 +108,11 @@ extern DLL_EXPORT rs::utils::log_util logger;
 
 #define LOG_LOGGER  logger.m_logger // default logger
 
+/**
+* @brief Checks the level of the default logger with the cached level, other loggers are asked directly.
+*/
+#define LOG_IS_LEVEL_ENABLED(_logger, _level) ((_logger) == LOG_LOGGER ? logger.is_level_enabled(_level) : (_logger)->is_level_enabled(_level))
+
 #define LOG_LEVEL_FATAL_ERROR	rs::utils::logging_service::level_fatal
 #define LOG_LEVEL_ERROR			rs::utils::logging_service::level_error
 #define LOG_LEVEL_WARNING		rs::utils::logging_service::level_warn
@@ -58,6 +121,26 @@ extern DLL_EXPORT rs::utils::log_util logger;
 #define LOG_LEVEL_TRACE			rs::utils::logging_service::level_trace
 #define LOG_LEVEL_VERBOSE		rs::utils::logging_service::level_verbose
 
+/**
+* @brief The lowest level of the compiled log messages, one of the \c logging_service::log_level_values, set by the build.
+*
+* The messages of lower levels are removed at compile time, the log call sites don't check the logger level at run time,
+* and \c LOG_FUNC_SCOPE doesn't construct a scope log object once the trace level isn't compiled. The default compiles all the levels.
+*/
+#ifndef RS_SDK_MIN_LOG_LEVEL
+#define RS_SDK_MIN_LOG_LEVEL 0
+#endif
+
+/**
+* @brief Checks the level with the compiled levels. The check is a constant, so the code of a level which isn't compiled is removed
+* by the compiler, while the message expressions are still parsed and the variables they use aren't reported as unused.
+*/
+#if RS_SDK_MIN_LOG_LEVEL > 0
+#define LOG_IS_LEVEL_COMPILED(_level) ((_level) >= RS_SDK_MIN_LOG_LEVEL)
+#else
+#define LOG_IS_LEVEL_COMPILED(_level) (true)
+#endif
+
 #ifndef __FUNCSIG__
 #define __FUNCSIG__   __FUNCTION__
 #endif
@@ -74,7 +157,7 @@ extern DLL_EXPORT rs::utils::log_util logger;
 */
 #define LOG(_level, ...)            												\
 {                                                       							\
-if (LOG_LOGGER->is_level_enabled(_level))               							\
+if (LOG_IS_LEVEL_COMPILED(_level) && logger.is_level_enabled(_level))				\
     {                                                   							\
         char szBuffer[1024];                            							\
         snprintf(szBuffer, 1024, __VA_ARGS__); 										\
@@ -89,7 +172,7 @@ if (LOG_LOGGER->is_level_enabled(_level))               							\
 */
 #define LOG_CFORMAT(_logger, _level, ...)            						\
 {                                                       					\
-    if (_logger->is_level_enabled(_level))                					\
+    if (LOG_IS_LEVEL_COMPILED(_level) && LOG_IS_LEVEL_ENABLED(_logger, _level))	\
     {                                                   					\
         char szBuffer[1024] = "";                       					\
         szBuffer[sizeof(szBuffer) - 1] = 0;             					\
@@ -106,7 +189,7 @@ if (LOG_LOGGER->is_level_enabled(_level))               							\
 */
 #define LOG_STREAM(_logger, _level, _message)        									\
 {                                                       								\
-    if (_logger->is_level_enabled(_level))                								\
+    if (LOG_IS_LEVEL_COMPILED(_level) && LOG_IS_LEVEL_ENABLED(_logger, _level))			\
     {                                                   								\
         std::basic_ostringstream<wchar_t> _stream;      								\
         _stream << _message;                            								\
@@ -114,6 +197,31 @@ if (LOG_LOGGER->is_level_enabled(_level))               							\
     }                                                   								\
 }
 
+/**
+* @brief Logs a message of a call site at most once a second, the logged message counts the messages suppressed since the previous one.
+*
+* For messages which repeat per frame or per sample, the call site level is checked first, so a disabled level isn't counted.
+* @param[in] _logger  Logger to use
+* @param[in] _level   Logging level
+* @param[in] _message Message to be logged
+*/
+#define LOG_STREAM_RATE_LIMITED(_logger, _level, _message)        							\
+{                                                       								\
+    if (LOG_IS_LEVEL_COMPILED(_level) && LOG_IS_LEVEL_ENABLED(_logger, _level))			\
+    {                                                   								\
+        static rs::utils::log_rate_limiter _limiter;    								\
+        uint64_t _suppressed_count = 0;                 								\
+        if (_limiter.try_log(_suppressed_count))        								\
+        {                                               								\
+            std::basic_ostringstream<wchar_t> _stream;  								\
+            _stream << _message;                        								\
+            if (_suppressed_count > 0)                  								\
+                _stream << " (" << _suppressed_count << " more since the previous message)";	\
+            _logger->logw(_level, _stream.str().c_str(), __FILE__, __LINE__, __FUNCSIG__); 	\
+        }                                               								\
+    }                                                   								\
+}
+
 #define LOG_VERBOSE(_message)        LOG_STREAM(LOG_LOGGER, LOG_LEVEL_VERBOSE, _message)
 #define LOG_TRACE(_message)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_VERBOSE, _message)
 #define LOG_DEBUG(_message)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_DEBUG, _message)
@@ -122,6 +230,9 @@ if (LOG_LOGGER->is_level_enabled(_level))               							\
 #define LOG_ERROR(_message)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_ERROR, _message)
 #define LOG_FATAL(_message)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_FATAL_ERROR, _message)
 
+#define LOG_WARN_RATE_LIMITED(_message)     LOG_STREAM_RATE_LIMITED(LOG_LOGGER, LOG_LEVEL_WARNING, _message)
+#define LOG_ERROR_RATE_LIMITED(_message)    LOG_STREAM_RATE_LIMITED(LOG_LOGGER, LOG_LEVEL_ERROR, _message)
+
 #define LOG_VERBOSE_VAR(_var)        LOG_STREAM(LOG_LOGGER, LOG_LEVEL_VERBOSE, #_var " = " << _var)
 #define LOG_TRACE_VAR(_var)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_TRACE, #_var " = " << _var)
 #define LOG_DEBUG_VAR(_var)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_DEBUG, #_var " = " << _var)
@@ -174,4 +285,10 @@ namespace rs
     }
 }
 
+// the scope log object logs at the trace level, it isn't constructed once the level isn't compiled.
+// 5000 is logging_service::level_trace, the preprocessor doesn't evaluate enum values
+#if RS_SDK_MIN_LOG_LEVEL > 5000
+#define LOG_FUNC_SCOPE()      ((void)0)
+#else
 #define LOG_FUNC_SCOPE()      rs::utils::scope_log log(__FUNCTION__)
+#endif
@@ -0,0 +1,108 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* @file memory_accounting.h
+* @brief Describes the \c rs::utils::memory_accounting class.
+*/
+
+#pragma once
+#include <stdint.h>
+#include "rs/core/status.h"
+
+#ifdef WIN32
+#ifdef realsense_memory_utils_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_memory_utils_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief The SDK subsystems which hold samples data, each subsystem is accounted separately.
+        */
+        enum class memory_subsystem : int32_t
+        {
+            recording,          /**< The samples queued by the record devices until the recording thread writes them */
+            playback,           /**< The samples prefetched by the playback devices until they're delivered */
+            samples_time_sync,  /**< The images held by the sync utilities until they're matched, and their unmatched images */
+            image_conversion,   /**< The converted images cached by their source images */
+            max
+        };
+
+        /**
+        * @brief The memory usage of a subsystem.
+        */
+        struct memory_usage
+        {
+            uint64_t    bytes;          /**< The bytes the subsystem holds */
+            uint64_t    peak_bytes;     /**< The most bytes the subsystem held since the process started */
+            uint64_t    dropped_bytes;  /**< The bytes of the samples the subsystem dropped or didn't keep, to stay within the budget */
+        };
+
+        /**
+        * @brief Accounts the memory the SDK subsystems hold in their samples queues and caches, and bounds it by a budget of the process.
+        *
+        * The accounted bytes are the data of the samples, the images and motion samples the subsystems hold, the bookkeeping of the
+        * subsystems isn't accounted. Once the subsystems hold the bytes of the budget, each subsystem keeps to it in its own way: the
+        * playback devices stop prefetching samples, which holds the reading of the file back, the record devices drop the new frames
+        * as they drop frames when their queue is full, the sync utilities don't keep the unmatched images, and the images don't cache
+        * their conversions. The bytes held when the budget is reached are released as the samples are consumed.
+        * The accounting is process wide and lock free, the subsystems update it as they hold and release samples.
+        */
+        class DLL_EXPORT memory_accounting
+        {
+            memory_accounting() = delete;
+        public:
+            /**
+            * @brief Returns the memory usage of a subsystem, a zero usage for an invalid subsystem.
+            */
+            static memory_usage query_usage(memory_subsystem subsystem);
+
+            /**
+            * @brief Returns the bytes all the subsystems hold.
+            */
+            static uint64_t query_total_bytes();
+
+            /**
+            * @brief Sets the budget of the bytes all the subsystems hold, 0 sets no budget. There's no budget by default.
+            * @param[in]  max_bytes              The budget in bytes
+            * @return status_no_error            The budget was set
+            */
+            static rs::core::status set_budget(uint64_t max_bytes);
+
+            /**
+            * @brief Returns the budget of the bytes all the subsystems hold, 0 if there's no budget.
+            */
+            static uint64_t query_budget();
+
+            /**
+            * @brief Returns true if the bytes fit in the budget along with the bytes the subsystems hold, called by the subsystems before
+            *        they hold optional data.
+            * @param[in]  bytes                  The bytes to hold
+            */
+            static bool is_within_budget(uint64_t bytes);
+
+            /**
+            * @brief Accounts bytes a subsystem holds, called by the subsystems.
+            */
+            static void add(memory_subsystem subsystem, uint64_t bytes);
+
+            /**
+            * @brief Accounts bytes a subsystem released, called by the subsystems.
+            */
+            static void remove(memory_subsystem subsystem, uint64_t bytes);
+
+            /**
+            * @brief Accounts bytes a subsystem dropped or didn't keep to stay within the budget, called by the subsystems.
+            */
+            static void add_dropped(memory_subsystem subsystem, uint64_t bytes);
+        };
+    }
+}
@@ -0,0 +1,74 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* @file numa_topology.h
+* @brief Describes the \c rs::utils::numa_topology class.
+*/
+
+#pragma once
+#include <stdint.h>
+#include "rs/core/status.h"
+#include "rs/utils/thread_config.h"
+
+#ifdef WIN32
+#ifdef realsense_thread_utils_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_thread_utils_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Queries the NUMA nodes of the host, and binds the SDK threads to the node of the device they serve.
+        *
+        * On a multi-socket host a camera is attached to the USB controller of one socket. The threads which copy, compress and write its
+        * frames run on the cpus of that node, so the frames and the buffers they touch stay in the memory of the node instead of crossing
+        * the socket interconnect. The buffers a bound thread allocates are placed on its node with the default memory policy, as the
+        * first touch of a page places it. The topology is read from sysfs on Linux, on the other platforms the host is a single node.
+        */
+        class DLL_EXPORT numa_topology
+        {
+            numa_topology() = delete;
+        public:
+            static const int32_t UNKNOWN_NODE = -1;
+
+            /**
+            * @brief Returns the number of NUMA nodes of the host, 1 if the host isn't a NUMA host or the platform doesn't report its nodes.
+            */
+            static int32_t query_nodes_count();
+
+            /**
+            * @brief Returns the NUMA node of the USB controller a device is attached to.
+            * @param[in]  usb_port_id    The USB port of the device, as reported by \c rs::device::get_usb_port_id, for example 2-3
+            * @return int32_t            The node, \c UNKNOWN_NODE if the platform doesn't report the node of the controller
+            */
+            static int32_t query_usb_port_node(const char * usb_port_id);
+
+            /**
+            * @brief Returns the cpus of a NUMA node, bit i is cpu i. 0 if the node isn't known, the cpus above 63 aren't reported.
+            */
+            static uint64_t query_node_cpus(int32_t node);
+
+            /**
+            * @brief Binds the calling thread to the cpus of a NUMA node, called by the SDK threads of a device when they start.
+            *
+            * The cpu affinity mask of the thread role is kept within the node, a role mask which has no cpus of the node is overridden by
+            * the node, the node locality outweighs the isolation of the role on a multi-socket host.
+            * @param[in]  node                      The node, a thread isn't bound to \c UNKNOWN_NODE
+            * @param[in]  role                      The role of the calling thread
+            * @return status_feature_unsupported    The platform doesn't support the thread binding
+            * @return status_invalid_argument       The node isn't a node of the host
+            * @return status_exec_aborted           The system refused the binding, the thread keeps its cpus
+            * @return status_no_error               The thread was bound, or the node is \c UNKNOWN_NODE
+            */
+            static rs::core::status bind_thread(int32_t node, thread_role role);
+        };
+    }
+}
@@ -0,0 +1,97 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file profiler_markers.h
+* @brief Describes the profiler marker macros of the SDK hot paths.
+*
+* The SDK stages mark their work with named zones, frame marks and counters, so the profiler timelines and flame graphs show
+* the SDK stages by name. The markers are emitted to the profiler the build selects, \c RS_SDK_PROFILER_TRACY for Tracy, or
+* \c RS_SDK_PROFILER_ITT for VTune and the other profilers of the ITT API. Without a profiler the macros expand to nothing,
+* their arguments aren't evaluated.
+*
+* The names are string literals, the zone name and the counter name are the same for every call of a call site.
+*/
+
+#pragma once
+
+#define RS_PROFILER_CONCAT_IMPL(a, b) a##b
+#define RS_PROFILER_CONCAT(a, b) RS_PROFILER_CONCAT_IMPL(a, b)
+
+#if defined(RS_SDK_PROFILER_TRACY)
+
+#include <tracy/Tracy.hpp>
+
+/**
+* @brief Marks the rest of the enclosing scope as a zone.
+* @param[in] _name Zone name
+*/
+#define RS_PROFILER_ZONE(_name)                 ZoneScopedN(_name)
+
+/**
+* @brief Marks the end of a frame of the named frame set, e.g. a frame of a stream.
+* @param[in] _name Frame set name
+*/
+#define RS_PROFILER_FRAME_MARK(_name)           FrameMarkNamed(_name)
+
+/**
+* @brief Sets the value of the named counter.
+* @param[in] _name  Counter name
+* @param[in] _value Counter value, an integer
+*/
+#define RS_PROFILER_COUNTER(_name, _value)      TracyPlot(_name, static_cast<int64_t>(_value))
+
+#elif defined(RS_SDK_PROFILER_ITT)
+
+#include <stdint.h>
+#include <ittnotify.h>
+
+namespace rs
+{
+    namespace utils
+    {
+        namespace profiler
+        {
+            // the domain of the SDK markers
+            inline __itt_domain * itt_domain()
+            {
+                static __itt_domain * domain = __itt_domain_create("realsense_sdk");
+                return domain;
+            }
+
+            // a task from its construction to the end of its scope
+            class itt_zone
+            {
+            public:
+                explicit itt_zone(__itt_string_handle * name) { __itt_task_begin(itt_domain(), __itt_null, __itt_null, name); }
+                ~itt_zone() { __itt_task_end(itt_domain()); }
+            };
+        }
+    }
+}
+
+// the string handles and counters are created once per call site
+#define RS_PROFILER_ZONE(_name)                                                                                             \
+    static __itt_string_handle * RS_PROFILER_CONCAT(rs_profiler_name_, __LINE__) = __itt_string_handle_create(_name);      \
+    rs::utils::profiler::itt_zone RS_PROFILER_CONCAT(rs_profiler_zone_, __LINE__)(RS_PROFILER_CONCAT(rs_profiler_name_, __LINE__))
+
+#define RS_PROFILER_FRAME_MARK(_name)                                                                                       \
+    do {                                                                                                                    \
+        static __itt_string_handle * rs_profiler_name = __itt_string_handle_create(_name);                                 \
+        __itt_marker(rs::utils::profiler::itt_domain(), __itt_null, rs_profiler_name, __itt_scope_global);                 \
+    } while(0)
+
+#define RS_PROFILER_COUNTER(_name, _value)                                                                                  \
+    do {                                                                                                                    \
+        static __itt_counter rs_profiler_counter = __itt_counter_create(_name, "realsense_sdk");                           \
+        uint64_t rs_profiler_value = static_cast<uint64_t>(_value);                                                         \
+        __itt_counter_set_value(rs_profiler_counter, &rs_profiler_value);                                                  \
+    } while(0)
+
+#else
+
+#define RS_PROFILER_ZONE(_name)                 ((void)0)
+#define RS_PROFILER_FRAME_MARK(_name)           ((void)0)
+#define RS_PROFILER_COUNTER(_name, _value)      ((void)0)
+
+#endif
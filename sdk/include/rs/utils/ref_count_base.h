@@ -15,6 +15,10 @@ namespace rs
     {
          /**
          * @brief Implements atomic reference counting operations.
+         *
+         * Increments are relaxed, since a thread can only add a reference through a reference it already holds. The release
+         * of the last reference skips the atomic decrement: an instance with a single reference has no other owner that could
+         * concurrently change its count, so an image passed through a single consumer chain is released with a plain load.
          */
         template<typename T>
         class ref_count_base : public T
@@ -36,7 +40,7 @@ namespace rs
              */
             virtual int add_ref() const override
             {
-                return ++m_ref_count;
+                return m_ref_count.fetch_add(1, std::memory_order_relaxed) + 1;
             }
 
             /**
@@ -45,7 +49,14 @@ namespace rs
              */
             virtual int release() const override
             {
-                int post_fetched_ref_count = --m_ref_count;
+                //the acquire load synchronizes with the releases of the previous owners, before the instance is deleted
+                if(m_ref_count.load(std::memory_order_acquire) == 1)
+                {
+                    delete(this);
+                    return 0;
+                }
+
+                int post_fetched_ref_count = m_ref_count.fetch_sub(1, std::memory_order_acq_rel) - 1;
                 if(post_fetched_ref_count == 0)
                 {
                    delete(this);
@@ -60,7 +71,7 @@ namespace rs
              */
             virtual int ref_count() const override
             {
-                return m_ref_count;
+                return m_ref_count.load(std::memory_order_relaxed);
             }
         protected:
             virtual ~ref_count_base() {}
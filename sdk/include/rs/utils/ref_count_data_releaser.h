@@ -0,0 +1,57 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file ref_count_data_releaser.h
+* @brief Describes the \c rs::utils::ref_count_data_releaser class.
+*/
+
+#pragma once
+#include "rs/utils/release_self_base.h"
+#include "rs/core/ref_count_interface.h"
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+         * @brief Data releaser which ties the data lifetime to a reference counted owner.
+         *
+         * A buffer releaser implementation for data owned by another reference counted object, such as an image or a pooled buffer.
+         * The constructor adds a reference to the owner, and the release function releases that reference and the releaser itself
+         * using the \c release_self_base class. The data is not copied, it stays valid as long as the owner keeps it.
+         */
+        class ref_count_data_releaser : public release_self_base<rs::core::release_interface>
+        {
+        public:
+            /**
+             * @brief Constructor
+             * @param[in] owner Reference counted owner of the data, a reference is added to it
+             */
+            ref_count_data_releaser(const rs::core::ref_count_interface * owner) : owner(owner)
+            {
+                if(owner)
+                {
+                    owner->add_ref();
+                }
+            }
+
+            /**
+             * @brief Releases the owner reference added in the constructor and itself using \c release_self_base class.
+             * @return int Number of instances
+             */
+            int release() const override
+            {
+                if(owner)
+                {
+                    owner->release();
+                }
+                return release_self_base::release(); //object destructed, return immediately
+            }
+        protected:
+            ~ref_count_data_releaser() {}
+        private:
+            const rs::core::ref_count_interface * owner;
+        };
+    }
+}
@@ -40,6 +40,16 @@ namespace rs
              * and an external device (which doesn't get timestamps from the camera's microcontroller)
              */
             static constexpr const char* external_device_name = "external_device";
+
+            /** @brief The device_name for devices which share a hardware frame counter between their streams
+             *
+             * Use this string as the device_name parameter when you call samples_time_sync_interface::create_instance
+             * to create a samples_time_sync implementation which matches the images with the same frame number, returned by
+             * \c image_interface::query_frame_number. A correlated sample is returned by the insert of its last image, without
+             * waiting for the images of a timestamps tolerance, and images of older frames than the other streams images are dropped at once.
+             * Motions are matched to the images by their timestamps.
+             */
+            static constexpr const char* frame_counter_device_name = "frame_counter_device";
     
             /**
             * @brief Creates and initializes the sync utility: registers streams and motions that are required to be synced.
@@ -99,22 +109,43 @@ namespace rs
 
             /**
             * @brief Inserts the new image sample to the sync utility. Returns true if the correlated sample was found.
+            *
+            * Inserting from several threads doesn't block: when another thread is matching the samples, the new sample is queued
+            * for that thread and the call returns false. A set matched for a queued sample is returned by one of the next insert calls,
+            * or by \c get_matched_sample_set.
             * @param[in]  new_image                 New image
             * @param[out] sample_set                Correlated sample containing correlated images and/or motions. May be empty.
             *                                       Reference counted resources in the sample set must be released by the caller.
+            *                                       The motion batches of the set are the samples \c get_matched_motions returns.
             * @return bool                          true if the match was found
             */
             virtual bool insert(rs::core::image_interface * new_image, rs::core::correlated_sample_set& sample_set)= 0;
 
             /**
             * @brief Inserts the new motion sample to the sync utility. Returns true if the correlated sample was found.
+            *
+            * Inserting from several threads doesn't block: when another thread is matching the samples, the new sample is queued
+            * for that thread and the call returns false. A set matched for a queued sample is returned by one of the next insert calls,
+            * or by \c get_matched_sample_set.
             * @param[in]  new_motion                New motion
             * @param[out] sample_set                Correlated sample containing correlated images and/or motions. May be empty.
             *                                       Reference counted resources in the sample set must be released by the caller.
+            *                                       The motion batches of the set are the samples \c get_matched_motions returns.
             * @return bool                          true if the match was found
             */
             virtual bool insert(rs::core::motion_sample& new_motion, rs::core::correlated_sample_set& sample_set) = 0;
 
+            /**
+            * @brief Returns the oldest correlated sample set matched for a queued sample, which no insert returned yet.
+            *
+            * Call it until it returns false after the last insert, so the sets matched for the last samples aren't left in the sync utility.
+            * \c flush and the destruction of the sync utility release the sets which weren't returned.
+            * @param[out] sample_set                Correlated sample set. Reference counted resources in the sample set must be released by the caller.
+            *                                       The motion batches of the set are the samples \c get_matched_motions returns.
+            * @return bool                          true if a set was returned
+            */
+            virtual bool get_matched_sample_set(rs::core::correlated_sample_set& sample_set) = 0;
+
 
             /**
             * @brief Puts the first (if available) unmatched frame of \c stream_type to the location specified by \c not_matched_frame.
@@ -127,7 +158,49 @@ namespace rs
             virtual bool get_not_matched_frame(rs::core::stream_type stream_type, rs::core::image_interface ** not_matched_frame) = 0;
 
             /**
-            * @brief Removes all the frames from the internal lists.
+            * @brief Returns the motion samples of \c motion_type matched with the last correlated sample set returned to the calling thread.
+            *
+            * These are all the samples received since the previous correlated sample set, up to the sample closest to the images,
+            * which is the sample of the correlated sample set. The samples are contiguous and ordered by their arrival.
+            * @param[in]   motion_type              Motion type to get the matched samples of
+            * @param[out]  motions                  Location to put the pointer to the first sample to. The samples are owned by the
+            *                                       sync utility and valid until the next call of the calling thread to \c insert or
+            *                                       \c get_matched_sample_set, or until \c flush. The sets returned to other threads don't overwrite them.
+            * @return unsigned int                  Number of samples, 0 if none
+            */
+            virtual unsigned int get_matched_motions(rs::core::motion_type motion_type, const rs::core::motion_sample ** motions) = 0;
+
+            /**
+            * @brief Removes the oldest images which weren't matched within \c max_latency, as a partial correlated sample set.
+            *
+            * The partial set holds the oldest image of each stream which is within the sync tolerance of the oldest image in the sync utility,
+            * once the newest inserted sample is at least \c max_latency milliseconds later than that image. Motion samples stay in the sync utility
+            * for the next correlated sample set. Call it after each insert to bound the latency of the streams matched with a stalled stream.
+            * @param[in]  max_latency               Latency in milliseconds, in the samples timestamps, after which the images are removed
+            * @param[out] sample_set                Partial sample set. Reference counted resources in the sample set must be released by the caller.
+            * @return bool                          true if a partial set was removed
+            */
+            virtual bool get_partial_sample_set(unsigned int max_latency, rs::core::correlated_sample_set& sample_set) = 0;
+
+            /**
+            * @brief Sizes the image buffers by the measured arrival skew of the streams, instead of by \c max_input_latency.
+            *
+            * The skew is how much earlier than the latest inserted image an image is timestamped. The buffers hold the images of the
+            * measured skew with a margin, between \c min_input_latency and the \c max_input_latency the sync utility was created with,
+            * and the oldest images beyond it are dropped, as unmatched frames. The measured skew follows a larger skew at once,
+            * and a smaller one gradually, so the buffers and the images held by the sync utility shrink when the streams arrive together.
+            * @param[in]  min_input_latency         The minimum latency in milliseconds the buffers are sized for, 0 sizes them by \c max_input_latency
+            */
+            virtual void set_adaptive_latency(unsigned int min_input_latency) = 0;
+
+            /**
+            * @brief Returns the latency in milliseconds the image buffers are currently sized for.
+            * @return unsigned int                  The \c max_input_latency, or the latency measured since \c set_adaptive_latency was called
+            */
+            virtual unsigned int query_input_latency() = 0;
+
+            /**
+            * @brief Removes all the frames from the internal lists, and releases the sets matched for queued samples which weren't returned.
             * @return void
             */
             virtual void flush() = 0;
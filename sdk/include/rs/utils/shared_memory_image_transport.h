@@ -0,0 +1,103 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* @file shared_memory_image_transport.h
+* @brief Describes the \c rs::utils::shared_memory_image_publisher_interface and \c rs::utils::shared_memory_image_subscriber_interface classes.
+*/
+
+#pragma once
+#include <stdint.h>
+#include "rs/core/release_interface.h"
+#include "rs/core/image_interface.h"
+#include "rs/core/correlated_sample_set.h"
+
+#ifdef WIN32
+#ifdef realsense_shared_memory_transport_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_shared_memory_transport_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Publishes images to the processes which subscribe to a named shared memory segment.
+        *
+        * The segment is a ring of slots, each holding an image with its info, stream, timestamp, frame number and metadata.
+        * A published image is copied once into the slot of its sequence number, and the subscribers read the slot in place.
+        * The slot of a new image may still be held by a subscriber, in which case the image is dropped, so a slow subscriber
+        * never blocks the publisher. Feed the publisher from the \c on_new_sample_set callback of the pipeline.
+        * The segment name is removed when the publisher is released, the subscribers keep their mapping until they're released.
+        * Shared memory segments are supported on Linux, on other platforms \c create_instance returns null.
+        */
+        class DLL_EXPORT shared_memory_image_publisher_interface : public rs::core::release_interface
+        {
+        public:
+            /**
+            * @brief Copies the image to the next slot, and makes it available to the subscribers.
+            *
+            * May be called from a single thread at a time.
+            * @param[in] image     The published image
+            * @return bool         true if the image was published, false if its slot is held by a subscriber or it exceeds the slot size
+            */
+            virtual bool publish(rs::core::image_interface * image) = 0;
+
+            /**
+            * @brief Publishes each image of the sample set.
+            *
+            * @param[in] sample_set    The sample set of the pipeline callback
+            * @return uint32_t         The number of published images
+            */
+            virtual uint32_t publish(const rs::core::correlated_sample_set & sample_set) = 0;
+
+            /**
+            * @brief Creates the shared memory segment, replacing a segment of the same name.
+            *
+            * @param[in] name              Segment name, a single path component which starts with a slash, as "/rs_depth"
+            * @param[in] slots_count       Number of slots in the ring, the number of images the subscribers may hold at once, plus one
+            * @param[in] max_image_size    Bytes of the largest image data, \c pitch * \c height
+            * @return shared_memory_image_publisher_interface *   The publisher, null if the segment couldn't be created
+            */
+            static shared_memory_image_publisher_interface * create_instance(const char * name, uint32_t slots_count, uint32_t max_image_size);
+
+        protected:
+            virtual ~shared_memory_image_publisher_interface() {}
+        };
+
+        /**
+        * @brief Receives the images published to a named shared memory segment by another process.
+        *
+        * The received images are backed by the shared memory slot, without copying the image data. A slot is held while any
+        * received image of it is referenced, and returned to the publisher when the last reference is released.
+        */
+        class DLL_EXPORT shared_memory_image_subscriber_interface : public rs::core::release_interface
+        {
+        public:
+            /**
+            * @brief Returns the oldest published image which wasn't received yet.
+            *
+            * Images which were overwritten before they were received are skipped. May be called from a single thread at a time.
+            * @param[out] skipped_images    Optional, the number of skipped images since the previous received image
+            * @return rs::core::image_interface *   The image, owned by the caller, null if no new image was published
+            */
+            virtual rs::core::image_interface * receive(uint32_t * skipped_images = nullptr) = 0;
+
+            /**
+            * @brief Opens the shared memory segment of a publisher, the first received image is the next published one.
+            *
+            * @param[in] name    Segment name the publisher was created with
+            * @return shared_memory_image_subscriber_interface *   The subscriber, null if the segment doesn't exist or has another layout version
+            */
+            static shared_memory_image_subscriber_interface * create_instance(const char * name);
+
+        protected:
+            virtual ~shared_memory_image_subscriber_interface() {}
+        };
+    }
+}
@@ -0,0 +1,98 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* @file thread_config.h
+* @brief Describes the \c rs::utils::thread_configuration class.
+*/
+
+#pragma once
+#include <stdint.h>
+#include "rs/core/status.h"
+
+#ifdef WIN32
+#ifdef realsense_thread_utils_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_thread_utils_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief The roles of the threads the SDK creates, each role is configured separately.
+        */
+        enum class thread_role : int32_t
+        {
+            recording,      /**< The record device thread which writes the samples to the file */
+            playback,       /**< The playback device threads which read the file and call the frame and motion callbacks */
+            pipeline,       /**< The pipeline executor workers, which run the samples consumers and the synchronous computer vision modules */
+            cv_module,      /**< The processing threads of the asynchronous computer vision modules */
+            viewer,         /**< The viewer window thread */
+            max
+        };
+
+        /**
+        * @brief The scheduling policy of a thread role.
+        */
+        enum class thread_scheduling : int32_t
+        {
+            normal,         /**< The time sharing scheduling, the priority is the nice level of the threads, -20 to 19 */
+            real_time       /**< The SCHED_FIFO scheduling, the priority is the real time priority of the threads, 1 to 99 */
+        };
+
+        /**
+        * @brief The configuration of the threads of a role, the default configuration doesn't change the created threads.
+        */
+        struct thread_config
+        {
+            uint64_t            cpu_affinity_mask;  /**< The cpus the threads run on, bit i is cpu i. 0 doesn't restrict the threads */
+            thread_scheduling   scheduling;         /**< The scheduling policy of the threads */
+            int32_t             priority;           /**< The nice level or the real time priority of the threads, by the scheduling policy.
+                                                             A normal scheduling priority of 0 keeps the inherited nice level */
+        };
+
+        /**
+        * @brief Configures the cpu affinity and the scheduling of the threads the SDK creates.
+        *
+        * Each SDK thread is named by its role, and applies the configuration of its role when it starts, so a configuration
+        * applies to the threads created after it's set, for example to the recording threads of the next record device. Set the
+        * configurations before the devices and the pipeline are created to isolate the recording or the tracking threads from the other
+        * processes of the system. Raising the priority or the real time scheduling may require privileges (CAP_SYS_NICE on Linux),
+        * a configuration the system refuses is logged once per thread, and the thread keeps running with its inherited settings.
+        */
+        class DLL_EXPORT thread_configuration
+        {
+            thread_configuration() = delete;
+        public:
+            /**
+            * @brief Sets the configuration of the threads of a role, which are created from now on.
+            * @param[in]  role                   The threads role
+            * @param[in]  config                 The threads configuration
+            * @return status_invalid_argument    The role isn't valid, or the priority is out of the range of the scheduling policy
+            * @return status_no_error            The configuration was set
+            */
+            static rs::core::status set_config(thread_role role, const thread_config & config);
+
+            /**
+            * @brief Returns the configuration of the threads of a role, the default configuration if it wasn't set.
+            */
+            static thread_config query_config(thread_role role);
+
+            /**
+            * @brief Names the calling thread and applies the configuration of its role, called by the SDK threads when they start.
+            * @param[in]  role                   The role of the calling thread
+            * @param[in]  name                   The thread name, shown by the debuggers and the system tools. Truncated to 15 characters on Linux
+            * @return status_feature_unsupported The platform doesn't support a part of the configuration
+            * @return status_exec_aborted        The system refused the configuration, the thread keeps its inherited settings
+            * @return status_no_error            The configuration was applied
+            */
+            static rs::core::status apply(thread_role role, const char * name);
+        };
+    }
+}
@@ -0,0 +1,160 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* @file thread_profiler.h
+* @brief Describes the \c rs::utils::thread_profiler class.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "rs/utils/thread_config.h"
+
+#ifdef WIN32
+#ifdef realsense_thread_utils_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_thread_utils_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief The reasons an SDK thread blocks, the time blocked for each reason is counted separately.
+        */
+        enum class thread_wait : int32_t
+        {
+            input,      /**< The thread is idle, waiting for samples or tasks to process */
+            output,     /**< The thread waits for its outputs to be consumed or released, e.g. the frames the application holds */
+            tasks,      /**< The thread waits for the work it handed to other threads, e.g. the frames compressed in parallel */
+            lock,       /**< The thread waits for a mutex another thread holds */
+            io,         /**< The thread waits for the storage to read or write */
+            max
+        };
+
+        /**
+        * @brief Counters of an SDK thread, or of all the threads of a role, since they started.
+        *
+        * The running time which isn't spent waiting and isn't cpu time is the time the thread was preempted, or blocked in the
+        * system by waits that aren't counted. A thread whose cpu time is close to its running time is cpu bound.
+        */
+        struct thread_statistics
+        {
+            uint32_t threads_count;                                         /**< The running threads */
+            uint64_t running_time;                                          /**< Time the threads ran, in microseconds */
+            uint64_t cpu_time;                                              /**< Time the threads used the cpu, in microseconds */
+            uint64_t wait_time[static_cast<int32_t>(thread_wait::max)];     /**< Time the threads blocked, in microseconds, indexed by thread_wait */
+            uint64_t processed_items_count;                                 /**< Samples, tasks or buffers the threads processed */
+        };
+
+        /**
+        * @brief Counts the cpu time, the blocked time and the processed items of an SDK thread.
+        *
+        * The thread starts the profiler when it starts, counts its waits and its processed items, and stops the profiler before it
+        * exits. The counters are added to the counters of the thread role as well, so the threads of the playback devices or of
+        * the pipeline are profiled together. The cpu time is sampled by the profiled thread as it counts its waits and items, the
+        * waits and items of other threads, e.g. of a method which the profiled thread and the application both call, aren't counted.
+        * The counters can be queried by any thread, while the profiled thread runs.
+        */
+        class DLL_EXPORT thread_profiler
+        {
+        public:
+            /**
+            * @brief Counts the time of a wait from its construction to the end of its scope.
+            */
+            class wait_scope
+            {
+            public:
+                wait_scope(thread_profiler & profiler, thread_wait wait) :
+                    m_profiler(profiler), m_wait(wait), m_start_time(std::chrono::steady_clock::now()) {}
+                ~wait_scope()
+                {
+                    auto wait_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start_time);
+                    m_profiler.add_wait_time(m_wait, static_cast<uint64_t>(wait_time.count()));
+                }
+            private:
+                wait_scope(const wait_scope &) = delete;
+                wait_scope & operator=(const wait_scope &) = delete;
+                thread_profiler & m_profiler;
+                thread_wait m_wait;
+                std::chrono::steady_clock::time_point m_start_time;
+            };
+
+            /**
+            * @brief Constructs a stopped profiler of a thread of the role.
+            */
+            explicit thread_profiler(thread_role role);
+            ~thread_profiler();
+
+            /**
+            * @brief Starts counting, called by the profiled thread when it starts. The counters of a restarted thread are accumulated.
+            */
+            void start();
+
+            /**
+            * @brief Counts the time since the last sample and stops counting, called by the profiled thread before it exits.
+            */
+            void stop();
+
+            /**
+            * @brief Counts processed items and samples the cpu time, if called by the profiled thread.
+            */
+            void add_processed_items(uint64_t count = 1);
+
+            /**
+            * @brief Counts the time the profiled thread blocked and samples the cpu time, if called by the profiled thread.
+            */
+            void add_wait_time(thread_wait wait, uint64_t microseconds);
+
+            /**
+            * @brief Locks the mutex, the time it takes if another thread holds it is counted as a lock wait.
+            */
+            template<typename lockable>
+            void lock(lockable & mutex)
+            {
+                if(mutex.try_lock())
+                    return;
+                wait_scope scope(*this, thread_wait::lock);
+                mutex.lock();
+            }
+
+            /**
+            * @brief Returns the counters of the profiled thread.
+            */
+            thread_statistics query_statistics() const;
+
+            /**
+            * @brief Returns the counters of all the threads of a role, zero counters for an invalid role.
+            */
+            static thread_statistics query_role_statistics(thread_role role);
+
+        private:
+            thread_profiler(const thread_profiler &) = delete;
+            thread_profiler & operator=(const thread_profiler &) = delete;
+
+            // counts the running and cpu time since the last sample
+            void sample_times();
+
+            // the thread id is set before the profiler is running, and read after it's seen running
+            bool is_profiled_thread() const { return m_is_running.load(std::memory_order_acquire) && std::this_thread::get_id() == m_thread_id; }
+
+            thread_role m_role;
+            std::thread::id m_thread_id;
+            std::chrono::steady_clock::time_point m_last_sample_time;
+            uint64_t m_last_cpu_time;
+            std::atomic<uint64_t> m_running_time;
+            std::atomic<uint64_t> m_cpu_time;
+            std::atomic<uint64_t> m_wait_time[static_cast<int32_t>(thread_wait::max)];
+            std::atomic<uint64_t> m_processed_items_count;
+            std::atomic<bool> m_is_running;
+        };
+    }
+}
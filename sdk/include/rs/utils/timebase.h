@@ -0,0 +1,66 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file timebase.h
+* @brief Describes the \c rs::utils::timebase class.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <chrono>
+
+#ifdef __linux__
+#include <time.h>
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief The monotonic clock of the SDK, which times the capture times of the recordings, the playback, the pipeline traces
+        *        and the fps counters.
+        *
+        * The clock isn't set back or slewed with the system time, so the times the subsystems take are consistent with each other, and
+        * it's cheap enough to be read for every sample. On Linux the clock is \c CLOCK_MONOTONIC_RAW, read by the vDSO without a
+        * system call on the recent kernels. The other platforms use \c std::chrono::steady_clock, which on Windows reads the performance
+        * counter, the invariant TSC converted by its calibrated frequency.
+        *
+        * The class meets the requirements of the standard clocks. Its time points are nanoseconds since an unspecified epoch, they
+        * can't be compared to the time points of other clocks.
+        */
+        class timebase
+        {
+        public:
+            typedef std::chrono::nanoseconds duration;
+            typedef duration::rep rep;
+            typedef duration::period period;
+            typedef std::chrono::time_point<timebase> time_point;
+            static constexpr bool is_steady = true;
+
+            /**
+            * @brief Returns the current time of the clock.
+            */
+            static time_point now() noexcept
+            {
+#ifdef __linux__
+                timespec time;
+                clock_gettime(CLOCK_MONOTONIC_RAW, &time);
+                return time_point(duration(static_cast<rep>(time.tv_sec) * 1000000000 + time.tv_nsec));
+#else
+                return time_point(std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()));
+#endif
+            }
+
+            /**
+            * @brief Returns the microseconds from the time point to now, 0 if the time point is later.
+            */
+            static uint64_t microseconds_since(time_point time) noexcept
+            {
+                auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now() - time).count();
+                return elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0;
+            }
+        };
+    }
+}
@@ -9,10 +9,14 @@
 #include "rs/core/context.h"
 #include "rs/core/correlated_sample_set.h"
 #include "rs/core/image_interface.h"
+#include "rs/core/device_buffer_interface.h"
+#include "rs/core/frame_allocator_interface.h"
 #include "rs/core/motion_sample.h"
 #include "rs/core/metadata_interface.h"
 #include "rs/core/status.h"
 #include "rs/core/types.h"
 #include "rs/core/video_module_interface.h"
 #include "rs/core/projection_interface.h"
+#include "rs/core/fisheye_projection_interface.h"
 #include "rs/core/pipeline_async.h"
+#include "rs/core/video_module_registry.h"
@@ -5,3 +5,4 @@
 
 #include "rs/record/record_context.h"
 #include "rs/record/record_device.h"
+#include "rs/record/record_module.h"
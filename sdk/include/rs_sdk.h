@@ -7,3 +7,4 @@
 #include "rs_utils.h"
 #include "rs_record.h"
 #include "rs_playback.h"
+#include "rs_synthetic.h"
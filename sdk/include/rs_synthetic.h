@@ -0,0 +1,7 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "rs/synthetic/synthetic_context.h"
+#include "rs/synthetic/synthetic_device.h"
@@ -2,7 +2,9 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #pragma once
+#include <cstring>
 #include <memory>
+#include <vector>
 #include "rs/core/status.h"
 #include "include/file_types.h"
 
@@ -25,12 +27,40 @@ namespace rs
             class DLL_EXPORT codec_interface
             {
             public:
+                //lz4 acceleration added by each speed boost step
+                static const int32_t ACCELERATION_PER_SPEED_BOOST = 8;
+
                 codec_interface() {}
                 virtual ~codec_interface() {}
 
                 virtual file_types::compression_type get_compression_type() = 0;
+                //returns status_value_out_of_range if the frame doesn't compress, the frame is recorded uncompressed
                 virtual status encode(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size) = 0;
-                virtual std::shared_ptr<file_types::frame_sample> decode(std::shared_ptr<file_types::frame_sample> frame, uint8_t * input, uint32_t input_size) = 0;
+                virtual std::shared_ptr<file_types::frame_sample> decode(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size) = 0;
+                //decodes the frame into a caller buffer of info.height rows, output_stride bytes apart, codecs which can't decode in place decode and copy the rows
+                virtual status decode_into(const file_types::frame_info & info, const uint8_t * input, uint32_t input_size, uint8_t * output, uint32_t output_stride)
+                {
+                    uint32_t row_size = static_cast<uint32_t>(info.stride);
+                    if(!output || output_stride < row_size)
+                        return status::status_param_unsupported;
+                    auto frame = std::make_shared<file_types::frame_sample>(info, 0);
+                    auto decoded = decode(frame, input, input_size);
+                    if(!decoded)
+                        return status::status_process_failed;
+                    for(int row = 0; row < info.height; row++)
+                        memcpy(output + row * output_stride, decoded->data + row * row_size, row_size);
+                    return status::status_no_error;
+                }
+                //temporal codecs encode frames with a reference to previous frames, only keyframes can be decoded independently
+                virtual bool is_temporal() { return false; }
+                virtual bool is_keyframe(const uint8_t * encoded_data, uint32_t encoded_size) { return true; }
+                //the next frame is encoded as a keyframe, which is decoded without the previously encoded frames
+                virtual void reset_reference() {}
+                //trades compression ratio for encoding speed, 0 encodes at the configured compression level, codecs without a speed tradeoff ignore it
+                virtual void set_speed_boost(uint32_t boost) {}
+                //codecs which learn a dictionary from the stream provide it to be stored in the file, and get it back before decoding
+                virtual bool get_dictionary(std::vector<uint8_t> & dictionary) { return false; }
+                virtual void set_dictionary(const std::vector<uint8_t> & dictionary) {}
             };
         }
     }
@@ -1,8 +1,16 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <algorithm>
 #include "decoder.h"
 #include "lz4_codec.h"
+#include "delta_codec.h"
+#include "lz4_stream_codec.h"
+#include "yuv420_codec.h"
+#include "rvl_codec.h"
+#ifdef WITH_ZSTD
+#include "zstd_codec.h"
+#endif
 #include "rs/utils/log_utils.h"
 #include "rs_sdk_version.h"
 
@@ -13,7 +21,9 @@ namespace rs
         namespace compression
         {
 
-            decoder::decoder(std::map<rs_stream,file_types::compression_type> configuration)
+            static const unsigned int MAX_NUMBER_OF_WORKERS = 4;
+
+            decoder::decoder(std::map<rs_stream,file_types::compression_type> configuration) : m_stop_workers(false)
             {
                 for(auto config : configuration)
                 {
@@ -23,7 +33,16 @@ namespace rs
 
             decoder::~decoder()
             {
-
+                {
+                    std::lock_guard<std::mutex> guard(m_tasks_mutex);
+                    m_stop_workers = true;
+                }
+                m_tasks_cv.notify_all();
+                for(auto & worker : m_workers)
+                {
+                    if(worker.joinable())
+                        worker.join();
+                }
             }
 
             void decoder::add_codec(rs_stream stream_type, file_types::compression_type compression_type)
@@ -33,17 +52,136 @@ namespace rs
                 switch (compression_type)
                 {
                     case file_types::compression_type::lz4: codec   = std::shared_ptr<codec_interface>(new lz4_codec()); break;
+                    case file_types::compression_type::lz4_striped: codec = std::shared_ptr<codec_interface>(new lz4_codec(true)); break;
+                    case file_types::compression_type::delta: codec = std::shared_ptr<codec_interface>(new delta_codec()); break;
+                    case file_types::compression_type::lz4_stream: codec = std::shared_ptr<codec_interface>(new lz4_stream_codec()); break;
+                    case file_types::compression_type::yuv420: codec = std::shared_ptr<codec_interface>(new yuv420_codec()); break;
+                    case file_types::compression_type::rvl: codec = std::shared_ptr<codec_interface>(new rvl_codec()); break;
+#ifdef WITH_ZSTD
+                    case file_types::compression_type::zstd: codec = std::shared_ptr<codec_interface>(new zstd_codec()); break;
+#endif
                     default: codec                                  = nullptr; break;
                 }
             }
 
-            std::shared_ptr<file_types::frame_sample> decoder::decode_frame(std::shared_ptr<file_types::frame_sample> frame, uint8_t *input, uint32_t input_size)
+            std::shared_ptr<file_types::frame_sample> decoder::decode_frame(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size)
             {
                 LOG_FUNC_SCOPE();
                 if(!frame)
                     return nullptr;
                 auto codec = m_codecs.at(frame->finfo.stream);
-                return codec ? m_codecs[frame->finfo.stream]->decode(frame, input, input_size) : nullptr;
+                return codec ? codec->decode(frame, input, input_size) : nullptr;
+            }
+
+            std::future<std::shared_ptr<file_types::frame_sample>> decoder::decode_frame_async(std::shared_ptr<file_types::frame_sample> frame,
+                                                                                                 std::shared_ptr<const uint8_t> input, uint32_t input_size)
+            {
+                std::packaged_task<std::shared_ptr<file_types::frame_sample>()> task([this, frame, input, input_size]()
+                {
+                    return decode_frame(frame, input.get(), input_size);
+                });
+                return submit(frame ? frame->finfo.stream : rs_stream::RS_STREAM_COUNT, std::move(task));
+            }
+
+            void decoder::set_dictionary(rs_stream stream, const std::vector<uint8_t> & dictionary)
+            {
+                auto codec = m_codecs.find(stream);
+                if(codec != m_codecs.end() && codec->second)
+                    codec->second->set_dictionary(dictionary);
+            }
+
+            status decoder::decode_frame_into(const file_types::frame_info & info, const uint8_t * input, uint32_t input_size, uint8_t * output, uint32_t output_stride)
+            {
+                LOG_FUNC_SCOPE();
+                auto codec = m_codecs.find(info.stream);
+                if(codec == m_codecs.end() || !codec->second)
+                    return status::status_feature_unsupported;
+                return codec->second->decode_into(info, input, input_size, output, output_stride);
+            }
+
+            std::shared_ptr<file_types::frame_sample> decoder::decode_frame_into(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size,
+                                                                                 std::shared_ptr<uint8_t> output, uint32_t output_stride)
+            {
+                if(!frame || decode_frame_into(frame->finfo, input, input_size, output.get(), output_stride) != status::status_no_error)
+                    return nullptr;
+                auto rv = std::shared_ptr<file_types::frame_sample>(new file_types::frame_sample(frame.get()), [output](file_types::frame_sample* f) { delete f; });
+                rv->finfo.stride = static_cast<int>(output_stride);
+                rv->data = output.get();
+                return rv;
+            }
+
+            std::future<std::shared_ptr<file_types::frame_sample>> decoder::decode_frame_into_async(std::shared_ptr<file_types::frame_sample> frame,
+                                                                                                      std::shared_ptr<const uint8_t> input, uint32_t input_size,
+                                                                                                      std::shared_ptr<uint8_t> output, uint32_t output_stride)
+            {
+                std::packaged_task<std::shared_ptr<file_types::frame_sample>()> task([this, frame, input, input_size, output, output_stride]()
+                {
+                    return decode_frame_into(frame, input.get(), input_size, output, output_stride);
+                });
+                return submit(frame ? frame->finfo.stream : rs_stream::RS_STREAM_COUNT, std::move(task));
+            }
+
+            std::future<std::shared_ptr<file_types::frame_sample>> decoder::submit(rs_stream stream, std::packaged_task<std::shared_ptr<file_types::frame_sample>()> task)
+            {
+                auto rv = task.get_future();
+                {
+                    std::lock_guard<std::mutex> guard(m_tasks_mutex);
+                    if(m_workers.empty())
+                        start_workers();
+                    m_tasks.emplace_back(stream, std::move(task));
+                }
+                m_tasks_cv.notify_one();
+                return rv;
+            }
+
+            //must be called while m_tasks_mutex is locked
+            void decoder::start_workers()
+            {
+                //frames of a stream are decoded in order, a worker per compressed stream is enough to keep the streams independent
+                unsigned int number_of_workers = static_cast<unsigned int>(m_codecs.size());
+                unsigned int number_of_cores = std::thread::hardware_concurrency();
+                //leave a core for the disk read thread
+                if(number_of_cores > 1 && number_of_workers > number_of_cores - 1)
+                    number_of_workers = number_of_cores - 1;
+                if(number_of_workers > MAX_NUMBER_OF_WORKERS)
+                    number_of_workers = MAX_NUMBER_OF_WORKERS;
+                if(number_of_workers == 0)
+                    number_of_workers = 1;
+                for(unsigned int i = 0; i < number_of_workers; i++)
+                    m_workers.push_back(std::thread(&decoder::worker_thread, this));
+                LOG_INFO("decoder started " << number_of_workers << " workers");
+            }
+
+            void decoder::worker_thread()
+            {
+                std::unique_lock<std::mutex> guard(m_tasks_mutex);
+                using task_type = std::pair<rs_stream, std::packaged_task<std::shared_ptr<file_types::frame_sample>()>>;
+                while(true)
+                {
+                    auto next_task = m_tasks.end();
+                    m_tasks_cv.wait(guard, [this, &next_task]()
+                    {
+                        //the oldest task of a stream which is not being decoded
+                        next_task = std::find_if(m_tasks.begin(), m_tasks.end(), [this](const task_type & task)
+                        {
+                            return m_busy_streams.find(task.first) == m_busy_streams.end();
+                        });
+                        return next_task != m_tasks.end() || (m_stop_workers && m_tasks.empty());
+                    });
+                    if(next_task == m_tasks.end())
+                        return;
+                    auto stream = next_task->first;
+                    auto task = std::move(next_task->second);
+                    m_tasks.erase(next_task);
+                    m_busy_streams.insert(stream);
+
+                    guard.unlock();
+                    task();
+                    guard.lock();
+
+                    m_busy_streams.erase(stream);
+                    m_tasks_cv.notify_all();
+                }
             }
         }
     }
@@ -4,6 +4,13 @@
 #pragma once
 #include <map>
 #include <memory>
+#include <deque>
+#include <set>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <future>
+#include <condition_variable>
 #include <librealsense/rs.hpp>
 #include "codec_interface.h"
 
@@ -23,17 +30,63 @@ namespace rs
     {
         namespace compression
         {
+            /**
+            * @brief Decodes the recorded frames on the host, the decoder workers decode the frames of different streams concurrently.
+            *
+            * The frames aren't decoded on a GPU. A device decode, as the nvCOMP batch decode of the lz4 frames, would need a CUDA
+            * build and a test configuration with a device, which the sdk builds don't have.
+            */
             class DLL_EXPORT decoder
             {
             public:
                 decoder(std::map<rs_stream,file_types::compression_type> configuration);
                 ~decoder();
 
-                std::shared_ptr<file_types::frame_sample> decode_frame(std::shared_ptr<file_types::frame_sample> frame, uint8_t * input, uint32_t input_size);
+                std::shared_ptr<file_types::frame_sample> decode_frame(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size);
+                /**
+                * @brief Decodes the frame on one of the decoder worker threads.
+                *
+                * The input is kept alive by the task until the frame is decoded.
+                * Frames of different streams are decoded concurrently, frames of the same stream are decoded one at a time in submission order.
+                * The caller is responsible for delivering the results in the required order.
+                */
+                std::future<std::shared_ptr<file_types::frame_sample>> decode_frame_async(std::shared_ptr<file_types::frame_sample> frame,
+                                                                                          std::shared_ptr<const uint8_t> input, uint32_t input_size);
+                /**
+                * @brief Decodes the frame into a caller buffer, without an intermediate frame buffer where the codec supports it.
+                *
+                * The buffer holds info.height rows, output_stride bytes apart, the stride must not be smaller than the frame stride.
+                */
+                //sets the dictionary the stream codec learned while recording, must be called before the frames of the stream are decoded
+                void set_dictionary(rs_stream stream, const std::vector<uint8_t> & dictionary);
+                status decode_frame_into(const file_types::frame_info & info, const uint8_t * input, uint32_t input_size, uint8_t * output, uint32_t output_stride);
+                /**
+                * @brief Decodes the frame into a caller buffer and returns the decoded frame.
+                *
+                * The returned frame points to the output buffer and keeps it alive, its stride is the output stride. The frame is null if the decoding failed.
+                */
+                std::shared_ptr<file_types::frame_sample> decode_frame_into(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size,
+                                                                            std::shared_ptr<uint8_t> output, uint32_t output_stride);
+                /**
+                * @brief Decodes the frame into a caller buffer on one of the decoder worker threads, see \c decode_frame_into() and \c decode_frame_async().
+                */
+                std::future<std::shared_ptr<file_types::frame_sample>> decode_frame_into_async(std::shared_ptr<file_types::frame_sample> frame,
+                                                                                               std::shared_ptr<const uint8_t> input, uint32_t input_size,
+                                                                                               std::shared_ptr<uint8_t> output, uint32_t output_stride);
 
             private:
                 void add_codec(rs_stream stream_type, file_types::compression_type compression_type);
+                std::future<std::shared_ptr<file_types::frame_sample>> submit(rs_stream stream, std::packaged_task<std::shared_ptr<file_types::frame_sample>()> task);
+                void start_workers();
+                void worker_thread();
+
                 std::map<rs_stream,std::shared_ptr<codec_interface>> m_codecs;
+                std::vector<std::thread>                m_workers;
+                std::deque<std::pair<rs_stream, std::packaged_task<std::shared_ptr<file_types::frame_sample>()>>> m_tasks;
+                std::set<rs_stream>                     m_busy_streams; //streams which are being decoded, codecs may depend on the previous frame
+                std::mutex                              m_tasks_mutex;
+                std::condition_variable                 m_tasks_cv;
+                bool                                    m_stop_workers;
             };
         }
     }
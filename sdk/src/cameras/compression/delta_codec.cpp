@@ -0,0 +1,143 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include "delta_codec.h"
+#include "rs/utils/log_utils.h"
+#include "lz4.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace compression
+        {
+            delta_codec::delta_codec() : m_compression_level(0), m_speed_boost(0), m_sequence_number(0), m_has_reference(false), m_frames_since_keyframe(0)
+            {
+
+            }
+
+            delta_codec::delta_codec(record::compression_level compression_level) :
+                m_compression_level(0), m_speed_boost(0), m_sequence_number(0), m_has_reference(false), m_frames_since_keyframe(0)
+            {
+                switch (compression_level)
+                {
+                    case record::compression_level::low: m_compression_level = 100; break;
+                    case record::compression_level::medium:  m_compression_level = 17; break;
+                    case record::compression_level::high: m_compression_level = 0; break;
+                    default: m_compression_level = 0; break;
+                }
+            }
+
+            delta_codec::~delta_codec(void)
+            {
+                LOG_FUNC_SCOPE();
+            }
+
+            status delta_codec::encode(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size)
+            {
+                LOG_FUNC_SCOPE();
+                output_size = 0;
+                if (!input)
+                {
+                    LOG_ERROR("input data is null");
+                    return status::status_process_failed;
+                }
+                uint32_t input_size = info.stride * info.height;
+                uint32_t number_of_pixels = input_size / static_cast<uint32_t>(sizeof(uint16_t));
+                if(input_size % sizeof(uint16_t) != 0 || input_size <= sizeof(frame_header))
+                    return status::status_param_unsupported;
+
+                frame_header header = {};
+                header.is_keyframe = !m_has_reference || m_reference.size() != number_of_pixels || m_frames_since_keyframe >= KEYFRAME_INTERVAL;
+                header.sequence_number = m_has_reference ? m_sequence_number + 1 : 0;
+
+                auto pixels = reinterpret_cast<const uint16_t*>(input);
+                const char * source = reinterpret_cast<const char*>(input);
+                if(!header.is_keyframe)
+                {
+                    m_deltas.resize(number_of_pixels);
+                    for(uint32_t i = 0; i < number_of_pixels; i++)
+                        m_deltas[i] = static_cast<uint16_t>(pixels[i] - m_reference[i]);
+                    source = reinterpret_cast<const char*>(m_deltas.data());
+                }
+
+                int max_compressed_size = static_cast<int>(input_size - sizeof(frame_header));
+                int compressed_size = LZ4_compress_fast(source, reinterpret_cast<char*>(output + sizeof(frame_header)),
+                                                        static_cast<int>(input_size), max_compressed_size,
+                                                        m_compression_level + static_cast<int32_t>(m_speed_boost) * ACCELERATION_PER_SPEED_BOOST);
+                if(compressed_size <= 0)
+                {
+                    //the frame doesn't compress and is recorded uncompressed, the next frame can't reference it
+                    m_has_reference = false;
+                    LOG_VERBOSE("frame doesn't compress - " << info.number << ", stream - " << info.stream);
+                    return status::status_value_out_of_range;
+                }
+
+                memcpy(output, &header, sizeof(header));
+                output_size = static_cast<uint32_t>(sizeof(header) + compressed_size);
+
+                m_reference.assign(pixels, pixels + number_of_pixels);
+                m_sequence_number = header.sequence_number;
+                m_has_reference = true;
+                m_frames_since_keyframe = header.is_keyframe ? 1 : m_frames_since_keyframe + 1;
+                return status::status_no_error;
+            }
+
+            bool delta_codec::is_keyframe(const uint8_t * encoded_data, uint32_t encoded_size)
+            {
+                if(encoded_data == nullptr || encoded_size < sizeof(frame_header))
+                    return false;
+                frame_header header = {};
+                memcpy(&header, encoded_data, sizeof(header));
+                return header.is_keyframe != 0;
+            }
+
+            std::shared_ptr<file_types::frame_sample> delta_codec::decode(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size)
+            {
+                LOG_FUNC_SCOPE();
+                if(input_size < sizeof(frame_header))
+                    return nullptr;
+                frame_header header = {};
+                memcpy(&header, input, sizeof(header));
+
+                uint32_t frame_size = frame->finfo.stride * frame->finfo.height;
+                uint32_t number_of_pixels = frame_size / static_cast<uint32_t>(sizeof(uint16_t));
+                if(!header.is_keyframe && (!m_has_reference || m_reference.size() != number_of_pixels || header.sequence_number != m_sequence_number + 1))
+                {
+                    LOG_WARN_RATE_LIMITED("reference frame is not available, frame - " << frame->finfo.number << ", stream - " << frame->finfo.stream);
+                    return nullptr;
+                }
+
+                uint8_t * data = nullptr;
+                auto rv = m_frame_pool.acquire(frame, frame_size, data);
+                char * destination = header.is_keyframe ? reinterpret_cast<char*>(data) : nullptr;
+                if(!header.is_keyframe)
+                {
+                    m_deltas.resize(number_of_pixels);
+                    destination = reinterpret_cast<char*>(m_deltas.data());
+                }
+                auto read = LZ4_decompress_safe(reinterpret_cast<const char*>(input + sizeof(frame_header)), destination,
+                                                static_cast<int>(input_size - sizeof(frame_header)), static_cast<int>(frame_size));
+                if(read != static_cast<int>(frame_size))
+                {
+                    m_has_reference = false;
+                    LOG_ERROR_RATE_LIMITED("failed to decode frame - " << frame->finfo.number << ", stream - " << frame->finfo.stream);
+                    return nullptr;
+                }
+
+                auto pixels = reinterpret_cast<uint16_t*>(data);
+                if(!header.is_keyframe)
+                {
+                    for(uint32_t i = 0; i < number_of_pixels; i++)
+                        pixels[i] = static_cast<uint16_t>(m_reference[i] + m_deltas[i]);
+                }
+
+                m_reference.assign(pixels, pixels + number_of_pixels);
+                m_sequence_number = header.sequence_number;
+                m_has_reference = true;
+                return rv;
+            }
+        }
+    }
+}
@@ -0,0 +1,70 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include "codec_interface.h"
+#include "frame_pool.h"
+#include "rs/record/record_device.h"
+
+#ifdef WIN32 
+#ifdef realsense_compression_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_compression_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+        namespace compression
+        {
+            /**
+            * @brief Temporal codec for 16 bit depth images.
+            *
+            * Each frame is encoded as the per pixel difference from the previous frame of the stream, followed by LZ4.
+            * A keyframe, encoded without a reference, is written periodically and after every encoding failure,
+            * since the recorder writes such frames uncompressed and the decoder can't use them as a reference.
+            * The codec is stateful, frames must be encoded and decoded in stream order.
+            */
+            class DLL_EXPORT delta_codec : public codec_interface
+            {
+            public:
+                struct frame_header
+                {
+                    uint32_t is_keyframe;
+                    uint32_t reserved;
+                    uint64_t sequence_number;   //a delta frame references the frame with the previous sequence number
+                };
+
+                static const uint32_t KEYFRAME_INTERVAL = 30;
+
+                delta_codec();
+                delta_codec(record::compression_level compression_level);
+                virtual ~delta_codec();
+
+                virtual status encode(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size) override;
+                virtual std::shared_ptr<file_types::frame_sample> decode(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size) override;
+                virtual file_types::compression_type get_compression_type() override { return file_types::compression_type::delta; }
+                virtual bool is_temporal() override { return true; }
+                virtual bool is_keyframe(const uint8_t * encoded_data, uint32_t encoded_size) override;
+                virtual void reset_reference() override { m_has_reference = false; }
+                virtual void set_speed_boost(uint32_t boost) override { m_speed_boost = boost; }
+
+            private:
+                int32_t                 m_compression_level;
+                uint32_t                m_speed_boost;
+                std::vector<uint16_t>   m_reference;        //last encoded or decoded frame
+                std::vector<uint16_t>   m_deltas;
+                uint64_t                m_sequence_number;  //of the frame in m_reference
+                bool                    m_has_reference;
+                uint32_t                m_frames_since_keyframe;
+                frame_pool              m_frame_pool;
+            };
+        }
+    }
+}
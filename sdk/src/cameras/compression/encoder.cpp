@@ -1,8 +1,16 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <algorithm>
 #include "encoder.h"
 #include "lz4_codec.h"
+#include "delta_codec.h"
+#include "lz4_stream_codec.h"
+#include "yuv420_codec.h"
+#include "rvl_codec.h"
+#ifdef WITH_ZSTD
+#include "zstd_codec.h"
+#endif
 #include "rs/utils/log_utils.h"
 
 namespace rs
@@ -12,14 +20,35 @@ namespace rs
         namespace compression
         {
 
-            encoder::encoder()
-            {
+            static const unsigned int MAX_NUMBER_OF_WORKERS = 4;
+
+            //the speed of a stream is adapted once per interval, so the encode time average reflects the previous speed
+            static const uint32_t SPEED_ADAPTATION_INTERVAL = 30;
+            static const uint32_t HIGH_BACKLOG_PERCENT = 50;
+            static const uint32_t LOW_BACKLOG_PERCENT = 10;
+            //fraction of the frame time left after the encoding
+            static const double LOW_ENCODE_HEADROOM = 0.25;
+            static const double HIGH_ENCODE_HEADROOM = 0.5;
+            static const double ENCODE_TIME_SMOOTHING = 0.1;
 
+            encoder::encoder() : m_backlog_percent(0), m_stop_workers(false)
+            {
+                for(auto & encode_time : m_encode_time)
+                    encode_time.store(0, std::memory_order_relaxed);
             }
 
             encoder::~encoder()
             {
-
+                {
+                    std::lock_guard<std::mutex> guard(m_tasks_mutex);
+                    m_stop_workers = true;
+                }
+                m_tasks_cv.notify_all();
+                for(auto & worker : m_workers)
+                {
+                    if(worker.joinable())
+                        worker.join();
+                }
             }
 
             file_types::compression_type encoder::get_compression_type(rs_stream stream)
@@ -32,27 +61,192 @@ namespace rs
                 return file_types::compression_type::none;
             }
 
-            file_types::compression_type encoder::compression_policy(rs_stream stream, rs_format format)
+            bool encoder::is_temporal(rs_stream stream)
+            {
+                auto codec = m_codecs.find(stream);
+                return codec != m_codecs.end() && codec->second && codec->second->is_temporal();
+            }
+
+            bool encoder::is_keyframe(rs_stream stream, const uint8_t * encoded_data, uint32_t encoded_size)
             {
+                auto codec = m_codecs.find(stream);
+                if(codec == m_codecs.end() || !codec->second)
+                    return true;
+                return codec->second->is_keyframe(encoded_data, encoded_size);
+            }
+
+            file_types::compression_type encoder::compression_policy(rs_stream stream, rs_format format, record::compression_level compression_level,
+                                                                     uint32_t compression_codecs)
+            {
+                if(compression_level == record::compression_level::lossy && yuv420_codec::is_format_supported(format))
+                    return file_types::compression_type::yuv420;
+                //the fastest level codes each depth frame on its own, the other levels exploit the redundancy between consecutive frames
+                if(compression_level == record::compression_level::low && rvl_codec::is_format_supported(format) &&
+                   (compression_codecs & record::compression_codec::codec_rvl))
+                    return file_types::compression_type::rvl;
+                if(format == rs_format::RS_FORMAT_Z16 && (compression_codecs & record::compression_codec::codec_delta))
+                    return file_types::compression_type::delta;
+#ifdef WITH_ZSTD
+                //infrared and fisheye images have little structure for lz4, a dictionary trained from the stream captures it
+                if(format == rs_format::RS_FORMAT_Y8)
+                    return file_types::compression_type::zstd;
+#endif
+                //the highest level matches each frame against the previous one, at the cost of decoding the frames in order
+                if(compression_level == record::compression_level::high && (compression_codecs & record::compression_codec::codec_lz4_stream))
+                    return file_types::compression_type::lz4_stream;
+                //the bands of large frames are decoded in parallel on playback
+                if(compression_codecs & record::compression_codec::codec_lz4_striped)
+                    return file_types::compression_type::lz4_striped;
                 return file_types::compression_type::lz4;
             }
 
-            void encoder::add_codec(rs_stream stream, rs_format format, record::compression_level compression_level)
+            void encoder::add_codec(rs_stream stream, rs_format format, record::compression_level compression_level, uint32_t compression_codecs)
             {
                 if(m_codecs.find(stream) != m_codecs.end()) return;
+                m_streams_load[stream] = stream_load();
                 auto & codec = m_codecs[stream];
-                switch (compression_policy(stream, format))
+                switch (compression_policy(stream, format, compression_level, compression_codecs))
                 {
                     case file_types::compression_type::lz4: codec   = std::shared_ptr<codec_interface>(new lz4_codec(compression_level)); break;
+                    case file_types::compression_type::lz4_striped: codec = std::shared_ptr<codec_interface>(new lz4_codec(compression_level, true)); break;
+                    case file_types::compression_type::delta: codec = std::shared_ptr<codec_interface>(new delta_codec(compression_level)); break;
+                    case file_types::compression_type::lz4_stream: codec = std::shared_ptr<codec_interface>(new lz4_stream_codec(compression_level)); break;
+                    case file_types::compression_type::yuv420: codec = std::shared_ptr<codec_interface>(new yuv420_codec()); break;
+                    case file_types::compression_type::rvl: codec = std::shared_ptr<codec_interface>(new rvl_codec()); break;
+#ifdef WITH_ZSTD
+                    case file_types::compression_type::zstd: codec = std::shared_ptr<codec_interface>(new zstd_codec(compression_level)); break;
+#endif
                     default: codec                                  = nullptr; break;
                 }
             }
 
+            std::map<rs_stream, std::vector<uint8_t>> encoder::get_dictionaries()
+            {
+                std::map<rs_stream, std::vector<uint8_t>> rv;
+                for(auto & codec : m_codecs)
+                {
+                    std::vector<uint8_t> dictionary;
+                    if(codec.second && codec.second->get_dictionary(dictionary))
+                        rv[codec.first] = std::move(dictionary);
+                }
+                return rv;
+            }
+
+            void encoder::reset_references()
+            {
+                for(auto & codec : m_codecs)
+                {
+                    if(codec.second)
+                        codec.second->reset_reference();
+                }
+            }
+
             status encoder::encode_frame(file_types::frame_info &info, const uint8_t *input, uint8_t * output, uint32_t &output_size)
             {
                 LOG_FUNC_SCOPE();
                 auto codec = m_codecs.at(info.stream);
-                return codec ? m_codecs[info.stream]->encode(info, input, output, output_size) : status::status_feature_unsupported;
+                if(!codec)
+                    return status::status_feature_unsupported;
+
+                auto & load = m_streams_load.at(info.stream);
+                adapt_speed(*codec, load, info);
+                auto start_time = std::chrono::steady_clock::now();
+                auto sts = codec->encode(info, input, output, output_size);
+                auto encode_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+                load.average_encode_time += (encode_time - load.average_encode_time) * ENCODE_TIME_SMOOTHING;
+                m_encode_time[info.stream].fetch_add(static_cast<uint64_t>(encode_time * 1000), std::memory_order_relaxed);
+                return sts;
+            }
+
+            void encoder::adapt_speed(codec_interface & codec, stream_load & load, const file_types::frame_info & info)
+            {
+                if(++load.frames_since_adaptation < SPEED_ADAPTATION_INTERVAL)
+                    return;
+                load.frames_since_adaptation = 0;
+
+                double frame_time = info.framerate > 0 ? 1000.0 / info.framerate : 0;
+                double headroom = frame_time > 0 ? 1.0 - load.average_encode_time / frame_time : 1.0;
+                uint32_t backlog = m_backlog_percent;
+                uint32_t speed_boost = load.speed_boost;
+                if((backlog >= HIGH_BACKLOG_PERCENT || headroom < LOW_ENCODE_HEADROOM) && speed_boost < MAX_SPEED_BOOST)
+                    speed_boost++;
+                else if(backlog <= LOW_BACKLOG_PERCENT && headroom > HIGH_ENCODE_HEADROOM && speed_boost > 0)
+                    speed_boost--;
+                if(speed_boost == load.speed_boost)
+                    return;
+
+                LOG_INFO("stream - " << info.stream << ", speed boost - " << speed_boost << ", backlog - " << backlog << "%, encode time - " << load.average_encode_time << "ms");
+                load.speed_boost = speed_boost;
+                codec.set_speed_boost(speed_boost);
+            }
+
+            std::future<status> encoder::encode_frame_async(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size)
+            {
+                std::packaged_task<status()> task([this, &info, input, output, &output_size]()
+                {
+                    return encode_frame(info, input, output, output_size);
+                });
+                auto rv = task.get_future();
+                {
+                    std::lock_guard<std::mutex> guard(m_tasks_mutex);
+                    if(m_workers.empty())
+                        start_workers();
+                    m_tasks.emplace_back(info.stream, std::move(task));
+                }
+                m_tasks_cv.notify_one();
+                return rv;
+            }
+
+            //must be called while m_tasks_mutex is locked
+            void encoder::start_workers()
+            {
+                //the codecs keep state between the frames of their stream, e.g. the reference frame of the delta codec, so the frames of a
+                //stream are encoded one at a time and in order, and more workers than compressed streams would stay idle
+                unsigned int number_of_workers = static_cast<unsigned int>(m_codecs.size());
+                unsigned int number_of_cores = std::thread::hardware_concurrency();
+                //leave a core for the disk write thread
+                if(number_of_cores > 1 && number_of_workers > number_of_cores - 1)
+                    number_of_workers = number_of_cores - 1;
+                if(number_of_workers > MAX_NUMBER_OF_WORKERS)
+                    number_of_workers = MAX_NUMBER_OF_WORKERS;
+                if(number_of_workers == 0)
+                    number_of_workers = 1;
+                for(unsigned int i = 0; i < number_of_workers; i++)
+                    m_workers.push_back(std::thread(&encoder::worker_thread, this));
+                LOG_INFO("encoder started " << number_of_workers << " workers");
+            }
+
+            void encoder::worker_thread()
+            {
+                if(m_worker_start_handler)
+                    m_worker_start_handler();
+                std::unique_lock<std::mutex> guard(m_tasks_mutex);
+                while(true)
+                {
+                    auto next_task = m_tasks.end();
+                    m_tasks_cv.wait(guard, [this, &next_task]()
+                    {
+                        //the oldest task of a stream which is not being encoded
+                        next_task = std::find_if(m_tasks.begin(), m_tasks.end(), [this](const std::pair<rs_stream, std::packaged_task<status()>> & task)
+                        {
+                            return m_busy_streams.find(task.first) == m_busy_streams.end();
+                        });
+                        return next_task != m_tasks.end() || (m_stop_workers && m_tasks.empty());
+                    });
+                    if(next_task == m_tasks.end())
+                        return;
+                    auto stream = next_task->first;
+                    auto task = std::move(next_task->second);
+                    m_tasks.erase(next_task);
+                    m_busy_streams.insert(stream);
+
+                    guard.unlock();
+                    task();
+                    guard.lock();
+
+                    m_busy_streams.erase(stream);
+                    m_tasks_cv.notify_all();
+                }
             }
         }
     }
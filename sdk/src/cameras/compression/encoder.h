@@ -2,9 +2,19 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #pragma once
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <tuple>
+#include <deque>
+#include <set>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <future>
+#include <functional>
+#include <condition_variable>
 #include <librealsense/rs.hpp>
 #include "codec_interface.h"
 #include "rs/record/record_device.h"
@@ -32,12 +42,63 @@ namespace rs
                 ~encoder();
 
                 status encode_frame(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size);
+                /**
+                * @brief Encodes the frame on one of the encoder worker threads.
+                *
+                * The input, output and the frame info must stay valid and unmodified until the returned future is ready.
+                * Frames of different streams are encoded concurrently, frames of the same stream are encoded one at a time in submission order.
+                * The caller is responsible for writing the results in the required order.
+                */
+                std::future<status> encode_frame_async(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size);
                 file_types::compression_type get_compression_type(rs_stream stream);
-                void add_codec(rs_stream stream, rs_format format, record::compression_level compression_level);
+                bool is_temporal(rs_stream stream);
+                bool is_keyframe(rs_stream stream, const uint8_t * encoded_data, uint32_t encoded_size);
+                //the codecs of the recent formats are used only if their record::compression_codec flag is set, otherwise the stream is coded with lz4
+                void add_codec(rs_stream stream, rs_format format, record::compression_level compression_level, uint32_t compression_codecs = 0);
+                /**
+                * @brief Reports the samples waiting to be written, in percents of the writer queue capacity.
+                *
+                * While the writer falls behind, or the encoding of a stream leaves no headroom within its frame time, the stream codec trades
+                * compression ratio for speed, up to MAX_SPEED_BOOST steps. The speed is restored gradually once the backlog clears.
+                */
+                void set_backlog(uint32_t backlog_percent) { m_backlog_percent = backlog_percent; }
+                //called by each worker thread when it starts, e.g. to bind it to the node of the recorded device. Must be set before the first async encode
+                void set_worker_start_handler(std::function<void()> handler) { m_worker_start_handler = handler; }
+                //the dictionaries the codecs learned from their streams, must not be called while frames are being encoded
+                std::map<rs_stream, std::vector<uint8_t>> get_dictionaries();
+                //the next frame of each stream is encoded as a keyframe, must not be called while frames are being encoded
+                void reset_references();
+                //total time the frames of a stream were encoded, in microseconds, updated by the encoding of the stream
+                uint64_t query_encode_time(rs_stream stream) const { return m_encode_time[stream].load(std::memory_order_relaxed); }
+
+                static const uint32_t MAX_SPEED_BOOST = 8;
 
             private:
-                file_types::compression_type compression_policy(rs_stream stream, rs_format format);
+                struct stream_load
+                {
+                    stream_load() : average_encode_time(0), frames_since_adaptation(0), speed_boost(0) {}
+                    double      average_encode_time;    //milliseconds
+                    uint32_t    frames_since_adaptation;
+                    uint32_t    speed_boost;
+                };
+
+                void adapt_speed(codec_interface & codec, stream_load & load, const file_types::frame_info & info);
+
+                file_types::compression_type compression_policy(rs_stream stream, rs_format format, record::compression_level compression_level, uint32_t compression_codecs);
+                void start_workers();
+                void worker_thread();
+
                 std::map<rs_stream,std::shared_ptr<codec_interface>> m_codecs;
+                std::map<rs_stream,stream_load>         m_streams_load; //created with the codecs, an entry is updated only by the encoding of its stream
+                std::atomic<uint32_t>                   m_backlog_percent;
+                std::atomic<uint64_t>                   m_encode_time[RS_STREAM_COUNT];
+                std::vector<std::thread>                m_workers;
+                std::deque<std::pair<rs_stream, std::packaged_task<status()>>> m_tasks;
+                std::set<rs_stream>                     m_busy_streams; //streams which are being encoded, codecs may depend on the previous frame
+                std::mutex                              m_tasks_mutex;
+                std::condition_variable                 m_tasks_cv;
+                bool                                    m_stop_workers;
+                std::function<void()>                   m_worker_start_handler;
             };
         }
     }
@@ -0,0 +1,101 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <new>
+#include "rs/core/frame_allocator_interface.h"
+#include "include/file_types.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace compression
+        {
+            /**
+            * @brief Pool of decoded frames, each frame owns a data buffer of the frame size.
+            *
+            * The pool keeps a reference to every frame it created, a frame is reused once the pool holds its only reference,
+            * so in steady state decoding doesn't allocate. Buffers are replaced when the requested size changes.
+            * The buffers are allocated by the process frame allocator.
+            */
+            class frame_pool
+            {
+                //the buffer is owned by the frame, it stays valid if the application holds the frame after the pool is destroyed
+                struct pooled_frame : public file_types::frame_sample
+                {
+                    pooled_frame(const file_types::frame_sample * frame) : file_types::frame_sample(frame) {}
+                    frame_buffer buffer;
+                };
+
+            public:
+                explicit frame_pool(size_t max_pool_size = 32) : m_max_pool_size(max_pool_size)
+                {
+                    m_frames.reserve(max_pool_size);
+                }
+
+                /**
+                * @brief Returns a copy of the frame description with a writable data buffer of size bytes.
+                * @param[in]  frame     Frame description to copy
+                * @param[in]  size      Required data buffer size
+                * @param[out] data      Writable data buffer, the same as the returned frame data
+                * @return Frame which is not referenced by anyone else
+                */
+                std::shared_ptr<file_types::frame_sample> acquire(const std::shared_ptr<file_types::frame_sample> & frame, size_t size, uint8_t *& data)
+                {
+                    std::lock_guard<std::mutex> guard(m_mutex);
+                    std::shared_ptr<pooled_frame> free_frame = nullptr;
+                    for(auto & pooled : m_frames)
+                    {
+                        //nobody else holds the frame, the count can't increase since only the pool has access to it
+                        if(pooled.use_count() == 1)
+                        {
+                            free_frame = pooled;
+                            if(pooled->buffer.size() == size)
+                                break;
+                        }
+                    }
+
+                    if(free_frame == nullptr)
+                    {
+                        if(m_frames.size() >= m_max_pool_size)
+                        {
+                            //the application holds all the pooled frames, fall back to a private allocation
+                            auto private_frame = std::make_shared<pooled_frame>(frame.get());
+                            private_frame->buffer = frame_buffer(size);
+                            if(size != 0 && !private_frame->buffer.data())
+                                throw std::bad_alloc();
+                            data = private_frame->buffer.data();
+                            private_frame->data = data;
+                            return private_frame;
+                        }
+                        free_frame = std::make_shared<pooled_frame>(frame.get());
+                        m_frames.push_back(free_frame);
+                    }
+                    else
+                    {
+                        static_cast<file_types::frame_sample&>(*free_frame) = *frame;
+                    }
+
+                    if(free_frame->buffer.size() != size)
+                    {
+                        free_frame->buffer = frame_buffer(size);
+                        if(!free_frame->buffer.data())
+                            throw std::bad_alloc();
+                    }
+                    data = free_frame->buffer.data();
+                    free_frame->data = data;
+                    return free_frame;
+                }
+
+            private:
+                std::mutex                                  m_mutex;
+                std::vector<std::shared_ptr<pooled_frame>>  m_frames;
+                size_t                                      m_max_pool_size;
+            };
+        }
+    }
+}
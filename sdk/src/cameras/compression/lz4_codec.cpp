@@ -1,9 +1,13 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <algorithm>
+#include <cstring>
+#include <future>
 #include <vector>
 #include "lz4_codec.h"
 #include "rs/utils/log_utils.h"
+#include "rs/utils/profiler_markers.h"
 #include "lz4.h"
 
 namespace rs
@@ -12,13 +16,16 @@ namespace rs
     {
         namespace compression
         {
+            const uint32_t lz4_codec::MAX_BANDS;
+            const uint32_t lz4_codec::MIN_BAND_SIZE;
 
-            lz4_codec::lz4_codec() : m_compression_level(0)
+            lz4_codec::lz4_codec(bool is_striped) : m_compression_level(0), m_speed_boost(0), m_is_striped(is_striped)
             {
 
             }
 
-            lz4_codec::lz4_codec(record::compression_level compression_level) : m_compression_level(0)
+            lz4_codec::lz4_codec(record::compression_level compression_level, bool is_striped) :
+                m_compression_level(0), m_speed_boost(0), m_is_striped(is_striped)
             {
                 switch (compression_level)
                 {
@@ -34,28 +41,52 @@ namespace rs
                 LOG_FUNC_SCOPE();
             }
 
-            std::shared_ptr<file_types::frame_sample> lz4_codec::decode(std::shared_ptr<file_types::frame_sample> frame, uint8_t * input, uint32_t input_size)
+            std::shared_ptr<file_types::frame_sample> lz4_codec::decode(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size)
             {
                 LOG_FUNC_SCOPE();
-
-                auto rv = std::shared_ptr<file_types::frame_sample>(
-                new file_types::frame_sample(frame.get()), [](file_types::frame_sample* f){delete[] f->data; delete f;});
+                RS_PROFILER_ZONE("lz4_codec::decode");
 
                 int frame_size = frame->finfo.stride * frame->finfo.height;
-                auto data = new uint8_t[frame_size];
-                auto read = LZ4_decompress_fast (reinterpret_cast<char*>(input), reinterpret_cast<char*>(data), frame_size);
-                if(read < 0)
+                uint8_t * data = nullptr;
+                auto rv = m_frame_pool.acquire(frame, frame_size, data);
+                if(!decode_frame(frame->finfo, input, input_size, data))
                 {
-                    LOG_ERROR("failed to decode frame - " << frame->finfo.number << ", stream - " << frame->finfo.stream);
+                    LOG_ERROR_RATE_LIMITED("failed to decode frame - " << frame->finfo.number << ", stream - " << frame->finfo.stream);
                     return nullptr;
                 }
-                rv->data = data;
                 return rv;
             }
 
+            status lz4_codec::decode_into(const file_types::frame_info & info, const uint8_t * input, uint32_t input_size, uint8_t * output, uint32_t output_stride)
+            {
+                LOG_FUNC_SCOPE();
+                RS_PROFILER_ZONE("lz4_codec::decode_into");
+
+                //a buffer with padded rows can't be the target of an lz4 block
+                if(output_stride != static_cast<uint32_t>(info.stride))
+                    return codec_interface::decode_into(info, input, input_size, output, output_stride);
+                if(!output)
+                    return status::status_param_unsupported;
+                if(!decode_frame(info, input, input_size, output))
+                {
+                    LOG_ERROR_RATE_LIMITED("failed to decode frame - " << info.number << ", stream - " << info.stream);
+                    return status::status_process_failed;
+                }
+                return status::status_no_error;
+            }
+
+            bool lz4_codec::decode_frame(const file_types::frame_info & info, const uint8_t * input, uint32_t input_size, uint8_t * output)
+            {
+                if(m_is_striped)
+                    return decode_striped(input, input_size, info.stride, info.height, output);
+                int frame_size = info.stride * info.height;
+                return LZ4_decompress_fast(reinterpret_cast<const char*>(input), reinterpret_cast<char*>(output), frame_size) >= 0;
+            }
+
             status lz4_codec::encode(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size)
             {
                 LOG_FUNC_SCOPE();
+                RS_PROFILER_ZONE("lz4_codec::encode");
 
                 if (!input)
                 {
@@ -63,15 +94,106 @@ namespace rs
                     return status::status_process_failed;
                 }
 
+                if(m_is_striped)
+                    return encode_striped(info, input, output, output_size);
+
                 int input_size = info.stride * info.height;
-                output_size = LZ4_compress_fast(reinterpret_cast<const char*>(input), reinterpret_cast<char*>(output), input_size, input_size, m_compression_level);
-                if(output_size == 0 || output_size == static_cast<uint32_t>(input_size))
+                output_size = LZ4_compress_fast(reinterpret_cast<const char*>(input), reinterpret_cast<char*>(output), input_size, input_size, get_acceleration());
+                //the output is limited to the input size, lz4 fails on frames which don't compress
+                if(output_size == 0 || output_size >= static_cast<uint32_t>(input_size))
                 {
-                    LOG_ERROR("failed to encode frame - " << info.number << ", stream - " << info.stream);
-                    return status::status_process_failed;
+                    LOG_VERBOSE("frame doesn't compress - " << info.number << ", stream - " << info.stream);
+                    return status::status_value_out_of_range;
+                }
+                return status::status_no_error;
+            }
+
+            status lz4_codec::encode_striped(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size)
+            {
+                output_size = 0;
+                uint32_t stride = static_cast<uint32_t>(info.stride);
+                uint32_t height = static_cast<uint32_t>(info.height);
+                uint32_t input_size = stride * height;
+                if(input_size == 0)
+                    return status::status_param_unsupported;
+
+                uint32_t bands_count = std::min(MAX_BANDS, std::max(1u, input_size / MIN_BAND_SIZE));
+                bands_count = std::min(bands_count, height);
+                striped_header header = {};
+                header.rows_per_band = (height + bands_count - 1) / bands_count;
+                header.bands_count = (height + header.rows_per_band - 1) / header.rows_per_band;
+
+                uint32_t table_size = static_cast<uint32_t>(sizeof(header) + header.bands_count * sizeof(uint32_t));
+                if(input_size <= table_size)
+                    return status::status_param_unsupported;
+
+                //the output buffer is as large as the input, a frame which doesn't compress is recorded uncompressed
+                std::vector<uint32_t> band_sizes(header.bands_count);
+                uint32_t offset = table_size;
+                for(uint32_t band = 0; band < header.bands_count; band++)
+                {
+                    uint32_t first_row = band * header.rows_per_band;
+                    uint32_t band_size = (std::min(height, first_row + header.rows_per_band) - first_row) * stride;
+                    int compressed_size = LZ4_compress_fast(reinterpret_cast<const char*>(input + first_row * stride), reinterpret_cast<char*>(output + offset),
+                                                            static_cast<int>(band_size), static_cast<int>(input_size - offset), get_acceleration());
+                    if(compressed_size <= 0)
+                    {
+                        LOG_VERBOSE("frame doesn't compress - " << info.number << ", stream - " << info.stream);
+                        return status::status_value_out_of_range;
+                    }
+                    band_sizes[band] = static_cast<uint32_t>(compressed_size);
+                    offset += band_sizes[band];
                 }
+
+                memcpy(output, &header, sizeof(header));
+                memcpy(output + sizeof(header), band_sizes.data(), band_sizes.size() * sizeof(uint32_t));
+                output_size = offset;
                 return status::status_no_error;
             }
+
+            bool lz4_codec::decode_striped(const uint8_t * input, uint32_t input_size, uint32_t stride, uint32_t height, uint8_t * output)
+            {
+                striped_header header = {};
+                if(input_size < sizeof(header))
+                    return false;
+                memcpy(&header, input, sizeof(header));
+                if(header.bands_count == 0 || header.bands_count > MAX_BANDS || header.rows_per_band == 0 ||
+                   (header.bands_count - 1) * header.rows_per_band >= height || header.bands_count * header.rows_per_band < height)
+                    return false;
+
+                uint32_t table_size = static_cast<uint32_t>(sizeof(header) + header.bands_count * sizeof(uint32_t));
+                if(input_size < table_size)
+                    return false;
+                std::vector<uint32_t> band_sizes(header.bands_count);
+                memcpy(band_sizes.data(), input + sizeof(header), band_sizes.size() * sizeof(uint32_t));
+
+                std::vector<uint32_t> band_offsets(header.bands_count);
+                uint64_t offset = table_size;
+                for(uint32_t band = 0; band < header.bands_count; band++)
+                {
+                    band_offsets[band] = static_cast<uint32_t>(offset);
+                    offset += band_sizes[band];
+                }
+                if(offset != input_size)
+                    return false;
+
+                auto decode_band = [&](uint32_t band) -> bool
+                {
+                    uint32_t first_row = band * header.rows_per_band;
+                    int band_size = static_cast<int>((std::min(height, first_row + header.rows_per_band) - first_row) * stride);
+                    return LZ4_decompress_safe(reinterpret_cast<const char*>(input + band_offsets[band]), reinterpret_cast<char*>(output + first_row * stride),
+                                               static_cast<int>(band_sizes[band]), band_size) == band_size;
+                };
+
+                //the first band is decoded on the calling thread, the others in parallel
+                std::vector<std::future<bool>> bands;
+                for(uint32_t band = 1; band < header.bands_count; band++)
+                    bands.push_back(std::async(std::launch::async, decode_band, band));
+                bool rv = decode_band(0);
+                for(auto & band : bands)
+                    rv = band.get() && rv;
+                return rv;
+            }
         }
     }
 }
@@ -5,6 +5,7 @@
 #include <thread>
 #include <map>
 #include "codec_interface.h"
+#include "frame_pool.h"
 #include "rs/record/record_device.h"
 
 #ifdef WIN32 
@@ -23,18 +24,49 @@ namespace rs
     {
         namespace compression
         {
+            /**
+            * @brief Lossless LZ4 codec.
+            *
+            * A frame is encoded as a single LZ4 block, or, in the striped format, as up to MAX_BANDS row bands, each compressed independently.
+            * The striped frame starts with a band table, so the bands of large frames are decoded in parallel.
+            */
             class DLL_EXPORT lz4_codec : public codec_interface
             {
             public:
-                lz4_codec();
-                lz4_codec(record::compression_level compression_level);
+                struct striped_header
+                {
+                    uint32_t bands_count;
+                    uint32_t rows_per_band;     //the last band holds the remaining rows
+                    //followed by the compressed size of each band, and the compressed bands in order
+                };
+
+                static const uint32_t MAX_BANDS = 4;
+                static const uint32_t MIN_BAND_SIZE = 256 * 1024; //smaller frames are not worth a decode thread per band
+
+                lz4_codec(bool is_striped = false);
+                lz4_codec(record::compression_level compression_level, bool is_striped = false);
                 virtual ~lz4_codec();
 
                 virtual status encode(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size) override;
-                virtual std::shared_ptr<file_types::frame_sample> decode(std::shared_ptr<file_types::frame_sample> frame, uint8_t * input, uint32_t input_size) override;
-                virtual file_types::compression_type get_compression_type() override { return file_types::compression_type::lz4; }
+                virtual std::shared_ptr<file_types::frame_sample> decode(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size) override;
+                virtual status decode_into(const file_types::frame_info & info, const uint8_t * input, uint32_t input_size, uint8_t * output, uint32_t output_stride) override;
+                virtual void set_speed_boost(uint32_t boost) override { m_speed_boost = boost; }
+                virtual file_types::compression_type get_compression_type() override
+                {
+                    return m_is_striped ? file_types::compression_type::lz4_striped : file_types::compression_type::lz4;
+                }
             private:
+                //decodes the frame into a buffer of the frame stride
+                bool decode_frame(const file_types::frame_info & info, const uint8_t * input, uint32_t input_size, uint8_t * output);
+                status encode_striped(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size);
+                bool decode_striped(const uint8_t * input, uint32_t input_size, uint32_t stride, uint32_t height, uint8_t * output);
+
+                int32_t get_acceleration() const { return static_cast<int32_t>(m_compression_level) + static_cast<int32_t>(m_speed_boost) * ACCELERATION_PER_SPEED_BOOST; }
+
                 uint32_t m_compression_level;
+                uint32_t m_speed_boost;
+                bool m_is_striped;
+                frame_pool m_frame_pool;
             };
         }
     }
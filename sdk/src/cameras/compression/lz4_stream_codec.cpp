@@ -0,0 +1,175 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <cstring>
+#include "lz4_stream_codec.h"
+#include "rs/utils/log_utils.h"
+#include "rs/utils/profiler_markers.h"
+#include "lz4.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace compression
+        {
+            const uint32_t lz4_stream_codec::BLOCK_SIZE;
+            const uint32_t lz4_stream_codec::WINDOW_SIZE;
+            const uint32_t lz4_stream_codec::KEYFRAME_INTERVAL;
+            static_assert(sizeof(lz4_stream_codec::frame_header) == sizeof(delta_codec::frame_header), "the temporal frame headers differ");
+
+            lz4_stream_codec::lz4_stream_codec() : m_compression_level(0), m_speed_boost(0), m_stream(nullptr), m_sequence_number(0), m_has_reference(false),
+                m_frames_since_keyframe(0)
+            {
+
+            }
+
+            lz4_stream_codec::lz4_stream_codec(record::compression_level compression_level) :
+                m_compression_level(0), m_speed_boost(0), m_stream(nullptr), m_sequence_number(0), m_has_reference(false), m_frames_since_keyframe(0)
+            {
+                switch (compression_level)
+                {
+                    case record::compression_level::low: m_compression_level = 100; break;
+                    case record::compression_level::medium:  m_compression_level = 17; break;
+                    case record::compression_level::high: m_compression_level = 0; break;
+                    default: m_compression_level = 0; break;
+                }
+            }
+
+            lz4_stream_codec::~lz4_stream_codec(void)
+            {
+                LOG_FUNC_SCOPE();
+                if(m_stream)
+                    LZ4_freeStream(static_cast<LZ4_stream_t*>(m_stream));
+            }
+
+            status lz4_stream_codec::encode(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size)
+            {
+                LOG_FUNC_SCOPE();
+                RS_PROFILER_ZONE("lz4_stream_codec::encode");
+                output_size = 0;
+                if (!input)
+                {
+                    LOG_ERROR("input data is null");
+                    return status::status_process_failed;
+                }
+                uint32_t input_size = info.stride * info.height;
+                uint32_t blocks_count = get_blocks_count(input_size);
+                uint32_t table_size = static_cast<uint32_t>(sizeof(frame_header) + blocks_count * sizeof(uint32_t));
+                if(input_size <= table_size)
+                    return status::status_param_unsupported;
+                if(!m_stream)
+                    m_stream = LZ4_createStream();
+                if(!m_stream)
+                    return status::status_process_failed;
+
+                frame_header header = {};
+                header.is_keyframe = !m_has_reference || m_reference.size() != input_size || m_frames_since_keyframe >= KEYFRAME_INTERVAL;
+                header.blocks_count = blocks_count;
+                header.sequence_number = m_has_reference ? m_sequence_number + 1 : 0;
+
+                //the blocks of a keyframe are contiguous, the stream keeps the preceding blocks as the dictionary of the next one
+                auto stream = static_cast<LZ4_stream_t*>(m_stream);
+                LZ4_resetStream(stream);
+                m_block_sizes.resize(blocks_count);
+                uint32_t offset = table_size;
+                for(uint32_t block = 0; block < blocks_count; block++)
+                {
+                    uint32_t block_begin = block * BLOCK_SIZE;
+                    uint32_t block_size = std::min(BLOCK_SIZE, input_size - block_begin);
+                    if(!header.is_keyframe)
+                    {
+                        uint32_t window_begin = get_window_begin(block_begin + block_size);
+                        LZ4_loadDict(stream, reinterpret_cast<const char*>(m_reference.data() + window_begin), static_cast<int>(block_begin + block_size - window_begin));
+                    }
+                    int compressed_size = LZ4_compress_fast_continue(stream, reinterpret_cast<const char*>(input + block_begin), reinterpret_cast<char*>(output + offset),
+                                                                     static_cast<int>(block_size), static_cast<int>(input_size - offset),
+                                                                     m_compression_level + static_cast<int32_t>(m_speed_boost) * ACCELERATION_PER_SPEED_BOOST);
+                    if(compressed_size <= 0)
+                    {
+                        //the frame doesn't compress and is recorded uncompressed, the next frame can't reference it
+                        m_has_reference = false;
+                        LOG_VERBOSE("frame doesn't compress - " << info.number << ", stream - " << info.stream);
+                        return status::status_value_out_of_range;
+                    }
+                    m_block_sizes[block] = static_cast<uint32_t>(compressed_size);
+                    offset += m_block_sizes[block];
+                }
+
+                memcpy(output, &header, sizeof(header));
+                memcpy(output + sizeof(header), m_block_sizes.data(), m_block_sizes.size() * sizeof(uint32_t));
+                output_size = offset;
+
+                m_reference.assign(input, input + input_size);
+                m_sequence_number = header.sequence_number;
+                m_has_reference = true;
+                m_frames_since_keyframe = header.is_keyframe ? 1 : m_frames_since_keyframe + 1;
+                return status::status_no_error;
+            }
+
+            bool lz4_stream_codec::is_keyframe(const uint8_t * encoded_data, uint32_t encoded_size)
+            {
+                if(encoded_data == nullptr || encoded_size < sizeof(frame_header))
+                    return false;
+                frame_header header = {};
+                memcpy(&header, encoded_data, sizeof(header));
+                return header.is_keyframe != 0;
+            }
+
+            std::shared_ptr<file_types::frame_sample> lz4_stream_codec::decode(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size)
+            {
+                LOG_FUNC_SCOPE();
+                RS_PROFILER_ZONE("lz4_stream_codec::decode");
+                if(input_size < sizeof(frame_header))
+                    return nullptr;
+                frame_header header = {};
+                memcpy(&header, input, sizeof(header));
+
+                uint32_t frame_size = frame->finfo.stride * frame->finfo.height;
+                uint32_t table_size = static_cast<uint32_t>(sizeof(frame_header) + header.blocks_count * sizeof(uint32_t));
+                if(header.blocks_count != get_blocks_count(frame_size) || input_size < table_size)
+                {
+                    LOG_ERROR_RATE_LIMITED("failed to decode frame - " << frame->finfo.number << ", stream - " << frame->finfo.stream);
+                    return nullptr;
+                }
+                if(!header.is_keyframe && (!m_has_reference || m_reference.size() != frame_size || header.sequence_number != m_sequence_number + 1))
+                {
+                    LOG_WARN_RATE_LIMITED("reference frame is not available, frame - " << frame->finfo.number << ", stream - " << frame->finfo.stream);
+                    return nullptr;
+                }
+
+                m_block_sizes.resize(header.blocks_count);
+                memcpy(m_block_sizes.data(), input + sizeof(frame_header), m_block_sizes.size() * sizeof(uint32_t));
+                uint8_t * data = nullptr;
+                auto rv = m_frame_pool.acquire(frame, frame_size, data);
+                uint64_t offset = table_size;
+                for(uint32_t block = 0; block < header.blocks_count; block++)
+                {
+                    uint32_t block_begin = block * BLOCK_SIZE;
+                    uint32_t block_size = std::min(BLOCK_SIZE, frame_size - block_begin);
+                    //the dictionary of a keyframe block is the preceding decoded blocks, of a delta frame block the window of the reference frame
+                    uint32_t window_begin = get_window_begin(header.is_keyframe ? block_begin : block_begin + block_size);
+                    const uint8_t * dictionary = header.is_keyframe ? data + window_begin : m_reference.data() + window_begin;
+                    uint32_t dictionary_size = (header.is_keyframe ? block_begin : block_begin + block_size) - window_begin;
+                    int read = offset + m_block_sizes[block] > input_size ? -1 :
+                        LZ4_decompress_safe_usingDict(reinterpret_cast<const char*>(input + offset), reinterpret_cast<char*>(data + block_begin),
+                                                      static_cast<int>(m_block_sizes[block]), static_cast<int>(block_size),
+                                                      reinterpret_cast<const char*>(dictionary), static_cast<int>(dictionary_size));
+                    if(read != static_cast<int>(block_size))
+                    {
+                        m_has_reference = false;
+                        LOG_ERROR_RATE_LIMITED("failed to decode frame - " << frame->finfo.number << ", stream - " << frame->finfo.stream);
+                        return nullptr;
+                    }
+                    offset += m_block_sizes[block];
+                }
+
+                m_reference.assign(data, data + frame_size);
+                m_sequence_number = header.sequence_number;
+                m_has_reference = true;
+                return rv;
+            }
+        }
+    }
+}
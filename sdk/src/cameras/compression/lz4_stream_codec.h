@@ -0,0 +1,82 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include "codec_interface.h"
+#include "delta_codec.h"
+#include "frame_pool.h"
+#include "rs/record/record_device.h"
+
+#ifdef WIN32 
+#ifdef realsense_compression_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_compression_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+        namespace compression
+        {
+            /**
+            * @brief Temporal LZ4 codec, for images of any format.
+            *
+            * The frame is compressed in blocks of BLOCK_SIZE bytes with the LZ4 streaming API. A block of a delta frame is compressed with the
+            * dictionary of the WINDOW_SIZE bytes of the previous frame which end with the same block, so the static parts of the image are
+            * matched against the previous frame, even though an LZ4 match can't reach further back than its 64KB window. A block of a keyframe
+            * uses the preceding blocks of the frame as its dictionary. The keyframes are written as the delta codec writes them, periodically
+            * and after every encoding failure. The codec is stateful, frames must be encoded and decoded in stream order.
+            */
+            class DLL_EXPORT lz4_stream_codec : public codec_interface
+            {
+            public:
+                //laid out as the delta codec frame header, a clip export reads the keyframe flag of both
+                struct frame_header
+                {
+                    uint32_t is_keyframe;
+                    uint32_t blocks_count;
+                    uint64_t sequence_number;   //a delta frame references the frame with the previous sequence number
+                    //followed by the compressed size of each block, and the compressed blocks in order
+                };
+
+                static const uint32_t BLOCK_SIZE = 32 * 1024;
+                static const uint32_t WINDOW_SIZE = 64 * 1024;
+                //the playback seeks the temporal streams back by at most the keyframe interval of the delta codec
+                static const uint32_t KEYFRAME_INTERVAL = delta_codec::KEYFRAME_INTERVAL;
+
+                lz4_stream_codec();
+                lz4_stream_codec(record::compression_level compression_level);
+                virtual ~lz4_stream_codec();
+
+                virtual status encode(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size) override;
+                virtual std::shared_ptr<file_types::frame_sample> decode(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size) override;
+                virtual file_types::compression_type get_compression_type() override { return file_types::compression_type::lz4_stream; }
+                virtual bool is_temporal() override { return true; }
+                virtual bool is_keyframe(const uint8_t * encoded_data, uint32_t encoded_size) override;
+                virtual void reset_reference() override { m_has_reference = false; }
+                virtual void set_speed_boost(uint32_t boost) override { m_speed_boost = boost; }
+
+            private:
+                static uint32_t get_blocks_count(uint32_t frame_size) { return (frame_size + BLOCK_SIZE - 1) / BLOCK_SIZE; }
+                //the first byte of the dictionary window of the block which ends at the block end
+                static uint32_t get_window_begin(uint32_t block_end) { return block_end > WINDOW_SIZE ? block_end - WINDOW_SIZE : 0; }
+
+                int32_t                 m_compression_level;
+                uint32_t                m_speed_boost;
+                void *                  m_stream;           //the lz4 stream state of the encoder
+                std::vector<uint8_t>    m_reference;        //last encoded or decoded frame
+                std::vector<uint32_t>   m_block_sizes;
+                uint64_t                m_sequence_number;  //of the frame in m_reference
+                bool                    m_has_reference;
+                uint32_t                m_frames_since_keyframe;
+                frame_pool              m_frame_pool;
+            };
+        }
+    }
+}
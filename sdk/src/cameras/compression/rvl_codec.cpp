@@ -0,0 +1,237 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include "rvl_codec.h"
+#include "rs/utils/log_utils.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace compression
+        {
+            namespace
+            {
+                //nibbles are packed from the most significant bits of each word, words are stored in memory order
+                class nibble_writer
+                {
+                public:
+                    nibble_writer(uint8_t * output, uint32_t capacity) :
+                        m_begin(output), m_output(output), m_end(output + capacity - capacity % sizeof(uint32_t)), m_word(0), m_nibbles(0), m_overflow(false) {}
+
+                    void write_value(uint32_t value)
+                    {
+                        do
+                        {
+                            uint32_t nibble = value & 0x7;
+                            value >>= 3;
+                            if(value)
+                                nibble |= 0x8;
+                            write_nibble(nibble);
+                        } while(value);
+                    }
+
+                    //returns the number of bytes written, 0 if the output is too small
+                    uint32_t flush()
+                    {
+                        if(m_nibbles > 0)
+                        {
+                            m_word <<= 4 * (8 - m_nibbles);
+                            store_word();
+                        }
+                        return m_overflow ? 0 : static_cast<uint32_t>(m_output - m_begin);
+                    }
+
+                    bool is_overflow() const { return m_overflow; }
+                private:
+                    void write_nibble(uint32_t nibble)
+                    {
+                        m_word = (m_word << 4) | nibble;
+                        if(++m_nibbles == 8)
+                            store_word();
+                    }
+
+                    void store_word()
+                    {
+                        if(m_output == m_end)
+                        {
+                            m_overflow = true;
+                        }
+                        else
+                        {
+                            memcpy(m_output, &m_word, sizeof(m_word));
+                            m_output += sizeof(m_word);
+                        }
+                        m_word = 0;
+                        m_nibbles = 0;
+                    }
+
+                    uint8_t *   m_begin;
+                    uint8_t *   m_output;
+                    uint8_t *   m_end;
+                    uint32_t    m_word;
+                    uint32_t    m_nibbles;
+                    bool        m_overflow;
+                };
+
+                class nibble_reader
+                {
+                public:
+                    nibble_reader(const uint8_t * input, uint32_t input_size) :
+                        m_input(input), m_end(input + input_size - input_size % sizeof(uint32_t)), m_word(0), m_nibbles(0), m_underflow(false) {}
+
+                    uint32_t read_value()
+                    {
+                        uint32_t value = 0;
+                        uint32_t shift = 0;
+                        uint32_t nibble = 0;
+                        do
+                        {
+                            nibble = read_nibble();
+                            //a 32 bit value takes at most 11 nibbles
+                            if(shift > 30)
+                            {
+                                m_underflow = true;
+                                return 0;
+                            }
+                            value |= (nibble & 0x7) << shift;
+                            shift += 3;
+                        } while((nibble & 0x8) && !m_underflow);
+                        return value;
+                    }
+
+                    bool is_underflow() const { return m_underflow; }
+                private:
+                    uint32_t read_nibble()
+                    {
+                        if(m_nibbles == 0)
+                        {
+                            if(m_input == m_end)
+                            {
+                                m_underflow = true;
+                                return 0;
+                            }
+                            memcpy(&m_word, m_input, sizeof(m_word));
+                            m_input += sizeof(m_word);
+                            m_nibbles = 8;
+                        }
+                        m_nibbles--;
+                        return (m_word >> (4 * m_nibbles)) & 0xf;
+                    }
+
+                    const uint8_t * m_input;
+                    const uint8_t * m_end;
+                    uint32_t        m_word;
+                    uint32_t        m_nibbles;
+                    bool            m_underflow;
+                };
+            }
+
+            status rvl_codec::encode(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size)
+            {
+                LOG_FUNC_SCOPE();
+                output_size = 0;
+                if (!input)
+                {
+                    LOG_ERROR("input data is null");
+                    return status::status_process_failed;
+                }
+                uint32_t input_size = info.stride * info.height;
+                if(input_size % sizeof(uint16_t) != 0 || input_size == 0)
+                    return status::status_param_unsupported;
+
+                uint32_t number_of_pixels = input_size / static_cast<uint32_t>(sizeof(uint16_t));
+                auto pixels = reinterpret_cast<const uint16_t*>(input);
+                //the output is limited to the input size, a larger output is recorded uncompressed
+                nibble_writer writer(output, input_size);
+                int32_t previous = 0;
+                uint32_t i = 0;
+                while(i < number_of_pixels && !writer.is_overflow())
+                {
+                    uint32_t zeros_begin = i;
+                    while(i < number_of_pixels && pixels[i] == 0)
+                        i++;
+                    writer.write_value(i - zeros_begin);
+
+                    uint32_t values_begin = i;
+                    while(i < number_of_pixels && pixels[i] != 0)
+                        i++;
+                    writer.write_value(i - values_begin);
+
+                    for(uint32_t j = values_begin; j < i; j++)
+                    {
+                        int32_t delta = static_cast<int32_t>(pixels[j]) - previous;
+                        writer.write_value((static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31));
+                        previous = pixels[j];
+                    }
+                }
+
+                output_size = writer.flush();
+                if(output_size == 0 || output_size >= input_size)
+                {
+                    output_size = 0;
+                    LOG_VERBOSE("frame doesn't compress - " << info.number << ", stream - " << info.stream);
+                    return status::status_value_out_of_range;
+                }
+                return status::status_no_error;
+            }
+
+            bool rvl_codec::decode_pixels(const uint8_t * input, uint32_t input_size, uint16_t * pixels, uint32_t number_of_pixels)
+            {
+                nibble_reader reader(input, input_size);
+                int32_t previous = 0;
+                uint32_t i = 0;
+                while(i < number_of_pixels)
+                {
+                    uint32_t zeros = reader.read_value();
+                    uint32_t values = reader.read_value();
+                    if(reader.is_underflow() || zeros > number_of_pixels - i || values > number_of_pixels - i - zeros)
+                        return false;
+                    memset(pixels + i, 0, zeros * sizeof(uint16_t));
+                    i += zeros;
+                    for(uint32_t end = i + values; i < end; i++)
+                    {
+                        uint32_t folded = reader.read_value();
+                        int32_t delta = static_cast<int32_t>(folded >> 1) ^ -static_cast<int32_t>(folded & 1);
+                        previous += delta;
+                        pixels[i] = static_cast<uint16_t>(previous);
+                    }
+                    if(reader.is_underflow())
+                        return false;
+                }
+                return true;
+            }
+
+            std::shared_ptr<file_types::frame_sample> rvl_codec::decode(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size)
+            {
+                LOG_FUNC_SCOPE();
+                uint32_t frame_size = frame->finfo.stride * frame->finfo.height;
+                uint8_t * data = nullptr;
+                auto rv = m_frame_pool.acquire(frame, frame_size, data);
+                if(!decode_pixels(input, input_size, reinterpret_cast<uint16_t*>(data), frame_size / static_cast<uint32_t>(sizeof(uint16_t))))
+                {
+                    LOG_ERROR("failed to decode frame - " << frame->finfo.number << ", stream - " << frame->finfo.stream);
+                    return nullptr;
+                }
+                return rv;
+            }
+
+            status rvl_codec::decode_into(const file_types::frame_info & info, const uint8_t * input, uint32_t input_size, uint8_t * output, uint32_t output_stride)
+            {
+                LOG_FUNC_SCOPE();
+                if(output_stride != static_cast<uint32_t>(info.stride))
+                    return codec_interface::decode_into(info, input, input_size, output, output_stride);
+                if(!output)
+                    return status::status_param_unsupported;
+                uint32_t frame_size = info.stride * info.height;
+                if(!decode_pixels(input, input_size, reinterpret_cast<uint16_t*>(output), frame_size / static_cast<uint32_t>(sizeof(uint16_t))))
+                {
+                    LOG_ERROR("failed to decode frame - " << info.number << ", stream - " << info.stream);
+                    return status::status_process_failed;
+                }
+                return status::status_no_error;
+            }
+        }
+    }
+}
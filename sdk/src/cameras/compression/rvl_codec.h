@@ -0,0 +1,51 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "codec_interface.h"
+#include "frame_pool.h"
+
+#ifdef WIN32 
+#ifdef realsense_compression_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_compression_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+        namespace compression
+        {
+            /**
+            * @brief Lossless run length and variable length codec for 16 bit depth images.
+            *
+            * The image is coded as alternating runs of invalid (zero) pixels and runs of valid pixels. Each valid pixel is coded as its
+            * difference from the previous valid pixel. The run lengths and the zigzag folded differences are written as variable length
+            * nibbles, 3 data bits and a continuation bit, packed into 32 bit words. Depth noise costs a few bits per pixel instead of breaking
+            * the byte matches lz4 relies on. Each frame is coded independently.
+            */
+            class DLL_EXPORT rvl_codec : public codec_interface
+            {
+            public:
+                rvl_codec() {}
+                virtual ~rvl_codec() {}
+
+                virtual status encode(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size) override;
+                virtual std::shared_ptr<file_types::frame_sample> decode(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size) override;
+                virtual status decode_into(const file_types::frame_info & info, const uint8_t * input, uint32_t input_size, uint8_t * output, uint32_t output_stride) override;
+                virtual file_types::compression_type get_compression_type() override { return file_types::compression_type::rvl; }
+
+                static bool is_format_supported(rs_format format) { return format == rs_format::RS_FORMAT_Z16; }
+            private:
+                bool decode_pixels(const uint8_t * input, uint32_t input_size, uint16_t * pixels, uint32_t number_of_pixels);
+
+                frame_pool m_frame_pool;
+            };
+        }
+    }
+}
@@ -0,0 +1,167 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "yuv420_codec.h"
+#include "rs/utils/log_utils.h"
+#include "lz4.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace compression
+        {
+            namespace
+            {
+                struct pixel_layout
+                {
+                    int bytes_per_pixel;
+                    int red;
+                    int green;
+                    int blue;
+                    int alpha;  //-1 if the format has no alpha channel
+                };
+
+                pixel_layout get_pixel_layout(rs_format format)
+                {
+                    switch(format)
+                    {
+                        case rs_format::RS_FORMAT_RGB8: return {3, 0, 1, 2, -1};
+                        case rs_format::RS_FORMAT_BGR8: return {3, 2, 1, 0, -1};
+                        case rs_format::RS_FORMAT_RGBA8: return {4, 0, 1, 2, 3};
+                        case rs_format::RS_FORMAT_BGRA8: return {4, 2, 1, 0, 3};
+                        default: return {0, 0, 0, 0, -1};
+                    }
+                }
+
+                inline uint8_t clamp(int value)
+                {
+                    return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+                }
+
+                uint32_t planes_size(uint32_t width, uint32_t height)
+                {
+                    return width * height + 2 * ((width + 1) / 2) * ((height + 1) / 2);
+                }
+            }
+
+            yuv420_codec::yuv420_codec()
+            {
+
+            }
+
+            yuv420_codec::~yuv420_codec(void)
+            {
+                LOG_FUNC_SCOPE();
+            }
+
+            bool yuv420_codec::is_format_supported(rs_format format)
+            {
+                return get_pixel_layout(format).bytes_per_pixel != 0;
+            }
+
+            status yuv420_codec::encode(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size)
+            {
+                LOG_FUNC_SCOPE();
+                output_size = 0;
+                if (!input)
+                {
+                    LOG_ERROR("input data is null");
+                    return status::status_process_failed;
+                }
+                auto layout = get_pixel_layout(info.format);
+                if(layout.bytes_per_pixel == 0 || info.width <= 0 || info.height <= 0)
+                    return status::status_param_unsupported;
+
+                uint32_t width = static_cast<uint32_t>(info.width);
+                uint32_t height = static_cast<uint32_t>(info.height);
+                uint32_t chroma_width = (width + 1) / 2;
+                uint32_t chroma_height = (height + 1) / 2;
+                m_planes.resize(planes_size(width, height));
+                uint8_t * y_plane = m_planes.data();
+                uint8_t * cb_plane = y_plane + width * height;
+                uint8_t * cr_plane = cb_plane + chroma_width * chroma_height;
+
+                //BT.601 full range, fixed point with 8 fraction bits
+                for(uint32_t cy = 0; cy < chroma_height; cy++)
+                {
+                    for(uint32_t cx = 0; cx < chroma_width; cx++)
+                    {
+                        int sum_r = 0, sum_g = 0, sum_b = 0, count = 0;
+                        for(uint32_t y = cy * 2; y < cy * 2 + 2 && y < height; y++)
+                        {
+                            for(uint32_t x = cx * 2; x < cx * 2 + 2 && x < width; x++)
+                            {
+                                const uint8_t * pixel = input + y * info.stride + x * layout.bytes_per_pixel;
+                                int r = pixel[layout.red], g = pixel[layout.green], b = pixel[layout.blue];
+                                y_plane[y * width + x] = clamp((77 * r + 150 * g + 29 * b + 128) >> 8);
+                                sum_r += r; sum_g += g; sum_b += b; count++;
+                            }
+                        }
+                        int r = sum_r / count, g = sum_g / count, b = sum_b / count;
+                        cb_plane[cy * chroma_width + cx] = clamp(((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128);
+                        cr_plane[cy * chroma_width + cx] = clamp(((128 * r - 107 * g - 21 * b + 128) >> 8) + 128);
+                    }
+                }
+
+                int input_size = static_cast<int>(info.stride * info.height);
+                int compressed_size = LZ4_compress_fast(reinterpret_cast<const char*>(m_planes.data()), reinterpret_cast<char*>(output),
+                                                        static_cast<int>(m_planes.size()), input_size, 0);
+                if(compressed_size <= 0 || compressed_size >= input_size)
+                {
+                    LOG_ERROR("failed to encode frame - " << info.number << ", stream - " << info.stream);
+                    return status::status_process_failed;
+                }
+                output_size = static_cast<uint32_t>(compressed_size);
+                return status::status_no_error;
+            }
+
+            std::shared_ptr<file_types::frame_sample> yuv420_codec::decode(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size)
+            {
+                LOG_FUNC_SCOPE();
+                auto & info = frame->finfo;
+                auto layout = get_pixel_layout(info.format);
+                if(layout.bytes_per_pixel == 0 || info.width <= 0 || info.height <= 0)
+                {
+                    LOG_ERROR("unsupported format - " << info.format << ", stream - " << info.stream);
+                    return nullptr;
+                }
+
+                uint32_t width = static_cast<uint32_t>(info.width);
+                uint32_t height = static_cast<uint32_t>(info.height);
+                uint32_t chroma_width = (width + 1) / 2;
+                m_planes.resize(planes_size(width, height));
+                auto read = LZ4_decompress_safe(reinterpret_cast<const char*>(input), reinterpret_cast<char*>(m_planes.data()),
+                                                static_cast<int>(input_size), static_cast<int>(m_planes.size()));
+                if(read != static_cast<int>(m_planes.size()))
+                {
+                    LOG_ERROR("failed to decode frame - " << info.number << ", stream - " << info.stream);
+                    return nullptr;
+                }
+                const uint8_t * y_plane = m_planes.data();
+                const uint8_t * cb_plane = y_plane + width * height;
+                const uint8_t * cr_plane = cb_plane + chroma_width * ((height + 1) / 2);
+
+                uint8_t * data = nullptr;
+                auto rv = m_frame_pool.acquire(frame, info.stride * info.height, data);
+                for(uint32_t y = 0; y < height; y++)
+                {
+                    uint8_t * row = data + y * info.stride;
+                    for(uint32_t x = 0; x < width; x++)
+                    {
+                        int luma = y_plane[y * width + x];
+                        int cb = cb_plane[(y / 2) * chroma_width + x / 2] - 128;
+                        int cr = cr_plane[(y / 2) * chroma_width + x / 2] - 128;
+                        uint8_t * pixel = row + x * layout.bytes_per_pixel;
+                        pixel[layout.red] = clamp(luma + ((359 * cr + 128) >> 8));
+                        pixel[layout.green] = clamp(luma - ((88 * cb + 183 * cr + 128) >> 8));
+                        pixel[layout.blue] = clamp(luma + ((454 * cb + 128) >> 8));
+                        if(layout.alpha >= 0)
+                            pixel[layout.alpha] = 255;
+                    }
+                }
+                return rv;
+            }
+        }
+    }
+}
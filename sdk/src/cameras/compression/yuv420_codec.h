@@ -0,0 +1,50 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include "codec_interface.h"
+#include "frame_pool.h"
+#include "rs/record/record_device.h"
+
+#ifdef WIN32 
+#ifdef realsense_compression_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_compression_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+        namespace compression
+        {
+            /**
+            * @brief Lossy codec for color images.
+            *
+            * The image is converted to planar YCbCr with 2x2 chroma subsampling (I420), the planes are compressed with LZ4.
+            * Supports rgb8, bgr8, rgba8 and bgra8 images, the alpha channel is not saved and is decoded as opaque.
+            */
+            class DLL_EXPORT yuv420_codec : public codec_interface
+            {
+            public:
+                yuv420_codec();
+                virtual ~yuv420_codec();
+
+                static bool is_format_supported(rs_format format);
+
+                virtual status encode(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size) override;
+                virtual std::shared_ptr<file_types::frame_sample> decode(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size) override;
+                virtual file_types::compression_type get_compression_type() override { return file_types::compression_type::yuv420; }
+
+            private:
+                std::vector<uint8_t>    m_planes;
+                frame_pool              m_frame_pool;
+            };
+        }
+    }
+}
@@ -0,0 +1,185 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "zstd_codec.h"
+#include "rs/utils/log_utils.h"
+#include "zstd.h"
+#include "zdict.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace compression
+        {
+            const uint32_t zstd_codec::TRAINING_SECONDS;
+            const uint32_t zstd_codec::MAX_TRAINING_SIZE;
+            const uint32_t zstd_codec::TRAINING_SAMPLE_SIZE;
+            const uint32_t zstd_codec::MAX_DICTIONARY_SIZE;
+
+            namespace
+            {
+                const uint32_t DICTIONARY_ID = 1;
+
+                std::vector<uint8_t> train_dictionary(std::vector<uint8_t> samples, std::vector<size_t> samples_sizes)
+                {
+                    std::vector<uint8_t> dictionary(zstd_codec::MAX_DICTIONARY_SIZE);
+                    auto size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), samples.data(), samples_sizes.data(), static_cast<unsigned>(samples_sizes.size()));
+                    if(ZDICT_isError(size))
+                    {
+                        LOG_WARN("failed to train dictionary - " << ZDICT_getErrorName(size));
+                        return std::vector<uint8_t>();
+                    }
+                    dictionary.resize(size);
+                    return dictionary;
+                }
+            }
+
+            zstd_codec::zstd_codec() : zstd_codec(record::compression_level::high)
+            {
+
+            }
+
+            zstd_codec::zstd_codec(record::compression_level compression_level) :
+                m_compression_level(ZSTD_CLEVEL_DEFAULT), m_compression_context(ZSTD_createCCtx()), m_decompression_context(ZSTD_createDCtx()),
+                m_compression_dictionary(nullptr), m_decompression_dictionary(nullptr), m_training_frames(0), m_is_training_started(false)
+            {
+                switch (compression_level)
+                {
+                    case record::compression_level::low: m_compression_level = 1; break;
+                    case record::compression_level::medium:  m_compression_level = 3; break;
+                    case record::compression_level::high: m_compression_level = 9; break;
+                    default: m_compression_level = 9; break;
+                }
+                ZSTD_CCtx_setParameter(m_compression_context, ZSTD_c_compressionLevel, m_compression_level);
+                //fails if zstd was built without multithreading, the frames are then compressed on the encoder worker thread
+                if(ZSTD_isError(ZSTD_CCtx_setParameter(m_compression_context, ZSTD_c_nbWorkers, COMPRESSION_WORKERS)))
+                    LOG_INFO("zstd multithreaded compression is not available");
+            }
+
+            zstd_codec::~zstd_codec(void)
+            {
+                LOG_FUNC_SCOPE();
+                if(m_training.valid())
+                    m_training.wait();
+                ZSTD_freeCDict(m_compression_dictionary);
+                ZSTD_freeDDict(m_decompression_dictionary);
+                ZSTD_freeCCtx(m_compression_context);
+                ZSTD_freeDCtx(m_decompression_context);
+            }
+
+            void zstd_codec::collect_training_sample(const file_types::frame_info &info, const uint8_t * input, uint32_t input_size)
+            {
+                uint32_t training_frames = std::max(1u, static_cast<uint32_t>(std::max(0, info.framerate)) * TRAINING_SECONDS);
+                for(uint32_t offset = 0; offset < input_size && m_training_data.size() < MAX_TRAINING_SIZE; offset += TRAINING_SAMPLE_SIZE)
+                {
+                    uint32_t size = std::min(TRAINING_SAMPLE_SIZE, input_size - offset);
+                    m_training_data.insert(m_training_data.end(), input + offset, input + offset + size);
+                    m_training_sizes.push_back(size);
+                }
+                if(++m_training_frames < training_frames && m_training_data.size() < MAX_TRAINING_SIZE)
+                    return;
+
+                //the training takes longer than a frame time, the frames are compressed without the dictionary until it's ready
+                m_is_training_started = true;
+                m_training = std::async(std::launch::async, train_dictionary, std::move(m_training_data), std::move(m_training_sizes));
+                m_training_data = std::vector<uint8_t>();
+                m_training_sizes = std::vector<size_t>();
+            }
+
+            void zstd_codec::adopt_trained_dictionary()
+            {
+                if(!m_training.valid() || m_training.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                    return;
+                auto dictionary = m_training.get();
+                if(dictionary.empty())
+                    return;
+                m_compression_dictionary = ZSTD_createCDict(dictionary.data(), dictionary.size(), m_compression_level);
+                if(m_compression_dictionary)
+                {
+                    m_dictionary = std::move(dictionary);
+                    LOG_INFO("dictionary trained, size - " << m_dictionary.size());
+                }
+            }
+
+            bool zstd_codec::get_dictionary(std::vector<uint8_t> & dictionary)
+            {
+                if(!m_compression_dictionary)
+                    return false;
+                dictionary = m_dictionary;
+                return true;
+            }
+
+            void zstd_codec::set_dictionary(const std::vector<uint8_t> & dictionary)
+            {
+                ZSTD_freeDDict(m_decompression_dictionary);
+                m_decompression_dictionary = dictionary.empty() ? nullptr : ZSTD_createDDict(dictionary.data(), dictionary.size());
+            }
+
+            status zstd_codec::encode(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size)
+            {
+                LOG_FUNC_SCOPE();
+                output_size = 0;
+                if (!input)
+                {
+                    LOG_ERROR("input data is null");
+                    return status::status_process_failed;
+                }
+                uint32_t input_size = info.stride * info.height;
+                if(input_size <= sizeof(frame_header) || !m_compression_context)
+                    return status::status_param_unsupported;
+
+                if(!m_is_training_started)
+                    collect_training_sample(info, input, input_size);
+                else if(!m_compression_dictionary)
+                    adopt_trained_dictionary();
+
+                frame_header header = {};
+                header.dictionary_id = m_compression_dictionary ? DICTIONARY_ID : 0;
+                ZSTD_CCtx_reset(m_compression_context, ZSTD_reset_session_only);
+                ZSTD_CCtx_refCDict(m_compression_context, m_compression_dictionary);
+                //the output is limited to the input size, a larger output is recorded uncompressed
+                auto compressed_size = ZSTD_compress2(m_compression_context, output + sizeof(header), input_size - sizeof(header), input, input_size);
+                if(ZSTD_isError(compressed_size))
+                {
+                    LOG_VERBOSE("frame doesn't compress - " << info.number << ", stream - " << info.stream);
+                    return status::status_value_out_of_range;
+                }
+
+                memcpy(output, &header, sizeof(header));
+                output_size = static_cast<uint32_t>(sizeof(header) + compressed_size);
+                return status::status_no_error;
+            }
+
+            std::shared_ptr<file_types::frame_sample> zstd_codec::decode(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size)
+            {
+                LOG_FUNC_SCOPE();
+                if(input_size < sizeof(frame_header) || !m_decompression_context)
+                    return nullptr;
+                frame_header header = {};
+                memcpy(&header, input, sizeof(header));
+                if(header.dictionary_id != 0 && !m_decompression_dictionary)
+                {
+                    LOG_ERROR("dictionary is not available, frame - " << frame->finfo.number << ", stream - " << frame->finfo.stream);
+                    return nullptr;
+                }
+
+                size_t frame_size = frame->finfo.stride * frame->finfo.height;
+                uint8_t * data = nullptr;
+                auto rv = m_frame_pool.acquire(frame, frame_size, data);
+                auto decompressed_size = header.dictionary_id != 0 ?
+                            ZSTD_decompress_usingDDict(m_decompression_context, data, frame_size, input + sizeof(header), input_size - sizeof(header), m_decompression_dictionary) :
+                            ZSTD_decompressDCtx(m_decompression_context, data, frame_size, input + sizeof(header), input_size - sizeof(header));
+                if(ZSTD_isError(decompressed_size) || decompressed_size != frame_size)
+                {
+                    LOG_ERROR("failed to decode frame - " << frame->finfo.number << ", stream - " << frame->finfo.stream);
+                    return nullptr;
+                }
+                return rv;
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <future>
+#include <vector>
+#include "codec_interface.h"
+#include "frame_pool.h"
+#include "rs/record/record_device.h"
+
+#ifdef WIN32 
+#ifdef realsense_compression_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_compression_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace rs
+{
+    namespace core
+    {
+        namespace compression
+        {
+            /**
+            * @brief Lossless zstd codec with a dictionary trained from the stream.
+            *
+            * The frames of the first TRAINING_SECONDS of the stream are compressed without a dictionary and collected as training samples.
+            * The dictionary is trained on a background thread, and the following frames are compressed with it once it's ready.
+            * The recorder stores the dictionary in the file, and the playback sets it to the decoding codec before the first frame is decoded.
+            * Available when the SDK is built with zstd.
+            */
+            class DLL_EXPORT zstd_codec : public codec_interface
+            {
+            public:
+                struct frame_header
+                {
+                    uint32_t dictionary_id;     //0 for frames compressed without the dictionary
+                    uint32_t reserved;
+                };
+
+                static const uint32_t TRAINING_SECONDS = 2;
+                static const uint32_t MAX_TRAINING_SIZE = 4 * 1024 * 1024;
+                static const uint32_t TRAINING_SAMPLE_SIZE = 4 * 1024;
+                static const uint32_t MAX_DICTIONARY_SIZE = 64 * 1024;
+                //zstd compresses a large frame on multiple threads, smaller frames use a single thread
+                static const int COMPRESSION_WORKERS = 2;
+
+                zstd_codec();
+                zstd_codec(record::compression_level compression_level);
+                virtual ~zstd_codec();
+
+                virtual status encode(file_types::frame_info &info, const uint8_t * input, uint8_t * output, uint32_t &output_size) override;
+                virtual std::shared_ptr<file_types::frame_sample> decode(std::shared_ptr<file_types::frame_sample> frame, const uint8_t * input, uint32_t input_size) override;
+                virtual file_types::compression_type get_compression_type() override { return file_types::compression_type::zstd; }
+                virtual bool get_dictionary(std::vector<uint8_t> & dictionary) override;
+                virtual void set_dictionary(const std::vector<uint8_t> & dictionary) override;
+
+            private:
+                void collect_training_sample(const file_types::frame_info &info, const uint8_t * input, uint32_t input_size);
+                void adopt_trained_dictionary();
+
+                int                                 m_compression_level;
+                ZSTD_CCtx_s *                       m_compression_context;
+                ZSTD_DCtx_s *                       m_decompression_context;
+                ZSTD_CDict_s *                      m_compression_dictionary;
+                ZSTD_DDict_s *                      m_decompression_dictionary;
+                std::vector<uint8_t>                m_dictionary;
+                std::vector<uint8_t>                m_training_data;
+                std::vector<size_t>                 m_training_sizes;
+                uint32_t                            m_training_frames;
+                bool                                m_is_training_started;
+                std::future<std::vector<uint8_t>>   m_training;
+                frame_pool                          m_frame_pool;
+            };
+        }
+    }
+}
@@ -0,0 +1,105 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief CRC32C (Castagnoli) of the recording chunks.
+        *
+        * Builds with SSE4.2 or the ARMv8 CRC extension use the crc32 instructions, which checksum 8 bytes per cycle, so the checksum
+        * costs less than the copy of the data to the write buffer. Other builds use a slicing by 8 table implementation.
+        * The crc is updated over consecutive buffers, starting from 0.
+        */
+        class crc32c
+        {
+        public:
+            static uint32_t update(uint32_t crc, const void * data, size_t size)
+            {
+                auto bytes = static_cast<const uint8_t*>(data);
+                uint32_t value = ~crc;
+#if defined(__SSE4_2__) || defined(__ARM_FEATURE_CRC32)
+                for(; size > 0 && (reinterpret_cast<uintptr_t>(bytes) & 7) != 0; size--)
+                    value = crc_byte(value, *bytes++);
+                uint64_t value64 = value;
+                for(; size >= 8; size -= 8, bytes += 8)
+                {
+                    uint64_t word;
+                    memcpy(&word, bytes, sizeof(word));
+#if defined(__SSE4_2__)
+                    value64 = _mm_crc32_u64(value64, word);
+#else
+                    value64 = __crc32cd(static_cast<uint32_t>(value64), word);
+#endif
+                }
+                value = static_cast<uint32_t>(value64);
+                for(; size > 0; size--)
+                    value = crc_byte(value, *bytes++);
+#else
+                const table_type & t = table();
+                for(; size >= 8; size -= 8, bytes += 8)
+                {
+                    //little endian words, the first 4 bytes are folded into the crc
+                    uint32_t low = value ^ (bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<uint32_t>(bytes[3]) << 24);
+                    value = t[7][low & 0xff] ^ t[6][(low >> 8) & 0xff] ^ t[5][(low >> 16) & 0xff] ^ t[4][low >> 24] ^
+                            t[3][bytes[4]] ^ t[2][bytes[5]] ^ t[1][bytes[6]] ^ t[0][bytes[7]];
+                }
+                for(; size > 0; size--)
+                    value = (value >> 8) ^ t[0][(value ^ *bytes++) & 0xff];
+#endif
+                return ~value;
+            }
+
+        private:
+            static const uint32_t POLYNOMIAL = 0x82f63b78; //reflected Castagnoli polynomial
+
+            typedef uint32_t table_type[8][256];
+
+            static const table_type & table()
+            {
+                struct tables
+                {
+                    table_type t;
+                    tables()
+                    {
+                        for(uint32_t i = 0; i < 256; i++)
+                        {
+                            uint32_t value = i;
+                            for(int bit = 0; bit < 8; bit++)
+                                value = (value >> 1) ^ (POLYNOMIAL & (0u - (value & 1)));
+                            t[0][i] = value;
+                        }
+                        for(uint32_t i = 0; i < 256; i++)
+                            for(int slice = 1; slice < 8; slice++)
+                                t[slice][i] = (t[slice - 1][i] >> 8) ^ t[0][t[slice - 1][i] & 0xff];
+                    }
+                };
+                static const tables rv;
+                return rv.t;
+            }
+
+            static uint32_t crc_byte(uint32_t value, uint8_t byte)
+            {
+#if defined(__SSE4_2__)
+                return _mm_crc32_u8(value, byte);
+#elif defined(__ARM_FEATURE_CRC32)
+                return __crc32cb(value, byte);
+#else
+                return (value >> 8) ^ table()[0][(value ^ byte) & 0xff];
+#endif
+            }
+        };
+    }
+}
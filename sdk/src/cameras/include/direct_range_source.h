@@ -0,0 +1,136 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <cstring>
+#include <cstdlib>
+#include <stdint.h>
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+#include "range_file.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Range source of a local file which is read with direct io, bypassing the page cache.
+        *
+        * A batch job which reads a large recording once fills the page cache with data it won't read again, evicting the cached files
+        * of the other processes of the host, and its read latency depends on what the cache holds. The ranges are read by O_DIRECT reads
+        * of aligned offsets and sizes into aligned buffers, which are pooled and reused, and are copied to the blocks of the range file.
+        * The kernel read ahead doesn't apply to direct io, the range file reads ahead the blocks of the samples index hints and of
+        * sequential reads. On platforms and file systems without direct io open fails, and the caller should fall back to another file.
+        */
+        class direct_range_source : public range_source
+        {
+            struct aligned_free
+            {
+                void operator()(uint8_t * buffer) const { free(buffer); }
+            };
+            typedef std::unique_ptr<uint8_t, aligned_free> aligned_buffer;
+
+        public:
+            static const uint32_t ALIGNMENT = 4096;                 //the logical block size of the common disks and file systems
+            static const uint32_t BUFFER_SIZE = range_file::BLOCK_SIZE + ALIGNMENT;
+            static const uint32_t MAX_POOLED_BUFFERS = range_file::MAX_FETCHED_BLOCKS + range_file::SEQUENTIAL_READ_AHEAD_BLOCKS;
+
+            direct_range_source() : m_fd(-1), m_size(0) {}
+
+            virtual ~direct_range_source()
+            {
+#ifndef WIN32
+                if(m_fd >= 0)
+                    ::close(m_fd);
+#endif
+            }
+
+            virtual status open(const std::string& location) override
+            {
+#if !defined(WIN32) && defined(O_DIRECT)
+                m_fd = ::open(location.c_str(), O_RDONLY | O_DIRECT);
+                if(m_fd < 0)
+                    return status_file_open_failed;
+                struct stat file_stat = {};
+                if(fstat(m_fd, &file_stat) != 0 || file_stat.st_size <= 0)
+                    return status_file_open_failed;
+                m_size = static_cast<uint64_t>(file_stat.st_size);
+                return status_no_error;
+#else
+                return status_file_open_failed;
+#endif
+            }
+
+            virtual uint64_t query_size() override { return m_size; }
+
+            virtual status read_range(uint64_t offset, uint8_t * data, uint32_t number_of_bytes) override
+            {
+#ifndef WIN32
+                //the range is read from its aligned start to its aligned end, the read of the file end is shorter
+                auto aligned_offset = offset - offset % ALIGNMENT;
+                auto head_size = static_cast<uint32_t>(offset - aligned_offset);
+                auto aligned_size = (head_size + number_of_bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+                auto buffer = acquire_buffer(aligned_size);
+                if(!buffer)
+                    return status_file_read_failed;
+                uint32_t bytes_read = 0;
+                while(bytes_read < head_size + number_of_bytes)
+                {
+                    auto rv = pread(m_fd, buffer.get() + bytes_read, aligned_size - bytes_read, static_cast<off_t>(aligned_offset + bytes_read));
+                    if(rv <= 0)
+                        break;
+                    bytes_read += static_cast<uint32_t>(rv);
+                }
+                auto is_complete = bytes_read >= head_size + number_of_bytes;
+                if(is_complete)
+                    memcpy(data, buffer.get() + head_size, number_of_bytes);
+                release_buffer(std::move(buffer), aligned_size);
+                return is_complete ? status_no_error : status_file_read_failed;
+#else
+                return status_file_read_failed;
+#endif
+            }
+
+        private:
+            //the blocks of the range file fit the pooled buffers, a larger range allocates a buffer of its own
+            aligned_buffer acquire_buffer(uint32_t size)
+            {
+                if(size <= BUFFER_SIZE)
+                {
+                    std::lock_guard<std::mutex> guard(m_mutex);
+                    if(!m_buffers.empty())
+                    {
+                        auto buffer = std::move(m_buffers.back());
+                        m_buffers.pop_back();
+                        return buffer;
+                    }
+                }
+                void * buffer = nullptr;
+#ifndef WIN32
+                if(posix_memalign(&buffer, ALIGNMENT, size > BUFFER_SIZE ? size : BUFFER_SIZE) != 0)
+                    buffer = nullptr;
+#endif
+                return aligned_buffer(static_cast<uint8_t*>(buffer));
+            }
+
+            void release_buffer(aligned_buffer buffer, uint32_t size)
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                if(size <= BUFFER_SIZE && m_buffers.size() < MAX_POOLED_BUFFERS)
+                    m_buffers.push_back(std::move(buffer));
+            }
+
+            int                         m_fd;
+            uint64_t                    m_size;
+            std::mutex                  m_mutex;
+            std::vector<aligned_buffer> m_buffers; //free buffers of BUFFER_SIZE bytes
+        };
+    }
+}
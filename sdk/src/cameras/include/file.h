@@ -4,6 +4,8 @@
 #pragma once
 #include <string>
 #include <fstream>
+#include <vector>
+#include <algorithm>
 #include <stdint.h>
 #include "status.h"
 
@@ -24,6 +26,13 @@ namespace rs
             end = 2,
         };
 
+        //a buffer of a gathered write
+        struct file_buffer
+        {
+            const void*     data;
+            unsigned int    size;
+        };
+
         class file
         {
         public:
@@ -58,7 +67,7 @@ namespace rs
             template<typename T>
             status read_to_object(T & data, const uint32_t data_size = sizeof(T))
             {
-                if(!m_file || data_size > sizeof(T))
+                if(!is_good() || data_size > sizeof(T))
                     return status_file_read_failed;
                 uint32_t num_bytes_read = 0;
                 uint32_t num_bytes_to_read = static_cast<uint32_t>(std::min(static_cast<uint32_t>(sizeof(data)), data_size));
@@ -78,7 +87,7 @@ namespace rs
             template<typename T>
             status read_to_partial_object_array(std::vector<T> & data, const uint32_t data_size)
             {
-                if(!m_file || data_size % sizeof(T) != 0)
+                if(!is_good() || data_size % sizeof(T) != 0)
                     return status_file_read_failed;
 
                 core::status sts = core::status::status_no_error;
@@ -99,6 +108,21 @@ namespace rs
                 return m_file ? status_no_error : status_file_write_failed;
             }
 
+            //writes the buffers in order, a file which can gather them writes them with a single system call
+            virtual status write_buffers(const file_buffer* buffers, unsigned int count, unsigned int& number_of_bytes_written)
+            {
+                number_of_bytes_written = 0;
+                for(unsigned int i = 0; i < count; i++)
+                {
+                    unsigned int bytes_written = 0;
+                    auto sts = write_bytes(buffers[i].data, buffers[i].size, bytes_written);
+                    number_of_bytes_written += bytes_written;
+                    if(sts != status_no_error)
+                        return sts;
+                }
+                return status_no_error;
+            }
+
             virtual status set_position(int64_t distance_to_move, core::move_method method, uint64_t* new_file_pointer = NULL)
             {
                 switch(method)
@@ -117,13 +141,27 @@ namespace rs
                 return m_file && new_file_pointer != NULL ? status_no_error : status_file_read_failed;
             }
 
+            virtual status flush()
+            {
+                m_file.flush();
+                return m_file ? status_no_error : status_file_write_failed;
+            }
+
+            //hints that the range is read soon, a file which can fetch it in the background does so
+            virtual void read_ahead(uint64_t offset, uint64_t number_of_bytes) {}
+
             virtual void reset()
             {
                 m_file.clear();
                 m_file.seekp(0, std::ios::beg);
             }
 
-            ~file()
+            virtual bool is_good()
+            {
+                return static_cast<bool>(m_file);
+            }
+
+            virtual ~file()
             {
                 m_file.close();
             }
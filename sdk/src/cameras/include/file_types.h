@@ -3,7 +3,9 @@
 
 #pragma once
 #include <map>
+#include <string>
 #include <memory>
+#include <stdexcept>
 #include <librealsense/rs.hpp>
 #include "rs/playback/playback_device.h"
 
@@ -47,15 +49,28 @@ namespace rs
                 h264 = 1,
                 lzo = 2,
                 lz4 = 3,
+                delta = 4,
+                yuv420 = 5,
+                lz4_striped = 6,
+                rvl = 7,
+                zstd = 8,
+                lz4_stream = 9,
                 compression_type_invalid_value = -1
             };
 
+            //the frames of a temporal compression are decoded with the previous frames of the stream, from the last keyframe
+            inline bool is_temporal_compression(compression_type ctype)
+            {
+                return ctype == compression_type::delta || ctype == compression_type::lz4_stream;
+            }
+
             enum sample_type
             {
                 st_image,
                 st_motion,
                 st_time,
-                st_debug_event
+                st_debug_event,
+                st_motion_block     //a block of motion and time stamp samples, expanded to its samples by the playback
             };
 
             enum chunk_id
@@ -73,7 +88,20 @@ namespace rs
                 chunk_sample_info       = 11,//sample type, capture time, offset
                 chunk_capabilities      = 12,
                 chunk_motion_intrinsics = 13,
-                chunk_camera_info       = 14
+                chunk_camera_info       = 14,
+                chunk_seek_table        = 15,//keyframes of streams with temporal compression, written at the end of the file
+                chunk_motion_block      = 16,//motion and time stamp samples of a motion block sample, in capture order
+                chunk_stream_trailer    = 17,//frames count of each stream, written at the end of a streamed recording
+                chunk_codec_dictionaries = 18,//dictionaries the codecs learned from their streams, written at the end of the file before the seek table
+                chunk_frame_metadata    = 19,//mask of the frame metadata values followed by the values, replaces the chunk_image_metadata pairs
+                chunk_stripes           = 20,//paths of the stripe files, which hold the image data of the striped streams
+                chunk_striped_sample_data = 21,//reference to the chunk_sample_data of a frame in a stripe file, replaces the chunk_sample_data
+                chunk_sample_checksum   = 22,//crc32c of the chunks of the sample, from its sample info chunk up to the checksum chunk
+                chunk_preview_frame     = 23,//downscaled and compressed copy of a frame, written after the frame sample, see disk_format::preview_frame
+                chunk_sample_bundle     = 24,//index entries of the samples of a time window, written before the chunks of the samples, see disk_format::sample_bundle
+                chunk_motion_columns    = 25,//motion or time stamp samples of a source in columns, written besides the motion samples, see disk_format::motion_columns
+                chunk_motion_columns_index = 26,//time ranges and offsets of the motion columns chunks, written at the end of the file before the codec dictionaries
+                chunk_repeated_sample_data = 27 //reference to an earlier frame of the stream whose data the frame repeats, replaces the chunk_sample_data, see disk_format::repeated_sample_data
             };
 
             struct device_cap
@@ -185,6 +213,33 @@ namespace rs
                 rs_motion_data   data;
             };
 
+            //a motion or time stamp sample of a motion block
+            struct motion_block_entry
+            {
+                sample_type type;
+                uint64_t    capture_time;
+                union
+                {
+                    rs_motion_data      motion;
+                    rs_timestamp_data   time_stamp;
+                } data;
+            };
+
+            /**
+            * @brief A block of motion and time stamp samples, recorded with a single allocation and written as a single chunk.
+            *
+            * The block capture time is the capture time of its first sample.
+            */
+            struct motion_block_sample : public sample
+            {
+                static const uint32_t max_entries = 32;
+
+                motion_block_sample(uint64_t capture_time) : sample::sample(sample_type::st_motion_block, capture_time, 0), count(0) {}
+                bool is_full() const { return count == max_entries; }
+                uint32_t            count;
+                motion_block_entry  entries[max_entries];
+            };
+
             struct frame_info
             {
                 int                 width;
@@ -202,6 +257,36 @@ namespace rs
                 compression_type    ctype; //compression procedure might fail, in that case the recorder writes uncompressed image, this member indicates what is the actual compression type.
             };
 
+            //the metadata values of a frame, stored inline so that copying a frame sample doesn't allocate
+            struct frame_metadata_set
+            {
+                static const int MAX_METADATA_COUNT = 16;
+
+                frame_metadata_set() : mask(0) {}
+                bool empty() const { return mask == 0; }
+                bool supports(rs_frame_metadata id) const
+                {
+                    return id >= 0 && id < MAX_METADATA_COUNT && (mask & (1u << id)) != 0;
+                }
+                double get(rs_frame_metadata id) const
+                {
+                    if(!supports(id))
+                        throw std::out_of_range("frame metadata is not available");
+                    return values[id];
+                }
+                void set(rs_frame_metadata id, double value)
+                {
+                    if(id < 0 || id >= MAX_METADATA_COUNT)
+                        return;
+                    mask |= 1u << id;
+                    values[id] = value;
+                }
+
+                uint32_t    mask;
+                double      values[MAX_METADATA_COUNT];
+            };
+            static_assert(RS_FRAME_METADATA_COUNT <= frame_metadata_set::MAX_METADATA_COUNT, "the frame metadata mask is too small");
+
             struct frame_sample : public sample
             {
                 frame_sample(const frame_sample * frame) : sample::sample(frame->info), finfo(frame->finfo), metadata(frame->metadata), data(nullptr) {}
@@ -230,7 +315,7 @@ namespace rs
                         rs_frame_metadata md = static_cast<rs_frame_metadata>(i);
                         if(ref->supports_frame_metadata(md))
                         {
-                              metadata[md] = ref->get_frame_metadata(md);
+                              metadata.set(md, ref->get_frame_metadata(md));
                         }
                     }
                 }
@@ -255,7 +340,7 @@ namespace rs
                         rs_frame_metadata md = static_cast<rs_frame_metadata>(i);
                         if(si.supports_frame_metadata(md))
                         {
-                              metadata[md] = si.get_frame_metadata(md);
+                              metadata.set(md, si.get_frame_metadata(md));
                         }
                     }
                 }
@@ -272,7 +357,7 @@ namespace rs
                 virtual ~frame_sample() {}
                 frame_info      finfo;
                 const uint8_t * data;
-                std::map<rs_frame_metadata, double> metadata;
+                frame_metadata_set metadata;
             };
 
             struct stream_profile
@@ -294,6 +379,12 @@ namespace rs
                 stream_profile      profile;
             };
 
+            /** The samples index is written by the recorder to a file next to the recording */
+            inline std::string samples_index_path(const std::string & file_path)
+            {
+                return file_path + ".rssdk.idx";
+            }
+
             struct file_header
             {
                 int32_t                         id;                     // File identifier
@@ -356,6 +447,12 @@ namespace rs
                     int32_t                 reserved[24];
                 };
 
+                struct motion_block_entry
+                {
+                    file_types::motion_block_entry  data;
+                    int32_t                         reserved[4];
+                };
+
                 struct motion_intrinsics
                 {
                     rs_motion_intrinsics    data;
@@ -367,6 +464,167 @@ namespace rs
                     file_types::debug_data data;
                     int32_t                reserved[10];
                 };
+
+                struct seek_table_entry
+                {
+                    rs_stream   stream;
+                    uint32_t    frame_index;        //index of the keyframe in the stream
+                    uint64_t    offset;             //sample info offset
+                    int32_t     reserved[2];
+                };
+
+                //followed by the values of the set bits, in bits order
+                struct frame_metadata_header
+                {
+                    uint32_t    mask;
+                    int32_t     reserved;
+                };
+
+                //an entry of the chunk_image_metadata chunk, written without the frame metadata format extension
+                struct frame_metadata_pair
+                {
+                    rs_frame_metadata   id;
+                    double              value;
+                };
+
+                struct stream_trailer_entry
+                {
+                    rs_stream   stream;
+                    int32_t     nframes;
+                    int32_t     reserved[2];
+                };
+
+                //last bytes of the seek table chunk, allows to locate the chunk from the end of the file
+                struct seek_table_footer
+                {
+                    uint64_t    chunk_offset;
+                    int32_t     id;                 // UID('R','S','S','T')
+                    int32_t     reserved;
+                };
+
+                //followed by the null terminated path of the stripe file
+                struct stripe_entry
+                {
+                    uint32_t    stripe;
+                    uint32_t    path_size;          //including the null terminator
+                    int32_t     reserved[2];
+                };
+
+                struct sample_checksum
+                {
+                    uint32_t    crc;                //crc32c of the size bytes which precede the checksum chunk
+                    uint32_t    size;
+                    int32_t     reserved[2];
+                };
+
+                //followed by the image data of the preview, compressed as the ctype of the frame info
+                struct preview_frame
+                {
+                    file_types::frame_info  data;               //the preview size, and the number and the index in stream of the full frame
+                    uint64_t                capture_time;
+                    uint32_t                scale;              //the full frame size divided by the preview size
+                    uint32_t                size;               //size of the image data
+                    int32_t                 reserved[6];
+                };
+
+                struct striped_sample_data
+                {
+                    uint32_t    stripe;
+                    uint32_t    size;               //size of the chunk_sample_data chunk in the stripe file, including its chunk info
+                    uint64_t    offset;             //offset of the chunk_sample_data chunk in the stripe file
+                    int32_t     reserved[4];
+                };
+
+                //the frame didn't change since the referenced frame, its data is the data chunk of the referenced frame
+                struct repeated_sample_data
+                {
+                    uint32_t    frame_index;        //index in stream of the referenced frame, which precedes the frame and isn't repeated itself
+                    int32_t     reserved[7];
+                };
+
+                //followed by the dictionary bytes
+                struct codec_dictionary_entry
+                {
+                    rs_stream   stream;
+                    uint32_t    size;
+                    int32_t     reserved[2];
+                };
+
+                //last bytes of the codec dictionaries chunk, which is followed by the seek table chunk, if there is one
+                struct codec_dictionaries_footer
+                {
+                    uint64_t    chunk_offset;
+                    int32_t     id;                 // UID('R','S','C','D')
+                    int32_t     reserved;
+                };
+
+                struct samples_index_header
+                {
+                    int32_t     id;                 // UID('R','S','I','X')
+                    int32_t     version;
+                    int32_t     completed;          // set when the recording was closed, an incomplete index is ignored
+                    uint64_t    recording_size;     // size of the indexed recording, used to detect a stale index
+                    uint64_t    samples_count;
+                    uint64_t    checkpoint_position;// recording size covered by the samples of an index which wasn't completed
+                    int32_t     reserved[8];
+                };
+
+                //followed by the index entries of the bundle samples, the chunks of the samples follow the bundle chunk
+                struct sample_bundle
+                {
+                    uint32_t    samples_count;      //index entries in the bundle chunk, the samples of a motion block have an entry each
+                    uint32_t    samples_size;       //size of the samples chunks which follow the bundle chunk
+                    uint64_t    start_time;         //capture time of the first sample
+                    int32_t     reserved[4];
+                };
+
+                //followed by the capture times, the time stamps and the frame numbers columns, and by a column of each axis of a motion source
+                struct motion_columns
+                {
+                    rs_event_source source;
+                    uint32_t        count;              //samples in each column
+                    uint32_t        axes_count;         //3 for a motion source, 0 for a time stamp source
+                    int32_t         reserved1;
+                    uint64_t        start_time;         //capture time of the first sample
+                    uint64_t        end_time;           //capture time of the last sample
+                    int32_t         reserved[4];
+                };
+
+                struct motion_columns_index_entry
+                {
+                    rs_event_source source;
+                    uint32_t        count;
+                    uint64_t        start_time;
+                    uint64_t        end_time;
+                    uint64_t        offset;             //offset of the motion columns chunk
+                    int32_t         reserved[2];
+                };
+
+                //last bytes of the motion columns index chunk, which is followed by the codec dictionaries chunk, the seek table chunk or the end of file
+                struct motion_columns_index_footer
+                {
+                    uint64_t    chunk_offset;
+                    int32_t     id;                 // UID('R','S','M','C')
+                    int32_t     reserved;
+                };
+
+                //a single sample descriptor, holds all the data required to play the sample except the frame buffer
+                struct sample_index_entry
+                {
+                    file_types::sample_info info;
+                    union
+                    {
+                        file_types::frame_info          frame;
+                        rs_motion_data                  motion;
+                        rs_timestamp_data               time_stamp;
+                        struct
+                        {
+                            debug_event_type            type;
+                            file_types::debug_data      data;
+                        } debug_event;
+                    } data;
+                    int32_t                 reserved[4];
+                };
             };
         }
     }
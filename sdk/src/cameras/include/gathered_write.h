@@ -0,0 +1,70 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+#include "file.h"
+
+#ifndef WIN32
+#include <sys/types.h>
+#include <sys/uio.h>
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+#ifndef WIN32
+        /**
+        * @brief Writes the buffers of a gathered write to a descriptor with vector writes.
+        *
+        * Up to MAX_GATHERED_BUFFERS buffers are written by each vector write, a write which stops in the middle of the buffers is
+        * resumed from where it stopped. The vector write is writev, or an equivalent of a descriptor which needs other write flags.
+        * Returns false if a vector write fails, the bytes written before the failure are counted.
+        */
+        template<typename vector_write_function>
+        bool write_gathered(const file_buffer* buffers, unsigned int count, unsigned int& number_of_bytes_written, vector_write_function vector_write)
+        {
+            static const int MAX_GATHERED_BUFFERS = 16;
+            number_of_bytes_written = 0;
+            iovec vectors[MAX_GATHERED_BUFFERS];
+            unsigned int next_buffer = 0;
+            while(next_buffer < count)
+            {
+                //empty buffers are skipped, a vector write of empty buffers writes nothing and can't be told from a failure
+                int vectors_count = 0;
+                for(; next_buffer < count && vectors_count < MAX_GATHERED_BUFFERS; next_buffer++)
+                {
+                    if(buffers[next_buffer].size == 0)
+                        continue;
+                    vectors[vectors_count].iov_base = const_cast<void*>(buffers[next_buffer].data);
+                    vectors[vectors_count].iov_len = buffers[next_buffer].size;
+                    vectors_count++;
+                }
+
+                iovec* pending = vectors;
+                while(vectors_count > 0)
+                {
+                    ssize_t result = vector_write(pending, vectors_count);
+                    if(result <= 0)
+                        return false;
+                    number_of_bytes_written += static_cast<unsigned int>(result);
+                    size_t written = static_cast<size_t>(result);
+                    while(vectors_count > 0 && written >= pending->iov_len)
+                    {
+                        written -= pending->iov_len;
+                        pending++;
+                        vectors_count--;
+                    }
+                    if(vectors_count > 0)
+                    {
+                        pending->iov_base = static_cast<uint8_t*>(pending->iov_base) + written;
+                        pending->iov_len -= written;
+                    }
+                }
+            }
+            return true;
+        }
+#endif
+    }
+}
@@ -0,0 +1,214 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <stdint.h>
+#include "range_file.h"
+
+#ifndef WIN32
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Range source over plain HTTP, the ranges are fetched with range requests.
+        *
+        * The location is an http://host[:port]/path URL, the server must support range requests.
+        * Each range is fetched on its own connection, so concurrent reads don't share state. A range fails if the server doesn't answer
+        * within the request timeout, or answers with another range or a chunked body.
+        */
+        class http_range_source : public range_source
+        {
+        public:
+            static bool is_http_location(const std::string& location)
+            {
+                return location.compare(0, strlen(http_prefix()), http_prefix()) == 0;
+            }
+
+            http_range_source() : m_size(0) {}
+
+            virtual status open(const std::string& location) override
+            {
+                if(!parse_location(location))
+                    return status_file_open_failed;
+                std::string headers;
+                uint8_t first_byte = 0;
+                if(request_range(0, &first_byte, 1, headers) != status_no_error)
+                    return status_file_open_failed;
+                //Content-Range: bytes 0-0/<file size>
+                auto content_range = find_header(headers, "content-range");
+                auto size_position = content_range.find('/');
+                if(size_position == std::string::npos)
+                    return status_file_open_failed;
+                m_size = strtoull(content_range.c_str() + size_position + 1, nullptr, 10);
+                return m_size > 0 ? status_no_error : status_file_open_failed;
+            }
+
+            virtual uint64_t query_size() override { return m_size; }
+
+            virtual status read_range(uint64_t offset, uint8_t * data, uint32_t number_of_bytes) override
+            {
+                std::string headers;
+                return request_range(offset, data, number_of_bytes, headers);
+            }
+
+        private:
+            static const int REQUEST_TIMEOUT_SECONDS = 10;  //of each connect, send and receive
+            static const size_t MAX_HEADERS_SIZE = 16 * 1024;
+
+            static const char * http_prefix() { return "http://"; }
+
+            bool parse_location(const std::string& location)
+            {
+                if(!is_http_location(location))
+                    return false;
+                auto host_start = strlen(http_prefix());
+                auto path_start = location.find('/', host_start);
+                auto host = location.substr(host_start, path_start == std::string::npos ? std::string::npos : path_start - host_start);
+                m_path = path_start == std::string::npos ? "/" : location.substr(path_start);
+                auto port_start = host.find(':');
+                m_port = port_start == std::string::npos ? "80" : host.substr(port_start + 1);
+                m_host = host.substr(0, port_start);
+                return !m_host.empty() && !m_port.empty();
+            }
+
+            static std::string find_header(const std::string& headers, const std::string& name)
+            {
+                std::string lower_headers(headers);
+                for(auto & c : lower_headers)
+                    c = static_cast<char>(tolower(c));
+                auto position = lower_headers.find("\r\n" + name + ":");
+                if(position == std::string::npos)
+                    return "";
+                auto value_start = position + name.size() + 3;
+                auto value_end = headers.find("\r\n", value_start);
+                return headers.substr(value_start, value_end == std::string::npos ? std::string::npos : value_end - value_start);
+            }
+
+            //Content-Range: bytes <first>-<last>/<file size>, the range must be the requested one
+            static bool is_requested_range(const std::string& headers, uint64_t offset, uint32_t number_of_bytes)
+            {
+                auto content_range = find_header(headers, "content-range");
+                auto range_start = content_range.find("bytes ");
+                if(range_start == std::string::npos)
+                    return false;
+                char * range_end = nullptr;
+                uint64_t first = strtoull(content_range.c_str() + range_start + 6, &range_end, 10);
+                if(*range_end != '-')
+                    return false;
+                uint64_t last = strtoull(range_end + 1, nullptr, 10);
+                return first == offset && last == offset + number_of_bytes - 1;
+            }
+
+#ifndef WIN32
+            status request_range(uint64_t offset, uint8_t * data, uint32_t number_of_bytes, std::string& headers)
+            {
+                if(number_of_bytes == 0)
+                    return status_no_error;
+                addrinfo hints = {};
+                hints.ai_family = AF_UNSPEC;
+                hints.ai_socktype = SOCK_STREAM;
+                addrinfo * addresses = nullptr;
+                if(getaddrinfo(m_host.c_str(), m_port.c_str(), &hints, &addresses) != 0)
+                    return status_file_read_failed;
+                //the send timeout also limits the connect
+                timeval timeout = {};
+                timeout.tv_sec = REQUEST_TIMEOUT_SECONDS;
+                int socket_fd = -1;
+                for(auto address = addresses; address && socket_fd < 0; address = address->ai_next)
+                {
+                    socket_fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+                    if(socket_fd >= 0 && (setsockopt(socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0 ||
+                                          setsockopt(socket_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) != 0 ||
+                                          connect(socket_fd, address->ai_addr, address->ai_addrlen) != 0))
+                    {
+                        ::close(socket_fd);
+                        socket_fd = -1;
+                    }
+                }
+                freeaddrinfo(addresses);
+                if(socket_fd < 0)
+                    return status_file_read_failed;
+
+                auto sts = exchange(socket_fd, offset, data, number_of_bytes, headers);
+                ::close(socket_fd);
+                return sts;
+            }
+
+            status exchange(int socket_fd, uint64_t offset, uint8_t * data, uint32_t number_of_bytes, std::string& headers)
+            {
+                std::string request = "GET " + m_path + " HTTP/1.1\r\n" +
+                                      "Host: " + m_host + "\r\n" +
+                                      "Range: bytes=" + std::to_string(offset) + "-" + std::to_string(offset + number_of_bytes - 1) + "\r\n" +
+                                      "Connection: close\r\n\r\n";
+                for(size_t sent = 0; sent < request.size();)
+                {
+                    auto result = send(socket_fd, request.data() + sent, request.size() - sent, 0);
+                    if(result <= 0)
+                        return status_file_read_failed;
+                    sent += static_cast<size_t>(result);
+                }
+
+                //the headers and the beginning of the body may arrive together
+                char buffer[4096];
+                size_t headers_end = std::string::npos;
+                while(headers_end == std::string::npos)
+                {
+                    if(headers.size() > MAX_HEADERS_SIZE)
+                        return status_file_read_failed;
+                    auto result = recv(socket_fd, buffer, sizeof(buffer), 0);
+                    if(result <= 0)
+                        return status_file_read_failed;
+                    headers.append(buffer, static_cast<size_t>(result));
+                    headers_end = headers.find("\r\n\r\n");
+                }
+                std::string body = headers.substr(headers_end + 4);
+                headers.resize(headers_end + 2);
+
+                //a server which ignores the range returns the whole file with 200
+                if(headers.compare(0, 9, "HTTP/1.1 ") != 0 && headers.compare(0, 9, "HTTP/1.0 ") != 0)
+                    return status_file_read_failed;
+                if(headers.compare(9, 3, "206") != 0)
+                    return status_file_read_failed;
+                //the body is read as the raw bytes of the range
+                auto transfer_encoding = find_header(headers, "transfer-encoding");
+                for(auto & c : transfer_encoding)
+                    c = static_cast<char>(tolower(c));
+                if(!is_requested_range(headers, offset, number_of_bytes) || transfer_encoding.find("chunked") != std::string::npos)
+                    return status_file_read_failed;
+
+                uint32_t received = static_cast<uint32_t>(std::min<size_t>(body.size(), number_of_bytes));
+                memcpy(data, body.data(), received);
+                while(received < number_of_bytes)
+                {
+                    auto result = recv(socket_fd, data + received, number_of_bytes - received, 0);
+                    if(result <= 0)
+                        return status_file_read_failed;
+                    received += static_cast<uint32_t>(result);
+                }
+                return status_no_error;
+            }
+#else
+            status request_range(uint64_t offset, uint8_t * data, uint32_t number_of_bytes, std::string& headers)
+            {
+                return status_feature_unsupported;
+            }
+#endif
+
+            std::string m_host;
+            std::string m_port;
+            std::string m_path;
+            uint64_t    m_size;
+        };
+    }
+}
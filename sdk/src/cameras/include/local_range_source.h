@@ -0,0 +1,55 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <stdint.h>
+#include "range_file.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Range source of a local file, which lets a range file read a local file by large blocks.
+        *
+        * The range file reads the blocks on background threads, so a sequential reader of small objects, such as the samples
+        * indexing, reads the file by a few large reads ahead of its position, instead of a read and a seek per object.
+        * The ranges are read one at a time, the blocks of a local file are read in order at the disk sequential speed.
+        */
+        class local_range_source : public range_source
+        {
+        public:
+            local_range_source() : m_size(0) {}
+
+            virtual status open(const std::string& location) override
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                m_file.open(location, std::ios::in | std::ios::binary);
+                if(!m_file.is_open())
+                    return status_file_open_failed;
+                m_file.seekg(0, std::ios::end);
+                m_size = static_cast<uint64_t>(m_file.tellg());
+                return m_file && m_size > 0 ? status_no_error : status_file_open_failed;
+            }
+
+            virtual uint64_t query_size() override { return m_size; }
+
+            virtual status read_range(uint64_t offset, uint8_t * data, uint32_t number_of_bytes) override
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                m_file.clear();
+                m_file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+                m_file.read(reinterpret_cast<char*>(data), number_of_bytes);
+                return m_file ? status_no_error : status_file_read_failed;
+            }
+
+        private:
+            std::mutex      m_mutex;
+            std::ifstream   m_file;
+            uint64_t        m_size;
+        };
+    }
+}
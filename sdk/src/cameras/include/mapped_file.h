@@ -0,0 +1,198 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <string>
+#include <memory>
+#include <cstring>
+#include <algorithm>
+#include <stdint.h>
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "file.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Read only file which is mapped to the process address space.
+        *
+        * read_bytes copies directly from the mapped region, avoiding the fstream buffering.
+        * map_bytes provides a zero copy access to the file content, the returned pointer keeps the mapping
+        * alive, so the data can be handed to the application after the file was closed.
+        * On platforms where memory mapping is not available open fails, and the caller should fall back to core::file.
+        */
+        class mapped_file : public file
+        {
+            struct region
+            {
+                region(uint8_t * data, uint64_t size) : data(data), size(size) {}
+                ~region()
+                {
+#ifndef WIN32
+                    if(data != nullptr)
+                        munmap(data, size);
+#endif
+                }
+                uint8_t *   data;
+                uint64_t    size;
+            };
+
+        public:
+            mapped_file() : m_position(0), m_is_good(false) {}
+
+            virtual status open(const std::string& filename, open_file_option mode) override
+            {
+                close();
+                if(mode != open_file_option::read)
+                    return status_file_open_failed;
+#ifndef WIN32
+                int fd = ::open(filename.c_str(), O_RDONLY);
+                if(fd < 0)
+                    return status_file_open_failed;
+                struct stat file_stat = {};
+                if(fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0)
+                {
+                    ::close(fd);
+                    return status_file_open_failed;
+                }
+                auto size = static_cast<uint64_t>(file_stat.st_size);
+                void * data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                //the mapping stays valid after the descriptor is closed
+                ::close(fd);
+                if(data == MAP_FAILED)
+                    return status_file_open_failed;
+                madvise(data, size, MADV_SEQUENTIAL);
+                m_region = std::make_shared<region>(static_cast<uint8_t*>(data), size);
+                m_position = 0;
+                m_is_good = true;
+                return status_no_error;
+#else
+                return status_file_open_failed;
+#endif
+            }
+
+            virtual status close() override
+            {
+                m_region.reset();
+                m_position = 0;
+                m_is_good = false;
+                return status_no_error;
+            }
+
+            virtual status read_bytes(void* data, unsigned int number_of_bytes_to_read, unsigned int& number_of_bytes_read) override
+            {
+                number_of_bytes_read = 0;
+                if(!m_is_good || m_position + number_of_bytes_to_read > m_region->size)
+                {
+                    m_is_good = false;
+                    return status_file_read_failed;
+                }
+                memcpy(data, m_region->data + m_position, number_of_bytes_to_read);
+                m_position += number_of_bytes_to_read;
+                number_of_bytes_read = number_of_bytes_to_read;
+                return status_no_error;
+            }
+
+            /**
+            * @brief Returns a pointer to the requested number of bytes at the current position and advances the position.
+            *
+            * The returned pointer shares the mapping ownership, the data is valid as long as the pointer is alive.
+            * @param[in]  number_of_bytes_to_map    Requested number of bytes
+            * @param[out] number_of_bytes_mapped    Number of bytes available through the pointer
+            * @return Pointer to the mapped data, nullptr in case the requested range exceeds the file size.
+            */
+            std::shared_ptr<const uint8_t> map_bytes(unsigned int number_of_bytes_to_map, unsigned int& number_of_bytes_mapped)
+            {
+                number_of_bytes_mapped = 0;
+                if(!m_is_good || m_position + number_of_bytes_to_map > m_region->size)
+                {
+                    m_is_good = false;
+                    return nullptr;
+                }
+                //aliasing constructor - the pointer keeps the whole region alive
+                std::shared_ptr<const uint8_t> rv(m_region, m_region->data + m_position);
+                m_position += number_of_bytes_to_map;
+                number_of_bytes_mapped = number_of_bytes_to_map;
+                return rv;
+            }
+
+            /**
+            * @brief Asks the system to read the requested range of the file ahead, the call doesn't wait for the read.
+            *
+            * The mapping is read on demand, reading the pages of a frame ahead avoids page faults on the thread that accesses the frame.
+            * @param[in]  offset            Range start offset from the file beginning
+            * @param[in]  number_of_bytes   Range size
+            */
+            virtual void read_ahead(uint64_t offset, uint64_t number_of_bytes) override
+            {
+#ifndef WIN32
+                if(!m_region || offset >= m_region->size)
+                    return;
+                number_of_bytes = std::min(number_of_bytes, m_region->size - offset);
+                //madvise requires a page aligned address
+                static const uint64_t page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+                uint64_t aligned_offset = offset - offset % page_size;
+                madvise(m_region->data + aligned_offset, number_of_bytes + (offset - aligned_offset), MADV_WILLNEED);
+#endif
+            }
+
+            virtual status write_bytes(const void* data, unsigned int number_of_bytes_to_write, unsigned int& number_of_bytes_written) override
+            {
+                number_of_bytes_written = 0;
+                return status_file_write_failed;
+            }
+
+            virtual status set_position(int64_t distance_to_move, core::move_method method, uint64_t* new_file_pointer = NULL) override
+            {
+                if(!m_region)
+                    return status_file_read_failed;
+                int64_t position = 0;
+                switch(method)
+                {
+                    case move_method::begin: position = distance_to_move; break;
+                    case move_method::current: position = static_cast<int64_t>(m_position) + distance_to_move; break;
+                    case move_method::end: position = static_cast<int64_t>(m_region->size) + distance_to_move; break;
+                }
+                //same as fstream - seeking beyond the end is allowed, the next read fails
+                if(position < 0)
+                {
+                    m_is_good = false;
+                    return status_file_read_failed;
+                }
+                m_position = static_cast<uint64_t>(position);
+                if(new_file_pointer != NULL) *new_file_pointer = m_position;
+                return m_is_good ? status_no_error : status_file_read_failed;
+            }
+
+            virtual status get_position(uint64_t* new_file_pointer) override
+            {
+                if(new_file_pointer != NULL) *new_file_pointer = m_position;
+                return m_is_good && new_file_pointer != NULL ? status_no_error : status_file_read_failed;
+            }
+
+            virtual void reset() override
+            {
+                m_is_good = m_region != nullptr;
+                m_position = 0;
+            }
+
+            virtual bool is_good() override { return m_is_good; }
+
+            virtual ~mapped_file()
+            {
+                close();
+            }
+
+        private:
+            std::shared_ptr<region>     m_region;
+            uint64_t                    m_position;
+            bool                        m_is_good;
+        };
+    }
+}
@@ -0,0 +1,193 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <string>
+#include <stdint.h>
+#include "file.h"
+#include "gathered_write.h"
+
+#ifndef WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Write only file which reserves its disk space ahead of the writes, in extents of a fixed size.
+        *
+        * A file which grows write by write is fragmented on a busy volume, the reserved extents keep the recording contiguous, so it's
+        * written and later read sequentially. The extents are reserved beyond the end of the file, the file size is the written size at any time,
+        * and the unused part of the last extent is released on close. On file systems which can't reserve the space the file grows with the
+        * writes. On platforms where reserving the space is not available open fails, and the caller should fall back to core::file.
+        */
+        class preallocated_file : public file
+        {
+        public:
+            explicit preallocated_file(uint64_t extent_size) : m_fd(-1), m_extent_size(extent_size), m_reserved_size(0), m_size(0),
+                m_position(0), m_is_good(false) {}
+
+            virtual status open(const std::string& filename, open_file_option mode) override
+            {
+                close();
+#if defined(__linux__)
+                if(mode != open_file_option::write)
+                    return status_file_open_failed;
+                m_fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+                if(m_fd < 0)
+                    return status_file_open_failed;
+                m_is_good = true;
+                return status_no_error;
+#else
+                return status_feature_unsupported;
+#endif
+            }
+
+            virtual status close() override
+            {
+                status sts = status_no_error;
+#if defined(__linux__)
+                if(m_fd >= 0)
+                {
+                    //releases the reserved extents beyond the written size
+                    if(m_reserved_size > m_size && ftruncate(m_fd, static_cast<off_t>(m_size)) != 0)
+                        sts = status_file_close_failed;
+                    ::close(m_fd);
+                }
+#endif
+                m_fd = -1;
+                m_reserved_size = 0;
+                m_size = 0;
+                m_position = 0;
+                m_is_good = false;
+                return sts;
+            }
+
+            virtual status read_bytes(void* data, unsigned int number_of_bytes_to_read, unsigned int& number_of_bytes_read) override
+            {
+                number_of_bytes_read = 0;
+                return status_file_read_failed;
+            }
+
+            virtual status write_bytes(const void* data, unsigned int number_of_bytes_to_write, unsigned int& number_of_bytes_written) override
+            {
+                number_of_bytes_written = 0;
+                if(!m_is_good)
+                    return status_file_write_failed;
+#if defined(__linux__)
+                reserve(m_position + number_of_bytes_to_write);
+                auto bytes = static_cast<const uint8_t*>(data);
+                while(number_of_bytes_written < number_of_bytes_to_write)
+                {
+                    auto result = ::write(m_fd, bytes + number_of_bytes_written, number_of_bytes_to_write - number_of_bytes_written);
+                    if(result <= 0)
+                    {
+                        m_is_good = false;
+                        return status_file_write_failed;
+                    }
+                    number_of_bytes_written += static_cast<unsigned int>(result);
+                }
+                m_position += number_of_bytes_written;
+                m_size = m_position > m_size ? m_position : m_size;
+#endif
+                return status_no_error;
+            }
+
+            virtual status write_buffers(const file_buffer* buffers, unsigned int count, unsigned int& number_of_bytes_written) override
+            {
+                number_of_bytes_written = 0;
+                if(!m_is_good)
+                    return status_file_write_failed;
+#if defined(__linux__)
+                uint64_t size = 0;
+                for(unsigned int i = 0; i < count; i++)
+                    size += buffers[i].size;
+                reserve(m_position + size);
+                auto is_written = write_gathered(buffers, count, number_of_bytes_written,
+                                                 [this](const iovec* vectors, int vectors_count) { return ::writev(m_fd, vectors, vectors_count); });
+                m_position += number_of_bytes_written;
+                m_size = m_position > m_size ? m_position : m_size;
+                if(!is_written)
+                {
+                    m_is_good = false;
+                    return status_file_write_failed;
+                }
+#endif
+                return status_no_error;
+            }
+
+            //the writes aren't buffered
+            virtual status flush() override { return m_is_good ? status_no_error : status_file_write_failed; }
+
+            virtual status set_position(int64_t distance_to_move, core::move_method method, uint64_t* new_file_pointer = NULL) override
+            {
+                if(!m_is_good)
+                    return status_file_write_failed;
+#if defined(__linux__)
+                int whence = SEEK_SET;
+                switch(method)
+                {
+                    case move_method::begin: whence = SEEK_SET; break;
+                    case move_method::current: whence = SEEK_CUR; break;
+                    case move_method::end: whence = SEEK_END; break;
+                }
+                //the reserved extents are beyond the end of the file, so the end is the written size
+                auto position = lseek(m_fd, static_cast<off_t>(distance_to_move), whence);
+                if(position < 0)
+                {
+                    m_is_good = false;
+                    return status_file_write_failed;
+                }
+                m_position = static_cast<uint64_t>(position);
+#endif
+                if(new_file_pointer != NULL) *new_file_pointer = m_position;
+                return status_no_error;
+            }
+
+            virtual status get_position(uint64_t* new_file_pointer) override
+            {
+                if(new_file_pointer != NULL) *new_file_pointer = m_position;
+                return m_is_good && new_file_pointer != NULL ? status_no_error : status_file_write_failed;
+            }
+
+            virtual void reset() override {}
+
+            virtual bool is_good() override { return m_is_good; }
+
+            virtual ~preallocated_file()
+            {
+                close();
+            }
+
+        private:
+            //reserves the extents which cover the file up to the requested size, without changing the file size
+            void reserve(uint64_t size)
+            {
+#if defined(__linux__)
+                if(m_extent_size == 0 || size <= m_reserved_size)
+                    return;
+                uint64_t reserved_size = (size + m_extent_size - 1) / m_extent_size * m_extent_size;
+                if(fallocate(m_fd, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(m_reserved_size), static_cast<off_t>(reserved_size - m_reserved_size)) != 0)
+                {
+                    //the file system can't reserve the space, the file grows with the writes
+                    m_extent_size = 0;
+                    return;
+                }
+                m_reserved_size = reserved_size;
+#endif
+            }
+
+            int         m_fd;
+            uint64_t    m_extent_size;
+            uint64_t    m_reserved_size;
+            uint64_t    m_size;
+            uint64_t    m_position;
+            bool        m_is_good;
+        };
+    }
+}
@@ -0,0 +1,239 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <string>
+#include <memory>
+#include <vector>
+#include <map>
+#include <list>
+#include <future>
+#include <cstring>
+#include <algorithm>
+#include <stdint.h>
+#include "file.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Source of a read only file which is accessed by byte ranges, e.g. a file on a remote server.
+        *
+        * read_range may be called concurrently, the range file fetches several blocks at once.
+        */
+        class range_source
+        {
+        public:
+            virtual ~range_source() {}
+            virtual status open(const std::string& location) = 0;
+            virtual uint64_t query_size() = 0;
+            virtual status read_range(uint64_t offset, uint8_t * data, uint32_t number_of_bytes) = 0;
+        };
+
+        /**
+        * @brief Read only file over a range source, with a block cache.
+        *
+        * The file is fetched in fixed size blocks, the recently used blocks are cached. read_ahead fetches the blocks of
+        * the requested range in the background, so a reader which knows its next reads, e.g. from the samples index,
+        * doesn't wait for the source. A block miss also fetches the following blocks, for sequential reads without hints.
+        */
+        class range_file : public file
+        {
+            typedef std::shared_future<std::shared_ptr<std::vector<uint8_t>>> block_future;
+
+        public:
+            static const uint32_t BLOCK_SIZE = 1024 * 1024;
+            static const uint32_t MAX_CACHED_BLOCKS = 64;
+            static const uint32_t MAX_FETCHED_BLOCKS = 8;          //blocks which are fetched in the background at once
+            static const uint32_t SEQUENTIAL_READ_AHEAD_BLOCKS = 2;
+
+            range_file(std::unique_ptr<range_source> source) : m_source(std::move(source)), m_size(0), m_position(0), m_is_good(false) {}
+
+            virtual status open(const std::string& filename, open_file_option mode) override
+            {
+                close();
+                if(mode != open_file_option::read || !m_source)
+                    return status_file_open_failed;
+                auto sts = m_source->open(filename);
+                if(sts != status_no_error)
+                    return status_file_open_failed;
+                m_size = m_source->query_size();
+                m_is_good = true;
+                return status_no_error;
+            }
+
+            virtual status close() override
+            {
+                //the background fetches are waited for by the futures
+                m_blocks.clear();
+                m_recently_used.clear();
+                m_position = 0;
+                m_size = 0;
+                m_is_good = false;
+                return status_no_error;
+            }
+
+            virtual status read_bytes(void* data, unsigned int number_of_bytes_to_read, unsigned int& number_of_bytes_read) override
+            {
+                number_of_bytes_read = 0;
+                if(!m_is_good || m_position + number_of_bytes_to_read > m_size)
+                {
+                    m_is_good = false;
+                    return status_file_read_failed;
+                }
+                auto output = static_cast<uint8_t*>(data);
+                while(number_of_bytes_read < number_of_bytes_to_read)
+                {
+                    auto block_index = m_position / BLOCK_SIZE;
+                    auto block = get_block(block_index);
+                    if(!block)
+                    {
+                        m_is_good = false;
+                        return status_file_read_failed;
+                    }
+                    auto offset_in_block = static_cast<uint32_t>(m_position % BLOCK_SIZE);
+                    auto size = std::min<uint32_t>(static_cast<uint32_t>(block->size()) - offset_in_block, number_of_bytes_to_read - number_of_bytes_read);
+                    memcpy(output + number_of_bytes_read, block->data() + offset_in_block, size);
+                    number_of_bytes_read += size;
+                    m_position += size;
+                }
+                return status_no_error;
+            }
+
+            virtual void read_ahead(uint64_t offset, uint64_t number_of_bytes) override
+            {
+                if(!m_is_good || offset >= m_size)
+                    return;
+                auto last_block = (std::min(offset + number_of_bytes, m_size) - 1) / BLOCK_SIZE;
+                for(auto block_index = offset / BLOCK_SIZE; block_index <= last_block && count_fetched_blocks() < MAX_FETCHED_BLOCKS; block_index++)
+                    fetch_block(block_index);
+            }
+
+            virtual status write_bytes(const void* data, unsigned int number_of_bytes_to_write, unsigned int& number_of_bytes_written) override
+            {
+                number_of_bytes_written = 0;
+                return status_file_write_failed;
+            }
+
+            virtual status set_position(int64_t distance_to_move, core::move_method method, uint64_t* new_file_pointer = NULL) override
+            {
+                int64_t position = 0;
+                switch(method)
+                {
+                    case move_method::begin: position = distance_to_move; break;
+                    case move_method::current: position = static_cast<int64_t>(m_position) + distance_to_move; break;
+                    case move_method::end: position = static_cast<int64_t>(m_size) + distance_to_move; break;
+                }
+                //same as fstream - seeking beyond the end is allowed, the next read fails
+                if(position < 0)
+                {
+                    m_is_good = false;
+                    return status_file_read_failed;
+                }
+                m_position = static_cast<uint64_t>(position);
+                if(new_file_pointer != NULL) *new_file_pointer = m_position;
+                return m_is_good ? status_no_error : status_file_read_failed;
+            }
+
+            virtual status get_position(uint64_t* new_file_pointer) override
+            {
+                if(new_file_pointer != NULL) *new_file_pointer = m_position;
+                return m_is_good && new_file_pointer != NULL ? status_no_error : status_file_read_failed;
+            }
+
+            virtual void reset() override
+            {
+                m_is_good = m_size > 0;
+                m_position = 0;
+            }
+
+            virtual bool is_good() override { return m_is_good; }
+
+            virtual ~range_file()
+            {
+                close();
+            }
+
+        private:
+            void fetch_block(uint64_t block_index)
+            {
+                if(m_blocks.find(block_index) != m_blocks.end())
+                    return;
+                auto offset = block_index * BLOCK_SIZE;
+                auto size = static_cast<uint32_t>(std::min<uint64_t>(BLOCK_SIZE, m_size - offset));
+                auto source = m_source.get();
+                m_blocks[block_index] = std::async(std::launch::async, [source, offset, size]()
+                {
+                    auto block = std::make_shared<std::vector<uint8_t>>(size);
+                    if(source->read_range(offset, block->data(), size) != status_no_error)
+                        block.reset();
+                    return block;
+                }).share();
+                m_recently_used.push_front(block_index);
+                evict_blocks();
+            }
+
+            std::shared_ptr<std::vector<uint8_t>> get_block(uint64_t block_index)
+            {
+                auto block = m_blocks.find(block_index);
+                if(block == m_blocks.end())
+                {
+                    fetch_block(block_index);
+                    block = m_blocks.find(block_index);
+                }
+                else
+                {
+                    m_recently_used.remove(block_index);
+                    m_recently_used.push_front(block_index);
+                }
+                auto future = block->second;
+                if(future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                {
+                    //a missed block, the following blocks are fetched while waiting
+                    for(uint64_t next = block_index + 1; next <= block_index + SEQUENTIAL_READ_AHEAD_BLOCKS && next * BLOCK_SIZE < m_size; next++)
+                        fetch_block(next);
+                }
+                auto data = future.get();
+                //a failed fetch isn't cached, the next read retries
+                if(!data && m_blocks.erase(block_index) > 0)
+                    m_recently_used.remove(block_index);
+                return data;
+            }
+
+            uint32_t count_fetched_blocks()
+            {
+                uint32_t count = 0;
+                for(auto & block : m_blocks)
+                {
+                    if(block.second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                        count++;
+                }
+                return count;
+            }
+
+            //blocks which are still fetched aren't evicted
+            void evict_blocks()
+            {
+                for(auto it = m_recently_used.rbegin(); m_blocks.size() > MAX_CACHED_BLOCKS && it != m_recently_used.rend();)
+                {
+                    auto block = m_blocks.find(*it);
+                    if(block->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                    {
+                        ++it;
+                        continue;
+                    }
+                    m_blocks.erase(block);
+                    it = std::list<uint64_t>::reverse_iterator(m_recently_used.erase(std::next(it).base()));
+                }
+            }
+
+            std::unique_ptr<range_source>       m_source;
+            std::map<uint64_t, block_future>    m_blocks;
+            std::list<uint64_t>                 m_recently_used; //blocks indices, most recently used first
+            uint64_t                            m_size;
+            uint64_t                            m_position;
+            bool                                m_is_good;
+        };
+    }
+}
@@ -0,0 +1,80 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Bounded lock free queue for a single producer thread and a single consumer thread.
+        *
+        * The elements storage is allocated once, in the constructor. push fails when the queue is full,
+        * the caller decides whether to drop the element or retry.
+        * push and high_watermark may be called only from the producer thread, pop only from the consumer thread,
+        * size and empty are safe to call from both.
+        */
+        template<typename T>
+        class spsc_queue
+        {
+        public:
+            explicit spsc_queue(size_t capacity) : m_buffer(capacity + 1), m_head(0), m_tail(0), m_high_watermark(0) {}
+
+            bool push(T item)
+            {
+                auto tail = m_tail.load(std::memory_order_relaxed);
+                auto next = increment(tail);
+                auto head = m_head.load(std::memory_order_acquire);
+                if(next == head)
+                    return false;
+                m_buffer[tail] = std::move(item);
+                m_tail.store(next, std::memory_order_release);
+
+                auto depth = distance(head, next);
+                if(depth > m_high_watermark.load(std::memory_order_relaxed))
+                    m_high_watermark.store(depth, std::memory_order_relaxed);
+                return true;
+            }
+
+            bool pop(T & item)
+            {
+                auto head = m_head.load(std::memory_order_relaxed);
+                if(head == m_tail.load(std::memory_order_acquire))
+                    return false;
+                item = std::move(m_buffer[head]);
+                //release the element content before the slot is handed back to the producer
+                m_buffer[head] = T();
+                m_head.store(increment(head), std::memory_order_release);
+                return true;
+            }
+
+            size_t size() const
+            {
+                return distance(m_head.load(std::memory_order_acquire), m_tail.load(std::memory_order_acquire));
+            }
+
+            bool empty() const { return size() == 0; }
+
+            size_t capacity() const { return m_buffer.size() - 1; }
+
+            /** @brief Returns the maximal number of elements which were queued at once since the queue was created. */
+            size_t high_watermark() const { return m_high_watermark.load(std::memory_order_relaxed); }
+
+        private:
+            spsc_queue(const spsc_queue&) = delete;
+            spsc_queue& operator=(const spsc_queue&) = delete;
+
+            size_t increment(size_t index) const { return index + 1 == m_buffer.size() ? 0 : index + 1; }
+            size_t distance(size_t head, size_t tail) const { return tail >= head ? tail - head : tail + m_buffer.size() - head; }
+
+            std::vector<T>          m_buffer;
+            std::atomic<size_t>     m_head;             //next element to pop, owned by the consumer
+            std::atomic<size_t>     m_tail;             //next free slot, owned by the producer
+            std::atomic<size_t>     m_high_watermark;
+        };
+    }
+}
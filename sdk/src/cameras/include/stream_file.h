@@ -0,0 +1,248 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <stdint.h>
+#include "file.h"
+#include "gathered_write.h"
+
+#ifndef WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <pthread.h>
+#include <time.h>
+#include <netdb.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Write only sink which can't seek, a TCP connection or a named pipe.
+        *
+        * A tcp://host:port location connects to a receiver, any other location must be an existing named pipe.
+        * The position is the number of bytes written, moving the position fails, so the writer must produce the file in order.
+        */
+        class stream_file : public file
+        {
+        public:
+            static bool is_stream_location(const std::string& location)
+            {
+                if(location.compare(0, strlen(tcp_prefix()), tcp_prefix()) == 0)
+                    return true;
+#ifndef WIN32
+                struct stat location_stat = {};
+                return stat(location.c_str(), &location_stat) == 0 && S_ISFIFO(location_stat.st_mode);
+#else
+                return false;
+#endif
+            }
+
+            stream_file() : m_fd(-1), m_is_socket(false), m_position(0), m_is_good(false) {}
+
+            virtual status open(const std::string& filename, open_file_option mode) override
+            {
+                close();
+#ifndef WIN32
+                if(mode != open_file_option::write)
+                    return status_file_open_failed;
+                m_is_socket = filename.compare(0, strlen(tcp_prefix()), tcp_prefix()) == 0;
+                m_fd = m_is_socket ? connect_to(filename.substr(strlen(tcp_prefix()))) : ::open(filename.c_str(), O_WRONLY);
+                if(m_fd < 0)
+                    return status_file_open_failed;
+                m_is_good = true;
+                return status_no_error;
+#else
+                return status_feature_unsupported;
+#endif
+            }
+
+            virtual status close() override
+            {
+#ifndef WIN32
+                if(m_fd >= 0)
+                    ::close(m_fd);
+#endif
+                m_fd = -1;
+                m_position = 0;
+                m_is_good = false;
+                return status_no_error;
+            }
+
+            virtual status read_bytes(void* data, unsigned int number_of_bytes_to_read, unsigned int& number_of_bytes_read) override
+            {
+                number_of_bytes_read = 0;
+                return status_file_read_failed;
+            }
+
+            virtual status write_bytes(const void* data, unsigned int number_of_bytes_to_write, unsigned int& number_of_bytes_written) override
+            {
+                number_of_bytes_written = 0;
+                if(!m_is_good)
+                    return status_file_write_failed;
+#ifndef WIN32
+                auto bytes = static_cast<const uint8_t*>(data);
+                //a receiver which went away fails the write with EPIPE instead of raising SIGPIPE
+                sigpipe_guard guard(!m_is_socket);
+                while(number_of_bytes_written < number_of_bytes_to_write)
+                {
+                    auto result = m_is_socket ? send(m_fd, bytes + number_of_bytes_written, number_of_bytes_to_write - number_of_bytes_written, MSG_NOSIGNAL) :
+                                                ::write(m_fd, bytes + number_of_bytes_written, number_of_bytes_to_write - number_of_bytes_written);
+                    if(result < 0 && errno == EINTR)
+                        continue;
+                    if(result <= 0)
+                    {
+                        m_is_good = false;
+                        return status_file_write_failed;
+                    }
+                    number_of_bytes_written += static_cast<unsigned int>(result);
+                }
+                m_position += number_of_bytes_written;
+#endif
+                return status_no_error;
+            }
+
+            virtual status write_buffers(const file_buffer* buffers, unsigned int count, unsigned int& number_of_bytes_written) override
+            {
+                number_of_bytes_written = 0;
+                if(!m_is_good)
+                    return status_file_write_failed;
+#ifndef WIN32
+                sigpipe_guard guard(!m_is_socket);
+                auto is_written = write_gathered(buffers, count, number_of_bytes_written, [this](const iovec* vectors, int vectors_count)
+                {
+                    if(!m_is_socket)
+                        return ::writev(m_fd, vectors, vectors_count);
+                    msghdr message = {};
+                    message.msg_iov = const_cast<iovec*>(vectors);
+                    message.msg_iovlen = vectors_count;
+                    return sendmsg(m_fd, &message, MSG_NOSIGNAL);
+                });
+                m_position += number_of_bytes_written;
+                if(!is_written)
+                {
+                    m_is_good = false;
+                    return status_file_write_failed;
+                }
+#endif
+                return status_no_error;
+            }
+
+            //the writes aren't buffered
+            virtual status flush() override { return m_is_good ? status_no_error : status_file_write_failed; }
+
+            virtual status set_position(int64_t distance_to_move, core::move_method method, uint64_t* new_file_pointer = NULL) override
+            {
+                if(new_file_pointer != NULL) *new_file_pointer = m_position;
+                return status_file_write_failed;
+            }
+
+            virtual status get_position(uint64_t* new_file_pointer) override
+            {
+                if(new_file_pointer != NULL) *new_file_pointer = m_position;
+                return m_is_good && new_file_pointer != NULL ? status_no_error : status_file_write_failed;
+            }
+
+            virtual void reset() override {}
+
+            virtual bool is_good() override { return m_is_good; }
+
+            virtual ~stream_file()
+            {
+                close();
+            }
+
+        private:
+            static const char * tcp_prefix() { return "tcp://"; }
+
+#ifndef WIN32
+            /**
+            * @brief Blocks SIGPIPE on the calling thread while a named pipe is written, so a reader which went away fails the write with
+            * EPIPE. A SIGPIPE the write raised is consumed before the signal mask is restored, a SIGPIPE which was already pending is kept.
+            */
+            class sigpipe_guard
+            {
+            public:
+                explicit sigpipe_guard(bool is_enabled) : m_is_enabled(is_enabled), m_was_pending(false)
+                {
+                    if(!m_is_enabled)
+                        return;
+                    sigemptyset(&m_sigpipe);
+                    sigaddset(&m_sigpipe, SIGPIPE);
+                    sigset_t pending;
+                    sigemptyset(&pending);
+                    sigpending(&pending);
+                    m_was_pending = sigismember(&pending, SIGPIPE) == 1;
+                    pthread_sigmask(SIG_BLOCK, &m_sigpipe, &m_previous_mask);
+                }
+
+                ~sigpipe_guard()
+                {
+                    if(!m_is_enabled)
+                        return;
+                    if(!m_was_pending)
+                    {
+                        sigset_t pending;
+                        sigemptyset(&pending);
+                        sigpending(&pending);
+                        if(sigismember(&pending, SIGPIPE) == 1)
+                        {
+                            timespec no_wait = {};
+                            while(sigtimedwait(&m_sigpipe, nullptr, &no_wait) < 0 && errno == EINTR) {}
+                        }
+                    }
+                    pthread_sigmask(SIG_SETMASK, &m_previous_mask, nullptr);
+                }
+            private:
+                sigpipe_guard(const sigpipe_guard &) = delete;
+                sigpipe_guard & operator=(const sigpipe_guard &) = delete;
+                bool m_is_enabled;
+                bool m_was_pending;
+                sigset_t m_sigpipe;
+                sigset_t m_previous_mask;
+            };
+
+            static int connect_to(const std::string& address)
+            {
+                auto port_start = address.rfind(':');
+                if(port_start == std::string::npos)
+                    return -1;
+                auto host = address.substr(0, port_start);
+                auto port = address.substr(port_start + 1);
+                addrinfo hints = {};
+                hints.ai_family = AF_UNSPEC;
+                hints.ai_socktype = SOCK_STREAM;
+                addrinfo * addresses = nullptr;
+                if(getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0)
+                    return -1;
+                int socket_fd = -1;
+                for(auto it = addresses; it && socket_fd < 0; it = it->ai_next)
+                {
+                    socket_fd = socket(it->ai_family, it->ai_socktype, it->ai_protocol);
+                    if(socket_fd >= 0 && connect(socket_fd, it->ai_addr, it->ai_addrlen) != 0)
+                    {
+                        ::close(socket_fd);
+                        socket_fd = -1;
+                    }
+                }
+                freeaddrinfo(addresses);
+                return socket_fd;
+            }
+#endif
+
+            int         m_fd;
+            bool        m_is_socket;
+            uint64_t    m_position;
+            bool        m_is_good;
+        };
+    }
+}
@@ -1,9 +1,14 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <limits>
+#include <algorithm>
+#include <stddef.h>
 #include "disk_read.h"
 #include "include/file.h"
 #include "rs/utils/log_utils.h"
+#include "compression/delta_codec.h"
+#include "include/crc32c.h"
 
 using namespace rs::core;
 using namespace rs::core::file_types;
@@ -33,7 +38,8 @@ namespace rs
             {
                 chunk_info chunk = {};
                 data_read_status = m_file_data_read->read_to_object(chunk);
-                if (data_read_status != status::status_no_error || chunk.id == chunk_id::chunk_sample_info)
+                //the headers are followed by the first sample, or by the bundle of the first samples
+                if (data_read_status != status::status_no_error || chunk.id == chunk_id::chunk_sample_info || chunk.id == chunk_id::chunk_sample_bundle)
                     return data_read_status;
 
                 switch (chunk.id)
@@ -62,7 +68,7 @@ namespace rs
                         {
                             for(auto & caps : devcaps)
                             {
-                                m_properties[caps.label] = caps.value;
+                                m_properties.set(caps.label, caps.value);
                             }
                         }
                         LOG_INFO("read properties chunk " << (data_read_status == status::status_no_error ? "succeeded" : "failed"));
@@ -133,6 +139,28 @@ namespace rs
                         LOG_INFO("read device info chunk " << (data_read_status == status::status_no_error ? "succeeded" : "failed"));
                     }
                     break;
+                    case chunk_id::chunk_stripes:
+                    {
+                        std::vector<uint8_t> stripes(chunk.size);
+                        data_read_status = m_file_data_read->read_to_object_array(stripes);
+                        for(uint8_t* it = stripes.data(); data_read_status == status::status_no_error &&
+                            it + sizeof(disk_format::stripe_entry) <= stripes.data() + stripes.size(); )
+                        {
+                            auto entry = reinterpret_cast<disk_format::stripe_entry*>(it);
+                            it += sizeof(disk_format::stripe_entry);
+                            if(entry->path_size == 0 || it + entry->path_size > stripes.data() + stripes.size())
+                            {
+                                data_read_status = status::status_item_unavailable;
+                                break;
+                            }
+                            if(m_stripe_paths.size() <= entry->stripe)
+                                m_stripe_paths.resize(entry->stripe + 1);
+                            m_stripe_paths[entry->stripe] = std::string(reinterpret_cast<char*>(it), entry->path_size - 1);
+                            it += entry->path_size;
+                        }
+                        LOG_INFO("read stripes chunk " << (data_read_status == status::status_no_error ? "succeeded" : "failed"));
+                    }
+                    break;
                     default:
                     {
                         m_file_data_read->set_position(chunk.size, core::move_method::current);
@@ -186,8 +214,7 @@ namespace rs
                                     break;
                                 frame_info frame_info = fi.data;
                                 frame_info.index_in_stream = static_cast<uint32_t>(m_image_indices[frame_info.stream].size());
-                                m_image_indices[frame_info.stream].push_back(static_cast<uint32_t>(m_samples_desc.size()));
-                                m_samples_desc.push_back(std::make_shared<frame_sample>(frame_info, sample_info));
+                                m_image_indices[frame_info.stream].push_back(m_samples_desc.add_frame(frame_info, sample_info));
                                 ++index;
                                 LOG_VERBOSE("frame sample indexed, sample time - " << sample_info.capture_time)
                                 break;
@@ -199,7 +226,7 @@ namespace rs
                                 if (data_read_status != core::status_no_error)
                                     break;
                                 rs_motion_data motion_data = md.data;
-                                m_samples_desc.push_back(std::make_shared<motion_sample>(motion_data, sample_info));
+                                m_samples_desc.add_motion(motion_data, sample_info);
                                 ++index;
                                 LOG_VERBOSE("motion sample indexed, sample time - " << sample_info.capture_time)
                                 break;
@@ -211,28 +238,54 @@ namespace rs
                                 if (data_read_status != core::status_no_error)
                                     break;
                                 rs_timestamp_data time_stamp_data = tsd.data;
-                                m_samples_desc.push_back(std::make_shared<time_stamp_sample>(time_stamp_data, sample_info));
+                                m_samples_desc.add_time_stamp(time_stamp_data, sample_info);
                                 ++index;
                                 LOG_VERBOSE("time stamp sample indexed, sample time - " << sample_info.capture_time)
                                 break;
                             }
+                            case sample_type::st_motion_block:
+                            {
+                                if(chunk2.id != chunk_id::chunk_motion_block)
+                                {
+                                    m_file_indexing->set_position(chunk2.size, core::move_method::current);
+                                    break;
+                                }
+                                std::vector<disk_format::motion_block_entry> entries(chunk2.size / sizeof(disk_format::motion_block_entry));
+                                data_read_status = m_file_indexing->read_to_object_array(entries);
+                                if (data_read_status != core::status_no_error)
+                                    break;
+                                //the block samples share the offset of the block
+                                for(auto & entry : entries)
+                                {
+                                    auto entry_info = sample_info;
+                                    entry_info.type = entry.data.type;
+                                    entry_info.capture_time = entry.data.capture_time;
+                                    if(entry.data.type == sample_type::st_motion)
+                                        m_samples_desc.add_motion(entry.data.data.motion, entry_info);
+                                    else
+                                        m_samples_desc.add_time_stamp(entry.data.data.time_stamp, entry_info);
+                                }
+                                index += static_cast<uint32_t>(entries.size());
+                                LOG_VERBOSE("motion block indexed, samples count - " << entries.size() << " ,sample time - " << sample_info.capture_time)
+                                break;
+                            }
                             case sample_type::st_debug_event:
                             {
                                 debug_event_type event_type;
                                 data_read_status = m_file_indexing->read_to_object(event_type, sizeof(event_type));
                                 if (data_read_status != core::status_no_error)
                                     break;
-                                std::shared_ptr<file_types::debug_data> debug_data_ptr = nullptr;
+                                disk_format::debug_data debug_data {};
+                                bool has_debug_data = false;
                                 switch (event_type)
                                 {
                                     case debug_event_type::application_frame_drop:
                                     case debug_event_type::recorder_frame_drop:
                                     {
-                                        disk_format::debug_data debug_data {};
                                         data_read_status = m_file_indexing->read_to_object(debug_data);
                                         if (data_read_status != core::status_no_error)
                                             break;
-                                        debug_data_ptr = std::make_shared<file_types::debug_data>(debug_data.data);
+                                        has_debug_data = true;
                                     }
                                     break;
                                     case debug_event_type::pause_record: break;
@@ -240,7 +293,7 @@ namespace rs
                                 }
                                 if (data_read_status == core::status_no_error)
                                 {
-                                    m_samples_desc.push_back(std::make_shared<debug_event_sample>(event_type, sample_info, debug_data_ptr));
+                                    m_samples_desc.add_debug_event(event_type, sample_info, has_debug_data ? &debug_data.data : nullptr);
                                 }
                                 break;
                             }
@@ -249,6 +302,50 @@ namespace rs
                         }
                     }
                     break;
+                    case chunk_id::chunk_sample_bundle:
+                    {
+                        //the index entries of the bundle samples are read at once, the chunks of the samples are skipped
+                        disk_format::sample_bundle bundle = {};
+                        data_read_status = m_file_indexing->read_to_object(bundle);
+                        if (data_read_status != core::status_no_error)
+                            break;
+                        //a bundle of an unknown layout is skipped, the samples which follow it are indexed from their chunks
+                        if(chunk.size != sizeof(bundle) + static_cast<uint64_t>(bundle.samples_count) * sizeof(disk_format::sample_index_entry))
+                        {
+                            if(chunk.size > sizeof(bundle))
+                                m_file_indexing->set_position(chunk.size - sizeof(bundle), core::move_method::current);
+                            break;
+                        }
+                        std::vector<disk_format::sample_index_entry> entries(bundle.samples_count);
+                        data_read_status = m_file_indexing->read_to_object_array(entries);
+                        if (data_read_status != core::status_no_error)
+                            break;
+                        for(auto & entry : entries)
+                        {
+                            if(!add_indexed_sample(entry, m_samples_desc, m_image_indices))
+                                LOG_WARN("invalid sample bundle entry, sample time - " << entry.info.capture_time)
+                        }
+                        index += static_cast<uint32_t>(entries.size());
+                        m_file_indexing->set_position(bundle.samples_size, core::move_method::current);
+                        LOG_VERBOSE("sample bundle indexed, samples count - " << entries.size() << " ,sample time - " << bundle.start_time)
+                    }
+                    break;
+                    case chunk_id::chunk_stream_trailer:
+                    {
+                        //a streamed recording has the frames count of its streams at its end
+                        std::vector<disk_format::stream_trailer_entry> entries(chunk.size / sizeof(disk_format::stream_trailer_entry));
+                        data_read_status = m_file_indexing->read_to_object_array(entries);
+                        if (data_read_status != core::status_no_error)
+                            break;
+                        for(auto & entry : entries)
+                        {
+                            auto stream_info = m_streams_infos.find(entry.stream);
+                            if(stream_info != m_streams_infos.end() && stream_info->second.nframes == 0)
+                                stream_info->second.nframes = entry.nframes;
+                        }
+                        LOG_INFO("stream trailer indexed, number of streams - " << entries.size())
+                    }
+                    break;
                     default:
                     {
                         m_file_indexing->set_position(chunk.size, core::move_method::current);
@@ -259,31 +356,358 @@ namespace rs
             }
         }
 
-        int32_t disk_read::size_of_pitches(void)
+        status disk_read::extract(const std::string & file_path, uint64_t start_time, uint64_t end_time, const std::vector<rs_stream> & streams, bool include_motions)
         {
-            return 0;
+            LOG_FUNC_SCOPE();
+            if(!m_pause)
+                return status_invalid_state;
+            if(file_path == m_file_path || start_time >= end_time)
+                return status_invalid_argument;
+            //the clip copies the recording chunks, the image data of a striped recording is in its stripe files
+            if(!m_stripe_paths.empty())
+                return status_feature_unsupported;
+            for(auto stream : streams)
+            {
+                if(m_streams_infos.find(stream) == m_streams_infos.end())
+                    return status_invalid_argument;
+            }
+
+            while(!m_is_index_complete)
+                index_next_samples(std::numeric_limits<uint32_t>::max());
+
+            std::unique_ptr<file> source;
+            if(open_file_for_read(m_file_path, source) != status_no_error)
+                return status_file_open_failed;
+            file clip;
+            if(clip.open(file_path, open_file_option::write) != status_no_error)
+                return status_file_open_failed;
+
+            std::map<rs_stream, uint64_t> nframes_offsets;
+            auto sts = write_clip_headers(*source, clip, streams, nframes_offsets);
+            if(sts != status_no_error)
+                return sts;
+
+            //capture times are in microseconds, the clip capture times start at the beginning of the range
+            start_time *= 1000;
+            end_time *= 1000;
+            std::map<rs_stream, int32_t> nframes;
+            std::vector<disk_format::seek_table_entry> seek_table;
+            std::vector<uint8_t> chunks;
+            std::vector<uint8_t> repeated_chunks;
+            uint64_t last_offset = std::numeric_limits<uint64_t>::max();
+            for(uint32_t index = 0; index < m_samples_desc.size(); index++)
+            {
+                //the samples of a motion block share the block offset
+                auto offset = m_samples_desc.offset(index);
+                if(offset == last_offset)
+                    continue;
+                last_offset = offset;
+                auto capture_time = m_samples_desc.capture_time(index);
+                if(capture_time < start_time || capture_time >= end_time)
+                    continue;
+
+                rs_stream stream = rs_stream::RS_STREAM_COUNT;
+                switch(m_samples_desc.type(index))
+                {
+                    case sample_type::st_image:
+                        stream = m_samples_desc.stream(index);
+                        if(std::find(streams.begin(), streams.end(), stream) == streams.end())
+                            continue;
+                        break;
+                    case sample_type::st_motion:
+                    case sample_type::st_time:
+                    case sample_type::st_motion_block:
+                        if(!include_motions)
+                            continue;
+                        break;
+                    case sample_type::st_debug_event:
+                    {
+                        //the stream of a frame drop event
+                        auto event_stream = m_samples_desc.stream(index);
+                        if(event_stream != rs_stream::RS_STREAM_COUNT && std::find(streams.begin(), streams.end(), event_stream) == streams.end())
+                            continue;
+                    }
+                    break;
+                }
+
+                sts = read_sample_chunks(*source, offset, chunks);
+                if(sts == status_no_error && m_samples_desc.type(index) == sample_type::st_image)
+                    sts = copy_repeated_sample_data(*source, m_samples_desc.frame_info(index), chunks, repeated_chunks);
+                if(sts != status_no_error)
+                {
+                    LOG_ERROR("failed to read sample chunks, offset - " << offset);
+                    return sts;
+                }
+
+                uint64_t clip_offset = 0;
+                clip.get_position(&clip_offset);
+                bool is_keyframe = true;
+                //the sample is copied as is, except for its offset and capture times
+                for(size_t position = 0; position + sizeof(chunk_info) <= chunks.size();)
+                {
+                    chunk_info chunk = {};
+                    memcpy(&chunk, chunks.data() + position, sizeof(chunk));
+                    auto data = chunks.data() + position + sizeof(chunk);
+                    switch(chunk.id)
+                    {
+                        case chunk_id::chunk_sample_info:
+                        {
+                            disk_format::sample_info si = {};
+                            auto size = std::min<size_t>(sizeof(si), chunk.size);
+                            memcpy(&si, data, size);
+                            si.data.offset = clip_offset;
+                            si.data.capture_time = capture_time - start_time;
+                            si.data.capture_time_unit = time_unit::microseconds;
+                            memcpy(data, &si, size);
+                        }
+                        break;
+                        case chunk_id::chunk_sample_data:
+                        {
+                            //frames which failed encoding are written uncompressed and don't depend on other frames
+                            if(stream == rs_stream::RS_STREAM_COUNT || !is_temporal_compression(m_streams_infos[stream].ctype))
+                                break;
+                            //the frame headers of the temporal codecs start with the keyframe flag
+                            compression::delta_codec::frame_header header = {};
+                            if(is_temporal_compression(m_samples_desc.frame_info(index).ctype) && chunk.size >= sizeof(header))
+                            {
+                                memcpy(&header, data, sizeof(header));
+                                is_keyframe = header.is_keyframe != 0;
+                            }
+                        }
+                        break;
+                        case chunk_id::chunk_motion_block:
+                        {
+                            disk_format::motion_block_entry entry = {};
+                            for(size_t entry_offset = 0; entry_offset + sizeof(entry) <= chunk.size; entry_offset += sizeof(entry))
+                            {
+                                memcpy(&entry, data + entry_offset, sizeof(entry));
+                                entry.data.capture_time = entry.data.capture_time > start_time ? entry.data.capture_time - start_time : 0;
+                                memcpy(data + entry_offset, &entry, sizeof(entry));
+                            }
+                        }
+                        break;
+                        case chunk_id::chunk_sample_checksum:
+                        {
+                            //the checksum covers the sample chunks which precede it, as they are copied to the clip
+                            disk_format::sample_checksum checksum = {};
+                            if(chunk.size != sizeof(checksum))
+                                break;
+                            checksum.crc = crc32c::update(0, chunks.data(), position);
+                            checksum.size = static_cast<uint32_t>(position);
+                            memcpy(data, &checksum, sizeof(checksum));
+                        }
+                        break;
+                        case chunk_id::chunk_preview_frame:
+                        {
+                            //the preview follows the checksum chunk, it references the frame by its index in the clip
+                            disk_format::preview_frame preview = {};
+                            if(stream == rs_stream::RS_STREAM_COUNT || chunk.size < sizeof(preview))
+                                break;
+                            memcpy(&preview, data, sizeof(preview));
+                            preview.capture_time = capture_time - start_time;
+                            preview.data.index_in_stream = static_cast<uint32_t>(nframes[stream]);
+                            memcpy(data, &preview, sizeof(preview));
+                        }
+                        break;
+                        default:
+                        break;
+                    }
+                    position += sizeof(chunk) + chunk.size;
+                }
+
+                if(stream != rs_stream::RS_STREAM_COUNT)
+                {
+                    //a stream with temporal compression is decodable from its first keyframe in the range
+                    if(!is_keyframe && nframes[stream] == 0)
+                        continue;
+                    if(is_temporal_compression(m_streams_infos[stream].ctype) && is_keyframe)
+                    {
+                        disk_format::seek_table_entry entry = {};
+                        entry.stream = stream;
+                        entry.frame_index = nframes[stream];
+                        entry.offset = clip_offset;
+                        seek_table.push_back(entry);
+                    }
+                    nframes[stream]++;
+                }
+
+                uint32_t bytes_written = 0;
+                if(clip.write_bytes(chunks.data(), static_cast<uint32_t>(chunks.size()), bytes_written) != status_no_error)
+                    return status_file_write_failed;
+            }
+
+            uint32_t bytes_written = 0;
+            if(!m_codec_dictionaries.empty())
+            {
+                disk_format::codec_dictionaries_footer footer = {};
+                clip.get_position(&footer.chunk_offset);
+                footer.id = UID('R', 'S', 'C', 'D');
+                chunk_info chunk = {};
+                chunk.id = chunk_id::chunk_codec_dictionaries;
+                size_t chunk_size = sizeof(footer);
+                for(auto & dictionary : m_codec_dictionaries)
+                    chunk_size += sizeof(disk_format::codec_dictionary_entry) + dictionary.second.size();
+                chunk.size = static_cast<uint32_t>(chunk_size);
+                clip.write_bytes(&chunk, sizeof(chunk), bytes_written);
+                for(auto & dictionary : m_codec_dictionaries)
+                {
+                    disk_format::codec_dictionary_entry entry = {};
+                    entry.stream = dictionary.first;
+                    entry.size = static_cast<uint32_t>(dictionary.second.size());
+                    clip.write_bytes(&entry, sizeof(entry), bytes_written);
+                    clip.write_bytes(dictionary.second.data(), entry.size, bytes_written);
+                }
+                clip.write_bytes(&footer, sizeof(footer), bytes_written);
+            }
+            if(!seek_table.empty())
+            {
+                disk_format::seek_table_footer footer = {};
+                clip.get_position(&footer.chunk_offset);
+                footer.id = UID('R', 'S', 'S', 'T');
+                chunk_info chunk = {};
+                chunk.id = chunk_id::chunk_seek_table;
+                chunk.size = static_cast<uint32_t>(seek_table.size() * sizeof(disk_format::seek_table_entry) + sizeof(footer));
+                clip.write_bytes(&chunk, sizeof(chunk), bytes_written);
+                clip.write_bytes(seek_table.data(), static_cast<uint32_t>(seek_table.size() * sizeof(disk_format::seek_table_entry)), bytes_written);
+                clip.write_bytes(&footer, sizeof(footer), bytes_written);
+            }
+
+            for(auto & offset : nframes_offsets)
+            {
+                int32_t frames_count = nframes[offset.first];
+                clip.set_position(offset.second, move_method::begin);
+                clip.write_bytes(&frames_count, sizeof(frames_count), bytes_written);
+                LOG_INFO("extracted stream - " << offset.first << " ,number of frames - " << frames_count);
+            }
+            return clip.close();
+        }
+
+        status disk_read::write_clip_headers(file & source, file & clip, const std::vector<rs_stream> & streams, std::map<rs_stream, uint64_t> & nframes_offsets)
+        {
+            disk_format::file_header header = {};
+            if(source.read_to_object(header) != status_no_error)
+                return status_file_read_failed;
+            header.data.nstreams = static_cast<int32_t>(streams.size());
+            uint32_t bytes_written = 0;
+            if(clip.write_bytes(&header, sizeof(header), bytes_written) != status_no_error)
+                return status_file_write_failed;
+
+            std::vector<uint8_t> data;
+            uint64_t position = sizeof(header);
+            while(position < static_cast<uint64_t>(m_file_header.first_frame_offset))
+            {
+                chunk_info chunk = {};
+                if(source.read_to_object(chunk) != status_no_error)
+                    return status_file_read_failed;
+                data.resize(chunk.size);
+                if(source.read_to_object_array(data) != status_no_error)
+                    return status_file_read_failed;
+                position += sizeof(chunk) + chunk.size;
+
+                if(chunk.id == chunk_id::chunk_stream_info)
+                {
+                    uint64_t chunk_offset = 0;
+                    clip.get_position(&chunk_offset);
+                    std::vector<disk_format::stream_info> stream_infos;
+                    for(size_t offset = 0; offset + sizeof(disk_format::stream_info) <= data.size(); offset += sizeof(disk_format::stream_info))
+                    {
+                        disk_format::stream_info stream_info = {};
+                        memcpy(&stream_info, data.data() + offset, sizeof(stream_info));
+                        if(std::find(streams.begin(), streams.end(), stream_info.data.stream) == streams.end())
+                            continue;
+                        //the frames count is updated when all the samples are copied
+                        nframes_offsets[stream_info.data.stream] = chunk_offset + sizeof(chunk) +
+                                stream_infos.size() * sizeof(disk_format::stream_info) + offsetof(file_types::stream_info, nframes);
+                        stream_infos.push_back(stream_info);
+                    }
+                    chunk.size = static_cast<uint32_t>(stream_infos.size() * sizeof(disk_format::stream_info));
+                    clip.write_bytes(&chunk, sizeof(chunk), bytes_written);
+                    if(clip.write_bytes(stream_infos.data(), chunk.size, bytes_written) != status_no_error)
+                        return status_file_write_failed;
+                    continue;
+                }
+                clip.write_bytes(&chunk, sizeof(chunk), bytes_written);
+                if(clip.write_bytes(data.data(), chunk.size, bytes_written) != status_no_error)
+                    return status_file_write_failed;
+            }
+
+            //the samples are copied right after the headers
+            uint64_t first_frame_offset = 0;
+            clip.get_position(&first_frame_offset);
+            int32_t first_frame_position = static_cast<int32_t>(first_frame_offset);
+            clip.set_position(offsetof(file_types::file_header, first_frame_offset), move_method::begin);
+            clip.write_bytes(&first_frame_position, sizeof(first_frame_position), bytes_written);
+            return clip.set_position(first_frame_offset, move_method::begin);
         }
 
-        uint32_t disk_read::read_frame_metadata(const std::shared_ptr<frame_sample>& frame, unsigned long num_bytes_to_read)
+        status disk_read::copy_repeated_sample_data(file & source, const file_types::frame_info & info, std::vector<uint8_t> & chunks,
+                                                    std::vector<uint8_t> & repeated_chunks)
         {
-            using metadata_pair_type = decltype(frame->metadata)::value_type; //gets the pair<K,V> of the map
-            assert(num_bytes_to_read != 0); //if the chunk size is 0 there shouldn't be a chunk
-            if(num_bytes_to_read % sizeof(metadata_pair_type) != 0) //num_bytes_to_read must be a multiplication of sizeof(metadata_pair_type)
+            for(size_t position = 0; position + sizeof(chunk_info) <= chunks.size();)
             {
-                //in case data size is not valid move file pointer to the next chunk
-                LOG_ERROR("failed to read frame metadata, metadata size is not valid");
-                m_file_data_read->set_position(num_bytes_to_read, rs::core::move_method::current);
-                return static_cast<uint32_t>(num_bytes_to_read);
+                chunk_info chunk = {};
+                memcpy(&chunk, chunks.data() + position, sizeof(chunk));
+                const size_t chunk_end = position + sizeof(chunk) + chunk.size;
+                if(chunk.id != chunk_id::chunk_repeated_sample_data || chunk_end > chunks.size())
+                {
+                    position = chunk_end;
+                    continue;
+                }
+
+                disk_format::repeated_sample_data reference = {};
+                memcpy(&reference, chunks.data() + position + sizeof(chunk), std::min<size_t>(sizeof(reference), chunk.size));
+                uint64_t offset = 0;
+                auto sts = get_repeated_frame_offset(info, reference, offset);
+                if(sts == status_no_error)
+                    sts = read_sample_chunks(source, offset, repeated_chunks);
+                if(sts != status_no_error)
+                    return sts;
+                for(size_t repeated_position = 0; repeated_position + sizeof(chunk_info) <= repeated_chunks.size();)
+                {
+                    chunk_info repeated_chunk = {};
+                    memcpy(&repeated_chunk, repeated_chunks.data() + repeated_position, sizeof(repeated_chunk));
+                    const size_t repeated_chunk_end = repeated_position + sizeof(repeated_chunk) + repeated_chunk.size;
+                    if((repeated_chunk.id == chunk_id::chunk_sample_data || repeated_chunk.id == chunk_id::chunk_striped_sample_data) &&
+                       repeated_chunk_end <= repeated_chunks.size())
+                    {
+                        chunks.erase(chunks.begin() + position, chunks.begin() + chunk_end);
+                        chunks.insert(chunks.begin() + position, repeated_chunks.begin() + repeated_position, repeated_chunks.begin() + repeated_chunk_end);
+                        return status_no_error;
+                    }
+                    repeated_position = repeated_chunk_end;
+                }
+                return status_file_read_failed;
             }
-            auto num_pairs = num_bytes_to_read / sizeof(metadata_pair_type);
-            std::vector<metadata_pair_type> metadata_pairs(num_pairs);
-            uint32_t num_bytes_read = 0;
-            m_file_data_read->read_to_object_array(metadata_pairs);
-            for(uint32_t i = 0; i < num_pairs; i++)
+            return status_no_error;
+        }
+
+        status disk_read::read_sample_chunks(file & source, uint64_t offset, std::vector<uint8_t> & chunks)
+        {
+            //the buffer is reused between samples
+            chunks.clear();
+            if(source.set_position(offset, move_method::begin) != status_no_error)
+                return status_file_read_failed;
+            chunk_info chunk = {};
+            if(source.read_to_object(chunk) != status_no_error || chunk.id != chunk_id::chunk_sample_info)
+                return status_file_read_failed;
+            for(;;)
             {
-                frame->metadata.emplace(metadata_pairs[i].first, metadata_pairs[i].second);
+                auto chunk_offset = chunks.size();
+                chunks.resize(chunk_offset + sizeof(chunk) + chunk.size);
+                memcpy(chunks.data() + chunk_offset, &chunk, sizeof(chunk));
+                uint32_t bytes_read = 0;
+                if(chunk.size > 0 && source.read_bytes(chunks.data() + chunk_offset + sizeof(chunk), chunk.size, bytes_read) != status_no_error)
+                    return status_file_read_failed;
+                //the last sample is followed by the codec dictionaries, the seek table or by the end of file
+                if(source.read_to_object(chunk) != status_no_error)
+                {
+                    source.reset();
+                    return status_no_error;
+                }
+                if(chunk.id == chunk_id::chunk_sample_info || chunk.id == chunk_id::chunk_sample_bundle || chunk.id == chunk_id::chunk_motion_columns ||
+                   chunk.id == chunk_id::chunk_motion_columns_index || chunk.id == chunk_id::chunk_seek_table || chunk.id == chunk_id::chunk_codec_dictionaries)
+                    return status_no_error;
             }
-            return num_bytes_read;
         }
     }
 }
@@ -3,18 +3,153 @@
 
 #include "disk_read_base.h"
 #include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <vector>
 #include "rs/core/metadata_interface.h"
+#include "rs/core/frame_allocator_interface.h"
 #include "include/file.h"
+#include "include/range_file.h"
+#include "include/http_range_source.h"
+#include "include/local_range_source.h"
+#include "include/direct_range_source.h"
 #include "rs/utils/log_utils.h"
 #include "rs_sdk_version.h"
+#include "compression/delta_codec.h"
+#include "rs/core/image_interface.h"
+#include "include/crc32c.h"
+#include "rs/utils/thread_config.h"
+#include "rs/utils/profiler_markers.h"
+#include "mcap_writer.h"
 
 using namespace rs::core;
 using namespace rs::playback;
 
-disk_read_base::disk_read_base(const char * file_path) : m_file_path(file_path), m_file_header(), m_pause(true),
-    m_realtime(true), m_streams_infos(), m_base_ts(0), m_is_index_complete(false),
-    m_samples_desc_index(0), m_is_motion_tracking_enabled(false)
+namespace
+{
+    const double MIN_PLAYBACK_RATE = 0.25;
+    const double MAX_PLAYBACK_RATE = 16;
+    //the verification is bound by the storage, more threads only add seeks
+    const unsigned int MAX_VERIFY_THREADS = 8;
+
+    //batch jobs over large recordings read them with direct io, so they don't evict the page cache of the other processes
+    bool is_direct_io_enabled()
+    {
+        const char * value = std::getenv("RS_SDK_PLAYBACK_DIRECT_IO");
+        return value != nullptr && std::string(value) != "0";
+    }
+
+    //the processes of the host which play the same recordings decode each frame once
+    const char * SHARED_FRAMES_CACHE_NAME = "/rs_sdk_playback_frames";
+
+    uint64_t get_shared_frames_cache_size()
+    {
+        const char * value = std::getenv("RS_SDK_PLAYBACK_SHARED_CACHE");
+        return value != nullptr ? std::strtoull(value, nullptr, 10) * 1024 * 1024 : 0;
+    }
+
+    std::future<std::shared_ptr<file_types::frame_sample>> ready_frame(std::shared_ptr<file_types::frame_sample> frame)
+    {
+        std::promise<std::shared_ptr<file_types::frame_sample>> promise;
+        promise.set_value(frame);
+        return promise.get_future();
+    }
+
+    //the ROS 1 definitions of the exported messages, the definitions of the nested messages follow the message definition
+    const char * ROS_DEFINITIONS_SEPARATOR = "================================================================================\n";
+    const char * ROS_HEADER_DEFINITION = "MSG: std_msgs/Header\nuint32 seq\ntime stamp\nstring frame_id\n";
+    const char * ROS_IMAGE_DEFINITION = "std_msgs/Header header\nuint32 height\nuint32 width\nstring encoding\nuint8 is_bigendian\nuint32 step\nuint8[] data\n";
+    const char * ROS_COMPRESSED_IMAGE_DEFINITION = "std_msgs/Header header\nstring format\nuint8[] data\n";
+    const char * ROS_IMU_DEFINITION = "std_msgs/Header header\ngeometry_msgs/Quaternion orientation\nfloat64[9] orientation_covariance\n"
+                                      "geometry_msgs/Vector3 angular_velocity\nfloat64[9] angular_velocity_covariance\n"
+                                      "geometry_msgs/Vector3 linear_acceleration\nfloat64[9] linear_acceleration_covariance\n";
+    const char * ROS_QUATERNION_DEFINITION = "MSG: geometry_msgs/Quaternion\nfloat64 x\nfloat64 y\nfloat64 z\nfloat64 w\n";
+    const char * ROS_VECTOR3_DEFINITION = "MSG: geometry_msgs/Vector3\nfloat64 x\nfloat64 y\nfloat64 z\n";
+    //frames decoded ahead of the exported frame
+    const size_t EXPORT_READ_AHEAD_FRAMES = 8;
+
+    //the ROS 1 serialization is little endian and unaligned
+    template<typename T>
+    void append_ros(std::vector<uint8_t> & buffer, T value)
+    {
+        auto size = buffer.size();
+        buffer.resize(size + sizeof(value));
+        memcpy(buffer.data() + size, &value, sizeof(value));
+    }
+
+    void append_ros(std::vector<uint8_t> & buffer, const std::string & value)
+    {
+        append_ros(buffer, static_cast<uint32_t>(value.size()));
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    //capture time is in microseconds
+    void append_ros_header(std::vector<uint8_t> & buffer, uint32_t seq, uint64_t capture_time, const std::string & frame_id)
+    {
+        append_ros(buffer, seq);
+        append_ros(buffer, static_cast<uint32_t>(capture_time / 1000000));
+        append_ros(buffer, static_cast<uint32_t>(capture_time % 1000000 * 1000));
+        append_ros(buffer, frame_id);
+    }
+
+    std::string ros_stream_name(rs_stream stream)
+    {
+        switch(stream)
+        {
+            case rs_stream::RS_STREAM_DEPTH: return "depth";
+            case rs_stream::RS_STREAM_COLOR: return "color";
+            case rs_stream::RS_STREAM_INFRARED: return "infrared";
+            case rs_stream::RS_STREAM_INFRARED2: return "infrared2";
+            case rs_stream::RS_STREAM_FISHEYE: return "fisheye";
+            default: return "stream" + std::to_string(static_cast<int>(stream));
+        }
+    }
+
+    std::string ros_image_encoding(const file_types::frame_info & info)
+    {
+        switch(info.format)
+        {
+            case rs_format::RS_FORMAT_Z16:
+            case rs_format::RS_FORMAT_DISPARITY16: return "16UC1";
+            case rs_format::RS_FORMAT_RGB8: return "rgb8";
+            case rs_format::RS_FORMAT_BGR8: return "bgr8";
+            case rs_format::RS_FORMAT_RGBA8: return "rgba8";
+            case rs_format::RS_FORMAT_BGRA8: return "bgra8";
+            case rs_format::RS_FORMAT_Y8: return "mono8";
+            case rs_format::RS_FORMAT_Y16: return "mono16";
+            case rs_format::RS_FORMAT_YUYV: return "yuv422_yuy2";
+            case rs_format::RS_FORMAT_XYZ32F: return "32FC3";
+            default:
+            {
+                //formats without a ROS encoding are exported as rows of bytes
+                auto bytes_per_pixel = info.width > 0 ? std::max(1, info.stride / info.width) : 1;
+                return "8UC" + std::to_string(bytes_per_pixel);
+            }
+        }
+    }
+
+    //the codecs whose frames are decoded without the previous frames and without the dictionaries stored in the recording
+    const char * passthrough_codec_name(file_types::compression_type ctype)
+    {
+        switch(ctype)
+        {
+            case file_types::compression_type::h264: return "h264";
+            case file_types::compression_type::lz4: return "rs_lz4";
+            case file_types::compression_type::lz4_striped: return "rs_lz4_striped";
+            case file_types::compression_type::yuv420: return "rs_yuv420";
+            case file_types::compression_type::rvl: return "rs_rvl";
+            default: return nullptr;
+        }
+    }
+}
+
+disk_read_base::disk_read_base(const char * file_path) : m_file_path(file_path), m_file_size(0), m_index_read_ahead_position(0), m_index_position(0), m_file_header(), m_pause(true),
+    m_mapped_data_read(nullptr), m_realtime(true), m_streams_infos(), m_base_ts(0), m_clock_offset(0), m_clock_position(0), m_is_index_complete(false),
+    m_format_traits(), m_samples_desc_index(0), m_playback_rate(1), m_is_motion_tracking_enabled(false), m_read_ahead_window(0), m_is_scheduled(false),
+    m_frames_cache(FRAMES_CACHE_BUDGET), m_file_key(), m_loop_memory_size(0), m_loop_samples_size(0), m_is_loop_held(true), m_is_replaying_loop(false),
+    m_loop_position(0), m_loop_count(0), m_loop_duration(0), m_preview_scan_position(0), m_is_preview_scan_complete(false),
+    m_is_motion_columns_index_loaded(false)
 {
 
 }
@@ -41,7 +176,8 @@ rs::playback::file_info disk_read_base::query_file_info()
     {
         case UID('R', 'S', 'C', 'F'): file_info.type = playback::file_format::rs_rssdk_format; break;
         case UID('R', 'S', 'L', '1'):
-        case UID('R', 'S', 'L', '2'): file_info.type = playback::file_format::rs_linux_format; break;
+        case UID('R', 'S', 'L', '2'):
+        case UID('R', 'S', 'L', '3'): file_info.type = playback::file_format::rs_linux_format; break;
     }
     return file_info;
 }
@@ -55,7 +191,7 @@ capture_mode disk_read_base::get_capture_mode()
     //index MIN_NUM_OF_FRAMES_TO_VALIDATE samples for each stream type
     while(!m_is_index_complete)
     {
-        index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
+        index_samples(NUMBER_OF_SAMPLES_TO_INDEX);
         if(m_image_indices.size() < m_streams_infos.size())
             continue;
 
@@ -72,13 +208,12 @@ capture_mode disk_read_base::get_capture_mode()
     }
 
     //match capture times between the differnt streams
-    for(auto sample_desc : m_samples_desc)
+    for(uint32_t index = 0; index < m_samples_desc.size(); index++)
     {
-        if(sample_desc->info.type != file_types::sample_type::st_image)
+        if(m_samples_desc.type(index) != file_types::sample_type::st_image)
             continue;
 
-        auto frame = std::dynamic_pointer_cast<file_types::frame_sample>(sample_desc);
-        capture_times[frame->finfo.stream] = frame->info.capture_time;
+        capture_times[m_samples_desc.stream(index)] = m_samples_desc.capture_time(index);
         if(capture_times.size() > 0 && capture_times.size() == m_streams_infos.size())
         {
             bool match = true;
@@ -95,263 +230,1833 @@ capture_mode disk_read_base::get_capture_mode()
     return capture_mode::asynced;
 }
 
+status disk_read_base::open_file_for_read(const std::string & file_path, std::unique_ptr<file> & rv, bool is_sequential)
+{
+    //a remote recording is read by ranges through a block cache
+    if(http_range_source::is_http_location(file_path))
+    {
+        rv = std::unique_ptr<file>(new range_file(std::unique_ptr<range_source>(new http_range_source())));
+        return rv->open(file_path, open_file_option::read);
+    }
+    if(is_direct_io_enabled())
+    {
+        rv = std::unique_ptr<file>(new range_file(std::unique_ptr<range_source>(new direct_range_source())));
+        if(rv->open(file_path, open_file_option::read) == status_no_error)
+            return status_no_error;
+        LOG_WARN("failed to open the file for direct io, using the page cache");
+    }
+    //prefer a memory mapped file, fall back to stream based io if the file can't be mapped
+    std::unique_ptr<file> mapped(new mapped_file());
+    if(mapped->open(file_path, open_file_option::read) == status_no_error)
+    {
+        rv = std::move(mapped);
+        return status_no_error;
+    }
+    LOG_WARN("failed to map file to memory, using stream based file read");
+    if(is_sequential)
+        rv = std::unique_ptr<file>(new range_file(std::unique_ptr<range_source>(new local_range_source())));
+    else
+        rv = std::unique_ptr<file>(new file());
+    return rv->open(file_path, open_file_option::read);
+}
+
 status disk_read_base::init()
 {
     if (m_file_path.empty()) return status_file_open_failed;
 
-    m_file_data_read = std::unique_ptr<file>(new file());
-    status init_status = m_file_data_read->open(m_file_path.c_str(), (open_file_option)(open_file_option::read));
+    status init_status = open_file_for_read(m_file_path, m_file_data_read);
     if (init_status < status_no_error)
     {
         return init_status;
     }
+    m_mapped_data_read = dynamic_cast<mapped_file*>(m_file_data_read.get());
 
     init_status = read_headers();
-
-    m_file_indexing = std::unique_ptr<file>(new file());
-    init_status = m_file_indexing->open(m_file_path.c_str(), (open_file_option)(open_file_option::read));
+    m_format_traits = query_format_traits();
+    if(open_stripe_files() < status_no_error)
+        return status_file_open_failed;
+    load_seek_table();
+    load_codec_dictionaries();
+    open_shared_frames_cache();
+
+    init_status = open_file_for_read(m_file_path, m_file_indexing, true);
     if (init_status < status_no_error) return init_status;
 
     /* Be prepared to index the frames */
+    m_file_indexing->set_position(0, move_method::end, &m_file_size);
     m_file_indexing->set_position(m_file_header.first_frame_offset, move_method::begin);
+    m_index_position = m_file_header.first_frame_offset;
     LOG_INFO("init " << (init_status == status_no_error ? "succeeded" : "failed") << "(status - " << init_status << ")");
 
+    if(load_samples_index())
+        LOG_INFO("samples index loaded, number of samples - " << m_samples_desc.size());
+
+    //the legacy formats are converted to the in-memory samples descriptors once, the samples are then read as in the current format
+    if(m_format_traits.index_at_open)
+    {
+        index_samples(std::numeric_limits<uint32_t>::max());
+        LOG_INFO("legacy index converted, number of samples - " << m_samples_desc.size());
+    }
+
     if(m_file_header.capture_mode == 0)
         m_file_header.capture_mode = get_capture_mode();
 
     return init_status;
 }
 
-void disk_read_base::resume()
+status disk_read_base::open_stripe_files()
 {
-    LOG_FUNC_SCOPE();
+    m_stripe_files.clear();
+    m_mapped_stripe_files.clear();
+    auto directory_end = m_file_path.find_last_of("/\\");
+    for(auto & path : m_stripe_paths)
+    {
+        std::unique_ptr<file> stripe;
+        if(open_file_for_read(path, stripe) != status_no_error)
+        {
+            //a moved recording is expected with its stripe files
+            auto name_start = path.find_last_of("/\\");
+            auto name = name_start == std::string::npos ? path : path.substr(name_start + 1);
+            auto local_path = directory_end == std::string::npos ? name : m_file_path.substr(0, directory_end + 1) + name;
+            if(open_file_for_read(local_path, stripe) != status_no_error)
+            {
+                LOG_ERROR("failed to open stripe file " << path.c_str());
+                return status_file_open_failed;
+            }
+        }
+        m_mapped_stripe_files.push_back(dynamic_cast<mapped_file*>(stripe.get()));
+        m_stripe_files.push_back(std::move(stripe));
+    }
+    return status_no_error;
+}
 
-    m_pause = false;
-    //reset time base on resume
-    update_time_base();
+status disk_read_base::verify(verification_result & result)
+{
+    result = {};
+    if(m_format_traits.index_at_open)
+        return status_feature_unsupported;
+    std::unique_ptr<file> source;
+    if(open_file_for_read(m_file_path, source) != status_no_error)
+        return status_file_open_failed;
+
+    //the chunks headers are walked first, the data chunks are skipped, so only the headers are read
+    std::vector<checksummed_range> ranges;
+    uint64_t position = m_file_header.first_frame_offset;
+    source->set_position(position, move_method::begin);
+    file_types::chunk_info chunk = {};
+    while(source->read_to_object(chunk) == status_no_error)
+    {
+        if(chunk.id == file_types::chunk_id::chunk_sample_checksum)
+        {
+            file_types::disk_format::sample_checksum checksum = {};
+            if(chunk.size != sizeof(checksum) || source->read_to_object(checksum) != status_no_error)
+                break;
+            //a checksum which covers the headers is corrupted, the crc of an empty range is 0 so the range doesn't match
+            if(checksum.size > position - m_file_header.first_frame_offset)
+                ranges.push_back({ position, 0, ~0u });
+            else
+                ranges.push_back({ position - checksum.size, checksum.size, checksum.crc });
+        }
+        else if(source->set_position(chunk.size, move_method::current) != status_no_error)
+        {
+            break;
+        }
+        position += sizeof(chunk) + chunk.size;
+    }
+    source.reset();
 
-    //resume while streaming is not allowed
-    if(m_thread.joinable())
-        throw std::runtime_error("resume while streaming is not allowed");
+    //each thread verifies a contiguous part of the file, so the threads read the file sequentially
+    size_t threads_count = std::max(1u, std::min(std::thread::hardware_concurrency(), MAX_VERIFY_THREADS));
+    size_t part_size = (ranges.size() + threads_count - 1) / threads_count;
+    std::vector<std::future<verification_result>> parts;
+    for(size_t begin = 0; begin < ranges.size(); begin += part_size)
+    {
+        auto end = std::min(begin + part_size, ranges.size());
+        parts.push_back(std::async(std::launch::async, [this, &ranges, begin, end]() { return verify_ranges(ranges, begin, end); }));
+    }
+    for(auto & part : parts)
+    {
+        auto part_result = part.get();
+        if(part_result.corrupted_samples_count > 0 && result.corrupted_samples_count == 0)
+            result.first_corrupted_offset = part_result.first_corrupted_offset;
+        result.verified_samples_count += part_result.verified_samples_count;
+        result.corrupted_samples_count += part_result.corrupted_samples_count;
+    }
+    LOG_INFO("verified samples - " << result.verified_samples_count << " ,corrupted samples - " << result.corrupted_samples_count);
+    return status_no_error;
+}
+
+status disk_read_base::read_preview_frame(rs_stream stream, uint32_t index, playback::preview_frame & frame)
+{
+    frame = {};
+    if(m_format_traits.index_at_open)
+        return status_feature_unsupported;
+    std::lock_guard<std::mutex> guard(m_preview_mutex);
+    if(!m_preview_file)
+    {
+        if(open_file_for_read(m_file_path, m_preview_file) != status_no_error)
+            return status_file_open_failed;
+        m_preview_scan_position = m_file_header.first_frame_offset;
+    }
+
+    //the scan reads the chunk headers only, until the requested preview frame is found or the end of the file
+    auto & offsets = m_preview_offsets[stream];
+    while(offsets.size() <= index && !m_is_preview_scan_complete)
+    {
+        file_types::chunk_info chunk = {};
+        file_types::disk_format::preview_frame preview = {};
+        if(m_preview_file->set_position(m_preview_scan_position, move_method::begin) != status_no_error ||
+           m_preview_file->read_to_object(chunk) != status_no_error ||
+           (chunk.id == file_types::chunk_id::chunk_preview_frame && m_preview_file->read_to_object(preview) != status_no_error))
+        {
+            m_is_preview_scan_complete = true;
+            break;
+        }
+        if(chunk.id == file_types::chunk_id::chunk_preview_frame)
+            m_preview_offsets[preview.data.stream].push_back(m_preview_scan_position + sizeof(chunk));
+        m_preview_scan_position += sizeof(chunk) + chunk.size;
+    }
+    if(index >= offsets.size())
+        return status_item_unavailable;
+
+    file_types::disk_format::preview_frame preview = {};
+    if(m_preview_file->set_position(offsets[index], move_method::begin) != status_no_error || m_preview_file->read_to_object(preview) != status_no_error)
+        return status_file_read_failed;
+    std::vector<uint8_t> encoded(preview.size);
+    uint32_t bytes_read = 0;
+    if(m_preview_file->read_bytes(encoded.data(), preview.size, bytes_read) != status_no_error || bytes_read != preview.size)
+        return status_file_read_failed;
+
+    auto & info = preview.data;
+    uint32_t size = static_cast<uint32_t>(info.stride) * info.height;
+    std::shared_ptr<uint8_t> data(new uint8_t[size], std::default_delete<uint8_t[]>());
+    switch(info.ctype)
+    {
+        case file_types::compression_type::none:
+            if(preview.size != size)
+                return status_file_read_failed;
+            memcpy(data.get(), encoded.data(), size);
+            break;
+        case file_types::compression_type::lz4:
+        {
+            auto sts = m_preview_codec.decode_into(info, encoded.data(), preview.size, data.get(), info.stride);
+            if(sts != status_no_error)
+                return sts;
+            break;
+        }
+        default:
+            return status_feature_unsupported;
+    }
 
-    m_thread = std::thread(&disk_read_base::read_thread, this);
+    frame.width = info.width;
+    frame.height = info.height;
+    frame.format = static_cast<rs::format>(info.format);
+    frame.stride = info.stride;
+    frame.scale = static_cast<int32_t>(preview.scale);
+    frame.frame_index = static_cast<int32_t>(info.index_in_stream);
+    frame.frame_number = info.number;
+    frame.capture_time = preview.capture_time / 1000;
+    frame.data = data;
+    return status_no_error;
 }
 
-void disk_read_base::pause()
+verification_result disk_read_base::verify_ranges(const std::vector<checksummed_range> & ranges, size_t begin, size_t end)
 {
-    LOG_FUNC_SCOPE();
+    rs::utils::thread_configuration::apply(rs::utils::thread_role::playback, "rs-play-verify");
+    verification_result rv = {};
+    std::unique_ptr<file> source;
+    bool is_open = open_file_for_read(m_file_path, source) == status_no_error;
+    auto mapped = dynamic_cast<mapped_file*>(source.get());
+    std::vector<uint8_t> buffer;
+    for(size_t i = begin; i < end; i++)
+    {
+        auto & range = ranges[i];
+        uint32_t checksum = 0;
+        uint32_t bytes_read = 0;
+        if(is_open && source->set_position(range.offset, move_method::begin) == status_no_error)
+        {
+            if(mapped)
+            {
+                auto data = mapped->map_bytes(range.size, bytes_read);
+                if(data)
+                    checksum = crc32c::update(0, data.get(), bytes_read);
+            }
+            else
+            {
+                buffer.resize(range.size);
+                if(source->read_bytes(buffer.data(), range.size, bytes_read) == status_no_error)
+                    checksum = crc32c::update(0, buffer.data(), bytes_read);
+            }
+        }
+        if(bytes_read == range.size && checksum == range.crc)
+        {
+            rv.verified_samples_count++;
+            continue;
+        }
+        if(rv.corrupted_samples_count++ == 0)
+            rv.first_corrupted_offset = range.offset;
+        LOG_WARN("corrupted sample, offset - " << range.offset);
+    }
+    return rv;
+}
 
-    m_pause = true;
+bool disk_read_base::load_samples_index()
+{
+    auto index_path = file_types::samples_index_path(m_file_path);
+    //the index of a remote recording is fetched from next to it, it spares indexing the recording over the network
+    std::unique_ptr<file> index_file(http_range_source::is_http_location(index_path) ?
+                                     new range_file(std::unique_ptr<range_source>(new http_range_source())) : new file());
+    if(index_file->open(index_path, open_file_option::read) != status_no_error)
+        return false;
+
+    file_types::disk_format::samples_index_header header = {};
+    if(index_file->read_to_object(header) != status_no_error)
+        return false;
+    //a recording which wasn't closed, e.g. the recording process crashed, is indexed up to its last checkpoint
+    bool is_checkpoint = header.completed == 0;
+    if(header.id != UID('R', 'S', 'I', '1') || (is_checkpoint && header.checkpoint_position == 0))
+    {
+        LOG_WARN("samples index is not valid, samples will be indexed from the recording");
+        return false;
+    }
+
+    //the recording was modified after the index was written
+    uint64_t recording_size = 0;
+    uint64_t first_sample_position = 0;
+    m_file_indexing->get_position(&first_sample_position);
+    m_file_indexing->set_position(0, move_method::end, &recording_size);
+    m_file_indexing->set_position(first_sample_position, move_method::begin);
+    if(is_checkpoint ? (recording_size < header.checkpoint_position || header.checkpoint_position < first_sample_position) : recording_size != header.recording_size)
+    {
+        LOG_WARN("samples index doesn't match the recording, samples will be indexed from the recording");
+        return false;
+    }
+
+    //entries which were written after the checkpoint are ignored
+    uint64_t index_size = 0;
+    index_file->set_position(0, move_method::end, &index_size);
+    uint64_t entries_size = header.samples_count * sizeof(file_types::disk_format::sample_index_entry);
+    if(is_checkpoint ? index_size < sizeof(header) + entries_size : index_size != sizeof(header) + entries_size)
+    {
+        LOG_WARN("samples index size is not valid, samples will be indexed from the recording");
+        return false;
+    }
+    index_file->set_position(sizeof(header), move_method::begin);
+    std::vector<file_types::disk_format::sample_index_entry> entries(header.samples_count);
+    if(index_file->read_to_object_array(entries) != status_no_error)
+        return false;
 
-    if (m_thread.joinable())
-        m_thread.join();
+    std::lock_guard<std::mutex> guard(m_mutex);
+    samples_index samples_desc;
+    std::map<rs_stream, std::vector<uint32_t>> image_indices;
+    samples_desc.reserve(entries.size());
+    for(auto & entry : entries)
+    {
+        if(!add_indexed_sample(entry, samples_desc, image_indices))
+        {
+            LOG_WARN("samples index contains an invalid entry, samples will be indexed from the recording");
+            return false;
+        }
+    }
+    m_samples_desc = std::move(samples_desc);
+    m_image_indices = std::move(image_indices);
+    if(is_checkpoint)
+    {
+        //the frames count in the header isn't updated after the crash, the frames are counted from the index
+        for(auto & stream_info : m_streams_infos)
+            stream_info.second.nframes = 0;
+        m_file_indexing->set_position(header.checkpoint_position, move_method::begin);
+        LOG_INFO("recording wasn't closed, samples after the last checkpoint are indexed from the recording, checkpoint position - " << header.checkpoint_position);
+        return true;
+    }
+    m_is_index_complete = true;
+    return true;
 }
 
-void disk_read_base::read_thread()
+bool disk_read_base::add_indexed_sample(const file_types::disk_format::sample_index_entry & entry, samples_index & samples_desc,
+                                        std::map<rs_stream, std::vector<uint32_t>> & image_indices)
 {
-    LOG_FUNC_SCOPE();
-    m_base_sys_time = std::chrono::high_resolution_clock::now();
-    auto eof = false;
-    while (!m_pause && !eof)
+    auto sample_info = entry.info;
+    if(sample_info.capture_time_unit == file_types::time_unit::milliseconds)
+        sample_info.capture_time *= 1000;
+    switch(sample_info.type)
     {
-        eof = !read_next_sample();
-        if(eof)
+        case file_types::sample_type::st_image:
+        {
+            auto frame_info = entry.data.frame;
+            if(m_streams_infos.find(frame_info.stream) == m_streams_infos.end())
+                return false;
+            frame_info.index_in_stream = static_cast<uint32_t>(image_indices[frame_info.stream].size());
+            image_indices[frame_info.stream].push_back(samples_desc.add_frame(frame_info, sample_info));
+        }
+        break;
+        case file_types::sample_type::st_motion:
+            samples_desc.add_motion(entry.data.motion, sample_info);
+            break;
+        case file_types::sample_type::st_time:
+            samples_desc.add_time_stamp(entry.data.time_stamp, sample_info);
+            break;
+        case file_types::sample_type::st_debug_event:
         {
-            //notify that reached the end of file
-            if(!m_eof_callback)
-                throw std::runtime_error("end of file callback is null");
-            m_eof_callback();
-            m_pause = true;
+            auto event_type = entry.data.debug_event.type;
+            bool has_debug_data = event_type == file_types::debug_event_type::application_frame_drop ||
+                                  event_type == file_types::debug_event_type::recorder_frame_drop;
+            samples_desc.add_debug_event(event_type, sample_info, has_debug_data ? &entry.data.debug_event.data : nullptr);
         }
+        break;
+        default:
+            return false;
     }
-    LOG_INFO("Total number of dropped frames during playback - " << m_properties[rs_option::RS_OPTION_TOTAL_FRAME_DROPS]);
-    LOG_INFO("Total number of dropped IMUs during playback - " << m_motion_drop_count);
+    return true;
 }
 
-void disk_read_base::init_decoder()
+void disk_read_base::load_seek_table()
 {
-    std::map<rs_stream,file_types::compression_type> compression_config;
-    uint32_t buffer_size = 0;
-    for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
+    m_keyframes.clear();
+    uint64_t file_size = 0;
+    file_types::disk_format::seek_table_footer footer = {};
+    if(m_file_data_read->set_position(0, move_method::end, &file_size) != status_no_error || file_size < sizeof(footer))
+        return;
+    m_file_data_read->set_position(file_size - sizeof(footer), move_method::begin);
+    if(m_file_data_read->read_to_object(footer) != status_no_error || footer.id != UID('R', 'S', 'S', 'T') || footer.chunk_offset >= file_size)
     {
-        uint32_t size = it->second.m_stream_info.profile.info.width * it->second.m_stream_info.profile.info.height;
-        buffer_size = size > buffer_size ? size : buffer_size;
-        compression_config.emplace(it->first, it->second.m_stream_info.ctype);
+        //older recordings and recordings without temporal compression have no seek table
+        m_file_data_read->reset();
+        return;
     }
 
-    m_decoder.reset(new compression::decoder(compression_config));
-    m_encoded_data = std::vector<uint8_t>(buffer_size * 4);//stride is not availabe, taking worst case.
+    file_types::chunk_info chunk = {};
+    m_file_data_read->set_position(footer.chunk_offset, move_method::begin);
+    if(m_file_data_read->read_to_object(chunk) != status_no_error || chunk.id != file_types::chunk_id::chunk_seek_table ||
+       footer.chunk_offset + sizeof(chunk) + chunk.size != file_size || chunk.size < sizeof(footer) ||
+       (chunk.size - sizeof(footer)) % sizeof(file_types::disk_format::seek_table_entry) != 0)
+    {
+        LOG_WARN("seek table is not valid");
+        m_file_data_read->reset();
+        return;
+    }
+    std::vector<file_types::disk_format::seek_table_entry> entries((chunk.size - sizeof(footer)) / sizeof(file_types::disk_format::seek_table_entry));
+    if(m_file_data_read->read_to_object_array(entries) != status_no_error)
+    {
+        LOG_WARN("failed to read seek table");
+        m_file_data_read->reset();
+        return;
+    }
+    for(auto & entry : entries)
+        m_keyframes[entry.stream].push_back(entry.frame_index);
+    for(auto & keyframes : m_keyframes)
+        std::sort(keyframes.second.begin(), keyframes.second.end());
+    LOG_INFO("seek table loaded, number of keyframes - " << entries.size());
+}
+
+void disk_read_base::load_codec_dictionaries()
+{
+    m_codec_dictionaries.clear();
+    uint64_t end = 0;
+    file_types::disk_format::codec_dictionaries_footer footer = {};
+    if(m_file_data_read->set_position(0, move_method::end, &end) != status_no_error || end < sizeof(footer))
+        return;
+    //the seek table is the last chunk of the file, the dictionaries precede it
+    file_types::disk_format::seek_table_footer seek_table_footer = {};
+    m_file_data_read->set_position(end - sizeof(seek_table_footer), move_method::begin);
+    if(m_file_data_read->read_to_object(seek_table_footer) == status_no_error && seek_table_footer.id == UID('R', 'S', 'S', 'T') &&
+       seek_table_footer.chunk_offset < end)
+        end = seek_table_footer.chunk_offset;
+    if(end < sizeof(footer))
+    {
+        m_file_data_read->reset();
+        return;
+    }
+    m_file_data_read->set_position(end - sizeof(footer), move_method::begin);
+    if(m_file_data_read->read_to_object(footer) != status_no_error || footer.id != UID('R', 'S', 'C', 'D') || footer.chunk_offset >= end)
+    {
+        //only recordings of codecs which learn from the stream have dictionaries
+        m_file_data_read->reset();
+        return;
+    }
+
+    file_types::chunk_info chunk = {};
+    m_file_data_read->set_position(footer.chunk_offset, move_method::begin);
+    if(m_file_data_read->read_to_object(chunk) != status_no_error || chunk.id != file_types::chunk_id::chunk_codec_dictionaries ||
+       footer.chunk_offset + sizeof(chunk) + chunk.size != end || chunk.size < sizeof(footer))
+    {
+        LOG_WARN("codec dictionaries are not valid");
+        m_file_data_read->reset();
+        return;
+    }
+    std::vector<uint8_t> data(chunk.size - sizeof(footer));
+    if(m_file_data_read->read_to_object_array(data) != status_no_error)
+    {
+        LOG_WARN("failed to read codec dictionaries");
+        m_file_data_read->reset();
+        return;
+    }
+    file_types::disk_format::codec_dictionary_entry entry = {};
+    for(size_t position = 0; position + sizeof(entry) <= data.size();)
+    {
+        memcpy(&entry, data.data() + position, sizeof(entry));
+        position += sizeof(entry);
+        if(entry.size > data.size() - position)
+        {
+            LOG_WARN("codec dictionary of stream " << entry.stream << " is truncated");
+            break;
+        }
+        m_codec_dictionaries[entry.stream].assign(data.begin() + position, data.begin() + position + entry.size);
+        position += entry.size;
+    }
+    LOG_INFO("codec dictionaries loaded, number of dictionaries - " << m_codec_dictionaries.size());
+}
+
+void disk_read_base::load_motion_columns_index()
+{
+    m_motion_columns_index.clear();
+    uint64_t end = 0;
+    file_types::disk_format::motion_columns_index_footer footer = {};
+    if(m_file_data_read->set_position(0, move_method::end, &end) != status_no_error || end < sizeof(footer))
+        return;
+    //the seek table is the last chunk of the file, the dictionaries precede it and the motion columns index precedes both
+    file_types::disk_format::seek_table_footer seek_table_footer = {};
+    m_file_data_read->set_position(end - sizeof(seek_table_footer), move_method::begin);
+    if(m_file_data_read->read_to_object(seek_table_footer) == status_no_error && seek_table_footer.id == UID('R', 'S', 'S', 'T') &&
+       seek_table_footer.chunk_offset < end)
+        end = seek_table_footer.chunk_offset;
+    file_types::disk_format::codec_dictionaries_footer dictionaries_footer = {};
+    if(end >= sizeof(dictionaries_footer))
+    {
+        m_file_data_read->set_position(end - sizeof(dictionaries_footer), move_method::begin);
+        if(m_file_data_read->read_to_object(dictionaries_footer) == status_no_error && dictionaries_footer.id == UID('R', 'S', 'C', 'D') &&
+           dictionaries_footer.chunk_offset < end)
+            end = dictionaries_footer.chunk_offset;
+    }
+    if(end < sizeof(footer))
+    {
+        m_file_data_read->reset();
+        return;
+    }
+    m_file_data_read->set_position(end - sizeof(footer), move_method::begin);
+    if(m_file_data_read->read_to_object(footer) != status_no_error || footer.id != UID('R', 'S', 'M', 'C') || footer.chunk_offset >= end)
+    {
+        //recordings without motions, recordings which weren't closed and older recordings have no motion columns
+        m_file_data_read->reset();
+        return;
+    }
+
+    file_types::chunk_info chunk = {};
+    m_file_data_read->set_position(footer.chunk_offset, move_method::begin);
+    if(m_file_data_read->read_to_object(chunk) != status_no_error || chunk.id != file_types::chunk_id::chunk_motion_columns_index ||
+       footer.chunk_offset + sizeof(chunk) + chunk.size != end || chunk.size < sizeof(footer) ||
+       (chunk.size - sizeof(footer)) % sizeof(file_types::disk_format::motion_columns_index_entry) != 0)
+    {
+        LOG_WARN("motion columns index is not valid");
+        m_file_data_read->reset();
+        return;
+    }
+    std::vector<file_types::disk_format::motion_columns_index_entry> entries((chunk.size - sizeof(footer)) / sizeof(file_types::disk_format::motion_columns_index_entry));
+    if(m_file_data_read->read_to_object_array(entries) != status_no_error)
+    {
+        LOG_WARN("failed to read motion columns index");
+        m_file_data_read->reset();
+        return;
+    }
+    m_motion_columns_index = std::move(entries);
+    LOG_INFO("motion columns index loaded, number of blocks - " << m_motion_columns_index.size());
+}
+
+status disk_read_base::read_motions(rs_event_source source, uint64_t start_time, uint64_t end_time, playback::motion_columns & columns)
+{
+    columns = playback::motion_columns();
+    if(!m_pause)
+        return status_invalid_state;
+    if(start_time >= end_time || source < 0 || source >= RS_EVENT_SOURCE_COUNT)
+        return status_invalid_argument;
+    //capture times are in microseconds
+    start_time *= 1000;
+    end_time *= 1000;
+    if(!m_is_motion_columns_index_loaded)
+    {
+        load_motion_columns_index();
+        m_is_motion_columns_index_loaded = true;
+    }
+    if(m_motion_columns_index.empty())
+    {
+        read_indexed_motions(source, start_time, end_time, columns);
+        return status_no_error;
+    }
+
+    //each block is read with a single read, the blocks of a source are in capture order
+    std::vector<uint8_t> data;
+    for(auto & entry : m_motion_columns_index)
+    {
+        if(entry.source != source || entry.end_time < start_time || entry.start_time >= end_time)
+            continue;
+        file_types::chunk_info chunk = {};
+        file_types::disk_format::motion_columns header = {};
+        if(m_file_data_read->set_position(entry.offset, move_method::begin) != status_no_error ||
+           m_file_data_read->read_to_object(chunk) != status_no_error || chunk.id != file_types::chunk_id::chunk_motion_columns || chunk.size < sizeof(header))
+            return status_file_read_failed;
+        data.resize(chunk.size);
+        if(m_file_data_read->read_to_object_array(data) != status_no_error)
+            return status_file_read_failed;
+        memcpy(&header, data.data(), sizeof(header));
+        size_t count = header.count;
+        if(header.axes_count > 3 || chunk.size != sizeof(header) + count * (sizeof(uint64_t) + sizeof(double) + sizeof(uint64_t) + header.axes_count * sizeof(float)))
+            return status_file_read_failed;
+
+        //the columns are 8 bytes aligned, except for the axes columns which follow them
+        auto capture_times = reinterpret_cast<const uint64_t*>(data.data() + sizeof(header));
+        auto time_stamps = reinterpret_cast<const double*>(capture_times + count);
+        auto frame_numbers = reinterpret_cast<const uint64_t*>(time_stamps + count);
+        auto axes = reinterpret_cast<const float*>(frame_numbers + count);
+        size_t first = std::lower_bound(capture_times, capture_times + count, start_time) - capture_times;
+        size_t last = std::lower_bound(capture_times, capture_times + count, end_time) - capture_times;
+        columns.capture_times.insert(columns.capture_times.end(), capture_times + first, capture_times + last);
+        columns.time_stamps.insert(columns.time_stamps.end(), time_stamps + first, time_stamps + last);
+        columns.frame_numbers.insert(columns.frame_numbers.end(), frame_numbers + first, frame_numbers + last);
+        if(header.axes_count == 3)
+        {
+            columns.x.insert(columns.x.end(), axes + first, axes + last);
+            columns.y.insert(columns.y.end(), axes + count + first, axes + count + last);
+            columns.z.insert(columns.z.end(), axes + 2 * count + first, axes + 2 * count + last);
+        }
+    }
+    return status_no_error;
+}
+
+void disk_read_base::read_indexed_motions(rs_event_source source, uint64_t start_time, uint64_t end_time, playback::motion_columns & columns)
+{
+    while(!m_is_index_complete)
+        index_samples(std::numeric_limits<uint32_t>::max());
+    for(uint32_t index = 0; index < m_samples_desc.size(); index++)
+    {
+        auto capture_time = m_samples_desc.capture_time(index);
+        if(capture_time < start_time || capture_time >= end_time)
+            continue;
+        const rs_timestamp_data * time_stamp = nullptr;
+        const float * axes = nullptr;
+        switch(m_samples_desc.type(index))
+        {
+            case file_types::sample_type::st_motion:
+                time_stamp = &m_samples_desc.motion(index).timestamp_data;
+                axes = m_samples_desc.motion(index).axes;
+                break;
+            case file_types::sample_type::st_time:
+                time_stamp = &m_samples_desc.time_stamp(index);
+                break;
+            default:
+                continue;
+        }
+        if(time_stamp->source_id != source)
+            continue;
+        columns.capture_times.push_back(capture_time);
+        columns.time_stamps.push_back(time_stamp->timestamp);
+        columns.frame_numbers.push_back(time_stamp->frame_number);
+        if(axes)
+        {
+            columns.x.push_back(axes[0]);
+            columns.y.push_back(axes[1]);
+            columns.z.push_back(axes[2]);
+        }
+    }
+}
+
+status disk_read_base::export_mcap(const std::string & file_path, const std::vector<rs_stream> & streams, bool include_motions, bool decode_frames)
+{
+    LOG_FUNC_SCOPE();
+    if(!m_pause)
+        return status_invalid_state;
+    if(file_path == m_file_path)
+        return status_invalid_argument;
+    for(auto stream : streams)
+    {
+        if(m_streams_infos.find(stream) == m_streams_infos.end())
+            return status_invalid_argument;
+    }
+
+    while(!m_is_index_complete)
+        index_samples(std::numeric_limits<uint32_t>::max());
+
+    mcap_writer writer;
+    if(writer.open(file_path, "ros1") != status_no_error)
+        return status_file_open_failed;
+    std::string header_definition = std::string(ROS_DEFINITIONS_SEPARATOR) + ROS_HEADER_DEFINITION;
+    auto image_schema = writer.add_schema("sensor_msgs/Image", "ros1msg", ROS_IMAGE_DEFINITION + header_definition);
+    auto compressed_image_schema = writer.add_schema("sensor_msgs/CompressedImage", "ros1msg", ROS_COMPRESSED_IMAGE_DEFINITION + header_definition);
+    std::map<rs_stream, uint16_t> image_channels;
+    std::map<rs_stream, uint16_t> compressed_image_channels;
+    for(auto stream : streams)
+    {
+        auto topic = "/camera/" + ros_stream_name(stream) + "/image_raw";
+        image_channels[stream] = writer.add_channel(image_schema, topic, "ros1");
+        if(!decode_frames)
+            compressed_image_channels[stream] = writer.add_channel(compressed_image_schema, topic + "/compressed", "ros1");
+    }
+    std::map<rs_event_source, uint16_t> imu_channels;
+    if(include_motions)
+    {
+        auto imu_schema = writer.add_schema("sensor_msgs/Imu", "ros1msg", ROS_IMU_DEFINITION + header_definition + ROS_DEFINITIONS_SEPARATOR +
+                                            ROS_QUATERNION_DEFINITION + ROS_DEFINITIONS_SEPARATOR + ROS_VECTOR3_DEFINITION);
+        imu_channels[rs_event_source::RS_EVENT_IMU_GYRO] = writer.add_channel(imu_schema, "/camera/gyro/sample", "ros1");
+        imu_channels[rs_event_source::RS_EVENT_IMU_ACCEL] = writer.add_channel(imu_schema, "/camera/accel/sample", "ros1");
+    }
+
+    //a frame is either decoded by the decoder threads or passed through with its recorded data
+    struct exported_frame
+    {
+        uint64_t                                                    capture_time;
+        file_types::frame_info                                      info;
+        std::future<std::shared_ptr<file_types::frame_sample>>      decoded;
+        std::vector<uint8_t>                                        encoded;
+    };
+    std::deque<exported_frame> frames;
+    std::vector<uint8_t> message;
+    auto write_frame = [&](exported_frame & frame) -> status
+    {
+        auto stream = frame.info.stream;
+        auto frame_id = "camera_" + ros_stream_name(stream) + "_optical_frame";
+        auto encoding = ros_image_encoding(m_streams_infos[stream].profile.info);
+        message.clear();
+        append_ros_header(message, frame.info.index_in_stream, frame.capture_time, frame_id);
+        if(!frame.decoded.valid())
+        {
+            append_ros(message, encoding + "; " + passthrough_codec_name(frame.info.ctype));
+            append_ros(message, static_cast<uint32_t>(frame.encoded.size()));
+            return writer.write_message(compressed_image_channels[stream], frame.capture_time * 1000,
+                                        { { message.data(), message.size() }, { frame.encoded.data(), frame.encoded.size() } }, false);
+        }
+        auto decoded = frame.decoded.get();
+        if(!decoded || !decoded->data)
+        {
+            LOG_ERROR_RATE_LIMITED("failed to read frame, stream - " << stream << " ,index - " << frame.info.index_in_stream);
+            return status_file_read_failed;
+        }
+        uint32_t size = static_cast<uint32_t>(decoded->finfo.stride) * decoded->finfo.height;
+        append_ros(message, static_cast<uint32_t>(decoded->finfo.height));
+        append_ros(message, static_cast<uint32_t>(decoded->finfo.width));
+        append_ros(message, encoding);
+        append_ros(message, static_cast<uint8_t>(0));
+        append_ros(message, static_cast<uint32_t>(decoded->finfo.stride));
+        append_ros(message, size);
+        return writer.write_message(image_channels[stream], frame.capture_time * 1000, { { message.data(), message.size() }, { decoded->data, size } }, true);
+    };
+
+    status sts = status_no_error;
+    for(uint32_t index = 0; index < m_samples_desc.size() && sts == status_no_error; index++)
+    {
+        auto capture_time = m_samples_desc.capture_time(index);
+        switch(m_samples_desc.type(index))
+        {
+            case file_types::sample_type::st_image:
+            {
+                auto stream = m_samples_desc.stream(index);
+                if(image_channels.find(stream) == image_channels.end())
+                    break;
+                auto frame = m_samples_desc.get_frame(index);
+                if(!frame)
+                    break;
+                exported_frame exported = { capture_time, frame->finfo };
+                if(!decode_frames && passthrough_codec_name(frame->finfo.ctype))
+                    sts = read_encoded_image_data(*frame, exported.encoded);
+                else
+                {
+                    //the frames of a stream are decoded in order, the decoder threads decode the streams in parallel
+                    std::lock_guard<std::mutex> guard(m_mutex);
+                    exported.decoded = read_image_data(frame, true);
+                }
+                frames.push_back(std::move(exported));
+                if(frames.size() > EXPORT_READ_AHEAD_FRAMES && sts == status_no_error)
+                {
+                    sts = write_frame(frames.front());
+                    frames.pop_front();
+                }
+            }
+            break;
+            case file_types::sample_type::st_motion:
+            {
+                auto & motion = m_samples_desc.motion(index);
+                auto channel = imu_channels.find(static_cast<rs_event_source>(motion.timestamp_data.source_id));
+                if(channel == imu_channels.end())
+                    break;
+                //a sample holds either the angular velocity or the linear acceleration, a covariance of -1 marks the values which are unknown
+                bool is_gyro = channel->first == rs_event_source::RS_EVENT_IMU_GYRO;
+                const double unknown[9] = { -1 };
+                const double known[9] = {};
+                auto velocity_covariance = is_gyro ? known : unknown;
+                auto acceleration_covariance = is_gyro ? unknown : known;
+                message.clear();
+                append_ros_header(message, static_cast<uint32_t>(motion.timestamp_data.frame_number), capture_time,
+                                  is_gyro ? "camera_gyro_frame" : "camera_accel_frame");
+                for(int i = 0; i < 4; i++)
+                    append_ros(message, 0.0);
+                for(auto value : unknown)
+                    append_ros(message, value);
+                for(int i = 0; i < 3; i++)
+                    append_ros(message, is_gyro ? static_cast<double>(motion.axes[i]) : 0.0);
+                for(int i = 0; i < 9; i++)
+                    append_ros(message, velocity_covariance[i]);
+                for(int i = 0; i < 3; i++)
+                    append_ros(message, is_gyro ? 0.0 : static_cast<double>(motion.axes[i]));
+                for(int i = 0; i < 9; i++)
+                    append_ros(message, acceleration_covariance[i]);
+                sts = writer.write_message(channel->second, capture_time * 1000, { { message.data(), message.size() } }, true);
+            }
+            break;
+            default:
+                break;
+        }
+    }
+    for(auto & frame : frames)
+    {
+        //the pending frames are waited for even after a failure, the decoder threads still use them
+        auto frame_sts = sts == status_no_error ? write_frame(frame) : status_no_error;
+        if(frame.decoded.valid())
+            frame.decoded.wait();
+        if(sts == status_no_error)
+            sts = frame_sts;
+    }
+
+    //the decoders of the temporal streams are past the playback position
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        for(auto stream : streams)
+        {
+            if(file_types::is_temporal_compression(m_streams_infos[stream].ctype))
+                m_unsynced_streams.insert(stream);
+        }
+    }
+    auto close_sts = writer.close();
+    if(sts == status_no_error)
+        sts = close_sts;
+    LOG_INFO("mcap export done, status - " << sts);
+    return sts;
+}
+
+status disk_read_base::read_encoded_image_data(const file_types::frame_sample & frame, std::vector<uint8_t> & data)
+{
+    core::file * data_file = m_file_data_read.get();
+    if(data_file->set_position(frame.info.offset, move_method::begin) != status_no_error)
+        return status_file_read_failed;
+    for(;;)
+    {
+        file_types::chunk_info chunk = {};
+        if(data_file->read_to_object(chunk) != status_no_error)
+            return status_file_read_failed;
+        switch(chunk.id)
+        {
+            case file_types::chunk_id::chunk_striped_sample_data:
+            {
+                file_types::disk_format::striped_sample_data reference = {};
+                if(data_file->read_to_object(reference, chunk.size) != status_no_error || reference.stripe >= m_stripe_files.size())
+                    return status_file_read_failed;
+                data_file = m_stripe_files[reference.stripe].get();
+                if(data_file->set_position(reference.offset, move_method::begin) != status_no_error)
+                    return status_file_read_failed;
+            }
+            break;
+            case file_types::chunk_id::chunk_repeated_sample_data:
+            {
+                //the data is read from the sample of the repeated frame, which is in the recording file
+                file_types::disk_format::repeated_sample_data reference = {};
+                uint64_t offset = 0;
+                if(data_file->read_to_object(reference, chunk.size) != status_no_error || get_repeated_frame_offset(frame.finfo, reference, offset) != status_no_error)
+                    return status_file_read_failed;
+                data_file = m_file_data_read.get();
+                if(data_file->set_position(offset, move_method::begin) != status_no_error)
+                    return status_file_read_failed;
+            }
+            break;
+            case file_types::chunk_id::chunk_sample_data:
+            {
+                if(chunk.size < m_format_traits.pitches_size)
+                    return status_file_read_failed;
+                data_file->set_position(m_format_traits.pitches_size, move_method::current);
+                data.resize(chunk.size - m_format_traits.pitches_size);
+                return data_file->read_to_object_array(data);
+            }
+            default:
+            {
+                if(chunk.size == 0)
+                    return status_file_read_failed;
+                data_file->set_position(chunk.size, move_method::current);
+            }
+        }
+    }
+}
+
+status disk_read_base::get_repeated_frame_offset(const file_types::frame_info & info, const file_types::disk_format::repeated_sample_data & reference,
+                                                 uint64_t & offset)
+{
+    //the repeated frame precedes the frame, so a corrupted reference can't loop
+    auto indices = m_image_indices.find(info.stream);
+    if(reference.frame_index >= info.index_in_stream || indices == m_image_indices.end() || reference.frame_index >= indices->second.size())
+    {
+        LOG_ERROR("invalid repeated frame reference, stream - " << info.stream << " frame index - " << reference.frame_index);
+        return status_file_read_failed;
+    }
+    offset = m_samples_desc.offset(indices->second[reference.frame_index]);
+    return status_no_error;
+}
+
+std::future<std::shared_ptr<file_types::frame_sample>> disk_read_base::seek_image_data(std::shared_ptr<file_types::frame_sample> &frame, bool decode_async)
+{
+    auto stream = frame->finfo.stream;
+    auto stream_info = m_streams_infos.find(stream);
+    if(stream_info == m_streams_infos.end() || !file_types::is_temporal_compression(stream_info->second.ctype))
+        return read_image_data(frame, decode_async);
+
+    //a keyframe is written at least every KEYFRAME_INTERVAL frames, the seek table points to the exact one
+    auto target = frame->finfo.index_in_stream;
+    uint32_t first = target >= compression::delta_codec::KEYFRAME_INTERVAL ? target - (compression::delta_codec::KEYFRAME_INTERVAL - 1) : 0;
+    auto keyframes = m_keyframes.find(stream);
+    if(keyframes != m_keyframes.end())
+    {
+        auto keyframe = std::upper_bound(keyframes->second.begin(), keyframes->second.end(), target);
+        if(keyframe != keyframes->second.begin())
+            first = *(--keyframe);
+    }
+
+    auto & indices = m_image_indices[stream];
+    //the frames of a stream are decoded in submission order, the decoded references aren't waited for
+    for(uint32_t index = first; index < target && index < indices.size(); index++)
+    {
+        auto reference = m_samples_desc.get_frame(indices[index]);
+        read_image_data(reference, decode_async);
+    }
+    return read_image_data(frame, decode_async);
+}
+
+void disk_read_base::resume()
+{
+    LOG_FUNC_SCOPE();
+
+    //resume while streaming is not allowed
+    if(m_is_scheduled)
+        throw std::runtime_error("resume while streaming is not allowed");
+
+    m_pause = false;
+    //reset time base on resume
+    update_time_base();
+    m_prefetch_controller.restart();
+    //the recordings which are played together continue by the time base of the recordings which are playing
+    if(m_clock)
+    {
+        uint64_t base_time = 0;
+        m_clock->join(this, m_base_ts + m_clock_offset, base_time, m_base_sys_time);
+        m_base_ts = base_time - m_clock_offset;
+        m_clock_position = base_time;
+    }
+
+    m_is_scheduled = true;
+    io_scheduler::instance().add(this);
+}
+
+void disk_read_base::pause()
+{
+    LOG_FUNC_SCOPE();
+
+    m_pause = true;
+    if(m_clock)
+        m_clock->leave(this);
+
+    //a reader whose read failed was already dropped by the io scheduler, the removal waits for its last turn anyway
+    io_scheduler::instance().remove(this);
+    if(!m_is_scheduled.exchange(false))
+        return;
+    LOG_INFO("Total number of dropped frames during playback - " << m_properties.get(rs_option::RS_OPTION_TOTAL_FRAME_DROPS));
+    LOG_INFO("Total number of dropped IMUs during playback - " << m_motion_drop_count);
+}
+
+int64_t disk_read_base::read_step()
+{
+    try
+    {
+        //the samples of a turn are read one after the other, the reads of the other readers wait for the next turn
+        for(int i = 0; i < NUMBER_OF_SAMPLES_PER_STEP && !m_pause; i++)
+        {
+            int64_t time_to_next_sample = 0;
+            if(!read_next_sample(time_to_next_sample))
+            {
+                //notify that reached the end of file
+                if(!m_eof_callback)
+                    throw std::runtime_error("end of file callback is null");
+                m_eof_callback();
+                m_pause = true;
+                //the other recordings don't wait for the samples of an ended recording
+                if(m_clock)
+                    m_clock->leave(this);
+                return -1;
+            }
+            if(time_to_next_sample > 0)
+                return time_to_next_sample;
+        }
+        return m_pause ? -1 : 0;
+    }
+    catch(const std::exception & ex)
+    {
+        //the io scheduler drops the reader, so the playback is paused and can be resumed
+        LOG_ERROR("failed to read the next samples, the playback is paused - " << ex.what());
+        m_pause = true;
+        if(m_clock)
+            m_clock->leave(this);
+        m_is_scheduled = false;
+        return -1;
+    }
+}
+
+void disk_read_base::init_decoder()
+{
+    std::map<rs_stream,file_types::compression_type> compression_config;
+    uint32_t buffer_size = 0;
+    for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
+    {
+        uint32_t size = it->second.m_stream_info.profile.info.width * it->second.m_stream_info.profile.info.height;
+        buffer_size = size > buffer_size ? size : buffer_size;
+        compression_config.emplace(it->first, it->second.m_stream_info.ctype);
+    }
+
+    m_decoder.reset(new compression::decoder(compression_config));
+    for(auto & dictionary : m_codec_dictionaries)
+        m_decoder->set_dictionary(dictionary.first, dictionary.second);
+    //encoded data is decoded directly from the mapped file, a staging buffer is required only for stream based read
+    if(!m_mapped_data_read)
+        m_encoded_data = std::vector<uint8_t>(buffer_size * 4);//stride is not availabe, taking worst case.
+}
+
+void disk_read_base::set_total_frame_drop_count(double value)
+{
+    m_properties.set(rs_option::RS_OPTION_TOTAL_FRAME_DROPS, value);
+}
+
+void disk_read_base::update_frame_drop_count(rs_stream stream, uint32_t frame_drop)
+{
+    m_frame_drop_count[stream] += frame_drop;
+    m_properties.add(rs_option::RS_OPTION_TOTAL_FRAME_DROPS, frame_drop);
+}
+
+void disk_read_base::update_imu_drop_count(uint32_t drop_count)
+{
+    m_motion_drop_count += drop_count;
+}
+
+void disk_read_base::reset()
+{
+    LOG_FUNC_SCOPE();
+    pause();
+    //the reverse playback starts from the end of the file
+    if(is_reverse())
+        index_samples(std::numeric_limits<uint32_t>::max());
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_file_data_read->reset();
+    m_samples_desc_index = is_reverse() ? static_cast<uint32_t>(m_samples_desc.size()) : 0;
+    m_batch_set.clear();
+    clear_read_ahead_samples();
+    clear_prefetched_samples();
+    for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
+    {
+        active_stream_info & asi = it->second;
+        asi.m_image_indices = m_image_indices[it->first];
+        asi.m_stream_info = m_streams_infos[it->first];
+    }
+    m_decoder.reset();
+    clear_loop();
+    m_is_loop_held = !is_reverse();
+}
+
+void disk_read_base::clear_loop()
+{
+    m_loop_samples.clear();
+    m_loop_samples_size = 0;
+    m_is_loop_held = false;
+    m_is_replaying_loop = false;
+    m_loop_position = 0;
+    m_loop_count = 0;
+}
+
+void disk_read_base::start_next_loop()
+{
+    if(m_loop_count == 0)
+    {
+        //the next loop starts a frame time of the slowest stream after the last sample of the file
+        int32_t min_frame_rate = 0;
+        for(auto & stream : m_active_streams_info)
+        {
+            auto frame_rate = stream.second.m_stream_info.profile.frame_rate;
+            if(frame_rate > 0 && (min_frame_rate == 0 || frame_rate < min_frame_rate))
+                min_frame_rate = frame_rate;
+        }
+        uint64_t frame_time = min_frame_rate > 0 ? 1000000 / min_frame_rate : 0;
+        m_loop_duration = m_samples_desc.capture_time(static_cast<uint32_t>(m_samples_desc.size() - 1)) - m_samples_desc.capture_time(0) + frame_time;
+        m_loop_frame_numbers.clear();
+        for(auto & stream : m_image_indices)
+        {
+            if(stream.second.empty())
+                continue;
+            auto first = m_samples_desc.frame_info(stream.second.front()).number;
+            auto last = m_samples_desc.frame_info(stream.second.back()).number;
+            m_loop_frame_numbers[stream.first] = last >= first ? last - first + 1 : stream.second.size();
+        }
+    }
+    m_loop_count++;
+    LOG_INFO("playback loop - " << m_loop_count << " ,held samples - " << m_loop_samples.size());
+    if(m_is_loop_held && !m_loop_samples.empty())
+    {
+        m_is_replaying_loop = true;
+        m_loop_position = 0;
+        return;
+    }
+    //the samples don't fit the memory, the file is read again from its beginning, the temporal codecs from their first keyframe
+    m_loop_samples.clear();
+    m_loop_samples_size = 0;
+    m_is_loop_held = false;
+    m_samples_desc_index = 0;
+    m_unsynced_streams.clear();
+    m_decimated_streams.clear();
+    m_decoder.reset();
+}
+
+void disk_read_base::hold_loop_sample(const std::shared_ptr<file_types::sample> & sample)
+{
+    if(!m_is_loop_held)
+        return;
+    auto frame = sample->info.type == file_types::sample_type::st_image ? std::static_pointer_cast<file_types::frame_sample>(sample) : nullptr;
+    uint64_t size = frame ? static_cast<uint64_t>(frame->finfo.stride) * frame->finfo.height : sizeof(file_types::motion_sample);
+    if(m_loop_samples_size + size > m_loop_memory_size)
+    {
+        LOG_INFO("the played samples exceed the loop memory size, the file is read at each loop");
+        m_loop_samples.clear();
+        m_loop_samples_size = 0;
+        m_is_loop_held = false;
+        return;
+    }
+    std::shared_ptr<file_types::sample> held = sample;
+    if(frame)
+    {
+        //the frame may point to the mapped file or to a pooled decoder buffer, the held copy owns its data
+        std::shared_ptr<uint8_t> data(new uint8_t[size], std::default_delete<uint8_t[]>());
+        memcpy(data.get(), frame->data, static_cast<size_t>(size));
+        auto copy = std::shared_ptr<file_types::frame_sample>(new file_types::frame_sample(frame.get()), [data](file_types::frame_sample * f) { delete f; });
+        copy->data = data.get();
+        held = copy;
+    }
+    m_loop_samples.push_back(held);
+    m_loop_samples_size += size;
+}
+
+std::shared_ptr<file_types::sample> disk_read_base::get_loop_sample(const std::shared_ptr<file_types::sample> & sample)
+{
+    uint64_t time_shift = m_loop_count * m_loop_duration;
+    double time_stamp_shift = static_cast<double>(time_shift) / 1000.0;
+    switch(sample->info.type)
+    {
+        case file_types::sample_type::st_image:
+        {
+            //the copy shares the data of the sample, which is kept alive by the copy deleter
+            auto frame = std::static_pointer_cast<file_types::frame_sample>(sample);
+            auto rv = std::shared_ptr<file_types::frame_sample>(new file_types::frame_sample(frame.get()), [frame](file_types::frame_sample * f) { delete f; });
+            rv->data = frame->data;
+            rv->info.capture_time += time_shift;
+            rv->finfo.time_stamp += time_stamp_shift;
+            rv->finfo.system_time += static_cast<long long>(time_shift / 1000);
+            rv->finfo.number += m_loop_count * m_loop_frame_numbers[rv->finfo.stream];
+            return rv;
+        }
+        case file_types::sample_type::st_motion:
+        {
+            auto rv = std::make_shared<file_types::motion_sample>(*std::static_pointer_cast<file_types::motion_sample>(sample));
+            rv->info.capture_time += time_shift;
+            rv->data.timestamp_data.timestamp += time_stamp_shift;
+            return rv;
+        }
+        case file_types::sample_type::st_time:
+        {
+            auto rv = std::make_shared<file_types::time_stamp_sample>(*std::static_pointer_cast<file_types::time_stamp_sample>(sample));
+            rv->info.capture_time += time_shift;
+            rv->data.timestamp += time_stamp_shift;
+            return rv;
+        }
+        default:
+            return sample;
+    }
+}
+
+void disk_read_base::replay_loop_sample()
+{
+    if(m_loop_position == m_loop_samples.size())
+        start_next_loop();
+    auto sample = get_loop_sample(m_loop_samples[m_loop_position++]);
+    std::lock_guard<std::mutex> guard(m_mutex);
+    //the replayed samples have no index, their position in the file isn't used while looping
+    indexed_sample prefetched = { static_cast<uint32_t>(m_samples_desc.size()), sample };
+    push_prefetched_sample(prefetched);
+}
+
+void disk_read_base::enable_stream(rs_stream stream, bool state)
+{
+    if(m_streams_infos.find(stream) == m_streams_infos.end())
+        throw std::runtime_error("unsupported stream");
+    if(state)
+    {
+        active_stream_info asi;
+        asi.m_image_indices = m_image_indices[stream];
+        asi.m_prefetched_samples_count = 0;
+        asi.m_stream_info = m_streams_infos[stream];
+        m_active_streams_info[stream] = asi;
+    }
+    else
+    {
+        if(m_active_streams_info.find(stream) != m_active_streams_info.end())
+            m_active_streams_info.erase(m_active_streams_info.find(stream));
+    }
+}
+
+void disk_read_base::enable_motions_callback(bool state)
+{
+    m_is_motion_tracking_enabled = state;
+}
+
+void disk_read_base::notify_available_samples()
+{
+    int64_t time_to_next_sample = 0;
+    while(!m_pause)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if(m_prefetched_samples.empty())break;
+        auto sample = m_prefetched_samples.front().sample;
+        time_to_next_sample = calc_sleep_time(sample);
+        if(time_to_next_sample > 0 && m_realtime)break;
+        //not in real time, the sample waits for the earlier samples of the recordings which are played together
+        if(!m_realtime && m_clock && !is_reverse() && !m_clock->is_due(sample->info.capture_time + m_clock_offset))break;
+        m_clock_position = sample->info.capture_time + m_clock_offset;
+
+        //handle next sample if its time has come
+        LOG_VERBOSE("calling callback, sample type - " << sample->info.type);
+        LOG_VERBOSE("calling callback, sample capture time - " << sample->info.capture_time);
+        m_sample_callback(sample);
+        pop_prefetched_sample();
+    }
+}
+
+void disk_read_base::read_ahead_sample(uint32_t sample_index)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    switch(m_samples_desc.type(sample_index))
+    {
+        case file_types::sample_type::st_image:
+        {
+            //don't prefatch frame if stream is disabled.
+            if(m_active_streams_info.find(m_samples_desc.stream(sample_index)) == m_active_streams_info.end()) return;
+            if(is_frame_skipped(sample_index)) return;
+            if(is_frame_decimated(sample_index))
+            {
+                if(file_types::is_temporal_compression(m_streams_infos[m_samples_desc.stream(sample_index)].ctype))
+                    m_decimated_streams.insert(m_samples_desc.stream(sample_index));
+                return;
+            }
+            auto frame = m_samples_desc.get_frame(sample_index);
+            indexed_sample sample = { sample_index, frame };
+            //frames of a stream with temporal compression are decoded from their keyframe when playing backwards,
+            //or when the decoder of the stream was used by the seeks
+            bool is_seek = is_reverse() || m_unsynced_streams.erase(frame->finfo.stream) > 0;
+            bool is_decimated = m_decimated_streams.erase(frame->finfo.stream) > 0;
+            auto data = is_seek ? seek_image_data(frame, m_read_ahead_window > 0) :
+                        is_decimated ? read_decimated_image_data(frame, m_read_ahead_window > 0) : read_image_data(frame, m_read_ahead_window > 0);
+            m_read_ahead_samples.emplace_back(sample, std::move(data));
+        }
+        break;
+        case file_types::sample_type::st_motion:
+        case file_types::sample_type::st_time:
+        {
+            if(m_is_motion_tracking_enabled)
+            {
+                indexed_sample sample = { sample_index, m_samples_desc.get_sample(sample_index) };
+                m_read_ahead_samples.emplace_back(sample, std::future<std::shared_ptr<file_types::frame_sample>>());
+            }
+        }
+        break;
+        case file_types::sample_type::st_debug_event:
+        break;
+        default:
+            throw std::runtime_error("undefind sample type");
+    }
+}
+
+bool disk_read_base::is_frame_skipped(uint32_t sample_index)
+{
+    if(!m_realtime || std::abs(m_playback_rate) <= 1)
+        return false;
+    auto & info = m_samples_desc.frame_info(sample_index);
+    //the frames of a stream with temporal compression are decoded one after the other when playing forward
+    if(!is_reverse() && file_types::is_temporal_compression(m_streams_infos[info.stream].ctype))
+        return false;
+    auto & stream_frames = m_image_indices[info.stream];
+    auto position = info.index_in_stream;
+    if(is_reverse() ? position == 0 : position + 1 >= stream_frames.size())
+        return false;
+    auto next_frame = stream_frames[is_reverse() ? position - 1 : position + 1];
+    return calc_sleep_time(m_samples_desc.capture_time(next_frame)) <= 0;
+}
+
+bool disk_read_base::is_frame_decimated(uint32_t sample_index)
+{
+    auto & info = m_samples_desc.frame_info(sample_index);
+    auto decimation = m_frame_decimations.find(info.stream);
+    if(decimation == m_frame_decimations.end())
+        return false;
+    auto position = info.index_in_stream;
+    if(decimation->second.frames_interval > 1 && position % decimation->second.frames_interval != 0)
+        return true;
+    //the first frame of each period is selected, so the selection doesn't depend on the playback direction
+    auto period = decimation->second.frame_period;
+    if(period == 0 || position == 0)
+        return false;
+    auto previous_frame = m_image_indices[info.stream][position - 1];
+    return m_samples_desc.capture_time(previous_frame) / period == m_samples_desc.capture_time(sample_index) / period;
+}
+
+std::future<std::shared_ptr<file_types::frame_sample>> disk_read_base::read_decimated_image_data(std::shared_ptr<file_types::frame_sample> &frame, bool decode_async)
+{
+    auto stream = frame->finfo.stream;
+    auto target = frame->finfo.index_in_stream;
+    auto position = m_decoded_positions.find(stream);
+    if(position == m_decoded_positions.end() || position->second >= target || target - position->second > compression::delta_codec::KEYFRAME_INTERVAL)
+        return seek_image_data(frame, decode_async);
+    auto first = position->second + 1;
+    auto keyframes = m_keyframes.find(stream);
+    if(keyframes != m_keyframes.end())
+    {
+        auto keyframe = std::upper_bound(keyframes->second.begin(), keyframes->second.end(), target);
+        if(keyframe != keyframes->second.begin() && *(keyframe - 1) > first)
+            first = *(keyframe - 1);
+    }
+    auto & indices = m_image_indices[stream];
+    for(uint32_t index = first; index < target && index < indices.size(); index++)
+    {
+        auto reference = m_samples_desc.get_frame(indices[index]);
+        read_image_data(reference, decode_async);
+    }
+    return read_image_data(frame, decode_async);
+}
+
+void disk_read_base::set_frame_decimation(rs_stream stream, uint32_t frames_interval, double frame_rate)
+{
+    if(frames_interval <= 1 && frame_rate <= 0)
+    {
+        m_frame_decimations.erase(stream);
+        return;
+    }
+    frame_decimation decimation = {};
+    decimation.frames_interval = frames_interval;
+    decimation.frame_period = frame_rate > 0 ? static_cast<uint64_t>(1000000 / frame_rate) : 0;
+    m_frame_decimations[stream] = decimation;
+}
+
+void disk_read_base::index_next_sample()
+{
+    while(!has_next_sample() && !m_is_index_complete && !is_reverse())
+        index_samples(NUMBER_OF_SAMPLES_TO_INDEX);
+}
+
+bool disk_read_base::set_playback_rate(double rate)
+{
+    if(std::abs(rate) < MIN_PLAYBACK_RATE || std::abs(rate) > MAX_PLAYBACK_RATE)
+        return false;
+    auto previous_state = m_pause;
+    pause();
+    if((rate < 0) != is_reverse())
+    {
+        //the playback turns around at the last delivered sample, the samples which were read ahead in the previous direction are dropped
+        if(rate < 0)
+            index_samples(std::numeric_limits<uint32_t>::max());
+        std::lock_guard<std::mutex> guard(m_mutex);
+        int64_t step = is_reverse() ? 1 : -1;
+        int64_t last_delivered = is_reverse() ? m_samples_desc_index : static_cast<int64_t>(m_samples_desc_index) - 1;
+        if(!m_prefetched_samples.empty())
+            last_delivered = static_cast<int64_t>(m_prefetched_samples.front().index) + step;
+        else if(!m_read_ahead_samples.empty())
+            last_delivered = static_cast<int64_t>(m_read_ahead_samples.front().first.index) + step;
+        clear_read_ahead_samples();
+        clear_loop();
+        clear_prefetched_samples();
+        m_batch_set.clear();
+        //a playback which didn't deliver any sample yet is played backwards from the end of the file
+        if(rate < 0)
+            m_samples_desc_index = last_delivered < 0 ? static_cast<uint32_t>(m_samples_desc.size()) : static_cast<uint32_t>(last_delivered);
+        else
+            m_samples_desc_index = static_cast<uint32_t>(std::min<int64_t>(last_delivered + 1, static_cast<int64_t>(m_samples_desc.size())));
+    }
+    m_playback_rate = rate;
+    LOG_INFO("playback rate - " << rate);
+    if(!previous_state)
+        resume();
+    return true;
+}
+
+void disk_read_base::set_frame_buffer_allocator(rs_stream stream, playback::frame_buffer_allocator allocator)
+{
+    //the cached frames were decoded into the playback buffers
+    m_frames_cache.clear();
+    if(allocator)
+        m_frame_buffer_allocators[stream] = allocator;
+    else
+        m_frame_buffer_allocators.erase(stream);
+}
+
+std::shared_ptr<uint8_t> disk_read_base::allocate_frame_buffer(const file_types::frame_info & info, uint32_t & stride)
+{
+    auto allocator = m_frame_buffer_allocators.find(info.stream);
+    if(allocator == m_frame_buffer_allocators.end())
+        return allocate_aligned_frame_buffer(info, stride);
+    int buffer_stride = info.stride;
+    auto buffer = allocator->second(info.width, info.height, info.bpp, buffer_stride);
+    if(!buffer)
+        return nullptr;
+    if(buffer_stride < info.stride)
+    {
+        LOG_ERROR("frame buffer stride " << buffer_stride << " is smaller than the frame stride " << info.stride << ", stream - " << info.stream);
+        return nullptr;
+    }
+    stride = static_cast<uint32_t>(buffer_stride);
+    return buffer;
+}
+
+std::shared_ptr<uint8_t> disk_read_base::allocate_aligned_frame_buffer(const file_types::frame_info & info, uint32_t & stride)
+{
+    const int32_t aligned_stride = image_interface::query_aligned_pitch(info.stride);
+    if(aligned_stride == info.stride || info.height <= 0)
+        return nullptr;
+    //the buffer of the process frame allocator is freed with the frame
+    auto buffer = std::make_shared<frame_buffer>(static_cast<size_t>(aligned_stride) * info.height);
+    if(!buffer->data())
+        return nullptr;
+    stride = static_cast<uint32_t>(aligned_stride);
+    return std::shared_ptr<uint8_t>(buffer->data(), [buffer](uint8_t *) {});
+}
+
+void disk_read_base::clear_read_ahead_samples()
+{
+    //the decoder workers may still use the codecs, wait for the issued frames before the next decode
+    for(auto & read_ahead : m_read_ahead_samples)
+    {
+        if(read_ahead.second.valid())
+            read_ahead.second.wait();
+    }
+    m_read_ahead_samples.clear();
+}
+
+void disk_read_base::hint_file_read_ahead(uint32_t sample_index)
+{
+    //the indexed samples offsets tell the range of the next reads, a remote file fetches it while the earlier samples are read
+    auto first_index = is_reverse() ? (sample_index > FILE_READ_AHEAD_SAMPLES ? sample_index - FILE_READ_AHEAD_SAMPLES : 0) : sample_index;
+    auto last_index = std::min<size_t>(is_reverse() ? sample_index + 1 : sample_index + FILE_READ_AHEAD_SAMPLES, m_samples_desc.size() - 1);
+    auto offset = m_samples_desc.offset(first_index);
+    auto end = m_samples_desc.offset(static_cast<uint32_t>(last_index));
+    if(end > offset)
+        m_file_data_read->read_ahead(offset, end - offset);
+}
+
+void disk_read_base::prefetch_sample()
+{
+    RS_PROFILER_ZONE("disk_read_base::prefetch_sample");
+    if(all_samples_bufferd())
+        return;
+    if(m_is_replaying_loop)
+    {
+        replay_loop_sample();
+        return;
+    }
+    auto read_start = rs::utils::timebase::now();
+    //keep the read ahead window full, the frames in the window are read and decoded while the earlier samples are delivered
+    while(has_next_sample() && m_read_ahead_samples.size() < std::max<uint32_t>(m_read_ahead_window, 1))
+    {
+        auto sample_index = is_reverse() ? --m_samples_desc_index : m_samples_desc_index++;
+        LOG_VERBOSE("process sample - " << sample_index);
+        if(!m_mapped_data_read)
+            hint_file_read_ahead(sample_index);
+        read_ahead_sample(sample_index);
+    }
+    RS_PROFILER_COUNTER("disk_read read ahead samples", m_read_ahead_samples.size());
+    if(m_read_ahead_samples.empty())
+        return;
+
+    //samples are prefetched in playback order, a frame that is still decoded is waited for
+    auto read_ahead = std::move(m_read_ahead_samples.front());
+    m_read_ahead_samples.pop_front();
+    auto sample = read_ahead.first.sample;
+    std::shared_ptr<file_types::sample> curr = sample;
+    if(read_ahead.second.valid())
+        curr = read_ahead.second.get();
+    if(!curr)
+        return;
+    if(m_loop_memory_size > 0 && !is_reverse())
+    {
+        if(m_loop_count == 0)
+            hold_loop_sample(curr);
+        else
+            curr = get_loop_sample(curr);
+    }
+
+    if(curr->info.type == file_types::sample_type::st_image)
+    {
+        auto read_time = rs::utils::timebase::microseconds_since(read_start);
+        m_prefetch_controller.add_read_time(std::static_pointer_cast<file_types::frame_sample>(curr)->finfo.stream, read_time);
+    }
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    indexed_sample prefetched = { read_ahead.first.index, curr };
+    push_prefetched_sample(prefetched);
+
+    LOG_VERBOSE("sample prefetched, sample type - " << sample->info.type);
+    LOG_VERBOSE("sample prefetched, sample capture time - " << sample->info.capture_time);
+}
+
+bool disk_read_base::read_next_sample(int64_t & time_to_next_sample)
+{
+    time_to_next_sample = 0;
+    //indicate to device all samples which time elapsed (timestamp is in the past of the playback clock)
+    notify_available_samples();
+    index_next_sample();
+    if(!m_is_replaying_loop && all_samples_read() && m_read_ahead_samples.empty() && m_prefetched_samples.size() == 0)
+    {
+        if(m_loop_memory_size == 0 || is_reverse() || m_samples_desc.size() == 0)
+            return false;
+        start_next_loop();
+    }
+    //optimize next reads - prefetch a single sample.
+    //This sample will be indicated to the device on the next iteration of the calling function if its time arrived.
+    //Can't fetch more than 1 sample without checking if need to indicate any sample from the prefetched queue
+    prefetch_sample();
+    update_clock_position();
+    //yield the io scheduler thread in case we have at least one frame ready for each stream, and playing in realtime
+    if(all_samples_bufferd() && m_realtime)
+    {
+        //use the time until the next sample to index the file
+        while((time_to_next_sample = calc_sleep_time(m_prefetched_samples.front().sample)) > 1000 && !m_is_index_complete)
+            index_samples(NUMBER_OF_SAMPLES_TO_INDEX);
+        if(time_to_next_sample <= 1000)
+            time_to_next_sample = 0;
+    }
+    return true;
+}
+
+uint32_t disk_read_base::scan_frames(uint64_t & position, std::vector<playback::frame_descriptor> & frames, uint32_t max_frames, bool read_metadata)
+{
+    frames.clear();
+    while(frames.size() < max_frames)
+    {
+        //the file is indexed up to the scan position, the index isn't reset by the scan
+        while(position >= m_samples_desc.size() && !m_is_index_complete)
+            index_samples(NUMBER_OF_SAMPLES_TO_INDEX_ON_SEEK);
+        if(position >= m_samples_desc.size())
+            break;
+        auto index = static_cast<uint32_t>(position++);
+        if(m_samples_desc.type(index) != file_types::sample_type::st_image)
+            continue;
+
+        auto & info = m_samples_desc.frame_info(index);
+        playback::frame_descriptor descriptor = {};
+        descriptor.stream = static_cast<rs::stream>(info.stream);
+        descriptor.frame_index = static_cast<int32_t>(info.index_in_stream);
+        descriptor.frame_number = info.number;
+        descriptor.time_stamp = info.time_stamp;
+        descriptor.time_stamp_domain = static_cast<rs::timestamp_domain>(info.time_stamp_domain);
+        descriptor.system_time = info.system_time;
+        descriptor.capture_time = m_samples_desc.capture_time(index);
+        if(read_metadata && m_format_traits.has_frame_metadata)
+        {
+            //the metadata chunks follow the frame headers and precede the image data chunk, which isn't read
+            file_types::frame_metadata_set metadata;
+            file_types::chunk_info chunk = {};
+            bool is_done = m_file_data_read->set_position(m_samples_desc.offset(index), move_method::begin) != status_no_error;
+            while(!is_done && m_file_data_read->read_to_object(chunk) == status_no_error)
+            {
+                switch(chunk.id)
+                {
+                    case file_types::chunk_id::chunk_sample_info:
+                    case file_types::chunk_id::chunk_frame_info:
+                        is_done = m_file_data_read->set_position(chunk.size, move_method::current) != status_no_error;
+                        break;
+                    case file_types::chunk_id::chunk_frame_metadata:
+                        is_done = read_frame_metadata(*m_file_data_read, metadata, chunk.size) == 0;
+                        break;
+                    case file_types::chunk_id::chunk_image_metadata:
+                        is_done = read_legacy_frame_metadata(*m_file_data_read, metadata, chunk.size) == 0;
+                        break;
+                    default:
+                        is_done = true;
+                        break;
+                }
+            }
+            for(int i = 0; i < RS_FRAME_METADATA_COUNT; i++)
+            {
+                auto id = static_cast<rs_frame_metadata>(i);
+                if(!metadata.supports(id))
+                    continue;
+                descriptor.metadata_mask |= 1u << i;
+                descriptor.metadata[i] = metadata.get(id);
+            }
+        }
+        frames.push_back(descriptor);
+    }
+    return static_cast<uint32_t>(frames.size());
 }
 
-void disk_read_base::set_total_frame_drop_count(double value)
+uint32_t disk_read_base::scan_samples(uint64_t & position, std::vector<sample_descriptor> & samples, uint32_t max_samples)
 {
-    m_properties[rs_option::RS_OPTION_TOTAL_FRAME_DROPS] = value;
+    samples.clear();
+    while(samples.size() < max_samples)
+    {
+        while(position >= m_samples_desc.size() && !m_is_index_complete)
+            index_samples(NUMBER_OF_SAMPLES_TO_INDEX_ON_SEEK);
+        if(position >= m_samples_desc.size())
+            break;
+        auto index = static_cast<uint32_t>(position++);
+
+        sample_descriptor descriptor = {};
+        descriptor.type = m_samples_desc.type(index);
+        descriptor.stream = m_samples_desc.stream(index);
+        descriptor.capture_time = m_samples_desc.capture_time(index);
+        descriptor.offset = m_samples_desc.offset(index);
+        if(descriptor.type == file_types::sample_type::st_image)
+            descriptor.frame = m_samples_desc.frame_info(index);
+        else if(descriptor.type == file_types::sample_type::st_debug_event)
+        {
+            descriptor.event_type = m_samples_desc.debug_event_type(index);
+            auto debug_data = m_samples_desc.debug_data(index);
+            if(debug_data)
+                descriptor.frame_drop_count = debug_data->frame_drop_count;
+        }
+        samples.push_back(descriptor);
+    }
+    return static_cast<uint32_t>(samples.size());
 }
 
-void disk_read_base::update_frame_drop_count(rs_stream stream, uint32_t frame_drop)
+uint32_t disk_read_base::read_frames_batch(std::vector<std::map<rs_stream, std::shared_ptr<file_types::frame_sample>>> & batch, uint32_t max_sets)
 {
-    m_frame_drop_count[stream] += frame_drop;
-    m_properties[rs_option::RS_OPTION_TOTAL_FRAME_DROPS] += frame_drop;
-}
+    //the caller owns the batch, clearing it keeps its capacity for the next call
+    batch.clear();
+    if(!m_pause)
+        throw std::runtime_error("batch read while streaming is not allowed");
 
-void disk_read_base::update_imu_drop_count(uint32_t drop_count)
-{
-    m_motion_drop_count += drop_count;
-}
+    //a set is closed when it holds a frame of each enabled stream, or when the next frame of a stream that is already in the set is read
+    auto close_set = [this, &batch]()
+    {
+        if(m_batch_set.empty())
+            return;
+        batch.push_back(std::move(m_batch_set));
+        m_batch_set.clear();
+    };
 
-void disk_read_base::reset()
-{
-    LOG_FUNC_SCOPE();
-    pause();
-    std::lock_guard<std::mutex> guard(m_mutex);
-    m_file_data_read->reset();
-    m_samples_desc_index = 0;
-    std::queue<std::shared_ptr<core::file_types::sample>> empty_queue;
-    std::swap(m_prefetched_samples, empty_queue);
-    for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
+    while(batch.size() < max_sets)
     {
-        active_stream_info & asi = it->second;
-        asi.m_image_indices = m_image_indices[it->first];
-        asi.m_prefetched_samples_count = 0;
-        asi.m_stream_info = m_streams_infos[it->first];
+        index_next_sample();
+        if(all_samples_read() && m_read_ahead_samples.empty() && m_prefetched_samples.empty())
+        {
+            close_set();
+            break;
+        }
+        //the read ahead window is filled by the prefetch, the samples are taken without pacing
+        prefetch_sample();
+
+        std::lock_guard<std::mutex> guard(m_mutex);
+        while(!m_prefetched_samples.empty() && batch.size() < max_sets)
+        {
+            auto sample = m_prefetched_samples.front().sample;
+            pop_prefetched_sample();
+            //motion samples are delivered by the motion callbacks only
+            if(sample->info.type != file_types::sample_type::st_image)
+                continue;
+            auto frame = std::static_pointer_cast<file_types::frame_sample>(sample);
+            auto stream = frame->finfo.stream;
+            if(m_batch_set.find(stream) != m_batch_set.end())
+                close_set();
+            m_batch_set[stream] = frame;
+            if(m_batch_set.size() == m_active_streams_info.size())
+                close_set();
+        }
     }
-    m_decoder.reset();
+    LOG_VERBOSE("batch read, number of sets - " << batch.size());
+    return static_cast<uint32_t>(batch.size());
 }
 
-void disk_read_base::enable_stream(rs_stream stream, bool state)
+status disk_read_base::compute_synced_sets(const std::vector<rs_stream> & streams, double max_time_difference, playback::synced_sets & sets)
 {
-    if(m_streams_infos.find(stream) == m_streams_infos.end())
-        throw std::runtime_error("unsupported stream");
-    if(state)
-    {
-        active_stream_info asi;
-        asi.m_image_indices = m_image_indices[stream];
-        asi.m_prefetched_samples_count = 0;
-        asi.m_stream_info = m_streams_infos[stream];
-        m_active_streams_info[stream] = asi;
-    }
-    else
+    LOG_FUNC_SCOPE();
+    sets = playback::synced_sets();
+    if(!m_pause)
+        return status_invalid_state;
+    if(streams.empty())
+        return status_invalid_argument;
+    int highest_fps = 0;
+    for(auto stream : streams)
     {
-        if(m_active_streams_info.find(stream) != m_active_streams_info.end())
-            m_active_streams_info.erase(m_active_streams_info.find(stream));
+        auto stream_info = m_streams_infos.find(stream);
+        if(stream_info == m_streams_infos.end())
+            return status_invalid_argument;
+        highest_fps = std::max(highest_fps, stream_info->second.profile.frame_rate);
     }
-}
+    //the tolerance of the samples time sync
+    if(max_time_difference <= 0)
+        max_time_difference = highest_fps > 0 ? 500.0 / highest_fps : 0;
 
-void disk_read_base::enable_motions_callback(bool state)
-{
-    m_is_motion_tracking_enabled = state;
-}
+    while(!m_is_index_complete)
+        index_samples(std::numeric_limits<uint32_t>::max());
 
-void disk_read_base::notify_available_samples()
-{
-    int64_t time_to_next_sample = 0;
-    while(!m_pause)
+    //the time stamps of each stream in a contiguous array, in stream order
+    std::vector<std::vector<double>> time_stamps(streams.size());
+    for(size_t i = 0; i < streams.size(); i++)
     {
-        std::lock_guard<std::mutex> guard(m_mutex);
-        if(m_prefetched_samples.empty())break;
-        time_to_next_sample = calc_sleep_time(m_prefetched_samples.front());
-        if(time_to_next_sample > 0 && m_realtime)break;
+        auto & stream_frames = m_image_indices[streams[i]];
+        time_stamps[i].resize(stream_frames.size());
+        for(size_t index = 0; index < stream_frames.size(); index++)
+            time_stamps[i][index] = m_samples_desc.frame_info(stream_frames[index]).time_stamp;
+    }
 
-        //handle next sample if its time has come
-        if(m_prefetched_samples.front()->info.type == file_types::sample_type::st_image)
+    for(auto stream : streams)
+        sets.streams.push_back(static_cast<rs::stream>(stream));
+    //the heads of the streams are aligned to the latest head, each step advances a head, so all the sets are matched in a single pass
+    std::vector<size_t> heads(streams.size(), 0);
+    for(;;)
+    {
+        double latest = -std::numeric_limits<double>::max();
+        for(size_t i = 0; i < heads.size(); i++)
         {
-            auto frame = std::dynamic_pointer_cast<file_types::frame_sample>(m_prefetched_samples.front());
-            if (frame)
-            {
-                m_active_streams_info[frame->finfo.stream].m_prefetched_samples_count--;
-                LOG_VERBOSE("calling callback, frame stream type - " << frame->finfo.stream);
-            }
+            if(heads[i] >= time_stamps[i].size())
+                return status_no_error;
+            latest = std::max(latest, time_stamps[i][heads[i]]);
+        }
+        bool is_aligned = true;
+        for(size_t i = 0; i < heads.size(); i++)
+        {
+            auto & stream_time_stamps = time_stamps[i];
+            auto & head = heads[i];
+            //frames earlier than the tolerance of the latest head have no match
+            while(head < stream_time_stamps.size() && stream_time_stamps[head] < latest - max_time_difference)
+                head++;
+            //a faster stream contributes its frame closest to the latest head
+            while(head + 1 < stream_time_stamps.size() && stream_time_stamps[head + 1] <= latest)
+                head++;
+            if(head >= stream_time_stamps.size())
+                return status_no_error;
+            if(stream_time_stamps[head] > latest)
+                is_aligned = false;
         }
-        LOG_VERBOSE("calling callback, sample type - " << m_prefetched_samples.front()->info.type);
-        LOG_VERBOSE("calling callback, sample capture time - " << m_prefetched_samples.front()->info.capture_time);
-        m_sample_callback(m_prefetched_samples.front());
-        m_prefetched_samples.pop();
+        //a head which passed the latest head raises it, the streams are aligned again
+        if(!is_aligned)
+            continue;
+        for(size_t i = 0; i < heads.size(); i++)
+            sets.frame_indices.push_back(static_cast<int32_t>(heads[i]++));
+        sets.time_stamps.push_back(latest);
     }
 }
 
-void disk_read_base::prefetch_sample()
+uint32_t disk_read_base::read_synced_sets(const playback::synced_sets & sets, uint32_t first_set, uint32_t max_sets,
+                                          std::vector<std::map<rs_stream, std::shared_ptr<file_types::frame_sample>>> & batch)
 {
-    if(m_samples_desc_index >= m_samples_desc.size() || all_samples_bufferd())
-        return;
-    LOG_VERBOSE("process sample - " << m_samples_desc_index);
-    auto sample = m_samples_desc[m_samples_desc_index];
-    m_samples_desc_index++;
-    std::lock_guard<std::mutex> guard(m_mutex);
-    switch(sample->info.type)
+    batch.clear();
+    if(!m_pause)
+        throw std::runtime_error("synced sets read while streaming is not allowed");
+    auto streams_count = sets.streams.size();
+    if(streams_count == 0 || sets.frame_indices.size() != sets.size() * streams_count)
+        return 0;
+
+    //all the frames of the batch are read before any of them is waited for, the streams are decoded in parallel by the decoder workers
+    std::vector<std::map<rs_stream, std::future<std::shared_ptr<file_types::frame_sample>>>> frames;
     {
-        case file_types::sample_type::st_image:
+        std::lock_guard<std::mutex> guard(m_mutex);
+        for(size_t set = first_set; set < sets.size() && frames.size() < max_sets; set++)
         {
-            auto frame = std::static_pointer_cast<file_types::frame_sample>(sample);
-            if (frame)
+            frames.emplace_back();
+            for(size_t i = 0; i < streams_count; i++)
             {
-                //don't prefatch frame if stream is disabled.
-                if(m_active_streams_info.find(frame->finfo.stream) == m_active_streams_info.end()) return;
-                auto curr = read_image_buffer(frame);
-                if(curr)
+                auto stream = static_cast<rs_stream>(sets.streams[i]);
+                auto index = static_cast<uint32_t>(sets.frame_indices[set * streams_count + i]);
+                auto & stream_frames = m_image_indices[stream];
+                if(index >= stream_frames.size())
+                    continue;
+                auto frame = m_samples_desc.get_frame(stream_frames[index]);
+                if(!frame)
+                    continue;
+                //the frames of a temporal stream which are skipped between the sets are decoded, a stream read backwards is decoded from its keyframe
+                bool is_temporal = file_types::is_temporal_compression(m_streams_infos[stream].ctype);
+                auto position = m_decoded_positions.find(stream);
+                if(is_temporal && position != m_decoded_positions.end() && position->second < index &&
+                   index - position->second <= compression::delta_codec::KEYFRAME_INTERVAL)
                 {
-                    m_active_streams_info[frame->finfo.stream].m_prefetched_samples_count++;
-                    m_prefetched_samples.push(curr);
+                    for(auto skipped = position->second + 1; skipped < index; skipped++)
+                    {
+                        auto skipped_frame = m_samples_desc.get_frame(stream_frames[skipped]);
+                        if(skipped_frame)
+                            read_image_data(skipped_frame, true);
+                    }
+                    frames.back()[stream] = read_image_data(frame, true);
                 }
+                else
+                    frames.back()[stream] = seek_image_data(frame, true);
+                //the decoder of the temporal stream is past the playback position
+                if(is_temporal)
+                    m_unsynced_streams.insert(stream);
             }
         }
-        break;
-        case file_types::sample_type::st_motion:
-        case file_types::sample_type::st_time:
-        {
-            if(m_is_motion_tracking_enabled)
-                m_prefetched_samples.push(sample);
-        }
-        break;
-        case file_types::sample_type::st_debug_event:
-        break;
-        default:
-            throw std::runtime_error("undefind sample type");
     }
-
-
-    LOG_VERBOSE("sample prefetched, sample type - " << sample->info.type);
-    LOG_VERBOSE("sample prefetched, sample capture time - " << sample->info.capture_time);
-}
-
-bool disk_read_base::read_next_sample()
-{
-    //indicate to device all samples which time elapsed (timestamp is in the past of the playback clock)
-    notify_available_samples();
-    while(m_samples_desc_index >= m_samples_desc.size() && !m_is_index_complete)
-        index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
-    if(m_samples_desc_index >= m_samples_desc.size() && m_prefetched_samples.size() == 0)
-        return false;
-    //optimize next reads - prefetch a single sample.
-    //This sample will be indicated to the device on the next iteration of the calling function if its time arrived.
-    //Can't fetch more than 1 sample without checking if need to indicate any sample from the prefetched queue
-    prefetch_sample();
-    //goto sleep in case we have at least one frame ready for each stream, and playing in realtime
-    if(all_samples_bufferd() && m_realtime)
+    for(auto & set : frames)
     {
-        int64_t time_to_next_sample;
-        while((time_to_next_sample  = calc_sleep_time(m_prefetched_samples.front())) > 1000)
+        batch.emplace_back();
+        for(auto & frame : set)
         {
-            if(m_is_index_complete)
-                std::this_thread::sleep_for(std::chrono::microseconds(time_to_next_sample));
-            else
-               index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
+            auto decoded = frame.second.get();
+            if(decoded)
+                batch.back()[frame.first] = decoded;
         }
     }
-    return true;
+    LOG_VERBOSE("synced sets read, number of sets - " << batch.size());
+    return static_cast<uint32_t>(batch.size());
 }
 
 bool disk_read_base::all_samples_bufferd()
 {
-    //no more samples to prefetch - all available samples are buffered
-    if(m_is_index_complete && m_samples_desc_index >= m_samples_desc.size() && m_prefetched_samples.size() > 0) return true;
+    //no more samples to prefetch - all available samples are buffered, the looped samples are replayed without an end
+    if(!m_is_replaying_loop && all_samples_read() && m_read_ahead_samples.empty() && m_prefetched_samples.size() > 0) return true;
 
+    //each stream has its next frame ready, and the frames which cover the read time of its following frames while the memory budget allows
+    bool is_over_budget = prefetch_controller::is_over_budget();
     for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
     {
-        if(it->second.m_prefetched_samples_count > 0) continue;//continue if at least one frame is ready
-        return false;
+        auto count = it->second.m_prefetched_samples_count;
+        if(count == 0) return false;
+        if(is_over_budget) continue;
+        auto & info = it->second.m_stream_info.profile.info;
+        auto frame_size = static_cast<uint64_t>(info.stride > 0 ? info.stride : info.width) * info.height;
+        if(count < m_prefetch_controller.required_frames(it->first, frame_size, m_active_streams_info.size())) return false;
     }
-    //no images streams enabled, only motions samples available.
-    return m_prefetched_samples.size() > (m_is_motion_tracking_enabled ? NUMBER_OF_REQUIRED_PREFETCHED_SAMPLES : 0);
+    //the motion samples cover the gaps between their bursts
+    if(m_is_motion_tracking_enabled)
+        return m_prefetched_samples.size() >= m_prefetch_controller.required_motions() || (is_over_budget && !m_active_streams_info.empty());
+    return m_prefetched_samples.size() > 0;
+}
+
+void disk_read_base::push_prefetched_sample(const indexed_sample & prefetched)
+{
+    if(prefetched.sample->info.type == file_types::sample_type::st_image)
+        m_active_streams_info[std::static_pointer_cast<file_types::frame_sample>(prefetched.sample)->finfo.stream].m_prefetched_samples_count++;
+    m_prefetch_controller.add_prefetched(*prefetched.sample);
+    m_prefetched_samples.push(prefetched);
+}
+
+void disk_read_base::pop_prefetched_sample()
+{
+    auto sample = m_prefetched_samples.front().sample;
+    if(sample->info.type == file_types::sample_type::st_image)
+        m_active_streams_info[std::static_pointer_cast<file_types::frame_sample>(sample)->finfo.stream].m_prefetched_samples_count--;
+    m_prefetch_controller.add_delivered(*sample);
+    m_prefetched_samples.pop();
+}
+
+void disk_read_base::clear_prefetched_samples()
+{
+    std::queue<indexed_sample> empty_queue;
+    std::swap(m_prefetched_samples, empty_queue);
+    for(auto & stream : m_active_streams_info)
+        stream.second.m_prefetched_samples_count = 0;
+    m_prefetch_controller.clear();
 }
 
 bool disk_read_base::is_stream_profile_available(rs_stream stream, int width, int height, rs_format format, int framerate)
@@ -375,8 +2080,9 @@ std::map<rs_stream, std::shared_ptr<rs::core::file_types::frame_sample>> disk_re
     auto previous_state = m_pause;
 
     pause();
+    clear_loop();
 
-    while(index >= m_image_indices[stream_type].size() && !m_is_index_complete) index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
+    while(index >= m_image_indices[stream_type].size() && !m_is_index_complete) index_samples(NUMBER_OF_SAMPLES_TO_INDEX);
 
     if (index >= m_image_indices[stream_type].size()) return rv;
 
@@ -398,29 +2104,29 @@ std::map<rs_stream, std::shared_ptr<rs::core::file_types::frame_sample>> disk_re
     auto previous_state = m_pause;
 
     pause();
+    clear_loop();
     rs_stream stream = rs_stream::RS_STREAM_COUNT;
     uint32_t index = 0;
     // Index the streams until we have at least a stream whose time stamp is bigger than ts.
-    do
+    // The frames of each stream are searched by time stamp, the earliest frame in the file is the target.
+    for(;;)
     {
-        if(index >= m_samples_desc.size())
-        {
-            if(m_is_index_complete)return rv;
-            index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
-        }
         {
-            if(index >= m_samples_desc.size())continue;
             std::lock_guard<std::mutex> guard(m_mutex);
-            if(m_samples_desc[index]->info.type != file_types::sample_type::st_image)continue;
-            auto frame = std::dynamic_pointer_cast<file_types::frame_sample>(m_samples_desc[index]);
-            if(frame->finfo.time_stamp >= (double)ts)
+            for(auto & stream_frames : m_image_indices)
             {
-                stream = frame->finfo.stream;
-                break;
+                auto frame_index = m_samples_desc.find_frame_by_time_stamp(stream_frames.first, static_cast<double>(ts));
+                if(frame_index == samples_index::NO_SAMPLE)continue;
+                if(stream == rs_stream::RS_STREAM_COUNT || frame_index < index)
+                {
+                    stream = stream_frames.first;
+                    index = frame_index;
+                }
             }
         }
+        if(stream != rs_stream::RS_STREAM_COUNT || m_is_index_complete)break;
+        index_samples(NUMBER_OF_SAMPLES_TO_INDEX_ON_SEEK);
     }
-    while(++index);
 
     if(stream == rs_stream::RS_STREAM_COUNT) return rv;
 
@@ -436,73 +2142,183 @@ std::map<rs_stream, std::shared_ptr<rs::core::file_types::frame_sample>> disk_re
     return rv;
 }
 
-std::map<rs_stream, std::shared_ptr<file_types::frame_sample> > disk_read_base::find_nearest_frames(uint32_t sample_index, rs_stream stream)
+std::map<rs_stream, std::shared_ptr<rs::core::file_types::frame_sample>> disk_read_base::set_frame_by_capture_time(uint64_t capture_time)
 {
     std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> rv;
+    auto previous_state = m_pause;
+
+    pause();
+    clear_loop();
+    //the capture times are in file order, the file is indexed past the capture time
+    while(!m_is_index_complete && (m_samples_desc.size() == 0 || m_samples_desc.capture_time(static_cast<uint32_t>(m_samples_desc.size() - 1)) < capture_time))
+        index_samples(NUMBER_OF_SAMPLES_TO_INDEX_ON_SEEK);
+
+    rs_stream stream = rs_stream::RS_STREAM_COUNT;
+    uint32_t index = 0;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        for(auto & stream_frames : m_image_indices)
+        {
+            auto frame_index = std::lower_bound(stream_frames.second.begin(), stream_frames.second.end(), capture_time,
+                                                [this](uint32_t sample_index, uint64_t time) { return m_samples_desc.capture_time(sample_index) < time; });
+            if(frame_index == stream_frames.second.end())continue;
+            if(stream == rs_stream::RS_STREAM_COUNT || *frame_index < index)
+            {
+                stream = stream_frames.first;
+                index = *frame_index;
+            }
+        }
+    }
+
+    if(stream == rs_stream::RS_STREAM_COUNT) return rv;
+
+    rv = find_nearest_frames(index, stream);
+
+    LOG_VERBOSE("requested capture time - " << capture_time << " ,set index to - " << index);
+
+    if(!previous_state)
+        resume();
+
+    return rv;
+}
 
-    std::map<rs_stream, uint64_t> prev_index;
-    std::map<rs_stream, uint64_t> next_index;
-    auto index = sample_index;
-    while(index > 0 && prev_index.size() < m_active_streams_info.size())
+uint64_t disk_read_base::query_start_time()
+{
+    //the recordings of the cameras of a host are aligned by the host time of their frames
+    for(uint32_t index = 0;; index++)
     {
-        index--;
-        if(m_samples_desc[index]->info.type != file_types::sample_type::st_image)continue;
-        auto frame = std::dynamic_pointer_cast<file_types::frame_sample>(m_samples_desc[index]);
-        if(prev_index.find(frame->finfo.stream) != prev_index.end())continue;
-        prev_index[frame->finfo.stream] = index;
+        while(index >= m_samples_desc.size() && !m_is_index_complete)
+            index_samples(NUMBER_OF_SAMPLES_TO_INDEX_ON_SEEK);
+        if(index >= m_samples_desc.size())
+            return 0;
+        if(m_samples_desc.type(index) != file_types::sample_type::st_image)
+            continue;
+        auto system_time = static_cast<uint64_t>(std::max<long long>(m_samples_desc.frame_info(index).system_time, 0)) * 1000;
+        auto capture_time = m_samples_desc.capture_time(index);
+        return system_time > capture_time ? system_time - capture_time : 0;
     }
-    index = sample_index;
-    while(next_index.size() < m_active_streams_info.size())
+}
+
+std::map<rs_stream, std::shared_ptr<file_types::frame_sample> > disk_read_base::find_nearest_frames(uint32_t sample_index, rs_stream stream)
+{
+    std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> rv;
+
+    clear_read_ahead_samples();
+
+    //the nearest frame of each stream is the frame before or after the sample, found by a binary search in the stream frames
+    std::map<rs_stream, uint32_t> nearest_index;
+    auto capture_time = m_samples_desc.capture_time(sample_index);
+    auto distance = [this, capture_time](uint32_t index)
+    {
+        auto frame_capture_time = m_samples_desc.capture_time(index);
+        return capture_time > frame_capture_time ? capture_time - frame_capture_time : frame_capture_time - capture_time;
+    };
+    for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
     {
-        if(index + 1 >= m_samples_desc.size())
+        if(it->first == stream)
+        {
+            nearest_index[stream] = sample_index;
+            continue;
+        }
+        auto & stream_frames = m_image_indices[it->first];
+        while((stream_frames.empty() || stream_frames.back() <= sample_index) && !m_is_index_complete)
+            index_samples(NUMBER_OF_SAMPLES_TO_INDEX_ON_SEEK);
+        auto next = std::upper_bound(stream_frames.begin(), stream_frames.end(), sample_index);
+        if(next == stream_frames.begin())
         {
-            if(m_is_index_complete)break;
-            index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
+            if(next != stream_frames.end())
+                nearest_index[it->first] = *next;
+            continue;
         }
-        if(index + 1 >= m_samples_desc.size())continue;
-        index++;
-        if(m_samples_desc[index]->info.type != file_types::sample_type::st_image)continue;
-        auto frame = std::dynamic_pointer_cast<file_types::frame_sample>(m_samples_desc[index]);
-        if(next_index.find(frame->finfo.stream) != next_index.end())continue;
-        next_index[frame->finfo.stream] = index;
+        auto prev = next - 1;
+        nearest_index[it->first] = next != stream_frames.end() && distance(*prev) > distance(*next) ? *next : *prev;
     }
-    auto capture_time = m_samples_desc[sample_index]->info.capture_time;
-    for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
+    //the frames of all the streams are read before any of them is waited for, the streams are decoded in parallel by the decoder workers
+    std::vector<std::future<std::shared_ptr<file_types::frame_sample>>> frames;
     {
         std::lock_guard<std::mutex> guard(m_mutex);
-
-        std::shared_ptr<file_types::sample> sample;
-        if(it->first == stream)
-            sample = m_samples_desc[sample_index];
-        else
+        for(auto & nearest : nearest_index)
         {
-            auto prev = capture_time > m_samples_desc[prev_index[it->first]]->info.capture_time ?
-                (capture_time - m_samples_desc[prev_index[it->first]]->info.capture_time ):
-                ( m_samples_desc[prev_index[it->first]]->info.capture_time - capture_time );
-            auto next = capture_time > m_samples_desc[next_index[it->first]]->info.capture_time ?
-                capture_time - m_samples_desc[next_index[it->first]]->info.capture_time :
-                m_samples_desc[next_index[it->first]]->info.capture_time - capture_time;
-            sample = prev > next ? m_samples_desc[next_index[it->first]] : m_samples_desc[prev_index[it->first]];
+            auto frame = m_samples_desc.get_frame(nearest.second);
+            if(!frame)
+                continue;
+            //scrubbing over the same range returns the cached frames, without reading the file
+            bool is_cached = m_frame_buffer_allocators.find(nearest.first) == m_frame_buffer_allocators.end();
+            auto cached = is_cached ? m_frames_cache.find(nearest.first, frame->finfo.index_in_stream) : nullptr;
+            if(cached)
+            {
+                rv[nearest.first] = cached;
+                if(file_types::is_temporal_compression(m_streams_infos[nearest.first].ctype))
+                    m_unsynced_streams.insert(nearest.first);
+                continue;
+            }
+            frames.push_back(seek_image_data(frame, true));
+            m_unsynced_streams.erase(nearest.first);
         }
-        auto frame = std::dynamic_pointer_cast<file_types::frame_sample>(sample);
-        if (frame)
+    }
+    for(auto & frame : frames)
+    {
+        auto curr = frame.get();
+        if(!curr)
+            continue;
+        auto stream = curr->finfo.stream;
+        rv[stream] = curr;
+        if(m_frame_buffer_allocators.find(stream) == m_frame_buffer_allocators.end())
         {
-            auto curr = read_image_buffer(frame);
-            if(curr)
-                rv[frame->finfo.stream] = curr;
+            //the returned frame is modified by the playback, the cache keeps its own copy
+            m_frames_cache.add(curr);
+            rv[stream] = m_frames_cache.find(stream, curr->finfo.index_in_stream);
+            if(!rv[stream])
+                rv[stream] = curr;
         }
     }
     {
         std::lock_guard<std::mutex> guard(m_mutex);
+        m_frames_cache.resolve_pending();
+        for(auto & frame : rv)
+        {
+            if(m_frame_buffer_allocators.find(frame.first) == m_frame_buffer_allocators.end())
+                read_ahead_scrubbed_frames(frame.first, frame.second->finfo.index_in_stream);
+        }
         m_samples_desc_index = sample_index;
+        clear_prefetched_samples();
     }
-    std::queue<std::shared_ptr<core::file_types::sample>> empty_queue;
-    std::swap(m_prefetched_samples, empty_queue);
+    m_batch_set.clear();
     prefetch_sample();
     LOG_VERBOSE("update " << rv.size() << " frames");
     return rv;
 }
 
+void disk_read_base::read_ahead_scrubbed_frames(rs_stream stream, uint32_t index_in_stream)
+{
+    auto position = m_scrub_positions.find(stream);
+    int64_t direction = position != m_scrub_positions.end() && position->second > index_in_stream ? -1 : 1;
+    m_scrub_positions[stream] = index_in_stream;
+
+    auto & stream_frames = m_image_indices[stream];
+    //the frames which follow each other forward are decoded in order, only the first is decoded from its keyframe
+    bool is_sequential = false;
+    for(uint32_t i = 1; i <= SCRUB_READ_AHEAD_FRAMES; i++)
+    {
+        int64_t index = static_cast<int64_t>(index_in_stream) + direction * i;
+        if(index < 0 || index >= static_cast<int64_t>(stream_frames.size()))
+            break;
+        if(m_frames_cache.contains(stream, static_cast<uint32_t>(index)))
+        {
+            is_sequential = false;
+            continue;
+        }
+        auto frame = m_samples_desc.get_frame(stream_frames[static_cast<size_t>(index)]);
+        if(!frame)
+            break;
+        auto decoded = is_sequential ? read_image_data(frame, true) : seek_image_data(frame, true);
+        m_frames_cache.add_pending(stream, static_cast<uint32_t>(index), std::move(decoded));
+        is_sequential = direction > 0;
+        if(file_types::is_temporal_compression(m_streams_infos[stream].ctype))
+            m_unsynced_streams.insert(stream);
+    }
+}
+
 void disk_read_base::set_realtime(bool realtime)
 {
     this->m_realtime = realtime;
@@ -519,24 +2335,47 @@ uint32_t disk_read_base::query_number_of_frames(rs_stream stream_type)
     if (nframes > 0) return nframes;
 
     /* If not able to get from the header, let's count */
-    while (!m_is_index_complete) index_next_samples(std::numeric_limits<uint32_t>::max());
+    index_samples(std::numeric_limits<uint32_t>::max());
 
     return (int32_t)m_image_indices[stream_type].size();
 }
 
+void disk_read_base::index_samples(uint32_t number_of_samples)
+{
+    if(m_is_index_complete)
+        return;
+    //the file reads the headers ahead of the indexing, a mapped file pages them in, other files read them by large blocks
+    uint64_t position = 0;
+    m_file_indexing->get_position(&position);
+    if(position + INDEX_READ_AHEAD_SIZE / 2 >= m_index_read_ahead_position)
+    {
+        m_file_indexing->read_ahead(position, INDEX_READ_AHEAD_SIZE);
+        m_index_read_ahead_position = position + INDEX_READ_AHEAD_SIZE;
+    }
+    index_next_samples(number_of_samples);
+    m_file_indexing->get_position(&position);
+    m_index_position = position;
+}
+
+double disk_read_base::query_index_progress()
+{
+    if(m_is_index_complete || m_file_size == 0)
+        return 1;
+    return std::min(static_cast<double>(m_index_position) / static_cast<double>(m_file_size), 1.0);
+}
+
 uint64_t disk_read_base::query_run_time()
 {
-    auto now = std::chrono::high_resolution_clock::now();
-    return std::chrono::duration_cast<std::chrono::microseconds>(now - m_base_sys_time).count();
+    return rs::utils::timebase::microseconds_since(m_base_sys_time);
 }
 
-int64_t disk_read_base::calc_sleep_time(std::shared_ptr<file_types::sample> sample)
+int64_t disk_read_base::calc_sleep_time(uint64_t capture_time)
 {
     auto time_span = query_run_time();
-    auto time_stamp = sample->info.capture_time;
     //number of miliseconds to wait - the diff in milisecond between the last call for streaming resume
-    //and the recorded time.
-    int64_t wait_for = static_cast<int>(time_stamp - m_base_ts - time_span);
+    //and the recorded time, the recorded time passes backwards in reverse playback.
+    auto recorded_time_span = static_cast<double>(static_cast<int64_t>(capture_time - m_base_ts)) / m_playback_rate;
+    int64_t wait_for = static_cast<int64_t>(recorded_time_span) - static_cast<int64_t>(time_span);
     LOG_VERBOSE("sleep length " << wait_for << " miliseconds");
     LOG_VERBOSE("total run time - " << time_span);
     return wait_for;
@@ -544,23 +2383,44 @@ int64_t disk_read_base::calc_sleep_time(std::shared_ptr<file_types::sample> samp
 
 void disk_read_base::update_time_base()
 {
-    m_base_sys_time = std::chrono::high_resolution_clock::now();
+    m_base_sys_time = rs::utils::timebase::now();
 
     std::lock_guard<std::mutex> guard(m_mutex);
-    if(m_samples_desc_index > 0)
-    {
-        if(m_prefetched_samples.size() > 0)
-            m_base_ts = m_prefetched_samples.front()->info.capture_time;
-        else
-            m_base_ts = m_samples_desc_index < m_samples_desc.size() ?
-                        m_samples_desc[m_samples_desc_index]->info.capture_time : 0;
-    }
+    if(m_prefetched_samples.size() > 0 && (m_samples_desc_index > 0 || is_reverse() || m_loop_count > 0))
+        m_base_ts = m_prefetched_samples.front().sample->info.capture_time;
+    else if(m_is_replaying_loop)
+        m_base_ts = m_loop_position < m_loop_samples.size() ? m_loop_samples[m_loop_position]->info.capture_time + m_loop_count * m_loop_duration :
+                                                               m_loop_samples.front()->info.capture_time + (m_loop_count + 1) * m_loop_duration;
+    else if(is_reverse())
+        m_base_ts = m_samples_desc_index > 0 ? m_samples_desc.capture_time(m_samples_desc_index - 1) : 0;
+    else if(m_samples_desc_index > 0)
+        m_base_ts = m_samples_desc_index < m_samples_desc.size() ?
+                    m_samples_desc.capture_time(m_samples_desc_index) : 0;
     else
         m_base_ts = 0;
+    //a loop which reads the file again plays the file times of the loop
+    if(!m_is_replaying_loop && !is_reverse() && m_prefetched_samples.empty())
+        m_base_ts += m_loop_count * m_loop_duration;
+
+    //the playing recordings keep the time base of the shared clock
+    if(m_clock && m_is_scheduled)
+    {
+        uint64_t base_time = 0;
+        m_clock->get_time_base(base_time, m_base_sys_time);
+        m_base_ts = base_time - m_clock_offset;
+    }
 
     LOG_VERBOSE("new time base - " << m_base_ts);
 }
 
+void disk_read_base::update_clock_position()
+{
+    if(!m_clock)
+        return;
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_clock->set_position(this, m_prefetched_samples.empty() ? m_clock_position : m_prefetched_samples.front().sample->info.capture_time + m_clock_offset);
+}
+
 file_types::version disk_read_base::query_sdk_version()
 {
     return m_sw_info.sdk;
@@ -571,31 +2431,135 @@ file_types::version disk_read_base::query_librealsense_version()
     return m_sw_info.librealsense;
 }
 
+uint32_t disk_read_base::read_frame_metadata(core::file & source, file_types::frame_metadata_set & metadata, unsigned long num_bytes_to_read)
+{
+    file_types::disk_format::frame_metadata_header header = {};
+    double values[file_types::frame_metadata_set::MAX_METADATA_COUNT];
+    uint32_t num_bytes_read = 0;
+    if(num_bytes_to_read < sizeof(header) || num_bytes_to_read > sizeof(header) + sizeof(values) ||
+       source.read_to_object(header) != status_no_error)
+    {
+        LOG_ERROR("failed to read frame metadata, metadata size is not valid");
+        source.set_position(num_bytes_to_read, move_method::current);
+        return static_cast<uint32_t>(num_bytes_to_read);
+    }
+    auto values_size = static_cast<uint32_t>(num_bytes_to_read - sizeof(header));
+    if(source.read_bytes(values, values_size, num_bytes_read) != status_no_error || num_bytes_read != values_size)
+        return 0;
+    uint32_t values_count = 0;
+    for(int i = 0; i < file_types::frame_metadata_set::MAX_METADATA_COUNT && values_count * sizeof(double) < values_size; i++)
+    {
+        if(header.mask & (1u << i))
+            metadata.set(static_cast<rs_frame_metadata>(i), values[values_count++]);
+    }
+    return static_cast<uint32_t>(num_bytes_to_read);
+}
+
+uint32_t disk_read_base::read_legacy_frame_metadata(core::file & source, file_types::frame_metadata_set & metadata, unsigned long num_bytes_to_read)
+{
+    file_types::disk_format::frame_metadata_pair pairs[file_types::frame_metadata_set::MAX_METADATA_COUNT];
+    uint32_t num_bytes_read = 0;
+    if(num_bytes_to_read % sizeof(pairs[0]) != 0 || num_bytes_to_read > sizeof(pairs)) //num_bytes_to_read must be a multiplication of the pair size
+    {
+        //in case data size is not valid move file pointer to the next chunk
+        LOG_ERROR("failed to read frame metadata, metadata size is not valid");
+        source.set_position(num_bytes_to_read, move_method::current);
+        return static_cast<uint32_t>(num_bytes_to_read);
+    }
+    if(source.read_bytes(pairs, static_cast<uint32_t>(num_bytes_to_read), num_bytes_read) != status_no_error)
+        return 0;
+    for(size_t i = 0; i < num_bytes_read / sizeof(pairs[0]); i++)
+    {
+        if(!metadata.supports(pairs[i].id))
+            metadata.set(pairs[i].id, pairs[i].value);
+    }
+    return num_bytes_read;
+}
+
 std::shared_ptr<file_types::frame_sample> disk_read_base::read_image_buffer(std::shared_ptr<file_types::frame_sample> &frame)
 {
-    status sts = m_file_data_read->set_position(frame->info.offset, move_method::begin);
+    return read_image_data(frame, false).get();
+}
+
+void disk_read_base::open_shared_frames_cache()
+{
+    const uint64_t size = get_shared_frames_cache_size();
+    if(size == 0)
+        return;
+    if(!shared_frames_cache::query_file_key(m_file_path, m_file_key))
+    {
+        LOG_WARN("the recording can't be identified, the host frames cache isn't used");
+        return;
+    }
+    //a slot fits the largest decoded frame of the recording, with its rows padded to the row alignment
+    uint64_t slot_size = 0;
+    for(auto & stream_info : m_streams_infos)
+    {
+        auto & info = stream_info.second.profile.info;
+        const uint64_t frame_size = static_cast<uint64_t>(image_interface::query_aligned_pitch(info.stride)) * info.height;
+        slot_size = std::max(slot_size, frame_size);
+    }
+    if(slot_size == 0 || slot_size > std::numeric_limits<uint32_t>::max())
+        return;
+    m_shared_frames_cache = shared_frames_cache::open(SHARED_FRAMES_CACHE_NAME, size, static_cast<uint32_t>(slot_size));
+    if(!m_shared_frames_cache)
+        LOG_WARN("failed to open the host frames cache, size - " << size << " slot size - " << slot_size);
+}
+
+std::future<std::shared_ptr<file_types::frame_sample>> disk_read_base::share_decoded_frame(std::future<std::shared_ptr<file_types::frame_sample>> decoded,
+                                                                                           const shared_frames_cache::frame_key & key)
+{
+    //the frame is added on the thread which waits for it, the decoder workers don't copy frames
+    auto cache = m_shared_frames_cache;
+    auto shared = decoded.share();
+    return std::async(std::launch::deferred, [cache, key, shared]()
+    {
+        auto frame = shared.get();
+        if(frame)
+            cache->add(key, *frame);
+        return frame;
+    });
+}
+
+std::future<std::shared_ptr<file_types::frame_sample>> disk_read_base::read_image_data(std::shared_ptr<file_types::frame_sample> &frame, bool decode_async)
+{
+    //the data chunk of a striped stream is read from its stripe file
+    core::file * data_file = m_file_data_read.get();
+    core::mapped_file * mapped_data_file = m_mapped_data_read;
+    status sts = data_file->set_position(frame->info.offset, move_method::begin);
+    m_decoded_positions[frame->finfo.stream] = frame->finfo.index_in_stream;
 
     if(!m_decoder)
         init_decoder();
 
     if(sts != status::status_no_error)
-        return nullptr;
+        return ready_frame(nullptr);
 
     uint32_t num_bytes_read = 0;
     unsigned long num_bytes_to_read = 0;
+    //the chunks of the sample of a repeated frame are read up to its data, the metadata of the frame is kept
+    bool is_repeated = false;
 
     file_types::chunk_info chunk = {};
     for (;;)
     {
-        m_file_data_read->read_bytes(&chunk, sizeof(chunk), num_bytes_read);
+        data_file->read_bytes(&chunk, sizeof(chunk), num_bytes_read);
         num_bytes_to_read = chunk.size;
         switch (chunk.id)
         {
             case file_types::chunk_id::chunk_image_metadata:
+            case file_types::chunk_id::chunk_frame_metadata:
             {
-                if(num_bytes_to_read > 0)
+                if(!m_format_traits.has_frame_metadata || is_repeated)
+                {
+                    m_file_data_read->set_position(num_bytes_to_read, move_method::current);
+                }
+                else if(num_bytes_to_read > 0)
                 {
-                    read_frame_metadata(frame, num_bytes_to_read);
+                    if(chunk.id == file_types::chunk_id::chunk_frame_metadata)
+                        read_frame_metadata(*m_file_data_read, frame->metadata, num_bytes_to_read);
+                    else
+                        read_legacy_frame_metadata(*m_file_data_read, frame->metadata, num_bytes_to_read);
                 }
                 else
                 {
@@ -603,30 +2567,136 @@ std::shared_ptr<file_types::frame_sample> disk_read_base::read_image_buffer(std:
                 }
                 break;
             }
+            case file_types::chunk_id::chunk_striped_sample_data:
+            {
+                file_types::disk_format::striped_sample_data reference = {};
+                if(data_file->read_to_object(reference, static_cast<uint32_t>(num_bytes_to_read)) != status_no_error || reference.stripe >= m_stripe_files.size())
+                {
+                    LOG_ERROR("failed to read the striped sample data reference");
+                    return ready_frame(nullptr);
+                }
+                data_file = m_stripe_files[reference.stripe].get();
+                mapped_data_file = m_mapped_stripe_files[reference.stripe];
+                if(data_file->set_position(reference.offset, move_method::begin) != status_no_error)
+                    return ready_frame(nullptr);
+                break;
+            }
+            case file_types::chunk_id::chunk_repeated_sample_data:
+            {
+                file_types::disk_format::repeated_sample_data reference = {};
+                uint64_t offset = 0;
+                if(data_file->read_to_object(reference, static_cast<uint32_t>(num_bytes_to_read)) != status_no_error ||
+                   get_repeated_frame_offset(frame->finfo, reference, offset) != status_no_error)
+                    return ready_frame(nullptr);
+                is_repeated = true;
+                data_file = m_file_data_read.get();
+                mapped_data_file = m_mapped_data_read;
+                if(data_file->set_position(offset, move_method::begin) != status_no_error)
+                    return ready_frame(nullptr);
+                break;
+            }
             case file_types::chunk_id::chunk_sample_data:
             {
-                m_file_data_read->set_position(size_of_pitches(),move_method::current);
-                num_bytes_to_read -= size_of_pitches();
+                data_file->set_position(m_format_traits.pitches_size, move_method::current);
+                num_bytes_to_read -= m_format_traits.pitches_size;
                 switch (frame->finfo.ctype)
                 {
                     case file_types::compression_type::none:
                     {
+                        if(mapped_data_file)
+                        {
+                            //zero copy - the frame points to the mapped region, which is kept alive by the frame deleter
+                            auto mapped_data = mapped_data_file->map_bytes(static_cast<uint32_t>(num_bytes_to_read), num_bytes_read);
+                            if(!mapped_data)
+                                return ready_frame(nullptr);
+                            auto rv = std::shared_ptr<file_types::frame_sample>(
+                            new file_types::frame_sample(frame.get()), [mapped_data](file_types::frame_sample* f) { delete f; });
+                            rv->data = mapped_data.get();
+                            return ready_frame(rv);
+                        }
+                        //the buffer of the process frame allocator is freed with the frame, its rows are padded to the row alignment
+                        const uint64_t stride = static_cast<uint64_t>(frame->finfo.stride);
+                        const uint64_t aligned_stride = static_cast<uint64_t>(image_interface::query_aligned_pitch(frame->finfo.stride));
+                        const bool is_padded = aligned_stride != stride && num_bytes_to_read == stride * frame->finfo.height;
+                        const uint64_t buffer_size = is_padded ? aligned_stride * frame->finfo.height : num_bytes_to_read;
+                        auto buffer = std::make_shared<frame_buffer>(buffer_size);
+                        if(!buffer->data())
+                            return ready_frame(nullptr);
                         auto rv = std::shared_ptr<file_types::frame_sample>(
-                        new file_types::frame_sample(frame.get()), [](file_types::frame_sample* f) { delete[] f->data; delete f;});
-                        auto data = new uint8_t[num_bytes_to_read];
-                        m_file_data_read->read_bytes(data, static_cast<uint32_t>(num_bytes_to_read), num_bytes_read);
+                        new file_types::frame_sample(frame.get()), [buffer](file_types::frame_sample* f) { delete f; });
+                        //the frame is read to the end of the buffer, then each row moves forward to its padded offset
+                        uint8_t * read_data = buffer->data() + (buffer_size - num_bytes_to_read);
+                        data_file->read_bytes(read_data, static_cast<uint32_t>(num_bytes_to_read), num_bytes_read);
                         num_bytes_to_read -= num_bytes_read;
-                        rv->data = data;
-                        return rv;
+                        if(is_padded)
+                        {
+                            for(int row = 0; row < frame->finfo.height; row++)
+                                memmove(buffer->data() + row * aligned_stride, read_data + row * stride, stride);
+                            rv->finfo.stride = static_cast<int>(aligned_stride);
+                        }
+                        rv->data = buffer->data();
+                        return ready_frame(rv);
                     }
                     case file_types::compression_type::lz4:
+                    case file_types::compression_type::lz4_striped:
                     case file_types::compression_type::h264:
+                    case file_types::compression_type::delta:
+                    case file_types::compression_type::lz4_stream:
+                    case file_types::compression_type::yuv420:
+                    case file_types::compression_type::rvl:
+                    case file_types::compression_type::zstd:
                     {
-                        uint8_t * data = m_encoded_data.data();
-                        m_file_data_read->read_bytes(data, static_cast<uint32_t>(num_bytes_to_read), num_bytes_read);
-                        num_bytes_to_read -= num_bytes_read;
-                        auto rv = m_decoder->decode_frame(frame, data, num_bytes_read);
-                        return rv;
+                        //an intra coded frame another process decoded is taken from the host cache, a temporal decoder must decode each frame,
+                        //and the frames of a stream with an application allocator are decoded into its buffers
+                        auto key = m_file_key;
+                        key.stream = frame->finfo.stream;
+                        key.index = frame->finfo.index_in_stream;
+                        const bool is_shared = m_shared_frames_cache && !file_types::is_temporal_compression(frame->finfo.ctype) &&
+                                               m_frame_buffer_allocators.find(frame->finfo.stream) == m_frame_buffer_allocators.end();
+                        if(is_shared)
+                        {
+                            auto cached = m_shared_frames_cache->find(key, *frame);
+                            if(cached)
+                                return ready_frame(cached);
+                        }
+                        //frames of streams with an application allocator are decoded straight into the application buffer, padded frames into an aligned buffer
+                        uint32_t output_stride = 0;
+                        auto output = allocate_frame_buffer(frame->finfo, output_stride);
+                        std::future<std::shared_ptr<file_types::frame_sample>> decoded;
+                        if(mapped_data_file)
+                        {
+                            //decode straight from the mapped region
+                            uint64_t position = 0;
+                            mapped_data_file->get_position(&position);
+                            auto mapped_data = mapped_data_file->map_bytes(static_cast<uint32_t>(num_bytes_to_read), num_bytes_read);
+                            if(!mapped_data)
+                                return ready_frame(nullptr);
+                            if(decode_async)
+                            {
+                                //the pages are read while the earlier frames of the stream are decoded
+                                mapped_data_file->read_ahead(position, num_bytes_read);
+                                if(output)
+                                    decoded = m_decoder->decode_frame_into_async(frame, mapped_data, num_bytes_read, output, output_stride);
+                                else
+                                    decoded = m_decoder->decode_frame_async(frame, mapped_data, num_bytes_read);
+                            }
+                            else if(output)
+                                decoded = ready_frame(m_decoder->decode_frame_into(frame, mapped_data.get(), num_bytes_read, output, output_stride));
+                            else
+                                decoded = ready_frame(m_decoder->decode_frame(frame, mapped_data.get(), num_bytes_read));
+                        }
+                        else
+                        {
+                            //the stream based read shares a single staging buffer, the frame is decoded before the next read
+                            uint8_t * data = m_encoded_data.data();
+                            data_file->read_bytes(data, static_cast<uint32_t>(num_bytes_to_read), num_bytes_read);
+                            num_bytes_to_read -= num_bytes_read;
+                            if(output)
+                                decoded = ready_frame(m_decoder->decode_frame_into(frame, data, num_bytes_read, output, output_stride));
+                            else
+                                decoded = ready_frame(m_decoder->decode_frame(frame, data, num_bytes_read));
+                        }
+                        return is_shared ? share_decoded_frame(std::move(decoded), key) : std::move(decoded);
                     }
                     default:
                     {
@@ -637,13 +2707,13 @@ std::shared_ptr<file_types::frame_sample> disk_read_base::read_image_buffer(std:
                 {
                     LOG_ERROR("image size failed to match the data size");
                 }
-                return nullptr;
+                return ready_frame(nullptr);
             }
             default:
             {
                 if(num_bytes_to_read == 0)
-                    return nullptr;
-                m_file_data_read->set_position(num_bytes_to_read, move_method::current);
+                    return ready_frame(nullptr);
+                data_file->set_position(num_bytes_to_read, move_method::current);
             }
             num_bytes_to_read = 0;
         }
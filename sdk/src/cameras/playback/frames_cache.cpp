@@ -0,0 +1,85 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "frames_cache.h"
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace playback
+    {
+        std::shared_ptr<file_types::frame_sample> frames_cache::find(rs_stream stream, uint32_t index)
+        {
+            auto pending = m_pending.find(key(stream, index));
+            if(pending != m_pending.end())
+            {
+                auto frame = pending->second.get();
+                m_pending.erase(pending);
+                if(frame)
+                    add(frame);
+            }
+            auto cached = m_index.find(key(stream, index));
+            if(cached == m_index.end())
+                return nullptr;
+            m_frames.splice(m_frames.begin(), m_frames, cached->second);
+            //the returned frame is modified by the playback, the cached frame is kept as decoded
+            auto frame = *cached->second;
+            auto rv = std::shared_ptr<file_types::frame_sample>(new file_types::frame_sample(frame.get()), [frame](file_types::frame_sample * f) { delete f; });
+            rv->data = frame->data;
+            return rv;
+        }
+
+        void frames_cache::add(const std::shared_ptr<file_types::frame_sample> & frame)
+        {
+            auto frame_key = key(frame->finfo.stream, frame->finfo.index_in_stream);
+            auto size = frame_size(*frame);
+            if(size > m_budget || m_index.find(frame_key) != m_index.end())
+                return;
+            while(m_size + size > m_budget && !m_frames.empty())
+            {
+                auto & evicted = m_frames.back();
+                m_size -= frame_size(*evicted);
+                m_index.erase(key(evicted->finfo.stream, evicted->finfo.index_in_stream));
+                m_frames.pop_back();
+            }
+            m_frames.push_front(frame);
+            m_index[frame_key] = m_frames.begin();
+            m_size += size;
+        }
+
+        void frames_cache::add_pending(rs_stream stream, uint32_t index, std::future<std::shared_ptr<file_types::frame_sample>> frame)
+        {
+            m_pending[key(stream, index)] = std::move(frame);
+        }
+
+        bool frames_cache::contains(rs_stream stream, uint32_t index) const
+        {
+            return m_index.find(key(stream, index)) != m_index.end() || m_pending.find(key(stream, index)) != m_pending.end();
+        }
+
+        void frames_cache::resolve_pending()
+        {
+            for(auto & pending : m_pending)
+            {
+                auto frame = pending.second.get();
+                if(frame)
+                    add(frame);
+            }
+            m_pending.clear();
+        }
+
+        void frames_cache::clear()
+        {
+            resolve_pending();
+            m_frames.clear();
+            m_index.clear();
+            m_size = 0;
+        }
+
+        uint64_t frames_cache::frame_size(const file_types::frame_sample & frame)
+        {
+            return static_cast<uint64_t>(frame.finfo.stride) * frame.finfo.height;
+        }
+    }
+}
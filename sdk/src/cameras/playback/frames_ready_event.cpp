@@ -0,0 +1,84 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "frames_ready_event.h"
+#include "rs/utils/log_utils.h"
+
+#ifdef WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#include <sys/eventfd.h>
+#endif
+
+namespace rs
+{
+    namespace playback
+    {
+#ifdef WIN32
+        frames_ready_event::frames_ready_event() : m_handle(-1), m_is_set(false)
+        {
+            HANDLE handle = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+            if(handle == nullptr)
+                LOG_ERROR("failed to create the frames ready event");
+            else
+                m_handle = reinterpret_cast<intptr_t>(handle);
+        }
+
+        frames_ready_event::~frames_ready_event()
+        {
+            if(m_handle != -1)
+                CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+        }
+
+        void frames_ready_event::set()
+        {
+            if(m_handle == -1 || m_is_set)
+                return;
+            m_is_set = SetEvent(reinterpret_cast<HANDLE>(m_handle)) != 0;
+        }
+
+        void frames_ready_event::reset()
+        {
+            if(m_handle == -1 || !m_is_set)
+                return;
+            m_is_set = ResetEvent(reinterpret_cast<HANDLE>(m_handle)) == 0;
+        }
+#elif defined(__linux__)
+        frames_ready_event::frames_ready_event() : m_handle(-1), m_is_set(false)
+        {
+            m_handle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if(m_handle == -1)
+                LOG_ERROR("failed to create the frames ready event");
+        }
+
+        frames_ready_event::~frames_ready_event()
+        {
+            if(m_handle != -1)
+                close(static_cast<int>(m_handle));
+        }
+
+        //the counter of the eventfd is 1 while the event is set, the descriptor is readable while the counter isn't 0
+        void frames_ready_event::set()
+        {
+            if(m_handle == -1 || m_is_set)
+                return;
+            uint64_t value = 1;
+            m_is_set = write(static_cast<int>(m_handle), &value, sizeof(value)) == sizeof(value);
+        }
+
+        void frames_ready_event::reset()
+        {
+            if(m_handle == -1 || !m_is_set)
+                return;
+            uint64_t value = 0;
+            m_is_set = read(static_cast<int>(m_handle), &value, sizeof(value)) != sizeof(value);
+        }
+#else
+        frames_ready_event::frames_ready_event() : m_handle(-1), m_is_set(false) {}
+        frames_ready_event::~frames_ready_event() {}
+        void frames_ready_event::set() {}
+        void frames_ready_event::reset() {}
+#endif
+    }
+}
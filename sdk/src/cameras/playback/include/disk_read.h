@@ -13,11 +13,19 @@ namespace rs
         public:
             disk_read(const char *file_name) : disk_read_base(file_name) {}
             virtual ~disk_read(void);
+            virtual core::status extract(const std::string & file_path, uint64_t start_time, uint64_t end_time, const std::vector<rs_stream> & streams, bool include_motions) override;
         protected:
             virtual rs::core::status read_headers() override;
             virtual void index_next_samples(uint32_t number_of_samples) override;
-            virtual int32_t size_of_pitches(void) override;
-            virtual uint32_t read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample> & frame, unsigned long num_bytes_to_read) override;
+            virtual format_traits query_format_traits() const override { return { 0, true, false }; }
+        private:
+            //reads the chunks of the sample at offset, up to the next sample or the seek table
+            core::status read_sample_chunks(core::file & source, uint64_t offset, std::vector<uint8_t> & chunks);
+            //replaces the reference of a frame the change gate recorded as unchanged by the data chunk of the frame it repeats, which may be out of the clip
+            core::status copy_repeated_sample_data(core::file & source, const core::file_types::frame_info & info, std::vector<uint8_t> & chunks,
+                                                   std::vector<uint8_t> & repeated_chunks);
+            //copies the headers chunks, only the extracted streams are kept in the stream info chunk
+            core::status write_clip_headers(core::file & source, core::file & clip, const std::vector<rs_stream> & streams, std::map<rs_stream, uint64_t> & nframes_offsets);
         };
     }
 }
@@ -4,23 +4,53 @@
 #pragma once
 #include <vector>
 #include <queue>
+#include <deque>
 #include <map>
+#include <set>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <future>
 #include <chrono>
+#include <atomic>
 #include "compression/decoder.h"
+#include "compression/lz4_codec.h"
 #include "include/file_types.h"
 #include "status.h"
 #include "disk_read_interface.h"
 #include "include/file.h"
+#include "include/mapped_file.h"
+#include "io_scheduler.h"
+#include "samples_index.h"
+#include "frames_cache.h"
+#include "shared_frames_cache.h"
+#include "prefetch_controller.h"
+#include "rs/utils/timebase.h"
 
 namespace rs
 {
     namespace playback
     {
-        class disk_read_base : public disk_read_interface
+        class disk_read_base : public disk_read_interface, public io_scheduler::reader
         {
+        protected:
+            //the layout differences of a file format version, queried once when the file is opened
+            struct format_traits
+            {
+                uint32_t    pitches_size;           //bytes of the planes pitches which precede the image data
+                bool        has_frame_metadata;     //the frame metadata chunks are in the current layout
+                bool        index_at_open;          //the samples are indexed when the file is opened, the legacy index is converted once
+            };
+
+        private:
+            //the chunks of a sample, which precede its checksum chunk
+            struct checksummed_range
+            {
+                uint64_t    offset;
+                uint32_t    size;
+                uint32_t    crc;
+            };
+
             struct active_stream_info
             {
                 core::file_types::stream_info   m_stream_info;
@@ -28,9 +58,27 @@ namespace rs
                 uint32_t                        m_prefetched_samples_count;
             };
 
+            //the frames of a stream which are delivered, see playback::device::set_frame_decimation
+            struct frame_decimation
+            {
+                uint32_t    frames_interval;    //0 or 1 delivers every frame
+                uint64_t    frame_period;       //microseconds of capture time, 0 doesn't limit the frame rate
+            };
+
+            //a sample which was taken from the samples index, with its position in the index
+            struct indexed_sample
+            {
+                uint32_t                                    index;
+                std::shared_ptr<core::file_types::sample>   sample;
+            };
+
         public:
             disk_read_base(const char *file_path);
             virtual ~disk_read_base(void);
+            //opens the recording with the file implementation that fits its location, a remote recording is read by http range requests,
+            //a file which is read sequentially and can't be mapped is read by large blocks ahead of its position,
+            //with RS_SDK_PLAYBACK_DIRECT_IO set a local file is read by large direct io blocks, bypassing the page cache
+            static core::status open_file_for_read(const std::string & file_path, std::unique_ptr<core::file> & file, bool is_sequential = false);
             virtual core::status init() override;
             virtual void reset() override;
             virtual void resume() override;
@@ -41,6 +89,7 @@ namespace rs
             virtual void set_realtime(bool realtime) override;
             virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_index(uint32_t index, rs_stream stream_type) override;
             virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_time_stamp(uint64_t ts) override;
+            virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_capture_time(uint64_t capture_time) override;
             virtual bool query_realtime() override { return m_realtime; }
             virtual bool is_stream_profile_available(rs_stream stream, int width, int height, rs_format format, int framerate) override;
             virtual uint32_t query_number_of_frames(rs_stream stream_type) override;
@@ -48,65 +97,198 @@ namespace rs
             virtual const std::map<rs_camera_info, std::string>& get_camera_info() override { return m_camera_info; }
             virtual std::map<rs_stream, core::file_types::stream_info> get_streams_infos() override {return m_streams_infos; }
             virtual rs_motion_intrinsics get_motion_intrinsics() { return m_motion_intrinsics; }
-            virtual std::map<rs_option, double> get_properties() override { return m_properties; }
+            virtual const option_values & get_properties() override { return m_properties; }
             virtual std::vector<rs_capabilities> get_capabilities() { return m_capabilities; }
             virtual playback::capture_mode query_capture_mode() override { return m_file_header.capture_mode; }
             virtual file_info query_file_info() override ;
             virtual uint64_t query_run_time() override;
+            virtual double query_index_progress() override;
+            //the host time of the first frame, less its capture time
+            virtual uint64_t query_start_time() override;
+            //set while not streaming
+            virtual void set_clock(std::shared_ptr<playback_clock> clock, uint64_t offset) override { m_clock = clock; m_clock_offset = offset; }
             virtual void set_callback(std::function<void(std::shared_ptr<core::file_types::sample>)> handler) { m_sample_callback = handler;}
             virtual void set_callback(std::function<void()> handler) { m_eof_callback = handler; }
             virtual void set_total_frame_drop_count(double value) override;
             virtual void update_frame_drop_count(rs_stream stream, uint32_t frame_drop) override;
             virtual void update_imu_drop_count(uint32_t drop_count)override;
+            virtual void set_read_ahead_window(uint32_t samples_count) override { m_read_ahead_window = samples_count; }
+            virtual void set_loop_memory_size(uint64_t max_memory_size) override { m_loop_memory_size = max_memory_size; }
+            virtual void set_frame_decimation(rs_stream stream, uint32_t frames_interval, double frame_rate) override;
+            virtual bool set_playback_rate(double rate) override;
+            virtual double query_playback_rate() override { return m_playback_rate; }
+            virtual void set_frame_buffer_allocator(rs_stream stream, playback::frame_buffer_allocator allocator) override;
+            virtual uint32_t read_frames_batch(std::vector<std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>>> & batch, uint32_t max_sets) override;
+            virtual core::status compute_synced_sets(const std::vector<rs_stream> & streams, double max_time_difference, playback::synced_sets & sets) override;
+            virtual uint32_t read_synced_sets(const playback::synced_sets & sets, uint32_t first_set, uint32_t max_sets,
+                                              std::vector<std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>>> & batch) override;
+            //copying the compressed samples requires the knowledge of the file layout, supported by the current file format only
+            virtual core::status extract(const std::string & file_path, uint64_t start_time, uint64_t end_time, const std::vector<rs_stream> & streams, bool include_motions) override
+            {
+                return core::status_feature_unsupported;
+            }
+            //the checksums are recorded in the current file format only
+            virtual core::status verify(playback::verification_result & result) override;
+            //the preview frames are written in the current file format only, they're located by a scan of the chunk headers on demand
+            virtual core::status read_preview_frame(rs_stream stream, uint32_t index, playback::preview_frame & frame) override;
+            //the frames are described by the samples index, the image data chunks are never read
+            virtual uint32_t scan_frames(uint64_t & position, std::vector<playback::frame_descriptor> & frames, uint32_t max_frames, bool read_metadata) override;
+            //the descriptors are copied from the samples index, a recording with a samples index file isn't read beyond its headers
+            virtual uint32_t scan_samples(uint64_t & position, std::vector<sample_descriptor> & samples, uint32_t max_samples) override;
+            //the motions are read from the motion columns blocks, recordings without the blocks are read from the samples index
+            virtual core::status read_motions(rs_event_source source, uint64_t start_time, uint64_t end_time, playback::motion_columns & columns) override;
+            //the samples are exported from the samples index, so every file format is exported
+            virtual core::status export_mcap(const std::string & file_path, const std::vector<rs_stream> & streams, bool include_motions, bool decode_frames) override;
 
         protected:
             virtual rs::core::status read_headers() = 0;
             virtual void index_next_samples(uint32_t number_of_samples) = 0;
-            virtual int32_t size_of_pitches(void) = 0;
+            virtual format_traits query_format_traits() const = 0;
+            void index_samples(uint32_t number_of_samples);
             virtual std::shared_ptr<core::file_types::frame_sample> read_image_buffer(std::shared_ptr<rs::core::file_types::frame_sample> &frame);
-            void read_thread();
+            //reads the frame chunks, a frame which is decoded from the mapped file can be decoded on the decoder workers
+            std::future<std::shared_ptr<core::file_types::frame_sample>> read_image_data(std::shared_ptr<rs::core::file_types::frame_sample> &frame, bool decode_async);
+            //opens the host cache of decoded frames when RS_SDK_PLAYBACK_SHARED_CACHE is set to its size in megabytes
+            void open_shared_frames_cache();
+            //adds the decoded frame to the host cache once it's decoded
+            std::future<std::shared_ptr<core::file_types::frame_sample>> share_decoded_frame(std::future<std::shared_ptr<core::file_types::frame_sample>> decoded,
+                                                                                             const shared_frames_cache::frame_key & key);
+            //reads the next samples on the io scheduler threads, the reader is scheduled from resume until pause or end of file
+            virtual int64_t read_step() override;
             core::file_types::version query_sdk_version();
             core::file_types::version query_librealsense_version();
             core::status get_image_offset(rs_stream stream, int64_t &offset);
             void notify_available_samples();
             void prefetch_sample();
-            bool read_next_sample();
+            //issues the read of the sample to the read ahead window, the descriptor is created only for a sample which is delivered
+            void read_ahead_sample(uint32_t sample_index);
+            //a frame which is due before the next frame of its stream is delivered is skipped when playing faster than real time
+            bool is_frame_skipped(uint32_t sample_index);
+            //a frame which isn't selected by the decimation of its stream is neither read nor decoded
+            bool is_frame_decimated(uint32_t sample_index);
+            //the frames a temporal stream decimated since its last read frame are decoded as references, a far frame is decoded from its keyframe
+            std::future<std::shared_ptr<core::file_types::frame_sample>> read_decimated_image_data(std::shared_ptr<core::file_types::frame_sample> &frame, bool decode_async);
+            //the samples are read in file order, or backwards when the playback rate is negative
+            bool is_reverse() const { return m_playback_rate < 0; }
+            bool has_next_sample() const { return is_reverse() ? m_samples_desc_index > 0 : m_samples_desc_index < m_samples_desc.size(); }
+            //the reverse playback starts from an indexed sample, so it reads indexed samples only
+            bool all_samples_read() const { return !has_next_sample() && (m_is_index_complete || is_reverse()); }
+            //indexes the file until the next sample in the playback direction is indexed
+            void index_next_sample();
+            void clear_read_ahead_samples();
+            //hints the file with the range of the samples which follow the sample, used when the file isn't memory mapped
+            void hint_file_read_ahead(uint32_t sample_index);
+            bool read_next_sample(int64_t & time_to_next_sample);
             void update_time_base();
+            //reports the time of the next sample to the shared clock, the samples of the readers are delivered in the time order of the clock
+            void update_clock_position();
             std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> find_nearest_frames(uint32_t sample_index, rs_stream stream);
+            //the loop continues from the samples held in memory, or from the beginning of the file if they don't hold the whole file
+            void start_next_loop();
+            //copies a delivered sample of the first loop to memory, the copies are dropped once they exceed the loop memory size
+            void hold_loop_sample(const std::shared_ptr<core::file_types::sample> & sample);
+            //a copy of the sample with the times and frame numbers of the current loop
+            std::shared_ptr<core::file_types::sample> get_loop_sample(const std::shared_ptr<core::file_types::sample> & sample);
+            void replay_loop_sample();
+            //a seek or a reset ends the loops, the next pass starts a new first loop
+            void clear_loop();
+            //decodes the frames which follow a seek of the stream into the frames cache, in the direction of the previous seeks
+            void read_ahead_scrubbed_frames(rs_stream stream, uint32_t index_in_stream);
             bool all_samples_bufferd();
+            //the prefetched samples methods must be called while m_mutex is locked
+            void push_prefetched_sample(const indexed_sample & prefetched);
+            void pop_prefetched_sample();
+            void clear_prefetched_samples();
+            //allocates the buffer the frame is decoded into from the stream allocator, returns null if the stream has no allocator and its rows are tight
+            std::shared_ptr<uint8_t> allocate_frame_buffer(const core::file_types::frame_info & info, uint32_t & stride);
+            //with a row alignment, a stream without an allocator is decoded into a buffer of padded rows, null if the rows are tight
+            std::shared_ptr<uint8_t> allocate_aligned_frame_buffer(const core::file_types::frame_info & info, uint32_t & stride);
             void init_decoder();
-            virtual uint32_t read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample>& frame, unsigned long num_bytes_to_read) = 0;
-            int64_t calc_sleep_time(std::shared_ptr<core::file_types::sample> sample);
+            uint32_t read_frame_metadata(core::file & source, core::file_types::frame_metadata_set & metadata, unsigned long num_bytes_to_read);
+            //reads the metadata pairs chunk of recordings which were written before the metadata mask chunk
+            uint32_t read_legacy_frame_metadata(core::file & source, core::file_types::frame_metadata_set & metadata, unsigned long num_bytes_to_read);
+            int64_t calc_sleep_time(std::shared_ptr<core::file_types::sample> sample) { return calc_sleep_time(sample->info.capture_time); }
+            //the time until the capture time is due on the playback clock, scaled by the playback rate
+            int64_t calc_sleep_time(uint64_t capture_time);
 
             playback::capture_mode get_capture_mode();
+            //builds the samples descriptors from the index written next to the recording, returns false if the index is not usable
+            bool load_samples_index();
+            //adds the sample of an index entry of the samples index or of a sample bundle, returns false if the entry is not valid
+            bool add_indexed_sample(const core::file_types::disk_format::sample_index_entry & entry, samples_index & samples_desc,
+                                    std::map<rs_stream, std::vector<uint32_t>> & image_indices);
+            //verifies the checksummed ranges from begin to end, in file order
+            playback::verification_result verify_ranges(const std::vector<checksummed_range> & ranges, size_t begin, size_t end);
+            //opens the stripe files of a striped recording, at their recorded path or next to the recording
+            core::status open_stripe_files();
+            //reads the keyframes table of streams with temporal compression
+            void load_seek_table();
+            //reads the dictionaries the codecs learned while recording, written before the seek table
+            void load_codec_dictionaries();
+            //reads the index of the motion columns blocks, written before the codec dictionaries and the seek table
+            void load_motion_columns_index();
+            void read_indexed_motions(rs_event_source source, uint64_t start_time, uint64_t end_time, playback::motion_columns & columns);
+            //reads the image data of a frame as it's recorded, without decoding it
+            core::status read_encoded_image_data(const core::file_types::frame_sample & frame, std::vector<uint8_t> & data);
+            //the offset of the sample of the frame which a frame the change gate recorded as unchanged repeats
+            core::status get_repeated_frame_offset(const core::file_types::frame_info & info, const core::file_types::disk_format::repeated_sample_data & reference,
+                                                   uint64_t & offset);
+            //decodes the frames required to decode a frame of a stream with temporal compression, starting from its keyframe
+            std::future<std::shared_ptr<core::file_types::frame_sample>> seek_image_data(std::shared_ptr<core::file_types::frame_sample> &frame, bool decode_async);
 
             static const int                                                NUMBER_OF_SAMPLES_TO_INDEX = 1;
 
-            //if IMU and video streams are enabled no more than 4 images will be bufferd per stream
-            static const int                                                NUMBER_OF_REQUIRED_PREFETCHED_SAMPLES = 20;
+            //a seek indexes the file in larger steps, the target is searched again after each step
+            static const int                                                NUMBER_OF_SAMPLES_TO_INDEX_ON_SEEK = 64;
+
+            //maximal number of samples read in a single turn of the io scheduler
+            static const int                                                NUMBER_OF_SAMPLES_PER_STEP = 8;
+
+            //bytes the file is hinted to read ahead of the indexing position, the indexing reads the headers of the samples only
+            static const uint64_t                                           INDEX_READ_AHEAD_SIZE = 8 * 1024 * 1024;
+
+            //number of indexed samples the file is hinted to read ahead of the current sample
+            static const int                                                FILE_READ_AHEAD_SAMPLES = 16;
+
+            //decoded bytes of the frames kept for scrubbing
+            static const uint64_t                                           FRAMES_CACHE_BUDGET = 256 * 1024 * 1024;
+
+            //number of frames of each stream decoded ahead of a seek, in the direction of the previous seeks
+            static const uint32_t                                           SCRUB_READ_AHEAD_FRAMES = 2;
 
             std::string                                                     m_file_path;
             //file pointers
             std::unique_ptr<core::file>                                     m_file_indexing;//use only for samples indexing
+            uint64_t                                                        m_file_size;
+            uint64_t                                                        m_index_read_ahead_position;//the end of the range the indexing file was hinted to read
+            std::atomic<uint64_t>                                           m_index_position;//the indexing file position, queried by the application thread
             std::unique_ptr<core::file>                                     m_file_data_read;//use both for file header read and image data read
+            core::mapped_file *                                             m_mapped_data_read;//m_file_data_read if the file is memory mapped, otherwise null
+            std::vector<std::string>                                        m_stripe_paths;//paths of the stripe files, as recorded
+            std::vector<std::unique_ptr<core::file>>                        m_stripe_files;//image data of the striped streams
+            std::vector<core::mapped_file *>                                m_mapped_stripe_files;
 
             bool                                                            m_pause;
             bool                                                            m_realtime;
             bool                                                            m_is_index_complete;
+            format_traits                                                   m_format_traits;
 
             std::mutex                                                      m_mutex;
-            std::thread                                                     m_thread;
+            std::atomic<bool>                                               m_is_scheduled;  //cleared by a failed read step on an io scheduler thread
 
             std::shared_ptr<core::compression::decoder>                     m_decoder;
             std::vector<uint8_t>                                            m_encoded_data;
 
-            std::chrono::high_resolution_clock::time_point                  m_base_sys_time;
+            rs::utils::timebase::time_point                                 m_base_sys_time;
             uint64_t                                                        m_base_ts;
+            std::shared_ptr<playback_clock>                                 m_clock; //null if the recording isn't played with other recordings
+            uint64_t                                                        m_clock_offset; //the recording start on the time line of the clock
+            uint64_t                                                        m_clock_position; //the clock time of the last delivered sample
 
             //file static info
             core::file_types::sw_info                                       m_sw_info;
             core::file_types::file_header                                   m_file_header;
-            std::map<rs_option, double>                                     m_properties;
+            option_values                                                   m_properties;
             std::vector<rs_capabilities>                                    m_capabilities;
             std::map<rs_stream, core::file_types::stream_info>              m_streams_infos;
             rs_motion_intrinsics                                            m_motion_intrinsics;
@@ -115,10 +297,45 @@ namespace rs
             bool                                                            m_is_motion_tracking_enabled;
 
             //sticky variables, calculated once in objects lifetime
-            std::map<rs_stream, std::vector<uint32_t>>                      m_image_indices; // index in m_samples_descriptors
-            std::queue<std::shared_ptr<core::file_types::sample>>           m_prefetched_samples;
-            std::vector<std::shared_ptr<core::file_types::sample>>          m_samples_desc; // growing vector of all samples descriptors in order of capture
-            uint32_t                                                        m_samples_desc_index; // points to the nexr indexed sample, which wasn't prefetched yet
+            std::map<rs_stream, std::vector<uint32_t>>                      m_image_indices; // index in m_samples_desc
+            std::map<rs_stream, std::vector<uint32_t>>                      m_keyframes; // sorted keyframes indices in stream
+            std::map<rs_stream, std::vector<uint8_t>>                       m_codec_dictionaries;
+            bool                                                            m_is_motion_columns_index_loaded; //the index is loaded by the first motions read
+            std::vector<core::file_types::disk_format::motion_columns_index_entry> m_motion_columns_index;
+            std::queue<indexed_sample>                                      m_prefetched_samples;
+            prefetch_controller                                             m_prefetch_controller; //the number of prefetched frames of each stream
+            //samples which were issued for read and decode ahead of the prefetched samples, in playback order
+            std::deque<std::pair<indexed_sample,
+                std::future<std::shared_ptr<core::file_types::frame_sample>>>> m_read_ahead_samples;
+            uint32_t                                                        m_read_ahead_window; // 0 reads and decodes each sample when it's prefetched
+            std::map<rs_stream, playback::frame_buffer_allocator>           m_frame_buffer_allocators; // set while not streaming
+            frames_cache                                                    m_frames_cache; //the frames of the seeks, frames of streams with an allocator aren't cached
+            std::shared_ptr<shared_frames_cache>                            m_shared_frames_cache; //null unless the host cache is enabled
+            shared_frames_cache::frame_key                                  m_file_key; //the identity of the recording in the host cache
+            std::map<rs_stream, uint32_t>                                   m_scrub_positions; //index in stream of the last seek of each stream
+            std::map<rs_stream, uint32_t>                                   m_decoded_positions; //index in stream of the last frame of each stream which was read for decoding
+            std::set<rs_stream>                                             m_unsynced_streams; //temporal streams whose decoder isn't at the last seek
+            std::map<rs_stream, frame_decimation>                           m_frame_decimations; // set while not streaming
+            std::set<rs_stream>                                             m_decimated_streams; //temporal streams whose decoder is behind their next delivered frame
+            uint64_t                                                        m_loop_memory_size; //0 doesn't loop the playback
+            std::vector<std::shared_ptr<core::file_types::sample>>          m_loop_samples; //the delivered samples of the first loop
+            uint64_t                                                        m_loop_samples_size;
+            bool                                                            m_is_loop_held; //the held samples start at the beginning of the file and fit the memory size
+            bool                                                            m_is_replaying_loop;
+            size_t                                                          m_loop_position; //the next replayed sample
+            uint64_t                                                        m_loop_count; //loops completed since the playback started
+            uint64_t                                                        m_loop_duration; //microseconds of capture time
+            std::map<rs_stream, unsigned long long>                         m_loop_frame_numbers; //frame numbers span of each stream
+            std::mutex                                                      m_preview_mutex; //the preview is read by the application thread while streaming
+            std::unique_ptr<core::file>                                     m_preview_file;
+            uint64_t                                                        m_preview_scan_position; //the next chunk the preview scan reads
+            bool                                                            m_is_preview_scan_complete;
+            std::map<rs_stream, std::vector<uint64_t>>                      m_preview_offsets; //offsets of the preview frame chunks, in stream order
+            core::compression::lz4_codec                                    m_preview_codec;
+            samples_index                                                   m_samples_desc; // growing index of all samples descriptors in order of capture
+            uint32_t                                                        m_samples_desc_index; // points to the nexr indexed sample, which wasn't prefetched yet, in reverse playback the sample before it is the next
+            double                                                          m_playback_rate; // negative when playing backwards
+            std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> m_batch_set; // frames set which is filled by the next batch read
 
             std::function<void(std::shared_ptr<core::file_types::sample>)>  m_sample_callback;
             std::function<void()>                                           m_eof_callback;
@@ -19,9 +19,9 @@ namespace rs
         public:
             static rs::core::status create_disk_read(const char *file_name, std::unique_ptr<disk_read_interface> &disk_read)
             {
-                std::unique_ptr<rs::core::file> file_ = std::unique_ptr<rs::core::file>(new rs::core::file());
+                std::unique_ptr<rs::core::file> file_;
 
-                rs::core::status status = file_->open(file_name, rs::core::open_file_option::read);
+                rs::core::status status = disk_read_base::open_file_for_read(file_name, file_);
                 if (status != rs::core::status_no_error)
                 {
                     std::string str = file_name;
@@ -37,9 +37,10 @@ namespace rs
                 status = file_->read_bytes(&file_type_id, sizeof(file_type_id), nbytesRead);
                 if (status != rs::core::status_no_error) return status;
 
-                if (file_type_id == UID('R', 'S', 'L', '2'))
+                //version 3 adds the sample bundles to the chunks of version 2
+                if (file_type_id == UID('R', 'S', 'L', '3') || file_type_id == UID('R', 'S', 'L', '2'))
                 {
-                    LOG_INFO("create disk read for Linux file format version 2")
+                    LOG_INFO("create disk read for Linux file format version " << (file_type_id == UID('R', 'S', 'L', '3') ? 3 : 2))
                     disk_read = std::unique_ptr<disk_read_interface>(new playback::disk_read(file_name));
                     return disk_read->init();
                 }
@@ -8,11 +8,25 @@
 #include "include/file_types.h"
 #include "rs/playback/playback_device.h"
 #include "status.h"
+#include "playback_clock.h"
+#include "option_values.h"
 
 namespace rs
 {
     namespace playback
     {
+        //a samples index entry, read without the sample chunks
+        struct sample_descriptor
+        {
+            core::file_types::sample_type       type;
+            rs_stream                           stream;             //the stream of a frame or of a frame drop event, RS_STREAM_COUNT for other samples
+            uint64_t                            capture_time;       //microseconds from the beginning of the recording
+            uint64_t                            offset;             //file offset of the sample chunks
+            core::file_types::frame_info        frame;              //valid for frames only
+            core::file_types::debug_event_type  event_type;         //valid for debug events only
+            uint64_t                            frame_drop_count;   //valid for frame drop events which carry their drop data
+        };
+
         class disk_read_interface
         {
         public:
@@ -29,10 +43,13 @@ namespace rs
             virtual std::map<rs_stream, core::file_types::stream_info> get_streams_infos() = 0;
             virtual rs_motion_intrinsics get_motion_intrinsics() = 0;
             virtual std::vector<rs_capabilities> get_capabilities() = 0;
-            virtual std::map<rs_option, double> get_properties() = 0;
+            //the recorded option values, the table is owned by the reader
+            virtual const option_values & get_properties() = 0;
             virtual void set_realtime(bool realtime) = 0;
             virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_index(uint32_t index, rs_stream stream_type) = 0;
             virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_time_stamp(uint64_t ts) = 0;
+            //the first frame of any stream captured at or after the capture time, in microseconds from the start of the recording
+            virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_capture_time(uint64_t capture_time) = 0;
             virtual bool query_realtime() = 0;
             virtual uint32_t query_number_of_frames(rs_stream stream_type) = 0;
             virtual int32_t query_coordinate_system() = 0;
@@ -41,12 +58,38 @@ namespace rs
             virtual playback::capture_mode query_capture_mode() = 0;
             virtual playback::file_info query_file_info() = 0;
             virtual uint64_t query_run_time() = 0;
+            //the indexed part of the recording, between 0 and 1
+            virtual double query_index_progress() = 0;
+            //the host time of the recording start in microseconds, 0 if the recording has no host times
+            virtual uint64_t query_start_time() = 0;
+            //the recordings which are played together share a clock, the offset places the recording start on the time line of the clock
+            virtual void set_clock(std::shared_ptr<playback_clock> clock, uint64_t offset) = 0;
             virtual bool is_stream_profile_available(rs_stream stream, int width, int height, rs_format format, int framerate) = 0;//TODO:[mk]consider moving to device
             virtual void set_callback(std::function<void(std::shared_ptr<core::file_types::sample>)> handler) = 0;
             virtual void set_callback(std::function<void()> handler) = 0;
             virtual void set_total_frame_drop_count(double value) = 0;
             virtual void update_frame_drop_count(rs_stream stream, uint32_t frame_drop) = 0;
             virtual void update_imu_drop_count(uint32_t frame_drop) = 0;
+            virtual void set_read_ahead_window(uint32_t samples_count) = 0;
+            //0 doesn't loop the playback
+            virtual void set_loop_memory_size(uint64_t max_memory_size) = 0;
+            //0 frames interval and 0 frame rate deliver every frame of the stream
+            virtual void set_frame_decimation(rs_stream stream, uint32_t frames_interval, double frame_rate) = 0;
+            virtual bool set_playback_rate(double rate) = 0;
+            virtual double query_playback_rate() = 0;
+            virtual void set_frame_buffer_allocator(rs_stream stream, playback::frame_buffer_allocator allocator) = 0;
+            virtual core::status extract(const std::string & file_path, uint64_t start_time, uint64_t end_time, const std::vector<rs_stream> & streams, bool include_motions) = 0;
+            virtual core::status verify(playback::verification_result & result) = 0;
+            virtual core::status read_preview_frame(rs_stream stream, uint32_t index, playback::preview_frame & frame) = 0;
+            virtual uint32_t scan_frames(uint64_t & position, std::vector<playback::frame_descriptor> & frames, uint32_t max_frames, bool read_metadata) = 0;
+            //the descriptors of the indexed samples of all types from the position, the samples are never read
+            virtual uint32_t scan_samples(uint64_t & position, std::vector<sample_descriptor> & samples, uint32_t max_samples) = 0;
+            virtual core::status read_motions(rs_event_source source, uint64_t start_time, uint64_t end_time, playback::motion_columns & columns) = 0;
+            virtual core::status export_mcap(const std::string & file_path, const std::vector<rs_stream> & streams, bool include_motions, bool decode_frames) = 0;
+            virtual uint32_t read_frames_batch(std::vector<std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>>> & batch, uint32_t max_sets) = 0;
+            virtual core::status compute_synced_sets(const std::vector<rs_stream> & streams, double max_time_difference, playback::synced_sets & sets) = 0;
+            virtual uint32_t read_synced_sets(const playback::synced_sets & sets, uint32_t first_set, uint32_t max_sets,
+                                              std::vector<std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>>> & batch) = 0;
         };
     }
 }
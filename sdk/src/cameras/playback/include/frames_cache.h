@@ -0,0 +1,53 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+#include <list>
+#include <map>
+#include <memory>
+#include <future>
+#include "include/file_types.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+         * @brief Least recently used cache of the decoded frames, within a budget of decoded bytes.
+         *
+         * The cache keeps the frames the application seeks to, so scrubbing back and forth over a range of the recording doesn't read
+         * and decode the same frames again. The frames are keyed by their stream and their index in the stream. A frame which is read
+         * ahead is added as pending, and is moved to the cache once its decoding is done.
+         * The cache isn't thread safe, it's used by the seek methods, which are called while the file isn't read by the io scheduler.
+         */
+        class frames_cache
+        {
+        public:
+            explicit frames_cache(uint64_t budget) : m_budget(budget), m_size(0) {}
+
+            //returns a frame which shares the decoded data of the cached frame, null if the frame isn't cached or pending
+            std::shared_ptr<core::file_types::frame_sample> find(rs_stream stream, uint32_t index);
+            //the frame is the most recently used, the least recently used frames are evicted to keep the cache within its budget
+            void add(const std::shared_ptr<core::file_types::frame_sample> & frame);
+            void add_pending(rs_stream stream, uint32_t index, std::future<std::shared_ptr<core::file_types::frame_sample>> frame);
+            bool contains(rs_stream stream, uint32_t index) const;
+            //waits for the pending frames and adds them to the cache
+            void resolve_pending();
+            void clear();
+            uint64_t size() const { return m_size; }
+
+        private:
+            typedef std::pair<rs_stream, uint32_t> key;
+            typedef std::list<std::shared_ptr<core::file_types::frame_sample>> frames_list;
+
+            static uint64_t frame_size(const core::file_types::frame_sample & frame);
+
+            uint64_t                                                                        m_budget;
+            uint64_t                                                                        m_size;
+            frames_list                                                                     m_frames; //most recently used first
+            std::map<key, frames_list::iterator>                                            m_index;
+            std::map<key, std::future<std::shared_ptr<core::file_types::frame_sample>>>     m_pending;
+        };
+    }
+}
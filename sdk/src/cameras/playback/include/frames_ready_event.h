@@ -0,0 +1,37 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+         * @brief Operating system event which is signaled while a time synced frames set is available to the synced mode application.
+         *
+         * The handle is an eventfd on linux and a manual reset event on windows, so the application waits for the frames in its epoll
+         * or WaitForMultipleObjects loop, together with its other sources. The event isn't thread safe, it's set and reset under the
+         * lock of the device frames.
+         */
+        class frames_ready_event
+        {
+        public:
+            frames_ready_event();
+            ~frames_ready_event();
+
+            //-1 if the event couldn't be created, or isn't supported by the platform
+            intptr_t handle() const { return m_handle; }
+            void set();
+            void reset();
+
+        private:
+            frames_ready_event(const frames_ready_event &) = delete;
+            frames_ready_event & operator= (const frames_ready_event &) = delete;
+
+            intptr_t    m_handle;
+            bool        m_is_set;
+        };
+    }
+}
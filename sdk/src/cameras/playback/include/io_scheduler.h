@@ -0,0 +1,72 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+         * @brief Runs the file reads of all the playback devices of the process on a small set of shared threads.
+         *
+         * A reader is scheduled while its device is streaming. Each turn of a reader reads its next few samples, and returns the time
+         * until its next sample is due, so a reader which waits for the playback clock doesn't hold a thread.
+         * The ready readers are served round robin, a reader is queued again behind the other ready readers after each turn.
+         * The samples of a turn are read one after the other, so the reads of a file aren't interleaved with the reads of the other files.
+         */
+        class io_scheduler
+        {
+        public:
+            class reader
+            {
+            public:
+                virtual ~reader() {}
+                //reads the next samples, returns the time in microseconds until the next sample is due, or a negative value when the reader is done
+                virtual int64_t read_step() = 0;
+            };
+
+            static io_scheduler & instance();
+
+            //the reader takes its first turn as soon as a thread is available
+            void add(reader * reader);
+
+            //waits for the current turn of the reader, a reader which is removed by its own turn isn't scheduled again
+            void remove(reader * reader);
+
+            ~io_scheduler();
+        private:
+            typedef std::chrono::steady_clock clock; //the condition variables wait on the steady clock
+
+            io_scheduler();
+            io_scheduler(const io_scheduler &) = delete;
+            io_scheduler & operator= (const io_scheduler &) = delete;
+
+            void start_threads();
+            void thread_loop();
+            //must be called while m_mutex is locked
+            void unschedule(reader * reader);
+
+            static const unsigned int MAX_NUMBER_OF_THREADS = 4;
+
+            std::mutex                                  m_mutex;
+            std::condition_variable                     m_ready_cv;
+            std::condition_variable                     m_turn_done_cv;
+            std::vector<std::thread>                    m_threads;
+            std::deque<reader *>                        m_ready_readers;
+            std::multimap<clock::time_point, reader *>  m_waiting_readers; //ordered by the time the reader is due
+            std::map<reader *, std::thread::id>         m_running_readers;
+            std::set<reader *>                          m_removed_readers; //removed during their turn
+            bool                                        m_stop;
+        };
+    }
+}
@@ -0,0 +1,122 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+#include <deque>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+#include "status.h"
+#include "include/file.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+         * @brief Writer of MCAP files, the recording container of the ROS and Foxglove tools.
+         *
+         * The messages are appended to chunks of CHUNK_SIZE bytes. A full chunk is compressed with LZ4 by a worker thread while the next
+         * chunk is filled, up to a chunk per core is compressed at a time, and the chunks are written in order, so the export is bound
+         * by the disk rather than by the compression. A chunk whose messages hold data which is compressed already is written as is,
+         * compressing it again would cost the cpu time without saving any bytes.
+         * The schemas and channels are written before the first chunk, and the file ends with a summary of the schemas, channels,
+         * statistics and chunk indexes, so the readers seek to the chunks of a time range without scanning the file.
+         */
+        class mcap_writer
+        {
+        public:
+            //a part of the message data, the message data is gathered from its parts as it's appended to the chunk
+            struct data_part
+            {
+                const void *    data;
+                size_t          size;
+            };
+
+            static const size_t CHUNK_SIZE = 4 * 1024 * 1024;
+
+            mcap_writer();
+            ~mcap_writer();
+
+            core::status open(const std::string & file_path, const std::string & profile);
+            //returns the schema id, the schemas are added before the first message
+            uint16_t add_schema(const std::string & name, const std::string & encoding, const std::string & data);
+            //returns the channel id, the channels are added before the first message
+            uint16_t add_channel(uint16_t schema_id, const std::string & topic, const std::string & message_encoding);
+            //log_time is in nanoseconds, is_compressible is false for data which is compressed already
+            core::status write_message(uint16_t channel_id, uint64_t log_time, const std::vector<data_part> & parts, bool is_compressible);
+            //writes the open chunk, the summary and the footer
+            core::status close();
+
+        private:
+            struct schema
+            {
+                uint16_t        id;
+                std::string     name;
+                std::string     encoding;
+                std::string     data;
+            };
+
+            struct channel
+            {
+                uint16_t        id;
+                uint16_t        schema_id;
+                std::string     topic;
+                std::string     message_encoding;
+            };
+
+            struct chunk
+            {
+                uint64_t                start_time;
+                uint64_t                end_time;
+                uint64_t                uncompressed_size;
+                std::string             compression;
+                std::vector<uint8_t>    records;
+            };
+
+            struct chunk_index
+            {
+                uint64_t        start_time;
+                uint64_t        end_time;
+                uint64_t        offset;
+                uint64_t        length;
+                uint64_t        compressed_size;
+                uint64_t        uncompressed_size;
+                std::string     compression;
+            };
+
+            static chunk compress_chunk(std::vector<uint8_t> records, uint64_t start_time, uint64_t end_time, bool compress);
+            static void append_schema(std::vector<uint8_t> & buffer, const schema & value);
+            static void append_channel(std::vector<uint8_t> & buffer, const channel & value);
+
+            //writes the schemas and channels records before the first chunk
+            core::status write_definitions();
+            //hands the open chunk to a compression worker
+            void flush_chunk();
+            //writes the earliest compressed chunk
+            core::status write_next_chunk();
+            core::status write(const std::vector<uint8_t> & buffer);
+
+            core::file                          m_file;
+            bool                                m_is_open;
+            uint64_t                            m_position;
+            std::vector<schema>                 m_schemas;
+            std::vector<channel>                m_channels;
+            bool                                m_is_data_started;
+            std::vector<uint8_t>                m_chunk;
+            uint64_t                            m_chunk_start_time;
+            uint64_t                            m_chunk_end_time;
+            size_t                              m_chunk_compressible_size;
+            std::deque<std::future<chunk>>      m_pending_chunks;
+            size_t                              m_max_pending_chunks;
+            std::vector<chunk_index>            m_chunk_indexes;
+            std::map<uint16_t, uint32_t>        m_sequences;
+            std::map<uint16_t, uint64_t>        m_message_counts;
+            uint64_t                            m_messages_count;
+            uint64_t                            m_start_time;
+            uint64_t                            m_end_time;
+        };
+    }
+}
@@ -0,0 +1,53 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <array>
+#include "include/file_types.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+         * @brief The recorded option values of a device, a flat table by option.
+         *
+         * The playback device answers the option queries of the application from the table, which is queried for every frame by
+         * applications that mirror the live device, so a query neither searches nor allocates.
+         */
+        class option_values
+        {
+        public:
+            option_values() { m_is_set.fill(false); m_values.fill(0); }
+
+            bool contains(rs_option option) const { return is_valid(option) && m_is_set[option]; }
+            //0 if the option wasn't recorded
+            double get(rs_option option) const { return contains(option) ? m_values[option] : 0; }
+            void set(rs_option option, double value)
+            {
+                if(!is_valid(option))
+                    return;
+                m_values[option] = value;
+                m_is_set[option] = true;
+            }
+            void add(rs_option option, double value) { set(option, get(option) + value); }
+
+            //calls the function with each recorded option and its value, in the options order
+            template<typename function_type>
+            void for_each(function_type function) const
+            {
+                for(int option = 0; option < RS_OPTION_COUNT; option++)
+                {
+                    if(m_is_set[option])
+                        function(static_cast<rs_option>(option), m_values[option]);
+                }
+            }
+
+        private:
+            static bool is_valid(rs_option option) { return option >= 0 && option < RS_OPTION_COUNT; }
+
+            std::array<bool, RS_OPTION_COUNT>   m_is_set;
+            std::array<double, RS_OPTION_COUNT> m_values;
+        };
+    }
+}
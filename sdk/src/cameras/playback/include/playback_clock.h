@@ -0,0 +1,54 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include "rs/utils/timebase.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+         * @brief Playback clock shared by the readers of the recordings which are played together.
+         *
+         * The times of the clock are microseconds on the common time line of the recordings, each reader adds the offset of its
+         * recording start to its capture times. The first reader which joins the clock while no other reader is playing sets the time
+         * base of the clock, the readers which join later play by the same time base, so the recordings don't drift apart.
+         * When not playing in real time, the clock orders the samples of the readers: a reader delivers a sample only after the other
+         * playing readers delivered their earlier samples.
+         */
+        class playback_clock
+        {
+        public:
+            typedef rs::utils::timebase::time_point time_point;
+
+            playback_clock() : m_base_time(0), m_is_time_requested(false), m_requested_time(0) {}
+
+            //returns the time base of the clock, the time is the time of the reader if the clock isn't played by another reader
+            void join(const void * reader, uint64_t time, uint64_t & base_time, time_point & base_sys_time);
+            void leave(const void * reader);
+            void get_time_base(uint64_t & base_time, time_point & base_sys_time);
+            //the time base of the next time the clock is joined by a first reader, used by the seek of all the readers
+            void request_time(uint64_t time);
+            //the time of the next sample of the reader, or of its last delivered sample while it reads the next sample
+            void set_position(const void * reader, uint64_t time);
+            //true if none of the playing readers is behind the time
+            bool is_due(uint64_t time);
+
+        private:
+            playback_clock(const playback_clock &) = delete;
+            playback_clock & operator= (const playback_clock &) = delete;
+
+            std::mutex                          m_mutex;
+            uint64_t                            m_base_time;
+            time_point                          m_base_sys_time;
+            bool                                m_is_time_requested;
+            uint64_t                            m_requested_time;
+            std::map<const void *, uint64_t>    m_positions; //the playing readers
+        };
+    }
+}
@@ -6,10 +6,12 @@
 #include <mutex>
 #include <thread>
 #include <queue>
+#include <deque>
 #include <condition_variable>
 #include "playback_device_interface.h"
 #include "disk_read_interface.h"
 #include "rs_stream_impl.h"
+#include "frames_ready_event.h"
 
 #ifdef WIN32 
 #ifdef realsense_playback_EXPORTS
@@ -42,12 +44,19 @@ namespace rs
             virtual rs_format get_frame_format() const override { return m_frame->finfo.format; }
             virtual rs_stream get_stream_type() const override { return m_frame->finfo.stream; }
             virtual rs_timestamp_domain get_frame_timestamp_domain() const { return m_frame->finfo.time_stamp_domain; }
-            virtual double get_frame_metadata(rs_frame_metadata frame_metadata) const override { return m_frame->metadata.at(frame_metadata); }
-            virtual bool supports_frame_metadata(rs_frame_metadata frame_metadata) const override { return m_frame->metadata.find(frame_metadata) != m_frame->metadata.end(); }
+            virtual double get_frame_metadata(rs_frame_metadata frame_metadata) const override { return m_frame->metadata.get(frame_metadata); }
+            virtual bool supports_frame_metadata(rs_frame_metadata frame_metadata) const override { return m_frame->metadata.supports(frame_metadata); }
         private:
             std::shared_ptr<rs::core::file_types::frame_sample> m_frame;
         };
 
+        //frames of the batch read aren't delivered by the stream callbacks threads
+        class rs_batch_frame_ref_impl : public rs_frame_ref_impl
+        {
+        public:
+            rs_batch_frame_ref_impl(std::shared_ptr<rs::core::file_types::frame_sample> frame) : rs_frame_ref_impl(frame) {}
+        };
+
         struct thread_sync
         {
             std::thread             thread;
@@ -55,12 +64,36 @@ namespace rs
             std::condition_variable sample_ready_cv;
         };
 
+        struct frame_queue_config
+        {
+            frame_queue_config() : max_queue_size(1), drop_policy(frame_drop_policy::drop_oldest_frame) {}
+            uint32_t            max_queue_size;
+            frame_drop_policy   drop_policy;
+        };
+
         struct frame_thread_sync : public thread_sync
         {
-            std::condition_variable                         sample_deleted_cv;
-            std::shared_ptr<core::file_types::frame_sample> sample;
-            std::shared_ptr<rs_frame_callback>              callback;
-            uint32_t                                        active_samples_count;
+            frame_thread_sync() : active_samples_count(0) {}
+            std::condition_variable                                     sample_deleted_cv;
+            std::deque<std::shared_ptr<core::file_types::frame_sample>> samples;
+            std::shared_ptr<rs_frame_callback>                          callback;
+            uint32_t                                                    active_samples_count;
+            frame_queue_config                                          queue_config;
+
+            //returns false if the frame was dropped from the queue, either the pushed frame or the oldest queued frame
+            bool push_sample(std::shared_ptr<core::file_types::frame_sample> sample)
+            {
+                if(samples.size() < queue_config.max_queue_size)
+                {
+                    samples.push_back(sample);
+                    return true;
+                }
+                if(queue_config.drop_policy == frame_drop_policy::drop_newest_frame)
+                    return false;
+                samples.pop_front();
+                samples.push_back(sample);
+                return false;
+            }
         };
 
         struct imu_thread_sync : public thread_sync
@@ -137,12 +170,36 @@ namespace rs
             virtual void                            resume() override;
             virtual bool                            set_frame_by_index(int index, rs_stream stream) override;
             virtual bool                            set_frame_by_timestamp(uint64_t timestamp) override;
+            virtual bool                            wait_all_streams_for(uint32_t timeout) override;
+            virtual intptr_t                        get_frames_ready_handle() override;
             virtual void                            set_real_time(bool realtime) override;
+            virtual bool                            set_playback_rate(double rate) override;
+            virtual double                          get_playback_rate() override;
+            virtual bool                            set_frame_queue(rs_stream stream, uint32_t queue_size, frame_drop_policy policy) override;
+            virtual bool                            set_read_ahead_window(uint32_t samples_count) override;
+            virtual bool                            set_frame_decimation(rs_stream stream, uint32_t frames_interval, double frame_rate) override;
+            virtual bool                            set_looped_playback(bool looped, uint64_t max_memory_size) override;
+            virtual bool                            set_frame_buffer_allocator(rs_stream stream, frame_buffer_allocator allocator) override;
+            virtual bool                            extract(const char * file_path, uint64_t start_time, uint64_t end_time, const std::vector<rs_stream> & streams, bool include_motions) override;
+            virtual bool                            verify(verification_result & result) override;
+            virtual bool                            get_preview_frame(rs_stream stream, int index, preview_frame & frame) override;
+            virtual bool                            read_motions(rs_event_source source, uint64_t start_time, uint64_t end_time, motion_columns & columns) override;
+            virtual bool                            export_mcap(const char * file_path, const std::vector<rs_stream> & streams, bool include_motions, bool decode_frames) override;
+            virtual uint32_t                        scan_frames(uint64_t & position, std::vector<frame_descriptor> & frames, uint32_t max_frames, bool read_metadata) override;
+            virtual uint32_t                        read_frames_batch(std::vector<std::map<rs_stream, rs_frame_ref *>> & batch, uint32_t max_sets) override;
+            virtual bool                            compute_synced_sets(const std::vector<rs_stream> & streams, double max_time_difference, synced_sets & sets) override;
+            virtual uint32_t                        read_synced_sets(const synced_sets & sets, uint32_t first_set, std::vector<std::map<rs_stream, rs_frame_ref *>> & batch, uint32_t max_sets) override;
             virtual int                             get_frame_index(rs_stream stream) override;
             virtual int                             get_frame_count(rs_stream stream) override;
             virtual int                             get_frame_count() override;
+            virtual double                          get_index_progress() override;
             virtual playback::file_info             get_file_info() override;
 
+            //used by the context of the recordings which are played together
+            uint64_t                                get_start_time();
+            void                                    set_clock(std::shared_ptr<playback_clock> clock, uint64_t offset);
+            bool                                    set_frame_by_capture_time(uint64_t capture_time);
+
         private:
             bool                                    all_streams_available();
             void                                    set_enabled_streams();
@@ -155,12 +212,17 @@ namespace rs
             void                                    handle_frame_callback(std::shared_ptr<core::file_types::sample> sample);
             void                                    handle_motion_callback(std::shared_ptr<core::file_types::sample> sample);
             bool                                    wait_for_active_frames();
+            //checks the synced mode and requests the next frames set from the read thread, false if a request is pending
+            bool                                    request_frames_set();
+            //returns true if the requested frames set was set, false if the streaming stopped or the wait timed out
+            bool                                    end_frames_set_request();
             void                                    internal_pause();
 
             static const int                                                    LIBREALSENSE_IMU_BUFFER_SIZE = 12;
 
             bool                                                                m_wait_streams_request;
             std::condition_variable                                             m_all_stream_available_cv;
+            std::unique_ptr<frames_ready_event>                                 m_frames_ready_event; //created by the first query of its handle
             std::mutex                                                          m_all_stream_available_mutex;
             bool                                                                m_is_streaming;
             std::mutex                                                          m_mutex;
@@ -169,8 +231,10 @@ namespace rs
             std::map<rs_stream,std::unique_ptr<rs_stream_impl>>                 m_available_streams;
             std::map<rs_stream,std::shared_ptr<core::file_types::frame_sample>> m_curr_frames;
             std::map<rs_stream, frame_thread_sync>                              m_frame_thread;
+            std::map<rs_stream, frame_queue_config>                             m_frame_queue_configs;
             imu_thread_sync                                                     m_imu_thread;
             std::unique_ptr<disk_read_interface>                                m_disk_read;
+            std::vector<std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>>> m_batch;
             size_t                                                              m_enabled_streams_count;
         };
     }
@@ -30,10 +30,29 @@ namespace rs
             virtual void resume() = 0;
             virtual bool set_frame_by_index(int index, rs_stream stream) = 0;
             virtual bool set_frame_by_timestamp(uint64_t timestamp) = 0;
+            virtual bool wait_all_streams_for(uint32_t timeout) = 0;
+            virtual intptr_t get_frames_ready_handle() = 0;
             virtual void set_real_time(bool realtime) = 0;
+            virtual bool set_playback_rate(double rate) = 0;
+            virtual double get_playback_rate() = 0;
+            virtual bool set_frame_queue(rs_stream stream, uint32_t queue_size, frame_drop_policy policy) = 0;
+            virtual bool set_read_ahead_window(uint32_t samples_count) = 0;
+            virtual bool set_frame_decimation(rs_stream stream, uint32_t frames_interval, double frame_rate) = 0;
+            virtual bool set_looped_playback(bool looped, uint64_t max_memory_size) = 0;
+            virtual bool set_frame_buffer_allocator(rs_stream stream, frame_buffer_allocator allocator) = 0;
+            virtual bool extract(const char * file_path, uint64_t start_time, uint64_t end_time, const std::vector<rs_stream> & streams, bool include_motions) = 0;
+            virtual bool verify(verification_result & result) = 0;
+            virtual bool get_preview_frame(rs_stream stream, int index, preview_frame & frame) = 0;
+            virtual bool read_motions(rs_event_source source, uint64_t start_time, uint64_t end_time, motion_columns & columns) = 0;
+            virtual bool export_mcap(const char * file_path, const std::vector<rs_stream> & streams, bool include_motions, bool decode_frames) = 0;
+            virtual uint32_t scan_frames(uint64_t & position, std::vector<frame_descriptor> & frames, uint32_t max_frames, bool read_metadata) = 0;
+            virtual uint32_t read_frames_batch(std::vector<std::map<rs_stream, rs_frame_ref *>> & batch, uint32_t max_sets) = 0;
+            virtual bool compute_synced_sets(const std::vector<rs_stream> & streams, double max_time_difference, synced_sets & sets) = 0;
+            virtual uint32_t read_synced_sets(const synced_sets & sets, uint32_t first_set, std::vector<std::map<rs_stream, rs_frame_ref *>> & batch, uint32_t max_sets) = 0;
             virtual int get_frame_index(rs_stream stream) = 0;
             virtual int get_frame_count(rs_stream stream) = 0;
             virtual int get_frame_count() = 0;
+            virtual double get_index_progress() = 0;
             virtual playback::file_info get_file_info() = 0;
         };
     }
@@ -0,0 +1,76 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+#include <map>
+#include <atomic>
+#include <chrono>
+#include "include/file_types.h"
+#include "rs/utils/memory_accounting.h"
+#include "rs/utils/timebase.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+         * @brief Sizes the prefetched samples queue of a reader by the observed read times and consumption rates of its streams.
+         *
+         * A stream keeps enough prefetched frames to cover the time it takes to read and decode its next frame, at the rate its
+         * frames are consumed, so a slow decode doesn't stall the consumer, and a fast decode doesn't buffer frames for nothing.
+         * The prefetched frames of all the readers of the process are limited by a memory budget, so high resolution streams keep few
+         * frames, and the prefetching gives way to the memory budget of the sdk. The motion samples are prefetched to cover the longest gap between the consumed motion samples, which are
+         * recorded in bursts.
+         * The controller isn't thread safe, it's used by the turns of its reader and under the lock of the prefetched samples.
+         */
+        class prefetch_controller
+        {
+        public:
+            prefetch_controller() : m_prefetched_bytes(0), m_motion_max_gap(0) {}
+            ~prefetch_controller() { clear(); }
+
+            //the time it took to read and decode the next frame of the stream, in microseconds
+            void add_read_time(rs_stream stream, uint64_t read_time);
+            void add_prefetched(const core::file_types::sample & sample);
+            void add_delivered(const core::file_types::sample & sample);
+            //the prefetched samples were dropped
+            void clear();
+            //the consumption rates aren't measured over the pause of the playback
+            void restart();
+            //the number of prefetched frames which covers the read time of the next frame of the stream
+            uint32_t required_frames(rs_stream stream, uint64_t frame_size, size_t streams_count) const;
+            uint32_t required_motions() const;
+            //the prefetched frames of all the readers of the process exceed the memory budget, or the sdk exceeds its memory budget
+            static bool is_over_budget() { return s_prefetched_bytes >= MEMORY_BUDGET || !rs::utils::memory_accounting::is_within_budget(0); }
+
+        private:
+            typedef rs::utils::timebase clock;
+
+            struct rate_statistics
+            {
+                rate_statistics() : read_time(0), delivery_interval(0), has_delivery(false) {}
+                double              read_time;          //average microseconds
+                double              delivery_interval;  //average microseconds between consumed samples
+                clock::time_point   last_delivery;
+                bool                has_delivery;
+            };
+
+            static uint64_t sample_size(const core::file_types::sample & sample);
+            //returns the microseconds since the previous delivery, 0 for the first delivery
+            static double update_delivery(rate_statistics & statistics);
+
+            //decoded bytes of the prefetched frames of all the readers
+            static const uint64_t                   MEMORY_BUDGET = 128 * 1024 * 1024;
+            static const uint32_t                   MAX_PREFETCHED_FRAMES = 16;
+            static const uint32_t                   MIN_PREFETCHED_MOTIONS = 20;
+            static const uint32_t                   MAX_PREFETCHED_MOTIONS = 2000;
+
+            static std::atomic<uint64_t>            s_prefetched_bytes;
+            uint64_t                                m_prefetched_bytes;
+            std::map<rs_stream, rate_statistics>    m_streams;
+            rate_statistics                         m_motions;
+            double                                  m_motion_max_gap; //decaying maximum of the motion delivery intervals
+        };
+    }
+}
@@ -0,0 +1,92 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <vector>
+#include "include/file_types.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+         * @brief The descriptors of the indexed samples of a recording, in file order.
+         *
+         * The fields which are searched by the playback are kept in flat arrays with an entry per sample, and the data of each sample
+         * type is kept in an array of its own. A recording with motion samples has millions of samples, so no object is allocated per
+         * indexed sample, the sample object is created when the sample is read.
+         * The capture times are converted to microseconds when the samples are indexed.
+         */
+        class samples_index
+        {
+        public:
+            size_t size() const { return m_types.size(); }
+            void reserve(size_t samples_count);
+            void clear();
+
+            //return the index of the added sample
+            uint32_t add_frame(const core::file_types::frame_info & frame_info, const core::file_types::sample_info & sample_info);
+            uint32_t add_motion(const rs_motion_data & motion_data, const core::file_types::sample_info & sample_info);
+            uint32_t add_time_stamp(const rs_timestamp_data & time_stamp_data, const core::file_types::sample_info & sample_info);
+            uint32_t add_debug_event(core::file_types::debug_event_type event_type, const core::file_types::sample_info & sample_info,
+                                     const core::file_types::debug_data * debug_data);
+
+            core::file_types::sample_type type(uint32_t index) const { return m_types[index]; }
+            uint64_t capture_time(uint32_t index) const { return m_capture_times[index]; }
+            uint64_t offset(uint32_t index) const { return m_offsets[index]; }
+            //the stream of a frame, or the stream of a frame drop event, RS_STREAM_COUNT for other samples
+            rs_stream stream(uint32_t index) const { return m_streams[index]; }
+            //valid for frames only
+            const core::file_types::frame_info & frame_info(uint32_t index) const { return m_frame_infos[m_data_indices[index]]; }
+            //valid for motions only
+            const rs_motion_data & motion(uint32_t index) const { return m_motions[m_data_indices[index]]; }
+            //valid for time stamps only
+            const rs_timestamp_data & time_stamp(uint32_t index) const { return m_time_stamps[m_data_indices[index]]; }
+            //valid for debug events only
+            core::file_types::debug_event_type debug_event_type(uint32_t index) const { return m_debug_events[m_data_indices[index]].type; }
+            //valid for debug events only, null if the event has no data
+            const core::file_types::debug_data * debug_data(uint32_t index) const
+            {
+                auto & event = m_debug_events[m_data_indices[index]];
+                return event.has_data ? &event.data : nullptr;
+            }
+
+            //creates the descriptor of the sample, the frame data isn't read
+            std::shared_ptr<core::file_types::sample> get_sample(uint32_t index) const;
+            //null if the sample isn't a frame
+            std::shared_ptr<core::file_types::frame_sample> get_frame(uint32_t index) const;
+
+            //the index of the stream frame with the earliest time stamp which isn't before the time stamp, NO_SAMPLE if the indexed frames are earlier
+            uint32_t find_frame_by_time_stamp(rs_stream stream, double time_stamp) const;
+
+            static const uint32_t NO_SAMPLE = 0xffffffff;
+
+        private:
+            struct debug_event
+            {
+                core::file_types::debug_event_type  type;
+                bool                                has_data;
+                core::file_types::debug_data        data;
+            };
+
+            uint32_t add_sample(const core::file_types::sample_info & sample_info, rs_stream stream, size_t data_index);
+            core::file_types::sample_info get_sample_info(uint32_t index) const;
+            double frame_time_stamp(uint32_t index) const { return m_frame_infos[m_data_indices[index]].time_stamp; }
+
+            std::vector<core::file_types::sample_type>      m_types;
+            std::vector<uint64_t>                           m_capture_times;
+            std::vector<uint64_t>                           m_offsets;
+            std::vector<rs_stream>                          m_streams;
+            std::vector<uint32_t>                           m_data_indices;     //index of the sample in the array of its type
+            std::vector<core::file_types::frame_info>       m_frame_infos;
+            std::vector<rs_motion_data>                     m_motions;
+            std::vector<rs_timestamp_data>                  m_time_stamps;
+            std::vector<debug_event>                        m_debug_events;
+            //the frames of each stream sorted by time stamp, the time stamps of a stream rarely go back so a frame is usually appended
+            std::map<rs_stream, std::vector<uint32_t>>      m_frames_by_time_stamp;
+        };
+    }
+}
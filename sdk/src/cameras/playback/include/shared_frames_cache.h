@@ -0,0 +1,59 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include "include/file_types.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+         * @brief Least recently used cache of decoded frames in a shared memory segment of the host, shared by the processes which read the same recordings.
+         *
+         * The frames are keyed by the identity of the recording file, their stream and their index in the stream, so the processes which
+         * read a recording at the same time decode each frame once. The segment is a fixed array of slots of a single size, each slot holds
+         * a decoded frame and counts the frames of all the processes which hold it, a held slot is neither evicted nor rewritten.
+         * A frame is added to the least recently used slot which no process holds, frames larger than the slot size aren't cached.
+         * The segment is private to the user, it's created by the first process of the user which opens it and its slot size is set by
+         * that process. The segment is removed when the last process which opened it releases it. The slots held by a process which
+         * exited without releasing its frames are released once all the slots are held. Shared memory segments are supported on Linux,
+         * on other platforms \c open returns null.
+         */
+        class shared_frames_cache
+        {
+        public:
+            //the identity of the file is the same in all the processes which read it, and changes when the file is rewritten
+            struct frame_key
+            {
+                uint64_t    device;
+                uint64_t    inode;
+                uint64_t    file_size;
+                int64_t     modified_time;  //nanoseconds
+                int32_t     stream;
+                uint32_t    index;          //the frame index in its stream
+            };
+
+            //opens the segment of the name and the user, creating it with the slots which fit the size, null if it has another layout or another owner
+            static std::shared_ptr<shared_frames_cache> open(const std::string & name, uint64_t size, uint32_t slot_size);
+            //sets the file identity of the key, false if the file can't be identified
+            static bool query_file_key(const std::string & file_path, frame_key & key);
+
+            ~shared_frames_cache();
+
+            //returns a frame of the descriptor, which shares the data of the cached frame and holds its slot, null if the frame isn't cached
+            std::shared_ptr<core::file_types::frame_sample> find(const frame_key & key, const core::file_types::frame_sample & descriptor);
+            //copies the decoded frame to a slot, false if the frame doesn't fit the slot or all the slots are held
+            bool add(const frame_key & key, const core::file_types::frame_sample & frame);
+
+        private:
+            class segment;
+            explicit shared_frames_cache(std::shared_ptr<segment> segment) : m_segment(std::move(segment)) {}
+
+            std::shared_ptr<segment> m_segment;
+        };
+    }
+}
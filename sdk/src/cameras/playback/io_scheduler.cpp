@@ -0,0 +1,152 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <exception>
+#include "io_scheduler.h"
+#include "rs/utils/log_utils.h"
+#include "rs/utils/thread_config.h"
+#include "rs/utils/thread_profiler.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        io_scheduler & io_scheduler::instance()
+        {
+            static io_scheduler scheduler;
+            return scheduler;
+        }
+
+        io_scheduler::io_scheduler() : m_stop(false)
+        {
+
+        }
+
+        io_scheduler::~io_scheduler()
+        {
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                m_stop = true;
+                m_ready_cv.notify_all();
+            }
+            for(auto & thread : m_threads)
+            {
+                if(thread.joinable())
+                    thread.join();
+            }
+        }
+
+        void io_scheduler::start_threads()
+        {
+            //the threads mostly wait for the disk, a few threads are enough to keep many files streaming
+            unsigned int number_of_threads = std::thread::hardware_concurrency();
+            if(number_of_threads > MAX_NUMBER_OF_THREADS)
+                number_of_threads = MAX_NUMBER_OF_THREADS;
+            if(number_of_threads < 2)
+                number_of_threads = 2;
+            for(unsigned int i = 0; i < number_of_threads; i++)
+                m_threads.push_back(std::thread(&io_scheduler::thread_loop, this));
+            LOG_INFO("io scheduler started " << number_of_threads << " threads");
+        }
+
+        void io_scheduler::add(reader * reader)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            if(m_threads.empty())
+                start_threads();
+            m_removed_readers.erase(reader);
+            m_ready_readers.push_back(reader);
+            m_ready_cv.notify_one();
+        }
+
+        void io_scheduler::remove(reader * reader)
+        {
+            std::unique_lock<std::mutex> guard(m_mutex);
+            unschedule(reader);
+            auto running = m_running_readers.find(reader);
+            if(running == m_running_readers.end())
+                return;
+            m_removed_readers.insert(reader);
+            //a reader which is removed by its own turn, e.g. by a samples callback, can't wait for it
+            if(running->second == std::this_thread::get_id())
+                return;
+            m_turn_done_cv.wait(guard, [this, reader]() { return m_running_readers.find(reader) == m_running_readers.end(); });
+            m_removed_readers.erase(reader);
+        }
+
+        void io_scheduler::unschedule(reader * reader)
+        {
+            m_ready_readers.erase(std::remove(m_ready_readers.begin(), m_ready_readers.end(), reader), m_ready_readers.end());
+            for(auto it = m_waiting_readers.begin(); it != m_waiting_readers.end();)
+            {
+                if(it->second == reader)
+                    it = m_waiting_readers.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        void io_scheduler::thread_loop()
+        {
+            rs::utils::thread_configuration::apply(rs::utils::thread_role::playback, "rs-play-read");
+            //a read step reads and decodes the samples of a reader, its storage reads are counted as running time
+            rs::utils::thread_profiler profiler(rs::utils::thread_role::playback);
+            profiler.start();
+            std::unique_lock<std::mutex> guard(m_mutex);
+            while(!m_stop)
+            {
+                auto now = clock::now();
+                while(!m_waiting_readers.empty() && m_waiting_readers.begin()->first <= now)
+                {
+                    m_ready_readers.push_back(m_waiting_readers.begin()->second);
+                    m_waiting_readers.erase(m_waiting_readers.begin());
+                }
+
+                if(m_ready_readers.empty())
+                {
+                    rs::utils::thread_profiler::wait_scope input_wait(profiler, rs::utils::thread_wait::input);
+                    if(m_waiting_readers.empty())
+                        m_ready_cv.wait(guard);
+                    else
+                        m_ready_cv.wait_until(guard, m_waiting_readers.begin()->first);
+                    continue;
+                }
+
+                auto reader = m_ready_readers.front();
+                m_ready_readers.pop_front();
+                m_running_readers[reader] = std::this_thread::get_id();
+                guard.unlock();
+
+                int64_t time_to_next_step = -1;
+                try
+                {
+                    time_to_next_step = reader->read_step();
+                }
+                catch(const std::exception & ex)
+                {
+                    LOG_ERROR("reader failed, the reader is removed - " << ex.what());
+                }
+
+                profiler.add_processed_items();
+                profiler.lock(guard);
+                m_running_readers.erase(reader);
+                if(m_removed_readers.erase(reader) == 0 && time_to_next_step >= 0)
+                {
+                    if(time_to_next_step == 0)
+                    {
+                        m_ready_readers.push_back(reader);
+                    }
+                    else
+                    {
+                        m_waiting_readers.emplace(clock::now() + std::chrono::microseconds(time_to_next_step), reader);
+                        //the other threads may wait for a later reader
+                        m_ready_cv.notify_one();
+                    }
+                }
+                m_turn_done_cv.notify_all();
+            }
+            profiler.stop();
+        }
+    }
+}
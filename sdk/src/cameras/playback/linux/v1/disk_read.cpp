@@ -64,7 +64,7 @@ namespace rs
                                 {
                                     for(auto & caps : devcaps)
                                     {
-                                        m_properties[caps.label] = caps.value;
+                                        m_properties.set(caps.label, caps.value);
                                     }
                                 }
                                 LOG_INFO("read properties chunk " << (data_read_status == core::status_no_error ? "succeeded" : "failed"));
@@ -165,8 +165,7 @@ namespace rs
                                         if (data_read_status != core::status_no_error)
                                             break;
                                         frame_info.index_in_stream = static_cast<uint32_t>(m_image_indices[frame_info.stream].size());
-                                        m_image_indices[frame_info.stream].push_back(static_cast<uint32_t>(m_samples_desc.size()));
-                                        m_samples_desc.push_back(std::make_shared<core::file_types::frame_sample>(frame_info, sample_info));
+                                        m_image_indices[frame_info.stream].push_back(m_samples_desc.add_frame(frame_info, sample_info));
                                         ++index;
                                         LOG_VERBOSE("frame sample indexed, sample time - " << sample_info.capture_time)
                                         break;
@@ -178,7 +177,7 @@ namespace rs
                                         if (data_read_status != core::status_no_error)
                                             break;
                                         rs_motion_data motion_data = md.data;
-                                        m_samples_desc.push_back(std::make_shared<core::file_types::motion_sample>(motion_data, sample_info));
+                                        m_samples_desc.add_motion(motion_data, sample_info);
                                         ++index;
                                         LOG_VERBOSE("motion sample indexed, sample time - " << sample_info.capture_time)
                                         break;
@@ -190,7 +189,7 @@ namespace rs
                                         if (data_read_status != core::status_no_error)
                                             break;
                                         rs_timestamp_data time_stamp_data = tsd.data;
-                                        m_samples_desc.push_back(std::make_shared<core::file_types::time_stamp_sample>(time_stamp_data, sample_info));
+                                        m_samples_desc.add_time_stamp(time_stamp_data, sample_info);
                                         ++index;
                                         LOG_VERBOSE("time stamp sample indexed, sample time - " << sample_info.capture_time)
                                         break;
@@ -209,16 +208,6 @@ namespace rs
                             break;
                     }
                 }
-
-                int32_t disk_read::size_of_pitches(void)
-                {
-                    return 0;
-                }
-
-                uint32_t disk_read::read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample>& frame, unsigned long num_bytes_to_read)
-                {
-                    throw std::runtime_error("unsupported");
-                }
             }
         }
     }
@@ -0,0 +1,354 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "mcap_writer.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include "lz4frame.h"
+#include "rs/utils/log_utils.h"
+
+using namespace rs::core;
+
+namespace
+{
+    const uint8_t MAGIC[] = { 0x89, 'M', 'C', 'A', 'P', '0', '\r', '\n' };
+
+    enum opcode : uint8_t
+    {
+        op_header       = 0x01,
+        op_footer       = 0x02,
+        op_schema       = 0x03,
+        op_channel      = 0x04,
+        op_message      = 0x05,
+        op_chunk        = 0x06,
+        op_chunk_index  = 0x08,
+        op_statistics   = 0x0b,
+        op_data_end     = 0x0f
+    };
+
+    //size of the opcode and the length which precede the record content
+    const size_t RECORD_PREFIX_SIZE = sizeof(uint8_t) + sizeof(uint64_t);
+
+    //the records are little endian, as the recording chunks
+    template<typename T>
+    void append(std::vector<uint8_t> & buffer, T value)
+    {
+        auto size = buffer.size();
+        buffer.resize(size + sizeof(value));
+        memcpy(buffer.data() + size, &value, sizeof(value));
+    }
+
+    void append(std::vector<uint8_t> & buffer, const std::string & value)
+    {
+        append(buffer, static_cast<uint32_t>(value.size()));
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    //returns the position of the record length, which is set by end_record
+    size_t begin_record(std::vector<uint8_t> & buffer, opcode op)
+    {
+        append(buffer, static_cast<uint8_t>(op));
+        append(buffer, static_cast<uint64_t>(0));
+        return buffer.size() - sizeof(uint64_t);
+    }
+
+    void end_record(std::vector<uint8_t> & buffer, size_t length_position)
+    {
+        uint64_t length = buffer.size() - length_position - sizeof(uint64_t);
+        memcpy(buffer.data() + length_position, &length, sizeof(length));
+    }
+}
+
+namespace rs
+{
+    namespace playback
+    {
+        const size_t mcap_writer::CHUNK_SIZE;
+
+        mcap_writer::mcap_writer() :
+            m_is_open(false),
+            m_position(0),
+            m_is_data_started(false),
+            m_chunk_start_time(std::numeric_limits<uint64_t>::max()),
+            m_chunk_end_time(0),
+            m_chunk_compressible_size(0),
+            m_max_pending_chunks(std::max(1u, std::thread::hardware_concurrency())),
+            m_messages_count(0),
+            m_start_time(std::numeric_limits<uint64_t>::max()),
+            m_end_time(0)
+        {
+
+        }
+
+        mcap_writer::~mcap_writer()
+        {
+            if(m_is_open)
+                close();
+        }
+
+        status mcap_writer::open(const std::string & file_path, const std::string & profile)
+        {
+            if(m_file.open(file_path, open_file_option::write) != status_no_error)
+                return status_file_open_failed;
+            m_is_open = true;
+            std::vector<uint8_t> buffer(MAGIC, MAGIC + sizeof(MAGIC));
+            auto length_position = begin_record(buffer, op_header);
+            append(buffer, profile);
+            append(buffer, std::string("librealsense_sdk"));
+            end_record(buffer, length_position);
+            return write(buffer);
+        }
+
+        uint16_t mcap_writer::add_schema(const std::string & name, const std::string & encoding, const std::string & data)
+        {
+            //schema id 0 stands for a channel without a schema
+            schema value = { static_cast<uint16_t>(m_schemas.size() + 1), name, encoding, data };
+            m_schemas.push_back(value);
+            return value.id;
+        }
+
+        uint16_t mcap_writer::add_channel(uint16_t schema_id, const std::string & topic, const std::string & message_encoding)
+        {
+            channel value = { static_cast<uint16_t>(m_channels.size() + 1), schema_id, topic, message_encoding };
+            m_channels.push_back(value);
+            return value.id;
+        }
+
+        status mcap_writer::write_message(uint16_t channel_id, uint64_t log_time, const std::vector<data_part> & parts, bool is_compressible)
+        {
+            if(!m_is_open)
+                return status_invalid_state;
+            if(!m_is_data_started)
+            {
+                auto sts = write_definitions();
+                if(sts != status_no_error)
+                    return sts;
+            }
+
+            size_t data_size = 0;
+            for(auto & part : parts)
+                data_size += part.size;
+            auto length_position = begin_record(m_chunk, op_message);
+            append(m_chunk, channel_id);
+            append(m_chunk, m_sequences[channel_id]++);
+            append(m_chunk, log_time);
+            append(m_chunk, log_time);
+            auto data_position = m_chunk.size();
+            m_chunk.resize(data_position + data_size);
+            for(auto & part : parts)
+            {
+                memcpy(m_chunk.data() + data_position, part.data, part.size);
+                data_position += part.size;
+            }
+            end_record(m_chunk, length_position);
+
+            if(is_compressible)
+                m_chunk_compressible_size += data_size;
+            m_chunk_start_time = std::min(m_chunk_start_time, log_time);
+            m_chunk_end_time = std::max(m_chunk_end_time, log_time);
+            m_start_time = std::min(m_start_time, log_time);
+            m_end_time = std::max(m_end_time, log_time);
+            m_message_counts[channel_id]++;
+            m_messages_count++;
+
+            if(m_chunk.size() >= CHUNK_SIZE)
+                flush_chunk();
+            //the compressed chunks are written in order, the oldest is waited for when all the workers are busy
+            while(m_pending_chunks.size() > m_max_pending_chunks)
+            {
+                auto sts = write_next_chunk();
+                if(sts != status_no_error)
+                    return sts;
+            }
+            return status_no_error;
+        }
+
+        status mcap_writer::close()
+        {
+            if(!m_is_open)
+                return status_invalid_state;
+            m_is_open = false;
+            status sts = m_is_data_started ? status_no_error : write_definitions();
+            flush_chunk();
+            while(!m_pending_chunks.empty())
+            {
+                auto chunk_sts = write_next_chunk();
+                if(sts == status_no_error)
+                    sts = chunk_sts;
+            }
+
+            //no crc is calculated for the data section
+            std::vector<uint8_t> buffer;
+            auto length_position = begin_record(buffer, op_data_end);
+            append(buffer, static_cast<uint32_t>(0));
+            end_record(buffer, length_position);
+
+            uint64_t summary_start = m_position + buffer.size();
+            for(auto & value : m_schemas)
+                append_schema(buffer, value);
+            for(auto & value : m_channels)
+                append_channel(buffer, value);
+
+            length_position = begin_record(buffer, op_statistics);
+            append(buffer, m_messages_count);
+            append(buffer, static_cast<uint16_t>(m_schemas.size()));
+            append(buffer, static_cast<uint32_t>(m_channels.size()));
+            append(buffer, static_cast<uint32_t>(0)); //attachments
+            append(buffer, static_cast<uint32_t>(0)); //metadata
+            append(buffer, static_cast<uint32_t>(m_chunk_indexes.size()));
+            append(buffer, m_messages_count > 0 ? m_start_time : 0);
+            append(buffer, m_end_time);
+            append(buffer, static_cast<uint32_t>(m_message_counts.size() * (sizeof(uint16_t) + sizeof(uint64_t))));
+            for(auto & count : m_message_counts)
+            {
+                append(buffer, count.first);
+                append(buffer, count.second);
+            }
+            end_record(buffer, length_position);
+
+            //the chunks have no message indexes, the readers read the chunks of a time range as a whole
+            for(auto & index : m_chunk_indexes)
+            {
+                length_position = begin_record(buffer, op_chunk_index);
+                append(buffer, index.start_time);
+                append(buffer, index.end_time);
+                append(buffer, index.offset);
+                append(buffer, index.length);
+                append(buffer, static_cast<uint32_t>(0));
+                append(buffer, static_cast<uint64_t>(0));
+                append(buffer, index.compression);
+                append(buffer, index.compressed_size);
+                append(buffer, index.uncompressed_size);
+                end_record(buffer, length_position);
+            }
+
+            length_position = begin_record(buffer, op_footer);
+            append(buffer, summary_start);
+            append(buffer, static_cast<uint64_t>(0)); //no summary offsets
+            append(buffer, static_cast<uint32_t>(0)); //no summary crc
+            end_record(buffer, length_position);
+            buffer.insert(buffer.end(), MAGIC, MAGIC + sizeof(MAGIC));
+
+            auto write_sts = write(buffer);
+            if(sts == status_no_error)
+                sts = write_sts;
+            auto close_sts = m_file.close();
+            return sts != status_no_error ? sts : close_sts;
+        }
+
+        mcap_writer::chunk mcap_writer::compress_chunk(std::vector<uint8_t> records, uint64_t start_time, uint64_t end_time, bool compress)
+        {
+            chunk rv = { start_time, end_time, records.size(), "", std::vector<uint8_t>() };
+            if(compress)
+            {
+                LZ4F_preferences_t preferences = {};
+                preferences.frameInfo.contentSize = records.size();
+                std::vector<uint8_t> compressed(LZ4F_compressFrameBound(records.size(), &preferences));
+                auto size = LZ4F_compressFrame(compressed.data(), compressed.size(), records.data(), records.size(), &preferences);
+                if(!LZ4F_isError(size) && size < records.size())
+                {
+                    compressed.resize(size);
+                    rv.compression = "lz4";
+                    rv.records = std::move(compressed);
+                    return rv;
+                }
+            }
+            rv.records = std::move(records);
+            return rv;
+        }
+
+        void mcap_writer::append_schema(std::vector<uint8_t> & buffer, const schema & value)
+        {
+            auto length_position = begin_record(buffer, op_schema);
+            append(buffer, value.id);
+            append(buffer, value.name);
+            append(buffer, value.encoding);
+            append(buffer, value.data);
+            end_record(buffer, length_position);
+        }
+
+        void mcap_writer::append_channel(std::vector<uint8_t> & buffer, const channel & value)
+        {
+            auto length_position = begin_record(buffer, op_channel);
+            append(buffer, value.id);
+            append(buffer, value.schema_id);
+            append(buffer, value.topic);
+            append(buffer, value.message_encoding);
+            append(buffer, static_cast<uint32_t>(0)); //no metadata
+            end_record(buffer, length_position);
+        }
+
+        status mcap_writer::write_definitions()
+        {
+            std::vector<uint8_t> buffer;
+            for(auto & value : m_schemas)
+                append_schema(buffer, value);
+            for(auto & value : m_channels)
+                append_channel(buffer, value);
+            m_is_data_started = true;
+            return write(buffer);
+        }
+
+        void mcap_writer::flush_chunk()
+        {
+            if(m_chunk.empty())
+                return;
+            //a chunk of mostly compressed images gains a few percent from the compression
+            bool compress = m_chunk_compressible_size * 2 >= m_chunk.size();
+            m_pending_chunks.push_back(std::async(std::launch::async, compress_chunk, std::move(m_chunk), m_chunk_start_time, m_chunk_end_time, compress));
+            m_chunk = std::vector<uint8_t>();
+            m_chunk.reserve(CHUNK_SIZE + CHUNK_SIZE / 4);
+            m_chunk_start_time = std::numeric_limits<uint64_t>::max();
+            m_chunk_end_time = 0;
+            m_chunk_compressible_size = 0;
+        }
+
+        status mcap_writer::write_next_chunk()
+        {
+            auto value = m_pending_chunks.front().get();
+            m_pending_chunks.pop_front();
+
+            chunk_index index = {};
+            index.start_time = value.start_time;
+            index.end_time = value.end_time;
+            index.offset = m_position;
+            index.compressed_size = value.records.size();
+            index.uncompressed_size = value.uncompressed_size;
+            index.compression = value.compression;
+
+            //the chunk records are written from the compressed buffer, without a copy to the chunk record
+            std::vector<uint8_t> buffer;
+            auto length_position = begin_record(buffer, op_chunk);
+            append(buffer, value.start_time);
+            append(buffer, value.end_time);
+            append(buffer, value.uncompressed_size);
+            append(buffer, static_cast<uint32_t>(0)); //no crc
+            append(buffer, value.compression);
+            append(buffer, static_cast<uint64_t>(value.records.size()));
+            uint64_t length = buffer.size() - length_position - sizeof(uint64_t) + value.records.size();
+            memcpy(buffer.data() + length_position, &length, sizeof(length));
+            index.length = RECORD_PREFIX_SIZE + length;
+
+            auto sts = write(buffer);
+            if(sts != status_no_error)
+                return sts;
+            sts = write(value.records);
+            if(sts != status_no_error)
+                return sts;
+            m_chunk_indexes.push_back(index);
+            LOG_VERBOSE("mcap chunk written, offset - " << index.offset << " ,size - " << index.compressed_size << " ,compression - " << index.compression.c_str());
+            return status_no_error;
+        }
+
+        status mcap_writer::write(const std::vector<uint8_t> & buffer)
+        {
+            uint32_t bytes_written = 0;
+            if(m_file.write_bytes(buffer.data(), static_cast<uint32_t>(buffer.size()), bytes_written) != status_no_error || bytes_written != buffer.size())
+                return status_file_write_failed;
+            m_position += buffer.size();
+            return status_no_error;
+        }
+    }
+}
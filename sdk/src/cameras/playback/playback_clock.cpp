@@ -0,0 +1,64 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "playback_clock.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        void playback_clock::join(const void * reader, uint64_t time, uint64_t & base_time, time_point & base_sys_time)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_positions.erase(reader);
+            if(m_positions.empty())
+            {
+                m_base_time = m_is_time_requested ? m_requested_time : time;
+                m_base_sys_time = rs::utils::timebase::now();
+                m_is_time_requested = false;
+            }
+            m_positions[reader] = time;
+            base_time = m_base_time;
+            base_sys_time = m_base_sys_time;
+        }
+
+        void playback_clock::leave(const void * reader)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_positions.erase(reader);
+        }
+
+        void playback_clock::get_time_base(uint64_t & base_time, time_point & base_sys_time)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            base_time = m_base_time;
+            base_sys_time = m_base_sys_time;
+        }
+
+        void playback_clock::request_time(uint64_t time)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_is_time_requested = true;
+            m_requested_time = time;
+        }
+
+        void playback_clock::set_position(const void * reader, uint64_t time)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            auto position = m_positions.find(reader);
+            if(position != m_positions.end())
+                position->second = time;
+        }
+
+        bool playback_clock::is_due(uint64_t time)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            for(auto & position : m_positions)
+            {
+                if(position.second < time)
+                    return false;
+            }
+            return true;
+        }
+    }
+}
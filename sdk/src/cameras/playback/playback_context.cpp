@@ -2,23 +2,50 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include <memory>
+#include <algorithm>
 #include "rs/playback/playback_context.h"
 #include "playback_device_impl.h"
+#include "playback_clock.h"
 
 namespace rs
 {
     namespace playback
     {
-        context::context(const char *file_path) : m_init_status(false)
+        context::context(const char *file_path) : m_devices_count(1), m_init_status(false), m_start_times(1, 0)
         {
             m_devices = new rs_device*[1];
             m_devices[0] = new rs_device_ex(file_path);
             m_init_status = ((rs_device_ex*)m_devices[0])->init();
         }
 
+        context::context(const char ** file_paths, int files_count) : m_devices_count(std::max(files_count, 0)), m_init_status(files_count > 0),
+            m_clock(std::make_shared<playback_clock>()), m_start_times(m_devices_count, 0)
+        {
+            m_devices = new rs_device*[m_devices_count];
+            for(auto i = 0; i < m_devices_count; i++)
+            {
+                m_devices[i] = new rs_device_ex(file_paths[i]);
+                m_init_status = ((rs_device_ex*)m_devices[i])->init() && m_init_status;
+            }
+            if(!m_init_status)
+                return;
+
+            //the recordings are aligned by the host times of their first frames, recordings without host times are aligned by their start
+            for(auto i = 0; i < m_devices_count; i++)
+                m_start_times[i] = ((rs_device_ex*)m_devices[i])->get_start_time();
+            if(std::find(m_start_times.begin(), m_start_times.end(), 0) != m_start_times.end())
+                std::fill(m_start_times.begin(), m_start_times.end(), 0);
+            auto first_start_time = *std::min_element(m_start_times.begin(), m_start_times.end());
+            for(auto i = 0; i < m_devices_count; i++)
+            {
+                m_start_times[i] -= first_start_time;
+                ((rs_device_ex*)m_devices[i])->set_clock(m_clock, m_start_times[i]);
+            }
+        }
+
         context::~context()
         {
-            for(auto i = 0; i < 1; i++)
+            for(auto i = 0; i < m_devices_count; i++)
             {
                 if(m_devices[i])
                     delete m_devices[i];
@@ -28,17 +55,56 @@ namespace rs
 
         int context::get_device_count() const
         {
-            return m_init_status ? 1 : 0;
+            return m_init_status ? m_devices_count : 0;
         }
 
         rs::device * context::get_device(int index)
         {
-            return (rs::device*)get_playback_device();
+            return (rs::device*)get_playback_device(index);
         }
 
         device * context::get_playback_device()
         {
-            return m_init_status ? (device*)m_devices[0] : nullptr;
+            return get_playback_device(0);
+        }
+
+        device * context::get_playback_device(int index)
+        {
+            return m_init_status && index >= 0 && index < m_devices_count ? (device*)m_devices[index] : nullptr;
+        }
+
+        uint64_t context::get_start_time(int index) const
+        {
+            return index >= 0 && index < m_devices_count ? m_start_times[index] : 0;
+        }
+
+        bool context::set_time(uint64_t time)
+        {
+            if(!m_init_status)
+                return false;
+            //the devices are paused together, so the first device which is resumed sets the time base of the clock to the time
+            std::vector<bool> is_streaming(m_devices_count);
+            for(auto i = 0; i < m_devices_count; i++)
+            {
+                auto device = (rs_device_ex*)m_devices[i];
+                is_streaming[i] = device->is_capturing();
+                if(is_streaming[i])
+                    device->pause();
+            }
+            if(m_clock)
+                m_clock->request_time(time);
+            bool rv = true;
+            for(auto i = 0; i < m_devices_count; i++)
+            {
+                auto capture_time = time > m_start_times[i] ? time - m_start_times[i] : 0;
+                rv = ((rs_device_ex*)m_devices[i])->set_frame_by_capture_time(capture_time) && rv;
+            }
+            for(auto i = 0; i < m_devices_count; i++)
+            {
+                if(is_streaming[i])
+                    ((rs_device_ex*)m_devices[i])->resume();
+            }
+            return rv;
         }
     }
 }
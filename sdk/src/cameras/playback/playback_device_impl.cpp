@@ -9,6 +9,8 @@
 #include "playback_device_impl.h"
 #include "disk_read_factory.h"
 #include "rs/playback/playback_device.h"
+#include "rs/utils/thread_config.h"
+#include "rs/utils/thread_profiler.h"
 
 using namespace rs::core;
 
@@ -275,10 +277,8 @@ namespace rs
             return (int)(m_imu_thread.motion_callback && m_disk_read->is_motion_tracking_enabled());
         }
 
-        void rs_device_ex::wait_all_streams()
+        bool rs_device_ex::request_frames_set()
         {
-            LOG_FUNC_SCOPE();
-
             if(m_frame_thread.size() > 0)//frame callbacks are enabled
             {
                 pause();
@@ -288,22 +288,63 @@ namespace rs
             if(m_disk_read->query_capture_mode() == capture_mode::asynced)
                 throw std::runtime_error("this file was not recorded in synced mode (wait for frames). the file can be played only in asynced mode (frame callbacks)");
 
+            std::lock_guard<std::mutex> guard(m_mutex);
+            if(m_wait_streams_request)
             {
-                std::lock_guard<std::mutex> guard(m_mutex);
-                if(m_wait_streams_request)
-                {
-                    LOG_ERROR("read flag was set to true by another thread - no reentrance");
-                    return;
-                }
-                m_wait_streams_request = true;
+                LOG_ERROR("read flag was set to true by another thread - no reentrance");
+                return false;
             }
+            m_wait_streams_request = true;
+            return true;
+        }
+
+        bool rs_device_ex::end_frames_set_request()
+        {
+            //the read thread clears the request when it sets the frames, a request which wasn't served is withdrawn
+            std::lock_guard<std::mutex> guard(m_mutex);
+            auto is_served = !m_wait_streams_request;
+            m_wait_streams_request = false;
+            return is_served;
+        }
+
+        void rs_device_ex::wait_all_streams()
+        {
+            LOG_FUNC_SCOPE();
+
+            if(!request_frames_set())
+                return;
 
-            std::unique_lock<std::mutex> guard(m_all_stream_available_mutex);
-            if(m_is_streaming)
             {
-                m_all_stream_available_cv.wait(guard);
-                guard.unlock();
+                std::unique_lock<std::mutex> guard(m_all_stream_available_mutex);
+                m_all_stream_available_cv.wait(guard, [this]() { return !m_wait_streams_request || !m_is_streaming; });
+            }
+            end_frames_set_request();
+        }
+
+        bool rs_device_ex::wait_all_streams_for(uint32_t timeout)
+        {
+            LOG_FUNC_SCOPE();
+
+            if(!request_frames_set())
+                return false;
+
+            {
+                std::unique_lock<std::mutex> guard(m_all_stream_available_mutex);
+                m_all_stream_available_cv.wait_for(guard, std::chrono::milliseconds(timeout), [this]() { return !m_wait_streams_request || !m_is_streaming; });
+            }
+            return end_frames_set_request();
+        }
+
+        intptr_t rs_device_ex::get_frames_ready_handle()
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            if(!m_frames_ready_event)
+            {
+                m_frames_ready_event.reset(new frames_ready_event());
+                if(m_frame_thread.empty() && all_streams_available())
+                    m_frames_ready_event->set();
             }
+            return m_frames_ready_event->handle();
         }
 
         bool rs_device_ex::poll_all_streams()
@@ -320,6 +361,9 @@ namespace rs
                 throw std::runtime_error("this file was not recorded in synced mode (wait for frames). the file can be played only in asynced mode (frame callbacks)");
 
             std::lock_guard<std::mutex> guard(m_mutex);
+            //the frames set is consumed, the event is set again by the next frames set
+            if(m_frames_ready_event)
+                m_frames_ready_event->reset();
 
             if(all_streams_available())
             {
@@ -346,20 +390,19 @@ namespace rs
 
         bool rs_device_ex::supports_option(rs_option option) const
         {
-            std::map<rs_option, double> props = m_disk_read->get_properties();
-            return props.find(option) != props.end();
+            return m_disk_read->get_properties().contains(option);
         }
 
         void rs_device_ex::get_option_range(rs_option option, double & min, double & max, double & step, double & def)
         {
             //return the current value as range
-            auto properties = m_disk_read->get_properties();
-            if(properties.find(option) != properties.end())
+            auto & properties = m_disk_read->get_properties();
+            if(properties.contains(option))
             {
-                min = properties[option];
-                max = properties[option];
+                min = properties.get(option);
+                max = min;
                 step = 0;
-                def = properties[option];
+                def = min;
             }
         }
 
@@ -379,17 +422,23 @@ namespace rs
 
         void rs_device_ex::get_options(const rs_option options[], size_t count, double values[])
         {
-            std::map<rs_option, double> props = m_disk_read->get_properties();
+            auto & properties = m_disk_read->get_properties();
             for(size_t i = 0; i < count; i++)
             {
-                if(props.find(options[i]) != props.end())
-                    values[i] = props.at(options[i]);
+                if(properties.contains(options[i]))
+                    values[i] = properties.get(options[i]);
             }
         }
 
         void rs_device_ex::release_frame(rs_frame_ref * ref)
         {
             LOG_VERBOSE("release frame");
+            if(dynamic_cast<rs_batch_frame_ref_impl*>(ref))
+            {
+                //the batch frames data is owned by the frame, it's not tied to the streaming state
+                delete ref;
+                return;
+            }
             auto stream_type = ref->get_stream_type();
             std::lock_guard<std::mutex> guard(m_frame_thread[stream_type].mutex);
             delete ref;
@@ -523,11 +572,237 @@ namespace rs
             return !frames.empty();
         }
 
+        bool rs_device_ex::set_frame_by_capture_time(uint64_t capture_time)
+        {
+            LOG_FUNC_SCOPE();
+            auto frames = m_disk_read->set_frame_by_capture_time(capture_time);
+            for(auto it = frames.begin(); it != frames.end(); ++it)
+            {
+                if(!m_available_streams[it->first]->is_enabled())
+                {
+                    LOG_ERROR("stream is not enabled");
+                    throw std::runtime_error("stream is not enabled");
+                }
+                m_available_streams[it->first]->set_frame(it->second);
+            }
+            return !frames.empty();
+        }
+
+        uint64_t rs_device_ex::get_start_time()
+        {
+            return m_disk_read->query_start_time();
+        }
+
+        void rs_device_ex::set_clock(std::shared_ptr<playback_clock> clock, uint64_t offset)
+        {
+            m_disk_read->set_clock(clock, offset);
+        }
+
         void rs_device_ex::set_real_time(bool realtime)
         {
             m_disk_read->set_realtime(realtime);
         }
 
+        bool rs_device_ex::set_playback_rate(double rate)
+        {
+            LOG_INFO("playback rate - " << rate);
+            return m_disk_read->set_playback_rate(rate);
+        }
+
+        double rs_device_ex::get_playback_rate()
+        {
+            return m_disk_read->query_playback_rate();
+        }
+
+        bool rs_device_ex::set_frame_queue(rs_stream stream, uint32_t queue_size, frame_drop_policy policy)
+        {
+            LOG_INFO("stream - " << stream << ", queue size - " << queue_size << ", drop policy - " << policy);
+            if(m_is_streaming || queue_size == 0)
+                return false;
+            m_frame_queue_configs[stream].max_queue_size = queue_size;
+            m_frame_queue_configs[stream].drop_policy = policy;
+            return true;
+        }
+
+        bool rs_device_ex::set_read_ahead_window(uint32_t samples_count)
+        {
+            LOG_INFO("read ahead window - " << samples_count);
+            if(m_is_streaming)
+                return false;
+            m_disk_read->set_read_ahead_window(samples_count);
+            return true;
+        }
+
+        bool rs_device_ex::set_frame_decimation(rs_stream stream, uint32_t frames_interval, double frame_rate)
+        {
+            LOG_INFO("stream - " << stream << ", decimation frames interval - " << frames_interval << ", frame rate - " << frame_rate);
+            if(m_is_streaming || frame_rate < 0)
+                return false;
+            m_disk_read->set_frame_decimation(stream, frames_interval, frame_rate);
+            return true;
+        }
+
+        bool rs_device_ex::set_looped_playback(bool looped, uint64_t max_memory_size)
+        {
+            LOG_INFO("looped playback - " << looped << " ,max memory size - " << max_memory_size);
+            if(m_is_streaming)
+                return false;
+            //a loop which holds no samples in memory reads the file at each loop
+            m_disk_read->set_loop_memory_size(looped ? std::max<uint64_t>(max_memory_size, 1) : 0);
+            return true;
+        }
+
+        bool rs_device_ex::set_frame_buffer_allocator(rs_stream stream, frame_buffer_allocator allocator)
+        {
+            LOG_INFO("stream - " << stream << ", frame buffer allocator - " << (allocator ? "set" : "default"));
+            if(m_is_streaming)
+                return false;
+            m_disk_read->set_frame_buffer_allocator(stream, allocator);
+            return true;
+        }
+
+        bool rs_device_ex::extract(const char * file_path, uint64_t start_time, uint64_t end_time, const std::vector<rs_stream> & streams, bool include_motions)
+        {
+            LOG_INFO("extract to - " << file_path << " ,start time - " << start_time << " ,end time - " << end_time);
+            if(m_is_streaming || !file_path)
+                return false;
+            auto sts = m_disk_read->extract(file_path, start_time, end_time, streams, include_motions);
+            if(sts != status::status_no_error)
+            {
+                LOG_ERROR("failed to extract, status - " << sts);
+                return false;
+            }
+            return true;
+        }
+
+        bool rs_device_ex::verify(verification_result & result)
+        {
+            LOG_FUNC_SCOPE();
+            if(m_is_streaming)
+                return false;
+            auto sts = m_disk_read->verify(result);
+            if(sts != status::status_no_error)
+            {
+                LOG_ERROR("failed to verify, status - " << sts);
+                return false;
+            }
+            return true;
+        }
+
+        bool rs_device_ex::get_preview_frame(rs_stream stream, int index, preview_frame & frame)
+        {
+            if(index < 0)
+                return false;
+            auto sts = m_disk_read->read_preview_frame(stream, static_cast<uint32_t>(index), frame);
+            if(sts != status::status_no_error)
+            {
+                LOG_VERBOSE("preview frame is not available, stream - " << stream << " ,index - " << index << " ,status - " << sts);
+                return false;
+            }
+            return true;
+        }
+
+        bool rs_device_ex::read_motions(rs_event_source source, uint64_t start_time, uint64_t end_time, motion_columns & columns)
+        {
+            if(m_is_streaming)
+            {
+                columns = motion_columns();
+                LOG_ERROR("motions read while streaming is not allowed");
+                return false;
+            }
+            auto sts = m_disk_read->read_motions(source, start_time, end_time, columns);
+            if(sts != status::status_no_error)
+            {
+                LOG_ERROR("failed to read motions, status - " << sts);
+                return false;
+            }
+            return true;
+        }
+
+        bool rs_device_ex::export_mcap(const char * file_path, const std::vector<rs_stream> & streams, bool include_motions, bool decode_frames)
+        {
+            LOG_INFO("export mcap to - " << file_path << " ,decode frames - " << decode_frames);
+            if(m_is_streaming || !file_path)
+                return false;
+            auto sts = m_disk_read->export_mcap(file_path, streams, include_motions, decode_frames);
+            if(sts != status::status_no_error)
+            {
+                LOG_ERROR("failed to export mcap, status - " << sts);
+                return false;
+            }
+            return true;
+        }
+
+        uint32_t rs_device_ex::scan_frames(uint64_t & position, std::vector<frame_descriptor> & frames, uint32_t max_frames, bool read_metadata)
+        {
+            frames.clear();
+            if(m_is_streaming)
+            {
+                LOG_ERROR("frames scan while streaming is not allowed");
+                return 0;
+            }
+            return m_disk_read->scan_frames(position, frames, max_frames, read_metadata);
+        }
+
+        uint32_t rs_device_ex::read_frames_batch(std::vector<std::map<rs_stream, rs_frame_ref *>> & batch, uint32_t max_sets)
+        {
+            batch.clear();
+            if(m_is_streaming)
+            {
+                LOG_ERROR("batch read while streaming is not allowed");
+                return 0;
+            }
+            set_enabled_streams();
+            m_disk_read->read_frames_batch(m_batch, max_sets);
+            for(auto & set : m_batch)
+            {
+                std::map<rs_stream, rs_frame_ref *> frames;
+                for(auto & frame : set)
+                    frames[frame.first] = new rs_batch_frame_ref_impl(frame.second);
+                batch.push_back(std::move(frames));
+            }
+            //the batch holds the frames until the application releases them, the sets vector is reused by the next read
+            m_batch.clear();
+            return static_cast<uint32_t>(batch.size());
+        }
+
+        bool rs_device_ex::compute_synced_sets(const std::vector<rs_stream> & streams, double max_time_difference, synced_sets & sets)
+        {
+            sets = synced_sets();
+            if(m_is_streaming)
+            {
+                LOG_ERROR("synced sets computed while streaming is not allowed");
+                return false;
+            }
+            auto sts = m_disk_read->compute_synced_sets(streams, max_time_difference, sets);
+            if(sts != status::status_no_error)
+            {
+                LOG_ERROR("failed to compute synced sets, status - " << sts);
+                return false;
+            }
+            return true;
+        }
+
+        uint32_t rs_device_ex::read_synced_sets(const synced_sets & sets, uint32_t first_set, std::vector<std::map<rs_stream, rs_frame_ref *>> & batch, uint32_t max_sets)
+        {
+            batch.clear();
+            if(m_is_streaming)
+            {
+                LOG_ERROR("synced sets read while streaming is not allowed");
+                return 0;
+            }
+            m_disk_read->read_synced_sets(sets, first_set, max_sets, m_batch);
+            for(auto & set : m_batch)
+            {
+                std::map<rs_stream, rs_frame_ref *> frames;
+                for(auto & frame : set)
+                    frames[frame.first] = new rs_batch_frame_ref_impl(frame.second);
+                batch.push_back(std::move(frames));
+            }
+            m_batch.clear();
+            return static_cast<uint32_t>(batch.size());
+        }
+
         int rs_device_ex::get_frame_index(rs_stream stream)
         {
             auto frame = m_available_streams[stream]->get_frame();
@@ -558,6 +833,11 @@ namespace rs
             return nframes;
         }
 
+        double rs_device_ex::get_index_progress()
+        {
+            return m_disk_read->query_index_progress();
+        }
+
         playback::file_info rs_device_ex::get_file_info()
         {
             return m_disk_read->query_file_info();
@@ -574,16 +854,18 @@ namespace rs
             {
                 std::lock_guard<std::mutex> guard(m_mutex);
                 m_curr_frames[stream] = frame;
+                if(m_frames_ready_event && m_frame_thread.empty() && all_streams_available())
+                    m_frames_ready_event->set();
             }
             if(m_frame_thread.size() > 0)//async
             {
                 if(m_frame_thread.find(stream) == m_frame_thread.end()) return;
                 if(m_disk_read->query_realtime())
                 {
+                    //the read thread only queues the frame, a slow callback drops frames of its own stream
                     std::unique_lock<std::mutex> guard(m_frame_thread[stream].mutex);
-                    if(m_frame_thread[stream].sample != nullptr)
+                    if(!m_frame_thread[stream].push_sample(frame))
                         m_disk_read->update_frame_drop_count(stream, 1);
-                    m_frame_thread[stream].sample = frame;
                     guard.unlock();
                     m_frame_thread[stream].sample_ready_cv.notify_one();
                 }
@@ -615,6 +897,8 @@ namespace rs
                         m_all_stream_available_cv.notify_one();
                         m_wait_streams_request = false;
                         m_curr_frames.clear();
+                        if(m_frames_ready_event)
+                            m_frames_ready_event->reset();
                         LOG_VERBOSE("all streams are available");
                     }
                 }
@@ -628,25 +912,34 @@ namespace rs
 
         void rs_device_ex::frame_callback_thread(rs_stream stream)
         {
-            auto pred = [this, stream]()->bool{ return (m_frame_thread[stream].sample != nullptr) || (m_is_streaming == false);};
+            rs::utils::thread_configuration::apply(rs::utils::thread_role::playback, "rs-play-frames");
+            rs::utils::thread_profiler profiler(rs::utils::thread_role::playback);
+            profiler.start();
+            auto pred = [this, stream]()->bool{ return (m_frame_thread[stream].samples.empty() == false) || (m_is_streaming == false);};
 
             while(m_is_streaming)
             {
-                std::unique_lock<std::mutex> guard(m_frame_thread[stream].mutex);
-                m_frame_thread[stream].sample_ready_cv.wait(guard, pred);
+                profiler.lock(m_frame_thread[stream].mutex);
+                std::unique_lock<std::mutex> guard(m_frame_thread[stream].mutex, std::adopt_lock);
+                {
+                    rs::utils::thread_profiler::wait_scope input_wait(profiler, rs::utils::thread_wait::input);
+                    m_frame_thread[stream].sample_ready_cv.wait(guard, pred);
+                }
                 rs_frame_ref_impl * frame_ref = nullptr;
                 if(m_is_streaming)
                 {
-                    frame_ref = new rs_frame_ref_impl(m_frame_thread[stream].sample);
+                    frame_ref = new rs_frame_ref_impl(m_frame_thread[stream].samples.front());
                     m_frame_thread[stream].active_samples_count++;
-                    m_frame_thread[stream].sample = nullptr;
+                    m_frame_thread[stream].samples.pop_front();
                 }
                 guard.unlock();
                 if(frame_ref)
                 {
                     m_frame_thread[stream].callback->on_frame(this, frame_ref);
+                    profiler.add_processed_items();
                 }
             }
+            profiler.stop();
         }
 
         void rs_device_ex::handle_motion_callback(std::shared_ptr<file_types::sample> sample)
@@ -671,21 +964,30 @@ namespace rs
 
         void rs_device_ex::motion_callback_thread()
         {
+            rs::utils::thread_configuration::apply(rs::utils::thread_role::playback, "rs-play-motion");
+            rs::utils::thread_profiler profiler(rs::utils::thread_role::playback);
+            profiler.start();
             auto pred = [this]()->bool{ return (m_imu_thread.samples.empty() == false) || (m_is_streaming == false);};
 
             while(m_is_streaming || !m_imu_thread.samples.empty())
             {
-                std::unique_lock<std::mutex> guard(m_imu_thread.mutex);
-                m_imu_thread.sample_ready_cv.wait(guard, pred);
+                profiler.lock(m_imu_thread.mutex);
+                std::unique_lock<std::mutex> guard(m_imu_thread.mutex, std::adopt_lock);
+                {
+                    rs::utils::thread_profiler::wait_scope input_wait(profiler, rs::utils::thread_wait::input);
+                    m_imu_thread.sample_ready_cv.wait(guard, pred);
+                }
                 std::queue<std::shared_ptr<core::file_types::sample>> data;
                 std::swap(m_imu_thread.samples, data);
                 guard.unlock();
+                profiler.add_processed_items(data.size());
                 while (!data.empty())
                 {
                     m_imu_thread.push_sample_to_user(data.front());
                     data.pop();
                 }
             }
+            profiler.stop();
         }
 
         bool rs_device_ex::init()
@@ -717,6 +1019,7 @@ namespace rs
                     case file_types::sample_type::st_motion:        handle_motion_callback(sample); break;
                     case file_types::sample_type::st_time:          handle_motion_callback(sample); break;
                     case file_types::sample_type::st_debug_event:   break;
+                    case file_types::sample_type::st_motion_block:  break; //motion blocks are indexed as their motion and time stamp samples
                 }
             };
 
@@ -790,6 +1093,8 @@ namespace rs
             for(auto it = m_frame_thread.begin(); it != m_frame_thread.end(); ++it)
             {
                 it->second.active_samples_count = 0;
+                it->second.samples.clear();
+                it->second.queue_config = m_frame_queue_configs[it->first];
                 it->second.thread = std::thread(&rs_device_ex::frame_callback_thread, this, it->first);
             }
             if(m_disk_read->is_motion_tracking_enabled())
@@ -847,6 +1152,16 @@ namespace rs
             ((rs_device_ex*)this)->pause();
         }
 
+        bool device::try_wait_for_frames(uint32_t timeout)
+        {
+            return ((rs_device_ex*)this)->wait_all_streams_for(timeout);
+        }
+
+        intptr_t device::get_frames_ready_handle()
+        {
+            return ((rs_device_ex*)this)->get_frames_ready_handle();
+        }
+
         bool device::set_frame_by_index(int index, rs::stream stream)
         {
             return((rs_device_ex*)this)->set_frame_by_index(index, (rs_stream)stream);
@@ -862,6 +1177,113 @@ namespace rs
             ((rs_device_ex*)this)->set_real_time(realtime);
         }
 
+        bool device::set_playback_rate(double rate)
+        {
+            return ((rs_device_ex*)this)->set_playback_rate(rate);
+        }
+
+        double device::get_playback_rate()
+        {
+            return ((rs_device_ex*)this)->get_playback_rate();
+        }
+
+        bool device::set_frame_queue(rs::stream stream, uint32_t queue_size, frame_drop_policy policy)
+        {
+            return ((rs_device_ex*)this)->set_frame_queue((rs_stream)stream, queue_size, policy);
+        }
+
+        bool device::set_read_ahead_window(uint32_t samples_count)
+        {
+            return ((rs_device_ex*)this)->set_read_ahead_window(samples_count);
+        }
+
+        bool device::set_frame_decimation(rs::stream stream, uint32_t frames_interval, double frame_rate)
+        {
+            return ((rs_device_ex*)this)->set_frame_decimation((rs_stream)stream, frames_interval, frame_rate);
+        }
+
+        bool device::set_looped_playback(bool looped, uint64_t max_memory_size)
+        {
+            return ((rs_device_ex*)this)->set_looped_playback(looped, max_memory_size);
+        }
+
+        bool device::set_frame_buffer_allocator(rs::stream stream, frame_buffer_allocator allocator)
+        {
+            return ((rs_device_ex*)this)->set_frame_buffer_allocator((rs_stream)stream, allocator);
+        }
+
+        bool device::extract(const char * file_path, uint64_t start_time, uint64_t end_time, const std::vector<rs::stream> & streams, bool include_motions)
+        {
+            std::vector<rs_stream> rs_streams;
+            for(auto stream : streams)
+                rs_streams.push_back((rs_stream)stream);
+            return ((rs_device_ex*)this)->extract(file_path, start_time, end_time, rs_streams, include_motions);
+        }
+
+        bool device::verify(verification_result & result)
+        {
+            return ((rs_device_ex*)this)->verify(result);
+        }
+
+        bool device::get_preview_frame(rs::stream stream, int index, preview_frame & frame)
+        {
+            return ((rs_device_ex*)this)->get_preview_frame((rs_stream)stream, index, frame);
+        }
+
+        uint32_t device::scan_frames(uint64_t & position, std::vector<frame_descriptor> & frames, uint32_t max_frames, bool read_metadata)
+        {
+            return ((rs_device_ex*)this)->scan_frames(position, frames, max_frames, read_metadata);
+        }
+
+        bool device::read_motions(rs::event source, uint64_t start_time, uint64_t end_time, motion_columns & columns)
+        {
+            return ((rs_device_ex*)this)->read_motions(static_cast<rs_event_source>(source), start_time, end_time, columns);
+        }
+
+        bool device::export_mcap(const char * file_path, const std::vector<rs::stream> & streams, bool include_motions, bool decode_frames)
+        {
+            std::vector<rs_stream> rs_streams;
+            for(auto stream : streams)
+                rs_streams.push_back((rs_stream)stream);
+            return ((rs_device_ex*)this)->export_mcap(file_path, rs_streams, include_motions, decode_frames);
+        }
+
+        uint32_t device::read_frames_batch(std::vector<std::map<rs::stream, rs::frame>> & batch, uint32_t max_sets)
+        {
+            batch.clear();
+            std::vector<std::map<rs_stream, rs_frame_ref *>> frames_refs;
+            auto sets_count = ((rs_device_ex*)this)->read_frames_batch(frames_refs, max_sets);
+            for(auto & frames_set : frames_refs)
+            {
+                batch.emplace_back();
+                for(auto & frame_ref : frames_set)
+                    batch.back().emplace((rs::stream)frame_ref.first, rs::frame((rs_device*)this, frame_ref.second));
+            }
+            return sets_count;
+        }
+
+        bool device::compute_synced_sets(const std::vector<rs::stream> & streams, double max_time_difference, synced_sets & sets)
+        {
+            std::vector<rs_stream> rs_streams;
+            for(auto stream : streams)
+                rs_streams.push_back((rs_stream)stream);
+            return ((rs_device_ex*)this)->compute_synced_sets(rs_streams, max_time_difference, sets);
+        }
+
+        uint32_t device::read_synced_sets(const synced_sets & sets, uint32_t first_set, std::vector<std::map<rs::stream, rs::frame>> & batch, uint32_t max_sets)
+        {
+            batch.clear();
+            std::vector<std::map<rs_stream, rs_frame_ref *>> frames_refs;
+            auto sets_count = ((rs_device_ex*)this)->read_synced_sets(sets, first_set, frames_refs, max_sets);
+            for(auto & frames_set : frames_refs)
+            {
+                batch.emplace_back();
+                for(auto & frame_ref : frames_set)
+                    batch.back().emplace((rs::stream)frame_ref.first, rs::frame((rs_device*)this, frame_ref.second));
+            }
+            return sets_count;
+        }
+
         int device::get_frame_index(rs::stream stream)
         {
             return ((rs_device_ex*)this)->get_frame_index((rs_stream)stream);
@@ -877,6 +1299,11 @@ namespace rs
             return ((rs_device_ex*)this)->get_frame_count();
         }
 
+        double device::get_index_progress()
+        {
+            return ((rs_device_ex*)this)->get_index_progress();
+        }
+
         file_info device::get_file_info()
         {
             return ((rs_device_ex*)this)->get_file_info();
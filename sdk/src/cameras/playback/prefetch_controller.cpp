@@ -0,0 +1,121 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <cmath>
+#include "prefetch_controller.h"
+
+using namespace rs::core;
+
+namespace
+{
+    //weight of the last measure in the averages
+    const double AVERAGE_WEIGHT = 0.125;
+    //the frames cover twice the average read time, a read which is slower than the average doesn't stall the consumer
+    const double READ_TIME_MARGIN = 2.0;
+    const double MOTION_GAP_DECAY = 0.95;
+
+    void update_average(double & average, double value)
+    {
+        average = average == 0 ? value : average + AVERAGE_WEIGHT * (value - average);
+    }
+}
+
+namespace rs
+{
+    namespace playback
+    {
+        std::atomic<uint64_t> prefetch_controller::s_prefetched_bytes(0);
+
+        void prefetch_controller::add_read_time(rs_stream stream, uint64_t read_time)
+        {
+            update_average(m_streams[stream].read_time, static_cast<double>(read_time));
+        }
+
+        void prefetch_controller::add_prefetched(const file_types::sample & sample)
+        {
+            auto size = sample_size(sample);
+            m_prefetched_bytes += size;
+            s_prefetched_bytes += size;
+            rs::utils::memory_accounting::add(rs::utils::memory_subsystem::playback, size);
+        }
+
+        void prefetch_controller::add_delivered(const file_types::sample & sample)
+        {
+            auto size = std::min(sample_size(sample), m_prefetched_bytes);
+            m_prefetched_bytes -= size;
+            s_prefetched_bytes -= size;
+            rs::utils::memory_accounting::remove(rs::utils::memory_subsystem::playback, size);
+            if(sample.info.type == file_types::sample_type::st_image)
+            {
+                auto & frame = static_cast<const file_types::frame_sample &>(sample);
+                update_delivery(m_streams[frame.finfo.stream]);
+            }
+            else if(sample.info.type == file_types::sample_type::st_motion)
+            {
+                auto interval = update_delivery(m_motions);
+                m_motion_max_gap = std::max(interval, m_motion_max_gap * MOTION_GAP_DECAY);
+            }
+        }
+
+        void prefetch_controller::clear()
+        {
+            s_prefetched_bytes -= m_prefetched_bytes;
+            rs::utils::memory_accounting::remove(rs::utils::memory_subsystem::playback, m_prefetched_bytes);
+            m_prefetched_bytes = 0;
+            restart();
+        }
+
+        void prefetch_controller::restart()
+        {
+            for(auto & stream : m_streams)
+                stream.second.has_delivery = false;
+            m_motions.has_delivery = false;
+        }
+
+        uint32_t prefetch_controller::required_frames(rs_stream stream, uint64_t frame_size, size_t streams_count) const
+        {
+            //the memory budget is shared by the streams, a stream keeps its next frame in any case
+            uint64_t budget_frames = MEMORY_BUDGET / std::max<uint64_t>(frame_size * std::max<size_t>(streams_count, 1), 1);
+            uint32_t max_frames = static_cast<uint32_t>(std::max<uint64_t>(std::min<uint64_t>(budget_frames, MAX_PREFETCHED_FRAMES), 1));
+            auto statistics = m_streams.find(stream);
+            if(statistics == m_streams.end() || statistics->second.delivery_interval <= 0)
+                return 1;
+            auto frames = 1 + std::ceil(READ_TIME_MARGIN * statistics->second.read_time / statistics->second.delivery_interval);
+            return std::min(static_cast<uint32_t>(frames), max_frames);
+        }
+
+        uint32_t prefetch_controller::required_motions() const
+        {
+            if(m_motions.delivery_interval <= 0)
+                return MIN_PREFETCHED_MOTIONS;
+            double max_read_time = 0;
+            for(auto & stream : m_streams)
+                max_read_time = std::max(max_read_time, stream.second.read_time);
+            auto motions = std::ceil((m_motion_max_gap + READ_TIME_MARGIN * max_read_time) / m_motions.delivery_interval);
+            return static_cast<uint32_t>(std::min<double>(std::max<double>(motions, MIN_PREFETCHED_MOTIONS), MAX_PREFETCHED_MOTIONS));
+        }
+
+        uint64_t prefetch_controller::sample_size(const file_types::sample & sample)
+        {
+            if(sample.info.type != file_types::sample_type::st_image)
+                return 0;
+            auto & frame = static_cast<const file_types::frame_sample &>(sample);
+            return static_cast<uint64_t>(frame.finfo.stride) * frame.finfo.height;
+        }
+
+        double prefetch_controller::update_delivery(rate_statistics & statistics)
+        {
+            auto now = clock::now();
+            double interval = 0;
+            if(statistics.has_delivery)
+            {
+                interval = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(now - statistics.last_delivery).count());
+                update_average(statistics.delivery_interval, interval);
+            }
+            statistics.last_delivery = now;
+            statistics.has_delivery = true;
+            return interval;
+        }
+    }
+}
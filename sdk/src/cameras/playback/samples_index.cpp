@@ -0,0 +1,138 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include "samples_index.h"
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace playback
+    {
+        const uint32_t samples_index::NO_SAMPLE;
+
+        void samples_index::reserve(size_t samples_count)
+        {
+            m_types.reserve(samples_count);
+            m_capture_times.reserve(samples_count);
+            m_offsets.reserve(samples_count);
+            m_streams.reserve(samples_count);
+            m_data_indices.reserve(samples_count);
+        }
+
+        void samples_index::clear()
+        {
+            m_types.clear();
+            m_capture_times.clear();
+            m_offsets.clear();
+            m_streams.clear();
+            m_data_indices.clear();
+            m_frame_infos.clear();
+            m_motions.clear();
+            m_time_stamps.clear();
+            m_debug_events.clear();
+            m_frames_by_time_stamp.clear();
+        }
+
+        uint32_t samples_index::add_sample(const file_types::sample_info & sample_info, rs_stream stream, size_t data_index)
+        {
+            m_types.push_back(sample_info.type);
+            m_capture_times.push_back(sample_info.capture_time);
+            m_offsets.push_back(sample_info.offset);
+            m_streams.push_back(stream);
+            m_data_indices.push_back(static_cast<uint32_t>(data_index));
+            return static_cast<uint32_t>(m_types.size() - 1);
+        }
+
+        uint32_t samples_index::add_frame(const file_types::frame_info & frame_info, const file_types::sample_info & sample_info)
+        {
+            m_frame_infos.push_back(frame_info);
+            auto index = add_sample(sample_info, frame_info.stream, m_frame_infos.size() - 1);
+            auto & stream_frames = m_frames_by_time_stamp[frame_info.stream];
+            if(stream_frames.empty() || frame_time_stamp(stream_frames.back()) <= frame_info.time_stamp)
+                stream_frames.push_back(index);
+            else
+                stream_frames.insert(std::upper_bound(stream_frames.begin(), stream_frames.end(), frame_info.time_stamp,
+                                                      [this](double value, uint32_t frame) { return value < frame_time_stamp(frame); }), index);
+            return index;
+        }
+
+        uint32_t samples_index::add_motion(const rs_motion_data & motion_data, const file_types::sample_info & sample_info)
+        {
+            m_motions.push_back(motion_data);
+            return add_sample(sample_info, rs_stream::RS_STREAM_COUNT, m_motions.size() - 1);
+        }
+
+        uint32_t samples_index::add_time_stamp(const rs_timestamp_data & time_stamp_data, const file_types::sample_info & sample_info)
+        {
+            m_time_stamps.push_back(time_stamp_data);
+            return add_sample(sample_info, rs_stream::RS_STREAM_COUNT, m_time_stamps.size() - 1);
+        }
+
+        uint32_t samples_index::add_debug_event(file_types::debug_event_type event_type, const file_types::sample_info & sample_info,
+                                                const file_types::debug_data * debug_data)
+        {
+            debug_event event = {};
+            event.type = event_type;
+            event.has_data = debug_data != nullptr;
+            if(debug_data)
+                event.data = *debug_data;
+            m_debug_events.push_back(event);
+            return add_sample(sample_info, debug_data ? debug_data->stream_type : rs_stream::RS_STREAM_COUNT, m_debug_events.size() - 1);
+        }
+
+        file_types::sample_info samples_index::get_sample_info(uint32_t index) const
+        {
+            file_types::sample_info info = {};
+            info.type = m_types[index];
+            info.capture_time = m_capture_times[index];
+            info.offset = m_offsets[index];
+            info.capture_time_unit = file_types::time_unit::microseconds;
+            return info;
+        }
+
+        std::shared_ptr<file_types::sample> samples_index::get_sample(uint32_t index) const
+        {
+            auto info = get_sample_info(index);
+            auto data_index = m_data_indices[index];
+            switch(info.type)
+            {
+                case file_types::sample_type::st_image:
+                    return std::make_shared<file_types::frame_sample>(m_frame_infos[data_index], info);
+                case file_types::sample_type::st_motion:
+                    return std::make_shared<file_types::motion_sample>(m_motions[data_index], info);
+                case file_types::sample_type::st_time:
+                    return std::make_shared<file_types::time_stamp_sample>(m_time_stamps[data_index], info);
+                case file_types::sample_type::st_debug_event:
+                {
+                    auto & event = m_debug_events[data_index];
+                    std::shared_ptr<file_types::debug_data> debug_data = nullptr;
+                    if(event.has_data)
+                        debug_data = std::make_shared<file_types::debug_data>(event.data);
+                    return std::make_shared<file_types::debug_event_sample>(event.type, info, debug_data);
+                }
+                default:
+                    return nullptr;
+            }
+        }
+
+        std::shared_ptr<file_types::frame_sample> samples_index::get_frame(uint32_t index) const
+        {
+            if(m_types[index] != file_types::sample_type::st_image)
+                return nullptr;
+            return std::make_shared<file_types::frame_sample>(m_frame_infos[m_data_indices[index]], get_sample_info(index));
+        }
+
+        uint32_t samples_index::find_frame_by_time_stamp(rs_stream stream, double time_stamp) const
+        {
+            auto stream_frames = m_frames_by_time_stamp.find(stream);
+            if(stream_frames == m_frames_by_time_stamp.end())
+                return NO_SAMPLE;
+            auto & frames = stream_frames->second;
+            auto frame = std::lower_bound(frames.begin(), frames.end(), time_stamp,
+                                          [this](uint32_t index, double value) { return frame_time_stamp(index) < value; });
+            return frame == frames.end() ? NO_SAMPLE : *frame;
+        }
+    }
+}
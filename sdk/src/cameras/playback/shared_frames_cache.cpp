@@ -0,0 +1,420 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#ifndef WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "shared_frames_cache.h"
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace playback
+    {
+#ifndef WIN32
+        namespace
+        {
+            static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "the segment atomics are shared between processes, they must be lock free");
+
+            const uint32_t SEGMENT_MAGIC = 0x52534643; // "RSFC"
+            const uint32_t SEGMENT_VERSION = 2;
+            const size_t SEGMENT_ALIGNMENT = 64;
+            //the creator initializes the segment header in a few microseconds, the other processes wait for it
+            const uint32_t MAX_INIT_WAIT_MS = 1000;
+
+            // set in the slot state while a process writes the slot, the lower bits count the frames which hold the slot
+            const uint32_t SLOT_WRITING = 0x80000000u;
+            // the processes which have the segment open, and the processes which hold a slot at a time
+            const uint32_t MAX_USERS = 64;
+            const uint32_t MAX_SLOT_HOLDERS = 8;
+
+            size_t align(size_t size) { return (size + SEGMENT_ALIGNMENT - 1) / SEGMENT_ALIGNMENT * SEGMENT_ALIGNMENT; }
+
+            struct segment_header
+            {
+                std::atomic<uint32_t> magic;            // written last, once the segment is initialized
+                uint32_t              version;
+                uint32_t              slots_count;
+                uint32_t              slot_size;
+                std::atomic<uint64_t> clock;            // ticks at each use of a slot, orders the slots by their last use
+                std::atomic<int32_t>  users[MAX_USERS]; // the pids of the processes which have the segment open, 0 for a free entry
+            };
+
+            struct slot_header
+            {
+                std::atomic<uint32_t>           state;
+                std::atomic<int32_t>            writer;     // the pid of the process which writes the slot, 0 while it isn't written
+                std::atomic<uint64_t>           holders[MAX_SLOT_HOLDERS]; // a pid in the high bits and the count of its frames which hold the slot, 0 for a free entry
+                std::atomic<uint64_t>           key_hash;   // 0 while the slot is empty or written
+                std::atomic<uint64_t>           last_used;
+                shared_frames_cache::frame_key  key;
+                file_types::frame_info          info;       // the decoded frame info, its stride is the stride of the slot data
+            };
+
+            // the segment layout: the header, then each slot header followed by its frame data
+            size_t get_slot_stride(uint32_t slot_size) { return align(sizeof(slot_header)) + align(slot_size); }
+
+            uint64_t hash_key(const shared_frames_cache::frame_key & key)
+            {
+                //fnv-1a over the key fields, 0 marks an empty slot
+                uint64_t hash = 14695981039346656037ull;
+                const uint64_t fields[] = { key.device, key.inode, key.file_size, static_cast<uint64_t>(key.modified_time),
+                                            static_cast<uint64_t>(static_cast<uint32_t>(key.stream)) << 32 | key.index };
+                for(auto field : fields)
+                {
+                    for(int i = 0; i < 8; i++)
+                    {
+                        hash ^= (field >> (i * 8)) & 0xff;
+                        hash *= 1099511628211ull;
+                    }
+                }
+                return hash == 0 ? 1 : hash;
+            }
+
+            bool is_same_key(const shared_frames_cache::frame_key & first, const shared_frames_cache::frame_key & second)
+            {
+                return first.device == second.device && first.inode == second.inode && first.file_size == second.file_size &&
+                       first.modified_time == second.modified_time && first.stream == second.stream && first.index == second.index;
+            }
+
+            uint64_t make_holder(int32_t pid, uint32_t count) { return static_cast<uint64_t>(static_cast<uint32_t>(pid)) << 32 | count; }
+            int32_t get_holder_pid(uint64_t holder) { return static_cast<int32_t>(holder >> 32); }
+            uint32_t get_holder_count(uint64_t holder) { return static_cast<uint32_t>(holder); }
+
+            //a process of another user exists though it can't be signaled
+            bool is_process_alive(int32_t pid)
+            {
+                return kill(pid, 0) == 0 || errno == EPERM;
+            }
+
+            //a slot is held unless a process writes it, the hold is recorded for the process so that the holds of an exited process are released,
+            //returns the holder entry of the process, -1 if the slot isn't held
+            int32_t try_hold(slot_header * slot, int32_t pid)
+            {
+                uint32_t state = slot->state.load(std::memory_order_relaxed);
+                do
+                {
+                    if(state & SLOT_WRITING)
+                        return -1;
+                } while(!slot->state.compare_exchange_weak(state, state + 1, std::memory_order_acquire));
+
+                for(uint32_t i = 0; i < MAX_SLOT_HOLDERS; i++)
+                {
+                    uint64_t holder = slot->holders[i].load(std::memory_order_relaxed);
+                    while(holder == 0 || get_holder_pid(holder) == pid)
+                    {
+                        if(slot->holders[i].compare_exchange_weak(holder, make_holder(pid, get_holder_count(holder) + 1), std::memory_order_relaxed))
+                            return static_cast<int32_t>(i);
+                    }
+                }
+                slot->state.fetch_sub(1, std::memory_order_release);
+                return -1;
+            }
+
+            void release_hold(slot_header * slot, int32_t holder_index)
+            {
+                auto & entry = slot->holders[holder_index];
+                uint64_t holder = entry.load(std::memory_order_relaxed);
+                while(!entry.compare_exchange_weak(holder, get_holder_count(holder) == 1 ? 0 : holder - 1, std::memory_order_relaxed)) {}
+                slot->state.fetch_sub(1, std::memory_order_release);
+            }
+
+            //releases the holds and the write of the processes which exited without releasing the slot
+            void reclaim_slot(slot_header * slot)
+            {
+                int32_t writer = slot->writer.load(std::memory_order_relaxed);
+                if(writer != 0 && !is_process_alive(writer) && slot->writer.compare_exchange_strong(writer, 0, std::memory_order_relaxed))
+                {
+                    slot->key_hash.store(0, std::memory_order_relaxed);
+                    slot->state.fetch_and(~SLOT_WRITING, std::memory_order_release);
+                }
+                for(auto & entry : slot->holders)
+                {
+                    uint64_t holder = entry.load(std::memory_order_relaxed);
+                    if(holder != 0 && !is_process_alive(get_holder_pid(holder)) && entry.compare_exchange_strong(holder, 0, std::memory_order_relaxed))
+                        slot->state.fetch_sub(get_holder_count(holder), std::memory_order_release);
+                }
+            }
+        }
+
+        class shared_frames_cache::segment
+        {
+        public:
+            segment(uint8_t * data, size_t size, const std::string & name, ino_t inode) : m_data(data), m_size(size), m_name(name), m_inode(inode), m_user(-1) {}
+            ~segment()
+            {
+                if(m_user >= 0)
+                    header()->users[m_user].store(0, std::memory_order_release);
+                if(!has_users())
+                    unlink_name();
+                munmap(m_data, m_size);
+            }
+
+            //records the process as a user of the segment, a process which doesn't fit the users table uses the segment unrecorded
+            void attach()
+            {
+                const int32_t pid = static_cast<int32_t>(getpid());
+                for(uint32_t i = 0; i < MAX_USERS && m_user < 0; i++)
+                {
+                    int32_t user = header()->users[i].load(std::memory_order_relaxed);
+                    if((user == 0 || !is_process_alive(user)) && header()->users[i].compare_exchange_strong(user, pid, std::memory_order_acq_rel))
+                        m_user = static_cast<int32_t>(i);
+                }
+            }
+
+            segment_header * header() const { return reinterpret_cast<segment_header *>(m_data); }
+            slot_header * slot(uint32_t index) const
+            {
+                return reinterpret_cast<slot_header *>(m_data + align(sizeof(segment_header)) + index * get_slot_stride(header()->slot_size));
+            }
+            uint8_t * slot_data(slot_header * slot) const { return reinterpret_cast<uint8_t *>(slot) + align(sizeof(slot_header)); }
+
+        private:
+            segment(const segment &) = delete;
+            segment & operator=(const segment &) = delete;
+
+            //the entries of the exited processes are released
+            bool has_users()
+            {
+                bool rv = false;
+                for(auto & entry : header()->users)
+                {
+                    int32_t user = entry.load(std::memory_order_acquire);
+                    if(user != 0 && !is_process_alive(user))
+                        entry.compare_exchange_strong(user, 0, std::memory_order_relaxed);
+                    else if(user != 0)
+                        rv = true;
+                }
+                return rv;
+            }
+
+            //the last user removes the segment name, unless the name was meanwhile removed and given to a new segment
+            void unlink_name()
+            {
+                int fd = shm_open(m_name.c_str(), O_RDONLY, 0);
+                if(fd < 0)
+                    return;
+                struct stat segment_stat = {};
+                const bool is_same_segment = fstat(fd, &segment_stat) == 0 && segment_stat.st_ino == m_inode;
+                close(fd);
+                if(is_same_segment)
+                    shm_unlink(m_name.c_str());
+            }
+
+            uint8_t *   m_data;
+            size_t      m_size;
+            std::string m_name;
+            ino_t       m_inode;
+            int32_t     m_user;     //the entry of the process in the users table, -1 if it's unrecorded
+        };
+
+        std::shared_ptr<shared_frames_cache> shared_frames_cache::open(const std::string & name, uint64_t size, uint32_t slot_size)
+        {
+            const uint32_t slots_count = static_cast<uint32_t>((size - std::min<uint64_t>(size, align(sizeof(segment_header)))) / get_slot_stride(slot_size));
+            if(slot_size == 0 || slots_count == 0)
+                return nullptr;
+
+            //the first process creates the segment, the others map the segment it created with its layout. The segment is private to the user,
+            //its name is of the user so that the segments of the users don't collide
+            const std::string user_name = name + "_" + std::to_string(geteuid());
+            bool is_creator = true;
+            int fd = shm_open(user_name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+            if(fd < 0)
+            {
+                is_creator = false;
+                fd = shm_open(user_name.c_str(), O_RDWR, 0);
+            }
+            if(fd < 0)
+                return nullptr;
+            size_t segment_size = align(sizeof(segment_header)) + slots_count * get_slot_stride(slot_size);
+            if(is_creator && ftruncate(fd, static_cast<off_t>(segment_size)) != 0)
+            {
+                close(fd);
+                shm_unlink(user_name.c_str());
+                return nullptr;
+            }
+            struct stat segment_stat = {};
+            for(uint32_t waited_ms = 0; fstat(fd, &segment_stat) != 0 || segment_stat.st_size == 0; waited_ms++)
+            {
+                if(waited_ms == MAX_INIT_WAIT_MS)
+                {
+                    close(fd);
+                    return nullptr;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            //a segment of the name created by another user isn't trusted
+            if(segment_stat.st_uid != geteuid() || (segment_stat.st_mode & (S_IRWXG | S_IRWXO)) != 0)
+            {
+                close(fd);
+                return nullptr;
+            }
+            if(!is_creator)
+                segment_size = static_cast<size_t>(segment_stat.st_size);
+
+            void * data = mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if(data == MAP_FAILED)
+                return nullptr;
+            auto mapping = std::make_shared<segment>(static_cast<uint8_t *>(data), segment_size, user_name, segment_stat.st_ino);
+            segment_header * header = mapping->header();
+            if(is_creator)
+            {
+                //the slots are zeroed by the truncate, an empty slot isn't held and has no key
+                header->version = SEGMENT_VERSION;
+                header->slots_count = slots_count;
+                header->slot_size = slot_size;
+                header->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+            }
+            for(uint32_t waited_ms = 0; header->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC; waited_ms++)
+            {
+                if(waited_ms == MAX_INIT_WAIT_MS)
+                    return nullptr;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if(header->version != SEGMENT_VERSION ||
+               segment_size < align(sizeof(segment_header)) + header->slots_count * get_slot_stride(header->slot_size))
+                return nullptr;
+            mapping->attach();
+            return std::shared_ptr<shared_frames_cache>(new shared_frames_cache(mapping));
+        }
+
+        bool shared_frames_cache::query_file_key(const std::string & file_path, frame_key & key)
+        {
+            struct stat file_stat = {};
+            if(stat(file_path.c_str(), &file_stat) != 0)
+                return false;
+            key.device = static_cast<uint64_t>(file_stat.st_dev);
+            key.inode = static_cast<uint64_t>(file_stat.st_ino);
+            key.file_size = static_cast<uint64_t>(file_stat.st_size);
+            key.modified_time = static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000 + file_stat.st_mtim.tv_nsec;
+            return true;
+        }
+
+        shared_frames_cache::~shared_frames_cache() {}
+
+        std::shared_ptr<file_types::frame_sample> shared_frames_cache::find(const frame_key & key, const file_types::frame_sample & descriptor)
+        {
+            segment_header * header = m_segment->header();
+            const uint64_t hash = hash_key(key);
+            const int32_t pid = static_cast<int32_t>(getpid());
+            for(uint32_t i = 0; i < header->slots_count; i++)
+            {
+                slot_header * slot = m_segment->slot(i);
+                if(slot->key_hash.load(std::memory_order_relaxed) != hash)
+                    continue;
+                const int32_t holder_index = try_hold(slot, pid);
+                if(holder_index < 0)
+                    continue;
+                //the key of a held slot isn't rewritten
+                if(slot->key_hash.load(std::memory_order_relaxed) != hash || !is_same_key(slot->key, key))
+                {
+                    release_hold(slot, holder_index);
+                    continue;
+                }
+                slot->last_used.store(header->clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                auto mapping = m_segment;
+                auto rv = std::shared_ptr<file_types::frame_sample>(new file_types::frame_sample(&descriptor), [mapping, slot, holder_index](file_types::frame_sample * f)
+                {
+                    release_hold(slot, holder_index);
+                    delete f;
+                });
+                rv->finfo.stride = slot->info.stride;
+                rv->data = m_segment->slot_data(slot);
+                return rv;
+            }
+            return nullptr;
+        }
+
+        bool shared_frames_cache::add(const frame_key & key, const file_types::frame_sample & frame)
+        {
+            segment_header * header = m_segment->header();
+            const uint64_t size = static_cast<uint64_t>(frame.finfo.stride) * frame.finfo.height;
+            if(frame.data == nullptr || frame.finfo.stride <= 0 || frame.finfo.height <= 0 || size > header->slot_size)
+                return false;
+
+            //the least recently used slot which isn't held is taken, a slot which was held meanwhile is skipped for the next one
+            const uint64_t hash = hash_key(key);
+            bool is_reclaimed = false;
+            for(uint32_t attempt = 0; attempt <= header->slots_count; attempt++)
+            {
+                slot_header * victim = nullptr;
+                uint64_t victim_last_used = 0;
+                for(uint32_t i = 0; i < header->slots_count; i++)
+                {
+                    slot_header * slot = m_segment->slot(i);
+                    //the frame was added by another process
+                    if(slot->key_hash.load(std::memory_order_relaxed) == hash)
+                        return true;
+                    auto last_used = slot->last_used.load(std::memory_order_relaxed);
+                    if(slot->state.load(std::memory_order_relaxed) == 0 && (!victim || last_used < victim_last_used))
+                    {
+                        victim = slot;
+                        victim_last_used = last_used;
+                    }
+                }
+                //the slots left held by the exited processes are released once all the slots are held, for one more attempt
+                if(!victim)
+                {
+                    if(is_reclaimed)
+                        return false;
+                    for(uint32_t i = 0; i < header->slots_count; i++)
+                        reclaim_slot(m_segment->slot(i));
+                    is_reclaimed = true;
+                    continue;
+                }
+                uint32_t free_state = 0;
+                if(!victim->state.compare_exchange_strong(free_state, SLOT_WRITING, std::memory_order_acquire))
+                    continue;
+
+                victim->writer.store(static_cast<int32_t>(getpid()), std::memory_order_relaxed);
+                victim->key_hash.store(0, std::memory_order_relaxed);
+                victim->key = key;
+                victim->info = frame.finfo;
+                memcpy(m_segment->slot_data(victim), frame.data, static_cast<size_t>(size));
+                victim->last_used.store(header->clock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                victim->key_hash.store(hash, std::memory_order_relaxed);
+                victim->writer.store(0, std::memory_order_relaxed);
+                victim->state.store(0, std::memory_order_release);
+                return true;
+            }
+            return false;
+        }
+#else
+        class shared_frames_cache::segment {};
+
+        std::shared_ptr<shared_frames_cache> shared_frames_cache::open(const std::string & name, uint64_t size, uint32_t slot_size)
+        {
+            return nullptr;
+        }
+
+        bool shared_frames_cache::query_file_key(const std::string & file_path, frame_key & key)
+        {
+            return false;
+        }
+
+        shared_frames_cache::~shared_frames_cache() {}
+
+        std::shared_ptr<file_types::frame_sample> shared_frames_cache::find(const frame_key & key, const file_types::frame_sample & descriptor)
+        {
+            return nullptr;
+        }
+
+        bool shared_frames_cache::add(const frame_key & key, const file_types::frame_sample & frame)
+        {
+            return false;
+        }
+#endif
+    }
+}
@@ -175,9 +175,10 @@ namespace rs
                     return data_read_status;
                 }
 
-                int32_t disk_read::size_of_pitches(void)
+                disk_read_base::format_traits disk_read::query_format_traits() const
                 {
-                    return sizeof(int32_t) * NUM_OF_PLANES;
+                    //the frame metadata is not played back
+                    return { static_cast<uint32_t>(sizeof(int32_t) * NUM_OF_PLANES), false, true };
                 }
 
                 void disk_read::index_next_samples(uint32_t number_of_samples)
@@ -223,8 +224,7 @@ namespace rs
                                 sample_info.capture_time = static_cast<uint64_t>(frame_info.time_stamp);
                                 m_file_indexing->get_position(&sample_info.offset);
                                 frame_info.index_in_stream = static_cast<uint32_t>(m_image_indices[frame_info.stream].size());
-                                m_image_indices[frame_info.stream].push_back(static_cast<uint32_t>(m_samples_desc.size()));
-                                m_samples_desc.push_back(std::make_shared<core::file_types::frame_sample>(frame_info, sample_info));
+                                m_image_indices[frame_info.stream].push_back(m_samples_desc.add_frame(frame_info, sample_info));
                                 ++index;
                                 LOG_VERBOSE("frame sample indexed, sample time - " << sample_info.capture_time)
                             }
@@ -239,13 +239,6 @@ namespace rs
                             break;
                     }
                 }
-
-                uint32_t disk_read::read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample> & frame, unsigned long num_bytes_to_read)
-                {
-                    //Does not do anything at the moment
-                    m_file_data_read->set_position(num_bytes_to_read, core::move_method::current);
-                    return 0;
-                }
             }
         }
     }
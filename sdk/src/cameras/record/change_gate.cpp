@@ -0,0 +1,104 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include "change_gate.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace record
+    {
+        const uint32_t change_gate::TILE_ROWS;
+        const uint32_t change_gate::TILE_BYTES;
+
+        namespace
+        {
+            //sum of the absolute differences of the bytes of a tile row, the row of a tile is at most TILE_BYTES bytes
+            uint32_t row_difference(const uint8_t * data, const uint8_t * reference, uint32_t size)
+            {
+                uint32_t difference = 0;
+                uint32_t i = 0;
+#if defined(__SSE2__)
+                //the sad instruction sums the absolute differences of 8 bytes into each 64 bit lane
+                __m128i sums = _mm_setzero_si128();
+                for(; i + 16 <= size; i += 16)
+                {
+                    sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)),
+                                                            _mm_loadu_si128(reinterpret_cast<const __m128i *>(reference + i))));
+                }
+                difference = static_cast<uint32_t>(_mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+#endif
+                for(; i < size; i++)
+                {
+                    difference += static_cast<uint32_t>(std::abs(data[i] - reference[i]));
+                }
+                return difference;
+            }
+        }
+
+        change_gate::change_gate() : m_reference_info() {}
+
+        bool change_gate::is_changed(const file_types::frame_info & info, const uint8_t * data, uint32_t threshold)
+        {
+            if(data == nullptr || info.stride <= 0 || info.height <= 0)
+            {
+                return true;
+            }
+
+            //the row padding isn't compared, formats without whole byte pixels are compared by the stride
+            const uint32_t stride = static_cast<uint32_t>(info.stride);
+            const uint32_t height = static_cast<uint32_t>(info.height);
+            const uint32_t row_bits = info.width > 0 && info.bpp > 0 ? static_cast<uint32_t>(info.width * info.bpp) : 0;
+            const uint32_t row_size = row_bits > 0 && row_bits % 8 == 0 ? std::min(row_bits / 8, stride) : stride;
+            const bool is_same_layout = !m_reference.empty() && m_reference_info.width == info.width && m_reference_info.height == info.height &&
+                                        m_reference_info.stride == info.stride && m_reference_info.format == info.format;
+            if(is_same_layout && !has_changed_tile(data, m_reference.data(), row_size, stride, height, threshold))
+            {
+                return false;
+            }
+
+            m_reference.assign(data, data + static_cast<size_t>(stride) * height);
+            m_reference_info = info;
+            return true;
+        }
+
+        void change_gate::reset()
+        {
+            m_reference.clear();
+            m_reference_info = {};
+        }
+
+        bool change_gate::has_changed_tile(const uint8_t * data, const uint8_t * reference, uint32_t row_size, uint32_t stride,
+                                           uint32_t height, uint32_t threshold)
+        {
+            for(uint32_t tile_row = 0; tile_row < height; tile_row += TILE_ROWS)
+            {
+                const uint32_t tile_height = std::min(TILE_ROWS, height - tile_row);
+                for(uint32_t tile_column = 0; tile_column < row_size; tile_column += TILE_BYTES)
+                {
+                    const uint32_t tile_width = std::min(TILE_BYTES, row_size - tile_column);
+                    const size_t tile_offset = static_cast<size_t>(tile_row) * stride + tile_column;
+                    uint32_t difference = 0;
+                    for(uint32_t row = 0; row < tile_height; row++)
+                    {
+                        difference += row_difference(data + tile_offset + static_cast<size_t>(row) * stride,
+                                                     reference + tile_offset + static_cast<size_t>(row) * stride, tile_width);
+                    }
+                    if(difference > threshold * tile_width * tile_height)
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+    }
+}
@@ -3,11 +3,20 @@
 
 #include <stddef.h>
 #include <assert.h>
+#include <cstdio>
 #include <tuple>
 #include "disk_write.h"
 #include "include/file.h"
+#include "include/stream_file.h"
+#include "include/preallocated_file.h"
+#include "include/crc32c.h"
 #include "rs_sdk_version.h"
 #include "rs/utils/log_utils.h"
+#include "rs/utils/thread_config.h"
+#include "rs/utils/thread_profiler.h"
+#include "rs/utils/numa_topology.h"
+#include "rs/utils/profiler_markers.h"
+#include "rs/utils/memory_accounting.h"
 
 using namespace rs::core;
 
@@ -16,14 +25,69 @@ namespace rs
     namespace record
     {
         static const uint32_t MAX_MEMORY_CONSUMPTION_PER_STREAM = 300e6;
+        static const uint32_t WRITE_BUFFER_SIZE = 16 * 1024 * 1024;
+        static const uint32_t MIN_GATHERED_WRITE_SIZE = 64 * 1024; //larger writes aren't copied to the write buffer
+        static const uint32_t SAMPLES_QUEUE_CAPACITY = 16384;
+        static const uint32_t MAX_PENDING_ENCODES = 8;
+        static const std::chrono::seconds CHECKPOINT_INTERVAL(1);
+        static const uint64_t MIN_PREALLOCATION_EXTENT_SIZE = 64 * 1024 * 1024;
+        static const uint64_t MAX_PRE_TRIGGER_MEMORY = 512 * 1024 * 1024;
+        static const uint64_t SAMPLE_BUNDLE_DURATION = 100000; //microseconds of capture time
+        static const std::chrono::milliseconds SAMPLE_BUNDLE_IDLE_INTERVAL(100);
+        static const uint32_t MAX_SAMPLE_BUNDLE_SIZE = 4 * 1024 * 1024;
+        static const uint32_t MAX_SAMPLE_BUNDLE_ENTRIES = 1024;
+        static const uint32_t MOTION_COLUMNS_BLOCK_SIZE = 8192; //samples of a source in a motion columns block
 
         disk_write::disk_write(void):
             m_is_configured(false),
             m_paused(false),
             m_stop_writing(true),
-            m_min_fps(0)
+            m_is_write_thread_idle(false),
+            m_samples_queue(SAMPLES_QUEUE_CAPACITY),
+            m_min_fps(0),
+            m_unpatched_bytes(0),
+            m_coalesce_writes(false),
+            m_is_streamed(false),
+            m_encoded_buffer_size(0),
+            m_numa_node(rs::utils::numa_topology::UNKNOWN_NODE),
+            m_pending_encodes(0),
+            m_indexed_samples_count(0),
+            m_checkpoint_position(0),
+            m_preallocation_extent_size(0),
+            m_max_segment_size(0),
+            m_max_segment_duration(0),
+            m_segment_index(0),
+            m_is_segment_started(false),
+            m_segment_start_time(0),
+            m_pre_trigger_duration(0),
+            m_post_trigger_duration(0),
+            m_trigger_end_time(0),
+            m_buffered_bytes(0),
+            m_file_written_bytes(0),
+            m_is_checksummed_sample(false),
+            m_sample_checksum(0),
+            m_sample_checksum_size(0),
+            m_preview_scale(0),
+            m_preview_interval(1),
+            m_preview_codec(record::compression_level::high),
+            m_is_sample_bundles(false),
+            m_is_motion_blocks(false),
+            m_is_frame_metadata_mask(false),
+            m_is_bundle_open(false),
+            m_bundle_start_time(0),
+            m_bundle_seek_table_start(0),
+            m_change_threshold(0),
+            m_write_thread_profiler(rs::utils::thread_role::recording)
         {
-
+            for(auto & statistics : m_stream_statistics)
+            {
+                statistics.recorded_frames_count.store(0, std::memory_order_relaxed);
+                statistics.dropped_frames_count.store(0, std::memory_order_relaxed);
+                statistics.raw_bytes.store(0, std::memory_order_relaxed);
+                statistics.written_bytes.store(0, std::memory_order_relaxed);
+                statistics.encode_time.store(0, std::memory_order_relaxed);
+                statistics.repeated_frames_count.store(0, std::memory_order_relaxed);
+            }
         }
 
         disk_write::~disk_write(void)
@@ -31,6 +95,29 @@ namespace rs
             stop();
         }
 
+        void disk_write::query_recording_statistics(rs_stream stream, record::recording_statistics & statistics) const
+        {
+            auto & stream_statistics = m_stream_statistics[stream];
+            statistics.recorded_frames_count = stream_statistics.recorded_frames_count.load(std::memory_order_relaxed);
+            statistics.dropped_frames_count = stream_statistics.dropped_frames_count.load(std::memory_order_relaxed);
+            statistics.raw_bytes = stream_statistics.raw_bytes.load(std::memory_order_relaxed);
+            statistics.written_bytes = stream_statistics.written_bytes.load(std::memory_order_relaxed);
+            statistics.encode_time = stream_statistics.encode_time.load(std::memory_order_relaxed);
+            statistics.repeated_frames_count = stream_statistics.repeated_frames_count.load(std::memory_order_relaxed);
+        }
+
+        void disk_write::query_recorder_statistics(record::recorder_statistics & statistics) const
+        {
+            statistics.queued_samples_count = static_cast<uint32_t>(m_samples_queue.size());
+            statistics.queue_high_watermark = static_cast<uint32_t>(m_samples_queue.high_watermark());
+            statistics.queue_capacity = static_cast<uint32_t>(m_samples_queue.capacity());
+            statistics.dropped_frames_count = 0;
+            for(auto & stream_statistics : m_stream_statistics)
+                statistics.dropped_frames_count += stream_statistics.dropped_frames_count.load(std::memory_order_relaxed);
+            statistics.written_bytes = m_file_written_bytes.load(std::memory_order_relaxed);
+            statistics.write_thread = m_write_thread_profiler.query_statistics();
+        }
+
         uint32_t disk_write::get_min_fps(const std::map<rs_stream, core::file_types::stream_profile>& stream_profiles)
         {
             uint32_t rv = 0xffffffff;
@@ -46,6 +133,224 @@ namespace rs
             return rv;
         }
 
+        uint64_t disk_write::get_preallocation_extent_size(const configuration& config)
+        {
+            if(config.m_preallocated_seconds == 0)
+                return 0;
+            //the compression ratio isn't known ahead, the extents are sized by the raw frames, 4 bytes per pixel at most
+            uint64_t bytes_per_second = 0;
+            for(auto & profile : config.m_stream_profiles)
+            {
+                auto & info = profile.second.info;
+                bytes_per_second += static_cast<uint64_t>(info.width) * info.height * 4 * static_cast<uint32_t>(std::max(info.framerate, 1));
+            }
+            return std::max(MIN_PREALLOCATION_EXTENT_SIZE, bytes_per_second * config.m_preallocated_seconds);
+        }
+
+        std::unique_ptr<core::file> disk_write::open_file(const std::string& file_path, uint64_t preallocation_extent_size)
+        {
+            std::unique_ptr<core::file> file;
+            if(stream_file::is_stream_location(file_path))
+            {
+                file.reset(new stream_file());
+            }
+            else if(preallocation_extent_size > 0)
+            {
+                file.reset(new preallocated_file(preallocation_extent_size));
+                if(file->open(file_path, open_file_option::write) == status_no_error)
+                    return file;
+                LOG_WARN("file preallocation isn't available, the recording file grows with the writes");
+                file.reset(new core::file());
+            }
+            else
+            {
+                file.reset(new core::file());
+            }
+            if(file->open(file_path, open_file_option::write) != status_no_error)
+                throw std::runtime_error("failed to open file for recording, file path - " + file_path);
+            return file;
+        }
+
+        std::string disk_write::get_segment_file_path(const std::string& file_path, uint32_t segment_index)
+        {
+            if(segment_index == 0)
+                return file_path;
+            auto name_start = file_path.find_last_of("/\\");
+            auto extension_start = file_path.rfind('.');
+            if(extension_start == std::string::npos || (name_start != std::string::npos && extension_start < name_start))
+                extension_start = file_path.size();
+            char suffix[16] = {};
+            snprintf(suffix, sizeof(suffix), "_%04u", segment_index);
+            return file_path.substr(0, extension_start) + suffix + file_path.substr(extension_start);
+        }
+
+        bool disk_write::is_segment_full(const std::shared_ptr<file_types::sample> &sample)
+        {
+            if(!m_is_segment_started)
+            {
+                m_is_segment_started = true;
+                m_segment_start_time = sample->info.capture_time;
+                return false;
+            }
+            return (m_max_segment_size > 0 && get_write_position() + m_bundle_buffer.size() >= m_max_segment_size) ||
+                   (m_max_segment_duration > 0 && sample->info.capture_time >= m_segment_start_time + m_max_segment_duration);
+        }
+
+        void disk_write::start_next_segment()
+        {
+            //no frame is encoded while the codecs dictionaries are written and the codecs restart with keyframes
+            while(!m_pending_samples.empty())
+                write_pending_sample();
+            close_sample_bundle();
+
+            std::unique_ptr<core::file> next_file;
+            try
+            {
+                next_file = m_next_segment_file.get();
+            }
+            catch(const std::exception & ex)
+            {
+                LOG_ERROR("failed to open the next recording segment, the recording continues in the current segment - " << ex.what());
+                m_max_segment_size = 0;
+                m_max_segment_duration = 0;
+                return;
+            }
+
+            write_motion_columns_index();
+            write_codec_dictionaries();
+            write_seek_table();
+            flush_write_buffer();
+            close_samples_index();
+            std::unique_ptr<core::file> closed_file = std::move(m_file);
+            m_file = std::move(next_file);
+            m_segment_index++;
+            LOG_INFO("recording segment started, file path - " << get_segment_file_path(m_file_path, m_segment_index).c_str());
+
+            m_number_of_frames.clear();
+            m_stream_frame_index.clear();
+            m_seek_table.clear();
+            m_motion_columns_index.clear();
+            m_encoder->reset_references();
+            //the repeated frames reference frames of their own segment, the first frame of each gated stream is written in full
+            for(auto & gated : m_gated_streams)
+                gated.second.has_written_frame = false;
+            m_is_segment_started = false;
+            uint32_t bytes_written = 0;
+            write_to_file(m_segment_header.data(), static_cast<uint32_t>(m_segment_header.size()), bytes_written);
+            open_samples_index(get_segment_file_path(m_file_path, m_segment_index));
+            m_last_checkpoint_time = rs::utils::timebase::now();
+            open_next_segment_in_background(std::move(closed_file));
+        }
+
+        void disk_write::open_next_segment_in_background(std::unique_ptr<core::file> closed_file)
+        {
+            //the closed segment may release its preallocated extents, and the next segment file is created, away from the write thread
+            m_next_segment_file = std::async(std::launch::async, [](std::unique_ptr<core::file> closed_file, std::string file_path, uint64_t preallocation_extent_size)
+            {
+                if(closed_file)
+                    closed_file->close();
+                return open_file(file_path, preallocation_extent_size);
+            }, std::move(closed_file), get_segment_file_path(m_file_path, m_segment_index + 1), m_preallocation_extent_size);
+        }
+
+        void disk_write::discard_next_segment()
+        {
+            if(!m_next_segment_file.valid())
+                return;
+            try
+            {
+                auto next_file = m_next_segment_file.get();
+                next_file->close();
+                ::remove(get_segment_file_path(m_file_path, m_segment_index + 1).c_str());
+            }
+            catch(const std::exception & ex)
+            {
+                LOG_WARN("failed to open the next recording segment - " << ex.what());
+            }
+        }
+
+        std::string disk_write::get_stripe_file_path(const std::string& file_path, const std::string& directory, uint32_t stripe_index)
+        {
+            auto name_start = file_path.find_last_of("/\\");
+            auto name = name_start == std::string::npos ? file_path : file_path.substr(name_start + 1);
+            auto separator = directory.empty() || directory.find_last_of("/\\") == directory.size() - 1 ? "" : "/";
+            char suffix[16] = {};
+            snprintf(suffix, sizeof(suffix), ".stripe%u", stripe_index);
+            return directory + separator + name + suffix;
+        }
+
+        void disk_write::open_stripes(const configuration& config)
+        {
+            m_stripes.clear();
+            m_stripe_paths.clear();
+            m_stream_stripe.clear();
+            if(config.m_stripe_directories.empty() && !config.m_is_stream_data_files)
+                return;
+            if(m_is_streamed || m_max_segment_size > 0 || m_max_segment_duration > 0)
+            {
+                LOG_WARN("a streamed or a segmented recording isn't striped");
+                return;
+            }
+            //the data files of the streams are stripes of a single stream each, in the stripe directories in turn
+            auto directories = config.m_stripe_directories;
+            if(directories.empty())
+            {
+                auto name_start = config.m_file_path.find_last_of("/\\");
+                directories.push_back(name_start == std::string::npos ? "" : config.m_file_path.substr(0, name_start + 1));
+            }
+            auto stripes_count = config.m_is_stream_data_files ? config.m_stream_profiles.size() : directories.size();
+            for(uint32_t i = 0; i < stripes_count; i++)
+            {
+                auto path = get_stripe_file_path(config.m_file_path, directories[i % directories.size()], i);
+                m_stripes.emplace_back(new stripe_writer(open_file(path, m_preallocation_extent_size), m_numa_node));
+                m_stripe_paths.push_back(path);
+            }
+            uint32_t stream_index = 0;
+            for(auto & profile : config.m_stream_profiles)
+                m_stream_stripe[profile.first] = stream_index++ % static_cast<uint32_t>(m_stripes.size());
+        }
+
+        void disk_write::write_stripes()
+        {
+            if(m_stripe_paths.empty())
+                return;
+            uint32_t size = 0;
+            for(auto & path : m_stripe_paths)
+                size += static_cast<uint32_t>(sizeof(file_types::disk_format::stripe_entry) + path.size() + 1);
+
+            file_types::chunk_info chunk = {};
+            chunk.id = file_types::chunk_id::chunk_stripes;
+            chunk.size = size;
+            uint32_t bytes_written = 0;
+            write_to_file(&chunk, sizeof(chunk), bytes_written);
+            for(uint32_t i = 0; i < m_stripe_paths.size(); i++)
+            {
+                file_types::disk_format::stripe_entry entry = {};
+                entry.stripe = i;
+                entry.path_size = static_cast<uint32_t>(m_stripe_paths[i].size() + 1);
+                write_to_file(&entry, sizeof(entry), bytes_written);
+                write_to_file(m_stripe_paths[i].c_str(), entry.path_size, bytes_written);
+            }
+        }
+
+        bool disk_write::flush_stripes()
+        {
+            bool rv = true;
+            for(auto & stripe : m_stripes)
+                rv = stripe->flush() && rv;
+            return rv;
+        }
+
+        void disk_write::close_stripes()
+        {
+            for(auto & stripe : m_stripes)
+            {
+                stripe->close();
+                if(!stripe->is_good())
+                    LOG_ERROR("failed writing to stripe file");
+            }
+        }
+
         bool disk_write::allow_sample(std::shared_ptr<rs::core::file_types::sample> &sample)
         {
             if(sample->info.type != file_types::sample_type::st_image) return true;
@@ -61,15 +366,20 @@ namespace rs
                     file_types::debug_data dd { frame->finfo.number - m_last_frame_number[stream], frame->finfo.stream };
                     std::shared_ptr<file_types::sample> debug_sample = std::make_shared<file_types::debug_event_sample>(
                                 file_types::debug_event_type::application_frame_drop, frame->info.capture_time, std::make_shared<file_types::debug_data>(dd));
-                    m_samples_queue.push(debug_sample);
+                    push_sample(debug_sample);
                 }
             }
             m_last_frame_number[stream] = frame_number;
             auto size = (double)(frame->finfo.stride * frame->finfo.height);
             auto max_samples = (double)(MAX_MEMORY_CONSUMPTION_PER_STREAM) / (double)size * frame->finfo.framerate / m_min_fps;
-            if(m_samples_count[stream] > max_samples)
+            //the frames which don't fit in the memory budget of the sdk are dropped as the frames beyond the stream memory
+            bool is_within_budget = rs::utils::memory_accounting::is_within_budget(static_cast<uint64_t>(size));
+            if(!is_within_budget)
+                rs::utils::memory_accounting::add_dropped(rs::utils::memory_subsystem::recording, static_cast<uint64_t>(size));
+            if(m_samples_count[stream] > max_samples || !is_within_budget)
             {
                 m_curr_recorder_frame_drop_count[frame->finfo.stream]++;
+                m_stream_statistics[stream].dropped_frames_count.fetch_add(1, std::memory_order_relaxed);
                 return false;
             }
 
@@ -79,7 +389,7 @@ namespace rs
                 std::shared_ptr<file_types::sample> debug_sample = std::make_shared<file_types::debug_event_sample>(
                             file_types::debug_event_type::recorder_frame_drop, frame->info.capture_time, std::make_shared<file_types::debug_data>(dd));
                 m_curr_recorder_frame_drop_count[stream] = 0;
-                m_samples_queue.push(debug_sample);
+                push_sample(debug_sample);
             }
             m_samples_count[stream]++;
             return true;
@@ -95,22 +405,65 @@ namespace rs
             bool insert_samples = false;
             {
                 std::lock_guard<std::mutex> guard(m_main_mutex);
-                insert_samples = allow_sample(sample);
-                if (insert_samples)//it is ok that sample queue size may exceed MAX_CACHED_SAMPLES by few samples
+                insert_samples = allow_sample(sample) && push_sample(sample);
+                if (!insert_samples)
                 {
-                    m_samples_queue.push(sample);
+                    LOG_WARN_RATE_LIMITED("sample drop, sample type - " << sample->info.type << " ,capture time - " << sample->info.capture_time);
                 }
-                else
+                else if(sample->info.type == file_types::sample_type::st_image)
                 {
-                    LOG_WARN("sample drop, sample type - " << sample->info.type << " ,capture time - " << sample->info.capture_time);
+                    rs::utils::memory_accounting::add(rs::utils::memory_subsystem::recording, frame_data_size(*sample));
                 }
             }
 
             if(insert_samples)
+                notify_write_thread();
+        }
+
+        void disk_write::record_dropped_frame(rs_stream stream, uint64_t frame_number)
+        {
+            if (m_paused)
             {
-                std::lock_guard<std::mutex> guard(m_notify_write_thread_mutex);
-                m_notify_write_thread_cv.notify_one();
+                return;
             }
+            std::lock_guard<std::mutex> guard(m_main_mutex);
+            //the dropped frame isn't an application frame drop
+            m_last_frame_number[stream] = frame_number;
+            m_curr_recorder_frame_drop_count[stream]++;
+            m_stream_statistics[stream].dropped_frames_count.fetch_add(1, std::memory_order_relaxed);
+            LOG_WARN_RATE_LIMITED("frame drop, no free frame slot, stream - " << stream << " ,frame number - " << frame_number);
+        }
+
+        status disk_write::trigger(uint64_t capture_time)
+        {
+            std::lock_guard<std::mutex> guard(m_main_mutex);
+            if(m_pre_trigger_duration == 0)
+                return status_invalid_state;
+            //a trigger during the post trigger duration of a previous trigger extends it
+            auto trigger_end_time = capture_time + m_post_trigger_duration;
+            if(trigger_end_time > m_trigger_end_time.load(std::memory_order_relaxed))
+                m_trigger_end_time.store(trigger_end_time, std::memory_order_relaxed);
+            LOG_INFO("recording triggered, capture time - " << capture_time)
+            return status_no_error;
+        }
+
+        //must be called while m_main_mutex is locked, the queue supports a single producer
+        bool disk_write::push_sample(const std::shared_ptr<file_types::sample> &sample)
+        {
+            if(m_samples_queue.push(sample))
+                return true;
+            LOG_WARN_RATE_LIMITED("samples queue is full, queue capacity - " << m_samples_queue.capacity());
+            return false;
+        }
+
+        void disk_write::notify_write_thread()
+        {
+            //pairs with the fence in write_thread, either the write thread sees the new sample or we see it is idle
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(!m_is_write_thread_idle.load(std::memory_order_relaxed))
+                return;
+            std::lock_guard<std::mutex> guard(m_notify_write_thread_mutex);
+            m_notify_write_thread_cv.notify_one();
         }
 
         bool disk_write::start()
@@ -127,20 +480,34 @@ namespace rs
         {
             LOG_FUNC_SCOPE();
 
-            std::unique_lock<std::mutex> guard(m_main_mutex);
-            m_stop_writing = true;
-            guard.unlock();
-
-            m_notify_write_thread_cv.notify_one();
+            {
+                std::lock_guard<std::mutex> guard(m_notify_write_thread_mutex);
+                m_stop_writing = true;
+                m_notify_write_thread_cv.notify_one();
+            }
 
             if (m_thread.joinable())
             {
                 m_thread.join();
+                LOG_INFO("samples queue high watermark - " << m_samples_queue.high_watermark() << " ,capacity - " << m_samples_queue.capacity());
             }
 
-            guard.lock();
+            std::unique_lock<std::mutex> guard(m_main_mutex);
+            //the samples the write thread didn't get to are released, with their accounted memory
+            std::shared_ptr<core::file_types::sample> sample = nullptr;
+            while(m_samples_queue.pop(sample))
+            {
+                if(sample && sample->info.type == file_types::sample_type::st_image)
+                {
+                    rs::utils::memory_accounting::remove(rs::utils::memory_subsystem::recording, frame_data_size(*sample));
+                    m_samples_count[std::static_pointer_cast<file_types::frame_sample>(sample)->finfo.stream]--;
+                }
+            }
+            close_samples_index();
+            close_stripes();
             if(m_file)
                 m_file->close();
+            discard_next_segment();
             guard.unlock();
         }
 
@@ -152,37 +519,83 @@ namespace rs
             auto debug_event_type = pause ? file_types::debug_event_type::pause_record : file_types::debug_event_type::resume_record;
 
             std::shared_ptr<file_types::sample> sample = std::make_shared<file_types::debug_event_sample>(debug_event_type, capture_time);
-            m_samples_queue.push(sample);
+            push_sample(sample);
         }
 
         status disk_write::configure(const configuration& config)
         {
             std::lock_guard<std::mutex> guard(m_main_mutex);
             if(m_is_configured) return status::status_exec_aborted;
-            m_file = std::unique_ptr<rs::core::file>(new rs::core::file());
-            status sts = m_file->open(config.m_file_path, (open_file_option)(open_file_option::write));
-
-            if (sts != status::status_no_error)
-                throw std::runtime_error("failed to open file for recording, file path - " + config.m_file_path);
+            m_is_streamed = stream_file::is_stream_location(config.m_file_path);
+            m_file_path = config.m_file_path;
+            m_preallocation_extent_size = m_is_streamed ? 0 : get_preallocation_extent_size(config);
+            m_file = open_file(config.m_file_path, m_preallocation_extent_size);
+            m_segment_index = 0;
+            m_is_segment_started = false;
+            m_max_segment_size = m_is_streamed ? 0 : config.m_max_segment_size;
+            m_max_segment_duration = m_is_streamed ? 0 : config.m_max_segment_seconds * 1000000ull;
+            if(m_is_streamed && (config.m_max_segment_size > 0 || config.m_max_segment_seconds > 0))
+                LOG_WARN("a streamed recording isn't segmented");
+            const bool is_segmented = m_max_segment_size > 0 || m_max_segment_duration > 0;
+            m_numa_node = config.m_numa_node;
+            open_stripes(config);
+            m_pre_trigger_duration = config.m_pre_trigger_seconds * 1000000ull;
+            m_post_trigger_duration = config.m_post_trigger_seconds * 1000000ull;
+            m_trigger_end_time = 0;
+            m_preview_scale = config.m_preview_scale;
+            m_preview_interval = std::max(1u, config.m_preview_interval);
+            m_change_threshold = config.m_change_threshold;
+            m_is_sample_bundles = (config.m_format_extensions & record::format_extension::extension_sample_bundles) != 0;
+            m_is_motion_blocks = (config.m_format_extensions & record::format_extension::extension_motion_blocks) != 0;
+            m_is_frame_metadata_mask = (config.m_format_extensions & record::format_extension::extension_frame_metadata) != 0;
+            m_gated_streams.clear();
 
             init_encoder(config);
             m_min_fps = get_min_fps(config.m_stream_profiles);
+            //a stream can't seek back to the header, the header chunks are staged until the first frame offset is known,
+            //the staged header chunks of a segmented recording are written as is to each segment
+            if(m_is_streamed || is_segmented)
+            {
+                if(m_write_buffer.capacity() < WRITE_BUFFER_SIZE)
+                    m_write_buffer.reserve(WRITE_BUFFER_SIZE);
+                m_coalesce_writes = true;
+            }
             write_header(static_cast<uint8_t>(config.m_stream_profiles.size()), config.m_coordinate_system, config.m_capture_mode);
             write_camera_info(config.m_camera_info);
             write_sw_info();
             write_capabilities(config.m_capabilities);
             write_motion_intrinsics(config.m_motion_intrinsics);
             write_stream_info(config.m_stream_profiles);
+            write_stripes();
             write_properties(config.m_options);
             write_first_frame_offset();
+            if(is_segmented)
+            {
+                m_segment_header = m_write_buffer;
+                open_next_segment_in_background(nullptr);
+            }
+            if(m_is_streamed || is_segmented)
+            {
+                flush_write_buffer();
+                m_coalesce_writes = false;
+            }
+            if(!m_is_streamed)
+            {
+                open_samples_index(config.m_file_path);
+            }
             m_is_configured = true;
-            return sts;
+            return status_no_error;
         }
 
         void disk_write::init_encoder(const configuration& config)
         {
             uint32_t buffer_size = 0;
             m_encoder.reset(new compression::encoder());
+            const int32_t numa_node = config.m_numa_node;
+            m_encoder->set_worker_start_handler([numa_node]()
+            {
+                rs::utils::numa_topology::bind_thread(numa_node, rs::utils::thread_role::recording);
+            });
             for(auto profile : config.m_stream_profiles)
             {
                 rs_stream stream = profile.second.info.stream;
@@ -193,52 +606,173 @@ namespace rs
                 {
                     auto compression_level = config.m_compression_config.at(profile.first);
                     if(compression_level != record::compression_level::disabled)
-                        m_encoder->add_codec(stream, format, compression_level);
+                        m_encoder->add_codec(stream, format, compression_level, config.m_compression_codecs);
                 }
                 else
                 {
-                    m_encoder->add_codec(stream, format, record::compression_level::high);
+                    m_encoder->add_codec(stream, format, record::compression_level::high, config.m_compression_codecs);
                 }
             }
-            m_encoded_data = std::vector<uint8_t>(buffer_size * 4);//stride is not available, taking worst case.
+            m_encoded_buffer_size = buffer_size * 4;//stride is not available, taking worst case.
+            m_encoded_buffers.clear();
         }
 
         void disk_write::write_to_file(const void* data, unsigned int number_of_bytes_to_write, unsigned int& number_of_bytes_written)
         {
-            auto sts = m_file->write_bytes(data, number_of_bytes_to_write, number_of_bytes_written);
+            file_buffer buffer = { data, number_of_bytes_to_write };
+            write_to_file(&buffer, 1);
+            number_of_bytes_written = number_of_bytes_to_write;
+        }
+
+        void disk_write::write_to_file(const file_buffer* buffers, unsigned int count)
+        {
+            uint64_t size = 0;
+            for(unsigned int i = 0; i < count; i++)
+                size += buffers[i].size;
+            if(m_is_checksummed_sample)
+            {
+                for(unsigned int i = 0; i < count; i++)
+                    m_sample_checksum = crc32c::update(m_sample_checksum, buffers[i].data, buffers[i].size);
+                m_sample_checksum_size += static_cast<uint32_t>(size);
+            }
+            //the staged bytes are accounted when the bundle is written
+            if(m_is_bundle_open)
+            {
+                for(unsigned int i = 0; i < count; i++)
+                {
+                    auto bytes = static_cast<const uint8_t*>(buffers[i].data);
+                    m_bundle_buffer.insert(m_bundle_buffer.end(), bytes, bytes + buffers[i].size);
+                }
+                return;
+            }
+            m_file_written_bytes.fetch_add(size, std::memory_order_relaxed);
+            if(m_coalesce_writes)
+            {
+                //small chunks are staged, a frame payload is written from its own buffer after the staged chunks
+                if(size < MIN_GATHERED_WRITE_SIZE && m_write_buffer.size() + size <= m_write_buffer.capacity())
+                {
+                    for(unsigned int i = 0; i < count; i++)
+                    {
+                        auto bytes = static_cast<const uint8_t*>(buffers[i].data);
+                        m_write_buffer.insert(m_write_buffer.end(), bytes, bytes + buffers[i].size);
+                    }
+                    return;
+                }
+                flush_write_buffer(buffers, count);
+                return;
+            }
+            rs::utils::thread_profiler::wait_scope io_wait(m_write_thread_profiler, rs::utils::thread_wait::io);
+            uint32_t bytes_written = 0;
+            auto sts = m_file->write_buffers(buffers, count, bytes_written);
+            if(sts != status::status_no_error)
+            {
+                m_file->close();
+                LOG_ERROR("failed writing to file");
+                throw std::runtime_error("failed writing to file");
+            }
+        }
+
+        void disk_write::flush_write_buffer(const file_buffer* buffers, unsigned int count)
+        {
+            if(m_write_buffer.empty() && count == 0)
+                return;
+            m_gathered_buffers.clear();
+            if(!m_write_buffer.empty())
+                m_gathered_buffers.push_back({ m_write_buffer.data(), static_cast<unsigned int>(m_write_buffer.size()) });
+            m_gathered_buffers.insert(m_gathered_buffers.end(), buffers, buffers + count);
+
+            rs::utils::thread_profiler::wait_scope io_wait(m_write_thread_profiler, rs::utils::thread_wait::io);
+            uint32_t bytes_written = 0;
+            auto sts = m_file->write_buffers(m_gathered_buffers.data(), static_cast<unsigned int>(m_gathered_buffers.size()), bytes_written);
             if(sts != status::status_no_error)
             {
                 m_file->close();
                 LOG_ERROR("failed writing to file");
                 throw std::runtime_error("failed writing to file");
             }
+            LOG_VERBOSE("flushed " << bytes_written << " bytes to file")
+            m_write_buffer.clear();
+
+            //the frames count is updated once per flush of a full buffer, the gathered writes of the frames are patched as often
+            m_unpatched_bytes += bytes_written;
+            if(count > 0 && m_unpatched_bytes < WRITE_BUFFER_SIZE)
+                return;
+            m_unpatched_bytes = 0;
+            for(auto & frames_count : m_number_of_frames)
+                write_stream_num_of_frames(frames_count.first, frames_count.second);
+        }
+
+        uint64_t disk_write::get_write_position()
+        {
+            uint64_t pos = 0;
+            m_file->get_position(&pos);
+            return m_coalesce_writes ? pos + m_write_buffer.size() : pos;
         }
 
         void disk_write::write_thread(void)
         {
             LOG_FUNC_SCOPE();
+            rs::utils::thread_configuration::apply(rs::utils::thread_role::recording, "rs-record");
+            //the write buffers and the encoder output buffers are allocated by the write thread, on its node
+            rs::utils::numa_topology::bind_thread(m_numa_node, rs::utils::thread_role::recording);
+            m_write_thread_profiler.start();
+            if(m_write_buffer.capacity() < WRITE_BUFFER_SIZE)
+                m_write_buffer.reserve(WRITE_BUFFER_SIZE);
+            if(m_bundle_buffer.capacity() < MAX_SAMPLE_BUNDLE_SIZE)
+                m_bundle_buffer.reserve(MAX_SAMPLE_BUNDLE_SIZE);
+            m_coalesce_writes = true;
+            m_stream_frame_index.clear();
+            m_gated_streams.clear();
+            m_seek_table.clear();
+            m_motion_columns.clear();
+            m_motion_columns_index.clear();
+            m_last_checkpoint_time = rs::utils::timebase::now();
             while (!m_stop_writing)
             {
-                std::unique_lock<std::mutex> guard(m_notify_write_thread_mutex);
-                m_notify_write_thread_cv.wait(guard);
-                guard.unlock();
-
                 LOG_VERBOSE("queue contains " << m_samples_queue.size() << " samples")
 
                 std::shared_ptr<core::file_types::sample> sample = nullptr;
-                while(!m_samples_queue.empty())
+                while(!m_stop_writing && m_samples_queue.pop(sample))
                 {
-                    {
-                        std::lock_guard<std::mutex> guard(m_main_mutex);
-                        if(m_samples_queue.empty() || m_stop_writing == true) break;
-                        sample = m_samples_queue.front();
-                        m_samples_queue.pop();
-                        if(!sample) continue;
-                    }
-                    write_sample_info(sample);
-                    write_sample(sample);
+                    if(!sample) continue;
+                    //the held samples don't start a segment
+                    if((m_max_segment_size > 0 || m_max_segment_duration > 0) && !is_pre_trigger_sample(sample) && is_segment_full(sample))
+                        start_next_segment();
+                    //the codecs trade compression ratio for speed while the queue fills up, instead of dropping samples
+                    m_encoder->set_backlog(static_cast<uint32_t>(m_samples_queue.size() * 100 / m_samples_queue.capacity()));
+                    encode_sample(sample);
+                    //samples are written in capture order, as soon as their encoding is done
+                    while(!m_pending_samples.empty() && (m_pending_encodes >= MAX_PENDING_ENCODES || is_pending_sample_ready(m_pending_samples.front())))
+                        write_pending_sample();
+                    if(rs::utils::timebase::now() - m_last_checkpoint_time >= CHECKPOINT_INTERVAL)
+                        write_checkpoint();
                 }
+                sample.reset();
+                while(!m_pending_samples.empty())
+                    write_pending_sample();
+                //a bundle is kept open while the samples keep coming, so a queue which drains often doesn't write single sample bundles
+                if(m_is_bundle_open && rs::utils::timebase::now() - m_bundle_open_time >= SAMPLE_BUNDLE_IDLE_INTERVAL)
+                    close_sample_bundle();
+                //the queue is drained, no reason to hold the staged data
+                flush_write_buffer();
+                for(auto & stripe : m_stripes)
+                    stripe->submit();
+                if(rs::utils::timebase::now() - m_last_checkpoint_time >= CHECKPOINT_INTERVAL)
+                    write_checkpoint();
+
+                std::unique_lock<std::mutex> guard(m_notify_write_thread_mutex);
+                m_is_write_thread_idle.store(true, std::memory_order_relaxed);
+                //pairs with the fence in notify_write_thread
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                auto is_notified = [this]() { return m_stop_writing || !m_samples_queue.empty(); };
+                rs::utils::thread_profiler::wait_scope input_wait(m_write_thread_profiler, rs::utils::thread_wait::input);
+                if(m_is_bundle_open)
+                    m_notify_write_thread_cv.wait_for(guard, SAMPLE_BUNDLE_IDLE_INTERVAL, is_notified);
+                else
+                    m_notify_write_thread_cv.wait(guard, is_notified);
+                m_is_write_thread_idle.store(false, std::memory_order_relaxed);
             }
+            close_sample_bundle();
             for(auto & pair : m_curr_recorder_frame_drop_count)
             {
                 if(pair.second == 0)
@@ -248,14 +782,436 @@ namespace rs
                             file_types::debug_event_type::recorder_frame_drop, 0, std::make_shared<file_types::debug_data>(dd));
                 write_sample_info(sample);
                 write_sample(sample);
+                write_sample_checksum();
+                write_samples_index_entry(sample);
             }
             m_curr_recorder_frame_drop_count.clear();
+            if(m_is_streamed)
+                write_stream_trailer();
+            write_motion_columns_index();
+            write_codec_dictionaries();
+            write_seek_table();
+            flush_write_buffer();
+            m_coalesce_writes = false;
+            m_write_thread_profiler.stop();
+        }
+
+        void disk_write::encode_sample(std::shared_ptr<file_types::sample> &sample)
+        {
+            //deque keeps the element address, the encoder writes directly to the pending sample
+            m_pending_samples.emplace_back();
+            auto & pending = m_pending_samples.back();
+            pending.sample = sample;
+            pending.encoded_size = 0;
+            pending.is_unchanged = false;
+            if(sample->info.type != file_types::sample_type::st_image)
+                return;
+            auto frame = std::static_pointer_cast<file_types::frame_sample>(sample);
+            //an unchanged frame isn't encoded, it's written as a repeat of the last written frame of its stream
+            if(is_gated_stream(frame->finfo.stream))
+            {
+                RS_PROFILER_ZONE("disk_write::change_gate");
+                pending.is_unchanged = !m_gated_streams[frame->finfo.stream].gate.is_changed(frame->finfo, frame->data, m_change_threshold);
+                if(pending.is_unchanged)
+                    return;
+            }
+            if(m_encoder->get_compression_type(frame->finfo.stream) == file_types::compression_type::none)
+                return;
+            if(m_encoded_buffers.empty())
+            {
+                pending.encoded_data = std::vector<uint8_t>(m_encoded_buffer_size);
+            }
+            else
+            {
+                pending.encoded_data = std::move(m_encoded_buffers.back());
+                m_encoded_buffers.pop_back();
+            }
+            pending.encode_status = m_encoder->encode_frame_async(frame->finfo, frame->data, pending.encoded_data.data(), pending.encoded_size);
+            m_pending_encodes++;
+        }
+
+        bool disk_write::is_pending_sample_ready(pending_sample &pending)
+        {
+            return !pending.encode_status.valid() || pending.encode_status.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        void disk_write::write_pending_sample()
+        {
+            auto & pending = m_pending_samples.front();
+            const uint8_t * encoded_data = nullptr;
+            if(pending.encode_status.valid())
+            {
+                m_pending_encodes--;
+                if(!is_pending_sample_ready(pending))
+                {
+                    rs::utils::thread_profiler::wait_scope tasks_wait(m_write_thread_profiler, rs::utils::thread_wait::tasks);
+                    pending.encode_status.wait();
+                }
+                if(pending.encode_status.get() == status::status_no_error)
+                    encoded_data = pending.encoded_data.data();
+                auto stream = std::static_pointer_cast<file_types::frame_sample>(pending.sample)->finfo.stream;
+                m_stream_statistics[stream].encode_time.store(m_encoder->query_encode_time(stream), std::memory_order_relaxed);
+            }
+            if(is_pre_trigger_sample(pending.sample))
+            {
+                buffer_sample(pending.sample, encoded_data, pending.encoded_size);
+            }
+            else
+            {
+                write_buffered_samples();
+                write_ready_sample(pending.sample, encoded_data, pending.encoded_size, pending.is_unchanged);
+            }
+            //the camera frame is released, either written or copied to the held samples
+            if(pending.sample->info.type == file_types::sample_type::st_image)
+            {
+                auto stream = std::static_pointer_cast<file_types::frame_sample>(pending.sample)->finfo.stream;
+                rs::utils::memory_accounting::remove(rs::utils::memory_subsystem::recording, frame_data_size(*pending.sample));
+                //the camera threads hold the lock as they queue their frames
+                m_write_thread_profiler.lock(m_main_mutex);
+                std::lock_guard<std::mutex> guard(m_main_mutex, std::adopt_lock);
+                m_samples_count[stream]--;
+            }
+            m_write_thread_profiler.add_processed_items();
+            if(!pending.encoded_data.empty())
+                m_encoded_buffers.push_back(std::move(pending.encoded_data));
+            m_pending_samples.pop_front();
+        }
+
+        uint64_t disk_write::frame_data_size(const file_types::sample & sample)
+        {
+            auto & frame = static_cast<const file_types::frame_sample &>(sample);
+            return static_cast<uint64_t>(frame.finfo.stride) * frame.finfo.height;
+        }
+
+        void disk_write::write_ready_sample(std::shared_ptr<file_types::sample> &sample, const uint8_t * encoded_data, uint32_t encoded_size,
+                                            bool is_unchanged)
+        {
+            RS_PROFILER_COUNTER("disk_write pending samples", m_pending_samples.size());
+            if(sample->info.type == file_types::sample_type::st_image)
+            {
+                auto stream = std::static_pointer_cast<file_types::frame_sample>(sample)->finfo.stream;
+                //a frame which failed encoding is written uncompressed and doesn't depend on other frames
+                if(m_broken_streams.count(stream) > 0)
+                {
+                    if(encoded_data != nullptr && !m_encoder->is_keyframe(stream, encoded_data, encoded_size))
+                        return;
+                    m_broken_streams.erase(stream);
+                }
+            }
+            //without the motion blocks extension a block is written as its motion and time stamp samples, which all the readers read
+            if(sample->info.type == file_types::sample_type::st_motion_block && !m_is_motion_blocks)
+            {
+                auto block = std::static_pointer_cast<file_types::motion_block_sample>(sample);
+                for(uint32_t i = 0; i < block->count; i++)
+                {
+                    auto & entry = block->entries[i];
+                    std::shared_ptr<file_types::sample> entry_sample;
+                    if(entry.type == file_types::sample_type::st_motion)
+                        entry_sample = std::make_shared<file_types::motion_sample>(entry.data.motion, entry.capture_time);
+                    else
+                        entry_sample = std::make_shared<file_types::time_stamp_sample>(entry.data.time_stamp, entry.capture_time);
+                    write_ready_sample(entry_sample, nullptr, 0);
+                }
+                return;
+            }
+            if(m_is_bundle_open && is_sample_bundle_full(sample))
+                close_sample_bundle();
+            if(m_is_sample_bundles && !m_is_bundle_open)
+                open_sample_bundle(sample->info.capture_time);
+            write_sample_info(sample);
+            write_sample(sample, encoded_data, encoded_size, is_unchanged);
+            write_sample_checksum();
+            write_samples_index_entry(sample);
+            add_motion_columns(sample);
+            if(sample->info.type == file_types::sample_type::st_image)
+            {
+                auto frame = std::static_pointer_cast<file_types::frame_sample>(sample);
+                auto stream = frame->finfo.stream;
+                auto frame_index = m_stream_frame_index[stream]++;
+                if(m_preview_scale > 0 && frame_index % m_preview_interval == 0)
+                    write_preview_frame(frame, frame_index);
+                if(m_encoder->is_temporal(stream) && (encoded_data == nullptr || m_encoder->is_keyframe(stream, encoded_data, encoded_size)))
+                {
+                    file_types::disk_format::seek_table_entry entry = {};
+                    entry.stream = stream;
+                    entry.frame_index = frame_index;
+                    entry.offset = frame->info.offset;
+                    m_seek_table.push_back(entry);
+                }
+            }
+        }
+
+        bool disk_write::is_gated_stream(rs_stream stream)
+        {
+            return m_change_threshold > 0 && m_pre_trigger_duration == 0 && !m_encoder->is_temporal(stream);
+        }
+
+        bool disk_write::is_pre_trigger_sample(const std::shared_ptr<file_types::sample> &sample)
+        {
+            return m_pre_trigger_duration > 0 && sample->info.capture_time >= m_trigger_end_time.load(std::memory_order_relaxed);
+        }
+
+        void disk_write::buffer_sample(const std::shared_ptr<file_types::sample> &sample, const uint8_t * encoded_data, uint32_t encoded_size)
+        {
+            buffered_sample buffered;
+            buffered.sample = sample;
+            buffered.is_encoded = encoded_data != nullptr;
+            if(sample->info.type == file_types::sample_type::st_image)
+            {
+                auto frame = std::static_pointer_cast<file_types::frame_sample>(sample);
+                auto frame_copy = std::make_shared<file_types::frame_sample>(frame.get());
+                auto data = buffered.is_encoded ? encoded_data : frame->data;
+                auto data_size = buffered.is_encoded ? encoded_size : static_cast<uint32_t>(frame->finfo.stride * frame->finfo.height);
+                if(data != nullptr)
+                    buffered.data.assign(data, data + data_size);
+                //the vector buffer keeps its address when the held sample is moved
+                frame_copy->data = buffered.is_encoded || data == nullptr ? nullptr : buffered.data.data();
+                buffered.sample = frame_copy;
+            }
+            m_buffered_bytes += buffered.data.size();
+            m_buffered_samples.push_back(std::move(buffered));
+
+            //the samples older than the pre trigger duration are dropped, the oldest samples are dropped once the memory limit is reached
+            auto capture_time = sample->info.capture_time;
+            while(!m_buffered_samples.empty() && (m_buffered_samples.front().sample->info.capture_time + m_pre_trigger_duration < capture_time ||
+                                                  m_buffered_bytes > MAX_PRE_TRIGGER_MEMORY))
+            {
+                auto & oldest = m_buffered_samples.front();
+                if(oldest.sample->info.type == file_types::sample_type::st_image)
+                {
+                    auto stream = std::static_pointer_cast<file_types::frame_sample>(oldest.sample)->finfo.stream;
+                    if(m_encoder->is_temporal(stream))
+                        m_broken_streams.insert(stream);
+                }
+                m_buffered_bytes -= oldest.data.size();
+                m_buffered_samples.pop_front();
+            }
+        }
+
+        void disk_write::write_buffered_samples()
+        {
+            for(auto & buffered : m_buffered_samples)
+            {
+                auto encoded_data = buffered.is_encoded ? buffered.data.data() : nullptr;
+                write_ready_sample(buffered.sample, encoded_data, static_cast<uint32_t>(buffered.data.size()));
+            }
+            m_buffered_samples.clear();
+            m_buffered_bytes = 0;
+        }
+
+        void disk_write::write_codec_dictionaries()
+        {
+            auto dictionaries = m_encoder->get_dictionaries();
+            if(dictionaries.empty())
+                return;
+            file_types::disk_format::codec_dictionaries_footer footer = {};
+            footer.chunk_offset = get_write_position();
+            footer.id = UID('R', 'S', 'C', 'D');
+
+            file_types::chunk_info chunk = {};
+            chunk.id = file_types::chunk_id::chunk_codec_dictionaries;
+            size_t chunk_size = sizeof(footer);
+            for(auto & dictionary : dictionaries)
+                chunk_size += sizeof(file_types::disk_format::codec_dictionary_entry) + dictionary.second.size();
+            chunk.size = static_cast<uint32_t>(chunk_size);
+
+            uint32_t bytes_written = 0;
+            write_to_file(&chunk, sizeof(chunk), bytes_written);
+            for(auto & dictionary : dictionaries)
+            {
+                file_types::disk_format::codec_dictionary_entry entry = {};
+                entry.stream = dictionary.first;
+                entry.size = static_cast<uint32_t>(dictionary.second.size());
+                write_to_file(&entry, sizeof(entry), bytes_written);
+                write_to_file(dictionary.second.data(), entry.size, bytes_written);
+            }
+            write_to_file(&footer, sizeof(footer), bytes_written);
+            LOG_INFO("write codec dictionaries chunk, chunk size - " << chunk.size)
+        }
+
+        void disk_write::write_seek_table()
+        {
+            if(m_seek_table.empty())
+                return;
+            file_types::disk_format::seek_table_footer footer = {};
+            footer.chunk_offset = get_write_position();
+            footer.id = UID('R', 'S', 'S', 'T');
+
+            file_types::chunk_info chunk = {};
+            chunk.id = file_types::chunk_id::chunk_seek_table;
+            chunk.size = static_cast<uint32_t>(m_seek_table.size() * sizeof(file_types::disk_format::seek_table_entry) + sizeof(footer));
+
+            uint32_t bytes_written = 0;
+            write_to_file(&chunk, sizeof(chunk), bytes_written);
+            write_to_file(m_seek_table.data(), static_cast<uint32_t>(m_seek_table.size() * sizeof(file_types::disk_format::seek_table_entry)), bytes_written);
+            write_to_file(&footer, sizeof(footer), bytes_written);
+            LOG_INFO("write seek table chunk, chunk size - " << chunk.size)
+        }
+
+        void disk_write::write_stream_trailer()
+        {
+            std::vector<file_types::disk_format::stream_trailer_entry> entries;
+            for(auto & frames_count : m_number_of_frames)
+            {
+                file_types::disk_format::stream_trailer_entry entry = {};
+                entry.stream = frames_count.first;
+                entry.nframes = frames_count.second;
+                entries.push_back(entry);
+            }
+
+            file_types::chunk_info chunk = {};
+            chunk.id = file_types::chunk_id::chunk_stream_trailer;
+            chunk.size = static_cast<uint32_t>(entries.size() * sizeof(file_types::disk_format::stream_trailer_entry));
+
+            uint32_t bytes_written = 0;
+            write_to_file(&chunk, sizeof(chunk), bytes_written);
+            write_to_file(entries.data(), chunk.size, bytes_written);
+            LOG_INFO("write stream trailer chunk, chunk size - " << chunk.size)
+        }
+
+        void disk_write::open_samples_index(const std::string& file_path)
+        {
+            m_indexed_samples_count = 0;
+            m_checkpoint_position = 0;
+            m_samples_index_file.reset(new rs::core::file());
+            auto index_path = file_types::samples_index_path(file_path);
+            if(m_samples_index_file->open(index_path, open_file_option::write) != status_no_error)
+            {
+                LOG_WARN("failed to create samples index, file path - " << index_path.c_str());
+                m_samples_index_file.reset();
+                return;
+            }
+            write_samples_index_header(false);
+        }
+
+        void disk_write::write_samples_index_header(bool completed)
+        {
+            if(!m_samples_index_file) return;
+            file_types::disk_format::samples_index_header header = {};
+            header.version = 1;
+            header.id = UID('R', 'S', 'I', '0' + header.version);
+            header.completed = completed ? 1 : 0;
+            header.samples_count = m_indexed_samples_count;
+            header.checkpoint_position = m_checkpoint_position;
+            if(completed)
+            {
+                m_file->set_position(0, move_method::end, &header.recording_size);
+            }
+
+            uint32_t bytes_written = 0;
+            m_samples_index_file->set_position(0, move_method::begin);
+            if(m_samples_index_file->write_bytes(&header, sizeof(header), bytes_written) != status_no_error)
+            {
+                LOG_WARN("failed writing samples index header, the index is discarded");
+                m_samples_index_file.reset();
+            }
+        }
+
+        void disk_write::write_checkpoint()
+        {
+            m_last_checkpoint_time = rs::utils::timebase::now();
+            if(!m_samples_index_file) return;
+
+            //the index entries of the staged samples are written when their bundle is written
+            close_sample_bundle();
+            //the samples are on disk before the index entries, and the entries before the header which counts them
+            flush_write_buffer();
+            if(!flush_stripes() || m_file->flush() != status_no_error || m_samples_index_file->flush() != status_no_error)
+            {
+                LOG_WARN("failed flushing the recording, checkpoint is skipped");
+                return;
+            }
+            //the checkpoint is taken between samples, the write position is the end of the last indexed sample
+            m_checkpoint_position = get_write_position();
+            write_samples_index_header(false);
+            if(!m_samples_index_file) return;
+            m_samples_index_file->set_position(0, move_method::end);
+            m_samples_index_file->flush();
+            LOG_VERBOSE("checkpoint, number of samples - " << m_indexed_samples_count << " ,recording size - " << m_checkpoint_position)
+        }
+
+        void disk_write::write_samples_index_entry(const std::shared_ptr<file_types::sample> &sample)
+        {
+            if(!m_samples_index_file && !m_is_bundle_open) return;
+            file_types::disk_format::sample_index_entry entry = {};
+            entry.info = sample->info;
+            switch(sample->info.type)
+            {
+                case file_types::sample_type::st_image:
+                    entry.data.frame = std::static_pointer_cast<file_types::frame_sample>(sample)->finfo;
+                    break;
+                case file_types::sample_type::st_motion:
+                    entry.data.motion = std::static_pointer_cast<file_types::motion_sample>(sample)->data;
+                    break;
+                case file_types::sample_type::st_time:
+                    entry.data.time_stamp = std::static_pointer_cast<file_types::time_stamp_sample>(sample)->data;
+                    break;
+                case file_types::sample_type::st_debug_event:
+                {
+                    auto debug_sample = std::static_pointer_cast<file_types::debug_event_sample>(sample);
+                    entry.data.debug_event.type = debug_sample->event_type;
+                    if(debug_sample->debug_data)
+                        entry.data.debug_event.data = *debug_sample->debug_data;
+                }
+                break;
+                case file_types::sample_type::st_motion_block:
+                {
+                    //the index holds the block samples, they share the offset of the block
+                    auto block = std::static_pointer_cast<file_types::motion_block_sample>(sample);
+                    for(uint32_t i = 0; i < block->count; i++)
+                    {
+                        file_types::disk_format::sample_index_entry block_entry = {};
+                        block_entry.info = sample->info;
+                        block_entry.info.type = block->entries[i].type;
+                        block_entry.info.capture_time = block->entries[i].capture_time;
+                        if(block->entries[i].type == file_types::sample_type::st_motion)
+                            block_entry.data.motion = block->entries[i].data.motion;
+                        else
+                            block_entry.data.time_stamp = block->entries[i].data.time_stamp;
+                        write_samples_index_entry(block_entry);
+                    }
+                    return;
+                }
+            }
+            write_samples_index_entry(entry);
+        }
+
+        void disk_write::write_samples_index_entry(const file_types::disk_format::sample_index_entry &entry)
+        {
+            //the entries of a bundle are written to the index file when the bundle is closed
+            if(m_is_bundle_open)
+            {
+                m_bundle_entries.push_back(entry);
+                return;
+            }
+            if(!m_samples_index_file) return;
+
+            uint32_t bytes_written = 0;
+            //an incomplete index is ignored by the playback, no need to remove the file
+            if(m_samples_index_file->write_bytes(&entry, sizeof(entry), bytes_written) != status_no_error)
+            {
+                LOG_WARN("failed writing samples index entry, the index is discarded");
+                m_samples_index_file.reset();
+                return;
+            }
+            m_indexed_samples_count++;
+        }
+
+        void disk_write::close_samples_index()
+        {
+            if(!m_samples_index_file || !m_file) return;
+            write_samples_index_header(true);
+            if(m_samples_index_file)
+                m_samples_index_file->close();
+            m_samples_index_file.reset();
+            LOG_INFO("samples index closed, number of samples - " << m_indexed_samples_count)
         }
 
         void disk_write::write_header(uint8_t stream_count, file_types::coordinate_system cs, playback::capture_mode capture_mode)
         {
             file_types::disk_format::file_header header = {};
-            header.data.version = 2;
+            //the default recording is read by the version 2 readers
+            header.data.version = m_is_sample_bundles ? 3 : 2;
             header.data.id = UID('R', 'S', 'L', '0' + header.data.version);
             header.data.coordinate_system = cs;
             header.data.capture_mode = capture_mode;
@@ -264,7 +1220,8 @@ namespace rs
             header.data.nstreams = stream_count;
 
             uint32_t bytes_written = 0;
-            m_file->set_position(0, move_method::begin);
+            if(!m_is_streamed)
+                m_file->set_position(0, move_method::begin);
             write_to_file(&header, sizeof(header), bytes_written);
             LOG_INFO("write header chunk, chunk size - " << sizeof(header))
         }
@@ -357,8 +1314,7 @@ namespace rs
                 sinfo.ctype = m_encoder->get_compression_type(stream);
                 sinfo.profile = iter->second;
                 /* Save the stream nframes offset for later update */
-                uint64_t pos = 0;
-                m_file->set_position(pos, move_method::current, &pos);
+                auto pos = get_write_position();
                 m_offsets[stream] = pos + offsetof(file_types::stream_info, nframes);
                 sinfo.stream = stream;
                 file_types::disk_format::stream_info stream_info = {};
@@ -396,6 +1352,14 @@ namespace rs
 
         void disk_write::write_first_frame_offset()
         {
+            if(m_coalesce_writes)
+            {
+                //the staged header chunks start at the beginning of the stream
+                uint32_t first_frame_position = static_cast<uint32_t>(get_write_position());
+                memcpy(m_write_buffer.data() + offsetof(file_types::file_header, first_frame_offset), &first_frame_position, sizeof(first_frame_position));
+                LOG_INFO("first frame offset - " << first_frame_position)
+                return;
+            }
             uint64_t pos = 0;
             m_file->set_position(pos, move_method::current, &pos);
             m_file->set_position((int64_t)offsetof(file_types::file_header, first_frame_offset), move_method::begin);
@@ -410,14 +1374,23 @@ namespace rs
 
         void disk_write::write_stream_num_of_frames(rs_stream stream, int32_t frame_count)
         {
+            //the frames count of a stream is written to the trailer
+            if(m_is_streamed) return;
             auto it = m_offsets.find(stream);
             if(it == m_offsets.end()) return;
             uint64_t pos;
             m_file->get_position(&pos);
             uint32_t bytes_written = 0;
+            //the patch is written in place at its header offset, it's neither staged in the write buffer nor in a sample bundle,
+            //which would append it to the samples and leave the header count stale
             m_file->set_position(it->second, move_method::begin);
-            write_to_file(&frame_count, sizeof(int32_t), bytes_written);
+            auto sts = m_file->write_bytes(&frame_count, sizeof(int32_t), bytes_written);
             m_file->set_position(pos, move_method::begin);
+            if(sts != status::status_no_error || bytes_written != sizeof(int32_t))
+            {
+                LOG_ERROR("failed to update the number of frames of stream - " << stream);
+                return;
+            }
             LOG_VERBOSE("stream - " << stream << " ,number of frames - " << frame_count)
         }
 
@@ -428,53 +1401,253 @@ namespace rs
             chunk.size = sizeof(file_types::disk_format::sample_info);
             file_types::disk_format::sample_info sample_info;
 
-            uint64_t pos = 0;
-            m_file->get_position(&pos);
-            sample->info.offset = pos;
+            //the offset of a bundle sample is relative to the bundle buffer until the bundle is closed
+            sample->info.offset = m_is_bundle_open ? m_bundle_buffer.size() : get_write_position();
 
             sample_info.data = sample->info;
+            m_is_checksummed_sample = true;
+            m_sample_checksum = 0;
+            m_sample_checksum_size = 0;
             uint32_t bytes_written = 0;
             write_to_file(&chunk, sizeof(chunk), bytes_written);
             write_to_file(&sample_info, chunk.size, bytes_written);
         }
 
-        void disk_write::write_sample(std::shared_ptr<file_types::sample> &sample)
+        void disk_write::write_sample_checksum()
+        {
+            m_is_checksummed_sample = false;
+            file_types::disk_format::sample_checksum checksum = {};
+            checksum.crc = m_sample_checksum;
+            checksum.size = m_sample_checksum_size;
+
+            file_types::chunk_info chunk = {};
+            chunk.id = file_types::chunk_id::chunk_sample_checksum;
+            chunk.size = sizeof(checksum);
+            uint32_t bytes_written = 0;
+            write_to_file(&chunk, sizeof(chunk), bytes_written);
+            write_to_file(&checksum, sizeof(checksum), bytes_written);
+        }
+
+        void disk_write::open_sample_bundle(uint64_t capture_time)
+        {
+            m_is_bundle_open = true;
+            m_bundle_start_time = capture_time;
+            m_bundle_open_time = rs::utils::timebase::now();
+            m_bundle_seek_table_start = m_seek_table.size();
+        }
+
+        bool disk_write::is_sample_bundle_full(const std::shared_ptr<file_types::sample> &sample)
+        {
+            return sample->info.capture_time >= m_bundle_start_time + SAMPLE_BUNDLE_DURATION ||
+                   m_bundle_buffer.size() >= MAX_SAMPLE_BUNDLE_SIZE ||
+                   m_bundle_entries.size() >= MAX_SAMPLE_BUNDLE_ENTRIES;
+        }
+
+        void disk_write::close_sample_bundle()
+        {
+            if(!m_is_bundle_open)
+                return;
+            m_is_bundle_open = false;
+            if(m_bundle_buffer.empty())
+                return;
+
+            file_types::disk_format::sample_bundle bundle = {};
+            bundle.samples_count = static_cast<uint32_t>(m_bundle_entries.size());
+            bundle.samples_size = static_cast<uint32_t>(m_bundle_buffer.size());
+            bundle.start_time = m_bundle_start_time;
+
+            file_types::chunk_info chunk = {};
+            chunk.id = file_types::chunk_id::chunk_sample_bundle;
+            chunk.size = static_cast<uint32_t>(sizeof(bundle) + m_bundle_entries.size() * sizeof(file_types::disk_format::sample_index_entry));
+
+            //the samples are written right after the bundle chunk
+            auto samples_position = get_write_position() + sizeof(chunk) + chunk.size;
+            for(auto & entry : m_bundle_entries)
+                entry.info.offset += samples_position;
+            for(auto i = m_bundle_seek_table_start; i < m_seek_table.size(); i++)
+                m_seek_table[i].offset += samples_position;
+
+            uint32_t bytes_written = 0;
+            write_to_file(&chunk, sizeof(chunk), bytes_written);
+            write_to_file(&bundle, sizeof(bundle), bytes_written);
+            write_to_file(m_bundle_entries.data(), static_cast<uint32_t>(m_bundle_entries.size() * sizeof(file_types::disk_format::sample_index_entry)), bytes_written);
+            write_to_file(m_bundle_buffer.data(), static_cast<uint32_t>(m_bundle_buffer.size()), bytes_written);
+            for(auto & entry : m_bundle_entries)
+                write_samples_index_entry(entry);
+            LOG_VERBOSE("write sample bundle, samples count - " << bundle.samples_count << " ,samples size - " << bundle.samples_size)
+            m_bundle_entries.clear();
+            m_bundle_buffer.clear();
+
+            //the full motion columns blocks are written between the bundles
+            for(auto & columns : m_motion_columns)
+            {
+                if(columns.second.capture_times.size() >= MOTION_COLUMNS_BLOCK_SIZE)
+                    write_motion_columns(columns.first);
+            }
+        }
+
+        void disk_write::add_motion_columns(const std::shared_ptr<file_types::sample> &sample)
+        {
+            switch(sample->info.type)
+            {
+                case file_types::sample_type::st_motion:
+                {
+                    auto & data = std::static_pointer_cast<file_types::motion_sample>(sample)->data;
+                    add_motion_columns_entry(data.timestamp_data, sample->info.capture_time, data.axes);
+                }
+                break;
+                case file_types::sample_type::st_time:
+                    add_motion_columns_entry(std::static_pointer_cast<file_types::time_stamp_sample>(sample)->data, sample->info.capture_time, nullptr);
+                    break;
+                case file_types::sample_type::st_motion_block:
+                {
+                    auto block = std::static_pointer_cast<file_types::motion_block_sample>(sample);
+                    for(uint32_t i = 0; i < block->count; i++)
+                    {
+                        auto & entry = block->entries[i];
+                        if(entry.type == file_types::sample_type::st_motion)
+                            add_motion_columns_entry(entry.data.motion.timestamp_data, entry.capture_time, entry.data.motion.axes);
+                        else
+                            add_motion_columns_entry(entry.data.time_stamp, entry.capture_time, nullptr);
+                    }
+                }
+                break;
+                default:
+                    break;
+            }
+        }
+
+        void disk_write::add_motion_columns_entry(const rs_timestamp_data &time_stamp, uint64_t capture_time, const float * axes)
+        {
+            auto & columns = m_motion_columns[time_stamp.source_id];
+            if(columns.capture_times.empty())
+            {
+                columns.has_axes = axes != nullptr;
+                columns.capture_times.reserve(MOTION_COLUMNS_BLOCK_SIZE);
+                columns.time_stamps.reserve(MOTION_COLUMNS_BLOCK_SIZE);
+                columns.frame_numbers.reserve(MOTION_COLUMNS_BLOCK_SIZE);
+            }
+            columns.capture_times.push_back(capture_time);
+            columns.time_stamps.push_back(time_stamp.timestamp);
+            columns.frame_numbers.push_back(time_stamp.frame_number);
+            if(!columns.has_axes)
+                return;
+            for(int axis = 0; axis < 3; axis++)
+                columns.axes[axis].push_back(axes ? axes[axis] : 0.0f);
+        }
+
+        void disk_write::write_motion_columns(rs_event_source source)
+        {
+            auto & columns = m_motion_columns[source];
+            if(columns.capture_times.empty())
+                return;
+            file_types::disk_format::motion_columns header = {};
+            header.source = source;
+            header.count = static_cast<uint32_t>(columns.capture_times.size());
+            header.axes_count = columns.has_axes ? 3 : 0;
+            header.start_time = columns.capture_times.front();
+            header.end_time = columns.capture_times.back();
+
+            file_types::chunk_info chunk = {};
+            chunk.id = file_types::chunk_id::chunk_motion_columns;
+            chunk.size = static_cast<uint32_t>(sizeof(header) + header.count * (sizeof(uint64_t) + sizeof(double) + sizeof(uint64_t) + header.axes_count * sizeof(float)));
+
+            file_types::disk_format::motion_columns_index_entry entry = {};
+            entry.source = source;
+            entry.count = header.count;
+            entry.start_time = header.start_time;
+            entry.end_time = header.end_time;
+            entry.offset = get_write_position();
+            m_motion_columns_index.push_back(entry);
+
+            uint32_t bytes_written = 0;
+            write_to_file(&chunk, sizeof(chunk), bytes_written);
+            write_to_file(&header, sizeof(header), bytes_written);
+            write_to_file(columns.capture_times.data(), static_cast<uint32_t>(header.count * sizeof(uint64_t)), bytes_written);
+            write_to_file(columns.time_stamps.data(), static_cast<uint32_t>(header.count * sizeof(double)), bytes_written);
+            write_to_file(columns.frame_numbers.data(), static_cast<uint32_t>(header.count * sizeof(uint64_t)), bytes_written);
+            for(uint32_t axis = 0; axis < header.axes_count; axis++)
+                write_to_file(columns.axes[axis].data(), static_cast<uint32_t>(header.count * sizeof(float)), bytes_written);
+            LOG_VERBOSE("write motion columns, source - " << source << " ,samples count - " << header.count)
+
+            columns.capture_times.clear();
+            columns.time_stamps.clear();
+            columns.frame_numbers.clear();
+            for(auto & axis : columns.axes)
+                axis.clear();
+        }
+
+        void disk_write::write_motion_columns_index()
+        {
+            for(auto & columns : m_motion_columns)
+                write_motion_columns(columns.first);
+            if(m_motion_columns_index.empty())
+                return;
+            file_types::disk_format::motion_columns_index_footer footer = {};
+            footer.chunk_offset = get_write_position();
+            footer.id = UID('R', 'S', 'M', 'C');
+
+            file_types::chunk_info chunk = {};
+            chunk.id = file_types::chunk_id::chunk_motion_columns_index;
+            chunk.size = static_cast<uint32_t>(m_motion_columns_index.size() * sizeof(file_types::disk_format::motion_columns_index_entry) + sizeof(footer));
+
+            uint32_t bytes_written = 0;
+            write_to_file(&chunk, sizeof(chunk), bytes_written);
+            write_to_file(m_motion_columns_index.data(), static_cast<uint32_t>(m_motion_columns_index.size() * sizeof(file_types::disk_format::motion_columns_index_entry)), bytes_written);
+            write_to_file(&footer, sizeof(footer), bytes_written);
+            LOG_INFO("write motion columns index chunk, chunk size - " << chunk.size)
+        }
+
+        void disk_write::write_sample(std::shared_ptr<file_types::sample> &sample, const uint8_t * encoded_data, uint32_t encoded_size, bool is_unchanged)
         {
+            RS_PROFILER_ZONE("disk_write::write_sample");
             switch(sample->info.type)
             {
                 case file_types::sample_type::st_image:
                 {
-                    file_types::chunk_info chunk = {};
-                    chunk.id = file_types::chunk_id::chunk_frame_info;
-                    file_types::disk_format::frame_info frame_info = {};
-                    chunk.size = sizeof(frame_info);
                     auto frame = std::static_pointer_cast<file_types::frame_sample>(sample);
                     if (frame)
                     {
-                        uint32_t data_size = 0;
-                        frame->finfo.ctype = m_encoder->get_compression_type(frame->finfo.stream);
-                        if(frame->finfo.ctype != file_types::compression_type::none)
+                        //frames which failed encoding are written uncompressed
+                        uint32_t data_size = frame->finfo.stride * frame->finfo.height;
+                        frame->finfo.ctype = file_types::compression_type::none;
+                        if(encoded_data != nullptr)
                         {
-                            auto sts = m_encoder->encode_frame(frame->finfo, frame->data, m_encoded_data.data(), data_size);
-                            if(sts != status::status_no_error)
-                            {
-                                data_size = frame->finfo.stride * frame->finfo.height;
-                                frame->finfo.ctype = file_types::compression_type::none;
-                            }
+                            frame->finfo.ctype = m_encoder->get_compression_type(frame->finfo.stream);
+                            data_size = encoded_size;
+                        }
+                        //an unchanged frame is written in full if its stream has no written frame in the segment to repeat
+                        auto gated = is_gated_stream(frame->finfo.stream) ? &m_gated_streams[frame->finfo.stream] : nullptr;
+                        const bool is_repeated = is_unchanged && gated && gated->has_written_frame;
+                        if(is_repeated)
+                            frame->finfo.ctype = gated->written_ctype;
+
+                        //the frame chunks and the frame data, encoded or as librealsense delivered it, are written with a single write
+                        m_frame_chunks.info_chunk = {};
+                        m_frame_chunks.info_chunk.id = file_types::chunk_id::chunk_frame_info;
+                        m_frame_chunks.info_chunk.size = sizeof(m_frame_chunks.info);
+                        m_frame_chunks.info = {};
+                        m_frame_chunks.info.data = frame->finfo;
+                        m_frame_buffers.clear();
+                        m_frame_buffers.push_back({ &m_frame_chunks.info_chunk, sizeof(m_frame_chunks.info_chunk) });
+                        m_frame_buffers.push_back({ &m_frame_chunks.info, sizeof(m_frame_chunks.info) });
+                        gather_frame_metadata_chunk(frame->metadata);
+                        if(is_repeated)
+                        {
+                            gather_repeated_image_data(frame->finfo, gated->written_frame_index);
                         }
                         else
                         {
-                            data_size = frame->finfo.stride * frame->finfo.height;
+                            auto data = encoded_data != nullptr ? encoded_data : frame->data;
+                            gather_image_data(frame->finfo, data, data_size);
+                            if(gated && data != nullptr)
+                            {
+                                gated->has_written_frame = true;
+                                gated->written_frame_index = m_stream_frame_index[frame->finfo.stream];
+                                gated->written_ctype = frame->finfo.ctype;
+                            }
                         }
-
-                        frame_info.data = frame->finfo;
-
-                        uint32_t bytes_written = 0;
-                        write_to_file(&chunk, sizeof(chunk), bytes_written);
-                        write_to_file(&frame_info, chunk.size, bytes_written);
-                        write_frame_metadata_chunk(frame->metadata);
-                        auto data = frame->finfo.ctype == file_types::compression_type::none ? frame->data : m_encoded_data.data();
-                        write_image_data(frame->finfo, data, data_size);
+                        write_to_file(m_frame_buffers.data(), static_cast<unsigned int>(m_frame_buffers.size()));
                         LOG_VERBOSE("write frame, " "stream type - " << frame->finfo.stream << " capture time - " << frame->info.capture_time
                                     << " time stamp - " << frame->finfo.time_stamp << " frame number - " << frame->finfo.number);
                     }
@@ -514,6 +1687,23 @@ namespace rs
                     }
                 }
                 break;
+                case file_types::sample_type::st_motion_block:
+                {
+                    auto block = std::static_pointer_cast<file_types::motion_block_sample>(sample);
+                    file_types::disk_format::motion_block_entry entries[file_types::motion_block_sample::max_entries] = {};
+                    for(uint32_t i = 0; i < block->count; i++)
+                    {
+                        entries[i].data = block->entries[i];
+                    }
+                    file_types::chunk_info chunk = {};
+                    chunk.id = file_types::chunk_id::chunk_motion_block;
+                    chunk.size = static_cast<uint32_t>(block->count * sizeof(file_types::disk_format::motion_block_entry));
+                    uint32_t bytes_written = 0;
+                    write_to_file(&chunk, sizeof(chunk), bytes_written);
+                    write_to_file(entries, chunk.size, bytes_written);
+                    LOG_VERBOSE("write motion block, relative time - " << block->info.capture_time << " ,samples count - " << block->count)
+                }
+                break;
                 case file_types::sample_type::st_debug_event:
                 {
                     file_types::chunk_info chunk = {};
@@ -549,47 +1739,172 @@ namespace rs
             }
         }
 
-        void disk_write::write_frame_metadata_chunk(const std::map<rs_frame_metadata, double>& metadata)
+        void disk_write::gather_frame_metadata_chunk(const file_types::frame_metadata_set & metadata)
         {
-            using metadata_pair_type = typename std::remove_reference<decltype(metadata)>::type::value_type; //get the undrlying pair of the map same as in playback
-            if(metadata.size() == 0)
+            if(metadata.empty())
+                return;
+            auto & chunk = m_frame_chunks.metadata_chunk;
+            chunk = {};
+            //without the frame metadata extension the metadata is written as the id and value pairs, which all the readers read
+            if(!m_is_frame_metadata_mask)
             {
-                LOG_ERROR("No metadata to write for current frame");
+                auto pairs = m_frame_chunks.metadata_pairs;
+                uint32_t pairs_count = 0;
+                for(int i = 0; i < file_types::frame_metadata_set::MAX_METADATA_COUNT; i++)
+                {
+                    if(metadata.mask & (1u << i))
+                    {
+                        pairs[pairs_count] = {};
+                        pairs[pairs_count].id = static_cast<rs_frame_metadata>(i);
+                        pairs[pairs_count].value = metadata.values[i];
+                        pairs_count++;
+                    }
+                }
+                chunk.id = file_types::chunk_id::chunk_image_metadata;
+                chunk.size = static_cast<uint32_t>(pairs_count * sizeof(pairs[0]));
+                m_frame_buffers.push_back({ &chunk, sizeof(chunk) });
+                m_frame_buffers.push_back({ pairs, chunk.size });
+                return;
             }
-            std::vector<metadata_pair_type> metadata_pairs;
-            for(auto key_value : metadata)
+
+            auto & header = m_frame_chunks.metadata_header;
+            header = {};
+            header.mask = metadata.mask;
+            auto values = m_frame_chunks.metadata_values;
+            uint32_t values_count = 0;
+            for(int i = 0; i < file_types::frame_metadata_set::MAX_METADATA_COUNT; i++)
             {
-                metadata_pairs.emplace_back(key_value.first, key_value.second);
+                if(metadata.mask & (1u << i))
+                    values[values_count++] = metadata.values[i];
             }
-            assert(metadata_pairs.size() <= RS_FRAME_METADATA_COUNT);
-            uint32_t num_bytes_to_write = static_cast<uint32_t>(sizeof(metadata_pair_type) * metadata_pairs.size());
-            uint32_t bytes_written = 0;
 
-            file_types::chunk_info chunk = {};
-            chunk.id = file_types::chunk_id::chunk_image_metadata;
-            chunk.size = num_bytes_to_write;
+            chunk.id = file_types::chunk_id::chunk_frame_metadata;
+            chunk.size = static_cast<uint32_t>(sizeof(header) + values_count * sizeof(double));
 
-            write_to_file(&chunk, sizeof(chunk), bytes_written);
-            write_to_file(metadata_pairs.data(), num_bytes_to_write, bytes_written);
+            m_frame_buffers.push_back({ &chunk, sizeof(chunk) });
+            m_frame_buffers.push_back({ &header, sizeof(header) });
+            m_frame_buffers.push_back({ values, static_cast<unsigned int>(values_count * sizeof(double)) });
         }
 
-        void disk_write::write_image_data(const file_types::frame_info &frame_info, const uint8_t * data, uint32_t data_size)
+        void disk_write::gather_image_data(const file_types::frame_info &frame_info, const uint8_t * data, uint32_t data_size)
         {
             if (data == nullptr)
                 return;
 
-            file_types::chunk_info chunk = {};
+            auto & chunk = m_frame_chunks.data_chunk;
+            chunk = {};
             chunk.id = file_types::chunk_id::chunk_sample_data;
             chunk.size = data_size;
 
-            uint32_t bytes_written = 0;
-            m_file->write_bytes(&chunk, sizeof(chunk), bytes_written);
-            m_file->write_bytes(data, chunk.size, bytes_written);
+            auto stripe = m_stream_stripe.find(frame_info.stream);
+            if(stripe != m_stream_stripe.end())
+            {
+                //the data chunk is written to the stripe file, the recording references it
+                auto & writer = m_stripes[stripe->second];
+                if(!writer->is_good())
+                    throw std::runtime_error("failed writing to stripe file");
+                auto & reference = m_frame_chunks.striped_data;
+                reference = {};
+                reference.stripe = stripe->second;
+                reference.size = static_cast<uint32_t>(sizeof(chunk)) + chunk.size;
+                reference.offset = writer->append(&chunk, sizeof(chunk), data, chunk.size);
+
+                //the data chunk header was appended to the stripe, the recording holds the reference chunk instead
+                chunk.id = file_types::chunk_id::chunk_striped_sample_data;
+                chunk.size = sizeof(reference);
+                m_frame_buffers.push_back({ &chunk, sizeof(chunk) });
+                m_frame_buffers.push_back({ &reference, sizeof(reference) });
+            }
+            else
+            {
+                m_frame_buffers.push_back({ &chunk, sizeof(chunk) });
+                m_frame_buffers.push_back({ data, chunk.size });
+            }
+
+            add_written_frame_statistics(frame_info, data_size);
+        }
 
+        void disk_write::gather_repeated_image_data(const file_types::frame_info &frame_info, uint32_t frame_index)
+        {
+            auto & reference = m_frame_chunks.repeated_data;
+            reference = {};
+            reference.frame_index = frame_index;
+            auto & chunk = m_frame_chunks.data_chunk;
+            chunk = {};
+            chunk.id = file_types::chunk_id::chunk_repeated_sample_data;
+            chunk.size = sizeof(reference);
+
+            m_frame_buffers.push_back({ &chunk, sizeof(chunk) });
+            m_frame_buffers.push_back({ &reference, sizeof(reference) });
+            m_stream_statistics[frame_info.stream].repeated_frames_count.fetch_add(1, std::memory_order_relaxed);
+            add_written_frame_statistics(frame_info, sizeof(chunk) + sizeof(reference));
+        }
+
+        void disk_write::add_written_frame_statistics(const file_types::frame_info &frame_info, uint64_t written_bytes)
+        {
             m_number_of_frames[frame_info.stream]++;
-            write_stream_num_of_frames(frame_info.stream, m_number_of_frames[frame_info.stream]);
-            std::lock_guard<std::mutex> guard(m_main_mutex);
-            m_samples_count[frame_info.stream]--;
+            auto & statistics = m_stream_statistics[frame_info.stream];
+            statistics.recorded_frames_count.fetch_add(1, std::memory_order_relaxed);
+            statistics.raw_bytes.fetch_add(static_cast<uint64_t>(frame_info.stride) * frame_info.height, std::memory_order_relaxed);
+            statistics.written_bytes.fetch_add(written_bytes, std::memory_order_relaxed);
+            if(!m_coalesce_writes)
+                write_stream_num_of_frames(frame_info.stream, m_number_of_frames[frame_info.stream]);
+        }
+
+        void disk_write::write_preview_frame(const std::shared_ptr<file_types::frame_sample> &frame, uint32_t frame_index)
+        {
+            auto & info = frame->finfo;
+            //packed formats which don't have whole byte pixels aren't previewed
+            if(frame->data == nullptr || info.bpp <= 0 || info.bpp % 8 != 0)
+                return;
+
+            //the frame is sampled every scale pixels of every scale rows, a YUYV macro pixel holds two pixels which share their chroma
+            uint32_t unit_pixels = info.format == rs_format::RS_FORMAT_YUYV ? 2 : 1;
+            uint32_t unit_size = static_cast<uint32_t>(info.bpp / 8) * unit_pixels;
+            uint32_t preview_units = static_cast<uint32_t>(info.width) / unit_pixels / m_preview_scale;
+            uint32_t preview_height = static_cast<uint32_t>(info.height) / m_preview_scale;
+            if(preview_units == 0 || preview_height == 0)
+                return;
+
+            file_types::disk_format::preview_frame preview = {};
+            preview.data = info;
+            preview.data.width = preview_units * unit_pixels;
+            preview.data.height = preview_height;
+            preview.data.stride = preview_units * unit_size;
+            preview.data.index_in_stream = frame_index;
+            preview.capture_time = frame->info.capture_time;
+            preview.scale = m_preview_scale;
+
+            uint32_t preview_size = preview.data.stride * preview_height;
+            m_preview_buffer.resize(preview_size * 2);
+            auto downscaled = m_preview_buffer.data();
+            for(uint32_t row = 0; row < preview_height; row++)
+            {
+                auto source = frame->data + static_cast<size_t>(row) * m_preview_scale * info.stride;
+                auto target = downscaled + row * preview.data.stride;
+                for(uint32_t unit = 0; unit < preview_units; unit++)
+                    memcpy(target + unit * unit_size, source + unit * m_preview_scale * unit_size, unit_size);
+            }
+
+            //a preview which doesn't compress is written as is
+            const uint8_t * data = downscaled;
+            preview.size = preview_size;
+            preview.data.ctype = file_types::compression_type::none;
+            uint32_t encoded_size = 0;
+            if(m_preview_codec.encode(preview.data, downscaled, downscaled + preview_size, encoded_size) == status::status_no_error)
+            {
+                data = downscaled + preview_size;
+                preview.size = encoded_size;
+                preview.data.ctype = m_preview_codec.get_compression_type();
+            }
+
+            file_types::chunk_info chunk = {};
+            chunk.id = file_types::chunk_id::chunk_preview_frame;
+            chunk.size = static_cast<uint32_t>(sizeof(preview)) + preview.size;
+            uint32_t bytes_written = 0;
+            write_to_file(&chunk, sizeof(chunk), bytes_written);
+            write_to_file(&preview, sizeof(preview), bytes_written);
+            write_to_file(data, preview.size, bytes_written);
         }
     }
 }
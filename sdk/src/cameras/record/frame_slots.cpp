@@ -0,0 +1,52 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "frame_slots.h"
+#include "rs/utils/log_utils.h"
+
+namespace rs
+{
+    namespace record
+    {
+        frame_slots::frame_slots(uint32_t slots_count) :
+            m_slots_count(slots_count),
+            m_slot_size(0)
+        {
+
+        }
+
+        uint8_t * frame_slots::acquire(size_t size)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            if(m_slots.empty())
+            {
+                m_slot_size = size;
+                m_slots.resize(m_slots_count, std::vector<uint8_t>(size));
+                for(auto & slot : m_slots)
+                {
+                    m_free_slots.push_back(slot.data());
+                }
+            }
+
+            if(size > m_slot_size)
+            {
+                LOG_ERROR("frame size " << size << " exceeds the frame slot size " << m_slot_size);
+                return nullptr;
+            }
+            if(m_free_slots.empty())
+            {
+                return nullptr;
+            }
+
+            auto slot = m_free_slots.back();
+            m_free_slots.pop_back();
+            return slot;
+        }
+
+        void frame_slots::release(const uint8_t * slot)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_free_slots.push_back(const_cast<uint8_t *>(slot));
+        }
+    }
+}
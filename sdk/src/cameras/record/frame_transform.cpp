@@ -0,0 +1,222 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <cstring>
+#include "frame_transform.h"
+#include "rs/utils/log_utils.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace rs
+{
+    namespace record
+    {
+        const int32_t frame_transform::MAX_SCALE;
+
+        namespace
+        {
+            //adds a row of 8 bit channels to the channel sums
+            void add_row(const uint8_t * row, uint32_t * sums, int32_t count)
+            {
+                int32_t i = 0;
+#if defined(__SSE2__)
+                const __m128i zero = _mm_setzero_si128();
+                for(; i + 16 <= count; i += 16)
+                {
+                    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+                    const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+                    const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+                    __m128i * sum = reinterpret_cast<__m128i *>(sums + i);
+                    _mm_storeu_si128(sum, _mm_add_epi32(_mm_loadu_si128(sum), _mm_unpacklo_epi16(low, zero)));
+                    _mm_storeu_si128(sum + 1, _mm_add_epi32(_mm_loadu_si128(sum + 1), _mm_unpackhi_epi16(low, zero)));
+                    _mm_storeu_si128(sum + 2, _mm_add_epi32(_mm_loadu_si128(sum + 2), _mm_unpacklo_epi16(high, zero)));
+                    _mm_storeu_si128(sum + 3, _mm_add_epi32(_mm_loadu_si128(sum + 3), _mm_unpackhi_epi16(high, zero)));
+                }
+#endif
+                for(; i < count; i++)
+                {
+                    sums[i] += row[i];
+                }
+            }
+
+            //adds a row of 16 bit channels to the channel sums
+            void add_row(const uint16_t * row, uint32_t * sums, int32_t count)
+            {
+                int32_t i = 0;
+#if defined(__SSE2__)
+                const __m128i zero = _mm_setzero_si128();
+                for(; i + 8 <= count; i += 8)
+                {
+                    const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+                    __m128i * sum = reinterpret_cast<__m128i *>(sums + i);
+                    _mm_storeu_si128(sum, _mm_add_epi32(_mm_loadu_si128(sum), _mm_unpacklo_epi16(words, zero)));
+                    _mm_storeu_si128(sum + 1, _mm_add_epi32(_mm_loadu_si128(sum + 1), _mm_unpackhi_epi16(words, zero)));
+                }
+#endif
+                for(; i < count; i++)
+                {
+                    sums[i] += row[i];
+                }
+            }
+
+            //bytes of a pixel, and of each of its channels, 0 for the formats which aren't transformed
+            void get_pixel_layout(rs_format format, int32_t & pixel_size, int32_t & channel_size)
+            {
+                channel_size = 1;
+                switch(format)
+                {
+                    case RS_FORMAT_Z16:
+                    case RS_FORMAT_DISPARITY16:
+                    case RS_FORMAT_Y16:
+                        pixel_size = channel_size = 2;
+                        break;
+                    case RS_FORMAT_Y8:
+                        pixel_size = 1;
+                        break;
+                    case RS_FORMAT_YUYV:
+                        pixel_size = 2;
+                        break;
+                    case RS_FORMAT_RGB8:
+                    case RS_FORMAT_BGR8:
+                        pixel_size = 3;
+                        break;
+                    case RS_FORMAT_RGBA8:
+                    case RS_FORMAT_BGRA8:
+                        pixel_size = 4;
+                        break;
+                    default:
+                        pixel_size = channel_size = 0;
+                }
+            }
+        }
+
+        std::shared_ptr<frame_transform> frame_transform::create(const stream_transform & transform, rs_format format, int32_t width, int32_t height)
+        {
+            std::shared_ptr<frame_transform> rv(new frame_transform());
+            get_pixel_layout(format, rv->m_pixel_size, rv->m_channel_size);
+            const int32_t crop_width = transform.width > 0 ? transform.width : width - transform.x;
+            const int32_t crop_height = transform.height > 0 ? transform.height : height - transform.y;
+            if(rv->m_pixel_size == 0 || transform.scale < 1 || transform.scale > MAX_SCALE || transform.x < 0 || transform.y < 0 ||
+               crop_width <= 0 || crop_height <= 0 || transform.x + crop_width > width || transform.y + crop_height > height)
+            {
+                LOG_ERROR("the stream transform doesn't fit the stream, format - " << format << " size - " << width << "x" << height);
+                return nullptr;
+            }
+            //a YUYV macro pixel holds two pixels which share their chroma, it's cropped on macro pixels and isn't downscaled
+            if(format == RS_FORMAT_YUYV && (transform.scale != 1 || transform.x % 2 != 0 || crop_width % 2 != 0))
+            {
+                LOG_ERROR("a YUYV stream is cropped on even columns and widths and isn't downscaled");
+                return nullptr;
+            }
+
+            rv->m_input_width = width;
+            rv->m_input_height = height;
+            rv->m_x = transform.x;
+            rv->m_y = transform.y;
+            rv->m_scale = transform.scale;
+            rv->m_width = crop_width / transform.scale;
+            rv->m_height = crop_height / transform.scale;
+            rv->m_is_depth = format == RS_FORMAT_Z16 || format == RS_FORMAT_DISPARITY16;
+            if(rv->m_width == 0 || rv->m_height == 0)
+            {
+                LOG_ERROR("the stream transform crops less than a pixel of the downscaled frame");
+                return nullptr;
+            }
+            if(rv->m_scale > 1 && !rv->m_is_depth)
+            {
+                rv->m_sums.resize(static_cast<size_t>(rv->m_width) * rv->m_scale * rv->m_pixel_size / rv->m_channel_size);
+            }
+            return rv;
+        }
+
+        rs_intrinsics frame_transform::transform_intrinsics(const rs_intrinsics & intrinsics) const
+        {
+            //a downscaled pixel is centered on its block, a decimated pixel on the first pixel of its block
+            const float scale = static_cast<float>(m_scale);
+            const float block_center = m_is_depth ? 0.f : (scale - 1) / 2.f;
+            rs_intrinsics rv = intrinsics;
+            rv.width = m_width;
+            rv.height = m_height;
+            rv.ppx = (intrinsics.ppx - static_cast<float>(m_x) - block_center) / scale;
+            rv.ppy = (intrinsics.ppy - static_cast<float>(m_y) - block_center) / scale;
+            rv.fx = intrinsics.fx / scale;
+            rv.fy = intrinsics.fy / scale;
+            return rv;
+        }
+
+        void frame_transform::apply(const uint8_t * data, int32_t stride, uint8_t * output)
+        {
+            const uint8_t * crop = data + static_cast<size_t>(m_y) * stride + static_cast<size_t>(m_x) * m_pixel_size;
+            if(m_scale == 1)
+                copy_block_rows(crop, stride, output);
+            else if(m_is_depth)
+                decimate_block_rows(crop, stride, output);
+            else
+                average_block_rows(crop, stride, output);
+        }
+
+        void frame_transform::copy_block_rows(const uint8_t * crop, int32_t stride, uint8_t * output)
+        {
+            const size_t row_size = static_cast<size_t>(query_stride());
+            for(int32_t row = 0; row < m_height; row++)
+            {
+                memcpy(output + row * row_size, crop + static_cast<size_t>(row) * stride, row_size);
+            }
+        }
+
+        void frame_transform::decimate_block_rows(const uint8_t * crop, int32_t stride, uint8_t * output)
+        {
+            //the depth formats have a single 16 bit channel
+            for(int32_t row = 0; row < m_height; row++)
+            {
+                const uint16_t * source = reinterpret_cast<const uint16_t *>(crop + static_cast<size_t>(row) * m_scale * stride);
+                uint16_t * target = reinterpret_cast<uint16_t *>(output + static_cast<size_t>(row) * query_stride());
+                for(int32_t column = 0; column < m_width; column++)
+                {
+                    target[column] = source[column * m_scale];
+                }
+            }
+        }
+
+        void frame_transform::average_block_rows(const uint8_t * crop, int32_t stride, uint8_t * output)
+        {
+            const int32_t channels = m_pixel_size / m_channel_size;
+            const int32_t block_row_channels = m_width * m_scale * channels;
+            const uint32_t block_area = static_cast<uint32_t>(m_scale * m_scale);
+            for(int32_t row = 0; row < m_height; row++)
+            {
+                std::fill(m_sums.begin(), m_sums.end(), 0u);
+                for(int32_t block_row = 0; block_row < m_scale; block_row++)
+                {
+                    const uint8_t * source = crop + static_cast<size_t>(row * m_scale + block_row) * stride;
+                    if(m_channel_size == 1)
+                        add_row(source, m_sums.data(), block_row_channels);
+                    else
+                        add_row(reinterpret_cast<const uint16_t *>(source), m_sums.data(), block_row_channels);
+                }
+
+                uint8_t * target = output + static_cast<size_t>(row) * query_stride();
+                for(int32_t column = 0; column < m_width; column++)
+                {
+                    for(int32_t channel = 0; channel < channels; channel++)
+                    {
+                        const uint32_t * block = m_sums.data() + column * m_scale * channels + channel;
+                        uint32_t sum = 0;
+                        for(int32_t block_column = 0; block_column < m_scale; block_column++)
+                        {
+                            sum += block[block_column * channels];
+                        }
+                        const uint32_t mean = (sum + block_area / 2) / block_area;
+                        if(m_channel_size == 1)
+                            target[column * channels + channel] = static_cast<uint8_t>(mean);
+                        else
+                            reinterpret_cast<uint16_t *>(target)[column * channels + channel] = static_cast<uint16_t>(mean);
+                    }
+                }
+            }
+        }
+    }
+}
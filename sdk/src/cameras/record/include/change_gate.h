@@ -0,0 +1,41 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "include/file_types.h"
+
+namespace rs
+{
+    namespace record
+    {
+        /**
+        * @brief Detects the frames of a stream which didn't change since the last changed frame of the stream.
+        *
+        * The frame is compared to a copy of the last changed frame in tiles of TILE_ROWS rows of TILE_BYTES bytes. The frame changed if
+        * the mean absolute difference of the bytes of any tile exceeds the threshold, so a change local to a small part of the frame isn't
+        * averaged out by the static rest of the frame. The comparison stops at the first changed tile. Since the reference is the last
+        * changed frame and not the previous frame, a slow drift changes the frame once it accumulates above the threshold.
+        */
+        class change_gate
+        {
+        public:
+            static const uint32_t TILE_ROWS = 16;
+            static const uint32_t TILE_BYTES = 64;
+
+            change_gate();
+
+            //the changed frame is copied as the reference of the next frames, the first frame and a frame of another layout changed
+            bool is_changed(const core::file_types::frame_info & info, const uint8_t * data, uint32_t threshold);
+            void reset();
+
+            //true if the mean absolute difference of the bytes of a tile of the images exceeds the threshold
+            static bool has_changed_tile(const uint8_t * data, const uint8_t * reference, uint32_t row_size, uint32_t stride,
+                                         uint32_t height, uint32_t threshold);
+        private:
+            std::vector<uint8_t>            m_reference;
+            core::file_types::frame_info    m_reference_info;
+        };
+    }
+}
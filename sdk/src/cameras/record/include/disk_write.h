@@ -7,21 +7,38 @@
 #include <map>
 #include <set>
 #include <list>
+#include <deque>
+#include <future>
 #include <mutex>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <atomic>
 #include <condition_variable>
+#include <chrono>
 #include "compression/encoder.h"
+#include "compression/lz4_codec.h"
 #include "include/file_types.h"
+#include "include/spsc_queue.h"
 #include "rs/core/image_interface.h"
 #include "rs/record/record_device.h"
+#include "rs/utils/thread_profiler.h"
+#include "rs/utils/timebase.h"
 #include "include/file.h"
+#include "stripe_writer.h"
+#include "change_gate.h"
 
 namespace rs
 {
     namespace record
     {
+        //the record::compression_codec flags of all the codecs
+        static const uint32_t ALL_COMPRESSION_CODECS = compression_codec::codec_delta | compression_codec::codec_lz4_striped |
+                                                       compression_codec::codec_rvl | compression_codec::codec_lz4_stream;
+        //the record::format_extension flags of all the extensions
+        static const uint32_t ALL_FORMAT_EXTENSIONS = format_extension::extension_sample_bundles | format_extension::extension_motion_blocks |
+                                                      format_extension::extension_frame_metadata;
+
         struct configuration
         {
             std::string                                                     m_file_path;
@@ -33,10 +50,84 @@ namespace rs
             rs_motion_intrinsics                                            m_motion_intrinsics;
             playback::capture_mode                                          m_capture_mode;
             std::map<rs_stream,record::compression_level>                   m_compression_config;
+            uint32_t                                                        m_compression_codecs;   //the record::compression_codec flags of the allowed codecs
+            uint32_t                                                        m_format_extensions;    //the record::format_extension flags of the allowed extensions
+            uint32_t                                                        m_preallocated_seconds; //0 grows the file with the writes
+            uint64_t                                                        m_max_segment_size;     //0 doesn't limit the segment size
+            uint32_t                                                        m_max_segment_seconds;  //0 doesn't limit the segment duration
+            uint32_t                                                        m_pre_trigger_seconds;  //0 writes all the samples
+            uint32_t                                                        m_post_trigger_seconds;
+            std::vector<std::string>                                        m_stripe_directories;   //empty writes the image data to the recording file
+            bool                                                            m_is_stream_data_files; //a stripe per stream, next to the recording file if it isn't striped
+            uint32_t                                                        m_preview_scale;        //0 doesn't record the preview track
+            uint32_t                                                        m_preview_interval;     //frames of a stream between its preview frames
+            int32_t                                                         m_numa_node;            //the node of the recording threads, numa_topology::UNKNOWN_NODE doesn't bind them
+            uint32_t                                                        m_change_threshold;     //0 writes all the frames in full
         };
 
         class disk_write
         {
+            struct stream_statistics
+            {
+                std::atomic<uint64_t> recorded_frames_count;
+                std::atomic<uint64_t> dropped_frames_count;
+                std::atomic<uint64_t> raw_bytes;
+                std::atomic<uint64_t> written_bytes;
+                std::atomic<uint64_t> encode_time;
+                std::atomic<uint64_t> repeated_frames_count;
+            };
+
+            //a sample waiting to be written, image samples may still be encoded by the encoder workers
+            struct pending_sample
+            {
+                std::shared_ptr<core::file_types::sample>   sample;
+                std::future<core::status>                   encode_status;
+                std::vector<uint8_t>                        encoded_data;
+                uint32_t                                    encoded_size;
+                bool                                        is_unchanged; //the change gate found the frame unchanged, it isn't encoded
+            };
+
+            //the change gate of a stream, and the last frame of the stream which was written in full
+            struct gated_stream
+            {
+                record::change_gate                         gate;
+                bool                                        has_written_frame; //a frame was written in full to the current segment
+                uint32_t                                    written_frame_index;
+                core::file_types::compression_type          written_ctype;
+            };
+
+            //the chunks of the frame being written, gathered with the frame data into a single write
+            struct frame_chunks
+            {
+                core::file_types::chunk_info                            info_chunk;
+                core::file_types::disk_format::frame_info               info;
+                core::file_types::chunk_info                            metadata_chunk;
+                core::file_types::disk_format::frame_metadata_header    metadata_header;
+                double                                                  metadata_values[core::file_types::frame_metadata_set::MAX_METADATA_COUNT];
+                core::file_types::disk_format::frame_metadata_pair      metadata_pairs[core::file_types::frame_metadata_set::MAX_METADATA_COUNT];
+                core::file_types::chunk_info                            data_chunk;
+                core::file_types::disk_format::striped_sample_data      striped_data;
+                core::file_types::disk_format::repeated_sample_data     repeated_data;
+            };
+
+            //the motion or time stamp samples of a source, held in columns until the block is written
+            struct motion_columns
+            {
+                std::vector<uint64_t>   capture_times;
+                std::vector<double>     time_stamps;
+                std::vector<uint64_t>   frame_numbers;
+                std::vector<float>      axes[3];
+                bool                    has_axes;
+            };
+
+            //a sample held in memory until a trigger, image samples hold a copy of their encoded or raw data instead of the camera frame
+            struct buffered_sample
+            {
+                std::shared_ptr<core::file_types::sample>   sample;
+                std::vector<uint8_t>                        data;
+                bool                                        is_encoded;
+            };
+
         public:
             disk_write(void);
             ~disk_write(void);
@@ -46,6 +137,17 @@ namespace rs
             bool is_configured() {return m_is_configured;}
             core::status configure(const configuration &config);
             void record_sample(std::shared_ptr<core::file_types::sample> &sample);
+            //accounts a frame the recorder couldn't hold, reported with the next recorded frame of the stream
+            void record_dropped_frame(rs_stream stream, uint64_t frame_number);
+            //writes the samples held in memory, and the samples captured up to the post trigger duration after the capture time
+            core::status trigger(uint64_t capture_time);
+            //number of samples waiting for the write thread
+            size_t query_queue_depth() const { return m_samples_queue.size(); }
+            //maximal number of samples that were waiting for the write thread at once
+            size_t query_queue_high_watermark() const { return m_samples_queue.high_watermark(); }
+            //the stream counters are updated by the recording threads and sampled without locking
+            void query_recording_statistics(rs_stream stream, record::recording_statistics & statistics) const;
+            void query_recorder_statistics(record::recorder_statistics & statistics) const;
 
         private:
             void write_thread();
@@ -62,22 +164,100 @@ namespace rs
             void write_stream_num_of_frames(rs_stream stream, int32_t frame_count);
             //sample type is written separatly since we need to know how to read the sample info
             void write_sample_info(std::shared_ptr<rs::core::file_types::sample> &sample);
-            void write_sample(std::shared_ptr<rs::core::file_types::sample> &sample);
-            void write_frame_metadata_chunk(const std::map<rs_frame_metadata, double>& metadata);
-            void write_image_data(const rs::core::file_types::frame_info &frame_info, const uint8_t * data, uint32_t data_size);
+            //an unchanged frame is written as a repeat of the last frame of its stream which was written in full to the segment
+            void write_sample(std::shared_ptr<rs::core::file_types::sample> &sample, const uint8_t * encoded_data = nullptr, uint32_t encoded_size = 0,
+                              bool is_unchanged = false);
+            //closes the sample chunks with their checksum, the checksum covers the chunks written since the sample info chunk
+            void write_sample_checksum();
+            //the samples of a time window are staged and written after the index entries of the window, the playback indexes
+            //the window with a single read instead of parsing the chunks of each sample
+            void open_sample_bundle(uint64_t capture_time);
+            bool is_sample_bundle_full(const std::shared_ptr<rs::core::file_types::sample> &sample);
+            void close_sample_bundle();
+            //the motion samples are also written in periodic blocks of columns, so reading the motions of a time range doesn't scan the recording
+            void add_motion_columns(const std::shared_ptr<rs::core::file_types::sample> &sample);
+            void add_motion_columns_entry(const rs_timestamp_data &time_stamp, uint64_t capture_time, const float * axes);
+            void write_motion_columns(rs_event_source source);
+            //writes the blocks which weren't written yet, and the index of the blocks
+            void write_motion_columns_index();
+            void encode_sample(std::shared_ptr<rs::core::file_types::sample> &sample);
+            bool is_pending_sample_ready(pending_sample &pending);
+            void write_pending_sample();
+            //writes a sample which isn't held anymore, a temporal stream which lost frames is written from its next keyframe
+            void write_ready_sample(std::shared_ptr<rs::core::file_types::sample> &sample, const uint8_t * encoded_data, uint32_t encoded_size,
+                                    bool is_unchanged = false);
+            //the frames of the streams without temporal compression are gated, unless the samples are held for a trigger
+            bool is_gated_stream(rs_stream stream);
+            bool is_pre_trigger_sample(const std::shared_ptr<rs::core::file_types::sample> &sample);
+            void buffer_sample(const std::shared_ptr<rs::core::file_types::sample> &sample, const uint8_t * encoded_data, uint32_t encoded_size);
+            void write_buffered_samples();
+            //the dictionaries the codecs learned while recording, written before the seek table
+            void write_codec_dictionaries();
+            void write_seek_table();
+            //the frames count of each stream, written at the end of a stream which can't patch the stream info chunk
+            void write_stream_trailer();
+            //the gather functions add the frame chunks to m_frame_buffers, which reference m_frame_chunks and the frame data
+            void gather_frame_metadata_chunk(const core::file_types::frame_metadata_set & metadata);
+            void gather_image_data(const rs::core::file_types::frame_info &frame_info, const uint8_t * data, uint32_t data_size);
+            void gather_repeated_image_data(const rs::core::file_types::frame_info &frame_info, uint32_t frame_index);
+            void add_written_frame_statistics(const rs::core::file_types::frame_info &frame_info, uint64_t written_bytes);
+            //writes a downscaled copy of the raw frame after the frame sample, frames which are held encoded have no preview
+            void write_preview_frame(const std::shared_ptr<rs::core::file_types::frame_sample> &frame, uint32_t frame_index);
             void write_to_file(const void* data, unsigned int number_of_bytes_to_write, unsigned int& numberOfBytesWritten);
+            //buffers which don't fit the staged writes are written with the staged chunks in a single gathered write, without copies
+            void write_to_file(const core::file_buffer* buffers, unsigned int count);
+            //while samples are written, chunks are staged in m_write_buffer and flushed to the file with a single write, followed by the buffers
+            void flush_write_buffer(const core::file_buffer* buffers = nullptr, unsigned int count = 0);
+            uint64_t get_write_position();
             bool allow_sample(std::shared_ptr<rs::core::file_types::sample> &sample);
+            bool push_sample(const std::shared_ptr<rs::core::file_types::sample> &sample);
+            void notify_write_thread();
             uint32_t get_min_fps(const std::map<rs_stream, core::file_types::stream_profile>& stream_profiles);
+            //the file space reserved at once, the streams raw bandwidth of the configured seconds
+            uint64_t get_preallocation_extent_size(const configuration& config);
+            static std::unique_ptr<core::file> open_file(const std::string& file_path, uint64_t preallocation_extent_size);
+            //the first segment is the configured file, the next segments are numbered before the file extension
+            static std::string get_segment_file_path(const std::string& file_path, uint32_t segment_index);
+            //the bytes of the image data a frame sample holds, as accounted in the sdk memory budget
+            static uint64_t frame_data_size(const core::file_types::sample & sample);
+            bool is_segment_full(const std::shared_ptr<rs::core::file_types::sample> &sample);
+            //closes the segment between samples, and continues the recording to the pre-opened next segment
+            void start_next_segment();
+            void open_next_segment_in_background(std::unique_ptr<core::file> closed_file);
+            void discard_next_segment();
+            //the stripe of each stream is named by the recording file, in the stripe directory
+            static std::string get_stripe_file_path(const std::string& file_path, const std::string& directory, uint32_t stripe_index);
+            //the image streams are assigned to the stripes in turn
+            void open_stripes(const configuration& config);
+            void write_stripes();
+            //waits until the stripes are on the disk, the recording references their data
+            bool flush_stripes();
+            void close_stripes();
             void init_encoder(const configuration& config);
+            //the samples index allows the playback to skip the recording scan on open
+            void open_samples_index(const std::string& file_path);
+            void write_samples_index_header(bool completed);
+            //makes the recorded samples durable, a recording which wasn't closed is indexed from the index up to the last checkpoint
+            void write_checkpoint();
+            void write_samples_index_entry(const std::shared_ptr<rs::core::file_types::sample> &sample);
+            void write_samples_index_entry(const rs::core::file_types::disk_format::sample_index_entry &entry);
+            void close_samples_index();
 
-            std::mutex                                                      m_main_mutex; //protect m_samples_queue, m_stop_thred
+            std::mutex                                                      m_main_mutex; //serialize the m_samples_queue producers
             std::mutex                                                      m_notify_write_thread_mutex;
             std::condition_variable                                         m_notify_write_thread_cv;
             std::thread                                                     m_thread;
-            bool                                                            m_stop_writing;
-            std::queue<std::shared_ptr<core::file_types::sample>>           m_samples_queue;
+            std::atomic<bool>                                               m_stop_writing;
+            std::atomic<bool>                                               m_is_write_thread_idle;
+            core::spsc_queue<std::shared_ptr<core::file_types::sample>>     m_samples_queue;
             std::unique_ptr<core::compression::encoder>                     m_encoder;
-            std::vector<uint8_t>                                            m_encoded_data;
+            uint32_t                                                        m_encoded_buffer_size;
+            int32_t                                                         m_numa_node;
+            std::vector<std::vector<uint8_t>>                               m_encoded_buffers; //free buffers for the encoder output
+            std::deque<pending_sample>                                      m_pending_samples; //samples in capture order
+            uint32_t                                                        m_pending_encodes;
+            std::map<rs_stream, uint32_t>                                   m_stream_frame_index; //index of the next written frame in its stream
+            std::vector<core::file_types::disk_format::seek_table_entry>    m_seek_table;
             std::unique_ptr<core::file>                                     m_file;
             bool                                                            m_paused;
             std::map<rs_stream, int64_t>                                    m_offsets;
@@ -87,6 +267,58 @@ namespace rs
             uint32_t                                                        m_min_fps;
             std::map<rs_stream, uint64_t>                                   m_last_frame_number;
             std::map<rs_stream, uint64_t>                                   m_curr_recorder_frame_drop_count;
+            std::vector<uint8_t>                                            m_write_buffer;
+            frame_chunks                                                    m_frame_chunks;
+            std::vector<core::file_buffer>                                  m_frame_buffers;
+            std::vector<core::file_buffer>                                  m_gathered_buffers; //the staged chunks, followed by the buffers of a gathered write
+            uint64_t                                                        m_unpatched_bytes; //written since the frames counts were patched
+            bool                                                            m_coalesce_writes;
+            bool                                                            m_is_streamed; //the recording is written to a socket or a pipe, which can't seek
+            std::unique_ptr<core::file>                                     m_samples_index_file;
+            uint64_t                                                        m_indexed_samples_count;
+            uint64_t                                                        m_checkpoint_position;
+            rs::utils::timebase::time_point                                 m_last_checkpoint_time;
+            std::string                                                     m_file_path;
+            uint64_t                                                        m_preallocation_extent_size;
+            uint64_t                                                        m_max_segment_size;
+            uint64_t                                                        m_max_segment_duration; //microseconds of capture time
+            uint32_t                                                        m_segment_index;
+            bool                                                            m_is_segment_started;
+            uint64_t                                                        m_segment_start_time;
+            std::vector<uint8_t>                                            m_segment_header; //the header chunks, shared by the segments
+            std::future<std::unique_ptr<core::file>>                        m_next_segment_file;
+            uint64_t                                                        m_pre_trigger_duration; //microseconds of capture time, 0 writes all the samples
+            uint64_t                                                        m_post_trigger_duration;
+            std::atomic<uint64_t>                                           m_trigger_end_time; //the samples captured before are written
+            std::deque<buffered_sample>                                     m_buffered_samples; //in capture order
+            uint64_t                                                        m_buffered_bytes;
+            std::set<rs_stream>                                             m_broken_streams; //temporal streams which wait for a keyframe
+            std::vector<std::unique_ptr<stripe_writer>>                     m_stripes;
+            std::vector<std::string>                                        m_stripe_paths;
+            std::map<rs_stream, uint32_t>                                   m_stream_stripe; //the stripe of each striped stream
+            stream_statistics                                               m_stream_statistics[RS_STREAM_COUNT];
+            std::atomic<uint64_t>                                           m_file_written_bytes; //bytes written to the recording, including the buffered writes
+            bool                                                            m_is_checksummed_sample; //the writes are accounted to the sample checksum
+            uint32_t                                                        m_sample_checksum;
+            uint32_t                                                        m_sample_checksum_size;
+            uint32_t                                                        m_preview_scale;
+            uint32_t                                                        m_preview_interval;
+            core::compression::lz4_codec                                    m_preview_codec;
+            std::vector<uint8_t>                                            m_preview_buffer; //the downscaled frame, followed by its compressed copy
+            bool                                                            m_is_sample_bundles; //the samples are written in bundles, the format version 3
+            bool                                                            m_is_motion_blocks; //the motion blocks are written as is, not as their samples
+            bool                                                            m_is_frame_metadata_mask; //the frame metadata is written as a mask and values, not as pairs
+            bool                                                            m_is_bundle_open; //the writes are staged in the bundle buffer
+            uint64_t                                                        m_bundle_start_time;
+            rs::utils::timebase::time_point                                 m_bundle_open_time;
+            std::vector<uint8_t>                                            m_bundle_buffer; //the samples offsets are relative to the buffer until the bundle is closed
+            std::vector<core::file_types::disk_format::sample_index_entry>  m_bundle_entries;
+            size_t                                                          m_bundle_seek_table_start; //the seek table entries of the bundle keyframes
+            std::map<rs_event_source, motion_columns>                       m_motion_columns;
+            std::vector<core::file_types::disk_format::motion_columns_index_entry> m_motion_columns_index;
+            uint32_t                                                        m_change_threshold;
+            std::map<rs_stream, gated_stream>                               m_gated_streams;
+            rs::utils::thread_profiler                                      m_write_thread_profiler;
         };
     }
 }
@@ -0,0 +1,39 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include <mutex>
+#include <stdint.h>
+
+namespace rs
+{
+    namespace record
+    {
+        /**
+        * @brief Ring of preallocated frame buffers of a stream, which hold the copies of the frames waiting to be written.
+        *
+        * The slots are allocated by the first acquired frame, the frames of a stream have the same size during the recording session.
+        * A slot is acquired when the frame is copied on the frame callback, and it is released once the frame is written.
+        */
+        class frame_slots
+        {
+        public:
+            explicit frame_slots(uint32_t slots_count);
+
+            //returns a free slot of at least size bytes, null if all the slots hold frames waiting to be written
+            uint8_t * acquire(size_t size);
+            void release(const uint8_t * slot);
+            uint32_t query_slots_count() const { return m_slots_count; }
+        private:
+            frame_slots(const frame_slots &) = delete;
+            frame_slots & operator= (const frame_slots &) = delete;
+
+            const uint32_t                      m_slots_count;
+            std::mutex                          m_mutex;
+            std::vector<std::vector<uint8_t>>   m_slots;
+            std::vector<uint8_t *>              m_free_slots;
+            size_t                              m_slot_size;
+        };
+    }
+}
@@ -0,0 +1,60 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <memory>
+#include <vector>
+#include <stdint.h>
+#include "rs/record/record_device.h"
+
+namespace rs
+{
+    namespace record
+    {
+        /**
+        * @brief Crops and downscales the frames of a stream as they are recorded, see \c rs::record::device::set_stream_transform.
+        *
+        * The color and infrared formats are downscaled by the mean of each block of scale by scale pixels. The depth formats are decimated to
+        * the first pixel of each block, since a mean of valid depths and of the zero depth of invalid pixels is a depth nothing was seen at.
+        * The block rows are summed into a row of sums with SIMD adds, then each block sums its columns, the callbacks of a stream are
+        * serialized so the transform of a stream owns its sums row.
+        */
+        class frame_transform
+        {
+        public:
+            static const int32_t MAX_SCALE = 8;
+
+            //null if the transform doesn't fit the format or the size of the stream frames
+            static std::shared_ptr<frame_transform> create(const stream_transform & transform, rs_format format, int32_t width, int32_t height);
+
+            int32_t query_width() const { return m_width; }
+            int32_t query_height() const { return m_height; }
+            int32_t query_stride() const { return m_width * m_pixel_size; }
+            bool is_input_size(int32_t width, int32_t height) const { return width == m_input_width && height == m_input_height; }
+
+            //the intrinsics of the stream, or its rectified intrinsics, as seen by the transformed frames
+            rs_intrinsics transform_intrinsics(const rs_intrinsics & intrinsics) const;
+
+            //writes the transformed frame, query_stride() by query_height() bytes, the frame is of the stream size
+            void apply(const uint8_t * data, int32_t stride, uint8_t * output);
+        private:
+            frame_transform() = default;
+
+            void copy_block_rows(const uint8_t * crop, int32_t stride, uint8_t * output);
+            void decimate_block_rows(const uint8_t * crop, int32_t stride, uint8_t * output);
+            void average_block_rows(const uint8_t * crop, int32_t stride, uint8_t * output);
+
+            int32_t                 m_input_width;
+            int32_t                 m_input_height;
+            int32_t                 m_x;
+            int32_t                 m_y;
+            int32_t                 m_scale;
+            int32_t                 m_width;
+            int32_t                 m_height;
+            int32_t                 m_pixel_size;   //bytes
+            int32_t                 m_channel_size; //bytes, 1 or 2
+            bool                    m_is_depth;
+            std::vector<uint32_t>   m_sums;         //the channel sums of the rows of a block row
+        };
+    }
+}
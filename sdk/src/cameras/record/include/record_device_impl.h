@@ -5,12 +5,24 @@
 #include <mutex>
 #include "record_device_interface.h"
 #include "disk_write.h"
+#include "frame_slots.h"
+#include "frame_transform.h"
+#include "rs/utils/timebase.h"
 
 namespace rs
 {
     namespace record
     {
         class frame_callback;
+
+        //the options a device supports and its camera info, which don't change while the device is connected. the snapshot is taken
+        //by the first recording of a device and shared by the next recordings, which read the option values only
+        struct device_snapshot
+        {
+            std::vector<rs_option>                      supported_options;
+            std::map<rs_camera_info, std::string>       camera_info;
+        };
+
         class rs_device_ex : public device_interface
         {
             friend class frame_callback;
@@ -62,16 +74,47 @@ namespace rs
             virtual void                            resume_record() override;
             virtual bool                            set_compression(rs_stream stream, record::compression_level compression_level) override;
             virtual record::compression_level       get_compression(rs_stream stream) override;
+            virtual core::status                    set_compression_codecs(uint32_t codecs) override;
+            virtual core::status                    set_format_extensions(uint32_t extensions) override;
+            virtual core::status                    set_frame_copy_mode(record::frame_copy_mode mode, uint32_t frame_slots_count) override;
+            virtual core::status                    set_numa_affinity(record::numa_affinity affinity, int32_t node) override;
+            virtual core::status                    set_file_preallocation(uint32_t preallocated_seconds) override;
+            virtual core::status                    set_file_segmentation(uint64_t max_segment_size, uint32_t max_segment_seconds) override;
+            virtual core::status                    set_file_striping(const std::vector<std::string> & stripe_directories) override;
+            virtual core::status                    set_stream_data_files(bool enable) override;
+            virtual core::status                    set_preview(uint32_t scale, uint32_t frames_interval) override;
+            virtual core::status                    set_change_gate(uint32_t threshold) override;
+            virtual core::status                    set_stream_transform(rs_stream stream, const record::stream_transform & transform) override;
+            virtual core::status                    set_pre_trigger_recording(uint32_t pre_trigger_seconds, uint32_t post_trigger_seconds) override;
+            virtual core::status                    trigger_recording() override;
+            virtual core::status                    query_recording_statistics(rs_stream stream, record::recording_statistics & statistics) override;
+            virtual core::status                    query_recorder_statistics(record::recorder_statistics & statistics) override;
 
         private:
             void write_samples();
             void write_frame(rs_stream stream, rs_frame_ref *ref);
+            //copies the frame to a frame slot of the stream, transformed if the stream has a transform, the frame may be released once the method returns
+            void write_frame_copy(rs_stream stream, rs_frame_ref *ref);
+            //the frames of the transformed streams are copied to frame slots in every frame copy mode
+            bool is_frame_copied(rs_stream stream) const;
+            void create_frame_slots();
+            //the transforms which fit their streams, created before the stream profiles are recorded
+            void create_frame_transforms();
+            //the node of the recording threads by the affinity, numa_topology::UNKNOWN_NODE if they aren't bound
+            int32_t resolve_numa_node();
+            //binds the camera callback thread to the recording node on its first frame, so the frame slots it fills are on the node
+            void bind_callback_thread();
+            //motion and time stamp samples are recorded in blocks, a block is recorded once it is full or before a frame is recorded
+            void write_motion_block_entry(const core::file_types::motion_block_entry & entry);
+            void flush_motion_block();
             void write_frameset(rs_frameset * frameset);
             core::status configure_disk_write();
             std::vector<rs_capabilities> get_capabilities();
             std::map<rs_stream, core::file_types::stream_profile> get_profiles();
             std::vector<core::file_types::device_cap> read_all_options();
             std::map<rs_camera_info, std::pair<uint32_t, const char *> > get_all_camera_info();
+            //the cached snapshot of the device, taken if the device wasn't recorded yet by this process
+            std::shared_ptr<const device_snapshot> get_device_snapshot();
             uint64_t get_capture_time();
             void update_active_streams(rs_stream stream, bool state);
 
@@ -82,12 +125,35 @@ namespace rs
             std::vector<rs_stream>                                                  m_active_streams;
             std::string                                                             m_file_path;
             std::vector<core::file_types::device_cap>                               m_modifyied_options;
-            std::chrono::high_resolution_clock::time_point                          m_capture_time_base;
+            rs::utils::timebase::time_point                                         m_capture_time_base;
             std::vector<rs_capabilities>                                            m_capabilities;
             rs_source                                                               m_source;
             bool                                                                    m_is_motion_tracking_enabled;
             playback::capture_mode                                                  m_capture_mode;
             std::map<rs_stream, compression_level>                                  m_compression_config;
+            uint32_t                                                                m_compression_codecs;
+            uint32_t                                                                m_format_extensions;
+            frame_copy_mode                                                         m_frame_copy_mode;
+            uint32_t                                                                m_frame_slots_count;
+            numa_affinity                                                           m_numa_affinity;
+            int32_t                                                                 m_fixed_numa_node;
+            int32_t                                                                 m_numa_node; //resolved on the first start, read only while streaming
+            uint32_t                                                                m_preallocated_seconds;
+            uint64_t                                                                m_max_segment_size;
+            uint32_t                                                                m_max_segment_seconds;
+            std::vector<std::string>                                                m_stripe_directories;
+            bool                                                                    m_is_stream_data_files;
+            uint32_t                                                                m_preview_scale;
+            uint32_t                                                                m_preview_interval;
+            uint32_t                                                                m_change_threshold;
+            uint32_t                                                                m_pre_trigger_seconds;
+            uint32_t                                                                m_post_trigger_seconds;
+            std::map<rs_stream, std::shared_ptr<frame_slots>>                       m_frame_slots; //created when the first start configures the writer, read only while streaming, shared by the samples which hold a slot until written
+            std::map<rs_stream, stream_transform>                                   m_stream_transforms;
+            std::map<rs_stream, std::shared_ptr<frame_transform>>                   m_frame_transforms; //created on the first start, read only while streaming
+            std::mutex                                                              m_motion_block_mutex;
+            std::shared_ptr<core::file_types::motion_block_sample>                  m_motion_block;
+            std::shared_ptr<const device_snapshot>                                  m_device_snapshot; //the camera info strings are recorded from the snapshot
         };
     }
 }
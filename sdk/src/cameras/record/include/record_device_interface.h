@@ -2,6 +2,8 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #pragma once
+#include <vector>
+#include <string>
 #include <librealsense/rs.hpp>
 #include <librealsense/rscore.hpp>
 #include "rs/record/record_device.h"
@@ -18,6 +20,21 @@ namespace rs
             virtual void resume_record() = 0;
             virtual bool set_compression(rs_stream stream, record::compression_level compression_level) = 0;
             virtual record::compression_level get_compression(rs_stream stream) = 0;
+            virtual core::status set_compression_codecs(uint32_t codecs) = 0;
+            virtual core::status set_format_extensions(uint32_t extensions) = 0;
+            virtual core::status set_frame_copy_mode(record::frame_copy_mode mode, uint32_t frame_slots_count) = 0;
+            virtual core::status set_numa_affinity(record::numa_affinity affinity, int32_t node) = 0;
+            virtual core::status set_file_preallocation(uint32_t preallocated_seconds) = 0;
+            virtual core::status set_file_segmentation(uint64_t max_segment_size, uint32_t max_segment_seconds) = 0;
+            virtual core::status set_file_striping(const std::vector<std::string> & stripe_directories) = 0;
+            virtual core::status set_stream_data_files(bool enable) = 0;
+            virtual core::status set_preview(uint32_t scale, uint32_t frames_interval) = 0;
+            virtual core::status set_change_gate(uint32_t threshold) = 0;
+            virtual core::status set_stream_transform(rs_stream stream, const record::stream_transform & transform) = 0;
+            virtual core::status set_pre_trigger_recording(uint32_t pre_trigger_seconds, uint32_t post_trigger_seconds) = 0;
+            virtual core::status trigger_recording() = 0;
+            virtual core::status query_recording_statistics(rs_stream stream, record::recording_statistics & statistics) = 0;
+            virtual core::status query_recorder_statistics(record::recorder_statistics & statistics) = 0;
         };
     }
 }
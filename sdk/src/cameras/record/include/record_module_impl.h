@@ -0,0 +1,77 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <memory>
+#include <mutex>
+#include <map>
+#include <chrono>
+#include "rs/record/record_module.h"
+#include "disk_write.h"
+#include "rs/utils/timebase.h"
+
+namespace rs
+{
+    namespace record
+    {
+        /**
+        * @brief The record_module_impl class
+        * writes the samples sets to the disk writer, which is configured by the first samples set of all the enabled streams.
+        */
+        class DLL_EXPORT record_module_impl : public rs::core::video_module_interface
+        {
+        public:
+            record_module_impl(const char * file_path);
+
+            record_module_impl(const record_module_impl & other) = delete;
+            record_module_impl & operator=(const record_module_impl & other) = delete;
+            record_module_impl(record_module_impl && other) = delete;
+            record_module_impl & operator=(record_module_impl && other) = delete;
+
+            core::status enable_stream(core::stream_type stream);
+            core::status enable_motion(core::motion_type motion);
+            core::status set_compression(core::stream_type stream, compression_level level);
+            core::status set_compression_codecs(uint32_t codecs);
+            core::status set_format_extensions(uint32_t extensions);
+            core::status query_recording_statistics(core::stream_type stream, recording_statistics & statistics);
+
+            // video_module_interface interface
+            int32_t query_module_uid() override;
+            core::status query_supported_module_config(int32_t idx, supported_module_config &supported_config) override;
+            core::status query_current_module_config(actual_module_config &module_config) override;
+            core::status set_module_config(const actual_module_config &module_config) override;
+            core::status process_sample_set(const core::correlated_sample_set & sample_set) override;
+            core::status register_event_handler(processing_event_handler *handler) override;
+            core::status unregister_event_handler(processing_event_handler *handler) override;
+            core::status flush_resources() override;
+            core::status reset_config() override;
+
+            virtual ~record_module_impl();
+
+        private:
+            bool is_sample_set_complete(const core::correlated_sample_set & sample_set);
+            //the recording streams are the images formats of the first complete samples set, with the calibration of the module config
+            core::status configure_disk_write(const core::correlated_sample_set & sample_set);
+            void record_image(core::image_interface * image, uint64_t capture_time);
+            void record_motions(const core::correlated_sample_set & sample_set, uint64_t capture_time);
+            uint64_t get_capture_time();
+
+            int32_t                                             m_unique_module_id;
+            std::string                                         m_file_path;
+            bool                                                m_enabled_streams[static_cast<uint32_t>(core::stream_type::max)];
+            bool                                                m_enabled_motions[static_cast<uint32_t>(core::motion_type::max)];
+            std::map<rs_stream, compression_level>              m_compression_config;
+            uint32_t                                            m_compression_codecs;
+            uint32_t                                            m_format_extensions;
+            std::mutex                                          m_lock;
+            bool                                                m_is_configured;
+            actual_module_config                                m_current_module_config;
+            std::unique_ptr<disk_write>                         m_disk_write;
+            bool                                                m_is_file_closed;
+            std::map<rs_stream, recording_statistics>           m_closed_file_statistics; //kept until the next recording
+            rs::utils::timebase::time_point                     m_capture_time_base;
+            std::mutex                                          m_processing_handler_lock;
+            processing_event_handler *                          m_processing_handler;
+        };
+    }
+}
@@ -0,0 +1,61 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <stdint.h>
+#include "include/file.h"
+
+namespace rs
+{
+    namespace record
+    {
+        /**
+        * @brief Writes the image data of the streams assigned to a stripe file, on a thread of its own.
+        *
+        * The recording thread stages the data chunks of a stripe and hands them over in large buffers, the stripe thread writes
+        * the buffers in order, so the stripes on different disks are written at the same time. The recording file references
+        * the chunks by their offset in the stripe file.
+        */
+        class stripe_writer
+        {
+        public:
+            //the stripe thread runs on the numa node, numa_topology::UNKNOWN_NODE doesn't bind it
+            stripe_writer(std::unique_ptr<core::file> file, int32_t numa_node);
+            ~stripe_writer();
+
+            //stages a chunk, returns its offset in the stripe file
+            uint64_t append(const void * header, uint32_t header_size, const void * data, uint32_t data_size);
+            //hands the staged chunks to the stripe thread, waits while the stripe thread is too far behind
+            void submit();
+            //waits until the submitted chunks are written and flushed to the disk, returns false if the stripe failed
+            bool flush();
+            //writes the staged chunks and closes the stripe file
+            void close();
+            bool is_good() const;
+        private:
+            stripe_writer(const stripe_writer &) = delete;
+            stripe_writer & operator= (const stripe_writer &) = delete;
+
+            void write_thread();
+
+            std::unique_ptr<core::file>             m_file;
+            std::vector<uint8_t>                    m_staged_buffer;    //accessed by the recording thread only
+            uint64_t                                m_position;         //the end of the staged chunks
+            mutable std::mutex                      m_mutex;
+            std::condition_variable                 m_cv;
+            std::deque<std::vector<uint8_t>>        m_submitted_buffers;
+            std::vector<std::vector<uint8_t>>       m_free_buffers;
+            bool                                    m_is_writing;       //the stripe thread writes a buffer it took
+            bool                                    m_stop;
+            bool                                    m_failed;
+            const int32_t                           m_numa_node;
+            std::thread                             m_thread;
+        };
+    }
+}
@@ -8,15 +8,31 @@ namespace rs
 {
     namespace record
     {
-        context::context(const char *file_path)
+        context::context(const char *file_path) : m_source_context(nullptr)
+        {
+            create_devices(file_path);
+        }
+
+        context::context(const char *file_path, rs::core::context_interface & source_context) : m_source_context(&source_context)
+        {
+            create_devices(file_path);
+        }
+
+        void context::create_devices(const char *file_path)
         {
             m_devices = new rs_device*[get_device_count()];
             for(auto i = 0; i < get_device_count(); i++)
             {
-                m_devices[i] = new rs_device_ex(file_path, (rs_device*)(m_context.get_device(i)));//revert casting to cpp wrapper done by librealsense
+                auto source_device = m_source_context ? m_source_context->get_device(i) : m_context->get_device(i);
+                m_devices[i] = new rs_device_ex(file_path, (rs_device*)(source_device));//revert casting to cpp wrapper done by librealsense
             }
         }
 
+        int context::get_device_count() const
+        {
+            return m_source_context ? m_source_context->get_device_count() : rs::core::context::get_device_count();
+        }
+
         context::~context()
         {
             for(auto i = 0; i < get_device_count(); i++)
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include "record_device_impl.h"
 #include "rs/utils/log_utils.h"
+#include "rs/utils/numa_topology.h"
 
 using namespace rs::core;
 
@@ -21,6 +22,10 @@ namespace
             default: return rs_capabilities::RS_CAPABILITIES_COUNT;
         }
     }
+
+    //the snapshots of the devices recorded by the process, by serial number and firmware version
+    std::mutex device_snapshots_mutex;
+    std::map<std::string, std::shared_ptr<const rs::record::device_snapshot>> device_snapshots;
 }
 
 namespace rs
@@ -36,8 +41,18 @@ namespace rs
                 m_stream(stream), m_user_callback(user_callback), m_device(device), m_user_callback_ptr(nullptr) {}
             void on_frame (rs_device * device, rs_frame_ref * frame) override
             {
-                auto clone = device->clone_frame(frame);
-                m_device->write_frame(m_stream, clone);
+                m_device->bind_callback_thread();
+                //the motion samples captured before the frame are written before it
+                m_device->flush_motion_block();
+                if(m_device->is_frame_copied(m_stream))
+                {
+                    m_device->write_frame_copy(m_stream, frame);
+                }
+                else
+                {
+                    auto clone = device->clone_frame(frame);
+                    m_device->write_frame(m_stream, clone);
+                }
                 m_user_callback_ptr == nullptr ? m_user_callback->on_frame(m_device, frame) : m_user_callback_ptr(device, frame, m_user);
             }
             void release() override
@@ -63,9 +78,11 @@ namespace rs
                 m_user_callback(user_callback), m_device(device), m_user_callback_ptr(nullptr) {}
             void on_event (rs_motion_data data) override
             {
-                std::shared_ptr<file_types::sample> sample = std::shared_ptr<file_types::sample>(
-                new file_types::motion_sample(data, m_device->get_capture_time()),[](file_types::sample* s) {});
-                m_device->m_disk_write.record_sample(sample);
+                file_types::motion_block_entry entry = {};
+                entry.type = file_types::sample_type::st_motion;
+                entry.capture_time = m_device->get_capture_time();
+                entry.data.motion = data;
+                m_device->write_motion_block_entry(entry);
                 m_user_callback_ptr == nullptr ? m_user_callback->on_event(data) : m_user_callback_ptr(m_device, data, m_user);
             }
             void release() override
@@ -90,9 +107,11 @@ namespace rs
                 m_user_callback(user_callback), m_device(device), m_user_callback_ptr(nullptr) {}
             void on_event (rs_timestamp_data data) override
             {
-                std::shared_ptr<file_types::sample> sample  = std::shared_ptr<file_types::sample>(
-                new file_types::time_stamp_sample(data, m_device->get_capture_time()),[](file_types::sample* s) {});
-                m_device->m_disk_write.record_sample(sample);
+                file_types::motion_block_entry entry = {};
+                entry.type = file_types::sample_type::st_time;
+                entry.capture_time = m_device->get_capture_time();
+                entry.data.time_stamp = data;
+                m_device->write_motion_block_entry(entry);
                 m_user_callback_ptr == nullptr ? m_user_callback->on_event(data) : m_user_callback_ptr(m_device, data, m_user);
             }
             void release() override
@@ -112,7 +131,23 @@ namespace rs
             m_device(device),
             m_file_path(file_path),
             m_is_streaming(false),
-            m_capture_mode(playback::capture_mode::synced)
+            m_capture_mode(playback::capture_mode::synced),
+            m_compression_codecs(0),
+            m_format_extensions(0),
+            m_frame_copy_mode(frame_copy_mode::hold_camera_frames),
+            m_frame_slots_count(0),
+            m_numa_affinity(numa_affinity::usb_controller_node),
+            m_fixed_numa_node(0),
+            m_numa_node(rs::utils::numa_topology::UNKNOWN_NODE),
+            m_preallocated_seconds(0),
+            m_max_segment_size(0),
+            m_max_segment_seconds(0),
+            m_is_stream_data_files(false),
+            m_preview_scale(0),
+            m_preview_interval(1),
+            m_change_threshold(0),
+            m_pre_trigger_seconds(0),
+            m_post_trigger_seconds(0)
         {
             rs_option opt = rs_option::RS_OPTION_FRAMES_QUEUE_SIZE;
             double value = 60.0;
@@ -127,6 +162,7 @@ namespace rs
 
         rs_device_ex::~rs_device_ex()
         {
+            flush_motion_block();
             m_disk_write.stop();
             stop(m_source);
         }
@@ -269,10 +305,13 @@ namespace rs
             }
             else
             {
+                m_numa_node = resolve_numa_node();
+                create_frame_transforms();
                 status sts = configure_disk_write();
                 if (sts == status::status_no_error)
                 {
-                    m_capture_time_base = std::chrono::high_resolution_clock::now();
+                    create_frame_slots();
+                    m_capture_time_base = rs::utils::timebase::now();
                     m_disk_write.start();
                 }
             }
@@ -429,6 +468,7 @@ namespace rs
         void rs_device_ex::pause_record()
         {
             LOG_INFO("pause record")
+            flush_motion_block();
             m_disk_write.set_pause(true, get_capture_time());
         }
 
@@ -445,7 +485,8 @@ namespace rs
                 case record::compression_level::disabled:
                 case record::compression_level::low:
                 case record::compression_level::medium:
-                case record::compression_level::high: m_compression_config[stream] = compression_level; return true;
+                case record::compression_level::high:
+                case record::compression_level::lossy: m_compression_config[stream] = compression_level; return true;
                 default: return false;
             }
         }
@@ -457,11 +498,293 @@ namespace rs
             return m_compression_config[stream];
         }
 
+        status rs_device_ex::set_compression_codecs(uint32_t codecs)
+        {
+            if(codecs & ~ALL_COMPRESSION_CODECS)
+            {
+                return status::status_invalid_argument;
+            }
+            std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
+            if(m_is_streaming)
+            {
+                return status::status_invalid_state;
+            }
+            m_compression_codecs = codecs;
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::set_format_extensions(uint32_t extensions)
+        {
+            if(extensions & ~ALL_FORMAT_EXTENSIONS)
+            {
+                return status::status_invalid_argument;
+            }
+            std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
+            if(m_is_streaming)
+            {
+                return status::status_invalid_state;
+            }
+            m_format_extensions = extensions;
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::set_frame_copy_mode(record::frame_copy_mode mode, uint32_t frame_slots_count)
+        {
+            std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
+            if(m_is_streaming)
+            {
+                return status::status_invalid_state;
+            }
+            switch(mode)
+            {
+                case record::frame_copy_mode::hold_camera_frames:
+                case record::frame_copy_mode::copy_to_frame_slots:
+                    m_frame_copy_mode = mode;
+                    m_frame_slots_count = frame_slots_count;
+                    return status::status_no_error;
+                default: return status::status_invalid_argument;
+            }
+        }
+
+        status rs_device_ex::set_numa_affinity(record::numa_affinity affinity, int32_t node)
+        {
+            if(node < 0)
+            {
+                return status::status_invalid_argument;
+            }
+            std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
+            if(m_is_streaming)
+            {
+                return status::status_invalid_state;
+            }
+            switch(affinity)
+            {
+                case record::numa_affinity::usb_controller_node:
+                case record::numa_affinity::fixed_node:
+                case record::numa_affinity::any_node:
+                    m_numa_affinity = affinity;
+                    m_fixed_numa_node = node;
+                    return status::status_no_error;
+                default: return status::status_invalid_argument;
+            }
+        }
+
+        status rs_device_ex::set_file_preallocation(uint32_t preallocated_seconds)
+        {
+            std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
+            if(m_is_streaming)
+            {
+                return status::status_invalid_state;
+            }
+            m_preallocated_seconds = preallocated_seconds;
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::set_file_segmentation(uint64_t max_segment_size, uint32_t max_segment_seconds)
+        {
+            std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
+            if(m_is_streaming)
+            {
+                return status::status_invalid_state;
+            }
+            m_max_segment_size = max_segment_size;
+            m_max_segment_seconds = max_segment_seconds;
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::set_file_striping(const std::vector<std::string> & stripe_directories)
+        {
+            std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
+            if(m_is_streaming)
+            {
+                return status::status_invalid_state;
+            }
+            m_stripe_directories = stripe_directories;
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::set_stream_data_files(bool enable)
+        {
+            std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
+            if(m_is_streaming)
+            {
+                return status::status_invalid_state;
+            }
+            m_is_stream_data_files = enable;
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::set_preview(uint32_t scale, uint32_t frames_interval)
+        {
+            if(scale == 1 || (scale > 0 && frames_interval == 0))
+            {
+                return status::status_invalid_argument;
+            }
+            std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
+            if(m_is_streaming)
+            {
+                return status::status_invalid_state;
+            }
+            m_preview_scale = scale;
+            m_preview_interval = frames_interval;
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::set_stream_transform(rs_stream stream, const record::stream_transform & transform)
+        {
+            if(stream < 0 || stream >= RS_STREAM_COUNT || transform.x < 0 || transform.y < 0 || transform.width < 0 || transform.height < 0 ||
+               transform.scale < 1 || transform.scale > frame_transform::MAX_SCALE)
+            {
+                return status::status_invalid_argument;
+            }
+            std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
+            if(m_is_streaming)
+            {
+                return status::status_invalid_state;
+            }
+            if(transform.x == 0 && transform.y == 0 && transform.width == 0 && transform.height == 0 && transform.scale == 1)
+            {
+                m_stream_transforms.erase(stream);
+            }
+            else
+            {
+                m_stream_transforms[stream] = transform;
+            }
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::set_change_gate(uint32_t threshold)
+        {
+            std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
+            if(m_is_streaming)
+            {
+                return status::status_invalid_state;
+            }
+            m_change_threshold = threshold;
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::set_pre_trigger_recording(uint32_t pre_trigger_seconds, uint32_t post_trigger_seconds)
+        {
+            std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
+            if(m_is_streaming)
+            {
+                return status::status_invalid_state;
+            }
+            m_pre_trigger_seconds = pre_trigger_seconds;
+            m_post_trigger_seconds = post_trigger_seconds;
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::trigger_recording()
+        {
+            return m_disk_write.trigger(get_capture_time());
+        }
+
+        status rs_device_ex::query_recording_statistics(rs_stream stream, record::recording_statistics & statistics)
+        {
+            if(stream < 0 || stream >= RS_STREAM_COUNT)
+            {
+                return status::status_invalid_argument;
+            }
+            m_disk_write.query_recording_statistics(stream, statistics);
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::query_recorder_statistics(record::recorder_statistics & statistics)
+        {
+            m_disk_write.query_recorder_statistics(statistics);
+            return status::status_no_error;
+        }
+
+        bool rs_device_ex::is_frame_copied(rs_stream stream) const
+        {
+            return m_frame_copy_mode == frame_copy_mode::copy_to_frame_slots || m_frame_transforms.count(stream) > 0;
+        }
+
+        void rs_device_ex::create_frame_slots()
+        {
+            for(auto & stream : m_active_streams)
+            {
+                if(!is_frame_copied(stream))
+                {
+                    continue;
+                }
+                uint32_t slots_count = m_frame_slots_count;
+                if(slots_count == 0)
+                {
+                    slots_count = static_cast<uint32_t>(std::max(m_device->get_stream_interface(stream).get_framerate(), 1));
+                }
+                m_frame_slots[stream] = std::make_shared<frame_slots>(slots_count);
+            }
+        }
+
+        void rs_device_ex::create_frame_transforms()
+        {
+            m_frame_transforms.clear();
+            for(auto & transform : m_stream_transforms)
+            {
+                if(std::find(m_active_streams.begin(), m_active_streams.end(), transform.first) == m_active_streams.end())
+                {
+                    continue;
+                }
+                auto & stream = m_device->get_stream_interface(transform.first);
+                auto intrinsics = stream.get_intrinsics();
+                auto created = frame_transform::create(transform.second, stream.get_format(), intrinsics.width, intrinsics.height);
+                if(created)
+                {
+                    m_frame_transforms[transform.first] = created;
+                }
+                else
+                {
+                    LOG_WARN("stream " << transform.first << " is recorded without its transform");
+                }
+            }
+        }
+
+        int32_t rs_device_ex::resolve_numa_node()
+        {
+            if(m_numa_affinity == numa_affinity::any_node || rs::utils::numa_topology::query_nodes_count() < 2)
+            {
+                return rs::utils::numa_topology::UNKNOWN_NODE;
+            }
+            if(m_numa_affinity == numa_affinity::fixed_node)
+            {
+                return m_fixed_numa_node;
+            }
+            const char * usb_port_id = nullptr;
+            try
+            {
+                usb_port_id = m_device->get_usb_port_id();
+            }
+            catch(const rs::error & e)
+            {
+                LOG_WARN("the usb port of the device isn't reported, the recording threads aren't bound to a numa node, " << e.what());
+            }
+            const int32_t node = rs::utils::numa_topology::query_usb_port_node(usb_port_id);
+            if(node != rs::utils::numa_topology::UNKNOWN_NODE)
+            {
+                LOG_INFO("the device on usb port " << usb_port_id << " is recorded on numa node " << node);
+            }
+            return node;
+        }
+
+        void rs_device_ex::bind_callback_thread()
+        {
+            //a callback thread serves a single device, it's bound once
+            static thread_local const rs_device_ex * bound_device = nullptr;
+            if(bound_device == this)
+            {
+                return;
+            }
+            bound_device = this;
+            rs::utils::numa_topology::bind_thread(m_numa_node, rs::utils::thread_role::recording);
+        }
+
+        //called for every sample, the capture times of the devices and the modules are taken by the sdk timebase
         uint64_t rs_device_ex::get_capture_time()
         {
-            LOG_FUNC_SCOPE();
-            auto now = std::chrono::high_resolution_clock::now();
-            return std::chrono::duration_cast<std::chrono::microseconds>(now - m_capture_time_base).count();
+            return rs::utils::timebase::microseconds_since(m_capture_time_base);
         }
 
         std::vector<rs::core::file_types::device_cap> rs_device_ex::read_all_options()
@@ -470,12 +793,8 @@ namespace rs
             std::vector<file_types::device_cap> rv;
             try
             {
-                std::vector<rs_option> options;
-                for(int option = 0; option < rs_option::RS_OPTION_COUNT; option++)
-                {
-                    if(m_device->supports_option((rs_option)option))
-                        options.push_back((rs_option)option);
-                }
+                //the values are read at each start, the supported options are probed once per device
+                auto & options = get_device_snapshot()->supported_options;
                 std::vector<double> values(options.size());
                 m_device->get_options(options.data(), options.size(), values.data());
                 rv.resize(options.size());
@@ -494,19 +813,46 @@ namespace rs
         std::map<rs_camera_info, std::pair<uint32_t, const char*>> rs_device_ex::get_all_camera_info()
         {
             std::map<rs_camera_info, std::pair<uint32_t, const char*>> info_map;
-            for(int i=0; i< static_cast<int>(rs_camera_info::RS_CAMERA_INFO_COUNT); i++)
+            m_device_snapshot = get_device_snapshot();
+            for(auto & info : m_device_snapshot->camera_info)
+            {
+                uint32_t string_size = static_cast<uint32_t>(info.second.size()) + 1; //"+1" for the '\0' char
+                info_map.emplace(info.first, std::pair<uint32_t, const char*> {string_size, info.second.c_str()});
+            }
+            return info_map;
+        }
+
+        std::shared_ptr<const device_snapshot> rs_device_ex::get_device_snapshot()
+        {
+            //a firmware update may change the supported options, the snapshot is taken again for the new version
+            std::string key = std::string(m_device->get_serial()) + "/" + m_device->get_firmware_version();
+            {
+                std::lock_guard<std::mutex> guard(device_snapshots_mutex);
+                auto snapshot = device_snapshots.find(key);
+                if(snapshot != device_snapshots.end())
+                {
+                    return snapshot->second;
+                }
+            }
+
+            auto snapshot = std::make_shared<device_snapshot>();
+            for(int option = 0; option < rs_option::RS_OPTION_COUNT; option++)
+            {
+                if(m_device->supports_option((rs_option)option))
+                    snapshot->supported_options.push_back((rs_option)option);
+            }
+            for(int i = 0; i < static_cast<int>(rs_camera_info::RS_CAMERA_INFO_COUNT); i++)
             {
                 rs_camera_info cam_info_id = static_cast<rs_camera_info>(i);
-                if(m_device->supports(cam_info_id) == false)
+                if(m_device->supports(cam_info_id))
                 {
-                    continue;
+                    snapshot->camera_info[cam_info_id] = m_device->get_camera_info(cam_info_id);
                 }
-                const char* info = m_device->get_camera_info(cam_info_id);
-                uint32_t len = static_cast<uint32_t>(std::strlen(info));
-                uint32_t string_size = len + 1; //"+1" for the '\0' char
-                info_map.emplace(cam_info_id,  std::pair<uint32_t, const char*> {string_size, info});
             }
-            return info_map;
+
+            //devices of the same key which were snapshot concurrently share the first snapshot
+            std::lock_guard<std::mutex> guard(device_snapshots_mutex);
+            return device_snapshots.emplace(key, snapshot).first->second;
         }
 
         void rs_device_ex::write_frame(rs_stream stream, rs_frame_ref * ref)
@@ -520,8 +866,81 @@ namespace rs
             m_disk_write.record_sample(sample);
         }
 
+        void rs_device_ex::write_frame_copy(rs_stream stream, rs_frame_ref * ref)
+        {
+            auto slots = m_frame_slots.find(stream);
+            if(slots == m_frame_slots.end())
+            {
+                return;
+            }
+
+            file_types::frame_sample frame(stream, ref, get_capture_time());
+            auto transform = m_frame_transforms.find(stream);
+            if(transform != m_frame_transforms.end() && !transform->second->is_input_size(frame.finfo.width, frame.finfo.height))
+            {
+                m_disk_write.record_dropped_frame(stream, frame.finfo.number);
+                return;
+            }
+            size_t size = transform != m_frame_transforms.end() ? static_cast<size_t>(transform->second->query_stride()) * transform->second->query_height() :
+                                                                  static_cast<size_t>(frame.finfo.stride) * frame.finfo.height;
+            auto slot = slots->second->acquire(size);
+            if(!slot)
+            {
+                m_disk_write.record_dropped_frame(stream, frame.finfo.number);
+                return;
+            }
+            if(transform != m_frame_transforms.end())
+            {
+                transform->second->apply(frame.data, frame.finfo.stride, slot);
+                frame.finfo.width = transform->second->query_width();
+                frame.finfo.height = transform->second->query_height();
+                frame.finfo.stride = transform->second->query_stride();
+            }
+            else
+            {
+                memcpy(slot, frame.data, size);
+            }
+
+            auto frame_copy = new file_types::frame_sample(&frame);
+            frame_copy->data = slot;
+            auto stream_slots = slots->second;
+            std::shared_ptr<file_types::sample> sample = std::shared_ptr<file_types::sample>(frame_copy,
+                    [stream_slots](file_types::sample* f)
+            {
+                stream_slots->release(static_cast<file_types::frame_sample*>(f)->data);
+                delete f;
+            });
+            m_disk_write.record_sample(sample);
+        }
+
+        void rs_device_ex::write_motion_block_entry(const file_types::motion_block_entry & entry)
+        {
+            std::lock_guard<std::mutex> guard(m_motion_block_mutex);
+            if(!m_motion_block)
+            {
+                m_motion_block = std::make_shared<file_types::motion_block_sample>(entry.capture_time);
+            }
+            m_motion_block->entries[m_motion_block->count++] = entry;
+            if(m_motion_block->is_full())
+            {
+                std::shared_ptr<file_types::sample> sample = std::move(m_motion_block);
+                m_disk_write.record_sample(sample);
+            }
+        }
+
+        void rs_device_ex::flush_motion_block()
+        {
+            std::lock_guard<std::mutex> guard(m_motion_block_mutex);
+            if(m_motion_block)
+            {
+                std::shared_ptr<file_types::sample> sample = std::move(m_motion_block);
+                m_disk_write.record_sample(sample);
+            }
+        }
+
         void rs_device_ex::write_samples()
         {
+            flush_motion_block();
             auto capture_time = get_capture_time();
             for(auto it = m_active_streams.begin(); it != m_active_streams.end(); ++it)
             {
@@ -529,6 +948,22 @@ namespace rs
                 if(m_device->get_stream_interface(*it).get_frame_number() == 0) continue;
 #endif
                 file_types::frame_sample frame(*it, m_device->get_stream_interface(*it), capture_time);
+                std::vector<uint8_t> transformed;
+                auto transform = m_frame_transforms.find(*it);
+                if(transform != m_frame_transforms.end())
+                {
+                    if(!transform->second->is_input_size(frame.finfo.width, frame.finfo.height))
+                    {
+                        m_disk_write.record_dropped_frame(*it, frame.finfo.number);
+                        continue;
+                    }
+                    transformed.resize(static_cast<size_t>(transform->second->query_stride()) * transform->second->query_height());
+                    transform->second->apply(frame.data, frame.finfo.stride, transformed.data());
+                    frame.data = transformed.data();
+                    frame.finfo.width = transform->second->query_width();
+                    frame.finfo.height = transform->second->query_height();
+                    frame.finfo.stride = transform->second->query_stride();
+                }
                 std::shared_ptr<file_types::sample> sample = std::shared_ptr<file_types::sample>(frame.copy(),
                 [](file_types::sample* f) { delete[] (static_cast<file_types::frame_sample*>(f))->data; delete f;});
                 m_disk_write.record_sample(sample);
@@ -547,6 +982,19 @@ namespace rs
             config.m_capture_mode = m_capture_mode;
             config.m_camera_info = get_all_camera_info();
             config.m_compression_config = m_compression_config;
+            config.m_compression_codecs = m_compression_codecs;
+            config.m_format_extensions = m_format_extensions;
+            config.m_preallocated_seconds = m_preallocated_seconds;
+            config.m_max_segment_size = m_max_segment_size;
+            config.m_max_segment_seconds = m_max_segment_seconds;
+            config.m_stripe_directories = m_stripe_directories;
+            config.m_is_stream_data_files = m_is_stream_data_files;
+            config.m_preview_scale = m_preview_scale;
+            config.m_preview_interval = m_preview_interval;
+            config.m_change_threshold = m_change_threshold;
+            config.m_numa_node = m_numa_node;
+            config.m_pre_trigger_seconds = m_pre_trigger_seconds;
+            config.m_post_trigger_seconds = m_post_trigger_seconds;
             return m_disk_write.configure(config);
         }
 
@@ -572,6 +1020,9 @@ namespace rs
             {
                 auto& si = m_device->get_stream_interface(*it);
                 auto intr = si.get_intrinsics();
+                auto transform = m_frame_transforms.find(*it);
+                if(transform != m_frame_transforms.end())
+                    intr = transform->second->transform_intrinsics(intr);
                 file_types::frame_info fi = {intr.width, intr.height, si.get_format()};
                 fi.stream = *it;
                 fi.framerate = si.get_framerate();
@@ -582,6 +1033,8 @@ namespace rs
                 //save empty calibration data in case rectified intrinsics data is not valid
                 try {rect_intrinsics = si.get_rectified_intrinsics();}
                 catch(...) {LOG_WARN("failed to read rectified intrinsics of stream - " << *it);}
+                if(transform != m_frame_transforms.end() && rect_intrinsics.width > 0)
+                    rect_intrinsics = transform->second->transform_intrinsics(rect_intrinsics);
 
                 //save empty calibration data in case extrinsics data is not valid
                 try {extrinsics = si.get_extrinsics_to(m_device->get_stream_interface(rs_stream::RS_STREAM_DEPTH));}
@@ -637,5 +1090,87 @@ namespace rs
         {
             return ((rs_device_ex*)this)->get_compression((rs_stream)stream);
         }
+
+        status device::set_compression_codecs(uint32_t codecs)
+        {
+            return ((rs_device_ex*)this)->set_compression_codecs(codecs);
+        }
+
+        status device::set_format_extensions(uint32_t extensions)
+        {
+            return ((rs_device_ex*)this)->set_format_extensions(extensions);
+        }
+
+        status device::set_frame_copy_mode(frame_copy_mode mode, uint32_t frame_slots_count)
+        {
+            return ((rs_device_ex*)this)->set_frame_copy_mode(mode, frame_slots_count);
+        }
+
+        status device::set_numa_affinity(numa_affinity affinity, int32_t node)
+        {
+            return ((rs_device_ex*)this)->set_numa_affinity(affinity, node);
+        }
+
+        status device::set_file_preallocation(uint32_t preallocated_seconds)
+        {
+            return ((rs_device_ex*)this)->set_file_preallocation(preallocated_seconds);
+        }
+
+        status device::set_file_segmentation(uint64_t max_segment_size, uint32_t max_segment_seconds)
+        {
+            return ((rs_device_ex*)this)->set_file_segmentation(max_segment_size, max_segment_seconds);
+        }
+
+        status device::set_file_striping(const char ** stripe_directories, uint32_t stripes_count)
+        {
+            std::vector<std::string> directories;
+            for(uint32_t i = 0; i < stripes_count; i++)
+            {
+                if(stripe_directories == nullptr || stripe_directories[i] == nullptr)
+                    return status::status_invalid_argument;
+                directories.push_back(stripe_directories[i]);
+            }
+            return ((rs_device_ex*)this)->set_file_striping(directories);
+        }
+
+        status device::set_stream_data_files(bool enable)
+        {
+            return ((rs_device_ex*)this)->set_stream_data_files(enable);
+        }
+
+        status device::set_preview(uint32_t scale, uint32_t frames_interval)
+        {
+            return ((rs_device_ex*)this)->set_preview(scale, frames_interval);
+        }
+
+        status device::set_change_gate(uint32_t threshold)
+        {
+            return ((rs_device_ex*)this)->set_change_gate(threshold);
+        }
+
+        status device::set_stream_transform(rs::stream stream, const stream_transform & transform)
+        {
+            return ((rs_device_ex*)this)->set_stream_transform((rs_stream)stream, transform);
+        }
+
+        status device::set_pre_trigger_recording(uint32_t pre_trigger_seconds, uint32_t post_trigger_seconds)
+        {
+            return ((rs_device_ex*)this)->set_pre_trigger_recording(pre_trigger_seconds, post_trigger_seconds);
+        }
+
+        status device::trigger_recording()
+        {
+            return ((rs_device_ex*)this)->trigger_recording();
+        }
+
+        status device::query_recording_statistics(rs::stream stream, recording_statistics & statistics)
+        {
+            return ((rs_device_ex*)this)->query_recording_statistics((rs_stream)stream, statistics);
+        }
+
+        status device::query_recorder_statistics(recorder_statistics & statistics)
+        {
+            return ((rs_device_ex*)this)->query_recorder_statistics(statistics);
+        }
     }
 }
@@ -0,0 +1,97 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "rs/record/record_module.h"
+#include "include/record_module_impl.h"
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace record
+    {
+        record_module::record_module(const char * file_path):
+            m_pimpl(new record_module_impl(file_path))
+        {}
+
+        status record_module::enable_stream(stream_type stream)
+        {
+            return m_pimpl->enable_stream(stream);
+        }
+
+        status record_module::enable_motion(motion_type motion)
+        {
+            return m_pimpl->enable_motion(motion);
+        }
+
+        status record_module::set_compression(stream_type stream, compression_level compression_level)
+        {
+            return m_pimpl->set_compression(stream, compression_level);
+        }
+
+        status record_module::set_compression_codecs(uint32_t codecs)
+        {
+            return m_pimpl->set_compression_codecs(codecs);
+        }
+
+        status record_module::set_format_extensions(uint32_t extensions)
+        {
+            return m_pimpl->set_format_extensions(extensions);
+        }
+
+        status record_module::query_recording_statistics(stream_type stream, recording_statistics & statistics)
+        {
+            return m_pimpl->query_recording_statistics(stream, statistics);
+        }
+
+        int32_t record_module::query_module_uid()
+        {
+            return m_pimpl->query_module_uid();
+        }
+
+        status record_module::query_supported_module_config(int32_t idx, supported_module_config &supported_config)
+        {
+            return m_pimpl->query_supported_module_config(idx, supported_config);
+        }
+
+        status record_module::query_current_module_config(actual_module_config &module_config)
+        {
+            return m_pimpl->query_current_module_config(module_config);
+        }
+
+        status record_module::set_module_config(const actual_module_config &module_config)
+        {
+            return m_pimpl->set_module_config(module_config);
+        }
+
+        status record_module::process_sample_set(const correlated_sample_set& sample_set)
+        {
+            return m_pimpl->process_sample_set(sample_set);
+        }
+
+        status record_module::register_event_handler(video_module_interface::processing_event_handler *handler)
+        {
+            return m_pimpl->register_event_handler(handler);
+        }
+
+        status record_module::unregister_event_handler(video_module_interface::processing_event_handler *handler)
+        {
+            return m_pimpl->unregister_event_handler(handler);
+        }
+
+        status record_module::flush_resources()
+        {
+            return m_pimpl->flush_resources();
+        }
+
+        status record_module::reset_config()
+        {
+            return m_pimpl->reset_config();
+        }
+
+        record_module::~record_module()
+        {
+            delete m_pimpl;
+        }
+    }
+}
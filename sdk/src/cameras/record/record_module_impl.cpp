@@ -0,0 +1,557 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include "include/record_module_impl.h"
+#include "rs/utils/librealsense_conversion_utils.h"
+#include "rs/utils/log_utils.h"
+#include "rs/utils/numa_topology.h"
+
+using namespace rs::core;
+using namespace rs::utils;
+
+namespace
+{
+    //the images wait for the write thread while the camera streams, see disk_write::allow_sample
+    const uint32_t MAX_HELD_SAMPLE_SETS = 8;
+
+    //the pipeline doesn't report the depth units, the recording has the default depth units of the cameras
+    const float DEFAULT_DEPTH_SCALE = 0.001f;
+
+    //the synthetic streams are computed by the playback of the native streams
+    bool is_native_stream(stream_type stream)
+    {
+        return stream >= stream_type::depth && stream <= stream_type::fisheye;
+    }
+
+    rs_capabilities get_capability(rs_stream stream)
+    {
+        switch(stream)
+        {
+            case rs_stream::RS_STREAM_COLOR: return rs_capabilities::RS_CAPABILITIES_COLOR;
+            case rs_stream::RS_STREAM_DEPTH: return rs_capabilities::RS_CAPABILITIES_DEPTH;
+            case rs_stream::RS_STREAM_INFRARED: return rs_capabilities::RS_CAPABILITIES_INFRARED;
+            case rs_stream::RS_STREAM_INFRARED2: return rs_capabilities::RS_CAPABILITIES_INFRARED2;
+            case rs_stream::RS_STREAM_FISHEYE: return rs_capabilities::RS_CAPABILITIES_FISH_EYE;
+            default: return rs_capabilities::RS_CAPABILITIES_COUNT;
+        }
+    }
+
+    rs_stream to_rs_stream(stream_type stream)
+    {
+        return static_cast<rs_stream>(convert_stream_type(stream));
+    }
+
+    int get_bits_per_pixel(pixel_format format)
+    {
+        //get_pixel_size returns the size of a single coordinate
+        return (format == pixel_format::xyz32f ? 3 : 1) * get_pixel_size(format) * 8;
+    }
+
+    rs_intrinsics to_rs_intrinsics(const intrinsics & intrinsics)
+    {
+        rs_intrinsics rv = {};
+        rv.width = intrinsics.width;
+        rv.height = intrinsics.height;
+        rv.ppx = intrinsics.ppx;
+        rv.ppy = intrinsics.ppy;
+        rv.fx = intrinsics.fx;
+        rv.fy = intrinsics.fy;
+        rv.model = static_cast<rs_distortion>(intrinsics.model);
+        std::memcpy(rv.coeffs, intrinsics.coeffs, sizeof(rv.coeffs));
+        return rv;
+    }
+
+    rs_extrinsics to_rs_extrinsics(const extrinsics & extrinsics)
+    {
+        rs_extrinsics rv = {};
+        std::memcpy(rv.rotation, extrinsics.rotation, sizeof(rv.rotation));
+        std::memcpy(rv.translation, extrinsics.translation, sizeof(rv.translation));
+        return rv;
+    }
+
+    //the module config has the extrinsics from the depth to the stream, the recording has the extrinsics from the stream to the depth
+    rs_extrinsics to_rs_inverse_extrinsics(const extrinsics & extrinsics)
+    {
+        rs_extrinsics rv = {};
+        for(int column = 0; column < 3; column++)
+        {
+            for(int row = 0; row < 3; row++)
+            {
+                //the rotation is column major, its inverse is its transpose
+                rv.rotation[column * 3 + row] = extrinsics.rotation[row * 3 + column];
+            }
+        }
+        for(int row = 0; row < 3; row++)
+        {
+            for(int column = 0; column < 3; column++)
+            {
+                rv.translation[row] -= rv.rotation[column * 3 + row] * extrinsics.translation[column];
+            }
+        }
+        return rv;
+    }
+
+    rs_motion_device_intrinsic to_rs_motion_device_intrinsic(const motion_device_intrinsics & intrinsics)
+    {
+        rs_motion_device_intrinsic rv = {};
+        std::memcpy(rv.data, intrinsics.data, sizeof(rv.data));
+        std::memcpy(rv.noise_variances, intrinsics.noise_variances, sizeof(rv.noise_variances));
+        std::memcpy(rv.bias_variances, intrinsics.bias_variances, sizeof(rv.bias_variances));
+        return rv;
+    }
+}
+
+namespace rs
+{
+    namespace record
+    {
+        record_module_impl::record_module_impl(const char * file_path):
+            m_file_path(file_path ? file_path : ""),
+            m_enabled_streams(),
+            m_enabled_motions(),
+            m_compression_codecs(0),
+            m_format_extensions(0),
+            m_is_configured(false),
+            m_current_module_config({}),
+            m_disk_write(new disk_write()),
+            m_is_file_closed(false),
+            m_processing_handler(nullptr)
+        {
+            m_unique_module_id = CONSTRUCT_UID('R', 'C', 'R', 'D');
+        }
+
+        status record_module_impl::enable_stream(stream_type stream)
+        {
+            if(!is_native_stream(stream))
+            {
+                return status_invalid_argument;
+            }
+            std::lock_guard<std::mutex> lock(m_lock);
+            if(m_is_configured)
+            {
+                return status_invalid_state;
+            }
+            m_enabled_streams[static_cast<uint32_t>(stream)] = true;
+            return status_no_error;
+        }
+
+        status record_module_impl::enable_motion(motion_type motion)
+        {
+            if(motion < motion_type::accel || motion >= motion_type::max)
+            {
+                return status_invalid_argument;
+            }
+            std::lock_guard<std::mutex> lock(m_lock);
+            if(m_is_configured)
+            {
+                return status_invalid_state;
+            }
+            m_enabled_motions[static_cast<uint32_t>(motion)] = true;
+            return status_no_error;
+        }
+
+        status record_module_impl::set_compression(stream_type stream, compression_level level)
+        {
+            if(!is_native_stream(stream) || level < compression_level::disabled || level > compression_level::lossy)
+            {
+                return status_invalid_argument;
+            }
+            std::lock_guard<std::mutex> lock(m_lock);
+            if(m_is_configured)
+            {
+                return status_invalid_state;
+            }
+            m_compression_config[to_rs_stream(stream)] = level;
+            return status_no_error;
+        }
+
+        status record_module_impl::set_compression_codecs(uint32_t codecs)
+        {
+            if(codecs & ~ALL_COMPRESSION_CODECS)
+            {
+                return status_invalid_argument;
+            }
+            std::lock_guard<std::mutex> lock(m_lock);
+            if(m_is_configured)
+            {
+                return status_invalid_state;
+            }
+            m_compression_codecs = codecs;
+            return status_no_error;
+        }
+
+        status record_module_impl::set_format_extensions(uint32_t extensions)
+        {
+            if(extensions & ~ALL_FORMAT_EXTENSIONS)
+            {
+                return status_invalid_argument;
+            }
+            std::lock_guard<std::mutex> lock(m_lock);
+            if(m_is_configured)
+            {
+                return status_invalid_state;
+            }
+            m_format_extensions = extensions;
+            return status_no_error;
+        }
+
+        status record_module_impl::query_recording_statistics(stream_type stream, recording_statistics & statistics)
+        {
+            if(!is_native_stream(stream))
+            {
+                return status_invalid_argument;
+            }
+            std::lock_guard<std::mutex> lock(m_lock);
+            if(m_is_file_closed)
+            {
+                statistics = m_closed_file_statistics[to_rs_stream(stream)];
+                return status_no_error;
+            }
+            m_disk_write->query_recording_statistics(to_rs_stream(stream), statistics);
+            return status_no_error;
+        }
+
+        int32_t record_module_impl::query_module_uid()
+        {
+            return m_unique_module_id;
+        }
+
+        status record_module_impl::query_supported_module_config(int32_t idx, supported_module_config &supported_config)
+        {
+            if(idx != 0)
+            {
+                return status_item_unavailable;
+            }
+
+            supported_config = {};
+
+            //the recording takes a reference of the images until they are written, they aren't copied
+            supported_config.concurrent_samples_count = MAX_HELD_SAMPLE_SETS;
+            supported_config.samples_time_sync_mode = supported_module_config::time_sync_mode::time_synced_input_accepting_unmatch_samples;
+            supported_config.async_processing = false;
+
+            //the processing only queues the images for the write thread, the samples sets are recorded in order
+            supported_config.queue_policy = supported_module_config::samples_queue_policy::drop_newest;
+            supported_config.queue_depth = MAX_HELD_SAMPLE_SETS;
+
+            //no restriction to specific camera or streams resolution
+            std::memset(supported_config.device_name, 0, sizeof(supported_config.device_name));
+
+            std::lock_guard<std::mutex> lock(m_lock);
+            for(uint32_t i = 0; i < static_cast<uint32_t>(stream_type::max); i++)
+            {
+                supported_config.image_streams_configs[i].flags = sample_flags::none;
+                supported_config.image_streams_configs[i].is_enabled = m_enabled_streams[i];
+            }
+            for(uint32_t i = 0; i < static_cast<uint32_t>(motion_type::max); i++)
+            {
+                supported_config.motion_sensors_configs[i].flags = sample_flags::none;
+                supported_config.motion_sensors_configs[i].is_enabled = m_enabled_motions[i];
+            }
+            return status_no_error;
+        }
+
+        status record_module_impl::query_current_module_config(actual_module_config &module_config)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if(!m_is_configured)
+            {
+                return status_data_not_initialized;
+            }
+            module_config = m_current_module_config;
+            return status_no_error;
+        }
+
+        status record_module_impl::set_module_config(const actual_module_config &module_config)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            for(uint32_t i = 0; i < static_cast<uint32_t>(stream_type::max); i++)
+            {
+                if(m_enabled_streams[i] && !module_config.image_streams_configs[i].is_enabled)
+                {
+                    return status_param_unsupported;
+                }
+            }
+            for(uint32_t i = 0; i < static_cast<uint32_t>(motion_type::max); i++)
+            {
+                if(m_enabled_motions[i] && !module_config.motion_sensors_configs[i].is_enabled)
+                {
+                    return status_param_unsupported;
+                }
+            }
+
+            //a new configuration is recorded from its first samples set
+            m_disk_write.reset(new disk_write());
+            m_is_file_closed = false;
+            m_current_module_config = module_config;
+            m_is_configured = true;
+            return status_no_error;
+        }
+
+        status record_module_impl::process_sample_set(const correlated_sample_set & sample_set)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if(!m_is_configured)
+            {
+                return status_data_not_initialized;
+            }
+            //after the pipeline restarts, the file is recorded again from its first samples set
+            if(!m_disk_write->is_configured())
+            {
+                if(!is_sample_set_complete(sample_set))
+                {
+                    //the streams start at different times, the partial samples sets before the first complete one aren't recorded
+                    return status_no_error;
+                }
+                auto status = configure_disk_write(sample_set);
+                if(status < status_no_error)
+                {
+                    return status;
+                }
+            }
+
+            auto capture_time = get_capture_time();
+            for(uint32_t i = 0; i < static_cast<uint32_t>(stream_type::max); i++)
+            {
+                if(m_enabled_streams[i] && sample_set.images[i])
+                {
+                    record_image(sample_set.images[i], capture_time);
+                }
+            }
+            record_motions(sample_set, capture_time);
+            return status_no_error;
+        }
+
+        status record_module_impl::register_event_handler(video_module_interface::processing_event_handler *handler)
+        {
+            std::lock_guard<std::mutex> lock(m_processing_handler_lock);
+            if(m_processing_handler != nullptr)
+            {
+                return status_handle_invalid;
+            }
+            m_processing_handler = handler;
+            return status_no_error;
+        }
+
+        status record_module_impl::unregister_event_handler(video_module_interface::processing_event_handler *handler)
+        {
+            std::lock_guard<std::mutex> lock(m_processing_handler_lock);
+            if(m_processing_handler != handler)
+            {
+                return status_handle_invalid;
+            }
+            m_processing_handler = nullptr;
+            return status_no_error;
+        }
+
+        status record_module_impl::flush_resources()
+        {
+            //the pipeline stops, the file is closed and the images which weren't written are released before the device stops
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_disk_write->stop();
+            for(uint32_t i = 0; i < static_cast<uint32_t>(stream_type::max); i++)
+            {
+                if(m_enabled_streams[i])
+                {
+                    auto stream = to_rs_stream(static_cast<stream_type>(i));
+                    m_disk_write->query_recording_statistics(stream, m_closed_file_statistics[stream]);
+                }
+            }
+            m_disk_write.reset(new disk_write());
+            m_is_file_closed = true;
+            return status_no_error;
+        }
+
+        status record_module_impl::reset_config()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_disk_write.reset(new disk_write());
+            m_is_file_closed = false;
+            m_current_module_config = {};
+            m_is_configured = false;
+            return status_no_error;
+        }
+
+        bool record_module_impl::is_sample_set_complete(const correlated_sample_set & sample_set)
+        {
+            for(uint32_t i = 0; i < static_cast<uint32_t>(stream_type::max); i++)
+            {
+                if(m_enabled_streams[i] && !sample_set.images[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        status record_module_impl::configure_disk_write(const correlated_sample_set & sample_set)
+        {
+            configuration config = {};
+            config.m_file_path = m_file_path;
+            config.m_coordinate_system = file_types::coordinate_system::rear_default;
+            config.m_capture_mode = playback::capture_mode::asynced;
+            config.m_compression_config = m_compression_config;
+            config.m_compression_codecs = m_compression_codecs;
+            config.m_format_extensions = m_format_extensions;
+            config.m_numa_node = rs::utils::numa_topology::UNKNOWN_NODE;
+
+            //the strings of the module config outlive the configuration
+            auto & device_info = m_current_module_config.device_info;
+            auto add_camera_info = [&config](rs_camera_info id, const char * info, size_t max_size)
+            {
+                uint32_t string_size = static_cast<uint32_t>(strnlen(info, max_size - 1)) + 1; //"+1" for the '\0' char
+                config.m_camera_info.emplace(id, std::pair<uint32_t, const char*> {string_size, info});
+            };
+            add_camera_info(rs_camera_info::RS_CAMERA_INFO_DEVICE_NAME, device_info.name, sizeof(device_info.name));
+            add_camera_info(rs_camera_info::RS_CAMERA_INFO_DEVICE_SERIAL_NUMBER, device_info.serial, sizeof(device_info.serial));
+            add_camera_info(rs_camera_info::RS_CAMERA_INFO_CAMERA_FIRMWARE_VERSION, device_info.firmware, sizeof(device_info.firmware));
+
+            for(uint32_t i = 0; i < static_cast<uint32_t>(stream_type::max); i++)
+            {
+                if(!m_enabled_streams[i])
+                {
+                    continue;
+                }
+                auto stream = to_rs_stream(static_cast<stream_type>(i));
+                auto & stream_config = m_current_module_config.image_streams_configs[i];
+                auto info = sample_set.images[i]->query_info();
+
+                file_types::frame_info frame_info = {};
+                frame_info.width = info.width;
+                frame_info.height = info.height;
+                frame_info.format = static_cast<rs_format>(convert_pixel_format(info.format));
+                frame_info.stride = info.pitch;
+                frame_info.bpp = get_bits_per_pixel(info.format);
+                frame_info.stream = stream;
+                frame_info.framerate = static_cast<int>(stream_config.frame_rate);
+
+                file_types::stream_profile profile = {};
+                profile.info = frame_info;
+                profile.frame_rate = frame_info.framerate;
+                profile.intrinsics = to_rs_intrinsics(stream_config.intrinsics);
+                profile.extrinsics = to_rs_inverse_extrinsics(stream_config.extrinsics);
+                profile.depth_scale = stream == rs_stream::RS_STREAM_DEPTH ? DEFAULT_DEPTH_SCALE : 0;
+                profile.motion_extrinsics = to_rs_extrinsics(stream_config.extrinsics_motion);
+                config.m_stream_profiles[stream] = profile;
+
+                auto capability = get_capability(stream);
+                if(capability != rs_capabilities::RS_CAPABILITIES_COUNT)
+                {
+                    config.m_capabilities.push_back(capability);
+                }
+            }
+
+            auto & accel_config = m_current_module_config[motion_type::accel];
+            auto & gyro_config = m_current_module_config[motion_type::gyro];
+            if(m_enabled_motions[static_cast<uint32_t>(motion_type::accel)] || m_enabled_motions[static_cast<uint32_t>(motion_type::gyro)])
+            {
+                config.m_capabilities.push_back(rs_capabilities::RS_CAPABILITIES_MOTION_EVENTS);
+            }
+            config.m_motion_intrinsics.acc = to_rs_motion_device_intrinsic(accel_config.intrinsics);
+            config.m_motion_intrinsics.gyro = to_rs_motion_device_intrinsic(gyro_config.intrinsics);
+
+            auto status = m_disk_write->configure(config);
+            if(status < status_no_error)
+            {
+                LOG_ERROR("failed to configure the recording of " << m_file_path.c_str() << ", status - " << status);
+                return status;
+            }
+            m_capture_time_base = rs::utils::timebase::now();
+            if(!m_disk_write->start())
+            {
+                return status_exec_aborted;
+            }
+            m_is_file_closed = false;
+            return status_no_error;
+        }
+
+        void record_module_impl::record_image(image_interface * image, uint64_t capture_time)
+        {
+            auto info = image->query_info();
+            auto & stream_config = m_current_module_config[image->query_stream_type()];
+
+            file_types::frame_info frame_info = {};
+            frame_info.width = info.width;
+            frame_info.height = info.height;
+            frame_info.format = static_cast<rs_format>(convert_pixel_format(info.format));
+            frame_info.stride = info.pitch;
+            frame_info.bpp = get_bits_per_pixel(info.format);
+            frame_info.stream = to_rs_stream(image->query_stream_type());
+            frame_info.number = image->query_frame_number();
+            frame_info.time_stamp = image->query_time_stamp();
+            frame_info.system_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch()).count();
+            frame_info.framerate = static_cast<int>(stream_config.frame_rate);
+            frame_info.time_stamp_domain = static_cast<rs_timestamp_domain>(convert_timestamp_domain(image->query_time_stamp_domain()));
+
+            //the sample references the image instead of a copy, the image is released once it's written or dropped
+            auto frame = new file_types::frame_sample(frame_info, capture_time);
+            frame->data = static_cast<const uint8_t *>(image->query_data());
+            image->add_ref();
+            std::shared_ptr<file_types::sample> sample(frame, [image](file_types::sample * f)
+            {
+                image->release();
+                delete f;
+            });
+            m_disk_write->record_sample(sample);
+        }
+
+        void record_module_impl::record_motions(const correlated_sample_set & sample_set, uint64_t capture_time)
+        {
+            std::shared_ptr<file_types::motion_block_sample> block;
+            for(uint32_t i = 0; i < static_cast<uint32_t>(motion_type::max); i++)
+            {
+                if(!m_enabled_motions[i])
+                {
+                    continue;
+                }
+
+                //the batch holds the motion samples since the previous samples set, without a batch only the latest sample is recorded
+                const motion_sample * samples = nullptr;
+                uint32_t count = sample_set.get_motion_batch(static_cast<motion_type>(i), &samples);
+                if(!samples)
+                {
+                    samples = &sample_set.motion_samples[i];
+                    count = samples->timestamp != 0 ? 1 : 0;
+                }
+
+                for(uint32_t j = 0; j < count; j++)
+                {
+                    if(!block)
+                    {
+                        block = std::make_shared<file_types::motion_block_sample>(capture_time);
+                    }
+                    file_types::motion_block_entry entry = {};
+                    entry.type = file_types::sample_type::st_motion;
+                    entry.capture_time = capture_time;
+                    entry.data.motion.timestamp_data.timestamp = samples[j].timestamp;
+                    entry.data.motion.timestamp_data.source_id = static_cast<rs_event_source>(convert_motion_type(samples[j].type));
+                    entry.data.motion.timestamp_data.frame_number = samples[j].frame_number;
+                    entry.data.motion.is_valid = 1;
+                    std::memcpy(entry.data.motion.axes, samples[j].data, sizeof(entry.data.motion.axes));
+                    block->entries[block->count++] = entry;
+                    if(block->is_full())
+                    {
+                        std::shared_ptr<file_types::sample> sample = std::move(block);
+                        m_disk_write->record_sample(sample);
+                    }
+                }
+            }
+            if(block)
+            {
+                std::shared_ptr<file_types::sample> sample = std::move(block);
+                m_disk_write->record_sample(sample);
+            }
+        }
+
+        uint64_t record_module_impl::get_capture_time()
+        {
+            return rs::utils::timebase::microseconds_since(m_capture_time_base);
+        }
+
+        record_module_impl::~record_module_impl()
+        {
+        }
+    }
+}
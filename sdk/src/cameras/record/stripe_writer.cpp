@@ -0,0 +1,145 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "stripe_writer.h"
+#include "rs/utils/log_utils.h"
+#include "rs/utils/thread_config.h"
+#include "rs/utils/thread_profiler.h"
+#include "rs/utils/numa_topology.h"
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace record
+    {
+        static const size_t STRIPE_BUFFER_SIZE = 16 * 1024 * 1024;
+        //the recording thread waits for the stripe once it's a few buffers behind, instead of holding the stripe data in memory
+        static const size_t MAX_SUBMITTED_BUFFERS = 4;
+
+        stripe_writer::stripe_writer(std::unique_ptr<core::file> file, int32_t numa_node) :
+            m_file(std::move(file)),
+            m_position(0),
+            m_is_writing(false),
+            m_stop(false),
+            m_failed(false),
+            m_numa_node(numa_node)
+        {
+            m_staged_buffer.reserve(STRIPE_BUFFER_SIZE);
+            m_thread = std::thread(&stripe_writer::write_thread, this);
+        }
+
+        stripe_writer::~stripe_writer()
+        {
+            close();
+        }
+
+        uint64_t stripe_writer::append(const void * header, uint32_t header_size, const void * data, uint32_t data_size)
+        {
+            if(m_staged_buffer.size() + header_size + data_size > STRIPE_BUFFER_SIZE)
+                submit();
+            auto header_bytes = static_cast<const uint8_t *>(header);
+            auto data_bytes = static_cast<const uint8_t *>(data);
+            m_staged_buffer.insert(m_staged_buffer.end(), header_bytes, header_bytes + header_size);
+            m_staged_buffer.insert(m_staged_buffer.end(), data_bytes, data_bytes + data_size);
+            auto offset = m_position;
+            m_position += header_size + data_size;
+            return offset;
+        }
+
+        void stripe_writer::submit()
+        {
+            if(m_staged_buffer.empty())
+                return;
+            std::unique_lock<std::mutex> guard(m_mutex);
+            m_cv.wait(guard, [this]() { return m_failed || m_submitted_buffers.size() < MAX_SUBMITTED_BUFFERS; });
+            m_submitted_buffers.push_back(std::move(m_staged_buffer));
+            if(m_free_buffers.empty())
+            {
+                m_staged_buffer = std::vector<uint8_t>();
+                m_staged_buffer.reserve(STRIPE_BUFFER_SIZE);
+            }
+            else
+            {
+                m_staged_buffer = std::move(m_free_buffers.back());
+                m_free_buffers.pop_back();
+            }
+            m_cv.notify_all();
+        }
+
+        bool stripe_writer::flush()
+        {
+            submit();
+            std::unique_lock<std::mutex> guard(m_mutex);
+            m_cv.wait(guard, [this]() { return m_failed || (m_submitted_buffers.empty() && !m_is_writing); });
+            if(!m_failed && m_file->flush() != status_no_error)
+                m_failed = true;
+            return !m_failed;
+        }
+
+        void stripe_writer::close()
+        {
+            if(!m_thread.joinable())
+                return;
+            submit();
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                m_stop = true;
+                m_cv.notify_all();
+            }
+            m_thread.join();
+            if(m_file->close() != status_no_error)
+                m_failed = true;
+        }
+
+        bool stripe_writer::is_good() const
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            return !m_failed;
+        }
+
+        void stripe_writer::write_thread()
+        {
+            rs::utils::thread_configuration::apply(rs::utils::thread_role::recording, "rs-record-strp");
+            rs::utils::numa_topology::bind_thread(m_numa_node, rs::utils::thread_role::recording);
+            //the stripe threads are counted with the recording threads
+            rs::utils::thread_profiler profiler(rs::utils::thread_role::recording);
+            profiler.start();
+            std::unique_lock<std::mutex> guard(m_mutex);
+            for(;;)
+            {
+                //the submitted buffers are written before the thread stops
+                {
+                    rs::utils::thread_profiler::wait_scope input_wait(profiler, rs::utils::thread_wait::input);
+                    m_cv.wait(guard, [this]() { return m_stop || !m_submitted_buffers.empty(); });
+                }
+                if(m_submitted_buffers.empty())
+                {
+                    profiler.stop();
+                    return;
+                }
+                auto buffer = std::move(m_submitted_buffers.front());
+                m_submitted_buffers.pop_front();
+                m_is_writing = true;
+                guard.unlock();
+
+                uint32_t bytes_written = 0;
+                bool failed = false;
+                {
+                    rs::utils::thread_profiler::wait_scope io_wait(profiler, rs::utils::thread_wait::io);
+                    failed = m_file->write_bytes(buffer.data(), static_cast<unsigned int>(buffer.size()), bytes_written) != status_no_error;
+                }
+                if(failed)
+                    LOG_ERROR("failed writing to stripe file");
+                buffer.clear();
+                profiler.add_processed_items();
+
+                guard.lock();
+                m_is_writing = false;
+                m_failed = m_failed || failed;
+                m_free_buffers.push_back(std::move(buffer));
+                m_cv.notify_all();
+            }
+        }
+    }
+}
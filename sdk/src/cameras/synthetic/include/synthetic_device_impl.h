@@ -0,0 +1,210 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <librealsense/rs.hpp>
+#include <librealsense/rscore.hpp>
+#include "rs/synthetic/synthetic_device.h"
+
+#ifdef WIN32
+#ifdef realsense_synthetic_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_synthetic_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace synthetic
+    {
+        //a generated image, the data is the stream scene, which is shared by all the stream images
+        struct synthetic_frame
+        {
+            rs_stream                                   stream;
+            stream_mode                                 mode;
+            int                                         bpp;
+            unsigned long long                          number;
+            double                                      time_stamp;
+            long long                                   system_time;
+            std::shared_ptr<const std::vector<uint8_t>> data;
+        };
+
+        class rs_frame_ref_synthetic : public rs_frame_ref
+        {
+        public:
+            rs_frame_ref_synthetic(std::shared_ptr<synthetic_frame> frame) : m_frame(frame) {}
+            virtual const uint8_t *get_frame_data() const override { return m_frame->data->data(); }
+            virtual double get_frame_timestamp() const override { return m_frame->time_stamp; }
+            virtual unsigned long long get_frame_number() const override { return m_frame->number; }
+            virtual long long get_frame_system_time() const override { return m_frame->system_time; }
+            virtual int get_frame_width() const override { return m_frame->mode.width; }
+            virtual int get_frame_height() const override { return m_frame->mode.height; }
+            virtual int get_frame_framerate() const override { return m_frame->mode.framerate; }
+            virtual int get_frame_stride() const override { return m_frame->mode.width * m_frame->bpp; }
+            virtual int get_frame_bpp() const override { return m_frame->bpp; }
+            virtual rs_format get_frame_format() const override { return static_cast<rs_format>(m_frame->mode.format); }
+            virtual rs_stream get_stream_type() const override { return m_frame->stream; }
+            virtual rs_timestamp_domain get_frame_timestamp_domain() const { return rs_timestamp_domain::RS_TIMESTAMP_DOMAIN_CAMERA; }
+            virtual double get_frame_metadata(rs_frame_metadata frame_metadata) const override { throw std::runtime_error("synthetic frames have no metadata"); }
+            virtual bool supports_frame_metadata(rs_frame_metadata frame_metadata) const override { return false; }
+        private:
+            std::shared_ptr<synthetic_frame> m_frame;
+        };
+
+        class synthetic_stream : public rs_stream_interface
+        {
+        public:
+            synthetic_stream(rs_stream stream, const std::vector<stream_mode> & modes);
+            void enable(const stream_mode & mode);
+            void disable() { m_is_enabled = false; }
+            const stream_mode & get_enabled_mode() const { return m_enabled_mode; }
+            int get_enabled_bpp() const { return m_enabled_bpp; }
+            //the image data of the enabled mode, generated once per mode
+            std::shared_ptr<const std::vector<uint8_t>> get_scene();
+            void set_frame(std::shared_ptr<synthetic_frame> frame) { m_frame = frame; }
+            void clear_data() { m_frame.reset(); }
+
+            virtual rs_extrinsics get_extrinsics_to(const rs_stream_interface &r) const override;
+            virtual float get_depth_scale() const override { return DEPTH_SCALE; }
+            virtual rs_intrinsics get_intrinsics() const override;
+            virtual rs_intrinsics get_rectified_intrinsics() const override { return get_intrinsics(); }
+            virtual rs_format get_format() const override { return static_cast<rs_format>(m_enabled_mode.format); }
+            virtual int get_framerate() const override { return m_enabled_mode.framerate; }
+            virtual double get_frame_metadata(rs_frame_metadata frame_metadata) const override { throw std::runtime_error("synthetic frames have no metadata"); }
+            virtual bool supports_frame_metadata(rs_frame_metadata frame_metadata) const override { return false; }
+            virtual unsigned long long get_frame_number() const override { return m_frame ? m_frame->number : 0; }
+            virtual long long get_frame_system_time() const override { return m_frame ? m_frame->system_time : 0; }
+            virtual const uint8_t *get_frame_data() const override { return m_frame ? m_frame->data->data() : nullptr; }
+            virtual int get_mode_count() const override { return static_cast<int>(m_modes.size()); }
+            virtual double get_frame_timestamp() const override { return m_frame ? m_frame->time_stamp : 0; }
+            virtual void get_mode(int mode, int *w, int *h, rs_format *f, int *fps) const override;
+            virtual bool is_enabled() const override { return m_is_enabled; }
+            virtual bool has_data() const { return m_frame ? true : false; }
+            virtual rs_stream get_stream_type() const { return m_stream; }
+            virtual int get_frame_stride() const { return m_frame ? m_frame->mode.width * m_frame->bpp : 0; }
+            virtual int get_frame_bpp() const { return m_frame ? m_frame->bpp : 0; }
+
+            //the bytes per pixel of the formats the device generates, 0 for other formats
+            static int get_bpp(rs_format format);
+            //the position of the stream camera relative to the depth camera, in meters
+            static float get_offset(rs_stream stream);
+
+            static constexpr float DEPTH_SCALE = 0.001f;
+        private:
+            rs_stream                                   m_stream;
+            std::vector<stream_mode>                    m_modes;
+            bool                                        m_is_enabled;
+            stream_mode                                 m_enabled_mode;
+            int                                         m_enabled_bpp;
+            std::shared_ptr<const std::vector<uint8_t>> m_scene;
+            std::shared_ptr<synthetic_frame>            m_frame;
+        };
+
+        struct stream_generator
+        {
+            stream_generator() : active_frames_count(0), generated_frames_count(0), dropped_frames_count(0), has_new_frame(false) {}
+            std::thread                         thread;
+            std::shared_ptr<rs_frame_callback>  callback;
+            std::mutex                          mutex;
+            std::condition_variable             frame_released_cv;
+            uint32_t                            active_frames_count;
+            std::atomic<uint64_t>               generated_frames_count;
+            std::atomic<uint64_t>               dropped_frames_count;
+            std::shared_ptr<synthetic_frame>    new_frame;         //the latest frame of a stream without a callback, waiting for wait_for_frames
+            bool                                has_new_frame;
+        };
+
+        class DLL_EXPORT rs_device_synthetic : public rs_device
+        {
+        public:
+            rs_device_synthetic(const device_configuration & configuration);
+            virtual ~rs_device_synthetic();
+            virtual const rs_stream_interface &     get_stream_interface(rs_stream stream) const override;
+            virtual const char *                    get_name() const override;
+            virtual const char *                    get_serial() const override;
+            virtual const char *                    get_firmware_version() const override;
+            virtual float                           get_depth_scale() const override;
+            virtual void                            enable_stream(rs_stream stream, int width, int height, rs_format format, int fps, rs_output_buffer_format output) override;
+            virtual void                            enable_stream_preset(rs_stream stream, rs_preset preset) override;
+            virtual void                            disable_stream(rs_stream stream) override;
+            virtual void                            enable_motion_tracking() override;
+            virtual void                            set_stream_callback(rs_stream stream, void(*on_frame)(rs_device * device, rs_frame_ref * frame, void * user), void * user) override;
+            virtual void                            set_stream_callback(rs_stream stream, rs_frame_callback * callback) override;
+            virtual void                            disable_motion_tracking() override;
+            virtual void                            set_motion_callback(void(*on_event)(rs_device * device, rs_motion_data data, void * user), void * user) override;
+            virtual void                            set_motion_callback(rs_motion_callback * callback) override;
+            virtual void                            set_timestamp_callback(void(*on_event)(rs_device * device, rs_timestamp_data data, void * user), void * user) override;
+            virtual void                            set_timestamp_callback(rs_timestamp_callback * callback) override;
+            virtual void                            start(rs_source source) override;
+            virtual void                            stop(rs_source source) override;
+            virtual bool                            is_capturing() const override;
+            virtual int                             is_motion_tracking_active() const override;
+            virtual void                            wait_all_streams() override;
+            virtual bool                            poll_all_streams() override;
+            virtual bool                            supports(rs_capabilities capability) const override;
+            virtual bool                            supports(rs_camera_info info_param) const override;
+            virtual bool                            supports_option(rs_option option) const override;
+            virtual void                            get_option_range(rs_option option, double & min, double & max, double & step, double & def) override;
+            virtual void                            set_options(const rs_option options[], size_t count, const double values[]) override;
+            virtual void                            get_options(const rs_option options[], size_t count, double values[]) override;
+            virtual void                            release_frame(rs_frame_ref * ref) override;
+            virtual rs_frame_ref *                  clone_frame(rs_frame_ref * frame) override;
+            virtual const char *                    get_usb_port_id() const;
+
+            virtual const char *                    get_camera_info(rs_camera_info info_type) const;
+            virtual rs_motion_intrinsics            get_motion_intrinsics() const;
+            virtual rs_extrinsics                   get_motion_extrinsics_from(rs_stream from) const;
+            virtual void                            start_fw_logger(char fw_log_op_code, int grab_rate_in_ms, std::timed_mutex &mutex);
+            virtual void                            stop_fw_logger();
+            virtual const char *                    get_option_description(rs_option option) const;
+
+            bool                                    set_real_time(bool realtime);
+            bool                                    is_real_time() const { return m_configuration.real_time; }
+            bool                                    set_max_jitter(double max_jitter);
+            uint64_t                                get_generated_frames_count(rs_stream stream);
+            uint64_t                                get_dropped_frames_count(rs_stream stream);
+
+        private:
+            void                                    start_video();
+            void                                    stop_video();
+            void                                    start_motion();
+            void                                    stop_motion();
+            void                                    stream_thread(rs_stream stream);
+            void                                    motion_thread();
+            void                                    deliver_frame(rs_stream stream, std::shared_ptr<synthetic_frame> frame);
+            double                                  query_jitter(rs_stream stream, unsigned long long frame_index) const;
+            bool                                    is_any_callback_set() const;
+            bool                                    all_streams_available() const;
+            bool                                    wait_for_active_frames();
+            template<typename predicate> bool       wait_until(std::chrono::steady_clock::time_point time, predicate stop_waiting);
+
+            device_configuration                                    m_configuration;
+            std::map<rs_camera_info, std::string>                   m_camera_info;
+            std::vector<std::unique_ptr<synthetic_stream>>          m_streams;
+            std::map<rs_stream, stream_generator>                   m_generators;
+            std::shared_ptr<rs_motion_callback>                     m_motion_callback;
+            std::shared_ptr<rs_timestamp_callback>                  m_timestamp_callback;
+            bool                                                    m_is_motion_tracking_enabled;
+            std::atomic<bool>                                       m_is_video_streaming;
+            std::atomic<bool>                                       m_is_motion_streaming;
+            std::chrono::steady_clock::time_point                   m_start_time;
+            std::thread                                             m_motion_thread;
+            std::mutex                                              m_streaming_mutex;      //guards the wake up of the generators sleep and the frames waiting for wait_for_frames
+            std::condition_variable                                 m_streaming_cv;
+            std::mutex                                              m_events_mutex;         //serializes the motion and time stamp callbacks of the generators
+        };
+    }
+}
@@ -0,0 +1,36 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <memory>
+#include "rs/synthetic/synthetic_context.h"
+#include "synthetic_device_impl.h"
+
+namespace rs
+{
+    namespace synthetic
+    {
+        context::context() : context(device_configuration()) {}
+
+        context::context(const device_configuration & configuration) : m_device(new rs_device_synthetic(configuration)) {}
+
+        context::~context()
+        {
+            delete m_device;
+        }
+
+        int context::get_device_count() const
+        {
+            return 1;
+        }
+
+        rs::device * context::get_device(int index)
+        {
+            return (rs::device*)get_synthetic_device();
+        }
+
+        device * context::get_synthetic_device()
+        {
+            return (device*)m_device;
+        }
+    }
+}
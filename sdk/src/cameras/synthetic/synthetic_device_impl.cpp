@@ -0,0 +1,913 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#ifdef WIN32
+#define NOMINMAX
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include "synthetic_device_impl.h"
+#include "rs/utils/log_utils.h"
+
+using namespace std::chrono;
+
+namespace rs
+{
+    namespace synthetic
+    {
+        class frame_callback : public rs_frame_callback
+        {
+            void(*fptr)(rs_device * dev, rs_frame_ref * frame, void * user);
+            void * user;
+            rs_device * device;
+        public:
+            frame_callback(rs_device * dev, void(*on_frame)(rs_device *, rs_frame_ref *, void *), void * user) : fptr(on_frame), user(user), device(dev) {}
+
+            void on_frame (rs_device * device, rs_frame_ref * frame) override
+            {
+                if (fptr)
+                {
+                    try { fptr(device, frame, user); }
+                    catch (...) {}
+                }
+            }
+            void release() override { delete this; }
+        };
+
+        class motion_events_callback : public rs_motion_callback
+        {
+            void(*fptr)(rs_device * dev, rs_motion_data data, void * user);
+            void        * user;
+            rs_device   * device;
+        public:
+            motion_events_callback(rs_device * dev, void(*fptr)(rs_device *, rs_motion_data, void *), void * user) : fptr(fptr), user(user), device(dev) {}
+
+            void on_event(rs_motion_data data) override
+            {
+                if (fptr)
+                {
+                    try { fptr(device, data, user); }
+                    catch (...) {}
+                }
+            }
+            void release() override { delete this; }
+        };
+
+        class timestamp_events_callback : public rs_timestamp_callback
+        {
+            void(*fptr)(rs_device * dev, rs_timestamp_data data, void * user);
+            void        * user;
+            rs_device   * device;
+        public:
+            timestamp_events_callback(rs_device * dev, void(*fptr)(rs_device *, rs_timestamp_data, void *), void * user) : fptr(fptr), user(user), device(dev) {}
+
+            void on_event(rs_timestamp_data data) override
+            {
+                if (fptr)
+                {
+                    try { fptr(device, data, user); }
+                    catch (...) {}
+                }
+            }
+            void release() override { delete this; }
+        };
+
+        device_configuration::device_configuration() :
+            motion_rate(200),
+            max_jitter(0),
+            seed(0),
+            real_time(true)
+        {
+            //the common modes of the ZR300 camera, and the depth mode of the pipeline default configuration
+            modes[rs::stream::depth] = { {480, 360, rs::format::z16, 30}, {480, 360, rs::format::z16, 60}, {628, 468, rs::format::z16, 30},
+                                         {640, 480, rs::format::z16, 30} };
+            modes[rs::stream::color] = { {640, 480, rs::format::rgb8, 30}, {640, 480, rs::format::rgb8, 60}, {640, 480, rs::format::bgr8, 30},
+                                         {640, 480, rs::format::rgba8, 30}, {1920, 1080, rs::format::rgb8, 30} };
+            modes[rs::stream::infrared] = { {480, 360, rs::format::y8, 30}, {480, 360, rs::format::y8, 60}, {480, 360, rs::format::y16, 30} };
+            modes[rs::stream::infrared2] = { {480, 360, rs::format::y8, 30}, {480, 360, rs::format::y8, 60}, {480, 360, rs::format::y16, 30} };
+            modes[rs::stream::fisheye] = { {640, 480, rs::format::raw8, 30}, {640, 480, rs::format::raw8, 60} };
+        }
+
+        synthetic_stream::synthetic_stream(rs_stream stream, const std::vector<stream_mode> & modes) :
+            m_stream(stream),
+            m_modes(modes),
+            m_is_enabled(false),
+            m_enabled_mode({0, 0, rs::format::any, 0}),
+            m_enabled_bpp(0)
+        {
+
+        }
+
+        void synthetic_stream::enable(const stream_mode & mode)
+        {
+            if(m_enabled_mode.width != mode.width || m_enabled_mode.height != mode.height || m_enabled_mode.format != mode.format)
+                m_scene.reset();
+            m_enabled_mode = mode;
+            m_enabled_bpp = get_bpp(static_cast<rs_format>(mode.format));
+            m_is_enabled = true;
+        }
+
+        std::shared_ptr<const std::vector<uint8_t>> synthetic_stream::get_scene()
+        {
+            if(m_scene)
+                return m_scene;
+
+            auto width = m_enabled_mode.width;
+            auto height = m_enabled_mode.height;
+            auto scene = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(width) * height * m_enabled_bpp);
+            auto format = static_cast<rs_format>(m_enabled_mode.format);
+            if(format == RS_FORMAT_Z16 || format == RS_FORMAT_DISPARITY16)
+            {
+                //a tilted wall at 1.5 to 2.5 meters, with a box at 0.8 meter in the image center
+                auto depth = reinterpret_cast<uint16_t*>(scene->data());
+                for(int y = 0; y < height; y++)
+                {
+                    for(int x = 0; x < width; x++)
+                    {
+                        bool is_box = std::abs(x - width / 2) < width / 6 && std::abs(y - height / 2) < height / 6;
+                        depth[y * width + x] = static_cast<uint16_t>(is_box ? 800 : 1500 + 1000 * x / width);
+                    }
+                }
+            }
+            else
+            {
+                //a diagonal gradient, yuyv chroma is kept neutral
+                for(int y = 0; y < height; y++)
+                {
+                    auto line = scene->data() + static_cast<size_t>(y) * width * m_enabled_bpp;
+                    for(int x = 0; x < width; x++)
+                    {
+                        for(int c = 0; c < m_enabled_bpp; c++)
+                        {
+                            uint8_t value = static_cast<uint8_t>((x + y + c * 64) & 0xff);
+                            if(format == RS_FORMAT_YUYV && c == 1)
+                                value = 128;
+                            line[x * m_enabled_bpp + c] = value;
+                        }
+                    }
+                }
+            }
+            m_scene = scene;
+            return m_scene;
+        }
+
+        rs_extrinsics synthetic_stream::get_extrinsics_to(const rs_stream_interface &r) const
+        {
+            //the cameras are parallel, placed along the x axis
+            rs_extrinsics extrinsics = {{1, 0, 0, 0, 1, 0, 0, 0, 1}, {0, 0, 0}};
+            extrinsics.translation[0] = get_offset(r.get_stream_type()) - get_offset(m_stream);
+            return extrinsics;
+        }
+
+        rs_intrinsics synthetic_stream::get_intrinsics() const
+        {
+            rs_intrinsics intrinsics = {};
+            intrinsics.width = m_enabled_mode.width;
+            intrinsics.height = m_enabled_mode.height;
+            intrinsics.ppx = static_cast<float>(m_enabled_mode.width) / 2.0f;
+            intrinsics.ppy = static_cast<float>(m_enabled_mode.height) / 2.0f;
+            intrinsics.fx = static_cast<float>(m_enabled_mode.width) * 0.9f;
+            intrinsics.fy = static_cast<float>(m_enabled_mode.width) * 0.9f;
+            intrinsics.model = RS_DISTORTION_NONE;
+            return intrinsics;
+        }
+
+        void synthetic_stream::get_mode(int mode, int *w, int *h, rs_format *f, int *fps) const
+        {
+            if(mode < 0 || mode >= static_cast<int>(m_modes.size()))
+                throw std::runtime_error("mode index is out of range");
+            *w = m_modes[mode].width;
+            *h = m_modes[mode].height;
+            *f = static_cast<rs_format>(m_modes[mode].format);
+            *fps = m_modes[mode].framerate;
+        }
+
+        int synthetic_stream::get_bpp(rs_format format)
+        {
+            switch(format)
+            {
+                case RS_FORMAT_Z16:
+                case RS_FORMAT_DISPARITY16:
+                case RS_FORMAT_Y16:
+                case RS_FORMAT_YUYV:
+                case RS_FORMAT_RAW16: return 2;
+                case RS_FORMAT_RGB8:
+                case RS_FORMAT_BGR8: return 3;
+                case RS_FORMAT_RGBA8:
+                case RS_FORMAT_BGRA8: return 4;
+                case RS_FORMAT_Y8:
+                case RS_FORMAT_RAW8: return 1;
+                default: return 0;
+            }
+        }
+
+        float synthetic_stream::get_offset(rs_stream stream)
+        {
+            switch(stream)
+            {
+                case RS_STREAM_COLOR: return 0.025f;
+                case RS_STREAM_INFRARED2: return 0.07f;
+                case RS_STREAM_FISHEYE: return -0.03f;
+                default: return 0;
+            }
+        }
+
+        //waits for the given time, returns false when the stop condition was met first
+        template<typename predicate>
+        bool rs_device_synthetic::wait_until(steady_clock::time_point time, predicate stop_waiting)
+        {
+            std::unique_lock<std::mutex> guard(m_streaming_mutex);
+            return !m_streaming_cv.wait_until(guard, time, stop_waiting);
+        }
+
+        rs_device_synthetic::rs_device_synthetic(const device_configuration & configuration) :
+            m_configuration(configuration),
+            m_is_motion_tracking_enabled(false),
+            m_is_video_streaming(false),
+            m_is_motion_streaming(false)
+        {
+            for(auto & modes : m_configuration.modes)
+            {
+                for(auto & mode : modes.second)
+                {
+                    if(synthetic_stream::get_bpp(static_cast<rs_format>(mode.format)) == 0 || mode.width <= 0 || mode.height <= 0 || mode.framerate <= 0)
+                    {
+                        LOG_ERROR("unsupported synthetic mode, stream - " << static_cast<int>(modes.first) << " ,format - " << static_cast<int>(mode.format));
+                        throw std::runtime_error("unsupported synthetic stream mode");
+                    }
+                }
+            }
+            for(int stream = 0; stream < RS_STREAM_COUNT; stream++)
+            {
+                auto modes = m_configuration.modes.find(static_cast<rs::stream>(stream));
+                m_streams.push_back(std::unique_ptr<synthetic_stream>(new synthetic_stream(static_cast<rs_stream>(stream),
+                    modes != m_configuration.modes.end() ? modes->second : std::vector<stream_mode>())));
+            }
+            m_camera_info[RS_CAMERA_INFO_DEVICE_NAME] = "Intel RealSense ZR300 (synthetic)";
+            m_camera_info[RS_CAMERA_INFO_DEVICE_SERIAL_NUMBER] = "0000000000";
+            m_camera_info[RS_CAMERA_INFO_CAMERA_FIRMWARE_VERSION] = "0.0.0.0";
+        }
+
+        rs_device_synthetic::~rs_device_synthetic()
+        {
+            try
+            {
+                stop(rs_source::RS_SOURCE_ALL);
+            }
+            catch(const std::exception & ex)
+            {
+                LOG_ERROR("failed to stop the synthetic device - " << ex.what());
+            }
+        }
+
+        const rs_stream_interface & rs_device_synthetic::get_stream_interface(rs_stream stream) const
+        {
+            if(stream < 0 || stream >= RS_STREAM_COUNT)
+                throw std::runtime_error("invalid stream");
+            return *m_streams[stream];
+        }
+
+        const char * rs_device_synthetic::get_name() const
+        {
+            return get_camera_info(rs_camera_info::RS_CAMERA_INFO_DEVICE_NAME);
+        }
+
+        const char * rs_device_synthetic::get_serial() const
+        {
+            return get_camera_info(rs_camera_info::RS_CAMERA_INFO_DEVICE_SERIAL_NUMBER);
+        }
+
+        const char * rs_device_synthetic::get_firmware_version() const
+        {
+            return get_camera_info(rs_camera_info::RS_CAMERA_INFO_CAMERA_FIRMWARE_VERSION);
+        }
+
+        float rs_device_synthetic::get_depth_scale() const
+        {
+            return synthetic_stream::DEPTH_SCALE;
+        }
+
+        void rs_device_synthetic::enable_stream(rs_stream stream, int width, int height, rs_format format, int fps, rs_output_buffer_format output)
+        {
+            LOG_INFO("enable stream - " << stream << " ,width - " << width << " ,height - " << height << " ,format - " << format << " ,fps -" << fps);
+
+            if(m_is_video_streaming)
+                throw std::runtime_error("can't enable a stream while the device is streaming");
+            auto modes = m_configuration.modes.find(static_cast<rs::stream>(stream));
+            if(modes == m_configuration.modes.end() || modes->second.empty())
+            {
+                LOG_ERROR("unsupported stream");
+                throw std::runtime_error("unsupported stream");
+            }
+            //zero values match any mode, as in librealsense
+            auto mode = std::find_if(modes->second.begin(), modes->second.end(), [&](const stream_mode & m)
+            {
+                return (width == 0 || m.width == width) && (height == 0 || m.height == height) &&
+                       (format == RS_FORMAT_ANY || static_cast<rs_format>(m.format) == format) && (fps == 0 || m.framerate == fps);
+            });
+            if(mode == modes->second.end())
+            {
+                LOG_ERROR("configuration mode is unavailable");
+                std::stringstream ss;
+                ss << "configuration mode of " << width << "X" << height << "X" <<  fps << " is unavailable";
+                throw std::runtime_error(ss.str());
+            }
+            m_streams[stream]->enable(*mode);
+        }
+
+        void rs_device_synthetic::enable_stream_preset(rs_stream stream, rs_preset preset)
+        {
+            LOG_INFO("enable stream - " << stream << " ,preset - " << preset)
+            enable_stream(stream, 0, 0, RS_FORMAT_ANY, 0, RS_OUTPUT_BUFFER_FORMAT_CONTINUOUS);
+        }
+
+        void rs_device_synthetic::disable_stream(rs_stream stream)
+        {
+            LOG_INFO("disable stream - " << stream)
+            if(m_is_video_streaming)
+                throw std::runtime_error("can't disable a stream while the device is streaming");
+            m_streams[stream]->disable();
+        }
+
+        void rs_device_synthetic::enable_motion_tracking()
+        {
+            LOG_INFO("enable motion tracking")
+            m_is_motion_tracking_enabled = true;
+        }
+
+        void rs_device_synthetic::set_stream_callback(rs_stream stream, void(*on_frame)(rs_device * device, rs_frame_ref * frame, void * user), void * user)
+        {
+            set_stream_callback(stream, new frame_callback(this, on_frame, user));
+        }
+
+        void rs_device_synthetic::set_stream_callback(rs_stream stream, rs_frame_callback * callback)
+        {
+            LOG_INFO("stream - " << stream)
+            if(m_is_video_streaming)
+                throw std::runtime_error("can't set a stream callback while the device is streaming");
+            m_generators[stream].callback = std::shared_ptr<rs_frame_callback>(callback, [](rs_frame_callback* cb)
+            {cb->release();});
+        }
+
+        void rs_device_synthetic::disable_motion_tracking()
+        {
+            LOG_INFO("disable motion tracking")
+            m_is_motion_tracking_enabled = false;
+        }
+
+        void rs_device_synthetic::set_motion_callback(void(*on_event)(rs_device * device, rs_motion_data data, void * user), void * user)
+        {
+            set_motion_callback(new motion_events_callback(this, on_event, user));
+        }
+
+        void rs_device_synthetic::set_motion_callback(rs_motion_callback * callback)
+        {
+            LOG_INFO("set motion callback")
+            std::lock_guard<std::mutex> guard(m_events_mutex);
+            m_motion_callback = std::shared_ptr<rs_motion_callback>(callback, [](rs_motion_callback* cb)
+            { cb->release(); });
+        }
+
+        void rs_device_synthetic::set_timestamp_callback(void(*on_event)(rs_device * device, rs_timestamp_data data, void * user), void * user)
+        {
+            set_timestamp_callback(new timestamp_events_callback(this, on_event, user));
+        }
+
+        void rs_device_synthetic::set_timestamp_callback(rs_timestamp_callback * callback)
+        {
+            LOG_INFO("set time stamp callback")
+            std::lock_guard<std::mutex> guard(m_events_mutex);
+            m_timestamp_callback = std::shared_ptr<rs_timestamp_callback>(callback, [](rs_timestamp_callback* cb)
+            { cb->release(); });
+        }
+
+        void rs_device_synthetic::start(rs_source source)
+        {
+            LOG_INFO("start");
+            //the video and motion timestamps share the time base of the first started source
+            if(!m_is_video_streaming && !m_is_motion_streaming)
+                m_start_time = steady_clock::now();
+            if(source == RS_SOURCE_VIDEO || source == RS_SOURCE_ALL)
+                start_video();
+            if((source == RS_SOURCE_MOTION_TRACKING || source == RS_SOURCE_ALL) && m_is_motion_tracking_enabled)
+                start_motion();
+        }
+
+        void rs_device_synthetic::stop(rs_source source)
+        {
+            LOG_INFO("stop");
+            if(source == RS_SOURCE_MOTION_TRACKING || source == RS_SOURCE_ALL)
+                stop_motion();
+            if(source == RS_SOURCE_VIDEO || source == RS_SOURCE_ALL)
+                stop_video();
+        }
+
+        bool rs_device_synthetic::is_capturing() const
+        {
+            return m_is_video_streaming;
+        }
+
+        int rs_device_synthetic::is_motion_tracking_active() const
+        {
+            return m_is_motion_streaming ? 1 : 0;
+        }
+
+        void rs_device_synthetic::wait_all_streams()
+        {
+            LOG_FUNC_SCOPE();
+
+            if(is_any_callback_set())
+                throw std::runtime_error("calling to \"wait_for_frames\" (synchronous mode) is not allowed if \"set_frame_callback\" was called (asynchronous mode)");
+
+            std::unique_lock<std::mutex> guard(m_streaming_mutex);
+            m_streaming_cv.wait(guard, [this]() { return all_streams_available() || !m_is_video_streaming; });
+            if(!m_is_video_streaming)
+                return;
+            for(auto & generator : m_generators)
+            {
+                m_streams[generator.first]->set_frame(generator.second.new_frame);
+                generator.second.has_new_frame = false;
+            }
+            m_streaming_cv.notify_all();
+        }
+
+        bool rs_device_synthetic::poll_all_streams()
+        {
+            LOG_FUNC_SCOPE();
+
+            if(is_any_callback_set())
+                throw std::runtime_error("calling to \"poll_for_frames\" (synchronous mode) is not allowed if \"set_frame_callback\" was called (asynchronous mode)");
+
+            std::lock_guard<std::mutex> guard(m_streaming_mutex);
+            if(!m_is_video_streaming || !all_streams_available())
+                return false;
+            for(auto & generator : m_generators)
+            {
+                m_streams[generator.first]->set_frame(generator.second.new_frame);
+                generator.second.has_new_frame = false;
+            }
+            m_streaming_cv.notify_all();
+            return true;
+        }
+
+        bool rs_device_synthetic::supports(rs_capabilities capability) const
+        {
+            auto has_modes = [this](rs::stream stream)
+            {
+                auto modes = m_configuration.modes.find(stream);
+                return modes != m_configuration.modes.end() && !modes->second.empty();
+            };
+            switch(capability)
+            {
+                case RS_CAPABILITIES_DEPTH: return has_modes(rs::stream::depth);
+                case RS_CAPABILITIES_COLOR: return has_modes(rs::stream::color);
+                case RS_CAPABILITIES_INFRARED: return has_modes(rs::stream::infrared);
+                case RS_CAPABILITIES_INFRARED2: return has_modes(rs::stream::infrared2);
+                case RS_CAPABILITIES_FISH_EYE: return has_modes(rs::stream::fisheye);
+                case RS_CAPABILITIES_MOTION_EVENTS: return m_configuration.motion_rate > 0;
+                default: return false;
+            }
+        }
+
+        bool rs_device_synthetic::supports(rs_camera_info info_param) const
+        {
+            return m_camera_info.find(info_param) != m_camera_info.end();
+        }
+
+        bool rs_device_synthetic::supports_option(rs_option option) const
+        {
+            return option == RS_OPTION_TOTAL_FRAME_DROPS;
+        }
+
+        void rs_device_synthetic::get_option_range(rs_option option, double & min, double & max, double & step, double & def)
+        {
+            if(!supports_option(option))
+                throw std::runtime_error("unsupported option");
+            min = 0;
+            max = std::numeric_limits<double>::max();
+            step = 1;
+            def = 0;
+        }
+
+        void rs_device_synthetic::set_options(const rs_option options[], size_t count, const double values[])
+        {
+            for(size_t i = 0; i < count; i++)
+            {
+                if(!supports_option(options[i]))
+                    throw std::runtime_error("unsupported option");
+                //the drops are counted by the generators, the option is read only
+                LOG_WARN("option " << options[i] << " is read only");
+            }
+        }
+
+        void rs_device_synthetic::get_options(const rs_option options[], size_t count, double values[])
+        {
+            for(size_t i = 0; i < count; i++)
+            {
+                if(!supports_option(options[i]))
+                    throw std::runtime_error("unsupported option");
+                uint64_t drops = 0;
+                for(auto & generator : m_generators)
+                    drops += generator.second.dropped_frames_count;
+                values[i] = static_cast<double>(drops);
+            }
+        }
+
+        void rs_device_synthetic::release_frame(rs_frame_ref * ref)
+        {
+            LOG_VERBOSE("release frame");
+            auto & generator = m_generators.at(ref->get_stream_type());
+            std::lock_guard<std::mutex> guard(generator.mutex);
+            delete ref;
+            generator.active_frames_count--;
+            generator.frame_released_cv.notify_one();
+        }
+
+        rs_frame_ref * rs_device_synthetic::clone_frame(rs_frame_ref * frame)
+        {
+            auto synthetic_frame_ref = dynamic_cast<rs_frame_ref_synthetic*>(frame);
+            if(!synthetic_frame_ref)
+                throw std::runtime_error("the frame was not generated by a synthetic device");
+            auto & generator = m_generators.at(frame->get_stream_type());
+            std::lock_guard<std::mutex> guard(generator.mutex);
+            generator.active_frames_count++;
+            return new rs_frame_ref_synthetic(*synthetic_frame_ref);
+        }
+
+        const char * rs_device_synthetic::get_usb_port_id() const
+        {
+            return "Synthetic";
+        }
+
+        const char * rs_device_synthetic::get_camera_info(rs_camera_info info_type) const
+        {
+            auto info = m_camera_info.find(info_type);
+            if(info == m_camera_info.end())
+            {
+                std::ostringstream oss;
+                oss << "camera info " << info_type << " is not supported for this device";
+                throw std::runtime_error(oss.str());
+            }
+            return info->second.c_str();
+        }
+
+        rs_motion_intrinsics rs_device_synthetic::get_motion_intrinsics() const
+        {
+            //ideal sensors, a unit scale without bias
+            rs_motion_intrinsics intrinsics = {};
+            for(int i = 0; i < 3; i++)
+            {
+                intrinsics.acc.data[i][i] = 1;
+                intrinsics.gyro.data[i][i] = 1;
+            }
+            return intrinsics;
+        }
+
+        rs_extrinsics rs_device_synthetic::get_motion_extrinsics_from(rs_stream from) const
+        {
+            if(from < 0 || from >= RS_STREAM_COUNT)
+                throw std::runtime_error("invalid stream");
+            //the motion module is placed at the depth camera
+            rs_extrinsics extrinsics = {{1, 0, 0, 0, 1, 0, 0, 0, 1}, {0, 0, 0}};
+            extrinsics.translation[0] = -synthetic_stream::get_offset(from);
+            return extrinsics;
+        }
+
+        void rs_device_synthetic::start_fw_logger(char fw_log_op_code, int grab_rate_in_ms, std::timed_mutex &mutex)
+        {
+            //not available
+        }
+
+        void rs_device_synthetic::stop_fw_logger()
+        {
+            //not available
+        }
+
+        const char * rs_device_synthetic::get_option_description(rs_option option) const
+        {
+            return option == RS_OPTION_TOTAL_FRAME_DROPS ? "Total number of frames the synthetic streams dropped" : nullptr;
+        }
+
+        bool rs_device_synthetic::set_real_time(bool realtime)
+        {
+            if(m_is_video_streaming)
+                return false;
+            m_configuration.real_time = realtime;
+            return true;
+        }
+
+        bool rs_device_synthetic::set_max_jitter(double max_jitter)
+        {
+            if(m_is_video_streaming || max_jitter < 0)
+                return false;
+            m_configuration.max_jitter = max_jitter;
+            return true;
+        }
+
+        uint64_t rs_device_synthetic::get_generated_frames_count(rs_stream stream)
+        {
+            auto generator = m_generators.find(stream);
+            return generator != m_generators.end() ? generator->second.generated_frames_count.load() : 0;
+        }
+
+        uint64_t rs_device_synthetic::get_dropped_frames_count(rs_stream stream)
+        {
+            auto generator = m_generators.find(stream);
+            return generator != m_generators.end() ? generator->second.dropped_frames_count.load() : 0;
+        }
+
+        void rs_device_synthetic::start_video()
+        {
+            LOG_FUNC_SCOPE();
+            if(m_is_video_streaming)
+                return;
+            bool is_async = is_any_callback_set();
+            std::vector<rs_stream> streams;
+            for(auto & stream : m_streams)
+            {
+                if(!stream->is_enabled())
+                    continue;
+                //in asynchronous mode only the streams with a callback are generated
+                auto generator = m_generators.find(stream->get_stream_type());
+                if(is_async && (generator == m_generators.end() || !generator->second.callback))
+                    continue;
+                streams.push_back(stream->get_stream_type());
+            }
+            if(streams.empty())
+                throw std::runtime_error("no stream is enabled");
+
+            //the generators of the previous session are removed, so that the synchronous mode waits only for the enabled streams
+            for(auto it = m_generators.begin(); it != m_generators.end();)
+            {
+                if(std::find(streams.begin(), streams.end(), it->first) == streams.end() && !it->second.callback)
+                    it = m_generators.erase(it);
+                else
+                    ++it;
+            }
+            for(auto stream : streams)
+            {
+                auto & generator = m_generators[stream];
+                generator.active_frames_count = 0;
+                generator.generated_frames_count = 0;
+                generator.dropped_frames_count = 0;
+                generator.new_frame.reset();
+                generator.has_new_frame = false;
+                m_streams[stream]->clear_data();
+                m_streams[stream]->get_scene();
+            }
+            m_is_video_streaming = true;
+            for(auto stream : streams)
+                m_generators[stream].thread = std::thread(&rs_device_synthetic::stream_thread, this, stream);
+        }
+
+        void rs_device_synthetic::stop_video()
+        {
+            LOG_FUNC_SCOPE();
+            if(!m_is_video_streaming)
+                return;
+            {
+                std::lock_guard<std::mutex> guard(m_streaming_mutex);
+                m_is_video_streaming = false;
+            }
+            m_streaming_cv.notify_all();
+            for(auto & generator : m_generators)
+            {
+                if(generator.second.thread.joinable())
+                    generator.second.thread.join();
+            }
+            for(auto & stream : m_streams)
+                stream->clear_data();
+            if(!wait_for_active_frames())
+                throw std::runtime_error("failed to stop synthetic device, not all frames returned within the time limit");
+        }
+
+        void rs_device_synthetic::start_motion()
+        {
+            LOG_FUNC_SCOPE();
+            if(m_is_motion_streaming || m_configuration.motion_rate <= 0)
+                return;
+            m_is_motion_streaming = true;
+            m_motion_thread = std::thread(&rs_device_synthetic::motion_thread, this);
+        }
+
+        void rs_device_synthetic::stop_motion()
+        {
+            LOG_FUNC_SCOPE();
+            if(!m_is_motion_streaming)
+                return;
+            {
+                std::lock_guard<std::mutex> guard(m_streaming_mutex);
+                m_is_motion_streaming = false;
+            }
+            m_streaming_cv.notify_all();
+            if(m_motion_thread.joinable())
+                m_motion_thread.join();
+        }
+
+        void rs_device_synthetic::stream_thread(rs_stream stream)
+        {
+            auto & generator = m_generators.at(stream);
+            auto & synthetic = *m_streams[stream];
+            auto mode = synthetic.get_enabled_mode();
+            auto bpp = synthetic.get_enabled_bpp();
+            auto scene = synthetic.get_scene();
+            auto frame_time = duration<double, std::milli>(1000.0 / mode.framerate);
+            auto real_time = m_configuration.real_time;
+            auto stop_waiting = [this]() { return !m_is_video_streaming; };
+
+            //a stream started after the motion source continues its time line
+            unsigned long long frame_index = real_time ? static_cast<unsigned long long>(std::ceil((steady_clock::now() - m_start_time) / frame_time)) : 0;
+            while(m_is_video_streaming)
+            {
+                if(real_time)
+                {
+                    if(!wait_until(m_start_time + duration_cast<steady_clock::duration>(frame_time * frame_index), stop_waiting))
+                        break;
+                }
+                else if(!generator.callback)
+                {
+                    //the next frame is generated once the previous frame was read by wait_for_frames
+                    std::unique_lock<std::mutex> guard(m_streaming_mutex);
+                    m_streaming_cv.wait(guard, [this, &generator]() { return !generator.has_new_frame || !m_is_video_streaming; });
+                    if(!m_is_video_streaming)
+                        break;
+                }
+
+                auto frame = std::make_shared<synthetic_frame>();
+                frame->stream = stream;
+                frame->mode = mode;
+                frame->bpp = bpp;
+                frame->number = frame_index + 1;
+                frame->time_stamp = std::max(0.0, frame_time.count() * static_cast<double>(frame_index) + query_jitter(stream, frame_index));
+                frame->system_time = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+                frame->data = scene;
+                generator.generated_frames_count++;
+
+                if(m_is_motion_streaming && (stream == RS_STREAM_DEPTH || stream == RS_STREAM_FISHEYE))
+                {
+                    std::lock_guard<std::mutex> guard(m_events_mutex);
+                    if(m_timestamp_callback)
+                    {
+                        rs_timestamp_data data = {frame->time_stamp, stream == RS_STREAM_DEPTH ? RS_EVENT_IMU_DEPTH_CAM : RS_EVENT_IMU_MOTION_CAM, frame->number};
+                        m_timestamp_callback->on_event(data);
+                    }
+                }
+
+                deliver_frame(stream, frame);
+                frame_index++;
+
+                if(real_time && generator.callback)
+                {
+                    //the frames which were due while the callback was busy are dropped, the stream continues from the latest due frame
+                    auto due_index = static_cast<unsigned long long>((steady_clock::now() - m_start_time) / frame_time);
+                    if(due_index > frame_index)
+                    {
+                        generator.generated_frames_count += due_index - frame_index;
+                        generator.dropped_frames_count += due_index - frame_index;
+                        frame_index = due_index;
+                    }
+                }
+            }
+        }
+
+        void rs_device_synthetic::motion_thread()
+        {
+            auto sample_time = duration<double, std::milli>(1000.0 / m_configuration.motion_rate);
+            auto stop_waiting = [this]() { return !m_is_motion_streaming; };
+            unsigned long long sample_index = static_cast<unsigned long long>(std::ceil((steady_clock::now() - m_start_time) / sample_time));
+            while(m_is_motion_streaming)
+            {
+                if(!wait_until(m_start_time + duration_cast<steady_clock::duration>(sample_time * sample_index), stop_waiting))
+                    break;
+
+                //a device at rest, swaying slowly around the vertical axis
+                double time_stamp = sample_time.count() * static_cast<double>(sample_index);
+                float sway = static_cast<float>(std::sin(time_stamp / 1000.0));
+                rs_motion_data accel = {};
+                accel.timestamp_data = {time_stamp, RS_EVENT_IMU_ACCEL, sample_index + 1};
+                accel.is_valid = 1;
+                accel.axes[0] = 0.1f * sway;
+                accel.axes[1] = -9.81f;
+                rs_motion_data gyro = {};
+                gyro.timestamp_data = {time_stamp, RS_EVENT_IMU_GYRO, sample_index + 1};
+                gyro.is_valid = 1;
+                gyro.axes[1] = 0.2f * sway;
+                {
+                    std::lock_guard<std::mutex> guard(m_events_mutex);
+                    if(m_motion_callback)
+                    {
+                        m_motion_callback->on_event(accel);
+                        m_motion_callback->on_event(gyro);
+                    }
+                }
+                sample_index++;
+            }
+        }
+
+        void rs_device_synthetic::deliver_frame(rs_stream stream, std::shared_ptr<synthetic_frame> frame)
+        {
+            auto & generator = m_generators.at(stream);
+            if(generator.callback)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(generator.mutex);
+                    generator.active_frames_count++;
+                }
+                generator.callback->on_frame(this, new rs_frame_ref_synthetic(frame));
+            }
+            else
+            {
+                std::lock_guard<std::mutex> guard(m_streaming_mutex);
+                //a frame which was not read by wait_for_frames is replaced by the newer frame
+                if(generator.has_new_frame)
+                    generator.dropped_frames_count++;
+                generator.new_frame = frame;
+                generator.has_new_frame = true;
+                m_streaming_cv.notify_all();
+            }
+        }
+
+        double rs_device_synthetic::query_jitter(rs_stream stream, unsigned long long frame_index) const
+        {
+            if(m_configuration.max_jitter <= 0)
+                return 0;
+            //splitmix64 of the seed, stream and frame index, the same frame gets the same jitter on every run
+            uint64_t hash = (static_cast<uint64_t>(m_configuration.seed) << 32) ^ (static_cast<uint64_t>(stream) << 56) ^ frame_index;
+            hash += 0x9e3779b97f4a7c15ULL;
+            hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+            hash = hash ^ (hash >> 31);
+            double unit = static_cast<double>(hash >> 11) / static_cast<double>(1ULL << 53);
+            return (unit * 2 - 1) * m_configuration.max_jitter;
+        }
+
+        bool rs_device_synthetic::is_any_callback_set() const
+        {
+            for(auto & generator : m_generators)
+            {
+                if(generator.second.callback)
+                    return true;
+            }
+            return false;
+        }
+
+        bool rs_device_synthetic::all_streams_available() const
+        {
+            for(auto & generator : m_generators)
+            {
+                if(!generator.second.has_new_frame)
+                    return false;
+            }
+            return !m_generators.empty();
+        }
+
+        bool rs_device_synthetic::wait_for_active_frames()
+        {
+            for(auto it = m_generators.begin(); it != m_generators.end(); ++it)
+            {
+                //wait for all frames to return
+                auto pred = [it]() -> bool
+                {
+                    return it->second.active_frames_count == 0;
+                };
+
+                std::unique_lock<std::mutex> locker(it->second.mutex);
+                if(!it->second.frame_released_cv.wait_for(locker, std::chrono::seconds(5), pred))
+                    return false;
+            }
+            return true;
+        }
+
+        /************************************************************************************************************/
+        //rs::device extention
+        /************************************************************************************************************/
+
+        bool device::set_real_time(bool realtime)
+        {
+            return ((rs_device_synthetic*)this)->set_real_time(realtime);
+        }
+
+        bool device::is_real_time()
+        {
+            return ((rs_device_synthetic*)this)->is_real_time();
+        }
+
+        bool device::set_max_jitter(double max_jitter)
+        {
+            return ((rs_device_synthetic*)this)->set_max_jitter(max_jitter);
+        }
+
+        uint64_t device::get_generated_frames_count(rs::stream stream)
+        {
+            return ((rs_device_synthetic*)this)->get_generated_frames_count(static_cast<rs_stream>(stream));
+        }
+
+        uint64_t device::get_dropped_frames_count(rs::stream stream)
+        {
+            return ((rs_device_synthetic*)this)->get_dropped_frames_count(static_cast<rs_stream>(stream));
+        }
+    }
+}
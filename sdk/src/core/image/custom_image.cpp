@@ -2,6 +2,7 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include "custom_image.h"
+#include "rs/utils/ref_count_data_releaser.h"
 
 namespace rs
 {
@@ -75,6 +76,19 @@ namespace rs
                                     frame_number,
                                     std::move(rs::utils::get_unique_ptr_with_releaser(data_container.data_releaser)));
         }
+
+        image_interface * image_interface::create_instance_view(image_info * info,
+                                                                const void * data,
+                                                                const ref_count_interface * data_owner,
+                                                                stream_type stream,
+                                                                image_interface::flag flags,
+                                                                double time_stamp,
+                                                                uint64_t frame_number,
+                                                                timestamp_domain time_stamp_domain)
+        {
+            release_interface * data_releaser = data_owner ? new rs::utils::ref_count_data_releaser(data_owner) : nullptr;
+            return create_instance_from_raw_data(info, {data, data_releaser}, stream, flags, time_stamp, frame_number, time_stamp_domain);
+        }
     }
 }
 
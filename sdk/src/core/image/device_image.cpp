@@ -0,0 +1,70 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "device_image.h"
+#include "image_buffer_pool.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            //the host copies of the device images, released host copies return their buffer to the pool
+            const std::shared_ptr<image_buffer_pool> & host_copy_buffer_pool()
+            {
+                static const std::shared_ptr<image_buffer_pool> pool = image_buffer_pool::create();
+                return pool;
+            }
+        }
+
+        device_image::device_image(image_info * info,
+                                   const device_buffer_interface * buffer,
+                                   stream_type stream,
+                                   image_interface::flag flags,
+                                   double time_stamp,
+                                   rs::core::timestamp_domain time_stamp_domain,
+                                   uint64_t frame_number)
+            : custom_image(info, nullptr, stream, flags, time_stamp, time_stamp_domain, frame_number, nullptr),
+              m_buffer(buffer), m_host_data(nullptr)
+        {
+            attach_device_buffer(m_buffer);
+        }
+
+        const void * device_image::query_data() const
+        {
+            //the device buffer is copied once, the image data is immutable
+            std::call_once(m_host_copy_once, [this]()
+            {
+                release_interface * data_releaser = nullptr;
+                uint8_t * host_data = host_copy_buffer_pool()->acquire(static_cast<size_t>(m_info.height) * m_info.pitch, data_releaser);
+                const int32_t row_size = m_info.width * get_pixel_size(m_info.format);
+                if(m_buffer->download(m_info.height, row_size, host_data, m_info.pitch) < status_no_error)
+                {
+                    data_releaser->release();
+                    return;
+                }
+                m_host_data_releaser = rs::utils::get_unique_ptr_with_releaser(data_releaser);
+                m_host_data = host_data;
+            });
+            return m_host_data;
+        }
+
+        device_image::~device_image() {}
+
+        image_interface * image_interface::create_instance_from_device_buffer(image_info * info,
+                                                                              const device_buffer_interface * buffer,
+                                                                              stream_type stream,
+                                                                              image_interface::flag flags,
+                                                                              double time_stamp,
+                                                                              uint64_t frame_number,
+                                                                              timestamp_domain time_stamp_domain)
+        {
+            if(!info || !buffer || buffer->query_api() < device_api::cuda || buffer->query_api() >= device_api::max)
+            {
+                return nullptr;
+            }
+            return new device_image(info, buffer, stream, flags, time_stamp, time_stamp_domain, frame_number);
+        }
+    }
+}
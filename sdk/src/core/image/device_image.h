@@ -0,0 +1,39 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "custom_image.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief The device_image class
+         * implements the sdk image interface over a device buffer, the image data is copied to host memory on the first query_data call.
+         * the device buffer is attached to the image as its buffer of the buffer api, so the modules of the api use it without a copy.
+         * see complete image documantation in the interface declaration.
+         */
+        class device_image : public custom_image
+        {
+        public:
+            device_image(const device_image &) = delete;
+            device_image & operator = (const device_image &) = delete;
+
+            device_image(image_info * info,
+                         const device_buffer_interface * buffer,
+                         stream_type stream,
+                         image_interface::flag flags,
+                         double time_stamp,
+                         rs::core::timestamp_domain time_stamp_domain,
+                         uint64_t frame_number);
+            const void * query_data(void) const override;
+        protected:
+            const device_buffer_interface * m_buffer;
+            mutable std::once_flag m_host_copy_once;
+            mutable const void * m_host_data;
+            mutable rs::utils::unique_ptr<release_interface> m_host_data_releaser;
+            virtual ~device_image();
+        };
+    }
+}
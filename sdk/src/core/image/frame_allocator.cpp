@@ -0,0 +1,215 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+#ifdef WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+#include "rs/core/frame_allocator_interface.h"
+#include "image_buffer_pool.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            const size_t FRAME_ALIGNMENT = 64;
+            const size_t SMALL_PAGE_SIZE = 4096;
+            const size_t HUGE_PAGE_SIZE = 2 << 20;
+
+            class heap_allocator : public frame_allocator_interface
+            {
+            public:
+                void * allocate(size_t size) override
+                {
+#ifdef WIN32
+                    return _aligned_malloc(size, FRAME_ALIGNMENT);
+#else
+                    void * data = nullptr;
+                    return posix_memalign(&data, FRAME_ALIGNMENT, size) == 0 ? data : nullptr;
+#endif
+                }
+
+                void deallocate(void * data, size_t) override
+                {
+#ifdef WIN32
+                    _aligned_free(data);
+#else
+                    free(data);
+#endif
+                }
+            };
+
+            //the free buffers of a size class are reused by the next allocations of the class, above the free bytes limit they're freed
+            class size_class_pool_allocator : public frame_allocator_interface
+            {
+            public:
+                explicit size_class_pool_allocator(frame_allocator_interface * backing) : m_backing(backing), m_free_bytes(0) {}
+
+                void * allocate(size_t size) override
+                {
+                    const size_t class_size = image_buffer_pool::size_class(size);
+                    {
+                        std::lock_guard<std::mutex> guard(m_mutex);
+                        auto & free_buffers = m_free_buffers[class_size];
+                        if(!free_buffers.empty())
+                        {
+                            void * data = free_buffers.back();
+                            free_buffers.pop_back();
+                            m_free_bytes -= class_size;
+                            return data;
+                        }
+                    }
+                    return m_backing->allocate(class_size);
+                }
+
+                void deallocate(void * data, size_t size) override
+                {
+                    const size_t class_size = image_buffer_pool::size_class(size);
+                    {
+                        std::lock_guard<std::mutex> guard(m_mutex);
+                        if(m_free_bytes + class_size <= MAX_FREE_BYTES)
+                        {
+                            m_free_buffers[class_size].push_back(data);
+                            m_free_bytes += class_size;
+                            return;
+                        }
+                    }
+                    m_backing->deallocate(data, class_size);
+                }
+
+            private:
+                static const size_t MAX_FREE_BYTES = 64 << 20;
+
+                frame_allocator_interface *             m_backing;
+                std::mutex                              m_mutex;
+                std::map<size_t, std::vector<void *>>   m_free_buffers; // by size class
+                size_t                                  m_free_bytes;
+            };
+
+#ifndef WIN32
+            //maps the buffers directly, so the pages are private to the buffer and the mapping flags apply to them
+            class mapped_allocator : public frame_allocator_interface
+            {
+            public:
+                enum class mode { huge_pages, numa_local, pinned };
+
+                explicit mapped_allocator(mode allocator_mode) : m_mode(allocator_mode) {}
+
+                void * allocate(size_t size) override
+                {
+                    const size_t mapped_size = get_mapped_size(size);
+                    void * data = MAP_FAILED;
+                    switch(m_mode)
+                    {
+                        case mode::huge_pages:
+#ifdef MAP_HUGETLB
+                            data = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+                            if(data == MAP_FAILED)
+                            {
+                                //no huge pages are reserved, ask for transparent huge pages
+                                data = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+                                if(data != MAP_FAILED)
+                                    madvise(data, mapped_size, MADV_HUGEPAGE);
+#endif
+                            }
+                            break;
+                        case mode::numa_local:
+                            //the first touch places a page, populating on the allocating thread places the buffer on its node
+                            data = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+                            break;
+                        case mode::pinned:
+                            data = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                            //above the lock limit the buffer is still usable, it is only swappable
+                            if(data != MAP_FAILED)
+                                mlock(data, mapped_size);
+                            break;
+                    }
+                    return data == MAP_FAILED ? nullptr : data;
+                }
+
+                void deallocate(void * data, size_t size) override
+                {
+                    const size_t mapped_size = get_mapped_size(size);
+                    if(m_mode == mode::pinned)
+                        munlock(data, mapped_size);
+                    munmap(data, mapped_size);
+                }
+
+            private:
+                size_t get_mapped_size(size_t size) const
+                {
+                    const size_t page_size = m_mode == mode::huge_pages ? HUGE_PAGE_SIZE : SMALL_PAGE_SIZE;
+                    return (size + page_size - 1) / page_size * page_size;
+                }
+
+                mode m_mode;
+            };
+#endif
+
+            //the built-in allocators are never destroyed, the buffers of static images may be freed at the process exit
+            heap_allocator & get_heap_allocator()
+            {
+                static heap_allocator * allocator = new heap_allocator();
+                return *allocator;
+            }
+
+            std::atomic<frame_allocator_interface *> & process_allocator()
+            {
+                static std::atomic<frame_allocator_interface *> allocator(&get_heap_allocator());
+                return allocator;
+            }
+        }
+
+        frame_allocator_interface * frame_allocator_interface::get_builtin(builtin type)
+        {
+            switch(type)
+            {
+                case builtin::size_class_pool:
+                {
+                    static size_class_pool_allocator * allocator = new size_class_pool_allocator(&get_heap_allocator());
+                    return allocator;
+                }
+#ifndef WIN32
+                case builtin::huge_pages:
+                {
+                    static mapped_allocator * allocator = new mapped_allocator(mapped_allocator::mode::huge_pages);
+                    return allocator;
+                }
+                case builtin::numa_local:
+                {
+                    static mapped_allocator * allocator = new mapped_allocator(mapped_allocator::mode::numa_local);
+                    return allocator;
+                }
+                case builtin::pinned:
+                {
+                    static mapped_allocator * allocator = new mapped_allocator(mapped_allocator::mode::pinned);
+                    return allocator;
+                }
+#endif
+                default:
+                    return &get_heap_allocator();
+            }
+        }
+
+        void frame_allocator_interface::set_process_allocator(frame_allocator_interface * allocator)
+        {
+            process_allocator().store(allocator ? allocator : &get_heap_allocator(), std::memory_order_release);
+        }
+
+        frame_allocator_interface * frame_allocator_interface::get_process_allocator()
+        {
+            return process_allocator().load(std::memory_order_acquire);
+        }
+    }
+}
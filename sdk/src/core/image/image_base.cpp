@@ -1,11 +1,18 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <algorithm>
+#include <atomic>
 #include "image_base.h"
 #include "custom_image.h"
 #include "image_conversion_util.h"
-#include "rs/utils/self_releasing_array_data_releaser.h"
+#include "image_rotation_util.h"
+#include "image_downscale_util.h"
+#include "image_transform_util.h"
+#include "image_buffer_pool.h"
+#include "lazy_converted_image.h"
 #include "rs/utils/smart_ptr_helpers.h"
+#include "rs/utils/memory_accounting.h"
 #include "rs_sdk_version.h"
 #include "metadata.h"
 
@@ -16,7 +23,76 @@ namespace rs
         image_base::image_base()
             : ref_count_base()
         {
+            for(auto & device_buffer : m_device_buffers)
+            {
+                device_buffer.store(nullptr, std::memory_order_relaxed);
+            }
+        }
 
+        const device_buffer_interface * image_base::query_device_buffer(device_api api) const
+        {
+            if(api < device_api::cuda || api >= device_api::max)
+            {
+                return nullptr;
+            }
+            return m_device_buffers[static_cast<int32_t>(api)].load(std::memory_order_acquire);
+        }
+
+        status image_base::attach_device_buffer(const device_buffer_interface * buffer) const
+        {
+            if(!buffer)
+            {
+                return status_handle_invalid;
+            }
+            const device_api api = buffer->query_api();
+            if(api < device_api::cuda || api >= device_api::max)
+            {
+                return status_handle_invalid;
+            }
+
+            //the modules may upload the image concurrently, the first upload is kept and the others are released by their modules
+            buffer->add_ref();
+            const device_buffer_interface * attached = nullptr;
+            if(!m_device_buffers[static_cast<int32_t>(api)].compare_exchange_strong(attached, buffer, std::memory_order_acq_rel))
+            {
+                buffer->release();
+                return status_key_already_exists;
+            }
+            return status_no_error;
+        }
+
+        const ref_count_interface * image_base::query_attachment(const void * owner, uint32_t id) const
+        {
+            std::lock_guard<std::mutex> guard(m_attachments_lock);
+            for(auto & attached : m_attachments)
+            {
+                if(attached.owner == owner && attached.id == id)
+                {
+                    return attached.data;
+                }
+            }
+            return nullptr;
+        }
+
+        status image_base::attach(const void * owner, uint32_t id, const ref_count_interface * data) const
+        {
+            if(!data)
+            {
+                return status_handle_invalid;
+            }
+
+            //the modules may derive the product concurrently, the first product is kept and the others are released by their modules
+            std::lock_guard<std::mutex> guard(m_attachments_lock);
+            for(auto & attached : m_attachments)
+            {
+                if(attached.owner == owner && attached.id == id)
+                {
+                    return status_key_already_exists;
+                }
+            }
+            data->add_ref();
+            m_attachments.push_back({ owner, id, data });
+            return status_no_error;
         }
 
         metadata_interface * image_base::query_metadata()
@@ -24,11 +100,53 @@ namespace rs
             return &metadata;
         }
 
+        namespace
+        {
+            //most conversions of an image are for display and for processing, a few formats and the pyramid levels are kept per image
+            const size_t MAX_CACHED_IMAGES_PER_IMAGE = 3 + image_interface::MAX_PYRAMID_LEVEL;
+            const size_t DEFAULT_MAX_CONVERSION_CACHE_BYTES = 256 << 20;
+
+            std::atomic<size_t> conversion_cache_bytes(0);
+            std::atomic<size_t> max_conversion_cache_bytes(DEFAULT_MAX_CONVERSION_CACHE_BYTES);
+
+            //the rows are aligned up to the alignment of the frame allocator buffers
+            const uint32_t MAX_ROW_ALIGNMENT = 64;
+            std::atomic<uint32_t> row_alignment(1);
+
+            //the converted images data is shared by all the images, released converted images return their buffer to the pool
+            const std::shared_ptr<image_buffer_pool> & conversion_buffer_pool()
+            {
+                static const std::shared_ptr<image_buffer_pool> pool = image_buffer_pool::create();
+                return pool;
+            }
+        }
+
+        image_base::~image_base()
+        {
+            for(auto & device_buffer : m_device_buffers)
+            {
+                auto buffer = device_buffer.load(std::memory_order_acquire);
+                if(buffer)
+                {
+                    buffer->release();
+                }
+            }
+            for(auto & attached : m_attachments)
+            {
+                attached.data->release();
+            }
+            for(auto & cached : image_cache)
+            {
+                conversion_cache_bytes -= cached.bytes;
+                rs::utils::memory_accounting::remove(rs::utils::memory_subsystem::image_conversion, cached.bytes);
+            }
+        }
+
         status image_base::convert_to(pixel_format format, const image_interface **converted_image)
         {
             image_info dst_info = query_info();
             dst_info.format = format;
-            dst_info.pitch = get_pixel_size(format) * query_info().width;
+            dst_info.pitch = query_aligned_pitch(get_pixel_size(format) * query_info().width);
 
             if(image_conversion_util::is_conversion_valid(query_info(), dst_info) < status_no_error)
             {
@@ -36,40 +154,311 @@ namespace rs
             }
 
             std::lock_guard<std::mutex> lock(image_caching_lock);
-            if(image_cache_per_pixel_format.find(format) == image_cache_per_pixel_format.end())
+            const image_interface * dst_image = query_cached_image(format, rs::core::rotation::rotation_0_degree);
+            if(dst_image)
+            {
+                dst_image->add_ref();
+                *converted_image = dst_image;
+                return status_no_error;
+            }
+
+            //the data is allocated and converted on the first read, the caller owns the created reference,
+            //the cache holds the image without a reference until it's converted
+            const size_t dst_size = static_cast<size_t>(dst_info.height) * dst_info.pitch;
+            dst_image = new lazy_converted_image(this, dst_info);
+            cache_image(format, rs::core::rotation::rotation_0_degree, 0, dst_image, image_buffer_pool::size_class(dst_size), true);
+            *converted_image = dst_image;
+            return status_no_error;
+        }
+
+        uint8_t * image_base::acquire_conversion_buffer(size_t size, release_interface *& data_releaser)
+        {
+            return conversion_buffer_pool()->acquire(size, data_releaser);
+        }
+
+        const image_interface * image_base::query_cached_image(pixel_format format, rs::core::rotation rotation, uint32_t pyramid_level)
+        {
+            for(auto it = image_cache.begin(); it != image_cache.end(); ++it)
+            {
+                if(it->format == format && it->rotation == rotation && it->pyramid_level == pyramid_level)
+                {
+                    std::rotate(image_cache.begin(), it, it + 1);
+                    return image_cache.front().image.get();
+                }
+            }
+            return nullptr;
+        }
+
+        void image_base::cache_image(pixel_format format, rs::core::rotation rotation, uint32_t pyramid_level, const image_interface * image, size_t bytes,
+                                     bool is_pending)
+        {
+            while(image_cache.size() >= MAX_CACHED_IMAGES_PER_IMAGE)
+            {
+                evict_least_recently_used_image();
+            }
+            while(!image_cache.empty() && conversion_cache_bytes + bytes > max_conversion_cache_bytes)
+            {
+                evict_least_recently_used_image();
+            }
+            //other images may fill the cache concurrently, the image is cached only if the bytes still fit
+            if(conversion_cache_bytes.fetch_add(bytes) + bytes > max_conversion_cache_bytes)
+            {
+                conversion_cache_bytes -= bytes;
+                return;
+            }
+            //the cache is the first to give way to the memory budget of the sdk
+            if(!rs::utils::memory_accounting::is_within_budget(bytes))
+            {
+                conversion_cache_bytes -= bytes;
+                rs::utils::memory_accounting::add_dropped(rs::utils::memory_subsystem::image_conversion, bytes);
+                return;
+            }
+            rs::utils::memory_accounting::add(rs::utils::memory_subsystem::image_conversion, bytes);
+            if(!is_pending)
+            {
+                image->add_ref();
+            }
+            image_cache.insert(image_cache.begin(), cached_image{format, rotation, pyramid_level, rs::utils::get_unique_ptr_with_releaser(image), bytes, is_pending});
+        }
+
+        void image_base::evict_least_recently_used_image()
+        {
+            conversion_cache_bytes -= image_cache.back().bytes;
+            rs::utils::memory_accounting::remove(rs::utils::memory_subsystem::image_conversion, image_cache.back().bytes);
+            if(image_cache.back().is_pending)
+            {
+                image_cache.back().image.release();
+            }
+            image_cache.pop_back();
+        }
+
+        void image_base::uncache_pending_image(const image_interface * image)
+        {
+            for(auto it = image_cache.begin(); it != image_cache.end(); ++it)
+            {
+                if(it->image.get() == image && it->is_pending)
+                {
+                    std::rotate(it, it + 1, image_cache.end());
+                    evict_least_recently_used_image();
+                    return;
+                }
+            }
+        }
+
+        void image_base::cache_converted_image(const image_interface * image)
+        {
+            for(auto & cached : image_cache)
+            {
+                if(cached.image.get() == image && cached.is_pending)
+                {
+                    image->add_ref();
+                    cached.is_pending = false;
+                    return;
+                }
+            }
+        }
+
+        void image_interface::set_conversion_cache_limit(size_t max_bytes)
+        {
+            max_conversion_cache_bytes = max_bytes;
+        }
+
+        status image_interface::set_row_alignment(uint32_t alignment)
+        {
+            if(alignment == 0 || alignment > MAX_ROW_ALIGNMENT || (alignment & (alignment - 1)) != 0)
+            {
+                return status_invalid_argument;
+            }
+            row_alignment = alignment;
+            return status_no_error;
+        }
+
+        uint32_t image_interface::query_row_alignment()
+        {
+            return row_alignment;
+        }
+
+        int32_t image_interface::query_aligned_pitch(int32_t row_bytes)
+        {
+            const int32_t alignment = static_cast<int32_t>(row_alignment.load());
+            return (row_bytes + alignment - 1) & ~(alignment - 1);
+        }
+
+        size_t image_interface::query_conversion_cache_bytes()
+        {
+            return conversion_cache_bytes;
+        }
+
+        status image_interface::set_depth_colorization_range(uint16_t min_depth, uint16_t max_depth)
+        {
+            return image_conversion_util::set_depth_colorization_range(min_depth, max_depth);
+        }
+
+        bool image_interface::query_depth_colorization_range(uint16_t & min_depth, uint16_t & max_depth)
+        {
+            return image_conversion_util::query_depth_colorization_range(min_depth, max_depth);
+        }
+
+        status image_base::convert_to(rs::core::rotation rotation, const image_interface **converted_image)
+        {
+            if(image_rotation_util::is_rotation_valid(query_info(), rotation) < status_no_error)
+            {
+                return status_param_unsupported;
+            }
+            if(rotation == rs::core::rotation::rotation_0_degree)
+            {
+                add_ref();
+                *converted_image = this;
+                return status_no_error;
+            }
+
+            std::lock_guard<std::mutex> lock(image_caching_lock);
+            const image_interface * dst_image = query_cached_image(query_info().format, rotation);
+            if(dst_image)
+            {
+                dst_image->add_ref();
+                *converted_image = dst_image;
+                return status_no_error;
+            }
+
+            image_info dst_info = image_rotation_util::query_rotated_info(query_info(), rotation);
+            const size_t dst_size = static_cast<size_t>(dst_info.height) * dst_info.pitch;
+            release_interface * data_releaser = nullptr;
+            uint8_t * dst_data = conversion_buffer_pool()->acquire(dst_size, data_releaser);
+            if(image_rotation_util::rotate(query_info(), static_cast<const uint8_t *>(query_data()), rotation, dst_info, dst_data) < status_no_error)
+            {
+                data_releaser->release();
+                return status_param_unsupported;
+            }
+
+            dst_image = image_interface::create_instance_from_raw_data(
+                    &dst_info,
+                    {dst_data, data_releaser},
+                    query_stream_type(),
+                    query_flags(),
+                    query_time_stamp(),
+                    query_frame_number());
+
+            cache_image(dst_info.format, rotation, 0, dst_image, image_buffer_pool::size_class(dst_size));
+            *converted_image = dst_image;
+            return status_no_error;
+        }
+
+        const uint32_t image_interface::MAX_PYRAMID_LEVEL;
+
+        status image_base::query_pyramid_level(uint32_t level, const image_interface **downscaled_image)
+        {
+            if(level < 1 || level > MAX_PYRAMID_LEVEL || (query_info().width >> level) < 1 || (query_info().height >> level) < 1 ||
+               image_downscale_util::is_downscale_valid(query_info()) < status_no_error)
+            {
+                return status_param_unsupported;
+            }
+
+            std::lock_guard<std::mutex> lock(image_caching_lock);
+            const pixel_format format = query_info().format;
+            const image_interface * dst_image = query_cached_image(format, rs::core::rotation::rotation_0_degree, level);
+            if(dst_image)
             {
-                //allocate image data
-                auto dst_data = new uint8_t[dst_info.height * dst_info.pitch];
+                dst_image->add_ref();
+                *downscaled_image = dst_image;
+                return status_no_error;
+            }
 
-                //create a releaser for the above allocation
-                auto data_releaser = new rs::utils::self_releasing_array_data_releaser(dst_data);
+            //start from the deepest cached level above the requested one, and cache each computed level
+            uint32_t src_level = level - 1;
+            const image_interface * src_image = nullptr;
+            while(src_level > 0 && !(src_image = query_cached_image(format, rs::core::rotation::rotation_0_degree, src_level)))
+            {
+                src_level--;
+            }
+            //the cached levels may be evicted while the next levels are cached, hold the source level
+            rs::utils::unique_ptr<const image_interface> src_reference;
+            if(src_image)
+            {
+                src_image->add_ref();
+                src_reference = rs::utils::get_unique_ptr_with_releaser(src_image);
+            }
+            else
+            {
+                src_image = this;
+            }
 
-                // update the dst image data
-                if(image_conversion_util::convert(query_info(), static_cast<const uint8_t *>(query_data()), dst_info, dst_data) < status_no_error)
+            for(uint32_t dst_level = src_level + 1; dst_level <= level; dst_level++)
+            {
+                const image_info src_info = src_image->query_info();
+                image_info dst_info = image_downscale_util::query_downscaled_info(src_info);
+                const size_t dst_size = static_cast<size_t>(dst_info.height) * dst_info.pitch;
+                release_interface * data_releaser = nullptr;
+                uint8_t * dst_data = conversion_buffer_pool()->acquire(dst_size, data_releaser);
+                if(image_downscale_util::downscale(src_info, static_cast<const uint8_t *>(src_image->query_data()), dst_info, dst_data) < status_no_error)
                 {
                     data_releaser->release();
                     return status_param_unsupported;
                 }
 
-                //cache the image
-                const image_interface * dst_image = image_interface::create_instance_from_raw_data(
+                dst_image = image_interface::create_instance_from_raw_data(
                         &dst_info,
                         {dst_data, data_releaser},
                         query_stream_type(),
                         query_flags(),
                         query_time_stamp(),
-                        query_frame_number());
-
-                image_cache_per_pixel_format[format] = rs::utils::get_unique_ptr_with_releaser(dst_image);
+                        query_frame_number(),
+                        query_time_stamp_domain());
+                src_reference = rs::utils::get_unique_ptr_with_releaser(dst_image);
+                src_image = dst_image;
+                cache_image(format, rs::core::rotation::rotation_0_degree, dst_level, dst_image, image_buffer_pool::size_class(dst_size));
             }
-            image_cache_per_pixel_format[format]->add_ref();
-            *converted_image = image_cache_per_pixel_format[format].get();
+
+            //the caller owns the reference of the last created level
+            *downscaled_image = src_reference.release();
             return status_no_error;
         }
 
-        status image_base::convert_to(rs::core::rotation rotation, const image_interface **converted_image)
+        status image_base::transform(const image_transform & parameters, const image_interface ** transformed_image)
         {
-            return status_feature_unsupported;
+            const image_info src_info = query_info();
+            image_transform resolved_parameters = {};
+            image_info dst_info = {};
+            auto status = image_transform_util::query_transformed_info(src_info, parameters, resolved_parameters, dst_info);
+            if(status < status_no_error)
+            {
+                return status;
+            }
+
+            //a transform of the whole image to its rotated size is a conversion or a rotation, which are cached
+            const bool is_whole_image = resolved_parameters.crop.width == src_info.width && resolved_parameters.crop.height == src_info.height;
+            const image_info rotated_info = image_rotation_util::query_rotated_info(src_info, resolved_parameters.rotation);
+            if(is_whole_image && dst_info.width == rotated_info.width && dst_info.height == rotated_info.height)
+            {
+                if(resolved_parameters.format == src_info.format)
+                {
+                    return convert_to(resolved_parameters.rotation, transformed_image);
+                }
+                if(resolved_parameters.rotation == rs::core::rotation::rotation_0_degree)
+                {
+                    return convert_to(resolved_parameters.format, transformed_image);
+                }
+            }
+
+            const size_t dst_size = static_cast<size_t>(dst_info.height) * dst_info.pitch;
+            release_interface * data_releaser = nullptr;
+            uint8_t * dst_data = conversion_buffer_pool()->acquire(dst_size, data_releaser);
+            status = image_transform_util::transform(src_info, static_cast<const uint8_t *>(query_data()), resolved_parameters, dst_info, dst_data);
+            if(status < status_no_error)
+            {
+                data_releaser->release();
+                return status;
+            }
+
+            *transformed_image = image_interface::create_instance_from_raw_data(
+                    &dst_info,
+                    {dst_data, data_releaser},
+                    query_stream_type(),
+                    query_flags(),
+                    query_time_stamp(),
+                    query_frame_number(),
+                    query_time_stamp_domain());
+            return status_no_error;
         }
     }
 }
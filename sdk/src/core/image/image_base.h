@@ -6,8 +6,9 @@
 #include "rs/utils/smart_ptr_helpers.h"
 #include "rs/core/image_interface.h"
 #include "metadata.h"
-#include <map>
+#include <vector>
 #include <mutex>
+#include <atomic>
 
 #ifdef WIN32 
 #ifdef realsense_image_EXPORTS
@@ -32,15 +33,63 @@ namespace rs
         public:
             image_base();
             virtual metadata_interface* query_metadata() override;
+            virtual const metadata_view * query_metadata_view() const override { return metadata.query_view(); }
             virtual status convert_to(pixel_format format, const image_interface ** converted_image) override;
             virtual status convert_to(rs::core::rotation rotation, const image_interface ** converted_image) override;
+            virtual status query_pyramid_level(uint32_t level, const image_interface ** downscaled_image) override;
+            virtual status transform(const image_transform & parameters, const image_interface ** transformed_image) override;
+            virtual const device_buffer_interface * query_device_buffer(device_api api) const override;
+            virtual status attach_device_buffer(const device_buffer_interface * buffer) const override;
+            virtual const ref_count_interface * query_attachment(const void * owner, uint32_t id) const override;
+            virtual status attach(const void * owner, uint32_t id, const ref_count_interface * data) const override;
 
         protected:
-            std::map<pixel_format, rs::utils::unique_ptr<const image_interface>> image_cache_per_pixel_format;
+            friend class lazy_converted_image;
+
+            /**
+             * @brief A converted, rotated or downscaled image cached by its source image, and the bytes it accounts in the conversion cache.
+             */
+            struct cached_image
+            {
+                pixel_format format;
+                rs::core::rotation rotation;
+                uint32_t pyramid_level; // 0 for the converted and rotated images
+                rs::utils::unique_ptr<const image_interface> image;
+                size_t bytes;
+                bool is_pending; // a lazy converted image which isn't converted yet, cached without a reference, see lazy_converted_image
+            };
+
+            //cached conversions, rotations and pyramid levels, most recently used first
+            std::vector<cached_image> image_cache;
             std::mutex image_caching_lock;
-            virtual ~image_base() = default;
+            virtual ~image_base();
+
+            //returns the cached image of the format, rotation and pyramid level and marks it most recently used, or null if it isn't cached
+            const image_interface * query_cached_image(pixel_format format, rs::core::rotation rotation, uint32_t pyramid_level = 0);
+            //caches the image if the conversion cache has room for it, evicting the least recently used images of this image first
+            void cache_image(pixel_format format, rs::core::rotation rotation, uint32_t pyramid_level, const image_interface * image, size_t bytes,
+                             bool is_pending = false);
+            void evict_least_recently_used_image();
+            //the pending image was released, removes it from the cache, image_caching_lock must be held
+            void uncache_pending_image(const image_interface * image);
+            //the pending image was converted, the cache takes a reference to it, image_caching_lock must be held
+            void cache_converted_image(const image_interface * image);
+            //the data of the converted images, returned to the pool of the conversion buffers by the releaser
+            static uint8_t * acquire_conversion_buffer(size_t size, release_interface *& data_releaser);
         private:
             rs::core::metadata metadata;
+            //the device buffers of the image data by their api, attached once and released with the image
+            mutable std::atomic<const device_buffer_interface *> m_device_buffers[static_cast<int32_t>(device_api::max)];
+
+            struct attachment
+            {
+                const void * owner;
+                uint32_t id;
+                const ref_count_interface * data;
+            };
+            //the data derived from the image by the modules, a few products per image, released with the image
+            mutable std::vector<attachment> m_attachments;
+            mutable std::mutex m_attachments_lock;
         };
     }
 }
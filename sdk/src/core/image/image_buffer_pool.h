@@ -0,0 +1,166 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <new>
+#include <stdint.h>
+#include "rs/core/frame_allocator_interface.h"
+#include "rs/core/release_interface.h"
+#include "rs/utils/release_self_base.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Pool of image data buffers, released images return their buffer to the pool.
+        *
+        * Each buffer is owned by the data releaser of the image that uses it, so an image may outlive the pool's creator,
+        * the releaser keeps the pool alive and hands the buffer back when the image is released.
+        * Buffers are allocated in size classes, a quarter of a power of two apart, so images of close sizes share buffers.
+        * The pool accounts the bytes of the buffers in use and of the free buffers, and drops the oldest free buffers
+        * once the free bytes exceed the pool limit.
+        * In steady state, creating an image of a previously used size doesn't allocate.
+        * The buffers are allocated by the process frame allocator, see \c frame_allocator_interface.
+        */
+        class image_buffer_pool : public std::enable_shared_from_this<image_buffer_pool>
+        {
+            class pooled_data_releaser : public rs::utils::release_self_base<release_interface>
+            {
+            public:
+                pooled_data_releaser(std::shared_ptr<image_buffer_pool> pool, frame_buffer buffer) :
+                    m_pool(pool), m_buffer(std::move(buffer)) {}
+
+                uint8_t * data() { return m_buffer.data(); }
+
+                int release() const override
+                {
+                    m_pool->recycle(std::move(m_buffer));
+                    return release_self_base::release();
+                }
+            protected:
+                ~pooled_data_releaser() {}
+            private:
+                std::shared_ptr<image_buffer_pool> m_pool;
+                mutable frame_buffer               m_buffer;
+            };
+
+        public:
+            static const size_t DEFAULT_MAX_FREE_BYTES = 64 << 20;
+
+            static std::shared_ptr<image_buffer_pool> create(size_t max_free_bytes = DEFAULT_MAX_FREE_BYTES)
+            {
+                return std::shared_ptr<image_buffer_pool>(new image_buffer_pool(max_free_bytes));
+            }
+
+            /**
+            * @brief Returns a buffer of at least size bytes, reused from a released image if one of the size class is available.
+            * @param[in]  size          Required buffer size
+            * @param[out] data_releaser Releaser to pass to the image which uses the buffer, returns the buffer to the pool
+            * @return Buffer data, owned by data_releaser. The buffer content is undefined
+            */
+            uint8_t * acquire(size_t size, release_interface *& data_releaser)
+            {
+                const size_t class_size = size_class(size);
+                frame_buffer buffer;
+                {
+                    std::lock_guard<std::mutex> guard(m_mutex);
+                    for(auto it = m_free_buffers.begin(); it != m_free_buffers.end(); ++it)
+                    {
+                        if(it->size() == class_size)
+                        {
+                            buffer = std::move(*it);
+                            m_free_buffers.erase(it);
+                            m_free_bytes -= class_size;
+                            break;
+                        }
+                    }
+                }
+                if(buffer.size() != class_size)
+                {
+                    buffer = frame_buffer(class_size);
+                    if(!buffer.data())
+                        throw std::bad_alloc();
+                }
+                m_used_bytes += class_size;
+
+                auto releaser = new pooled_data_releaser(shared_from_this(), std::move(buffer));
+                data_releaser = releaser;
+                return releaser->data();
+            }
+
+            /**
+            * @brief Sets the limit of the free bytes kept by the pool, the oldest free buffers above the limit are dropped.
+            */
+            void set_max_free_bytes(size_t max_free_bytes)
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                m_max_free_bytes = max_free_bytes;
+                trim();
+            }
+
+            /**
+            * @brief Returns the bytes of the buffers held by images.
+            */
+            size_t query_used_bytes() const { return m_used_bytes; }
+
+            /**
+            * @brief Returns the bytes of the free buffers kept for reuse.
+            */
+            size_t query_free_bytes() const
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                return m_free_bytes;
+            }
+
+            /**
+            * @brief Returns the buffer size allocated for a requested size, a quarter of a power of two apart from the next class.
+            */
+            static size_t size_class(size_t size)
+            {
+                const size_t min_class_size = 4096;
+                if(size <= min_class_size) return min_class_size;
+                size_t power = min_class_size;
+                while(power * 2 < size) power *= 2;
+                const size_t step = power / 4;
+                return (size + step - 1) / step * step;
+            }
+
+        private:
+            explicit image_buffer_pool(size_t max_free_bytes) : m_max_free_bytes(max_free_bytes), m_free_bytes(0), m_used_bytes(0) {}
+
+            void recycle(frame_buffer buffer)
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                m_used_bytes -= buffer.size();
+                if(buffer.size() > m_max_free_bytes)
+                    return;
+                m_free_bytes += buffer.size();
+                m_free_buffers.push_back(std::move(buffer));
+                trim();
+            }
+
+            //drops the oldest free buffers, they are likely of a size which is no longer used
+            void trim()
+            {
+                auto it = m_free_buffers.begin();
+                while(m_free_bytes > m_max_free_bytes && it != m_free_buffers.end())
+                {
+                    m_free_bytes -= it->size();
+                    ++it;
+                }
+                m_free_buffers.erase(m_free_buffers.begin(), it);
+            }
+
+            mutable std::mutex                  m_mutex;
+            std::vector<frame_buffer>           m_free_buffers;
+            size_t                              m_max_free_bytes;
+            size_t                              m_free_bytes;
+            std::atomic<size_t>                 m_used_bytes;
+        };
+    }
+}
@@ -2,179 +2,448 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include "image_conversion_util.h"
+#include "image_rows_bands.h"
 #include "rs/core/status.h"
+#include "rs/utils/image_statistics.h"
 
-#include "opencv/cv.h"
-#include "opencv/cxcore.h"
-#include <opencv2/imgproc/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//the row kernels are plain loops, vectorized by the compiler. where the compiler supports it, each kernel is compiled for
+//avx2 and for the baseline instruction set, and the best version is selected once at load time
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 6) && defined(__x86_64__) && defined(__linux__)
+#define CONVERSION_ROW_KERNEL __attribute__((target_clones("avx2","default")))
+#else
+#define CONVERSION_ROW_KERNEL
+#endif
 
 namespace rs
 {
     namespace core
     {
-        status image_conversion_util::is_conversion_valid(const image_info &src_info, const image_info &dst_info)
+        namespace
         {
-            return get_cv_convert_enum(src_info.format, dst_info.format) == -1 ? status_param_unsupported : status_no_error;
-        }
+            //z16 values are clamped to this range before coloring
+            const uint16_t MAX_COLORED_DEPTH = 3000;
 
-        status image_conversion_util::convert(const image_info &src_info, const uint8_t *src_data, const image_info &dst_info, uint8_t *dst_data)
-        {
-            auto is_valid_status = is_conversion_valid(src_info, dst_info);
-            if(is_valid_status != status_no_error)
+            //BT.601 luma weights, in 14 bits fixed point
+            const int R2Y = 4899, G2Y = 9617, B2Y = 1868, Y_SHIFT = 14;
+
+            //BT.601 YUV to RGB coefficients, in 20 bits fixed point
+            const int YUV_CY = 1220542, YUV_CUB = 2116026, YUV_CUG = -409993, YUV_CVG = -852492, YUV_CVR = 1673527, YUV_SHIFT = 20;
+
+            inline uint8_t saturate_to_8u(int value)
             {
-                return is_valid_status;
+                return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+            }
+
+            /**
+             * @brief The byte position of each color channel in a pixel, a is -1 when the format has no alpha channel.
+             */
+            template<int CHANNELS, int R, int G, int B, int A> struct color_layout
+            {
+                static const int channels = CHANNELS, r = R, g = G, b = B, a = A;
+            };
+            typedef color_layout<3, 0, 1, 2, -1> rgb_layout;
+            typedef color_layout<3, 2, 1, 0, -1> bgr_layout;
+            typedef color_layout<4, 0, 1, 2, 3>  rgba_layout;
+            typedef color_layout<4, 2, 1, 0, 3>  bgra_layout;
+
+            template<typename DST> inline void write_color(uint8_t * dst, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+            {
+                dst[DST::r] = r;
+                dst[DST::g] = g;
+                dst[DST::b] = b;
+                if(DST::a >= 0) dst[DST::a >= 0 ? DST::a : 0] = a;
+            }
+
+            template<typename DST>
+            CONVERSION_ROW_KERNEL void gray_to_color_row(const uint8_t * src, int width, uint8_t * dst)
+            {
+                for(int x = 0; x < width; x++)
+                {
+                    write_color<DST>(dst + x * DST::channels, src[x], src[x], src[x], 255);
+                }
+            }
+
+            template<typename SRC, typename DST>
+            CONVERSION_ROW_KERNEL void color_to_color_row(const uint8_t * src, int width, uint8_t * dst)
+            {
+                for(int x = 0; x < width; x++)
+                {
+                    const uint8_t * pixel = src + x * SRC::channels;
+                    const uint8_t alpha = SRC::a >= 0 ? pixel[SRC::a >= 0 ? SRC::a : 0] : 255;
+                    write_color<DST>(dst + x * DST::channels, pixel[SRC::r], pixel[SRC::g], pixel[SRC::b], alpha);
+                }
+            }
+
+            template<typename SRC>
+            CONVERSION_ROW_KERNEL void color_to_gray_row(const uint8_t * src, int width, uint8_t * dst)
+            {
+                for(int x = 0; x < width; x++)
+                {
+                    const uint8_t * pixel = src + x * SRC::channels;
+                    dst[x] = static_cast<uint8_t>((pixel[SRC::r] * R2Y + pixel[SRC::g] * G2Y + pixel[SRC::b] * B2Y + (1 << (Y_SHIFT - 1))) >> Y_SHIFT);
+                }
+            }
+
+            CONVERSION_ROW_KERNEL void yuyv_to_gray_row(const uint8_t * src, int width, uint8_t * dst)
+            {
+                for(int x = 0; x < width; x++)
+                {
+                    dst[x] = src[2 * x];
+                }
+            }
+
+            //yuyv pixels come in pairs sharing the chroma, an odd last pixel is left untouched
+            template<typename DST>
+            CONVERSION_ROW_KERNEL void yuyv_to_color_row(const uint8_t * src, int width, uint8_t * dst)
+            {
+                for(int x = 0; x + 1 < width; x += 2)
+                {
+                    const uint8_t * pair = src + 2 * x;
+                    const int u = static_cast<int>(pair[1]) - 128;
+                    const int v = static_cast<int>(pair[3]) - 128;
+                    const int ruv = (1 << (YUV_SHIFT - 1)) + YUV_CVR * v;
+                    const int guv = (1 << (YUV_SHIFT - 1)) + YUV_CVG * v + YUV_CUG * u;
+                    const int buv = (1 << (YUV_SHIFT - 1)) + YUV_CUB * u;
+                    const int y0 = std::max(0, static_cast<int>(pair[0]) - 16) * YUV_CY;
+                    const int y1 = std::max(0, static_cast<int>(pair[2]) - 16) * YUV_CY;
+                    write_color<DST>(dst + x * DST::channels, saturate_to_8u((y0 + ruv) >> YUV_SHIFT),
+                                     saturate_to_8u((y0 + guv) >> YUV_SHIFT), saturate_to_8u((y0 + buv) >> YUV_SHIFT), 255);
+                    write_color<DST>(dst + (x + 1) * DST::channels, saturate_to_8u((y1 + ruv) >> YUV_SHIFT),
+                                     saturate_to_8u((y1 + guv) >> YUV_SHIFT), saturate_to_8u((y1 + buv) >> YUV_SHIFT), 255);
+                }
+            }
+
+            //scales 16 bit values to 8 bit with rounding and saturation
+            inline uint8_t scale_to_8u(uint16_t value, float scale)
+            {
+                const long scaled = lrintf(static_cast<float>(value) * scale);
+                return static_cast<uint8_t>(scaled > 255 ? 255 : scaled);
             }
 
-            try
+            template<typename DST>
+            CONVERSION_ROW_KERNEL void gray16_to_color_row(const uint16_t * src, int width, float scale, uint8_t * dst)
             {
-                pixel_format src_format;
-                cv::Mat src_mat;
-                cv::Mat temp = cv::Mat(src_info.height, src_info.width, rs_format_to_cv_pixel_type(src_info.format), const_cast<uint8_t*>(src_data));
-                auto dst_mat = cv::Mat(dst_info.height, src_info.width, rs_format_to_cv_pixel_type(dst_info.format), const_cast<uint8_t*>(dst_data));
-                switch(src_info.format)
+                for(int x = 0; x < width; x++)
                 {
-                    case rs::core::pixel_format::z16:
+                    const uint8_t gray = scale_to_8u(src[x], scale);
+                    write_color<DST>(dst + x * DST::channels, gray, gray, gray, 255);
+                }
+            }
+
+            /**
+             * @brief The hot colormap, black to red to yellow to white, sampled at 256 levels.
+             *
+             * The colormap is linearly interpolated from 64 control colors, which rise the red channel over the first 3/8 of the range,
+             * then the green channel over the next 3/8 and the blue channel over the last 1/4.
+             */
+            struct hot_colormap
+            {
+                uint8_t colors[256][3];
+
+                hot_colormap()
+                {
+                    const int control_points = 64, rise_points = 24;
+                    auto control_value = [&](int channel, int index) -> double
+                    {
+                        const int rise_begin = channel * rise_points;
+                        const int rise_length = channel == 2 ? control_points - 2 * rise_points : rise_points;
+                        if(index < rise_begin) return 0.;
+                        return std::min(1., static_cast<double>(index - rise_begin + 1) / rise_length);
+                    };
+                    for(int level = 0; level < 256; level++)
                     {
-                        double min, max;
-                        cv::minMaxIdx(temp, &min, &max);
-                        max = max > 3000 ? 3000 : max;
-                        cv::Mat color_map;
-                        cv::convertScaleAbs(temp, color_map, 255 / max);
-                        if(dst_info.format == pixel_format::rgb8)
+                        const double position = level * (control_points - 1) / 255.;
+                        const int index = std::min(static_cast<int>(position), control_points - 2);
+                        const double weight = position - index;
+                        for(int channel = 0; channel < 3; channel++)
                         {
-                            cv::applyColorMap(color_map, dst_mat, cv::COLORMAP_HOT);
-                            return status_no_error;
+                            const double value = control_value(channel, index) * (1. - weight) + control_value(channel, index + 1) * weight;
+                            colors[level][channel] = static_cast<uint8_t>(lrint(value * 255.));
                         }
-                        cv::applyColorMap(color_map, src_mat, cv::COLORMAP_HOT);
-                        src_format = pixel_format::rgb8;
-                        break;
                     }
-                    case rs::core::pixel_format::y16:
+                }
+            };
+
+            //the colors are written with the red and the blue channels swapped relative to the destination layout,
+            //the same bytes the previous OpenCV based conversion produced from its BGR colormap output
+            template<typename DST>
+            CONVERSION_ROW_KERNEL void depth_to_color_row(const uint16_t * src, int width, float scale, const hot_colormap & colormap, uint8_t * dst)
+            {
+                for(int x = 0; x < width; x++)
+                {
+                    const uint8_t * color = colormap.colors[scale_to_8u(src[x], scale)];
+                    write_color<DST>(dst + x * DST::channels, color[2], color[1], color[0], 255);
+                }
+            }
+
+            /**
+             * @brief The colors of all the z16 values in a fixed depth range, the hot colormap level of each value precomputed.
+             *
+             * The values up to the range minimum are black, the values from the range maximum are white, so a colorization with a fixed
+             * range is a single lookup per pixel, without the statistics pass of the image maximal value.
+             */
+            struct depth_color_lut
+            {
+                uint16_t min_depth;
+                uint16_t max_depth;
+                uint8_t colors[65536][3]; // r, g, b of each value, with the hot colormap red and blue channels swapped
+
+                depth_color_lut(uint16_t min_depth, uint16_t max_depth) : min_depth(min_depth), max_depth(max_depth)
+                {
+                    static const hot_colormap colormap;
+                    const float scale = 255.f / (max_depth - min_depth);
+                    for(int value = 0; value < 65536; value++)
                     {
-                        double min, max;
-                        cv::minMaxIdx(temp, &min, &max);
-                        cv::convertScaleAbs(temp, src_mat, 255 / max);
-                        src_format = src_info.format;
-                        break;
+                        const uint16_t offset = static_cast<uint16_t>(value > min_depth ? value - min_depth : 0);
+                        const uint8_t * color = colormap.colors[scale_to_8u(offset, scale)];
+                        colors[value][0] = color[2];
+                        colors[value][1] = color[1];
+                        colors[value][2] = color[0];
                     }
-                    default:
+                }
+            };
+
+            //the table of the depth colorization range, null while the depth is scaled by each image maximal value.
+            //the table is replaced when the range is set, the converters of the previous range keep their table
+            std::mutex depth_color_lut_lock;
+            std::shared_ptr<const depth_color_lut> depth_color_lut_instance;
+
+            std::shared_ptr<const depth_color_lut> query_depth_color_lut()
+            {
+                std::lock_guard<std::mutex> lock(depth_color_lut_lock);
+                return depth_color_lut_instance;
+            }
+
+            template<typename DST>
+            CONVERSION_ROW_KERNEL void depth_lut_to_color_row(const uint16_t * src, int width, const depth_color_lut & lut, uint8_t * dst)
+            {
+                for(int x = 0; x < width; x++)
+                {
+                    const uint8_t * color = lut.colors[src[x]];
+                    write_color<DST>(dst + x * DST::channels, color[0], color[1], color[2], 255);
+                }
+            }
+
+            //16 bit kernels read their source row as 16 bit values
+            template<typename KERNEL>
+            image_conversion_util::row_converter gray16_kernel_row_converter(KERNEL kernel)
+            {
+                return [kernel](const uint8_t * src, int width, uint8_t * dst) { kernel(reinterpret_cast<const uint16_t *>(src), width, dst); };
+            }
+
+            template<typename DST>
+            image_conversion_util::row_converter color_row_converter(pixel_format src_format)
+            {
+                switch(src_format)
+                {
+                    case pixel_format::raw8:
+                    case pixel_format::y8:   return gray_to_color_row<DST>;
+                    case pixel_format::rgb8: return color_to_color_row<rgb_layout, DST>;
+                    case pixel_format::bgr8: return color_to_color_row<bgr_layout, DST>;
+                    case pixel_format::rgba8: return color_to_color_row<rgba_layout, DST>;
+                    case pixel_format::bgra8: return color_to_color_row<bgra_layout, DST>;
+                    case pixel_format::yuyv: return yuyv_to_color_row<DST>;
+                    default: return nullptr;
+                }
+            }
+
+            template<typename DST>
+            image_conversion_util::row_converter depth_lut_row_converter(std::shared_ptr<const depth_color_lut> lut)
+            {
+                return gray16_kernel_row_converter([lut](const uint16_t * src, int width, uint8_t * dst)
+                {
+                    depth_lut_to_color_row<DST>(src, width, *lut, dst);
+                });
+            }
+
+            template<typename DST>
+            image_conversion_util::row_converter gray16_row_converter(pixel_format src_format, float scale)
+            {
+                if(src_format == pixel_format::z16)
+                {
+                    static const hot_colormap colormap;
+                    return gray16_kernel_row_converter([scale](const uint16_t * src, int width, uint8_t * dst)
                     {
-                        src_format = src_info.format;
-                        src_mat = temp;
+                        depth_to_color_row<DST>(src, width, scale, colormap, dst);
+                    });
+                }
+                return gray16_kernel_row_converter([scale](const uint16_t * src, int width, uint8_t * dst)
+                {
+                    gray16_to_color_row<DST>(src, width, scale, dst);
+                });
+            }
+
+            image_conversion_util::row_converter gray_row_converter(pixel_format src_format)
+            {
+                switch(src_format)
+                {
+                    case pixel_format::rgb8: return color_to_gray_row<rgb_layout>;
+                    case pixel_format::bgr8: return color_to_gray_row<bgr_layout>;
+                    case pixel_format::rgba8: return color_to_gray_row<rgba_layout>;
+                    case pixel_format::bgra8: return color_to_gray_row<bgra_layout>;
+                    case pixel_format::yuyv: return yuyv_to_gray_row;
+                    default: return nullptr;
+                }
+            }
+        }
+
+        status image_conversion_util::is_conversion_valid(const image_info &src_info, const image_info &dst_info)
+        {
+            return is_format_conversion_valid(src_info.format, dst_info.format) ? status_no_error : status_param_unsupported;
+        }
+
+        image_conversion_util::row_converter image_conversion_util::query_row_converter(const image_info &src_info, const uint8_t *src_data,
+                                                                                        const rect &roi, pixel_format dst_format)
+        {
+            if(!is_format_conversion_valid(src_info.format, dst_format) || !src_data)
+            {
+                return nullptr;
+            }
+
+            if(src_info.format == pixel_format::z16)
+            {
+                //a fixed depth range colors each value by its precomputed color
+                auto lut = query_depth_color_lut();
+                if(lut)
+                {
+                    switch(dst_format)
+                    {
+                        case pixel_format::rgb8:  return depth_lut_row_converter<rgb_layout>(lut);
+                        case pixel_format::bgr8:  return depth_lut_row_converter<bgr_layout>(lut);
+                        case pixel_format::rgba8: return depth_lut_row_converter<rgba_layout>(lut);
+                        case pixel_format::bgra8: return depth_lut_row_converter<bgra_layout>(lut);
+                        default: return nullptr;
                     }
                 }
-                cv::cvtColor(src_mat, dst_mat, get_cv_convert_enum(src_format, dst_info.format));
+            }
+
+            if(src_info.format == pixel_format::z16 || src_info.format == pixel_format::y16)
+            {
+                //the values are scaled so the maximal value, clamped for depth, maps to 255
+                rs::utils::image_statistics::statistics stats = {};
+                rs::utils::image_statistics::query_statistics(src_info, src_data, roi, stats);
+                double max = stats.max_value;
+                if(src_info.format == pixel_format::z16 && max > MAX_COLORED_DEPTH)
+                    max = MAX_COLORED_DEPTH;
+                const float scale = max > 0 ? static_cast<float>(255 / max) : 0.f;
+                switch(dst_format)
+                {
+                    case pixel_format::rgb8:  return gray16_row_converter<rgb_layout>(src_info.format, scale);
+                    case pixel_format::bgr8:  return gray16_row_converter<bgr_layout>(src_info.format, scale);
+                    case pixel_format::rgba8: return gray16_row_converter<rgba_layout>(src_info.format, scale);
+                    case pixel_format::bgra8: return gray16_row_converter<bgra_layout>(src_info.format, scale);
+                    default: return nullptr;
+                }
+            }
+
+            switch(dst_format)
+            {
+                case pixel_format::rgb8:  return color_row_converter<rgb_layout>(src_info.format);
+                case pixel_format::bgr8:  return color_row_converter<bgr_layout>(src_info.format);
+                case pixel_format::rgba8: return color_row_converter<rgba_layout>(src_info.format);
+                case pixel_format::bgra8: return color_row_converter<bgra_layout>(src_info.format);
+                case pixel_format::y8:    return gray_row_converter(src_info.format);
+                default: return nullptr;
+            }
+        }
+
+        status image_conversion_util::set_depth_colorization_range(uint16_t min_depth, uint16_t max_depth)
+        {
+            if(min_depth == 0 && max_depth == 0)
+            {
+                std::lock_guard<std::mutex> lock(depth_color_lut_lock);
+                depth_color_lut_instance.reset();
                 return status_no_error;
             }
-            catch(const std::exception& ex)
+            if(max_depth <= min_depth)
             {
-                //auto what = ex.what();
-                //TODO: log exception
-                return status_exec_aborted;
+                return status_invalid_argument;
             }
 
+            //the table is rebuilt only when the range changes
+            auto current = query_depth_color_lut();
+            if(current && current->min_depth == min_depth && current->max_depth == max_depth)
+            {
+                return status_no_error;
+            }
+            std::shared_ptr<const depth_color_lut> lut = std::make_shared<depth_color_lut>(min_depth, max_depth);
+            std::lock_guard<std::mutex> lock(depth_color_lut_lock);
+            depth_color_lut_instance = lut;
             return status_no_error;
         }
 
-        int image_conversion_util::rs_format_to_cv_pixel_type(rs::core::pixel_format format)
+        bool image_conversion_util::query_depth_colorization_range(uint16_t &min_depth, uint16_t &max_depth)
         {
-            switch(format)
+            auto lut = query_depth_color_lut();
+            if(!lut)
             {
-                case rs::core::pixel_format::y8:
-                case rs::core::pixel_format::raw8: return CV_8UC1;
-                case rs::core::pixel_format::raw16:
-                case rs::core::pixel_format::z16:
-                case rs::core::pixel_format::y16: return CV_16UC1;
-                case rs::core::pixel_format::bgr8:
-                case rs::core::pixel_format::rgb8: return CV_8UC3;
-                case rs::core::pixel_format::rgba8:
-                case rs::core::pixel_format::bgra8: return CV_8UC4;
-                case rs::core::pixel_format::yuyv: return CV_8UC2;
-                default:
-                    return -1;
+                return false;
+            }
+            min_depth = lut->min_depth;
+            max_depth = lut->max_depth;
+            return true;
+        }
+
+        status image_conversion_util::convert(const image_info &src_info, const uint8_t *src_data, const image_info &dst_info, uint8_t *dst_data)
+        {
+            auto is_valid_status = is_conversion_valid(src_info, dst_info);
+            if(is_valid_status != status_no_error)
+            {
+                return is_valid_status;
+            }
+            if(!src_data || !dst_data)
+            {
+                return status_handle_invalid;
             }
+
+            const row_converter convert_row = query_row_converter(src_info, src_data, {}, dst_info.format);
+            if(!convert_row)
+            {
+                return status_param_unsupported;
+            }
+
+            for_each_rows_band(src_info, [&](int begin_row, int end_row)
+            {
+                for(int y = begin_row; y < end_row; y++)
+                {
+                    convert_row(src_data + static_cast<size_t>(y) * src_info.pitch, src_info.width, dst_data + static_cast<size_t>(y) * dst_info.pitch);
+                }
+            });
+            return status_no_error;
         }
 
-        int image_conversion_util::get_cv_convert_enum(rs::core::pixel_format from, rs::core::pixel_format to)
+        bool image_conversion_util::is_format_conversion_valid(rs::core::pixel_format from, rs::core::pixel_format to)
         {
             switch(from)
             {
                 case rs::core::pixel_format::raw8:
                 case rs::core::pixel_format::y8:
-                    switch(to)
-                    {
-                        case rs::core::pixel_format::bgr8: return CV_GRAY2BGR;
-                        case rs::core::pixel_format::rgb8: return CV_GRAY2RGB;
-                        case rs::core::pixel_format::rgba8: return CV_GRAY2RGBA;
-                        case rs::core::pixel_format::bgra8: return CV_GRAY2BGRA;
-                        default:
-                            return -1;
-                    }
                 case rs::core::pixel_format::z16:
                 case rs::core::pixel_format::y16:
-                    switch(to)
-                    {
-                        case rs::core::pixel_format::bgr8: return CV_GRAY2BGR;
-                        case rs::core::pixel_format::rgb8: return CV_GRAY2RGB;
-                        case rs::core::pixel_format::rgba8: return CV_GRAY2RGBA;
-                        case rs::core::pixel_format::bgra8: return CV_GRAY2BGRA;
-                        default:
-                            return -1;
-                    }
+                    return to == pixel_format::bgr8 || to == pixel_format::rgb8 || to == pixel_format::rgba8 || to == pixel_format::bgra8;
                 case rs::core::pixel_format::bgr8:
-                    switch(to)
-                    {
-                        case rs::core::pixel_format::y8: return CV_BGR2GRAY;
-                        case rs::core::pixel_format::rgb8: return CV_BGR2RGB;
-                        case rs::core::pixel_format::rgba8: return CV_BGR2RGBA;
-                        case rs::core::pixel_format::bgra8: return CV_BGR2BGRA;
-                        default:
-                            return -1;
-                    }
                 case rs::core::pixel_format::rgb8:
-                    switch(to)
-                    {
-                        case rs::core::pixel_format::y8: return CV_RGB2GRAY;
-                        case rs::core::pixel_format::bgr8: return CV_RGB2BGR;
-                        case rs::core::pixel_format::rgba8: return CV_RGB2RGBA;
-                        case rs::core::pixel_format::bgra8: return CV_RGB2BGRA;
-                        default:
-                            return -1;
-                    }
                 case rs::core::pixel_format::rgba8:
-                    switch(to)
-                    {
-                        case rs::core::pixel_format::y8: return CV_RGBA2GRAY;
-                        case rs::core::pixel_format::bgr8: return CV_RGBA2BGR;
-                        case rs::core::pixel_format::rgb8: return CV_RGBA2RGB;
-                        case rs::core::pixel_format::bgra8: return CV_RGBA2BGRA;
-                        default:
-                            return -1;
-                    }
                 case rs::core::pixel_format::bgra8:
-                    switch(to)
-                    {
-                        case rs::core::pixel_format::y8: return CV_BGRA2GRAY;
-                        case rs::core::pixel_format::bgr8: return CV_BGRA2BGR;
-                        case rs::core::pixel_format::rgb8: return CV_BGRA2RGB;
-                        case rs::core::pixel_format::rgba8: return CV_BGRA2RGBA;
-                        default:
-                            return -1;
-                    }
                 case rs::core::pixel_format::yuyv:
-                    switch(to)
-                    {
-                        case rs::core::pixel_format::y8: return CV_YUV2GRAY_YUYV;
-                        case rs::core::pixel_format::bgr8: return CV_YUV2BGR_YUYV;
-                        case rs::core::pixel_format::rgb8: return CV_YUV2RGB_YUYV;
-                        case rs::core::pixel_format::rgba8: return CV_YUV2RGBA_YUYV;
-                        case rs::core::pixel_format::bgra8: return CV_YUV2BGRA_YUYV;
-                        default:
-                            return -1;
-                    }
+                    return to != from && (to == pixel_format::y8 || to == pixel_format::bgr8 || to == pixel_format::rgb8 ||
+                                          to == pixel_format::rgba8 || to == pixel_format::bgra8);
                 default:
-                    return -1;
+                    return false;
             }
         }
+
+        void image_conversion_util::for_each_rows_band(const image_info &info, const rows_converter &convert_rows)
+        {
+            image_rows_bands::for_each(info.height, image_rows_bands::query_number_of_bands(info.width, info.height),
+                                       [&convert_rows](int band, int begin_row, int end_row) { convert_rows(begin_row, end_row); });
+        }
     }
 }
@@ -2,6 +2,7 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #pragma once
+#include <functional>
 #include "rs/core/image_interface.h"
 #include "rs/core/types.h"
 #include "rs/core/status.h"
@@ -17,11 +18,29 @@ namespace rs
             image_conversion_util & operator = (const image_conversion_util &) = delete;
             ~image_conversion_util() = delete;
         public:
+            //converts a row of width pixels
+            typedef std::function<void(const uint8_t *src_row, int width, uint8_t *dst_row)> row_converter;
+
             static status convert(const image_info &src_info, const uint8_t *src_data, const image_info &dst_info, uint8_t *dst_data);
             static status is_conversion_valid(const image_info &src_info, const image_info &dst_info);
+            /**
+             * @brief Returns the converter of the rows of the image to the format, null if the conversion is unsupported.
+             *
+             * The 16 bit formats are scaled by the maximal value of the region of interest, an empty region is the whole image.
+             * The converter may be applied to rows gathered from the image, in the image format.
+             */
+            static row_converter query_row_converter(const image_info &src_info, const uint8_t *src_data, const rect &roi, pixel_format dst_format);
+            //sets the fixed z16 colorization range, whose colors table is built once, (0, 0) scales each image by its maximal value
+            static status set_depth_colorization_range(uint16_t min_depth, uint16_t max_depth);
+            //returns false while each image is scaled by its maximal value
+            static bool query_depth_colorization_range(uint16_t &min_depth, uint16_t &max_depth);
         private:
-            static int rs_format_to_cv_pixel_type(rs::core::pixel_format format);
-            static int get_cv_convert_enum(rs::core::pixel_format from, rs::core::pixel_format to);
+            //converts the rows [begin_row, end_row) of the image
+            typedef std::function<void(int begin_row, int end_row)> rows_converter;
+
+            static bool is_format_conversion_valid(rs::core::pixel_format from, rs::core::pixel_format to);
+            //large images are converted in parallel row bands
+            static void for_each_rows_band(const image_info &info, const rows_converter &convert_rows);
         };
     }
 }
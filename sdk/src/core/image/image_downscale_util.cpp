@@ -0,0 +1,132 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "image_downscale_util.h"
+#include "image_rows_bands.h"
+
+#include <algorithm>
+
+//see image_conversion_util.cpp, the row kernels are vectorized by the compiler for each instruction set
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 6) && defined(__x86_64__) && defined(__linux__)
+#define DOWNSCALE_ROW_KERNEL __attribute__((target_clones("avx2","default")))
+#else
+#define DOWNSCALE_ROW_KERNEL
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            //the lower median of the non zero values of each 2x2 block. subtracting 1 wraps the zeros to the largest value,
+            //so they sort last, and the second smallest value is a valid one only if at most one value is zero
+            DOWNSCALE_ROW_KERNEL void median_depth_row(const uint16_t * src_row0, const uint16_t * src_row1, uint16_t * dst, int dst_width)
+            {
+                for(int x = 0; x < dst_width; x++)
+                {
+                    const uint16_t a = static_cast<uint16_t>(src_row0[2 * x] - 1), b = static_cast<uint16_t>(src_row0[2 * x + 1] - 1);
+                    const uint16_t c = static_cast<uint16_t>(src_row1[2 * x] - 1), d = static_cast<uint16_t>(src_row1[2 * x + 1] - 1);
+                    const uint16_t low0 = std::min(a, b), high0 = std::max(a, b);
+                    const uint16_t low1 = std::min(c, d), high1 = std::max(c, d);
+                    const uint16_t smallest = std::min(low0, low1);
+                    const uint16_t second = std::min(std::max(low0, low1), std::min(high0, high1));
+                    const int zeros = (src_row0[2 * x] == 0) + (src_row0[2 * x + 1] == 0) + (src_row1[2 * x] == 0) + (src_row1[2 * x + 1] == 0);
+                    dst[x] = static_cast<uint16_t>((zeros <= 1 ? second : smallest) + 1);
+                }
+            }
+
+            template<typename T>
+            DOWNSCALE_ROW_KERNEL void mean_row(const T * src_row0, const T * src_row1, T * dst, int dst_width, int channels)
+            {
+                for(int x = 0; x < dst_width; x++)
+                {
+                    for(int channel = 0; channel < channels; channel++)
+                    {
+                        const int left = 2 * x * channels + channel;
+                        const uint32_t sum = static_cast<uint32_t>(src_row0[left]) + src_row0[left + channels] + src_row1[left] + src_row1[left + channels];
+                        dst[x * channels + channel] = static_cast<T>((sum + 2) / 4);
+                    }
+                }
+            }
+
+            //the channels of a pixel, 0 if the format can't be downscaled
+            int query_channels(pixel_format format)
+            {
+                switch(format)
+                {
+                    case pixel_format::z16:
+                    case pixel_format::disparity16:
+                    case pixel_format::y8:
+                    case pixel_format::y16:
+                    case pixel_format::raw8:
+                        return 1;
+                    case pixel_format::rgb8:
+                    case pixel_format::bgr8:
+                        return 3;
+                    case pixel_format::rgba8:
+                    case pixel_format::bgra8:
+                        return 4;
+                    default:
+                        return 0;
+                }
+            }
+        }
+
+        image_info image_downscale_util::query_downscaled_info(const image_info &src_info)
+        {
+            image_info dst_info = src_info;
+            dst_info.width = src_info.width / 2;
+            dst_info.height = src_info.height / 2;
+            dst_info.pitch = image_interface::query_aligned_pitch(dst_info.width * get_pixel_size(src_info.format));
+            return dst_info;
+        }
+
+        status image_downscale_util::is_downscale_valid(const image_info &src_info)
+        {
+            return query_channels(src_info.format) && src_info.width >= 2 && src_info.height >= 2 ? status_no_error : status_param_unsupported;
+        }
+
+        status image_downscale_util::downscale(const image_info &src_info, const uint8_t *src_data, const image_info &dst_info, uint8_t *dst_data)
+        {
+            auto is_valid_status = is_downscale_valid(src_info);
+            if(is_valid_status != status_no_error)
+            {
+                return is_valid_status;
+            }
+            if(!src_data || !dst_data)
+            {
+                return status_handle_invalid;
+            }
+
+            const int channels = query_channels(src_info.format);
+            const bool is_depth = src_info.format == pixel_format::z16 || src_info.format == pixel_format::disparity16;
+            const bool is_16_bits = get_pixel_size(src_info.format) == 2;
+            image_rows_bands::for_each(dst_info.height, image_rows_bands::query_number_of_bands(src_info.width, src_info.height),
+                                       [&](int band, int begin_row, int end_row)
+            {
+                for(int y = begin_row; y < end_row; y++)
+                {
+                    const uint8_t * src_row0 = src_data + static_cast<size_t>(2 * y) * src_info.pitch;
+                    const uint8_t * src_row1 = src_row0 + src_info.pitch;
+                    uint8_t * dst = dst_data + static_cast<size_t>(y) * dst_info.pitch;
+                    if(is_depth)
+                    {
+                        median_depth_row(reinterpret_cast<const uint16_t *>(src_row0), reinterpret_cast<const uint16_t *>(src_row1),
+                                         reinterpret_cast<uint16_t *>(dst), dst_info.width);
+                    }
+                    else if(is_16_bits)
+                    {
+                        mean_row<uint16_t>(reinterpret_cast<const uint16_t *>(src_row0), reinterpret_cast<const uint16_t *>(src_row1),
+                                           reinterpret_cast<uint16_t *>(dst), dst_info.width, channels);
+                    }
+                    else
+                    {
+                        mean_row<uint8_t>(src_row0, src_row1, dst, dst_info.width, channels);
+                    }
+                }
+            });
+            return status_no_error;
+        }
+    }
+}
@@ -0,0 +1,37 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "rs/core/image_interface.h"
+#include "rs/core/types.h"
+#include "rs/core/status.h"
+
+namespace rs
+{
+    namespace core
+    {
+        class image_downscale_util
+        {
+            image_downscale_util() = delete;
+            image_downscale_util(const image_downscale_util &) = delete;
+            image_downscale_util & operator = (const image_downscale_util &) = delete;
+            ~image_downscale_util() = delete;
+        public:
+            /**
+             * @brief Returns the info of the image downscaled by half, with a minimal pitch. An odd last row or column is dropped.
+             */
+            static image_info query_downscaled_info(const image_info &src_info);
+
+            static status is_downscale_valid(const image_info &src_info);
+
+            /**
+             * @brief Downscales the image by half, dst_info is the info returned by \c query_downscaled_info.
+             *
+             * Each destination pixel is computed from a 2x2 block of source pixels. z16 and disparity16 blocks take the lower median
+             * of their non zero pixels, so a block across an edge takes the depth of one of its surfaces rather than a depth between
+             * them. The other formats take the rounded mean of each channel.
+             */
+            static status downscale(const image_info &src_info, const uint8_t *src_data, const image_info &dst_info, uint8_t *dst_data);
+        };
+    }
+}
@@ -0,0 +1,196 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "image_rotation_util.h"
+
+#include <algorithm>
+#include <cstring>
+
+//see image_conversion_util.cpp, the tile kernels are vectorized by the compiler for each instruction set
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 6) && defined(__x86_64__) && defined(__linux__)
+#define ROTATION_TILE_KERNEL __attribute__((target_clones("avx2","default")))
+#else
+#define ROTATION_TILE_KERNEL
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            //a tile of 32x32 pixels of 4 bytes reads and writes 32 cache lines
+            const int TILE_SIZE = 32;
+
+            template<int BYTES> struct pixel
+            {
+                uint8_t bytes[BYTES];
+            };
+
+            template<int BYTES> inline const pixel<BYTES> * row_of(const uint8_t * data, int pitch, int row)
+            {
+                return reinterpret_cast<const pixel<BYTES> *>(data + static_cast<size_t>(row) * pitch);
+            }
+
+            template<int BYTES> inline pixel<BYTES> * row_of(uint8_t * data, int pitch, int row)
+            {
+                return reinterpret_cast<pixel<BYTES> *>(data + static_cast<size_t>(row) * pitch);
+            }
+
+            //rotates by 90 degrees clockwise when clockwise is set, by 270 degrees otherwise,
+            //dst(x, y) is src(y, src_height - 1 - x) when rotating by 90 degrees and src(src_width - 1 - y, x) when rotating by 270 degrees
+            template<int BYTES, bool CLOCKWISE>
+            ROTATION_TILE_KERNEL void transpose_tile(const image_info & src_info, const uint8_t * src_data, const image_info & dst_info, uint8_t * dst_data,
+                                                     int tile_x, int tile_y)
+            {
+                const int end_x = std::min(tile_x + TILE_SIZE, dst_info.width);
+                const int end_y = std::min(tile_y + TILE_SIZE, dst_info.height);
+                //each destination row of the tile walks up or down a source column
+                const ptrdiff_t src_step = CLOCKWISE ? -static_cast<ptrdiff_t>(src_info.pitch) : src_info.pitch;
+                for(int y = tile_y; y < end_y; y++)
+                {
+                    pixel<BYTES> * dst = row_of<BYTES>(dst_data, dst_info.pitch, y);
+                    const int src_x = CLOCKWISE ? y : src_info.width - 1 - y;
+                    const uint8_t * src = reinterpret_cast<const uint8_t *>(row_of<BYTES>(src_data, src_info.pitch, CLOCKWISE ? src_info.height - 1 - tile_x : tile_x) + src_x);
+                    for(int x = tile_x; x < end_x; x++, src += src_step)
+                    {
+                        dst[x] = *reinterpret_cast<const pixel<BYTES> *>(src);
+                    }
+                }
+            }
+
+            template<int BYTES, bool CLOCKWISE>
+            void transpose(const image_info & src_info, const uint8_t * src_data, const image_info & dst_info, uint8_t * dst_data)
+            {
+                for(int tile_y = 0; tile_y < dst_info.height; tile_y += TILE_SIZE)
+                {
+                    for(int tile_x = 0; tile_x < dst_info.width; tile_x += TILE_SIZE)
+                    {
+                        transpose_tile<BYTES, CLOCKWISE>(src_info, src_data, dst_info, dst_data, tile_x, tile_y);
+                    }
+                }
+            }
+
+            template<int BYTES>
+            ROTATION_TILE_KERNEL void reverse_rows(const image_info & src_info, const uint8_t * src_data, const image_info & dst_info, uint8_t * dst_data)
+            {
+                for(int y = 0; y < dst_info.height; y++)
+                {
+                    const pixel<BYTES> * src = row_of<BYTES>(src_data, src_info.pitch, src_info.height - 1 - y);
+                    pixel<BYTES> * dst = row_of<BYTES>(dst_data, dst_info.pitch, y);
+                    for(int x = 0; x < dst_info.width; x++)
+                    {
+                        dst[x] = src[src_info.width - 1 - x];
+                    }
+                }
+            }
+
+            //the yuyv pairs are reversed, and the two luma values of each pair are swapped
+            void reverse_yuyv_rows(const image_info & src_info, const uint8_t * src_data, const image_info & dst_info, uint8_t * dst_data)
+            {
+                const int pairs = src_info.width / 2;
+                for(int y = 0; y < dst_info.height; y++)
+                {
+                    const uint8_t * src = src_data + static_cast<size_t>(src_info.height - 1 - y) * src_info.pitch;
+                    uint8_t * dst = dst_data + static_cast<size_t>(y) * dst_info.pitch;
+                    for(int pair = 0; pair < pairs; pair++)
+                    {
+                        const uint8_t * src_pair = src + 4 * (pairs - 1 - pair);
+                        dst[4 * pair + 0] = src_pair[2];
+                        dst[4 * pair + 1] = src_pair[1];
+                        dst[4 * pair + 2] = src_pair[0];
+                        dst[4 * pair + 3] = src_pair[3];
+                    }
+                }
+            }
+
+            template<int BYTES>
+            void rotate_pixels(const image_info & src_info, const uint8_t * src_data, rs::core::rotation rotation, const image_info & dst_info, uint8_t * dst_data)
+            {
+                switch(rotation)
+                {
+                    case rs::core::rotation::rotation_90_degree:  transpose<BYTES, true>(src_info, src_data, dst_info, dst_data); break;
+                    case rs::core::rotation::rotation_180_degree: reverse_rows<BYTES>(src_info, src_data, dst_info, dst_data); break;
+                    case rs::core::rotation::rotation_270_degree: transpose<BYTES, false>(src_info, src_data, dst_info, dst_data); break;
+                    default: break;
+                }
+            }
+        }
+
+        image_info image_rotation_util::query_rotated_info(const image_info &src_info, rs::core::rotation rotation)
+        {
+            image_info dst_info = src_info;
+            if(rotation == rs::core::rotation::rotation_90_degree || rotation == rs::core::rotation::rotation_270_degree)
+            {
+                dst_info.width = src_info.height;
+                dst_info.height = src_info.width;
+            }
+            dst_info.pitch = image_interface::query_aligned_pitch(dst_info.width * query_pixel_bytes(src_info.format));
+            return dst_info;
+        }
+
+        status image_rotation_util::is_rotation_valid(const image_info &src_info, rs::core::rotation rotation)
+        {
+            switch(rotation)
+            {
+                case rs::core::rotation::rotation_0_degree:
+                case rs::core::rotation::rotation_180_degree:
+                    return query_pixel_bytes(src_info.format) ? status_no_error : status_param_unsupported;
+                case rs::core::rotation::rotation_90_degree:
+                case rs::core::rotation::rotation_270_degree:
+                    return query_pixel_bytes(src_info.format) && src_info.format != pixel_format::yuyv ? status_no_error : status_param_unsupported;
+                default:
+                    return status_param_unsupported;
+            }
+        }
+
+        status image_rotation_util::rotate(const image_info &src_info, const uint8_t *src_data, rs::core::rotation rotation, const image_info &dst_info, uint8_t *dst_data)
+        {
+            auto is_valid_status = is_rotation_valid(src_info, rotation);
+            if(is_valid_status != status_no_error)
+            {
+                return is_valid_status;
+            }
+            if(!src_data || !dst_data)
+            {
+                return status_handle_invalid;
+            }
+            if(rotation == rs::core::rotation::rotation_0_degree)
+            {
+                const size_t row_bytes = static_cast<size_t>(src_info.width) * query_pixel_bytes(src_info.format);
+                for(int y = 0; y < src_info.height; y++)
+                {
+                    memcpy(dst_data + static_cast<size_t>(y) * dst_info.pitch, src_data + static_cast<size_t>(y) * src_info.pitch, row_bytes);
+                }
+                return status_no_error;
+            }
+            if(src_info.format == pixel_format::yuyv)
+            {
+                reverse_yuyv_rows(src_info, src_data, dst_info, dst_data);
+                return status_no_error;
+            }
+
+            switch(query_pixel_bytes(src_info.format))
+            {
+                case 1:  rotate_pixels<1>(src_info, src_data, rotation, dst_info, dst_data); break;
+                case 2:  rotate_pixels<2>(src_info, src_data, rotation, dst_info, dst_data); break;
+                case 3:  rotate_pixels<3>(src_info, src_data, rotation, dst_info, dst_data); break;
+                case 4:  rotate_pixels<4>(src_info, src_data, rotation, dst_info, dst_data); break;
+                case 12: rotate_pixels<12>(src_info, src_data, rotation, dst_info, dst_data); break;
+                default: return status_param_unsupported;
+            }
+            return status_no_error;
+        }
+
+        int image_rotation_util::query_pixel_bytes(rs::core::pixel_format format)
+        {
+            switch(format)
+            {
+                //get_pixel_size returns the size of a single coordinate
+                case rs::core::pixel_format::xyz32f: return 3 * get_pixel_size(format);
+                case rs::core::pixel_format::raw10:  return 0;
+                default: return get_pixel_size(format);
+            }
+        }
+    }
+}
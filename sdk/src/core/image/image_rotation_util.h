@@ -0,0 +1,39 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "rs/core/image_interface.h"
+#include "rs/core/types.h"
+#include "rs/core/status.h"
+
+namespace rs
+{
+    namespace core
+    {
+        class image_rotation_util
+        {
+            image_rotation_util() = delete;
+            image_rotation_util(const image_rotation_util &) = delete;
+            image_rotation_util & operator = (const image_rotation_util &) = delete;
+            ~image_rotation_util() = delete;
+        public:
+            /**
+             * @brief Returns the info of the image rotated clockwise, with a minimal pitch.
+             */
+            static image_info query_rotated_info(const image_info &src_info, rs::core::rotation rotation);
+
+            static status is_rotation_valid(const image_info &src_info, rs::core::rotation rotation);
+
+            /**
+             * @brief Rotates the image clockwise, dst_info is the info returned by \c query_rotated_info.
+             *
+             * The 90 and 270 degrees rotations transpose the image in square tiles, so both the source and the destination
+             * tile rows stay in the cache. yuyv images only support 180 degrees, as their pixels pairs share the chroma.
+             */
+            static status rotate(const image_info &src_info, const uint8_t *src_data, rs::core::rotation rotation, const image_info &dst_info, uint8_t *dst_data);
+        private:
+            //the bytes of a pixel, 0 if the format can't be rotated pixel by pixel
+            static int query_pixel_bytes(rs::core::pixel_format format);
+        };
+    }
+}
@@ -0,0 +1,139 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "image_rows_bands.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            const int MAX_NUMBER_OF_WORKERS = 7; //the calling thread processes the eighth band
+
+            //the bands of a for_each call, taken in order by the calling thread and by the workers
+            struct bands_job
+            {
+                const image_rows_bands::band_processor * process_band;
+                int height;
+                int rows_per_band;
+                int number_of_bands;
+                int next_band;
+                int processed_bands;
+                std::condition_variable processed;
+            };
+
+            class bands_workers
+            {
+            public:
+                static bands_workers & instance()
+                {
+                    static bands_workers workers;
+                    return workers;
+                }
+
+                void run(bands_job & job)
+                {
+                    std::unique_lock<std::mutex> lock(m_lock);
+                    if(m_threads.empty())
+                    {
+                        const int hardware_threads = static_cast<int>(std::thread::hardware_concurrency());
+                        const int number_of_workers = std::max(1, std::min(hardware_threads - 1, MAX_NUMBER_OF_WORKERS));
+                        for(int i = 0; i < number_of_workers; i++)
+                        {
+                            m_threads.emplace_back(&bands_workers::work, this);
+                        }
+                    }
+                    m_jobs.push_back(&job);
+                    m_job_ready.notify_all();
+
+                    while(job.next_band < job.number_of_bands)
+                    {
+                        process_next_band(lock, job);
+                    }
+                    job.processed.wait(lock, [&job]() { return job.processed_bands == job.number_of_bands; });
+                }
+
+                ~bands_workers()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_lock);
+                        m_is_stopping = true;
+                    }
+                    m_job_ready.notify_all();
+                    for(auto & thread : m_threads)
+                    {
+                        thread.join();
+                    }
+                }
+
+            private:
+                bands_workers() : m_is_stopping(false) {}
+
+                void work()
+                {
+                    std::unique_lock<std::mutex> lock(m_lock);
+                    while(true)
+                    {
+                        m_job_ready.wait(lock, [this]() { return m_is_stopping || !m_jobs.empty(); });
+                        if(m_is_stopping)
+                        {
+                            return;
+                        }
+                        process_next_band(lock, *m_jobs.front());
+                    }
+                }
+
+                //m_lock is held, and released while the band is processed. the job is removed from the queue once its last band is taken,
+                //and isn't accessed after its last band is counted, since its caller returns then
+                void process_next_band(std::unique_lock<std::mutex> & lock, bands_job & job)
+                {
+                    const int band = job.next_band++;
+                    if(job.next_band == job.number_of_bands)
+                    {
+                        m_jobs.erase(std::find(m_jobs.begin(), m_jobs.end(), &job));
+                    }
+
+                    lock.unlock();
+                    const int begin_row = band * job.rows_per_band;
+                    (*job.process_band)(band, begin_row, std::min(begin_row + job.rows_per_band, job.height));
+                    lock.lock();
+
+                    if(++job.processed_bands == job.number_of_bands)
+                    {
+                        job.processed.notify_one();
+                    }
+                }
+
+                std::mutex m_lock;
+                std::condition_variable m_job_ready;
+                std::deque<bands_job *> m_jobs;
+                std::vector<std::thread> m_threads;
+                bool m_is_stopping;
+            };
+        }
+
+        void image_rows_bands::for_each(int height, int number_of_bands, const band_processor & process_band)
+        {
+            if(number_of_bands <= 1)
+            {
+                process_band(0, 0, height);
+                return;
+            }
+
+            bands_job job;
+            job.process_band = &process_band;
+            job.height = height;
+            job.rows_per_band = (height + number_of_bands - 1) / number_of_bands;
+            job.number_of_bands = (height + job.rows_per_band - 1) / job.rows_per_band;
+            job.next_band = 0;
+            job.processed_bands = 0;
+            bands_workers::instance().run(job);
+        }
+    }
+}
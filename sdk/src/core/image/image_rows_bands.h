@@ -0,0 +1,47 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief Splits the rows of an image to bands, which are processed in parallel by the image utilities.
+         *
+         * The bands are processed by the calling thread and by workers which are created once per process, on the first parallel call,
+         * and are kept for the next calls. The calling thread processes the bands which no worker took, so the calls can be nested or
+         * made by several threads at once without waiting for a free worker.
+         */
+        class image_rows_bands
+        {
+            image_rows_bands() = delete;
+        public:
+            //processes the rows [begin_row, end_row) of the band
+            typedef std::function<void(int band, int begin_row, int end_row)> band_processor;
+
+            //images of at least MIN_PARALLEL_PIXELS are split to bands of at least MIN_BAND_ROWS rows
+            static int query_number_of_bands(int width, int height)
+            {
+                if(width * height < MIN_PARALLEL_PIXELS)
+                {
+                    return 1;
+                }
+                const int hardware_threads = static_cast<int>(std::thread::hardware_concurrency());
+                return std::max(1, std::min({hardware_threads, MAX_NUMBER_OF_BANDS, height / MIN_BAND_ROWS}));
+            }
+
+            //returns once all the bands are processed, a single band is processed on the calling thread
+            static void for_each(int height, int number_of_bands, const band_processor & process_band);
+
+        private:
+            static const int MAX_NUMBER_OF_BANDS = 8;
+            static const int MIN_BAND_ROWS = 64;
+            static const int MIN_PARALLEL_PIXELS = 1 << 19;
+        };
+    }
+}
@@ -0,0 +1,204 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "rs/utils/image_statistics.h"
+#include "image_rows_bands.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+//the row kernels are plain loops, vectorized by the compiler. where the compiler supports it, each kernel is compiled for
+//avx2 and for the baseline instruction set, and the best version is selected once at load time
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 6) && defined(__x86_64__) && defined(__linux__)
+#define STATISTICS_ROW_KERNEL __attribute__((target_clones("avx2","default")))
+#else
+#define STATISTICS_ROW_KERNEL
+#endif
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace utils
+    {
+        namespace
+        {
+            //the zero pixels are replaced by the maximal value before the min reduction, so the loop has no branches
+            template<typename T>
+            STATISTICS_ROW_KERNEL void row_statistics(const T * row, int width, image_statistics::statistics & stats)
+            {
+                T min_value = std::numeric_limits<T>::max(), max_value = 0;
+                uint64_t sum = 0;
+                uint32_t valid_pixels_count = 0;
+                for(int x = 0; x < width; x++)
+                {
+                    const T value = row[x];
+                    min_value = std::min(min_value, value != 0 ? value : std::numeric_limits<T>::max());
+                    max_value = std::max(max_value, value);
+                    sum += value;
+                    valid_pixels_count += value != 0;
+                }
+                stats.min_value = std::min<uint16_t>(stats.min_value, min_value);
+                stats.max_value = std::max<uint16_t>(stats.max_value, max_value);
+                stats.sum += sum;
+                stats.valid_pixels_count += valid_pixels_count;
+            }
+
+            template<typename T>
+            void row_histogram(const T * row, int width, uint32_t bins_count, uint32_t * bins)
+            {
+                const int value_bits = 8 * sizeof(T);
+                for(int x = 0; x < width; x++)
+                {
+                    bins[(static_cast<uint64_t>(row[x]) * bins_count) >> value_bits]++;
+                }
+            }
+
+            bool is_statistics_format(pixel_format format)
+            {
+                return format == pixel_format::z16 || format == pixel_format::y16 || format == pixel_format::y8;
+            }
+
+            //clamps the region of interest to the image, an empty region is the whole image
+            status clamp_roi(const image_info & info, const rect & roi, rect & clamped_roi)
+            {
+                if(roi.x < 0 || roi.y < 0 || roi.width < 0 || roi.height < 0)
+                {
+                    return status_invalid_argument;
+                }
+                if(roi.width == 0 || roi.height == 0)
+                {
+                    clamped_roi = { 0, 0, info.width, info.height };
+                    return status_no_error;
+                }
+                clamped_roi.x = std::min(roi.x, info.width);
+                clamped_roi.y = std::min(roi.y, info.height);
+                clamped_roi.width = std::min(roi.width, info.width - clamped_roi.x);
+                clamped_roi.height = std::min(roi.height, info.height - clamped_roi.y);
+                return status_no_error;
+            }
+
+            template<typename T> inline const T * roi_row_of(const void * data, const image_info & info, const rect & roi, int row)
+            {
+                return reinterpret_cast<const T *>(static_cast<const uint8_t *>(data) + static_cast<size_t>(roi.y + row) * info.pitch) + roi.x;
+            }
+
+            //processes the region of interest rows in bands, each band has its own result which the caller combines
+            template<typename RESULT, typename ROW_PROCESSOR>
+            std::vector<RESULT> process_roi_rows(const rect & roi, const RESULT & initial_result, ROW_PROCESSOR process_row)
+            {
+                const int number_of_bands = image_rows_bands::query_number_of_bands(roi.width, roi.height);
+                std::vector<RESULT> results(number_of_bands, initial_result);
+                image_rows_bands::for_each(roi.height, number_of_bands, [&](int band, int begin_row, int end_row)
+                {
+                    for(int y = begin_row; y < end_row; y++)
+                    {
+                        process_row(y, results[band]);
+                    }
+                });
+                return results;
+            }
+        }
+
+        status image_statistics::query_statistics(const image_info & info, const void * data, const rect & roi, statistics & stats)
+        {
+            if(!data)
+            {
+                return status_handle_invalid;
+            }
+            if(!is_statistics_format(info.format))
+            {
+                return status_param_unsupported;
+            }
+            rect clamped_roi;
+            auto clamp_status = clamp_roi(info, roi, clamped_roi);
+            if(clamp_status != status_no_error)
+            {
+                return clamp_status;
+            }
+
+            statistics initial_stats = { std::numeric_limits<uint16_t>::max(), 0, 0, 0, 0 };
+            std::vector<statistics> bands_stats;
+            if(info.format == pixel_format::y8)
+            {
+                bands_stats = process_roi_rows(clamped_roi, initial_stats, [&](int y, statistics & band_stats)
+                {
+                    row_statistics(roi_row_of<uint8_t>(data, info, clamped_roi, y), clamped_roi.width, band_stats);
+                });
+            }
+            else
+            {
+                bands_stats = process_roi_rows(clamped_roi, initial_stats, [&](int y, statistics & band_stats)
+                {
+                    row_statistics(roi_row_of<uint16_t>(data, info, clamped_roi, y), clamped_roi.width, band_stats);
+                });
+            }
+
+            stats = initial_stats;
+            for(auto & band_stats : bands_stats)
+            {
+                stats.min_value = std::min(stats.min_value, band_stats.min_value);
+                stats.max_value = std::max(stats.max_value, band_stats.max_value);
+                stats.sum += band_stats.sum;
+                stats.valid_pixels_count += band_stats.valid_pixels_count;
+            }
+            stats.pixels_count = static_cast<uint64_t>(clamped_roi.width) * clamped_roi.height;
+            if(stats.valid_pixels_count == 0)
+            {
+                stats.min_value = 0;
+            }
+            return status_no_error;
+        }
+
+        status image_statistics::query_histogram(const image_info & info, const void * data, const rect & roi, uint32_t * bins, uint32_t bins_count)
+        {
+            if(!data || !bins)
+            {
+                return status_handle_invalid;
+            }
+            if(!is_statistics_format(info.format))
+            {
+                return status_param_unsupported;
+            }
+            const uint32_t values_count = info.format == pixel_format::y8 ? 1u << 8 : 1u << 16;
+            if(bins_count == 0 || bins_count > values_count)
+            {
+                return status_invalid_argument;
+            }
+            rect clamped_roi;
+            auto clamp_status = clamp_roi(info, roi, clamped_roi);
+            if(clamp_status != status_no_error)
+            {
+                return clamp_status;
+            }
+
+            std::vector<std::vector<uint32_t>> bands_bins;
+            std::vector<uint32_t> initial_bins(bins_count, 0);
+            if(info.format == pixel_format::y8)
+            {
+                bands_bins = process_roi_rows(clamped_roi, initial_bins, [&](int y, std::vector<uint32_t> & band_bins)
+                {
+                    row_histogram(roi_row_of<uint8_t>(data, info, clamped_roi, y), clamped_roi.width, bins_count, band_bins.data());
+                });
+            }
+            else
+            {
+                bands_bins = process_roi_rows(clamped_roi, initial_bins, [&](int y, std::vector<uint32_t> & band_bins)
+                {
+                    row_histogram(roi_row_of<uint16_t>(data, info, clamped_roi, y), clamped_roi.width, bins_count, band_bins.data());
+                });
+            }
+
+            std::fill(bins, bins + bins_count, 0);
+            for(auto & band_bins : bands_bins)
+            {
+                for(uint32_t bin = 0; bin < bins_count; bin++)
+                {
+                    bins[bin] += band_bins[bin];
+                }
+            }
+            return status_no_error;
+        }
+    }
+}
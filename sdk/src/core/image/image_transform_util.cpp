@@ -0,0 +1,191 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "image_transform_util.h"
+#include "image_conversion_util.h"
+#include "image_rotation_util.h"
+#include "image_rows_bands.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            template<int BYTES> struct pixel
+            {
+                uint8_t bytes[BYTES];
+            };
+
+            //the source pixel of each destination pixel of a row is at the row base plus its offset
+            template<int BYTES>
+            void sample_row(const uint8_t * base, const ptrdiff_t * offsets, int width, uint8_t * dst)
+            {
+                pixel<BYTES> * dst_pixels = reinterpret_cast<pixel<BYTES> *>(dst);
+                for(int x = 0; x < width; x++)
+                {
+                    dst_pixels[x] = *reinterpret_cast<const pixel<BYTES> *>(base + offsets[x]);
+                }
+            }
+
+            //the yuyv pixels of a destination pair take the chroma of the source pair of its first pixel
+            void sample_yuyv_row(const uint8_t * base, const ptrdiff_t * offsets, int width, uint8_t * dst)
+            {
+                for(int x = 0; x < width; x++)
+                {
+                    const ptrdiff_t pair_offset = offsets[x & ~1] & ~static_cast<ptrdiff_t>(3);
+                    dst[2 * x] = base[offsets[x]];
+                    dst[2 * x + 1] = base[pair_offset + 1 + 2 * (x & 1)];
+                }
+            }
+
+            //the nearest source index of each of dst_size samples of src_size pixels
+            inline int nearest(int dst_index, int src_size, int dst_size)
+            {
+                return static_cast<int>((static_cast<int64_t>(2 * dst_index + 1) * src_size) / (2 * static_cast<int64_t>(dst_size)));
+            }
+        }
+
+        status image_transform_util::query_transformed_info(const image_info &src_info, const image_interface::image_transform &parameters,
+                                                            image_interface::image_transform &resolved_parameters, image_info &dst_info)
+        {
+            const rect & crop = parameters.crop;
+            if(crop.x < 0 || crop.y < 0 || crop.width < 0 || crop.height < 0 || parameters.size.width < 0 || parameters.size.height < 0)
+            {
+                return status_invalid_argument;
+            }
+
+            resolved_parameters = parameters;
+            rect & resolved_crop = resolved_parameters.crop;
+            if(crop.width == 0 || crop.height == 0)
+            {
+                resolved_crop = { 0, 0, src_info.width, src_info.height };
+            }
+            resolved_crop.width = std::min(resolved_crop.width, src_info.width - resolved_crop.x);
+            resolved_crop.height = std::min(resolved_crop.height, src_info.height - resolved_crop.y);
+            if(resolved_crop.width <= 0 || resolved_crop.height <= 0)
+            {
+                return status_param_unsupported;
+            }
+
+            if(resolved_parameters.format == pixel_format::any)
+            {
+                resolved_parameters.format = src_info.format;
+            }
+            image_info converted_info = src_info;
+            converted_info.format = resolved_parameters.format;
+            if(!query_pixel_bytes(src_info.format) || image_rotation_util::is_rotation_valid(src_info, parameters.rotation) < status_no_error ||
+               (converted_info.format != src_info.format && image_conversion_util::is_conversion_valid(src_info, converted_info) < status_no_error))
+            {
+                return status_param_unsupported;
+            }
+
+            const bool is_transposed = parameters.rotation == rotation::rotation_90_degree || parameters.rotation == rotation::rotation_270_degree;
+            const int rotated_width = is_transposed ? resolved_crop.height : resolved_crop.width;
+            const int rotated_height = is_transposed ? resolved_crop.width : resolved_crop.height;
+            if(parameters.size.width == 0 || parameters.size.height == 0)
+            {
+                resolved_parameters.size = { rotated_width, rotated_height };
+            }
+
+            dst_info = { resolved_parameters.size.width, resolved_parameters.size.height, resolved_parameters.format,
+                         image_interface::query_aligned_pitch(resolved_parameters.size.width * query_pixel_bytes(resolved_parameters.format)) };
+            return status_no_error;
+        }
+
+        status image_transform_util::transform(const image_info &src_info, const uint8_t *src_data, const image_interface::image_transform &resolved_parameters,
+                                               const image_info &dst_info, uint8_t *dst_data)
+        {
+            if(!src_data || !dst_data)
+            {
+                return status_handle_invalid;
+            }
+
+            const int pixel_bytes = query_pixel_bytes(src_info.format);
+            const rect & crop = resolved_parameters.crop;
+            const rotation rotate = resolved_parameters.rotation;
+            const bool is_transposed = rotate == rotation::rotation_90_degree || rotate == rotation::rotation_270_degree;
+            const int rotated_width = is_transposed ? crop.height : crop.width;
+            const int rotated_height = is_transposed ? crop.width : crop.height;
+
+            //without a transpose the destination rows sample a source row and the columns sample the source columns,
+            //with a transpose the destination rows sample a source column and the columns sample the source rows
+            const ptrdiff_t row_step = is_transposed ? pixel_bytes : src_info.pitch;
+            const ptrdiff_t column_step = is_transposed ? src_info.pitch : pixel_bytes;
+            const int row_origin = is_transposed ? crop.x : crop.y;
+            const int column_origin = is_transposed ? crop.y : crop.x;
+            //the 180 and 270 degrees rotations sample the destination rows in reverse, the 90 and 180 degrees rotations the destination columns
+            const bool is_row_reversed = rotate == rotation::rotation_180_degree || rotate == rotation::rotation_270_degree;
+            const bool is_column_reversed = rotate == rotation::rotation_90_degree || rotate == rotation::rotation_180_degree;
+
+            std::vector<ptrdiff_t> offsets(dst_info.width);
+            for(int x = 0; x < dst_info.width; x++)
+            {
+                const int rotated_x = nearest(x, rotated_width, dst_info.width);
+                const int index = is_column_reversed ? rotated_width - 1 - rotated_x : rotated_x;
+                offsets[x] = (column_origin + index) * column_step;
+            }
+
+            image_conversion_util::row_converter convert_row;
+            if(dst_info.format != src_info.format)
+            {
+                convert_row = image_conversion_util::query_row_converter(src_info, src_data, crop, dst_info.format);
+                if(!convert_row)
+                {
+                    return status_param_unsupported;
+                }
+            }
+
+            void (*sample)(const uint8_t *, const ptrdiff_t *, int, uint8_t *) = nullptr;
+            switch(src_info.format == pixel_format::yuyv ? -1 : pixel_bytes)
+            {
+                case -1: sample = sample_yuyv_row; break;
+                case 1:  sample = sample_row<1>; break;
+                case 2:  sample = sample_row<2>; break;
+                case 3:  sample = sample_row<3>; break;
+                case 4:  sample = sample_row<4>; break;
+                case 12: sample = sample_row<12>; break;
+                default: return status_param_unsupported;
+            }
+
+            image_rows_bands::for_each(dst_info.height, image_rows_bands::query_number_of_bands(dst_info.width, dst_info.height),
+                                       [&](int band, int begin_row, int end_row)
+            {
+                //the sampled row stays in the cache until it's converted
+                std::vector<uint8_t> sampled_row(convert_row ? static_cast<size_t>(dst_info.width) * pixel_bytes : 0);
+                for(int y = begin_row; y < end_row; y++)
+                {
+                    const int rotated_y = nearest(y, rotated_height, dst_info.height);
+                    const int index = is_row_reversed ? rotated_height - 1 - rotated_y : rotated_y;
+                    const uint8_t * base = src_data + (row_origin + index) * row_step;
+                    uint8_t * dst_row = dst_data + static_cast<size_t>(y) * dst_info.pitch;
+                    if(convert_row)
+                    {
+                        sample(base, offsets.data(), dst_info.width, sampled_row.data());
+                        convert_row(sampled_row.data(), dst_info.width, dst_row);
+                    }
+                    else
+                    {
+                        sample(base, offsets.data(), dst_info.width, dst_row);
+                    }
+                }
+            });
+            return status_no_error;
+        }
+
+        int image_transform_util::query_pixel_bytes(pixel_format format)
+        {
+            switch(format)
+            {
+                //get_pixel_size returns the size of a single coordinate
+                case pixel_format::xyz32f: return 3 * get_pixel_size(format);
+                case pixel_format::raw10:  return 0;
+                case pixel_format::any:    return 0;
+                default: return get_pixel_size(format);
+            }
+        }
+    }
+}
@@ -0,0 +1,39 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "rs/core/image_interface.h"
+#include "rs/core/types.h"
+#include "rs/core/status.h"
+
+namespace rs
+{
+    namespace core
+    {
+        class image_transform_util
+        {
+            image_transform_util() = delete;
+            image_transform_util(const image_transform_util &) = delete;
+            image_transform_util & operator = (const image_transform_util &) = delete;
+            ~image_transform_util() = delete;
+        public:
+            /**
+             * @brief Returns the transform with the crop clamped to the image and the defaults resolved, and the info of the transformed image, with a minimal pitch.
+             */
+            static status query_transformed_info(const image_info &src_info, const image_interface::image_transform &parameters,
+                                                 image_interface::image_transform &resolved_parameters, image_info &dst_info);
+
+            /**
+             * @brief Transforms the image with the resolved parameters, dst_info is the info returned by \c query_transformed_info.
+             *
+             * Each destination row samples the nearest source pixels into a row in the source format, which is converted to the
+             * destination row. Without a format conversion the pixels are sampled directly to the destination row.
+             */
+            static status transform(const image_info &src_info, const uint8_t *src_data, const image_interface::image_transform &resolved_parameters,
+                                    const image_info &dst_info, uint8_t *dst_data);
+        private:
+            //the bytes of a pixel, 0 if the format can't be sampled pixel by pixel
+            static int query_pixel_bytes(pixel_format format);
+        };
+    }
+}
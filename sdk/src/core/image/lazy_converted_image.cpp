@@ -0,0 +1,196 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "lazy_converted_image.h"
+#include "rs/utils/smart_ptr_helpers.h"
+
+namespace rs
+{
+    namespace core
+    {
+        lazy_converted_image::lazy_converted_image(image_base * source, const image_info & info)
+            : m_info(info),
+              m_time_stamp(source->query_time_stamp()),
+              m_time_stamp_domain(source->query_time_stamp_domain()),
+              m_flags(source->query_flags()),
+              m_stream(source->query_stream_type()),
+              m_frame_number(source->query_frame_number()),
+              m_references(1),
+              m_source(source),
+              m_data(nullptr),
+              m_data_releaser(nullptr),
+              m_converted_rows(static_cast<size_t>(info.height), false),
+              m_converted_rows_count(0)
+        {
+            source->add_ref();
+        }
+
+        int lazy_converted_image::add_ref() const
+        {
+            return m_references.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        int lazy_converted_image::release() const
+        {
+            int references = 0;
+            if(m_source.load(std::memory_order_acquire) == nullptr)
+            {
+                references = m_references.fetch_sub(1, std::memory_order_acq_rel) - 1;
+            }
+            else
+            {
+                //the source looks up its pending images under its cache lock, the last release removes the image under the same lock
+                std::lock_guard<std::mutex> lock(m_source_lock);
+                image_base * source = m_source.load(std::memory_order_relaxed);
+                if(source)
+                {
+                    std::lock_guard<std::mutex> cache_lock(source->image_caching_lock);
+                    references = m_references.fetch_sub(1, std::memory_order_acq_rel) - 1;
+                    if(references == 0)
+                    {
+                        source->uncache_pending_image(this);
+                    }
+                }
+                else
+                {
+                    references = m_references.fetch_sub(1, std::memory_order_acq_rel) - 1;
+                }
+            }
+
+            if(references == 0)
+            {
+                delete this;
+            }
+            return references;
+        }
+
+        int lazy_converted_image::ref_count() const
+        {
+            return m_references.load(std::memory_order_relaxed);
+        }
+
+        const void * lazy_converted_image::query_data(void) const
+        {
+            //the data of a converted image isn't changed
+            if(m_source.load(std::memory_order_acquire) == nullptr)
+            {
+                return m_data;
+            }
+
+            std::lock_guard<std::mutex> lock(m_lock);
+            if(!convert_rows(0, m_info.height))
+            {
+                return nullptr;
+            }
+            detach_source();
+            return m_data;
+        }
+
+        const void * lazy_converted_image::query_data_rows(int32_t first_row, int32_t rows_count) const
+        {
+            if(first_row < 0 || rows_count < 0 || first_row + rows_count > m_info.height)
+            {
+                return nullptr;
+            }
+            if(m_source.load(std::memory_order_acquire) == nullptr)
+            {
+                return m_data;
+            }
+
+            std::lock_guard<std::mutex> lock(m_lock);
+            if(!convert_rows(first_row, first_row + rows_count))
+            {
+                return nullptr;
+            }
+            if(m_converted_rows_count == m_info.height)
+            {
+                detach_source();
+            }
+            return m_data;
+        }
+
+        bool lazy_converted_image::convert_rows(int32_t begin_row, int32_t end_row) const
+        {
+            if(m_converted_rows_count == m_info.height)
+            {
+                return true;
+            }
+
+            image_base * source = m_source.load(std::memory_order_relaxed);
+            const image_info source_info = source->query_info();
+            const uint8_t * source_data = static_cast<const uint8_t *>(source->query_data());
+            if(!source_data)
+            {
+                return false;
+            }
+
+            if(!m_data)
+            {
+                release_interface * data_releaser = nullptr;
+                m_data = acquire_conversion_buffer(static_cast<size_t>(m_info.height) * m_info.pitch, data_releaser);
+                m_data_releaser = rs::utils::get_unique_ptr_with_releaser(data_releaser);
+            }
+
+            //the full conversion of an unread image converts its rows in parallel bands
+            if(m_converted_rows_count == 0 && begin_row == 0 && end_row == m_info.height)
+            {
+                if(image_conversion_util::convert(source_info, source_data, m_info, m_data) < status_no_error)
+                {
+                    return false;
+                }
+                m_converted_rows.assign(m_converted_rows.size(), true);
+                m_converted_rows_count = m_info.height;
+                return true;
+            }
+
+            if(!m_convert_row)
+            {
+                m_convert_row = image_conversion_util::query_row_converter(source_info, source_data, {}, m_info.format);
+                if(!m_convert_row)
+                {
+                    return false;
+                }
+            }
+            for(int32_t row = begin_row; row < end_row; row++)
+            {
+                if(!m_converted_rows[row])
+                {
+                    m_convert_row(source_data + static_cast<size_t>(row) * source_info.pitch, source_info.width,
+                                  m_data + static_cast<size_t>(row) * m_info.pitch);
+                    m_converted_rows[row] = true;
+                    m_converted_rows_count++;
+                }
+            }
+            return true;
+        }
+
+        void lazy_converted_image::detach_source() const
+        {
+            image_base * source = m_source.load(std::memory_order_relaxed);
+            if(!source)
+            {
+                return;
+            }
+            m_convert_row = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_source_lock);
+                {
+                    std::lock_guard<std::mutex> cache_lock(source->image_caching_lock);
+                    source->cache_converted_image(this);
+                }
+                m_source.store(nullptr, std::memory_order_release);
+            }
+            //the cache of the source may hold the last reference to the source, which releases this image, the caller holds another reference
+            source->release();
+        }
+
+        lazy_converted_image::~lazy_converted_image()
+        {
+            image_base * source = m_source.load(std::memory_order_relaxed);
+            if(source)
+            {
+                source->release();
+            }
+        }
+    }
+}
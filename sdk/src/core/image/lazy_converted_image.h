@@ -0,0 +1,70 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "image_base.h"
+#include "image_conversion_util.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief The image of \c image_base::convert_to, converted from its source image when its data is first queried.
+         *
+         * The image holds its source until all its rows are converted, then releases it. The source caches the pending image without
+         * a reference, since the pending image references the source, and caches it with a reference once it's converted. The image counts
+         * its own references, so its last release removes the pending image from the source cache under the source cache lock, and the
+         * source never returns a pending image which is being deleted. The rows of a \c query_data_rows call are converted on the calling
+         * thread, a full conversion converts the rows in parallel bands. Concurrent queries wait for the conversion under m_lock, while
+         * the source is swapped under m_source_lock, so releasing the image doesn't wait for a conversion. A failed conversion returns
+         * null data and is retried by the next query.
+         */
+        class lazy_converted_image : public image_base
+        {
+        public:
+            //the conversion of the source to the info was validated by the caller
+            lazy_converted_image(image_base * source, const image_info & info);
+
+            int add_ref() const override;
+            int release() const override;
+            int ref_count() const override;
+
+            image_info query_info(void) const override { return m_info; }
+            double query_time_stamp(void) const override { return m_time_stamp; }
+            timestamp_domain query_time_stamp_domain(void) const override { return m_time_stamp_domain; }
+            flag query_flags(void) const override { return m_flags; }
+            stream_type query_stream_type(void) const override { return m_stream; }
+            uint64_t query_frame_number(void) const override { return m_frame_number; }
+            const void * query_data(void) const override;
+            const void * query_data_rows(int32_t first_row, int32_t rows_count) const override;
+        protected:
+            virtual ~lazy_converted_image();
+        private:
+            //converts the rows of [begin_row, end_row) which weren't converted yet, m_lock must be held
+            bool convert_rows(int32_t begin_row, int32_t end_row) const;
+            //once all the rows are converted, the source caches the image with a reference and the image releases the source
+            void detach_source() const;
+
+            const image_info m_info;
+            const double m_time_stamp;
+            const timestamp_domain m_time_stamp_domain;
+            const flag m_flags;
+            const stream_type m_stream;
+            const uint64_t m_frame_number;
+
+            mutable std::atomic<int> m_references;
+            mutable std::mutex m_lock;          //the conversion, taken before m_source_lock
+            mutable std::mutex m_source_lock;   //the detach of the source, taken before the source cache lock
+            mutable std::atomic<image_base *> m_source; //null once the image is converted
+            mutable uint8_t * m_data;
+            mutable rs::utils::unique_ptr<release_interface> m_data_releaser;
+            mutable image_conversion_util::row_converter m_convert_row;
+            mutable std::vector<bool> m_converted_rows;
+            mutable int32_t m_converted_rows_count;
+        };
+    }
+}
@@ -0,0 +1,88 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+#ifndef WIN32
+#include <dirent.h>
+#endif
+#include "rs/core/device_registry.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            struct registry
+            {
+                std::mutex lock;
+                std::weak_ptr<rs::context> devices;  //the last enumeration, while contexts use it
+                std::string devices_nodes;           //the video device nodes of the last enumeration
+                bool is_invalidated = false;         //the last enumeration isn't shared with new contexts
+            };
+
+            registry & get_instance()
+            {
+                static registry instance;
+                return instance;
+            }
+
+            //the sorted names of the video device nodes, which change when a camera is connected or disconnected
+            std::string query_devices_nodes()
+            {
+                std::vector<std::string> names;
+#ifndef WIN32
+                DIR * directory = opendir("/sys/class/video4linux");
+                if(directory)
+                {
+                    while(struct dirent * entry = readdir(directory))
+                    {
+                        names.push_back(entry->d_name);
+                    }
+                    closedir(directory);
+                }
+#endif
+                std::sort(names.begin(), names.end());
+                std::string rv;
+                for(auto & name : names)
+                {
+                    rv += name + ";";
+                }
+                return rv;
+            }
+        }
+
+        std::shared_ptr<rs::context> device_registry::acquire()
+        {
+            registry & instance = get_instance();
+            std::lock_guard<std::mutex> lock(instance.lock);
+            const std::string devices_nodes = query_devices_nodes();
+            std::shared_ptr<rs::context> devices = instance.devices.lock();
+            if(devices && devices_nodes != instance.devices_nodes)
+            {
+                instance.is_invalidated = true;
+            }
+            if(devices)
+            {
+                //the devices of an invalidated enumeration are enumerated again once its contexts are released
+                return instance.is_invalidated ? std::make_shared<rs::context>() : devices;
+            }
+
+            devices = std::make_shared<rs::context>();
+            instance.devices = devices;
+            instance.devices_nodes = devices_nodes;
+            instance.is_invalidated = false;
+            return devices;
+        }
+
+        void device_registry::invalidate()
+        {
+            registry & instance = get_instance();
+            std::lock_guard<std::mutex> lock(instance.lock);
+            instance.is_invalidated = true;
+        }
+    }
+}
@@ -1,6 +1,10 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
 #include "lrs_image.h"
 #include "rs/utils/librealsense_conversion_utils.h"
 
@@ -10,11 +14,93 @@ namespace rs
 {
     namespace core
     {
+        namespace
+        {
+            //a few images per stream are in flight at a time, a deeper pool only holds memory
+            const size_t MAX_FREE_IMAGES_PER_STREAM = 32;
+            //images of unknown streams share the last pool
+            const size_t POOLS_COUNT = static_cast<size_t>(stream_type::max) + 1;
+
+            //the pool index is kept in front of the image, the image follows at the maximal alignment
+            struct image_header
+            {
+                size_t pool_index;
+            };
+            const size_t HEADER_SIZE = (sizeof(image_header) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+            struct image_pool
+            {
+                std::mutex          mutex;
+                std::vector<void *> free_blocks;
+            };
+
+            image_pool & get_pool(size_t index)
+            {
+                //never destroyed, images may be released by other libraries static destructors
+                static image_pool * pools = new image_pool[POOLS_COUNT];
+                return pools[index];
+            }
+        }
+
+        void * lrs_image::operator new(size_t size, stream_type stream)
+        {
+            //derived sizes are not pooled, all the pooled blocks have the size of an lrs_image
+            size_t pool_index = static_cast<size_t>(stream) < POOLS_COUNT - 1 ? static_cast<size_t>(stream) : POOLS_COUNT - 1;
+            void * block = nullptr;
+            if(size == sizeof(lrs_image))
+            {
+                auto & pool = get_pool(pool_index);
+                std::lock_guard<std::mutex> guard(pool.mutex);
+                if(!pool.free_blocks.empty())
+                {
+                    block = pool.free_blocks.back();
+                    pool.free_blocks.pop_back();
+                }
+            }
+            else
+            {
+                pool_index = POOLS_COUNT;
+            }
+            if(!block)
+                block = ::operator new(HEADER_SIZE + size);
+            static_cast<image_header *>(block)->pool_index = pool_index;
+            return static_cast<uint8_t *>(block) + HEADER_SIZE;
+        }
+
+        void lrs_image::operator delete(void * image, stream_type)
+        {
+            operator delete(image);
+        }
+
+        void lrs_image::operator delete(void * image)
+        {
+            if(!image)
+                return;
+            void * block = static_cast<uint8_t *>(image) - HEADER_SIZE;
+            auto pool_index = static_cast<image_header *>(block)->pool_index;
+            if(pool_index < POOLS_COUNT)
+            {
+                auto & pool = get_pool(pool_index);
+                std::lock_guard<std::mutex> guard(pool.mutex);
+                if(pool.free_blocks.size() < MAX_FREE_IMAGES_PER_STREAM)
+                {
+                    pool.free_blocks.push_back(block);
+                    return;
+                }
+            }
+            ::operator delete(block);
+        }
+
         lrs_image::lrs_image(rs::frame &frame,
                              image_interface::flag flags)
             : image_base(), m_flags(flags)
         {
             m_frame.swap(frame);
+            m_info.format = utils::convert_pixel_format(m_frame.get_format());
+            m_info.height = m_frame.get_height();
+            m_info.width = m_frame.get_width();
+            m_info.pitch = m_frame.get_stride();
+            m_stream_type = utils::convert_stream_type(m_frame.get_stream_type());
             for(int i = 0; i < rs_frame_metadata::RS_FRAME_METADATA_COUNT; i++)
             {
                 rs_frame_metadata rs_md_id = static_cast<rs_frame_metadata>(i);
@@ -30,12 +116,7 @@ namespace rs
 
         image_info lrs_image::query_info() const
         {
-            image_info info;
-            info.format = utils::convert_pixel_format(m_frame.get_format());
-            info.height = m_frame.get_height();
-            info.width = m_frame.get_width();
-            info.pitch = m_frame.get_stride();
-            return info;
+            return m_info;
         }
 
         double lrs_image::query_time_stamp() const
@@ -60,8 +141,7 @@ namespace rs
 
         stream_type lrs_image::query_stream_type() const
         {
-            //the frame const cast can be remove if librealsense made get_stream_type const
-            return utils::convert_stream_type(const_cast<rs::frame*>(&m_frame)->get_stream_type());
+            return m_stream_type;
         }
 
         uint64_t lrs_image::query_frame_number() const
@@ -72,7 +152,8 @@ namespace rs
         image_interface * image_interface::create_instance_from_librealsense_frame(rs::frame& frame,
                                                                                    flag flags)
         {
-            return new lrs_image(frame, flags);
+            auto stream = utils::convert_stream_type(frame.get_stream_type());
+            return new (stream) lrs_image(frame, flags);
         }
 
         lrs_image::~lrs_image() {}
@@ -13,6 +13,8 @@ namespace rs
          * @brief The lrs_image class
          * implements the sdk image interface for a frame defined by librealsense.
          * see complete documantation in the interface declaration.
+         * The image info and stream type are converted once, when the frame is wrapped. The image memory is reused from a per stream
+         * pool of released images, so wrapping a frame doesn't allocate in steady state.
          */
         class lrs_image : public image_base
         {
@@ -22,6 +24,11 @@ namespace rs
 
             lrs_image(rs::frame &frame,
                       image_interface::flag flags);
+
+            //allocates the image from the pool of the stream, the image returns its memory to that pool when it is deleted
+            static void * operator new(size_t size, stream_type stream);
+            static void operator delete(void * image, stream_type stream);
+            static void operator delete(void * image);
             image_info query_info(void) const override;
             double query_time_stamp(void) const override;
             timestamp_domain query_time_stamp_domain(void) const override;
@@ -34,6 +41,8 @@ namespace rs
         private:
             rs::frame m_frame;
             image_interface::flag m_flags;
+            image_info m_info;
+            stream_type m_stream_type;
         };
     }
 }
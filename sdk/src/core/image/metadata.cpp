@@ -60,6 +60,12 @@ namespace rs
             }
 
             m_data.emplace(id, std::vector<uint8_t>(buffer, buffer + size));
+            double * value = query_view_value(id);
+            if(value && size == sizeof(double))
+            {
+                std::memcpy(value, buffer, sizeof(double));
+                m_view.valid_types |= 1u << static_cast<uint32_t>(id);
+            }
             return status::status_no_error;
         }
 
@@ -73,6 +79,10 @@ namespace rs
             }
 
             m_data.erase(id);
+            if(query_view_value(id))
+            {
+                m_view.valid_types &= ~(1u << static_cast<uint32_t>(id));
+            }
             return status::status_no_error;
         }
 
@@ -80,6 +90,19 @@ namespace rs
         {
            return m_data.find(id) != m_data.end();
         }
+
+        double * metadata::query_view_value(metadata_type id)
+        {
+            switch(id)
+            {
+                case metadata_type::actual_exposure:
+                    return &m_view.actual_exposure;
+                case metadata_type::actual_fps:
+                    return &m_view.actual_fps;
+                default:
+                    return nullptr;
+            }
+        }
     }
 }
 
@@ -25,10 +25,15 @@ namespace rs
             uint32_t get_metadata(metadata_type id, uint8_t* buffer) const override;
             status add_metadata(metadata_type id, const uint8_t* buffer, uint32_t size) override;
             status remove_metadata(metadata_type id) override;
+
+            //the values of the known types, updated with the stored metadata
+            const metadata_view * query_view() const { return &m_view; }
         private:
             bool exists(metadata_type id) const;
+            double * query_view_value(metadata_type id);
 
             std::map<metadata_type, std::vector<uint8_t>> m_data;
+            metadata_view m_view = {};
             mutable std::mutex m_mutex;
         };
     }
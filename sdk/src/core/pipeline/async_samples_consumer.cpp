@@ -2,6 +2,8 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include "async_samples_consumer.h"
+#include "sample_set_pool.h"
+#include "rs/utils/profiler_markers.h"
 
 #include <iostream>
 
@@ -14,17 +16,30 @@ namespace rs
         async_samples_consumer::async_samples_consumer(pipeline_async_interface::callback_handler *app_callbacks_handler,
                                                        video_module_interface * cv_module,
                                                        const video_module_interface::actual_module_config &module_config,
-                                                       const video_module_interface::supported_module_config::time_sync_mode time_sync_mode):
-            samples_consumer_base(module_config, time_sync_mode),
+                                                       const video_module_interface::supported_module_config::time_sync_mode time_sync_mode,
+                                                       uint32_t time_sync_deadline):
+            samples_consumer_base(module_config, time_sync_mode, time_sync_deadline),
             m_app_callbacks_handler(app_callbacks_handler),
-            m_cv_module(cv_module)
+            m_cv_module(cv_module),
+            m_last_process_time(0)
         {
             m_cv_module->register_event_handler(this);
         }
 
         void async_samples_consumer::on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set)
         {
+            RS_PROFILER_ZONE("async cv module dispatch");
+            if(has_downstream_consumers() || m_tracer.is_enabled())
+            {
+                std::lock_guard<std::mutex> lock(m_last_sample_set_lock);
+                m_last_sample_set = ready_sample_set;
+            }
+
+            //the async module process call only hands the sample set to the module threads
+            m_last_process_time.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+            m_tracer.trace(pipeline_trace_stage::process_begin, *ready_sample_set);
             status process_sample_set_status = m_cv_module->process_sample_set(*ready_sample_set);
+            m_tracer.trace(pipeline_trace_stage::process_end, *ready_sample_set);
             if(process_sample_set_status < status_no_error)
             {
                 LOG_ERROR("failed async sample process");
@@ -38,11 +53,56 @@ namespace rs
 
         void async_samples_consumer::module_output_ready(video_module_interface *sender, correlated_sample_set *sample)
         {
+            const auto last_process_time = m_last_process_time.load(std::memory_order_relaxed);
+            if(last_process_time != 0)
+            {
+                m_statistics.on_processed(std::chrono::steady_clock::now().time_since_epoch() - std::chrono::steady_clock::duration(last_process_time));
+            }
+            m_statistics.on_output();
+
+            std::shared_ptr<correlated_sample_set> output_sample_set;
+            if(sample)
+            {
+                //the module owns its output sample set, the downstream modules get a referenced copy
+                output_sample_set = sample_set_pool::shared_pool().acquire();
+                *output_sample_set = *sample;
+                sample_set_pool::own_motion_batches(*output_sample_set);
+                for(int stream_index = 0; stream_index < static_cast<int>(stream_type::max); stream_index++)
+                {
+                    if(output_sample_set->images[stream_index])
+                    {
+                        output_sample_set->images[stream_index]->add_ref();
+                    }
+                }
+            }
+            else if(has_downstream_consumers())
+            {
+                std::lock_guard<std::mutex> lock(m_last_sample_set_lock);
+                output_sample_set = m_last_sample_set;
+            }
+            notify_downstream_consumers(output_sample_set);
+
+            //the output is traced by the last input sample set, which is the processed one unless the module skipped sample sets
+            std::shared_ptr<correlated_sample_set> traced_sample_set;
+            if(m_tracer.is_enabled())
+            {
+                std::lock_guard<std::mutex> lock(m_last_sample_set_lock);
+                traced_sample_set = m_last_sample_set;
+            }
+
             if(m_app_callbacks_handler)
             {
                 try
                 {
+                    if(traced_sample_set)
+                    {
+                        m_tracer.trace(pipeline_trace_stage::callback_begin, *traced_sample_set);
+                    }
                     m_app_callbacks_handler->on_cv_module_process_complete(m_cv_module);
+                    if(traced_sample_set)
+                    {
+                        m_tracer.trace(pipeline_trace_stage::callback_end, *traced_sample_set);
+                    }
                 }
                 catch(const std::exception & ex)
                 {
@@ -55,6 +115,8 @@ namespace rs
         async_samples_consumer::~async_samples_consumer()
         {
             m_cv_module->unregister_event_handler(this);
+            std::lock_guard<std::mutex> lock(m_last_sample_set_lock);
+            m_last_sample_set.reset();
         }
     }
 }
@@ -5,6 +5,8 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <chrono>
 #include "rs/core/pipeline_async_interface.h"
 #include "samples_consumer_base.h"
 
@@ -19,7 +21,8 @@ namespace rs
             async_samples_consumer(pipeline_async_interface::callback_handler* app_callbacks_handler,
                                    video_module_interface* cv_module,
                                    const video_module_interface::actual_module_config &module_config,
-                                   const video_module_interface::supported_module_config::time_sync_mode time_sync_mode);
+                                   const video_module_interface::supported_module_config::time_sync_mode time_sync_mode,
+                                   uint32_t time_sync_deadline);
 
             // processing_event_handler interface
             void module_output_ready(video_module_interface *sender, correlated_sample_set *sample) override;
@@ -28,6 +31,9 @@ namespace rs
         private:
             pipeline_async_interface::callback_handler * m_app_callbacks_handler;
             video_module_interface * m_cv_module;
+            std::atomic<std::chrono::steady_clock::rep> m_last_process_time; //steady clock ticks of the last process call, the async process time starts there
+            std::mutex m_last_sample_set_lock;
+            std::shared_ptr<correlated_sample_set> m_last_sample_set; //the last sample set passed to the module, the downstream input of outputs without a sample set and the traced output sample set
 
             void on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set) override;
             void consumer_loop();
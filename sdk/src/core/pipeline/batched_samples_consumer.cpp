@@ -0,0 +1,75 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "batched_samples_consumer.h"
+
+namespace rs
+{
+    namespace core
+    {
+        batched_samples_consumer::batched_samples_consumer(std::function<status(const correlated_sample_set * sample_sets, uint32_t count)> sample_sets_ready_handler,
+                                                           const video_module_interface::actual_module_config & module_config,
+                                                           const video_module_interface::supported_module_config::time_sync_mode time_sync_mode,
+                                                           uint32_t time_sync_deadline,
+                                                           work_stealing_executor & executor,
+                                                           int affinity,
+                                                           work_stealing_executor::priority handler_priority,
+                                                           video_module_interface::supported_module_config::samples_queue_policy queue_policy,
+                                                           uint32_t queue_depth,
+                                                           uint32_t max_batch_size,
+                                                           uint32_t max_batch_delay) :
+            sync_samples_consumer([sample_sets_ready_handler](std::shared_ptr<correlated_sample_set> sample_set)
+                                  {
+                                      //the queued sample sets are created by the batching only
+                                      auto & batch = static_cast<const batched_sample_sets &>(*sample_set);
+                                      return sample_sets_ready_handler(batch.sample_sets.data(), static_cast<uint32_t>(batch.sample_sets.size()));
+                                  },
+                                  module_config,
+                                  time_sync_mode,
+                                  time_sync_deadline,
+                                  executor,
+                                  affinity,
+                                  handler_priority,
+                                  queue_policy,
+                                  queue_depth),
+            m_max_batch_size(max_batch_size > 1 ? max_batch_size : 1),
+            m_max_batch_delay(max_batch_delay)
+        {
+
+        }
+
+        void batched_samples_consumer::on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set)
+        {
+            std::shared_ptr<batched_sample_sets> batch;
+            {
+                std::lock_guard<std::mutex> lock(m_batching_lock);
+                const auto now = std::chrono::steady_clock::now();
+                if(!m_batch)
+                {
+                    m_batch = std::make_shared<batched_sample_sets>();
+                    m_batch->sample_sets.reserve(m_max_batch_size);
+                    m_batch->owners.reserve(m_max_batch_size);
+                    m_batch_start_time = now;
+                }
+                m_batch->sample_sets.push_back(*ready_sample_set);
+                m_batch->owners.push_back(std::move(ready_sample_set));
+
+                const bool is_delayed = m_max_batch_delay.count() > 0 && now - m_batch_start_time >= m_max_batch_delay;
+                if(m_batch->sample_sets.size() < m_max_batch_size && !is_delayed)
+                {
+                    return;
+                }
+
+                //the batch is traced and forwarded downstream as its newest sample set
+                batch = std::move(m_batch);
+                static_cast<correlated_sample_set &>(*batch) = batch->sample_sets.back();
+            }
+            sync_samples_consumer::on_complete_sample_set(std::move(batch));
+        }
+
+        batched_samples_consumer::~batched_samples_consumer()
+        {
+
+        }
+    }
+}
@@ -0,0 +1,57 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <functional>
+#include "sync_samples_consumer.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief The batched_samples_consumer class
+         *
+         * Consumes the samples of a module which processes batches of sample sets. The time synced sample sets are accumulated to a
+         * batch, which is handled as a single queued sample set on the pipeline executor once it holds the maximal batch size, or once a
+         * sample set completes the maximal batch delay after the first sample set of the batch. The delay is checked as the sample sets
+         * complete, like the time sync deadline is checked as the samples arrive, so no timer thread waits for a partial batch.
+         * The queue policy and depth of the consumer apply to the queued batches.
+         */
+        class batched_samples_consumer : public sync_samples_consumer
+        {
+        public:
+            batched_samples_consumer(std::function<status(const correlated_sample_set * sample_sets, uint32_t count)> sample_sets_ready_handler,
+                                     const video_module_interface::actual_module_config & module_config,
+                                     const video_module_interface::supported_module_config::time_sync_mode time_sync_mode,
+                                     uint32_t time_sync_deadline,
+                                     work_stealing_executor & executor,
+                                     int affinity,
+                                     work_stealing_executor::priority handler_priority,
+                                     video_module_interface::supported_module_config::samples_queue_policy queue_policy,
+                                     uint32_t queue_depth,
+                                     uint32_t max_batch_size,
+                                     uint32_t max_batch_delay);
+
+            virtual ~batched_samples_consumer();
+        protected:
+            void on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set) override;
+        private:
+            //the queued batch, the base sample set is the newest sample set of the batch
+            struct batched_sample_sets : public correlated_sample_set
+            {
+                std::vector<correlated_sample_set> sample_sets;
+                std::vector<std::shared_ptr<correlated_sample_set>> owners; //own the images references of the sample sets
+            };
+
+            const size_t m_max_batch_size;
+            const std::chrono::milliseconds m_max_batch_delay;
+            std::mutex m_batching_lock;
+            std::shared_ptr<batched_sample_sets> m_batch; //guarded by m_batching_lock
+            std::chrono::steady_clock::time_point m_batch_start_time; //guarded by m_batching_lock
+        };
+    }
+}
@@ -49,6 +49,118 @@ namespace rs
             return true;
         }
 
+        bool config_util::is_aligned_stream(stream_type stream)
+        {
+            return stream == stream_type::depth_aligned_to_color || stream == stream_type::color_aligned_to_depth;
+        }
+
+        bool config_util::are_aligned_streams_sources_enabled(const video_module_interface::supported_module_config & config)
+        {
+            bool is_any_aligned_stream_enabled = false;
+            for(uint32_t stream_index = 0; stream_index < static_cast<uint32_t>(stream_type::max); ++stream_index)
+            {
+                if(config.image_streams_configs[stream_index].is_enabled && is_aligned_stream(static_cast<stream_type>(stream_index)))
+                {
+                    is_any_aligned_stream_enabled = true;
+                }
+            }
+            return !is_any_aligned_stream_enabled ||
+                   (config.image_streams_configs[static_cast<uint32_t>(stream_type::depth)].is_enabled &&
+                    config.image_streams_configs[static_cast<uint32_t>(stream_type::color)].is_enabled);
+        }
+
+        bool config_util::are_configs_equal(const video_module_interface::actual_module_config & first,
+                                            const video_module_interface::actual_module_config & second)
+        {
+            for(uint32_t stream_index = 0; stream_index < static_cast<uint32_t>(stream_type::max); ++stream_index)
+            {
+                auto & first_stream = first.image_streams_configs[stream_index];
+                auto & second_stream = second.image_streams_configs[stream_index];
+                if(first_stream.is_enabled != second_stream.is_enabled)
+                {
+                    return false;
+                }
+                if(first_stream.is_enabled &&
+                   (first_stream.size.width != second_stream.size.width ||
+                    first_stream.size.height != second_stream.size.height ||
+                    first_stream.frame_rate != second_stream.frame_rate ||
+                    first_stream.flags != second_stream.flags))
+                {
+                    return false;
+                }
+            }
+
+            for(uint32_t motion_index = 0; motion_index < static_cast<uint32_t>(motion_type::max); ++motion_index)
+            {
+                auto & first_motion = first.motion_sensors_configs[motion_index];
+                auto & second_motion = second.motion_sensors_configs[motion_index];
+                if(first_motion.is_enabled != second_motion.is_enabled)
+                {
+                    return false;
+                }
+                if(first_motion.is_enabled &&
+                   (first_motion.sample_rate != second_motion.sample_rate ||
+                    first_motion.flags != second_motion.flags))
+                {
+                    return false;
+                }
+            }
+
+            return std::strcmp(first.device_info.name, second.device_info.name) == 0 &&
+                   first.device_count == second.device_count;
+        }
+
+        bool config_util::are_configs_equal(const video_module_interface::supported_module_config & first,
+                                            const video_module_interface::supported_module_config & second)
+        {
+            for(uint32_t stream_index = 0; stream_index < static_cast<uint32_t>(stream_type::max); ++stream_index)
+            {
+                auto & first_stream = first.image_streams_configs[stream_index];
+                auto & second_stream = second.image_streams_configs[stream_index];
+                if(first_stream.is_enabled != second_stream.is_enabled)
+                {
+                    return false;
+                }
+                if(first_stream.is_enabled &&
+                   (first_stream.size.width != second_stream.size.width ||
+                    first_stream.size.height != second_stream.size.height ||
+                    first_stream.frame_rate != second_stream.frame_rate ||
+                    first_stream.flags != second_stream.flags))
+                {
+                    return false;
+                }
+            }
+
+            for(uint32_t motion_index = 0; motion_index < static_cast<uint32_t>(motion_type::max); ++motion_index)
+            {
+                auto & first_motion = first.motion_sensors_configs[motion_index];
+                auto & second_motion = second.motion_sensors_configs[motion_index];
+                if(first_motion.is_enabled != second_motion.is_enabled)
+                {
+                    return false;
+                }
+                if(first_motion.is_enabled &&
+                   (first_motion.sample_rate != second_motion.sample_rate ||
+                    first_motion.flags != second_motion.flags))
+                {
+                    return false;
+                }
+            }
+
+            return std::strcmp(first.device_name, second.device_name) == 0 &&
+                   first.concurrent_samples_count == second.concurrent_samples_count &&
+                   first.async_processing == second.async_processing &&
+                   first.samples_time_sync_mode == second.samples_time_sync_mode &&
+                   first.time_sync_deadline == second.time_sync_deadline &&
+                   first.queue_policy == second.queue_policy &&
+                   first.queue_depth == second.queue_depth &&
+                   first.device_count == second.device_count &&
+                   first.priority_class == second.priority_class &&
+                   first.max_rate == second.max_rate &&
+                   first.max_batch_size == second.max_batch_size &&
+                   first.max_batch_delay == second.max_batch_delay;
+        }
+
         void config_util::recursive_cartesian_multiplicity(const std::vector<std::vector<video_module_interface::supported_module_config>>& groups,
                                                            const uint32_t group_index,
                                                            const std::vector<video_module_interface::supported_module_config>& combination_prefix,
@@ -212,6 +324,7 @@ namespace rs
                 }
 
                 superset.concurrent_samples_count = std::max(superset.concurrent_samples_count, config.concurrent_samples_count);
+                superset.device_count = std::max(superset.device_count, config.device_count);
 
             }
             return true;
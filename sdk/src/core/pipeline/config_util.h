@@ -30,6 +30,20 @@ namespace rs
 
             static bool is_config_empty(const video_module_interface::supported_module_config & config);
 
+            //checks if the stream is registered by the pipeline from the depth and color streams, rather than streamed by the device
+            static bool is_aligned_stream(stream_type stream);
+
+            //checks if the depth and color streams the aligned streams of the configuration are registered from are enabled
+            static bool are_aligned_streams_sources_enabled(const video_module_interface::supported_module_config & config);
+
+            //checks if both configurations enable the same streams and motion sensors with the same parameters
+            static bool are_configs_equal(const video_module_interface::actual_module_config & first,
+                                          const video_module_interface::actual_module_config & second);
+
+            //checks if both configurations request the same streams, motion sensors, device and samples delivery
+            static bool are_configs_equal(const video_module_interface::supported_module_config & first,
+                                          const video_module_interface::supported_module_config & second);
+
         private:
             config_util(){}
 
@@ -0,0 +1,127 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include "rs/core/pipeline_statistics.h"
+#include "rs/core/correlated_sample_set.h"
+#include "rs/utils/fps_counter.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief Runtime counters of a samples consumer.
+         *
+         * The counters are updated on the streaming threads and sampled by the pipeline statistics queries, both sides only
+         * touch relaxed atomics, so sampling doesn't block or delay the streaming.
+         */
+        class consumer_statistics
+        {
+        public:
+            consumer_statistics(uint32_t frame_rate) :
+                m_queued_sample_sets_count(0),
+                m_processed_sample_sets_count(0),
+                m_throttled_sample_sets_count(0),
+                m_outputs_count(0),
+                m_process_time_sum_us(0),
+                m_start_time(std::chrono::steady_clock::now()),
+                m_outputs_fps_counter(frame_rate)
+            {
+                for(int stream_index = 0; stream_index < static_cast<int>(stream_type::max); stream_index++)
+                {
+                    m_unmatched_samples_count[stream_index].store(0, std::memory_order_relaxed);
+                    m_dropped_samples_count[stream_index].store(0, std::memory_order_relaxed);
+                }
+                for(auto & bucket : m_process_time_histogram)
+                {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+            }
+
+            void on_unmatched_samples(const correlated_sample_set & sample_set) { count_samples(m_unmatched_samples_count, sample_set); }
+            void on_dropped_samples(const correlated_sample_set & sample_set) { count_samples(m_dropped_samples_count, sample_set); }
+            void on_queue_size_changed(size_t queued_sample_sets_count)
+            {
+                m_queued_sample_sets_count.store(static_cast<uint32_t>(queued_sample_sets_count), std::memory_order_relaxed);
+            }
+
+            void on_processed(std::chrono::steady_clock::duration process_time)
+            {
+                const uint64_t process_time_us = static_cast<uint64_t>(std::max<int64_t>(0,
+                                                     std::chrono::duration_cast<std::chrono::microseconds>(process_time).count()));
+                int bucket = 0;
+                for(uint64_t time_ms = process_time_us / 1000; time_ms > 0 && bucket < pipeline_module_statistics::PROCESS_TIME_BUCKETS - 1; time_ms >>= 1)
+                {
+                    bucket++;
+                }
+                m_process_time_histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+                m_process_time_sum_us.fetch_add(process_time_us, std::memory_order_relaxed);
+                m_processed_sample_sets_count.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void on_throttled() { m_throttled_sample_sets_count.fetch_add(1, std::memory_order_relaxed); }
+
+            void on_output()
+            {
+                m_outputs_count.fetch_add(1, std::memory_order_relaxed);
+                m_outputs_fps_counter.tick();
+            }
+
+            uint64_t query_unmatched_samples_count(stream_type stream) const
+            {
+                return m_unmatched_samples_count[static_cast<int>(stream)].load(std::memory_order_relaxed);
+            }
+
+            uint64_t query_dropped_samples_count(stream_type stream) const
+            {
+                return m_dropped_samples_count[static_cast<int>(stream)].load(std::memory_order_relaxed);
+            }
+
+            //fills all the module statistics but the dropped sample sets count, which the consumer queue policy counts
+            void query_module_statistics(pipeline_module_statistics & statistics) const
+            {
+                statistics.queued_sample_sets_count = m_queued_sample_sets_count.load(std::memory_order_relaxed);
+                statistics.processed_sample_sets_count = m_processed_sample_sets_count.load(std::memory_order_relaxed);
+                statistics.throttled_sample_sets_count = m_throttled_sample_sets_count.load(std::memory_order_relaxed);
+                statistics.outputs_count = m_outputs_count.load(std::memory_order_relaxed);
+                statistics.output_rate = m_outputs_fps_counter.current_fps();
+                const double elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start_time).count();
+                statistics.throughput = elapsed_seconds > 0 ? static_cast<double>(statistics.processed_sample_sets_count) / elapsed_seconds : 0.;
+                uint64_t histogram_count = 0;
+                for(int bucket = 0; bucket < pipeline_module_statistics::PROCESS_TIME_BUCKETS; bucket++)
+                {
+                    statistics.process_time_histogram[bucket] = m_process_time_histogram[bucket].load(std::memory_order_relaxed);
+                    histogram_count += statistics.process_time_histogram[bucket];
+                }
+                statistics.mean_process_time_ms = histogram_count > 0 ?
+                            static_cast<double>(m_process_time_sum_us.load(std::memory_order_relaxed)) / 1000. / static_cast<double>(histogram_count) : 0.;
+            }
+        private:
+            std::atomic<uint64_t> m_unmatched_samples_count[static_cast<int>(stream_type::max)];
+            std::atomic<uint64_t> m_dropped_samples_count[static_cast<int>(stream_type::max)];
+            std::atomic<uint32_t> m_queued_sample_sets_count;
+            std::atomic<uint64_t> m_processed_sample_sets_count;
+            std::atomic<uint64_t> m_throttled_sample_sets_count;
+            std::atomic<uint64_t> m_outputs_count;
+            std::atomic<uint64_t> m_process_time_sum_us;
+            const std::chrono::steady_clock::time_point m_start_time; //the consumers are created when the pipeline starts streaming
+            std::atomic<uint64_t> m_process_time_histogram[pipeline_module_statistics::PROCESS_TIME_BUCKETS];
+            mutable rs::utils::fps_counter m_outputs_fps_counter;
+
+            static void count_samples(std::atomic<uint64_t> (&counters)[static_cast<int>(stream_type::max)], const correlated_sample_set & sample_set)
+            {
+                for(int stream_index = 0; stream_index < static_cast<int>(stream_type::max); stream_index++)
+                {
+                    if(sample_set.images[stream_index])
+                    {
+                        counters[stream_index].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        };
+    }
+}
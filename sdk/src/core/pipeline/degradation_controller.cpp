@@ -0,0 +1,121 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include "rs/utils/log_utils.h"
+#include "degradation_controller.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            const uint32_t DEFAULT_EVALUATION_INTERVAL_MS = 100;
+        }
+
+        degradation_controller::degradation_controller(const pipeline_degradation_plan & plan) :
+            m_plan(plan),
+            m_evaluation_interval(std::chrono::milliseconds(plan.evaluation_interval_ms > 0 ? plan.evaluation_interval_ms : DEFAULT_EVALUATION_INTERVAL_MS)),
+            m_step(0),
+            m_step_changes_count(0),
+            m_max_queued_sample_sets_count(0),
+            m_max_process_time_us(0),
+            m_interval_end(0),
+            m_overloaded_intervals(0),
+            m_calm_intervals(0) {}
+
+        void degradation_controller::on_queue_size_changed(size_t queued_sample_sets_count, time_point now)
+        {
+            const uint32_t queued = static_cast<uint32_t>(queued_sample_sets_count);
+            uint32_t max_queued = m_max_queued_sample_sets_count.load(std::memory_order_relaxed);
+            while(queued > max_queued && !m_max_queued_sample_sets_count.compare_exchange_weak(max_queued, queued, std::memory_order_relaxed)) {}
+            evaluate(now);
+        }
+
+        void degradation_controller::on_processed(std::chrono::steady_clock::duration process_time, time_point now)
+        {
+            const uint64_t process_time_us = static_cast<uint64_t>(std::max<int64_t>(0,
+                                                 std::chrono::duration_cast<std::chrono::microseconds>(process_time).count()));
+            uint64_t max_process_time_us = m_max_process_time_us.load(std::memory_order_relaxed);
+            while(process_time_us > max_process_time_us &&
+                  !m_max_process_time_us.compare_exchange_weak(max_process_time_us, process_time_us, std::memory_order_relaxed)) {}
+            evaluate(now);
+        }
+
+        uint32_t degradation_controller::query_decimation(video_module_interface::supported_module_config::module_priority priority_class) const
+        {
+            const uint32_t step_number = m_step.load(std::memory_order_relaxed);
+            if(step_number == 0)
+            {
+                return 1;
+            }
+
+            const pipeline_degradation_plan::step & step = m_plan.steps[step_number - 1];
+            switch(priority_class)
+            {
+                case video_module_interface::supported_module_config::module_priority::best_effort:
+                    return step.skip_best_effort_modules ? 0 : std::max<uint32_t>(step.best_effort_decimation, 1);
+                case video_module_interface::supported_module_config::module_priority::normal:
+                    return std::max<uint32_t>(step.normal_decimation, 1);
+                default:
+                    return 1;
+            }
+        }
+
+        void degradation_controller::evaluate(time_point now)
+        {
+            const int64_t now_ticks = now.time_since_epoch().count();
+            int64_t interval_end = m_interval_end.load(std::memory_order_relaxed);
+            if(interval_end == 0)
+            {
+                //the first report starts the first interval
+                m_interval_end.compare_exchange_strong(interval_end, now_ticks + m_evaluation_interval.count(), std::memory_order_relaxed);
+                return;
+            }
+            if(now_ticks < interval_end)
+            {
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock(m_evaluation_lock, std::try_to_lock);
+            if(!lock.owns_lock() || now_ticks < m_interval_end.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            //the intervals without reports which passed since the last evaluation are evaluated as a single interval
+            const uint32_t max_queued = m_max_queued_sample_sets_count.exchange(0, std::memory_order_relaxed);
+            const uint64_t max_process_time_us = m_max_process_time_us.exchange(0, std::memory_order_relaxed);
+            const bool is_overloaded = (m_plan.overload_queue_depth > 0 && max_queued >= m_plan.overload_queue_depth) ||
+                                       (m_plan.overload_process_time_ms > 0 && max_process_time_us > m_plan.overload_process_time_ms * 1000ull);
+
+            const uint32_t steps_count = std::min<uint32_t>(m_plan.steps_count, pipeline_degradation_plan::MAX_STEPS);
+            const uint32_t step = m_step.load(std::memory_order_relaxed);
+            if(is_overloaded)
+            {
+                m_calm_intervals = 0;
+                if(++m_overloaded_intervals >= std::max<uint32_t>(m_plan.escalation_intervals, 1) && step < steps_count)
+                {
+                    m_overloaded_intervals = 0;
+                    m_step.store(step + 1, std::memory_order_relaxed);
+                    m_step_changes_count.fetch_add(1, std::memory_order_relaxed);
+                    LOG_WARN("pipeline overloaded, max queued sample sets " << max_queued << ", max process time " << max_process_time_us <<
+                             " us, applying degradation step " << step + 1);
+                }
+            }
+            else
+            {
+                m_overloaded_intervals = 0;
+                if(++m_calm_intervals >= std::max<uint32_t>(m_plan.recovery_intervals, 1) && step > 0)
+                {
+                    m_calm_intervals = 0;
+                    m_step.store(step - 1, std::memory_order_relaxed);
+                    m_step_changes_count.fetch_add(1, std::memory_order_relaxed);
+                    LOG_INFO("pipeline load recovered, restoring degradation step " << step - 1);
+                }
+            }
+            m_interval_end.store(now_ticks + m_evaluation_interval.count(), std::memory_order_relaxed);
+        }
+    }
+}
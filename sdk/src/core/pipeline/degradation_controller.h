@@ -0,0 +1,58 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdint.h>
+#include "rs/core/pipeline_degradation.h"
+#include "rs/core/video_module_interface.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief Applies the steps of a degradation plan by the load the module consumers report, shared by the pipeline consumers.
+         *
+         * The consumers report their queue sizes and process times on the streaming threads, the reports only raise relaxed atomic
+         * maximums. The report which crosses the end of an interval evaluates it, the other reports never wait for the evaluation.
+         * The consumers query the applied step for each sample set.
+         */
+        class degradation_controller
+        {
+        public:
+            typedef std::chrono::steady_clock::time_point time_point;
+
+            degradation_controller(const pipeline_degradation_plan & plan);
+
+            void on_queue_size_changed(size_t queued_sample_sets_count, time_point now);
+            void on_processed(std::chrono::steady_clock::duration process_time, time_point now);
+
+            /**
+             * @brief Returns the decimation of the sample sets of a module priority class by the applied step, 0 if the class
+             * processes no sample sets, 1 if it isn't degraded.
+             */
+            uint32_t query_decimation(video_module_interface::supported_module_config::module_priority priority_class) const;
+
+            //the applied step, 1 based, 0 while not degraded
+            uint32_t query_step() const { return m_step.load(std::memory_order_relaxed); }
+            uint64_t query_step_changes_count() const { return m_step_changes_count.load(std::memory_order_relaxed); }
+        private:
+            const pipeline_degradation_plan m_plan;
+            const std::chrono::steady_clock::duration m_evaluation_interval;
+            std::atomic<uint32_t> m_step;
+            std::atomic<uint64_t> m_step_changes_count;
+            std::atomic<uint32_t> m_max_queued_sample_sets_count; //of the current interval
+            std::atomic<uint64_t> m_max_process_time_us; //of the current interval
+            std::atomic<int64_t> m_interval_end; //steady clock ticks, 0 until the first report
+            std::mutex m_evaluation_lock;
+            uint32_t m_overloaded_intervals; //consecutive, guarded by m_evaluation_lock
+            uint32_t m_calm_intervals; //consecutive, guarded by m_evaluation_lock
+
+            //evaluates the intervals which ended before the time, if no other report evaluates them
+            void evaluate(time_point now);
+        };
+    }
+}
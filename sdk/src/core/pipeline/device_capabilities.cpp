@@ -0,0 +1,85 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <stdexcept>
+#include "rs/utils/librealsense_conversion_utils.h"
+#include "config_util.h"
+#include "device_capabilities.h"
+
+using namespace rs::utils;
+
+namespace rs
+{
+    namespace core
+    {
+        device_capabilities::device_capabilities(rs::device * device)
+        {
+            if(!device)
+            {
+                throw std::runtime_error("device is not initialized");
+            }
+
+            m_name = device->get_name();
+            for(uint32_t stream_index = 0; stream_index < static_cast<uint32_t>(stream_type::max); stream_index++)
+            {
+                if(config_util::is_aligned_stream(static_cast<stream_type>(stream_index)))
+                {
+                    continue;
+                }
+                auto librealsense_stream = convert_stream_type(static_cast<stream_type>(stream_index));
+                for(auto mode_index = 0; mode_index < device->get_stream_mode_count(librealsense_stream); mode_index++)
+                {
+                    stream_mode mode = {};
+                    rs::format librealsense_format;
+                    device->get_stream_mode(librealsense_stream, mode_index, mode.width, mode.height, librealsense_format, mode.frame_rate);
+                    m_stream_modes[stream_index].push_back(mode);
+                }
+            }
+            m_supports_motion_events = device->supports(rs::capabilities::motion_events);
+        }
+
+        const char * device_capabilities::get_name() const
+        {
+            return m_name.c_str();
+        }
+
+        bool device_capabilities::is_config_satisfied(const video_module_interface::supported_module_config & config) const
+        {
+            if(!config_util::are_aligned_streams_sources_enabled(config))
+            {
+                return false;
+            }
+
+            for(uint32_t stream_index = 0; stream_index < static_cast<uint32_t>(stream_type::max); stream_index++)
+            {
+                auto & stream_config = config.image_streams_configs[stream_index];
+                if(!stream_config.is_enabled || config_util::is_aligned_stream(static_cast<stream_type>(stream_index)))
+                {
+                    continue;
+                }
+
+                auto & modes = m_stream_modes[stream_index];
+                bool is_stream_satisfied = std::any_of(modes.begin(), modes.end(), [&stream_config](const stream_mode & mode)
+                {
+                    return (stream_config.size.width == 0 || stream_config.size.width == mode.width) &&
+                           (stream_config.size.height == 0 || stream_config.size.height == mode.height) &&
+                           (stream_config.frame_rate == 0 || stream_config.frame_rate == static_cast<float>(mode.frame_rate));
+                });
+                if(!is_stream_satisfied)
+                {
+                    return false;
+                }
+            }
+
+            for(uint32_t motion_index = 0; motion_index < static_cast<uint32_t>(motion_type::max); motion_index++)
+            {
+                if(config.motion_sensors_configs[motion_index].is_enabled && !m_supports_motion_events)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+}
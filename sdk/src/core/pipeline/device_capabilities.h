@@ -0,0 +1,45 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <string>
+#include <vector>
+#include <librealsense/rs.hpp>
+#include "rs/core/video_module_interface.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief The device_capabilities class
+         *
+         * Caches the stream modes and the motion support of a device, which are queried once, so configurations can be
+         * negotiated without touching the device.
+         */
+        class device_capabilities
+        {
+        public:
+            device_capabilities(rs::device * device);
+
+            const char * get_name() const;
+
+            /**
+             * @brief Checks if the device has a mode for each stream of the configuration, and the motion sensors if the
+             * configuration enables them, as the device manager selects the device modes.
+             */
+            bool is_config_satisfied(const video_module_interface::supported_module_config & config) const;
+        private:
+            struct stream_mode
+            {
+                int width;
+                int height;
+                int frame_rate;
+            };
+
+            std::string m_name;
+            std::vector<stream_mode> m_stream_modes[static_cast<uint32_t>(stream_type::max)];
+            bool m_supports_motion_events;
+        };
+    }
+}
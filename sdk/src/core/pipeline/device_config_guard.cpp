@@ -3,7 +3,7 @@
 
 #include "rs/utils/librealsense_conversion_utils.h"
 #include "rs/utils/log_utils.h"
-#include "sample_set_releaser.h"
+#include "sample_set_pool.h"
 #include "device_config_guard.h"
 
 using namespace std;
@@ -83,7 +83,7 @@ namespace rs
                 stream_type stream = static_cast<stream_type>(stream_index);
                 m_stream_callback_per_stream[stream] = [stream, this](rs::frame frame)
                 {
-                    std::shared_ptr<correlated_sample_set> sample_set(new correlated_sample_set(), sample_set_releaser());
+                    std::shared_ptr<correlated_sample_set> sample_set = sample_set_pool::shared_pool().acquire();
                     (*sample_set)[stream] = image_interface::create_instance_from_librealsense_frame(frame, image_interface::flag::any);
                     if(m_non_blocking_notify_sample)
                     {
@@ -113,7 +113,7 @@ namespace rs
                     //enable motion from the selected module configuration
                     m_motion_callback = [this](rs::motion_data entry)
                     {
-                        std::shared_ptr<correlated_sample_set> sample_set(new correlated_sample_set(), sample_set_releaser());
+                        std::shared_ptr<correlated_sample_set> sample_set = sample_set_pool::shared_pool().acquire();
 
                         auto actual_motion = convert_motion_type(static_cast<rs::event>(entry.timestamp_data.source_id));
 
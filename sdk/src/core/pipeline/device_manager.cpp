@@ -2,9 +2,13 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include <vector>
+#include <algorithm>
+#include <cstring>
 #include "rs/core/projection_interface.h"
 #include "rs/utils/librealsense_conversion_utils.h"
 #include "rs/utils/log_utils.h"
+#include "lazy_projection.h"
+#include "config_util.h"
 #include "device_manager.h"
 
 using namespace std;
@@ -37,28 +41,30 @@ namespace rs
                 throw std::runtime_error("no valid device configuration");
             }
 
-            m_device_config_guard.reset(new device_config_guard(m_device, actual_config, non_blocking_notify_sample));
+            //the aligned streams are registered by the samples consumers, the device streams their depth and color streams only
+            video_module_interface::actual_module_config device_config = actual_config;
+            for(uint32_t stream_index = 0; stream_index < static_cast<uint32_t>(stream_type::max); ++stream_index)
+            {
+                if(config_util::is_aligned_stream(static_cast<stream_type>(stream_index)))
+                {
+                    device_config.image_streams_configs[stream_index] = {};
+                }
+            }
+            m_device_config_guard.reset(new device_config_guard(m_device, device_config, non_blocking_notify_sample));
 
             m_actual_config = actual_config;
             m_projection.reset();
 
-            //create projection object if the streams are relevant
-            if(m_device->is_stream_enabled(rs::stream::color) && m_device->is_stream_enabled(rs::stream::depth))
+            //the projection is initialized on its first use, from the calibration of the actual config
+            auto & color_config = m_actual_config[stream_type::color];
+            auto & depth_config = m_actual_config[stream_type::depth];
+            if(color_config.is_enabled && depth_config.is_enabled)
             {
-                try
-                {
-                    rs::core::intrinsics color_intrin = rs::utils::convert_intrinsics(m_device->get_stream_intrinsics(rs::stream::color));
-                    rs::core::intrinsics depth_intrin = rs::utils::convert_intrinsics(m_device->get_stream_intrinsics(rs::stream::depth));
-                    rs::core::extrinsics extrinsics = rs::utils::convert_extrinsics(m_device->get_extrinsics(rs::stream::depth, rs::stream::color));
-                    m_projection.reset(rs::core::projection_interface::create_instance(&color_intrin, &depth_intrin, &extrinsics));
-                }
-                catch(const std::exception & ex)
-                {
-                    LOG_ERROR("failed to create projection object, error : " << ex.what());
-                }
+                m_projection.reset(new lazy_projection(color_config.intrinsics, depth_config.intrinsics, color_config.extrinsics));
             }
 
             m_actual_config.projection = m_projection.get();
+            m_actual_config.device_count = 1;
         }
 
         void device_manager::start()
@@ -106,16 +112,65 @@ namespace rs
                 }
             }
 
+            actual_config.device_count = std::max(supported_config.device_count, 1u);
             return actual_config;
         }
 
+        bool device_manager::is_config_satisfied_by_current_modes(const video_module_interface::supported_module_config & config) const
+        {
+            if(std::strlen(config.device_name) != 0 && std::strcmp(config.device_name, m_actual_config.device_info.name) != 0)
+            {
+                return false;
+            }
+
+            for(uint32_t stream_index = 0; stream_index < static_cast<uint32_t>(stream_type::max); ++stream_index)
+            {
+                auto & stream_config = config.image_streams_configs[stream_index];
+                if(!stream_config.is_enabled)
+                {
+                    continue;
+                }
+                auto & current_stream_config = m_actual_config.image_streams_configs[stream_index];
+                if(config_util::is_aligned_stream(static_cast<stream_type>(stream_index)))
+                {
+                    if(!current_stream_config.is_enabled)
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+                if(!current_stream_config.is_enabled ||
+                   (stream_config.size.width != 0 && stream_config.size.width != current_stream_config.size.width) ||
+                   (stream_config.size.height != 0 && stream_config.size.height != current_stream_config.size.height) ||
+                   (stream_config.frame_rate != 0 && stream_config.frame_rate != current_stream_config.frame_rate))
+                {
+                    return false;
+                }
+            }
+
+            for(uint32_t motion_index = 0; motion_index < static_cast<uint32_t>(motion_type::max); ++motion_index)
+            {
+                if(config.motion_sensors_configs[motion_index].is_enabled && !m_actual_config.motion_sensors_configs[motion_index].is_enabled)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
         bool device_manager::is_there_a_satisfying_device_mode(const video_module_interface::supported_module_config& given_config,
                                                                video_module_interface::actual_module_config& actual_config) const
         {
             actual_config = {};
+            if(!config_util::are_aligned_streams_sources_enabled(given_config))
+            {
+                return false;
+            }
+
             for(uint32_t stream_index = 0; stream_index < static_cast<uint32_t>(stream_type::max); stream_index++)
             {
-                if(!given_config.image_streams_configs[stream_index].is_enabled)
+                if(!given_config.image_streams_configs[stream_index].is_enabled ||
+                   config_util::is_aligned_stream(static_cast<stream_type>(stream_index)))
                 {
                     continue;
                 }
@@ -187,6 +242,26 @@ namespace rs
                 }
             }
 
+            //an aligned stream has the size, the intrinsics and the extrinsics of the stream it's registered to,
+            //and a registered image for each depth image which is matched with a color image
+            auto & depth_stream = actual_config.image_streams_configs[static_cast<uint32_t>(stream_type::depth)];
+            auto & color_stream = actual_config.image_streams_configs[static_cast<uint32_t>(stream_type::color)];
+            const std::pair<stream_type, const video_module_interface::actual_image_stream_config *> aligned_streams[] =
+            {
+                { stream_type::depth_aligned_to_color, &color_stream },
+                { stream_type::color_aligned_to_depth, &depth_stream }
+            };
+            for(auto & aligned_stream : aligned_streams)
+            {
+                if(!given_config.image_streams_configs[static_cast<uint32_t>(aligned_stream.first)].is_enabled)
+                {
+                    continue;
+                }
+                auto & actual_stream = actual_config.image_streams_configs[static_cast<uint32_t>(aligned_stream.first)];
+                actual_stream = *aligned_stream.second;
+                actual_stream.frame_rate = std::min(depth_stream.frame_rate, color_stream.frame_rate);
+            }
+
             //check for motion configuration
             rs::motion_intrinsics motion_intrinsics = {};
             rs::extrinsics motion_extrinsics_from_depth = {};
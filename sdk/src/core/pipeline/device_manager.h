@@ -30,6 +30,12 @@ namespace rs
             const video_module_interface::actual_module_config create_actual_config_from_supported_config(
                     const video_module_interface::supported_module_config & supported_config) const;
 
+            /**
+             * @brief Checks if the enabled device modes satisfy the configuration, so the configuration can be served without
+             * reconfiguring the device streams, while the device is streaming.
+             */
+            bool is_config_satisfied_by_current_modes(const video_module_interface::supported_module_config & config) const;
+
             virtual ~device_manager();
         private:            
             rs::device * m_device;
@@ -0,0 +1,305 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include <vector>
+#include "rs/utils/log_utils.h"
+#include "lazy_projection.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            struct calibration_projection
+            {
+                intrinsics color_intrinsics;
+                intrinsics depth_intrinsics;
+                extrinsics depth_to_color_extrinsics;
+                std::shared_ptr<projection_interface> projection;
+            };
+
+            std::mutex projections_lock;
+            std::vector<calibration_projection> projections; //guarded by projections_lock
+
+            std::shared_ptr<projection_interface> acquire_calibration_projection(intrinsics color_intrinsics,
+                                                                                 intrinsics depth_intrinsics,
+                                                                                 extrinsics depth_to_color_extrinsics)
+            {
+                std::lock_guard<std::mutex> guard(projections_lock);
+                for(auto & cached : projections)
+                {
+                    if(std::memcmp(&cached.color_intrinsics, &color_intrinsics, sizeof(intrinsics)) == 0 &&
+                       std::memcmp(&cached.depth_intrinsics, &depth_intrinsics, sizeof(intrinsics)) == 0 &&
+                       std::memcmp(&cached.depth_to_color_extrinsics, &depth_to_color_extrinsics, sizeof(extrinsics)) == 0)
+                    {
+                        return cached.projection;
+                    }
+                }
+
+                std::shared_ptr<projection_interface> projection;
+                try
+                {
+                    projection.reset(projection_interface::create_instance(&color_intrinsics, &depth_intrinsics, &depth_to_color_extrinsics),
+                                     [](projection_interface * projection) { if(projection) projection->release(); });
+                }
+                catch(const std::exception & ex)
+                {
+                    LOG_ERROR("failed to create projection object, error : " << ex.what());
+                }
+
+                //a failed calibration is cached as well, so it isn't initialized again
+                projections.push_back({ color_intrinsics, depth_intrinsics, depth_to_color_extrinsics, projection });
+                return projection;
+            }
+        }
+
+        lazy_projection::lazy_projection(const intrinsics & color_intrinsics, const intrinsics & depth_intrinsics, const extrinsics & depth_to_color_extrinsics) :
+            m_color_intrinsics(color_intrinsics),
+            m_depth_intrinsics(depth_intrinsics),
+            m_depth_to_color_extrinsics(depth_to_color_extrinsics)
+        {
+
+        }
+
+        projection_interface * lazy_projection::get_projection()
+        {
+            std::call_once(m_projection_created, [this]()
+            {
+                m_projection = acquire_calibration_projection(m_color_intrinsics, m_depth_intrinsics, m_depth_to_color_extrinsics);
+            });
+            return m_projection.get();
+        }
+
+        status lazy_projection::map_depth_to_color(int32_t npoints, point3dF32 *pos_uvz, pointF32 *pos_ij)
+        {
+            auto projection = get_projection();
+            return projection ? projection->map_depth_to_color(npoints, pos_uvz, pos_ij) : status_data_unavailable;
+        }
+
+        status lazy_projection::map_color_to_depth(image_interface *depth, int32_t npoints, pointF32 *pos_ij, pointF32 *pos_uv)
+        {
+            auto projection = get_projection();
+            return projection ? projection->map_color_to_depth(depth, npoints, pos_ij, pos_uv) : status_data_unavailable;
+        }
+
+        status lazy_projection::map_color_to_depth_sparse(image_interface *depth, int32_t npoints, pointF32 *pos_ij, pointF32 *pos_uv)
+        {
+            auto projection = get_projection();
+            return projection ? projection->map_color_to_depth_sparse(depth, npoints, pos_ij, pos_uv) : status_data_unavailable;
+        }
+
+        status lazy_projection::project_depth_to_camera(int32_t npoints, point3dF32 *pos_uvz, point3dF32 *pos3d)
+        {
+            auto projection = get_projection();
+            return projection ? projection->project_depth_to_camera(npoints, pos_uvz, pos3d) : status_data_unavailable;
+        }
+
+        status lazy_projection::project_color_to_camera(int32_t npoints, point3dF32 *pos_ijz, point3dF32 *pos3d)
+        {
+            auto projection = get_projection();
+            return projection ? projection->project_color_to_camera(npoints, pos_ijz, pos3d) : status_data_unavailable;
+        }
+
+        status lazy_projection::project_camera_to_depth(int32_t npoints, point3dF32 *pos3d, pointF32 *pos_uv)
+        {
+            auto projection = get_projection();
+            return projection ? projection->project_camera_to_depth(npoints, pos3d, pos_uv) : status_data_unavailable;
+        }
+
+        status lazy_projection::project_camera_to_color(int32_t npoints, point3dF32 *pos3d, pointF32 *pos_ij)
+        {
+            auto projection = get_projection();
+            return projection ? projection->project_camera_to_color(npoints, pos3d, pos_ij) : status_data_unavailable;
+        }
+
+        status lazy_projection::project_camera_to_depth(int32_t npoints, const float *pos3d_x, const float *pos3d_y, const float *pos3d_z,
+                                                        float *pos_u, float *pos_v)
+        {
+            auto projection = get_projection();
+            return projection ? projection->project_camera_to_depth(npoints, pos3d_x, pos3d_y, pos3d_z, pos_u, pos_v) : status_data_unavailable;
+        }
+
+        status lazy_projection::project_camera_to_color(int32_t npoints, const float *pos3d_x, const float *pos3d_y, const float *pos3d_z,
+                                                        float *pos_i, float *pos_j)
+        {
+            auto projection = get_projection();
+            return projection ? projection->project_camera_to_color(npoints, pos3d_x, pos3d_y, pos3d_z, pos_i, pos_j) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_uvmap(image_interface *depth, pointF32 *uvmap)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_uvmap(depth, uvmap) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_invuvmap(image_interface *depth, pointF32 *inv_uvmap)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_invuvmap(depth, inv_uvmap) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_vertices(image_interface *depth, point3dF32 *vertices)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_vertices(depth, vertices) : status_data_unavailable;
+        }
+
+        image_interface * lazy_projection::create_color_image_mapped_to_depth(image_interface *depth, image_interface *color)
+        {
+            auto projection = get_projection();
+            return projection ? projection->create_color_image_mapped_to_depth(depth, color) : nullptr;
+        }
+
+        image_interface * lazy_projection::create_depth_image_mapped_to_color(image_interface *depth, image_interface *color)
+        {
+            auto projection = get_projection();
+            return projection ? projection->create_depth_image_mapped_to_color(depth, color) : nullptr;
+        }
+
+        status lazy_projection::map_depth_to_color_batch(int32_t nbuffers, const int32_t *npoints, point3dF32 **pos_uvz, pointF32 **pos_ij)
+        {
+            auto projection = get_projection();
+            return projection ? projection->map_depth_to_color_batch(nbuffers, npoints, pos_uvz, pos_ij) : status_data_unavailable;
+        }
+
+        status lazy_projection::project_camera_to_color_batch(int32_t nbuffers, const int32_t *npoints, point3dF32 **pos3d, pointF32 **pos_ij)
+        {
+            auto projection = get_projection();
+            return projection ? projection->project_camera_to_color_batch(nbuffers, npoints, pos3d, pos_ij) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_uvmap_batch(int32_t nframes, image_interface **depth, pointF32 **uvmap)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_uvmap_batch(nframes, depth, uvmap) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_vertices_batch(int32_t nframes, image_interface **depth, point3dF32 **vertices)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_vertices_batch(nframes, depth, vertices) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_uvmap_resident(image_interface *depth, const projection_output_interface **uvmap)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_uvmap_resident(depth, uvmap) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_vertices_resident(image_interface *depth, const projection_output_interface **vertices)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_vertices_resident(depth, vertices) : status_data_unavailable;
+        }
+
+        image_interface * lazy_projection::create_color_image_mapped_to_depth(image_interface *depth, image_interface *color, uint8_t *data, int32_t pitch)
+        {
+            auto projection = get_projection();
+            return projection ? projection->create_color_image_mapped_to_depth(depth, color, data, pitch) : nullptr;
+        }
+
+        image_interface * lazy_projection::create_depth_image_mapped_to_color(image_interface *depth, image_interface *color, uint8_t *data, int32_t pitch)
+        {
+            auto projection = get_projection();
+            return projection ? projection->create_depth_image_mapped_to_color(depth, color, data, pitch) : nullptr;
+        }
+
+        status lazy_projection::query_uvmap(image_interface *depth, rect roi, pointF32 *uvmap, int32_t pitch)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_uvmap(depth, roi, uvmap, pitch) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_vertices(image_interface *depth, rect roi, point3dF32 *vertices, int32_t pitch)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_vertices(depth, roi, vertices, pitch) : status_data_unavailable;
+        }
+
+        image_interface * lazy_projection::create_color_image_mapped_to_depth(image_interface *depth, image_interface *color, rect roi, uint8_t *data, int32_t pitch)
+        {
+            auto projection = get_projection();
+            return projection ? projection->create_color_image_mapped_to_depth(depth, color, roi, data, pitch) : nullptr;
+        }
+
+        image_interface * lazy_projection::create_depth_image_mapped_to_color(image_interface *depth, image_interface *color, rect roi, uint8_t *data, int32_t pitch)
+        {
+            auto projection = get_projection();
+            return projection ? projection->create_depth_image_mapped_to_color(depth, color, roi, data, pitch) : nullptr;
+        }
+
+        status lazy_projection::query_vertices(image_interface *depth, rect roi, vertex_format format, void *vertices, int32_t pitch)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_vertices(depth, roi, format, vertices, pitch) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_depth_rays(pointF32 *rays)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_depth_rays(rays) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_valid_vertices(image_interface *depth, point3dF32 *vertices, int32_t *pixel_indices, int32_t *nvertices)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_valid_vertices(depth, vertices, pixel_indices, nvertices) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_voxelized_vertices(image_interface *depth, float voxel_size, point3dF32 *voxels, int32_t *nvoxels)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_voxelized_vertices(depth, voxel_size, voxels, nvoxels) : status_data_unavailable;
+        }
+
+        status lazy_projection::set_incremental_registration(bool enable, uint16_t depth_threshold)
+        {
+            auto projection = get_projection();
+            return projection ? projection->set_incremental_registration(enable, depth_threshold) : status_data_unavailable;
+        }
+
+        status lazy_projection::set_splatted_registration(bool enable, int32_t splat_size)
+        {
+            auto projection = get_projection();
+            return projection ? projection->set_splatted_registration(enable, splat_size) : status_data_unavailable;
+        }
+
+        status lazy_projection::set_fixed_point_projection(bool enable)
+        {
+            auto projection = get_projection();
+            return projection ? projection->set_fixed_point_projection(enable) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_shared_uvmap(image_interface *depth, const pointF32 **uvmap)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_shared_uvmap(depth, uvmap) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_shared_vertices(image_interface *depth, const point3dF32 **vertices)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_shared_vertices(depth, vertices) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_shared_color_image_mapped_to_depth(image_interface *depth, image_interface *color, const image_interface **mapped)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_shared_color_image_mapped_to_depth(depth, color, mapped) : status_data_unavailable;
+        }
+
+        status lazy_projection::query_shared_depth_image_mapped_to_color(image_interface *depth, image_interface *color, const image_interface **mapped)
+        {
+            auto projection = get_projection();
+            return projection ? projection->query_shared_depth_image_mapped_to_color(depth, color, mapped) : status_data_unavailable;
+        }
+
+        int lazy_projection::release() const
+        {
+            delete this;
+            return 0;
+        }
+    }
+}
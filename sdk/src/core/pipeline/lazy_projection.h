@@ -0,0 +1,77 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <memory>
+#include <mutex>
+#include "rs/core/projection_interface.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief The lazy_projection class
+         *
+         * Forwards to the projection of the device calibration, which is created on the first projection call. The projections are
+         * cached per calibration for the process lifetime, so a pipeline which is configured or started again with the same device reuses
+         * the initialized projection. A projection which fails to initialize fails the calls with \c status_data_unavailable.
+         */
+        class lazy_projection : public projection_interface
+        {
+        public:
+            lazy_projection(const intrinsics & color_intrinsics, const intrinsics & depth_intrinsics, const extrinsics & depth_to_color_extrinsics);
+
+            status map_depth_to_color(int32_t npoints, point3dF32 *pos_uvz, pointF32 *pos_ij) override;
+            status map_color_to_depth(image_interface *depth, int32_t npoints, pointF32 *pos_ij, pointF32 *pos_uv) override;
+            status map_color_to_depth_sparse(image_interface *depth, int32_t npoints, pointF32 *pos_ij, pointF32 *pos_uv) override;
+            status project_depth_to_camera(int32_t npoints, point3dF32 *pos_uvz, point3dF32 *pos3d) override;
+            status project_color_to_camera(int32_t npoints, point3dF32 *pos_ijz, point3dF32 *pos3d) override;
+            status project_camera_to_depth(int32_t npoints, point3dF32 *pos3d, pointF32 *pos_uv) override;
+            status project_camera_to_color(int32_t npoints, point3dF32 *pos3d, pointF32 *pos_ij) override;
+            status project_camera_to_depth(int32_t npoints, const float *pos3d_x, const float *pos3d_y, const float *pos3d_z,
+                                           float *pos_u, float *pos_v) override;
+            status project_camera_to_color(int32_t npoints, const float *pos3d_x, const float *pos3d_y, const float *pos3d_z,
+                                           float *pos_i, float *pos_j) override;
+            status query_uvmap(image_interface *depth, pointF32 *uvmap) override;
+            status query_invuvmap(image_interface *depth, pointF32 *inv_uvmap) override;
+            status query_vertices(image_interface *depth, point3dF32 *vertices) override;
+            image_interface* create_color_image_mapped_to_depth(image_interface *depth, image_interface *color) override;
+            image_interface* create_depth_image_mapped_to_color(image_interface *depth, image_interface *color) override;
+            status map_depth_to_color_batch(int32_t nbuffers, const int32_t *npoints, point3dF32 **pos_uvz, pointF32 **pos_ij) override;
+            status project_camera_to_color_batch(int32_t nbuffers, const int32_t *npoints, point3dF32 **pos3d, pointF32 **pos_ij) override;
+            status query_uvmap_batch(int32_t nframes, image_interface **depth, pointF32 **uvmap) override;
+            status query_vertices_batch(int32_t nframes, image_interface **depth, point3dF32 **vertices) override;
+            status query_uvmap_resident(image_interface *depth, const projection_output_interface **uvmap) override;
+            status query_vertices_resident(image_interface *depth, const projection_output_interface **vertices) override;
+            image_interface* create_color_image_mapped_to_depth(image_interface *depth, image_interface *color, uint8_t *data, int32_t pitch) override;
+            image_interface* create_depth_image_mapped_to_color(image_interface *depth, image_interface *color, uint8_t *data, int32_t pitch) override;
+            status query_uvmap(image_interface *depth, rect roi, pointF32 *uvmap, int32_t pitch) override;
+            status query_vertices(image_interface *depth, rect roi, point3dF32 *vertices, int32_t pitch) override;
+            image_interface* create_color_image_mapped_to_depth(image_interface *depth, image_interface *color, rect roi, uint8_t *data, int32_t pitch) override;
+            image_interface* create_depth_image_mapped_to_color(image_interface *depth, image_interface *color, rect roi, uint8_t *data, int32_t pitch) override;
+            status query_vertices(image_interface *depth, rect roi, vertex_format format, void *vertices, int32_t pitch) override;
+            status query_depth_rays(pointF32 *rays) override;
+            status query_valid_vertices(image_interface *depth, point3dF32 *vertices, int32_t *pixel_indices, int32_t *nvertices) override;
+            status query_voxelized_vertices(image_interface *depth, float voxel_size, point3dF32 *voxels, int32_t *nvoxels) override;
+            status set_incremental_registration(bool enable, uint16_t depth_threshold) override;
+            status set_splatted_registration(bool enable, int32_t splat_size) override;
+            status set_fixed_point_projection(bool enable) override;
+            status query_shared_uvmap(image_interface *depth, const pointF32 **uvmap) override;
+            status query_shared_vertices(image_interface *depth, const point3dF32 **vertices) override;
+            status query_shared_color_image_mapped_to_depth(image_interface *depth, image_interface *color, const image_interface **mapped) override;
+            status query_shared_depth_image_mapped_to_color(image_interface *depth, image_interface *color, const image_interface **mapped) override;
+
+            int release() const override;
+        private:
+            intrinsics m_color_intrinsics;
+            intrinsics m_depth_intrinsics;
+            extrinsics m_depth_to_color_extrinsics;
+            std::once_flag m_projection_created;
+            std::shared_ptr<projection_interface> m_projection;
+
+            //the projection of the calibration, null if it failed to initialize
+            projection_interface * get_projection();
+        };
+    }
+}
@@ -0,0 +1,300 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+#include "rs_sdk_version.h"
+#include "rs/utils/log_utils.h"
+#include "lazy_video_module.h"
+
+using namespace std;
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            void * open_library(const string & library_path)
+            {
+#ifdef WIN32
+                return LoadLibraryA(library_path.c_str());
+#else
+                return dlopen(library_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+            }
+
+            void * find_symbol(void * handle, const char * name)
+            {
+#ifdef WIN32
+                return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(handle), name));
+#else
+                return dlsym(handle, name);
+#endif
+            }
+
+            void close_library(void * handle)
+            {
+#ifdef WIN32
+                FreeLibrary(static_cast<HMODULE>(handle));
+#else
+                dlclose(handle);
+#endif
+            }
+        }
+
+        shared_ptr<plugin_library> plugin_library::load(const string & library_path)
+        {
+            void * handle = open_library(library_path);
+            if(!handle)
+            {
+#ifdef WIN32
+                LOG_ERROR("failed to load the module library " << library_path.c_str());
+#else
+                const char * error_message = dlerror();
+                LOG_ERROR("failed to load the module library " << library_path.c_str() << ": " << (error_message ? error_message : ""));
+#endif
+                return nullptr;
+            }
+
+            auto version = reinterpret_cast<rs_video_module_plugin_version_func>(find_symbol(handle, RS_VIDEO_MODULE_PLUGIN_VERSION_FUNC));
+            auto create = reinterpret_cast<rs_video_module_plugin_create_func>(find_symbol(handle, RS_VIDEO_MODULE_PLUGIN_CREATE_FUNC));
+            auto destroy = reinterpret_cast<rs_video_module_plugin_destroy_func>(find_symbol(handle, RS_VIDEO_MODULE_PLUGIN_DESTROY_FUNC));
+            if(!version || !create || !destroy)
+            {
+                LOG_ERROR("the library " << library_path.c_str() << " doesn't export the module entry points");
+                close_library(handle);
+                return nullptr;
+            }
+
+            int32_t major = -1, minor = -1;
+            uint32_t supported_config_size = 0;
+            version(&major, &minor, &supported_config_size);
+            if(major != SDK_VER_MAJOR || (major == 0 && minor != SDK_VER_MINOR) ||
+               supported_config_size != sizeof(video_module_interface::supported_module_config))
+            {
+                LOG_ERROR("the module library " << library_path.c_str() << " version " << major << "." << minor << " doesn't match the sdk version");
+                close_library(handle);
+                return nullptr;
+            }
+
+            return shared_ptr<plugin_library>(new plugin_library(handle, create, destroy));
+        }
+
+        plugin_library::plugin_library(void * handle, rs_video_module_plugin_create_func create, rs_video_module_plugin_destroy_func destroy) :
+            m_handle(handle), m_create(create), m_destroy(destroy) {}
+
+        plugin_library::~plugin_library()
+        {
+            close_library(m_handle);
+        }
+
+        lazy_video_module::lazy_video_module(const module_manifest & manifest, const string & library_path, shared_ptr<plugin_library_slot> library_slot) :
+            m_manifest(manifest),
+            m_library_path(library_path),
+            m_library_slot(library_slot),
+            m_instance(nullptr),
+            m_handler(nullptr),
+            m_output_forwarder(this) {}
+
+        int32_t lazy_video_module::query_module_uid()
+        {
+            return m_manifest.uid;
+        }
+
+        status lazy_video_module::query_supported_module_config(int32_t idx, supported_module_config & supported_config)
+        {
+            if(idx < 0 || static_cast<size_t>(idx) >= m_manifest.supported_configs.size())
+            {
+                return status_item_unavailable;
+            }
+            supported_config = m_manifest.supported_configs[idx];
+            return status_no_error;
+        }
+
+        status lazy_video_module::query_current_module_config(actual_module_config & module_config)
+        {
+            auto instance = query_instance();
+            return instance ? instance->query_current_module_config(module_config) : status_data_unavailable;
+        }
+
+        status lazy_video_module::set_module_config(const actual_module_config & module_config)
+        {
+            auto instance = get_instance();
+            return instance ? instance->set_module_config(module_config) : status_init_failed;
+        }
+
+        status lazy_video_module::process_sample_set(const correlated_sample_set & sample_set)
+        {
+            auto instance = query_instance();
+            return instance ? instance->process_sample_set(sample_set) : status_data_unavailable;
+        }
+
+        status lazy_video_module::process_multi_device_sample_set(const correlated_sample_set * sample_sets, uint32_t device_count)
+        {
+            auto instance = query_instance();
+            return instance ? instance->process_multi_device_sample_set(sample_sets, device_count) : status_data_unavailable;
+        }
+
+        status lazy_video_module::process_sample_set_batch(const correlated_sample_set * sample_sets, uint32_t count)
+        {
+            auto instance = query_instance();
+            return instance ? instance->process_sample_set_batch(sample_sets, count) : status_data_unavailable;
+        }
+
+        status lazy_video_module::query_module_config_hash(uint64_t & config_hash)
+        {
+            auto instance = query_instance();
+            return instance ? instance->query_module_config_hash(config_hash) : status_data_unavailable;
+        }
+
+        status lazy_video_module::save_module_output(const correlated_sample_set & sample_set, std::vector<uint8_t> & output)
+        {
+            auto instance = query_instance();
+            return instance ? instance->save_module_output(sample_set, output) : status_data_unavailable;
+        }
+
+        status lazy_video_module::restore_module_output(const correlated_sample_set & sample_set, const uint8_t * output, uint32_t size)
+        {
+            auto instance = query_instance();
+            return instance ? instance->restore_module_output(sample_set, output, size) : status_data_unavailable;
+        }
+
+        status lazy_video_module::register_event_handler(processing_event_handler * handler)
+        {
+            if(!handler)
+            {
+                return status_handle_invalid;
+            }
+
+            lock_guard<mutex> lock(m_load_lock);
+            auto registered_handler = m_handler.load();
+            if(registered_handler == handler)
+            {
+                return status_param_inplace;
+            }
+            if(registered_handler)
+            {
+                return status_param_unsupported;
+            }
+
+            auto instance = query_instance();
+            if(instance)
+            {
+                auto sts = instance->register_event_handler(&m_output_forwarder);
+                if(sts < status_no_error)
+                {
+                    return sts;
+                }
+            }
+            m_handler.store(handler);
+            return status_no_error;
+        }
+
+        status lazy_video_module::unregister_event_handler(processing_event_handler * handler)
+        {
+            lock_guard<mutex> lock(m_load_lock);
+            if(!handler || m_handler.load() != handler)
+            {
+                return status_handle_invalid;
+            }
+
+            auto instance = query_instance();
+            if(instance)
+            {
+                instance->unregister_event_handler(&m_output_forwarder);
+            }
+            m_handler.store(nullptr);
+            return status_no_error;
+        }
+
+        status lazy_video_module::flush_resources()
+        {
+            auto instance = query_instance();
+            return instance ? instance->flush_resources() : status_no_error;
+        }
+
+        status lazy_video_module::reset_config()
+        {
+            auto instance = query_instance();
+            return instance ? instance->reset_config() : status_no_error;
+        }
+
+        void lazy_video_module::output_forwarder::module_output_ready(video_module_interface * sender, correlated_sample_set * sample)
+        {
+            //the pipeline knows the module by this module, not by the library instance
+            auto handler = m_owner->m_handler.load();
+            if(handler)
+            {
+                handler->module_output_ready(m_owner, sample);
+            }
+        }
+
+        video_module_interface * lazy_video_module::get_instance()
+        {
+            auto instance = query_instance();
+            if(instance)
+            {
+                return instance;
+            }
+
+            lock_guard<mutex> lock(m_load_lock);
+            instance = query_instance();
+            if(instance)
+            {
+                return instance;
+            }
+
+            shared_ptr<plugin_library> library;
+            {
+                lock_guard<mutex> slot_lock(m_library_slot->lock);
+                library = m_library_slot->library.lock();
+                if(!library)
+                {
+                    library = plugin_library::load(m_library_path);
+                    m_library_slot->library = library;
+                }
+            }
+            if(!library)
+            {
+                return nullptr;
+            }
+
+            instance = library->create_module();
+            if(!instance)
+            {
+                LOG_ERROR("the module library " << m_library_path.c_str() << " failed to create its module");
+                return nullptr;
+            }
+            if(instance->query_module_uid() != m_manifest.uid)
+            {
+                LOG_ERROR("the module uid of the library " << m_library_path.c_str() << " doesn't match its manifest, the manifest should be written again");
+                library->destroy_module(instance);
+                return nullptr;
+            }
+
+            if(m_handler.load() && instance->register_event_handler(&m_output_forwarder) < status_no_error)
+            {
+                LOG_ERROR("failed to register the event handler to the module of the library " << m_library_path.c_str());
+            }
+
+            m_library = library;
+            m_instance.store(instance, memory_order_release);
+            return instance;
+        }
+
+        lazy_video_module::~lazy_video_module()
+        {
+            auto instance = query_instance();
+            if(instance)
+            {
+                m_library->destroy_module(instance);
+            }
+            //the library is unloaded with the last module it created
+            m_library.reset();
+        }
+    }
+}
@@ -0,0 +1,103 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "rs/core/video_module_plugin.h"
+#include "module_manifest.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief The plugin_library class
+         *
+         * A loaded module library and its entry points. The library is unloaded when the instance is destroyed, after the modules it
+         * created are destroyed.
+         */
+        class plugin_library
+        {
+        public:
+            // loads the library and resolves its entry points, returns null if the library can't be loaded, doesn't export the entry
+            // points or was built by another sdk version
+            static std::shared_ptr<plugin_library> load(const std::string & library_path);
+
+            video_module_interface * create_module() const { return m_create(); }
+            void destroy_module(video_module_interface * module) const { m_destroy(module); }
+
+            ~plugin_library();
+        private:
+            plugin_library(void * handle, rs_video_module_plugin_create_func create, rs_video_module_plugin_destroy_func destroy);
+
+            void * m_handle;
+            rs_video_module_plugin_create_func m_create;
+            rs_video_module_plugin_destroy_func m_destroy;
+        };
+
+        // the library of a manifest, shared by its modules, which load it once
+        struct plugin_library_slot
+        {
+            std::mutex lock;
+            std::weak_ptr<plugin_library> library;
+        };
+
+        /**
+         * @brief The lazy_video_module class
+         *
+         * Forwards to the module of a library, which is loaded on the first set_module_config call. Until then the uid and the
+         * supported configurations are answered from the library manifest, the calls which need the module instance fail with
+         * status_data_unavailable, and the resets are no-ops. A registered event handler is registered to the instance once it's
+         * created, the instance notifies its outputs as sent by this module.
+         */
+        class lazy_video_module : public video_module_interface
+        {
+        public:
+            lazy_video_module(const module_manifest & manifest, const std::string & library_path, std::shared_ptr<plugin_library_slot> library_slot);
+
+            int32_t query_module_uid() override;
+            status query_supported_module_config(int32_t idx, supported_module_config & supported_config) override;
+            status query_current_module_config(actual_module_config & module_config) override;
+            status set_module_config(const actual_module_config & module_config) override;
+            status process_sample_set(const correlated_sample_set & sample_set) override;
+            status process_multi_device_sample_set(const correlated_sample_set * sample_sets, uint32_t device_count) override;
+            status process_sample_set_batch(const correlated_sample_set * sample_sets, uint32_t count) override;
+            status query_module_config_hash(uint64_t & config_hash) override;
+            status save_module_output(const correlated_sample_set & sample_set, std::vector<uint8_t> & output) override;
+            status restore_module_output(const correlated_sample_set & sample_set, const uint8_t * output, uint32_t size) override;
+            status register_event_handler(processing_event_handler * handler) override;
+            status unregister_event_handler(processing_event_handler * handler) override;
+            status flush_resources() override;
+            status reset_config() override;
+
+            // the module instance of the library, null until it's loaded
+            video_module_interface * query_instance() const { return m_instance.load(std::memory_order_acquire); }
+
+            ~lazy_video_module();
+        private:
+            class output_forwarder : public processing_event_handler
+            {
+            public:
+                output_forwarder(lazy_video_module * owner) : m_owner(owner) {}
+                void module_output_ready(video_module_interface * sender, correlated_sample_set * sample) override;
+            private:
+                lazy_video_module * m_owner;
+            };
+
+            //loads the library and creates the instance, returns null if it failed
+            video_module_interface * get_instance();
+
+            const module_manifest m_manifest;
+            const std::string m_library_path;
+            std::shared_ptr<plugin_library_slot> m_library_slot;
+            std::mutex m_load_lock;
+            std::shared_ptr<plugin_library> m_library;
+            std::atomic<video_module_interface *> m_instance;
+            std::atomic<processing_event_handler *> m_handler;
+            output_forwarder m_output_forwarder;
+        };
+    }
+}
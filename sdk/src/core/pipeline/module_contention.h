@@ -0,0 +1,30 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief Counts the latency critical modules which have a sample set queued or in process, shared by the pipeline consumers.
+         *
+         * The best effort modules consumers throttle their input while a latency critical module is busy, so the pipeline threads
+         * process the latency critical sample sets first.
+         */
+        class module_contention
+        {
+        public:
+            module_contention() : m_busy_latency_critical_count(0) {}
+
+            void on_latency_critical_busy() { m_busy_latency_critical_count.fetch_add(1, std::memory_order_relaxed); }
+            void on_latency_critical_idle() { m_busy_latency_critical_count.fetch_sub(1, std::memory_order_relaxed); }
+            bool is_contended() const { return m_busy_latency_critical_count.load(std::memory_order_relaxed) > 0; }
+        private:
+            std::atomic<uint32_t> m_busy_latency_critical_count;
+        };
+    }
+}
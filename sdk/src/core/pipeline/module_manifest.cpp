@@ -0,0 +1,128 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include <fstream>
+#include "rs_sdk_version.h"
+#include "module_manifest.h"
+
+using namespace std;
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            const char MANIFEST_MAGIC[8] = { 'R', 'S', 'V', 'M', 'O', 'D', 'M', 'F' };
+            const uint32_t MANIFEST_FORMAT_VERSION = 1;
+            const uint32_t MAX_LIBRARY_NAME_SIZE = 1024;
+            const uint32_t MAX_SUPPORTED_CONFIGS = 1024;
+
+            struct manifest_header
+            {
+                char     magic[8];
+                uint32_t format_version;
+                int32_t  sdk_major;
+                int32_t  sdk_minor;
+                uint32_t supported_config_size;
+                int32_t  uid;
+                uint32_t library_name_size;
+                uint32_t supported_configs_count;
+            };
+        }
+
+        string module_manifest_path(const string & library_path)
+        {
+            return library_path + ".manifest";
+        }
+
+        status read_module_manifest(const string & manifest_path, module_manifest & manifest)
+        {
+            ifstream file(manifest_path, ios::binary);
+            if(!file.is_open())
+            {
+                return status_file_open_failed;
+            }
+
+            manifest_header header = {};
+            if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+               memcmp(header.magic, MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC)) != 0 ||
+               header.format_version != MANIFEST_FORMAT_VERSION)
+            {
+                return status_file_read_failed;
+            }
+
+            //the configurations are raw structs, they are valid only for the sdk which wrote them
+            if(header.sdk_major != SDK_VER_MAJOR || (header.sdk_major == 0 && header.sdk_minor != SDK_VER_MINOR) ||
+               header.supported_config_size != sizeof(video_module_interface::supported_module_config))
+            {
+                return status_file_read_failed;
+            }
+
+            if(header.library_name_size == 0 || header.library_name_size > MAX_LIBRARY_NAME_SIZE ||
+               header.supported_configs_count > MAX_SUPPORTED_CONFIGS)
+            {
+                return status_file_read_failed;
+            }
+
+            module_manifest read_manifest;
+            read_manifest.uid = header.uid;
+            read_manifest.library_name.resize(header.library_name_size);
+            read_manifest.supported_configs.resize(header.supported_configs_count);
+            if(!file.read(&read_manifest.library_name[0], header.library_name_size) ||
+               !file.read(reinterpret_cast<char*>(read_manifest.supported_configs.data()),
+                          header.supported_configs_count * sizeof(video_module_interface::supported_module_config)))
+            {
+                return status_file_read_failed;
+            }
+
+            //a manifest names a library of its directory, not a path
+            if(read_manifest.library_name.find_first_of("/\\") != string::npos ||
+               read_manifest.library_name.find('\0') != string::npos)
+            {
+                return status_file_read_failed;
+            }
+
+            for(auto & config : read_manifest.supported_configs)
+            {
+                config.device_name[sizeof(config.device_name) - 1] = '\0';
+            }
+
+            manifest = std::move(read_manifest);
+            return status_no_error;
+        }
+
+        status write_module_manifest(const string & manifest_path, const module_manifest & manifest)
+        {
+            if(manifest.library_name.empty() || manifest.library_name.size() > MAX_LIBRARY_NAME_SIZE ||
+               manifest.supported_configs.size() > MAX_SUPPORTED_CONFIGS)
+            {
+                return status_invalid_argument;
+            }
+
+            manifest_header header = {};
+            memcpy(header.magic, MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC));
+            header.format_version = MANIFEST_FORMAT_VERSION;
+            header.sdk_major = SDK_VER_MAJOR;
+            header.sdk_minor = SDK_VER_MINOR;
+            header.supported_config_size = sizeof(video_module_interface::supported_module_config);
+            header.uid = manifest.uid;
+            header.library_name_size = static_cast<uint32_t>(manifest.library_name.size());
+            header.supported_configs_count = static_cast<uint32_t>(manifest.supported_configs.size());
+
+            ofstream file(manifest_path, ios::binary | ios::trunc);
+            if(!file.is_open())
+            {
+                return status_file_write_failed;
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(manifest.library_name.data(), manifest.library_name.size());
+            file.write(reinterpret_cast<const char*>(manifest.supported_configs.data()),
+                       manifest.supported_configs.size() * sizeof(video_module_interface::supported_module_config));
+            file.close();
+            return file ? status_no_error : status_file_write_failed;
+        }
+    }
+}
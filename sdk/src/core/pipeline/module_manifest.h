@@ -0,0 +1,33 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <string>
+#include <vector>
+#include "rs/core/video_module_interface.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief The module_manifest struct
+         *
+         * The metadata of a module library, which is read without loading the library. The file is the header, the library file name
+         * and the supported configurations as raw structs, so a manifest is read only by the SDK version and the struct layout
+         * which wrote it.
+         */
+        struct module_manifest
+        {
+            int32_t uid;
+            std::string library_name; // the library file name, in the manifest directory
+            std::vector<video_module_interface::supported_module_config> supported_configs;
+        };
+
+        // the manifest path of a module library, the library path with the .manifest extension
+        std::string module_manifest_path(const std::string & library_path);
+
+        status read_module_manifest(const std::string & manifest_path, module_manifest & manifest);
+        status write_module_manifest(const std::string & manifest_path, const module_manifest & manifest);
+    }
+}
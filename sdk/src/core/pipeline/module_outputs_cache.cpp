@@ -0,0 +1,192 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include "rs/utils/log_utils.h"
+#include "module_outputs_cache.h"
+
+using namespace std;
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            const uint32_t RECORD_MAGIC = 0x4f4d5352; // "RSMO"
+
+            struct record_header
+            {
+                uint32_t magic;
+                uint32_t size;
+                uint64_t frame_id;
+            };
+
+            //fnv-1a over the bytes of each value
+            void hash_value(uint64_t & hash, uint64_t value)
+            {
+                for(int i = 0; i < 8; i++)
+                {
+                    hash ^= (value >> (i * 8)) & 0xff;
+                    hash *= 1099511628211ull;
+                }
+            }
+
+            uint64_t double_bits(double value)
+            {
+                uint64_t bits = 0;
+                memcpy(&bits, &value, sizeof(bits));
+                return bits;
+            }
+        }
+
+        std::shared_ptr<module_outputs_cache> module_outputs_cache::open(const std::string & directory_path, uint64_t source_id, video_module_interface * cv_module)
+        {
+            uint64_t config_hash = 0;
+            if(directory_path.empty() || cv_module->query_module_config_hash(config_hash) < status_no_error)
+            {
+                return nullptr;
+            }
+
+            std::ostringstream file_path;
+            file_path << directory_path << "/module_" << cv_module->query_module_uid() << "_" << std::hex << std::setw(16) << std::setfill('0') << config_hash << ".rsmo";
+            std::shared_ptr<module_outputs_cache> rv(new module_outputs_cache(cv_module, source_id, file_path.str()));
+            if(!rv->m_file.is_open())
+            {
+                LOG_WARN("failed to open the module outputs cache file " << file_path.str().c_str() << ", the module is processed");
+                return nullptr;
+            }
+            rv->load_records();
+            LOG_INFO("module outputs cache " << file_path.str().c_str() << " opened, number of outputs - " << rv->m_records.size());
+            return rv;
+        }
+
+        uint64_t module_outputs_cache::query_source_id(const std::string & file_path)
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for(auto character : file_path)
+            {
+                hash_value(hash, static_cast<uint8_t>(character));
+            }
+            std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+            hash_value(hash, file.is_open() ? static_cast<uint64_t>(file.tellg()) : 0);
+            return hash;
+        }
+
+        module_outputs_cache::module_outputs_cache(video_module_interface * cv_module, uint64_t source_id, const std::string & file_path) :
+            m_cv_module(cv_module), m_source_id(source_id), m_file_path(file_path), m_end(0), m_is_writable(true), m_restored_count(0), m_saved_count(0)
+        {
+            //the file is created on the first run, then read and appended by each run
+            std::ofstream(file_path, std::ios::binary | std::ios::app);
+            m_file.open(file_path, std::ios::binary | std::ios::in | std::ios::out);
+        }
+
+        void module_outputs_cache::load_records()
+        {
+            m_file.seekg(0, std::ios::end);
+            const uint64_t file_size = static_cast<uint64_t>(m_file.tellg());
+            m_file.seekg(0, std::ios::beg);
+            record_header header = {};
+            while(m_end + sizeof(header) <= file_size && m_file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+            {
+                const uint64_t offset = m_end + sizeof(header);
+                if(header.magic != RECORD_MAGIC || header.size > file_size - offset)
+                {
+                    break;
+                }
+                //a frame saved again by a later run replaces its earlier output
+                m_records[header.frame_id] = { offset, header.size };
+                m_end = offset + header.size;
+                m_file.seekg(static_cast<std::streamoff>(m_end), std::ios::beg);
+            }
+            if(m_end < file_size)
+            {
+                LOG_WARN("the module outputs cache " << m_file_path.c_str() << " ends with a partial output, it's overwritten by the next outputs");
+            }
+            m_file.clear();
+        }
+
+        uint64_t module_outputs_cache::query_frame_id(const correlated_sample_set & sample_set) const
+        {
+            uint64_t hash = 14695981039346656037ull;
+            hash_value(hash, m_source_id);
+            for(int stream = 0; stream < static_cast<int>(stream_type::max); stream++)
+            {
+                const image_interface * image = sample_set.images[stream];
+                if(image)
+                {
+                    hash_value(hash, static_cast<uint64_t>(stream));
+                    hash_value(hash, image->query_frame_number());
+                    hash_value(hash, double_bits(image->query_time_stamp()));
+                }
+            }
+            for(int motion = 0; motion < static_cast<int>(motion_type::max); motion++)
+            {
+                const motion_sample & sample = sample_set.motion_samples[motion];
+                if(sample.timestamp != 0)
+                {
+                    hash_value(hash, static_cast<uint64_t>(static_cast<int>(stream_type::max) + motion));
+                    hash_value(hash, sample.frame_number);
+                    hash_value(hash, double_bits(sample.timestamp));
+                }
+            }
+            return hash;
+        }
+
+        bool module_outputs_cache::restore(const correlated_sample_set & sample_set)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            auto saved = m_records.find(query_frame_id(sample_set));
+            if(saved == m_records.end())
+            {
+                return false;
+            }
+            m_output.resize(saved->second.size);
+            m_file.seekg(static_cast<std::streamoff>(saved->second.offset), std::ios::beg);
+            if(!m_file.read(reinterpret_cast<char *>(m_output.data()), saved->second.size))
+            {
+                m_file.clear();
+                LOG_WARN_RATE_LIMITED("failed to read a module output from " << m_file_path.c_str() << ", the sample set is processed");
+                return false;
+            }
+            if(m_cv_module->restore_module_output(sample_set, m_output.data(), saved->second.size) < status_no_error)
+            {
+                return false;
+            }
+            m_restored_count++;
+            return true;
+        }
+
+        void module_outputs_cache::save(const correlated_sample_set & sample_set)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_output.clear();
+            if(!m_is_writable || m_cv_module->save_module_output(sample_set, m_output) < status_no_error)
+            {
+                return;
+            }
+            const record_header header = { RECORD_MAGIC, static_cast<uint32_t>(m_output.size()), query_frame_id(sample_set) };
+            m_file.seekp(static_cast<std::streamoff>(m_end), std::ios::beg);
+            m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            m_file.write(reinterpret_cast<const char *>(m_output.data()), static_cast<std::streamsize>(m_output.size()));
+            if(!m_file.flush())
+            {
+                //a full disk stops the saving, the outputs saved so far are still restored
+                m_file.clear();
+                m_is_writable = false;
+                LOG_WARN("failed to write a module output to " << m_file_path.c_str() << ", the next outputs aren't saved");
+                return;
+            }
+            m_records[header.frame_id] = { m_end + sizeof(header), header.size };
+            m_end += sizeof(header) + header.size;
+            m_saved_count++;
+        }
+
+        module_outputs_cache::~module_outputs_cache()
+        {
+            LOG_INFO("module outputs cache " << m_file_path.c_str() << " closed, restored outputs - " << m_restored_count << " saved outputs - " << m_saved_count);
+        }
+    }
+}
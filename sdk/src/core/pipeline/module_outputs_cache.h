@@ -0,0 +1,65 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+#include "rs/core/video_module_interface.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief The saved outputs of a memoized module, see \c pipeline_async_interface::set_module_outputs_cache().
+         *
+         * The outputs of a module uid and config hash are appended to a file of the cache directory, each record holds the frame id
+         * of its sample set, a hash of the recording identity and of the frame numbers and timestamps of the sample set samples.
+         * The records index is loaded when the cache is opened, the outputs are read when they are restored. A record which was
+         * partially written by an interrupted run ends the index, the next outputs are written over it.
+         * The sync consumer handles a sample set at a time, the lock only orders the handlers which run on different workers.
+         */
+        class module_outputs_cache
+        {
+        public:
+            //opens the outputs of the current module config, null if the module isn't memoized or the file can't be opened
+            static std::shared_ptr<module_outputs_cache> open(const std::string & directory_path, uint64_t source_id, video_module_interface * cv_module);
+            //a hash of the recording path and size, the outputs of another recording aren't restored
+            static uint64_t query_source_id(const std::string & file_path);
+
+            //restores the saved output of the sample set into the module, false if it wasn't saved or the module failed to restore it
+            bool restore(const correlated_sample_set & sample_set);
+            //saves the output of the sample set the module processed
+            void save(const correlated_sample_set & sample_set);
+
+            ~module_outputs_cache();
+        private:
+            struct record
+            {
+                uint64_t offset; //of the output, past the record header
+                uint32_t size;
+            };
+
+            module_outputs_cache(video_module_interface * cv_module, uint64_t source_id, const std::string & file_path);
+            void load_records();
+            uint64_t query_frame_id(const correlated_sample_set & sample_set) const;
+
+            video_module_interface * m_cv_module;
+            const uint64_t m_source_id;
+            const std::string m_file_path;
+            std::mutex m_lock;
+            std::fstream m_file;
+            uint64_t m_end; //the end of the valid records
+            bool m_is_writable;
+            std::unordered_map<uint64_t, record> m_records; //by frame id
+            std::vector<uint8_t> m_output;
+            uint64_t m_restored_count;
+            uint64_t m_saved_count;
+        };
+    }
+}
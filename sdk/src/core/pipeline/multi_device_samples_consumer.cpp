@@ -0,0 +1,118 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "rs/utils/log_utils.h"
+#include "multi_device_samples_consumer.h"
+
+namespace rs
+{
+    namespace core
+    {
+        multi_device_samples_consumer::multi_device_samples_consumer(std::function<status(const correlated_sample_set * sample_sets, uint32_t device_count)> sample_sets_ready_handler,
+                                                                     const video_module_interface::actual_module_config & module_config,
+                                                                     const video_module_interface::supported_module_config::time_sync_mode time_sync_mode,
+                                                                     uint32_t time_sync_deadline,
+                                                                     work_stealing_executor & executor,
+                                                                     int affinity,
+                                                                     video_module_interface::supported_module_config::samples_queue_policy queue_policy,
+                                                                     uint32_t queue_depth) :
+            sync_samples_consumer([sample_sets_ready_handler](std::shared_ptr<correlated_sample_set> sample_set)
+                                  {
+                                      //the queued sample sets are created by the matching only
+                                      auto & matched = static_cast<const matched_sample_sets &>(*sample_set);
+                                      return sample_sets_ready_handler(matched.sample_sets.data(), static_cast<uint32_t>(matched.sample_sets.size()));
+                                  },
+                                  module_config,
+                                  time_sync_mode,
+                                  time_sync_deadline,
+                                  executor,
+                                  affinity,
+                                  work_stealing_executor::priority::normal,
+                                  queue_policy,
+                                  queue_depth),
+            m_device_count(module_config.device_count > 1 ? module_config.device_count : 1),
+            m_latest_sample_sets(m_device_count),
+            m_latest_sample_sets_count(0)
+        {
+            for(uint32_t device_index = 1; device_index < m_device_count; device_index++)
+            {
+                m_device_sync_stages.push_back(std::unique_ptr<device_sync_stage>(
+                    new device_sync_stage(*this, device_index, module_config, time_sync_mode, time_sync_deadline)));
+            }
+        }
+
+        uint32_t multi_device_samples_consumer::query_device_count() const
+        {
+            return m_device_count;
+        }
+
+        void multi_device_samples_consumer::notify_device_sample_set_non_blocking(uint32_t device_index, std::shared_ptr<correlated_sample_set> sample_set)
+        {
+            if(device_index == 0 || device_index >= m_device_count)
+            {
+                return;
+            }
+            m_device_sync_stages[device_index - 1]->notify_sample_set_non_blocking(std::move(sample_set));
+        }
+
+        void multi_device_samples_consumer::on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set)
+        {
+            match_device_sample_set(0, std::move(ready_sample_set));
+        }
+
+        void multi_device_samples_consumer::match_device_sample_set(uint32_t device_index, std::shared_ptr<correlated_sample_set> sample_set)
+        {
+            std::shared_ptr<matched_sample_sets> matched;
+            {
+                std::lock_guard<std::mutex> lock(m_matching_lock);
+                auto & latest_sample_set = m_latest_sample_sets[device_index];
+                if(latest_sample_set)
+                {
+                    m_statistics.on_unmatched_samples(*latest_sample_set);
+                }
+                else
+                {
+                    m_latest_sample_sets_count++;
+                }
+                latest_sample_set = std::move(sample_set);
+
+                if(m_latest_sample_sets_count < m_device_count)
+                {
+                    return;
+                }
+
+                matched = std::make_shared<matched_sample_sets>();
+                for(auto & device_sample_set : m_latest_sample_sets)
+                {
+                    matched->sample_sets.push_back(*device_sample_set);
+                    matched->owners.push_back(std::move(device_sample_set));
+                }
+                static_cast<correlated_sample_set &>(*matched) = matched->sample_sets[0];
+                m_latest_sample_sets_count = 0;
+            }
+            sync_samples_consumer::on_complete_sample_set(std::move(matched));
+        }
+
+        multi_device_samples_consumer::~multi_device_samples_consumer()
+        {
+
+        }
+
+        multi_device_samples_consumer::device_sync_stage::device_sync_stage(multi_device_samples_consumer & owner,
+                                                                            uint32_t device_index,
+                                                                            const video_module_interface::actual_module_config & module_config,
+                                                                            const video_module_interface::supported_module_config::time_sync_mode time_sync_mode,
+                                                                            uint32_t time_sync_deadline) :
+            samples_consumer_base(module_config, time_sync_mode, time_sync_deadline),
+            m_owner(owner),
+            m_device_index(device_index)
+        {
+
+        }
+
+        void multi_device_samples_consumer::device_sync_stage::on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set)
+        {
+            m_owner.match_device_sample_set(m_device_index, std::move(ready_sample_set));
+        }
+    }
+}
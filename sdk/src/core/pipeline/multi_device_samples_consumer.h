@@ -0,0 +1,83 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <mutex>
+#include <vector>
+#include <functional>
+#include "sync_samples_consumer.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief The multi_device_samples_consumer class
+         *
+         * Consumes the samples of several devices for a module with a multi-device configuration. The first device samples are
+         * notified as the samples of any consumer, the samples of each other device are time synced by a sync stage of the device,
+         * called by the device callbacks threads. The latest complete sample set of each device waits for the other devices, once
+         * all the devices have a sample set they are matched and handled as a single queued sample set on the pipeline executor.
+         * A sample set replaced by a newer sample set of its device before it was matched is counted as unmatched.
+         */
+        class multi_device_samples_consumer : public sync_samples_consumer
+        {
+        public:
+            multi_device_samples_consumer(std::function<status(const correlated_sample_set * sample_sets, uint32_t device_count)> sample_sets_ready_handler,
+                                          const video_module_interface::actual_module_config & module_config,
+                                          const video_module_interface::supported_module_config::time_sync_mode time_sync_mode,
+                                          uint32_t time_sync_deadline,
+                                          work_stealing_executor & executor,
+                                          int affinity,
+                                          video_module_interface::supported_module_config::samples_queue_policy queue_policy,
+                                          uint32_t queue_depth);
+
+            /**
+             * @brief Returns the number of devices the consumer matches.
+             */
+            uint32_t query_device_count() const;
+
+            /**
+             * @brief Notifies the consumer of a sample set of a device other than the first, the sample set is time synced by the device sync stage.
+             *
+             * The sample sets of the same device must be notified serially.
+             * @param[in] device_index  The device index, larger than 0 and smaller than the consumer device count
+             */
+            void notify_device_sample_set_non_blocking(uint32_t device_index, std::shared_ptr<correlated_sample_set> sample_set);
+
+            virtual ~multi_device_samples_consumer();
+        protected:
+            void on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set) override;
+        private:
+            class device_sync_stage : public samples_consumer_base
+            {
+            public:
+                device_sync_stage(multi_device_samples_consumer & owner,
+                                  uint32_t device_index,
+                                  const video_module_interface::actual_module_config & module_config,
+                                  const video_module_interface::supported_module_config::time_sync_mode time_sync_mode,
+                                  uint32_t time_sync_deadline);
+            protected:
+                void on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set) override;
+            private:
+                multi_device_samples_consumer & m_owner;
+                const uint32_t m_device_index;
+            };
+
+            //the queued matched sample set, the base sample set is the first device sample set
+            struct matched_sample_sets : public correlated_sample_set
+            {
+                std::vector<correlated_sample_set> sample_sets;
+                std::vector<std::shared_ptr<correlated_sample_set>> owners; //own the images references of the sample sets
+            };
+
+            const uint32_t m_device_count;
+            std::vector<std::unique_ptr<device_sync_stage>> m_device_sync_stages; //the sync stages of the devices after the first
+            std::mutex m_matching_lock;
+            std::vector<std::shared_ptr<correlated_sample_set>> m_latest_sample_sets; //guarded by m_matching_lock
+            uint32_t m_latest_sample_sets_count; //guarded by m_matching_lock
+
+            void match_device_sample_set(uint32_t device_index, std::shared_ptr<correlated_sample_set> sample_set);
+        };
+    }
+}
@@ -23,6 +23,11 @@ namespace rs
                return m_pimpl->add_cv_module(cv_module);
         }
 
+        status pipeline_async::connect_cv_modules(video_module_interface * upstream_module, video_module_interface * downstream_module)
+        {
+            return m_pimpl->connect_cv_modules(upstream_module, downstream_module);
+        }
+
         status pipeline_async::query_cv_module(uint32_t index, video_module_interface **cv_module) const
         {
             return m_pimpl->query_cv_module(index, cv_module);
@@ -63,6 +68,46 @@ namespace rs
             return m_pimpl->get_device();
         }
 
+        status pipeline_async::query_dropped_sample_sets_count(video_module_interface * cv_module, uint64_t & dropped_count) const
+        {
+            return m_pimpl->query_dropped_sample_sets_count(cv_module, dropped_count);
+        }
+
+        status pipeline_async::pull_sample_set(video_module_interface * cv_module, correlated_sample_set & sample_set)
+        {
+            return m_pimpl->pull_sample_set(cv_module, sample_set);
+        }
+
+        status pipeline_async::next_sample_set(video_module_interface * cv_module, correlated_sample_set & sample_set, uint32_t timeout_ms)
+        {
+            return m_pimpl->next_sample_set(cv_module, sample_set, timeout_ms);
+        }
+
+        status pipeline_async::set_trace_handler(pipeline_trace_handler * trace_handler)
+        {
+            return m_pimpl->set_trace_handler(trace_handler);
+        }
+
+        status pipeline_async::set_degradation_plan(const pipeline_degradation_plan & plan)
+        {
+            return m_pimpl->set_degradation_plan(plan);
+        }
+
+        status pipeline_async::set_module_outputs_cache(const char * directory_path)
+        {
+            return m_pimpl->set_module_outputs_cache(directory_path);
+        }
+
+        status pipeline_async::query_statistics(pipeline_statistics & statistics) const
+        {
+            return m_pimpl->query_statistics(statistics);
+        }
+
+        status pipeline_async::query_module_statistics(video_module_interface * cv_module, pipeline_module_statistics & statistics) const
+        {
+            return m_pimpl->query_module_statistics(cv_module, statistics);
+        }
+
         pipeline_async::~pipeline_async()
         {
             delete m_pimpl;
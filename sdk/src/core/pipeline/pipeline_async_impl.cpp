@@ -3,12 +3,15 @@
 
 #include <algorithm>
 #include <exception>
+#include <thread>
 #include "rs/utils/librealsense_conversion_utils.h"
 #include "rs/utils/log_utils.h"
+#include "rs/utils/profiler_markers.h"
 #include "pipeline_async_impl.h"
 #include "sync_samples_consumer.h"
 #include "async_samples_consumer.h"
 #include "config_util.h"
+#include "rs/synthetic/synthetic_context.h"
 
 using namespace std;
 using namespace rs::utils;
@@ -17,9 +20,37 @@ namespace rs
 {
     namespace core
     {
+        namespace
+        {
+            bool is_pulled_queue_policy(video_module_interface::supported_module_config::samples_queue_policy queue_policy)
+            {
+                return queue_policy == video_module_interface::supported_module_config::samples_queue_policy::pull_latest ||
+                       queue_policy == video_module_interface::supported_module_config::samples_queue_policy::pull_queued;
+            }
+
+            //the latency critical modules are scheduled first and the best effort modules last
+            int query_scheduling_rank(video_module_interface::supported_module_config::module_priority priority_class)
+            {
+                switch(priority_class)
+                {
+                    case video_module_interface::supported_module_config::module_priority::latency_critical: return 0;
+                    case video_module_interface::supported_module_config::module_priority::best_effort: return 2;
+                    default: return 1;
+                }
+            }
+        }
+
         pipeline_async_impl::pipeline_async_impl() :
             m_current_state(state::unconfigured),
             m_user_requested_time_sync_mode(video_module_interface::supported_module_config::time_sync_mode::sync_not_required),
+            m_user_requested_time_sync_deadline(0),
+            m_user_requested_queue_policy(video_module_interface::supported_module_config::samples_queue_policy::keep_latest),
+            m_user_requested_queue_depth(1),
+            m_user_requested_max_rate(0),
+            m_trace_handler(nullptr),
+            m_degradation_plan(),
+            m_app_callbacks_handler(nullptr),
+            m_is_lockstep_replay(false),
             m_device_manager(nullptr),
             m_context(new context()) { }
 
@@ -32,11 +63,30 @@ namespace rs
                 case pipeline_async::testing_mode::playback:
                     // initiate context from a playback file
                     m_context.reset(new rs::playback::context(file_path));
+                    m_playback_file_path = file_path;
+                    break;
+                case pipeline_async::testing_mode::replay:
+                {
+                    //the non real time playback delivers the next sample once the previous sample callback returned
+                    auto playback_context = new rs::playback::context(file_path);
+                    m_context.reset(playback_context);
+                    playback_context->get_playback_device()->set_real_time(false);
+                    m_is_lockstep_replay = true;
+                    m_playback_file_path = file_path;
                     break;
+                }
                 case pipeline_async::testing_mode::record:
                     // initiate context as a recording device
                     m_context.reset(new rs::record::context(file_path));
                     break;
+                case pipeline_async::testing_mode::synthetic:
+                    // initiate context from a synthetic device, optionally recorded
+                    m_source_context.reset(new rs::synthetic::context());
+                    if(file_path)
+                        m_context.reset(new rs::record::context(file_path, *m_source_context));
+                    else
+                        m_context = std::move(m_source_context);
+                    break;
                 }
             }
             catch(const std::exception & ex)
@@ -74,9 +124,83 @@ namespace rs
             }
 
             m_cv_modules.push_back(cv_module);
+            m_matching_supersets.clear();
+            return status_no_error;
+        }
+
+        status pipeline_async_impl::connect_cv_modules(video_module_interface * upstream_module, video_module_interface * downstream_module)
+        {
+            if(!upstream_module || !downstream_module)
+            {
+                return status_data_not_initialized;
+            }
+
+            std::lock_guard<std::mutex> state_guard(m_state_lock);
+            if(m_current_state != state::unconfigured)
+            {
+                return status_invalid_state;
+            }
+
+            if(std::find(m_cv_modules.begin(), m_cv_modules.end(), upstream_module) == m_cv_modules.end() ||
+               std::find(m_cv_modules.begin(), m_cv_modules.end(), downstream_module) == m_cv_modules.end())
+            {
+                return status_item_unavailable;
+            }
+
+            auto connection = std::make_pair(upstream_module, downstream_module);
+            if(std::find(m_cv_modules_connections.begin(), m_cv_modules_connections.end(), connection) != m_cv_modules_connections.end())
+            {
+                return status_param_inplace;
+            }
+
+            //the connection forms a cycle if the upstream module already processes the output of the downstream module
+            if(upstream_module == downstream_module || is_cv_module_reachable(downstream_module, upstream_module))
+            {
+                return status_param_unsupported;
+            }
+
+            m_cv_modules_connections.push_back(connection);
             return status_no_error;
         }
 
+        bool pipeline_async_impl::is_cv_module_downstream(video_module_interface * cv_module) const
+        {
+            return std::find_if(m_cv_modules_connections.begin(), m_cv_modules_connections.end(),
+                                [cv_module](const std::pair<video_module_interface *, video_module_interface *> & connection)
+                                {
+                                    return connection.second == cv_module;
+                                }) != m_cv_modules_connections.end();
+        }
+
+        bool pipeline_async_impl::is_cv_module_reachable(video_module_interface * from_module, video_module_interface * to_module) const
+        {
+            std::vector<video_module_interface *> modules_to_visit = { from_module };
+            std::vector<video_module_interface *> visited_modules;
+            while(!modules_to_visit.empty())
+            {
+                auto cv_module = modules_to_visit.back();
+                modules_to_visit.pop_back();
+                if(cv_module == to_module)
+                {
+                    return true;
+                }
+                if(std::find(visited_modules.begin(), visited_modules.end(), cv_module) != visited_modules.end())
+                {
+                    continue;
+                }
+                visited_modules.push_back(cv_module);
+
+                for(auto & connection : m_cv_modules_connections)
+                {
+                    if(connection.first == cv_module)
+                    {
+                        modules_to_visit.push_back(connection.second);
+                    }
+                }
+            }
+            return false;
+        }
+
         status pipeline_async_impl::query_cv_module(uint32_t index, video_module_interface ** cv_module) const
         {
             std::lock_guard<std::mutex> state_guard(m_state_lock);
@@ -113,7 +237,7 @@ namespace rs
             switch(m_current_state)
             {
                 case state::streaming:
-                    return status_invalid_state;
+                    return set_config_while_streaming_unsafe(config);
                 case state::configured:
                 case state::unconfigured:
                 default:
@@ -145,6 +269,7 @@ namespace rs
             }
 
             m_device_manager->query_current_config(current_config);
+            current_config.device_count = static_cast<uint32_t>(m_secondary_devices.size()) + 1;
             return status_no_error;
         }
 
@@ -177,42 +302,234 @@ namespace rs
             assert(m_current_state == state::configured && "the pipeline must be in configured state to start");
             assert(m_device_manager != nullptr && "on configured state the device manager must exist");
 
+            //the sync consumers handlers share the executor workers, a worker for each sync consumer up to the hardware threads
+            unsigned int sync_consumers_count = app_callbacks_handler ? 1 : 0;
+            for(auto cv_module : m_cv_modules)
+            {
+                if(!std::get<1>(m_modules_configs[cv_module]))
+                {
+                    sync_consumers_count++;
+                }
+            }
+            const unsigned int workers_count = std::min(std::max(std::thread::hardware_concurrency(), 1u), std::max(sync_consumers_count, 1u));
+            m_executor.reset(new work_stealing_executor(workers_count));
+
+            for(auto & received_samples_count : m_received_samples_count)
+            {
+                received_samples_count.store(0, std::memory_order_relaxed);
+            }
+            m_app_callbacks_handler = app_callbacks_handler;
+            create_samples_consumers();
+
+            try
+            {
+                m_device_manager->start();
+                for(auto & device : m_secondary_devices)
+                {
+                    device->manager->start();
+                }
+            }
+            catch(const std::exception & ex)
+            {
+                LOG_ERROR("failed to start device, error message : " << ex.what());
+                ordered_resources_reset();
+                return status_device_failed;
+            }
+            catch(...)
+            {
+                LOG_ERROR("failed to start device");
+                ordered_resources_reset();
+                return status_device_failed;
+            }
+
+            m_current_state = state::streaming;
+            return status_no_error;
+        }
+
+        void pipeline_async_impl::create_samples_consumers()
+        {
+            auto app_callbacks_handler = m_app_callbacks_handler;
             std::vector<std::shared_ptr<samples_consumer_base>> samples_consumers;
-            if(app_callbacks_handler)
+            std::map<video_module_interface *, std::shared_ptr<samples_consumer_base>> cv_modules_consumers;
+            std::vector<std::vector<std::shared_ptr<multi_device_samples_consumer>>> secondary_devices_consumers(m_secondary_devices.size());
+            std::shared_ptr<samples_consumer_base> app_consumer;
+            //the application callbacks don't wait behind the cv modules processing
+            int next_affinity = 0;
+            if(app_callbacks_handler || is_pulled_queue_policy(m_user_requested_queue_policy))
             {
                 video_module_interface::actual_module_config actual_pipeline_config = {};
                 m_device_manager->query_current_config(actual_pipeline_config);
                 //application samples consumer creation :
+                pipeline_tracer app_tracer(m_trace_handler, 0);
                 samples_consumers.push_back(std::unique_ptr<samples_consumer_base>(
                     new sync_samples_consumer(
-                            [app_callbacks_handler](std::shared_ptr<correlated_sample_set> sample_set)
+                            [app_callbacks_handler, app_tracer](std::shared_ptr<correlated_sample_set> sample_set)
                                 {
+                                  app_tracer.trace(pipeline_trace_stage::callback_begin, *sample_set);
                                   app_callbacks_handler->on_new_sample_set(*sample_set);
+                                  app_tracer.trace(pipeline_trace_stage::callback_end, *sample_set);
+                                  return status_no_error;
                                 },
                             actual_pipeline_config,
-                            m_user_requested_time_sync_mode)));
+                            m_user_requested_time_sync_mode,
+                            m_user_requested_time_sync_deadline,
+                            *m_executor,
+                            next_affinity++,
+                            work_stealing_executor::priority::high,
+                            query_consumer_queue_policy(m_user_requested_queue_policy),
+                            m_user_requested_queue_depth)));
+                samples_consumers.back()->set_tracer(app_tracer);
+                samples_consumers.back()->set_max_rate(m_user_requested_max_rate);
+                app_consumer = samples_consumers.back();
+            }
+            const uint64_t outputs_source_id = m_module_outputs_cache_path.empty() ? 0 : module_outputs_cache::query_source_id(m_playback_file_path);
+            //the consumers are notified in creation order, so the latency critical modules get each sample set first
+            std::vector<video_module_interface *> scheduled_cv_modules = m_cv_modules;
+            std::stable_sort(scheduled_cv_modules.begin(), scheduled_cv_modules.end(),
+                             [this](video_module_interface * first, video_module_interface * second)
+                             {
+                                 return query_scheduling_rank(std::get<6>(m_modules_configs[first])) < query_scheduling_rank(std::get<6>(m_modules_configs[second]));
+                             });
+            auto contention = std::make_shared<module_contention>();
+            //the modules share the controller of the plan, a replay processes every sample set
+            std::shared_ptr<degradation_controller> degradation;
+            if(m_degradation_plan.steps_count > 0 && !m_is_lockstep_replay)
+            {
+                degradation = std::make_shared<degradation_controller>(m_degradation_plan);
             }
             // create a samples consumer for each cv module
-            for(auto cv_module : m_cv_modules)
+            for(auto cv_module : scheduled_cv_modules)
             {
                 video_module_interface::actual_module_config & actual_module_config = std::get<0>(m_modules_configs[cv_module]);
                 bool is_cv_module_async = std::get<1>(m_modules_configs[cv_module]);
                 video_module_interface::supported_module_config::time_sync_mode module_time_sync_mode = std::get<2>(m_modules_configs[cv_module]);
+                uint32_t module_time_sync_deadline = std::get<3>(m_modules_configs[cv_module]);
+                auto module_queue_policy = std::get<4>(m_modules_configs[cv_module]);
+                uint32_t module_queue_depth = std::get<5>(m_modules_configs[cv_module]);
+                auto module_priority_class = std::get<6>(m_modules_configs[cv_module]);
+                uint32_t module_max_batch_size = std::get<8>(m_modules_configs[cv_module]);
+                uint32_t module_max_batch_delay = std::get<9>(m_modules_configs[cv_module]);
+                const bool is_latency_critical = module_priority_class == video_module_interface::supported_module_config::module_priority::latency_critical;
+                pipeline_tracer module_tracer(m_trace_handler, cv_module->query_module_uid());
                 if(is_cv_module_async)
                 {
                     samples_consumers.push_back(std::unique_ptr<samples_consumer_base>(new async_samples_consumer(
                                                                                                app_callbacks_handler,
                                                                                                cv_module,
                                                                                                actual_module_config,
-                                                                                               module_time_sync_mode)));
+                                                                                               module_time_sync_mode,
+                                                                                               module_time_sync_deadline)));
+                }
+                else if(actual_module_config.device_count > 1) //cv_module is sync with a multi-device configuration
+                {
+                    auto multi_device_consumer = std::make_shared<multi_device_samples_consumer>(
+                            [cv_module, app_callbacks_handler, module_tracer](const correlated_sample_set * sample_sets, uint32_t device_count)
+                            {
+                                module_tracer.trace(pipeline_trace_stage::process_begin, sample_sets[0]);
+                                auto status = cv_module->process_multi_device_sample_set(sample_sets, device_count);
+                                module_tracer.trace(pipeline_trace_stage::process_end, sample_sets[0]);
+
+                                if(status < status_no_error)
+                                {
+                                    LOG_ERROR("cv module failed to process multi-device sample set, error code" << status);
+                                    if(app_callbacks_handler)
+                                    {
+                                        app_callbacks_handler->on_error(status);
+                                    }
+                                    return status;
+                                }
+                                if(app_callbacks_handler)
+                                {
+                                    module_tracer.trace(pipeline_trace_stage::callback_begin, sample_sets[0]);
+                                    app_callbacks_handler->on_cv_module_process_complete(cv_module);
+                                    module_tracer.trace(pipeline_trace_stage::callback_end, sample_sets[0]);
+                                }
+                                return status;
+                            },
+                            actual_module_config,
+                            module_time_sync_mode,
+                            module_time_sync_deadline,
+                            *m_executor,
+                            next_affinity++,
+                            is_pulled_queue_policy(module_queue_policy) ?
+                                video_module_interface::supported_module_config::samples_queue_policy::keep_latest : module_queue_policy,
+                            module_queue_depth);
+                    multi_device_consumer->set_priority_class(module_priority_class, contention);
+                    multi_device_consumer->set_degradation_controller(degradation);
+                    //the first device samples are notified as the samples of any consumer, the other devices samples by their callbacks
+                    for(uint32_t device_index = 1; device_index < multi_device_consumer->query_device_count(); device_index++)
+                    {
+                        secondary_devices_consumers[device_index - 1].push_back(multi_device_consumer);
+                    }
+                    samples_consumers.push_back(multi_device_consumer);
+                }
+                else if(module_max_batch_size > 1 && !is_pulled_queue_policy(module_queue_policy)) //cv_module is sync and processes batches
+                {
+                    auto batched_consumer = std::make_shared<batched_samples_consumer>(
+                            [cv_module, app_callbacks_handler, module_tracer](const correlated_sample_set * sample_sets, uint32_t count)
+                            {
+                                RS_PROFILER_ZONE("batched cv module dispatch");
+                                module_tracer.trace(pipeline_trace_stage::process_begin, sample_sets[count - 1]);
+                                auto status = cv_module->process_sample_set_batch(sample_sets, count);
+                                if(status == status_feature_unsupported)
+                                {
+                                    //a module which doesn't process batches processes each sample set of the batch
+                                    status = status_no_error;
+                                    for(uint32_t index = 0; index < count && status >= status_no_error; index++)
+                                    {
+                                        status = cv_module->process_sample_set(sample_sets[index]);
+                                    }
+                                }
+                                module_tracer.trace(pipeline_trace_stage::process_end, sample_sets[count - 1]);
+
+                                if(status < status_no_error)
+                                {
+                                    LOG_ERROR("cv module failed to process sample sets batch, error code" << status);
+                                    if(app_callbacks_handler)
+                                    {
+                                        app_callbacks_handler->on_error(status);
+                                    }
+                                    return status;
+                                }
+                                if(app_callbacks_handler)
+                                {
+                                    module_tracer.trace(pipeline_trace_stage::callback_begin, sample_sets[count - 1]);
+                                    app_callbacks_handler->on_cv_module_process_complete(cv_module);
+                                    module_tracer.trace(pipeline_trace_stage::callback_end, sample_sets[count - 1]);
+                                }
+                                return status;
+                            },
+                            actual_module_config,
+                            module_time_sync_mode,
+                            module_time_sync_deadline,
+                            *m_executor,
+                            next_affinity++,
+                            is_latency_critical ? work_stealing_executor::priority::high : work_stealing_executor::priority::normal,
+                            query_consumer_queue_policy(module_queue_policy),
+                            module_queue_depth,
+                            module_max_batch_size,
+                            module_max_batch_delay);
+                    batched_consumer->set_priority_class(module_priority_class, m_is_lockstep_replay ? nullptr : contention);
+                    batched_consumer->set_degradation_controller(degradation);
+                    samples_consumers.push_back(batched_consumer);
                 }
                 else //cv_module is sync
                 {
-                    samples_consumers.push_back(std::unique_ptr<samples_consumer_base>(new sync_samples_consumer(
-                            [cv_module, app_callbacks_handler](std::shared_ptr<correlated_sample_set> sample_set)
+                    //a memoized module restores the saved output of a replayed sample set instead of processing it
+                    auto outputs_cache = module_outputs_cache::open(m_module_outputs_cache_path, outputs_source_id, cv_module);
+                    auto sync_consumer = std::make_shared<sync_samples_consumer>(
+                            [cv_module, app_callbacks_handler, module_tracer, outputs_cache](std::shared_ptr<correlated_sample_set> sample_set)
                             {
+                                RS_PROFILER_ZONE("sync cv module dispatch");
                                 //push to sample_set to the cv module
-                                auto status = cv_module->process_sample_set(*sample_set);
+                                module_tracer.trace(pipeline_trace_stage::process_begin, *sample_set);
+                                const bool is_restored = outputs_cache && outputs_cache->restore(*sample_set);
+                                auto status = is_restored ? status_no_error : cv_module->process_sample_set(*sample_set);
+                                if(outputs_cache && !is_restored && status >= status_no_error)
+                                {
+                                    outputs_cache->save(*sample_set);
+                                }
+                                module_tracer.trace(pipeline_trace_stage::process_end, *sample_set);
 
                                 if(status < status_no_error)
                                 {
@@ -221,41 +538,73 @@ namespace rs
                                     {
                                         app_callbacks_handler->on_error(status);
                                     }
-                                    return;
+                                    return status;
                                 }
                                 if(app_callbacks_handler)
                                 {
+                                    module_tracer.trace(pipeline_trace_stage::callback_begin, *sample_set);
                                     app_callbacks_handler->on_cv_module_process_complete(cv_module);
+                                    module_tracer.trace(pipeline_trace_stage::callback_end, *sample_set);
                                 }
+                                return status;
                             },
                             actual_module_config,
-                            module_time_sync_mode)));
+                            module_time_sync_mode,
+                            module_time_sync_deadline,
+                            *m_executor,
+                            next_affinity++,
+                            is_latency_critical ? work_stealing_executor::priority::high : work_stealing_executor::priority::normal,
+                            query_consumer_queue_policy(module_queue_policy),
+                            module_queue_depth);
+                    sync_consumer->set_priority_class(module_priority_class, m_is_lockstep_replay ? nullptr : contention);
+                    sync_consumer->set_degradation_controller(degradation);
+                    samples_consumers.push_back(sync_consumer);
+                }
+                samples_consumers.back()->set_tracer(module_tracer);
+                samples_consumers.back()->set_max_rate(std::get<7>(m_modules_configs[cv_module]));
+                cv_modules_consumers[cv_module] = samples_consumers.back();
+                //a downstream module gets only the output of its upstream modules
+                if(is_cv_module_downstream(cv_module))
+                {
+                    samples_consumers.pop_back();
                 }
             }
-
-            try
+            for(auto & connection : m_cv_modules_connections)
             {
-                m_device_manager->start();
+                cv_modules_consumers[connection.first]->add_downstream_consumer(cv_modules_consumers[connection.second]);
             }
-            catch(const std::exception & ex)
-            {
-                LOG_ERROR("failed to start device, error message : " << ex.what());
-                return status_device_failed;
-            }
-            catch(...)
+
+            //the consumers of the same streams and time sync mode share the time sync of the first of them,
+            //so the samples are matched once and the matched sample set is delivered to all of them
+            std::vector<std::shared_ptr<samples_consumer_base>> sync_stages;
+            for(auto & consumer : samples_consumers)
             {
-                LOG_ERROR("failed to start device");
-                return status_device_failed;
+                auto sync_stage = std::find_if(sync_stages.begin(), sync_stages.end(),
+                                               [&consumer](const std::shared_ptr<samples_consumer_base> & stage) { return stage->is_sharing_sync_stage(*consumer); });
+                if(sync_stage != sync_stages.end())
+                {
+                    (*sync_stage)->add_sync_stage_follower(std::move(consumer));
+                }
+                else
+                {
+                    sync_stages.push_back(std::move(consumer));
+                }
             }
 
             //commit to update the pipeline state
             {
                 std::lock_guard<std::mutex> samples_consumers_guard(m_samples_consumers_lock);
-                m_samples_consumers = std::move(samples_consumers);
+                m_samples_consumers = std::move(sync_stages);
+                m_cv_modules_consumers = std::move(cv_modules_consumers);
+                m_device_tracer = pipeline_tracer(m_trace_handler, 0);
+                m_app_consumer = std::move(app_consumer);
+            }
+            m_degradation = std::move(degradation);
+            for(size_t i = 0; i < m_secondary_devices.size(); i++)
+            {
+                std::lock_guard<std::mutex> consumers_guard(m_secondary_devices[i]->consumers_lock);
+                m_secondary_devices[i]->consumers = std::move(secondary_devices_consumers[i]);
             }
-
-            m_current_state = state::streaming;
-            return status_no_error;
         }
 
         status pipeline_async_impl::stop()
@@ -280,10 +629,20 @@ namespace rs
         {
             std::lock_guard<std::mutex> state_guard(m_state_lock);
             ordered_resources_reset();
+            m_secondary_devices.clear();
             m_device_manager.reset();
             m_cv_modules.clear();
+            m_cv_modules_connections.clear();
             m_modules_configs.clear();
+            m_modules_supported_configs.clear();
+            m_matching_supersets.clear();
             m_user_requested_time_sync_mode = video_module_interface::supported_module_config::time_sync_mode::sync_not_required;
+            m_user_requested_time_sync_deadline = 0;
+            m_user_requested_queue_policy = video_module_interface::supported_module_config::samples_queue_policy::keep_latest;
+            m_user_requested_queue_depth = 1;
+            m_user_requested_max_rate = 0;
+            m_trace_handler = nullptr;
+            m_degradation_plan = pipeline_degradation_plan();
             m_current_state = state::unconfigured;
             return status_no_error;
         }
@@ -297,33 +656,82 @@ namespace rs
             return m_device_manager->get_underlying_device();
         }
 
-        rs::device * pipeline_async_impl::get_device_from_config(const video_module_interface::supported_module_config & config) const
+        std::vector<rs::device *> pipeline_async_impl::get_devices_from_config(const video_module_interface::supported_module_config & config) const
         {
+            std::vector<rs::device *> devices;
+            const size_t requested_devices_count = std::max(config.device_count, 1u);
             auto device_count = m_context->get_device_count();
             auto is_any_device_valid = (std::strcmp(config.device_name, "") == 0);
-            for(int i = 0; i < device_count; ++i)
+            for(int i = 0; i < device_count && devices.size() < requested_devices_count; ++i)
             {
                 auto device = m_context->get_device(i);
-                if(is_any_device_valid || std::strcmp(config.device_name, device->get_name()) == 0)
+                if(is_any_device_valid || std::strcmp(config.device_name, get_device_capabilities(device).get_name()) == 0)
                 {
-                    return device;
+                    devices.push_back(device);
                 }
             }
-            return nullptr;
+            return devices;
         }
 
-        bool pipeline_async_impl::is_there_a_satisfying_module_config(video_module_interface * cv_module,
-                                                                      const video_module_interface::supported_module_config & given_config,
-                                                                      video_module_interface::supported_module_config & satisfying_config) const
+        const device_capabilities & pipeline_async_impl::get_device_capabilities(rs::device * device) const
         {
-            for(auto config_index = 0;; ++config_index)
+            auto & capabilities = m_devices_capabilities[device];
+            if(!capabilities)
+            {
+                capabilities.reset(new device_capabilities(device));
+            }
+            return *capabilities;
+        }
+
+        const std::vector<video_module_interface::supported_module_config> & pipeline_async_impl::get_module_supported_configs(video_module_interface * cv_module) const
+        {
+            auto supported_configs = m_modules_supported_configs.find(cv_module);
+            if(supported_configs != m_modules_supported_configs.end())
+            {
+                return supported_configs->second;
+            }
+
+            std::vector<video_module_interface::supported_module_config> configs;
+            for(uint32_t config_index = 0;; config_index++)
+            {
+                video_module_interface::supported_module_config module_config = {};
+                if(cv_module->query_supported_module_config(config_index, module_config) < status_no_error)
+                {
+                    break;
+                }
+                configs.push_back(module_config);
+            }
+            return m_modules_supported_configs[cv_module] = std::move(configs);
+        }
+
+        bool pipeline_async_impl::is_superset_negotiable(const video_module_interface::supported_module_config & superset,
+                                                         const std::vector<rs::device *> & devices) const
+        {
+            for(auto device : devices)
+            {
+                if(!get_device_capabilities(device).is_config_satisfied(superset))
+                {
+                    return false;
+                }
+            }
+
+            video_module_interface::supported_module_config satisfying_config = {};
+            for(auto cv_module : m_cv_modules)
             {
-                video_module_interface::supported_module_config supported_config = {};
-                if(cv_module->query_supported_module_config(config_index, supported_config) < status_no_error)
+                if(!is_there_a_satisfying_module_config(cv_module, superset, satisfying_config))
                 {
-                    //finished looping through the supported configs and haven't found a satisfying config
                     return false;
                 }
+            }
+            return true;
+        }
+
+        bool pipeline_async_impl::is_there_a_satisfying_module_config(video_module_interface * cv_module,
+                                                                      const video_module_interface::supported_module_config & given_config,
+                                                                      video_module_interface::supported_module_config & satisfying_config) const
+        {
+            for(auto supported_config : get_module_supported_configs(cv_module))
+            {
 
                 auto is_the_device_in_the_current_config_valid = std::strlen(given_config.device_name) == 0 ||
                                                                  (std::strcmp(given_config.device_name, supported_config.device_name) == 0);
@@ -388,26 +796,301 @@ namespace rs
                 return true;
             }
 
+            //finished looping through the supported configs and haven't found a satisfying config
             return false;
         }
 
+        status pipeline_async_impl::query_dropped_sample_sets_count(video_module_interface * cv_module, uint64_t & dropped_count) const
+        {
+            if(!cv_module)
+            {
+                return status_handle_invalid;
+            }
+
+            std::lock_guard<std::mutex> state_guard(m_state_lock);
+            if(m_current_state != state::streaming)
+            {
+                return status_invalid_state;
+            }
+
+            std::lock_guard<std::mutex> samples_consumers_guard(m_samples_consumers_lock);
+            auto cv_module_consumer = m_cv_modules_consumers.find(cv_module);
+            if(cv_module_consumer == m_cv_modules_consumers.end())
+            {
+                return status_item_unavailable;
+            }
+
+            dropped_count = cv_module_consumer->second->query_dropped_sample_sets_count();
+            return status_no_error;
+        }
+
+        status pipeline_async_impl::query_pulled_consumer(video_module_interface * cv_module, std::shared_ptr<samples_consumer_base> & consumer) const
+        {
+            std::lock_guard<std::mutex> state_guard(m_state_lock);
+            if(m_current_state != state::streaming)
+            {
+                return status_invalid_state;
+            }
+
+            std::lock_guard<std::mutex> samples_consumers_guard(m_samples_consumers_lock);
+            if(cv_module)
+            {
+                auto cv_module_consumer = m_cv_modules_consumers.find(cv_module);
+                if(cv_module_consumer == m_cv_modules_consumers.end())
+                {
+                    return status_item_unavailable;
+                }
+                consumer = cv_module_consumer->second;
+            }
+            else
+            {
+                consumer = m_app_consumer;
+            }
+            return consumer ? status_no_error : status_feature_unsupported;
+        }
+
+        void pipeline_async_impl::copy_pulled_sample_set(const correlated_sample_set & pulled_sample_set, correlated_sample_set & sample_set)
+        {
+            //the pulled sample set is released with the shared pointer, the caller gets its own images references
+            sample_set = pulled_sample_set;
+            for(auto image : sample_set.images)
+            {
+                if(image)
+                {
+                    image->add_ref();
+                }
+            }
+        }
+
+        status pipeline_async_impl::pull_sample_set(video_module_interface * cv_module, correlated_sample_set & sample_set)
+        {
+            std::shared_ptr<samples_consumer_base> consumer;
+            const status consumer_status = query_pulled_consumer(cv_module, consumer);
+            if(consumer_status != status_no_error)
+            {
+                return consumer_status;
+            }
+
+            std::shared_ptr<correlated_sample_set> pulled_sample_set;
+            const status pull_status = consumer->pull_sample_set(pulled_sample_set);
+            if(pull_status != status_no_error)
+            {
+                return pull_status;
+            }
+            copy_pulled_sample_set(*pulled_sample_set, sample_set);
+            return status_no_error;
+        }
+
+        status pipeline_async_impl::next_sample_set(video_module_interface * cv_module, correlated_sample_set & sample_set, uint32_t timeout_ms)
+        {
+            std::shared_ptr<samples_consumer_base> consumer;
+            const status consumer_status = query_pulled_consumer(cv_module, consumer);
+            if(consumer_status != status_no_error)
+            {
+                return consumer_status;
+            }
+
+            //the wait doesn't hold the pipeline locks, stopping the pipeline wakes the waiting thread
+            std::shared_ptr<correlated_sample_set> pulled_sample_set;
+            const status wait_status = consumer->wait_sample_set(pulled_sample_set, timeout_ms);
+            if(wait_status != status_no_error)
+            {
+                return wait_status;
+            }
+            copy_pulled_sample_set(*pulled_sample_set, sample_set);
+            return status_no_error;
+        }
+
+        status pipeline_async_impl::query_statistics(pipeline_statistics & statistics) const
+        {
+            //the consumers are replaced only under the state lock, the counters are sampled without the samples consumers lock
+            std::lock_guard<std::mutex> state_guard(m_state_lock);
+            if(m_current_state != state::streaming)
+            {
+                return status_invalid_state;
+            }
+
+            for(int stream_index = 0; stream_index < static_cast<int>(stream_type::max); stream_index++)
+            {
+                const stream_type stream = static_cast<stream_type>(stream_index);
+                pipeline_stream_statistics & stream_statistics = statistics[stream];
+                stream_statistics.received_samples_count = m_received_samples_count[stream_index].load(std::memory_order_relaxed);
+
+                //a sync stage matches once for all its consumers, the unmatched samples are counted by the sync stages
+                stream_statistics.unmatched_samples_count = 0;
+                for(auto & sync_stage : m_samples_consumers)
+                {
+                    stream_statistics.unmatched_samples_count += sync_stage->query_statistics().query_unmatched_samples_count(stream);
+                }
+
+                stream_statistics.dropped_samples_count = m_app_consumer ? m_app_consumer->query_statistics().query_dropped_samples_count(stream) : 0;
+                for(auto & cv_module_consumer : m_cv_modules_consumers)
+                {
+                    stream_statistics.dropped_samples_count += cv_module_consumer.second->query_statistics().query_dropped_samples_count(stream);
+                }
+            }
+            statistics.workers = m_executor ? m_executor->query_workers_statistics() : rs::utils::thread_statistics();
+            statistics.degradation_step = m_degradation ? m_degradation->query_step() : 0;
+            statistics.degradation_step_changes_count = m_degradation ? m_degradation->query_step_changes_count() : 0;
+            return status_no_error;
+        }
+
+        status pipeline_async_impl::query_module_statistics(video_module_interface * cv_module, pipeline_module_statistics & statistics) const
+        {
+            if(!cv_module)
+            {
+                return status_handle_invalid;
+            }
+
+            std::lock_guard<std::mutex> state_guard(m_state_lock);
+            if(m_current_state != state::streaming)
+            {
+                return status_invalid_state;
+            }
+
+            auto cv_module_consumer = m_cv_modules_consumers.find(cv_module);
+            if(cv_module_consumer == m_cv_modules_consumers.end())
+            {
+                return status_item_unavailable;
+            }
+
+            cv_module_consumer->second->query_module_statistics(statistics);
+            return status_no_error;
+        }
+
+        status pipeline_async_impl::set_trace_handler(pipeline_trace_handler * trace_handler)
+        {
+            std::lock_guard<std::mutex> state_guard(m_state_lock);
+            if(m_current_state == state::streaming)
+            {
+                return status_invalid_state;
+            }
+
+            m_trace_handler = trace_handler;
+            return status_no_error;
+        }
+
+        status pipeline_async_impl::set_degradation_plan(const pipeline_degradation_plan & plan)
+        {
+            if(plan.steps_count > static_cast<uint32_t>(pipeline_degradation_plan::MAX_STEPS))
+            {
+                return status_invalid_argument;
+            }
+
+            std::lock_guard<std::mutex> state_guard(m_state_lock);
+            if(m_current_state == state::streaming)
+            {
+                return status_invalid_state;
+            }
+
+            m_degradation_plan = plan;
+            return status_no_error;
+        }
+
+        status pipeline_async_impl::set_module_outputs_cache(const char * directory_path)
+        {
+            if(m_playback_file_path.empty())
+            {
+                return status_feature_unsupported;
+            }
+
+            std::lock_guard<std::mutex> state_guard(m_state_lock);
+            if(m_current_state == state::streaming)
+            {
+                return status_invalid_state;
+            }
+
+            m_module_outputs_cache_path = directory_path ? directory_path : "";
+            return status_no_error;
+        }
+
         void pipeline_async_impl::non_blocking_sample_callback(std::shared_ptr<correlated_sample_set> sample_set)
         {
             std::lock_guard<std::mutex> samples_consumers_guard(m_samples_consumers_lock);
+            m_device_tracer.trace(pipeline_trace_stage::device_callback, *sample_set);
+            count_received_samples(*sample_set);
             for(size_t i = 0; i < m_samples_consumers.size(); ++i)
             {
                 m_samples_consumers[i]->notify_sample_set_non_blocking(sample_set);
             }
         }
 
-        void pipeline_async_impl::ordered_resources_reset()
+        void pipeline_async_impl::non_blocking_secondary_sample_callback(secondary_device & device, std::shared_ptr<correlated_sample_set> sample_set)
         {
-            //the order of destruction is critical,
-            //the consumers must release all resources allocated by the device inorder to stop and release the device.
+            //each device has its own lock, so the devices callbacks don't wait for each other
+            std::lock_guard<std::mutex> consumers_guard(device.consumers_lock);
+            count_received_samples(*sample_set);
+            for(auto & consumer : device.consumers)
+            {
+                consumer->notify_device_sample_set_non_blocking(device.device_index, sample_set);
+            }
+        }
+
+        void pipeline_async_impl::count_received_samples(const correlated_sample_set & sample_set)
+        {
+            for(int stream_index = 0; stream_index < static_cast<int>(stream_type::max); stream_index++)
+            {
+                if(sample_set.images[stream_index])
+                {
+                    m_received_samples_count[stream_index].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void pipeline_async_impl::stop_devices()
+        {
+            for(auto & device : m_secondary_devices)
+            {
+                device->manager->stop();
+            }
+            if(m_device_manager)
+            {
+                m_device_manager->stop();
+            }
+        }
+
+        video_module_interface::supported_module_config::samples_queue_policy pipeline_async_impl::query_consumer_queue_policy(
+                video_module_interface::supported_module_config::samples_queue_policy queue_policy) const
+        {
+            //a lockstep replay delivers each sample set, the streaming waits for the consumers instead of dropping
+            if(m_is_lockstep_replay && !is_pulled_queue_policy(queue_policy))
+            {
+                return video_module_interface::supported_module_config::samples_queue_policy::block;
+            }
+            return queue_policy;
+        }
+
+        void pipeline_async_impl::release_samples_consumers()
+        {
+            //the sync consumers wait for their running handlers on destruction, the executor keeps running
             {
                 std::lock_guard<std::mutex> samples_consumers_guard(m_samples_consumers_lock);
+                //a thread that waits for a pulled sample set holds its consumer until it's woken
+                for(auto & cv_module_consumer : m_cv_modules_consumers)
+                {
+                    cv_module_consumer.second->stop_pulling();
+                }
+                if(m_app_consumer)
+                {
+                    m_app_consumer->stop_pulling();
+                }
                 m_samples_consumers.clear();
+                m_cv_modules_consumers.clear();
+                m_app_consumer.reset();
+            }
+            for(auto & device : m_secondary_devices)
+            {
+                std::lock_guard<std::mutex> consumers_guard(device->consumers_lock);
+                device->consumers.clear();
             }
+        }
+
+        void pipeline_async_impl::ordered_resources_reset()
+        {
+            //the order of destruction is critical,
+            //the consumers must release all resources allocated by the device inorder to stop and release the device.
+            release_samples_consumers();
+            m_executor.reset();
 
             // cv modules reset
             for (auto cv_module : m_cv_modules)
@@ -415,10 +1098,7 @@ namespace rs
                 cv_module->flush_resources();
             }
 
-            if(m_device_manager)
-            {
-                m_device_manager->stop();
-            }
+            stop_devices();
         }
 
         const video_module_interface::supported_module_config pipeline_async_impl::get_hardcoded_superset_config() const
@@ -482,42 +1162,47 @@ namespace rs
                 return status::status_invalid_argument;
             }
 
-            //pull the modules configurations
-            vector<vector<video_module_interface::supported_module_config>> groups;
-            for (auto cv_module : m_cv_modules)
-            {
-                vector<video_module_interface::supported_module_config> configs;
-                for(uint32_t config_index = 0;; config_index++)
-                {
-                    video_module_interface::supported_module_config module_config = {};
-                    if(cv_module->query_supported_module_config(config_index, module_config) < status_no_error)
-                    {
-                        break;
-                    }
-                    configs.push_back(module_config);
-                }
-
-                groups.push_back(configs);
-            }
-
-            //add the user's config as a configuration restriction
-            groups.push_back({config});
-
-            //generate flatten supersets from the grouped configurations
             vector<video_module_interface::supported_module_config> supersets;
-            config_util::generete_matching_supersets(groups, supersets);
+            get_matching_supersets(config, supersets);
 
             //try to set each superset on the device and the modules
             for(auto & superset : supersets)
             {
+                m_secondary_devices.clear();
                 m_device_manager.reset();
+                auto devices = get_devices_from_config(superset);
+                if(devices.size() < std::max(superset.device_count, 1u))
+                {
+                    LOG_INFO("skipping config that requests " << superset.device_count << " devices, found " << devices.size());
+                    continue;
+                }
+
+                //negotiate with the cached capabilities first, the device managers configure the devices of a negotiable superset only
+                if(!is_superset_negotiable(superset, devices))
+                {
+                    continue;
+                }
 
                 std::unique_ptr<rs::core::device_manager> device_manager;
+                std::vector<std::unique_ptr<secondary_device>> secondary_devices;
                 try
                 {
-                    device_manager.reset(new rs::core::device_manager(get_device_from_config(superset),
+                    device_manager.reset(new rs::core::device_manager(devices[0],
                                                                       superset,
                                                                       [this](std::shared_ptr<correlated_sample_set> sample_set) { non_blocking_sample_callback(sample_set); }));
+                    for(uint32_t device_index = 1; device_index < devices.size(); device_index++)
+                    {
+                        std::unique_ptr<secondary_device> device(new secondary_device());
+                        device->device_index = device_index;
+                        auto device_ptr = device.get();
+                        device->manager.reset(new rs::core::device_manager(devices[device_index],
+                                                                           superset,
+                                                                           [this, device_ptr](std::shared_ptr<correlated_sample_set> sample_set)
+                                                                           {
+                                                                               non_blocking_secondary_sample_callback(*device_ptr, sample_set);
+                                                                           }));
+                        secondary_devices.push_back(std::move(device));
+                    }
                 }
                 catch(const std::runtime_error & ex)
                 {
@@ -530,30 +1215,8 @@ namespace rs
                     continue;
                 }
 
-                std::map<video_module_interface *, std::tuple<video_module_interface::actual_module_config,
-                                                              bool,
-                                                              video_module_interface::supported_module_config::time_sync_mode>> modules_configs;
-                bool found_satisfying_config_to_each_module = true;
-                //get satisfying modules configurations
-                for (auto cv_module : m_cv_modules)
-                {
-                    video_module_interface::supported_module_config satisfying_config = {};
-                    if(is_there_a_satisfying_module_config(cv_module, superset, satisfying_config))
-                    {
-                        auto actual_module_config = device_manager->create_actual_config_from_supported_config(satisfying_config);
-
-                        //save the module configuration
-                        modules_configs[cv_module] = std::make_tuple(actual_module_config, satisfying_config.async_processing, satisfying_config.samples_time_sync_mode);
-                    }
-                    else
-                    {
-                        LOG_ERROR("no available configuration for module id : " << cv_module->query_module_uid());
-                        found_satisfying_config_to_each_module = false;
-                        break;
-                    }
-                }
-
-                if(!found_satisfying_config_to_each_module)
+                modules_configs_map modules_configs;
+                if(!get_modules_configs(superset, *device_manager, modules_configs))
                 {
                     continue; //check next config
                 }
@@ -587,13 +1250,175 @@ namespace rs
                 //commit updated config
                 m_modules_configs.swap(modules_configs);
                 m_device_manager = std::move(device_manager);
+                m_secondary_devices = std::move(secondary_devices);
                 m_user_requested_time_sync_mode = config.samples_time_sync_mode;
+                m_user_requested_time_sync_deadline = config.time_sync_deadline;
+                m_user_requested_queue_policy = config.queue_policy;
+                m_user_requested_queue_depth = config.queue_depth;
+                m_user_requested_max_rate = config.max_rate;
                 return status_no_error;
             }
 
             return status_match_not_found;
         }
 
+        status pipeline_async_impl::set_config_while_streaming_unsafe(const video_module_interface::supported_module_config & config)
+        {
+            if(config_util::is_config_empty(config) && m_cv_modules.empty())
+            {
+                return status::status_invalid_argument;
+            }
+
+            vector<video_module_interface::supported_module_config> supersets;
+            get_matching_supersets(config, supersets);
+
+            //only the supersets the streaming devices serve with their current modes are applied, the devices keep streaming
+            bool are_samples_consumers_released = false;
+            for(auto & superset : supersets)
+            {
+                if(std::max(superset.device_count, 1u) != m_secondary_devices.size() + 1 ||
+                   !m_device_manager->is_config_satisfied_by_current_modes(superset) ||
+                   std::any_of(m_secondary_devices.begin(), m_secondary_devices.end(),
+                               [&superset](const std::unique_ptr<secondary_device> & device) { return !device->manager->is_config_satisfied_by_current_modes(superset); }))
+                {
+                    continue;
+                }
+
+                modules_configs_map modules_configs;
+                if(!get_modules_configs(superset, *m_device_manager, modules_configs))
+                {
+                    continue;
+                }
+
+                //the modules are reconfigured while no sample set is processed
+                if(!are_samples_consumers_released)
+                {
+                    release_samples_consumers();
+                    are_samples_consumers_released = true;
+                }
+
+                //reconfigure only the modules which configuration changed, on failure restore the reconfigured modules
+                std::vector<video_module_interface *> reconfigured_modules;
+                status module_config_status = status_no_error;
+                for(auto cv_module : m_cv_modules)
+                {
+                    auto & actual_module_config = std::get<0>(modules_configs[cv_module]);
+                    if(config_util::are_configs_equal(actual_module_config, std::get<0>(m_modules_configs[cv_module])))
+                    {
+                        continue;
+                    }
+                    cv_module->flush_resources();
+                    reconfigured_modules.push_back(cv_module);
+                    module_config_status = cv_module->set_module_config(actual_module_config);
+                    if(module_config_status < status_no_error)
+                    {
+                        LOG_ERROR("failed to set configuration on module id : " << cv_module->query_module_uid());
+                        break;
+                    }
+                }
+
+                if(module_config_status < status_no_error)
+                {
+                    for(auto cv_module : reconfigured_modules)
+                    {
+                        if(cv_module->set_module_config(std::get<0>(m_modules_configs[cv_module])) < status_no_error)
+                        {
+                            LOG_ERROR("failed to restore configuration on module id : " << cv_module->query_module_uid());
+                        }
+                    }
+                    continue; //check next config
+                }
+
+                m_modules_configs.swap(modules_configs);
+                m_user_requested_time_sync_mode = config.samples_time_sync_mode;
+                m_user_requested_time_sync_deadline = config.time_sync_deadline;
+                m_user_requested_queue_policy = config.queue_policy;
+                m_user_requested_queue_depth = config.queue_depth;
+                m_user_requested_max_rate = config.max_rate;
+                create_samples_consumers();
+                return status_no_error;
+            }
+
+            if(are_samples_consumers_released)
+            {
+                create_samples_consumers();
+            }
+
+            //the configuration requires reconfiguring the device streams
+            return status_invalid_state;
+        }
+
+        bool pipeline_async_impl::get_modules_configs(const video_module_interface::supported_module_config & superset,
+                                                      const rs::core::device_manager & device_manager,
+                                                      modules_configs_map & modules_configs) const
+        {
+            //get satisfying modules configurations
+            for (auto cv_module : m_cv_modules)
+            {
+                video_module_interface::supported_module_config satisfying_config = {};
+                if(is_there_a_satisfying_module_config(cv_module, superset, satisfying_config))
+                {
+                    //the samples of the other devices are notified to sync upstream modules only
+                    if(satisfying_config.device_count > 1 && (satisfying_config.async_processing || is_cv_module_downstream(cv_module)))
+                    {
+                        LOG_ERROR("multi-device configuration is not supported for module id : " << cv_module->query_module_uid());
+                        return false;
+                    }
+
+                    auto actual_module_config = device_manager.create_actual_config_from_supported_config(satisfying_config);
+
+                    //save the module configuration
+                    modules_configs[cv_module] = std::make_tuple(actual_module_config,
+                                                                 satisfying_config.async_processing,
+                                                                 satisfying_config.samples_time_sync_mode,
+                                                                 satisfying_config.time_sync_deadline,
+                                                                 satisfying_config.queue_policy,
+                                                                 satisfying_config.queue_depth,
+                                                                 satisfying_config.priority_class,
+                                                                 satisfying_config.max_rate,
+                                                                 satisfying_config.max_batch_size,
+                                                                 satisfying_config.max_batch_delay);
+                }
+                else
+                {
+                    LOG_ERROR("no available configuration for module id : " << cv_module->query_module_uid());
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void pipeline_async_impl::get_matching_supersets(const video_module_interface::supported_module_config & config,
+                                                         std::vector<video_module_interface::supported_module_config> & supersets) const
+        {
+            //the supersets depend on the modules configurations, which are cached until the modules change
+            auto cached_supersets = std::find_if(m_matching_supersets.begin(), m_matching_supersets.end(),
+                                                 [&config](const std::pair<video_module_interface::supported_module_config,
+                                                                           std::vector<video_module_interface::supported_module_config>> & entry)
+                                                 {
+                                                     return config_util::are_configs_equal(entry.first, config);
+                                                 });
+            if(cached_supersets != m_matching_supersets.end())
+            {
+                supersets = cached_supersets->second;
+                return;
+            }
+
+            //pull the modules configurations
+            vector<vector<video_module_interface::supported_module_config>> groups;
+            for (auto cv_module : m_cv_modules)
+            {
+                groups.push_back(get_module_supported_configs(cv_module));
+            }
+
+            //add the user's config as a configuration restriction
+            groups.push_back({config});
+
+            //generate flatten supersets from the grouped configurations
+            config_util::generete_matching_supersets(groups, supersets);
+            m_matching_supersets.push_back(std::make_pair(config, supersets));
+        }
+
         pipeline_async_impl::~pipeline_async_impl()
         {
             ordered_resources_reset();
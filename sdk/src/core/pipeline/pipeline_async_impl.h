@@ -6,10 +6,17 @@
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <atomic>
 #include <librealsense/rs.hpp>
 #include "rs/core/pipeline_async_interface.h"
 #include "samples_consumer_base.h"
+#include "multi_device_samples_consumer.h"
+#include "batched_samples_consumer.h"
 #include "device_manager.h"
+#include "device_capabilities.h"
+#include "work_stealing_executor.h"
+#include "degradation_controller.h"
+#include "module_outputs_cache.h"
 
 #ifdef WIN32 
 #ifdef realsense_pipeline_EXPORTS
@@ -34,6 +41,7 @@ namespace rs
             pipeline_async_impl();
             pipeline_async_impl(const pipeline_async::testing_mode mode, const char * file_path);
             virtual status add_cv_module(video_module_interface * cv_module) override;
+            virtual status connect_cv_modules(video_module_interface * upstream_module, video_module_interface * downstream_module) override;
             virtual status query_cv_module(uint32_t index, video_module_interface ** cv_module) const override;
             virtual status query_default_config(uint32_t index, video_module_interface::supported_module_config & default_config) const override;
             virtual status set_config(const video_module_interface::supported_module_config & config) override;
@@ -42,6 +50,14 @@ namespace rs
             virtual status start(callback_handler * app_callbacks_handler) override;
             virtual status stop() override;
             virtual rs::device * get_device() override;
+            virtual status query_dropped_sample_sets_count(video_module_interface * cv_module, uint64_t & dropped_count) const override;
+            virtual status pull_sample_set(video_module_interface * cv_module, correlated_sample_set & sample_set) override;
+            virtual status next_sample_set(video_module_interface * cv_module, correlated_sample_set & sample_set, uint32_t timeout_ms) override;
+            virtual status set_trace_handler(pipeline_trace_handler * trace_handler) override;
+            virtual status set_degradation_plan(const pipeline_degradation_plan & plan) override;
+            virtual status set_module_outputs_cache(const char * directory_path) override;
+            virtual status query_statistics(pipeline_statistics & statistics) const override;
+            virtual status query_module_statistics(video_module_interface * cv_module, pipeline_module_statistics & statistics) const override;
 
             virtual ~pipeline_async_impl();
         private:
@@ -51,26 +67,87 @@ namespace rs
                 configured,
                 streaming
             };
+            //a device of a multi-device configuration other than the first, its samples are notified to the multi-device consumers only
+            struct secondary_device
+            {
+                uint32_t device_index;
+                std::unique_ptr<device_manager> manager;
+                std::mutex consumers_lock;
+                std::vector<std::shared_ptr<multi_device_samples_consumer>> consumers; //guarded by consumers_lock
+            };
+            //the actual config, async processing, time sync mode, time sync deadline, queue policy, queue depth, priority class and max rate of each module
+            typedef std::map<video_module_interface *, std::tuple<video_module_interface::actual_module_config,
+                                                                  bool,
+                                                                  video_module_interface::supported_module_config::time_sync_mode,
+                                                                  uint32_t,
+                                                                  video_module_interface::supported_module_config::samples_queue_policy,
+                                                                  uint32_t,
+                                                                  video_module_interface::supported_module_config::module_priority,
+                                                                  uint32_t,
+                                                                  uint32_t,
+                                                                  uint32_t>> modules_configs_map;
             state m_current_state;
             mutable std::mutex m_state_lock;
-            std::mutex m_samples_consumers_lock;
+            mutable std::mutex m_samples_consumers_lock;
+            std::unique_ptr<context_interface> m_source_context; //the recorded context of the synthetic testing mode, outlives m_context
             std::unique_ptr<context_interface> m_context;
             std::vector<video_module_interface *> m_cv_modules;
-            std::map<video_module_interface *, std::tuple<video_module_interface::actual_module_config,
-                                                          bool,
-                                                          video_module_interface::supported_module_config::time_sync_mode>> m_modules_configs;
+            std::vector<std::pair<video_module_interface *, video_module_interface *>> m_cv_modules_connections; //pairs of upstream and downstream modules
+            modules_configs_map m_modules_configs;
             video_module_interface::supported_module_config::time_sync_mode m_user_requested_time_sync_mode;
+            uint32_t m_user_requested_time_sync_deadline;
+            video_module_interface::supported_module_config::samples_queue_policy m_user_requested_queue_policy;
+            uint32_t m_user_requested_queue_depth;
+            uint32_t m_user_requested_max_rate;
+            pipeline_trace_handler * m_trace_handler;
+            pipeline_degradation_plan m_degradation_plan;
+            std::shared_ptr<degradation_controller> m_degradation; //the controller of the streaming, null if the plan has no steps
+            callback_handler * m_app_callbacks_handler;
+            bool m_is_lockstep_replay;
+            std::string m_playback_file_path; //empty unless the pipeline streams a playback file
+            std::string m_module_outputs_cache_path; //empty unless the modules outputs are memoized
+            pipeline_tracer m_device_tracer; //guarded by m_samples_consumers_lock
+            std::unique_ptr<work_stealing_executor> m_executor; //declared before the consumers, which run on it
             std::vector<std::shared_ptr<samples_consumer_base>> m_samples_consumers;
+            std::map<video_module_interface *, std::shared_ptr<samples_consumer_base>> m_cv_modules_consumers; //guarded by m_samples_consumers_lock
+            std::shared_ptr<samples_consumer_base> m_app_consumer; //guarded by m_samples_consumers_lock
+            std::atomic<uint64_t> m_received_samples_count[static_cast<int>(stream_type::max)];
             std::unique_ptr<device_manager> m_device_manager;
+            //the configuration negotiation caches, guarded by m_state_lock
+            mutable std::map<rs::device *, std::unique_ptr<device_capabilities>> m_devices_capabilities;
+            mutable std::map<video_module_interface *, std::vector<video_module_interface::supported_module_config>> m_modules_supported_configs;
+            mutable std::vector<std::pair<video_module_interface::supported_module_config,
+                                          std::vector<video_module_interface::supported_module_config>>> m_matching_supersets; //the supersets of each requested config
+            std::vector<std::unique_ptr<secondary_device>> m_secondary_devices;
 
             void non_blocking_sample_callback(std::shared_ptr<correlated_sample_set> sample_set);
+            void non_blocking_secondary_sample_callback(secondary_device & device, std::shared_ptr<correlated_sample_set> sample_set);
+            void count_received_samples(const correlated_sample_set & sample_set);
+            void create_samples_consumers();
+            void release_samples_consumers();
+            video_module_interface::supported_module_config::samples_queue_policy query_consumer_queue_policy(
+                    video_module_interface::supported_module_config::samples_queue_policy queue_policy) const;
+            status query_pulled_consumer(video_module_interface * cv_module, std::shared_ptr<samples_consumer_base> & consumer) const;
+            static void copy_pulled_sample_set(const correlated_sample_set & pulled_sample_set, correlated_sample_set & sample_set);
             void ordered_resources_reset();
-            rs::device * get_device_from_config(const video_module_interface::supported_module_config & config) const;
+            void stop_devices();
+            bool is_cv_module_downstream(video_module_interface * cv_module) const;
+            bool is_cv_module_reachable(video_module_interface * from_module, video_module_interface * to_module) const;
+            std::vector<rs::device *> get_devices_from_config(const video_module_interface::supported_module_config & config) const;
+            const device_capabilities & get_device_capabilities(rs::device * device) const;
+            const std::vector<video_module_interface::supported_module_config> & get_module_supported_configs(video_module_interface * cv_module) const;
+            bool is_superset_negotiable(const video_module_interface::supported_module_config & superset, const std::vector<rs::device *> & devices) const;
             bool is_there_a_satisfying_module_config(video_module_interface * cv_module,
                                                      const video_module_interface::supported_module_config & given_config,
                                                      video_module_interface::supported_module_config &satisfying_config) const;
             const video_module_interface::supported_module_config get_hardcoded_superset_config() const;
             status set_config_unsafe(const video_module_interface::supported_module_config & config);
+            status set_config_while_streaming_unsafe(const video_module_interface::supported_module_config & config);
+            void get_matching_supersets(const video_module_interface::supported_module_config & config,
+                                        std::vector<video_module_interface::supported_module_config> & supersets) const;
+            bool get_modules_configs(const video_module_interface::supported_module_config & superset,
+                                     const rs::core::device_manager & device_manager,
+                                     modules_configs_map & modules_configs) const;
         };
     }
 }
@@ -0,0 +1,129 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <fstream>
+#include <map>
+#include "rs/core/pipeline_trace.h"
+#include "rs/utils/log_utils.h"
+
+using namespace rs::utils;
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            const char * stage_name(pipeline_trace_stage stage)
+            {
+                switch(stage)
+                {
+                    case pipeline_trace_stage::device_callback: return "device_callback";
+                    case pipeline_trace_stage::time_synced: return "time_synced";
+                    case pipeline_trace_stage::queued: return "queued";
+                    case pipeline_trace_stage::process_begin:
+                    case pipeline_trace_stage::process_end: return "process";
+                    case pipeline_trace_stage::callback_begin:
+                    case pipeline_trace_stage::callback_end: return "callback";
+                }
+                return "unknown";
+            }
+
+            const char * stream_name(stream_type stream)
+            {
+                switch(stream)
+                {
+                    case stream_type::depth: return "depth";
+                    case stream_type::color: return "color";
+                    case stream_type::infrared: return "infrared";
+                    case stream_type::infrared2: return "infrared2";
+                    case stream_type::fisheye: return "fisheye";
+                    case stream_type::rectified_color: return "rectified_color";
+                    case stream_type::depth_aligned_to_color: return "depth_aligned_to_color";
+                    case stream_type::color_aligned_to_depth: return "color_aligned_to_depth";
+                    default: return "unknown";
+                }
+            }
+
+            //the process and callback hops are slices on their thread, the other hops are thread scoped instant events
+            const char * event_phase(pipeline_trace_stage stage)
+            {
+                switch(stage)
+                {
+                    case pipeline_trace_stage::process_begin:
+                    case pipeline_trace_stage::callback_begin: return "B";
+                    case pipeline_trace_stage::process_end:
+                    case pipeline_trace_stage::callback_end: return "E";
+                    default: return "i";
+                }
+            }
+        }
+
+        chrome_trace_writer::chrome_trace_writer(const char * file_path) : m_file_path(file_path ? file_path : "") {}
+
+        void chrome_trace_writer::on_trace_event(const pipeline_trace_event & event)
+        {
+            std::lock_guard<std::mutex> lock(m_events_lock);
+            m_events.push_back(event);
+        }
+
+        size_t chrome_trace_writer::query_events_count() const
+        {
+            std::lock_guard<std::mutex> lock(m_events_lock);
+            return m_events.size();
+        }
+
+        status chrome_trace_writer::flush()
+        {
+            std::vector<pipeline_trace_event> events;
+            {
+                std::lock_guard<std::mutex> lock(m_events_lock);
+                events = m_events;
+            }
+
+            std::ofstream trace_file(m_file_path.c_str(), std::ios::out | std::ios::trunc);
+            if(!trace_file.is_open())
+            {
+                LOG_ERROR("failed to open trace file " << m_file_path.c_str());
+                return status_file_open_failed;
+            }
+
+            //the thread id hashes are replaced by small numbers, in the order of the threads first event
+            std::map<uint64_t, size_t> thread_numbers;
+            trace_file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+            trace_file.setf(std::ios::fixed);
+            trace_file.precision(3);
+            for(size_t index = 0; index < events.size(); index++)
+            {
+                const auto & event = events[index];
+                auto thread_number = thread_numbers.insert(std::make_pair(event.thread_id, thread_numbers.size() + 1)).first->second;
+                trace_file << (index > 0 ? ",\n" : "\n")
+                           << "{\"name\":\"" << stage_name(event.stage) << "\",\"cat\":\"" << (event.module_uid != 0 ? "module" : "pipeline")
+                           << "\",\"ph\":\"" << event_phase(event.stage) << "\",\"ts\":" << static_cast<double>(event.time_ns) / 1000.
+                           << ",\"pid\":1,\"tid\":" << thread_number;
+                if(event_phase(event.stage)[0] == 'i')
+                {
+                    trace_file << ",\"s\":\"t\"";
+                }
+                trace_file << ",\"args\":{\"stream\":\"" << stream_name(event.stream) << "\",\"frame_number\":" << event.frame_number
+                           << ",\"module_uid\":" << event.module_uid << "}}";
+            }
+            trace_file << "\n]}\n";
+            trace_file.close();
+            if(trace_file.fail())
+            {
+                LOG_ERROR("failed to write trace file " << m_file_path.c_str());
+                return status_file_write_failed;
+            }
+            return status_no_error;
+        }
+
+        chrome_trace_writer::~chrome_trace_writer()
+        {
+            if(!m_file_path.empty())
+            {
+                flush();
+            }
+        }
+    }
+}
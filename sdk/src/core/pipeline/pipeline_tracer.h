@@ -0,0 +1,56 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <chrono>
+#include <functional>
+#include <thread>
+#include "rs/core/pipeline_trace.h"
+#include "rs/core/correlated_sample_set.h"
+#include "rs/utils/timebase.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief Stamps the samples of a sample set at a pipeline hop, a disabled tracer costs a single branch.
+         */
+        class pipeline_tracer
+        {
+        public:
+            pipeline_tracer() : m_handler(nullptr), m_module_uid(0) {}
+            pipeline_tracer(pipeline_trace_handler * handler, int32_t module_uid) : m_handler(handler), m_module_uid(module_uid) {}
+
+            bool is_enabled() const { return m_handler != nullptr; }
+
+            void trace(pipeline_trace_stage stage, const correlated_sample_set & sample_set) const
+            {
+                if(!m_handler)
+                {
+                    return;
+                }
+
+                pipeline_trace_event event = {};
+                event.stage = stage;
+                event.module_uid = m_module_uid;
+                event.time_ns = static_cast<uint64_t>(rs::utils::timebase::now().time_since_epoch().count());
+                event.thread_id = static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+                for(int stream_index = 0; stream_index < static_cast<int>(stream_type::max); stream_index++)
+                {
+                    auto image = sample_set.images[stream_index];
+                    if(!image)
+                    {
+                        continue;
+                    }
+                    event.stream = static_cast<stream_type>(stream_index);
+                    event.frame_number = image->query_frame_number();
+                    m_handler->on_trace_event(event);
+                }
+            }
+        private:
+            pipeline_trace_handler * m_handler;
+            int32_t m_module_uid;
+        };
+    }
+}
@@ -0,0 +1,179 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <mutex>
+#include <new>
+#include <vector>
+#include "sample_set_pool.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            //a pool sample set, with the storage of its motion batches
+            struct pooled_sample_set : correlated_sample_set
+            {
+                std::vector<motion_sample> motion_batches_storage[static_cast<uint8_t>(motion_type::max)];
+            };
+        }
+
+        struct sample_set_pool::storage
+        {
+            //the control block of a shared pointer with a deleter and an allocator fits the block size on the supported
+            //standard libraries, larger allocations fall back to the heap
+            static const size_t BLOCK_SIZE = 128;
+
+            std::mutex lock;
+            std::vector<pooled_sample_set *> free_sample_sets;
+            std::vector<void *> free_blocks;
+
+            ~storage()
+            {
+                for(auto sample_set : free_sample_sets)
+                {
+                    delete sample_set;
+                }
+                for(auto block : free_blocks)
+                {
+                    ::operator delete(block);
+                }
+            }
+
+            correlated_sample_set * acquire_sample_set()
+            {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    if(!free_sample_sets.empty())
+                    {
+                        auto sample_set = free_sample_sets.back();
+                        free_sample_sets.pop_back();
+                        return sample_set;
+                    }
+                }
+                return new pooled_sample_set();
+            }
+
+            void recycle_sample_set(correlated_sample_set * sample_set)
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                free_sample_sets.push_back(static_cast<pooled_sample_set *>(sample_set));
+            }
+
+            void * allocate_block(size_t size)
+            {
+                if(size > BLOCK_SIZE)
+                {
+                    return ::operator new(size);
+                }
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    if(!free_blocks.empty())
+                    {
+                        auto block = free_blocks.back();
+                        free_blocks.pop_back();
+                        return block;
+                    }
+                }
+                return ::operator new(BLOCK_SIZE);
+            }
+
+            void deallocate_block(void * block, size_t size)
+            {
+                if(size > BLOCK_SIZE)
+                {
+                    ::operator delete(block);
+                    return;
+                }
+                std::lock_guard<std::mutex> guard(lock);
+                free_blocks.push_back(block);
+            }
+        };
+
+        namespace
+        {
+            //releases the sample set images and returns the sample set to the pool
+            struct pool_sample_set_releaser
+            {
+                std::shared_ptr<sample_set_pool::storage> pool_storage;
+
+                void operator()(correlated_sample_set * sample_set) const
+                {
+                    for(int i = 0; i < static_cast<uint8_t>(stream_type::max); i++)
+                    {
+                        if(sample_set->images[i])
+                        {
+                            sample_set->images[i]->release();
+                        }
+                    }
+                    *sample_set = correlated_sample_set();
+                    pool_storage->recycle_sample_set(sample_set);
+                }
+            };
+
+            //allocates the shared pointer control blocks from the pool
+            template<typename T>
+            struct pool_block_allocator
+            {
+                typedef T value_type;
+                std::shared_ptr<sample_set_pool::storage> pool_storage;
+
+                pool_block_allocator(const std::shared_ptr<sample_set_pool::storage> & storage) : pool_storage(storage) {}
+                template<typename U> pool_block_allocator(const pool_block_allocator<U> & other) : pool_storage(other.pool_storage) {}
+
+                T * allocate(size_t count) { return static_cast<T *>(pool_storage->allocate_block(count * sizeof(T))); }
+                void deallocate(T * block, size_t count) { pool_storage->deallocate_block(block, count * sizeof(T)); }
+
+                template<typename U> bool operator==(const pool_block_allocator<U> & other) const { return pool_storage == other.pool_storage; }
+                template<typename U> bool operator!=(const pool_block_allocator<U> & other) const { return pool_storage != other.pool_storage; }
+            };
+        }
+
+        sample_set_pool::sample_set_pool(size_t preallocated_sample_sets_count) : m_storage(std::make_shared<storage>())
+        {
+            m_storage->free_sample_sets.reserve(preallocated_sample_sets_count);
+            m_storage->free_blocks.reserve(preallocated_sample_sets_count);
+            for(size_t i = 0; i < preallocated_sample_sets_count; i++)
+            {
+                m_storage->free_sample_sets.push_back(new pooled_sample_set());
+                m_storage->free_blocks.push_back(::operator new(storage::BLOCK_SIZE));
+            }
+        }
+
+        std::shared_ptr<correlated_sample_set> sample_set_pool::acquire()
+        {
+            return std::shared_ptr<correlated_sample_set>(m_storage->acquire_sample_set(),
+                                                          pool_sample_set_releaser{ m_storage },
+                                                          pool_block_allocator<correlated_sample_set>(m_storage));
+        }
+
+        size_t sample_set_pool::query_free_sample_sets_count() const
+        {
+            std::lock_guard<std::mutex> guard(m_storage->lock);
+            return m_storage->free_sample_sets.size();
+        }
+
+        void sample_set_pool::own_motion_batches(correlated_sample_set & sample_set)
+        {
+            auto & pooled = static_cast<pooled_sample_set &>(sample_set);
+            for(int i = 0; i < static_cast<uint8_t>(motion_type::max); i++)
+            {
+                auto & batch_storage = pooled.motion_batches_storage[i];
+                if(pooled.motion_batches[i] == batch_storage.data() && !batch_storage.empty())
+                {
+                    continue; //already owned
+                }
+                batch_storage.assign(pooled.motion_batches[i], pooled.motion_batches[i] + pooled.motion_batch_sizes[i]);
+                pooled.motion_batches[i] = batch_storage.empty() ? nullptr : batch_storage.data();
+            }
+        }
+
+        sample_set_pool & sample_set_pool::shared_pool()
+        {
+            //enough for the queues of a few consumers at 60 fps of several streams
+            static sample_set_pool pool(64);
+            return pool;
+        }
+    }
+}
@@ -0,0 +1,56 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <memory>
+#include "rs/core/correlated_sample_set.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief Recycles the sample sets the pipeline passes between the device, the time sync and the consumers.
+         *
+         * A sample set and the shared pointer control block which owns it are taken from free lists, and returned to them
+         * when the last reference is released, after the sample set images are released. Once the pool warmed up to the
+         * number of sample sets in flight, acquiring a sample set doesn't allocate. The released sample sets keep the
+         * pool storage alive, so they may outlive the pool.
+         */
+        class sample_set_pool
+        {
+        public:
+            /**
+             * @brief Constructor.
+             * @param[in] preallocated_sample_sets_count  Number of sample sets allocated upfront, the pool grows beyond it on demand
+             */
+            explicit sample_set_pool(size_t preallocated_sample_sets_count);
+
+            /**
+             * @brief Returns an empty sample set, which owns a reference of each image set to it.
+             */
+            std::shared_ptr<correlated_sample_set> acquire();
+
+            /**
+             * @brief Returns the number of sample sets ready to be acquired without an allocation.
+             */
+            size_t query_free_sample_sets_count() const;
+
+            /**
+             * @brief Copies the motion batches the sample set refers to into the sample set storage, so they are valid as long as the
+             * sample set is held. The storage keeps its capacity when the sample set is recycled.
+             * @param[in,out] sample_set  A sample set acquired from a pool
+             */
+            static void own_motion_batches(correlated_sample_set & sample_set);
+
+            /**
+             * @brief The pool of the pipeline sample sets.
+             */
+            static sample_set_pool & shared_pool();
+
+            struct storage;
+        private:
+            std::shared_ptr<storage> m_storage;
+        };
+    }
+}
@@ -1,19 +1,89 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <cstring>
+#include <algorithm>
 #include "samples_consumer_base.h"
-#include "sample_set_releaser.h"
+#include "rs/core/projection_interface.h"
+#include "sample_set_pool.h"
+#include "config_util.h"
 using namespace rs::utils;
 
 namespace rs
 {
     namespace core
     {
+        namespace
+        {
+            //the consumer outputs rate is at most the rate of its fastest stream
+            uint32_t query_highest_frame_rate(const video_module_interface::actual_module_config & module_config)
+            {
+                float highest_frame_rate = 0;
+                for(auto stream_index = 0; stream_index < static_cast<int32_t>(stream_type::max); stream_index++)
+                {
+                    if(module_config.image_streams_configs[stream_index].is_enabled)
+                    {
+                        highest_frame_rate = std::max(highest_frame_rate, module_config.image_streams_configs[stream_index].frame_rate);
+                    }
+                }
+                return static_cast<uint32_t>(highest_frame_rate);
+            }
+        }
+
         samples_consumer_base::samples_consumer_base(const video_module_interface::actual_module_config &module_config,
-                                                     const video_module_interface::supported_module_config::time_sync_mode time_sync_mode) :
-            m_module_config(module_config)
+                                                     const video_module_interface::supported_module_config::time_sync_mode time_sync_mode,
+                                                     uint32_t time_sync_deadline) :
+            m_statistics(query_highest_frame_rate(module_config)),
+            m_module_config(module_config),
+            m_time_sync_mode(time_sync_mode),
+            m_time_sync_deadline(time_sync_deadline),
+            m_max_rate(0)
         {
             m_time_sync_util = get_time_sync_util_from_module_config(m_module_config, time_sync_mode);
+            std::fill(std::begin(m_next_sample_time_stamps), std::end(m_next_sample_time_stamps), 0.);
+        }
+
+        void samples_consumer_base::set_max_rate(uint32_t max_rate)
+        {
+            m_max_rate = max_rate;
+        }
+
+        bool samples_consumer_base::is_sample_set_decimated(const correlated_sample_set & sample_set)
+        {
+            if(m_max_rate == 0)
+            {
+                return false;
+            }
+
+            //a relevant sample set holds a single sample, the motion samples aren't decimated
+            for(auto stream_index = 0; stream_index < static_cast<int32_t>(stream_type::max); stream_index++)
+            {
+                const image_interface * image = sample_set.images[stream_index];
+                if(!image)
+                {
+                    continue;
+                }
+                const float frame_rate = m_module_config.image_streams_configs[stream_index].frame_rate;
+                if(frame_rate <= static_cast<float>(m_max_rate))
+                {
+                    return false;
+                }
+
+                //the samples of a stream are passed a period apart, within half of the stream frame interval
+                const double period_ms = 1000. / m_max_rate;
+                const double tolerance_ms = frame_rate > 0 ? 500. / frame_rate : 0.;
+                const double time_stamp = image->query_time_stamp();
+                double & next_time_stamp = m_next_sample_time_stamps[stream_index];
+                const bool is_restarted = time_stamp + tolerance_ms < next_time_stamp - period_ms; //the stream timestamps went back
+                if(!is_restarted && time_stamp + tolerance_ms < next_time_stamp)
+                {
+                    return true;
+                }
+                //a stream which skipped more than a period isn't caught up with a burst of samples
+                next_time_stamp = is_restarted || time_stamp - next_time_stamp >= period_ms ? time_stamp + period_ms : next_time_stamp + period_ms;
+                return false;
+            }
+            return false;
         }
 
         bool samples_consumer_base::is_sample_set_relevant(const std::shared_ptr<correlated_sample_set> & sample_set) const
@@ -77,18 +147,202 @@ namespace rs
                 return;
             }
 
+            //a decimated sample isn't referenced by the time sync
+            if(is_sample_set_decimated(*sample_set))
+            {
+                return;
+            }
+
             std::shared_ptr<correlated_sample_set> ready_sample_set = insert_to_time_sync_util(sample_set);
 
             auto unmatched_frames = get_unmatched_frames(); // empty on no time sync or time sync input only modes
             for(auto unmatched_frame : unmatched_frames)
             {
-                on_complete_sample_set(unmatched_frame);
+                m_statistics.on_unmatched_samples(*unmatched_frame);
+                for(auto & follower : m_sync_stage_followers)
+                {
+                    follower->m_statistics.on_unmatched_samples(*unmatched_frame);
+                }
+                deliver_complete_sample_set(unmatched_frame);
+            }
+
+            auto partial_sample_sets = get_partial_sample_sets(); // empty on modes without a deadline
+            for(auto partial_sample_set : partial_sample_sets)
+            {
+                register_aligned_streams(*partial_sample_set);
+                deliver_complete_sample_set(partial_sample_set);
             }
 
             if(ready_sample_set)
             {
-                on_complete_sample_set(ready_sample_set);
+                //without a time sync the ready sample set is the device sample set, which is shared by all the consumers
+                if(m_time_sync_util)
+                {
+                    register_aligned_streams(*ready_sample_set);
+                }
+                deliver_complete_sample_set(ready_sample_set);
+            }
+
+            //the sets matched for the samples which concurrent inserts queued, so the sets of the last samples aren't left in the time sync
+            auto matched_sample_sets = get_matched_sample_sets();
+            for(auto matched_sample_set : matched_sample_sets)
+            {
+                register_aligned_streams(*matched_sample_set);
+                deliver_complete_sample_set(matched_sample_set);
+            }
+        }
+
+        void samples_consumer_base::deliver_complete_sample_set(const std::shared_ptr<correlated_sample_set> & ready_sample_set)
+        {
+            m_tracer.trace(pipeline_trace_stage::time_synced, *ready_sample_set);
+            on_complete_sample_set(ready_sample_set);
+            for(auto & follower : m_sync_stage_followers)
+            {
+                follower->m_tracer.trace(pipeline_trace_stage::time_synced, *ready_sample_set);
+                follower->on_complete_sample_set(ready_sample_set);
+            }
+        }
+
+        void samples_consumer_base::register_aligned_streams(correlated_sample_set & sample_set) const
+        {
+            image_interface * depth = sample_set[stream_type::depth];
+            image_interface * color = sample_set[stream_type::color];
+            if(!m_module_config.projection || !depth || !color)
+            {
+                return;
+            }
+
+            //the registered images are attached to the depth image by the projection, so each is computed once for all the sync stages
+            for(auto stream : { stream_type::depth_aligned_to_color, stream_type::color_aligned_to_depth })
+            {
+                if(!m_module_config.image_streams_configs[static_cast<int32_t>(stream)].is_enabled || sample_set[stream])
+                {
+                    continue;
+                }
+                const image_interface * aligned_image = nullptr;
+                status registration_status = stream == stream_type::depth_aligned_to_color ?
+                    m_module_config.projection->query_shared_depth_image_mapped_to_color(depth, color, &aligned_image) :
+                    m_module_config.projection->query_shared_color_image_mapped_to_depth(depth, color, &aligned_image);
+                if(registration_status < status_no_error || !aligned_image)
+                {
+                    LOG_WARN("failed to register the aligned stream " << static_cast<int32_t>(stream) << ", status " << registration_status);
+                    continue;
+                }
+                //the sample set releases its images
+                aligned_image->add_ref();
+                sample_set[stream] = const_cast<image_interface *>(aligned_image);
+            }
+        }
+
+        status samples_consumer_base::pull_sample_set(std::shared_ptr<correlated_sample_set> & sample_set)
+        {
+            return status_feature_unsupported;
+        }
+
+        status samples_consumer_base::wait_sample_set(std::shared_ptr<correlated_sample_set> & sample_set, uint32_t timeout_ms)
+        {
+            return status_feature_unsupported;
+        }
+
+        void samples_consumer_base::stop_pulling()
+        {
+
+        }
+
+        const consumer_statistics & samples_consumer_base::query_statistics() const
+        {
+            return m_statistics;
+        }
+
+        void samples_consumer_base::query_module_statistics(pipeline_module_statistics & statistics) const
+        {
+            m_statistics.query_module_statistics(statistics);
+            statistics.dropped_sample_sets_count = query_dropped_sample_sets_count();
+        }
+
+        void samples_consumer_base::set_tracer(const pipeline_tracer & tracer)
+        {
+            m_tracer = tracer;
+        }
+
+        void samples_consumer_base::add_downstream_consumer(std::shared_ptr<samples_consumer_base> downstream_consumer)
+        {
+            m_downstream_consumers.push_back(std::move(downstream_consumer));
+        }
+
+        void samples_consumer_base::notify_upstream_sample_set(std::shared_ptr<correlated_sample_set> sample_set)
+        {
+            if(!sample_set)
+            {
+                return;
             }
+
+            //the upstream module input was already time synced, the upstream consumers handlers may complete concurrently
+            std::lock_guard<std::mutex> lock(m_upstream_lock);
+            deliver_complete_sample_set(sample_set);
+        }
+
+        void samples_consumer_base::notify_downstream_consumers(const std::shared_ptr<correlated_sample_set> & output_sample_set)
+        {
+            for(auto & downstream_consumer : m_downstream_consumers)
+            {
+                downstream_consumer->notify_upstream_sample_set(output_sample_set);
+            }
+        }
+
+        bool samples_consumer_base::has_downstream_consumers() const
+        {
+            return !m_downstream_consumers.empty();
+        }
+
+        uint64_t samples_consumer_base::query_dropped_sample_sets_count() const
+        {
+            return 0;
+        }
+
+        bool samples_consumer_base::is_sharing_sync_stage(const samples_consumer_base & other) const
+        {
+            if(m_time_sync_mode != other.m_time_sync_mode || m_max_rate != other.m_max_rate ||
+               (m_time_sync_mode == video_module_interface::supported_module_config::time_sync_mode::time_synced_input_with_deadline &&
+                m_time_sync_deadline != other.m_time_sync_deadline))
+            {
+                return false;
+            }
+
+            if(std::strcmp(m_module_config.device_info.name, other.m_module_config.device_info.name) != 0)
+            {
+                return false;
+            }
+
+            //the time sync utility is created by the enabled streams rates
+            for(auto stream_index = 0; stream_index < static_cast<int32_t>(stream_type::max); stream_index++)
+            {
+                auto & stream_config = m_module_config.image_streams_configs[stream_index];
+                auto & other_stream_config = other.m_module_config.image_streams_configs[stream_index];
+                if(stream_config.is_enabled != other_stream_config.is_enabled ||
+                   (stream_config.is_enabled && stream_config.frame_rate != other_stream_config.frame_rate))
+                {
+                    return false;
+                }
+            }
+            for(auto motion_index = 0; motion_index < static_cast<int32_t>(motion_type::max); motion_index++)
+            {
+                auto & motion_config = m_module_config.motion_sensors_configs[motion_index];
+                auto & other_motion_config = other.m_module_config.motion_sensors_configs[motion_index];
+                if(motion_config.is_enabled != other_motion_config.is_enabled ||
+                   (motion_config.is_enabled && motion_config.sample_rate != other_motion_config.sample_rate))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void samples_consumer_base::add_sync_stage_follower(std::shared_ptr<samples_consumer_base> follower)
+        {
+            //the follower is notified only by this consumer, its own time sync utility won't be used
+            follower->m_time_sync_util.reset();
+            m_sync_stage_followers.push_back(std::move(follower));
         }
 
         std::shared_ptr<correlated_sample_set> samples_consumer_base::insert_to_time_sync_util(const std::shared_ptr<correlated_sample_set> & input_sample_set)
@@ -105,8 +359,9 @@ namespace rs
                     correlated_sample_set ready_sample_set = {};
                     if(m_time_sync_util->insert(input_sample_set->images[stream_index], ready_sample_set))
                     {
-                        std::shared_ptr<correlated_sample_set> output_sample_set(new correlated_sample_set(), sample_set_releaser());
+                        std::shared_ptr<correlated_sample_set> output_sample_set = sample_set_pool::shared_pool().acquire();
                         *output_sample_set = ready_sample_set;
+                        sample_set_pool::own_motion_batches(*output_sample_set);
                         return output_sample_set;
                     }
                 }
@@ -118,8 +373,9 @@ namespace rs
                     correlated_sample_set ready_sample_set = {};
                     if(m_time_sync_util->insert(input_sample_set->motion_samples[motion_index], ready_sample_set))
                     {
-                        std::shared_ptr<correlated_sample_set> output_sample_set(new correlated_sample_set(), sample_set_releaser());
+                        std::shared_ptr<correlated_sample_set> output_sample_set = sample_set_pool::shared_pool().acquire();
                         *output_sample_set = ready_sample_set;
+                        sample_set_pool::own_motion_batches(*output_sample_set);
                         return output_sample_set;
                     }
                 }
@@ -143,12 +399,15 @@ namespace rs
                 case video_module_interface::supported_module_config::time_sync_mode::time_synced_input_accepting_unmatch_samples:
                     // update the default time sync configuration values to accept unmatched samples
                     not_matched_frames_buffer_size = 1;
+                case video_module_interface::supported_module_config::time_sync_mode::time_synced_input_with_deadline:
                 case video_module_interface::supported_module_config::time_sync_mode::time_synced_input_only:
                 {
                     int streams_fps[static_cast<int32_t>(stream_type::max)] = {};
                     for(auto stream_index = 0; stream_index < static_cast<int32_t>(stream_type::max); stream_index++)
                     {
-                        if(module_config.image_streams_configs[stream_index].is_enabled)
+                        //the aligned streams are registered after the time sync
+                        if(module_config.image_streams_configs[stream_index].is_enabled &&
+                           !config_util::is_aligned_stream(static_cast<stream_type>(stream_index)))
                         {
                             streams_fps[stream_index] = static_cast<int>(module_config.image_streams_configs[stream_index].frame_rate);
                         }
@@ -206,7 +465,7 @@ namespace rs
                     is_there_more_unmatched_samples_for_at_least_one_stream = is_there_more_unmatched_samples_for_at_least_one_stream || m_time_sync_util->get_not_matched_frame(stream, &image);
                     if (image)
                     {
-                        std::shared_ptr<correlated_sample_set> sample_set(new correlated_sample_set(), sample_set_releaser());
+                        std::shared_ptr<correlated_sample_set> sample_set = sample_set_pool::shared_pool().acquire();
                         (*sample_set)[stream] = image;
                         unmatched_samples.push_back(std::move(sample_set));
                     }
@@ -216,6 +475,49 @@ namespace rs
             return unmatched_samples;
         }
 
+        std::vector<std::shared_ptr<correlated_sample_set>> samples_consumer_base::get_partial_sample_sets()
+        {
+            std::vector<std::shared_ptr<correlated_sample_set>> partial_sample_sets;
+            if(!m_time_sync_util ||
+               m_time_sync_mode != video_module_interface::supported_module_config::time_sync_mode::time_synced_input_with_deadline)
+            {
+                return partial_sample_sets;
+            }
+
+            //the images older than the deadline won't wait for a stalled stream anymore
+            correlated_sample_set partial_sample_set = {};
+            while(m_time_sync_util->get_partial_sample_set(m_time_sync_deadline, partial_sample_set))
+            {
+                std::shared_ptr<correlated_sample_set> sample_set = sample_set_pool::shared_pool().acquire();
+                *sample_set = partial_sample_set;
+                partial_sample_sets.push_back(std::move(sample_set));
+                partial_sample_set = {};
+            }
+
+            return partial_sample_sets;
+        }
+
+        std::vector<std::shared_ptr<correlated_sample_set>> samples_consumer_base::get_matched_sample_sets()
+        {
+            std::vector<std::shared_ptr<correlated_sample_set>> matched_sample_sets;
+            if(!m_time_sync_util)
+            {
+                return matched_sample_sets;
+            }
+
+            correlated_sample_set matched_sample_set = {};
+            while(m_time_sync_util->get_matched_sample_set(matched_sample_set))
+            {
+                std::shared_ptr<correlated_sample_set> sample_set = sample_set_pool::shared_pool().acquire();
+                *sample_set = matched_sample_set;
+                sample_set_pool::own_motion_batches(*sample_set);
+                matched_sample_sets.push_back(std::move(sample_set));
+                matched_sample_set = {};
+            }
+
+            return matched_sample_sets;
+        }
+
         samples_consumer_base::~samples_consumer_base()
         {
 
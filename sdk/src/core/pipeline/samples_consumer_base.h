@@ -3,8 +3,11 @@
 
 #pragma once
 #include <memory>
+#include <mutex>
 #include <vector>
 #include "rs/utils/samples_time_sync_interface.h"
+#include "pipeline_tracer.h"
+#include "consumer_statistics.h"
 
 namespace rs
 {
@@ -14,18 +17,114 @@ namespace rs
         {
         public:
             samples_consumer_base(const video_module_interface::actual_module_config &module_config,
-                                  const video_module_interface::supported_module_config::time_sync_mode time_sync_mode);
+                                  const video_module_interface::supported_module_config::time_sync_mode time_sync_mode,
+                                  uint32_t time_sync_deadline);
             void notify_sample_set_non_blocking(std::shared_ptr<correlated_sample_set> sample_set);
+
+            /**
+             * @brief Checks if the other consumer requests the same streams with the same time sync mode, so both consumers
+             * would match the same sample sets.
+             */
+            bool is_sharing_sync_stage(const samples_consumer_base & other) const;
+
+            /**
+             * @brief Shares this consumer time sync with a consumer of the same sync stage. The follower gets each completed
+             * sample set of this consumer, the sample set is shared by reference and isn't matched again.
+             * @param[in] follower  The consumer, owned by this consumer from now on
+             */
+            void add_sync_stage_follower(std::shared_ptr<samples_consumer_base> follower);
+
+            /**
+             * @brief Connects a consumer of a downstream module, which gets the output sample sets of this consumer module.
+             * @param[in] downstream_consumer  The consumer of the downstream module, shared by the consumers of its upstream modules
+             */
+            void add_downstream_consumer(std::shared_ptr<samples_consumer_base> downstream_consumer);
+
+            /**
+             * @brief Notifies the consumer of an output sample set of its upstream module, the sample set is processed without time sync.
+             * The sample sets of concurrent upstream modules are delivered one at a time.
+             */
+            void notify_upstream_sample_set(std::shared_ptr<correlated_sample_set> sample_set);
+
+            /**
+             * @brief Sets the tracer of the consumer hops, must be set before the consumer is notified of sample sets.
+             */
+            void set_tracer(const pipeline_tracer & tracer);
+
+            /**
+             * @brief Sets the maximal rate of each image stream of the consumer, the samples above the rate are skipped before the time sync.
+             * Must be set before the consumer is notified of sample sets.
+             * @param[in] max_rate  The maximal rate in frames per second, 0 doesn't limit the rate
+             */
+            void set_max_rate(uint32_t max_rate);
+
+            /**
+             * @brief Returns the number of completed sample sets this consumer dropped by its queue policy.
+             */
+            virtual uint64_t query_dropped_sample_sets_count() const;
+
+            /**
+             * @brief Takes the newest completed sample set of a consumer which is pulled by its module thread.
+             * @param[out] sample_set  The newest sample set, unchanged if no sample set completed since the previous pull
+             * @return status_feature_unsupported if the consumer pushes its sample sets, status_data_not_changed if no sample set completed
+             */
+            virtual status pull_sample_set(std::shared_ptr<correlated_sample_set> & sample_set);
+
+            /**
+             * @brief Waits for the next completed sample set of a consumer which is pulled by its module thread.
+             * @param[out] sample_set  The next sample set, unchanged if no sample set completed before the timeout
+             * @param[in] timeout_ms   The maximal wait in milliseconds
+             * @return status_feature_unsupported if the consumer pushes its sample sets, status_exec_timeout if no sample set completed,
+             * status_invalid_state if the pulling was stopped while waiting
+             */
+            virtual status wait_sample_set(std::shared_ptr<correlated_sample_set> & sample_set, uint32_t timeout_ms);
+
+            /**
+             * @brief Wakes the thread which waits for a pulled sample set, once the pipeline stops streaming.
+             */
+            virtual void stop_pulling();
+
+            /**
+             * @brief Returns the runtime counters of the consumer, they are sampled without blocking the streaming.
+             */
+            const consumer_statistics & query_statistics() const;
+
+            /**
+             * @brief Fills the runtime counters of the consumer module.
+             */
+            void query_module_statistics(pipeline_module_statistics & statistics) const;
             virtual ~samples_consumer_base();
         protected:
             virtual void on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set) = 0;
-        private:            
+
+            //forwards the output sample set of the consumer module to the downstream modules consumers
+            void notify_downstream_consumers(const std::shared_ptr<correlated_sample_set> & output_sample_set);
+            bool has_downstream_consumers() const;
+
+            pipeline_tracer m_tracer;
+            consumer_statistics m_statistics;
+        private:
             const video_module_interface::actual_module_config m_module_config;
+            const video_module_interface::supported_module_config::time_sync_mode m_time_sync_mode;
+            const uint32_t m_time_sync_deadline;
             rs::utils::unique_ptr<rs::utils::samples_time_sync_interface> m_time_sync_util;
+            uint32_t m_max_rate;
+            double m_next_sample_time_stamps[static_cast<int32_t>(stream_type::max)]; //each entry is touched by its stream callback thread only
+            std::vector<std::shared_ptr<samples_consumer_base>> m_sync_stage_followers;
+            std::vector<std::shared_ptr<samples_consumer_base>> m_downstream_consumers;
+            std::mutex m_upstream_lock; //orders the deliveries of the upstream modules consumers
+
+            void deliver_complete_sample_set(const std::shared_ptr<correlated_sample_set> & ready_sample_set);
+
+            //sets the images of the aligned streams of the consumer, registered from the depth and color images of a time synced sample set
+            void register_aligned_streams(correlated_sample_set & sample_set) const;
 
             bool is_sample_set_relevant(const std::shared_ptr<correlated_sample_set> & sample_set) const;
+            bool is_sample_set_decimated(const correlated_sample_set & sample_set);
             std::shared_ptr<correlated_sample_set> insert_to_time_sync_util(const std::shared_ptr<correlated_sample_set> & input_sample_set);
             std::vector<std::shared_ptr<correlated_sample_set>> get_unmatched_frames();
+            std::vector<std::shared_ptr<correlated_sample_set>> get_partial_sample_sets();
+            std::vector<std::shared_ptr<correlated_sample_set>> get_matched_sample_sets();
             rs::utils::unique_ptr<rs::utils::samples_time_sync_interface> get_time_sync_util_from_module_config(const video_module_interface::actual_module_config &module_config,
                                                                                                                 const video_module_interface::supported_module_config::time_sync_mode time_sync_mode);
         };
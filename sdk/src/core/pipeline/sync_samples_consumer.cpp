@@ -11,63 +11,322 @@ namespace rs
 {
     namespace core
     {
-        sync_samples_consumer::sync_samples_consumer(std::function<void(std::shared_ptr<correlated_sample_set>)> sample_set_ready_handler,
+        sync_samples_consumer::sync_samples_consumer(std::function<status(std::shared_ptr<correlated_sample_set>)> sample_set_ready_handler,
                                                      const video_module_interface::actual_module_config &module_config,
-                                                     const video_module_interface::supported_module_config::time_sync_mode time_sync_mode):
-            samples_consumer_base(module_config, time_sync_mode),
+                                                     const video_module_interface::supported_module_config::time_sync_mode time_sync_mode,
+                                                     uint32_t time_sync_deadline,
+                                                     work_stealing_executor & executor,
+                                                     int affinity,
+                                                     work_stealing_executor::priority handler_priority,
+                                                     video_module_interface::supported_module_config::samples_queue_policy queue_policy,
+                                                     uint32_t queue_depth):
+            samples_consumer_base(module_config, time_sync_mode, time_sync_deadline),
+            m_executor(executor),
+            m_affinity(affinity),
+            m_handler_priority(handler_priority),
+            m_queue_policy(queue_policy),
+            m_queue_depth(queue_depth > 0 ? queue_depth : 1),
             m_is_closing(false),
-            m_current_sample_set(nullptr),
+            m_is_scheduled(false),
+            m_dropped_sample_sets_count(0),
+            m_is_pull_waiting(false),
+            m_is_pull_stopped(false),
+            m_priority_class(video_module_interface::supported_module_config::module_priority::normal),
+            m_contended_sample_sets_count(0),
+            m_degraded_sample_sets_count(0),
             m_sample_set_ready_handler(sample_set_ready_handler)
         {
-            m_samples_consumer_thread = std::thread(&sync_samples_consumer::consumer_loop, this);
+            if(m_queue_policy == video_module_interface::supported_module_config::samples_queue_policy::pull_queued)
+            {
+                m_queued_pulled_sample_sets.reset(new spsc_queue<std::shared_ptr<correlated_sample_set>>(m_queue_depth));
+            }
+        }
+
+        bool sync_samples_consumer::is_pulled() const
+        {
+            return m_queue_policy == video_module_interface::supported_module_config::samples_queue_policy::pull_latest ||
+                   m_queue_policy == video_module_interface::supported_module_config::samples_queue_policy::pull_queued;
+        }
+
+        void sync_samples_consumer::set_priority_class(video_module_interface::supported_module_config::module_priority priority_class,
+                                                       std::shared_ptr<module_contention> contention)
+        {
+            m_priority_class = priority_class;
+            m_contention = std::move(contention);
+        }
+
+        void sync_samples_consumer::set_degradation_controller(std::shared_ptr<degradation_controller> degradation)
+        {
+            m_degradation = std::move(degradation);
+        }
+
+        bool sync_samples_consumer::is_latency_critical() const
+        {
+            return m_contention && m_priority_class == video_module_interface::supported_module_config::module_priority::latency_critical;
+        }
+
+        bool sync_samples_consumer::is_throttled()
+        {
+            if(m_degradation)
+            {
+                const uint32_t decimation = m_degradation->query_decimation(m_priority_class);
+                if(decimation != 1)
+                {
+                    //the first sample set of a degradation step is handled, unless the step skips the module
+                    return decimation == 0 || m_degraded_sample_sets_count++ % decimation != 0;
+                }
+                m_degraded_sample_sets_count = 0;
+            }
+            if(!m_contention || m_priority_class != video_module_interface::supported_module_config::module_priority::best_effort)
+            {
+                return false;
+            }
+            if(!m_contention->is_contended())
+            {
+                m_contended_sample_sets_count = 0;
+                return false;
+            }
+            //the first sample set of a contention is handled, so a best effort module isn't starved by a busy latency critical module
+            return m_contended_sample_sets_count++ % BEST_EFFORT_DECIMATION != 0;
         }
 
         void sync_samples_consumer::on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set)
         {
-            //update the current object even if no one took it
+            if(is_pulled())
             {
-                std::unique_lock<std::mutex> lock(m_lock);
-                m_current_sample_set = std::move(ready_sample_set);
+                publish_pulled_sample_set(std::move(ready_sample_set));
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock(m_lock);
+            if(is_throttled())
+            {
+                m_statistics.on_throttled();
+                return;
+            }
+            if(m_sample_sets_queue.size() >= m_queue_depth)
+            {
+                switch(m_queue_policy)
+                {
+                    case video_module_interface::supported_module_config::samples_queue_policy::keep_latest:
+                        m_dropped_sample_sets_count += m_sample_sets_queue.size();
+                        for(auto & dropped_sample_set : m_sample_sets_queue)
+                        {
+                            m_statistics.on_dropped_samples(*dropped_sample_set);
+                        }
+                        m_sample_sets_queue.clear();
+                        break;
+                    case video_module_interface::supported_module_config::samples_queue_policy::drop_oldest:
+                        m_dropped_sample_sets_count++;
+                        m_statistics.on_dropped_samples(*m_sample_sets_queue.front());
+                        m_sample_sets_queue.pop_front();
+                        break;
+                    case video_module_interface::supported_module_config::samples_queue_policy::drop_newest:
+                        m_dropped_sample_sets_count++;
+                        m_statistics.on_dropped_samples(*ready_sample_set);
+                        return;
+                    case video_module_interface::supported_module_config::samples_queue_policy::block:
+                        //an upstream consumer delivers on an executor worker, waiting there for this consumer task may deadlock the
+                        //executor, so the worker drops the oldest queued sample set instead
+                        if(m_executor.is_worker_thread())
+                        {
+                            m_dropped_sample_sets_count++;
+                            m_statistics.on_dropped_samples(*m_sample_sets_queue.front());
+                            m_sample_sets_queue.pop_front();
+                            break;
+                        }
+                        m_conditional_variable.wait(lock, [this]() { return m_sample_sets_queue.size() < m_queue_depth || m_is_closing; });
+                        break;
+                    case video_module_interface::supported_module_config::samples_queue_policy::pull_latest:
+                    case video_module_interface::supported_module_config::samples_queue_policy::pull_queued:
+                        break;
+                }
+            }
+
+            if(m_is_closing)
+            {
+                return;
+            }
+            m_tracer.trace(pipeline_trace_stage::queued, *ready_sample_set);
+            m_sample_sets_queue.push_back(std::move(ready_sample_set));
+            m_statistics.on_queue_size_changed(m_sample_sets_queue.size());
+            if(m_degradation)
+            {
+                m_degradation->on_queue_size_changed(m_sample_sets_queue.size(), std::chrono::steady_clock::now());
+            }
+            if(m_is_scheduled)
+            {
+                return;
             }
-            m_conditional_variable.notify_one();
+            m_is_scheduled = true;
+            if(is_latency_critical())
+            {
+                m_contention->on_latency_critical_busy();
+            }
+            lock.unlock();
+
+            schedule_handler();
+        }
+
+        uint64_t sync_samples_consumer::query_dropped_sample_sets_count() const
+        {
+            return m_dropped_sample_sets_count;
         }
 
-        void sync_samples_consumer::consumer_loop()
+        void sync_samples_consumer::publish_pulled_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set)
         {
-            while(!m_is_closing)
+            std::shared_ptr<correlated_sample_set> dropped_sample_set;
             {
-                std::shared_ptr<correlated_sample_set> samples_set;
+                //the lock orders the streaming threads which complete sample sets, the pulling thread doesn't take it
+                std::lock_guard<std::mutex> lock(m_lock);
+                if(m_is_closing)
+                {
+                    return;
+                }
+                m_tracer.trace(pipeline_trace_stage::queued, *ready_sample_set);
+                if(m_queued_pulled_sample_sets)
                 {
-                  std::unique_lock<std::mutex> lock(m_lock);
-                  m_conditional_variable.wait(lock, [this]() { return m_is_closing || ( !m_is_closing && m_current_sample_set);});
-                  samples_set.swap(m_current_sample_set);
+                    //the pulling thread owns the queue head, so a full queue drops the newest sample set
+                    if(!m_queued_pulled_sample_sets->push(ready_sample_set))
+                    {
+                        dropped_sample_set = std::move(ready_sample_set);
+                        m_dropped_sample_sets_count++;
+                        m_statistics.on_dropped_samples(*dropped_sample_set);
+                    }
+                    m_statistics.on_queue_size_changed(m_queued_pulled_sample_sets->size());
                 }
+                else if(m_pulled_sample_sets.publish(std::move(ready_sample_set), dropped_sample_set))
+                {
+                    m_dropped_sample_sets_count++;
+                    m_statistics.on_dropped_samples(*dropped_sample_set);
+                }
+            }
+            //the dropped sample set images are released outside the lock
+
+            //pairs with the fence of the waiting thread, either the waiting thread sees the published sample set or it's woken
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(m_is_pull_waiting.load(std::memory_order_relaxed))
+            {
+                std::lock_guard<std::mutex> lock(m_pull_lock);
+                m_pulled_sample_set_ready.notify_one();
+            }
+        }
+
+        status sync_samples_consumer::pull_sample_set(std::shared_ptr<correlated_sample_set> & sample_set)
+        {
+            if(!is_pulled())
+            {
+                return samples_consumer_base::pull_sample_set(sample_set);
+            }
+            const bool is_taken = m_queued_pulled_sample_sets ? m_queued_pulled_sample_sets->pop(sample_set) : m_pulled_sample_sets.take(sample_set);
+            if(!is_taken)
+            {
+                return status_data_not_changed;
+            }
+            m_statistics.on_output();
+            return status_no_error;
+        }
+
+        status sync_samples_consumer::wait_sample_set(std::shared_ptr<correlated_sample_set> & sample_set, uint32_t timeout_ms)
+        {
+            status pull_status = pull_sample_set(sample_set);
+            if(pull_status != status_data_not_changed || timeout_ms == 0)
+            {
+                return pull_status == status_data_not_changed ? status_exec_timeout : pull_status;
+            }
+
+            std::unique_lock<std::mutex> lock(m_pull_lock);
+            m_is_pull_waiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            m_pulled_sample_set_ready.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&]()
+            {
+                pull_status = pull_sample_set(sample_set);
+                return pull_status != status_data_not_changed || m_is_pull_stopped;
+            });
+            m_is_pull_waiting.store(false, std::memory_order_relaxed);
 
-                if(!samples_set)
+            if(pull_status != status_data_not_changed)
+            {
+                return pull_status;
+            }
+            return m_is_pull_stopped ? status_invalid_state : status_exec_timeout;
+        }
+
+        void sync_samples_consumer::stop_pulling()
+        {
+            std::lock_guard<std::mutex> lock(m_pull_lock);
+            m_is_pull_stopped = true;
+            m_pulled_sample_set_ready.notify_all();
+        }
+
+        void sync_samples_consumer::schedule_handler()
+        {
+            m_executor.submit([this]() { handle_queued_sample_set(); }, m_affinity, m_handler_priority);
+        }
+
+        void sync_samples_consumer::handle_queued_sample_set()
+        {
+            std::shared_ptr<correlated_sample_set> samples_set;
+            {
+                std::unique_lock<std::mutex> lock(m_lock);
+                if(!m_is_closing && !m_sample_sets_queue.empty())
                 {
-                    continue;
+                    samples_set = std::move(m_sample_sets_queue.front());
+                    m_sample_sets_queue.pop_front();
+                    m_statistics.on_queue_size_changed(m_sample_sets_queue.size());
                 }
+            }
+            //a blocked delivery may queue the next sample set
+            m_conditional_variable.notify_all();
 
+            if(samples_set)
+            {
                 try
                 {
-                    m_sample_set_ready_handler(samples_set);
+                    const auto process_start_time = std::chrono::steady_clock::now();
+                    const status handler_status = m_sample_set_ready_handler(samples_set);
+                    const auto process_end_time = std::chrono::steady_clock::now();
+                    m_statistics.on_processed(process_end_time - process_start_time);
+                    if(m_degradation)
+                    {
+                        m_degradation->on_processed(process_end_time - process_start_time, process_end_time);
+                    }
+                    if(handler_status >= status_no_error)
+                    {
+                        m_statistics.on_output();
+                        notify_downstream_consumers(samples_set);
+                    }
                 }
                 catch(const std::exception & ex)
                 {
                     LOG_ERROR("m_sample_set_ready_handler callback throw ex" << ex.what());
-                    throw ex;
                 }
             }
+
+            //a sample set that completed during the handler is handled by a new task, so the other consumers tasks aren't delayed
+            std::unique_lock<std::mutex> lock(m_lock);
+            if(!m_sample_sets_queue.empty() && !m_is_closing)
+            {
+                lock.unlock();
+                schedule_handler();
+                return;
+            }
+            m_is_scheduled = false;
+            if(is_latency_critical())
+            {
+                m_contention->on_latency_critical_idle();
+            }
+            m_conditional_variable.notify_all();
         }
 
         sync_samples_consumer::~sync_samples_consumer()
         {
+            //the executor outlives the consumers, wait for the scheduled handler to finish
+            std::unique_lock<std::mutex> lock(m_lock);
             m_is_closing = true;
-            m_conditional_variable.notify_one();
-            if(m_samples_consumer_thread.joinable())
-            {
-                m_samples_consumer_thread.join();
-            }
+            m_sample_sets_queue.clear();
+            m_conditional_variable.notify_all();
+            m_conditional_variable.wait(lock, [this]() { return !m_is_scheduled; });
         }
     }
 }
@@ -2,12 +2,18 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #pragma once
-#include <thread>
 #include <mutex>
+#include <deque>
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include "rs/core/pipeline_async_interface.h"
 #include "samples_consumer_base.h"
+#include "work_stealing_executor.h"
+#include "triple_buffer.h"
+#include "spsc_queue.h"
+#include "module_contention.h"
+#include "degradation_controller.h"
 
 namespace rs
 {
@@ -15,25 +21,88 @@ namespace rs
     {
         /**
          * @brief The samples_consumer class
+         *
+         * The handler runs on the pipeline executor, one sample set at a time. Sample sets that complete while the handler is
+         * busy are queued, by the queue policy and depth of the consumer. Once the handler processed a sample set successfully, the
+         * sample set is forwarded to the downstream modules consumers. With the block queue policy a full queue blocks the streaming
+         * thread, though never an executor worker, which drops the oldest queued sample set of a downstream consumer instead.
+         * With the pull_latest queue policy the handler isn't called, the newest sample set is exchanged with the module thread
+         * through a triple buffer, the streaming threads and the pulling thread never wait for each other. With the pull_queued
+         * queue policy the sample sets are exchanged in order through a bounded lock free queue. A pulling thread that waits for
+         * the next sample set is woken by the streaming thread only while it waits.
+         * A latency critical consumer marks the shared module contention while it has a sample set queued or in process, and a best
+         * effort consumer handles only every BEST_EFFORT_DECIMATION sample set while the contention is marked.
+         * A consumer with a degradation controller reports its queue size and process times to it, and decimates its sample sets
+         * by the applied step of the degradation plan.
          */
         class sync_samples_consumer : public samples_consumer_base
         {
         public:
-            sync_samples_consumer(std::function<void(std::shared_ptr<correlated_sample_set>)> sample_set_ready_handler,
+            sync_samples_consumer(std::function<status(std::shared_ptr<correlated_sample_set>)> sample_set_ready_handler,
                                   const video_module_interface::actual_module_config & module_config,
-                                  const video_module_interface::supported_module_config::time_sync_mode time_sync_mode);
+                                  const video_module_interface::supported_module_config::time_sync_mode time_sync_mode,
+                                  uint32_t time_sync_deadline,
+                                  work_stealing_executor & executor,
+                                  int affinity,
+                                  work_stealing_executor::priority handler_priority,
+                                  video_module_interface::supported_module_config::samples_queue_policy queue_policy,
+                                  uint32_t queue_depth);
+
+            /**
+             * @brief Sets the module priority class and the contention shared by the pipeline consumers, must be set before the consumer
+             * is notified of sample sets.
+             */
+            void set_priority_class(video_module_interface::supported_module_config::module_priority priority_class,
+                                    std::shared_ptr<module_contention> contention);
+
+            /**
+             * @brief Sets the degradation controller shared by the pipeline module consumers, must be set before the consumer is
+             * notified of sample sets.
+             */
+            void set_degradation_controller(std::shared_ptr<degradation_controller> degradation);
+
+            uint64_t query_dropped_sample_sets_count() const override;
+            status pull_sample_set(std::shared_ptr<correlated_sample_set> & sample_set) override;
+            status wait_sample_set(std::shared_ptr<correlated_sample_set> & sample_set, uint32_t timeout_ms) override;
+            void stop_pulling() override;
 
             virtual ~sync_samples_consumer();
+        protected:
+            void on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set) override;
         private:
-            std::thread m_samples_consumer_thread;
+            static const uint32_t BEST_EFFORT_DECIMATION = 4;
+
+            work_stealing_executor & m_executor;
+            const int m_affinity;
+            const work_stealing_executor::priority m_handler_priority;
+            const video_module_interface::supported_module_config::samples_queue_policy m_queue_policy;
+            const size_t m_queue_depth;
             bool m_is_closing;
-            std::shared_ptr<correlated_sample_set> m_current_sample_set;
+            bool m_is_scheduled;
+            std::deque<std::shared_ptr<correlated_sample_set>> m_sample_sets_queue;
+            std::atomic<uint64_t> m_dropped_sample_sets_count;
             std::mutex m_lock;
             std::condition_variable m_conditional_variable;
+            triple_buffer<std::shared_ptr<correlated_sample_set>> m_pulled_sample_sets; //written under m_lock, read by the pulling thread only
+            std::unique_ptr<spsc_queue<std::shared_ptr<correlated_sample_set>>> m_queued_pulled_sample_sets; //the pull_queued exchange, same as above
+            std::atomic<bool> m_is_pull_waiting;
+            bool m_is_pull_stopped; //guarded by m_pull_lock
+            std::mutex m_pull_lock;
+            std::condition_variable m_pulled_sample_set_ready;
+            video_module_interface::supported_module_config::module_priority m_priority_class;
+            std::shared_ptr<module_contention> m_contention;
+            uint32_t m_contended_sample_sets_count; //guarded by m_lock
+            std::shared_ptr<degradation_controller> m_degradation;
+            uint32_t m_degraded_sample_sets_count; //guarded by m_lock
 
-            std::function<void(std::shared_ptr<correlated_sample_set>)> m_sample_set_ready_handler;
-            void on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set) override;
-            void consumer_loop();
+            std::function<status(std::shared_ptr<correlated_sample_set>)> m_sample_set_ready_handler;
+            //handles the oldest queued sample set on the executor, and reschedules itself while sample sets are queued
+            void schedule_handler();
+            void handle_queued_sample_set();
+            bool is_pulled() const;
+            bool is_latency_critical() const;
+            bool is_throttled();
+            void publish_pulled_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set);
         };
     }
 }
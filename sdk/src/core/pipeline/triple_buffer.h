@@ -0,0 +1,74 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <utility>
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief A wait-free exchange of the latest value between a single writer and a single reader.
+         *
+         * The writer fills its own slot and swaps it with the middle slot, the reader swaps its own slot with the middle slot when
+         * the middle slot holds a value it didn't take yet. Neither side waits for the other, a value which wasn't taken before the
+         * next value was published is returned to the writer, which releases it.
+         */
+        template<typename T>
+        class triple_buffer
+        {
+        public:
+            triple_buffer() : m_middle(MIDDLE_SLOT), m_write_slot(WRITE_SLOT), m_read_slot(READ_SLOT) {}
+
+            /**
+             * @brief Publishes the value to the reader, replacing a value the reader didn't take yet.
+             * @param[in] value      The published value
+             * @param[out] replaced  The replaced value which wasn't taken, empty if the reader took the previous value
+             * @return true if a value which wasn't taken was replaced
+             */
+            bool publish(T value, T & replaced)
+            {
+                m_slots[m_write_slot] = std::move(value);
+                const uint8_t previous_middle = m_middle.exchange(static_cast<uint8_t>(m_write_slot | FRESH_FLAG), std::memory_order_acq_rel);
+                m_write_slot = previous_middle & SLOT_MASK;
+                replaced = std::move(m_slots[m_write_slot]);
+                m_slots[m_write_slot] = T();
+                return (previous_middle & FRESH_FLAG) != 0;
+            }
+
+            /**
+             * @brief Takes the latest published value, the reader slot is left empty so the value isn't held by the buffer.
+             * @param[out] value  The latest value, unchanged if no value was published since the previous take
+             * @return true if a value was taken
+             */
+            bool take(T & value)
+            {
+                if((m_middle.load(std::memory_order_relaxed) & FRESH_FLAG) == 0)
+                {
+                    return false;
+                }
+                const uint8_t previous_middle = m_middle.exchange(m_read_slot, std::memory_order_acq_rel);
+                m_read_slot = previous_middle & SLOT_MASK;
+                value = std::move(m_slots[m_read_slot]);
+                m_slots[m_read_slot] = T();
+                return true;
+            }
+
+        private:
+            static const uint8_t WRITE_SLOT = 0;
+            static const uint8_t MIDDLE_SLOT = 1;
+            static const uint8_t READ_SLOT = 2;
+            static const uint8_t SLOT_MASK = 0x3;
+            //set while the middle slot holds a value the reader didn't take
+            static const uint8_t FRESH_FLAG = 0x4;
+
+            T m_slots[3];
+            std::atomic<uint8_t> m_middle;
+            uint8_t m_write_slot; //owned by the writer
+            uint8_t m_read_slot;  //owned by the reader
+        };
+    }
+}
@@ -0,0 +1,285 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "rs/core/video_module_registry.h"
+#include "rs/utils/log_utils.h"
+#include "lazy_video_module.h"
+
+using namespace std;
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            const string MANIFEST_EXTENSION = ".manifest";
+
+            string parent_directory(const string & path)
+            {
+                auto separator = path.find_last_of("/\\");
+                return separator == string::npos ? string() : path.substr(0, separator + 1);
+            }
+
+            string file_name(const string & path)
+            {
+                auto separator = path.find_last_of("/\\");
+                return separator == string::npos ? path : path.substr(separator + 1);
+            }
+
+            bool is_manifest_name(const string & name)
+            {
+                return name.size() > MANIFEST_EXTENSION.size() &&
+                       name.compare(name.size() - MANIFEST_EXTENSION.size(), MANIFEST_EXTENSION.size(), MANIFEST_EXTENSION) == 0;
+            }
+
+            //the manifest file names of a directory, sorted so the catalog order doesn't depend on the file system
+            status list_manifests(const string & directory_path, vector<string> & manifest_names)
+            {
+#ifdef WIN32
+                WIN32_FIND_DATAA find_data;
+                HANDLE find_handle = FindFirstFileA((directory_path + "\\*" + MANIFEST_EXTENSION).c_str(), &find_data);
+                if(find_handle == INVALID_HANDLE_VALUE)
+                {
+                    return GetLastError() == ERROR_FILE_NOT_FOUND ? status_no_error : status_file_open_failed;
+                }
+                do
+                {
+                    if(!(find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && is_manifest_name(find_data.cFileName))
+                    {
+                        manifest_names.push_back(find_data.cFileName);
+                    }
+                } while(FindNextFileA(find_handle, &find_data));
+                FindClose(find_handle);
+#else
+                DIR * directory = opendir(directory_path.c_str());
+                if(!directory)
+                {
+                    return status_file_open_failed;
+                }
+                while(dirent * entry = readdir(directory))
+                {
+                    if(is_manifest_name(entry->d_name))
+                    {
+                        manifest_names.push_back(entry->d_name);
+                    }
+                }
+                closedir(directory);
+#endif
+                sort(manifest_names.begin(), manifest_names.end());
+                return status_no_error;
+            }
+        }
+
+        /**
+         * @brief The video_module_registry_impl class
+         *
+         * The catalog entries and the modules created of them. The catalog is read by the manifests only, each entry shares its
+         * library between the modules created of it.
+         */
+        class video_module_registry_impl
+        {
+        public:
+            struct catalog_entry
+            {
+                module_manifest manifest;
+                string library_path;
+                shared_ptr<plugin_library_slot> library_slot;
+            };
+
+            mutable mutex m_lock;
+            vector<catalog_entry> m_catalog;
+            vector<unique_ptr<lazy_video_module>> m_modules;
+        };
+
+        video_module_registry::video_module_registry() : m_pimpl(new video_module_registry_impl()) {}
+
+        status video_module_registry::add_directory(const char * directory_path)
+        {
+            if(!directory_path)
+            {
+                return status_handle_invalid;
+            }
+
+            vector<string> manifest_names;
+            auto sts = list_manifests(directory_path, manifest_names);
+            if(sts < status_no_error)
+            {
+                LOG_ERROR("failed to open the modules directory " << directory_path);
+                return sts;
+            }
+
+            string directory(directory_path);
+            if(!directory.empty() && directory.back() != '/' && directory.back() != '\\')
+            {
+                directory += '/';
+            }
+
+            bool added = false;
+            for(auto & manifest_name : manifest_names)
+            {
+                sts = add_manifest((directory + manifest_name).c_str());
+                if(sts < status_no_error)
+                {
+                    LOG_WARN("skipped the module manifest " << directory.c_str() << manifest_name.c_str() << ", status " << sts);
+                    continue;
+                }
+                added = true;
+            }
+            return added ? status_no_error : status_item_unavailable;
+        }
+
+        status video_module_registry::add_manifest(const char * manifest_path)
+        {
+            if(!manifest_path)
+            {
+                return status_handle_invalid;
+            }
+
+            video_module_registry_impl::catalog_entry entry;
+            auto sts = read_module_manifest(manifest_path, entry.manifest);
+            if(sts < status_no_error)
+            {
+                return sts;
+            }
+            entry.library_path = parent_directory(manifest_path) + entry.manifest.library_name;
+            entry.library_slot = make_shared<plugin_library_slot>();
+
+            lock_guard<mutex> lock(m_pimpl->m_lock);
+            for(auto & catalog_entry : m_pimpl->m_catalog)
+            {
+                if(catalog_entry.manifest.uid == entry.manifest.uid)
+                {
+                    return status_key_already_exists;
+                }
+            }
+            m_pimpl->m_catalog.push_back(std::move(entry));
+            return status_no_error;
+        }
+
+        uint32_t video_module_registry::query_modules_count() const
+        {
+            lock_guard<mutex> lock(m_pimpl->m_lock);
+            return static_cast<uint32_t>(m_pimpl->m_catalog.size());
+        }
+
+        status video_module_registry::query_module_info(uint32_t index, module_info & info) const
+        {
+            lock_guard<mutex> lock(m_pimpl->m_lock);
+            if(index >= m_pimpl->m_catalog.size())
+            {
+                return status_value_out_of_range;
+            }
+
+            auto & entry = m_pimpl->m_catalog[index];
+            info = {};
+            info.uid = entry.manifest.uid;
+            strncpy(info.library_path, entry.library_path.c_str(), sizeof(info.library_path) - 1);
+            info.supported_configs_count = static_cast<uint32_t>(entry.manifest.supported_configs.size());
+            return status_no_error;
+        }
+
+        status video_module_registry::query_supported_module_config(uint32_t index, int32_t idx,
+                                                                    video_module_interface::supported_module_config & supported_config) const
+        {
+            lock_guard<mutex> lock(m_pimpl->m_lock);
+            if(index >= m_pimpl->m_catalog.size())
+            {
+                return status_value_out_of_range;
+            }
+
+            auto & supported_configs = m_pimpl->m_catalog[index].manifest.supported_configs;
+            if(idx < 0 || static_cast<size_t>(idx) >= supported_configs.size())
+            {
+                return status_value_out_of_range;
+            }
+            supported_config = supported_configs[idx];
+            return status_no_error;
+        }
+
+        status video_module_registry::find_module(int32_t uid, uint32_t & index) const
+        {
+            lock_guard<mutex> lock(m_pimpl->m_lock);
+            for(size_t i = 0; i < m_pimpl->m_catalog.size(); i++)
+            {
+                if(m_pimpl->m_catalog[i].manifest.uid == uid)
+                {
+                    index = static_cast<uint32_t>(i);
+                    return status_no_error;
+                }
+            }
+            return status_item_unavailable;
+        }
+
+        video_module_interface * video_module_registry::create_module(uint32_t index)
+        {
+            lock_guard<mutex> lock(m_pimpl->m_lock);
+            if(index >= m_pimpl->m_catalog.size())
+            {
+                return nullptr;
+            }
+
+            auto & entry = m_pimpl->m_catalog[index];
+            m_pimpl->m_modules.emplace_back(new lazy_video_module(entry.manifest, entry.library_path, entry.library_slot));
+            return m_pimpl->m_modules.back().get();
+        }
+
+        video_module_interface * video_module_registry::query_loaded_module(video_module_interface * module) const
+        {
+            lock_guard<mutex> lock(m_pimpl->m_lock);
+            for(auto & created_module : m_pimpl->m_modules)
+            {
+                if(created_module.get() == module)
+                {
+                    return created_module->query_instance();
+                }
+            }
+            return nullptr;
+        }
+
+        status video_module_registry::write_manifest(const char * library_path, const char * manifest_path)
+        {
+            if(!library_path)
+            {
+                return status_handle_invalid;
+            }
+
+            auto library = plugin_library::load(library_path);
+            if(!library)
+            {
+                return status_init_failed;
+            }
+            auto module = library->create_module();
+            if(!module)
+            {
+                return status_init_failed;
+            }
+
+            module_manifest manifest;
+            manifest.uid = module->query_module_uid();
+            manifest.library_name = file_name(library_path);
+            video_module_interface::supported_module_config supported_config = {};
+            for(int32_t idx = 0; module->query_supported_module_config(idx, supported_config) >= status_no_error; idx++)
+            {
+                manifest.supported_configs.push_back(supported_config);
+                supported_config = {};
+            }
+            library->destroy_module(module);
+
+            return write_module_manifest(manifest_path ? string(manifest_path) : module_manifest_path(library_path), manifest);
+        }
+
+        video_module_registry::~video_module_registry()
+        {
+            delete m_pimpl;
+        }
+    }
+}
@@ -0,0 +1,218 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "rs/utils/log_utils.h"
+#include "rs/utils/thread_config.h"
+#include "work_stealing_executor.h"
+
+using namespace rs::utils;
+
+namespace
+{
+    //the executor of the calling worker thread
+    thread_local const rs::core::work_stealing_executor * current_executor = nullptr;
+}
+
+namespace rs
+{
+    namespace core
+    {
+        work_stealing_executor::work_stealing_executor(unsigned int workers_count) :
+            m_next_worker(0),
+            m_pending_tasks_count(0),
+            m_is_closing(false)
+        {
+            if(workers_count == 0)
+            {
+                workers_count = 1;
+            }
+
+            for(unsigned int worker_index = 0; worker_index < workers_count; worker_index++)
+            {
+                std::unique_ptr<worker> new_worker(new worker());
+                new_worker->is_idle = false;
+                m_workers.push_back(std::move(new_worker));
+            }
+
+            //the workers start after all of them exist, as they steal from each other
+            for(size_t worker_index = 0; worker_index < m_workers.size(); worker_index++)
+            {
+                m_workers[worker_index]->thread = std::thread(&work_stealing_executor::worker_loop, this, worker_index);
+            }
+        }
+
+        void work_stealing_executor::submit(std::function<void()> task, int affinity, priority task_priority)
+        {
+            const size_t worker_index = (affinity >= 0 ? static_cast<unsigned int>(affinity) : m_next_worker++) % m_workers.size();
+            worker & target_worker = *m_workers[worker_index];
+            {
+                std::lock_guard<std::mutex> lock(target_worker.lock);
+                target_worker.tasks[static_cast<int>(task_priority)].push_back(std::move(task));
+            }
+
+            std::lock_guard<std::mutex> lock(m_idle_lock);
+            m_pending_tasks_count++;
+
+            //wake up the target worker, or an idle worker to steal the task if the target is busy
+            if(target_worker.is_idle)
+            {
+                target_worker.wake_up.notify_one();
+                return;
+            }
+            wake_up_idle_worker();
+        }
+
+        void work_stealing_executor::wake_up_idle_worker()
+        {
+            for(auto & idle_worker : m_workers)
+            {
+                if(idle_worker->is_idle)
+                {
+                    idle_worker->wake_up.notify_one();
+                    return;
+                }
+            }
+        }
+
+        unsigned int work_stealing_executor::query_workers_count() const
+        {
+            return static_cast<unsigned int>(m_workers.size());
+        }
+
+        bool work_stealing_executor::is_worker_thread() const
+        {
+            return current_executor == this;
+        }
+
+        rs::utils::thread_statistics work_stealing_executor::query_workers_statistics() const
+        {
+            rs::utils::thread_statistics statistics = {};
+            for(auto & counted_worker : m_workers)
+            {
+                auto worker_statistics = counted_worker->profiler.query_statistics();
+                statistics.threads_count += worker_statistics.threads_count;
+                statistics.running_time += worker_statistics.running_time;
+                statistics.cpu_time += worker_statistics.cpu_time;
+                for(int32_t i = 0; i < static_cast<int32_t>(rs::utils::thread_wait::max); i++)
+                {
+                    statistics.wait_time[i] += worker_statistics.wait_time[i];
+                }
+                statistics.processed_items_count += worker_statistics.processed_items_count;
+            }
+            return statistics;
+        }
+
+        bool work_stealing_executor::try_pop(worker & from, std::function<void()> & task)
+        {
+            std::lock_guard<std::mutex> lock(from.lock);
+            for(auto & tasks : from.tasks)
+            {
+                if(tasks.empty())
+                {
+                    continue;
+                }
+
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                return true;
+            }
+            return false;
+        }
+
+        bool work_stealing_executor::try_get_task(size_t worker_index, std::function<void()> & task)
+        {
+            if(try_pop(*m_workers[worker_index], task))
+            {
+                return true;
+            }
+
+            //steal, starting from the next worker so the workers don't steal from the same victim
+            for(size_t offset = 1; offset < m_workers.size(); offset++)
+            {
+                if(try_pop(*m_workers[(worker_index + offset) % m_workers.size()], task))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void work_stealing_executor::worker_loop(size_t worker_index)
+        {
+            rs::utils::thread_configuration::apply(rs::utils::thread_role::pipeline, "rs-pipeline");
+            current_executor = this;
+            worker & this_worker = *m_workers[worker_index];
+            this_worker.profiler.start();
+            while(true)
+            {
+                std::function<void()> task;
+                if(try_get_task(worker_index, task))
+                {
+                    {
+                        this_worker.profiler.lock(m_idle_lock);
+                        std::lock_guard<std::mutex> lock(m_idle_lock, std::adopt_lock);
+                        m_pending_tasks_count--;
+                        //a submit woke this worker only, an idle worker steals the tasks which are left while this one is busy
+                        if(m_pending_tasks_count > 0)
+                        {
+                            wake_up_idle_worker();
+                        }
+                    }
+
+                    try
+                    {
+                        task();
+                    }
+                    catch(const std::exception & ex)
+                    {
+                        LOG_ERROR("executor task throw ex : " << ex.what());
+                    }
+                    this_worker.profiler.add_processed_items();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(m_idle_lock);
+                //a task which is popped by another worker is still pending until that worker updates the count
+                if(m_pending_tasks_count > 0)
+                {
+                    lock.unlock();
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                if(m_is_closing)
+                {
+                    this_worker.profiler.stop();
+                    return;
+                }
+
+                this_worker.is_idle = true;
+                {
+                    rs::utils::thread_profiler::wait_scope input_wait(this_worker.profiler, rs::utils::thread_wait::input);
+                    this_worker.wake_up.wait(lock, [this]() { return m_pending_tasks_count > 0 || m_is_closing; });
+                }
+                this_worker.is_idle = false;
+            }
+        }
+
+        work_stealing_executor::~work_stealing_executor()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_idle_lock);
+                m_is_closing = true;
+                for(auto & closing_worker : m_workers)
+                {
+                    closing_worker->wake_up.notify_one();
+                }
+            }
+
+            for(auto & closing_worker : m_workers)
+            {
+                if(closing_worker->thread.joinable())
+                {
+                    closing_worker->thread.join();
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,97 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <functional>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include "rs/utils/thread_profiler.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief Runs tasks on a fixed set of worker threads, shared by the pipeline samples consumers.
+         *
+         * Each worker has its own queues. A task submitted with an affinity hint is queued to that worker, so a consumer keeps running
+         * on the same thread while the worker keeps up, the other tasks are spread round robin.
+         * An idle worker runs its own tasks first and then steals the oldest tasks of the other workers, so a task queued to a busy
+         * worker doesn't wait for it. High priority tasks run before the normal priority tasks, and are stolen first.
+         */
+        class work_stealing_executor
+        {
+        public:
+            enum class priority
+            {
+                high   = 0,
+                normal = 1
+            };
+
+            static const int no_affinity = -1;
+
+            /**
+             * @brief Starts the workers.
+             * @param[in] workers_count Number of worker threads, at least one worker is started
+             */
+            explicit work_stealing_executor(unsigned int workers_count);
+
+            /**
+             * @brief Queues a task to run on one of the workers.
+             * @param[in] task          The task, exceptions thrown by the task are logged and dropped
+             * @param[in] affinity      Index of the preferred worker, modulo the workers count, or \c no_affinity
+             * @param[in] task_priority Priority of the task
+             */
+            void submit(std::function<void()> task, int affinity = no_affinity, priority task_priority = priority::normal);
+
+            unsigned int query_workers_count() const;
+
+            /**
+             * @brief Checks if the calling thread is one of the workers, a task mustn't wait for another task of the executor.
+             */
+            bool is_worker_thread() const;
+
+            /**
+             * @brief Returns the counters of all the workers, their input wait is their idle time.
+             */
+            rs::utils::thread_statistics query_workers_statistics() const;
+
+            //the queued tasks run before the workers exit
+            ~work_stealing_executor();
+        private:
+            static const int priorities_count = 2;
+
+            struct worker
+            {
+                worker() : profiler(rs::utils::thread_role::pipeline) {}
+                std::mutex lock;
+                std::deque<std::function<void()>> tasks[priorities_count];
+                std::condition_variable wake_up;   //waited with m_idle_lock
+                bool is_idle;                      //guarded by m_idle_lock
+                std::thread thread;
+                rs::utils::thread_profiler profiler;
+            };
+
+            work_stealing_executor(const work_stealing_executor &) = delete;
+            work_stealing_executor & operator= (const work_stealing_executor &) = delete;
+
+            //pops the oldest task of the worker, for its own tasks and for stolen tasks alike, so the tasks of a consumer keep their order
+            bool try_pop(worker & from, std::function<void()> & task);
+            bool try_get_task(size_t worker_index, std::function<void()> & task);
+            //called with m_idle_lock held
+            void wake_up_idle_worker();
+            void worker_loop(size_t worker_index);
+
+            std::vector<std::unique_ptr<worker>> m_workers;
+            std::atomic<unsigned int> m_next_worker;
+            std::mutex m_idle_lock;
+            size_t m_pending_tasks_count;          //guarded by m_idle_lock
+            bool m_is_closing;                     //guarded by m_idle_lock
+        };
+    }
+}
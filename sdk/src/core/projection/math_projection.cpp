@@ -1,10 +1,19 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <cmath>
 #include <cstring>
 #include <utility>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <vector>
 
 #include "math_projection_interface.h"
+#include "voxel_grid.h"
+#include "image_rows_bands.h"
+#include "rs/utils/profiler_markers.h"
 
 const float MINABS_32F = 1.175494351e-38f;
 const double EPS52 = 2.2204460492503131e-016;
@@ -15,8 +24,519 @@ namespace rs
     {
         inline double abs(double a) { return (a < 0) ? (-a) : a; }
 
+        //the row kernels are written to be auto vectorized, each is compiled for several instruction sets when the compiler
+        //supports function multiversioning, and the best version for the running cpu is selected when the library is loaded
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 6) && defined(__x86_64__) && defined(__linux__)
+#define PROJECTION_ROW_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define PROJECTION_ROW_KERNEL
+#endif
+
+#if defined(__GNUC__)
+#define PROJECTION_INLINE __attribute__((always_inline))
+#else
+#define PROJECTION_INLINE
+#endif
+
+        //the invalid (zero depth) pixels are handled arithmetically with 0/1 masks rather than with conditional
+        //expressions, which the compiler may turn into branches and leave the loop scalar
+
+        //depth row to 3d points in the depth camera coordinates, a zero depth pixel gives (0, 0, 0)
+        PROJECTION_ROW_KERNEL
+        static void project_depth_row_to_vertices(const unsigned short * src, const pointF32 * rays, int width, float * dst)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const float z = static_cast<float>(src[x]);
+                //adding zero turns the -0 of a negative ray with zero depth to 0
+                dst[3 * x + 0] = rays[x].x * z + 0.f;
+                dst[3 * x + 1] = rays[x].y * z + 0.f;
+                dst[3 * x + 2] = z;
+            }
+        }
+
+        //the half float bits of a finite float, rounded to the nearest even and saturated to the largest half. both the normal and the
+        //subnormal results are computed and selected, so the conversion doesn't branch per pixel
+        static inline PROJECTION_INLINE uint16_t float_to_half(float value)
+        {
+            const uint32_t half_overflow = (127 + 16) << 23;    //2^16, the rounded magnitude is larger than the largest half
+            const uint32_t half_min_normal = 113 << 23;         //2^-14
+            const uint32_t subnormal_magic_bits = ((127 - 15) + (23 - 10) + 1) << 23;
+            float subnormal_magic;
+            memcpy(&subnormal_magic, &subnormal_magic_bits, sizeof(subnormal_magic));
+
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            const uint32_t sign = (bits >> 16) & 0x8000;
+            const uint32_t magnitude = bits & 0x7fffffff;
+
+            //the float addition aligns the subnormal mantissa and rounds it
+            float magnitude_value;
+            memcpy(&magnitude_value, &magnitude, sizeof(magnitude_value));
+            const float subnormal_sum = magnitude_value + subnormal_magic;
+            uint32_t subnormal_bits;
+            memcpy(&subnormal_bits, &subnormal_sum, sizeof(subnormal_bits));
+            const uint32_t subnormal = subnormal_bits - subnormal_magic_bits;
+
+            const uint32_t mantissa_odd = (magnitude >> 13) & 1;
+            const uint32_t normal = (magnitude + ((15u - 127u) << 23) + 0xfff + mantissa_odd) >> 13;
+
+            const uint32_t half = magnitude >= half_overflow ? 0x7bffu : (magnitude < half_min_normal ? subnormal : normal);
+            return static_cast<uint16_t>(half | sign);
+        }
+
+        //the nearest 16 bit integer, saturated
+        static inline PROJECTION_INLINE int16_t float_to_int16(float value)
+        {
+            const float saturated = std::min(std::max(value, -32768.f), 32767.f);
+            return static_cast<int16_t>(saturated + (saturated < 0.f ? -0.5f : 0.5f));
+        }
+
+        //depth row to 3d points in half floats, a zero depth pixel gives (0, 0, 0)
+        PROJECTION_ROW_KERNEL
+        static void project_depth_row_to_half_vertices(const unsigned short * src, const pointF32 * rays, int width, uint16_t * dst)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const float z = static_cast<float>(src[x]);
+                dst[3 * x + 0] = float_to_half(rays[x].x * z + 0.f);
+                dst[3 * x + 1] = float_to_half(rays[x].y * z + 0.f);
+                dst[3 * x + 2] = float_to_half(z);
+            }
+        }
+
+        //depth row to 3d points rounded to 16 bit integers, a zero depth pixel gives (0, 0, 0)
+        PROJECTION_ROW_KERNEL
+        static void project_depth_row_to_int16_vertices(const unsigned short * src, const pointF32 * rays, int width, int16_t * dst)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const float z = static_cast<float>(src[x]);
+                dst[3 * x + 0] = float_to_int16(rays[x].x * z);
+                dst[3 * x + 1] = float_to_int16(rays[x].y * z);
+                dst[3 * x + 2] = float_to_int16(z);
+            }
+        }
+
+        //depth row to the 3d points of the nonzero depth pixels and their pixel indices, returns the number of points.
+        //each pixel is written at the current output position, which advances only for a valid pixel, so the compaction doesn't branch
+        PROJECTION_ROW_KERNEL
+        static int project_depth_row_to_valid_vertices(const unsigned short * src, const pointF32 * rays, int width, int32_t first_index,
+                                                       float * dst, int32_t * indices)
+        {
+            int count = 0;
+            for (int x = 0; x < width; ++x)
+            {
+                const float z = static_cast<float>(src[x]);
+                dst[3 * count + 0] = rays[x].x * z + 0.f;
+                dst[3 * count + 1] = rays[x].y * z + 0.f;
+                dst[3 * count + 2] = z;
+                indices[count] = first_index + x;
+                count += src[x] != 0 ? 1 : 0;
+            }
+            return count;
+        }
+
+        //depth row to 3d points moved by the rotation and translation, a zero depth pixel gives (0, 0, 0)
+        PROJECTION_ROW_KERNEL
+        static void project_depth_row_to_transformed_vertices(const unsigned short * src, const pointF32 * rays, int width,
+                                                              const float * rotation, const float * translation, float * dst)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const float z = static_cast<float>(src[x]);
+                const float valid = src[x] != 0 ? 1.f : 0.f;
+                const float px = rays[x].x * z;
+                const float py = rays[x].y * z;
+                const float tx = rotation[0] * px + rotation[1] * py + rotation[2] * z + translation[0];
+                const float ty = rotation[3] * px + rotation[4] * py + rotation[5] * z + translation[1];
+                const float tz = rotation[6] * px + rotation[7] * py + rotation[8] * z + translation[2];
+                dst[3 * x + 0] = tx * valid + 0.f;
+                dst[3 * x + 1] = ty * valid + 0.f;
+                dst[3 * x + 2] = tz * valid + 0.f;
+            }
+        }
+
+        //depth row to pixel coordinates of the destination camera, a zero depth pixel gives (-1, -1),
+        //a point on the destination camera plane gives (0, 0). returns the number of points on the camera plane
+        static inline PROJECTION_INLINE int project_depth_row_to_uv_impl(const unsigned short * src, const pointF32 * rays, int width,
+                                                                     const float * rotation, const float * translation, const double * distortion,
+                                                                     const float * camera, float * dst, bool distorted)
+        {
+            int degenerate_count = 0;
+            for (int x = 0; x < width; ++x)
+            {
+                const float z = static_cast<float>(src[x]);
+                const float px = rays[x].x * z;
+                const float py = rays[x].y * z;
+                const float tx = rotation[0] * px + rotation[1] * py + rotation[2] * z + translation[0];
+                const float ty = rotation[3] * px + rotation[4] * py + rotation[5] * z + translation[1];
+                const float tz = rotation[6] * px + rotation[7] * py + rotation[8] * z + translation[2];
+
+                const bool valid = src[x] != 0;
+                const bool on_plane = (tz < 0 ? -tz : tz) <= MINABS_32F;
+                degenerate_count += (valid & on_plane) ? 1 : 0;
+
+                //keep the math finite for the pixels which are masked out
+                const double inv_z = 1.f / (on_plane ? 1.f : tz);
+                double u = inv_z * tx;
+                double v = inv_z * ty;
+
+                if(distorted)
+                {
+                    const double r2  = u * u + v * v;
+                    const double r4  = r2 * r2;
+                    const double fDist = 1.f + distortion[0] * r2 + distortion[1] * r4 + distortion[4] * r2 * r4;
+                    const double uv2 = 2.f * u * v;
+                    const double du = u * fDist + distortion[2] * uv2 + distortion[3] * (r2 + 2.f * u * u);
+                    const double dv = v * fDist + distortion[3] * uv2 + distortion[2] * (r2 + 2.f * v * v);
+                    u = du;
+                    v = dv;
+                }
+
+                //valid pixels keep their coordinates, points on the camera plane give 0, zero depth pixels give -1
+                const double keep = (valid & !on_plane) ? 1. : 0.;
+                const double fill = valid ? 0. : -1.;
+                dst[2 * x + 0] = static_cast<float>((u * camera[0] + camera[1]) * keep + fill);
+                dst[2 * x + 1] = static_cast<float>((v * camera[2] + camera[3]) * keep + fill);
+            }
+            return degenerate_count;
+        }
+
+        PROJECTION_ROW_KERNEL
+        static int project_depth_row_to_uv(const unsigned short * src, const pointF32 * rays, int width, const float * rotation,
+                                           const float * translation, const double * distortion, const float * camera, float * dst)
+        {
+            //the distortion test is hoisted out of the pixels loop, each call below is inlined into its own loop
+            if(distortion)
+                return project_depth_row_to_uv_impl(src, rays, width, rotation, translation, distortion, camera, dst, true);
+            return project_depth_row_to_uv_impl(src, rays, width, rotation, translation, distortion, camera, dst, false);
+        }
+
+        //camera points to pixel coordinates of the destination camera, in structure of arrays, a point on the camera plane gives (0, 0).
+        //the arithmetic of rs_3d_array_projection_32f, with the missing transformations replaced by the identity
+        static inline PROJECTION_INLINE void project_points_to_uv_impl(const float * px, const float * py, const float * pz, int length,
+                                                                   const float * rotation, const float * translation, const double * distortion,
+                                                                   const float * camera, float * pu, float * pv, bool distorted)
+        {
+            //the parameters are copied to locals, the compiler can't tell the outputs don't alias them, and would reload them per point
+            const float r0 = rotation[0], r1 = rotation[1], r2 = rotation[2], r3 = rotation[3], r4 = rotation[4], r5 = rotation[5];
+            const float r6 = rotation[6], r7 = rotation[7], r8 = rotation[8];
+            const float t0 = translation[0], t1 = translation[1], t2 = translation[2];
+            const double c0 = camera[0], c1 = camera[1], c2 = camera[2], c3 = camera[3];
+            for (int n = 0; n < length; ++n)
+            {
+                const float tx = r0 * px[n] + r1 * py[n] + r2 * pz[n] + t0;
+                const float ty = r3 * px[n] + r4 * py[n] + r5 * pz[n] + t1;
+                const float tz = r6 * px[n] + r7 * py[n] + r8 * pz[n] + t2;
+
+                //keep the math finite for the points on the camera plane, which are masked out
+                const bool on_plane = (tz < 0 ? -tz : tz) <= MINABS_32F;
+                const double inv_z = 1.f / (on_plane ? 1.f : tz);
+                double u = inv_z * tx;
+                double v = inv_z * ty;
+
+                if(distorted)
+                {
+                    const double r2  = u * u + v * v;
+                    const double r4  = r2 * r2;
+                    const double fDist = 1.f + distortion[0] * r2 + distortion[1] * r4 + distortion[4] * r2 * r4;
+                    const double uv2 = 2.f * u * v;
+                    const double du = u * fDist + distortion[2] * uv2 + distortion[3] * (r2 + 2.f * u * u);
+                    const double dv = v * fDist + distortion[3] * uv2 + distortion[2] * (r2 + 2.f * v * v);
+                    u = du;
+                    v = dv;
+                }
+
+                const double keep = on_plane ? 0. : 1.;
+                pu[n] = static_cast<float>((u * c0 + c1) * keep);
+                pv[n] = static_cast<float>((v * c2 + c3) * keep);
+            }
+        }
+
+        PROJECTION_ROW_KERNEL
+        static void project_points_to_uv(const float * px, const float * py, const float * pz, int length, const float * rotation,
+                                         const float * translation, const double * distortion, const float * camera, float * pu, float * pv)
+        {
+            //the distortion test is hoisted out of the points loop, each call below is inlined into its own loop
+            if(distortion)
+                project_points_to_uv_impl(px, py, pz, length, rotation, translation, distortion, camera, pu, pv, true);
+            else
+                project_points_to_uv_impl(px, py, pz, length, rotation, translation, distortion, camera, pu, pv, false);
+        }
+
+        //the transformation parameters of the points kernels, the missing transformations are replaced by the identity, and the
+        //tangential distortion coefficients are ignored unless the first one is set
+        struct points_projection_parameters
+        {
+            float rotation[9];
+            float translation[3];
+            double distortion[5];
+            bool distorted;
+
+            points_projection_parameters(const float * rotation_src, const float * translation_src, const float * distortion_src) :
+                rotation { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f }, translation { 0.f, 0.f, 0.f }, distortion { 0., 0., 0., 0., 0. },
+                distorted(distortion_src != nullptr)
+            {
+                if(rotation_src) memcpy(rotation, rotation_src, sizeof(rotation));
+                if(translation_src) memcpy(translation, translation_src, sizeof(translation));
+                if(distortion_src)
+                {
+                    distortion[0] = distortion_src[0];
+                    distortion[1] = distortion_src[1];
+                    distortion[4] = distortion_src[4];
+                    if(distortion_src[2] != 0)
+                    {
+                        distortion[2] = distortion_src[2];
+                        distortion[3] = distortion_src[3];
+                    }
+                }
+            }
+        };
+
+        //the fixed point kernels keep the rays, the transformation and the camera parameters as Q16 integers, with 16 fractional bits,
+        //and compute in 64 bit integers, which don't overflow for any depth value. they're selected on the targets whose floating point
+        //unit is slow, only the final conversion of the float outputs uses it. the vertices kernels are auto vectorized like the float
+        //kernels, the widening multiplies map to the integer SIMD instructions, e.g. NEON vmull
+        static const int FIXED_POINT_SHIFT = 16;
+        static const int64_t FIXED_POINT_ONE = int64_t(1) << FIXED_POINT_SHIFT;
+        //the normalized coordinates are bounded before the distortion, which keeps its powers in 64 bits. it's 4 focal lengths, 76 degrees
+        //off the camera axis, far outside the field of view of the color camera
+        static const int64_t FIXED_POINT_MAX_NORMALIZED = 4 * FIXED_POINT_ONE;
+
+        static inline int32_t float_to_q16(float value)
+        {
+            return static_cast<int32_t>(std::lround(static_cast<double>(value) * FIXED_POINT_ONE));
+        }
+
+        //the nearest 16 bit integer of a Q16 value, saturated
+        static inline PROJECTION_INLINE int16_t q16_to_int16(int64_t value)
+        {
+            const int64_t rounded = (value + (FIXED_POINT_ONE >> 1)) >> FIXED_POINT_SHIFT;
+            return static_cast<int16_t>(std::min<int64_t>(std::max<int64_t>(rounded, -32768), 32767));
+        }
+
+        //depth row to 3d points with the Q16 rays, a zero depth pixel gives (0, 0, 0)
+        PROJECTION_ROW_KERNEL
+        static void project_depth_row_to_fixed_point_vertices(const unsigned short * src, const pointI32 * rays, int width, float * dst)
+        {
+            const float q16_scale = 1.f / FIXED_POINT_ONE;
+            for (int x = 0; x < width; ++x)
+            {
+                const int64_t z = src[x];
+                dst[3 * x + 0] = static_cast<float>(rays[x].x * z) * q16_scale;
+                dst[3 * x + 1] = static_cast<float>(rays[x].y * z) * q16_scale;
+                dst[3 * x + 2] = static_cast<float>(src[x]);
+            }
+        }
+
+        //depth row to 3d points in half floats with the Q16 rays, a zero depth pixel gives (0, 0, 0)
+        PROJECTION_ROW_KERNEL
+        static void project_depth_row_to_fixed_point_half_vertices(const unsigned short * src, const pointI32 * rays, int width, uint16_t * dst)
+        {
+            const float q16_scale = 1.f / FIXED_POINT_ONE;
+            for (int x = 0; x < width; ++x)
+            {
+                const int64_t z = src[x];
+                dst[3 * x + 0] = float_to_half(static_cast<float>(rays[x].x * z) * q16_scale);
+                dst[3 * x + 1] = float_to_half(static_cast<float>(rays[x].y * z) * q16_scale);
+                dst[3 * x + 2] = float_to_half(static_cast<float>(src[x]));
+            }
+        }
+
+        //depth row to 3d points rounded to 16 bit integers with the Q16 rays, without floating point, a zero depth pixel gives (0, 0, 0)
+        PROJECTION_ROW_KERNEL
+        static void project_depth_row_to_fixed_point_int16_vertices(const unsigned short * src, const pointI32 * rays, int width, int16_t * dst)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const int64_t z = src[x];
+                dst[3 * x + 0] = q16_to_int16(rays[x].x * z);
+                dst[3 * x + 1] = q16_to_int16(rays[x].y * z);
+                dst[3 * x + 2] = static_cast<int16_t>(std::min<int64_t>(z, 32767));
+            }
+        }
+
+        //depth row to pixel coordinates of the destination camera with the Q16 rays and parameters, as project_depth_row_to_uv.
+        //the points beyond the bound of the normalized coordinates give (-1, -1). returns the number of points on the camera plane
+        static int project_depth_row_to_fixed_point_uv(const unsigned short * src, const pointI32 * rays, int width, const int64_t * rotation,
+                                                       const int64_t * translation, const int64_t * distortion, const int64_t * camera, float * dst)
+        {
+            const float q16_scale = 1.f / FIXED_POINT_ONE;
+            int degenerate_count = 0;
+            for (int x = 0; x < width; ++x)
+            {
+                const int64_t z = src[x];
+                const int64_t px = rays[x].x * z;
+                const int64_t py = rays[x].y * z;
+                const int64_t pz = z << FIXED_POINT_SHIFT;
+                const int64_t tx = ((rotation[0] * px + rotation[1] * py + rotation[2] * pz) >> FIXED_POINT_SHIFT) + translation[0];
+                const int64_t ty = ((rotation[3] * px + rotation[4] * py + rotation[5] * pz) >> FIXED_POINT_SHIFT) + translation[1];
+                const int64_t tz = ((rotation[6] * px + rotation[7] * py + rotation[8] * pz) >> FIXED_POINT_SHIFT) + translation[2];
+
+                const bool valid = z != 0;
+                const bool on_plane = tz == 0;
+                degenerate_count += (valid & on_plane) ? 1 : 0;
+
+                const int64_t divisor = on_plane ? 1 : tz;
+                int64_t u = (tx << FIXED_POINT_SHIFT) / divisor;
+                int64_t v = (ty << FIXED_POINT_SHIFT) / divisor;
+                const bool bounded = u >= -FIXED_POINT_MAX_NORMALIZED && u <= FIXED_POINT_MAX_NORMALIZED &&
+                                     v >= -FIXED_POINT_MAX_NORMALIZED && v <= FIXED_POINT_MAX_NORMALIZED;
+                u = bounded ? u : 0;
+                v = bounded ? v : 0;
+
+                if(distortion)
+                {
+                    const int64_t r2 = (u * u + v * v) >> FIXED_POINT_SHIFT;
+                    const int64_t r4 = (r2 * r2) >> FIXED_POINT_SHIFT;
+                    const int64_t r6 = (r2 * r4) >> FIXED_POINT_SHIFT;
+                    const int64_t dist = FIXED_POINT_ONE + ((distortion[0] * r2 + distortion[1] * r4 + distortion[4] * r6) >> FIXED_POINT_SHIFT);
+                    const int64_t uv2 = (2 * u * v) >> FIXED_POINT_SHIFT;
+                    const int64_t du = ((u * dist) >> FIXED_POINT_SHIFT) +
+                                       ((distortion[2] * uv2 + distortion[3] * (r2 + ((2 * u * u) >> FIXED_POINT_SHIFT))) >> FIXED_POINT_SHIFT);
+                    const int64_t dv = ((v * dist) >> FIXED_POINT_SHIFT) +
+                                       ((distortion[3] * uv2 + distortion[2] * (r2 + ((2 * v * v) >> FIXED_POINT_SHIFT))) >> FIXED_POINT_SHIFT);
+                    u = du;
+                    v = dv;
+                }
+
+                //valid pixels keep their coordinates, points on the camera plane give 0, zero depth and unbounded pixels give -1
+                const int64_t keep = (valid & !on_plane & bounded) ? 1 : 0;
+                const int64_t fill = (valid & (on_plane | bounded)) ? 0 : -FIXED_POINT_ONE;
+                dst[2 * x + 0] = static_cast<float>((((u * camera[0]) >> FIXED_POINT_SHIFT) + camera[1]) * keep + fill) * q16_scale;
+                dst[2 * x + 1] = static_cast<float>((((v * camera[2]) >> FIXED_POINT_SHIFT) + camera[3]) * keep + fill) * q16_scale;
+            }
+            return degenerate_count;
+        }
+
+        //the f-theta (FOV) fisheye model maps the undistorted radius r of a normalized point to the distorted radius
+        //rd = atan(2 r tan(fov / 2)) / fov, returns rd / r, whose limit at the optical axis is 2 tan(fov / 2) / fov
+        static inline PROJECTION_INLINE float fisheye_distortion_scale(float r, float fov, float fov_tan)
+        {
+            const float axis_scale = 2.f * fov_tan / fov;
+            return r > MINABS_32F ? std::atan(2.f * r * fov_tan) / (fov * r) : axis_scale;
+        }
+
+        //rectified pinhole camera row to the fisheye pixels of its pixels, the rays of a pinhole camera are all in front of the
+        //fisheye camera, so each pixel maps inside the field of view of the model
+        PROJECTION_ROW_KERNEL
+        static void fisheye_undistort_row(int y, int width, const float * camera_dst, const float * camera_fisheye, float fov, float * dst)
+        {
+            const float fx = camera_dst[0], px = camera_dst[1], fy = camera_dst[2], py = camera_dst[3];
+            const float ffx = camera_fisheye[0], fpx = camera_fisheye[1], ffy = camera_fisheye[2], fpy = camera_fisheye[3];
+            const float fov_tan = std::tan(fov * 0.5f);
+            const float ny = (static_cast<float>(y) - py) / fy;
+            for (int x = 0; x < width; ++x)
+            {
+                const float nx = (static_cast<float>(x) - px) / fx;
+                const float scale = fisheye_distortion_scale(std::sqrt(nx * nx + ny * ny), fov, fov_tan);
+                dst[2 * x + 0] = nx * scale * ffx + fpx;
+                dst[2 * x + 1] = ny * scale * ffy + fpy;
+            }
+        }
+
+        //the remap table starts with its header, followed by the source offset of each destination pixel, -1 for a pixel outside of the
+        //source, and by the Q8 horizontal and vertical weights of each pixel
+        struct remap_table_header
+        {
+            sizeI32 src_size;
+            int32_t src_step;
+            sizeI32 dst_size;
+            int32_t interpolation_type;
+            int32_t reserved[2];
+        };
+        static const int REMAP_WEIGHT_SHIFT = 8;
+
+        //remap table row of the bilinear interpolation. a coordinate is inside the source up to its last column and row, where the
+        //top left sample moves one pixel back and its weight moves to the next sample, so the four samples are always in the source
+        PROJECTION_ROW_KERNEL
+        static void build_linear_remap_table_row(const float * xy, int width, int src_width, int src_height, int src_step,
+                                                 int32_t * offsets, uint16_t * weights)
+        {
+            const float last_x = static_cast<float>(src_width - 1), last_y = static_cast<float>(src_height - 1);
+            const float weight_one = static_cast<float>(1 << REMAP_WEIGHT_SHIFT);
+            for (int x = 0; x < width; ++x)
+            {
+                const float sx = xy[2 * x + 0];
+                const float sy = xy[2 * x + 1];
+                const int inside = (sx >= 0.f) & (sy >= 0.f) & (sx <= last_x) & (sy <= last_y);
+                //the clamps are written so a nan coordinate clamps to 0
+                const float cx = std::min(std::max(0.f, sx), last_x);
+                const float cy = std::min(std::max(0.f, sy), last_y);
+                const int x0 = std::min(static_cast<int>(cx), src_width - 2);
+                const int y0 = std::min(static_cast<int>(cy), src_height - 2);
+                offsets[x] = (y0 * src_step + x0 + 1) * inside - 1;
+                weights[2 * x + 0] = static_cast<uint16_t>((cx - static_cast<float>(x0)) * weight_one + 0.5f);
+                weights[2 * x + 1] = static_cast<uint16_t>((cy - static_cast<float>(y0)) * weight_one + 0.5f);
+            }
+        }
+
+        //remap table row of the nearest source pixels, rounded half down as rs_remap_16u_c1r rounds them. the bounds are checked on
+        //the coordinates, so the coordinates far outside of the source aren't converted to integers
+        PROJECTION_ROW_KERNEL
+        static void build_nearest_remap_table_row(const float * xy, int width, int src_width, int src_height, int src_step,
+                                                  int32_t * offsets, uint16_t * weights)
+        {
+            const float max_x = static_cast<float>(src_width) - 0.5f, max_y = static_cast<float>(src_height) - 0.5f;
+            for (int x = 0; x < width; ++x)
+            {
+                const float sx = xy[2 * x + 0];
+                const float sy = xy[2 * x + 1];
+                const int inside = (sx >= -0.5f) & (sy >= -0.5f) & (sx < max_x) & (sy < max_y);
+                const int ix = static_cast<int>(std::min(std::max(-0.5f, sx), max_x) + 1.5f) - 1;
+                const int iy = static_cast<int>(std::min(std::max(-0.5f, sy), max_y) + 1.5f) - 1;
+                offsets[x] = (iy * src_step + ix + 1) * inside - 1;
+                weights[2 * x + 0] = weights[2 * x + 1] = 0;
+            }
+        }
+
+        //8 bit row bilinearly remapped by its remap table row, the pixels outside of the source take the default value. the offsets of
+        //the outside pixels are masked to the source origin, so the samples are read without branches
+        PROJECTION_ROW_KERNEL
+        static void remap_row_8u_linear(const unsigned char * src, int src_step, const int32_t * offsets, const uint16_t * weights, int width,
+                                        unsigned char * dst, unsigned char default_value)
+        {
+            const int32_t half = 1 << (2 * REMAP_WEIGHT_SHIFT - 1);
+            for (int x = 0; x < width; ++x)
+            {
+                const int32_t offset = std::max(offsets[x], 0);
+                const int32_t wx = weights[2 * x + 0];
+                const int32_t wy = weights[2 * x + 1];
+                const unsigned char * sample = src + offset;
+                const int32_t top = (sample[0] << REMAP_WEIGHT_SHIFT) + (sample[1] - sample[0]) * wx;
+                const int32_t bottom = (sample[src_step] << REMAP_WEIGHT_SHIFT) + (sample[src_step + 1] - sample[src_step]) * wx;
+                const int32_t value = ((top << REMAP_WEIGHT_SHIFT) + (bottom - top) * wy + half) >> (2 * REMAP_WEIGHT_SHIFT);
+                dst[x] = offsets[x] >= 0 ? static_cast<unsigned char>(value) : default_value;
+            }
+        }
+
+        //8 bit row remapped to the nearest source pixels of its remap table row
+        PROJECTION_ROW_KERNEL
+        static void remap_row_8u_nearest(const unsigned char * src, const int32_t * offsets, int width, unsigned char * dst, unsigned char default_value)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const unsigned char value = src[std::max(offsets[x], 0)];
+                dst[x] = offsets[x] >= 0 ? value : default_value;
+            }
+        }
+
         static status r_own_iuvmap_invertor(const pointF32 *uvmap, int uvmap_step, sizeI32 uvmap_size, rect uvmap_roi,
-                                            pointF32 *uvInv, int uvinv_step, sizeI32 uvinv_size, rect uvinv_roi, int uvinv_units_is_relative, pointF32 threshold);
+                                            pointF32 *uvInv, int uvinv_step, sizeI32 uvinv_size, rect uvinv_roi, int uvinv_units_is_relative, pointF32 threshold,
+                                            int band_ymin, int band_ymax);
+
+        static const int MAX_NUMBER_OF_BANDS = 8;
+        static const int MIN_BAND_ROWS = 32;
+
+        //splits [0, rows) to bands, one per core, and calls band_function(first_row, last_row + 1) for each band in parallel,
+        //on the calling thread and the persistent workers of the image bands
+        static void for_each_rows_band(int rows, int min_band_rows, const std::function<void(int, int)> & band_function)
+        {
+            int number_of_bands = std::min(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())), MAX_NUMBER_OF_BANDS);
+            number_of_bands = std::max(1, std::min(number_of_bands, rows / std::max(1, min_band_rows)));
+            image_rows_bands::for_each(rows, number_of_bands, [&band_function](int band, int first_row, int end_row) { band_function(first_row, end_row); });
+        }
 
 
         math_projection::math_projection() {}
@@ -94,6 +614,7 @@ namespace rs
         status REFCALL math_projection::rs_3d_array_projection_32f(const float *psrc, float *pdst, int length, float camera_src[4],
                 float inv_distortionSrc[5], float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4])
         {
+            RS_PROFILER_ZONE("math_projection::rs_3d_array_projection_32f");
 
             status sts = status::status_no_error;
             signed int n = 0;
@@ -108,6 +629,35 @@ namespace rs
             if (psrc == 0 || pdst == 0) return status::status_handle_invalid;
             if (length <= 0) return status::status_data_not_initialized;
 
+            if(!camera_src && !inv_distortionSrc && camera_dst)
+            {
+                //camera points to pixels, the points are split to blocks and each block is transposed to a structure of arrays on the
+                //stack, so the points kernel is vectorized. a block is read before it's written, so the projection can be in place
+                const int block_size = 256;
+                float x[block_size], y[block_size], z[block_size], u[block_size], v[block_size];
+                const points_projection_parameters parameters(rotation, translation, distortion_dst);
+                for ( ; n < length; n += block_size)
+                {
+                    const int count = std::min(block_size, length - n);
+                    const float* block_src = src + 3 * n;
+                    float* block_dst = dst + 2 * n;
+                    for (int i = 0; i < count; ++i)
+                    {
+                        x[i] = block_src[3 * i + 0];
+                        y[i] = block_src[3 * i + 1];
+                        z[i] = block_src[3 * i + 2];
+                    }
+                    project_points_to_uv(x, y, z, count, parameters.rotation, parameters.translation,
+                                         parameters.distorted ? parameters.distortion : nullptr, camera_dst, u, v);
+                    for (int i = 0; i < count; ++i)
+                    {
+                        block_dst[2 * i + 0] = u[i];
+                        block_dst[2 * i + 1] = v[i];
+                    }
+                }
+                return sts;
+            }
+
             if(camera_src)
             {
                 invFx = (1.f / camera_src[0]);
@@ -205,8 +755,19 @@ namespace rs
             return sts;
         }
 
+        status REFCALL math_projection::rs_3d_array_projection_32f_p3p2(const float *psrc_x, const float *psrc_y, const float *psrc_z,
+                float *pdst_u, float *pdst_v, int length, float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4])
+        {
+            RS_PROFILER_ZONE("math_projection::rs_3d_array_projection_32f_p3p2");
+            if (psrc_x == 0 || psrc_y == 0 || psrc_z == 0 || pdst_u == 0 || pdst_v == 0 || camera_dst == 0) return status::status_handle_invalid;
+            if (length <= 0) return status::status_data_not_initialized;
+            const points_projection_parameters parameters(rotation, translation, distortion_dst);
+            project_points_to_uv(psrc_x, psrc_y, psrc_z, length, parameters.rotation, parameters.translation,
+                                 parameters.distorted ? parameters.distortion : nullptr, camera_dst, pdst_u, pdst_v);
+            return status::status_no_error;
+        }
+
         //Added
-        #pragma vector
         status REFCALL math_projection::rs_projection_16u32f_c1cxr(const unsigned short *psrc, sizeI32 roi_size, int src_step, float *pdst, int dst_step,
                 float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4], const projection_spec_32f *pspec)
         {
@@ -215,102 +776,245 @@ namespace rs
 
             sizeI32 context_roi_size = ((sizeI32*)pspec)[0];
             if( roi_size.width != context_roi_size.width || roi_size.height != context_roi_size.height ) return status::status_param_unsupported ;
-            status sts = status::status_no_error;
 
-            double u, v;
-            float zPlane;
-            int dstPi_x = 3;
-            if(camera_dst) dstPi_x = 2;
+            rect roi = { 0, 0, roi_size.width, roi_size.height };
+            return rs_projection_roi_16u32f_c1cxr(psrc, roi, src_step, pdst, dst_step, rotation, translation, distortion_dst, camera_dst, pspec);
+        }
+
+        status REFCALL math_projection::rs_projection_roi_16u32f_c1cxr(const unsigned short *psrc, rect roi, int src_step, float *pdst, int dst_step,
+                float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4], const projection_spec_32f *pspec)
+        {
+            RS_PROFILER_ZONE("math_projection::rs_projection_roi_16u32f_c1cxr");
+            if(psrc == 0 || pdst == 0 || pspec == 0) return status::status_handle_invalid;
+            if (roi.width <= 0 || roi.height <= 0) return status::status_data_not_initialized;
+
+            sizeI32 context_roi_size = ((sizeI32*)pspec)[0];
+            if (roi.x < 0 || roi.y < 0 || roi.x + roi.width > context_roi_size.width || roi.y + roi.height > context_roi_size.height)
+                return status::status_param_unsupported;
+            status sts = status::status_no_error;
 
             unsigned char* pbuffer = (unsigned char*)pspec + sizeof(float) * 16;
-            pointF32 *rowUV = (pointF32*)pbuffer;
+            const pointF32 *rowUV = (const pointF32*)pbuffer + roi.y * context_roi_size.width + roi.x;
+
+            //missing transformations are replaced by the identity, which keeps the row kernels free of per pixel branches
+            const float identity_rotation[9] = { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f };
+            const float zero_translation[3] = { 0.f, 0.f, 0.f };
+            const float* rot = rotation ? rotation : identity_rotation;
+            const float* trans = translation ? translation : zero_translation;
+
+            //the tangential coefficients are ignored unless the first one is set
+            double dist[5] = { 0., 0., 0., 0., 0. };
+            const double* distortion = distortion_dst ? dist : nullptr;
+            if(distortion_dst)
+            {
+                dist[0] = distortion_dst[0];
+                dist[1] = distortion_dst[1];
+                dist[4] = distortion_dst[4];
+                if(distortion_dst[2] != 0)
+                {
+                    dist[2] = distortion_dst[2];
+                    dist[3] = distortion_dst[3];
+                }
+            }
 
-            for (int y = 0; y < roi_size.height; ++y)
+            for (int y = 0; y < roi.height; ++y, rowUV += context_roi_size.width)
             {
                 float* dst = (float*)((unsigned char*)pdst + y * dst_step);
-                unsigned short* src_value = (unsigned short*)psrc;
-                for (int x = 0; x < roi_size.width; ++x, rowUV++, dst += dstPi_x)
+                const unsigned short* src = (const unsigned short*)((const unsigned char*)psrc + y * src_step);
+                if(camera_dst)
                 {
-                    if (src_value[x] == 0)
-                    {
-                        if(camera_dst)
-                        {
-                            dst[0] = -1.f;
-                            dst[1] = -1.f;
-                        }
-                        else
-                        {
-                            dst[0] = 0.f;
-                            dst[1] = 0.f;
-                            dst[2] = 0.f;
-                        }
-                        continue;
-                    }
-
-                    zPlane = static_cast<float>(src_value[x]);
-                    dst[0] = rowUV->x * zPlane;
-                    dst[1] = rowUV->y * zPlane;
-
-                    if(rotation)
-                    {
-                        float tmp0 = rotation[0] * dst[0] + rotation[1] * dst[1] + rotation[2] * zPlane;
-                        float tmp1 = rotation[3] * dst[0] + rotation[4] * dst[1] + rotation[5] * zPlane;
-                        zPlane     = rotation[6] * dst[0] + rotation[7] * dst[1] + rotation[8] * zPlane;
-                        dst[0] = tmp0;
-                        dst[1] = tmp1;
-                    }
+                    if(project_depth_row_to_uv(src, rowUV, roi.width, rot, trans, distortion, camera_dst, dst))
+                        sts = status::status_handle_invalid;
+                }
+                else if(rotation || translation)
+                {
+                    project_depth_row_to_transformed_vertices(src, rowUV, roi.width, rot, trans, dst);
+                }
+                else
+                {
+                    project_depth_row_to_vertices(src, rowUV, roi.width, dst);
+                }
+            }
+            return sts;
+        }
 
-                    if(translation)
-                    {
-                        dst[0] += translation[0];
-                        dst[1] += translation[1];
-                        zPlane += translation[2];
-                    }
+        status REFCALL math_projection::rs_vertices_roi_16u_c1c3r(const unsigned short *psrc, rect roi, int src_step, void *pdst, int dst_step,
+                vertex_format format, const projection_spec_32f *pspec)
+        {
+            RS_PROFILER_ZONE("math_projection::rs_vertices_roi_16u_c1c3r");
+            if(psrc == 0 || pdst == 0 || pspec == 0) return status::status_handle_invalid;
+            if (roi.width <= 0 || roi.height <= 0) return status::status_data_not_initialized;
 
-                    if(camera_dst)
-                    {
-                        if ( abs(zPlane) <= MINABS_32F )
-                        {
-                            dst[0] = dst[1] = 0.f;
-                            sts = status::status_handle_invalid;
-                            continue;
-                        }
+            sizeI32 context_roi_size = ((sizeI32*)pspec)[0];
+            if (roi.x < 0 || roi.y < 0 || roi.x + roi.width > context_roi_size.width || roi.y + roi.height > context_roi_size.height)
+                return status::status_param_unsupported;
 
-                        u = v = 1.f / zPlane;
-                        u *= dst[0];
-                        v *= dst[1];
+            const pointF32 *rowUV = (const pointF32*)((unsigned char*)pspec + sizeof(float) * 16) + roi.y * context_roi_size.width + roi.x;
+            for (int y = 0; y < roi.height; ++y, rowUV += context_roi_size.width)
+            {
+                void* dst = (unsigned char*)pdst + y * dst_step;
+                const unsigned short* src = (const unsigned short*)((const unsigned char*)psrc + y * src_step);
+                switch(format)
+                {
+                    case vertex_format::xyz32f:
+                        project_depth_row_to_vertices(src, rowUV, roi.width, (float*)dst);
+                        break;
+                    case vertex_format::xyz16f:
+                        project_depth_row_to_half_vertices(src, rowUV, roi.width, (uint16_t*)dst);
+                        break;
+                    case vertex_format::xyz16s:
+                        project_depth_row_to_int16_vertices(src, rowUV, roi.width, (int16_t*)dst);
+                        break;
+                    default:
+                        return status::status_param_unsupported;
+                }
+            }
+            return status::status_no_error;
+        }
 
-                        if( distortion_dst )
-                        {
-                            double r2  = u * u + v * v;
-                            double r4  = r2 * r2;
-                            double fDist = 1.f + distortion_dst[0] * r2 + distortion_dst[1] * r4 + distortion_dst[4] * r2 * r4;
-                            if( distortion_dst[2] != 0 )
-                            {
-                                r4  = 2.f * u * v;
-                                u = u * fDist + distortion_dst[2] * r4 + distortion_dst[3] * (r2 + 2.f * u * u);
-                                v = v * fDist + distortion_dst[3] * r4 + distortion_dst[2] * (r2 + 2.f * v * v);
-                            }
-                            else
-                            {
-                                u *= fDist;
-                                v *= fDist;
-                            }
-                        }
+        status REFCALL math_projection::rs_vertices_roi_16u_c1c3r_q16(const unsigned short *psrc, rect roi, int src_step, void *pdst, int dst_step,
+                vertex_format format, const pointI32 *prays, sizeI32 rays_size)
+        {
+            RS_PROFILER_ZONE("math_projection::rs_vertices_roi_16u_c1c3r_q16");
+            if(psrc == 0 || pdst == 0 || prays == 0) return status::status_handle_invalid;
+            if (roi.width <= 0 || roi.height <= 0) return status::status_data_not_initialized;
+            if (roi.x < 0 || roi.y < 0 || roi.x + roi.width > rays_size.width || roi.y + roi.height > rays_size.height)
+                return status::status_param_unsupported;
+
+            const pointI32 *rowRays = prays + roi.y * rays_size.width + roi.x;
+            for (int y = 0; y < roi.height; ++y, rowRays += rays_size.width)
+            {
+                void* dst = (unsigned char*)pdst + y * dst_step;
+                const unsigned short* src = (const unsigned short*)((const unsigned char*)psrc + y * src_step);
+                switch(format)
+                {
+                    case vertex_format::xyz32f:
+                        project_depth_row_to_fixed_point_vertices(src, rowRays, roi.width, (float*)dst);
+                        break;
+                    case vertex_format::xyz16f:
+                        project_depth_row_to_fixed_point_half_vertices(src, rowRays, roi.width, (uint16_t*)dst);
+                        break;
+                    case vertex_format::xyz16s:
+                        project_depth_row_to_fixed_point_int16_vertices(src, rowRays, roi.width, (int16_t*)dst);
+                        break;
+                    default:
+                        return status::status_param_unsupported;
+                }
+            }
+            return status::status_no_error;
+        }
 
-                        dst[0] = static_cast<float>(u * camera_dst[0] + camera_dst[1]);
-                        dst[1] = static_cast<float>(v * camera_dst[2] + camera_dst[3]);
-                    }
-                    else
-                    {
-                        dst[2] = zPlane;
-                    }
+        status REFCALL math_projection::rs_uvmap_roi_16u32f_c1c2r_q16(const unsigned short *psrc, rect roi, int src_step, float *pdst, int dst_step,
+                float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4], const pointI32 *prays, sizeI32 rays_size)
+        {
+            RS_PROFILER_ZONE("math_projection::rs_uvmap_roi_16u32f_c1c2r_q16");
+            if(psrc == 0 || pdst == 0 || camera_dst == 0 || prays == 0) return status::status_handle_invalid;
+            if (roi.width <= 0 || roi.height <= 0) return status::status_data_not_initialized;
+            if (roi.x < 0 || roi.y < 0 || roi.x + roi.width > rays_size.width || roi.y + roi.height > rays_size.height)
+                return status::status_param_unsupported;
+
+            //the parameters are converted once per call, missing transformations are replaced by the identity
+            int64_t rot[9] = { FIXED_POINT_ONE, 0, 0, 0, FIXED_POINT_ONE, 0, 0, 0, FIXED_POINT_ONE };
+            int64_t trans[3] = { 0, 0, 0 };
+            int64_t dist[5] = { 0, 0, 0, 0, 0 };
+            int64_t camera[4];
+            if(rotation)
+                for (int i = 0; i < 9; ++i) rot[i] = float_to_q16(rotation[i]);
+            if(translation)
+                for (int i = 0; i < 3; ++i) trans[i] = float_to_q16(translation[i]);
+            for (int i = 0; i < 4; ++i) camera[i] = float_to_q16(camera_dst[i]);
+            //the tangential coefficients are ignored unless the first one is set
+            if(distortion_dst)
+            {
+                dist[0] = float_to_q16(distortion_dst[0]);
+                dist[1] = float_to_q16(distortion_dst[1]);
+                dist[4] = float_to_q16(distortion_dst[4]);
+                if(distortion_dst[2] != 0)
+                {
+                    dist[2] = float_to_q16(distortion_dst[2]);
+                    dist[3] = float_to_q16(distortion_dst[3]);
                 }
-                psrc  = (unsigned short*)((unsigned char*)psrc + src_step);
+            }
+
+            status sts = status::status_no_error;
+            const pointI32 *rowRays = prays + roi.y * rays_size.width + roi.x;
+            for (int y = 0; y < roi.height; ++y, rowRays += rays_size.width)
+            {
+                float* dst = (float*)((unsigned char*)pdst + y * dst_step);
+                const unsigned short* src = (const unsigned short*)((const unsigned char*)psrc + y * src_step);
+                if(project_depth_row_to_fixed_point_uv(src, rowRays, roi.width, rot, trans, distortion_dst ? dist : nullptr, camera, dst))
+                    sts = status::status_handle_invalid;
             }
             return sts;
         }
 
+        status REFCALL math_projection::rs_valid_vertices_16u32f_c1c3r(const unsigned short *psrc, sizeI32 roi_size, int src_step, float *pdst,
+                int *pindices, int *pcount, const projection_spec_32f *pspec)
+        {
+            RS_PROFILER_ZONE("math_projection::rs_valid_vertices_16u32f_c1c3r");
+            if(psrc == 0 || pdst == 0 || pindices == 0 || pcount == 0 || pspec == 0) return status::status_handle_invalid;
+            if (roi_size.width <= 0 || roi_size.height <= 0) return status::status_data_not_initialized;
+
+            sizeI32 context_roi_size = ((sizeI32*)pspec)[0];
+            if (roi_size.width != context_roi_size.width || roi_size.height != context_roi_size.height) return status::status_param_unsupported;
+
+            const pointF32 *rowUV = (const pointF32*)((unsigned char*)pspec + sizeof(float) * 16);
+            int count = 0;
+            for (int y = 0; y < roi_size.height; ++y, rowUV += roi_size.width)
+            {
+                const unsigned short* src = (const unsigned short*)((const unsigned char*)psrc + y * src_step);
+                count += project_depth_row_to_valid_vertices(src, rowUV, roi_size.width, y * roi_size.width, pdst + 3 * count, pindices + count);
+            }
+            *pcount = count;
+            return status::status_no_error;
+        }
+
+        status REFCALL math_projection::rs_voxelize_16u_c1r(const unsigned short *psrc, sizeI32 roi_size, int src_step, voxel_grid &grid,
+                const projection_spec_32f *pspec)
+        {
+            RS_PROFILER_ZONE("math_projection::rs_voxelize_16u_c1r");
+            if(psrc == 0 || pspec == 0) return status::status_handle_invalid;
+            if (roi_size.width <= 0 || roi_size.height <= 0) return status::status_data_not_initialized;
+
+            sizeI32 context_roi_size = ((sizeI32*)pspec)[0];
+            if (roi_size.width != context_roi_size.width || roi_size.height != context_roi_size.height) return status::status_param_unsupported;
+
+            //the vertices of a row are projected to a cache resident buffer and binned, the vertices of the image are never written
+            std::vector<float> row_vertices(3 * roi_size.width);
+            std::vector<int32_t> row_indices(roi_size.width);
+            const pointF32 *rowUV = (const pointF32*)((unsigned char*)pspec + sizeof(float) * 16);
+            for (int y = 0; y < roi_size.height; ++y, rowUV += roi_size.width)
+            {
+                const unsigned short* src = (const unsigned short*)((const unsigned char*)psrc + y * src_step);
+                const int count = project_depth_row_to_valid_vertices(src, rowUV, roi_size.width, 0, row_vertices.data(), row_indices.data());
+                for (int i = 0; i < count; ++i)
+                    grid.add(row_vertices[3 * i + 0], row_vertices[3 * i + 1], row_vertices[3 * i + 2]);
+            }
+            return status::status_no_error;
+        }
+
+        status REFCALL math_projection::rs_projection_get_rays_32f(const projection_spec_32f *pspec, pointF32 *prays)
+        {
+            if(pspec == 0 || prays == 0) return status::status_handle_invalid;
+            sizeI32 context_roi_size = ((sizeI32*)pspec)[0];
+            memcpy(prays, (unsigned char*)pspec + sizeof(float) * 16, sizeof(pointF32) * context_roi_size.width * context_roi_size.height);
+            return status::status_no_error;
+        }
+
+        status REFCALL math_projection::rs_projection_get_rays_32s_q16(const projection_spec_32f *pspec, pointI32 *prays)
+        {
+            if(pspec == 0 || prays == 0) return status::status_handle_invalid;
+            sizeI32 context_roi_size = ((sizeI32*)pspec)[0];
+            const pointF32 *rays = (const pointF32*)((unsigned char*)pspec + sizeof(float) * 16);
+            const int count = context_roi_size.width * context_roi_size.height;
+            for (int i = 0; i < count; ++i)
+            {
+                prays[i].x = float_to_q16(rays[i].x);
+                prays[i].y = float_to_q16(rays[i].y);
+            }
+            return status::status_no_error;
+        }
+
         //Added
         status REFCALL math_projection::rs_projection_get_size_32f(sizeI32 roi_size, int *pspec_size)
         {
@@ -328,6 +1032,7 @@ namespace rs
                 int xy_map_step, unsigned short* pdst, sizeI32 dst_roi_size,
                 int dst_step, int interpolation_type, unsigned short default_value)
         {
+            RS_PROFILER_ZONE("math_projection::rs_remap_16u_c1r");
             int x, y, sx, sy;
             if (psrc == 0 || pdst == 0 || pxy_map == 0) return status::status_handle_invalid;
             if (src_size.width <= 0 || src_size.height <= 0 || dst_roi_size.width <= 0 || dst_roi_size.height <= 0) return status::status_data_not_initialized;
@@ -355,42 +1060,239 @@ namespace rs
             return status::status_no_error;
         }
 
+        status REFCALL math_projection::rs_remap_table_get_size(sizeI32 dst_size, int *ptable_size)
+        {
+            if (ptable_size == 0) return status::status_handle_invalid;
+            if (dst_size.width <= 0 || dst_size.height <= 0) return status::status_data_not_initialized;
+
+            (*ptable_size) = static_cast<int>(sizeof(remap_table_header));
+            (*ptable_size) += dst_size.width * dst_size.height * static_cast<int>(sizeof(int32_t) + 2 * sizeof(uint16_t));
+            return status::status_no_error;
+        }
+
+        status REFCALL math_projection::rs_remap_table_init_32f(const float *pxy_map, int xy_map_step, sizeI32 dst_size, sizeI32 src_size, int src_step,
+                int interpolation_type, remap_table *ptable)
+        {
+            RS_PROFILER_ZONE("math_projection::rs_remap_table_init_32f");
+            if (pxy_map == 0 || ptable == 0) return status::status_handle_invalid;
+            if (src_size.width <= 0 || src_size.height <= 0 || dst_size.width <= 0 || dst_size.height <= 0) return status::status_data_not_initialized;
+            if (interpolation_type != 0 && interpolation_type != 1) return status::status_data_not_initialized;
+            //the bilinear samples are two pixels apart at most
+            if (interpolation_type == 1 && (src_size.width < 2 || src_size.height < 2)) return status::status_param_unsupported;
+            if (src_step < src_size.width) return status::status_param_unsupported;
+
+            remap_table_header *header = (remap_table_header*)ptable;
+            header->src_size = src_size;
+            header->src_step = src_step;
+            header->dst_size = dst_size;
+            header->interpolation_type = interpolation_type;
+            int32_t *offsets = (int32_t*)(header + 1);
+            uint16_t *weights = (uint16_t*)(offsets + dst_size.width * dst_size.height);
+            auto build_row = interpolation_type == 0 ? build_nearest_remap_table_row : build_linear_remap_table_row;
+            for (int y = 0; y < dst_size.height; y++)
+            {
+                const float *xy_row = (const float*)((const unsigned char*)pxy_map + y * xy_map_step);
+                build_row(xy_row, dst_size.width, src_size.width, src_size.height, src_step,
+                          offsets + y * dst_size.width, weights + 2 * y * dst_size.width);
+            }
+            return status::status_no_error;
+        }
+
+        status REFCALL math_projection::rs_remap_table_8u_c1r(const unsigned char* psrc, sizeI32 src_size, int src_step, const remap_table *ptable,
+                unsigned char* pdst, int dst_step, unsigned char default_value)
+        {
+            RS_PROFILER_ZONE("math_projection::rs_remap_table_8u_c1r");
+            if (psrc == 0 || pdst == 0 || ptable == 0) return status::status_handle_invalid;
+            const remap_table_header *header = (const remap_table_header*)ptable;
+            //the offsets of the table are of its source
+            if (src_size.width != header->src_size.width || src_size.height != header->src_size.height || src_step != header->src_step)
+                return status::status_param_unsupported;
+
+            const sizeI32 dst_size = header->dst_size;
+            const int interpolation_type = header->interpolation_type;
+            const int32_t *offsets = (const int32_t*)(header + 1);
+            const uint16_t *weights = (const uint16_t*)(offsets + dst_size.width * dst_size.height);
+            //the rows are independent, each band remaps its own rows
+            for_each_rows_band(dst_size.height, MIN_BAND_ROWS, [=](int first_row, int end_row)
+            {
+                for (int y = first_row; y < end_row; y++)
+                {
+                    if (interpolation_type == 0)
+                        remap_row_8u_nearest(psrc, offsets + y * dst_size.width, dst_size.width, pdst + y * dst_step, default_value);
+                    else
+                        remap_row_8u_linear(psrc, src_step, offsets + y * dst_size.width, weights + 2 * y * dst_size.width, dst_size.width,
+                                            pdst + y * dst_step, default_value);
+                }
+            });
+            return status::status_no_error;
+        }
+
+        status REFCALL math_projection::rs_fisheye_undistort_map_32f_c2r(sizeI32 map_size, float camera_dst[4], float camera_fisheye[4], float fov,
+                float *pxy_map, int xy_map_step)
+        {
+            RS_PROFILER_ZONE("math_projection::rs_fisheye_undistort_map_32f_c2r");
+            if (camera_dst == 0 || camera_fisheye == 0 || pxy_map == 0) return status::status_handle_invalid;
+            if (map_size.width <= 0 || map_size.height <= 0) return status::status_data_not_initialized;
+            if (!(fov > 0.f && fov < 3.1415926f) || camera_dst[0] == 0.f || camera_dst[2] == 0.f) return status::status_param_unsupported;
+
+            for (int y = 0; y < map_size.height; y++)
+                fisheye_undistort_row(y, map_size.width, camera_dst, camera_fisheye, fov, (float*)((unsigned char*)pxy_map + y * xy_map_step));
+            return status::status_no_error;
+        }
+
+        status REFCALL math_projection::rs_fisheye_projection_32f(const float *psrc, float *pdst, int length, float camera_fisheye[4], float fov)
+        {
+            if (psrc == 0 || pdst == 0 || camera_fisheye == 0) return status::status_handle_invalid;
+            if (length <= 0) return status::status_data_not_initialized;
+            if (!(fov > 0.f && fov < 3.1415926f)) return status::status_param_unsupported;
+
+            const float fov_tan = std::tan(fov * 0.5f);
+            for (int i = 0; i < length; i++, psrc += 3, pdst += 2)
+            {
+                if (psrc[2] < MINABS_32F)
+                {
+                    pdst[0] = pdst[1] = -1.f;
+                    continue;
+                }
+                const float x = psrc[0] / psrc[2], y = psrc[1] / psrc[2];
+                const float scale = fisheye_distortion_scale(std::sqrt(x * x + y * y), fov, fov_tan);
+                pdst[0] = x * scale * camera_fisheye[0] + camera_fisheye[1];
+                pdst[1] = y * scale * camera_fisheye[2] + camera_fisheye[3];
+            }
+            return status::status_no_error;
+        }
+
+        status REFCALL math_projection::rs_fisheye_unprojection_32f(const float *psrc, float *pdst, int length, float camera_fisheye[4], float fov)
+        {
+            if (psrc == 0 || pdst == 0 || camera_fisheye == 0) return status::status_handle_invalid;
+            if (length <= 0) return status::status_data_not_initialized;
+            if (!(fov > 0.f && fov < 3.1415926f) || camera_fisheye[0] == 0.f || camera_fisheye[2] == 0.f) return status::status_param_unsupported;
+
+            //the undistorted radius r = tan(rd fov) / (2 tan(fov / 2)), whose limit ratio at the optical axis is fov / (2 tan(fov / 2)).
+            //a distorted radius at or beyond fov / (pi / 2) is a direction at or behind the camera plane, which the model doesn't map
+            const float fov_tan = std::tan(fov * 0.5f);
+            const float max_angle = 1.5707963f;
+            for (int i = 0; i < length; i++, psrc += 3, pdst += 3)
+            {
+                const float xd = (psrc[0] - camera_fisheye[1]) / camera_fisheye[0];
+                const float yd = (psrc[1] - camera_fisheye[3]) / camera_fisheye[2];
+                const float rd = std::sqrt(xd * xd + yd * yd);
+                const float z = psrc[2];
+                if (rd * fov >= max_angle)
+                {
+                    pdst[0] = pdst[1] = pdst[2] = 0.f;
+                    continue;
+                }
+                const float scale = rd > MINABS_32F ? std::tan(rd * fov) / (2.f * fov_tan * rd) : fov / (2.f * fov_tan);
+                pdst[0] = xd * scale * z;
+                pdst[1] = yd * scale * z;
+                pdst[2] = z;
+            }
+            return status::status_no_error;
+        }
+
         //Added
         status REFCALL math_projection::rs_uvmap_filter_32f_c2ir(float *psrc_dst, int srcdst_step, sizeI32 roi_size,
                 const unsigned short *pdepth, int depth_step, unsigned short invalid_depth)
         {
-            pointF32 *uvTest;
-            int y, x;
-            for( y = 0; y < roi_size.height; y ++ )
+            RS_PROFILER_ZONE("math_projection::rs_uvmap_filter_32f_c2ir");
+            //the rows are independent, each band filters its own rows
+            for_each_rows_band(roi_size.height, MIN_BAND_ROWS, [=](int first_row, int end_row)
             {
-                if (pdepth != NULL)
+                for (int y = first_row; y < end_row; y++)
                 {
-                    for ( x = 0; x < roi_size.width; x++ )
+                    pointF32 *uv_row = (pointF32*)((unsigned char*)psrc_dst + y * srcdst_step);
+                    pointF32 *uvTest;
+                    if (pdepth != NULL)
                     {
-                        uvTest = ((pointF32*)psrc_dst) + x;
-                        if( ((unsigned short*)pdepth)[x] > 0 && ((unsigned short*)pdepth)[x] != invalid_depth
-                                && uvTest->x >= 0.f && uvTest->x < 1.f && uvTest->y >= 0.f && uvTest->y < 1.f )
+                        const unsigned short *depth_row = (const unsigned short*)((const unsigned char*)pdepth + y * depth_step);
+                        for (int x = 0; x < roi_size.width; x++)
                         {
-                            continue;
+                            uvTest = uv_row + x;
+                            if( depth_row[x] > 0 && depth_row[x] != invalid_depth
+                                    && uvTest->x >= 0.f && uvTest->x < 1.f && uvTest->y >= 0.f && uvTest->y < 1.f )
+                            {
+                                continue;
+                            }
+                            uvTest->x = uvTest->y = -1.f;
+                        }
+                    }
+                    else
+                    {
+                        for (int x = 0; x < roi_size.width; x++)
+                        {
+                            uvTest = uv_row + x;
+                            if( uvTest->x >= 0.f && uvTest->x < 1.f && uvTest->y >= 0.f && uvTest->y < 1.f )
+                            {
+                                continue;
+                            }
+                            uvTest->x = uvTest->y = -1.f;
                         }
-                        uvTest->x = uvTest->y = -1.f;
                     }
-                    pdepth  = (const unsigned short*)((const unsigned char*)pdepth + depth_step);
                 }
-                else
+            });
+            return status::status_no_error;
+        }
+
+        status REFCALL math_projection::rs_depth_splat_16u_c1r(const unsigned short *psrc, int src_step, const float *puvmap, int uvmap_step, rect roi,
+                unsigned short *pdst, int dst_step, sizeI32 dst_size, int splat_size)
+        {
+            RS_PROFILER_ZONE("math_projection::rs_depth_splat_16u_c1r");
+            if (psrc == 0 || puvmap == 0 || pdst == 0) return status::status_handle_invalid;
+            if (roi.width <= 0 || roi.height <= 0 || dst_size.width <= 0 || dst_size.height <= 0 || splat_size <= 0) return status::status_data_not_initialized;
+
+            //the splat of a pixel covers the destination pixels from its pixel minus before to its pixel plus after
+            const int before = (splat_size - 1) / 2;
+            const int after = splat_size / 2;
+            const float width = static_cast<float>(dst_size.width);
+            const float height = static_cast<float>(dst_size.height);
+
+            //the destination rows each source row is splatted to, so a band skips the source rows which don't reach it
+            std::vector<std::pair<int, int>> rows_range(roi.height, std::make_pair(dst_size.height, -1));
+            for (int y = 0; y < roi.height; ++y)
+            {
+                const pointF32* uv = (const pointF32*)((const unsigned char*)puvmap + (roi.y + y) * uvmap_step) + roi.x;
+                for (int x = 0; x < roi.width; ++x)
+                {
+                    if (uv[x].x < 0.f) continue;
+                    const int row = static_cast<int>(uv[x].y * height);
+                    rows_range[y].first = std::min(rows_range[y].first, row - before);
+                    rows_range[y].second = std::max(rows_range[y].second, row + after);
+                }
+            }
+
+            //each band owns its destination rows, and the z test of a destination pixel is done by its band only, so the bands
+            //don't share a z buffer and the result doesn't depend on the bands
+            for_each_rows_band(dst_size.height, MIN_BAND_ROWS, [&](int first_row, int end_row)
+            {
+                for (int y = 0; y < roi.height; ++y)
                 {
-                    for ( x = 0; x < roi_size.width; x++ )
+                    if (rows_range[y].second < first_row || rows_range[y].first >= end_row) continue;
+                    const unsigned short* src = (const unsigned short*)((const unsigned char*)psrc + (roi.y + y) * src_step) + roi.x;
+                    const pointF32* uv = (const pointF32*)((const unsigned char*)puvmap + (roi.y + y) * uvmap_step) + roi.x;
+                    for (int x = 0; x < roi.width; ++x)
                     {
-                        uvTest = ((pointF32*)psrc_dst) + x;
-                        if( uvTest->x >= 0.f && uvTest->x < 1.f && uvTest->y >= 0.f && uvTest->y < 1.f )
+                        const unsigned short z = src[x];
+                        if (uv[x].x < 0.f || z == 0) continue;
+                        const int column = static_cast<int>(uv[x].x * width);
+                        const int row = static_cast<int>(uv[x].y * height);
+                        const int splat_first_row = std::max(first_row, row - before);
+                        const int splat_end_row = std::min(end_row, row + after + 1);
+                        const int splat_first_column = std::max(0, column - before);
+                        const int splat_end_column = std::min(dst_size.width, column + after + 1);
+                        for (int splat_row = splat_first_row; splat_row < splat_end_row; ++splat_row)
                         {
-                            continue;
+                            unsigned short* dst = (unsigned short*)((unsigned char*)pdst + splat_row * dst_step);
+                            for (int splat_column = splat_first_column; splat_column < splat_end_column; ++splat_column)
+                            {
+                                //the nearest surface hides the surfaces behind it
+                                if (dst[splat_column] == 0 || z < dst[splat_column])
+                                    dst[splat_column] = z;
+                            }
                         }
-                        uvTest->x = uvTest->y = -1.f;
                     }
                 }
-                psrc_dst = (float*)((unsigned char*)psrc_dst + srcdst_step);
-            }
+            });
             return status::status_no_error;
         }
 
@@ -398,21 +1300,35 @@ namespace rs
         status REFCALL math_projection::rs_uvmap_invertor_32f_c2r(const float *psrc, int src_step, sizeI32 src_size, rect src_roi,
                 float *pdst, int dst_step, sizeI32 dst_size, int units_is_relative, pointF32 threshold)
         {
+            RS_PROFILER_ZONE("math_projection::rs_uvmap_invertor_32f_c2r");
             rect uvinv_roi = {0, 0, dst_size.width, dst_size.height};
-            int i, j;
-            float *dst = pdst;
 
-            for (i = 0; i < dst_size.height; ++i)
+            //the inverse map is split to horizontal bands, each band scans the whole uvmap and fills only its own rows.
+            //the pixels of a band are written in the same order as in a single pass, so the result doesn't depend on the bands
+            status sts = status::status_no_error;
+            std::mutex sts_mutex;
+            for_each_rows_band(dst_size.height, MIN_BAND_ROWS, [&](int first_row, int end_row)
             {
-                for (j = 0; j < dst_size.width * 2; ++j)
+                for (int i = first_row; i < end_row; ++i)
+                {
+                    float *dst = (float*)((unsigned char*)pdst + i * dst_step);
+                    for (int j = 0; j < dst_size.width * 2; ++j)
+                    {
+                        dst[j] = -1.f;
+                    }
+                }
+                status band_sts = r_own_iuvmap_invertor((pointF32*)psrc, src_step, src_size, src_roi, (pointF32*)pdst, dst_step,
+                                                        dst_size, uvinv_roi, units_is_relative, threshold, first_row, end_row - 1);
+                if (band_sts != status::status_no_error)
                 {
-                    dst[j] = -1.f;
+                    std::lock_guard<std::mutex> lock(sts_mutex);
+                    sts = band_sts;
                 }
-                dst = (float*)((unsigned char*)dst + dst_step);
-            }
-            return r_own_iuvmap_invertor((pointF32*)psrc, src_step, src_size, src_roi, (pointF32*)pdst, dst_step, dst_size, uvinv_roi, units_is_relative, threshold);
+            });
+            return sts;
         }
 
+        //Added
         status REFCALL math_projection::rs_qr_decomp_m_64f(const double* psrc, int src_stride1, int src_stride2, double* pbuffer,
                 double* pdst, int dststride1, int dststride2, int width, int height)
         {
@@ -622,8 +1538,11 @@ namespace rs
             return maxV;
         }
 
+        //fills the rows [band_ymin, band_ymax] of the inverse map. the triangles edge functions are accumulated from the first row
+        //of each triangle inside uvinv_roi, as when the whole roi is filled at once, so the bands results are identical to a single pass
         status r_own_iuvmap_invertor ( const pointF32 *uvmap, int uvmap_step, sizeI32 uvmap_size, rect uvmap_roi,
-                                       pointF32 *uvInv, int uvinv_step, sizeI32 uvinv_size, rect uvinv_roi, int uvinv_units_is_relative, pointF32 threshold )
+                                       pointF32 *uvInv, int uvinv_step, sizeI32 uvinv_size, rect uvinv_roi, int uvinv_units_is_relative, pointF32 threshold,
+                                       int band_ymin, int band_ymax )
         {
             typedef struct
             {
@@ -742,6 +1661,8 @@ namespace rs
                         ymax = (int)fymax;
                         if (ymin < ymin_uvinv_roi) ymin = ymin_uvinv_roi;
                         if (ymax > ymax_uvinv_roi) ymax = ymax_uvinv_roi;
+                        if (ymax < band_ymin || ymin > band_ymax) continue;
+                        if (ymax > band_ymax) ymax = band_ymax;
 
                         // TriangleInteriorTest
                         if (p0[0] > p1[0]) std::swap( p0, p1 );
@@ -776,7 +1697,8 @@ namespace rs
                             e1 = e0;
 
                             uvinv_ptr = (pointF32*)puvinv;
-                            for (i_x=xmin ; i_x <= xmax ; ++i_x)
+                            // the rows above the band only advance the edge functions
+                            for (i_x = (i_y < band_ymin) ? xmax + 1 : xmin ; i_x <= xmax ; ++i_x)
                             {
                                 a1 -= dy0;
                                 b1 -= dy1;
@@ -855,6 +1777,8 @@ namespace rs
                         ymax = (int)fymax;
                         if (ymin < ymin_uvinv_roi) ymin = ymin_uvinv_roi;
                         if (ymax > ymax_uvinv_roi) ymax = ymax_uvinv_roi;
+                        if (ymax < band_ymin || ymin > band_ymax) continue;
+                        if (ymax > band_ymax) ymax = band_ymax;
 
                         // TriangleInteriorTest
                         dx0 = p1[0] - p0[0];
@@ -876,7 +1800,8 @@ namespace rs
                             c1 = c0;
 
                             uvinv_ptr = (pointF32*)puvinv;
-                            for (i_x=xmin ; i_x <= xmax ; ++i_x)
+                            // the rows above the band only advance the edge functions
+                            for (i_x = (i_y < band_ymin) ? xmax + 1 : xmin ; i_x <= xmax ; ++i_x)
                             {
                                 a1 -= dy0;
                                 b1 -= dy1;
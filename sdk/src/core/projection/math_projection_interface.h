@@ -15,6 +15,8 @@ namespace rs
 
         struct projection_spec_32f;
         typedef struct projection_spec_32f projection_spec_32f;
+        struct remap_table;
+        class voxel_grid;
 
         class math_projection
         {
@@ -27,22 +29,90 @@ namespace rs
                     float inv_distortion_src[5], float rotation[9], float translation[3],
                     float distortion_dst[5], float camera_dst[4]);
 
+            // projects camera points to the destination camera pixels, as rs_3d_array_projection_32f, with the points coordinates and the
+            // pixels coordinates in separate arrays. the camera is required
+            rs::core::status REFCALL rs_3d_array_projection_32f_p3p2(const float *psrc_x, const float *psrc_y, const float *psrc_z,
+                    float *pdst_u, float *pdst_v, int length, float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4]);
+
             rs::core::status REFCALL rs_projection_16u32f_c1cxr(const unsigned short *psrc, rs::core::sizeI32 roi_size, int src_step, float *pdst, int dst_step,
                     float rotation[9], float translation[3], float distortion_dst[5],
                     float camera_dst[4], const projection_spec_32f *pspec);
 
+            // projects the roi of a depth image of the spec size, psrc and pdst point to the roi origin
+            rs::core::status REFCALL rs_projection_roi_16u32f_c1cxr(const unsigned short *psrc, rs::core::rect roi, int src_step, float *pdst, int dst_step,
+                    float rotation[9], float translation[3], float distortion_dst[5],
+                    float camera_dst[4], const projection_spec_32f *pspec);
+
+            // projects the roi of a depth image of the spec size to vertices in the depth camera coordinates, in the given format.
+            // psrc and pdst point to the roi origin
+            rs::core::status REFCALL rs_vertices_roi_16u_c1c3r(const unsigned short *psrc, rs::core::rect roi, int src_step, void *pdst, int dst_step,
+                    rs::core::vertex_format format, const projection_spec_32f *pspec);
+
+            // fixed point rs_vertices_roi_16u_c1c3r, with the Q16 rays of rs_projection_get_rays_32s_q16 of the rays size
+            rs::core::status REFCALL rs_vertices_roi_16u_c1c3r_q16(const unsigned short *psrc, rs::core::rect roi, int src_step, void *pdst, int dst_step,
+                    rs::core::vertex_format format, const pointI32 *prays, rs::core::sizeI32 rays_size);
+
+            // fixed point rs_projection_roi_16u32f_c1cxr to the destination camera pixels, with the Q16 rays of rs_projection_get_rays_32s_q16
+            // of the rays size. the parameters are converted to Q16 once per call, the camera is required
+            rs::core::status REFCALL rs_uvmap_roi_16u32f_c1c2r_q16(const unsigned short *psrc, rs::core::rect roi, int src_step, float *pdst, int dst_step,
+                    float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4], const pointI32 *prays, rs::core::sizeI32 rays_size);
+
+            // projects the nonzero depth pixels of a depth image of the spec size to packed vertices, and writes the pixel index of each vertex.
+            // pdst and pindices have room for a vertex per pixel
+            rs::core::status REFCALL rs_valid_vertices_16u32f_c1c3r(const unsigned short *psrc, rs::core::sizeI32 roi_size, int src_step, float *pdst,
+                    int *pindices, int *pcount, const projection_spec_32f *pspec);
+
+            // projects the nonzero depth pixels of a depth image of the spec size and adds the vertices to the voxel grid
+            rs::core::status REFCALL rs_voxelize_16u_c1r(const unsigned short *psrc, rs::core::sizeI32 roi_size, int src_step, voxel_grid &grid,
+                    const projection_spec_32f *pspec);
+
+            // copies the ray of each pixel of the spec size, the vertex of a pixel is its ray scaled by its depth
+            rs::core::status REFCALL rs_projection_get_rays_32f(const projection_spec_32f *pspec, pointF32 *prays);
+
+            // copies the rays of the spec size as Q16 fixed point, 16 fractional bits
+            rs::core::status REFCALL rs_projection_get_rays_32s_q16(const projection_spec_32f *pspec, pointI32 *prays);
+
             rs::core::status REFCALL rs_projection_get_size_32f(rs::core::sizeI32 roi_size, int *pspec_size);
 
             rs::core::status REFCALL rs_remap_16u_c1r(const unsigned short* psrc, rs::core::sizeI32 src_size, int src_step, const float* pxy_map,
                     int xy_map_step, unsigned short* pdst, rs::core::sizeI32 dstroi_size,
                     int dst_step, int interpolation_type, unsigned short default_value);
 
+            rs::core::status REFCALL rs_remap_table_get_size(rs::core::sizeI32 dst_size, int *ptable_size);
+
+            // precomputes the remap of a source of the size and step by the source coordinates of each destination pixel, as rs_remap_16u_c1r
+            // takes them. interpolation_type 0 takes the nearest source pixel and 1 interpolates the source pixels bilinearly
+            rs::core::status REFCALL rs_remap_table_init_32f(const float *pxy_map, int xy_map_step, rs::core::sizeI32 dst_size, rs::core::sizeI32 src_size,
+                    int src_step, int interpolation_type, remap_table *ptable);
+
+            // remaps an 8 bit image by a remap table of its size and step to the table destination size, the pixels outside of the source
+            // take the default value
+            rs::core::status REFCALL rs_remap_table_8u_c1r(const unsigned char* psrc, rs::core::sizeI32 src_size, int src_step, const remap_table *ptable,
+                    unsigned char* pdst, int dst_step, unsigned char default_value);
+
+            // builds the remap of a fisheye image of the f-theta model, whose field of view parameter is fov in radians, to a pinhole
+            // camera of the map size. each map pixel is the fisheye pixel of the pinhole pixel ray
+            rs::core::status REFCALL rs_fisheye_undistort_map_32f_c2r(rs::core::sizeI32 map_size, float camera_dst[4], float camera_fisheye[4], float fov,
+                    float *pxy_map, int xy_map_step);
+
+            // projects camera points to the pixels of a fisheye camera of the f-theta model, the points on or behind the camera plane give (-1, -1)
+            rs::core::status REFCALL rs_fisheye_projection_32f(const float *psrc, float *pdst, int length, float camera_fisheye[4], float fov);
+
+            // unprojects fisheye pixels and their depths to camera points, the pixels the f-theta model doesn't map to a ray in front of the
+            // camera give (0, 0, 0)
+            rs::core::status REFCALL rs_fisheye_unprojection_32f(const float *psrc, float *pdst, int length, float camera_fisheye[4], float fov);
+
             rs::core::status REFCALL rs_uvmap_filter_32f_c2ir(float *psrc_dst, int srcdst_step, rs::core::sizeI32 roi_size,
                     const unsigned short *pdepth, int depth_step, unsigned short invalid_depth);
 
             rs::core::status REFCALL rs_uvmap_invertor_32f_c2r(const float *psrc, int src_step, rs::core::sizeI32 src_size, rs::core::rect src_roi,
                     float *pdst, int dst_step, rs::core::sizeI32 dst_size, int units_is_relative, pointF32  threshold);
 
+            // forward maps the depth pixels of the roi to the destination pixels of their normalized uvmap coordinates, each depth pixel
+            // covers splat_size x splat_size destination pixels and the nearest depth is kept. psrc and puvmap point to the image origin
+            rs::core::status REFCALL rs_depth_splat_16u_c1r(const unsigned short *psrc, int src_step, const float *puvmap, int uvmap_step, rs::core::rect roi,
+                    unsigned short *pdst, int dst_step, rs::core::sizeI32 dst_size, int splat_size);
+
             rs::core::status REFCALL rs_qr_decomp_m_64f(const double*  psrc,  int src_stride1, int src_stride2,
                     double*  pbuffer,
                     double*  pdst,  int dststride1, int dststride2,
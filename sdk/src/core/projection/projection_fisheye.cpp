@@ -0,0 +1,186 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include "projection_fisheye.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            const float PI_32F = 3.14159265f;
+
+            //the intrinsics as the camera array of math_projection, fx, ppx, fy, ppy
+            void to_camera_array(const intrinsics & intrin, float camera[4])
+            {
+                camera[0] = intrin.fx;
+                camera[1] = intrin.ppx;
+                camera[2] = intrin.fy;
+                camera[3] = intrin.ppy;
+            }
+
+            bool is_8bit_format(pixel_format format)
+            {
+                return format == pixel_format::raw8 || format == pixel_format::y8;
+            }
+        }
+
+        fisheye_projection::fisheye_projection(const intrinsics & fisheye, const intrinsics & rectified) :
+            m_fisheye(fisheye),
+            m_rectified(rectified),
+            m_rectification_map(rectified.width * rectified.height),
+            m_remap_table_pitch(0),
+            m_image_buffer_pool(image_buffer_pool::create())
+        {
+            to_camera_array(m_fisheye, m_camera_fisheye);
+            to_camera_array(m_rectified, m_camera_rectified);
+            m_math_projection.rs_fisheye_undistort_map_32f_c2r({ m_rectified.width, m_rectified.height }, m_camera_rectified, m_camera_fisheye,
+                                                               m_fisheye.coeffs[0], reinterpret_cast<float*>(m_rectification_map.data()),
+                                                               m_rectified.width * static_cast<int>(sizeof(pointF32)));
+            //the fisheye images are usually packed, their table is built along with the map
+            query_remap_table(m_fisheye.width);
+        }
+
+        status fisheye_projection::project_camera_to_fisheye(int32_t npoints, point3dF32 *pos3d, pointF32 *pos_ij)
+        {
+            return m_math_projection.rs_fisheye_projection_32f(reinterpret_cast<const float*>(pos3d), reinterpret_cast<float*>(pos_ij), npoints,
+                                                               m_camera_fisheye, m_fisheye.coeffs[0]);
+        }
+
+        status fisheye_projection::project_fisheye_to_camera(int32_t npoints, point3dF32 *pos_ijz, point3dF32 *pos3d)
+        {
+            return m_math_projection.rs_fisheye_unprojection_32f(reinterpret_cast<const float*>(pos_ijz), reinterpret_cast<float*>(pos3d), npoints,
+                                                                 m_camera_fisheye, m_fisheye.coeffs[0]);
+        }
+
+        status fisheye_projection::query_rectified_intrinsics(intrinsics *rectified)
+        {
+            if (!rectified) return status_handle_invalid;
+            *rectified = m_rectified;
+            return status_no_error;
+        }
+
+        status fisheye_projection::query_rectification_map(pointF32 *map)
+        {
+            if (!map) return status_handle_invalid;
+            memcpy(map, m_rectification_map.data(), m_rectification_map.size() * sizeof(pointF32));
+            return status_no_error;
+        }
+
+        std::shared_ptr<const std::vector<uint8_t>> fisheye_projection::query_remap_table(int32_t src_pitch)
+        {
+            std::lock_guard<std::mutex> lock(m_remap_table_lock);
+            if (m_remap_table && m_remap_table_pitch == src_pitch)
+                return m_remap_table;
+
+            //the table is replaced rather than rebuilt in place, so a thread which remaps by the previous table keeps it
+            int table_size = 0;
+            sizeI32 rectified_size = { m_rectified.width, m_rectified.height };
+            if (m_math_projection.rs_remap_table_get_size(rectified_size, &table_size) < status_no_error)
+                return nullptr;
+            auto table = std::make_shared<std::vector<uint8_t>>(table_size);
+            if (m_math_projection.rs_remap_table_init_32f(reinterpret_cast<const float*>(m_rectification_map.data()),
+                                                          m_rectified.width * static_cast<int>(sizeof(pointF32)), rectified_size,
+                                                          { m_fisheye.width, m_fisheye.height }, src_pitch, 1,
+                                                          reinterpret_cast<remap_table*>(table->data())) < status_no_error)
+                return nullptr;
+            m_remap_table = table;
+            m_remap_table_pitch = src_pitch;
+            return m_remap_table;
+        }
+
+        bool fisheye_projection::rectify(image_interface *fisheye, uint8_t *data, int32_t pitch)
+        {
+            image_info info = fisheye->query_info();
+            if (info.width != m_fisheye.width || info.height != m_fisheye.height) return false;
+            const uint8_t *src = static_cast<const uint8_t*>(fisheye->query_data());
+            if (!src) return false;
+
+            if (is_8bit_format(info.format))
+            {
+                auto table = query_remap_table(info.pitch);
+                return table && m_math_projection.rs_remap_table_8u_c1r(src, { info.width, info.height }, info.pitch,
+                                                                        reinterpret_cast<const remap_table*>(table->data()),
+                                                                        data, pitch, 0) >= status_no_error;
+            }
+            if (info.format == pixel_format::y16)
+            {
+                return m_math_projection.rs_remap_16u_c1r(reinterpret_cast<const unsigned short*>(src), { info.width, info.height }, info.pitch,
+                                                          reinterpret_cast<const float*>(m_rectification_map.data()),
+                                                          m_rectified.width * static_cast<int>(sizeof(pointF32)),
+                                                          reinterpret_cast<unsigned short*>(data), { m_rectified.width, m_rectified.height },
+                                                          pitch, 0, 0) >= status_no_error;
+            }
+            return false;
+        }
+
+        image_interface* fisheye_projection::create_rectified_image(image_interface *fisheye)
+        {
+            if (!fisheye) return nullptr;
+            image_info info = fisheye->query_info();
+            if (!is_8bit_format(info.format) && info.format != pixel_format::y16) return nullptr;
+            image_info rectified_info = { m_rectified.width, m_rectified.height, info.format, m_rectified.width * get_pixel_size(info.format) };
+
+            release_interface* data_releaser = nullptr;
+            uint8_t* rectified_data = m_image_buffer_pool->acquire(rectified_info.height * rectified_info.pitch, data_releaser);
+            if (!rectify(fisheye, rectified_data, rectified_info.pitch))
+            {
+                data_releaser->release();
+                return nullptr;
+            }
+            return image_interface::create_instance_from_raw_data(&rectified_info,
+                                                                  {rectified_data, data_releaser},
+                                                                  fisheye->query_stream_type(),
+                                                                  image_interface::flag::any,
+                                                                  fisheye->query_time_stamp(),
+                                                                  fisheye->query_frame_number(),
+                                                                  fisheye->query_time_stamp_domain());
+        }
+
+        image_interface* fisheye_projection::create_rectified_image(image_interface *fisheye, uint8_t *data, int32_t pitch)
+        {
+            if (!fisheye || !data) return nullptr;
+            image_info info = fisheye->query_info();
+            if (!is_8bit_format(info.format) && info.format != pixel_format::y16) return nullptr;
+            if (pitch < m_rectified.width * get_pixel_size(info.format)) return nullptr;
+            image_info rectified_info = { m_rectified.width, m_rectified.height, info.format, pitch };
+
+            if (!rectify(fisheye, data, pitch))
+                return nullptr;
+            return image_interface::create_instance_from_raw_data(&rectified_info,
+                                                                  {data, nullptr},
+                                                                  fisheye->query_stream_type(),
+                                                                  image_interface::flag::any,
+                                                                  fisheye->query_time_stamp(),
+                                                                  fisheye->query_frame_number(),
+                                                                  fisheye->query_time_stamp_domain());
+        }
+
+        fisheye_projection_interface* create_fisheye_projection(const intrinsics *fisheye, const intrinsics *rectified)
+        {
+            if (!fisheye) return nullptr;
+            if (fisheye->model != distortion_type::distortion_ftheta || !(fisheye->coeffs[0] > 0.f && fisheye->coeffs[0] < PI_32F) ||
+                fisheye->width <= 0 || fisheye->height <= 0 || fisheye->fx == 0.f || fisheye->fy == 0.f)
+                return nullptr;
+
+            //by default the rectified camera keeps the fisheye image size, principal point and focal lengths
+            intrinsics default_rectified = *fisheye;
+            default_rectified.model = distortion_type::none;
+            memset(default_rectified.coeffs, 0, sizeof(default_rectified.coeffs));
+            if (!rectified) rectified = &default_rectified;
+            if (rectified->model != distortion_type::none || rectified->width <= 0 || rectified->height <= 0 ||
+                rectified->fx == 0.f || rectified->fy == 0.f)
+                return nullptr;
+            return new fisheye_projection(*fisheye, *rectified);
+        }
+
+        extern "C" {
+            extern void* rs_projection_create_fisheye_instance_from_intrinsics(intrinsics *fisheyeIntrinsics, intrinsics *rectifiedIntrinsics)
+            {
+                return create_fisheye_projection(fisheyeIntrinsics, rectifiedIntrinsics);
+            }
+        }
+    }
+}
@@ -0,0 +1,56 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "rs/core/fisheye_projection_interface.h"
+#include "rs/utils/ref_count_base.h"
+#include "math_projection_interface.h"
+#include "image_buffer_pool.h"
+
+namespace rs
+{
+    namespace core
+    {
+        class fisheye_projection : public rs::utils::release_self_base<fisheye_projection_interface>
+        {
+        public:
+            // the fisheye intrinsics are of the f-theta model and the rectified intrinsics of a pinhole camera, as create_fisheye_projection checks
+            fisheye_projection(const intrinsics & fisheye, const intrinsics & rectified);
+
+            virtual status project_camera_to_fisheye(int32_t npoints, point3dF32 *pos3d, pointF32 *pos_ij) override;
+            virtual status project_fisheye_to_camera(int32_t npoints, point3dF32 *pos_ijz, point3dF32 *pos3d) override;
+            virtual status query_rectified_intrinsics(intrinsics *rectified) override;
+            virtual status query_rectification_map(pointF32 *map) override;
+            virtual image_interface* create_rectified_image(image_interface *fisheye) override;
+            virtual image_interface* create_rectified_image(image_interface *fisheye, uint8_t *data, int32_t pitch) override;
+
+        protected:
+            virtual ~fisheye_projection() {}
+
+        private:
+            // returns the 8 bit remap table of a fisheye image pitch, the table of the last pitch is kept
+            std::shared_ptr<const std::vector<uint8_t>> query_remap_table(int32_t src_pitch);
+            // rectifies the image to the data, returns false if the image isn't of the fisheye size or of a supported format
+            bool rectify(image_interface *fisheye, uint8_t *data, int32_t pitch);
+
+            math_projection       m_math_projection;
+            intrinsics            m_fisheye;
+            intrinsics            m_rectified;
+            float                 m_camera_fisheye[4];   // fx, ppx, fy, ppy of the fisheye camera
+            float                 m_camera_rectified[4]; // fx, ppx, fy, ppy of the rectified camera
+            std::vector<pointF32> m_rectification_map;   // fisheye pixel of each rectified pixel
+
+            std::mutex            m_remap_table_lock;    // Guards the replacement of the remap table
+            std::shared_ptr<const std::vector<uint8_t>> m_remap_table; // Bilinear remap table of the 8 bit images of m_remap_table_pitch
+            int32_t               m_remap_table_pitch;
+            std::shared_ptr<image_buffer_pool> m_image_buffer_pool; // Data buffers of the rectified images, reused once an image is released
+        };
+
+        // returns a fisheye projection of the intrinsics, or null if they aren't of the supported models
+        fisheye_projection_interface* create_fisheye_projection(const intrinsics *fisheye, const intrinsics *rectified);
+    }
+}
@@ -2,12 +2,16 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include "projection_r200.h"
 #pragma warning (disable : 4068)
 #include "math_projection_interface.h"
+#include "projection_solution_cache.h"
+#include "image_rows_bands.h"
 #include "rs_sdk_version.h"
-#include "rs/utils/self_releasing_array_data_releaser.h"
 
 using namespace rs::utils;
 using namespace rs::core;
@@ -15,20 +19,77 @@ using namespace rs::core;
 static void *aligned_malloc(size_t size);
 static void aligned_free(void *ptr);
 
-#define x64_ALIGNMENT(x) (((x)+0x3f)&0xffffffc0)
-
-
 namespace rs
 {
     namespace core
     {
+        namespace
+        {
+            //scratch buffers of the queries of a thread, shared by the projection instances. a query writes a buffer before it reads it
+            //and doesn't keep it past its return, so an instance is shared by threads without locking its scratch buffers
+            struct projection_scratch
+            {
+                std::vector<pointF32> uvmap;
+                std::vector<pointF32> invuvmap;
+                std::vector<pointI32> sparse_invuvmap;
+                voxel_grid            voxels;
+            };
+
+            projection_scratch & thread_scratch()
+            {
+                static thread_local projection_scratch scratch;
+                return scratch;
+            }
+
+            //search offsets of map_color_to_depth around a color pixel, nearest first
+            const std::vector<pointI32> & color_search_steps()
+            {
+                static const std::vector<pointI32> steps = []()
+                {
+                    const int niter = 2;
+                    std::vector<pointI32> step_buffer;
+                    step_buffer.push_back({0, 0});
+                    for(int i = 1; i <= niter; i++)
+                    {
+                        step_buffer.push_back({0, i});
+                        step_buffer.push_back({-i, 0});
+                        step_buffer.push_back({i, 0});
+                        step_buffer.push_back({0, -i});
+                        for(int j = 1; j <= i - 1; j++)
+                        {
+                            step_buffer.push_back({-j, i});
+                            step_buffer.push_back({j, i});
+
+                            step_buffer.push_back({-i, j});
+                            step_buffer.push_back({i, j});
+
+                            step_buffer.push_back({-i, -j});
+                            step_buffer.push_back({i, -j});
+
+                            step_buffer.push_back({-j, -i});
+                            step_buffer.push_back({j, -i});
+                        }
+                        step_buffer.push_back({-i, i});
+                        step_buffer.push_back({i, i});
+                        step_buffer.push_back({-i, -i});
+                        step_buffer.push_back({i, -i});
+                    }
+                    return step_buffer;
+                }();
+                return steps;
+            }
+        }
+
         ds4_projection::ds4_projection(bool platformCameraProjection) :
-            m_buffer(nullptr),
             m_initialize_status(initialize_status::not_initialized),
             m_is_platform_camera_projection(platformCameraProjection),
             m_projection_spec(nullptr),
             m_projection_spec_size(0),
-            m_sparse_invuvmap(nullptr)
+            m_is_projection_spec_valid(false),
+            m_image_buffer_pool(image_buffer_pool::create()),
+            m_registration_splat_size(0),
+            m_is_fixed_point_projection(false),
+            m_is_fixed_point_rays_valid(false)
         {
             reset();
         }
@@ -36,8 +97,6 @@ namespace rs
         ds4_projection::~ds4_projection()
         {
             reset();
-            if (m_sparse_invuvmap)
-                delete[] m_sparse_invuvmap;
         }
 
         void ds4_projection::reset()
@@ -47,9 +106,12 @@ namespace rs
             if (m_projection_spec) aligned_free(m_projection_spec);
             m_projection_spec = nullptr;
             m_projection_spec_size = 0;
-            if (m_buffer) aligned_free(m_buffer);
-            m_buffer = nullptr;
-            m_buffer_size = 0;
+            m_is_projection_spec_valid = false;
+            m_is_fixed_point_rays_valid = false;
+            std::vector<pointI32>().swap(m_fixed_point_rays);
+            m_resident_uvmap.reset();
+            m_resident_vertices.reset();
+            release_incremental_registration();
         }
 
         status ds4_projection::init_from_float_array(r200_projection_float_array *data)
@@ -117,17 +179,13 @@ namespace rs
             if (flipY)
                 m_camera_depth_params[2] = -m_camera_depth_params[2];
 
-            int projectionSpecSize;
-
-            sizeI32 depthSize = {m_depth_size.width, m_depth_size.height};
-            m_math_projection.rs_projection_get_size_32f(depthSize, &projectionSpecSize);
-            if( m_projection_spec_size < projectionSpecSize)
+            // the depth rays table is rebuilt on its next use
             {
-                m_projection_spec = (uint8_t*)aligned_malloc(sizeof(uint8_t) * projectionSpecSize);
-                m_projection_spec_size = projectionSpecSize;
-                memset(m_projection_spec, 0, projectionSpecSize);
+                std::lock_guard<std::recursive_mutex> auto_lock(m_cs_buffer);
+                m_is_projection_spec_valid = false;
+                m_is_fixed_point_rays_valid = false;
+                m_incremental_registration.valid = false;
             }
-            m_math_projection.rs_projection_init_32f(depthSize, m_camera_depth_params, 0, (projection_spec_32f*)m_projection_spec);
 
             m_camera_color_params[0] = m_color_calib.focal_length.x;
             m_camera_color_params[1] = m_color_calib.principal_point.x;
@@ -158,7 +216,6 @@ namespace rs
                     m_rotation[4] = -m_rotation[4];
                     m_rotation[5] = -m_rotation[7];
                 }
-                projection_ds_lms12(m_rotation, m_translation, m_invrot_color, m_invtrans_color);
 #pragma novector
                 float distortion[5] =
                 {
@@ -168,17 +225,40 @@ namespace rs
                     m_color_calib.tangential_distortion[1],
                     m_color_calib.radial_distortion[2]
                 };
-                if (memcmp(m_distorsion_color_coeffs, distortion, 5 * sizeof(float)))
+                float camera[4] =
+                {
+                    m_color_calib.focal_length.x * 2.f / (float)m_color_size_unrectified.width,
+                    m_color_calib.principal_point.x * 2.f / (float)m_color_size_unrectified.width - 1.f,
+                    m_color_calib.focal_length.y * 2.f / (float)m_color_size_unrectified.height,
+                    m_color_calib.principal_point.y * 2.f / (float)m_color_size_unrectified.height - 1.f
+                };
+
+                //the fits depend only on the calibration, a solution of the same calibration is reused instead of fitting again
+                projection_solution_key key = {};
+                memcpy(key.rotation, m_rotation, sizeof(key.rotation));
+                memcpy(key.translation, m_translation, sizeof(key.translation));
+                memcpy(key.color_camera, camera, sizeof(key.color_camera));
+                memcpy(key.color_distortion, distortion, sizeof(key.color_distortion));
+                projection_solution solution = {};
+                if (projection_solution_cache::instance().find(key, solution))
                 {
+                    memcpy(m_invrot_color, solution.invrot_color, sizeof(solution.invrot_color));
+                    memcpy(m_invtrans_color, solution.invtrans_color, sizeof(solution.invtrans_color));
+                    memcpy(m_invdist_color_coeffs, solution.invdist_color_coeffs, sizeof(solution.invdist_color_coeffs));
                     memcpy(m_distorsion_color_coeffs, distortion, 5 * sizeof(float));
-                    float camera[4] =
+                }
+                else
+                {
+                    projection_ds_lms12(m_rotation, m_translation, m_invrot_color, m_invtrans_color);
+                    if (memcmp(m_distorsion_color_coeffs, distortion, 5 * sizeof(float)))
                     {
-                        m_color_calib.focal_length.x * 2.f / (float)m_color_size_unrectified.width,
-                        m_color_calib.principal_point.x * 2.f / (float)m_color_size_unrectified.width - 1.f,
-                        m_color_calib.focal_length.y * 2.f / (float)m_color_size_unrectified.height,
-                        m_color_calib.principal_point.y * 2.f / (float)m_color_size_unrectified.height - 1.f
-                    };
-                    distorsion_ds_lms(camera, m_distorsion_color_coeffs, m_invdist_color_coeffs);
+                        memcpy(m_distorsion_color_coeffs, distortion, 5 * sizeof(float));
+                        distorsion_ds_lms(camera, m_distorsion_color_coeffs, m_invdist_color_coeffs);
+                    }
+                    memcpy(solution.invrot_color, m_invrot_color, sizeof(solution.invrot_color));
+                    memcpy(solution.invtrans_color, m_invtrans_color, sizeof(solution.invtrans_color));
+                    memcpy(solution.invdist_color_coeffs, m_invdist_color_coeffs, sizeof(solution.invdist_color_coeffs));
+                    projection_solution_cache::instance().insert(key, solution);
                 }
             }
 
@@ -210,6 +290,21 @@ namespace rs
         }
 
 
+        status  ds4_projection::project_camera_to_depth(int32_t npoints, const float *pos3d_x, const float *pos3d_y, const float *pos3d_z, float *pos_u, float *pos_v)
+        {
+            if (npoints <= 0) return status::status_param_unsupported;
+            if (!pos3d_x || !pos3d_y || !pos3d_z) return status::status_handle_invalid;
+            if (!pos_u || !pos_v) return status::status_handle_invalid;
+            if (!(m_initialize_status & initialize_status::depth_initialized)) return status::status_data_unavailable;
+            status result = m_math_projection.rs_3d_array_projection_32f_p3p2(pos3d_x, pos3d_y, pos3d_z, pos_u, pos_v, npoints, nullptr, nullptr, nullptr, m_camera_depth_params);
+            if(result != status::status_no_error)
+            {
+                return status::status_param_unsupported;
+            }
+            return status::status_no_error;
+        }
+
+
         status  ds4_projection::project_color_to_camera(int32_t npoints, point3dF32 *pos_ijz, point3dF32 *pos3d)
         {
             if (npoints <= 0) return status::status_param_unsupported;
@@ -235,6 +330,31 @@ namespace rs
             if (!pos3d) return status::status_handle_invalid;
             if (!pos_ij) return status::status_handle_invalid;
             if (!(m_initialize_status & initialize_status::color_initialized)) return status::status_data_unavailable;
+            return project_camera_to_color_unchecked(npoints, pos3d, pos_ij);
+        }
+
+
+        status  ds4_projection::project_camera_to_color(int32_t npoints, const float *pos3d_x, const float *pos3d_y, const float *pos3d_z, float *pos_i, float *pos_j)
+        {
+            if (npoints <= 0) return status::status_param_unsupported;
+            if (!pos3d_x || !pos3d_y || !pos3d_z) return status::status_handle_invalid;
+            if (!pos_i || !pos_j) return status::status_handle_invalid;
+            if (!(m_initialize_status & initialize_status::color_initialized)) return status::status_data_unavailable;
+            // if color image is not rectified, we should assume rotation and distorsion of color image
+            float* rotation = m_is_color_rectified ? nullptr : m_rotation;
+            float* distortion = m_is_color_rectified ? nullptr : m_distorsion_color_coeffs;
+            status result = m_math_projection.rs_3d_array_projection_32f_p3p2(pos3d_x, pos3d_y, pos3d_z, pos_i, pos_j, npoints,
+                            rotation, m_translation, distortion, m_camera_color_params);
+            if (result != status::status_no_error)
+            {
+                return status::status_param_unsupported;
+            }
+            return status::status_no_error;
+        }
+
+
+        status  ds4_projection::project_camera_to_color_unchecked(int32_t npoints, point3dF32 *pos3d, pointF32 *pos_ij)
+        {
             if (m_is_color_rectified)
             {
                 status result = m_math_projection.rs_3d_array_projection_32f((const float*)pos3d, (float*)pos_ij, npoints, nullptr, nullptr, nullptr, m_translation, nullptr, m_camera_color_params);
@@ -262,35 +382,71 @@ namespace rs
             if (!depth) return status::status_handle_invalid;
             if (!uvmap) return status::status_handle_invalid;
             if (m_initialize_status != initialize_status::both_initialized) return status::status_data_unavailable;
+            image_info info = depth->query_info();
+            sizeI32 depth_size = { info.width, info.height };
+            const projection_spec_32f* projection_spec = query_projection_spec(depth_size);
+            if (!projection_spec) return status::status_feature_unsupported;
+            return query_uvmap_unchecked(depth, projection_spec, uvmap);
+        }
+
+
+        status  ds4_projection::query_uvmap(image_interface *depth, rect roi, pointF32 *uvmap, int32_t pitch)
+        {
+            if (!depth) return status::status_handle_invalid;
+            if (!uvmap) return status::status_handle_invalid;
+            if (m_initialize_status != initialize_status::both_initialized) return status::status_data_unavailable;
+            image_info info = depth->query_info();
+            if (!is_roi_inside(info, roi) || pitch < roi.width * static_cast<int32_t>(sizeof(pointF32))) return status::status_param_unsupported;
+            sizeI32 depth_size = { info.width, info.height };
+            const projection_spec_32f* projection_spec = query_projection_spec(depth_size);
+            if (!projection_spec) return status::status_feature_unsupported;
+            return query_uvmap_roi_unchecked(depth, projection_spec, roi, uvmap, pitch);
+        }
+
+
+        status  ds4_projection::query_uvmap_unchecked(image_interface *depth, const projection_spec_32f *projection_spec, pointF32 *uvmap)
+        {
+            image_info info = depth->query_info();
+            rect roi = { 0, 0, info.width, info.height };
+            return query_uvmap_roi_unchecked(depth, projection_spec, roi, uvmap, info.width * static_cast<int32_t>(sizeof(pointF32)));
+        }
+
+
+        status  ds4_projection::query_uvmap_roi_unchecked(image_interface *depth, const projection_spec_32f *projection_spec, rect roi, pointF32 *uvmap, int32_t pitch)
+        {
             image_info info = depth->query_info();
             const void* data = depth->query_data();
             if (!data)
             {
                 return status::status_data_not_initialized;
             }
-            int dst_pitches = info.width * get_pixel_size(pixel_format::bgra8) * 2;
-            sizeI32 depth_size = { info.width, info.height };
+            sizeI32 roi_size = { roi.width, roi.height };
+            status sts = project_uvmap_roi((const uint16_t*)data, info.pitch, roi, projection_spec, uvmap, pitch);
+            if (sts < status::status_no_error) return sts;
+            m_math_projection.rs_uvmap_filter_32f_c2ir((float*)uvmap, pitch, roi_size, 0, 0, 0 );
+            return status::status_no_error;
+        }
+
+
+        status ds4_projection::project_uvmap_roi(const uint16_t *depth_data, int32_t depth_pitch, rect roi, const projection_spec_32f *projection_spec, pointF32 *uvmap, int32_t uvmap_pitch)
+        {
+            const uint16_t* roi_depth_data = reinterpret_cast<const uint16_t*>(reinterpret_cast<const uint8_t*>(depth_data) + roi.y * depth_pitch) + roi.x;
             float inv_width = 1.f / (float)m_color_size.width;
             float inv_height = 1.f / (float)m_color_size.height;
             float cameraC[4] = { m_camera_color_params[0] * inv_width, m_camera_color_params[1] * inv_width, m_camera_color_params[2] * inv_height, m_camera_color_params[3] * inv_height };
-            if (m_is_color_rectified)
-            {
-                if (status::status_param_unsupported  == m_math_projection.rs_projection_16u32f_c1cxr((const unsigned short*)data, depth_size, depth->query_info().pitch, (float*)uvmap, dst_pitches,
-                        0, m_translation, 0, cameraC, (const projection_spec_32f*)m_projection_spec))
-                {
-                    return status::status_feature_unsupported;
-                }
-            }
-            else
+            // if color image is not rectified, we should assume rotation and distorsion of the image
+            float* rotation = m_is_color_rectified ? nullptr : m_rotation;
+            float* distortion = m_is_color_rectified ? nullptr : m_distorsion_color_coeffs;
+            const pointI32* fixed_point_rays = query_fixed_point_rays(projection_spec);
+            status sts = fixed_point_rays ?
+                         m_math_projection.rs_uvmap_roi_16u32f_c1c2r_q16(roi_depth_data, roi, depth_pitch, (float*)uvmap, uvmap_pitch,
+                                 rotation, m_translation, distortion, cameraC, fixed_point_rays, m_depth_size) :
+                         m_math_projection.rs_projection_roi_16u32f_c1cxr(roi_depth_data, roi, depth_pitch, (float*)uvmap, uvmap_pitch,
+                                 rotation, m_translation, distortion, cameraC, projection_spec);
+            if (status::status_param_unsupported == sts)
             {
-                // if color image is not rectified, we should assume rotation and distorsion of the image
-                if (status::status_param_unsupported  == m_math_projection.rs_projection_16u32f_c1cxr((const unsigned short*)data, depth_size, depth->query_info().pitch, (float*)uvmap, dst_pitches,
-                        m_rotation, m_translation, m_distorsion_color_coeffs, cameraC, (const projection_spec_32f*)m_projection_spec))
-                {
-                    return status::status_feature_unsupported;
-                }
+                return status::status_feature_unsupported;
             }
-            m_math_projection.rs_uvmap_filter_32f_c2ir((float*)uvmap, dst_pitches, depth_size, 0, 0, 0 );
             return status::status_no_error;
         }
 
@@ -300,16 +456,33 @@ namespace rs
             if (!inv_uvmap) return status::status_handle_invalid;
             if (!depth) return status::status_handle_invalid;
             if (m_initialize_status != initialize_status::both_initialized) return status::status_data_unavailable;
-            std::vector<pointF32> uvmap(depth->query_info().width * depth->query_info().height);
-            if (status::status_no_error > query_uvmap(depth, uvmap.data()))
-                return status::status_data_unavailable;
             int src_pitches = depth->query_info().width * get_pixel_size(pixel_format::xyz32f) * 2;
             image_info info = depth->query_info();
             sizeI32 depth_size = { info.width, info.height };
             sizeI32 color_size = { m_color_size.width, m_color_size.height };
             rect uvMapRoi = { 0, 0, info.width, info.height };
             pointF32 threshold = {4.f + (float)color_size.width/(float)depth_size.width, 4.f + (float)color_size.height/(float)depth_size.height};
-            if(status::status_no_error != m_math_projection.rs_uvmap_invertor_32f_c2r((float*)uvmap.data(), src_pitches, depth_size, uvMapRoi, (float*)inv_uvmap, color_size.width * static_cast<int>(sizeof(pointF32)), color_size, 1, threshold))
+            auto registration_lock = lock_incremental_registration();
+            if (registration_lock.owns_lock())
+            {
+                incremental_registration& registration = m_incremental_registration;
+                if (status::status_no_error > update_incremental_registration(depth, color_size))
+                    return status::status_data_unavailable;
+                if (!registration.relative_invuvmap_current)
+                {
+                    registration.relative_invuvmap.resize(color_size.width * color_size.height);
+                    if(status::status_no_error != m_math_projection.rs_uvmap_invertor_32f_c2r((const float*)registration.filtered_uvmap.data(), src_pitches, depth_size, uvMapRoi,
+                            (float*)registration.relative_invuvmap.data(), color_size.width * static_cast<int>(sizeof(pointF32)), color_size, 1, threshold))
+                        return status::status_feature_unsupported;
+                    registration.relative_invuvmap_current = true;
+                }
+                memcpy(inv_uvmap, registration.relative_invuvmap.data(), color_size.width * color_size.height * sizeof(pointF32));
+                return status::status_no_error;
+            }
+            pointF32* uvmap = query_uvmap_buffer(depth_size.width * depth_size.height);
+            if (status::status_no_error > query_uvmap(depth, uvmap))
+                return status::status_data_unavailable;
+            if(status::status_no_error != m_math_projection.rs_uvmap_invertor_32f_c2r((float*)uvmap, src_pitches, depth_size, uvMapRoi, (float*)inv_uvmap, color_size.width * static_cast<int>(sizeof(pointF32)), color_size, 1, threshold))
                 return status::status_feature_unsupported;
             return status::status_no_error;
         }
@@ -320,16 +493,105 @@ namespace rs
             if (!depth) return status::status_handle_invalid;
             if (!vertices) return status::status_handle_invalid;
             if (!(m_initialize_status & initialize_status::depth_initialized)) return status::status_data_unavailable;
+            if (!depth->query_data()) return status::status_data_unavailable;
             image_info info = depth->query_info();
+            sizeI32 depth_size = { info.width, info.height };
+            const projection_spec_32f* projection_spec = query_projection_spec(depth_size);
+            if (!projection_spec) return status::status_feature_unsupported;
+            return query_vertices_unchecked(depth, projection_spec, vertices);
+        }
+
+
+        status  ds4_projection::query_vertices(image_interface *depth, rect roi, point3dF32 *vertices, int32_t pitch)
+        {
+            return query_vertices(depth, roi, vertex_format::xyz32f, vertices, pitch);
+        }
+
+
+        status  ds4_projection::query_vertices(image_interface *depth, rect roi, vertex_format format, void *vertices, int32_t pitch)
+        {
+            if (!depth) return status::status_handle_invalid;
+            if (!vertices) return status::status_handle_invalid;
+            if (!(m_initialize_status & initialize_status::depth_initialized)) return status::status_data_unavailable;
+            if (!depth->query_data()) return status::status_data_unavailable;
+            image_info info = depth->query_info();
+            int32_t vertex_size = format == vertex_format::xyz32f ? static_cast<int32_t>(sizeof(point3dF32)) : 3 * static_cast<int32_t>(sizeof(int16_t));
+            if (!is_roi_inside(info, roi) || pitch < roi.width * vertex_size) return status::status_param_unsupported;
+            sizeI32 depth_size = { info.width, info.height };
+            const projection_spec_32f* projection_spec = query_projection_spec(depth_size);
+            if (!projection_spec) return status::status_feature_unsupported;
+            return query_vertices_roi_unchecked(depth, projection_spec, roi, format, vertices, pitch);
+        }
+
+
+        status  ds4_projection::query_vertices_unchecked(image_interface *depth, const projection_spec_32f *projection_spec, point3dF32 *vertices)
+        {
+            image_info info = depth->query_info();
+            rect roi = { 0, 0, info.width, info.height };
+            return query_vertices_roi_unchecked(depth, projection_spec, roi, vertex_format::xyz32f, vertices, info.width * static_cast<int32_t>(sizeof(point3dF32)));
+        }
+
+
+        status  ds4_projection::query_vertices_roi_unchecked(image_interface *depth, const projection_spec_32f *projection_spec, rect roi, vertex_format format, void *vertices, int32_t pitch)
+        {
+            image_info info = depth->query_info();
+            const uint8_t* data = static_cast<const uint8_t*>(depth->query_data());
+            if (!data) return status::status_data_unavailable;
+            const uint16_t* roi_data = reinterpret_cast<const uint16_t*>(data + roi.y * info.pitch) + roi.x;
+            const pointI32* fixed_point_rays = query_fixed_point_rays(projection_spec);
+            if (fixed_point_rays)
+                return m_math_projection.rs_vertices_roi_16u_c1c3r_q16(roi_data, roi, info.pitch, vertices, pitch, format, fixed_point_rays, m_depth_size);
+            return m_math_projection.rs_vertices_roi_16u_c1c3r(roi_data, roi, info.pitch, vertices, pitch, format, projection_spec);
+        }
+
+
+        status  ds4_projection::query_valid_vertices(image_interface *depth, point3dF32 *vertices, int32_t *pixel_indices, int32_t *nvertices)
+        {
+            if (!depth) return status::status_handle_invalid;
+            if (!vertices || !pixel_indices || !nvertices) return status::status_handle_invalid;
+            if (!(m_initialize_status & initialize_status::depth_initialized)) return status::status_data_unavailable;
             const void* data = depth->query_data();
             if (!data) return status::status_data_unavailable;
+            image_info info = depth->query_info();
             sizeI32 depth_size = { info.width, info.height };
-            m_math_projection.rs_projection_16u32f_c1cxr((const unsigned short*)data, depth_size, depth->query_info().pitch, (float*)vertices, depth_size.width * static_cast<int>(sizeof(point3dF32)),
-                    0, 0, 0, 0, (const projection_spec_32f*)m_projection_spec);
+            const projection_spec_32f* projection_spec = query_projection_spec(depth_size);
+            if (!projection_spec) return status::status_feature_unsupported;
+            return m_math_projection.rs_valid_vertices_16u32f_c1c3r((const unsigned short*)data, depth_size, info.pitch, (float*)vertices,
+                    pixel_indices, nvertices, projection_spec);
+        }
+
+
+        status  ds4_projection::query_voxelized_vertices(image_interface *depth, float voxel_size, point3dF32 *voxels, int32_t *nvoxels)
+        {
+            if (!depth) return status::status_handle_invalid;
+            if (!voxels || !nvoxels) return status::status_handle_invalid;
+            if (!(voxel_size > 0.f)) return status::status_param_unsupported;
+            if (!(m_initialize_status & initialize_status::depth_initialized)) return status::status_data_unavailable;
+            const void* data = depth->query_data();
+            if (!data) return status::status_data_unavailable;
+            image_info info = depth->query_info();
+            sizeI32 depth_size = { info.width, info.height };
+            const projection_spec_32f* projection_spec = query_projection_spec(depth_size);
+            if (!projection_spec) return status::status_feature_unsupported;
+            voxel_grid& grid = thread_scratch().voxels;
+            grid.reset(voxel_size, static_cast<size_t>(info.width) * info.height);
+            status sts = m_math_projection.rs_voxelize_16u_c1r((const unsigned short*)data, depth_size, info.pitch, grid, projection_spec);
+            if (sts < status::status_no_error) return sts;
+            *nvoxels = static_cast<int32_t>(grid.query_centroids(voxels));
             return status::status_no_error;
         }
 
 
+        status  ds4_projection::query_depth_rays(pointF32 *rays)
+        {
+            if (!rays) return status::status_handle_invalid;
+            if (!(m_initialize_status & initialize_status::depth_initialized)) return status::status_data_unavailable;
+            const projection_spec_32f* projection_spec = query_projection_spec(m_depth_size);
+            if (!projection_spec) return status::status_feature_unsupported;
+            return m_math_projection.rs_projection_get_rays_32f(projection_spec, rays);
+        }
+
+
         // Map
         status ds4_projection::map_depth_to_color(int32_t npoints, point3dF32 *pos_uvz, pointF32  *pos_ij)
         {
@@ -337,6 +599,12 @@ namespace rs
             if (!pos_uvz) return status::status_handle_invalid;
             if (!pos_ij) return status::status_handle_invalid;
             if (m_initialize_status != initialize_status::both_initialized) return status::status_data_unavailable;
+            return map_depth_to_color_unchecked(npoints, pos_uvz, pos_ij);
+        }
+
+
+        status ds4_projection::map_depth_to_color_unchecked(int32_t npoints, point3dF32 *pos_uvz, pointF32  *pos_ij)
+        {
             if (m_is_color_rectified)
             {
                 status result = m_math_projection.rs_3d_array_projection_32f((const float*)pos_uvz, (float*)pos_ij, npoints, m_camera_depth_params, nullptr, nullptr, m_translation, nullptr, m_camera_color_params);
@@ -366,62 +634,60 @@ namespace rs
             if (!pos_uv) return status::status_handle_invalid;
             if (m_initialize_status != initialize_status::both_initialized) return status::status_data_unavailable;
 
-            if (m_step_buffer.size() == 0)
+            image_info depth_info = depth->query_info();
+            const pointF32* uvmap = nullptr;
+            pointI32* sparse_invuvmap = nullptr;
+            bool is_sparse_invuvmap_current = false;
+            const size_t color_points = static_cast<size_t>(m_color_size.width) * m_color_size.height;
+            auto registration_lock = lock_incremental_registration();
+            if (registration_lock.owns_lock())
             {
-                const int32_t max_size = 25;
-                m_step_buffer.reserve(max_size);
-                const int niter = 2;
-                m_step_buffer.push_back({0, 0});
-                for(int i = 1; i <= niter; i++)
+                // the sparse inverse map is rebuilt only if a tile of the depth was registered again
+                sizeI32 color_size = { m_color_size.width, m_color_size.height };
+                if (status::status_no_error > update_incremental_registration(depth, color_size))
+                    return status::status_data_unavailable;
+                incremental_registration& registration = m_incremental_registration;
+                uvmap = registration.filtered_uvmap.data();
+                if (registration.sparse_invuvmap.size() != color_points)
                 {
-                    m_step_buffer.push_back({0, i});
-                    m_step_buffer.push_back({-i, 0});
-                    m_step_buffer.push_back({i, 0});
-                    m_step_buffer.push_back({0, -i});
-                    for(int j = 1; j <= i - 1; j++)
-                    {
-                        m_step_buffer.push_back({-j, i});
-                        m_step_buffer.push_back({j, i});
-
-                        m_step_buffer.push_back({-i, j});
-                        m_step_buffer.push_back({i, j});
-
-                        m_step_buffer.push_back({-i, -j});
-                        m_step_buffer.push_back({i, -j});
-
-                        m_step_buffer.push_back({-j, -i});
-                        m_step_buffer.push_back({j, -i});
-                    }
-                    m_step_buffer.push_back({-i, i});
-                    m_step_buffer.push_back({i, i});
-                    m_step_buffer.push_back({-i, -i});
-                    m_step_buffer.push_back({i, -i});
+                    registration.sparse_invuvmap.resize(color_points);
+                    registration.sparse_invuvmap_current = false;
                 }
-
-                m_sparse_invuvmap = new pointI32[m_color_size.width * m_color_size.height];
+                sparse_invuvmap = registration.sparse_invuvmap.data();
+                is_sparse_invuvmap_current = registration.sparse_invuvmap_current;
+                registration.sparse_invuvmap_current = true;
+            }
+            else
+            {
+                pointF32* uvmap_buffer = query_uvmap_buffer(depth_info.width * depth_info.height);
+                if (status::status_no_error > query_uvmap(depth, uvmap_buffer))
+                    return status::status_data_unavailable;
+                uvmap = uvmap_buffer;
+                std::vector<pointI32>& sparse_invuvmap_buffer = thread_scratch().sparse_invuvmap;
+                if (sparse_invuvmap_buffer.size() < color_points)
+                    sparse_invuvmap_buffer.resize(color_points);
+                sparse_invuvmap = sparse_invuvmap_buffer.data();
             }
 
-            memset(m_sparse_invuvmap, -1, sizeof(pointI32)*m_color_size.width*m_color_size.height);
-
-            image_info depth_info = depth->query_info();
-            std::vector<pointF32> uvmap(depth_info.width * depth_info.height);
-            if (status::status_no_error > query_uvmap(depth, uvmap.data()))
-                return status::status_data_unavailable;
-
-            for(int u = 0; u < depth_info.width; u++)
+            if (!is_sparse_invuvmap_current)
             {
-                for(int v = 0; v < depth_info.height; v++)
+                memset(sparse_invuvmap, -1, sizeof(pointI32)*m_color_size.width*m_color_size.height);
+                for(int u = 0; u < depth_info.width; u++)
                 {
-                    int i = static_cast<int>(uvmap[u+v*depth_info.width].x*(float)m_color_size.width);
-                    int j = static_cast<int>(uvmap[u+v*depth_info.width].y*(float)m_color_size.height);
-                    if(i < 0 || j < 0) continue;  // skip invalid pixel coordinates
+                    for(int v = 0; v < depth_info.height; v++)
+                    {
+                        int i = static_cast<int>(uvmap[u+v*depth_info.width].x*(float)m_color_size.width);
+                        int j = static_cast<int>(uvmap[u+v*depth_info.width].y*(float)m_color_size.height);
+                        if(i < 0 || j < 0) continue;  // skip invalid pixel coordinates
 
-                    m_sparse_invuvmap[i+j*m_color_size.width].x = u;
-                    m_sparse_invuvmap[i+j*m_color_size.width].y = v;
+                        sparse_invuvmap[i+j*m_color_size.width].x = u;
+                        sparse_invuvmap[i+j*m_color_size.width].y = v;
+                    }
                 }
             }
             status sts = status::status_no_error;
-            const int step_buffer_size = static_cast<int>(m_step_buffer.size());
+            const std::vector<pointI32>& step_buffer = color_search_steps();
+            const int step_buffer_size = static_cast<int>(step_buffer.size());
             pointI32 index;
             float min_dist, max_dist =  1.f/(float)m_color_size.width + 1.f/(float)m_color_size.height;
             int Ox, Oy;
@@ -434,22 +700,22 @@ namespace rs
 
                 for(int j = 0; j < step_buffer_size; j++)
                 {
-                    index.y = static_cast<int>(pos_ij[i].y + (float)m_step_buffer[j].y);
-                    index.x = static_cast<int>(pos_ij[i].x + (float)m_step_buffer[j].x);
+                    index.y = static_cast<int>(pos_ij[i].y + (float)step_buffer[j].y);
+                    index.x = static_cast<int>(pos_ij[i].x + (float)step_buffer[j].x);
                     if (index.x >= m_color_size.width || index.y >= m_color_size.height) continue; // indexes out of range
                     if (index.x < 0 || index.y < 0) continue; // indexes out of range
                     const int index_with_step = index.x+index.y*m_color_size.width;
-                    if (m_sparse_invuvmap[index_with_step].x < 0) continue;
+                    if (sparse_invuvmap[index_with_step].x < 0) continue;
 
-                    float prod_x = tmp_pos_color.x - uvmap[m_sparse_invuvmap[index_with_step].x+m_sparse_invuvmap[index_with_step].y*depth_info.width].x;
-                    float prod_y = tmp_pos_color.y - uvmap[m_sparse_invuvmap[index_with_step].x+m_sparse_invuvmap[index_with_step].y*depth_info.width].y;
+                    float prod_x = tmp_pos_color.x - uvmap[sparse_invuvmap[index_with_step].x+sparse_invuvmap[index_with_step].y*depth_info.width].x;
+                    float prod_y = tmp_pos_color.y - uvmap[sparse_invuvmap[index_with_step].x+sparse_invuvmap[index_with_step].y*depth_info.width].y;
                     float r = static_cast<float>(fabs(prod_x) + fabs(prod_y));
                     if (r < min_dist)
                     {
                         min_dist = r;
-                        Ox = m_sparse_invuvmap[index_with_step].x;
-                        Oy = m_sparse_invuvmap[index_with_step].y;
-                        if (m_step_buffer[j].x == 0 && m_step_buffer[j].y == 0) break;
+                        Ox = sparse_invuvmap[index_with_step].x;
+                        Oy = sparse_invuvmap[index_with_step].y;
+                        if (step_buffer[j].x == 0 && step_buffer[j].y == 0) break;
                     }
                 }
                 pos_uv[i].x = static_cast<float>(Ox);
@@ -460,30 +726,401 @@ namespace rs
         }
 
 
+        status  ds4_projection::map_color_to_depth_sparse(image_interface *depth, int32_t npoints, pointF32 *pos_ij, pointF32 *pos_uv)
+        {
+            if (!depth) return status::status_handle_invalid;
+            if (npoints <= 0) return status::status_param_unsupported;
+            if (!pos_ij) return status::status_handle_invalid;
+            if (!pos_uv) return status::status_handle_invalid;
+            if (m_initialize_status != initialize_status::both_initialized) return status::status_data_unavailable;
+
+            image_info depth_info = depth->query_info();
+            const uint8_t* depth_data = static_cast<const uint8_t*>(depth->query_data());
+            if (!depth_data) return status::status_data_unavailable;
+
+            const int max_iterations = 8;
+            const int search_radius = 2;
+            const int search_points = (2 * search_radius + 1) * (2 * search_radius + 1);
+            // the same acceptance distance as map_color_to_depth, in color pixels, separately normalized on each axis
+            const float max_dist = 1.f/(float)m_color_size.width + 1.f/(float)m_color_size.height;
+            // depth pixels per color pixel, the approximate jacobian of the color to depth mapping
+            const float scale_x = m_camera_depth_params[0] / m_camera_color_params[0];
+            const float scale_y = m_camera_depth_params[2] / m_camera_color_params[2];
+
+            auto depth_at = [&](int u, int v) -> uint16_t
+            {
+                return reinterpret_cast<const uint16_t*>(depth_data + v * depth_info.pitch)[u];
+            };
+            auto inside = [&](int u, int v) { return u >= 0 && v >= 0 && u < depth_info.width && v < depth_info.height; };
+            auto color_dist = [&](const pointF32& a, const pointF32& b)
+            {
+                return static_cast<float>(fabs(a.x - b.x)) / (float)m_color_size.width + static_cast<float>(fabs(a.y - b.y)) / (float)m_color_size.height;
+            };
+
+            point3dF32 candidates_uvz[search_points];
+            pointF32 candidates_ij[search_points];
+            for (int32_t n = 0; n < npoints; n++)
+            {
+                const pointF32 target = pos_ij[n];
+
+                // start from the depth pixel which sees the same direction as the color pixel, ignoring the cameras baseline
+                float u = (target.x - m_camera_color_params[1]) * scale_x + m_camera_depth_params[1];
+                float v = (target.y - m_camera_color_params[3]) * scale_y + m_camera_depth_params[3];
+                int best_u = -1, best_v = -1;
+                for (int iteration = 0; iteration < max_iterations; iteration++)
+                {
+                    int ui = std::min(std::max(static_cast<int>(u + 0.5f), 0), depth_info.width - 1);
+                    int vi = std::min(std::max(static_cast<int>(v + 0.5f), 0), depth_info.height - 1);
+
+                    // use the nearest valid depth around the current pixel
+                    point3dF32 uvz = {0.f, 0.f, 0.f};
+                    for (int r = 0; r <= search_radius && uvz.z == 0.f; r++)
+                        for (int dv = -r; dv <= r && uvz.z == 0.f; dv++)
+                            for (int du = -r; du <= r && uvz.z == 0.f; du++)
+                            {
+                                if (!inside(ui + du, vi + dv) || !depth_at(ui + du, vi + dv)) continue;
+                                uvz.x = static_cast<float>(ui + du);
+                                uvz.y = static_cast<float>(vi + dv);
+                                uvz.z = static_cast<float>(depth_at(ui + du, vi + dv));
+                            }
+                    if (uvz.z == 0.f) break;
+
+                    pointF32 ij;
+                    if (map_depth_to_color_unchecked(1, &uvz, &ij) != status::status_no_error) break;
+                    best_u = static_cast<int>(uvz.x);
+                    best_v = static_cast<int>(uvz.y);
+
+                    const float step_u = (target.x - ij.x) * scale_x;
+                    const float step_v = (target.y - ij.y) * scale_y;
+                    if (fabs(step_u) < 0.5f && fabs(step_v) < 0.5f) break;
+                    u = uvz.x + step_u;
+                    v = uvz.y + step_v;
+                }
+
+                pos_uv[n].x = pos_uv[n].y = -1.f;
+                if (best_u < 0) continue;
+
+                // select the nearest match in the neighborhood of the search result
+                int ncandidates = 0;
+                for (int dv = -search_radius; dv <= search_radius; dv++)
+                    for (int du = -search_radius; du <= search_radius; du++)
+                    {
+                        if (!inside(best_u + du, best_v + dv) || !depth_at(best_u + du, best_v + dv)) continue;
+                        candidates_uvz[ncandidates].x = static_cast<float>(best_u + du);
+                        candidates_uvz[ncandidates].y = static_cast<float>(best_v + dv);
+                        candidates_uvz[ncandidates].z = static_cast<float>(depth_at(best_u + du, best_v + dv));
+                        ncandidates++;
+                    }
+                if (map_depth_to_color_unchecked(ncandidates, candidates_uvz, candidates_ij) != status::status_no_error) continue;
+
+                float min_dist = max_dist;
+                for (int c = 0; c < ncandidates; c++)
+                {
+                    const float dist = color_dist(target, candidates_ij[c]);
+                    if (dist < min_dist)
+                    {
+                        min_dist = dist;
+                        pos_uv[n].x = candidates_uvz[c].x;
+                        pos_uv[n].y = candidates_uvz[c].y;
+                    }
+                }
+            }
+            return status::status_no_error;
+        }
+
+
+        // Batch
+        status ds4_projection::map_depth_to_color_batch(int32_t nbuffers, const int32_t *npoints, point3dF32 **pos_uvz, pointF32 **pos_ij)
+        {
+            if (nbuffers <= 0) return status::status_param_unsupported;
+            if (!npoints || !pos_uvz || !pos_ij) return status::status_handle_invalid;
+            for (int32_t i = 0; i < nbuffers; i++)
+            {
+                if (npoints[i] <= 0) return status::status_param_unsupported;
+                if (!pos_uvz[i] || !pos_ij[i]) return status::status_handle_invalid;
+            }
+            if (m_initialize_status != initialize_status::both_initialized) return status::status_data_unavailable;
+            return for_each_item(nbuffers, [&](int32_t i) { return map_depth_to_color_unchecked(npoints[i], pos_uvz[i], pos_ij[i]); });
+        }
+
+
+        status ds4_projection::project_camera_to_color_batch(int32_t nbuffers, const int32_t *npoints, point3dF32 **pos3d, pointF32 **pos_ij)
+        {
+            if (nbuffers <= 0) return status::status_param_unsupported;
+            if (!npoints || !pos3d || !pos_ij) return status::status_handle_invalid;
+            for (int32_t i = 0; i < nbuffers; i++)
+            {
+                if (npoints[i] <= 0) return status::status_param_unsupported;
+                if (!pos3d[i] || !pos_ij[i]) return status::status_handle_invalid;
+            }
+            if (!(m_initialize_status & initialize_status::color_initialized)) return status::status_data_unavailable;
+            return for_each_item(nbuffers, [&](int32_t i) { return project_camera_to_color_unchecked(npoints[i], pos3d[i], pos_ij[i]); });
+        }
+
+
+        status ds4_projection::query_uvmap_batch(int32_t nframes, image_interface **depth, pointF32 **uvmap)
+        {
+            if (nframes <= 0) return status::status_param_unsupported;
+            if (!depth || !uvmap) return status::status_handle_invalid;
+            for (int32_t i = 0; i < nframes; i++)
+            {
+                if (!depth[i] || !uvmap[i]) return status::status_handle_invalid;
+            }
+            if (m_initialize_status != initialize_status::both_initialized) return status::status_data_unavailable;
+            const projection_spec_32f* projection_spec = query_projection_spec(m_depth_size);
+            if (!projection_spec) return status::status_feature_unsupported;
+            for (int32_t i = 0; i < nframes; i++)
+            {
+                image_info info = depth[i]->query_info();
+                if (info.width != m_depth_size.width || info.height != m_depth_size.height) return status::status_feature_unsupported;
+            }
+            return for_each_item(nframes, [&](int32_t i) { return query_uvmap_unchecked(depth[i], projection_spec, uvmap[i]); });
+        }
+
+
+        status ds4_projection::query_vertices_batch(int32_t nframes, image_interface **depth, point3dF32 **vertices)
+        {
+            if (nframes <= 0) return status::status_param_unsupported;
+            if (!depth || !vertices) return status::status_handle_invalid;
+            for (int32_t i = 0; i < nframes; i++)
+            {
+                if (!depth[i] || !vertices[i]) return status::status_handle_invalid;
+            }
+            if (!(m_initialize_status & initialize_status::depth_initialized)) return status::status_data_unavailable;
+            const projection_spec_32f* projection_spec = query_projection_spec(m_depth_size);
+            if (!projection_spec) return status::status_feature_unsupported;
+            for (int32_t i = 0; i < nframes; i++)
+            {
+                image_info info = depth[i]->query_info();
+                if (info.width != m_depth_size.width || info.height != m_depth_size.height) return status::status_feature_unsupported;
+            }
+            return for_each_item(nframes, [&](int32_t i) { return query_vertices_unchecked(depth[i], projection_spec, vertices[i]); });
+        }
+
+
+        status ds4_projection::for_each_item(int32_t nitems, const std::function<status(int32_t)> & item_function)
+        {
+            std::vector<status> items_status(nitems, status::status_no_error);
+            std::atomic<int32_t> next_item(0);
+            auto worker_function = [&]()
+            {
+                for (int32_t i = next_item++; i < nitems; i = next_item++)
+                    items_status[i] = item_function(i);
+            };
+
+            // each band of the persistent image bands workers takes the next items, a single item runs on the calling thread
+            const int32_t number_of_workers = std::min(nitems, static_cast<int32_t>(std::max(1u, std::thread::hardware_concurrency())));
+            image_rows_bands::for_each(number_of_workers, number_of_workers, [&worker_function](int band, int begin, int end) { worker_function(); });
+
+            for (auto item_status : items_status)
+                if (item_status != status::status_no_error)
+                    return item_status;
+            return status::status_no_error;
+        }
+
+
+        // Projection owned output
+        // The last output is reused once the projection holds its only reference, otherwise its user keeps it and a new output is allocated
+        template<typename T>
+        static resident_output<T> *acquire_resident_output(rs::utils::unique_ptr<resident_output<T>> &output, size_t npoints)
+        {
+            if (!output || output->ref_count() > 1 || output->points.size() != npoints)
+            {
+                output = rs::utils::get_unique_ptr_with_releaser(new resident_output<T>(npoints));
+            }
+            // the writes follow the reads of the user which released the output
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return output.get();
+        }
+
+
+        status ds4_projection::query_uvmap_resident(image_interface *depth, const projection_output_interface **uvmap)
+        {
+            if (!depth) return status::status_handle_invalid;
+            if (!uvmap) return status::status_handle_invalid;
+            *uvmap = nullptr;
+            std::lock_guard<std::recursive_mutex> auto_lock(m_cs_buffer);
+            image_info info = depth->query_info();
+            auto output = acquire_resident_output(m_resident_uvmap, static_cast<size_t>(info.width) * info.height);
+            status sts = query_uvmap(depth, output->points.data());
+            if (sts < status::status_no_error) return sts;
+            output->add_ref();
+            *uvmap = output;
+            return sts;
+        }
+
+
+        status ds4_projection::query_vertices_resident(image_interface *depth, const projection_output_interface **vertices)
+        {
+            if (!depth) return status::status_handle_invalid;
+            if (!vertices) return status::status_handle_invalid;
+            *vertices = nullptr;
+            std::lock_guard<std::recursive_mutex> auto_lock(m_cs_buffer);
+            image_info info = depth->query_info();
+            auto output = acquire_resident_output(m_resident_vertices, static_cast<size_t>(info.width) * info.height);
+            status sts = query_vertices(depth, output->points.data());
+            if (sts < status::status_no_error) return sts;
+            output->add_ref();
+            *vertices = output;
+            return sts;
+        }
+
+
+        // Depth image attached output
+        namespace
+        {
+            enum shared_product_id : uint32_t
+            {
+                shared_uvmap,
+                shared_vertices,
+                shared_color_image_mapped_to_depth,
+                shared_depth_image_mapped_to_color
+            };
+        }
+
+        status ds4_projection::acquire_shared_product(image_interface *depth, uint32_t id, rs::utils::unique_ptr<depth_image_product> & product)
+        {
+            auto attached = depth->query_attachment(this, id);
+            if (!attached)
+            {
+                //the users may attach concurrently, the user which loses the race uses the attached product
+                auto created = rs::utils::get_unique_ptr_with_releaser(new depth_image_product());
+                status sts = depth->attach(this, id, created.get());
+                if (sts == status::status_no_error)
+                {
+                    product = std::move(created);
+                    return sts;
+                }
+                if (sts != status::status_key_already_exists)
+                    return sts;
+                attached = depth->query_attachment(this, id);
+            }
+            attached->add_ref();
+            product.reset(static_cast<depth_image_product *>(const_cast<ref_count_interface *>(attached)));
+            return status::status_no_error;
+        }
+
+        status ds4_projection::query_shared_uvmap(image_interface *depth, const pointF32 **uvmap)
+        {
+            if (!depth) return status::status_handle_invalid;
+            if (!uvmap) return status::status_handle_invalid;
+            rs::utils::unique_ptr<depth_image_product> product;
+            status sts = acquire_shared_product(depth, shared_uvmap, product);
+            if (sts < status::status_no_error)
+                return sts;
+            std::lock_guard<std::mutex> product_lock(product->lock);
+            if (!product->is_computed)
+            {
+                image_info info = depth->query_info();
+                product->uvmap.resize(static_cast<size_t>(info.width) * info.height);
+                product->computed_status = query_uvmap(depth, product->uvmap.data());
+                product->is_computed = true;
+            }
+            *uvmap = product->computed_status < status::status_no_error ? nullptr : product->uvmap.data();
+            return product->computed_status;
+        }
+
+        status ds4_projection::query_shared_vertices(image_interface *depth, const point3dF32 **vertices)
+        {
+            if (!depth) return status::status_handle_invalid;
+            if (!vertices) return status::status_handle_invalid;
+            rs::utils::unique_ptr<depth_image_product> product;
+            status sts = acquire_shared_product(depth, shared_vertices, product);
+            if (sts < status::status_no_error)
+                return sts;
+            std::lock_guard<std::mutex> product_lock(product->lock);
+            if (!product->is_computed)
+            {
+                image_info info = depth->query_info();
+                product->vertices.resize(static_cast<size_t>(info.width) * info.height);
+                product->computed_status = query_vertices(depth, product->vertices.data());
+                product->is_computed = true;
+            }
+            *vertices = product->computed_status < status::status_no_error ? nullptr : product->vertices.data();
+            return product->computed_status;
+        }
+
+        status ds4_projection::query_shared_color_image_mapped_to_depth(image_interface *depth, image_interface *color, const image_interface **mapped)
+        {
+            return query_shared_mapped_image(depth, color, shared_color_image_mapped_to_depth, mapped);
+        }
+
+        status ds4_projection::query_shared_depth_image_mapped_to_color(image_interface *depth, image_interface *color, const image_interface **mapped)
+        {
+            return query_shared_mapped_image(depth, color, shared_depth_image_mapped_to_color, mapped);
+        }
+
+        status ds4_projection::query_shared_mapped_image(image_interface *depth, image_interface *color, uint32_t id, const image_interface **mapped)
+        {
+            if (!depth || !color || !mapped) return status::status_handle_invalid;
+            rs::utils::unique_ptr<depth_image_product> product;
+            status sts = acquire_shared_product(depth, id, product);
+            if (sts < status::status_no_error)
+                return sts;
+            std::lock_guard<std::mutex> product_lock(product->lock);
+            for (auto & mapped_image : product->mapped_images)
+            {
+                if (mapped_image.color.get() == color)
+                {
+                    *mapped = mapped_image.mapped.get();
+                    return status::status_no_error;
+                }
+            }
+
+            auto created = rs::utils::get_unique_ptr_with_releaser(id == shared_color_image_mapped_to_depth ?
+                                                                   create_color_image_mapped_to_depth(depth, color) :
+                                                                   create_depth_image_mapped_to_color(depth, color));
+            if (!created)
+                return status::status_data_unavailable;
+            *mapped = created.get();
+            color->add_ref();
+            product->mapped_images.push_back({ rs::utils::get_unique_ptr_with_releaser(color), std::move(created) });
+            return status::status_no_error;
+        }
+
+
         // Create images
         image_interface *ds4_projection::create_color_image_mapped_to_depth(image_interface *depth, image_interface *color)
+        {
+            return create_color_image_mapped_to_depth(depth, color, nullptr, 0);
+        }
+
+
+        image_interface *ds4_projection::create_color_image_mapped_to_depth(image_interface *depth, image_interface *color, uint8_t *data, int32_t pitch)
+        {
+            if (!depth) return nullptr;
+            image_info depth_info = depth->query_info();
+            rect roi = { 0, 0, depth_info.width, depth_info.height };
+            return create_color_image_mapped_to_depth(depth, color, roi, data, pitch);
+        }
+
+
+        image_interface *ds4_projection::create_color_image_mapped_to_depth(image_interface *depth, image_interface *color, rect roi, uint8_t *data, int32_t pitch)
         {
             if (!depth) return nullptr;
             if (!color) return nullptr;
 
             image_info depth_info = depth->query_info();
             image_info color_info = color->query_info();
-            int32_t pitch = depth_info.width * get_pixel_size(color_info.format);
-            image_info color2depth_info = { depth_info.width, depth_info.height, color_info.format, pitch };
+            if (!is_roi_inside(depth_info, roi)) return nullptr;
+            int32_t min_pitch = roi.width * get_pixel_size(color_info.format);
+            if (data && pitch < min_pitch) return nullptr;
+            image_info color2depth_info = { roi.width, roi.height, color_info.format, data ? pitch : min_pitch };
 
-            uint8_t* color2depth_data = new uint8_t[color2depth_info.height * color2depth_info.pitch];
+            release_interface* data_releaser = nullptr;
+            uint8_t* color2depth_data = data ? data : m_image_buffer_pool->acquire(color2depth_info.height * color2depth_info.pitch, data_releaser);
             memset(color2depth_data, 0, color2depth_info.height * color2depth_info.pitch);
             int32_t color2depth_step = color2depth_info.pitch;
             uint8_t* ptr_color2depth_data = color2depth_data;
 
-            std::vector<pointF32> uvmap(depth_info.width * depth_info.height);
-            if (status::status_no_error > query_uvmap(depth, uvmap.data()))
+            int32_t uvmap_step = roi.width * static_cast<int32_t>(sizeof(pointF32));
+            pointF32* uvmap = query_uvmap_buffer(roi.width * roi.height);
+            if (status::status_no_error > query_uvmap(depth, roi, uvmap, uvmap_step))
             {
-                delete[] color2depth_data;
+                if (data_releaser) data_releaser->release();
                 return nullptr;
             }
-            int32_t uvmap_step = depth_info.width * get_pixel_size(pixel_format::bgra8) * 2;
-            uint8_t* ptr_uvmap = (uint8_t*)uvmap.data();
+            uint8_t* ptr_uvmap = (uint8_t*)uvmap;
             pointF32* ptr_uvmap_32f;
 
             int32_t color_step = color_info.pitch;
@@ -507,9 +1144,9 @@ namespace rs
                     channels = 1;
             }
 
-            for(int i = 0; i < depth_info.height; i++)
+            for(int i = 0; i < roi.height; i++)
             {
-                for (int j = 0, xi = 0; j < depth_info.width; j++, xi+= channels)
+                for (int j = 0, xi = 0; j < roi.width; j++, xi+= channels)
                 {
                     ptr_uvmap_32f = ((pointF32*)ptr_uvmap) + j;
                     if(ptr_uvmap_32f->x >= 0.f && ptr_uvmap_32f->x < 1.f && ptr_uvmap_32f->y >= 0.f && ptr_uvmap_32f->y < 1.f)
@@ -526,8 +1163,6 @@ namespace rs
                 ptr_color2depth_data += color2depth_step;
             }
 
-            auto data_releaser = new rs::utils::self_releasing_array_data_releaser(color2depth_data);
-            
             return image_interface::create_instance_from_raw_data(&color2depth_info,
                                                                   {color2depth_data, data_releaser},
                                                                   color->query_stream_type(),
@@ -538,6 +1173,21 @@ namespace rs
 
 
         image_interface* ds4_projection::create_depth_image_mapped_to_color(image_interface *depth, image_interface *color)
+        {
+            return create_depth_image_mapped_to_color(depth, color, nullptr, 0);
+        }
+
+
+        image_interface* ds4_projection::create_depth_image_mapped_to_color(image_interface *depth, image_interface *color, uint8_t *data, int32_t pitch)
+        {
+            if (!depth) return nullptr;
+            image_info depth_info = depth->query_info();
+            rect roi = { 0, 0, depth_info.width, depth_info.height };
+            return create_depth_image_mapped_to_color(depth, color, roi, data, pitch);
+        }
+
+
+        image_interface* ds4_projection::create_depth_image_mapped_to_color(image_interface *depth, image_interface *color, rect roi, uint8_t *data, int32_t pitch)
         {
             if (!depth) return nullptr;
             if (!color) return nullptr;
@@ -545,46 +1195,81 @@ namespace rs
             uint16_t default_depth_value = 0;
             image_info depth_info = depth->query_info();
             image_info color_info = color->query_info();
-            int32_t pitch = color_info.width * get_pixel_size(pixel_format::z16);
-            image_info depth2color_info = { color_info.width, color_info.height, depth_info.format, pitch };
+            if (!is_roi_inside(depth_info, roi)) return nullptr;
+            int32_t min_pitch = color_info.width * get_pixel_size(pixel_format::z16);
+            if (data && pitch < min_pitch) return nullptr;
+            image_info depth2color_info = { color_info.width, color_info.height, depth_info.format, data ? pitch : min_pitch };
 
-            uint8_t* depth2color_data = new uint8_t[depth2color_info.height * depth2color_info.pitch];
+            release_interface* data_releaser = nullptr;
+            uint8_t* depth2color_data = data ? data : m_image_buffer_pool->acquire(depth2color_info.height * depth2color_info.pitch, data_releaser);
             memset(depth2color_data, 0, depth2color_info.height * depth2color_info.pitch);
             uint16_t* depth_data = reinterpret_cast<uint16_t*>(const_cast<void*>(depth->query_data()));
 
-            std::vector<pointF32> uvmap(depth_info.width*depth_info.height);
-            if (status::status_no_error > query_uvmap(depth, uvmap.data()))
+            sizeI32 depth_size = { depth_info.width, depth_info.height };
+            sizeI32 color_size = { color_info.width, color_info.height };
+
+            // the incremental registration covers the whole depth image, a partial roi is registered on its own
+            bool is_full_roi = roi.width == depth_info.width && roi.height == depth_info.height;
+            const int32_t splat_size = m_registration_splat_size;
+            auto registration_lock = is_full_roi && splat_size == 0 ? lock_incremental_registration() : std::unique_lock<std::recursive_mutex>();
+            if (registration_lock.owns_lock())
             {
-                delete[] depth2color_data;
+                if (m_initialize_status != initialize_status::both_initialized ||
+                        status::status_no_error > update_incremental_registration(depth, color_size))
+                {
+                    if (data_releaser) data_releaser->release();
+                    return nullptr;
+                }
+                incremental_registration& registration = m_incremental_registration;
+                if (!registration.invuvmap_current)
+                {
+                    registration.invuvmap.resize(color_size.width * color_size.height);
+                    rect uvmap_roi = { 0, 0, depth_size.width, depth_size.height };
+                    pointF32 threshold = {4.f + (float)color_size.width/(float)depth_size.width, 4.f + (float)color_size.height/(float)depth_size.height};
+                    m_math_projection.rs_uvmap_invertor_32f_c2r((const float*)registration.filtered_uvmap.data(), depth_size.width * static_cast<int>(sizeof(pointF32)),
+                            depth_size, uvmap_roi, (float*)registration.invuvmap.data(), color_size.width * static_cast<int>(sizeof(pointF32)), color_size, 0, threshold);
+                    registration.invuvmap_current = true;
+                }
+                m_math_projection.rs_remap_16u_c1r((unsigned short*)depth_data, depth_size, depth_info.pitch,
+                                                   (float*)m_incremental_registration.invuvmap.data(), color_info.width * static_cast<int>(sizeof(pointF32)),
+                                                   (uint16_t*)depth2color_data, color_size, depth2color_info.pitch, 0, default_depth_value);
+                return image_interface::create_instance_from_raw_data(&depth2color_info,
+                                                                      {depth2color_data, data_releaser},
+                                                                      stream_type::depth,
+                                                                      image_interface::flag::any,
+                                                                      0,
+                                                                      0);
+            }
+
+            // the uvmap of the roi is written at the roi position of a depth size uvmap, the inversion reads the roi only
+            int32_t uvmap_pitch = depth_info.width * static_cast<int32_t>(sizeof(pointF32));
+            pointF32* uvmap = query_uvmap_buffer(depth_info.width * depth_info.height);
+            if (status::status_no_error > query_uvmap(depth, roi, uvmap + roi.y * depth_info.width + roi.x, uvmap_pitch))
+            {
+                if (data_releaser) data_releaser->release();
                 return nullptr;
             }
-            std::lock_guard<std::recursive_mutex> auto_lock(m_cs_buffer);
-            int32_t invuvmapPoints = static_cast<int32_t>(x64_ALIGNMENT(color_info.width * color_info.height * sizeof(pointF32)));
-            if(invuvmapPoints > m_buffer_size)
+            if (splat_size > 0)
             {
-                if(m_buffer) aligned_free(m_buffer);
-                m_buffer = 0;
-                m_buffer = (pointF32*)aligned_malloc(sizeof(pointF32) * invuvmapPoints);
-
-                if(!m_buffer)
-                {
-                    delete[] depth2color_data;
-                    return 0;
-                }
-                m_buffer_size = invuvmapPoints;
+                m_math_projection.rs_depth_splat_16u_c1r(depth_data, depth_info.pitch, (const float*)uvmap, uvmap_pitch, roi,
+                                                         (uint16_t*)depth2color_data, depth2color_info.pitch, color_size, splat_size);
+                return image_interface::create_instance_from_raw_data(&depth2color_info,
+                                                                      {depth2color_data, data_releaser},
+                                                                      stream_type::depth,
+                                                                      image_interface::flag::any,
+                                                                      0,
+                                                                      0);
             }
-            sizeI32 depth_size = { depth_info.width, depth_info.height };
-            sizeI32 color_size = { color_info.width, color_info.height };
-            rect uvmap_roi = { 0, 0, depth_info.width, depth_info.height };
+            std::vector<pointF32>& invuvmap = thread_scratch().invuvmap;
+            if (invuvmap.size() < static_cast<size_t>(color_info.width) * color_info.height)
+                invuvmap.resize(static_cast<size_t>(color_info.width) * color_info.height);
             pointF32 threshold = {4.f + (float)color_size.width/(float)depth_size.width, 4.f + (float)color_size.height/(float)depth_size.height};
-            m_math_projection.rs_uvmap_invertor_32f_c2r((float*)uvmap.data(), depth_info.width * get_pixel_size(pixel_format::xyz32f) * 2,
-                    depth_size, uvmap_roi, (float*)m_buffer, color_info.width * static_cast<int>(sizeof(pointF32)), color_size, 0 , threshold);
+            m_math_projection.rs_uvmap_invertor_32f_c2r((float*)uvmap, uvmap_pitch,
+                    depth_size, roi, (float*)invuvmap.data(), color_info.width * static_cast<int>(sizeof(pointF32)), color_size, 0 , threshold);
             m_math_projection.rs_remap_16u_c1r((unsigned short*)depth_data, depth_size, depth_info.pitch,
-                                               (float*)m_buffer, color_info.width * static_cast<int>(sizeof(pointF32)), (uint16_t*)depth2color_data,
+                                               (float*)invuvmap.data(), color_info.width * static_cast<int>(sizeof(pointF32)), (uint16_t*)depth2color_data,
                                                color_size, depth2color_info.pitch, 0, default_depth_value);
 
-            auto data_releaser = new rs::utils::self_releasing_array_data_releaser(depth2color_data);
-
             return image_interface::create_instance_from_raw_data(&depth2color_info,
                                                                   {depth2color_data, data_releaser},
                                                                   stream_type::depth,
@@ -594,7 +1279,198 @@ namespace rs
         }
 
 
+        // Registration
+        status ds4_projection::set_incremental_registration(bool enable, uint16_t depth_threshold)
+        {
+            std::lock_guard<std::recursive_mutex> auto_lock(m_cs_buffer);
+            m_incremental_registration.enabled = enable;
+            if (m_incremental_registration.depth_threshold != depth_threshold)
+                m_incremental_registration.valid = false;
+            m_incremental_registration.depth_threshold = depth_threshold;
+            if (!enable)
+                release_incremental_registration();
+            return status::status_no_error;
+        }
+
+
+        void ds4_projection::release_incremental_registration()
+        {
+            std::lock_guard<std::recursive_mutex> auto_lock(m_cs_buffer);
+            incremental_registration& registration = m_incremental_registration;
+            registration.valid = false;
+            std::vector<uint16_t>().swap(registration.reference_depth);
+            std::vector<pointF32>().swap(registration.uvmap);
+            std::vector<pointF32>().swap(registration.filtered_uvmap);
+            std::vector<pointF32>().swap(registration.invuvmap);
+            std::vector<pointF32>().swap(registration.relative_invuvmap);
+            std::vector<pointI32>().swap(registration.sparse_invuvmap);
+            registration.invuvmap_current = false;
+            registration.relative_invuvmap_current = false;
+            registration.sparse_invuvmap_current = false;
+        }
+
+
+        status ds4_projection::set_splatted_registration(bool enable, int32_t splat_size)
+        {
+            if (enable && (splat_size < 1 || splat_size > MAX_REGISTRATION_SPLAT_SIZE)) return status::status_param_unsupported;
+            m_registration_splat_size = enable ? splat_size : 0;
+            return status::status_no_error;
+        }
+
+
+        status ds4_projection::set_fixed_point_projection(bool enable)
+        {
+            // the rays are kept when the fixed point projection is disabled, a query of another thread may still use them
+            m_is_fixed_point_projection = enable;
+            return status::status_no_error;
+        }
+
+
+        const pointI32* ds4_projection::query_fixed_point_rays(const projection_spec_32f *projection_spec)
+        {
+            if (!m_is_fixed_point_projection) return nullptr;
+            if (m_is_fixed_point_rays_valid.load(std::memory_order_acquire)) return m_fixed_point_rays.data();
+            std::lock_guard<std::recursive_mutex> auto_lock(m_cs_buffer);
+            if (m_is_fixed_point_rays_valid) return m_fixed_point_rays.data();
+            // the rays are converted from the projection spec rays once, and again only if the spec was rebuilt
+            m_fixed_point_rays.resize(static_cast<size_t>(m_depth_size.width) * m_depth_size.height);
+            if (status::status_no_error != m_math_projection.rs_projection_get_rays_32s_q16(projection_spec, m_fixed_point_rays.data())) return nullptr;
+            m_is_fixed_point_rays_valid.store(true, std::memory_order_release);
+            return m_fixed_point_rays.data();
+        }
+
+
+        status ds4_projection::update_incremental_registration(image_interface *depth, sizeI32 color_size)
+        {
+            const int tile_size = 32;
+            std::lock_guard<std::recursive_mutex> auto_lock(m_cs_buffer);
+            image_info depth_info = depth->query_info();
+            const uint8_t* depth_data = static_cast<const uint8_t*>(depth->query_data());
+            if (!depth_data) return status::status_data_not_initialized;
+            sizeI32 depth_size = { depth_info.width, depth_info.height };
+            const projection_spec_32f* projection_spec = query_projection_spec(depth_size);
+            if (!projection_spec) return status::status_feature_unsupported;
+
+            incremental_registration& registration = m_incremental_registration;
+            bool register_all = !registration.valid ||
+                                registration.depth_size.width != depth_size.width || registration.depth_size.height != depth_size.height ||
+                                registration.color_size.width != color_size.width || registration.color_size.height != color_size.height;
+            if (register_all)
+            {
+                registration.valid = false;
+                registration.depth_size = depth_size;
+                registration.color_size = color_size;
+                registration.reference_depth.resize(depth_size.width * depth_size.height);
+                registration.uvmap.resize(depth_size.width * depth_size.height);
+                registration.filtered_uvmap.resize(depth_size.width * depth_size.height);
+            }
+
+            bool registered = register_all;
+            const int depth_threshold = registration.depth_threshold;
+            for (int tile_y = 0; tile_y < depth_size.height; tile_y += tile_size)
+            {
+                for (int tile_x = 0; tile_x < depth_size.width; tile_x += tile_size)
+                {
+                    rect tile = { tile_x, tile_y, std::min(tile_size, depth_size.width - tile_x), std::min(tile_size, depth_size.height - tile_y) };
+                    bool changed = register_all;
+                    for (int y = tile.y; y < tile.y + tile.height && !changed; y++)
+                    {
+                        const uint16_t* src = reinterpret_cast<const uint16_t*>(depth_data + y * depth_info.pitch) + tile.x;
+                        const uint16_t* ref = registration.reference_depth.data() + y * depth_size.width + tile.x;
+                        for (int x = 0; x < tile.width; x++)
+                        {
+                            if (std::abs(static_cast<int>(src[x]) - static_cast<int>(ref[x])) > depth_threshold)
+                            {
+                                changed = true;
+                                break;
+                            }
+                        }
+                    }
+                    if (!changed) continue;
+
+                    for (int y = tile.y; y < tile.y + tile.height; y++)
+                    {
+                        memcpy(registration.reference_depth.data() + y * depth_size.width + tile.x,
+                               reinterpret_cast<const uint16_t*>(depth_data + y * depth_info.pitch) + tile.x, tile.width * sizeof(uint16_t));
+                    }
+                    status sts = project_uvmap_roi(reinterpret_cast<const uint16_t*>(depth_data), depth_info.pitch, tile, projection_spec,
+                                                   registration.uvmap.data() + tile.y * depth_size.width + tile.x, depth_size.width * static_cast<int32_t>(sizeof(pointF32)));
+                    if (sts < status::status_no_error)
+                    {
+                        registration.valid = false;
+                        return sts;
+                    }
+                    registered = true;
+                }
+            }
+
+            if (registered)
+            {
+                // the filter works on the whole uvmap, the unfiltered uvmap is kept for the next frames
+                int32_t uvmap_pitch = depth_size.width * static_cast<int>(sizeof(pointF32));
+                memcpy(registration.filtered_uvmap.data(), registration.uvmap.data(), depth_size.width * depth_size.height * sizeof(pointF32));
+                m_math_projection.rs_uvmap_filter_32f_c2ir((float*)registration.filtered_uvmap.data(), uvmap_pitch, depth_size, 0, 0, 0);
+                registration.invuvmap_current = false;
+                registration.relative_invuvmap_current = false;
+                registration.sparse_invuvmap_current = false;
+            }
+            registration.valid = true;
+            return status::status_no_error;
+        }
+
+
         // Helper Functions
+        const projection_spec_32f* ds4_projection::query_projection_spec(sizeI32 depth_size)
+        {
+            if (depth_size.width != m_depth_size.width || depth_size.height != m_depth_size.height) return nullptr;
+            // the built table is read without locking, the flag is set after the table is written
+            if (m_is_projection_spec_valid.load(std::memory_order_acquire)) return (const projection_spec_32f*)m_projection_spec;
+            std::lock_guard<std::recursive_mutex> auto_lock(m_cs_buffer);
+            if (m_is_projection_spec_valid) return (const projection_spec_32f*)m_projection_spec;
+
+            int projection_spec_size;
+            if (status::status_no_error != m_math_projection.rs_projection_get_size_32f(depth_size, &projection_spec_size)) return nullptr;
+            if (m_projection_spec_size < projection_spec_size)
+            {
+                if (m_projection_spec) aligned_free(m_projection_spec);
+                m_projection_spec = (uint8_t*)aligned_malloc(sizeof(uint8_t) * projection_spec_size);
+                if (!m_projection_spec)
+                {
+                    m_projection_spec_size = 0;
+                    return nullptr;
+                }
+                m_projection_spec_size = projection_spec_size;
+                memset(m_projection_spec, 0, projection_spec_size);
+            }
+            // the rays are recomputed only if the size or the camera parameters differ from the ones the table was built with
+            if (status::status_no_error != m_math_projection.rs_projection_init_32f(depth_size, m_camera_depth_params, 0, (projection_spec_32f*)m_projection_spec)) return nullptr;
+            m_is_projection_spec_valid.store(true, std::memory_order_release);
+            return (const projection_spec_32f*)m_projection_spec;
+        }
+
+        bool ds4_projection::is_roi_inside(const image_info & info, rect roi)
+        {
+            return roi.x >= 0 && roi.y >= 0 && roi.width > 0 && roi.height > 0 &&
+                   roi.x + roi.width <= info.width && roi.y + roi.height <= info.height;
+        }
+
+        pointF32* ds4_projection::query_uvmap_buffer(int32_t npoints)
+        {
+            std::vector<pointF32>& uvmap_buffer = thread_scratch().uvmap;
+            if (uvmap_buffer.size() < static_cast<size_t>(npoints))
+                uvmap_buffer.resize(npoints);
+            return uvmap_buffer.data();
+        }
+
+        std::unique_lock<std::recursive_mutex> ds4_projection::lock_incremental_registration()
+        {
+            if (!m_incremental_registration.enabled) return std::unique_lock<std::recursive_mutex>();
+            std::unique_lock<std::recursive_mutex> registration_lock(m_cs_buffer);
+            // the registration may have been disabled while the lock was taken
+            if (!m_incremental_registration.enabled) registration_lock.unlock();
+            return registration_lock;
+        }
+
         int ds4_projection::distorsion_ds_lms(float* Kc, float* invdistc, float* distc)
         {
             double dst[5];
@@ -2,12 +2,17 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #pragma once
+#include <atomic>
 #include <mutex>
 #include <vector>
+#include <functional>
 
 #include "rs/core/projection_interface.h"
 #include "rs/utils/ref_count_base.h"
+#include "rs/utils/smart_ptr_helpers.h"
 #include "math_projection_interface.h"
+#include "image_buffer_pool.h"
+#include "voxel_grid.h"
 
 namespace rs
 {
@@ -58,6 +63,42 @@ namespace rs
             return static_cast<initialize_status>(static_cast<int>(lhs) | static_cast<int>(rhs));
         }
 
+        /**
+         * @brief A product of a depth image which a projection attached to the image, computed by the first of its users.
+         *
+         * The users lock the product, the first computes it and the others wait for it, so a product is computed once per image.
+         * A mapped image product holds a reference to each color image it was mapped with, so a color image isn't confused with a
+         * later image allocated at the same address.
+         */
+        struct depth_image_product : public rs::utils::ref_count_base<ref_count_interface>
+        {
+            struct mapped_image
+            {
+                rs::utils::unique_ptr<image_interface> color;
+                rs::utils::unique_ptr<image_interface> mapped;
+            };
+
+            std::mutex                  lock;
+            bool                        is_computed = false;
+            status                      computed_status = status_no_error;
+            std::vector<pointF32>       uvmap;
+            std::vector<point3dF32>     vertices;
+            std::vector<mapped_image>   mapped_images;
+        };
+
+        /**
+         * @brief The buffer of a resident query output, written again by the projection only once its users released it.
+         */
+        template<typename T>
+        struct resident_output : public rs::utils::ref_count_base<projection_output_interface>
+        {
+            explicit resident_output(size_t npoints) : points(npoints) {}
+            const void * query_data() const override { return points.data(); }
+            int32_t query_points_count() const override { return static_cast<int32_t>(points.size()); }
+
+            std::vector<T> points;
+        };
+
         class ds4_projection : public rs::utils::release_self_base<projection_interface>
         {
         public:
@@ -72,19 +113,83 @@ namespace rs
             virtual status project_camera_to_depth(int32_t npoints, point3dF32 *pos3d, pointF32 *pos_uv);
             virtual status project_color_to_camera(int32_t npoints, point3dF32 *pos_ijz, point3dF32 *pos3d);
             virtual status project_camera_to_color(int32_t npoints, point3dF32 *pos3d, pointF32 *pos_ij);
+            virtual status project_camera_to_depth(int32_t npoints, const float *pos3d_x, const float *pos3d_y, const float *pos3d_z, float *pos_u, float *pos_v);
+            virtual status project_camera_to_color(int32_t npoints, const float *pos3d_x, const float *pos3d_y, const float *pos3d_z, float *pos_i, float *pos_j);
             virtual status map_depth_to_color(int32_t npoints, point3dF32 *pos_uvz, pointF32  *pos_ij);
             virtual status map_color_to_depth(image_interface *depth, int32_t npoints, pointF32 *pos_ij, pointF32 *pos_uv);
+            virtual status map_color_to_depth_sparse(image_interface *depth, int32_t npoints, pointF32 *pos_ij, pointF32 *pos_uv);
             virtual status query_uvmap(image_interface *depth, pointF32 *uvmap);
             virtual status query_invuvmap(image_interface *depth, pointF32 *inv_uvmap);
             virtual status query_vertices(image_interface *depth, point3dF32 *vertices);
             virtual image_interface* create_color_image_mapped_to_depth(image_interface *depth, image_interface *color);
             virtual image_interface* create_depth_image_mapped_to_color(image_interface *depth, image_interface *color);
+            virtual image_interface* create_color_image_mapped_to_depth(image_interface *depth, image_interface *color, uint8_t *data, int32_t pitch);
+            virtual image_interface* create_depth_image_mapped_to_color(image_interface *depth, image_interface *color, uint8_t *data, int32_t pitch);
+
+            /* region of interest */
+            virtual status query_uvmap(image_interface *depth, rect roi, pointF32 *uvmap, int32_t pitch);
+            virtual status query_vertices(image_interface *depth, rect roi, point3dF32 *vertices, int32_t pitch);
+            virtual image_interface* create_color_image_mapped_to_depth(image_interface *depth, image_interface *color, rect roi, uint8_t *data, int32_t pitch);
+            virtual image_interface* create_depth_image_mapped_to_color(image_interface *depth, image_interface *color, rect roi, uint8_t *data, int32_t pitch);
+
+            /* compact vertices */
+            virtual status query_vertices(image_interface *depth, rect roi, vertex_format format, void *vertices, int32_t pitch);
+            virtual status query_depth_rays(pointF32 *rays);
+            virtual status query_valid_vertices(image_interface *depth, point3dF32 *vertices, int32_t *pixel_indices, int32_t *nvertices);
+            virtual status query_voxelized_vertices(image_interface *depth, float voxel_size, point3dF32 *voxels, int32_t *nvoxels);
+
+            /* batch */
+            virtual status map_depth_to_color_batch(int32_t nbuffers, const int32_t *npoints, point3dF32 **pos_uvz, pointF32 **pos_ij);
+            virtual status project_camera_to_color_batch(int32_t nbuffers, const int32_t *npoints, point3dF32 **pos3d, pointF32 **pos_ij);
+            virtual status query_uvmap_batch(int32_t nframes, image_interface **depth, pointF32 **uvmap);
+            virtual status query_vertices_batch(int32_t nframes, image_interface **depth, point3dF32 **vertices);
+
+            /* projection owned output */
+            virtual status query_uvmap_resident(image_interface *depth, const projection_output_interface **uvmap);
+            virtual status query_vertices_resident(image_interface *depth, const projection_output_interface **vertices);
+
+            /* depth image attached output */
+            virtual status query_shared_uvmap(image_interface *depth, const pointF32 **uvmap);
+            virtual status query_shared_vertices(image_interface *depth, const point3dF32 **vertices);
+            virtual status query_shared_color_image_mapped_to_depth(image_interface *depth, image_interface *color, const image_interface **mapped);
+            virtual status query_shared_depth_image_mapped_to_color(image_interface *depth, image_interface *color, const image_interface **mapped);
+
+            /* registration */
+            virtual status set_incremental_registration(bool enable, uint16_t depth_threshold);
+            virtual status set_splatted_registration(bool enable, int32_t splat_size);
+            virtual status set_fixed_point_projection(bool enable);
 
         private:
             ds4_projection(const ds4_projection&) = delete;
             ds4_projection& operator=(const ds4_projection&) = delete;
 
             status init(bool isMirrored);
+            // returns the depth pixels rays table, built on first use after init, or null if depth_size isn't the initialized depth size
+            const projection_spec_32f* query_projection_spec(sizeI32 depth_size);
+            // returns the uvmap scratch buffer of the calling thread of at least npoints, valid until the thread's next call
+            static pointF32* query_uvmap_buffer(int32_t npoints);
+            // locks m_cs_buffer if the incremental registration is enabled, the returned lock doesn't own the mutex otherwise
+            std::unique_lock<std::recursive_mutex> lock_incremental_registration();
+            // the unchecked variants are called after the projection state and the arguments were validated
+            status map_depth_to_color_unchecked(int32_t npoints, point3dF32 *pos_uvz, pointF32 *pos_ij);
+            status project_camera_to_color_unchecked(int32_t npoints, point3dF32 *pos3d, pointF32 *pos_ij);
+            status query_uvmap_unchecked(image_interface *depth, const projection_spec_32f *projection_spec, pointF32 *uvmap);
+            status query_uvmap_roi_unchecked(image_interface *depth, const projection_spec_32f *projection_spec, rect roi, pointF32 *uvmap, int32_t pitch);
+            // projects a roi of the depth image to the unfiltered uvmap, depth_data points to the depth image origin and uvmap to the roi origin
+            status project_uvmap_roi(const uint16_t *depth_data, int32_t depth_pitch, rect roi, const projection_spec_32f *projection_spec, pointF32 *uvmap, int32_t uvmap_pitch);
+            // registers again the tiles of depth which changed since the last call, and rebuilds the cached inverse uvmap if needed
+            // registers again the tiles of depth which changed, the inverse mappings are left for their users to rebuild
+            status update_incremental_registration(image_interface *depth, sizeI32 color_size);
+            void release_incremental_registration();
+            const pointI32* query_fixed_point_rays(const projection_spec_32f *projection_spec);
+            status query_vertices_unchecked(image_interface *depth, const projection_spec_32f *projection_spec, point3dF32 *vertices);
+            status query_vertices_roi_unchecked(image_interface *depth, const projection_spec_32f *projection_spec, rect roi, vertex_format format, void *vertices, int32_t pitch);
+            static bool is_roi_inside(const image_info & info, rect roi);
+            // returns the product of the depth image attached by this projection, attaching an empty product for the first user
+            status acquire_shared_product(image_interface *depth, uint32_t id, rs::utils::unique_ptr<depth_image_product> & product);
+            status query_shared_mapped_image(image_interface *depth, image_interface *color, uint32_t id, const image_interface **mapped);
+            // calls item_function for each item index in parallel, returns the status of the first item which failed
+            static status for_each_item(int32_t nitems, const std::function<status(int32_t)> & item_function);
             int distorsion_ds_lms(float* Kc, float* invdistc, float* distc);
             int projection_ds_lms12(float* r, float* t, float* ir, float* it);
 
@@ -121,13 +226,41 @@ namespace rs
             float m_invtrans_color[3];   // Translation vector from Color to Depth camera
 
             // internal buffers
+            // the queries share the calibration state, which is set by the initialization and read only after it, and the lazily built
+            // tables, which are built once under m_cs_buffer and published by their atomic flags. the scratch buffers of the queries are
+            // per thread, so the queries of an instance shared by threads don't lock, except while the incremental registration is enabled
             uint8_t               *m_projection_spec; // Projection spec buffer used in QueryUVMap and QueryVertices
             int                   m_projection_spec_size;// Projection spec buffer size
-            pointF32              *m_buffer;         // Projection internal buffer
-            int32_t               m_buffer_size;     // Projection internal buffer size
-            std::recursive_mutex  m_cs_buffer;        // Projection internal buffer protection mutex
-            std::vector<pointI32> m_step_buffer;
-            pointI32              *m_sparse_invuvmap;
+            std::atomic<bool>     m_is_projection_spec_valid; // Projection spec matches the current depth camera parameters
+            std::recursive_mutex  m_cs_buffer;        // Guards the building of the tables, the resident outputs and the incremental registration
+            rs::utils::unique_ptr<resident_output<pointF32>>   m_resident_uvmap;    // Last UVMap of query_uvmap_resident
+            rs::utils::unique_ptr<resident_output<point3dF32>> m_resident_vertices; // Last vertices of query_vertices_resident
+            std::shared_ptr<image_buffer_pool> m_image_buffer_pool; // Data buffers of the mapped images, reused once an image is released
+            static const int32_t  MAX_REGISTRATION_SPLAT_SIZE = 8;
+            std::atomic<int32_t>  m_registration_splat_size; // Depth pixel splat edge of create_depth_image_mapped_to_color, 0 maps by the inverse uvmap
+            std::atomic<bool>     m_is_fixed_point_projection; // The uvmap and the vertices are projected in fixed point
+            std::vector<pointI32> m_fixed_point_rays;          // Q16 rays of the projection spec, built under m_cs_buffer
+            std::atomic<bool>     m_is_fixed_point_rays_valid; // Fixed point rays match the projection spec
+
+            // Registration state reused across frames by create_depth_image_mapped_to_color, guarded by m_cs_buffer
+            struct incremental_registration
+            {
+                std::atomic<bool>     enabled { false };  // read without the lock to decide whether to take it
+                uint16_t              depth_threshold = 0;
+                bool                  valid = false;      // the buffers match the initialized cameras
+                sizeI32               depth_size = { 0, 0 };
+                sizeI32               color_size = { 0, 0 };
+                std::vector<uint16_t> reference_depth;    // depth the uvmap was computed with
+                std::vector<pointF32> uvmap;              // uvmap before filtering
+                std::vector<pointF32> filtered_uvmap;     // uvmap as query_uvmap returns it
+                // the inverse mappings are rebuilt from the filtered uvmap on their first use after a tile was registered again
+                std::vector<pointF32> invuvmap;           // in color pixels, resampled by create_depth_image_mapped_to_color
+                bool                  invuvmap_current = false;
+                std::vector<pointF32> relative_invuvmap;  // as query_invuvmap returns it
+                bool                  relative_invuvmap_current = false;
+                std::vector<pointI32> sparse_invuvmap;    // nearest depth pixel of each color pixel, searched by map_color_to_depth
+                bool                  sparse_invuvmap_current = false;
+            } m_incremental_registration;
         };
 
     }
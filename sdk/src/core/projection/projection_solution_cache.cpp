@@ -0,0 +1,161 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include "projection_solution_cache.h"
+
+namespace rs
+{
+    namespace core
+    {
+        namespace
+        {
+            const uint32_t solution_file_marker = 0x4a505352; // "RSPJ"
+            const uint32_t solution_file_version = 1;
+
+            struct solution_file
+            {
+                uint32_t                marker;
+                uint32_t                version;
+                projection_solution_key key;
+                projection_solution     solution;
+            };
+
+            bool is_same_key(const projection_solution_key & first, const projection_solution_key & second)
+            {
+                return std::memcmp(&first, &second, sizeof(projection_solution_key)) == 0;
+            }
+
+            // FNV-1a of the key bytes
+            uint64_t hash_key(const projection_solution_key & key)
+            {
+                uint64_t hash = 14695981039346656037ull;
+                auto bytes = reinterpret_cast<const uint8_t *>(&key);
+                for(size_t i = 0; i < sizeof(projection_solution_key); i++)
+                {
+                    hash ^= bytes[i];
+                    hash *= 1099511628211ull;
+                }
+                return hash;
+            }
+        }
+
+        projection_solution_cache & projection_solution_cache::instance()
+        {
+            static projection_solution_cache cache;
+            return cache;
+        }
+
+        projection_solution_cache::projection_solution_cache()
+        {
+            const char * directory = std::getenv("RS_SDK_PROJECTION_CACHE_PATH");
+            if(directory)
+            {
+                m_directory = directory;
+            }
+        }
+
+        void projection_solution_cache::set_directory(const std::string & directory)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_directory = directory;
+        }
+
+        bool projection_solution_cache::find(const projection_solution_key & key, projection_solution & solution)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            for(auto & cached : m_solutions)
+            {
+                if(is_same_key(cached.first, key))
+                {
+                    solution = cached.second;
+                    return true;
+                }
+            }
+
+            if(!load(key, solution))
+            {
+                return false;
+            }
+            m_solutions.push_back(std::make_pair(key, solution));
+            return true;
+        }
+
+        void projection_solution_cache::insert(const projection_solution_key & key, const projection_solution & solution)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            for(auto & cached : m_solutions)
+            {
+                if(is_same_key(cached.first, key))
+                {
+                    return;
+                }
+            }
+            m_solutions.push_back(std::make_pair(key, solution));
+            store(key, solution);
+        }
+
+        std::string projection_solution_cache::get_file_path(const projection_solution_key & key) const
+        {
+            char file_name[64];
+            std::snprintf(file_name, sizeof(file_name), "projection_%016llx.bin", static_cast<unsigned long long>(hash_key(key)));
+            return m_directory + "/" + file_name;
+        }
+
+        bool projection_solution_cache::load(const projection_solution_key & key, projection_solution & solution) const
+        {
+            if(m_directory.empty())
+            {
+                return false;
+            }
+
+            std::ifstream file(get_file_path(key), std::ios::binary);
+            solution_file content = {};
+            if(!file.read(reinterpret_cast<char *>(&content), sizeof(content)))
+            {
+                return false;
+            }
+
+            //a hash collision or a file of another version is solved again
+            if(content.marker != solution_file_marker || content.version != solution_file_version || !is_same_key(content.key, key))
+            {
+                return false;
+            }
+            solution = content.solution;
+            return true;
+        }
+
+        void projection_solution_cache::store(const projection_solution_key & key, const projection_solution & solution) const
+        {
+            if(m_directory.empty())
+            {
+                return;
+            }
+
+            solution_file content = {};
+            content.marker = solution_file_marker;
+            content.version = solution_file_version;
+            content.key = key;
+            content.solution = solution;
+
+            //written to a temporary file and renamed, so a concurrent process never reads a partial file
+            auto file_path = get_file_path(key);
+            auto temporary_file_path = file_path + ".tmp";
+            {
+                std::ofstream file(temporary_file_path, std::ios::binary | std::ios::trunc);
+                if(!file.write(reinterpret_cast<const char *>(&content), sizeof(content)))
+                {
+                    return;
+                }
+            }
+            if(std::rename(temporary_file_path.c_str(), file_path.c_str()) != 0)
+            {
+                std::remove(temporary_file_path.c_str());
+            }
+        }
+    }
+}
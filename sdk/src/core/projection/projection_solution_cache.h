@@ -0,0 +1,61 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rs
+{
+    namespace core
+    {
+        // the inputs of the unrectified color fits of the projection initialization
+        struct projection_solution_key
+        {
+            float rotation[9];          // depth to color rotation
+            float translation[3];       // depth to color translation, in millimeters
+            float color_camera[4];      // normalized color focal lengths and principal point
+            float color_distortion[5];  // color distortion coefficients
+        };
+
+        // the outputs of the unrectified color fits
+        struct projection_solution
+        {
+            float invrot_color[9];
+            float invtrans_color[3];
+            float invdist_color_coeffs[5];
+        };
+
+        /**
+         * @brief The projection_solution_cache class
+         *
+         * Keeps the solved fits of each calibration for the process lifetime. If the RS_SDK_PROJECTION_CACHE_PATH environment variable
+         * names a directory, the solutions are also persisted there, a file per calibration hash, so later processes with the same camera
+         * calibration load them instead of fitting again. A persisted file is used only if it stores the same calibration.
+         */
+        class projection_solution_cache
+        {
+        public:
+            static projection_solution_cache & instance();
+
+            bool find(const projection_solution_key & key, projection_solution & solution);
+            void insert(const projection_solution_key & key, const projection_solution & solution);
+
+            // sets the directory of the persisted solutions, an empty directory keeps the solutions in memory only
+            void set_directory(const std::string & directory);
+        private:
+            projection_solution_cache();
+            projection_solution_cache(const projection_solution_cache &) = delete;
+            projection_solution_cache & operator=(const projection_solution_cache &) = delete;
+
+            std::string get_file_path(const projection_solution_key & key) const;
+            bool load(const projection_solution_key & key, projection_solution & solution) const;
+            void store(const projection_solution_key & key, const projection_solution & solution) const;
+
+            std::mutex m_lock;
+            std::vector<std::pair<projection_solution_key, projection_solution>> m_solutions; // guarded by m_lock
+            std::string m_directory; // guarded by m_lock
+        };
+    }
+}
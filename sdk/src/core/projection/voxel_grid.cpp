@@ -0,0 +1,84 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cmath>
+#include "voxel_grid.h"
+
+namespace rs
+{
+    namespace core
+    {
+        const uint64_t voxel_grid::EMPTY_KEY;
+
+        voxel_grid::voxel_grid() : m_inverse_voxel_size(1.f) {}
+
+        void voxel_grid::reset(float voxel_size, size_t max_points)
+        {
+            m_inverse_voxel_size = 1.f / voxel_size;
+
+            size_t table_size = 16;
+            while (table_size < 2 * max_points)
+                table_size <<= 1;
+            if (m_slots.size() < table_size)
+            {
+                voxel empty = {};
+                empty.key = EMPTY_KEY;
+                m_slots.assign(table_size, empty);
+            }
+            else
+            {
+                // only the occupied slots are cleared, the table is usually mostly free
+                for (auto slot : m_occupied_slots)
+                    m_slots[slot].key = EMPTY_KEY;
+            }
+            m_occupied_slots.clear();
+        }
+
+        void voxel_grid::add(float x, float y, float z)
+        {
+            const uint64_t key = get_key(x, y, z);
+            const size_t mask = m_slots.size() - 1;
+            // fibonacci hashing spreads the neighbouring voxels, which differ in the low bits of each coordinate
+            size_t slot = static_cast<size_t>((key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+            while (m_slots[slot].key != key && m_slots[slot].key != EMPTY_KEY)
+                slot = (slot + 1) & mask;
+
+            voxel & target = m_slots[slot];
+            if (target.key == EMPTY_KEY)
+            {
+                target.key = key;
+                target.sum[0] = target.sum[1] = target.sum[2] = 0.;
+                target.count = 0;
+                m_occupied_slots.push_back(static_cast<uint32_t>(slot));
+            }
+            target.sum[0] += x;
+            target.sum[1] += y;
+            target.sum[2] += z;
+            target.count++;
+        }
+
+        size_t voxel_grid::query_centroids(point3dF32 * centroids) const
+        {
+            for (size_t i = 0; i < m_occupied_slots.size(); i++)
+            {
+                const voxel & source = m_slots[m_occupied_slots[i]];
+                const double inverse_count = 1. / source.count;
+                centroids[i].x = static_cast<float>(source.sum[0] * inverse_count);
+                centroids[i].y = static_cast<float>(source.sum[1] * inverse_count);
+                centroids[i].z = static_cast<float>(source.sum[2] * inverse_count);
+            }
+            return m_occupied_slots.size();
+        }
+
+        uint64_t voxel_grid::get_key(float x, float y, float z) const
+        {
+            // 21 bits per coordinate, the voxel coordinates are biased to be non negative
+            const int64_t bias = 1 << 20;
+            const uint64_t coordinate_mask = (1 << 21) - 1;
+            const uint64_t ix = static_cast<uint64_t>(static_cast<int64_t>(std::floor(x * m_inverse_voxel_size)) + bias) & coordinate_mask;
+            const uint64_t iy = static_cast<uint64_t>(static_cast<int64_t>(std::floor(y * m_inverse_voxel_size)) + bias) & coordinate_mask;
+            const uint64_t iz = static_cast<uint64_t>(static_cast<int64_t>(std::floor(z * m_inverse_voxel_size)) + bias) & coordinate_mask;
+            return (ix << 42) | (iy << 21) | iz;
+        }
+    }
+}
@@ -0,0 +1,51 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "rs/core/types.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+         * @brief The voxel_grid class
+         *
+         * Accumulates 3d points into cubic voxels, and returns the centroid of the points of each occupied voxel. The voxels are kept in
+         * an open addressing hash table, which is sized for the expected number of points and reused by the next clouds, so binning a
+         * cloud doesn't allocate once the grid reached the cloud size. The centroids are returned in the order the voxels were first hit.
+         */
+        class voxel_grid
+        {
+        public:
+            voxel_grid();
+
+            // clears the voxels, and grows the table so the points can be added without rehashing
+            void reset(float voxel_size, size_t max_points);
+            void add(float x, float y, float z);
+            // the number of occupied voxels
+            size_t size() const { return m_occupied_slots.size(); }
+            // writes the centroid of each occupied voxel, returns the number of centroids
+            size_t query_centroids(point3dF32 * centroids) const;
+
+        private:
+            struct voxel
+            {
+                uint64_t key;           // the packed voxel coordinates, EMPTY_KEY if the slot is free
+                double   sum[3];
+                uint32_t count;
+            };
+
+            static const uint64_t EMPTY_KEY = 0xffffffffffffffffULL;
+
+            uint64_t get_key(float x, float y, float z) const;
+
+            float                   m_inverse_voxel_size;
+            std::vector<voxel>      m_slots;            // power of two size, at least twice the number of points
+            std::vector<uint32_t>   m_occupied_slots;   // in the order the voxels were first hit
+        };
+    }
+}
@@ -0,0 +1,84 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "rs_sdk_version.h"
+#include "rs/cv_modules/depth_filter_module/depth_filter_module.h"
+#include "depth_filter_module_impl.h"
+
+using namespace rs::core;
+using namespace rs::utils;
+
+namespace rs
+{
+    namespace cv_modules
+    {
+        depth_filter_module::depth_filter_module():
+            m_pimpl(new depth_filter_module_impl())
+        {}
+
+        int32_t depth_filter_module::query_module_uid()
+        {
+            return m_pimpl->query_module_uid();
+        }
+
+        status depth_filter_module::query_supported_module_config(int32_t idx, supported_module_config &supported_config)
+        {
+            return m_pimpl->query_supported_module_config(idx, supported_config);
+        }
+
+        status depth_filter_module::query_current_module_config(actual_module_config &module_config)
+        {
+            return m_pimpl->query_current_module_config(module_config);
+        }
+
+        status depth_filter_module::set_module_config(const actual_module_config &module_config)
+        {
+            return m_pimpl->set_module_config(module_config);
+        }
+
+        status depth_filter_module::process_sample_set(const correlated_sample_set& sample_set)
+        {
+            return m_pimpl->process_sample_set(sample_set);
+        }
+
+        status depth_filter_module::register_event_handler(video_module_interface::processing_event_handler *handler)
+        {
+            return m_pimpl->register_event_handler(handler);
+        }
+
+        status depth_filter_module::unregister_event_handler(video_module_interface::processing_event_handler *handler)
+        {
+            return m_pimpl->unregister_event_handler(handler);
+        }
+
+        core::status depth_filter_module::flush_resources()
+        {
+            return m_pimpl->flush_resources();
+        }
+
+        core::status depth_filter_module::reset_config()
+        {
+            return m_pimpl->reset_config();
+        }
+
+        core::status depth_filter_module::set_options(const depth_filter_options & options)
+        {
+            return m_pimpl->set_options(options);
+        }
+
+        depth_filter_output_interface::depth_filter_options depth_filter_module::query_options()
+        {
+            return m_pimpl->query_options();
+        }
+
+        core::image_interface * depth_filter_module::query_filtered_depth_image()
+        {
+            return m_pimpl->query_filtered_depth_image();
+        }
+
+        depth_filter_module::~depth_filter_module()
+        {
+            delete m_pimpl;
+        }
+    }
+}
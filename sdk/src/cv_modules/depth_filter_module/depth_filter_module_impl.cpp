@@ -0,0 +1,304 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include <algorithm>
+
+#include "depth_filter_module_impl.h"
+#include "rs/utils/log_utils.h"
+
+using namespace rs::core;
+using namespace rs::utils;
+
+namespace
+{
+    const uint32_t MAX_SPATIAL_ITERATIONS = 5;
+    const uint32_t MAX_PERSISTENCE_FRAMES = 8;
+
+    //the filtered images of a few frames are held by the application at a time
+    const size_t MAX_FREE_BUFFER_BYTES = 16 << 20;
+
+    bool is_alpha_valid(float alpha)
+    {
+        return alpha > 0 && alpha <= 1;
+    }
+
+    //the pyramid level of the decimation factor, 0 if the factor isn't supported
+    uint32_t query_decimation_level(uint32_t decimation_factor)
+    {
+        switch(decimation_factor)
+        {
+            case 2: return 1;
+            case 4: return 2;
+            case 8: return 3;
+            default: return 0;
+        }
+    }
+}
+
+namespace rs
+{
+    namespace cv_modules
+    {
+        depth_filter_module_impl::depth_filter_module_impl():
+            m_current_module_config({}),
+            m_processing_handler(nullptr),
+            m_options(depth_filter_output_interface::query_default_options()),
+            m_buffer_pool(image_buffer_pool::create(MAX_FREE_BUFFER_BYTES)),
+            m_temporal_decimation_factor(1)
+        {
+            m_unique_module_id = CONSTRUCT_UID('D', 'F', 'L', 'T');
+        }
+
+        int32_t depth_filter_module_impl::query_module_uid()
+        {
+            return m_unique_module_id;
+        }
+
+        status depth_filter_module_impl::query_supported_module_config(int32_t idx, supported_module_config &supported_config)
+        {
+            if(idx != 0)
+            {
+                return status_item_unavailable;
+            }
+
+            supported_config = {};
+
+            //the module holds the depth image only while it's filtered
+            supported_config.concurrent_samples_count = 1;
+            supported_config.samples_time_sync_mode = supported_module_config::time_sync_mode::sync_not_required;
+            supported_config.async_processing = false;
+
+            //a slower processing drops the older depth images, so the filtered depth isn't delayed
+            supported_config.queue_policy = supported_module_config::samples_queue_policy::keep_latest;
+            supported_config.queue_depth = 1;
+
+            //no restriction to specific camera or depth resolution
+            std::memset(supported_config.device_name, 0, sizeof(supported_config.device_name));
+
+            video_module_interface::supported_image_stream_config & depth_desc = supported_config[stream_type::depth];
+            depth_desc.flags = sample_flags::none;
+            depth_desc.is_enabled = true;
+            return status_no_error;
+        }
+
+        status depth_filter_module_impl::query_current_module_config(actual_module_config &module_config)
+        {
+            module_config = m_current_module_config;
+            return status_no_error;
+        }
+
+        status depth_filter_module_impl::set_module_config(const actual_module_config &module_config)
+        {
+            auto depth_config = module_config.image_streams_configs[static_cast<uint32_t>(stream_type::depth)];
+            if(depth_config.is_enabled == false)
+            {
+                return status_param_unsupported;
+            }
+
+            m_current_module_config = module_config;
+            return status_no_error;
+        }
+
+        status depth_filter_module_impl::process_sample_set(const correlated_sample_set & sample_set)
+        {
+            image_interface * depth_image = sample_set[stream_type::depth];
+            if(!depth_image)
+            {
+                return status_item_unavailable;
+            }
+
+            image_interface * filtered_image = nullptr;
+            auto status = filter_depth_image(depth_image, &filtered_image);
+            if(status < status_no_error)
+            {
+                return status;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_output_lock);
+                m_filtered_depth_image = get_unique_ptr_with_releaser(filtered_image);
+            }
+
+            std::lock_guard<std::mutex> lock(m_processing_handler_lock);
+            if(m_processing_handler)
+            {
+                m_processing_handler->module_output_ready(this, nullptr);
+            }
+            return status_no_error;
+        }
+
+        status depth_filter_module_impl::register_event_handler(video_module_interface::processing_event_handler *handler)
+        {
+            std::lock_guard<std::mutex> lock(m_processing_handler_lock);
+            if(m_processing_handler != nullptr)
+            {
+                return status_handle_invalid;
+            }
+            m_processing_handler = handler;
+            return status_no_error;
+        }
+
+        status depth_filter_module_impl::unregister_event_handler(video_module_interface::processing_event_handler *handler)
+        {
+            std::lock_guard<std::mutex> lock(m_processing_handler_lock);
+            if(m_processing_handler != handler)
+            {
+                return status_handle_invalid;
+            }
+
+            m_processing_handler = nullptr;
+            return status_no_error;
+        }
+
+        status depth_filter_module_impl::flush_resources()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_output_lock);
+                m_filtered_depth_image.reset();
+            }
+            std::lock_guard<std::mutex> lock(m_processing_lock);
+            m_temporal_state = {};
+            m_buffer_pool->set_max_free_bytes(0);
+            m_buffer_pool->set_max_free_bytes(MAX_FREE_BUFFER_BYTES);
+            return status_no_error;
+        }
+
+        status depth_filter_module_impl::reset_config()
+        {
+            return status_no_error;
+        }
+
+        status depth_filter_module_impl::set_options(const depth_filter_options & options)
+        {
+            if(query_decimation_level(options.decimation_factor) == 0 && options.decimation_factor != 1)
+            {
+                return status_param_unsupported;
+            }
+            if(options.spatial_filter && (!is_alpha_valid(options.spatial_alpha) ||
+                                          options.spatial_iterations == 0 || options.spatial_iterations > MAX_SPATIAL_ITERATIONS))
+            {
+                return status_param_unsupported;
+            }
+            if(options.temporal_filter && (!is_alpha_valid(options.temporal_alpha) || options.persistence_frames > MAX_PERSISTENCE_FRAMES))
+            {
+                return status_param_unsupported;
+            }
+
+            std::lock_guard<std::mutex> lock(m_options_lock);
+            m_options = options;
+            return status_no_error;
+        }
+
+        depth_filter_output_interface::depth_filter_options depth_filter_module_impl::query_options()
+        {
+            std::lock_guard<std::mutex> lock(m_options_lock);
+            return m_options;
+        }
+
+        image_interface * depth_filter_module_impl::query_filtered_depth_image()
+        {
+            std::lock_guard<std::mutex> lock(m_output_lock);
+            if(!m_filtered_depth_image)
+            {
+                return nullptr;
+            }
+            m_filtered_depth_image->add_ref();
+            return m_filtered_depth_image.get();
+        }
+
+        status depth_filter_module_impl::filter_depth_image(image_interface * depth_image, image_interface ** filtered_image)
+        {
+            if(depth_image->query_info().format != pixel_format::z16)
+            {
+                return status_param_unsupported;
+            }
+
+            depth_filter_options options;
+            {
+                std::lock_guard<std::mutex> lock(m_options_lock);
+                options = m_options;
+            }
+
+            //the decimated image is a level of the depth image pyramid, shared with the other modules which downscale the depth image
+            rs::utils::unique_ptr<const image_interface> decimated_image;
+            const image_interface * source_image = depth_image;
+            const uint32_t decimation_level = query_decimation_level(options.decimation_factor);
+            if(decimation_level > 0)
+            {
+                const image_interface * level_image = nullptr;
+                auto status = depth_image->query_pyramid_level(decimation_level, &level_image);
+                if(status < status_no_error)
+                {
+                    return status;
+                }
+                decimated_image = get_unique_ptr_with_releaser(level_image);
+                source_image = level_image;
+            }
+
+            const image_info source_info = source_image->query_info();
+            image_info info = { source_info.width, source_info.height, pixel_format::z16, source_info.width * 2 };
+            const size_t size = static_cast<size_t>(info.pitch) * info.height;
+
+            std::lock_guard<std::mutex> lock(m_processing_lock);
+            release_interface * data_releaser = nullptr;
+            uint16_t * data = nullptr;
+            try
+            {
+                data = reinterpret_cast<uint16_t *>(m_buffer_pool->acquire(size, data_releaser));
+            }
+            catch(const std::bad_alloc & ex)
+            {
+                LOG_ERROR(ex.what())
+                return status_exec_aborted;
+            }
+
+            //the filters run in place on the output buffer
+            const uint8_t * source_data = static_cast<const uint8_t *>(source_image->query_data());
+            for(int y = 0; y < info.height; y++)
+            {
+                std::memcpy(reinterpret_cast<uint8_t *>(data) + static_cast<size_t>(y) * info.pitch,
+                            source_data + static_cast<size_t>(y) * source_info.pitch, static_cast<size_t>(info.pitch));
+            }
+
+            if(options.spatial_filter)
+            {
+                const int weight = depth_filters::to_weight(options.spatial_alpha);
+                for(uint32_t iteration = 0; iteration < options.spatial_iterations; iteration++)
+                {
+                    depth_filters::spatial_filter(data, info.width, info.height, info.pitch, weight, options.spatial_delta);
+                }
+            }
+            if(options.temporal_filter)
+            {
+                if(m_temporal_decimation_factor != options.decimation_factor)
+                {
+                    m_temporal_state = {};
+                    m_temporal_decimation_factor = options.decimation_factor;
+                }
+                depth_filters::temporal_filter(data, info.width, info.height, info.pitch, depth_filters::to_weight(options.temporal_alpha),
+                                               options.temporal_delta, options.persistence_frames, m_temporal_state);
+            }
+            else
+            {
+                m_temporal_state = {};
+            }
+            if(options.hole_filling)
+            {
+                depth_filters::fill_holes(data, info.width, info.height, info.pitch);
+            }
+
+            *filtered_image = image_interface::create_instance_from_raw_data(&info, {data, data_releaser},
+                                                                             stream_type::depth,
+                                                                             depth_image->query_flags(),
+                                                                             depth_image->query_time_stamp(),
+                                                                             depth_image->query_frame_number(),
+                                                                             depth_image->query_time_stamp_domain());
+            return status_no_error;
+        }
+
+        depth_filter_module_impl::~depth_filter_module_impl()
+        {
+        }
+    }
+}
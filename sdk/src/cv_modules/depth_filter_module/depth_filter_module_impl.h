@@ -0,0 +1,87 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <memory>
+#include <mutex>
+
+#include "rs/cv_modules/depth_filter_module/depth_filter_output_interface.h"
+#include "rs_core.h"
+#include "rs_utils.h"
+#include "image_buffer_pool.h"
+#include "depth_filters.h"
+
+#ifdef WIN32
+#ifdef realsense_depth_filter_module_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_depth_filter_module_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace cv_modules
+    {
+        /**
+         * @brief The depth_filter_module_impl class
+         * post-processes the depth images with the depth filters, synchronously in the processing call.
+         */
+        class DLL_EXPORT depth_filter_module_impl : public rs::core::video_module_interface,
+                                                    public depth_filter_output_interface
+        {
+        public:
+            depth_filter_module_impl(const depth_filter_module_impl & other) = delete;
+            depth_filter_module_impl & operator=(const depth_filter_module_impl & other) = delete;
+            depth_filter_module_impl(depth_filter_module_impl && other) = delete;
+            depth_filter_module_impl & operator=(depth_filter_module_impl && other) = delete;
+
+            depth_filter_module_impl();
+
+            // video_module_interface impl
+            int32_t query_module_uid() override;
+            rs::core::status query_supported_module_config(int32_t idx,
+                    rs::core::video_module_interface::supported_module_config &supported_config) override;
+            rs::core::status query_current_module_config(rs::core::video_module_interface::actual_module_config &module_config) override;
+            rs::core::status set_module_config(const rs::core::video_module_interface::actual_module_config &module_config) override;
+            rs::core::status process_sample_set(const rs::core::correlated_sample_set& sample_set) override;
+            rs::core::status register_event_handler(rs::core::video_module_interface::processing_event_handler *handler) override;
+            rs::core::status unregister_event_handler(rs::core::video_module_interface::processing_event_handler *handler) override;
+            rs::core::status flush_resources() override;
+            rs::core::status reset_config() override;
+
+            // depth_filter_output_interface impl
+            rs::core::status set_options(const depth_filter_options & options) override;
+            depth_filter_options query_options() override;
+            rs::core::image_interface * query_filtered_depth_image() override;
+
+            ~depth_filter_module_impl();
+
+        protected:
+            //filters a copy of the depth image into a pooled buffer
+            rs::core::status filter_depth_image(rs::core::image_interface * depth_image, rs::core::image_interface ** filtered_image);
+
+            int32_t m_unique_module_id;
+            rs::core::video_module_interface::actual_module_config m_current_module_config;
+
+        private:
+            std::mutex m_processing_handler_lock;
+            rs::core::video_module_interface::processing_event_handler * m_processing_handler;
+
+            //the options are copied at the start of each image processing
+            std::mutex m_options_lock;
+            depth_filter_options m_options;
+
+            //the processing state, a single image is processed at a time
+            std::mutex m_processing_lock;
+            std::shared_ptr<rs::core::image_buffer_pool> m_buffer_pool;
+            depth_filters::temporal_state m_temporal_state;
+            uint32_t m_temporal_decimation_factor; //the decimation factor of the temporal history
+
+            std::mutex m_output_lock;
+            rs::utils::unique_ptr<rs::core::image_interface> m_filtered_depth_image;
+        };
+    }
+}
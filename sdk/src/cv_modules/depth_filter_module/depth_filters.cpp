@@ -0,0 +1,159 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "depth_filters.h"
+#include "image_rows_bands.h"
+
+//see image_conversion_util.cpp, the kernels are vectorized by the compiler for each instruction set
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 6) && defined(__x86_64__) && defined(__linux__)
+#define DEPTH_FILTER_KERNEL __attribute__((target_clones("avx2","default")))
+#else
+#define DEPTH_FILTER_KERNEL
+#endif
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace cv_modules
+    {
+        namespace
+        {
+            inline uint16_t * row_of(uint16_t * data, int pitch, int row)
+            {
+                return reinterpret_cast<uint16_t *>(reinterpret_cast<uint8_t *>(data) + static_cast<size_t>(row) * pitch);
+            }
+
+            //moves the depth toward the smoothed neighbour depth, unless one of them is a hole or they're across an edge
+            inline uint16_t smooth(int depth, int neighbour, int weight, int delta)
+            {
+                const int difference = depth - neighbour;
+                const bool is_smoothed = depth != 0 && neighbour != 0 && std::abs(difference) <= delta;
+                return static_cast<uint16_t>(is_smoothed ? neighbour + ((difference * weight) >> 8) : depth);
+            }
+
+            //each pixel depends on the previous pixel of its row, the rows are independent
+            void smooth_rows(uint16_t * data, int width, int pitch, int begin_row, int end_row, int weight, int delta)
+            {
+                for(int y = begin_row; y < end_row; y++)
+                {
+                    uint16_t * row = row_of(data, pitch, y);
+                    for(int x = 1; x < width; x++)
+                    {
+                        row[x] = smooth(row[x], row[x - 1], weight, delta);
+                    }
+                    for(int x = width - 2; x >= 0; x--)
+                    {
+                        row[x] = smooth(row[x], row[x + 1], weight, delta);
+                    }
+                }
+            }
+
+            //each pixel depends on the pixel above or below it, the columns of a row are independent and are smoothed together
+            DEPTH_FILTER_KERNEL void smooth_row_toward(uint16_t * row, const uint16_t * neighbour_row, int begin_column, int end_column, int weight, int delta)
+            {
+                for(int x = begin_column; x < end_column; x++)
+                {
+                    row[x] = smooth(row[x], neighbour_row[x], weight, delta);
+                }
+            }
+
+            void smooth_columns(uint16_t * data, int height, int pitch, int begin_column, int end_column, int weight, int delta)
+            {
+                for(int y = 1; y < height; y++)
+                {
+                    smooth_row_toward(row_of(data, pitch, y), row_of(data, pitch, y - 1), begin_column, end_column, weight, delta);
+                }
+                for(int y = height - 2; y >= 0; y--)
+                {
+                    smooth_row_toward(row_of(data, pitch, y), row_of(data, pitch, y + 1), begin_column, end_column, weight, delta);
+                }
+            }
+
+            inline uint32_t count_bits(uint32_t bits)
+            {
+                bits = bits - ((bits >> 1) & 0x55);
+                bits = (bits & 0x33) + ((bits >> 2) & 0x33);
+                return (bits + (bits >> 4)) & 0x0f;
+            }
+
+            DEPTH_FILTER_KERNEL void temporal_filter_row(uint16_t * row, uint16_t * history, uint8_t * valid_history, int width,
+                                                         int weight, int delta, uint32_t persistence_frames)
+            {
+                for(int x = 0; x < width; x++)
+                {
+                    const int depth = row[x];
+                    const int previous = history[x];
+                    const uint32_t valid_frames = valid_history[x];
+                    uint16_t filtered = smooth(depth, previous, weight, delta);
+                    //persistence_frames 0 never fills a hole, a pixel is valid in at most 8 frames
+                    const bool is_persisted = depth == 0 && persistence_frames != 0 && count_bits(valid_frames) >= persistence_frames;
+                    filtered = is_persisted ? static_cast<uint16_t>(previous) : filtered;
+                    valid_history[x] = static_cast<uint8_t>((valid_frames << 1) | (depth != 0 ? 1u : 0u));
+                    history[x] = filtered;
+                    row[x] = filtered;
+                }
+            }
+        }
+
+        int depth_filters::to_weight(float alpha)
+        {
+            return std::max(1, std::min(WEIGHT_ONE, static_cast<int>(std::lround(alpha * WEIGHT_ONE))));
+        }
+
+        void depth_filters::spatial_filter(uint16_t * data, int width, int height, int pitch, int weight, uint16_t delta)
+        {
+            const int number_of_bands = image_rows_bands::query_number_of_bands(width, height);
+            image_rows_bands::for_each(height, number_of_bands, [&](int band, int begin_row, int end_row)
+            {
+                smooth_rows(data, width, pitch, begin_row, end_row, weight, delta);
+            });
+            //the column strips are split like the row bands
+            image_rows_bands::for_each(width, number_of_bands, [&](int band, int begin_column, int end_column)
+            {
+                smooth_columns(data, height, pitch, begin_column, end_column, weight, delta);
+            });
+        }
+
+        void depth_filters::temporal_filter(uint16_t * data, int width, int height, int pitch, int weight, uint16_t delta,
+                                            uint32_t persistence_frames, temporal_state & state)
+        {
+            const size_t pixels = static_cast<size_t>(width) * height;
+            if(state.history.size() != pixels)
+            {
+                //the first frame of a size passes through, and starts the history
+                state.history.assign(pixels, 0);
+                state.valid_history.assign(pixels, 0);
+            }
+            image_rows_bands::for_each(height, image_rows_bands::query_number_of_bands(width, height), [&](int band, int begin_row, int end_row)
+            {
+                for(int y = begin_row; y < end_row; y++)
+                {
+                    const size_t offset = static_cast<size_t>(y) * width;
+                    temporal_filter_row(row_of(data, pitch, y), state.history.data() + offset, state.valid_history.data() + offset, width,
+                                        weight, delta, persistence_frames);
+                }
+            });
+        }
+
+        void depth_filters::fill_holes(uint16_t * data, int width, int height, int pitch)
+        {
+            image_rows_bands::for_each(height, image_rows_bands::query_number_of_bands(width, height), [&](int band, int begin_row, int end_row)
+            {
+                for(int y = begin_row; y < end_row; y++)
+                {
+                    uint16_t * row = row_of(data, pitch, y);
+                    uint16_t last_valid = 0;
+                    for(int x = 0; x < width; x++)
+                    {
+                        last_valid = row[x] ? row[x] : last_valid;
+                        row[x] = last_valid;
+                    }
+                }
+            });
+        }
+    }
+}
@@ -0,0 +1,48 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+namespace rs
+{
+    namespace cv_modules
+    {
+        /**
+         * @brief The depth post-processing filters, which filter a z16 image in place.
+         *
+         * The image pitch is in bytes, and the weights are fixed point, in 1/256 units. Zero depth is a hole, the filters never smooth across a hole or an edge.
+         * Each filter splits the image between the hardware threads, the row passes in row bands and the column passes in column
+         * strips, so each inner loop runs over independent pixels and is vectorized by the compiler.
+         */
+        class depth_filters
+        {
+            depth_filters() = delete;
+        public:
+            static const int WEIGHT_ONE = 256;
+
+            // converts a filter alpha in (0, 1] to a fixed point weight
+            static int to_weight(float alpha);
+
+            // smooths each pixel toward its smoothed neighbour along the rows then along the columns, in both directions
+            static void spatial_filter(uint16_t * data, int width, int height, int pitch, int weight, uint16_t delta);
+
+            /**
+             * @brief The temporal filter state of an image size.
+             */
+            struct temporal_state
+            {
+                std::vector<uint16_t> history;          // the last filtered depth of each pixel
+                std::vector<uint8_t>  valid_history;    // a bit per the last 8 frames, set if the pixel was valid
+            };
+
+            // averages each pixel with its history, and fills the holes of pixels which were valid in at least persistence_frames of the last 8 frames
+            static void temporal_filter(uint16_t * data, int width, int height, int pitch, int weight, uint16_t delta,
+                                        uint32_t persistence_frames, temporal_state & state);
+
+            // fills each hole with the nearest valid depth on its left
+            static void fill_holes(uint16_t * data, int width, int height, int pitch);
+        };
+    }
+}
@@ -3,6 +3,7 @@
 
 #include "rs_sdk_version.h"
 #include "rs/cv_modules/max_depth_value_module/max_depth_value_module.h"
+#include "rs/core/video_module_plugin.h"
 #include "max_depth_value_module_impl.h"
 
 using namespace rs::core;
@@ -66,6 +67,16 @@ namespace rs
             return m_pimpl->get_max_depth_value_data();
         }
 
+        core::status max_depth_value_module::set_roi(const core::rect & roi)
+        {
+            return m_pimpl->set_roi(roi);
+        }
+
+        core::status max_depth_value_module::set_number_of_processing_threads(uint32_t number_of_threads)
+        {
+            return m_pimpl->set_number_of_processing_threads(number_of_threads);
+        }
+
         max_depth_value_module::~max_depth_value_module()
         {
             delete m_pimpl;
@@ -73,3 +84,5 @@ namespace rs
     }
 }
 
+
+RS_VIDEO_MODULE_PLUGIN(rs::cv_modules::max_depth_value_module)
@@ -5,15 +5,91 @@
 #include <thread>
 #include <cstring>
 #include <vector>
+#include <algorithm>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 #include "max_depth_value_module_impl.h"
+#include "image_rows_bands.h"
 #include "rs/utils/log_utils.h"
+#include "rs/utils/thread_config.h"
 
 #define NOMINMAX
 
 using namespace rs::core;
 using namespace rs::utils;
 
+namespace
+{
+    const uint32_t MAX_PROCESSING_THREADS = 16;
+
+    //the max value of a row of z16 pixels, the vector loop handles the row body and the scalar loop the tail
+    uint16_t row_max_value(const uint16_t * row, int32_t width, uint16_t max_value)
+    {
+        int32_t x = 0;
+#if defined(__AVX2__)
+        __m256i max_vector = _mm256_set1_epi16(static_cast<short>(max_value));
+        for(; x + 16 <= width; x += 16)
+        {
+            max_vector = _mm256_max_epu16(max_vector, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + x)));
+        }
+        __m128i max_half = _mm_max_epu16(_mm256_castsi256_si128(max_vector), _mm256_extracti128_si256(max_vector, 1));
+        //the min of the inverted values is the max, _mm_minpos_epu16 reduces the 8 lanes
+        max_value = static_cast<uint16_t>(~_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(max_half, _mm_set1_epi16(-1)))));
+#elif defined(__SSE4_1__)
+        __m128i max_vector = _mm_set1_epi16(static_cast<short>(max_value));
+        for(; x + 8 <= width; x += 8)
+        {
+            max_vector = _mm_max_epu16(max_vector, _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x)));
+        }
+        max_value = static_cast<uint16_t>(~_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_xor_si128(max_vector, _mm_set1_epi16(-1)))));
+#elif defined(__SSE2__)
+        //sse2 has only a signed 16 bit max, flipping the sign bit maps the unsigned order to the signed order
+        const __m128i sign_bit = _mm_set1_epi16(static_cast<short>(0x8000));
+        __m128i max_vector = _mm_xor_si128(_mm_set1_epi16(static_cast<short>(max_value)), sign_bit);
+        for(; x + 8 <= width; x += 8)
+        {
+            max_vector = _mm_max_epi16(max_vector, _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x)), sign_bit));
+        }
+        max_vector = _mm_max_epi16(max_vector, _mm_srli_si128(max_vector, 8));
+        max_vector = _mm_max_epi16(max_vector, _mm_srli_si128(max_vector, 4));
+        max_vector = _mm_max_epi16(max_vector, _mm_srli_si128(max_vector, 2));
+        max_value = static_cast<uint16_t>(_mm_cvtsi128_si32(max_vector) ^ 0x8000);
+#elif defined(__ARM_NEON)
+        uint16x8_t max_vector = vdupq_n_u16(max_value);
+        for(; x + 8 <= width; x += 8)
+        {
+            max_vector = vmaxq_u16(max_vector, vld1q_u16(row + x));
+        }
+        uint16x4_t max_half = vmax_u16(vget_low_u16(max_vector), vget_high_u16(max_vector));
+        max_half = vpmax_u16(max_half, max_half);
+        max_half = vpmax_u16(max_half, max_half);
+        max_value = vget_lane_u16(max_half, 0);
+#endif
+        for(; x < width; x++)
+        {
+            max_value = std::max(max_value, row[x]);
+        }
+        return max_value;
+    }
+
+    uint16_t rows_max_value(const uint8_t * data, int32_t pitch, int32_t x, int32_t width, int32_t first_row, int32_t last_row)
+    {
+        uint16_t max_value = 0;
+        for(auto y = first_row; y < last_row; y++)
+        {
+            max_value = row_max_value(reinterpret_cast<const uint16_t *>(data + y * pitch) + x, width, max_value);
+        }
+        return max_value;
+    }
+}
+
 namespace rs
 {
     namespace cv_modules
@@ -24,7 +100,9 @@ namespace rs
             m_is_closing(false),
             m_output_data({}),
             m_input_depth_image(nullptr),
-            m_milliseconds_added_to_simulate_larger_computation_time(milliseconds_added_to_simulate_larger_computation_time)
+            m_milliseconds_added_to_simulate_larger_computation_time(milliseconds_added_to_simulate_larger_computation_time),
+            m_roi({}),
+            m_number_of_processing_threads(1)
         {
             m_unique_module_id = CONSTRUCT_UID('M', 'A', 'X', 'D');
             m_async_processing = is_async_processing;
@@ -159,6 +237,30 @@ namespace rs
             return m_output_data.blocking_get();
         }
 
+        status max_depth_value_module_impl::set_roi(const rect & roi)
+        {
+            if(roi.x < 0 || roi.y < 0 || roi.width < 0 || roi.height < 0)
+            {
+                return status_invalid_argument;
+            }
+
+            std::lock_guard<std::mutex> lock(m_processing_params_lock);
+            m_roi = roi;
+            return status_no_error;
+        }
+
+        status max_depth_value_module_impl::set_number_of_processing_threads(uint32_t number_of_threads)
+        {
+            if(number_of_threads == 0 || number_of_threads > MAX_PROCESSING_THREADS)
+            {
+                return status_param_unsupported;
+            }
+
+            std::lock_guard<std::mutex> lock(m_processing_params_lock);
+            m_number_of_processing_threads = number_of_threads;
+            return status_no_error;
+        }
+
         status max_depth_value_module_impl::process_depth_max_value(
                 std::shared_ptr<core::image_interface> depth_image,
                 max_depth_value_output_interface::max_depth_value_output_data & output_data)
@@ -168,28 +270,41 @@ namespace rs
                 return status_data_not_initialized;
             }
 
+            rect roi;
+            uint32_t number_of_threads;
+            {
+                std::lock_guard<std::mutex> lock(m_processing_params_lock);
+                roi = m_roi;
+                number_of_threads = m_number_of_processing_threads;
+            }
+
             //calculate max depth value
             uint16_t max_depth_value = std::numeric_limits<uint16_t>::min();
             //protect algorithm exception safety
             try
             {
-                const uint8_t * current_pixel = static_cast<const uint8_t * >(depth_image->query_data());
+                const uint8_t * data = static_cast<const uint8_t * >(depth_image->query_data());
                 auto depth_image_info = depth_image->query_info();
 
-                for(auto y = 0; y < depth_image_info.height; y++)
+                //clamp the roi to the image, an empty roi is the whole image
+                if(roi.width == 0 || roi.height == 0)
                 {
-                    for(auto x = 0; x < depth_image_info.width; x+=2)
-                    {
-                        auto pixel_with_pitch_allignment = y * depth_image_info.pitch + x;
-                        //combine 2 uint8_t to uint16_t
-                        uint16_t current_pixel_value =  static_cast<uint16_t>(current_pixel[pixel_with_pitch_allignment] | current_pixel[pixel_with_pitch_allignment + 1] << 8);
-
-                        if(current_pixel_value > max_depth_value)
-                        {
-                            max_depth_value = current_pixel_value ;
-                        }
-                    }
+                    roi = { 0, 0, depth_image_info.width, depth_image_info.height };
                 }
+                auto first_column = std::min(roi.x, depth_image_info.width);
+                auto first_row = std::min(roi.y, depth_image_info.height);
+                auto width = std::min(roi.width, depth_image_info.width - first_column);
+                auto last_row = first_row + std::min(roi.height, depth_image_info.height - first_row);
+
+                //split the rows to bands, which run on the calling thread and on the shared image bands workers
+                auto rows_count = last_row - first_row;
+                auto bands_count = std::max<int32_t>(1, std::min<int32_t>(static_cast<int32_t>(number_of_threads), rows_count));
+                std::vector<uint16_t> bands_max_values(bands_count, std::numeric_limits<uint16_t>::min());
+                image_rows_bands::for_each(rows_count, bands_count, [&](int band, int begin_row, int end_row)
+                {
+                    bands_max_values[band] = rows_max_value(data, depth_image_info.pitch, first_column, width, first_row + begin_row, first_row + end_row);
+                });
+                max_depth_value = *std::max_element(bands_max_values.begin(), bands_max_values.end());
 
                 //simulate larger computation time
                 std::this_thread::sleep_for(std::chrono::milliseconds(m_milliseconds_added_to_simulate_larger_computation_time));
@@ -206,6 +321,7 @@ namespace rs
 
         void max_depth_value_module_impl::async_processing_loop()
         {
+            rs::utils::thread_configuration::apply(rs::utils::thread_role::cv_module, "rs-max-depth");
             while(!m_is_closing)
             {
                 auto current_depth_image = m_input_depth_image.blocking_get();
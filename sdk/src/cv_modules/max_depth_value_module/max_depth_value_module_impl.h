@@ -55,6 +55,9 @@ namespace rs
             // max_depth_value_module_output_interface impl
             max_depth_value_output_data get_max_depth_value_data() override;
 
+            rs::core::status set_roi(const rs::core::rect & roi);
+            rs::core::status set_number_of_processing_threads(uint32_t number_of_threads);
+
             ~max_depth_value_module_impl();
 
         protected:
@@ -116,6 +119,11 @@ namespace rs
         private:
             const uint64_t m_milliseconds_added_to_simulate_larger_computation_time;
             std::mutex m_processing_handler_lock;
+
+            //the processing parameters are copied at the start of each image processing
+            std::mutex m_processing_params_lock;
+            rs::core::rect m_roi; //zero width or height means the whole image
+            uint32_t m_number_of_processing_threads;
             rs::core::video_module_interface::processing_event_handler * m_processing_handler;
 
             //thread for handling inputs throughput in async flow
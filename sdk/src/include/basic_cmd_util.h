@@ -44,6 +44,7 @@ namespace rs
             size_t get_number_of_frames();
             bool is_real_time();
             bool is_print_file_info();
+            std::string get_benchmark_file_path();
             bool is_rendering_enabled();
             bool is_motion_enabled();
             streaming_mode get_streaming_mode();
@@ -33,27 +33,108 @@ namespace rs
 {
     namespace utils
     {
+        struct viewer_gl;
+
         class DLL_EXPORT viewer
         {
             using int_pair = std::pair<int, int>;
         public:
+            /**
+             * @brief The consumer of the streams grid composed by an offscreen viewer, such as a video encoder.
+             *
+             * The methods are called on the viewer thread, once per composition, at the display rate.
+             */
+            class offscreen_sink
+            {
+            public:
+                /**
+                 * @brief Gets the composed grid texture, while the viewer gl context is current.
+                 *
+                 * The texture is an rgba texture of the viewer size, overwritten by the next composition. An encoder which takes gl
+                 * textures encodes it without copying it to host memory.
+                 * @param[in] texture       The gl texture of the composed grid
+                 * @param[in] width         The texture width
+                 * @param[in] height        The texture height
+                 * @param[in] time_stamp    The time stamp of the latest image in the grid
+                 * @return true to get the grid in host memory by on_composed_image, false if the texture is enough
+                 */
+                virtual bool on_composed_texture(GLuint texture, uint32_t width, uint32_t height, double time_stamp) = 0;
+
+                /**
+                 * @brief Gets the composed grid in host memory, as a bgra8 image of the viewer size with its top row first.
+                 *
+                 * The grid is read back asynchronously, the image of a composition is delivered with the next composition, so the
+                 * viewer doesn't wait for the gpu. The sink adds a reference to keep the image beyond the call.
+                 * @param[in] image         The composed grid, whose time stamp is of the latest image in the grid
+                 */
+                virtual void on_composed_image(const rs::core::image_interface * image) = 0;
+
+                virtual ~offscreen_sink() {}
+            };
+
             viewer(size_t stream_count, uint32_t width, uint32_t height, std::function<void()> on_close_callback, std::string title = "");
 
+            /**
+             * @brief Constructs a headless viewer, which composes the streams grid in an offscreen gl framebuffer, and hands each
+             *        composition to the sink instead of displaying it.
+             *
+             * The images are converted by the same shaders as the windowed viewer, and the grid is laid out as the window would be. The
+             * gl context is of a hidden window, on a machine without a display glfw should be built for a headless platform, such as
+             * osmesa or egl. No composition is made if the context doesn't support framebuffer objects.
+             * @param[in] stream_count  The number of the streams in the grid
+             * @param[in] width         The composed grid width
+             * @param[in] height        The composed grid height
+             * @param[in] sink          The consumer of the compositions, which must outlive the viewer
+             */
+            viewer(size_t stream_count, uint32_t width, uint32_t height, offscreen_sink * sink);
+
             ~viewer();
 
             void show_image(const rs::core::image_interface * image);
             void show_image(std::shared_ptr<rs::core::image_interface> image);
 
+            //caps the rate of the windows redraw, a frame which arrives before the next redraw replaces the pending frame of its stream.
+            //60 frames per second by default, 0 redraws on every frame
+            void set_max_display_rate(uint32_t frames_per_second);
+
         private:
+            //a persistent texture per stream, uploaded through two alternating pixel buffers.
+            //the windows are redrawn from the textures, so a redraw needn't a new frame of each stream
+            struct stream_texture
+            {
+                GLuint texture;
+                GLuint pixel_buffers[2];
+                uint32_t next_pixel_buffer;
+                GLint internal_format;
+                rs::core::image_info info;
+                int shader_mode;
+                float scale;
+                float offset; // subtracted from the normalized value before scaling, the depth colorization range minimum
+            };
+
             void setup_window(uint32_t width, uint32_t height, std::string window_title);
-            void render_image(std::shared_ptr<rs::core::image_interface> image);
-            void draw(const rs::core::image_interface * image, int gl_format, int gl_channel_type);
+            //loads the shader which converts the raw formats, without it the images are converted on the cpu
+            void setup_gl_upload();
+            void release_gl_upload();
+            //creates the framebuffer the offscreen viewer composes to, and the pixel buffers of its readback
+            void setup_offscreen();
+            void release_offscreen();
+            //hands the composition to the sink, and reads it back for the sink when requested
+            void deliver_composition();
+            //the size of the grid, the window size or the offscreen framebuffer size
+            int_pair query_canvas_size();
+            //uploads the raw image to the stream texture, to be converted by the shader
+            bool upload_texture(const rs::core::image_interface * image, stream_texture & stream_texture);
+            //updates the stream texture, converting the image on the cpu if the shader can't
+            bool upload_image(std::shared_ptr<rs::core::image_interface> image);
+            void draw_streams();
+            void draw_quad(rs::core::stream_type stream, const rs::core::image_info & info);
             void ui_refresh();
             void update_buffer(std::shared_ptr<rs::core::image_interface>& image);
             bool add_window(rs::core::stream_type stream);
 
             int_pair calc_grid(size_t width, size_t height, size_t streams);
-            std::pair<int_pair, int_pair> calc_window_size(const core::image_interface *image);
+            std::pair<int_pair, int_pair> calc_window_size(rs::core::stream_type stream, const rs::core::image_info & info);
             std::map<rs::core::stream_type, std::shared_ptr<rs::core::image_interface>> m_render_buffer;
             uint32_t m_width;
             uint32_t m_height;
@@ -66,6 +147,21 @@ namespace rs
             size_t m_stream_count;
             std::map<rs::core::stream_type, size_t> m_windows_positions;
             std::atomic<bool> m_is_running;
+            std::unique_ptr<viewer_gl> m_gl;
+            GLuint m_program;
+            std::map<rs::core::stream_type, stream_texture> m_textures;
+            std::atomic<uint32_t> m_max_display_rate;
+
+            //the offscreen composition, the readback alternates two pixel buffers, each mapped one composition after its read
+            offscreen_sink * m_offscreen_sink;
+            std::unique_ptr<viewer_gl> m_offscreen_gl;
+            GLuint m_offscreen_framebuffer;
+            GLuint m_offscreen_texture;
+            GLuint m_readback_buffers[2];
+            double m_readback_time_stamps[2];
+            bool m_is_readback_pending[2];
+            uint32_t m_next_readback_buffer;
+            double m_latest_time_stamp;
         };
     }
 }
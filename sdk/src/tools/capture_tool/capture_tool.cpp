@@ -4,11 +4,13 @@
 #include <memory>
 #include <sstream>
 #include <iostream>
+#include <fstream>
 #include <chrono>
 #include <thread>
 #include <signal.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <sys/resource.h>
 #include <librealsense/rs.hpp>
 #include "rs_core.h"
 #include "rs/core/context_interface.h"
@@ -98,6 +100,66 @@ std::string pixel_format_to_string(rs::format format)
     }
 }
 
+std::string streaming_mode_to_string(streaming_mode mode)
+{
+    switch(mode)
+    {
+        case streaming_mode::live: return "live";
+        case streaming_mode::record: return "record";
+        case streaming_mode::playback: return "playback";
+    }
+    return "";
+}
+
+//the user and system cpu time of all the process threads, in seconds
+double query_process_cpu_time()
+{
+    rusage usage = {};
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+//writes the benchmark json report, the recorder counters are reported in record mode. in non real time playback the time per
+//frame is the file read and decode time, since frames are delivered as fast as they are decoded
+void write_benchmark_report(rs::device* device, const std::string & file_path, double elapsed_seconds, double cpu_seconds)
+{
+    auto mode = g_cmd.get_streaming_mode();
+    std::ofstream report(file_path);
+    if(!report.is_open())
+        throw std::runtime_error("failed to open the benchmark report file " + file_path);
+
+    report << "{" << std::endl;
+    report << "  \"mode\": \"" << streaming_mode_to_string(mode) << "\"," << std::endl;
+    report << "  \"real_time\": " << (mode != streaming_mode::playback || g_cmd.is_real_time() ? "true" : "false") << "," << std::endl;
+    report << "  \"duration_s\": " << elapsed_seconds << "," << std::endl;
+    report << "  \"cpu_usage_percent\": " << (elapsed_seconds > 0 ? 100. * cpu_seconds / elapsed_seconds : 0.) << "," << std::endl;
+    report << "  \"streams\": [";
+    auto streams = g_cmd.get_enabled_streams();
+    for(size_t i = 0; i < streams.size(); i++)
+    {
+        auto lrs_stream = convert_stream_type(streams[i]);
+        auto frames = g_frame_count.count(lrs_stream) ? g_frame_count[lrs_stream] : 0;
+        report << (i > 0 ? "," : "") << std::endl << "    {" << std::endl;
+        report << "      \"stream\": \"" << stream_type_to_string(lrs_stream) << "\"," << std::endl;
+        report << "      \"frames\": " << frames << "," << std::endl;
+        report << "      \"fps\": " << (elapsed_seconds > 0 ? static_cast<double>(frames) / elapsed_seconds : 0.) << "," << std::endl;
+        report << "      \"ms_per_frame\": " << (frames > 0 ? 1000. * elapsed_seconds / static_cast<double>(frames) : 0.);
+        if(mode == streaming_mode::record)
+        {
+            rs::record::recording_statistics statistics = {};
+            static_cast<rs::record::device*>(device)->query_recording_statistics(lrs_stream, statistics);
+            report << "," << std::endl;
+            report << "      \"recorded_frames\": " << statistics.recorded_frames_count << "," << std::endl;
+            report << "      \"recorder_dropped_frames\": " << statistics.dropped_frames_count << "," << std::endl;
+            report << "      \"write_mb_per_s\": " << (elapsed_seconds > 0 ? static_cast<double>(statistics.written_bytes) / 1e6 / elapsed_seconds : 0.) << "," << std::endl;
+            report << "      \"compression_ratio\": " << (statistics.written_bytes > 0 ? static_cast<double>(statistics.raw_bytes) / static_cast<double>(statistics.written_bytes) : 0.);
+        }
+        report << std::endl << "    }";
+    }
+    report << std::endl << "  ]" << std::endl << "}" << std::endl;
+}
+
 void configure_device(rs::device* device, basic_cmd_util cl_util, std::shared_ptr<viewer> &renderer)
 {
     const int window_width = 640;
@@ -210,19 +272,26 @@ int main(int argc, char* argv[])
 
         rs::source source = g_cmd.is_motion_enabled() ? rs::source::all_sources : rs::source::video;
 
+        auto benchmark_file_path = g_cmd.get_benchmark_file_path();
+        auto capture_time = g_cmd.get_capture_time();
+        auto frames = g_cmd.get_number_of_frames();
+
+        //a benchmark runs for a fixed duration, unless the run is limited by the user
+        const int default_benchmark_time = 10;
+        if(!benchmark_file_path.empty() && capture_time <= 0 && frames == 0)
+            capture_time = default_benchmark_time;
+
+        auto start_cpu_time = query_process_cpu_time();
         device->start(source);
 
         auto start_time = std::chrono::high_resolution_clock::now();
 
-        auto capture_time = g_cmd.get_capture_time();
-        auto frames = g_cmd.get_number_of_frames();
-
         cout << "start capturing ";
         if(frames)
             cout << frames << " frames ";
 
         if(capture_time)
-            cout << "for " << to_string(g_cmd.get_capture_time()) << " second";
+            cout << "for " << to_string(capture_time) << " second";
 
         std::cout << endl;
 
@@ -269,11 +338,20 @@ int main(int argc, char* argv[])
             locker.unlock();
         }
 
+        auto elapsed_seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+        auto cpu_seconds = query_process_cpu_time() - start_cpu_time;
+
         if(device->is_streaming())
             device->stop(source);
 
         cout << "done capturing" << endl;
 
+        if(!benchmark_file_path.empty())
+        {
+            write_benchmark_report(device, benchmark_file_path, elapsed_seconds, cpu_seconds);
+            cout << "benchmark report written to " << benchmark_file_path << endl;
+        }
+
         return 0;
     }
     catch(rs::error e)
@@ -286,4 +364,9 @@ int main(int argc, char* argv[])
         cout << e << endl;
         return -1;
     }
+    catch(const std::exception & e)
+    {
+        cout << e.what() << endl;
+        return -1;
+    }
 }
@@ -0,0 +1,173 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include "disk_read_factory.h"
+
+using namespace std;
+using namespace rs::core;
+
+namespace
+{
+    struct export_options
+    {
+        string      output_dir;
+        bool        decode_frames;
+        bool        include_motions;
+        bool        overwrite;
+        unsigned    jobs;
+    };
+
+    struct export_result
+    {
+        string      output_path;
+        string      error;
+        uint64_t    input_bytes;
+        uint64_t    output_bytes;
+        double      seconds;
+    };
+
+    bool file_exists(const string & path, uint64_t * size = nullptr)
+    {
+        struct stat info = {};
+        if(stat(path.c_str(), &info) != 0)
+            return false;
+        if(size)
+            *size = static_cast<uint64_t>(info.st_size);
+        return true;
+    }
+
+    string output_path(const string & input_path, const export_options & options)
+    {
+        if(options.output_dir.empty())
+            return input_path + ".mcap";
+        auto name_position = input_path.find_last_of('/');
+        auto name = name_position == string::npos ? input_path : input_path.substr(name_position + 1);
+        return options.output_dir + "/" + name + ".mcap";
+    }
+
+    //the samples are exported from the reader index, the recording isn't played
+    export_result export_recording(const string & input_path, const export_options & options)
+    {
+        export_result result = {};
+        result.output_path = output_path(input_path, options);
+        auto start_time = chrono::steady_clock::now();
+        file_exists(input_path, &result.input_bytes);
+        if(!options.overwrite && file_exists(result.output_path))
+        {
+            result.error = "output file exists";
+            return result;
+        }
+
+        unique_ptr<rs::playback::disk_read_interface> reader;
+        auto sts = rs::playback::disk_read_factory::create_disk_read(input_path.c_str(), reader);
+        if(sts != status_no_error)
+        {
+            result.error = "failed to open the recording, status - " + to_string(sts);
+            return result;
+        }
+
+        vector<rs_stream> streams;
+        for(auto & stream_info : reader->get_streams_infos())
+            streams.push_back(stream_info.first);
+        sts = reader->export_mcap(result.output_path, streams, options.include_motions, options.decode_frames);
+        if(sts != status_no_error)
+        {
+            result.error = "failed to export, status - " + to_string(sts);
+            return result;
+        }
+        file_exists(result.output_path, &result.output_bytes);
+        result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        return result;
+    }
+
+    void print_help()
+    {
+        cout << "Usage: rs_mcap_export_tool [options] <recording> [<recording> ...]" << endl;
+        cout << "Exports recordings to MCAP files of ROS 1 image and imu messages." << endl;
+        cout << "  -o <dir>     Output directory, the exported file is named after the recording with a .mcap suffix." << endl;
+        cout << "               By default the output is written next to the recording." << endl;
+        cout << "  -d           Decode all the frames. By default the frames of the codecs which don't depend on other frames" << endl;
+        cout << "               are exported as recorded to the compressed image topics." << endl;
+        cout << "  -n           Don't export the motion samples." << endl;
+        cout << "  -j <count>   Number of recordings exported concurrently. Default is 1, a recording export is bound by the disk." << endl;
+        cout << "  -f           Overwrite existing output files." << endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    export_options options = {};
+    options.include_motions = true;
+    options.jobs = 1;
+    vector<string> inputs;
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if(arg == "-h" || arg == "--help")
+        {
+            print_help();
+            return 0;
+        }
+        else if(arg == "-o" && has_value)
+            options.output_dir = argv[++i];
+        else if(arg == "-d")
+            options.decode_frames = true;
+        else if(arg == "-n")
+            options.include_motions = false;
+        else if(arg == "-j" && has_value)
+            options.jobs = static_cast<unsigned>(max(1, atoi(argv[++i])));
+        else if(arg == "-f")
+            options.overwrite = true;
+        else if(!arg.empty() && arg[0] == '-')
+        {
+            print_help();
+            return -1;
+        }
+        else
+            inputs.push_back(arg);
+    }
+    if(inputs.empty())
+    {
+        print_help();
+        return -1;
+    }
+
+    atomic<size_t> next_input(0);
+    atomic<size_t> failures(0);
+    mutex output_mutex;
+    auto worker = [&]()
+    {
+        for(size_t index = next_input++; index < inputs.size(); index = next_input++)
+        {
+            auto result = export_recording(inputs[index], options);
+            lock_guard<mutex> guard(output_mutex);
+            if(!result.error.empty())
+            {
+                failures++;
+                cerr << inputs[index] << " - failed, " << result.error << endl;
+                continue;
+            }
+            cout << inputs[index] << " -> " << result.output_path << " - "
+                 << static_cast<double>(result.input_bytes) / 1e6 << " MB -> " << static_cast<double>(result.output_bytes) / 1e6 << " MB in " << result.seconds << " s" << endl;
+        }
+    };
+
+    vector<thread> workers;
+    for(unsigned i = 0; i < min<size_t>(options.jobs, inputs.size()); i++)
+        workers.emplace_back(worker);
+    for(auto & worker_thread : workers)
+        worker_thread.join();
+
+    cout << inputs.size() - failures << " of " << inputs.size() << " recordings exported" << endl;
+    return failures > 0 ? -1 : 0;
+}
@@ -0,0 +1,283 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include "rs_core.h"
+#include "rs/core/pipeline_async.h"
+#include "rs/core/pipeline_trace.h"
+#include "rs/utils/timebase.h"
+#include "rs/cv_modules/max_depth_value_module/max_depth_value_module.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::cv_modules;
+
+namespace
+{
+    //device callback times of the recent depth frames, a frame output later than this many frames is not timed
+    const size_t TIMED_FRAMES_COUNT = 4096;
+
+    struct benchmark_options
+    {
+        uint32_t    max_modules_count;
+        uint64_t    load_ms;
+        uint32_t    seconds;
+        bool        run_sync;
+        bool        run_async;
+        string      file_path;  //empty streams the synthetic camera
+        bool        is_replay;
+    };
+
+    struct benchmark_result
+    {
+        string      error;
+        uint64_t    received_samples;   //depth samples the device delivered
+        uint64_t    outputs;            //outputs of all the modules
+        uint64_t    pipeline_drops;     //sample sets dropped or throttled by the modules consumers
+        double      elapsed_seconds;
+        double      cpu_seconds;
+        vector<uint64_t> latencies_us;  //from the device callback of a depth frame to the output of a module which processed it
+    };
+
+    //times the depth frames at the device callback, and the module outputs by the frame they processed
+    class latency_tracker : public pipeline_trace_handler, public pipeline_async_interface::callback_handler
+    {
+    public:
+        latency_tracker() : m_frames(TIMED_FRAMES_COUNT), m_outputs(0)
+        {
+            m_latencies_us.reserve(1 << 16);
+        }
+
+        void on_trace_event(const pipeline_trace_event & event) override
+        {
+            if(event.stage != pipeline_trace_stage::device_callback || event.stream != stream_type::depth)
+                return;
+            lock_guard<mutex> guard(m_lock);
+            m_frames[event.frame_number % TIMED_FRAMES_COUNT] = { event.frame_number, event.time_ns };
+        }
+
+        void on_cv_module_process_complete(video_module_interface * cv_module) override
+        {
+            const uint64_t now_ns = static_cast<uint64_t>(rs::utils::timebase::now().time_since_epoch().count());
+            //the output is ready when the callback is called, the get doesn't block
+            const uint64_t frame_number = static_cast<max_depth_value_module *>(cv_module)->get_max_depth_value_data().frame_number;
+            m_outputs++;
+
+            lock_guard<mutex> guard(m_lock);
+            const timed_frame & frame = m_frames[frame_number % TIMED_FRAMES_COUNT];
+            if(frame.time_ns != 0 && frame.frame_number == frame_number && now_ns > frame.time_ns)
+                m_latencies_us.push_back((now_ns - frame.time_ns) / 1000);
+        }
+
+        void on_error(status status) override
+        {
+            cerr << "pipeline error, status " << status << endl;
+        }
+
+        uint64_t query_outputs_count() const { return m_outputs; }
+        vector<uint64_t> take_latencies()
+        {
+            lock_guard<mutex> guard(m_lock);
+            return move(m_latencies_us);
+        }
+
+    private:
+        struct timed_frame
+        {
+            uint64_t frame_number;
+            uint64_t time_ns;
+        };
+
+        mutex                   m_lock;
+        vector<timed_frame>     m_frames;
+        vector<uint64_t>        m_latencies_us;
+        atomic<uint64_t>        m_outputs;
+    };
+
+    double query_process_cpu_seconds()
+    {
+        rusage usage = {};
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    unique_ptr<pipeline_async> create_pipeline(const benchmark_options & options)
+    {
+        if(options.file_path.empty())
+            return unique_ptr<pipeline_async>(new pipeline_async(pipeline_async::testing_mode::synthetic, nullptr));
+        return unique_ptr<pipeline_async>(new pipeline_async(options.is_replay ? pipeline_async::testing_mode::replay :
+                                                                                 pipeline_async::testing_mode::playback,
+                                                             options.file_path.c_str()));
+    }
+
+    benchmark_result run(const benchmark_options & options, uint32_t modules_count, bool is_async)
+    {
+        benchmark_result result = {};
+        auto pipeline = create_pipeline(options);
+        vector<unique_ptr<max_depth_value_module>> modules;
+        for(uint32_t i = 0; i < modules_count; i++)
+        {
+            modules.emplace_back(new max_depth_value_module(options.load_ms, is_async));
+            status add_status = pipeline->add_cv_module(modules.back().get());
+            if(add_status < status_no_error)
+            {
+                result.error = "failed to add a module, status " + to_string(add_status);
+                return result;
+            }
+        }
+
+        latency_tracker tracker;
+        pipeline->set_trace_handler(&tracker);
+        const double cpu_start = query_process_cpu_seconds();
+        const auto start = chrono::steady_clock::now();
+        status start_status = pipeline->start(&tracker);
+        if(start_status < status_no_error)
+        {
+            result.error = "failed to start the pipeline, status " + to_string(start_status);
+            return result;
+        }
+        this_thread::sleep_for(chrono::seconds(options.seconds));
+
+        //the counters are sampled before the stop, which flushes the modules queues
+        pipeline_statistics statistics = {};
+        pipeline->query_statistics(statistics);
+        for(auto & module : modules)
+        {
+            pipeline_module_statistics module_statistics = {};
+            if(pipeline->query_module_statistics(module.get(), module_statistics) == status_no_error)
+                result.pipeline_drops += module_statistics.dropped_sample_sets_count + module_statistics.throttled_sample_sets_count;
+        }
+        result.outputs = tracker.query_outputs_count();
+        result.elapsed_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        result.cpu_seconds = query_process_cpu_seconds() - cpu_start;
+        result.received_samples = statistics[stream_type::depth].received_samples_count;
+        pipeline->stop();
+        pipeline->set_trace_handler(nullptr);
+        result.latencies_us = tracker.take_latencies();
+        return result;
+    }
+
+    double percentile_ms(vector<uint64_t> & values, double percent)
+    {
+        if(values.empty())
+            return 0;
+        size_t index = min(values.size() - 1, static_cast<size_t>(static_cast<double>(values.size()) * percent / 100));
+        nth_element(values.begin(), values.begin() + index, values.end());
+        return static_cast<double>(values[index]) / 1000.;
+    }
+
+    void print_header()
+    {
+        cout << left << setw(7) << "mode" << right << setw(8) << "modules" << setw(12) << "outputs/s" << setw(12) << "per module"
+             << setw(9) << "drop %" << setw(10) << "p50 ms" << setw(10) << "p90 ms" << setw(10) << "p99 ms" << setw(9) << "cpu %"
+             << setw(14) << "cpu ms/output" << endl;
+    }
+
+    void print_result(bool is_async, uint32_t modules_count, benchmark_result & result)
+    {
+        cout << left << setw(7) << (is_async ? "async" : "sync") << right << setw(8) << modules_count;
+        if(!result.error.empty())
+        {
+            cout << "  " << result.error << endl;
+            return;
+        }
+
+        //each module is expected to output a sample set for each depth sample the device delivered
+        const double expected_outputs = static_cast<double>(result.received_samples) * modules_count;
+        const double drop_percent = expected_outputs > 0 ? max(0., 100. * (1 - static_cast<double>(result.outputs) / expected_outputs)) : 0;
+        const double throughput = static_cast<double>(result.outputs) / result.elapsed_seconds;
+        cout << fixed << setprecision(1) << setw(12) << throughput << setw(12) << throughput / modules_count << setw(9) << drop_percent
+             << setprecision(2) << setw(10) << percentile_ms(result.latencies_us, 50) << setw(10) << percentile_ms(result.latencies_us, 90)
+             << setw(10) << percentile_ms(result.latencies_us, 99) << setprecision(1) << setw(9) << 100 * result.cpu_seconds / result.elapsed_seconds
+             << setprecision(3) << setw(14) << (result.outputs > 0 ? 1000 * result.cpu_seconds / static_cast<double>(result.outputs) : 0.) << endl;
+    }
+
+    void print_help()
+    {
+        cout << "Usage: rs_pipeline_benchmark_tool [options]" << endl;
+        cout << "Streams pipelines of 1 to N max depth value modules with a simulated computation time, and prints the throughput," << endl;
+        cout << "the latency percentiles from the device callback to the module outputs, the drop rate and the process cpu time of each" << endl;
+        cout << "modules count. The drop rate counts the depth samples a module didn't output, of the samples the device delivered." << endl;
+        cout << "  -n <count>   Maximal number of modules. Default is 8." << endl;
+        cout << "  -l <ms>      Simulated computation time of each module sample set. Default is 10." << endl;
+        cout << "  -t <seconds> Streaming time of each modules count. Default is 5." << endl;
+        cout << "  -m <mode>    Module processing mode, sync, async or both. Default is both." << endl;
+        cout << "  -f <file>    Stream a recording instead of the synthetic camera, its depth stream must be 640x480 at 30 fps." << endl;
+        cout << "  -r           Replay the recording in lockstep with the modules, as fast as they process it." << endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options = {};
+    options.max_modules_count = 8;
+    options.load_ms = 10;
+    options.seconds = 5;
+    options.run_sync = true;
+    options.run_async = true;
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if(arg == "-h" || arg == "--help")
+        {
+            print_help();
+            return 0;
+        }
+        else if(arg == "-n" && has_value)
+            options.max_modules_count = static_cast<uint32_t>(max(1, atoi(argv[++i])));
+        else if(arg == "-l" && has_value)
+            options.load_ms = static_cast<uint64_t>(max(0, atoi(argv[++i])));
+        else if(arg == "-t" && has_value)
+            options.seconds = static_cast<uint32_t>(max(1, atoi(argv[++i])));
+        else if(arg == "-m" && has_value)
+        {
+            string mode = argv[++i];
+            options.run_sync = mode == "sync" || mode == "both";
+            options.run_async = mode == "async" || mode == "both";
+        }
+        else if(arg == "-f" && has_value)
+            options.file_path = argv[++i];
+        else if(arg == "-r")
+            options.is_replay = true;
+        else
+        {
+            print_help();
+            return -1;
+        }
+    }
+    if((!options.run_sync && !options.run_async) || (options.is_replay && options.file_path.empty()))
+    {
+        print_help();
+        return -1;
+    }
+
+    print_header();
+    size_t failures = 0;
+    for(bool is_async : { false, true })
+    {
+        if((is_async && !options.run_async) || (!is_async && !options.run_sync))
+            continue;
+        for(uint32_t modules_count = 1; modules_count <= options.max_modules_count; modules_count++)
+        {
+            auto result = run(options, modules_count, is_async);
+            if(!result.error.empty())
+                failures++;
+            print_result(is_async, modules_count, result);
+        }
+    }
+    return failures > 0 ? -1 : 0;
+}
@@ -31,6 +31,12 @@ public:
         add_single_arg_option("-fpf", "set fisheye stream pixel format", "raw8", "raw8");
 
         add_single_arg_option("-pb -playback", "set playback file path");
+        add_option("-nrt -non_real_time", "play the file as fast as the projection processes it, applies to playback");
+
+        add_option("-nr -no_render", "project without rendering, report the projection throughput");
+        add_single_arg_option("-n", "number of frames to project, the streaming stops once they are projected");
+        add_single_arg_option("-ply", "export the vertices of each frame to a binary PLY file in the given directory");
+        add_single_arg_option("-vtx -vertices", "stream the vertices of all frames to a single binary file");
 
         set_usage_example("-cconf 640-480-30 -cpf rgb8\n\n"
                           "The following command will configure the camera to\n"
@@ -39,6 +45,46 @@ public:
                           "Color, Depth and Fisheye streams MUST be available in case of prerecorded clips.\n"
                           "Color, Depth, Fisheye streams and World image are ALWAYS shown.\n"
                           "Other projection-generated images can be also viewed using specific keyboard keys.\n"
-                          "GUI help message is always shown in the main window.\n");
+                          "GUI help message is always shown in the main window.\n\n"
+                          "-pb <file> -nrt -nr -vtx <file>\n\n"
+                          "The following command will project each frame of the\n"
+                          "recording without rendering, stream the vertices to a\n"
+                          "binary file and report the projection throughput.\n");
+    }
+
+    /** @brief is_rendering_disabled
+     *
+     * @return: true                    The frames are projected and exported without rendering.
+     */
+    bool is_rendering_disabled()
+    {
+        rs::utils::cmd_option opt;
+        return get_cmd_option("-nr -no_render", opt);
+    }
+
+    /** @brief get_ply_directory
+     *
+     * @return: std::string             Directory to write a PLY file per frame to, empty if not requested.
+     */
+    std::string get_ply_directory()
+    {
+        return get_single_arg_value("-ply");
+    }
+
+    /** @brief get_vertices_file_path
+     *
+     * @return: std::string             File to stream the vertices of all frames to, empty if not requested.
+     */
+    std::string get_vertices_file_path()
+    {
+        return get_single_arg_value("-vtx -vertices");
+    }
+
+private:
+    std::string get_single_arg_value(const std::string & tags)
+    {
+        rs::utils::cmd_option opt;
+        if(!get_cmd_option(tags, opt) || opt.m_option_args_values.empty()) return "";
+        return opt.m_option_args_values[0];
     }
 };
@@ -12,9 +12,14 @@
 #include "librealsense/rs.hpp"
 
 /* standard library */
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
 #include <fstream>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 
@@ -34,44 +39,159 @@ using namespace rs::utils;
  */
 int configure(rs::device* device, basic_cmd_util& cmd_utility, unique_ptr<samples_time_sync_interface>& sync_utility, const std::vector<rs::core::stream_type>& streams);
 
+/** @brief stage_queue
+ *
+ * Bounded queue between the stages of the projection pipeline, each stage runs on its own thread.
+ * A full queue either blocks the producer, so every frame is processed, or drops its oldest frame, so the consumer gets the latest frame.
+ * Closing the queue wakes the waiting stages, the consumer drains the queued frames before it stops.
+ */
+template<typename T>
+class stage_queue
+{
+public:
+    stage_queue(size_t capacity, bool drop_oldest) : m_capacity(capacity), m_drop_oldest(drop_oldest), m_closed(false), m_dropped_count(0) {}
+
+    /** @return: false if the queue is closed */
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_drop_oldest && m_items.size() >= m_capacity && !m_items.empty())
+        {
+            m_items.pop_front();
+            m_dropped_count++;
+        }
+        m_not_full.wait(lock, [this]{ return m_closed || m_items.size() < m_capacity; });
+        if (m_closed)
+        {
+            return false;
+        }
+        m_items.push_back(std::move(item));
+        m_not_empty.notify_one();
+        return true;
+    }
+
+    /** @return: false if the queue is closed and drained */
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_empty.wait(lock, [this]{ return m_closed || !m_items.empty(); });
+        if (m_items.empty())
+        {
+            return false;
+        }
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        m_not_full.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_not_empty.notify_all();
+        m_not_full.notify_all();
+    }
+
+    uint64_t query_dropped_count()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_dropped_count;
+    }
+
+private:
+    const size_t m_capacity;
+    const bool m_drop_oldest;
+    bool m_closed;
+    uint64_t m_dropped_count;
+    std::deque<T> m_items;
+    std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+};
+
+/** @brief projection_frame
+ *
+ * A correlated sample set and the projection results computed for it by the projection stage, consumed by the render and export stages.
+ * The images are referenced by the frame until the last stage releases it.
+ */
+struct projection_frame
+{
+    unique_ptr<image_interface> depth;
+    unique_ptr<image_interface> color;
+    unique_ptr<image_interface> fisheye;
+    projection_interface* projection;                   /**< the projection of the color or fisheye stream, by the user selection */
+    bool is_fisheye;
+    std::vector<point3dF32> vertices;                   /**< the camera coordinates of each depth pixel */
+    std::vector<uint16_t> world_data;                   /**< the world image, the Z coordinate of each vertex */
+    std::vector<pointF32> uvmap_points;
+    std::vector<pointF32> invuvmap_points;
+    unique_ptr<image_interface> color_mapped_to_depth;
+    unique_ptr<image_interface> depth_mapped_to_color;
+};
+
+/** @brief projection_statistics
+ *
+ * Throughput counters of the projection pipeline, reported when the streaming stops.
+ */
+struct projection_statistics
+{
+    std::atomic<uint64_t> projected_frames;
+    std::atomic<uint64_t> projection_time_us;
+    std::atomic<uint64_t> exported_frames;
+};
+
 /** @brief create_frame_callback
  *
- * Create frame callback for device.
+ * Create frame callback for device. The callback matches the frames and queues the correlated sample sets to the projection stage.
  * @param[in] sync_utility          Samples time sync interface instance.
- * @param[in] process_sample        Sample processing function called when a pair of color-depth frames is found.
+ * @param[in] samples_queue         Queue of the correlated sample sets to the projection stage.
  * @param[in] continue_streaming    Flag to check if the streaming is over.
+ * @param[in] process_sample_called Flag to check if the sync utility matched frames.
+ *                                  Used to warn the user whether sync utility managed to find a correlated pair of frames.
  * @return: std::function<void(rs::frame)> Created frame callback.
  */
 std::function<void(rs::frame)> create_frame_callback(unique_ptr<samples_time_sync_interface>& sync_utility,
-                                                     std::function<void(const correlated_sample_set&)> process_sample,
-                                                     projection_viewer& renderer,
-                                                     bool& continue_streaming);
+                                                     stage_queue<std::shared_ptr<projection_frame>>& samples_queue,
+                                                     std::atomic<bool>& continue_streaming,
+                                                     std::atomic<bool>& process_sample_called);
 
-/** @brief create_processing_function
+/** @brief project_frame
  *
- * Create function to process correlated frames that calls projection methods on such frames.
+ * Calls the projection methods on the correlated frames, as requested by the user through the renderer UI.
+ * @param[in] frame                 Frame with the correlated images, the projection results are set to it.
  * @param[in] projections           Reference to a collection of projection interface instances.
- * @param[in] renderer              Projection viewer instance.
- * @param[in] world_data            A buffer of real world Z-coordinate points to be populated and rendered internally.
+ * @param[in] renderer              Projection viewer instance, null if rendering is disabled.
  * @param[in] depth_scale           Value for the mapping between depth image units and meters.
- * @param[in] process_sample_called Flag to check if the function was called.
- *                                  Used to warn the user whether sync utility managed to find a correlated pair of frames.
- * @return: std::function<void(const correlated_sample_set&)> Created processing function.
  */
-std::function<void(const correlated_sample_set&)> create_processing_function(std::map<rs::stream, projection_interface*>& projections, projection_viewer& renderer,
-                                                                             std::vector<uint16_t>& world_data, const double depth_scale,
-                                                                             bool& process_sample_called);
+void project_frame(projection_frame& frame, std::map<rs::stream, projection_interface*>& projections, projection_viewer* renderer, const double depth_scale);
+
+/** @brief render_frame
+ *
+ * Render the frame images and the projection results on the main window and the dynamic windows.
+ * @param[in] frame                 Projected frame.
+ * @param[in] renderer              Projection viewer instance.
+ */
+void render_frame(projection_frame& frame, projection_viewer& renderer);
+
+/** @brief export_frame
+ *
+ * Write the vertices of the frame to a PLY file in the given directory, and append them to the vertices file.
+ * @param[in] frame                 Projected frame.
+ * @param[in] ply_directory         Directory of the PLY files, empty to skip.
+ * @param[in] vertices_file         Vertices file, null to skip.
+ * @return: 0                       The vertices were written.
+ * @return: -1                      Failed to write the vertices.
+ */
+const int export_frame(const projection_frame& frame, const std::string& ply_directory, std::ofstream* vertices_file);
 
 /** @brief create_world_data
  *
- * Create real world image and get it as raw data.
- * @param[in] realsense_projection  RealSense projection object.
- * @param[in] depth                 Depth image.
+ * Get the real world image raw data from the vertices of the depth image.
+ * @param[in] vertices              Vertices of the depth image.
  * @param[in] world_data            Real world data vector to return the mapped data into.
- * @return: 0                       Real world data successfully created.
- * @return: -1                      Failed to create real world data.
-*/
-const int create_world_data(projection_interface* realsense_projection, image_interface* depth, std::vector<uint16_t>& world_data);
+ */
+void create_world_data(const std::vector<point3dF32>& vertices, std::vector<uint16_t>& world_data);
 
 /** @brief handle_uvmap
  *
@@ -183,10 +303,33 @@ int main(int argc, char* argv[])
         streams_resolutions[stream] = {realsense_device->get_stream_width(convert_stream_type(stream)),realsense_device->get_stream_height(convert_stream_type(stream))};
     }
     
-    bool continue_streaming = true;
-    // create renderer
-    projection_viewer renderer(streams_resolutions, [&continue_streaming]{ continue_streaming = false; });
-    
+    std::atomic<bool> continue_streaming(true);
+    // create renderer, without rendering the frames are only projected and exported
+    std::unique_ptr<projection_viewer> renderer;
+    if (!cmd_utility.is_rendering_disabled())
+    {
+        renderer.reset(new projection_viewer(streams_resolutions, [&continue_streaming]{ continue_streaming = false; }));
+    }
+
+    if (cmd_utility.get_streaming_mode() == streaming_mode::playback)
+    {
+        static_cast<rs::playback::device*>(realsense_device)->set_real_time(cmd_utility.is_real_time());
+    }
+
+    const std::string ply_directory = cmd_utility.get_ply_directory();
+    std::unique_ptr<std::ofstream> vertices_file;
+    if (!cmd_utility.get_vertices_file_path().empty())
+    {
+        vertices_file.reset(new std::ofstream(cmd_utility.get_vertices_file_path(), std::ios::binary));
+        if (!vertices_file->good())
+        {
+            std::cerr << "\nError: Unable to open the vertices file\n";
+            return -1;
+        }
+    }
+    const bool is_exporting = !ply_directory.empty() || vertices_file;
+    const uint64_t frames_to_project = cmd_utility.get_number_of_frames(); // 0 projects until the streaming stops
+
     intrinsics color_intrin = convert_intrinsics(realsense_device->get_stream_intrinsics(color_stream));
     intrinsics fisheye_intrin = convert_intrinsics(realsense_device->get_stream_intrinsics(rs::stream::fisheye));
     intrinsics depth_intrin = convert_intrinsics(realsense_device->get_stream_intrinsics(rs::stream::depth));
@@ -205,38 +348,114 @@ int main(int argc, char* argv[])
         {rs::stream::fisheye, realsense_projection_fed.get()}
     };
     
-    // creating real world image data buffer for future
-    std::vector<uint16_t> world_data(depth_intrin.width*depth_intrin.height);
     // get depth scale to get depth value units as meters
     const double depth_scale = realsense_device->get_depth_scale();
-    bool process_sample_called = false;
-    // processing of frame data when sync utility found a pair of correlated frames
-    auto process_sample = create_processing_function(projections, renderer, world_data, depth_scale, process_sample_called);
+    std::atomic<bool> process_sample_called(false);
+
+    // the projection of a frame overlaps the rendering and the export of the previous frame, each stage runs on its own thread.
+    // an exported frame is never dropped, otherwise the projection gets the latest correlated frames
+    stage_queue<std::shared_ptr<projection_frame>> samples_queue(is_exporting ? 2 : 1, !is_exporting);
+    stage_queue<std::shared_ptr<projection_frame>> render_queue(2, false);
+    stage_queue<std::shared_ptr<projection_frame>> export_queue(4, false);
+    projection_statistics statistics = {};
+
+    std::thread projection_thread([&]
+    {
+        std::shared_ptr<projection_frame> frame;
+        while (samples_queue.pop(frame))
+        {
+            const auto start_time = std::chrono::steady_clock::now();
+            try
+            {
+                project_frame(*frame, projections, renderer.get(), depth_scale);
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "\nError: " << e.what() << std::endl;
+                continue_streaming = false;
+                continue;
+            }
+            statistics.projection_time_us += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                                       std::chrono::steady_clock::now() - start_time).count());
+            if (++statistics.projected_frames == frames_to_project)
+            {
+                continue_streaming = false;
+            }
+            if (renderer)
+            {
+                render_queue.push(frame);
+            }
+            if (is_exporting)
+            {
+                export_queue.push(frame);
+            }
+        }
+        render_queue.close();
+        export_queue.close();
+    });
+    std::thread render_thread([&]
+    {
+        std::shared_ptr<projection_frame> frame;
+        while (render_queue.pop(frame))
+        {
+            render_frame(*frame, *renderer);
+        }
+    });
+    std::thread export_thread([&]
+    {
+        std::shared_ptr<projection_frame> frame;
+        while (export_queue.pop(frame))
+        {
+            if (export_frame(*frame, ply_directory, vertices_file.get()) != 0)
+            {
+                export_queue.close();
+                continue_streaming = false;
+                break;
+            }
+            statistics.exported_frames++;
+        }
+    });
+
     // create frame callback for rs::device
-    auto frame_callback = create_frame_callback(sync_utility, process_sample, renderer, continue_streaming);
+    auto frame_callback = create_frame_callback(sync_utility, samples_queue, continue_streaming, process_sample_called);
 
     for(auto stream : requested_streams)
     {
         realsense_device->set_frame_callback(convert_stream_type(stream), frame_callback);
     }
 
+    const auto streaming_start_time = std::chrono::steady_clock::now();
     realsense_device->start();
-    while(realsense_device->is_streaming())
+    while(realsense_device->is_streaming() && continue_streaming)
     {
-        renderer.process_user_events(); // user events are processed in the main thread as required by GLFW
-        if (!continue_streaming) // the value is changed by process_user_events()
+        if (renderer)
         {
-            break;
+            renderer->process_user_events(); // user events are processed in the main thread as required by GLFW
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
     }
 
-    renderer.terminate();
     {
         std::lock_guard<std::mutex> lock(sync_mutex);
         sync_utility->flush();
         sync_utility.reset(); // prevent samples_time_sync from processing new frames
                               // which can result in a deadlock on device->stop()
     }
+    // the queued frames are processed before the stages stop
+    samples_queue.close();
+    projection_thread.join();
+    render_thread.join();
+    export_queue.close();
+    export_thread.join();
+    const double streaming_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - streaming_start_time).count();
+
+    if (renderer)
+    {
+        renderer->terminate();
+    }
     realsense_device->stop();
     if (!process_sample_called)
     {
@@ -244,6 +463,17 @@ int main(int argc, char* argv[])
         return 0;
     }
 
+    const uint64_t projected_frames = statistics.projected_frames;
+    std::cout << "Projected " << projected_frames << " frames in " << streaming_seconds << " s, "
+              << (streaming_seconds > 0 ? static_cast<double>(projected_frames) / streaming_seconds : 0) << " fps, "
+              << (projected_frames > 0 ? static_cast<double>(statistics.projection_time_us) / 1000.0 / static_cast<double>(projected_frames) : 0) << " ms projection per frame, "
+              << samples_queue.query_dropped_count() << " frames dropped";
+    if (is_exporting)
+    {
+        std::cout << ", " << statistics.exported_frames << " frames exported";
+    }
+    std::cout << std::endl;
+
     std::cout << "Finished streaming. Exiting. Goodbye!" << std::endl;
     return 0;
 }
@@ -387,20 +617,15 @@ int configure(rs::device* device, basic_cmd_util& cmd_utility, unique_ptr<sample
 }
 
 std::function<void(rs::frame)> create_frame_callback(unique_ptr<samples_time_sync_interface>& sync_utility,
-                                                     std::function<void(const correlated_sample_set&)> process_sample,
-                                                     projection_viewer& renderer,
-                                                     bool& continue_streaming)
+                                                     stage_queue<std::shared_ptr<projection_frame>>& samples_queue,
+                                                     std::atomic<bool>& continue_streaming,
+                                                     std::atomic<bool>& process_sample_called)
 {
-    return [&sync_utility, process_sample, &renderer, &continue_streaming] (rs::frame new_frame)
+    return [&sync_utility, &samples_queue, &continue_streaming, &process_sample_called] (rs::frame new_frame)
     {
         std::lock_guard<std::mutex> lock(sync_mutex);
-        if (!sync_utility)
-            return;
-        if (!continue_streaming)
-        {
-            renderer.update();
+        if (!sync_utility || !continue_streaming)
             return;
-        }
         auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_librealsense_frame(new_frame, image_interface::flag::any));
 
         //create a container for correlated sample set
@@ -410,134 +635,174 @@ std::function<void(rs::frame)> create_frame_callback(unique_ptr<samples_time_syn
         // time sync may return correlated sample set - check the status
         if (sync_utility->insert(image.get(), sample))
         {
-            // correlated sample set found - give it to projection and renderer
+            // correlated sample set found - queue it to the projection stage
             // only synced frames are to be used in projection
-            process_sample(sample);
-            sample = {};
-            renderer.update();
+            process_sample_called = true;
+            std::shared_ptr<projection_frame> frame(new projection_frame());
+            frame->depth = get_unique_ptr_with_releaser(sample[stream_type::depth]);
+            frame->color = get_unique_ptr_with_releaser(sample[stream_type::color]);
+            frame->fisheye = get_unique_ptr_with_releaser(sample[stream_type::fisheye]);
+            samples_queue.push(std::move(frame));
         }
     };
 }
 
-std::function<void(const correlated_sample_set&)> create_processing_function(std::map<rs::stream, projection_interface*>& projections, projection_viewer& renderer,
-                                                                             std::vector<uint16_t>& world_data, const double depth_scale,
-                                                                             bool& process_sample_called)
+void project_frame(projection_frame& frame, std::map<rs::stream, projection_interface*>& projections, projection_viewer* renderer, const double depth_scale)
 {
-    return [&projections, &renderer, &world_data, depth_scale, &process_sample_called] (const correlated_sample_set& sample)
+    frame.is_fisheye = renderer && renderer->is_fisheye_requested();
+    frame.projection = frame.is_fisheye ? projections.at(rs::stream::fisheye) : projections.at(rs::stream::color);
+    image_interface* depth = frame.depth.get();
+    image_interface* color = frame.is_fisheye ? frame.fisheye.get() : frame.color.get();
+
+    if (!depth->query_data())
     {
-        process_sample_called = true;
-    
-        auto depth = get_unique_ptr_with_releaser(sample[stream_type::depth]);
-        auto color = get_unique_ptr_with_releaser(sample[stream_type::color]);
-        auto fisheye = get_unique_ptr_with_releaser(sample[stream_type::fisheye]);
+        throw std::runtime_error("Unable to query data from image object");
+    }
+    frame.vertices.resize(depth->query_info().width * depth->query_info().height);
+    /* Documentation reference: query_vertices function */
+    status sts = frame.projection->query_vertices(depth, frame.vertices.data());
+    if (sts != status_no_error)
+    {
+        throw std::runtime_error("Unable to query vertices, status - " + std::to_string(sts));
+    }
+    if (!renderer)
+    {
+        return;
+    }
 
-        projection_interface* projection = renderer.is_fisheye_requested() ?
-                                           projections.at(rs::stream::fisheye) :
-                                           projections.at(rs::stream::color);
-    
-        const int depth_width = depth->query_info().width;
-        const int depth_height = depth->query_info().height;
-    
-        // rendering synthetically created by projection real world image
-        if (create_world_data(projection, depth.get(), world_data) != 0)
-        {
-            throw std::runtime_error("Unable to create world data");
-        }
-        const int world_pitch = depth_width * get_pixel_size(pixel_format::z16);
-        image_info world_info = {depth_width, depth_height, pixel_format::z16, world_pitch};
-        auto world = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(
-            &world_info,
-            {(const void*)world_data.data(), nullptr},
-            stream_type::depth,
-            image_interface::flag::any,
-            0, 0));
-    
-        renderer.show_stream(image_type::depth, depth.get());
-        if(renderer.is_fisheye_requested())
-        {
-            renderer.show_stream(image_type::fisheye, fisheye.get());
-        }
-        else
-        {
-            renderer.show_stream(image_type::color, color.get());
-        }
-    
-        renderer.show_stream(image_type::world, world.get());
-    
-        std::vector<pointF32> points;
-        points = handle_uvmap(renderer.is_uvmap_requested(), renderer.get_current_max_depth_distance(), depth_scale,
-                              projection, depth.get(), renderer.is_fisheye_requested() ? fisheye.get() : color.get()); // uvmap
-        if (!points.empty())
-        {
-            // show points based on uvmap pixel coordinates calculations and in the specified depth range
-            renderer.draw_points(image_type::uvmap, points);
-        }
-    
-        points.clear();
-        points = handle_invuvmap(renderer.is_invuvmap_requested(), renderer.get_current_max_depth_distance(), depth_scale,
-                                 projection, depth.get(), renderer.is_fisheye_requested() ? fisheye.get() : color.get()); // invuvmap
-        if (!points.empty())
-        {
-            // show points based on invuvmap pixel coordinates calculations and in the specified depth range
-            renderer.draw_points(image_type::invuvmap, points);
-        }
-        if (renderer.is_mapping_to_depth_requested()) // color or fisheye image mapped to depth
+    // synthetically created by projection real world image
+    create_world_data(frame.vertices, frame.world_data);
+
+    frame.uvmap_points = handle_uvmap(renderer->is_uvmap_requested(), renderer->get_current_max_depth_distance(), depth_scale,
+                                      frame.projection, depth, color);
+    frame.invuvmap_points = handle_invuvmap(renderer->is_invuvmap_requested(), renderer->get_current_max_depth_distance(), depth_scale,
+                                            frame.projection, depth, color);
+    if (renderer->is_mapping_to_depth_requested()) // color or fisheye image mapped to depth
+    {
+        /* Documentation reference: create_color_image_mapped_to_depth function */
+        frame.color_mapped_to_depth = get_unique_ptr_with_releaser(frame.projection->create_color_image_mapped_to_depth(depth, color));
+        if (!frame.color_mapped_to_depth->query_data())
         {
-            /* Documentation reference: create_color_image_mapped_to_depth function */
-            auto color2depth_image = get_unique_ptr_with_releaser(projection->create_color_image_mapped_to_depth(depth.get(), renderer.is_fisheye_requested() ? fisheye.get() : color.get()));
-            const void* color2depth_data = color2depth_image->query_data();
-            if (!color2depth_data)
-            {
-                throw std::runtime_error("Unable to get color mapped depth data");
-            }
-            // show color image mapped to depth in a separate window
-            renderer.show_window(color2depth_image.get());
+            throw std::runtime_error("Unable to get color mapped depth data");
         }
-        if (renderer.is_mapping_from_depth_requested()) // depth image mapped to color or fisheye
+    }
+    if (renderer->is_mapping_from_depth_requested()) // depth image mapped to color or fisheye
+    {
+        /* Documentation reference: create_depth_image_mapped_to_color function */
+        frame.depth_mapped_to_color = get_unique_ptr_with_releaser(frame.projection->create_depth_image_mapped_to_color(depth, color));
+        if (!frame.depth_mapped_to_color->query_data())
         {
-            /* Documentation reference: create_depth_image_mapped_to_color function */
-            auto depth2color_image = get_unique_ptr_with_releaser(projection->create_depth_image_mapped_to_color(depth.get(), renderer.is_fisheye_requested() ? fisheye.get() : color.get()));
-            const void* depth2color_data = depth2color_image->query_data();
-            if (!depth2color_data)
-            {
-                throw std::runtime_error("Unable to get depth mapped color data");
-            }
-            // show depth image mapped to color in a separate window
-            renderer.show_window(depth2color_image.get());
+            throw std::runtime_error("Unable to get depth mapped color data");
         }
-        handle_points_mapping(projection, depth.get(), renderer);
-    };
+    }
 }
 
+void render_frame(projection_frame& frame, projection_viewer& renderer)
+{
+    const int depth_width = frame.depth->query_info().width;
+    const int depth_height = frame.depth->query_info().height;
+    const int world_pitch = depth_width * get_pixel_size(pixel_format::z16);
+    image_info world_info = {depth_width, depth_height, pixel_format::z16, world_pitch};
+    auto world = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(
+        &world_info,
+        {(const void*)frame.world_data.data(), nullptr},
+        stream_type::depth,
+        image_interface::flag::any,
+        0, 0));
 
-const int create_world_data(projection_interface* realsense_projection, image_interface* depth, std::vector<uint16_t>& world_data)
+    renderer.show_stream(image_type::depth, frame.depth.get());
+    if(frame.is_fisheye)
+    {
+        renderer.show_stream(image_type::fisheye, frame.fisheye.get());
+    }
+    else
+    {
+        renderer.show_stream(image_type::color, frame.color.get());
+    }
+
+    renderer.show_stream(image_type::world, world.get());
+
+    if (!frame.uvmap_points.empty())
+    {
+        // show points based on uvmap pixel coordinates calculations and in the specified depth range
+        renderer.draw_points(image_type::uvmap, frame.uvmap_points);
+    }
+    if (!frame.invuvmap_points.empty())
+    {
+        // show points based on invuvmap pixel coordinates calculations and in the specified depth range
+        renderer.draw_points(image_type::invuvmap, frame.invuvmap_points);
+    }
+    if (frame.color_mapped_to_depth)
+    {
+        // show color image mapped to depth in a separate window
+        renderer.show_window(frame.color_mapped_to_depth.get());
+    }
+    if (frame.depth_mapped_to_color)
+    {
+        // show depth image mapped to color in a separate window
+        renderer.show_window(frame.depth_mapped_to_color.get());
+    }
+    // the user drawn points are few, they are mapped when the frame is rendered
+    handle_points_mapping(frame.projection, frame.depth.get(), renderer);
+    renderer.update();
+}
+
+const int export_frame(const projection_frame& frame, const std::string& ply_directory, std::ofstream* vertices_file)
 {
-    if (!depth->query_data())
+    // only the vertices of valid depth pixels are exported
+    std::vector<point3dF32> vertices;
+    vertices.reserve(frame.vertices.size());
+    for (auto& vertex : frame.vertices)
     {
-        std::cerr << "\nError: Unable to query data from image object" << std::endl;
-        return -1;
+        if (vertex.z > 0)
+        {
+            vertices.push_back(vertex);
+        }
     }
-    const int depth_width = depth->query_info().width;
-    const int depth_height = depth->query_info().height;
-    std::vector<point3dF32> matrix(depth_width*depth_height);
-    /* Documentation reference: query_vertices function */
-    status status_ = realsense_projection->query_vertices(depth, matrix.data());
-    if (status_ != status_no_error)
+
+    const uint64_t frame_number = frame.depth->query_frame_number();
+    if (!ply_directory.empty())
     {
-        std::cerr << "\nError: query_vertices bad status returned: " << status_ << std::endl;
-        return -1;
+        const std::string file_path = ply_directory + "/frame_" + std::to_string(frame_number) + ".ply";
+        std::ofstream ply_file(file_path, std::ios::binary);
+        ply_file << "ply\nformat binary_little_endian 1.0\n"
+                 << "element vertex " << vertices.size() << "\n"
+                 << "property float x\nproperty float y\nproperty float z\nend_header\n";
+        ply_file.write(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(point3dF32));
+        if (!ply_file.good())
+        {
+            std::cerr << "\nError: Unable to write " << file_path << std::endl;
+            return -1;
+        }
     }
-    for (int i = 0; i < depth_height; i++)
+    if (vertices_file)
     {
-        for (int j = 0; j < depth_width; j++)
+        // each frame is the depth frame number, time stamp and vertices count, followed by the x, y, z floats of each vertex
+        const double time_stamp = frame.depth->query_time_stamp();
+        const uint32_t vertices_count = static_cast<uint32_t>(vertices.size());
+        vertices_file->write(reinterpret_cast<const char*>(&frame_number), sizeof(frame_number));
+        vertices_file->write(reinterpret_cast<const char*>(&time_stamp), sizeof(time_stamp));
+        vertices_file->write(reinterpret_cast<const char*>(&vertices_count), sizeof(vertices_count));
+        vertices_file->write(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(point3dF32));
+        if (!vertices_file->good())
         {
-            // copy z value from vertices array to world_data
-            world_data[j + i * depth_width] = static_cast<uint16_t>(matrix[j + i * depth_width].z);
+            std::cerr << "\nError: Unable to write the vertices file" << std::endl;
+            return -1;
         }
     }
     return 0;
 }
 
+void create_world_data(const std::vector<point3dF32>& vertices, std::vector<uint16_t>& world_data)
+{
+    world_data.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        // copy z value from vertices array to world_data
+        world_data[i] = static_cast<uint16_t>(vertices[i].z);
+    }
+}
+
 std::vector<pointF32> handle_uvmap(const bool is_uvmap_queried, const float max_depth_distance, const double scale,
                                    projection_interface* projection, image_interface* depth, image_interface* color)
 {
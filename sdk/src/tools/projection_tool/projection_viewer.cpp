@@ -501,6 +501,9 @@ void projection_viewer::show_stream(image_type type, rs::core::image_interface*
     auto info = image->query_info();
     int width = info.width;
     int height = info.height;
+    // the converted image is converted on its first data query, which returns null if the conversion fails
+    auto data = image_to_show->query_data();
+    if(!data) return;
 
     // drawing
     glfwMakeContextCurrent(m_window);
@@ -513,7 +516,7 @@ void projection_viewer::show_stream(image_type type, rs::core::image_interface*
     {
         glViewport(position_x, position_y, width, height);
     }
-    draw_texture(width, height, GL_UNSIGNED_BYTE, gl_format, image_to_show->query_data());
+    draw_texture(width, height, GL_UNSIGNED_BYTE, gl_format, data);
 }
 
 void projection_viewer::show_window(image_interface* image)
@@ -572,6 +575,8 @@ void projection_viewer::show_window(image_interface* image)
     
     auto width = info.width;
     auto height = info.height;
+    auto data = image_to_show->query_data();
+    if(!data) return;
 
     
     // drawing
@@ -579,7 +584,7 @@ void projection_viewer::show_window(image_interface* image)
     glfwMakeContextCurrent(p_gl_window);
 
     glViewport(0, 0, width, height);
-    draw_texture(width, height, GL_UNSIGNED_BYTE, gl_format, image_to_show->query_data());
+    draw_texture(width, height, GL_UNSIGNED_BYTE, gl_format, data);
     glfwSwapBuffers(p_gl_window);
     glClear(GL_COLOR_BUFFER_BIT);
     
@@ -0,0 +1,378 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "disk_read_factory.h"
+
+using namespace std;
+using namespace rs::core;
+
+namespace
+{
+    //samples copied from the reader index in each scan call
+    const uint32_t SCAN_BATCH_SIZE = 4096;
+
+    struct inspect_options
+    {
+        double      bucket_seconds;
+        bool        print_bitrate_series;
+        unsigned    jobs;
+    };
+
+    struct stream_report
+    {
+        uint32_t                header_frames;          //frames count of the recording header, or the indexed frames if it has none
+        uint64_t                frames;
+        uint64_t                gaps;                   //frame number jumps between consecutive frames
+        uint64_t                missing_frames;         //frame numbers skipped by the gaps
+        uint64_t                recorder_drop_events;
+        uint64_t                recorder_dropped_frames;
+        uint64_t                application_drop_events;
+        uint64_t                application_dropped_frames;
+        uint64_t                stored_bytes;           //bytes of the frames whose size is known from the offset of the next sample
+        uint64_t                raw_bytes;              //uncompressed bytes of the same frames
+        bool                    is_striped;             //the image data is stored in stripe files, the stored bytes are unknown
+        vector<uint64_t>        bucket_bytes;           //stored bytes by capture time bucket
+        file_types::frame_info  first_frame;
+        unsigned long long      last_frame_number;
+    };
+
+    struct inspect_result
+    {
+        string                              path;
+        string                              error;
+        rs::playback::file_info             info;
+        uint64_t                            file_bytes;
+        uint64_t                            duration;   //microseconds, capture time of the last sample
+        uint64_t                            samples;
+        uint64_t                            motion_samples;
+        bool                                is_indexed; //the samples were read from the samples index file, the recording was read to its headers only
+        map<rs_stream, stream_report>       streams;
+        double                              seconds;
+    };
+
+    bool file_size(const string & path, uint64_t & size, bool & is_directory)
+    {
+        struct stat info = {};
+        if(stat(path.c_str(), &info) != 0)
+            return false;
+        size = static_cast<uint64_t>(info.st_size);
+        is_directory = S_ISDIR(info.st_mode);
+        return true;
+    }
+
+    //the file starts with the id of a recording format the playback reads
+    bool is_recording(const string & path)
+    {
+        FILE * file = fopen(path.c_str(), "rb");
+        if(!file)
+            return false;
+        int32_t id = 0;
+        bool has_id = fread(&id, sizeof(id), 1, file) == 1;
+        fclose(file);
+        return has_id && (id == UID('R', 'S', 'L', '1') || id == UID('R', 'S', 'L', '2') ||
+                          id == UID('R', 'S', 'L', '3') || id == UID('R', 'S', 'C', 'F'));
+    }
+
+    //the recordings of the directory, sorted by name, the index files and other files next to them are skipped
+    void list_recordings(const string & directory_path, vector<string> & paths)
+    {
+        DIR * directory = opendir(directory_path.c_str());
+        if(!directory)
+            return;
+        vector<string> found;
+        while(dirent * entry = readdir(directory))
+        {
+            string name = entry->d_name;
+            if(name == "." || name == "..")
+                continue;
+            auto path = directory_path + "/" + name;
+            uint64_t size = 0;
+            bool is_directory = false;
+            if(file_size(path, size, is_directory) && !is_directory && is_recording(path))
+                found.push_back(path);
+        }
+        closedir(directory);
+        sort(found.begin(), found.end());
+        paths.insert(paths.end(), found.begin(), found.end());
+    }
+
+    uint64_t raw_frame_size(const file_types::frame_info & frame)
+    {
+        auto row_size = frame.stride > 0 ? frame.stride : frame.width * frame.bpp;
+        return static_cast<uint64_t>(max(row_size, 0)) * static_cast<uint64_t>(max(frame.height, 0));
+    }
+
+    //the frames and events are taken from the reader index and the recording header, no sample is read. the stored size of a frame is
+    //the distance to the next sample in the file, the size of the last sample isn't known, the file ends with the seek tables
+    inspect_result inspect(const string & path, const inspect_options & options)
+    {
+        inspect_result result = {};
+        result.path = path;
+        auto start_time = chrono::steady_clock::now();
+        bool is_directory = false;
+        file_size(path, result.file_bytes, is_directory);
+
+        unique_ptr<rs::playback::disk_read_interface> reader;
+        auto sts = rs::playback::disk_read_factory::create_disk_read(path.c_str(), reader);
+        if(sts != status_no_error)
+        {
+            result.error = "failed to open the recording, status - " + to_string(sts);
+            return result;
+        }
+        result.info = reader->query_file_info();
+        result.is_indexed = reader->query_index_progress() >= 1.0;
+
+        vector<rs::playback::sample_descriptor> samples;
+        vector<rs::playback::sample_descriptor> batch;
+        uint64_t position = 0;
+        while(reader->scan_samples(position, batch, SCAN_BATCH_SIZE) > 0)
+            samples.insert(samples.end(), batch.begin(), batch.end());
+        result.samples = samples.size();
+
+        for(auto & stream_info : reader->get_streams_infos())
+        {
+            auto & report = result.streams[stream_info.first];
+            report.header_frames = reader->query_number_of_frames(stream_info.first);
+            report.is_striped = stream_info.second.ctype == file_types::compression_type::lz4_striped;
+        }
+
+        //the offsets in file order, a sample ends where the next one starts
+        vector<uint64_t> offsets;
+        offsets.reserve(samples.size());
+        for(auto & sample : samples)
+            offsets.push_back(sample.offset);
+        sort(offsets.begin(), offsets.end());
+        offsets.erase(unique(offsets.begin(), offsets.end()), offsets.end());
+
+        auto bucket_size = max<uint64_t>(1, static_cast<uint64_t>(options.bucket_seconds * 1e6));
+        for(auto & sample : samples)
+        {
+            result.duration = max(result.duration, sample.capture_time);
+            switch(sample.type)
+            {
+                case file_types::sample_type::st_image:
+                {
+                    auto & report = result.streams[sample.stream];
+                    if(report.frames > 0 && sample.frame.number > report.last_frame_number + 1)
+                    {
+                        report.gaps++;
+                        report.missing_frames += sample.frame.number - report.last_frame_number - 1;
+                    }
+                    if(report.frames == 0)
+                        report.first_frame = sample.frame;
+                    report.last_frame_number = sample.frame.number;
+                    report.frames++;
+
+                    auto next = upper_bound(offsets.begin(), offsets.end(), sample.offset);
+                    if(next == offsets.end())
+                        break;
+                    auto stored_size = *next - sample.offset;
+                    report.stored_bytes += stored_size;
+                    report.raw_bytes += raw_frame_size(sample.frame);
+                    auto bucket = static_cast<size_t>(sample.capture_time / bucket_size);
+                    if(report.bucket_bytes.size() <= bucket)
+                        report.bucket_bytes.resize(bucket + 1, 0);
+                    report.bucket_bytes[bucket] += stored_size;
+                }
+                break;
+                case file_types::sample_type::st_motion:
+                case file_types::sample_type::st_time:
+                    result.motion_samples++;
+                    break;
+                case file_types::sample_type::st_debug_event:
+                {
+                    if(sample.stream == RS_STREAM_COUNT)
+                        break;
+                    auto & report = result.streams[sample.stream];
+                    if(sample.event_type == file_types::debug_event_type::recorder_frame_drop)
+                    {
+                        report.recorder_drop_events++;
+                        report.recorder_dropped_frames += sample.frame_drop_count;
+                    }
+                    else if(sample.event_type == file_types::debug_event_type::application_frame_drop)
+                    {
+                        report.application_drop_events++;
+                        report.application_dropped_frames += sample.frame_drop_count;
+                    }
+                }
+                break;
+                default:
+                    break;
+            }
+        }
+        result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        return result;
+    }
+
+    string stream_name(rs_stream stream)
+    {
+        switch(stream)
+        {
+            case RS_STREAM_DEPTH: return "depth";
+            case RS_STREAM_COLOR: return "color";
+            case RS_STREAM_INFRARED: return "infrared";
+            case RS_STREAM_INFRARED2: return "infrared2";
+            case RS_STREAM_FISHEYE: return "fisheye";
+            default: return "stream " + to_string(static_cast<int>(stream));
+        }
+    }
+
+    string format_result(const inspect_result & result, const inspect_options & options)
+    {
+        stringstream out;
+        out << fixed << setprecision(2);
+        out << result.path << endl;
+        if(!result.error.empty())
+        {
+            out << "  failed, " << result.error << endl;
+            return out.str();
+        }
+
+        auto duration_seconds = static_cast<double>(result.duration) / 1e6;
+        out << "  file version " << result.info.version << ", sdk " << result.info.sdk_version << ", librealsense " << result.info.librealsense_version
+            << ", " << static_cast<double>(result.file_bytes) / 1e6 << " MB, " << duration_seconds << " s, " << result.samples << " samples, "
+            << result.motion_samples << " motion samples" << endl;
+        if(!result.is_indexed)
+            out << "  the recording has no samples index file, its samples were indexed from the recording" << endl;
+
+        for(auto & stream : result.streams)
+        {
+            auto & report = stream.second;
+            if(report.frames == 0 && report.header_frames == 0)
+                continue;
+            out << "  " << stream_name(stream.first) << " " << report.first_frame.width << "x" << report.first_frame.height
+                << " @ " << report.first_frame.framerate << " fps, " << report.frames << " frames";
+            if(report.header_frames != report.frames)
+                out << " (" << report.header_frames << " in the header)";
+            out << endl;
+            out << "    gaps " << report.gaps << ", missing frames " << report.missing_frames
+                << ", recorder drops " << report.recorder_drop_events << " events / " << report.recorder_dropped_frames << " frames"
+                << ", application drops " << report.application_drop_events << " events / " << report.application_dropped_frames << " frames" << endl;
+
+            if(report.is_striped)
+            {
+                out << "    the image data is stored in stripe files, its bitrate and compression ratio aren't known from the index" << endl;
+                continue;
+            }
+            if(report.stored_bytes == 0)
+                continue;
+
+            //the buckets the stream has frames in, a stream which started late or stopped early isn't averaged over the empty buckets
+            double min_rate = 0, max_rate = 0, sum_rate = 0;
+            size_t rate_count = 0;
+            for(auto bytes : report.bucket_bytes)
+            {
+                if(bytes == 0)
+                    continue;
+                auto rate = static_cast<double>(bytes * 8) / options.bucket_seconds / 1e6;
+                min_rate = rate_count == 0 ? rate : min(min_rate, rate);
+                max_rate = max(max_rate, rate);
+                sum_rate += rate;
+                rate_count++;
+            }
+            out << "    bitrate min " << min_rate << ", avg " << (rate_count ? sum_rate / static_cast<double>(rate_count) : 0) << ", max " << max_rate
+                << " Mbit/s, compression ratio " << static_cast<double>(report.raw_bytes) / static_cast<double>(report.stored_bytes) << endl;
+            if(options.print_bitrate_series)
+            {
+                out << "    Mbit/s by " << options.bucket_seconds << " s:";
+                for(auto bytes : report.bucket_bytes)
+                    out << " " << static_cast<double>(bytes * 8) / options.bucket_seconds / 1e6;
+                out << endl;
+            }
+        }
+        out << "  inspected in " << setprecision(3) << result.seconds << " s" << endl;
+        return out.str();
+    }
+
+    void print_help()
+    {
+        cout << "Usage: rs_record_inspector_tool [options] <recording or directory> [...]" << endl;
+        cout << "Prints the frame counts, the frame number gaps, the drop events, the bitrate and the compression ratio of each stream" << endl;
+        cout << "of recordings. Only the recording headers and the samples index are read, a recording without a samples index file" << endl;
+        cout << "is indexed by its sample headers." << endl;
+        cout << "  -b <seconds> Bitrate bucket length. Default is 1." << endl;
+        cout << "  -s           Print the bitrate of each bucket." << endl;
+        cout << "  -j <count>   Number of recordings inspected concurrently. Default is the number of cores." << endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    inspect_options options = {};
+    options.bucket_seconds = 1;
+    options.jobs = max(1u, thread::hardware_concurrency());
+    vector<string> inputs;
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if(arg == "-h" || arg == "--help")
+        {
+            print_help();
+            return 0;
+        }
+        else if(arg == "-b" && has_value)
+            options.bucket_seconds = atof(argv[++i]);
+        else if(arg == "-s")
+            options.print_bitrate_series = true;
+        else if(arg == "-j" && has_value)
+            options.jobs = static_cast<unsigned>(max(1, atoi(argv[++i])));
+        else if(!arg.empty() && arg[0] == '-')
+        {
+            print_help();
+            return -1;
+        }
+        else
+        {
+            uint64_t size = 0;
+            bool is_directory = false;
+            if(file_size(arg, size, is_directory) && is_directory)
+                list_recordings(arg, inputs);
+            else
+                inputs.push_back(arg);
+        }
+    }
+    if(inputs.empty() || options.bucket_seconds <= 0)
+    {
+        print_help();
+        return -1;
+    }
+
+    //the results are printed in the inputs order once all the recordings are inspected
+    vector<inspect_result> results(inputs.size());
+    atomic<size_t> next_input(0);
+    auto worker = [&]()
+    {
+        for(size_t index = next_input++; index < inputs.size(); index = next_input++)
+            results[index] = inspect(inputs[index], options);
+    };
+
+    vector<thread> workers;
+    for(unsigned i = 0; i < min<size_t>(options.jobs, inputs.size()); i++)
+        workers.emplace_back(worker);
+    for(auto & worker_thread : workers)
+        worker_thread.join();
+
+    size_t failures = 0;
+    for(auto & result : results)
+    {
+        if(!result.error.empty())
+            failures++;
+        cout << format_result(result, options);
+    }
+    return failures > 0 ? -1 : 0;
+}
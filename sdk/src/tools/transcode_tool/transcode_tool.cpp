@@ -0,0 +1,266 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include "disk_read_factory.h"
+#include "disk_write.h"
+#include "rs/utils/numa_topology.h"
+
+using namespace std;
+using namespace rs::core;
+
+namespace
+{
+    //samples a file may have waiting for its writer, bounds the memory of a transcoded file to a few frames of each stream
+    const size_t MAX_QUEUED_SAMPLES = 16;
+    //frames read and decoded ahead of the transcoded sample
+    const uint32_t READ_AHEAD_SAMPLES = 4;
+
+    struct transcode_options
+    {
+        string                          output_dir;
+        rs::record::compression_level   compression_level;
+        bool                            overwrite;
+        unsigned                        jobs;
+    };
+
+    struct transcode_result
+    {
+        string      output_path;
+        string      error;
+        uint64_t    frames;
+        uint64_t    dropped_frames;
+        uint64_t    input_bytes;
+        uint64_t    output_bytes;
+        double      seconds;
+    };
+
+    bool file_exists(const string & path, uint64_t * size = nullptr)
+    {
+        struct stat info = {};
+        if(stat(path.c_str(), &info) != 0)
+            return false;
+        if(size)
+            *size = static_cast<uint64_t>(info.st_size);
+        return true;
+    }
+
+    string output_path(const string & input_path, const transcode_options & options)
+    {
+        if(options.output_dir.empty())
+            return input_path + ".transcoded";
+        auto name_position = input_path.find_last_of('/');
+        auto name = name_position == string::npos ? input_path : input_path.substr(name_position + 1);
+        return options.output_dir + "/" + name;
+    }
+
+    bool parse_compression_level(const string & value, rs::record::compression_level & level)
+    {
+        if(value == "disabled") level = rs::record::compression_level::disabled;
+        else if(value == "low") level = rs::record::compression_level::low;
+        else if(value == "medium") level = rs::record::compression_level::medium;
+        else if(value == "high") level = rs::record::compression_level::high;
+        else return false;
+        return true;
+    }
+
+    //copies the recording samples to a recording of the current format, the samples are decoded and encoded again by the recorder codecs
+    transcode_result transcode(const string & input_path, const transcode_options & options)
+    {
+        transcode_result result = {};
+        result.output_path = output_path(input_path, options);
+        auto start_time = chrono::steady_clock::now();
+        file_exists(input_path, &result.input_bytes);
+        if(!options.overwrite && file_exists(result.output_path))
+        {
+            result.error = "output file exists";
+            return result;
+        }
+
+        unique_ptr<rs::playback::disk_read_interface> reader;
+        auto sts = rs::playback::disk_read_factory::create_disk_read(input_path.c_str(), reader);
+        if(sts != status_no_error)
+        {
+            result.error = "failed to open the recording, status - " + to_string(sts);
+            return result;
+        }
+
+        rs::record::configuration config = {};
+        config.m_file_path = result.output_path;
+        //the camera info strings are owned by the reader, which outlives the writer configuration
+        for(auto & info : reader->get_camera_info())
+            config.m_camera_info[info.first] = { static_cast<uint32_t>(info.second.size() + 1), info.second.c_str() };
+        reader->get_properties().for_each([&config](rs_option option, double value) { config.m_options.push_back({ option, value }); });
+        for(auto & stream_info : reader->get_streams_infos())
+        {
+            config.m_stream_profiles[stream_info.first] = stream_info.second.profile;
+            config.m_compression_config[stream_info.first] = options.compression_level;
+            reader->enable_stream(stream_info.first, true);
+        }
+        config.m_coordinate_system = static_cast<file_types::coordinate_system>(reader->query_coordinate_system());
+        config.m_capabilities = reader->get_capabilities();
+        config.m_motion_intrinsics = reader->get_motion_intrinsics();
+        config.m_capture_mode = reader->query_capture_mode();
+        config.m_numa_node = rs::utils::numa_topology::UNKNOWN_NODE;
+        for(auto capability : config.m_capabilities)
+        {
+            if(capability == rs_capabilities::RS_CAPABILITIES_MOTION_EVENTS)
+                reader->enable_motions_callback(true);
+        }
+
+        rs::record::disk_write writer;
+        try
+        {
+            sts = writer.configure(config);
+        }
+        catch(const exception & e)
+        {
+            result.error = e.what();
+            return result;
+        }
+        if(sts != status_no_error || !writer.start())
+        {
+            result.error = "failed to configure the writer, status - " + to_string(sts);
+            return result;
+        }
+
+        mutex eof_mutex;
+        condition_variable eof_cv;
+        bool eof = false;
+        reader->set_realtime(false);
+        reader->set_read_ahead_window(READ_AHEAD_SAMPLES);
+        reader->set_callback((function<void()>)([&]()
+        {
+            lock_guard<mutex> guard(eof_mutex);
+            eof = true;
+            eof_cv.notify_one();
+        }));
+        //the reader waits for the writer, a sample is never dropped because the writer is behind
+        reader->set_callback([&](shared_ptr<file_types::sample> sample)
+        {
+            while(writer.query_queue_depth() >= MAX_QUEUED_SAMPLES)
+                this_thread::sleep_for(chrono::milliseconds(1));
+            if(sample->info.type == file_types::sample_type::st_image)
+                result.frames++;
+            writer.record_sample(sample);
+        });
+
+        reader->resume();
+        {
+            unique_lock<mutex> guard(eof_mutex);
+            eof_cv.wait(guard, [&]() { return eof; });
+        }
+        reader->pause();
+
+        //the writer stops without writing the queued samples
+        while(writer.query_queue_depth() > 0)
+            this_thread::sleep_for(chrono::milliseconds(1));
+        writer.stop();
+
+        for(auto & profile : config.m_stream_profiles)
+        {
+            rs::record::recording_statistics statistics = {};
+            writer.query_recording_statistics(profile.first, statistics);
+            result.dropped_frames += statistics.dropped_frames_count;
+        }
+        if(result.dropped_frames > 0)
+            result.error = to_string(result.dropped_frames) + " frames were dropped";
+        file_exists(result.output_path, &result.output_bytes);
+        result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        return result;
+    }
+
+    void print_help()
+    {
+        cout << "Usage: rs_transcode_tool [options] <recording> [<recording> ...]" << endl;
+        cout << "Transcodes recordings of any file format version to the current format, compressed and indexed." << endl;
+        cout << "  -o <dir>     Output directory, the transcoded recording keeps its file name." << endl;
+        cout << "               By default the output is written next to the recording with a .transcoded suffix." << endl;
+        cout << "  -c <level>   Compression level of all streams - disabled, low, medium or high. Default is high." << endl;
+        cout << "  -j <count>   Number of recordings transcoded concurrently. Default is the number of cores." << endl;
+        cout << "  -f           Overwrite existing output files." << endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    transcode_options options = {};
+    options.compression_level = rs::record::compression_level::high;
+    options.jobs = max(1u, thread::hardware_concurrency());
+    vector<string> inputs;
+    for(int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if(arg == "-h" || arg == "--help")
+        {
+            print_help();
+            return 0;
+        }
+        else if(arg == "-o" && has_value)
+            options.output_dir = argv[++i];
+        else if(arg == "-c" && has_value)
+        {
+            if(!parse_compression_level(argv[++i], options.compression_level))
+            {
+                cerr << "unknown compression level " << argv[i] << endl;
+                return -1;
+            }
+        }
+        else if(arg == "-j" && has_value)
+            options.jobs = static_cast<unsigned>(max(1, atoi(argv[++i])));
+        else if(arg == "-f")
+            options.overwrite = true;
+        else if(!arg.empty() && arg[0] == '-')
+        {
+            print_help();
+            return -1;
+        }
+        else
+            inputs.push_back(arg);
+    }
+    if(inputs.empty())
+    {
+        print_help();
+        return -1;
+    }
+
+    //each worker transcodes one recording at a time, the memory in use is bounded by the number of workers
+    atomic<size_t> next_input(0);
+    atomic<size_t> failures(0);
+    mutex output_mutex;
+    auto worker = [&]()
+    {
+        for(size_t index = next_input++; index < inputs.size(); index = next_input++)
+        {
+            auto result = transcode(inputs[index], options);
+            lock_guard<mutex> guard(output_mutex);
+            if(!result.error.empty())
+            {
+                failures++;
+                cerr << inputs[index] << " - failed, " << result.error << endl;
+                continue;
+            }
+            cout << inputs[index] << " -> " << result.output_path << " - " << result.frames << " frames, "
+                 << static_cast<double>(result.input_bytes) / 1e6 << " MB -> " << static_cast<double>(result.output_bytes) / 1e6 << " MB in " << result.seconds << " s" << endl;
+        }
+    };
+
+    vector<thread> workers;
+    for(unsigned i = 0; i < min<size_t>(options.jobs, inputs.size()); i++)
+        workers.emplace_back(worker);
+    for(auto & worker_thread : workers)
+        worker_thread.join();
+
+    cout << inputs.size() - failures << " of " << inputs.size() << " recordings transcoded" << endl;
+    return failures > 0 ? -1 : 0;
+}
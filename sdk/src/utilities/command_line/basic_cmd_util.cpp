@@ -129,6 +129,7 @@ namespace rs
                 add_single_arg_option("-n", "set minimum number of frames to capture per stream");
                 add_option("-r -render", "enable streaming display");
                 add_option("-nrt -non_real_time", "playback in non real time mode");
+                add_single_arg_option("-bench -benchmark", "run a throughput benchmark for the capture time and write the json report to a file");
 
                 set_usage_example("-c -cconf 640-480-30 -cpf rgba8 -rec rec.rssdk -r\n\n"
                                   "The following command will configure the camera to\n"
@@ -284,6 +285,14 @@ namespace rs
             return get_cmd_option("-fi -file_info", opt);
         }
 
+        std::string basic_cmd_util::get_benchmark_file_path()
+        {
+            rs::utils::cmd_option opt;
+            if(!get_cmd_option("-bench -benchmark", opt)) return "";
+            if(opt.m_option_args_values.size() == 0) return "";
+            return opt.m_option_args_values[0];
+        }
+
         bool basic_cmd_util::is_rendering_enabled()
         {
             rs::utils::cmd_option opt;
@@ -26,7 +26,13 @@ namespace rs
 {
 	namespace utils
 	{
-		log_util::log_util(wchar_t* name)
+		namespace
+		{
+			//a level above all the levels, cached when the logger logs nothing
+			const logging_service::log_level DISABLED_LEVEL = static_cast<logging_service::log_level>(logging_service::level_fatal + 1);
+		}
+
+		log_util::log_util(wchar_t* name) : m_enabled_level(DISABLED_LEVEL)
 		{
 #ifdef WIN32
 			m_logger = &m_empty_logger;
@@ -107,6 +113,7 @@ namespace rs
 			m_logger->set_logger_name(wc);
 			delete[] wc;
 			FreeLibrary(handle);
+			update_enabled_level();
 #else
 			m_logger = &m_empty_logger;
 
@@ -241,15 +248,42 @@ namespace rs
 			mbstowcs(wc, name_string.c_str(), cSize);
 			m_logger->set_logger_name(wc);
 			delete[] wc;
+			update_enabled_level();
 #endif
 		}
 
+		status log_util::set_level(logging_service::log_level level)
+		{
+			auto sts = m_logger->set_level(level);
+			update_enabled_level();
+			return sts;
+		}
+
+		void log_util::update_enabled_level()
+		{
+			//the lowest level the logger logs, the empty logger logs nothing
+			static const logging_service::log_level levels[] = { logging_service::level_verbose, logging_service::level_trace, logging_service::level_debug,
+			                                                     logging_service::level_info, logging_service::level_warn, logging_service::level_error,
+			                                                     logging_service::level_fatal };
+			logging_service::log_level enabled_level = DISABLED_LEVEL;
+			for (auto level : levels)
+			{
+				if (m_logger->is_level_enabled(level))
+				{
+					enabled_level = level;
+					break;
+				}
+			}
+			m_enabled_level = enabled_level;
+		}
+
 		log_util::~log_util()
 		{
 
 			if (m_logger != &m_empty_logger)
 			{
 				m_logger = &m_empty_logger;
+				m_enabled_level = DISABLED_LEVEL;
 			}
 		}
 	}
@@ -0,0 +1,180 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include "async_logger.h"
+
+using namespace rs::core;
+
+namespace
+{
+    //the background thread drains the rings periodically, error messages wake it up
+    const std::chrono::milliseconds DRAIN_PERIOD(2);
+
+    std::atomic<rs::utils::async_logger*> at_exit_logger(nullptr);
+
+    //marks the ring of a thread as done when the thread exits, the background thread releases it once it is drained
+    template<typename ring_type>
+    struct thread_ring_holder
+    {
+        ~thread_ring_holder()
+        {
+            if(ring)
+                ring->is_thread_done = true;
+        }
+        std::shared_ptr<ring_type> ring;
+        const void * owner = nullptr;
+    };
+}
+
+namespace rs
+{
+    namespace utils
+    {
+        async_logger::async_logger(logging_service * sink) : m_sink(sink), m_is_running(true)
+        {
+            m_thread = std::thread(&async_logger::thread_loop, this);
+            //the messages which are queued when the process exits are forwarded before the sink is destroyed
+            if(at_exit_logger.exchange(this) == nullptr)
+                std::atexit(&async_logger::stop_at_exit);
+        }
+
+        async_logger::~async_logger()
+        {
+            stop();
+            auto self = this;
+            at_exit_logger.compare_exchange_strong(self, nullptr);
+        }
+
+        void async_logger::stop_at_exit()
+        {
+            auto instance = at_exit_logger.load();
+            if(instance)
+                instance->stop();
+        }
+
+        void async_logger::stop()
+        {
+            if(!m_is_running.exchange(false))
+                return;
+            m_wake_cv.notify_one();
+            if(m_thread.joinable())
+                m_thread.join();
+            drain_rings();
+        }
+
+        void async_logger::log(log_level level, const char* message, const char* file_name, int line_number, const char* function_name)
+        {
+            record item;
+            item.level = level;
+            item.file_name = file_name;
+            item.function_name = function_name;
+            item.line_number = line_number;
+            item.is_wide = false;
+            strncpy(item.text, message ? message : "", MAX_MESSAGE_LENGTH - 1);
+            item.text[MAX_MESSAGE_LENGTH - 1] = 0;
+            push(item);
+        }
+
+        void async_logger::logw(log_level level, const wchar_t* message, const char* file_name, int line_number, const char* function_name)
+        {
+            record item;
+            item.level = level;
+            item.file_name = file_name;
+            item.function_name = function_name;
+            item.line_number = line_number;
+            item.is_wide = true;
+            wcsncpy(item.wide_text, message ? message : L"", MAX_MESSAGE_LENGTH - 1);
+            item.wide_text[MAX_MESSAGE_LENGTH - 1] = 0;
+            push(item);
+        }
+
+        async_logger::thread_ring * async_logger::get_thread_ring()
+        {
+            static thread_local thread_ring_holder<thread_ring> holder;
+            if(holder.owner != this)
+            {
+                if(holder.ring)
+                    holder.ring->is_thread_done = true;
+                holder.ring = std::make_shared<thread_ring>();
+                holder.owner = this;
+                std::lock_guard<std::mutex> guard(m_mutex);
+                m_rings.push_back(holder.ring);
+            }
+            return holder.ring.get();
+        }
+
+        void async_logger::push(record & item)
+        {
+            //once the background thread is stopped the messages are forwarded by the logging thread
+            if(!m_is_running.load(std::memory_order_relaxed))
+            {
+                forward(item);
+                return;
+            }
+            auto ring = get_thread_ring();
+            if(!ring->records.push(item))
+                ring->dropped_count.fetch_add(1, std::memory_order_relaxed);
+            if(item.level >= level_error)
+                m_wake_cv.notify_one();
+        }
+
+        void async_logger::forward(const record & item)
+        {
+            if(item.is_wide)
+                m_sink->logw(item.level, item.wide_text, item.file_name, item.line_number, item.function_name);
+            else
+                m_sink->log(item.level, item.text, item.file_name, item.line_number, item.function_name);
+        }
+
+        bool async_logger::drain_rings()
+        {
+            std::vector<std::shared_ptr<thread_ring>> rings;
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                rings = m_rings;
+            }
+
+            bool is_forwarded = false;
+            record item;
+            for(auto & ring : rings)
+            {
+                //the flag is read before the ring is drained, a done thread doesn't push after it
+                bool is_thread_done = ring->is_thread_done.load();
+                while(ring->records.pop(item))
+                {
+                    forward(item);
+                    is_forwarded = true;
+                }
+                auto dropped_count = ring->dropped_count.exchange(0);
+                if(dropped_count > 0)
+                {
+                    auto message = std::to_string(dropped_count) + " log messages were dropped, the thread log ring was full";
+                    m_sink->log(level_warn, message.c_str(), __FILE__, __LINE__, __FUNCTION__);
+                }
+                if(is_thread_done)
+                {
+                    std::lock_guard<std::mutex> guard(m_mutex);
+                    m_rings.erase(std::remove(m_rings.begin(), m_rings.end(), ring), m_rings.end());
+                }
+            }
+            return is_forwarded;
+        }
+
+        void async_logger::thread_loop()
+        {
+            while(m_is_running)
+            {
+                if(drain_rings())
+                    continue;
+                std::unique_lock<std::mutex> guard(m_mutex);
+                m_wake_cv.wait_for(guard, DRAIN_PERIOD);
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include "rs/utils/logging_service.h"
+#include "spsc_queue.h"
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Logger which hands the messages to a background thread, the background thread forwards them to the sink logger.
+        *
+        * Each logging thread owns a lock free ring of messages, logging a message copies it to the ring and returns,
+        * the sink logger layout, appenders and io run on the background thread. A message which doesn't fit in the ring slot
+        * is truncated, a message which doesn't fit in a full ring is dropped and counted.
+        * The messages of a thread keep their order, the order between threads is the order the background thread drains the rings.
+        */
+        class async_logger : public logging_service
+        {
+        public:
+            //the ring slot text size, in characters
+            static const uint32_t MAX_MESSAGE_LENGTH = 256;
+            static const uint32_t THREAD_RING_CAPACITY = 1024;
+
+            explicit async_logger(logging_service * sink);
+            virtual ~async_logger();
+
+            virtual rs::core::status set_logger_name(const wchar_t* name) override { return m_sink->set_logger_name(name); }
+            virtual rs::core::status configure(config_mode config_mode, const wchar_t* config, int file_watch_delay) override { return m_sink->configure(config_mode, config, file_watch_delay); }
+            virtual bool is_configured() override { return m_sink->is_configured(); }
+            virtual rs::core::status set_level(log_level level) override { return m_sink->set_level(level); }
+            virtual bool is_level_enabled(log_level level) override { return m_sink->is_level_enabled(level); }
+            virtual log_level get_level() override { return m_sink->get_level(); }
+            virtual logger_type get_logger_type() override { return m_sink->get_logger_type(); }
+            virtual void log(log_level level, const char* message, const char* file_name, int line_number, const char* function_name) override;
+            virtual void logw(log_level level, const wchar_t* message, const char* file_name, int line_number, const char* function_name) override;
+
+            //forwards the queued messages and stops the background thread, later messages are forwarded by the logging thread
+            void stop();
+
+        private:
+            struct record
+            {
+                log_level       level;
+                const char *    file_name;      //the log macros pass string literals, the pointers outlive the record
+                const char *    function_name;
+                int             line_number;
+                bool            is_wide;
+                union
+                {
+                    char        text[MAX_MESSAGE_LENGTH];
+                    wchar_t     wide_text[MAX_MESSAGE_LENGTH];
+                };
+            };
+
+            struct thread_ring
+            {
+                thread_ring() : records(THREAD_RING_CAPACITY), dropped_count(0), is_thread_done(false) {}
+                rs::core::spsc_queue<record>    records;
+                std::atomic<uint32_t>           dropped_count;
+                std::atomic<bool>               is_thread_done;
+            };
+
+            async_logger(const async_logger &) = delete;
+            async_logger & operator= (const async_logger &) = delete;
+
+            thread_ring * get_thread_ring();
+            void push(record & item);
+            void forward(const record & item);
+            void thread_loop();
+            bool drain_rings();
+            static void stop_at_exit();
+
+            std::unique_ptr<logging_service>            m_sink;
+            std::mutex                                  m_mutex;
+            std::condition_variable                     m_wake_cv;
+            std::vector<std::shared_ptr<thread_ring>>   m_rings;        //guarded by m_mutex, a ring is added once per logging thread
+            std::atomic<bool>                           m_is_running;
+            std::thread                                 m_thread;
+        };
+    }
+}
@@ -2,6 +2,7 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 #include "rs/utils/logging_service.h"
 #include "xlevel.h"
+#include "async_logger.h"
 
 #include <log4cxx/logstring.h>
 #include <log4cxx/logger.h>
@@ -154,7 +155,8 @@ namespace rs
 extern "C" status get_logger_instance(rs::utils::logging_service **instance)
 {
     if (!instance) return status_handle_invalid;
-    *instance = new rs::utils::Log4cxx();
+    //log4cxx layout and appenders run on the async logger thread, off the logging threads
+    *instance = new rs::utils::async_logger(new rs::utils::Log4cxx());
     return (*instance) ? status_no_error : status_alloc_failed;
 }
 
@@ -0,0 +1,93 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <atomic>
+#include "rs/utils/memory_accounting.h"
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace utils
+    {
+        namespace
+        {
+            struct subsystem_counters
+            {
+                std::atomic<uint64_t> bytes;
+                std::atomic<uint64_t> peak_bytes;
+                std::atomic<uint64_t> dropped_bytes;
+            };
+
+            //zero initialized as static storage, before any subsystem accounts its samples
+            subsystem_counters counters[static_cast<int32_t>(memory_subsystem::max)];
+            std::atomic<uint64_t> total_bytes;
+            std::atomic<uint64_t> budget;
+
+            bool is_subsystem_valid(memory_subsystem subsystem)
+            {
+                return subsystem >= memory_subsystem::recording && subsystem < memory_subsystem::max;
+            }
+        }
+
+        memory_usage memory_accounting::query_usage(memory_subsystem subsystem)
+        {
+            memory_usage usage = {};
+            if(!is_subsystem_valid(subsystem))
+                return usage;
+            auto & subsystem_counters = counters[static_cast<int32_t>(subsystem)];
+            usage.bytes = subsystem_counters.bytes.load(std::memory_order_relaxed);
+            usage.peak_bytes = subsystem_counters.peak_bytes.load(std::memory_order_relaxed);
+            usage.dropped_bytes = subsystem_counters.dropped_bytes.load(std::memory_order_relaxed);
+            return usage;
+        }
+
+        uint64_t memory_accounting::query_total_bytes()
+        {
+            return total_bytes.load(std::memory_order_relaxed);
+        }
+
+        status memory_accounting::set_budget(uint64_t max_bytes)
+        {
+            budget.store(max_bytes, std::memory_order_relaxed);
+            return status_no_error;
+        }
+
+        uint64_t memory_accounting::query_budget()
+        {
+            return budget.load(std::memory_order_relaxed);
+        }
+
+        bool memory_accounting::is_within_budget(uint64_t bytes)
+        {
+            auto max_bytes = budget.load(std::memory_order_relaxed);
+            return max_bytes == 0 || total_bytes.load(std::memory_order_relaxed) + bytes <= max_bytes;
+        }
+
+        void memory_accounting::add(memory_subsystem subsystem, uint64_t bytes)
+        {
+            if(!is_subsystem_valid(subsystem) || bytes == 0)
+                return;
+            auto & subsystem_counters = counters[static_cast<int32_t>(subsystem)];
+            auto subsystem_bytes = subsystem_counters.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            total_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            auto peak_bytes = subsystem_counters.peak_bytes.load(std::memory_order_relaxed);
+            while(subsystem_bytes > peak_bytes && !subsystem_counters.peak_bytes.compare_exchange_weak(peak_bytes, subsystem_bytes, std::memory_order_relaxed));
+        }
+
+        void memory_accounting::remove(memory_subsystem subsystem, uint64_t bytes)
+        {
+            if(!is_subsystem_valid(subsystem) || bytes == 0)
+                return;
+            counters[static_cast<int32_t>(subsystem)].bytes.fetch_sub(bytes, std::memory_order_relaxed);
+            total_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        }
+
+        void memory_accounting::add_dropped(memory_subsystem subsystem, uint64_t bytes)
+        {
+            if(!is_subsystem_valid(subsystem))
+                return;
+            counters[static_cast<int32_t>(subsystem)].dropped_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+}
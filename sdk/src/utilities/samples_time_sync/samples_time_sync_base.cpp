@@ -2,7 +2,10 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include "samples_time_sync_base.h"
+#include "rs/utils/profiler_markers.h"
+#include "rs/utils/memory_accounting.h"
 #include <algorithm>
+#include <cmath>
 
 
 using namespace std;
@@ -13,7 +16,9 @@ rs::utils::samples_time_sync_base::samples_time_sync_base(int streams_fps[],
                                                             int motions_fps[],
                                                             unsigned int max_input_latency,
                                                             unsigned int not_matched_frames_buffer_size) :
-    m_highest_fps(0), m_not_matched_frames_buffer_size(not_matched_frames_buffer_size)
+    m_highest_fps(0), m_not_matched_frames_buffer_size(not_matched_frames_buffer_size), m_pending_samples(PENDING_SAMPLES_CAPACITY), m_latest_timestamp(0),
+    m_max_input_latency(max_input_latency), m_min_input_latency(0), m_input_latency(max_input_latency), m_measured_skew(0), m_latest_image_timestamp(0),
+    m_image_bytes(), m_lists_bytes(0), m_not_matched_bytes(0)
 {
     LOG_FUNC_SCOPE();
 
@@ -30,6 +35,7 @@ rs::utils::samples_time_sync_base::samples_time_sync_base(int streams_fps[],
     for (int i = 0; i<static_cast<int>(stream_type::max); i++)
     {
         m_streams_fps[i] = streams_fps[i];
+        m_buffer_capacities[i] = m_buffer_lengths[i] = 0;
 
         if (streams_fps[i] == 0 )
             continue;
@@ -43,10 +49,11 @@ rs::utils::samples_time_sync_base::samples_time_sync_base(int streams_fps[],
         if (buffer_length == 0)
             buffer_length = 1;
 
-        m_streams_map.insert(std::make_pair(static_cast<stream_type>(i), cyclic_array<rs::utils::unique_ptr<image_interface>>(buffer_length)));
+        m_buffer_capacities[i] = m_buffer_lengths[i] = buffer_length;
+        m_streams_map.insert(static_cast<stream_type>(i), cyclic_array<rs::utils::unique_ptr<image_interface>>(buffer_length));
 
         if (m_not_matched_frames_buffer_size != 0)
-            m_stream_lists_dropped_frames.insert(std::make_pair(static_cast<stream_type>(i), cyclic_array<rs::utils::unique_ptr<image_interface>>(m_not_matched_frames_buffer_size)));
+            m_stream_lists_dropped_frames.insert(static_cast<stream_type>(i), cyclic_array<rs::utils::unique_ptr<image_interface>>(m_not_matched_frames_buffer_size));
 
         LOG_DEBUG("For stream " << i << " with fps " << streams_fps[i] << " using buffer length " << buffer_length);
 
@@ -70,7 +77,10 @@ rs::utils::samples_time_sync_base::samples_time_sync_base(int streams_fps[],
 
         LOG_DEBUG("For stream " << i << " with fps " << motions_fps[i] << " using buffer length " << buffer_length);
 
-        m_motions_map.insert(std::make_pair(static_cast<motion_type>(i), cyclic_array<motion_sample>(buffer_length)));
+        m_motions_map.insert(static_cast<motion_type>(i), cyclic_array<motion_sample>(buffer_length));
+
+        // the matched motions are at most the buffered ones, they are picked without allocating
+        m_matched_motions[i].reserve(buffer_length);
     }
 
     if (registered_streams < 2)
@@ -98,14 +108,91 @@ bool rs::utils::samples_time_sync_base::empty_list_exists()
 void rs::utils::samples_time_sync_base::pop_or_save_to_not_matched(stream_type st_type)
 {
     if (m_not_matched_frames_buffer_size!=0)
-            m_stream_lists_dropped_frames[st_type].push_back( m_streams_map[st_type].front());
+    {
+        std::lock_guard<std::mutex> lock(m_dropped_images_mutex);
+        auto bytes = image_bytes(m_streams_map[st_type].front().get());
+        auto& not_matched_list = m_stream_lists_dropped_frames[st_type];
+        // the unmatched images are the first to give way to the memory budget of the sdk
+        if (memory_accounting::is_within_budget(bytes))
+        {
+            // a full buffer overwrites its oldest image
+            if (not_matched_list.size() == m_not_matched_frames_buffer_size)
+            {
+                m_not_matched_bytes -= image_bytes(not_matched_list.front().get());
+                memory_accounting::remove(memory_subsystem::samples_time_sync, image_bytes(not_matched_list.front().get()));
+            }
+            not_matched_list.push_back(m_streams_map[st_type].front());
+            m_not_matched_bytes += bytes;
+            memory_accounting::add(memory_subsystem::samples_time_sync, bytes);
+        }
+        else
+        {
+            memory_accounting::add_dropped(memory_subsystem::samples_time_sync, bytes);
+        }
+    }
 
     m_streams_map[st_type].pop_front();
 }
 
+void rs::utils::samples_time_sync_base::pick_closest_motions(motions_map& motions, double timestamp, rs::core::correlated_sample_set& sample_set)
+{
+    for (auto& motion_list : motions)
+    {
+        auto& matched_motions = m_matched_motions[static_cast<int>(motion_list.first)];
+        matched_motions.clear();
+
+        sample_set[motion_list.first] = motion_list.second.front();
+        matched_motions.push_back(motion_list.second.front());
+        motion_list.second.pop_front();
+
+        while(motion_list.second.size() > 0)
+        {
+            auto a1 = std::abs(timestamp-sample_set[motion_list.first].timestamp);
+            auto a2 = std::abs(timestamp-motion_list.second.front().timestamp);
+
+            // pick  up the closest to the selected timestamp motion sample
+            if ( a2 >= a1 )
+                break;
+
+            sample_set[motion_list.first] = motion_list.second.front();
+            matched_motions.push_back(motion_list.second.front());
+            motion_list.second.pop_front();
+        } //end of while
+    }
+}
+
+void rs::utils::samples_time_sync_base::copy_motions(const motions_span& from, motions_span& to)
+{
+    for (int i = 0; i < static_cast<int>(motion_type::max); i++)
+        to[i].assign(from[i].begin(), from[i].end());
+}
+
+rs::utils::samples_time_sync_base::motions_span& rs::utils::samples_time_sync_base::thread_returned_motions()
+{
+    auto inserted = m_returned_motions.emplace(std::this_thread::get_id(), returned_motions());
+    auto& motions = inserted.first->second.motions;
+    // the motions returned to the thread are copied without allocating after its first set
+    if (inserted.second)
+    {
+        for (int i = 0; i < static_cast<int>(motion_type::max); i++)
+            motions[i].reserve(m_matched_motions[i].capacity());
+    }
+    return motions;
+}
+
+void rs::utils::samples_time_sync_base::set_returned_motion_batches(const motions_span& motions, rs::core::correlated_sample_set& sample_set)
+{
+    for (int i = 0; i < static_cast<int>(motion_type::max); i++)
+    {
+        sample_set.motion_batches[i] = motions[i].empty() ? nullptr : motions[i].data();
+        sample_set.motion_batch_sizes[i] = static_cast<uint32_t>(motions[i].size());
+    }
+}
+
 bool rs::utils::samples_time_sync_base::insert(image_interface * new_image,
                                      rs::core::correlated_sample_set& correlated_sample)
 {
+    RS_PROFILER_ZONE("samples_time_sync_base::insert image");
     if (!new_image)
         throw std::invalid_argument("Null pointer received!");
     new_image->add_ref();
@@ -116,25 +203,234 @@ bool rs::utils::samples_time_sync_base::insert(image_interface * new_image,
     if (!is_stream_registered(stream_type))
         throw std::invalid_argument("Stream was not registered to this sync utility instance!");
 
-    std::lock_guard<std::mutex> lock_guard(m_image_mutex);
+    std::unique_lock<std::mutex> lock(m_image_mutex, std::try_to_lock);
 
-    m_streams_map[stream_type].push_back(new_unique_image);
+    if (!lock.owns_lock())
+    {
+        // another stream is being matched, hand the image over to the matching thread instead of waiting for it
+        pending_sample sample = {std::move(new_unique_image), motion_sample()};
+        if (push_pending_sample(sample))
+        {
+            if (!lock.try_lock())
+                return false;
+
+            return match_and_unlock(lock, false, correlated_sample);
+        }
+
+        new_unique_image = std::move(sample.image);
+        lock.lock();
+    }
+
+    m_latest_timestamp = std::max(m_latest_timestamp, new_unique_image->query_time_stamp());
+    push_image(new_unique_image);
 
     // return synced color and depth
-    return sync_all(m_streams_map, m_motions_map, correlated_sample);
+    return match_and_unlock(lock, true, correlated_sample);
 }
 
 
 bool rs::utils::samples_time_sync_base::insert(rs::core::motion_sample& new_motion, rs::core::correlated_sample_set& correlated_sample)
 {
+    RS_PROFILER_ZONE("samples_time_sync_base::insert motion");
     if (!is_motion_registered(new_motion.type))
         throw std::invalid_argument("Stream was not registered to this sync utility instance!");
 
-    std::lock_guard<std::mutex> lock_guard(m_image_mutex);
+    std::unique_lock<std::mutex> lock(m_image_mutex, std::try_to_lock);
 
+    if (!lock.owns_lock())
+    {
+        pending_sample sample = {rs::utils::unique_ptr<image_interface>(), new_motion};
+        if (push_pending_sample(sample))
+        {
+            if (!lock.try_lock())
+                return false;
+
+            return match_and_unlock(lock, false, correlated_sample);
+        }
+
+        lock.lock();
+    }
+
+    m_latest_timestamp = std::max(m_latest_timestamp, new_motion.timestamp);
     m_motions_map[new_motion.type].push_back(new_motion);
 
-    return sync_all(m_streams_map, m_motions_map, correlated_sample);
+    return match_and_unlock(lock, true, correlated_sample);
+}
+
+bool rs::utils::samples_time_sync_base::push_pending_sample(pending_sample& sample)
+{
+    if (!m_pending_samples.push_back(sample))
+        return false;
+
+    // pairs with the fence in match_and_unlock, either the matching thread sees the sample or this thread gets the lock
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return true;
+}
+
+void rs::utils::samples_time_sync_base::insert_pending_samples()
+{
+    pending_sample sample = {};
+    while (m_pending_samples.pop_front(sample))
+    {
+        if (sample.image)
+        {
+            m_latest_timestamp = std::max(m_latest_timestamp, sample.image->query_time_stamp());
+            push_image(sample.image);
+        }
+        else
+        {
+            m_latest_timestamp = std::max(m_latest_timestamp, sample.motion.timestamp);
+            m_motions_map[sample.motion.type].push_back(sample.motion);
+        }
+
+        sync_to_matched_sets();
+    }
+}
+
+void rs::utils::samples_time_sync_base::push_image(rs::utils::unique_ptr<image_interface>& image)
+{
+    auto stream_type = image->query_stream_type();
+    if (m_min_input_latency != 0)
+        update_input_latency(image->query_time_stamp());
+
+    m_image_bytes[static_cast<int>(stream_type)] = image_bytes(image.get());
+    auto& stream_list = m_streams_map[stream_type];
+    stream_list.push_back(image);
+
+    // a full list overwrites its oldest image, the oldest images beyond a shorter length are dropped as unmatched
+    while (stream_list.size() > m_buffer_lengths[static_cast<int>(stream_type)])
+        pop_or_save_to_not_matched(stream_type);
+}
+
+uint64_t rs::utils::samples_time_sync_base::image_bytes(const image_interface * image)
+{
+    auto info = image->query_info();
+    return static_cast<uint64_t>(info.pitch) * info.height;
+}
+
+void rs::utils::samples_time_sync_base::account_lists_bytes()
+{
+    uint64_t lists_bytes = 0;
+    for (auto& stream_list : m_streams_map)
+        lists_bytes += stream_list.second.size() * m_image_bytes[static_cast<int>(stream_list.first)];
+
+    if (lists_bytes > m_lists_bytes)
+        memory_accounting::add(memory_subsystem::samples_time_sync, lists_bytes - m_lists_bytes);
+    else
+        memory_accounting::remove(memory_subsystem::samples_time_sync, m_lists_bytes - lists_bytes);
+    m_lists_bytes = lists_bytes;
+}
+
+void rs::utils::samples_time_sync_base::update_input_latency(double image_timestamp)
+{
+    m_measured_skew *= SKEW_DECAY;
+    if (m_latest_image_timestamp - image_timestamp > m_measured_skew)
+        m_measured_skew = m_latest_image_timestamp - image_timestamp;
+    m_latest_image_timestamp = std::max(m_latest_image_timestamp, image_timestamp);
+
+    double input_latency = m_measured_skew * SKEW_MARGIN + 1000.0 / m_highest_fps;
+    input_latency = std::min(std::max(input_latency, static_cast<double>(m_min_input_latency)), static_cast<double>(m_max_input_latency));
+    set_buffer_lengths(input_latency);
+}
+
+void rs::utils::samples_time_sync_base::set_buffer_lengths(double input_latency)
+{
+    m_input_latency = input_latency;
+    for (auto& stream_list : m_streams_map)
+    {
+        int i = static_cast<int>(stream_list.first);
+        auto length = static_cast<unsigned int>(std::ceil(m_streams_fps[i] * input_latency / 1000));
+        m_buffer_lengths[i] = std::min(std::max(length, 1u), m_buffer_capacities[i]);
+    }
+}
+
+void rs::utils::samples_time_sync_base::set_adaptive_latency(unsigned int min_input_latency)
+{
+    std::lock_guard<std::mutex> lock_guard(m_image_mutex);
+
+    m_min_input_latency = std::min(min_input_latency, m_max_input_latency);
+    // the buffers shrink from the max latency as the skew decays, so the images of a lagging stream aren't dropped before it's measured
+    m_measured_skew = std::max(0.0, (m_max_input_latency - 1000.0 / m_highest_fps) / SKEW_MARGIN);
+    set_buffer_lengths(m_max_input_latency);
+}
+
+unsigned int rs::utils::samples_time_sync_base::query_input_latency()
+{
+    std::lock_guard<std::mutex> lock_guard(m_image_mutex);
+    return static_cast<unsigned int>(std::ceil(m_input_latency));
+}
+
+void rs::utils::samples_time_sync_base::sync_to_matched_sets()
+{
+    matched_set matched = {};
+    if (sync_all(m_streams_map, m_motions_map, matched.sample_set))
+    {
+        copy_motions(m_matched_motions, matched.motions);
+        m_matched_sets.push_back(std::move(matched));
+    }
+}
+
+bool rs::utils::samples_time_sync_base::match_and_unlock(std::unique_lock<std::mutex>& lock, bool sample_inserted,
+                                                         rs::core::correlated_sample_set& sample_set)
+{
+    bool matched = false;
+
+    if (sample_inserted)
+    {
+        // a set matched earlier for another thread is returned first
+        if (m_matched_sets.empty())
+        {
+            matched = sync_all(m_streams_map, m_motions_map, sample_set);
+            if (matched)
+                copy_motions(m_matched_motions, thread_returned_motions());
+        }
+        else
+            sync_to_matched_sets();
+    }
+
+    do
+    {
+        insert_pending_samples();
+
+        if (!matched && !m_matched_sets.empty())
+        {
+            sample_set = m_matched_sets.front().sample_set;
+            copy_motions(m_matched_sets.front().motions, thread_returned_motions());
+            m_matched_sets.pop_front();
+            matched = true;
+        }
+
+        if (matched)
+            set_returned_motion_batches(thread_returned_motions(), sample_set);
+
+        account_lists_bytes();
+        lock.unlock();
+
+        // a thread which pushed a sample after the last drain and failed to lock before the unlock left it to this thread
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    while (!m_pending_samples.empty() && lock.try_lock());
+
+    // a returned set is a frame of the synced streams
+    if (matched)
+        RS_PROFILER_FRAME_MARK("samples_time_sync matched set");
+    return matched;
+}
+
+void rs::utils::samples_time_sync_base::release_images(rs::core::correlated_sample_set& sample_set)
+{
+    for (auto& image : sample_set.images)
+    {
+        if (image)
+            image->release();
+        image = nullptr;
+    }
+}
+
+bool rs::utils::samples_time_sync_base::get_matched_sample_set(rs::core::correlated_sample_set& sample_set)
+{
+    std::unique_lock<std::mutex> lock(m_image_mutex);
+    return match_and_unlock(lock, false, sample_set);
 }
 
 bool rs::utils::samples_time_sync_base::get_not_matched_frame(rs::core::stream_type stream_type, image_interface **not_matched_frame)
@@ -157,6 +453,9 @@ bool rs::utils::samples_time_sync_base::get_not_matched_frame(rs::core::stream_t
     raw_image->add_ref();
     *not_matched_frame = raw_image;
 
+    m_not_matched_bytes -= image_bytes(raw_image);
+    memory_accounting::remove(memory_subsystem::samples_time_sync, image_bytes(raw_image));
+
     m_stream_lists_dropped_frames[stream_type].pop_front();
 
     if (m_stream_lists_dropped_frames[stream_type].size() == 0 )
@@ -166,15 +465,85 @@ bool rs::utils::samples_time_sync_base::get_not_matched_frame(rs::core::stream_t
 
 }
 
+unsigned int rs::utils::samples_time_sync_base::get_matched_motions(rs::core::motion_type motion_type, const rs::core::motion_sample ** motions)
+{
+    if (!motions)
+        throw std::invalid_argument("Null pointer received");
+
+    *motions = nullptr;
+
+    if (!is_motion_registered(motion_type))
+        return 0;
+
+    std::lock_guard<std::mutex> lock_guard(m_image_mutex);
+    auto thread_motions = m_returned_motions.find(std::this_thread::get_id());
+    if (thread_motions == m_returned_motions.end())
+        return 0;
+
+    auto& returned_motions = thread_motions->second.motions[static_cast<int>(motion_type)];
+    if (returned_motions.empty())
+        return 0;
+
+    *motions = returned_motions.data();
+    return static_cast<unsigned int>(returned_motions.size());
+}
+
+bool rs::utils::samples_time_sync_base::get_partial_sample_set(unsigned int max_latency, rs::core::correlated_sample_set& sample_set)
+{
+    std::lock_guard<std::mutex> lock_guard(m_image_mutex);
+
+    double oldest_timestamp = m_latest_timestamp;
+    bool image_found = false;
+    for (auto& stream_list : m_streams_map)
+    {
+        if (stream_list.second.size() == 0)
+            continue;
+        oldest_timestamp = std::min(oldest_timestamp, stream_list.second.front()->query_time_stamp());
+        image_found = true;
+    }
+
+    if (!image_found || m_latest_timestamp - oldest_timestamp < max_latency)
+        return false;
+
+    for (auto& stream_list : m_streams_map)
+    {
+        if (stream_list.second.size() == 0 || stream_list.second.front()->query_time_stamp() - oldest_timestamp > get_max_diff())
+            continue;
+
+        //adding ref count because on pop_front the shared ptr will call release
+        stream_list.second.front()->add_ref();
+        sample_set[stream_list.first] = stream_list.second.front().get();
+        stream_list.second.pop_front();
+    }
+    account_lists_bytes();
+    return true;
+}
+
 void rs::utils::samples_time_sync_base::flush()
 {
     std::lock_guard<std::mutex> lock_guard(m_image_mutex);
+
+    //drop the pending samples, and release the images of the matched sets which weren't returned
+    pending_sample sample = {};
+    while (m_pending_samples.pop_front(sample))
+        sample.image.reset();
+
+    for (auto& matched : m_matched_sets)
+        release_images(matched.sample_set);
+    m_matched_sets.clear();
+
+    m_returned_motions.clear();
+
+    m_latest_timestamp = 0;
+    m_latest_image_timestamp = 0;
+
     //remove all frames from all lists
     for (auto& stream_list : m_streams_map)
     {
         while (stream_list.second.size())
             stream_list.second.pop_front();
     }
+    account_lists_bytes();
 
 
     std::lock_guard<std::mutex> lock(m_dropped_images_mutex);
@@ -184,8 +553,12 @@ void rs::utils::samples_time_sync_base::flush()
         while (stream_list.second.size())
             stream_list.second.pop_front();
     }
+    memory_accounting::remove(memory_subsystem::samples_time_sync, m_not_matched_bytes);
+    m_not_matched_bytes = 0;
 
 }
 
-
-
+rs::utils::samples_time_sync_base::~samples_time_sync_base()
+{
+    flush();
+}
@@ -9,9 +9,15 @@
 #include <list>
 #include <mutex>
 #include <map>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
 
 #include "rs_sdk.h"
 #include "rs/utils/cyclic_array.h"
+#include "rs/utils/concurrent_cyclic_array.h"
 
 
 namespace rs
@@ -19,8 +25,52 @@ namespace rs
     namespace utils
     {
 
-        typedef std::map<rs::core::stream_type, rs::utils::cyclic_array<rs::utils::unique_ptr<rs::core::image_interface>>> streams_map;
-        typedef std::map<rs::core::motion_type, rs::utils::cyclic_array<rs::core::motion_sample>> motions_map;
+        /**
+        * @brief Fixed size array of the lists of the registered streams or motions, indexed by their type.
+        *
+        * The registered lists are iterated in the ascending order of their types, as a \c std::map of the types would be,
+        * the iterated entries hold the type as \c first and the list as \c second.
+        * Lookups index the array directly, and the lists are contiguous, the types are registered once, in the ascending order.
+        */
+        template<typename type, typename list_type>
+        class lists_by_type
+        {
+        public:
+            struct entry
+            {
+                type first;
+                list_type second;
+            };
+
+            lists_by_type() : m_count(0)
+            {
+                for (auto& index : m_indices)
+                    index = -1;
+            }
+
+            void insert(type key, list_type list)
+            {
+                m_entries[m_count].first = key;
+                m_entries[m_count].second = std::move(list);
+                m_indices[static_cast<int>(key)] = m_count++;
+            }
+
+            // the type must be registered
+            list_type& operator[](type key) { return m_entries[m_indices[static_cast<int>(key)]].second; }
+
+            entry * begin() { return m_entries; }
+            entry * end() { return m_entries + m_count; }
+
+        private:
+            static const int max_types = static_cast<int>(type::max);
+
+            entry m_entries[max_types];
+            int m_indices[max_types];
+            int m_count;
+        };
+
+        typedef lists_by_type<rs::core::stream_type, rs::utils::cyclic_array<rs::utils::unique_ptr<rs::core::image_interface>>> streams_map;
+        typedef lists_by_type<rs::core::motion_type, rs::utils::cyclic_array<rs::core::motion_sample>> motions_map;
 
         class samples_time_sync_base : public release_self_base<samples_time_sync_interface>
         {
@@ -34,11 +84,21 @@ namespace rs
 
             virtual bool insert(rs::core::motion_sample& new_motion, rs::core::correlated_sample_set& sample_set) override;
 
+            virtual bool get_matched_sample_set(rs::core::correlated_sample_set& sample_set) override;
+
             virtual bool get_not_matched_frame(rs::core::stream_type stream_type, rs::core::image_interface ** not_matched_frame) override;
 
+            virtual unsigned int get_matched_motions(rs::core::motion_type motion_type, const rs::core::motion_sample ** motions) override;
+
+            virtual bool get_partial_sample_set(unsigned int max_latency, rs::core::correlated_sample_set& sample_set) override;
+
+            virtual void set_adaptive_latency(unsigned int min_input_latency) override;
+
+            virtual unsigned int query_input_latency() override;
+
             virtual void flush() override;
 
-            virtual ~samples_time_sync_base() {}
+            virtual ~samples_time_sync_base();
 
         protected:
 
@@ -48,6 +108,9 @@ namespace rs
 
             void pop_or_save_to_not_matched(rs::core::stream_type st_type);
 
+            // sets the motion samples closest to timestamp to the sample set, and keeps the samples up to them as the matched motions
+            void pick_closest_motions(motions_map& motions, double timestamp, rs::core::correlated_sample_set& sample_set);
+
             inline bool is_stream_registered(rs::core::stream_type stream) { return m_streams_fps[static_cast<int>(stream)] != 0; }
             inline bool is_motion_registered(rs::core::motion_type motion) { return m_motions_fps[static_cast<int>(motion)] != 0; }
 
@@ -58,6 +121,75 @@ namespace rs
             samples_time_sync_base& operator=(const samples_time_sync_base&) = delete;
             samples_time_sync_base(const samples_time_sync_base&) = delete;
 
+            typedef std::vector<rs::core::motion_sample> motions_span[static_cast<int>(rs::core::motion_type::max)];
+
+            // a set matched for a pending sample, with its matched motions
+            struct matched_set
+            {
+                rs::core::correlated_sample_set sample_set;
+                motions_span motions;
+            };
+
+            // the motions of the last set returned to a thread
+            struct returned_motions
+            {
+                motions_span motions;
+            };
+
+            static void copy_motions(const motions_span& from, motions_span& to);
+
+            // the returned motions of the calling thread. must be called with m_image_mutex locked
+            motions_span& thread_returned_motions();
+
+            // points the motion batches of the set to the returned motions. must be called with m_image_mutex locked
+            void set_returned_motion_batches(const motions_span& motions, rs::core::correlated_sample_set& sample_set);
+
+            // a sample inserted while another thread was matching, queued for that thread without locking
+            struct pending_sample
+            {
+                rs::utils::unique_ptr<rs::core::image_interface> image;  // null for motion samples
+                rs::core::motion_sample motion;
+            };
+
+            // samples which may be queued while a thread is matching, a sample inserted once the queue is full waits for the lock
+            static const unsigned int PENDING_SAMPLES_CAPACITY = 64;
+
+            // queues the sample for the matching thread, returns false if the queue is full
+            bool push_pending_sample(pending_sample& sample);
+
+            // inserts the pending samples to the lists in their arrival order, and queues the sets they match.
+            // must be called with m_image_mutex locked
+            void insert_pending_samples();
+
+            // matches the lists, and queues the matched set if any. must be called with m_image_mutex locked
+            void sync_to_matched_sets();
+
+            // matches the samples inserted by the calling thread and by the threads which didn't get the lock meanwhile,
+            // returns the oldest matched set, and unlocks m_image_mutex
+            bool match_and_unlock(std::unique_lock<std::mutex>& lock, bool sample_inserted, rs::core::correlated_sample_set& sample_set);
+
+            static void release_images(rs::core::correlated_sample_set& sample_set);
+
+            // the measured skew decays by this factor per inserted image, a larger skew replaces it at once
+            static constexpr double SKEW_DECAY = 0.995;
+            // the buffers hold the images of the measured skew times this margin, and a period of the highest fps
+            static constexpr double SKEW_MARGIN = 1.5;
+
+            // pushes the image to its list, and drops the oldest images beyond the list length. must be called with m_image_mutex locked
+            void push_image(rs::utils::unique_ptr<rs::core::image_interface>& image);
+
+            // measures the arrival skew of the image, and sizes the lists by it. must be called with m_image_mutex locked
+            void update_input_latency(double image_timestamp);
+
+            // sets the lists lengths to hold the images of the latency, up to the lists capacities
+            void set_buffer_lengths(double input_latency);
+
+            // the bytes of the image data, as accounted in the sdk memory budget
+            static uint64_t image_bytes(const rs::core::image_interface * image);
+
+            // accounts the bytes of the images in the lists. must be called with m_image_mutex locked
+            void account_lists_bytes();
+
             streams_map    m_streams_map;
             motions_map    m_motions_map;
 
@@ -66,7 +198,27 @@ namespace rs
             std::mutex m_image_mutex;
             std::mutex m_dropped_images_mutex;
 
+            concurrent_cyclic_array<pending_sample, producers_model::multiple> m_pending_samples; // the samples inserted while m_image_mutex was locked, in arrival order
+            std::deque<matched_set> m_matched_sets;                     // sets matched for pending samples, returned by the next inserts or get_matched_sample_set
+
+            double m_latest_timestamp;       // the latest timestamp of the inserted samples, the partial sets latency is measured to it
+
+            motions_span m_matched_motions;  // motions picked by the last sync_all
+            // motions of the last set returned to each thread, an insert of another thread doesn't overwrite them
+            std::unordered_map<std::thread::id, returned_motions> m_returned_motions;
+
             unsigned int m_max_input_latency;
+            unsigned int m_min_input_latency;    // 0 when the lists are sized by m_max_input_latency
+            double m_input_latency;              // the latency the lists are sized for, in ms
+            double m_measured_skew;              // the decaying peak of the images arrival skew, in ms
+            double m_latest_image_timestamp;     // the latest timestamp of the inserted images, the skew is measured to it
+
+            uint64_t m_image_bytes[static_cast<int>(rs::core::stream_type::max)];  // the bytes of the latest image of each stream
+            uint64_t m_lists_bytes;              // the bytes of the images in the lists, accounted under m_image_mutex
+            uint64_t m_not_matched_bytes;        // the bytes of the not matched images, accounted under m_dropped_images_mutex
+
+            unsigned int m_buffer_capacities[static_cast<int>(rs::core::stream_type::max)];  // the lists sizes, by m_max_input_latency
+            unsigned int m_buffer_lengths[static_cast<int>(rs::core::stream_type::max)];     // the images kept in the lists
             unsigned int m_not_matched_frames_buffer_size;
 
             int m_streams_fps[static_cast<int>(rs::core::stream_type::max)];
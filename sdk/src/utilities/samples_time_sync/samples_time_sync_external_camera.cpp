@@ -2,11 +2,117 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include "samples_time_sync_external_camera.h"
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 using namespace rs::core;
 using namespace rs::utils;
 
+constexpr double rs::utils::samples_time_sync_external_camera::clock_model::MAX_DRIFT;
+
+void rs::utils::samples_time_sync_external_camera::clock_model::add_match(double time_stamp, double reference_time_stamp)
+{
+    m_matches.emplace_back(time_stamp, reference_time_stamp);
+    if (m_matches.size() > CLOCK_MODEL_WINDOW)
+        m_matches.pop_front();
+
+    // the sums are centered on the first match, the time stamps since the epoch would lose the precision of the squares
+    const double x0 = m_matches.front().first;
+    const double y0 = m_matches.front().second;
+    const double count = static_cast<double>(m_matches.size());
+    double sum_x = 0, sum_y = 0;
+    for (auto& match : m_matches)
+    {
+        sum_x += match.first - x0;
+        sum_y += match.second - y0;
+    }
+    const double mean_x = sum_x / count;
+    const double mean_y = sum_y / count;
+    double sum_xx = 0, sum_xy = 0;
+    for (auto& match : m_matches)
+    {
+        const double dx = match.first - x0 - mean_x;
+        sum_xx += dx * dx;
+        sum_xy += dx * (match.second - y0 - mean_y);
+    }
+
+    m_slope = sum_xx > 0 ? sum_xy / sum_xx : 1;
+    if (std::abs(m_slope - 1) > MAX_DRIFT)
+        m_slope = 1;
+    m_offset = y0 + mean_y - m_slope * mean_x;
+}
+
+void rs::utils::samples_time_sync_external_camera::sync_latest(streams_map& streams, rs::core::correlated_sample_set &sample_set)
+{
+    for (auto& pair : streams)
+    {
+        while (pair.second.size() > 1)
+            pop_or_save_to_not_matched(pair.first);
+    }
+
+    const double reference_time_stamp = streams.begin()->second.front()->query_time_stamp();
+    for (auto& pair : streams)
+    {
+        image_interface* image = pair.second.front().get();
+        m_clock_models[static_cast<int>(pair.first)].add_match(image->query_time_stamp(), reference_time_stamp);
+        image->add_ref();
+        sample_set[pair.first] = image;
+        pair.second.pop_front();
+    }
+}
+
+bool rs::utils::samples_time_sync_external_camera::sync_corrected(streams_map& streams, rs::core::correlated_sample_set &sample_set)
+{
+    auto& reference = *streams.begin();
+    while (true)
+    {
+        if (empty_list_exists())
+            return false;
+
+        const double reference_time_stamp = reference.second.front()->query_time_stamp();
+        bool is_reference_matched = true;
+        for (auto stream_list = streams.begin() + 1; stream_list != streams.end() && is_reference_matched; stream_list++)
+        {
+            auto& model = m_clock_models[static_cast<int>(stream_list->first)];
+            while (stream_list->second.size() > 0 &&
+                   model.to_reference(stream_list->second.front()->query_time_stamp()) < reference_time_stamp - get_max_diff())
+                pop_or_save_to_not_matched(stream_list->first);
+
+            // the frame of the reference time didn't arrive yet
+            if (stream_list->second.size() == 0)
+                return false;
+
+            is_reference_matched = model.to_reference(stream_list->second.front()->query_time_stamp()) <= reference_time_stamp + get_max_diff();
+        }
+        if (is_reference_matched)
+            break;
+
+        // a stream dropped the frame of the reference time
+        pop_or_save_to_not_matched(reference.first);
+        if (++m_unmatched_references >= MAX_UNMATCHED_REFERENCES)
+        {
+            LOG_WARN("External camera frames aren't matched by the estimated clocks, the clocks are estimated again");
+            for (auto& model : m_clock_models)
+                model.reset();
+            m_unmatched_references = 0;
+            return false;
+        }
+    }
+
+    m_unmatched_references = 0;
+    const double reference_time_stamp = reference.second.front()->query_time_stamp();
+    for (auto& pair : streams)
+    {
+        image_interface* image = pair.second.front().get();
+        m_clock_models[static_cast<int>(pair.first)].add_match(image->query_time_stamp(), reference_time_stamp);
+        image->add_ref();
+        sample_set[pair.first] = image;
+        pair.second.pop_front();
+    }
+    return true;
+}
+
 bool rs::utils::samples_time_sync_external_camera::sync_all(streams_map& streams, motions_map& motions, rs::core::correlated_sample_set &sample_set)
 {
     if (empty_list_exists())
@@ -14,23 +120,24 @@ bool rs::utils::samples_time_sync_external_camera::sync_all(streams_map& streams
         return false;
     }
 
-    //Go over all the lists and get every stream and then motion
+    bool are_models_ready = true;
     for (auto& pair : streams)
+        are_models_ready &= m_clock_models[static_cast<int>(pair.first)].is_ready();
+
+    if (are_models_ready)
     {
-        assert(pair.second.size() == 1); //assuming here that samples_time_sync_external_camera was created with a single buffer
-        stream_type st = pair.first;
-        image_interface* image = pair.second.back().get();
-        image->add_ref();
-        sample_set[st] = image;
-        pair.second.pop_back();
+        if (!sync_corrected(streams, sample_set))
+            return false;
     }
-
-    for (auto& pair : motions)
+    else
     {
-        assert(pair.second.size() == 1);
-        motion_type mt = pair.first;
-        sample_set[mt] = pair.second.back();
-        pair.second.pop_back();
+        sync_latest(streams, sample_set);
     }
+
+    //the motions aren't on the clock of any stream, the latest motion samples are matched
+    double latest_motion_time_stamp = 0;
+    for (auto& motion_list : motions)
+        latest_motion_time_stamp = std::max(latest_motion_time_stamp, motion_list.second.back().timestamp);
+    pick_closest_motions(motions, latest_motion_time_stamp, sample_set);
     return true;
 }
@@ -8,6 +8,7 @@
 #include <list>
 #include <mutex>
 #include <map>
+#include <deque>
 #include "rs_sdk.h"
 
 #include "samples_time_sync_base.h"
@@ -16,6 +17,13 @@ namespace rs
 {
     namespace utils
     {
+        /**
+        * @brief Syncs the streams of cameras which don't share a clock.
+        *
+        * The time stamps of every stream are mapped to the clock of the first registered stream, the reference stream, by a line
+        * fitted to the time stamps of the recently matched frames, so the offset and the drift between the clocks are compensated.
+        * Until enough frames are matched to fit the lines, the latest frames of the streams are matched.
+        */
         class samples_time_sync_external_camera : public samples_time_sync_base
         {
         public:
@@ -23,13 +31,50 @@ namespace rs
                                   int motions_fps[static_cast<int>(rs::core::motion_type::max)],
                                   unsigned int max_input_latency,
                                   unsigned int not_matched_frames_buffer_size) :
-                samples_time_sync_base(streams_fps, motions_fps, max_input_latency, not_matched_frames_buffer_size) {}
+                samples_time_sync_base(streams_fps, motions_fps, max_input_latency, not_matched_frames_buffer_size), m_unmatched_references(0) {}
 
             virtual ~samples_time_sync_external_camera() {}
 
         protected:
             virtual bool sync_all(streams_map& streams, motions_map& motions, rs::core::correlated_sample_set &sample_set) override;
 
+        private:
+            // the time stamps pairs of the matched frames the lines are fitted to
+            static const size_t CLOCK_MODEL_WINDOW = 128;
+            // the matched frames required before the corrected time stamps are matched
+            static const size_t CLOCK_MODEL_MIN_MATCHES = 16;
+            // the reference frames dropped in a row before the lines are fitted again, the clock of a camera was reset
+            static const int MAX_UNMATCHED_REFERENCES = 30;
+
+            /**
+            * @brief Maps the time stamps of a stream to the reference clock by the least squares line of the recently matched time stamps.
+            */
+            class clock_model
+            {
+            public:
+                clock_model() : m_slope(1), m_offset(0) {}
+
+                void add_match(double time_stamp, double reference_time_stamp);
+                bool is_ready() const { return m_matches.size() >= CLOCK_MODEL_MIN_MATCHES; }
+                double to_reference(double time_stamp) const { return m_offset + m_slope * (time_stamp - m_matches.front().first); }
+                void reset() { m_matches.clear(); }
+
+            private:
+                // drift larger than this is a misfit of the time stamps of a short time span, the clocks are assumed to run at the same rate
+                static constexpr double MAX_DRIFT = 0.001;
+
+                std::deque<std::pair<double, double>> m_matches;
+                double m_slope;
+                double m_offset;  // the reference time stamp of the first kept match
+            };
+
+            // matches the latest frames of the streams, until the clock models are ready
+            void sync_latest(streams_map& streams, rs::core::correlated_sample_set &sample_set);
+            // matches the frames of the corrected time stamps closest to the reference frame, returns false if a frame didn't arrive yet
+            bool sync_corrected(streams_map& streams, rs::core::correlated_sample_set &sample_set);
+
+            clock_model m_clock_models[static_cast<int>(rs::core::stream_type::max)];
+            int m_unmatched_references;
         };
     }
 }
@@ -0,0 +1,57 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "samples_time_sync_frame_counter.h"
+#include <algorithm>
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+
+bool rs::utils::samples_time_sync_frame_counter::sync_all(streams_map& streams, motions_map& motions, rs::core::correlated_sample_set& sample_set)
+{
+    if (empty_list_exists())
+        return false;
+
+    // the frame counters don't go back, so a head older than the latest head will not be matched.
+    // visit the lists cyclically until all the heads have the latest frame number, a list is visited again
+    // only when a later list raised the latest frame number, since its image of the latest frame was dropped
+    uint64_t largest_frame_number = 0;
+    for (auto& stream_list : streams)
+        largest_frame_number = std::max(largest_frame_number, stream_list.second.front()->query_frame_number());
+
+    const int streams_count = static_cast<int>(streams.end() - streams.begin());
+    int aligned_count = 0;
+    for (auto stream_list = streams.begin(); aligned_count < streams_count; stream_list = stream_list + 1 == streams.end() ? streams.begin() : stream_list + 1)
+    {
+        while (stream_list->second.size() > 0 && stream_list->second.front()->query_frame_number() < largest_frame_number)
+            pop_or_save_to_not_matched(stream_list->first);
+
+        // the image of the latest frame didn't arrive yet
+        if (stream_list->second.size() == 0)
+            return false;
+
+        if (stream_list->second.front()->query_frame_number() > largest_frame_number)
+        {
+            largest_frame_number = stream_list->second.front()->query_frame_number();
+            aligned_count = 0;
+        }
+        aligned_count++;
+    }
+
+    // the heads of all lists are the images of the same frame
+    double timestamp = 0;
+    for (auto& stream_list : streams)
+    {
+        //setting the image in the output sample set, adding ref count because on pop_front the shared ptr will call release
+        stream_list.second.front()->add_ref();
+        sample_set[stream_list.first] = stream_list.second.front().get();
+        timestamp = std::max(timestamp, stream_list.second.front()->query_time_stamp());
+        stream_list.second.pop_front();
+    }
+
+    //pick up corresponding motions
+    pick_closest_motions(motions, timestamp, sample_set);
+
+    return true;
+}
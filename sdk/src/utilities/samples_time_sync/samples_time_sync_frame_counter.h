@@ -0,0 +1,39 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "rs_sdk.h"
+#include "rs/utils/cyclic_array.h"
+
+#include "samples_time_sync_base.h"
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Matches the images by their hardware frame counters instead of their timestamps.
+        *
+        * The streams of the device share their frame counter, so the images of a set have the same frame number,
+        * and the set is matched as soon as its last image is inserted, without a timestamps tolerance to wait for.
+        * An image with a frame number lower than another stream's oldest image can't be matched anymore, and is dropped at once.
+        * Motions are matched to the images timestamp, as with the other devices.
+        */
+        class samples_time_sync_frame_counter : public samples_time_sync_base
+        {
+        public:
+            samples_time_sync_frame_counter(int streams_fps[static_cast<int>(rs::core::stream_type::max)],
+                                            int motions_fps[static_cast<int>(rs::core::motion_type::max)],
+                                            unsigned int max_input_latency,
+                                            unsigned int not_matched_frames_buffer_size) :
+                samples_time_sync_base(streams_fps, motions_fps, max_input_latency, not_matched_frames_buffer_size) {}
+
+            virtual ~samples_time_sync_frame_counter() {}
+
+        protected:
+            virtual bool sync_all(streams_map& streams, motions_map& motions, rs::core::correlated_sample_set &sample_set) override;
+
+        };
+    }
+}
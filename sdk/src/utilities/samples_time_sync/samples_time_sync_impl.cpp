@@ -6,6 +6,7 @@
 #include "samples_time_sync_ds5.h"
 #include "rs_sdk_version.h"
 #include "samples_time_sync_external_camera.h"
+#include "samples_time_sync_frame_counter.h"
 
 namespace rs {
     namespace utils {
@@ -21,13 +22,10 @@ namespace rs {
                         return new samples_time_sync_zr300(streams_fps, motions_fps, max_input_latency, not_matched_frames_buffer_size);
 
                 if ( str.compare(external_device_name) == 0 )
-                {
-                    //External camera synchronization requires that a single buffer is used for the images arrays
-                    const int SINGLE_BUFFER = 1;
-                    return new samples_time_sync_external_camera(streams_fps,
-                                                                 motions_fps, SINGLE_BUFFER,
-                                                                 not_matched_frames_buffer_size);
-                }
+                    return new samples_time_sync_external_camera(streams_fps, motions_fps, max_input_latency, not_matched_frames_buffer_size);
+                if ( str.compare(frame_counter_device_name) == 0 )
+                    return new samples_time_sync_frame_counter(streams_fps, motions_fps, max_input_latency, not_matched_frames_buffer_size);
+
                 /*if ( str.find("RS400") != std::string::npos )
                         return new samples_time_sync_ds5(streams_fps, motions_fps, max_input_latency, not_matched_frames_buffer_size);*/
 
@@ -2,6 +2,7 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include "samples_time_sync_zr300.h"
+#include <algorithm>
 
 using namespace std;
 using namespace rs::core;
@@ -9,81 +10,80 @@ using namespace rs::utils;
 
 bool rs::utils::samples_time_sync_zr300::sync_all(streams_map& streams, motions_map& motions,  rs::core::correlated_sample_set& sample_set )
 {
-    bool set_found = false;
-
     if (empty_list_exists())
         return false;
 
-    double largest_timestamp;
+    // the lists of the streams with the same timestamps, fisheye timestamps are matched to the closest
+    rs::utils::cyclic_array<rs::utils::unique_ptr<image_interface>> * lists[static_cast<int>(stream_type::max)];
+    stream_type lists_types[static_cast<int>(stream_type::max)];
+    rs::utils::cyclic_array<rs::utils::unique_ptr<image_interface>> * fisheye_list = nullptr;
+    int lists_count = 0;
+    for (auto& stream_list : streams)
+    {
+        if (stream_list.first == stream_type::fisheye)
+        {
+            fisheye_list = &stream_list.second;
+            continue;
+        }
+        lists_types[lists_count] = stream_list.first;
+        lists[lists_count++] = &stream_list.second;
+    }
+
+    // start from the largest (latest) head timestamp, so the first visit of each list eliminates its older frames
+    double largest_timestamp = -1;
+    for (int i = 0; i < lists_count; i++)
+        largest_timestamp = std::max(largest_timestamp, lists[i]->front()->query_time_stamp());
 
-    while (!set_found)
+    // visit the lists cyclically, eliminating the frames earlier than the largest head timestamp seen so far.
+    // a list is visited again only when the head of a later list raised the largest timestamp, so each call
+    // costs one visit per list and per eliminated frame, instead of a full rescan per eliminated frame
+    int aligned_count = 0;
+    for (int i = 0; aligned_count < lists_count; i = (i + 1) % lists_count)
     {
-        set_found = true;
+        auto& list = *lists[i];
+        while (list.size() > 0 && list.front()->query_time_stamp() < largest_timestamp)
+            pop_or_save_to_not_matched(lists_types[i]);
 
-        largest_timestamp = -1;
+        // now the list may become empty - in this case - correleated sample can not be found - just return false
+        if (list.size() == 0)
+            return false;
 
-        // first pass - find largest (latest) timestamp;
-        for (auto& stream_list : streams)
+        if (list.front()->query_time_stamp() > largest_timestamp)
         {
-            // skip fish_eye stream since its timestamp is not the same as all other streams
-            if (stream_list.first == stream_type::fisheye)
-                continue;
-
-            if (largest_timestamp < stream_list.second.front()->query_time_stamp() )
-                largest_timestamp = stream_list.second.front()->query_time_stamp();
+            largest_timestamp = list.front()->query_time_stamp();
+            aligned_count = 0;
         }
+        aligned_count++;
 
-        //second pass - eliminate the frames with the timstamps earlier than largest timistamp
-        for (auto& stream_list : streams)
-        {
-            // skip fish_eye stream since its timestamp is not the same as all other streams
-            if (stream_list.first == stream_type::fisheye)
-                continue;
+        if (aligned_count < lists_count || !fisheye_list)
+            continue;
 
-            while ( stream_list.second.size() > 0 && stream_list.second.front()->query_time_stamp() < largest_timestamp)
-                pop_or_save_to_not_matched(stream_list.first);
+        // heads of all lists have the same timestamp, match it to the fisheye
+        while (largest_timestamp - fisheye_list->front()->query_time_stamp() > get_max_diff() )
+        {
+            pop_or_save_to_not_matched(stream_type::fisheye);
 
-            // now the list may become empty - in this case - correleated sample can not be found - just return false
-            if (stream_list.second.size() == 0)
+            if (fisheye_list->size() == 0)
                 return false;
-
-            // if timestamp of the head of the list is NOT equal to the found maximum = go for the next iteration
-            set_found = set_found && (largest_timestamp == stream_list.second.front()->query_time_stamp());
         }
 
-
-        if (is_stream_registered(stream_type::fisheye) && set_found)
+        if (largest_timestamp - fisheye_list->front()->query_time_stamp() < (-1 * get_max_diff()) )
         {
-            while (largest_timestamp - streams[stream_type::fisheye].front()->query_time_stamp() > get_max_diff() )
+            //remove heads of all streams, except fish_eye - these will not be matched to any fisheye frame
+            for (int j = 0; j < lists_count; j++)
             {
-                pop_or_save_to_not_matched(stream_type::fisheye);
+                pop_or_save_to_not_matched(lists_types[j]);
 
-                if (streams[stream_type::fisheye].size() == 0)
+                // return false if any stream turns to be empty
+                if (lists[j]->size() == 0)
                     return false;
             }
 
-            if (largest_timestamp - streams[stream_type::fisheye].front()->query_time_stamp() < (-1 * get_max_diff()) )
-            {
-                //remove heads of all streams, except fish_eye - these will not be matched to any fisheye frame
-                for (auto& stream_l : streams)
-                {
-                    // skip fish_eye stream since its timestamp is not the same as all other streams
-                    if (stream_l.first == stream_type::fisheye)
-                        continue;
-
-                    pop_or_save_to_not_matched(stream_l.first);
-
-                    // return false if any stream turns to be empty
-                    if (stream_l.second.size()==0)
-                        return false;
-                }
-
-                //force next iteration of while(!set_found)
-                set_found = false;
-            }
-        } // end of fish_eye
-
-    } //end of while (!set_found)
+            //align the new heads
+            largest_timestamp = -1;
+            aligned_count = 0;
+        }
+    }
 
 
     // at this point, head of all lists have frames with the same/closest timestamp
@@ -96,24 +96,7 @@ bool rs::utils::samples_time_sync_zr300::sync_all(streams_map& streams, motions_
     }
 
     //pick up corresponding motions
-    for (auto& motion_list : motions)
-    {
-        sample_set[motion_list.first] = motion_list.second.front();
-        motion_list.second.pop_front();
-
-        while(motion_list.second.size() > 0)
-        {
-            auto a1 = abs(largest_timestamp-sample_set[motion_list.first].timestamp);
-            auto a2 = abs(largest_timestamp-motion_list.second.front().timestamp);
-
-            // pick  up the closest to the selected timestamp motion sample
-            if ( a2 >= a1 )
-                break;
-
-            sample_set[motion_list.first] = motion_list.second.front();
-            motion_list.second.pop_front();
-        } //end of while
-    }
+    pick_closest_motions(motions, largest_timestamp, sample_set);
 
     return true;
 }
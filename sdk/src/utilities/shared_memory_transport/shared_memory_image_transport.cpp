@@ -0,0 +1,356 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <stdint.h>
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "rs/utils/shared_memory_image_transport.h"
+#include "rs/utils/release_self_base.h"
+#include "rs/utils/log_utils.h"
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace utils
+    {
+#ifndef WIN32
+        namespace
+        {
+            static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "the segment atomics are shared between processes, they must be lock free");
+
+            const uint32_t SEGMENT_MAGIC = 0x52534d54; // "RSMT"
+            const uint32_t SEGMENT_VERSION = 1;
+            const size_t SEGMENT_ALIGNMENT = 64;
+            const uint32_t MAX_METADATA_ITEMS = 4;
+            const uint32_t MAX_METADATA_ITEM_SIZE = 32;
+
+            // set in the slot state while the publisher writes the slot, the lower bits count the subscribers which hold the slot
+            const uint32_t SLOT_WRITING = 0x80000000u;
+
+            size_t align(size_t size) { return (size + SEGMENT_ALIGNMENT - 1) / SEGMENT_ALIGNMENT * SEGMENT_ALIGNMENT; }
+
+            struct metadata_item
+            {
+                int32_t  type;
+                uint32_t size;
+                uint8_t  data[MAX_METADATA_ITEM_SIZE];
+            };
+
+            struct slot_header
+            {
+                std::atomic<uint32_t> state;
+                std::atomic<uint64_t> sequence;         // the sequence number of the image in the slot, 0 if the slot wasn't written
+                image_info            info;
+                int32_t               stream;
+                int32_t               flags;
+                int32_t               time_stamp_domain;
+                double                time_stamp;
+                uint64_t              frame_number;
+                uint32_t              metadata_count;
+                metadata_item         metadata[MAX_METADATA_ITEMS];
+            };
+
+            struct segment_header
+            {
+                std::atomic<uint32_t> magic;            // written last, once the segment is initialized
+                uint32_t              version;
+                uint32_t              slots_count;
+                uint32_t              max_image_size;
+                std::atomic<uint64_t> published_sequence; // the sequence number of the last published image, images are numbered from 1
+            };
+
+            // the segment layout: the header, then each slot header followed by its image data
+            size_t get_slot_stride(uint32_t max_image_size) { return align(sizeof(slot_header)) + align(max_image_size); }
+            size_t get_segment_size(uint32_t slots_count, uint32_t max_image_size)
+            {
+                return align(sizeof(segment_header)) + slots_count * get_slot_stride(max_image_size);
+            }
+
+            // a segment mapped to the process address space, unmapped when the publisher and the received images released it
+            class segment_mapping
+            {
+            public:
+                segment_mapping(uint8_t * data, size_t size) : m_data(data), m_size(size) {}
+                ~segment_mapping() { munmap(m_data, m_size); }
+
+                segment_header * header() const { return reinterpret_cast<segment_header *>(m_data); }
+                slot_header * slot(uint64_t sequence) const
+                {
+                    const uint32_t index = static_cast<uint32_t>(sequence % header()->slots_count);
+                    return reinterpret_cast<slot_header *>(m_data + align(sizeof(segment_header)) + index * get_slot_stride(header()->max_image_size));
+                }
+                uint8_t * slot_data(slot_header * slot) const { return reinterpret_cast<uint8_t *>(slot) + align(sizeof(slot_header)); }
+
+            private:
+                segment_mapping(const segment_mapping &) = delete;
+                segment_mapping & operator=(const segment_mapping &) = delete;
+
+                uint8_t * m_data;
+                size_t    m_size;
+            };
+
+            std::shared_ptr<segment_mapping> map_segment(int fd, size_t size)
+            {
+                void * data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                close(fd);
+                if(data == MAP_FAILED)
+                    return nullptr;
+                return std::make_shared<segment_mapping>(static_cast<uint8_t *>(data), size);
+            }
+
+            // returns the slot to the publisher once the image is released
+            class slot_releaser : public release_self_base<release_interface>
+            {
+            public:
+                slot_releaser(std::shared_ptr<segment_mapping> mapping, slot_header * slot) : m_mapping(std::move(mapping)), m_slot(slot) {}
+
+                int release() const override
+                {
+                    m_slot->state.fetch_sub(1, std::memory_order_release);
+                    return release_self_base::release();
+                }
+            protected:
+                ~slot_releaser() {}
+            private:
+                std::shared_ptr<segment_mapping> m_mapping;
+                slot_header *                    m_slot;
+            };
+
+            class shared_memory_image_publisher : public release_self_base<shared_memory_image_publisher_interface>
+            {
+            public:
+                shared_memory_image_publisher(std::string name, std::shared_ptr<segment_mapping> mapping) :
+                    m_name(std::move(name)), m_mapping(std::move(mapping)), m_sequence(0) {}
+
+                bool publish(image_interface * image) override
+                {
+                    if(!image || !image->query_data())
+                        return false;
+                    const image_info info = image->query_info();
+                    const size_t size = static_cast<size_t>(info.pitch) * static_cast<size_t>(info.height);
+                    segment_header * header = m_mapping->header();
+                    if(info.pitch <= 0 || info.height <= 0 || size > header->max_image_size)
+                        return false;
+
+                    // the slot is written only if no subscriber holds it, the subscribers can't take it while it's written
+                    const uint64_t sequence = m_sequence + 1;
+                    slot_header * slot = m_mapping->slot(sequence);
+                    uint32_t free_state = 0;
+                    if(!slot->state.compare_exchange_strong(free_state, SLOT_WRITING, std::memory_order_acquire))
+                        return false;
+
+                    memcpy(m_mapping->slot_data(slot), image->query_data(), size);
+                    slot->info = info;
+                    slot->stream = static_cast<int32_t>(image->query_stream_type());
+                    slot->flags = static_cast<int32_t>(image->query_flags());
+                    slot->time_stamp_domain = static_cast<int32_t>(image->query_time_stamp_domain());
+                    slot->time_stamp = image->query_time_stamp();
+                    slot->frame_number = image->query_frame_number();
+                    slot->metadata_count = 0;
+                    metadata_interface * metadata = image->query_metadata();
+                    const metadata_type metadata_types[] = { metadata_type::actual_exposure, metadata_type::actual_fps };
+                    for(auto type : metadata_types)
+                    {
+                        if(!metadata || !metadata->is_metadata_available(type) || metadata->query_buffer_size(type) > MAX_METADATA_ITEM_SIZE)
+                            continue;
+                        metadata_item & item = slot->metadata[slot->metadata_count++];
+                        item.type = static_cast<int32_t>(type);
+                        item.size = metadata->get_metadata(type, item.data);
+                    }
+
+                    slot->sequence.store(sequence, std::memory_order_relaxed);
+                    slot->state.store(0, std::memory_order_release);
+                    header->published_sequence.store(sequence, std::memory_order_release);
+                    m_sequence = sequence;
+                    return true;
+                }
+
+                uint32_t publish(const correlated_sample_set & sample_set) override
+                {
+                    uint32_t published = 0;
+                    for(auto image : sample_set.images)
+                    {
+                        if(image && publish(image))
+                            published++;
+                    }
+                    return published;
+                }
+
+            protected:
+                ~shared_memory_image_publisher()
+                {
+                    shm_unlink(m_name.c_str());
+                }
+
+            private:
+                std::string                      m_name;
+                std::shared_ptr<segment_mapping> m_mapping;
+                uint64_t                         m_sequence; // the sequence number of the last published image
+            };
+
+            class shared_memory_image_subscriber : public release_self_base<shared_memory_image_subscriber_interface>
+            {
+            public:
+                explicit shared_memory_image_subscriber(std::shared_ptr<segment_mapping> mapping) :
+                    m_mapping(std::move(mapping)),
+                    m_next_sequence(m_mapping->header()->published_sequence.load(std::memory_order_acquire) + 1) {}
+
+                image_interface * receive(uint32_t * skipped_images) override
+                {
+                    segment_header * header = m_mapping->header();
+                    uint64_t skipped = 0;
+                    for(;;)
+                    {
+                        const uint64_t published = header->published_sequence.load(std::memory_order_acquire);
+                        if(m_next_sequence > published)
+                        {
+                            if(skipped_images) *skipped_images = static_cast<uint32_t>(skipped);
+                            return nullptr;
+                        }
+                        // the images older than the ring were overwritten
+                        if(published - m_next_sequence >= header->slots_count)
+                        {
+                            const uint64_t oldest = published - header->slots_count + 1;
+                            skipped += oldest - m_next_sequence;
+                            m_next_sequence = oldest;
+                        }
+
+                        slot_header * slot = m_mapping->slot(m_next_sequence);
+                        uint32_t state = slot->state.load(std::memory_order_relaxed);
+                        bool held = false;
+                        while(!(state & SLOT_WRITING))
+                        {
+                            if(slot->state.compare_exchange_weak(state, state + 1, std::memory_order_acquire))
+                            {
+                                held = true;
+                                break;
+                            }
+                        }
+                        if(held && slot->sequence.load(std::memory_order_relaxed) == m_next_sequence)
+                        {
+                            m_next_sequence++;
+                            if(skipped_images) *skipped_images = static_cast<uint32_t>(skipped);
+                            return create_image(slot);
+                        }
+                        if(held)
+                            slot->state.fetch_sub(1, std::memory_order_release);
+                        // the slot is rewritten with a newer image, or the publisher dropped the image since the slot is held
+                        if(slot->sequence.load(std::memory_order_relaxed) != m_next_sequence && (held || !(state & SLOT_WRITING)))
+                        {
+                            skipped++;
+                            m_next_sequence++;
+                        }
+                    }
+                }
+
+            private:
+                image_interface * create_image(slot_header * slot)
+                {
+                    image_info info = slot->info;
+                    auto releaser = new slot_releaser(m_mapping, slot);
+                    image_interface * image = image_interface::create_instance_from_raw_data(&info,
+                                                  { m_mapping->slot_data(slot), releaser },
+                                                  static_cast<stream_type>(slot->stream),
+                                                  static_cast<image_interface::flag>(slot->flags),
+                                                  slot->time_stamp,
+                                                  slot->frame_number,
+                                                  static_cast<timestamp_domain>(slot->time_stamp_domain));
+                    metadata_interface * metadata = image->query_metadata();
+                    for(uint32_t i = 0; metadata && i < slot->metadata_count; i++)
+                    {
+                        const metadata_item & item = slot->metadata[i];
+                        metadata->add_metadata(static_cast<metadata_type>(item.type), item.data, item.size);
+                    }
+                    return image;
+                }
+
+                std::shared_ptr<segment_mapping> m_mapping;
+                uint64_t                         m_next_sequence;
+            };
+        }
+
+        shared_memory_image_publisher_interface * shared_memory_image_publisher_interface::create_instance(const char * name, uint32_t slots_count, uint32_t max_image_size)
+        {
+            if(!name || slots_count == 0 || max_image_size == 0)
+                return nullptr;
+
+            // a segment left by a publisher which didn't exit cleanly is replaced, its subscribers keep the old mapping
+            shm_unlink(name);
+            int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+            if(fd < 0)
+            {
+                LOG_ERROR("failed to create the shared memory segment " << name);
+                return nullptr;
+            }
+            const size_t size = get_segment_size(slots_count, max_image_size);
+            if(ftruncate(fd, static_cast<off_t>(size)) != 0)
+            {
+                LOG_ERROR("failed to size the shared memory segment " << name << " to " << size << " bytes");
+                close(fd);
+                shm_unlink(name);
+                return nullptr;
+            }
+            auto mapping = map_segment(fd, size);
+            if(!mapping)
+            {
+                shm_unlink(name);
+                return nullptr;
+            }
+
+            // the truncated segment is zero filled, which is the initial state of the atomics and the slots
+            segment_header * header = mapping->header();
+            header->version = SEGMENT_VERSION;
+            header->slots_count = slots_count;
+            header->max_image_size = max_image_size;
+            header->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+            return new shared_memory_image_publisher(name, mapping);
+        }
+
+        shared_memory_image_subscriber_interface * shared_memory_image_subscriber_interface::create_instance(const char * name)
+        {
+            if(!name)
+                return nullptr;
+            int fd = shm_open(name, O_RDWR, 0);
+            if(fd < 0)
+                return nullptr;
+            struct stat segment_stat = {};
+            if(fstat(fd, &segment_stat) != 0 || static_cast<size_t>(segment_stat.st_size) < sizeof(segment_header))
+            {
+                close(fd);
+                return nullptr;
+            }
+            const size_t size = static_cast<size_t>(segment_stat.st_size);
+            auto mapping = map_segment(fd, size);
+            if(!mapping)
+                return nullptr;
+            segment_header * header = mapping->header();
+            if(header->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC || header->version != SEGMENT_VERSION ||
+               header->slots_count == 0 || get_segment_size(header->slots_count, header->max_image_size) > size)
+            {
+                LOG_ERROR("the shared memory segment " << name << " isn't an initialized image transport segment");
+                return nullptr;
+            }
+            return new shared_memory_image_subscriber(mapping);
+        }
+#else
+        shared_memory_image_publisher_interface * shared_memory_image_publisher_interface::create_instance(const char *, uint32_t, uint32_t)
+        {
+            return nullptr;
+        }
+
+        shared_memory_image_subscriber_interface * shared_memory_image_subscriber_interface::create_instance(const char *)
+        {
+            return nullptr;
+        }
+#endif
+    }
+}
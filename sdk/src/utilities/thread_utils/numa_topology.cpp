@@ -0,0 +1,183 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <string>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include "rs/utils/numa_topology.h"
+#include "rs/utils/log_utils.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <dirent.h>
+#include <limits.h>
+#endif
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace utils
+    {
+        const int32_t numa_topology::UNKNOWN_NODE;
+
+        namespace
+        {
+#if defined(__linux__)
+            const char * NODES_DIRECTORY = "/sys/devices/system/node";
+            const char * USB_DEVICES_DIRECTORY = "/sys/bus/usb/devices/";
+
+            bool read_first_line(const std::string & path, std::string & line)
+            {
+                std::ifstream file(path);
+                return file && std::getline(file, line);
+            }
+
+            //parses a sysfs cpu list, for example 0-11,24-35
+            uint64_t parse_cpu_list(const std::string & cpu_list)
+            {
+                uint64_t cpus = 0;
+                const char * range = cpu_list.c_str();
+                while(*range)
+                {
+                    char * range_end = nullptr;
+                    const long first = std::strtol(range, &range_end, 10);
+                    if(range_end == range)
+                    {
+                        break;
+                    }
+                    long last = first;
+                    if(*range_end == '-')
+                    {
+                        range = range_end + 1;
+                        last = std::strtol(range, &range_end, 10);
+                    }
+                    for(long cpu = first; cpu <= last && cpu < 64; cpu++)
+                    {
+                        cpus |= 1ull << cpu;
+                    }
+                    if(*range_end != ',')
+                    {
+                        break;
+                    }
+                    range = range_end + 1;
+                }
+                return cpus;
+            }
+#endif
+        }
+
+#if defined(__linux__)
+        int32_t numa_topology::query_nodes_count()
+        {
+            DIR * nodes_directory = opendir(NODES_DIRECTORY);
+            if(!nodes_directory)
+            {
+                return 1;
+            }
+            int32_t nodes_count = 0;
+            while(dirent * entry = readdir(nodes_directory))
+            {
+                if(std::strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9')
+                {
+                    nodes_count++;
+                }
+            }
+            closedir(nodes_directory);
+            return nodes_count > 0 ? nodes_count : 1;
+        }
+
+        int32_t numa_topology::query_usb_port_node(const char * usb_port_id)
+        {
+            //the port is a sysfs device name, which never holds a path
+            if(!usb_port_id || !*usb_port_id || std::strchr(usb_port_id, '/') || std::strcmp(usb_port_id, "..") == 0)
+            {
+                return UNKNOWN_NODE;
+            }
+
+            char device_path[PATH_MAX] = {};
+            if(!realpath((std::string(USB_DEVICES_DIRECTORY) + usb_port_id).c_str(), device_path))
+            {
+                return UNKNOWN_NODE;
+            }
+
+            //the usb devices have no node of their own, the pci controller they're attached to has
+            std::string path(device_path);
+            while(path.size() > 1)
+            {
+                std::string node;
+                if(read_first_line(path + "/numa_node", node))
+                {
+                    const int32_t controller_node = std::atoi(node.c_str());
+                    return controller_node >= 0 ? controller_node : UNKNOWN_NODE;
+                }
+                path.erase(path.find_last_of('/'));
+            }
+            return UNKNOWN_NODE;
+        }
+
+        uint64_t numa_topology::query_node_cpus(int32_t node)
+        {
+            std::string cpu_list;
+            if(node < 0 || !read_first_line(std::string(NODES_DIRECTORY) + "/node" + std::to_string(node) + "/cpulist", cpu_list))
+            {
+                return 0;
+            }
+            return parse_cpu_list(cpu_list);
+        }
+
+        status numa_topology::bind_thread(int32_t node, thread_role role)
+        {
+            if(node == UNKNOWN_NODE)
+            {
+                return status_no_error;
+            }
+            const uint64_t node_cpus = query_node_cpus(node);
+            if(node_cpus == 0)
+            {
+                return status_invalid_argument;
+            }
+
+            const uint64_t role_cpus = thread_configuration::query_config(role).cpu_affinity_mask & node_cpus;
+            const uint64_t thread_cpus = role_cpus != 0 ? role_cpus : node_cpus;
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            for(int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++)
+            {
+                if(thread_cpus & (1ull << cpu))
+                {
+                    CPU_SET(cpu, &cpus);
+                }
+            }
+            if(pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+            {
+                LOG_WARN("the thread keeps its cpus, the system refused to bind it to numa node " << node);
+                return status_exec_aborted;
+            }
+            return status_no_error;
+        }
+#else
+        int32_t numa_topology::query_nodes_count()
+        {
+            return 1;
+        }
+
+        int32_t numa_topology::query_usb_port_node(const char * usb_port_id)
+        {
+            return UNKNOWN_NODE;
+        }
+
+        uint64_t numa_topology::query_node_cpus(int32_t node)
+        {
+            return 0;
+        }
+
+        status numa_topology::bind_thread(int32_t node, thread_role role)
+        {
+            return node == UNKNOWN_NODE ? status_no_error : status_feature_unsupported;
+        }
+#endif
+    }
+}
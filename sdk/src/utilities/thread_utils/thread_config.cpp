@@ -0,0 +1,158 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <mutex>
+#include <cstring>
+#include "rs/utils/thread_config.h"
+#include "rs/utils/log_utils.h"
+
+#ifdef WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace utils
+    {
+        namespace
+        {
+            const int32_t MIN_NICE_LEVEL = -20;
+            const int32_t MAX_NICE_LEVEL = 19;
+            const int32_t MIN_REAL_TIME_PRIORITY = 1;
+            const int32_t MAX_REAL_TIME_PRIORITY = 99;
+
+            //the configurations are read once by each created thread
+            std::mutex configs_lock;
+            thread_config configs[static_cast<int32_t>(thread_role::max)] = {};
+
+            bool is_role_valid(thread_role role)
+            {
+                return role >= thread_role::recording && role < thread_role::max;
+            }
+
+#ifdef WIN32
+            status apply_config(const thread_config & config)
+            {
+                HANDLE thread = GetCurrentThread();
+                bool is_applied = true;
+                if(config.cpu_affinity_mask != 0)
+                {
+                    is_applied &= SetThreadAffinityMask(thread, static_cast<DWORD_PTR>(config.cpu_affinity_mask)) != 0;
+                }
+                if(config.scheduling == thread_scheduling::real_time)
+                {
+                    is_applied &= SetThreadPriority(thread, THREAD_PRIORITY_TIME_CRITICAL) != 0;
+                }
+                else if(config.priority != 0)
+                {
+                    //the nice levels are mapped to the thread priorities around the normal priority
+                    is_applied &= SetThreadPriority(thread, config.priority < 0 ? THREAD_PRIORITY_ABOVE_NORMAL : THREAD_PRIORITY_BELOW_NORMAL) != 0;
+                }
+                return is_applied ? status_no_error : status_exec_aborted;
+            }
+#elif defined(__linux__)
+            status apply_config(const thread_config & config)
+            {
+                bool is_applied = true;
+                if(config.cpu_affinity_mask != 0)
+                {
+                    cpu_set_t cpus;
+                    CPU_ZERO(&cpus);
+                    for(int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++)
+                    {
+                        if(config.cpu_affinity_mask & (1ull << cpu))
+                        {
+                            CPU_SET(cpu, &cpus);
+                        }
+                    }
+                    is_applied &= pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+                }
+                if(config.scheduling == thread_scheduling::real_time)
+                {
+                    sched_param parameters = {};
+                    parameters.sched_priority = config.priority;
+                    is_applied &= pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters) == 0;
+                }
+                else if(config.priority != 0)
+                {
+                    //the nice level of a linux thread is set by its thread id
+                    is_applied &= setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), config.priority) == 0;
+                }
+                return is_applied ? status_no_error : status_exec_aborted;
+            }
+#else
+            status apply_config(const thread_config & config)
+            {
+                const bool is_default = config.cpu_affinity_mask == 0 && config.scheduling == thread_scheduling::normal && config.priority == 0;
+                return is_default ? status_no_error : status_feature_unsupported;
+            }
+#endif
+
+            void set_thread_name(const char * name)
+            {
+#if defined(__linux__)
+                //the linux thread names are limited to 15 characters
+                char truncated_name[16] = {};
+                std::strncpy(truncated_name, name, sizeof(truncated_name) - 1);
+                pthread_setname_np(pthread_self(), truncated_name);
+#endif
+            }
+        }
+
+        status thread_configuration::set_config(thread_role role, const thread_config & config)
+        {
+            if(!is_role_valid(role))
+            {
+                return status_invalid_argument;
+            }
+            const bool is_priority_valid = config.scheduling == thread_scheduling::real_time ?
+                                               config.priority >= MIN_REAL_TIME_PRIORITY && config.priority <= MAX_REAL_TIME_PRIORITY :
+                                               config.priority >= MIN_NICE_LEVEL && config.priority <= MAX_NICE_LEVEL;
+            if(!is_priority_valid)
+            {
+                return status_invalid_argument;
+            }
+
+            std::lock_guard<std::mutex> lock(configs_lock);
+            configs[static_cast<int32_t>(role)] = config;
+            return status_no_error;
+        }
+
+        thread_config thread_configuration::query_config(thread_role role)
+        {
+            if(!is_role_valid(role))
+            {
+                return thread_config();
+            }
+            std::lock_guard<std::mutex> lock(configs_lock);
+            return configs[static_cast<int32_t>(role)];
+        }
+
+        status thread_configuration::apply(thread_role role, const char * name)
+        {
+            if(!is_role_valid(role))
+            {
+                return status_invalid_argument;
+            }
+            if(name)
+            {
+                set_thread_name(name);
+            }
+
+            const status apply_status = apply_config(query_config(role));
+            if(apply_status != status_no_error)
+            {
+                LOG_WARN("thread " << (name ? name : "") << " keeps its inherited settings, the system refused its configuration, error code " << apply_status);
+            }
+            return apply_status;
+        }
+    }
+}
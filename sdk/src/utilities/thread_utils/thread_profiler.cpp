@@ -0,0 +1,158 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "rs/utils/thread_profiler.h"
+
+#ifdef WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <time.h>
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        namespace
+        {
+            struct role_counters
+            {
+                std::atomic<uint32_t> threads_count;
+                std::atomic<uint64_t> running_time;
+                std::atomic<uint64_t> cpu_time;
+                std::atomic<uint64_t> wait_time[static_cast<int32_t>(thread_wait::max)];
+                std::atomic<uint64_t> processed_items_count;
+            };
+
+            //zero initialized as static storage, before any thread is profiled
+            role_counters roles_counters[static_cast<int32_t>(thread_role::max)];
+
+            bool is_role_valid(thread_role role)
+            {
+                return role >= thread_role::recording && role < thread_role::max;
+            }
+
+            //the cpu time of the calling thread, in microseconds
+            uint64_t query_thread_cpu_time()
+            {
+#ifdef WIN32
+                FILETIME creation_time, exit_time, kernel_time, user_time;
+                if(!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time))
+                    return 0;
+                auto to_100ns = [](const FILETIME & time) { return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime; };
+                return (to_100ns(kernel_time) + to_100ns(user_time)) / 10;
+#elif defined(__linux__)
+                timespec time = {};
+                if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+                    return 0;
+                return static_cast<uint64_t>(time.tv_sec) * 1000000 + static_cast<uint64_t>(time.tv_nsec) / 1000;
+#else
+                return 0;
+#endif
+            }
+        }
+
+        thread_profiler::thread_profiler(thread_role role) :
+            m_role(role), m_last_cpu_time(0), m_running_time(0), m_cpu_time(0), m_processed_items_count(0), m_is_running(false)
+        {
+            for(auto & wait_time : m_wait_time)
+                wait_time.store(0, std::memory_order_relaxed);
+        }
+
+        thread_profiler::~thread_profiler()
+        {
+            //a profiler which wasn't stopped by its thread isn't counted as running
+            if(m_is_running.load(std::memory_order_relaxed) && is_role_valid(m_role))
+                roles_counters[static_cast<int32_t>(m_role)].threads_count.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        void thread_profiler::start()
+        {
+            if(m_is_running.load(std::memory_order_relaxed))
+                return;
+            m_thread_id = std::this_thread::get_id();
+            m_last_sample_time = std::chrono::steady_clock::now();
+            m_last_cpu_time = query_thread_cpu_time();
+            m_is_running.store(true, std::memory_order_release);
+            if(is_role_valid(m_role))
+                roles_counters[static_cast<int32_t>(m_role)].threads_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void thread_profiler::stop()
+        {
+            if(!is_profiled_thread())
+                return;
+            sample_times();
+            m_is_running.store(false, std::memory_order_relaxed);
+            if(is_role_valid(m_role))
+                roles_counters[static_cast<int32_t>(m_role)].threads_count.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        void thread_profiler::add_processed_items(uint64_t count)
+        {
+            if(!is_profiled_thread())
+                return;
+            m_processed_items_count.fetch_add(count, std::memory_order_relaxed);
+            if(is_role_valid(m_role))
+                roles_counters[static_cast<int32_t>(m_role)].processed_items_count.fetch_add(count, std::memory_order_relaxed);
+            sample_times();
+        }
+
+        void thread_profiler::add_wait_time(thread_wait wait, uint64_t microseconds)
+        {
+            if(!is_profiled_thread() || wait < thread_wait::input || wait >= thread_wait::max)
+                return;
+            m_wait_time[static_cast<int32_t>(wait)].fetch_add(microseconds, std::memory_order_relaxed);
+            if(is_role_valid(m_role))
+                roles_counters[static_cast<int32_t>(m_role)].wait_time[static_cast<int32_t>(wait)].fetch_add(microseconds, std::memory_order_relaxed);
+            sample_times();
+        }
+
+        void thread_profiler::sample_times()
+        {
+            auto now = std::chrono::steady_clock::now();
+            auto running_time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - m_last_sample_time).count());
+            auto cpu_time = query_thread_cpu_time();
+            auto cpu_time_delta = cpu_time > m_last_cpu_time ? cpu_time - m_last_cpu_time : 0;
+            //the time is counted in whole microseconds, the remainder is kept for the next sample
+            m_last_sample_time += std::chrono::microseconds(running_time);
+            m_last_cpu_time += cpu_time_delta;
+
+            m_running_time.fetch_add(running_time, std::memory_order_relaxed);
+            m_cpu_time.fetch_add(cpu_time_delta, std::memory_order_relaxed);
+            if(is_role_valid(m_role))
+            {
+                auto & counters = roles_counters[static_cast<int32_t>(m_role)];
+                counters.running_time.fetch_add(running_time, std::memory_order_relaxed);
+                counters.cpu_time.fetch_add(cpu_time_delta, std::memory_order_relaxed);
+            }
+        }
+
+        thread_statistics thread_profiler::query_statistics() const
+        {
+            thread_statistics statistics = {};
+            statistics.threads_count = m_is_running.load(std::memory_order_relaxed) ? 1 : 0;
+            statistics.running_time = m_running_time.load(std::memory_order_relaxed);
+            statistics.cpu_time = m_cpu_time.load(std::memory_order_relaxed);
+            for(int32_t i = 0; i < static_cast<int32_t>(thread_wait::max); i++)
+                statistics.wait_time[i] = m_wait_time[i].load(std::memory_order_relaxed);
+            statistics.processed_items_count = m_processed_items_count.load(std::memory_order_relaxed);
+            return statistics;
+        }
+
+        thread_statistics thread_profiler::query_role_statistics(thread_role role)
+        {
+            thread_statistics statistics = {};
+            if(!is_role_valid(role))
+                return statistics;
+            auto & counters = roles_counters[static_cast<int32_t>(role)];
+            statistics.threads_count = counters.threads_count.load(std::memory_order_relaxed);
+            statistics.running_time = counters.running_time.load(std::memory_order_relaxed);
+            statistics.cpu_time = counters.cpu_time.load(std::memory_order_relaxed);
+            for(int32_t i = 0; i < static_cast<int32_t>(thread_wait::max); i++)
+                statistics.wait_time[i] = counters.wait_time[i].load(std::memory_order_relaxed);
+            statistics.processed_items_count = counters.processed_items_count.load(std::memory_order_relaxed);
+            return statistics;
+        }
+    }
+}
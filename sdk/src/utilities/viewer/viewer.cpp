@@ -1,11 +1,90 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <cstring>
+#include <algorithm>
 #include "viewer.h"
+#include "viewer_gl.h"
 #include "rs_sdk_version.h"
+#include "rs/utils/image_statistics.h"
+#include "rs/utils/thread_config.h"
+#include "rs/utils/self_releasing_array_data_releaser.h"
 
 namespace
 {
+    //the windows are redrawn at most at the display rate, and the window events are polled at least once per poll period
+    const uint32_t DEFAULT_MAX_DISPLAY_RATE = 60;
+    const std::chrono::milliseconds EVENTS_POLL_PERIOD(10);
+
+    //the shader modes, matching the fragment shader. a texture converted on the cpu is drawn without the shader
+    const int SHADER_MODE_NONE = -1;
+    const int SHADER_MODE_COLOR = 0;
+    const int SHADER_MODE_YUYV = 1;
+    const int SHADER_MODE_DEPTH = 2;
+    const int SHADER_MODE_GRAY16 = 3;
+
+    //depth values are clamped to this range before coloring, as the cpu depth conversion does
+    const uint16_t MAX_COLORED_DEPTH = 3000;
+
+    const char * VERTEX_SHADER =
+        "void main()\n"
+        "{\n"
+        "    gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+        "    gl_Position = ftransform();\n"
+        "}\n";
+
+    //the conversions produce the same colors as the cpu image conversions
+    const char * FRAGMENT_SHADER =
+        "uniform sampler2D u_image;\n"
+        "uniform int u_mode;\n"
+        "uniform float u_width;\n"
+        "uniform float u_scale;\n"
+        "uniform float u_offset;\n"
+        "void main()\n"
+        "{\n"
+        "    vec2 coord = gl_TexCoord[0].xy;\n"
+        "    vec4 texel = texture2D(u_image, coord);\n"
+        "    if(u_mode == 1)\n"
+        "    {\n"
+        "        //each yuyv texel holds the luma and a chroma sample, the pair shares the u of the even texel and the v of the odd texel\n"
+        "        float pair_x = floor(coord.x * u_width * 0.5) * 2.0;\n"
+        "        float u = texture2D(u_image, vec2((pair_x + 0.5) / u_width, coord.y)).a - 128.0 / 255.0;\n"
+        "        float v = texture2D(u_image, vec2((pair_x + 1.5) / u_width, coord.y)).a - 128.0 / 255.0;\n"
+        "        float y = 1.164 * max(texel.r - 16.0 / 255.0, 0.0);\n"
+        "        gl_FragColor = vec4(y + 1.596 * v, y - 0.391 * u - 0.813 * v, y + 2.018 * u, 1.0);\n"
+        "    }\n"
+        "    else if(u_mode == 2)\n"
+        "    {\n"
+        "        //the hot colormap, with the red and the blue channels swapped as the cpu depth conversion writes them\n"
+        "        float position = clamp((texel.r - u_offset) * u_scale, 0.0, 1.0) * 63.0;\n"
+        "        vec3 hot = clamp(vec3((position + 1.0) / 24.0, (position - 23.0) / 24.0, (position - 47.0) / 16.0), 0.0, 1.0);\n"
+        "        gl_FragColor = vec4(hot.b, hot.g, hot.r, 1.0);\n"
+        "    }\n"
+        "    else if(u_mode == 3)\n"
+        "    {\n"
+        "        gl_FragColor = vec4(vec3(clamp(texel.r * u_scale, 0.0, 1.0)), 1.0);\n"
+        "    }\n"
+        "    else\n"
+        "    {\n"
+        "        gl_FragColor = vec4(texel.rgb, 1.0);\n"
+        "    }\n"
+        "}\n";
+
+    GLuint compile_shader(rs::utils::viewer_gl & gl, GLenum type, const char * source)
+    {
+        GLuint shader = gl.create_shader(type);
+        gl.shader_source(shader, 1, &source, nullptr);
+        gl.compile_shader(shader);
+        GLint is_compiled = GL_FALSE;
+        gl.get_shader_iv(shader, GL_COMPILE_STATUS, &is_compiled);
+        if(is_compiled != GL_TRUE)
+        {
+            gl.delete_shader(shader);
+            return 0;
+        }
+        return shader;
+    }
+
     static std::map<rs::core::stream_type, std::string> create_streams_names_map()
     {
         std::map<rs::core::stream_type, std::string> rv;
@@ -30,7 +109,39 @@ namespace rs
             m_stream_count(stream_count),
             m_user_on_close_callback(on_close_callback),
             m_title(title),
-            m_is_running(true)
+            m_is_running(true),
+            m_program(0),
+            m_max_display_rate(DEFAULT_MAX_DISPLAY_RATE),
+            m_offscreen_sink(nullptr),
+            m_offscreen_framebuffer(0),
+            m_offscreen_texture(0),
+            m_readback_buffers{0, 0},
+            m_readback_time_stamps{0, 0},
+            m_is_readback_pending{false, false},
+            m_next_readback_buffer(0),
+            m_latest_time_stamp(0)
+        {
+            m_ui_thread = std::thread(&viewer::ui_refresh, this);
+        }
+
+        viewer::viewer(size_t stream_count, uint32_t width, uint32_t height, offscreen_sink * sink) :
+            m_width(width),
+            m_height(height),
+            m_window(nullptr),
+            m_stream_count(stream_count),
+            m_user_on_close_callback(nullptr),
+            m_title("rs-offscreen-viewer"),
+            m_is_running(true),
+            m_program(0),
+            m_max_display_rate(DEFAULT_MAX_DISPLAY_RATE),
+            m_offscreen_sink(sink),
+            m_offscreen_framebuffer(0),
+            m_offscreen_texture(0),
+            m_readback_buffers{0, 0},
+            m_readback_time_stamps{0, 0},
+            m_is_readback_pending{false, false},
+            m_next_readback_buffer(0),
+            m_latest_time_stamp(0)
         {
             m_ui_thread = std::thread(&viewer::ui_refresh, this);
         }
@@ -57,20 +168,31 @@ namespace rs
 
         void viewer::ui_refresh()
         {
+            rs::utils::thread_configuration::apply(rs::utils::thread_role::viewer, "rs-viewer");
             setup_window(m_width, m_height, m_title);
+            setup_gl_upload();
+            setup_offscreen();
 
             std::vector<std::shared_ptr<rs::core::image_interface>> images;
             images.reserve(5); // MAX_STREAM_TYPES_COUNT
 
-            auto pred = [this]() -> bool
+            auto next_display_time = std::chrono::steady_clock::now();
+            auto pred = [this, &next_display_time]() -> bool
             {
-                    return ((m_is_running == false) || (m_render_buffer.size() > 0));
+                    return ((m_is_running == false) || (m_render_buffer.size() > 0 && std::chrono::steady_clock::now() >= next_display_time));
             };
 
             while(m_is_running)
             {
                 std::unique_lock<std::mutex> locker(m_render_mutex);
-                bool render =  m_render_thread_cv.wait_for(locker, std::chrono::milliseconds(10), pred);
+                //pending frames wait for the next display time, a newer frame of the stream replaces its pending frame meanwhile
+                std::chrono::steady_clock::duration wait_duration = EVENTS_POLL_PERIOD;
+                auto now = std::chrono::steady_clock::now();
+                if(m_render_buffer.size() > 0 && next_display_time > now)
+                {
+                    wait_duration = std::min(wait_duration, next_display_time - now);
+                }
+                bool render =  m_render_thread_cv.wait_for(locker, wait_duration, pred);
 
                 if (render == true)
                 {
@@ -91,16 +213,33 @@ namespace rs
                 {
                     // TODO: make images clear scope guard
 
+                    bool is_uploaded = false;
+                    double latest_time_stamp = 0;
                     for (auto& image : images)
                     {
-                        render_image(image);
+                        is_uploaded |= upload_image(image);
+                        latest_time_stamp = std::max(latest_time_stamp, image->query_time_stamp());
                     }
 
                     images.clear();
+
+                    //all the streams are drawn with a single buffers swap
+                    if (is_uploaded)
+                    {
+                        m_latest_time_stamp = latest_time_stamp;
+                        draw_streams();
+                    }
+
+                    auto max_display_rate = m_max_display_rate.load();
+                    next_display_time = std::chrono::steady_clock::now();
+                    if (max_display_rate > 0)
+                    {
+                        next_display_time += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / max_display_rate));
+                    }
                 }
 
                 glfwPollEvents();
-                if (glfwWindowShouldClose(m_window) > 0)
+                if (m_window && glfwWindowShouldClose(m_window) > 0)
                 {
                     m_is_running = false;
                 }
@@ -116,6 +255,8 @@ namespace rs
                 m_user_on_close_callback();
             }
 
+            release_offscreen();
+            release_gl_upload();
             glfwDestroyWindow(m_window);
             glfwTerminate();
         }
@@ -156,11 +297,32 @@ namespace rs
             update_buffer(image);
         }
 
-        void viewer::render_image(std::shared_ptr<rs::core::image_interface> image)
+        void viewer::set_max_display_rate(uint32_t frames_per_second)
+        {
+            m_max_display_rate = frames_per_second;
+        }
+
+        bool viewer::upload_image(std::shared_ptr<rs::core::image_interface> image)
         {
             auto stream = image->query_stream_type();
 
-            if(!add_window(stream)) return;
+            if(!add_window(stream)) return false;
+
+            glfwMakeContextCurrent(m_window);
+            auto & stream_texture = m_textures[stream];
+            if(!stream_texture.texture)
+            {
+                glGenTextures(1, &stream_texture.texture);
+                if(m_gl)
+                {
+                    m_gl->gen_buffers(2, stream_texture.pixel_buffers);
+                }
+            }
+
+            if(upload_texture(image.get(), stream_texture))
+            {
+                return true;
+            }
 
             int gl_format, gl_channel_type;
             const core::image_interface * converted_image = nullptr;
@@ -177,7 +339,7 @@ namespace rs
                     gl_channel_type = GL_UNSIGNED_BYTE;
                     break;
                 case rs::core::pixel_format::yuyv:
-                    if(image->convert_to(core::pixel_format::rgba8, &converted_image) != core::status_no_error) return;
+                    if(image->convert_to(core::pixel_format::rgba8, &converted_image) != core::status_no_error) return false;
                     gl_format = GL_RGBA;
                     gl_channel_type = GL_UNSIGNED_BYTE;
                     break;
@@ -199,7 +361,7 @@ namespace rs
                     gl_channel_type = GL_SHORT;
                     break;
                 case rs::core::pixel_format::z16:
-                    if(image->convert_to(core::pixel_format::rgba8, &converted_image) != core::status_no_error) return;
+                    if(image->convert_to(core::pixel_format::rgba8, &converted_image) != core::status_no_error) return false;
                     gl_format = GL_RGBA;
                     gl_channel_type = GL_UNSIGNED_BYTE;
                     break;
@@ -214,7 +376,19 @@ namespace rs
                 image_to_show = converted_image;
             }
 
-            draw(image_to_show, gl_format, gl_channel_type);
+            //the converted image is converted on its first data query, which returns null if the conversion fails
+            auto data = image_to_show->query_data();
+            if(!data) return false;
+            auto info = image_to_show->query_info();
+            glBindTexture(GL_TEXTURE_2D, stream_texture.texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, info.width, info.height, 0, gl_format, gl_channel_type, data);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            stream_texture.info = info;
+            stream_texture.internal_format = GL_RGB;
+            stream_texture.shader_mode = SHADER_MODE_NONE;
+            return true;
         }
 
         bool viewer::add_window(rs::core::stream_type stream)
@@ -235,16 +409,320 @@ namespace rs
             return true;
         }
 
-        void viewer::draw(const rs::core::image_interface * image, int gl_format, int gl_channel_type)
+        void viewer::setup_gl_upload()
         {
-            auto rect = calc_window_size(image);
+            if(!m_window)
+                return;
+            std::unique_ptr<viewer_gl> gl(new viewer_gl());
+            if(!gl->load())
+                return;
+
+            GLuint vertex_shader = compile_shader(*gl, GL_VERTEX_SHADER, VERTEX_SHADER);
+            GLuint fragment_shader = compile_shader(*gl, GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+            if(vertex_shader && fragment_shader)
+            {
+                GLuint program = gl->create_program();
+                gl->attach_shader(program, vertex_shader);
+                gl->attach_shader(program, fragment_shader);
+                gl->link_program(program);
+                GLint is_linked = GL_FALSE;
+                gl->get_program_iv(program, GL_LINK_STATUS, &is_linked);
+                if(is_linked == GL_TRUE)
+                {
+                    m_program = program;
+                }
+                else
+                {
+                    gl->delete_program(program);
+                }
+            }
+            if(vertex_shader) gl->delete_shader(vertex_shader);
+            if(fragment_shader) gl->delete_shader(fragment_shader);
+
+            if(m_program)
+            {
+                m_gl = std::move(gl);
+            }
+        }
+
+        void viewer::release_gl_upload()
+        {
+            if(!m_window)
+                return;
+            glfwMakeContextCurrent(m_window);
+            for(auto & stream_texture : m_textures)
+            {
+                glDeleteTextures(1, &stream_texture.second.texture);
+                if(m_gl)
+                    m_gl->delete_buffers(2, stream_texture.second.pixel_buffers);
+            }
+            m_textures.clear();
+            if(!m_gl)
+                return;
+            m_gl->delete_program(m_program);
+            m_program = 0;
+            m_gl.reset();
+        }
+
+        bool viewer::upload_texture(const rs::core::image_interface * image, stream_texture & stream_texture)
+        {
+            if(!m_gl)
+                return false;
+
+            auto info = image->query_info();
+            GLint internal_format;
+            GLenum gl_format, gl_channel_type = GL_UNSIGNED_BYTE;
+            int bytes_per_pixel;
+            int shader_mode = SHADER_MODE_COLOR;
+            float scale = 1.f, offset = 0.f;
+            switch(info.format)
+            {
+                case rs::core::pixel_format::rgb8: internal_format = GL_RGB; gl_format = GL_RGB; bytes_per_pixel = 3; break;
+                case rs::core::pixel_format::bgr8: internal_format = GL_RGB; gl_format = GL_BGR_EXT; bytes_per_pixel = 3; break;
+                case rs::core::pixel_format::rgba8: internal_format = GL_RGBA; gl_format = GL_RGBA; bytes_per_pixel = 4; break;
+                case rs::core::pixel_format::bgra8: internal_format = GL_RGBA; gl_format = GL_BGRA_EXT; bytes_per_pixel = 4; break;
+                case rs::core::pixel_format::raw8:
+                case rs::core::pixel_format::y8: internal_format = GL_LUMINANCE; gl_format = GL_LUMINANCE; bytes_per_pixel = 1; break;
+                case rs::core::pixel_format::yuyv:
+                    //the luma and chroma samples of a pixel are uploaded as a luminance alpha texel, the shader converts them
+                    internal_format = GL_LUMINANCE8_ALPHA8;
+                    gl_format = GL_LUMINANCE_ALPHA;
+                    bytes_per_pixel = 2;
+                    shader_mode = SHADER_MODE_YUYV;
+                    break;
+                case rs::core::pixel_format::y16:
+                case rs::core::pixel_format::z16:
+                {
+                    //the values are scaled so the maximal value, clamped for depth, is the full intensity
+                    internal_format = GL_LUMINANCE16;
+                    gl_format = GL_LUMINANCE;
+                    gl_channel_type = GL_UNSIGNED_SHORT;
+                    bytes_per_pixel = 2;
+                    //a fixed depth colorization range colors the depth without the statistics pass
+                    uint16_t min_depth = 0, max_depth = 0;
+                    if(info.format == rs::core::pixel_format::z16 && rs::core::image_interface::query_depth_colorization_range(min_depth, max_depth))
+                    {
+                        shader_mode = SHADER_MODE_DEPTH;
+                        scale = 65535.f / (max_depth - min_depth);
+                        offset = min_depth / 65535.f;
+                        break;
+                    }
+                    image_statistics::statistics stats = {};
+                    image_statistics::query_statistics(info, image->query_data(), {}, stats);
+                    uint16_t max = stats.max_value;
+                    if(info.format == rs::core::pixel_format::z16)
+                    {
+                        shader_mode = SHADER_MODE_DEPTH;
+                        max = std::min(max, MAX_COLORED_DEPTH);
+                    }
+                    else
+                    {
+                        shader_mode = SHADER_MODE_GRAY16;
+                    }
+                    scale = max > 0 ? 65535.f / max : 0.f;
+                    break;
+                }
+                default:
+                    return false;
+            }
+            if(info.pitch % bytes_per_pixel != 0 || !image->query_data())
+                return false;
+
+            glBindTexture(GL_TEXTURE_2D, stream_texture.texture);
+
+            //the texture storage is allocated once per stream resolution and format
+            if(stream_texture.info.width != info.width || stream_texture.info.height != info.height || stream_texture.internal_format != internal_format)
+            {
+                glTexImage2D(GL_TEXTURE_2D, 0, internal_format, info.width, info.height, 0, gl_format, gl_channel_type, nullptr);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+                stream_texture.internal_format = internal_format;
+            }
+
+            //the pixel buffers alternate, the previous frame upload may still be in flight while the next frame is copied.
+            //the buffer storage is orphaned before mapping, so mapping doesn't wait for the gpu
+            const std::ptrdiff_t image_size = static_cast<std::ptrdiff_t>(info.pitch) * info.height;
+            m_gl->bind_buffer(GL_PIXEL_UNPACK_BUFFER, stream_texture.pixel_buffers[stream_texture.next_pixel_buffer]);
+            stream_texture.next_pixel_buffer ^= 1;
+            m_gl->buffer_data(GL_PIXEL_UNPACK_BUFFER, image_size, nullptr, GL_STREAM_DRAW);
+            void * pixel_buffer = m_gl->map_buffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+            if(!pixel_buffer)
+            {
+                m_gl->bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                glBindTexture(GL_TEXTURE_2D, 0);
+                return false;
+            }
+            std::memcpy(pixel_buffer, image->query_data(), image_size);
+            m_gl->unmap_buffer(GL_PIXEL_UNPACK_BUFFER);
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, info.pitch / bytes_per_pixel);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, info.width, info.height, gl_format, gl_channel_type, nullptr);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            m_gl->bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glBindTexture(GL_TEXTURE_2D, 0);
+
+            stream_texture.info = info;
+            stream_texture.shader_mode = shader_mode;
+            stream_texture.scale = scale;
+            stream_texture.offset = offset;
+            return true;
+        }
+
+        void viewer::draw_streams()
+        {
+            glfwMakeContextCurrent(m_window);
+            if(m_offscreen_sink)
+            {
+                if(!m_offscreen_framebuffer)
+                    return;
+                m_offscreen_gl->bind_framebuffer(GL_FRAMEBUFFER, m_offscreen_framebuffer);
+                glViewport(0, 0, m_width, m_height);
+            }
+            glClear(GL_COLOR_BUFFER_BIT);
+            for(auto & stream_texture : m_textures)
+            {
+                auto & texture = stream_texture.second;
+                if(texture.info.width == 0 || texture.info.height == 0)
+                    continue;
+                if(texture.shader_mode != SHADER_MODE_NONE)
+                {
+                    m_gl->use_program(m_program);
+                    m_gl->uniform_1i(m_gl->get_uniform_location(m_program, "u_image"), 0);
+                    m_gl->uniform_1i(m_gl->get_uniform_location(m_program, "u_mode"), texture.shader_mode);
+                    m_gl->uniform_1f(m_gl->get_uniform_location(m_program, "u_width"), static_cast<float>(texture.info.width));
+                    m_gl->uniform_1f(m_gl->get_uniform_location(m_program, "u_scale"), texture.scale);
+                    m_gl->uniform_1f(m_gl->get_uniform_location(m_program, "u_offset"), texture.offset);
+                }
+                glBindTexture(GL_TEXTURE_2D, texture.texture);
+                draw_quad(stream_texture.first, texture.info);
+                glBindTexture(GL_TEXTURE_2D, 0);
+                if(texture.shader_mode != SHADER_MODE_NONE)
+                {
+                    m_gl->use_program(0);
+                }
+            }
+            if(m_offscreen_sink)
+            {
+                deliver_composition();
+                m_offscreen_gl->bind_framebuffer(GL_FRAMEBUFFER, 0);
+                return;
+            }
+            glfwSwapBuffers(m_window);
+        }
+
+        void viewer::setup_offscreen()
+        {
+            if(!m_window || !m_offscreen_sink)
+                return;
+            std::unique_ptr<viewer_gl> gl(new viewer_gl());
+            if(!gl->load_offscreen())
+                return;
+
+            glGenTextures(1, &m_offscreen_texture);
+            glBindTexture(GL_TEXTURE_2D, m_offscreen_texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glBindTexture(GL_TEXTURE_2D, 0);
+
+            gl->gen_framebuffers(1, &m_offscreen_framebuffer);
+            gl->bind_framebuffer(GL_FRAMEBUFFER, m_offscreen_framebuffer);
+            gl->framebuffer_texture_2d(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_offscreen_texture, 0);
+            const bool is_complete = gl->check_framebuffer_status(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+            gl->bind_framebuffer(GL_FRAMEBUFFER, 0);
+            if(!is_complete)
+            {
+                gl->delete_framebuffers(1, &m_offscreen_framebuffer);
+                glDeleteTextures(1, &m_offscreen_texture);
+                m_offscreen_framebuffer = 0;
+                m_offscreen_texture = 0;
+                return;
+            }
+
+            gl->gen_buffers(2, m_readback_buffers);
+            m_offscreen_gl = std::move(gl);
+        }
+
+        void viewer::release_offscreen()
+        {
+            if(!m_window || !m_offscreen_gl)
+                return;
+            glfwMakeContextCurrent(m_window);
+            m_offscreen_gl->delete_buffers(2, m_readback_buffers);
+            m_offscreen_gl->delete_framebuffers(1, &m_offscreen_framebuffer);
+            glDeleteTextures(1, &m_offscreen_texture);
+            m_offscreen_framebuffer = 0;
+            m_offscreen_texture = 0;
+            m_offscreen_gl.reset();
+        }
+
+        void viewer::deliver_composition()
+        {
+            bool is_image_requested = m_offscreen_sink->on_composed_texture(m_offscreen_texture, m_width, m_height, m_latest_time_stamp);
+
+            //the composition is read to a pixel buffer without waiting for the gpu, the buffer read by the previous composition is
+            //mapped meanwhile, its read is complete by now
+            const std::ptrdiff_t pitch = static_cast<std::ptrdiff_t>(m_width) * 4;
+            const uint32_t current = m_next_readback_buffer;
+            const uint32_t previous = current ^ 1;
+            if(is_image_requested)
+            {
+                m_offscreen_gl->bind_buffer(GL_PIXEL_PACK_BUFFER, m_readback_buffers[current]);
+                m_offscreen_gl->buffer_data(GL_PIXEL_PACK_BUFFER, pitch * m_height, nullptr, GL_STREAM_READ);
+                glPixelStorei(GL_PACK_ALIGNMENT, 4);
+                glReadPixels(0, 0, m_width, m_height, GL_BGRA_EXT, GL_UNSIGNED_BYTE, nullptr);
+                m_readback_time_stamps[current] = m_latest_time_stamp;
+                m_is_readback_pending[current] = true;
+            }
+
+            if(m_is_readback_pending[previous])
+            {
+                m_is_readback_pending[previous] = false;
+                m_offscreen_gl->bind_buffer(GL_PIXEL_PACK_BUFFER, m_readback_buffers[previous]);
+                auto pixels = static_cast<const uint8_t *>(m_offscreen_gl->map_buffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+                if(pixels)
+                {
+                    //the gl rows are bottom up
+                    uint8_t * data = new uint8_t[pitch * m_height];
+                    for(uint32_t y = 0; y < m_height; y++)
+                    {
+                        std::memcpy(data + y * pitch, pixels + (m_height - 1 - y) * pitch, pitch);
+                    }
+                    m_offscreen_gl->unmap_buffer(GL_PIXEL_PACK_BUFFER);
+
+                    rs::core::image_info info = { static_cast<int32_t>(m_width), static_cast<int32_t>(m_height), rs::core::pixel_format::bgra8, static_cast<int32_t>(pitch) };
+                    auto image = rs::utils::get_unique_ptr_with_releaser(rs::core::image_interface::create_instance_from_raw_data(
+                        &info, {data, new rs::utils::self_releasing_array_data_releaser(data)}, rs::core::stream_type::color,
+                        rs::core::image_interface::flag::any, m_readback_time_stamps[previous], 0));
+                    m_offscreen_sink->on_composed_image(image.get());
+                }
+            }
+            m_offscreen_gl->bind_buffer(GL_PIXEL_PACK_BUFFER, 0);
+            m_next_readback_buffer = previous;
+        }
+
+        viewer::int_pair viewer::query_canvas_size()
+        {
+            if(m_offscreen_sink)
+                return int_pair(m_width, m_height);
+            int window_width, window_height;
+            glfwGetWindowSize(m_window, &window_width, &window_height);
+            return int_pair(window_width, window_height);
+        }
+
+        void viewer::draw_quad(rs::core::stream_type stream, const rs::core::image_info & info)
+        {
+            auto rect = calc_window_size(stream, info);
 
             auto x_entry = rect.first.first;
             auto y_entry = rect.first.second;
             auto width = rect.second.first;
             auto height = rect.second.second;
 
-            glfwMakeContextCurrent(m_window);
             glViewport (x_entry, y_entry, width, height);
 
             glLoadIdentity ();
@@ -252,10 +730,6 @@ namespace rs
             glPushMatrix();
             glOrtho(0, width, height, 0, -1, +1);
 
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image->query_info().width, image->query_info().height, 0, gl_format, gl_channel_type, image->query_data());
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-            glBindTexture(GL_TEXTURE_2D, 0);
             glEnable(GL_TEXTURE_2D);
             glBegin(GL_QUADS);
             glTexCoord2f(0, 0); glVertex2f(0, 0);
@@ -265,16 +739,14 @@ namespace rs
             glEnd();
             glDisable(GL_TEXTURE_2D);
             glPopMatrix();
-            glfwSwapBuffers(m_window);
         }
 
-        std::pair<viewer::int_pair, viewer::int_pair> viewer::calc_window_size(const rs::core::image_interface * image)
+        std::pair<viewer::int_pair, viewer::int_pair> viewer::calc_window_size(rs::core::stream_type stream, const rs::core::image_info & info)
         {
-            auto info = image->query_info();
-            size_t position = m_windows_positions.at(image->query_stream_type());
+            size_t position = m_windows_positions.at(stream);
 
-            int window_width, window_height;
-            glfwGetWindowSize(m_window, &window_width, &window_height);
+            int_pair canvas_size = query_canvas_size();
+            int window_width = canvas_size.first, window_height = canvas_size.second;
 
             int_pair window_grid = calc_grid(window_width, window_height, m_stream_count);
 
@@ -323,7 +795,10 @@ namespace rs
                 glfwTerminate();
             }
             glfwInit();
+            //the offscreen viewer needs only the gl context of its window
+            glfwWindowHint(GLFW_VISIBLE, m_offscreen_sink ? GL_FALSE : GL_TRUE);
             m_window = glfwCreateWindow(width, height, window_title.c_str(), nullptr, nullptr);
+            glfwDefaultWindowHints();
             glfwMakeContextCurrent(m_window);
         }
     }
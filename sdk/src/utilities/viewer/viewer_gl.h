@@ -0,0 +1,127 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <cstddef>
+#include <GLFW/glfw3.h>
+
+//the platform gl headers may only declare opengl 1.1, the shader and pixel buffer entry points are loaded at runtime
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER      0x8B30
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER        0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS       0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS          0x8B82
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER  0x88EC
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW          0x88E0
+#endif
+#ifndef GL_WRITE_ONLY
+#define GL_WRITE_ONLY           0x88B9
+#endif
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER    0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ          0x88E1
+#endif
+#ifndef GL_READ_ONLY
+#define GL_READ_ONLY            0x88B8
+#endif
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER          0x8D40
+#endif
+#ifndef GL_COLOR_ATTACHMENT0
+#define GL_COLOR_ATTACHMENT0    0x8CE0
+#endif
+#ifndef GL_FRAMEBUFFER_COMPLETE
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+         * @brief The opengl 2.1 functions the viewer uses for shader conversions and pixel buffer uploads, and the opengl 3.0
+         *        functions of the offscreen composition.
+         *
+         * The functions are loaded for the current context, the viewer falls back to converting the images on the cpu
+         * when the context doesn't provide them. The offscreen viewer composes nothing without the framebuffer functions.
+         */
+        struct viewer_gl
+        {
+            GLuint (APIENTRY * create_shader)(GLenum type);
+            void (APIENTRY * shader_source)(GLuint shader, GLsizei count, const char * const * strings, const GLint * lengths);
+            void (APIENTRY * compile_shader)(GLuint shader);
+            void (APIENTRY * get_shader_iv)(GLuint shader, GLenum name, GLint * value);
+            void (APIENTRY * delete_shader)(GLuint shader);
+            GLuint (APIENTRY * create_program)();
+            void (APIENTRY * attach_shader)(GLuint program, GLuint shader);
+            void (APIENTRY * link_program)(GLuint program);
+            void (APIENTRY * get_program_iv)(GLuint program, GLenum name, GLint * value);
+            void (APIENTRY * use_program)(GLuint program);
+            void (APIENTRY * delete_program)(GLuint program);
+            GLint (APIENTRY * get_uniform_location)(GLuint program, const char * name);
+            void (APIENTRY * uniform_1i)(GLint location, GLint value);
+            void (APIENTRY * uniform_1f)(GLint location, GLfloat value);
+            void (APIENTRY * gen_buffers)(GLsizei count, GLuint * buffers);
+            void (APIENTRY * delete_buffers)(GLsizei count, const GLuint * buffers);
+            void (APIENTRY * bind_buffer)(GLenum target, GLuint buffer);
+            void (APIENTRY * buffer_data)(GLenum target, std::ptrdiff_t size, const void * data, GLenum usage);
+            void * (APIENTRY * map_buffer)(GLenum target, GLenum access);
+            GLboolean (APIENTRY * unmap_buffer)(GLenum target);
+            void (APIENTRY * gen_framebuffers)(GLsizei count, GLuint * framebuffers);
+            void (APIENTRY * delete_framebuffers)(GLsizei count, const GLuint * framebuffers);
+            void (APIENTRY * bind_framebuffer)(GLenum target, GLuint framebuffer);
+            void (APIENTRY * framebuffer_texture_2d)(GLenum target, GLenum attachment, GLenum texture_target, GLuint texture, GLint level);
+            GLenum (APIENTRY * check_framebuffer_status)(GLenum target);
+
+            //returns false if the current context misses any of the functions
+            bool load()
+            {
+                return load(create_shader, "glCreateShader") && load(shader_source, "glShaderSource") &&
+                       load(compile_shader, "glCompileShader") && load(get_shader_iv, "glGetShaderiv") &&
+                       load(delete_shader, "glDeleteShader") && load(create_program, "glCreateProgram") &&
+                       load(attach_shader, "glAttachShader") && load(link_program, "glLinkProgram") &&
+                       load(get_program_iv, "glGetProgramiv") && load(use_program, "glUseProgram") &&
+                       load(delete_program, "glDeleteProgram") && load(get_uniform_location, "glGetUniformLocation") &&
+                       load(uniform_1i, "glUniform1i") && load(uniform_1f, "glUniform1f") &&
+                       load(gen_buffers, "glGenBuffers") && load(delete_buffers, "glDeleteBuffers") &&
+                       load(bind_buffer, "glBindBuffer") && load(buffer_data, "glBufferData") &&
+                       load(map_buffer, "glMapBuffer") && load(unmap_buffer, "glUnmapBuffer");
+            }
+
+            //loads the framebuffer object and the pixel buffer functions of the offscreen composition, opengl 3.0 or
+            //ARB_framebuffer_object. returns false if the current context misses any of them
+            bool load_offscreen()
+            {
+                return load(gen_framebuffers, "glGenFramebuffers") && load(delete_framebuffers, "glDeleteFramebuffers") &&
+                       load(bind_framebuffer, "glBindFramebuffer") && load(framebuffer_texture_2d, "glFramebufferTexture2D") &&
+                       load(check_framebuffer_status, "glCheckFramebufferStatus") &&
+                       load(gen_buffers, "glGenBuffers") && load(delete_buffers, "glDeleteBuffers") &&
+                       load(bind_buffer, "glBindBuffer") && load(buffer_data, "glBufferData") &&
+                       load(map_buffer, "glMapBuffer") && load(unmap_buffer, "glUnmapBuffer");
+            }
+
+        private:
+            template<typename function_type>
+            static bool load(function_type & function, const char * name)
+            {
+                function = reinterpret_cast<function_type>(glfwGetProcAddress(name));
+                return function != nullptr;
+            }
+        };
+    }
+}
@@ -2,6 +2,8 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include <stdio.h>
+#include <cstdlib>
+#include <cstring>
 #include <map>
 #include <fstream>
 #include <thread>
@@ -13,6 +15,14 @@
 #include "rs/playback/playback_device.h"
 #include "rs/playback/playback_context.h"
 #include "file_types.h"
+#include "compression/lz4_codec.h"
+#include "compression/lz4_stream_codec.h"
+#include "compression/delta_codec.h"
+#include "compression/rvl_codec.h"
+#include "compression/yuv420_codec.h"
+#ifdef WITH_ZSTD
+#include "compression/zstd_codec.h"
+#endif
 
 using namespace std;
 using namespace rs::core;
@@ -305,3 +315,150 @@ TEST_F(compression_fixture, four_streams_maximal_frame_drop_of_10_percent)
 }
 
 
+
+namespace codec_tests_util
+{
+    //odd frame sizes, and strides with padding after the pixels of each row
+    static const int width = 317;
+    static const int height = 241;
+    static const int stride_padding = 6;
+    static const uint8_t padding_value = 0xcd;
+
+    file_types::frame_info make_frame_info(int width, int height, rs_format format, int bpp, rs_stream stream)
+    {
+        file_types::frame_info info = {};
+        info.width = width;
+        info.height = height;
+        info.format = format;
+        info.bpp = bpp;
+        info.stride = width * bpp + stride_padding;
+        info.stream = stream;
+        info.framerate = 30;
+        return info;
+    }
+
+    //a smooth frame which compresses, the pixels of each frame number differ
+    std::vector<uint8_t> make_frame(const file_types::frame_info & info, int frame_number)
+    {
+        std::vector<uint8_t> frame(info.stride * info.height, padding_value);
+        for(int y = 0; y < info.height; y++)
+        {
+            uint8_t * row = frame.data() + y * info.stride;
+            for(int x = 0; x < info.width; x++)
+            {
+                uint8_t * pixel = row + x * info.bpp;
+                if(info.format == rs_format::RS_FORMAT_Z16)
+                {
+                    //depth with holes of invalid pixels
+                    uint16_t depth = (x % 37 < 5) ? 0 : static_cast<uint16_t>(1000 + y * 3 + (x * 7 + frame_number) % 64);
+                    memcpy(pixel, &depth, sizeof(depth));
+                }
+                else
+                {
+                    for(int channel = 0; channel < info.bpp; channel++)
+                        pixel[channel] = static_cast<uint8_t>((x + y) * 160 / (info.width + info.height) + channel * 30 + frame_number);
+                }
+            }
+        }
+        return frame;
+    }
+
+    //encodes the frames with the recording codec, decodes them in order with the playback codec and checks the pixels are restored up to max_error
+    void check_round_trip(rs::core::compression::codec_interface & encode_codec, rs::core::compression::codec_interface & decode_codec,
+                          file_types::frame_info info, int frames_count, int max_error)
+    {
+        std::vector<uint8_t> encoded(info.stride * info.height);
+        for(int i = 0; i < frames_count; i++)
+        {
+            info.number = i;
+            auto frame = make_frame(info, i);
+            uint32_t encoded_size = 0;
+            ASSERT_EQ(status_no_error, encode_codec.encode(info, frame.data(), encoded.data(), encoded_size)) << "frame " << i;
+            ASSERT_LT(0u, encoded_size);
+            ASSERT_LT(encoded_size, static_cast<uint32_t>(frame.size()));
+
+            auto decoded = decode_codec.decode(std::make_shared<file_types::frame_sample>(info, 0), encoded.data(), encoded_size);
+            ASSERT_NE(nullptr, decoded) << "frame " << i;
+            ASSERT_NE(nullptr, decoded->data);
+            EXPECT_EQ(info.width, decoded->finfo.width);
+            EXPECT_EQ(info.height, decoded->finfo.height);
+            EXPECT_EQ(info.stride, decoded->finfo.stride);
+            for(int y = 0; y < info.height; y++)
+            {
+                const uint8_t * expected = frame.data() + y * info.stride;
+                const uint8_t * actual = decoded->data + y * info.stride;
+                for(int x = 0; x < info.width * info.bpp; x++)
+                    ASSERT_LE(std::abs(expected[x] - actual[x]), max_error) << "frame " << i << ", row " << y << ", byte " << x;
+            }
+        }
+    }
+}
+
+TEST(codec_round_trip_tests, lz4)
+{
+    rs::core::compression::lz4_codec encode_codec(rs::record::compression_level::high);
+    rs::core::compression::lz4_codec decode_codec;
+    auto info = codec_tests_util::make_frame_info(codec_tests_util::width, codec_tests_util::height, rs_format::RS_FORMAT_RGB8, 3, rs_stream::RS_STREAM_COLOR);
+    codec_tests_util::check_round_trip(encode_codec, decode_codec, info, 2, 0);
+}
+
+TEST(codec_round_trip_tests, lz4_striped)
+{
+    rs::core::compression::lz4_codec encode_codec(rs::record::compression_level::medium, true);
+    rs::core::compression::lz4_codec decode_codec(true);
+    //large enough for the bands to be decoded in parallel, the rows aren't divided evenly between the bands
+    auto info = codec_tests_util::make_frame_info(1283, 721, rs_format::RS_FORMAT_RGB8, 3, rs_stream::RS_STREAM_COLOR);
+    codec_tests_util::check_round_trip(encode_codec, decode_codec, info, 2, 0);
+
+    //a small frame is coded as a single band
+    info = codec_tests_util::make_frame_info(codec_tests_util::width, codec_tests_util::height, rs_format::RS_FORMAT_RGB8, 3, rs_stream::RS_STREAM_COLOR);
+    codec_tests_util::check_round_trip(encode_codec, decode_codec, info, 2, 0);
+}
+
+TEST(codec_round_trip_tests, lz4_stream)
+{
+    rs::core::compression::lz4_stream_codec encode_codec(rs::record::compression_level::high);
+    rs::core::compression::lz4_stream_codec decode_codec;
+    auto info = codec_tests_util::make_frame_info(codec_tests_util::width, codec_tests_util::height, rs_format::RS_FORMAT_Y16, 2, rs_stream::RS_STREAM_INFRARED);
+    //past the keyframe interval, so the frames after the second keyframe are decoded too
+    codec_tests_util::check_round_trip(encode_codec, decode_codec, info, rs::core::compression::lz4_stream_codec::KEYFRAME_INTERVAL + 3, 0);
+}
+
+TEST(codec_round_trip_tests, delta)
+{
+    rs::core::compression::delta_codec encode_codec(rs::record::compression_level::medium);
+    rs::core::compression::delta_codec decode_codec;
+    auto info = codec_tests_util::make_frame_info(codec_tests_util::width, codec_tests_util::height, rs_format::RS_FORMAT_Z16, 2, rs_stream::RS_STREAM_DEPTH);
+    codec_tests_util::check_round_trip(encode_codec, decode_codec, info, rs::core::compression::delta_codec::KEYFRAME_INTERVAL + 3, 0);
+}
+
+TEST(codec_round_trip_tests, rvl)
+{
+    rs::core::compression::rvl_codec encode_codec;
+    rs::core::compression::rvl_codec decode_codec;
+    auto info = codec_tests_util::make_frame_info(codec_tests_util::width, codec_tests_util::height, rs_format::RS_FORMAT_Z16, 2, rs_stream::RS_STREAM_DEPTH);
+    codec_tests_util::check_round_trip(encode_codec, decode_codec, info, 2, 0);
+}
+
+TEST(codec_round_trip_tests, yuv420_error_is_bounded)
+{
+    //the chroma of each 2x2 pixels is averaged, the error of a smooth image is of the color conversion rounding
+    const int max_error = 4;
+    rs::core::compression::yuv420_codec encode_codec;
+    rs::core::compression::yuv420_codec decode_codec;
+    for(auto format : { rs_format::RS_FORMAT_RGB8, rs_format::RS_FORMAT_BGR8 })
+    {
+        auto info = codec_tests_util::make_frame_info(codec_tests_util::width, codec_tests_util::height, format, 3, rs_stream::RS_STREAM_COLOR);
+        codec_tests_util::check_round_trip(encode_codec, decode_codec, info, 2, max_error);
+    }
+}
+
+#ifdef WITH_ZSTD
+TEST(codec_round_trip_tests, zstd)
+{
+    rs::core::compression::zstd_codec encode_codec(rs::record::compression_level::medium);
+    rs::core::compression::zstd_codec decode_codec;
+    auto info = codec_tests_util::make_frame_info(codec_tests_util::width, codec_tests_util::height, rs_format::RS_FORMAT_Y8, 1, rs_stream::RS_STREAM_INFRARED);
+    codec_tests_util::check_round_trip(encode_codec, decode_codec, info, 2, 0);
+}
+#endif
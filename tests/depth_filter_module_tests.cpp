@@ -0,0 +1,105 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "rs_sdk.h"
+#include "rs/cv_modules/depth_filter_module/depth_filter_module.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+using namespace rs::cv_modules;
+
+namespace
+{
+    const int WIDTH = 64, HEIGHT = 48;
+
+    //a depth step at the middle column, with a hole at (hole_x, hole_y)
+    vector<uint16_t> create_depth_data(int hole_x, int hole_y)
+    {
+        vector<uint16_t> data(WIDTH * HEIGHT);
+        for(int y = 0; y < HEIGHT; y++)
+            for(int x = 0; x < WIDTH; x++)
+                data[y * WIDTH + x] = x < WIDTH / 2 ? 1000 : 3000;
+        if(hole_x >= 0)
+            data[hole_y * WIDTH + hole_x] = 0;
+        return data;
+    }
+
+    rs::utils::unique_ptr<image_interface> filter(depth_filter_module & module, vector<uint16_t> & data, uint64_t frame_number)
+    {
+        image_info info = { WIDTH, HEIGHT, pixel_format::z16, WIDTH * 2 };
+        auto depth_image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, {data.data(), nullptr},
+                               stream_type::depth, image_interface::flag::any, static_cast<double>(frame_number), frame_number));
+        correlated_sample_set sample_set = {};
+        sample_set[stream_type::depth] = depth_image.get();
+        EXPECT_EQ(status_no_error, module.process_sample_set(sample_set));
+        return get_unique_ptr_with_releaser(module.query_filtered_depth_image());
+    }
+}
+
+GTEST_TEST(depth_filter_module_tests, spatial_filter_keeps_edges_and_holes)
+{
+    depth_filter_module module;
+    EXPECT_EQ(nullptr, module.query_filtered_depth_image());
+    auto options = module.query_options();
+    options.temporal_filter = false;
+    ASSERT_EQ(status_no_error, module.set_options(options));
+
+    auto data = create_depth_data(10, 10);
+    auto filtered = filter(module, data, 1);
+    ASSERT_NE(nullptr, filtered);
+    EXPECT_EQ(1u, filtered->query_frame_number());
+    EXPECT_EQ(pixel_format::z16, filtered->query_info().format);
+    const uint16_t * filtered_data = static_cast<const uint16_t *>(filtered->query_data());
+    for(int x = 0; x < WIDTH; x++)
+        EXPECT_EQ(x < WIDTH / 2 ? 1000 : 3000, filtered_data[20 * WIDTH + x]);
+    EXPECT_EQ(0, filtered_data[10 * WIDTH + 10]);
+
+    options.hole_filling = true;
+    ASSERT_EQ(status_no_error, module.set_options(options));
+    filtered = filter(module, data, 2);
+    EXPECT_EQ(1000, static_cast<const uint16_t *>(filtered->query_data())[10 * WIDTH + 10]);
+}
+
+GTEST_TEST(depth_filter_module_tests, temporal_filter_persists_valid_pixels)
+{
+    depth_filter_module module;
+    auto options = module.query_options();
+    options.spatial_filter = false;
+    options.persistence_frames = 2;
+    ASSERT_EQ(status_no_error, module.set_options(options));
+
+    auto data = create_depth_data(-1, -1);
+    filter(module, data, 1);
+    filter(module, data, 2);
+    auto holed_data = create_depth_data(40, 5);
+    auto filtered = filter(module, holed_data, 3);
+    ASSERT_NE(nullptr, filtered);
+    EXPECT_EQ(3000, static_cast<const uint16_t *>(filtered->query_data())[5 * WIDTH + 40]);
+}
+
+GTEST_TEST(depth_filter_module_tests, decimation_and_options)
+{
+    depth_filter_module module;
+    auto options = module.query_options();
+    options.decimation_factor = 4;
+    ASSERT_EQ(status_no_error, module.set_options(options));
+
+    auto data = create_depth_data(-1, -1);
+    auto filtered = filter(module, data, 1);
+    ASSERT_NE(nullptr, filtered);
+    EXPECT_EQ(WIDTH / 4, filtered->query_info().width);
+    EXPECT_EQ(HEIGHT / 4, filtered->query_info().height);
+
+    options.decimation_factor = 3;
+    EXPECT_EQ(status_param_unsupported, module.set_options(options));
+    options = depth_filter_output_interface::query_default_options();
+    options.spatial_alpha = 0;
+    EXPECT_EQ(status_param_unsupported, module.set_options(options));
+    options = depth_filter_output_interface::query_default_options();
+    options.persistence_frames = 9;
+    EXPECT_EQ(status_param_unsupported, module.set_options(options));
+    EXPECT_EQ(4u, module.query_options().decimation_factor);
+}
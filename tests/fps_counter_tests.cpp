@@ -2,6 +2,8 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "file_types.h"
@@ -100,3 +102,36 @@ TEST_F(fps_counter_tests, comparison_fps)
     ASSERT_NEAR(average_current_diff, 0, fps_tests_setup::threshold);
 }
 
+
+TEST(fps_counter_statistics_tests, intervals_statistics_and_concurrent_ticks)
+{
+    //a 100 fps stream, with a 40 milliseconds gap which misses 3 frames
+    fps_counter _fps_counter(100);
+    EXPECT_EQ(0u, _fps_counter.query_interval_statistics().intervals_count);
+    for(int frame = 0; frame < 46; frame++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(frame == 30 ? 40 : 10));
+        _fps_counter.tick();
+    }
+    auto statistics = _fps_counter.query_interval_statistics();
+    //the first 5 ticks are skipped
+    EXPECT_EQ(40u, statistics.intervals_count);
+    EXPECT_GE(statistics.median_interval_ms, 8.);
+    EXPECT_LT(statistics.median_interval_ms, 16.);
+    EXPECT_GE(statistics.max_interval_ms, 40.);
+    EXPECT_GE(statistics.max_jitter_ms, 30.);
+    EXPECT_GE(statistics.dropped_frames_count, 3u);
+
+    fps_counter concurrent_fps_counter(60);
+    std::vector<std::thread> ticking_threads;
+    for(int thread = 0; thread < 4; thread++)
+    {
+        ticking_threads.emplace_back([&concurrent_fps_counter]() { for(int frame = 0; frame < 1000; frame++) concurrent_fps_counter.tick(); });
+    }
+    for(auto & ticking_thread : ticking_threads)
+    {
+        ticking_thread.join();
+    }
+    EXPECT_EQ(4000u - 5 - 1, concurrent_fps_counter.query_interval_statistics().intervals_count);
+    EXPECT_GT(concurrent_fps_counter.total_average_fps(), 0.);
+}
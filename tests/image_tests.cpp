@@ -4,10 +4,17 @@
 #include <limits.h>
 #include <iostream>
 #include <memory>
+#include <vector>
+#include <cstring>
+#include <functional>
 #include "gtest/gtest.h"
 #include "utilities/utilities.h"
 #include "librealsense/rs.hpp"
 #include "rs/utils/librealsense_conversion_utils.h"
+#include "rs/utils/self_releasing_array_data_releaser.h"
+#include "rs/utils/image_statistics.h"
+#include "rs/utils/ref_count_base.h"
+#include "rs/core/frame_allocator_interface.h"
 #include "viewer.h"
 #include <chrono>
 
@@ -305,3 +312,616 @@ GTEST_TEST(image_api, image_metadata_test)
         EXPECT_TRUE(streamReceived.second) << "No callbacks received during the test for stream type " << stream_type_to_string((rs::stream)streamReceived.first);
     }
 }
+
+GTEST_TEST(image_api, metadata_view_reflects_the_added_metadata)
+{
+    image_info info = { 4, 4, pixel_format::y8, 4 };
+    std::vector<uint8_t> data(info.pitch * info.height);
+    auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, {data.data(), nullptr},
+                     stream_type::fisheye, image_interface::flag::any, 1.0, 1));
+    const metadata_view * view = image->query_metadata_view();
+    ASSERT_NE(nullptr, view);
+    EXPECT_FALSE(view->is_valid(metadata_type::actual_exposure));
+
+    const double exposure = 16.5;
+    const uint32_t custom = 7;
+    ASSERT_EQ(status_no_error, image->query_metadata()->add_metadata(metadata_type::actual_exposure, reinterpret_cast<const uint8_t *>(&exposure), sizeof(exposure)));
+    ASSERT_EQ(status_no_error, image->query_metadata()->add_metadata(metadata_type::custom, reinterpret_cast<const uint8_t *>(&custom), sizeof(custom)));
+    EXPECT_TRUE(view->is_valid(metadata_type::actual_exposure));
+    EXPECT_EQ(exposure, view->actual_exposure);
+    EXPECT_FALSE(view->is_valid(metadata_type::actual_fps));
+    EXPECT_FALSE(view->is_valid(metadata_type::custom));
+
+    ASSERT_EQ(status_no_error, image->query_metadata()->remove_metadata(metadata_type::actual_exposure));
+    EXPECT_FALSE(view->is_valid(metadata_type::actual_exposure));
+}
+
+GTEST_TEST(image_api, image_view_holds_data_owner)
+{
+    const int width = 64, height = 48;
+    image_info info = { width, height, pixel_format::y8, width };
+    uint8_t * data = new uint8_t[width * height];
+    for(int i = 0; i < width * height; i++)
+        data[i] = static_cast<uint8_t>(i / width);
+
+    auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info,
+                     {data, new self_releasing_array_data_releaser(data)}, stream_type::infrared, image_interface::flag::any, 1.0, 1));
+
+    //a view of the bottom half of the image, pointing into the image data
+    image_info view_info = { width, height / 2, pixel_format::y8, info.pitch };
+    const uint8_t * view_data = static_cast<const uint8_t *>(image->query_data()) + (height / 2) * info.pitch;
+    auto view = get_unique_ptr_with_releaser(image_interface::create_instance_view(&view_info, view_data, image.get(),
+                    stream_type::infrared, image_interface::flag::any, 1.0, 1));
+    EXPECT_EQ(2, image->ref_count());
+    EXPECT_EQ(view_data, view->query_data());
+
+    //the view keeps the data alive after the image owner released it
+    image.reset();
+    for(int y = 0; y < view_info.height; y++)
+        EXPECT_EQ(static_cast<uint8_t>(y + height / 2), static_cast<const uint8_t *>(view->query_data())[y * view_info.pitch]);
+
+    const image_interface * converted = nullptr;
+    ASSERT_EQ(status_no_error, view->convert_to(pixel_format::rgb8, &converted));
+    auto converted_image = get_unique_ptr_with_releaser(converted);
+    EXPECT_EQ(view_info.height, converted_image->query_info().height);
+}
+
+GTEST_TEST(image_api, convert_padded_color_images)
+{
+    const int width = 33, height = 7, padding = 5;
+    image_info rgb_info = { width, height, pixel_format::rgb8, width * 3 + padding };
+    std::vector<uint8_t> rgb_data(rgb_info.pitch * height);
+    for(int y = 0; y < height; y++)
+        for(int x = 0; x < width; x++)
+        {
+            uint8_t * pixel = &rgb_data[y * rgb_info.pitch + x * 3];
+            pixel[0] = static_cast<uint8_t>(x);
+            pixel[1] = static_cast<uint8_t>(y);
+            pixel[2] = static_cast<uint8_t>(x + y);
+        }
+    auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&rgb_info, {rgb_data.data(), nullptr},
+                     stream_type::color, image_interface::flag::any, 1.0, 1));
+
+    const image_interface * converted = nullptr;
+    ASSERT_EQ(status_no_error, image->convert_to(pixel_format::bgra8, &converted));
+    auto bgra = get_unique_ptr_with_releaser(converted);
+    image_info bgra_info = bgra->query_info();
+    ASSERT_EQ(width * 4, bgra_info.pitch);
+    const uint8_t * bgra_data = static_cast<const uint8_t *>(bgra->query_data());
+    for(int y = 0; y < height; y++)
+        for(int x = 0; x < width; x++)
+        {
+            const uint8_t * pixel = &bgra_data[y * bgra_info.pitch + x * 4];
+            EXPECT_EQ(static_cast<uint8_t>(x + y), pixel[0]);
+            EXPECT_EQ(static_cast<uint8_t>(y), pixel[1]);
+            EXPECT_EQ(static_cast<uint8_t>(x), pixel[2]);
+            EXPECT_EQ(255, pixel[3]);
+        }
+
+    EXPECT_EQ(status_param_unsupported, image->convert_to(pixel_format::rgb8, &converted));
+    EXPECT_EQ(status_param_unsupported, image->convert_to(pixel_format::z16, &converted));
+}
+
+GTEST_TEST(image_api, row_alignment_pads_the_created_images_pitch)
+{
+    EXPECT_EQ(status_invalid_argument, image_interface::set_row_alignment(0));
+    EXPECT_EQ(status_invalid_argument, image_interface::set_row_alignment(48));
+    EXPECT_EQ(status_invalid_argument, image_interface::set_row_alignment(128));
+    EXPECT_EQ(1u, image_interface::query_row_alignment());
+
+    const int width = 37, height = 9;
+    image_info info = { width, height, pixel_format::y8, width };
+    std::vector<uint8_t> data(info.pitch * height);
+    for(size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<uint8_t>(i * 7);
+    auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, {data.data(), nullptr},
+                     stream_type::color, image_interface::flag::any, 1.0, 1));
+
+    ASSERT_EQ(status_no_error, image_interface::set_row_alignment(64));
+    EXPECT_EQ(64, image_interface::query_aligned_pitch(width));
+    EXPECT_EQ(128, image_interface::query_aligned_pitch(65));
+
+    const image_interface * converted = nullptr;
+    ASSERT_EQ(status_no_error, image->convert_to(pixel_format::bgr8, &converted));
+    auto bgr = get_unique_ptr_with_releaser(converted);
+    const image_interface * rotated = nullptr;
+    ASSERT_EQ(status_no_error, image->convert_to(rotation::rotation_90_degree, &rotated));
+    auto rotated_image = get_unique_ptr_with_releaser(rotated);
+    image_interface::set_row_alignment(1);
+
+    //every row starts on a 64 bytes boundary, and the rows hold the same pixels as the tight rows
+    image_info bgr_info = bgr->query_info();
+    EXPECT_EQ(128, bgr_info.pitch);
+    EXPECT_EQ(64, rotated_image->query_info().pitch);
+    const uint8_t * bgr_data = static_cast<const uint8_t *>(bgr->query_data());
+    const uint8_t * rotated_data = static_cast<const uint8_t *>(rotated_image->query_data());
+    for(int y = 0; y < height; y++)
+    {
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(bgr_data + y * bgr_info.pitch) % 64);
+        for(int x = 0; x < width; x++)
+        {
+            EXPECT_EQ(data[y * width + x], bgr_data[y * bgr_info.pitch + x * 3]);
+            EXPECT_EQ(data[(height - 1 - y) * width + x], rotated_data[x * 64 + y]);
+        }
+    }
+}
+
+GTEST_TEST(image_api, conversion_cache_limit)
+{
+    const int width = 64, height = 48;
+    image_info info = { width, height, pixel_format::y8, width };
+    std::vector<uint8_t> data(info.pitch * height, 128);
+    const size_t cached_bytes_before = image_interface::query_conversion_cache_bytes();
+    {
+        auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, {data.data(), nullptr},
+                         stream_type::infrared, image_interface::flag::any, 1.0, 1));
+
+        //a cached conversion is returned again
+        const image_interface * first = nullptr, * second = nullptr;
+        ASSERT_EQ(status_no_error, image->convert_to(pixel_format::rgb8, &first));
+        ASSERT_EQ(status_no_error, image->convert_to(pixel_format::rgb8, &second));
+        EXPECT_EQ(first, second);
+        EXPECT_LT(cached_bytes_before, image_interface::query_conversion_cache_bytes());
+        first->release();
+        second->release();
+
+        //without room in the cache, the conversion is returned uncached and the cache is emptied
+        image_interface::set_conversion_cache_limit(0);
+        ASSERT_EQ(status_no_error, image->convert_to(pixel_format::bgra8, &first));
+        ASSERT_EQ(status_no_error, image->convert_to(pixel_format::bgra8, &second));
+        EXPECT_NE(first, second);
+        EXPECT_EQ(1, first->ref_count());
+        EXPECT_EQ(cached_bytes_before, image_interface::query_conversion_cache_bytes());
+        first->release();
+        second->release();
+        image_interface::set_conversion_cache_limit(256 << 20);
+
+        ASSERT_EQ(status_no_error, image->convert_to(pixel_format::rgba8, &first));
+        first->release();
+    }
+    //released images release their cached conversions
+    EXPECT_EQ(cached_bytes_before, image_interface::query_conversion_cache_bytes());
+}
+
+GTEST_TEST(image_api, converted_images_convert_the_queried_rows)
+{
+    const int width = 64, height = 48;
+    image_info info = { width, height, pixel_format::y8, width };
+    std::vector<uint8_t> data(info.pitch * height);
+    for(size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<uint8_t>(i * 7);
+    auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, {data.data(), nullptr},
+                     stream_type::infrared, image_interface::flag::any, 1.0, 1));
+
+    //the info of the converted image is set before its data is converted
+    const image_interface * converted = nullptr;
+    ASSERT_EQ(status_no_error, image->convert_to(pixel_format::rgb8, &converted));
+    auto rgb = get_unique_ptr_with_releaser(converted);
+    EXPECT_EQ(pixel_format::rgb8, rgb->query_info().format);
+    EXPECT_EQ(height, rgb->query_info().height);
+    EXPECT_EQ(1u, rgb->query_frame_number());
+    EXPECT_EQ(nullptr, rgb->query_data_rows(height - 1, 2));
+
+    //the queried rows are converted, then the rest of the rows on the first full query
+    const int32_t pitch = rgb->query_info().pitch;
+    const uint8_t * rows = static_cast<const uint8_t *>(rgb->query_data_rows(10, 2));
+    ASSERT_NE(nullptr, rows);
+    EXPECT_EQ(data[10 * width + 5], rows[10 * pitch + 5 * 3]);
+    EXPECT_EQ(data[11 * width + 5], rows[11 * pitch + 5 * 3 + 2]);
+    const uint8_t * rgb_data = static_cast<const uint8_t *>(rgb->query_data());
+    EXPECT_EQ(rows, rgb_data);
+    for(int y = 0; y < height; y++)
+        for(int x = 0; x < width; x++)
+            ASSERT_EQ(data[y * width + x], rgb_data[y * pitch + x * 3 + 1]);
+
+    //the converted image stays cached after its source was released by the conversion
+    ASSERT_EQ(status_no_error, image->convert_to(pixel_format::rgb8, &converted));
+    EXPECT_EQ(rgb.get(), converted);
+    converted->release();
+}
+
+GTEST_TEST(image_api, rotate_images)
+{
+    const int width = 37, height = 70;
+    image_info info = { width, height, pixel_format::z16, width * 2 + 6 };
+    std::vector<uint8_t> data(info.pitch * height);
+    auto pixel_at = [&](int x, int y) { return reinterpret_cast<const uint16_t *>(&data[y * info.pitch])[x]; };
+    for(int y = 0; y < height; y++)
+        for(int x = 0; x < width; x++)
+            reinterpret_cast<uint16_t *>(&data[y * info.pitch])[x] = static_cast<uint16_t>(y * width + x);
+    auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, {data.data(), nullptr},
+                     stream_type::depth, image_interface::flag::any, 1.0, 1));
+
+    struct expected_rotation
+    {
+        rotation rotation_value;
+        int width, height;
+        std::function<uint16_t(int, int)> source_pixel;
+    };
+    std::vector<expected_rotation> rotations =
+    {
+        { rotation::rotation_90_degree,  height, width, [&](int x, int y) { return pixel_at(y, height - 1 - x); } },
+        { rotation::rotation_180_degree, width, height, [&](int x, int y) { return pixel_at(width - 1 - x, height - 1 - y); } },
+        { rotation::rotation_270_degree, height, width, [&](int x, int y) { return pixel_at(width - 1 - y, x); } }
+    };
+    for(auto & expected : rotations)
+    {
+        const image_interface * rotated = nullptr, * cached = nullptr;
+        ASSERT_EQ(status_no_error, image->convert_to(expected.rotation_value, &rotated));
+        auto rotated_image = get_unique_ptr_with_releaser(rotated);
+        image_info rotated_info = rotated->query_info();
+        ASSERT_EQ(expected.width, rotated_info.width);
+        ASSERT_EQ(expected.height, rotated_info.height);
+        EXPECT_EQ(pixel_format::z16, rotated_info.format);
+        for(int y = 0; y < rotated_info.height; y++)
+            for(int x = 0; x < rotated_info.width; x++)
+                ASSERT_EQ(expected.source_pixel(x, y), reinterpret_cast<const uint16_t *>(
+                              static_cast<const uint8_t *>(rotated->query_data()) + y * rotated_info.pitch)[x]) << x << "," << y;
+
+        ASSERT_EQ(status_no_error, image->convert_to(expected.rotation_value, &cached));
+        EXPECT_EQ(rotated, cached);
+        cached->release();
+    }
+
+    const image_interface * same = nullptr;
+    ASSERT_EQ(status_no_error, image->convert_to(rotation::rotation_0_degree, &same));
+    EXPECT_EQ(image.get(), same);
+    same->release();
+
+    image_info yuyv_info = { 4, 2, pixel_format::yuyv, 8 };
+    auto yuyv = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&yuyv_info, {data.data(), nullptr},
+                    stream_type::color, image_interface::flag::any, 1.0, 1));
+    EXPECT_EQ(status_param_unsupported, yuyv->convert_to(rotation::rotation_90_degree, &same));
+}
+
+GTEST_TEST(image_api, image_pyramid_levels)
+{
+    const int width = 64, height = 48;
+    image_info info = { width, height, pixel_format::z16, width * 2 };
+    std::vector<uint16_t> data(width * height);
+    //the left half is at 1000, the right half at 2000 with holes in every other row
+    for(int y = 0; y < height; y++)
+        for(int x = 0; x < width; x++)
+            data[y * width + x] = x < width / 2 ? 1000 : (y % 2 ? 0 : 2000);
+    auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, {data.data(), nullptr},
+                     stream_type::depth, image_interface::flag::any, 1.0, 1));
+
+    const image_interface * downscaled = nullptr;
+    ASSERT_EQ(status_no_error, image->query_pyramid_level(2, &downscaled));
+    auto quarter = get_unique_ptr_with_releaser(downscaled);
+    EXPECT_EQ(width / 4, quarter->query_info().width);
+    EXPECT_EQ(height / 4, quarter->query_info().height);
+    EXPECT_EQ(width / 2, quarter->query_info().pitch);
+    EXPECT_EQ(pixel_format::z16, quarter->query_info().format);
+    EXPECT_EQ(1u, quarter->query_frame_number());
+
+    //the depth levels take a depth of the block rather than a mean across the edge or with the holes
+    const uint16_t * quarter_data = static_cast<const uint16_t *>(quarter->query_data());
+    for(int x = 0; x < width / 4; x++)
+        EXPECT_EQ(x < width / 8 ? 1000 : 2000, quarter_data[x]);
+
+    //the levels are cached, the previous level was computed on the way
+    ASSERT_EQ(status_no_error, image->query_pyramid_level(2, &downscaled));
+    EXPECT_EQ(quarter.get(), downscaled);
+    downscaled->release();
+    ASSERT_EQ(status_no_error, image->query_pyramid_level(1, &downscaled));
+    auto half = get_unique_ptr_with_releaser(downscaled);
+    EXPECT_EQ(width / 2, half->query_info().width);
+
+    EXPECT_EQ(status_param_unsupported, image->query_pyramid_level(0, &downscaled));
+    EXPECT_EQ(status_param_unsupported, image->query_pyramid_level(image_interface::MAX_PYRAMID_LEVEL + 1, &downscaled));
+
+    //the other formats take the mean of each block
+    image_info y8_info = { 4, 2, pixel_format::y8, 4 };
+    std::vector<uint8_t> y8_data = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    auto y8_image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&y8_info, {y8_data.data(), nullptr},
+                        stream_type::infrared, image_interface::flag::any, 1.0, 1));
+    ASSERT_EQ(status_no_error, y8_image->query_pyramid_level(1, &downscaled));
+    auto y8_half = get_unique_ptr_with_releaser(downscaled);
+    EXPECT_EQ(4, static_cast<const uint8_t *>(y8_half->query_data())[0]);
+    EXPECT_EQ(6, static_cast<const uint8_t *>(y8_half->query_data())[1]);
+    EXPECT_EQ(status_param_unsupported, y8_image->query_pyramid_level(2, &downscaled));
+}
+
+GTEST_TEST(image_api, fused_image_transform)
+{
+    const int width = 40, height = 30;
+    image_info info = { width, height, pixel_format::rgb8, width * 3 };
+    std::vector<uint8_t> data(info.pitch * height);
+    for(size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<uint8_t>(i * 7);
+    auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, {data.data(), nullptr},
+                     stream_type::color, image_interface::flag::any, 1.0, 1));
+
+    //the fused transform matches a rotation followed by a conversion
+    const image_interface * converted = nullptr;
+    ASSERT_EQ(status_no_error, image->convert_to(rotation::rotation_90_degree, &converted));
+    //the rotated image is converted again, which needs a non const handle
+    auto rotated = get_unique_ptr_with_releaser(const_cast<image_interface *>(converted));
+    ASSERT_EQ(status_no_error, rotated->convert_to(pixel_format::bgra8, &converted));
+    auto expected = get_unique_ptr_with_releaser(converted);
+
+    image_interface::image_transform parameters = { pixel_format::bgra8, rotation::rotation_90_degree, { 0, 0, 0, 0 }, { 0, 0 } };
+    ASSERT_EQ(status_no_error, image->transform(parameters, &converted));
+    auto transformed = get_unique_ptr_with_releaser(converted);
+    ASSERT_EQ(expected->query_info().width, transformed->query_info().width);
+    ASSERT_EQ(expected->query_info().pitch, transformed->query_info().pitch);
+    EXPECT_EQ(0, memcmp(expected->query_data(), transformed->query_data(), expected->query_info().pitch * expected->query_info().height));
+
+    //a conversion of the whole image is the cached conversion
+    parameters.rotation = rotation::rotation_0_degree;
+    ASSERT_EQ(status_no_error, image->transform(parameters, &converted));
+    auto cached = get_unique_ptr_with_releaser(converted);
+    ASSERT_EQ(status_no_error, image->convert_to(pixel_format::bgra8, &converted));
+    EXPECT_EQ(cached.get(), converted);
+    converted->release();
+
+    //the crop is sampled to the destination size by the nearest pixels
+    parameters = { pixel_format::any, rotation::rotation_180_degree, { 10, 4, 20, 10 }, { 10, 5 } };
+    ASSERT_EQ(status_no_error, image->transform(parameters, &converted));
+    auto resized = get_unique_ptr_with_releaser(converted);
+    EXPECT_EQ(10, resized->query_info().width);
+    EXPECT_EQ(5, resized->query_info().height);
+    EXPECT_EQ(pixel_format::rgb8, resized->query_info().format);
+    //the first destination pixel samples the crop pixel (1, 1) counted from the crop end, the image pixel (28, 12)
+    EXPECT_EQ(0, memcmp(resized->query_data(), &data[(12 * width + 28) * 3], 3));
+
+    parameters = { pixel_format::any, rotation::rotation_0_degree, { width, 0, 10, 10 }, { 0, 0 } };
+    EXPECT_EQ(status_param_unsupported, image->transform(parameters, &converted));
+    parameters = { pixel_format::z16, rotation::rotation_0_degree, { 0, 0, 0, 0 }, { 0, 0 } };
+    EXPECT_EQ(status_param_unsupported, image->transform(parameters, &converted));
+    parameters = { pixel_format::any, rotation::rotation_0_degree, { 0, 0, 0, 0 }, { -1, 2 } };
+    EXPECT_EQ(status_invalid_argument, image->transform(parameters, &converted));
+}
+
+GTEST_TEST(image_api, image_statistics)
+{
+    //a padded z16 image, large enough to be processed in parallel bands
+    const int width = 1021, height = 613, pitch = 2 * width + 6;
+    std::vector<uint8_t> data(pitch * height, 0xff);
+    auto pixel = [&](int x, int y) -> uint16_t & { return reinterpret_cast<uint16_t *>(data.data() + y * pitch)[x]; };
+    for(int y = 0; y < height; y++)
+        for(int x = 0; x < width; x++)
+            pixel(x, y) = (x + y) % 5 == 0 ? 0 : static_cast<uint16_t>(100 + (x * 7 + y) % 1000);
+    pixel(width - 1, height - 1) = 65000;
+    pixel(3, 2) = 1;
+
+    image_info info = { width, height, pixel_format::z16, pitch };
+    rs::utils::image_statistics::statistics stats = {};
+    ASSERT_EQ(status_no_error, rs::utils::image_statistics::query_statistics(info, data.data(), {}, stats));
+    uint64_t expected_sum = 0, expected_valid = 0;
+    for(int y = 0; y < height; y++)
+        for(int x = 0; x < width; x++)
+        {
+            expected_sum += pixel(x, y);
+            expected_valid += pixel(x, y) != 0;
+        }
+    EXPECT_EQ(1, stats.min_value);
+    EXPECT_EQ(65000, stats.max_value);
+    EXPECT_EQ(expected_sum, stats.sum);
+    EXPECT_EQ(static_cast<uint64_t>(width * height), stats.pixels_count);
+    EXPECT_EQ(expected_valid, stats.valid_pixels_count);
+    EXPECT_DOUBLE_EQ(static_cast<double>(expected_sum) / static_cast<double>(expected_valid), stats.mean());
+
+    //the roi is clamped to the image, the padding bytes aren't read
+    ASSERT_EQ(status_no_error, rs::utils::image_statistics::query_statistics(info, data.data(), { 10, 10, 5000, 5000 }, stats));
+    EXPECT_EQ(65000, stats.max_value);
+    EXPECT_EQ(static_cast<uint64_t>((width - 10) * (height - 10)), stats.pixels_count);
+    ASSERT_EQ(status_no_error, rs::utils::image_statistics::query_statistics(info, data.data(), { 0, 0, 5, 5 }, stats));
+    EXPECT_EQ(1, stats.min_value);
+
+    std::vector<uint32_t> bins(16);
+    ASSERT_EQ(status_no_error, rs::utils::image_statistics::query_histogram(info, data.data(), {}, bins.data(), static_cast<uint32_t>(bins.size())));
+    EXPECT_EQ(1u, bins[15]);
+    EXPECT_EQ(static_cast<uint32_t>(width * height - 1), bins[0]);
+
+    image_info y8_info = { 4, 1, pixel_format::y8, 4 };
+    uint8_t y8_data[] = { 0, 10, 200, 255 };
+    ASSERT_EQ(status_no_error, rs::utils::image_statistics::query_histogram(y8_info, y8_data, {}, bins.data(), 2));
+    EXPECT_EQ(2u, bins[0]);
+    EXPECT_EQ(2u, bins[1]);
+    ASSERT_EQ(status_no_error, rs::utils::image_statistics::query_statistics(y8_info, y8_data, {}, stats));
+    EXPECT_EQ(10, stats.min_value);
+    EXPECT_EQ(255, stats.max_value);
+    EXPECT_EQ(3u, stats.valid_pixels_count);
+
+    image_info rgb_info = { 4, 1, pixel_format::rgb8, 12 };
+    EXPECT_EQ(status_param_unsupported, rs::utils::image_statistics::query_statistics(rgb_info, data.data(), {}, stats));
+    EXPECT_EQ(status_invalid_argument, rs::utils::image_statistics::query_histogram(y8_info, y8_data, {}, bins.data(), 257));
+}
+
+GTEST_TEST(image_api, builtin_frame_allocators)
+{
+    const frame_allocator_interface::builtin allocators[] = { frame_allocator_interface::builtin::heap,
+                                                              frame_allocator_interface::builtin::size_class_pool,
+                                                              frame_allocator_interface::builtin::huge_pages,
+                                                              frame_allocator_interface::builtin::numa_local,
+                                                              frame_allocator_interface::builtin::pinned };
+    const size_t size = 640 * 480 * 2 + 3;
+    for(auto type : allocators)
+    {
+        auto allocator = frame_allocator_interface::get_builtin(type);
+        ASSERT_NE(nullptr, allocator);
+        auto data = static_cast<uint8_t *>(allocator->allocate(size));
+        ASSERT_NE(nullptr, data);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(data) % 64);
+        memset(data, 0xab, size);
+        EXPECT_EQ(0xab, data[size - 1]);
+        allocator->deallocate(data, size);
+    }
+}
+
+GTEST_TEST(image_api, converted_images_use_the_process_frame_allocator)
+{
+    //counts the live buffers, and allocates them from the heap. The conversion pool keeps the freed buffers, which are freed
+    //by the allocator they were allocated with, so the allocator lives as long as the process
+    class counting_allocator : public frame_allocator_interface
+    {
+    public:
+        int live_buffers = 0;
+        void * allocate(size_t size) override
+        {
+            live_buffers++;
+            return frame_allocator_interface::get_builtin(builtin::heap)->allocate(size);
+        }
+        void deallocate(void * data, size_t size) override
+        {
+            live_buffers--;
+            frame_allocator_interface::get_builtin(builtin::heap)->deallocate(data, size);
+        }
+    };
+    static counting_allocator allocator;
+    frame_allocator_interface::set_process_allocator(&allocator);
+
+    const int width = 1001, height = 13;
+    image_info rgb_info = { width, height, pixel_format::rgb8, width * 3 };
+    std::vector<uint8_t> rgb_data(rgb_info.pitch * height, 7);
+    {
+        auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&rgb_info, {rgb_data.data(), nullptr},
+                         stream_type::color, image_interface::flag::any, 1.0, 1));
+        const image_interface * converted = nullptr;
+        ASSERT_EQ(status_no_error, image->convert_to(pixel_format::bgra8, &converted));
+        auto bgra = get_unique_ptr_with_releaser(converted);
+        EXPECT_EQ(7, static_cast<const uint8_t *>(bgra->query_data())[0]);
+        EXPECT_LE(1, allocator.live_buffers);
+    }
+    frame_allocator_interface::set_process_allocator(nullptr);
+    EXPECT_EQ(frame_allocator_interface::get_builtin(frame_allocator_interface::builtin::heap), frame_allocator_interface::get_process_allocator());
+}
+
+GTEST_TEST(image_api, device_buffer_images_copy_to_host_once_and_share_their_uploads)
+{
+    //a device buffer over host memory, which counts the copies to the host
+    class counting_device_buffer : public ref_count_base<device_buffer_interface>
+    {
+    public:
+        counting_device_buffer(device_api api, int32_t pitch, int32_t height) : api(api), pitch(pitch), data(pitch * height) {}
+        device_api query_api() const override { return api; }
+        uint64_t query_handle() const override { return reinterpret_cast<uintptr_t>(data.data()); }
+        void * query_context() const override { return nullptr; }
+        int32_t query_pitch() const override { return pitch; }
+        status download(int32_t height, int32_t row_size, void * host_data, int32_t host_pitch) const override
+        {
+            downloads++;
+            for(int32_t y = 0; y < height; y++)
+            {
+                memcpy(static_cast<uint8_t *>(host_data) + y * host_pitch, data.data() + y * pitch, row_size);
+            }
+            return status_no_error;
+        }
+        device_api api;
+        int32_t pitch;
+        std::vector<uint8_t> data;
+        mutable int downloads = 0;
+    };
+
+    const int width = 33, height = 5;
+    auto buffer = get_unique_ptr_with_releaser(new counting_device_buffer(device_api::cuda, 128, height));
+    for(int y = 0; y < height; y++)
+    {
+        memset(buffer->data.data() + y * buffer->pitch, y + 1, width * 2);
+    }
+
+    image_info info = { width, height, pixel_format::z16, width * 2 };
+    {
+        auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_device_buffer(&info, buffer.get(), stream_type::depth,
+                                                                                                     image_interface::flag::any, 1.0, 1));
+        ASSERT_NE(nullptr, image);
+        EXPECT_EQ(2, buffer->ref_count());
+        EXPECT_EQ(buffer.get(), image->query_device_buffer(device_api::cuda));
+        EXPECT_EQ(nullptr, image->query_device_buffer(device_api::opencl));
+        EXPECT_EQ(0, buffer->downloads);
+
+        auto host_data = static_cast<const uint8_t *>(image->query_data());
+        ASSERT_NE(nullptr, host_data);
+        EXPECT_EQ(host_data, image->query_data());
+        EXPECT_EQ(1, buffer->downloads);
+        EXPECT_EQ(1, host_data[0]);
+        EXPECT_EQ(5, host_data[(height - 1) * info.pitch + info.pitch - 1]);
+    }
+    EXPECT_EQ(1, buffer->ref_count());
+
+    //the first module which uploads a host image attaches its upload for the next modules
+    std::vector<uint8_t> host_data(info.pitch * height);
+    auto host_image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, {host_data.data(), nullptr}, stream_type::depth,
+                                                                                                image_interface::flag::any, 1.0, 1));
+    auto other_upload = get_unique_ptr_with_releaser(new counting_device_buffer(device_api::cuda, 128, height));
+    EXPECT_EQ(nullptr, host_image->query_device_buffer(device_api::cuda));
+    EXPECT_EQ(status_no_error, host_image->attach_device_buffer(buffer.get()));
+    EXPECT_EQ(status_key_already_exists, host_image->attach_device_buffer(other_upload.get()));
+    EXPECT_EQ(buffer.get(), host_image->query_device_buffer(device_api::cuda));
+    EXPECT_EQ(2, buffer->ref_count());
+    EXPECT_EQ(1, other_upload->ref_count());
+    host_image.reset();
+    EXPECT_EQ(1, buffer->ref_count());
+}
+
+GTEST_TEST(image_api, attachments_are_shared_by_their_owner_and_id)
+{
+    class product : public ref_count_base<ref_count_interface> {};
+
+    const int width = 4, height = 2;
+    image_info info = { width, height, pixel_format::y8, width };
+    std::vector<uint8_t> data(info.pitch * height);
+    auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, {data.data(), nullptr}, stream_type::depth,
+                                                                                          image_interface::flag::any, 1.0, 1));
+    auto first = get_unique_ptr_with_releaser(new product());
+    auto second = get_unique_ptr_with_releaser(new product());
+    int owner = 0, other_owner = 0;
+
+    //the first user which attaches a product for a key shares it with the next users of the image
+    EXPECT_EQ(nullptr, image->query_attachment(&owner, 0));
+    EXPECT_EQ(status_handle_invalid, image->attach(&owner, 0, nullptr));
+    EXPECT_EQ(status_no_error, image->attach(&owner, 0, first.get()));
+    EXPECT_EQ(status_key_already_exists, image->attach(&owner, 0, second.get()));
+    EXPECT_EQ(first.get(), image->query_attachment(&owner, 0));
+    EXPECT_EQ(nullptr, image->query_attachment(&owner, 1));
+    EXPECT_EQ(nullptr, image->query_attachment(&other_owner, 0));
+    EXPECT_EQ(status_no_error, image->attach(&other_owner, 0, second.get()));
+    EXPECT_EQ(second.get(), image->query_attachment(&other_owner, 0));
+    EXPECT_EQ(2, first->ref_count());
+    EXPECT_EQ(2, second->ref_count());
+
+    image.reset();
+    EXPECT_EQ(1, first->ref_count());
+    EXPECT_EQ(1, second->ref_count());
+}
+
+GTEST_TEST(image_api, depth_colorization_range_colors_by_the_precomputed_table)
+{
+    const int width = 4, height = 1;
+    image_info depth_info = { width, height, pixel_format::z16, width * 2 };
+    image_info rgba_info = { width, height, pixel_format::rgba8, width * 4 };
+    auto convert = [&](const std::vector<uint16_t> & depth, std::vector<uint8_t> & rgba)
+    {
+        rgba.assign(rgba_info.pitch * height, 0);
+        auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depth_info, {depth.data(), nullptr},
+                         stream_type::depth, image_interface::flag::any, 1.0, 1));
+        const image_interface * converted = nullptr;
+        ASSERT_EQ(status_no_error, image->convert_to(pixel_format::rgba8, &converted));
+        auto converted_image = get_unique_ptr_with_releaser(converted);
+        memcpy(rgba.data(), converted->query_data(), rgba.size());
+    };
+
+    //scaled by the image maximal value, 1000, as the depth of the range [1000, 2000] offset by 1000
+    std::vector<uint8_t> scaled;
+    convert({ 0, 250, 500, 1000 }, scaled);
+
+    uint16_t min_depth = 0, max_depth = 0;
+    EXPECT_FALSE(image_interface::query_depth_colorization_range(min_depth, max_depth));
+    EXPECT_EQ(status_invalid_argument, image_interface::set_depth_colorization_range(2000, 1000));
+    ASSERT_EQ(status_no_error, image_interface::set_depth_colorization_range(1000, 2000));
+    ASSERT_TRUE(image_interface::query_depth_colorization_range(min_depth, max_depth));
+    EXPECT_EQ(1000, min_depth);
+    EXPECT_EQ(2000, max_depth);
+
+    std::vector<uint8_t> ranged;
+    convert({ 900, 1250, 1500, 2000 }, ranged);
+    EXPECT_EQ(scaled, ranged);
+    //the depth out of the range is black below it and white above it
+    convert({ 0, 1250, 1500, 60000 }, ranged);
+    EXPECT_EQ(scaled, ranged);
+
+    ASSERT_EQ(status_no_error, image_interface::set_depth_colorization_range(0, 0));
+    EXPECT_FALSE(image_interface::query_depth_colorization_range(min_depth, max_depth));
+}
@@ -45,6 +45,26 @@ GTEST_TEST(librealsense_types_conversion, stream_conversions)
  }
 
 
+GTEST_TEST(librealsense_types_conversion, pixel_format_conversions)
+{
+    ASSERT_EQ(14, RS_FORMAT_COUNT)
+            << "format count has changed, integrating a new librealsense version?, update the conversion functions";
+    for(int i = 0; i < RS_FORMAT_COUNT; i++)
+    {
+        auto lrs_format = static_cast<rs::format>(i);
+        ASSERT_EQ(lrs_format, convert_pixel_format(convert_pixel_format(lrs_format)));
+    }
+    ASSERT_EQ(convert_pixel_format(rs::format::raw8), pixel_format::raw8);
+    ASSERT_EQ(convert_pixel_format(pixel_format::raw8), rs::format::raw8);
+
+    //values out of the enums range are not converted
+    ASSERT_EQ(static_cast<pixel_format>(-1), convert_pixel_format(static_cast<rs::format>(RS_FORMAT_COUNT)));
+    ASSERT_EQ(static_cast<rs::format>(-1), convert_pixel_format(static_cast<pixel_format>(-1)));
+    ASSERT_EQ(static_cast<stream_type>(-1), convert_stream_type(rs::stream::points));
+    ASSERT_EQ(static_cast<stream_type>(-1), convert_stream_type(rs::stream::depth_aligned_to_color));
+    ASSERT_EQ(static_cast<rs::stream>(-1), convert_stream_type(stream_type::max));
+}
+
 GTEST_TEST(librealsense_types_conversion, convert_motion_intrinsics)
 {
     //assert that librealsense motion intrinsics\extrinsics struct is in the same size as the sdk librealsense motion intrinsics\extrinsics structs
@@ -8,3 +8,32 @@ GTEST_TEST(LoggerTests, logger_configured_test)
 {
     ASSERT_NE(LOGGER_TYPE,rs::utils::logging_service::logger_type::empty_logger) << "Logger .so file is not loaded, or logger configuration failure.";
 }
+
+GTEST_TEST(LoggerTests, cached_level_check_test)
+{
+    const rs::utils::logging_service::log_level levels[] = { LOG_LEVEL_VERBOSE, LOG_LEVEL_TRACE, LOG_LEVEL_DEBUG, LOG_LEVEL_INFO,
+                                                             LOG_LEVEL_WARNING, LOG_LEVEL_ERROR, LOG_LEVEL_FATAL_ERROR };
+    for(auto level : levels)
+        EXPECT_EQ(LOG_LOGGER->is_level_enabled(level), logger.is_level_enabled(level)) << "level - " << level;
+}
+
+GTEST_TEST(LoggerTests, empty_logger_disables_all_levels_test)
+{
+    rs::utils::log_util empty_log_util;
+    empty_log_util.m_logger = &empty_log_util.m_empty_logger;
+    ASSERT_EQ(rs::core::status_no_error, empty_log_util.set_level(LOG_LEVEL_VERBOSE));
+    const rs::utils::logging_service::log_level levels[] = { LOG_LEVEL_VERBOSE, LOG_LEVEL_TRACE, LOG_LEVEL_DEBUG, LOG_LEVEL_INFO,
+                                                             LOG_LEVEL_WARNING, LOG_LEVEL_ERROR, LOG_LEVEL_FATAL_ERROR };
+    for(auto level : levels)
+        EXPECT_FALSE(empty_log_util.is_level_enabled(level)) << "level - " << level;
+}
+
+GTEST_TEST(LoggerTests, rate_limiter_counts_suppressed_messages_test)
+{
+    rs::utils::log_rate_limiter limiter;
+    uint64_t suppressed_count = 1;
+    ASSERT_TRUE(limiter.try_log(suppressed_count));
+    EXPECT_EQ(0u, suppressed_count);
+    for(int i = 0; i < 10; i++)
+        EXPECT_FALSE(limiter.try_log(suppressed_count));
+}
@@ -0,0 +1,280 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Performance regression tests, built as the rs_perf_tests target and run apart from the functional tests:
+//     RS_SDK_PERF_RECORDING=<reference recording> rs_perf_tests --gtest_output=xml:perf_report.xml
+// Each test records its measurement and its budget as test properties, so the xml report holds the results for trend tracking.
+// The budgets are of the reference machine, RS_SDK_PERF_BUDGET_SCALE scales the time budgets of slower machines. The playback
+// tests run when a reference recording is set, the recorder test runs when a camera is connected.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "rs/playback/playback_device.h"
+#include "rs/playback/playback_context.h"
+#include "rs/record/record_device.h"
+#include "rs/record/record_context.h"
+#include "rs/utils/samples_time_sync_interface.h"
+#include "rs/utils/smart_ptr_helpers.h"
+#include "librealsense/rs.hpp"
+#include "rs/core/image_interface.h"
+
+using namespace std;
+using namespace rs::core;
+
+namespace perf_budgets
+{
+    static const double playback_open_ms = 200;
+    static const double playback_seek_ms = 20;
+    static const double non_real_time_decode_fps = 120;
+    static const double recorder_fps_ratio = 0.95;     // of the configured frame rate, without drops
+    static const double time_sync_insert_us = 20;
+
+    static const int recorder_seconds = 5;
+    static const char * recorder_file_path = "rstest_perf_record.rssdk";
+}
+
+namespace perf_tests_util
+{
+    double budget_scale()
+    {
+        const char * scale = getenv("RS_SDK_PERF_BUDGET_SCALE");
+        const double rv = scale ? atof(scale) : 1.0;
+        return rv > 0 ? rv : 1.0;
+    }
+
+    //the reference recording, empty if it isn't set
+    std::string reference_recording()
+    {
+        const char * file_path = getenv("RS_SDK_PERF_RECORDING");
+        return file_path ? file_path : "";
+    }
+
+    double elapsed_ms(std::chrono::high_resolution_clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+    }
+
+    double median(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+
+    void report(const std::string & name, double value, double budget)
+    {
+        ::testing::Test::RecordProperty(name, std::to_string(value));
+        ::testing::Test::RecordProperty(name + "_budget", std::to_string(budget));
+    }
+
+    int enable_available_streams(rs::device * device)
+    {
+        int stream_count = 0;
+        for(int32_t s = (int32_t)rs::stream::depth; s <= (int32_t)rs::stream::fisheye; ++s)
+        {
+            int width, height, fps;
+            rs::format format = rs::format::any;
+            auto stream = (rs::stream)s;
+            if(device->get_stream_mode_count(stream) == 0) continue;
+            device->get_stream_mode(stream, 0, width, height, format, fps);
+            if(format != rs::format::any)
+            {
+                stream_count++;
+                device->enable_stream(stream, width, height, format, fps);
+            }
+        }
+        return stream_count;
+    }
+
+    rs::stream first_enabled_stream(rs::device * device)
+    {
+        for(int32_t s = (int32_t)rs::stream::depth; s <= (int32_t)rs::stream::fisheye; ++s)
+        {
+            if(device->is_stream_enabled((rs::stream)s)) return (rs::stream)s;
+        }
+        return rs::stream::depth;
+    }
+}
+
+class playback_perf_fixture : public testing::Test
+{
+protected:
+    std::string m_file_path;
+
+    virtual void SetUp()
+    {
+        m_file_path = perf_tests_util::reference_recording();
+        if(m_file_path.empty())
+        {
+            std::cout << "RS_SDK_PERF_RECORDING isn't set, the playback budgets aren't checked" << std::endl;
+        }
+    }
+};
+
+TEST_F(playback_perf_fixture, open_time)
+{
+    if(m_file_path.empty()) return;
+
+    std::vector<double> open_times;
+    for(int i = 0; i < 5; i++)
+    {
+        auto begin = std::chrono::high_resolution_clock::now();
+        rs::playback::context context(m_file_path.c_str());
+        ASSERT_NE(nullptr, context.get_playback_device());
+        open_times.push_back(perf_tests_util::elapsed_ms(begin));
+    }
+
+    const double open_ms = perf_tests_util::median(open_times);
+    const double budget = perf_budgets::playback_open_ms * perf_tests_util::budget_scale();
+    perf_tests_util::report("playback_open_ms", open_ms, budget);
+    EXPECT_LE(open_ms, budget);
+}
+
+TEST_F(playback_perf_fixture, seek_time)
+{
+    if(m_file_path.empty()) return;
+
+    rs::playback::context context(m_file_path.c_str());
+    auto device = context.get_playback_device();
+    ASSERT_NE(nullptr, device);
+    ASSERT_NE(0, perf_tests_util::enable_available_streams(device));
+    auto stream = perf_tests_util::first_enabled_stream(device);
+    const int frame_count = device->get_frame_count(stream);
+    ASSERT_LT(0, frame_count);
+
+    //seeks spread over the file, in both directions
+    std::vector<double> seek_times;
+    for(int i = 0; i < 20; i++)
+    {
+        const int index = (i % 2 == 0 ? i : 19 - i) * (frame_count - 1) / 19;
+        auto begin = std::chrono::high_resolution_clock::now();
+        ASSERT_TRUE(device->set_frame_by_index(index, stream));
+        seek_times.push_back(perf_tests_util::elapsed_ms(begin));
+    }
+
+    const double seek_ms = perf_tests_util::median(seek_times);
+    const double budget = perf_budgets::playback_seek_ms * perf_tests_util::budget_scale();
+    perf_tests_util::report("playback_seek_ms", seek_ms, budget);
+    EXPECT_LE(seek_ms, budget);
+}
+
+TEST_F(playback_perf_fixture, non_real_time_decode_fps)
+{
+    if(m_file_path.empty()) return;
+
+    rs::playback::context context(m_file_path.c_str());
+    auto device = context.get_playback_device();
+    ASSERT_NE(nullptr, device);
+    ASSERT_NE(0, perf_tests_util::enable_available_streams(device));
+    auto stream = perf_tests_util::first_enabled_stream(device);
+
+    std::atomic<uint32_t> frames_count(0);
+    device->set_frame_callback(stream, [&frames_count](rs::frame f) { frames_count++; });
+    device->set_real_time(false);
+    auto begin = std::chrono::high_resolution_clock::now();
+    device->start();
+    while(device->is_streaming())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    const double seconds = perf_tests_util::elapsed_ms(begin) / 1000;
+    device->stop();
+
+    ASSERT_LT(0u, frames_count.load());
+    const double decode_fps = frames_count / seconds;
+    const double budget = perf_budgets::non_real_time_decode_fps / perf_tests_util::budget_scale();
+    perf_tests_util::report("non_real_time_decode_fps", decode_fps, budget);
+    EXPECT_GE(decode_fps, budget);
+}
+
+TEST(recorder_perf_tests, sustained_fps_without_drops)
+{
+    {
+        rs::record::context context(perf_budgets::recorder_file_path);
+        if(context.get_device_count() == 0)
+        {
+            std::cout << "no camera is connected, the recorder budget isn't checked" << std::endl;
+            return;
+        }
+        auto device = context.get_record_device(0);
+        const rs::stream streams[] = { rs::stream::depth, rs::stream::color };
+        std::atomic<uint32_t> frames_count[2];
+        int frame_rates[2] = {};
+        for(int i = 0; i < 2; i++)
+        {
+            int width, height;
+            rs::format format;
+            device->get_stream_mode(streams[i], 0, width, height, format, frame_rates[i]);
+            device->enable_stream(streams[i], width, height, format, frame_rates[i]);
+            frames_count[i] = 0;
+            auto & count = frames_count[i];
+            device->set_frame_callback(streams[i], [&count](rs::frame f) { count++; });
+        }
+
+        device->start();
+        std::this_thread::sleep_for(std::chrono::seconds(perf_budgets::recorder_seconds));
+        device->stop();
+
+        rs::record::recorder_statistics statistics = {};
+        ASSERT_EQ(status_no_error, device->query_recorder_statistics(statistics));
+        perf_tests_util::report("recorder_dropped_frames", static_cast<double>(statistics.dropped_frames_count), 0);
+        EXPECT_EQ(0u, statistics.dropped_frames_count);
+        for(int i = 0; i < 2; i++)
+        {
+            const double fps = static_cast<double>(frames_count[i]) / perf_budgets::recorder_seconds;
+            const double budget = perf_budgets::recorder_fps_ratio * frame_rates[i];
+            perf_tests_util::report(std::string("recorder_fps_") + (i == 0 ? "depth" : "color"), fps, budget);
+            EXPECT_GE(fps, budget);
+        }
+    }
+    ::remove(perf_budgets::recorder_file_path);
+}
+
+TEST(time_sync_perf_tests, insert_cost)
+{
+    int streams[static_cast<int>(stream_type::max)] = {0};
+    int motions[static_cast<int>(motion_type::max)] = {0};
+    streams[static_cast<int>(stream_type::color)] = 30;
+    streams[static_cast<int>(stream_type::depth)] = 30;
+    auto samples_sync = rs::utils::get_unique_ptr_with_releaser(
+        rs::utils::samples_time_sync_interface::create_instance(streams, motions, rs::utils::samples_time_sync_interface::external_device_name));
+
+    //the images are created before the measurement, each pair of the same timestamp completes a sample set
+    const int pairs_count = 10000;
+    std::vector<rs::utils::unique_ptr<image_interface>> images;
+    for(int i = 0; i < pairs_count; i++)
+    {
+        image_info info = {};
+        const double timestamp = i * 1000.0 / 30;
+        for(auto stream : { stream_type::color, stream_type::depth })
+        {
+            images.push_back(rs::utils::get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(
+                &info, {nullptr, nullptr}, stream, image_interface::flag::any, timestamp, static_cast<uint64_t>(i))));
+        }
+    }
+
+    int sample_sets_count = 0;
+    auto begin = std::chrono::high_resolution_clock::now();
+    for(auto & image : images)
+    {
+        correlated_sample_set sample_set = {};
+        if(samples_sync->insert(image.get(), sample_set))
+        {
+            sample_sets_count++;
+            for(int i = 0; i < static_cast<int>(stream_type::max); i++)
+            {
+                if(sample_set.images[i]) sample_set.images[i]->release();
+            }
+        }
+    }
+    const double insert_us = perf_tests_util::elapsed_ms(begin) * 1000 / static_cast<double>(images.size());
+
+    EXPECT_EQ(pairs_count, sample_sets_count);
+    const double budget = perf_budgets::time_sync_insert_us * perf_tests_util::budget_scale();
+    perf_tests_util::report("time_sync_insert_us", insert_us, budget);
+    EXPECT_LE(insert_us, budget);
+}
@@ -3,13 +3,33 @@
 
 #include <thread>
 #include <fstream>
+#include <iterator>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
 
 #include "gtest/gtest.h"
 #include "rs_sdk.h"
 #include "../sdk/src/cv_modules/max_depth_value_module/max_depth_value_module_impl.h"
 #include "../sdk/src/core/pipeline/config_util.h"
+#include "../sdk/src/core/pipeline/work_stealing_executor.h"
+#include "../sdk/src/core/pipeline/samples_consumer_base.h"
+#include "../sdk/src/core/pipeline/sample_set_releaser.h"
+#include "../sdk/src/core/pipeline/sample_set_pool.h"
+#include "../sdk/src/core/pipeline/sync_samples_consumer.h"
+#include "../sdk/src/core/pipeline/multi_device_samples_consumer.h"
+#include "../sdk/src/core/pipeline/batched_samples_consumer.h"
+#include "../sdk/src/core/pipeline/degradation_controller.h"
+#include "../sdk/src/core/pipeline/lazy_projection.h"
+#include "../sdk/src/core/pipeline/module_manifest.h"
+#include "../sdk/src/core/pipeline/module_outputs_cache.h"
 
 using namespace std;
 using namespace rs::core;
@@ -19,9 +39,14 @@ using namespace rs::cv_modules;
 class max_depth_value_module_testing : public max_depth_value_module_impl
 {
 public:
-    max_depth_value_module_testing(): m_is_using_custom_config(false)
+    max_depth_value_module_testing(): m_is_using_custom_config(false), m_supported_config_queries_count(0)
     {}
 
+    int query_supported_config_queries_count() const
+    {
+        return m_supported_config_queries_count;
+    }
+
     video_module_interface::supported_module_config::time_sync_mode query_time_sync_mode()
     {
         return m_time_sync_mode;
@@ -50,6 +75,7 @@ public:
 
     status query_supported_module_config(int32_t idx, supported_module_config &supported_config)
     {
+        m_supported_config_queries_count++;
         if(!m_is_using_custom_config)
         {
             return max_depth_value_module_impl::query_supported_module_config(idx, supported_config);
@@ -117,9 +143,15 @@ public:
         return status_no_error;
     }
 
+    status process_depth_image(std::shared_ptr<image_interface> depth_image, max_depth_value_output_interface::max_depth_value_output_data & output_data)
+    {
+        return process_depth_max_value(depth_image, output_data);
+    }
+
 private:
     bool m_is_using_custom_config;
     std::vector<supported_module_config> m_supported_configs;
+    int m_supported_config_queries_count;
 };
 
 
@@ -301,6 +333,28 @@ TEST_F(pipeline_tests, query_current_config)
     ASSERT_NE(0, current_config[stream_type::depth].size.width) << "pipeline should have filled the missing configuration data";
 }
 
+TEST_F(pipeline_tests, set_config_negotiates_with_cached_module_configs)
+{
+    m_pipeline->add_cv_module(m_module.get());
+    video_module_interface::supported_module_config config = {};
+    config[stream_type::depth].is_enabled = true;
+    ASSERT_EQ(status_no_error, m_pipeline->set_config(config));
+    auto queries_count = m_module->query_supported_config_queries_count();
+    ASSERT_GT(queries_count, 0);
+
+    //setting the same and another config reuses the module configs queried by the first negotiation
+    ASSERT_EQ(status_no_error, m_pipeline->set_config(config));
+    config[stream_type::color].is_enabled = true;
+    ASSERT_EQ(status_no_error, m_pipeline->set_config(config));
+    EXPECT_EQ(queries_count, m_module->query_supported_config_queries_count());
+
+    //the caches are cleared with the modules
+    m_pipeline->reset();
+    m_pipeline->add_cv_module(m_module.get());
+    ASSERT_EQ(status_no_error, m_pipeline->set_config(config));
+    EXPECT_GT(m_module->query_supported_config_queries_count(), queries_count);
+}
+
 TEST_F(pipeline_tests, reset)
 {
     m_pipeline->add_cv_module(m_module.get());
@@ -478,6 +532,33 @@ TEST_F(pipeline_tests, check_pipeline_is_preventing_config_change_while_streamin
     m_pipeline->stop();
 }
 
+TEST_F(pipeline_tests, check_pipeline_reconfigures_modules_while_streaming)
+{
+    m_pipeline->add_cv_module(m_module.get());
+    video_module_interface::supported_module_config available_config = {};
+    m_pipeline->query_default_config(0, available_config);
+    ASSERT_EQ(status_no_error, m_pipeline->set_config(available_config));
+    ASSERT_EQ(status_no_error, m_pipeline->start(m_callback_handler.get()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    //a subset of the streaming modes is applied without stopping the device
+    auto reduced_config = available_config;
+    reduced_config[stream_type::fisheye].is_enabled = false;
+    EXPECT_EQ(status_no_error, m_pipeline->set_config(reduced_config));
+    EXPECT_TRUE(m_pipeline->get_device()->is_streaming());
+
+    //different device modes require stopping the pipeline
+    auto changed_config = available_config;
+    changed_config[stream_type::color].size.width = 320;
+    changed_config[stream_type::color].size.height = 240;
+    EXPECT_EQ(status_invalid_state, m_pipeline->set_config(changed_config));
+    EXPECT_TRUE(m_pipeline->get_device()->is_streaming());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    m_pipeline->stop();
+    ASSERT_TRUE(m_callback_handler->was_a_new_valid_sample_dispatched());
+}
+
 TEST_F(pipeline_tests, check_pipeline_recording_playing_a_recorded_file)
 {
     const char * test_file = "pipeline_test.rssdk";
@@ -508,6 +589,21 @@ TEST_F(pipeline_tests, check_pipeline_recording_playing_a_recorded_file)
     std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     EXPECT_TRUE(m_callback_handler->was_a_new_valid_sample_dispatched()) <<"new valid sample wasn't dispatched";
     ASSERT_EQ(status_no_error, m_pipeline->stop());
+    m_pipeline.reset();
+
+    //the replay delivers the recorded samples as fast as the module processes them, without drops
+    m_module.reset(new max_depth_value_module_testing());
+    m_callback_handler.reset(new pipeline_handler(m_module));
+    m_pipeline.reset(new pipeline_async(pipeline_async::testing_mode::replay, test_file));
+    m_pipeline->add_cv_module(m_module.get());
+    ASSERT_EQ(status_no_error, m_pipeline->start(m_callback_handler.get()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    pipeline_module_statistics statistics = {};
+    ASSERT_EQ(status_no_error, m_pipeline->query_module_statistics(m_module.get(), statistics));
+    EXPECT_GT(statistics.processed_sample_sets_count, 0u);
+    EXPECT_GT(statistics.throughput, 0.);
+    EXPECT_EQ(0u, statistics.dropped_sample_sets_count);
+    ASSERT_EQ(status_no_error, m_pipeline->stop());
 
     if(is_file_exists(test_file))
     {
@@ -515,6 +611,44 @@ TEST_F(pipeline_tests, check_pipeline_recording_playing_a_recorded_file)
     }
 }
 
+class recording_pipeline_handler : public pipeline_async_interface::callback_handler
+{
+public:
+    void on_new_sample_set(const correlated_sample_set& sample_set) override {}
+    void on_cv_module_process_complete(video_module_interface * cv_module) override {}
+    void on_error(status status) override { ADD_FAILURE() << "got pipeline error : " << status; }
+};
+
+TEST_F(pipeline_tests, record_module_records_the_pipeline_sample_sets)
+{
+    const char * test_file = "pipeline_record_module_test.rssdk";
+    std::remove(test_file);
+
+    recording_pipeline_handler callback_handler;
+    rs::record::record_module recorder(test_file);
+    ASSERT_EQ(status_invalid_argument, recorder.enable_stream(stream_type::rectified_color));
+    ASSERT_EQ(status_no_error, recorder.enable_stream(stream_type::depth));
+    ASSERT_EQ(status_no_error, m_pipeline->add_cv_module(&recorder));
+    ASSERT_EQ(status_no_error, m_pipeline->start(&callback_handler));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    ASSERT_EQ(status_no_error, m_pipeline->stop());
+
+    //the statistics of the recording are kept after the file is closed
+    rs::record::recording_statistics statistics = {};
+    ASSERT_EQ(status_no_error, recorder.query_recording_statistics(stream_type::depth, statistics));
+    EXPECT_GT(statistics.recorded_frames_count, 0u);
+    m_pipeline.reset();
+
+    {
+        rs::playback::context playback_context(test_file);
+        auto playback = playback_context.get_playback_device();
+        ASSERT_NE(nullptr, playback);
+        EXPECT_NE(0, playback->get_stream_mode_count(rs::stream::depth));
+        EXPECT_EQ(static_cast<int>(statistics.recorded_frames_count), playback->get_frame_count(rs::stream::depth));
+    }
+    std::remove(test_file);
+}
+
 class multi_module_pipeline_handler : public pipeline_async_interface::callback_handler
 {
 public:
@@ -797,3 +931,1131 @@ GTEST_TEST(config_util_test, check_generete_matching_supersets)
                                                && (matching_supersets.at(3)[stream_type::color].size.width == 640));
 }
 
+GTEST_TEST(config_util_test, aligned_streams_require_their_depth_and_color_sources)
+{
+    EXPECT_TRUE(config_util::is_aligned_stream(stream_type::depth_aligned_to_color));
+    EXPECT_TRUE(config_util::is_aligned_stream(stream_type::color_aligned_to_depth));
+    EXPECT_FALSE(config_util::is_aligned_stream(stream_type::depth));
+    EXPECT_FALSE(config_util::is_aligned_stream(stream_type::rectified_color));
+
+    video_module_interface::supported_module_config config = {};
+    EXPECT_TRUE(config_util::are_aligned_streams_sources_enabled(config));
+    config[stream_type::depth_aligned_to_color].is_enabled = true;
+    config[stream_type::depth].is_enabled = true;
+    EXPECT_FALSE(config_util::are_aligned_streams_sources_enabled(config)) << "the color stream the depth is registered to isn't enabled";
+    config[stream_type::color].is_enabled = true;
+    EXPECT_TRUE(config_util::are_aligned_streams_sources_enabled(config));
+}
+
+TEST(pipeline_executor_tests, busy_worker_tasks_are_stolen)
+{
+    std::mutex lock;
+    std::condition_variable released;
+    bool is_released = false;
+    std::atomic<int> completed_tasks(0);
+    {
+        work_stealing_executor executor(2);
+        //block the first worker, its queued tasks must be stolen by the second worker
+        executor.submit([&]()
+        {
+            std::unique_lock<std::mutex> blocking_lock(lock);
+            released.wait(blocking_lock, [&]() { return is_released; });
+        }, 0);
+
+        const int tasks_count = 100;
+        for(int i = 0; i < tasks_count; i++)
+        {
+            executor.submit([&]() { completed_tasks++; }, 0, i % 2 ? work_stealing_executor::priority::high : work_stealing_executor::priority::normal);
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(completed_tasks < tasks_count && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(tasks_count, completed_tasks) << "the tasks of the busy worker weren't stolen";
+
+        {
+            std::lock_guard<std::mutex> release_lock(lock);
+            is_released = true;
+        }
+        released.notify_all();
+
+        //queued tasks run before the executor is destroyed
+        executor.submit([&]() { completed_tasks++; }, 1);
+    }
+    ASSERT_EQ(101, completed_tasks);
+}
+
+TEST(pipeline_executor_tests, stolen_tasks_run_oldest_first)
+{
+    std::mutex lock;
+    std::condition_variable released;
+    bool is_released = false;
+    std::vector<int> stolen_tasks;
+    {
+        work_stealing_executor executor(2);
+        //block the first worker, the second worker steals its queued tasks one at a time
+        executor.submit([&]()
+        {
+            std::unique_lock<std::mutex> blocking_lock(lock);
+            released.wait(blocking_lock, [&]() { return is_released; });
+        }, 0);
+
+        const int tasks_count = 10;
+        for(int i = 0; i < tasks_count; i++)
+        {
+            executor.submit([&, i]()
+            {
+                std::lock_guard<std::mutex> task_lock(lock);
+                stolen_tasks.push_back(i);
+            }, 0);
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(std::chrono::steady_clock::now() < deadline)
+        {
+            {
+                std::lock_guard<std::mutex> test_lock(lock);
+                if(static_cast<int>(stolen_tasks.size()) == tasks_count)
+                {
+                    break;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        {
+            std::lock_guard<std::mutex> release_lock(lock);
+            is_released = true;
+        }
+        released.notify_all();
+    }
+    ASSERT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), stolen_tasks);
+}
+
+TEST(pipeline_executor_tests, tasks_run_on_the_executor_workers)
+{
+    work_stealing_executor executor(2);
+    EXPECT_FALSE(executor.is_worker_thread());
+    std::promise<bool> is_worker_thread;
+    auto result = is_worker_thread.get_future();
+    executor.submit([&]() { is_worker_thread.set_value(executor.is_worker_thread()); });
+    ASSERT_EQ(std::future_status::ready, result.wait_for(std::chrono::seconds(5)));
+    ASSERT_TRUE(result.get());
+}
+
+//the module config of a 30 fps color stream, which the samples consumer tests are notified of
+static video_module_interface::actual_module_config create_color_module_config()
+{
+    video_module_interface::actual_module_config config = {};
+    config[stream_type::color].is_enabled = true;
+    config[stream_type::color].frame_rate = 30;
+    return config;
+}
+
+//a sample set of an image without data, the samples consumer tests check the time stamps and the frame numbers only
+static std::shared_ptr<correlated_sample_set> create_sample_set(stream_type stream, double time_stamp, uint64_t frame)
+{
+    image_info info = {};
+    rs::core::image_interface::image_data_with_data_releaser image(nullptr, nullptr);
+    std::shared_ptr<correlated_sample_set> sample_set(new correlated_sample_set(), sample_set_releaser());
+    (*sample_set)[stream] = image_interface::create_instance_from_raw_data(&info, image, stream, image_interface::flag::any, time_stamp, frame);
+    return sample_set;
+}
+
+//a color sample set whose time stamp is its frame number
+static std::shared_ptr<correlated_sample_set> create_color_sample_set(uint64_t frame)
+{
+    return create_sample_set(stream_type::color, static_cast<double>(frame), frame);
+}
+
+class counting_samples_consumer : public samples_consumer_base
+{
+public:
+    counting_samples_consumer(const video_module_interface::actual_module_config & module_config,
+                              const video_module_interface::supported_module_config::time_sync_mode time_sync_mode) :
+        samples_consumer_base(module_config, time_sync_mode, 0) {}
+
+    std::vector<std::shared_ptr<correlated_sample_set>> m_sample_sets;
+protected:
+    void on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set) override
+    {
+        m_sample_sets.push_back(ready_sample_set);
+    }
+};
+
+TEST(pipeline_samples_consumer_tests, same_sync_stage_consumers_share_the_matched_sample_set)
+{
+    video_module_interface::actual_module_config config = {};
+    std::strcpy(config.device_info.name, rs::utils::samples_time_sync_interface::external_device_name);
+    for(auto stream : { stream_type::color, stream_type::depth })
+    {
+        config[stream].is_enabled = true;
+        config[stream].frame_rate = 30;
+    }
+
+    auto time_synced = video_module_interface::supported_module_config::time_sync_mode::time_synced_input_only;
+    auto not_synced = video_module_interface::supported_module_config::time_sync_mode::sync_not_required;
+    std::shared_ptr<counting_samples_consumer> leader(new counting_samples_consumer(config, time_synced));
+    std::shared_ptr<counting_samples_consumer> follower(new counting_samples_consumer(config, time_synced));
+    std::shared_ptr<counting_samples_consumer> not_synced_consumer(new counting_samples_consumer(config, not_synced));
+    ASSERT_TRUE(leader->is_sharing_sync_stage(*follower));
+    ASSERT_FALSE(leader->is_sharing_sync_stage(*not_synced_consumer));
+    leader->add_sync_stage_follower(follower);
+
+    auto notify_image = [&](stream_type stream)
+    {
+        auto sample_set = create_sample_set(stream, 1000., 1);
+        leader->notify_sample_set_non_blocking(sample_set);
+        not_synced_consumer->notify_sample_set_non_blocking(sample_set);
+    };
+    notify_image(stream_type::color);
+    notify_image(stream_type::depth);
+
+    //the sample set is matched once by the leader and the same sample set is delivered to the follower
+    ASSERT_EQ(1u, leader->m_sample_sets.size());
+    ASSERT_EQ(1u, follower->m_sample_sets.size());
+    ASSERT_EQ(leader->m_sample_sets[0], follower->m_sample_sets[0]);
+    ASSERT_NE(nullptr, (*leader->m_sample_sets[0])[stream_type::color]);
+    ASSERT_NE(nullptr, (*leader->m_sample_sets[0])[stream_type::depth]);
+    ASSERT_EQ(2u, not_synced_consumer->m_sample_sets.size());
+}
+
+TEST(pipeline_samples_consumer_tests, slow_consumer_drops_the_oldest_queued_sample_sets)
+{
+    auto config = create_color_module_config();
+
+    std::mutex lock;
+    std::condition_variable handler_state_changed;
+    bool is_handler_busy = false;
+    bool is_handler_released = false;
+    std::vector<uint64_t> handled_frames;
+    work_stealing_executor executor(1);
+    {
+        sync_samples_consumer consumer([&](std::shared_ptr<correlated_sample_set> sample_set)
+                                       {
+                                           std::unique_lock<std::mutex> handler_lock(lock);
+                                           handled_frames.push_back((*sample_set)[stream_type::color]->query_frame_number());
+                                           is_handler_busy = true;
+                                           handler_state_changed.notify_all();
+                                           handler_state_changed.wait(handler_lock, [&]() { return is_handler_released; });
+                                           return status_no_error;
+                                       },
+                                       config,
+                                       video_module_interface::supported_module_config::time_sync_mode::sync_not_required,
+                                       0,
+                                       executor,
+                                       work_stealing_executor::no_affinity,
+                                       work_stealing_executor::priority::normal,
+                                       video_module_interface::supported_module_config::samples_queue_policy::drop_oldest,
+                                       2);
+
+        auto notify_frame = [&](uint64_t frame)
+        {
+            consumer.notify_sample_set_non_blocking(create_color_sample_set(frame));
+        };
+
+        //the handler is busy with the first frame, the next frames are queued by the queue depth
+        notify_frame(1);
+        {
+            std::unique_lock<std::mutex> test_lock(lock);
+            handler_state_changed.wait(test_lock, [&]() { return is_handler_busy; });
+        }
+        for(uint64_t frame = 2; frame <= 5; frame++)
+        {
+            notify_frame(frame);
+        }
+        EXPECT_EQ(2u, consumer.query_dropped_sample_sets_count());
+
+        {
+            std::lock_guard<std::mutex> test_lock(lock);
+            is_handler_released = true;
+        }
+        handler_state_changed.notify_all();
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(std::chrono::steady_clock::now() < deadline)
+        {
+            {
+                std::lock_guard<std::mutex> test_lock(lock);
+                if(handled_frames.size() == 3)
+                {
+                    break;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    ASSERT_EQ((std::vector<uint64_t>{1, 4, 5}), handled_frames);
+}
+
+TEST(pipeline_samples_consumer_tests, pulling_consumer_returns_the_latest_sample_set)
+{
+    auto config = create_color_module_config();
+
+    bool is_handler_called = false;
+    work_stealing_executor executor(1);
+    sync_samples_consumer consumer([&](std::shared_ptr<correlated_sample_set> sample_set)
+                                   {
+                                       is_handler_called = true;
+                                       return status_no_error;
+                                   },
+                                   config,
+                                   video_module_interface::supported_module_config::time_sync_mode::sync_not_required,
+                                   0,
+                                   executor,
+                                   work_stealing_executor::no_affinity,
+                                   work_stealing_executor::priority::normal,
+                                   video_module_interface::supported_module_config::samples_queue_policy::pull_latest,
+                                   1);
+
+    auto notify_frame = [&](uint64_t frame)
+    {
+        consumer.notify_sample_set_non_blocking(create_color_sample_set(frame));
+    };
+
+    std::shared_ptr<correlated_sample_set> pulled_sample_set;
+    EXPECT_EQ(status_data_not_changed, consumer.pull_sample_set(pulled_sample_set));
+
+    //the sample sets which weren't pulled before a newer sample set completed are dropped
+    for(uint64_t frame = 1; frame <= 3; frame++)
+    {
+        notify_frame(frame);
+    }
+    ASSERT_EQ(status_no_error, consumer.pull_sample_set(pulled_sample_set));
+    EXPECT_EQ(3u, (*pulled_sample_set)[stream_type::color]->query_frame_number());
+    EXPECT_EQ(status_data_not_changed, consumer.pull_sample_set(pulled_sample_set));
+    EXPECT_EQ(2u, consumer.query_dropped_sample_sets_count());
+
+    notify_frame(4);
+    ASSERT_EQ(status_no_error, consumer.pull_sample_set(pulled_sample_set));
+    EXPECT_EQ(4u, (*pulled_sample_set)[stream_type::color]->query_frame_number());
+    EXPECT_EQ(2u, consumer.query_dropped_sample_sets_count());
+    EXPECT_FALSE(is_handler_called);
+}
+
+TEST(pipeline_samples_consumer_tests, queued_pulling_consumer_returns_the_sample_sets_in_order)
+{
+    auto config = create_color_module_config();
+
+    work_stealing_executor executor(1);
+    sync_samples_consumer consumer([&](std::shared_ptr<correlated_sample_set> sample_set) { return status_no_error; },
+                                   config,
+                                   video_module_interface::supported_module_config::time_sync_mode::sync_not_required,
+                                   0,
+                                   executor,
+                                   work_stealing_executor::no_affinity,
+                                   work_stealing_executor::priority::normal,
+                                   video_module_interface::supported_module_config::samples_queue_policy::pull_queued,
+                                   2);
+
+    auto notify_frame = [&](uint64_t frame)
+    {
+        consumer.notify_sample_set_non_blocking(create_color_sample_set(frame));
+    };
+
+    std::shared_ptr<correlated_sample_set> pulled_sample_set;
+    EXPECT_EQ(status_exec_timeout, consumer.wait_sample_set(pulled_sample_set, 0));
+    EXPECT_EQ(status_exec_timeout, consumer.wait_sample_set(pulled_sample_set, 10));
+
+    //the queue holds two sample sets, the newest sample set is dropped once it's full
+    for(uint64_t frame = 1; frame <= 3; frame++)
+    {
+        notify_frame(frame);
+    }
+    EXPECT_EQ(1u, consumer.query_dropped_sample_sets_count());
+    ASSERT_EQ(status_no_error, consumer.pull_sample_set(pulled_sample_set));
+    EXPECT_EQ(1u, (*pulled_sample_set)[stream_type::color]->query_frame_number());
+    ASSERT_EQ(status_no_error, consumer.wait_sample_set(pulled_sample_set, 0));
+    EXPECT_EQ(2u, (*pulled_sample_set)[stream_type::color]->query_frame_number());
+    EXPECT_EQ(status_data_not_changed, consumer.pull_sample_set(pulled_sample_set));
+
+    //a waiting thread is woken by the streaming thread
+    std::thread streaming_thread([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        notify_frame(4);
+    });
+    ASSERT_EQ(status_no_error, consumer.wait_sample_set(pulled_sample_set, 5000));
+    EXPECT_EQ(4u, (*pulled_sample_set)[stream_type::color]->query_frame_number());
+    streaming_thread.join();
+
+    //stopping the pulling wakes the waiting thread
+    std::thread stopping_thread([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        consumer.stop_pulling();
+    });
+    EXPECT_EQ(status_invalid_state, consumer.wait_sample_set(pulled_sample_set, 5000));
+    stopping_thread.join();
+}
+
+TEST(pipeline_samples_consumer_tests, consumer_statistics_count_processed_dropped_and_failed_sample_sets)
+{
+    auto config = create_color_module_config();
+
+    std::mutex lock;
+    std::condition_variable handler_state_changed;
+    bool is_handler_released = false;
+    work_stealing_executor executor(1);
+    sync_samples_consumer consumer([&](std::shared_ptr<correlated_sample_set> sample_set)
+                                   {
+                                       std::unique_lock<std::mutex> handler_lock(lock);
+                                       handler_state_changed.wait(handler_lock, [&]() { return is_handler_released; });
+                                       //odd frames fail with an error, their process time is counted without an output
+                                       return (*sample_set)[stream_type::color]->query_frame_number() % 2 ? status_data_unavailable : status_no_error;
+                                   },
+                                   config,
+                                   video_module_interface::supported_module_config::time_sync_mode::sync_not_required,
+                                   0,
+                                   executor,
+                                   work_stealing_executor::no_affinity,
+                                   work_stealing_executor::priority::normal,
+                                   video_module_interface::supported_module_config::samples_queue_policy::drop_newest,
+                                   2);
+
+    for(uint64_t frame = 1; frame <= 4; frame++)
+    {
+        consumer.notify_sample_set_non_blocking(create_color_sample_set(frame));
+    }
+
+    //the handler holds the first frame or hasn't started yet, so at least one of the four frames was dropped
+    const uint64_t dropped_samples_count = consumer.query_statistics().query_dropped_samples_count(stream_type::color);
+    EXPECT_GE(dropped_samples_count, 1u);
+    EXPECT_EQ(consumer.query_dropped_sample_sets_count(), dropped_samples_count);
+    EXPECT_EQ(0u, consumer.query_statistics().query_dropped_samples_count(stream_type::depth));
+
+    {
+        std::lock_guard<std::mutex> test_lock(lock);
+        is_handler_released = true;
+    }
+    handler_state_changed.notify_all();
+
+    pipeline_module_statistics statistics = {};
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(std::chrono::steady_clock::now() < deadline)
+    {
+        consumer.query_module_statistics(statistics);
+        if(statistics.processed_sample_sets_count + statistics.dropped_sample_sets_count == 4)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(4u, statistics.processed_sample_sets_count + statistics.dropped_sample_sets_count);
+    EXPECT_EQ(0u, statistics.queued_sample_sets_count);
+    EXPECT_LT(statistics.outputs_count, statistics.processed_sample_sets_count);
+    uint64_t histogram_count = 0;
+    for(auto bucket_count : statistics.process_time_histogram)
+    {
+        histogram_count += bucket_count;
+    }
+    EXPECT_EQ(statistics.processed_sample_sets_count, histogram_count);
+    EXPECT_GE(statistics.mean_process_time_ms, 0.);
+}
+
+TEST(pipeline_samples_consumer_tests, best_effort_consumer_is_throttled_while_latency_critical_consumer_is_busy)
+{
+    auto config = create_color_module_config();
+
+    std::mutex lock;
+    std::condition_variable handler_state_changed;
+    bool is_handler_released = false;
+    work_stealing_executor executor(2);
+    sync_samples_consumer latency_critical_consumer([&](std::shared_ptr<correlated_sample_set> sample_set)
+                                                    {
+                                                        std::unique_lock<std::mutex> handler_lock(lock);
+                                                        handler_state_changed.wait(handler_lock, [&]() { return is_handler_released; });
+                                                        return status_no_error;
+                                                    },
+                                                    config,
+                                                    video_module_interface::supported_module_config::time_sync_mode::sync_not_required,
+                                                    0,
+                                                    executor,
+                                                    work_stealing_executor::no_affinity,
+                                                    work_stealing_executor::priority::high,
+                                                    video_module_interface::supported_module_config::samples_queue_policy::keep_latest,
+                                                    1);
+    sync_samples_consumer best_effort_consumer([&](std::shared_ptr<correlated_sample_set> sample_set) { return status_no_error; },
+                                               config,
+                                               video_module_interface::supported_module_config::time_sync_mode::sync_not_required,
+                                               0,
+                                               executor,
+                                               work_stealing_executor::no_affinity,
+                                               work_stealing_executor::priority::normal,
+                                               video_module_interface::supported_module_config::samples_queue_policy::drop_newest,
+                                               16);
+    auto contention = std::make_shared<module_contention>();
+    latency_critical_consumer.set_priority_class(video_module_interface::supported_module_config::module_priority::latency_critical, contention);
+    best_effort_consumer.set_priority_class(video_module_interface::supported_module_config::module_priority::best_effort, contention);
+
+    auto notify_frame = [&](sync_samples_consumer & consumer, uint64_t frame)
+    {
+        consumer.notify_sample_set_non_blocking(create_color_sample_set(frame));
+    };
+
+    //the latency critical consumer is busy until its handler is released, the best effort consumer handles every 4th frame meanwhile
+    notify_frame(latency_critical_consumer, 1);
+    EXPECT_TRUE(contention->is_contended());
+    for(uint64_t frame = 1; frame <= 8; frame++)
+    {
+        notify_frame(best_effort_consumer, frame);
+    }
+    pipeline_module_statistics statistics = {};
+    best_effort_consumer.query_module_statistics(statistics);
+    EXPECT_EQ(6u, statistics.throttled_sample_sets_count);
+
+    {
+        std::lock_guard<std::mutex> test_lock(lock);
+        is_handler_released = true;
+    }
+    handler_state_changed.notify_all();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(contention->is_contended() && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_FALSE(contention->is_contended());
+
+    //without contention every frame is handled
+    for(uint64_t frame = 9; frame <= 10; frame++)
+    {
+        notify_frame(best_effort_consumer, frame);
+    }
+    while(std::chrono::steady_clock::now() < deadline)
+    {
+        best_effort_consumer.query_module_statistics(statistics);
+        if(statistics.processed_sample_sets_count == 4)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(4u, statistics.processed_sample_sets_count);
+    EXPECT_EQ(6u, statistics.throttled_sample_sets_count);
+    EXPECT_EQ(0u, statistics.dropped_sample_sets_count);
+}
+
+TEST(pipeline_samples_consumer_tests, degradation_steps_follow_the_overload_and_decimate_the_modules)
+{
+    using module_priority = video_module_interface::supported_module_config::module_priority;
+    pipeline_degradation_plan plan = {};
+    plan.steps_count = 2;
+    plan.steps[0].best_effort_decimation = 2;
+    plan.steps[1].skip_best_effort_modules = true;
+    plan.steps[1].normal_decimation = 2;
+    plan.overload_queue_depth = 4;
+    plan.evaluation_interval_ms = 100;
+    plan.recovery_intervals = 2;
+    auto degradation = std::make_shared<degradation_controller>(plan);
+
+    //the intervals are evaluated at the given times, far ahead of the consumers reports
+    auto start_time = std::chrono::steady_clock::now() + std::chrono::hours(1);
+    auto at = [start_time](int ms) { return start_time + std::chrono::milliseconds(ms); };
+
+    degradation->on_queue_size_changed(1, at(0));
+    degradation->on_queue_size_changed(4, at(50));
+    EXPECT_EQ(0u, degradation->query_step());
+    degradation->on_queue_size_changed(1, at(100));
+    EXPECT_EQ(1u, degradation->query_step());
+    EXPECT_EQ(2u, degradation->query_decimation(module_priority::best_effort));
+    EXPECT_EQ(1u, degradation->query_decimation(module_priority::normal));
+
+    degradation->on_queue_size_changed(5, at(150));
+    degradation->on_processed(std::chrono::milliseconds(1), at(200));
+    EXPECT_EQ(2u, degradation->query_step());
+    EXPECT_EQ(0u, degradation->query_decimation(module_priority::best_effort));
+    EXPECT_EQ(2u, degradation->query_decimation(module_priority::normal));
+    EXPECT_EQ(1u, degradation->query_decimation(module_priority::latency_critical));
+
+    auto config = create_color_module_config();
+    work_stealing_executor executor(2);
+    auto create_consumer = [&](module_priority priority_class)
+    {
+        std::unique_ptr<sync_samples_consumer> consumer(new sync_samples_consumer(
+                [](std::shared_ptr<correlated_sample_set> sample_set) { return status_no_error; },
+                config,
+                video_module_interface::supported_module_config::time_sync_mode::sync_not_required,
+                0,
+                executor,
+                work_stealing_executor::no_affinity,
+                work_stealing_executor::priority::normal,
+                video_module_interface::supported_module_config::samples_queue_policy::drop_newest,
+                16));
+        consumer->set_priority_class(priority_class, nullptr);
+        consumer->set_degradation_controller(degradation);
+        return consumer;
+    };
+    auto notify_frames = [&](sync_samples_consumer & consumer)
+    {
+        for(uint64_t frame = 1; frame <= 4; frame++)
+        {
+            consumer.notify_sample_set_non_blocking(create_color_sample_set(frame));
+        }
+    };
+
+    //the normal module handles every second sample set, the best effort module handles none, the latency critical module handles all
+    auto normal_consumer = create_consumer(module_priority::normal);
+    auto best_effort_consumer = create_consumer(module_priority::best_effort);
+    auto latency_critical_consumer = create_consumer(module_priority::latency_critical);
+    notify_frames(*normal_consumer);
+    notify_frames(*best_effort_consumer);
+    notify_frames(*latency_critical_consumer);
+    pipeline_module_statistics statistics = {};
+    normal_consumer->query_module_statistics(statistics);
+    EXPECT_EQ(2u, statistics.throttled_sample_sets_count);
+    best_effort_consumer->query_module_statistics(statistics);
+    EXPECT_EQ(4u, statistics.throttled_sample_sets_count);
+    latency_critical_consumer->query_module_statistics(statistics);
+    EXPECT_EQ(0u, statistics.throttled_sample_sets_count);
+
+    //the last step stays applied while overloaded, a step is restored after two calm intervals
+    degradation->on_queue_size_changed(6, at(250));
+    degradation->on_queue_size_changed(0, at(300));
+    EXPECT_EQ(2u, degradation->query_step());
+    degradation->on_processed(std::chrono::milliseconds(1), at(400));
+    EXPECT_EQ(2u, degradation->query_step());
+    degradation->on_processed(std::chrono::milliseconds(1), at(500));
+    EXPECT_EQ(1u, degradation->query_step());
+    EXPECT_EQ(3u, degradation->query_step_changes_count());
+}
+
+TEST(pipeline_samples_consumer_tests, max_rate_consumer_handles_the_samples_a_period_apart)
+{
+    auto config = create_color_module_config();
+
+    std::atomic<uint32_t> handled_count(0);
+    std::vector<uint64_t> handled_frames;
+    std::mutex lock;
+    work_stealing_executor executor(2);
+    sync_samples_consumer consumer([&](std::shared_ptr<correlated_sample_set> sample_set)
+                                   {
+                                       std::lock_guard<std::mutex> handler_lock(lock);
+                                       handled_frames.push_back((*sample_set)[stream_type::color]->query_frame_number());
+                                       handled_count++;
+                                       return status_no_error;
+                                   },
+                                   config,
+                                   video_module_interface::supported_module_config::time_sync_mode::sync_not_required,
+                                   0,
+                                   executor,
+                                   work_stealing_executor::no_affinity,
+                                   work_stealing_executor::priority::normal,
+                                   video_module_interface::supported_module_config::samples_queue_policy::drop_newest,
+                                   16);
+    consumer.set_max_rate(10);
+
+    //the 30 fps color stream is reduced to 10 fps, every 3rd frame is handled
+    for(uint64_t frame = 0; frame < 12; frame++)
+    {
+        consumer.notify_sample_set_non_blocking(create_sample_set(stream_type::color, static_cast<double>(frame) * 1000. / 30, frame));
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(handled_count < 4 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::lock_guard<std::mutex> test_lock(lock);
+    EXPECT_EQ(std::vector<uint64_t>({0, 3, 6, 9}), handled_frames);
+}
+
+TEST(pipeline_samples_consumer_tests, upstream_consumer_output_is_the_downstream_consumer_input)
+{
+    auto config = create_color_module_config();
+
+    auto not_synced = video_module_interface::supported_module_config::time_sync_mode::sync_not_required;
+    std::shared_ptr<counting_samples_consumer> downstream_consumer(new counting_samples_consumer(config, not_synced));
+    std::atomic<int> upstream_processed_count(0);
+    {
+        work_stealing_executor executor(2);
+        std::shared_ptr<sync_samples_consumer> upstream_consumer(new sync_samples_consumer(
+            [&](std::shared_ptr<correlated_sample_set> sample_set)
+            {
+                //fails the second sample set, which isn't forwarded
+                return ++upstream_processed_count == 2 ? status_data_unavailable : status_no_error;
+            },
+            config, not_synced, 0, executor, 0, work_stealing_executor::priority::normal,
+            video_module_interface::supported_module_config::samples_queue_policy::block, 3));
+        upstream_consumer->add_downstream_consumer(downstream_consumer);
+
+        for(uint64_t frame = 1; frame <= 3; frame++)
+        {
+            upstream_consumer->notify_sample_set_non_blocking(create_color_sample_set(frame));
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(upstream_processed_count < 3 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        //the upstream consumer is destroyed before the downstream consumer is checked, so its forwarding completed
+        upstream_consumer.reset();
+    }
+
+    ASSERT_EQ(3, upstream_processed_count);
+    ASSERT_EQ(2u, downstream_consumer->m_sample_sets.size());
+    ASSERT_EQ(1u, (*downstream_consumer->m_sample_sets[0])[stream_type::color]->query_frame_number());
+    ASSERT_EQ(3u, (*downstream_consumer->m_sample_sets[1])[stream_type::color]->query_frame_number());
+}
+
+TEST(pipeline_samples_consumer_tests, blocking_downstream_consumer_doesnt_block_the_upstream_worker)
+{
+    auto config = create_color_module_config();
+
+    auto not_synced = video_module_interface::supported_module_config::time_sync_mode::sync_not_required;
+    auto block = video_module_interface::supported_module_config::samples_queue_policy::block;
+    std::mutex lock;
+    std::condition_variable released;
+    bool is_released = false;
+    std::atomic<int> upstream_processed_count(0);
+    std::atomic<int> downstream_processed_count(0);
+    uint64_t downstream_dropped_count = 0;
+    {
+        work_stealing_executor executor(2);
+        //the downstream handler holds one worker until it's released, so the downstream queue is full while the upstream is handled
+        std::shared_ptr<sync_samples_consumer> downstream_consumer(new sync_samples_consumer(
+            [&](std::shared_ptr<correlated_sample_set> sample_set)
+            {
+                std::unique_lock<std::mutex> handler_lock(lock);
+                released.wait(handler_lock, [&]() { return is_released; });
+                downstream_processed_count++;
+                return status_no_error;
+            },
+            config, not_synced, 0, executor, 1, work_stealing_executor::priority::normal, block, 1));
+        std::shared_ptr<sync_samples_consumer> upstream_consumer(new sync_samples_consumer(
+            [&](std::shared_ptr<correlated_sample_set> sample_set)
+            {
+                upstream_processed_count++;
+                return status_no_error;
+            },
+            config, not_synced, 0, executor, 0, work_stealing_executor::priority::normal, block, 4));
+        upstream_consumer->add_downstream_consumer(downstream_consumer);
+
+        for(uint64_t frame = 1; frame <= 4; frame++)
+        {
+            upstream_consumer->notify_sample_set_non_blocking(create_color_sample_set(frame));
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(upstream_processed_count < 4 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(4, upstream_processed_count) << "the upstream worker waited for the blocked downstream consumer";
+
+        {
+            std::lock_guard<std::mutex> release_lock(lock);
+            is_released = true;
+        }
+        released.notify_all();
+        upstream_consumer.reset();
+
+        deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(downstream_processed_count + downstream_consumer->query_dropped_sample_sets_count() < 4 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        downstream_dropped_count = downstream_consumer->query_dropped_sample_sets_count();
+    }
+
+    //the blocked handler holds one sample set and the queue another one, the other sample sets were dropped by the upstream worker
+    ASSERT_LE(2u, downstream_dropped_count);
+    ASSERT_EQ(4u, downstream_processed_count + downstream_dropped_count);
+}
+
+class recording_trace_handler : public pipeline_trace_handler
+{
+public:
+    std::vector<pipeline_trace_event> m_events;
+    void on_trace_event(const pipeline_trace_event & event) override
+    {
+        m_events.push_back(event);
+    }
+};
+
+TEST(pipeline_samples_consumer_tests, time_synced_samples_are_traced_per_consumer)
+{
+    video_module_interface::actual_module_config config = {};
+    std::strcpy(config.device_info.name, rs::utils::samples_time_sync_interface::external_device_name);
+    for(auto stream : { stream_type::color, stream_type::depth })
+    {
+        config[stream].is_enabled = true;
+        config[stream].frame_rate = 30;
+    }
+
+    auto time_synced = video_module_interface::supported_module_config::time_sync_mode::time_synced_input_only;
+    recording_trace_handler trace_handler;
+    std::shared_ptr<counting_samples_consumer> leader(new counting_samples_consumer(config, time_synced));
+    std::shared_ptr<counting_samples_consumer> follower(new counting_samples_consumer(config, time_synced));
+    leader->set_tracer(pipeline_tracer(&trace_handler, 1));
+    follower->set_tracer(pipeline_tracer(&trace_handler, 2));
+    leader->add_sync_stage_follower(follower);
+
+    for(auto stream : { stream_type::color, stream_type::depth })
+    {
+        leader->notify_sample_set_non_blocking(create_sample_set(stream, 1000., 5));
+    }
+
+    //each consumer stamps each sample of the matched sample set
+    ASSERT_EQ(4u, trace_handler.m_events.size());
+    for(size_t index = 0; index < trace_handler.m_events.size(); index++)
+    {
+        const auto & event = trace_handler.m_events[index];
+        EXPECT_EQ(pipeline_trace_stage::time_synced, event.stage);
+        EXPECT_EQ(index < 2 ? 1 : 2, event.module_uid);
+        EXPECT_EQ(5u, event.frame_number);
+        EXPECT_GT(event.time_ns, 0u);
+    }
+    EXPECT_LE(trace_handler.m_events[1].time_ns, trace_handler.m_events[2].time_ns);
+
+    const std::string trace_file_path = "pipeline_trace_test.json";
+    {
+        chrome_trace_writer trace_writer(trace_file_path.c_str());
+        for(const auto & event : trace_handler.m_events)
+        {
+            trace_writer.on_trace_event(event);
+        }
+        ASSERT_EQ(4u, trace_writer.query_events_count());
+        ASSERT_EQ(status_no_error, trace_writer.flush());
+    }
+    std::ifstream trace_file(trace_file_path);
+    std::string trace((std::istreambuf_iterator<char>(trace_file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"time_synced\""));
+    EXPECT_NE(std::string::npos, trace.find("\"frame_number\":5"));
+    trace_file.close();
+    ::remove(trace_file_path.c_str());
+}
+
+TEST(pipeline_samples_consumer_tests, pooled_sample_sets_are_recycled_and_release_their_images)
+{
+    sample_set_pool pool(2);
+    ASSERT_EQ(2u, pool.query_free_sample_sets_count());
+
+    image_info info = {};
+    rs::core::image_interface::image_data_with_data_releaser image_data(nullptr, nullptr);
+    image_interface * image = image_interface::create_instance_from_raw_data(&info, image_data, stream_type::color, image_interface::flag::any, 1000., 1);
+    image->add_ref(); //the test reference
+    {
+        auto first_sample_set = pool.acquire();
+        auto second_sample_set = pool.acquire();
+        auto grown_sample_set = pool.acquire();
+        EXPECT_EQ(0u, pool.query_free_sample_sets_count());
+        (*first_sample_set)[stream_type::color] = image;
+        auto shared_sample_set = first_sample_set;
+    }
+    //the pool grew by the sample set it allocated on demand
+    EXPECT_EQ(3u, pool.query_free_sample_sets_count());
+    EXPECT_EQ(0, image->release());
+
+    auto recycled_sample_set = pool.acquire();
+    EXPECT_EQ(nullptr, (*recycled_sample_set)[stream_type::color]);
+    EXPECT_EQ(2u, pool.query_free_sample_sets_count());
+}
+
+TEST(pipeline_sample_set_pool_tests, sample_set_owns_its_motion_batches)
+{
+    sample_set_pool pool(1);
+    std::vector<motion_sample> producer_batch(3);
+    for(size_t i = 0; i < producer_batch.size(); i++)
+    {
+        producer_batch[i].type = motion_type::gyro;
+        producer_batch[i].timestamp = 5.0 * static_cast<double>(i);
+    }
+
+    const motion_sample * batch = nullptr;
+    {
+        auto sample_set = pool.acquire();
+        sample_set->motion_batches[static_cast<uint8_t>(motion_type::gyro)] = producer_batch.data();
+        sample_set->motion_batch_sizes[static_cast<uint8_t>(motion_type::gyro)] = static_cast<uint32_t>(producer_batch.size());
+        sample_set_pool::own_motion_batches(*sample_set);
+
+        //the producer reuses its batch for the next sample set
+        producer_batch.assign(producer_batch.size(), motion_sample());
+        ASSERT_EQ(3u, sample_set->get_motion_batch(motion_type::gyro, &batch));
+        ASSERT_NE(producer_batch.data(), batch);
+        EXPECT_EQ(0.0, batch[0].timestamp);
+        EXPECT_EQ(10.0, batch[2].timestamp);
+        EXPECT_EQ(0u, sample_set->get_motion_batch(motion_type::accel, &batch));
+        EXPECT_EQ(nullptr, batch);
+    }
+
+    //the recycled sample set holds no batch
+    auto recycled_sample_set = pool.acquire();
+    EXPECT_EQ(0u, recycled_sample_set->get_motion_batch(motion_type::gyro, &batch));
+    EXPECT_EQ(nullptr, batch);
+}
+
+TEST(pipeline_samples_consumer_tests, multi_device_consumer_matches_the_latest_sample_set_of_each_device)
+{
+    auto config = create_color_module_config();
+    config.device_count = 2;
+
+    std::mutex lock;
+    std::condition_variable handled;
+    std::vector<std::vector<uint64_t>> handled_frames;
+    work_stealing_executor executor(1);
+    {
+        multi_device_samples_consumer consumer([&](const correlated_sample_set * sample_sets, uint32_t device_count)
+                                               {
+                                                   std::vector<uint64_t> frames;
+                                                   for(uint32_t device_index = 0; device_index < device_count; device_index++)
+                                                   {
+                                                       frames.push_back(sample_sets[device_index][stream_type::color]->query_frame_number());
+                                                   }
+                                                   std::lock_guard<std::mutex> handler_lock(lock);
+                                                   handled_frames.push_back(frames);
+                                                   handled.notify_all();
+                                                   return status_no_error;
+                                               },
+                                               config,
+                                               video_module_interface::supported_module_config::time_sync_mode::sync_not_required,
+                                               0,
+                                               executor,
+                                               work_stealing_executor::no_affinity,
+                                               video_module_interface::supported_module_config::samples_queue_policy::keep_latest,
+                                               1);
+        ASSERT_EQ(2u, consumer.query_device_count());
+
+        //the first device sample set is replaced by the newer one before the second device has a sample set
+        consumer.notify_sample_set_non_blocking(create_color_sample_set(1));
+        consumer.notify_sample_set_non_blocking(create_color_sample_set(2));
+        EXPECT_EQ(1u, consumer.query_statistics().query_unmatched_samples_count(stream_type::color));
+        consumer.notify_device_sample_set_non_blocking(1, create_color_sample_set(10));
+
+        std::unique_lock<std::mutex> test_lock(lock);
+        ASSERT_TRUE(handled.wait_for(test_lock, std::chrono::seconds(5), [&]() { return handled_frames.size() == 1; }));
+    }
+    ASSERT_EQ((std::vector<uint64_t>{2, 10}), handled_frames[0]);
+}
+
+TEST(pipeline_samples_consumer_tests, batched_consumer_handles_full_batches_in_order)
+{
+    auto config = create_color_module_config();
+
+    std::mutex lock;
+    std::condition_variable handled;
+    std::vector<std::vector<uint64_t>> handled_frames;
+    work_stealing_executor executor(1);
+    {
+        batched_samples_consumer consumer([&](const correlated_sample_set * sample_sets, uint32_t count)
+                                          {
+                                              std::vector<uint64_t> frames;
+                                              for(uint32_t index = 0; index < count; index++)
+                                              {
+                                                  frames.push_back(sample_sets[index][stream_type::color]->query_frame_number());
+                                              }
+                                              std::lock_guard<std::mutex> handler_lock(lock);
+                                              handled_frames.push_back(frames);
+                                              handled.notify_all();
+                                              return status_no_error;
+                                          },
+                                          config,
+                                          video_module_interface::supported_module_config::time_sync_mode::sync_not_required,
+                                          0,
+                                          executor,
+                                          work_stealing_executor::no_affinity,
+                                          work_stealing_executor::priority::normal,
+                                          video_module_interface::supported_module_config::samples_queue_policy::block,
+                                          2,
+                                          3,
+                                          0);
+
+        for(uint64_t frame = 1; frame <= 7; frame++)
+        {
+            consumer.notify_sample_set_non_blocking(create_color_sample_set(frame));
+        }
+
+        //without a batch delay the last sample set waits for a full batch
+        std::unique_lock<std::mutex> test_lock(lock);
+        ASSERT_TRUE(handled.wait_for(test_lock, std::chrono::seconds(5), [&]() { return handled_frames.size() == 2; }));
+    }
+    ASSERT_EQ(2u, handled_frames.size());
+    EXPECT_EQ((std::vector<uint64_t>{1, 2, 3}), handled_frames[0]);
+    EXPECT_EQ((std::vector<uint64_t>{4, 5, 6}), handled_frames[1]);
+}
+
+//saves the color frame number as its output, and keeps the last restored output
+class memoized_module : public video_module_interface
+{
+public:
+    memoized_module(uint64_t config_hash) : m_config_hash(config_hash), m_restored_frame(0) {}
+    int32_t query_module_uid() override { return 0x6d656d6f; }
+    status query_supported_module_config(int32_t idx, supported_module_config & supported_config) override { return status_item_unavailable; }
+    status query_current_module_config(actual_module_config & module_config) override { return status_no_error; }
+    status set_module_config(const actual_module_config & module_config) override { return status_no_error; }
+    status process_sample_set(const correlated_sample_set & sample_set) override { return status_no_error; }
+    status register_event_handler(processing_event_handler * handler) override { return status_no_error; }
+    status unregister_event_handler(processing_event_handler * handler) override { return status_no_error; }
+    status flush_resources() override { return status_no_error; }
+    status reset_config() override { return status_no_error; }
+
+    status query_module_config_hash(uint64_t & config_hash) override
+    {
+        config_hash = m_config_hash;
+        return status_no_error;
+    }
+    status save_module_output(const correlated_sample_set & sample_set, std::vector<uint8_t> & output) override
+    {
+        const uint64_t frame = sample_set[stream_type::color]->query_frame_number();
+        output.resize(sizeof(frame));
+        memcpy(output.data(), &frame, sizeof(frame));
+        return status_no_error;
+    }
+    status restore_module_output(const correlated_sample_set & sample_set, const uint8_t * output, uint32_t size) override
+    {
+        if(size != sizeof(m_restored_frame))
+        {
+            return status_param_unsupported;
+        }
+        memcpy(&m_restored_frame, output, size);
+        return status_no_error;
+    }
+
+    const uint64_t m_config_hash;
+    uint64_t m_restored_frame;
+};
+
+TEST(pipeline_module_outputs_cache_tests, unchanged_module_restores_the_outputs_of_the_previous_run)
+{
+    std::vector<std::shared_ptr<correlated_sample_set>> sample_sets;
+    for(uint64_t frame = 1; frame <= 3; frame++)
+    {
+        sample_sets.push_back(create_color_sample_set(frame));
+    }
+    memoized_module module(1), changed_module(2);
+    const std::string cache_path = ".";
+    auto remove_cache_files = [&]()
+    {
+        for(auto cv_module : { &module, &changed_module })
+        {
+            std::ostringstream file_path;
+            file_path << cache_path << "/module_" << cv_module->query_module_uid() << "_" << std::hex << std::setw(16) << std::setfill('0')
+                      << cv_module->m_config_hash << ".rsmo";
+            std::remove(file_path.str().c_str());
+        }
+    };
+    remove_cache_files();
+
+    //the first run processes the sample sets and saves their outputs
+    auto first_run = module_outputs_cache::open(cache_path, 7, &module);
+    ASSERT_NE(nullptr, first_run);
+    for(auto & sample_set : sample_sets)
+    {
+        EXPECT_FALSE(first_run->restore(*sample_set));
+        first_run->save(*sample_set);
+    }
+    first_run.reset();
+
+    //the next run of the same module restores them, a run of another recording or a changed module processes them
+    auto second_run = module_outputs_cache::open(cache_path, 7, &module);
+    ASSERT_NE(nullptr, second_run);
+    EXPECT_TRUE(second_run->restore(*sample_sets[1]));
+    EXPECT_EQ(2u, module.m_restored_frame);
+    EXPECT_TRUE(second_run->restore(*sample_sets[2]));
+    EXPECT_EQ(3u, module.m_restored_frame);
+    EXPECT_FALSE(module_outputs_cache::open(cache_path, 8, &module)->restore(*sample_sets[0]));
+    EXPECT_FALSE(module_outputs_cache::open(cache_path, 7, &changed_module)->restore(*sample_sets[0]));
+    second_run.reset();
+    remove_cache_files();
+}
+
+TEST(pipeline_projection_tests, lazy_projection_of_uninitialized_calibration_is_unavailable)
+{
+    intrinsics color_intrinsics = {}, depth_intrinsics = {};
+    extrinsics depth_to_color_extrinsics = {};
+    rs::utils::unique_ptr<projection_interface> projection(new lazy_projection(color_intrinsics, depth_intrinsics, depth_to_color_extrinsics));
+
+    point3dF32 pos_uvz = { 1.f, 1.f, 1.f };
+    pointF32 pos_ij = {};
+    EXPECT_EQ(status_data_unavailable, projection->map_depth_to_color(1, &pos_uvz, &pos_ij));
+    EXPECT_EQ(nullptr, projection->create_color_image_mapped_to_depth(nullptr, nullptr));
+
+    //the failed calibration is cached, a projection of the same calibration doesn't initialize it again
+    rs::utils::unique_ptr<projection_interface> same_calibration_projection(new lazy_projection(color_intrinsics, depth_intrinsics, depth_to_color_extrinsics));
+    EXPECT_EQ(status_data_unavailable, same_calibration_projection->project_depth_to_camera(1, &pos_uvz, &pos_uvz));
+}
+
+TEST(pipeline_module_registry_tests, registry_module_answers_from_the_manifest_until_configured)
+{
+    const std::string manifest_path = module_manifest_path("librealsense_missing_module.so");
+    module_manifest manifest;
+    manifest.uid = 1234;
+    manifest.library_name = "librealsense_missing_module.so";
+    video_module_interface::supported_module_config supported_config = {};
+    supported_config.image_streams_configs[static_cast<uint32_t>(stream_type::depth)].is_enabled = true;
+    supported_config.image_streams_configs[static_cast<uint32_t>(stream_type::depth)].size = { 628, 468 };
+    supported_config.concurrent_samples_count = 3;
+    manifest.supported_configs.push_back(supported_config);
+    ASSERT_EQ(status_no_error, write_module_manifest(manifest_path, manifest));
+
+    video_module_registry registry;
+    ASSERT_EQ(status_no_error, registry.add_manifest(manifest_path.c_str()));
+    EXPECT_EQ(status_key_already_exists, registry.add_manifest(manifest_path.c_str()));
+    std::remove(manifest_path.c_str());
+    ASSERT_EQ(1u, registry.query_modules_count());
+
+    uint32_t index = 0;
+    ASSERT_EQ(status_no_error, registry.find_module(1234, index));
+    video_module_registry::module_info info = {};
+    ASSERT_EQ(status_no_error, registry.query_module_info(index, info));
+    EXPECT_EQ(1234, info.uid);
+    EXPECT_STREQ("librealsense_missing_module.so", info.library_path);
+    EXPECT_EQ(1u, info.supported_configs_count);
+
+    //the metadata is read from the manifest, the library isn't loaded
+    video_module_interface * module = registry.create_module(index);
+    ASSERT_NE(nullptr, module);
+    EXPECT_EQ(1234, module->query_module_uid());
+    video_module_interface::supported_module_config module_config = {};
+    ASSERT_EQ(status_no_error, module->query_supported_module_config(0, module_config));
+    EXPECT_EQ(628, module_config.image_streams_configs[static_cast<uint32_t>(stream_type::depth)].size.width);
+    EXPECT_EQ(3u, module_config.concurrent_samples_count);
+    EXPECT_GT(status_no_error, module->query_supported_module_config(1, module_config));
+    EXPECT_EQ(nullptr, registry.query_loaded_module(module));
+    EXPECT_EQ(status_no_error, module->flush_resources());
+    EXPECT_EQ(status_data_unavailable, module->process_sample_set(correlated_sample_set()));
+
+    //the library is loaded by the configuration
+    video_module_interface::actual_module_config actual_config = {};
+    EXPECT_EQ(status_init_failed, module->set_module_config(actual_config));
+    EXPECT_EQ(nullptr, registry.query_loaded_module(module));
+}
+
+TEST(max_depth_value_module_tests, max_value_in_roi_with_processing_threads)
+{
+    const int32_t width = 643, height = 37, pitch = 1296;
+    std::vector<uint8_t> data(pitch * height, 0);
+    auto set_pixel = [&](int32_t x, int32_t y, uint16_t value) { std::memcpy(data.data() + y * pitch + x * 2, &value, sizeof(value)); };
+    set_pixel(642, 36, 60000); //the last pixel, beyond the vector body of the row
+    set_pixel(10, 5, 40000);
+    set_pixel(321, 20, 50000);
+
+    image_info info = { width, height, pixel_format::z16, pitch };
+    std::shared_ptr<image_interface> depth_image(image_interface::create_instance_from_raw_data(&info, { data.data(), nullptr },
+                                                 stream_type::depth, image_interface::flag::any, 1.0, 7), [](image_interface * image) { image->release(); });
+
+    max_depth_value_module_testing module;
+    max_depth_value_output_interface::max_depth_value_output_data output_data = {};
+    for(uint32_t number_of_threads : { 1u, 4u, 16u })
+    {
+        ASSERT_EQ(status_no_error, module.set_number_of_processing_threads(number_of_threads));
+        ASSERT_EQ(status_no_error, module.set_roi({}));
+        ASSERT_EQ(status_no_error, module.process_depth_image(depth_image, output_data));
+        EXPECT_EQ(60000, output_data.max_depth_value);
+        EXPECT_EQ(7u, output_data.frame_number);
+
+        ASSERT_EQ(status_no_error, module.set_roi({ 0, 0, 300, 30 }));
+        ASSERT_EQ(status_no_error, module.process_depth_image(depth_image, output_data));
+        EXPECT_EQ(40000, output_data.max_depth_value);
+
+        //the roi is clamped to the image
+        ASSERT_EQ(status_no_error, module.set_roi({ 300, 10, 1000, 1000 }));
+        ASSERT_EQ(status_no_error, module.process_depth_image(depth_image, output_data));
+        EXPECT_EQ(60000, output_data.max_depth_value);
+    }
+    EXPECT_EQ(status_param_unsupported, module.set_number_of_processing_threads(0));
+    EXPECT_EQ(status_invalid_argument, module.set_roi({ -1, 0, 10, 10 }));
+}
@@ -3,15 +3,28 @@
 
 #include <stdio.h>
 #include <map>
+#include <fstream>
 #include <chrono>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/mman.h>
+#endif
 #include "gtest/gtest.h"
 #include "rs/playback/playback_device.h"
 #include "rs/playback/playback_context.h"
 #include "rs/record/record_context.h"
 #include "librealsense/rs.hpp"
 #include "file_types.h"
+#include "range_file.h"
+#include "direct_range_source.h"
+#include "shared_frames_cache.h"
 #include "rs/utils/librealsense_conversion_utils.h"
 #include "viewer.h"
 #include "utilities/utilities.h"
@@ -664,6 +677,57 @@ TEST_P(playback_streaming_fixture, poll_for_frames)
     device->stop();
 }
 
+TEST_P(playback_streaming_fixture, try_wait_for_frames)
+{
+    //prevent from runnimg async file with wait for frames
+    rs::playback::file_info file_info = device->get_file_info();
+    if(file_info.capture_mode == rs::playback::capture_mode::asynced) return;
+
+    auto stream_count = playback_tests_util::enable_available_streams(device);
+    auto it = setup::profiles.begin();
+    ASSERT_NE(it, setup::profiles.end());
+    rs::stream stream = it->first;
+    EXPECT_FALSE(device->try_wait_for_frames(10));
+    device->start();
+    ASSERT_TRUE(device->try_wait_for_frames(1000));
+    auto first = device->get_frame_index(stream);
+    ASSERT_TRUE(device->try_wait_for_frames(1000));
+    EXPECT_GT(device->get_frame_index(stream), first);
+    device->pause();
+    EXPECT_FALSE(device->try_wait_for_frames(1000));
+    device->stop();
+}
+
+#ifdef __linux__
+TEST_P(playback_streaming_fixture, frames_ready_handle)
+{
+    //prevent from runnimg async file with wait for frames
+    rs::playback::file_info file_info = device->get_file_info();
+    if(file_info.capture_mode == rs::playback::capture_mode::asynced) return;
+
+    auto stream_count = playback_tests_util::enable_available_streams(device);
+    auto it = setup::profiles.begin();
+    ASSERT_NE(it, setup::profiles.end());
+    rs::stream stream = it->first;
+    auto handle = device->get_frames_ready_handle();
+    ASSERT_NE(-1, handle);
+    EXPECT_EQ(handle, device->get_frames_ready_handle());
+    pollfd descriptor = { static_cast<int>(handle), POLLIN, 0 };
+    EXPECT_EQ(0, poll(&descriptor, 1, 0));
+    device->start();
+    int last_index = -1;
+    for(int i = 0; i < 3; i++)
+    {
+        //the handle is readable once the next frames set is available, and is reset by the poll for frames
+        ASSERT_EQ(1, poll(&descriptor, 1, 1000));
+        ASSERT_TRUE(device->poll_for_frames());
+        EXPECT_GT(device->get_frame_index(stream), last_index);
+        last_index = device->get_frame_index(stream);
+    }
+    device->stop();
+}
+#endif
+
 TEST_P(playback_streaming_fixture, get_frame_timestamp)
 {
     auto stream_count = playback_tests_util::enable_available_streams(device);
@@ -702,6 +766,43 @@ TEST_P(playback_streaming_fixture, get_frame_data)
     }
 }
 
+TEST_P(playback_streaming_fixture, scrub_back_and_forth)
+{
+    auto stream_count = playback_tests_util::enable_available_streams(device);
+    ASSERT_NE(0, stream_count);
+    rs::stream stream = rs::stream::depth;
+    const int frames_count = std::min(10, device->get_frame_count(stream));
+    ASSERT_LT(0, frames_count);
+    auto frame_size = static_cast<size_t>(device->get_stream_width(stream) * device->get_stream_height(stream) * 2);
+
+    //the frames scrubbed forward are returned from the cache when scrubbing backward, with the same content
+    std::vector<std::vector<uint8_t>> frames(frames_count);
+    std::vector<unsigned long long> frame_numbers(frames_count);
+    for(int i = 0; i < frames_count; i++)
+    {
+        ASSERT_TRUE(device->set_frame_by_index(i, stream));
+        auto data = static_cast<const uint8_t*>(device->get_frame_data(stream));
+        ASSERT_NE(nullptr, data);
+        frames[i].assign(data, data + frame_size);
+        frame_numbers[i] = device->get_frame_number(stream);
+    }
+    for(int i = frames_count - 1; i >= 0; i--)
+    {
+        ASSERT_TRUE(device->set_frame_by_index(i, stream));
+        auto data = static_cast<const uint8_t*>(device->get_frame_data(stream));
+        ASSERT_NE(nullptr, data);
+        EXPECT_EQ(frame_numbers[i], device->get_frame_number(stream));
+        EXPECT_EQ(0, memcmp(frames[i].data(), data, frame_size));
+    }
+
+    //the playback continues from the scrubbed frame
+    device->set_real_time(false);
+    device->start();
+    device->wait_for_frames();
+    EXPECT_NE(nullptr, device->get_frame_data(stream));
+    device->stop();
+}
+
 TEST_P(playback_streaming_fixture, is_real_time)
 {
     device->set_real_time(false);
@@ -737,6 +838,29 @@ TEST_P(playback_streaming_fixture, non_real_time_playback)
     device->stop();
 }
 
+TEST_P(playback_streaming_fixture, decimated_playback_delivers_every_nth_frame)
+{
+    const uint32_t frames_interval = 4;
+    auto stream_count = playback_tests_util::enable_available_streams(device);
+    ASSERT_NE(0, stream_count);
+    auto stream = setup::profiles.begin()->first;
+    ASSERT_TRUE(device->set_frame_decimation(stream, frames_interval, 0));
+    EXPECT_FALSE(device->set_frame_decimation(stream, frames_interval, -1));
+
+    std::atomic<uint32_t> frames_count(0);
+    device->set_frame_callback(stream, [&frames_count](rs::frame f) { frames_count++; });
+    device->set_real_time(false);
+    device->start();
+    EXPECT_FALSE(device->set_frame_decimation(stream, 1, 0));
+    while(device->is_streaming())
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    device->stop();
+    ASSERT_TRUE(device->set_frame_decimation(stream, 1, 0));
+
+    //the skipped frames are neither read nor delivered
+    EXPECT_EQ((static_cast<uint32_t>(device->get_frame_count(stream)) + frames_interval - 1) / frames_interval, frames_count.load());
+}
+
 TEST_P(playback_streaming_fixture, pause)
 {
     //prevent from runnimg async file with wait for frames
@@ -842,6 +966,16 @@ TEST_P(playback_streaming_fixture, get_frame_index)
     EXPECT_EQ(index, device->get_frame_index(stream));
 }
 
+TEST_P(playback_streaming_fixture, get_index_progress)
+{
+    auto progress = device->get_index_progress();
+    EXPECT_LE(0.0, progress);
+    EXPECT_GE(1.0, progress);
+    //indexing the recording to its end
+    device->get_frame_count();
+    EXPECT_DOUBLE_EQ(1.0, device->get_index_progress());
+}
+
 TEST_P(playback_streaming_fixture, get_frame_count)
 {
     auto stream_count = playback_tests_util::enable_available_streams(device);
@@ -873,6 +1007,593 @@ TEST_P(playback_streaming_fixture, get_frame_count)
     }
 }
 
+TEST_P(playback_streaming_fixture, read_frames_batch)
+{
+    auto stream_count = static_cast<size_t>(playback_tests_util::enable_available_streams(device));
+
+    std::map<rs::stream,int> frame_counter;
+    std::vector<std::map<rs::stream, rs::frame>> batch;
+    while(device->read_frames_batch(batch, 16) > 0)
+    {
+        EXPECT_LE(batch.size(), 16u);
+        for(auto & frames_set : batch)
+        {
+            EXPECT_LE(frames_set.size(), stream_count);
+            for(auto & frame : frames_set)
+            {
+                EXPECT_EQ(frame.first, frame.second.get_stream_type());
+                EXPECT_NE(nullptr, frame.second.get_data());
+                frame_counter[frame.first]++;
+            }
+        }
+    }
+    EXPECT_FALSE(device->is_streaming());
+
+    ASSERT_EQ(stream_count, frame_counter.size());
+    for(auto it = frame_counter.begin(); it != frame_counter.end(); ++it)
+    {
+        auto stream = it->first;
+        EXPECT_EQ(device->get_frame_count(stream), it->second);
+    }
+}
+
+TEST_P(playback_streaming_fixture, compute_synced_sets)
+{
+    std::vector<rs::stream> streams;
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+        streams.push_back(it->first);
+
+    rs::playback::synced_sets sets;
+    ASSERT_TRUE(device->compute_synced_sets(streams, 0, sets));
+    EXPECT_EQ(streams.size(), sets.streams.size());
+    EXPECT_LT(0u, sets.size());
+    EXPECT_EQ(sets.size() * streams.size(), sets.frame_indices.size());
+    EXPECT_TRUE(std::is_sorted(sets.time_stamps.begin(), sets.time_stamps.end()));
+
+    uint32_t sets_count = 0;
+    std::vector<std::map<rs::stream, rs::frame>> batch;
+    while(device->read_synced_sets(sets, sets_count, batch, 16) > 0)
+    {
+        for(auto & frames_set : batch)
+        {
+            EXPECT_EQ(streams.size(), frames_set.size());
+            for(size_t i = 0; i < streams.size(); i++)
+            {
+                auto frame = frames_set.find(streams[i]);
+                ASSERT_NE(frames_set.end(), frame);
+                EXPECT_NE(nullptr, frame->second.get_data());
+                EXPECT_LE(sets.time_stamps[sets_count] - frame->second.get_timestamp(), 1000.0 / frame->second.get_framerate());
+            }
+            sets_count++;
+        }
+    }
+    EXPECT_EQ(sets.size(), sets_count);
+    EXPECT_FALSE(device->compute_synced_sets({}, 0, sets));
+}
+
+TEST_P(playback_streaming_fixture, read_frames_batch_backwards)
+{
+    auto stream_count = playback_tests_util::enable_available_streams(device);
+
+    EXPECT_FALSE(device->set_playback_rate(0.1));
+    EXPECT_FALSE(device->set_playback_rate(-32));
+    ASSERT_TRUE(device->set_playback_rate(-1));
+    EXPECT_EQ(-1, device->get_playback_rate());
+
+    std::map<rs::stream,int> frame_counter;
+    std::map<rs::stream,unsigned long long> prev_frame_number;
+    std::vector<std::map<rs::stream, rs::frame>> batch;
+    while(device->read_frames_batch(batch, 16) > 0)
+    {
+        for(auto & frames_set : batch)
+        {
+            for(auto & frame : frames_set)
+            {
+                auto frame_number = frame.second.get_frame_number();
+                if(prev_frame_number.find(frame.first) != prev_frame_number.end())
+                    EXPECT_GT(prev_frame_number[frame.first], frame_number);
+                prev_frame_number[frame.first] = frame_number;
+                frame_counter[frame.first]++;
+            }
+        }
+    }
+
+    ASSERT_EQ(stream_count, frame_counter.size());
+    for(auto it = frame_counter.begin(); it != frame_counter.end(); ++it)
+        EXPECT_EQ(device->get_frame_count(it->first), it->second);
+    EXPECT_TRUE(device->set_playback_rate(1));
+}
+
+TEST_P(playback_streaming_fixture, frames_are_decoded_into_allocated_buffers)
+{
+    playback_tests_util::enable_available_streams(device);
+
+    const int padding = 64;
+    std::mutex mutex;
+    std::map<const void*, int> buffers_strides;
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        auto allocator = [&](int width, int height, int bpp, int & stride)
+        {
+            stride += padding;
+            auto buffer = std::shared_ptr<uint8_t>(new uint8_t[stride * height], std::default_delete<uint8_t[]>());
+            std::lock_guard<std::mutex> guard(mutex);
+            buffers_strides[buffer.get()] = stride;
+            return buffer;
+        };
+        ASSERT_TRUE(device->set_frame_buffer_allocator(it->first, allocator));
+    }
+
+    std::vector<std::map<rs::stream, rs::frame>> batch;
+    while(device->read_frames_batch(batch, 16) > 0)
+    {
+        for(auto & frames_set : batch)
+        {
+            for(auto & frame : frames_set)
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                //uncompressed frames are delivered from the playback buffers
+                auto buffer = buffers_strides.find(frame.second.get_data());
+                if(buffer == buffers_strides.end())
+                    continue;
+                EXPECT_EQ(buffer->second, frame.second.get_stride());
+            }
+        }
+    }
+}
+
+TEST_P(playback_streaming_fixture, concurrent_playback)
+{
+    //the devices share the io scheduler threads
+    const int devices_count = 8;
+    std::vector<std::unique_ptr<rs::playback::context>> contexts;
+    std::vector<rs::playback::device*> devices;
+    std::vector<std::map<rs::stream,int>> frame_counters(devices_count);
+    std::mutex mutex;
+    for(int i = 0; i < devices_count; i++)
+    {
+        contexts.emplace_back(new rs::playback::context(GetParam().c_str()));
+        auto playback = contexts.back()->get_playback_device();
+        ASSERT_NE(nullptr, playback);
+        playback_tests_util::enable_available_streams(playback);
+        for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+        {
+            auto & frame_counter = frame_counters[i];
+            playback->set_frame_callback(it->first, [&frame_counter, &mutex](rs::frame f)
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                frame_counter[f.get_stream_type()]++;
+            });
+        }
+        playback->set_real_time(false);
+        devices.push_back(playback);
+    }
+
+    for(auto playback : devices)
+        playback->start();
+    for(auto playback : devices)
+    {
+        while(playback->is_streaming())
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        playback->stop();
+    }
+
+    for(int i = 0; i < devices_count; i++)
+    {
+        for(auto it = frame_counters[i].begin(); it != frame_counters[i].end(); ++it)
+            EXPECT_EQ(devices[i]->get_frame_count(it->first), it->second);
+    }
+}
+
+TEST_P(playback_streaming_fixture, extract)
+{
+    const std::string clip_path = "rstest_extract.rssdk";
+    auto streams = setup::profiles.begin();
+    auto stream = streams->first;
+
+    //the recorded samples are captured during the first seconds of the file
+    ASSERT_TRUE(device->extract(clip_path.c_str(), 0, 60000, { stream }, false));
+    {
+        rs::playback::context clip_context(clip_path.c_str());
+        auto clip = clip_context.get_playback_device();
+        ASSERT_NE(nullptr, clip);
+        for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+        {
+            if(it->first == stream)
+                EXPECT_NE(0, clip->get_stream_mode_count(it->first));
+            else
+                EXPECT_EQ(0, clip->get_stream_mode_count(it->first));
+        }
+        EXPECT_EQ(device->get_frame_count(stream), clip->get_frame_count(stream));
+    }
+
+    //an empty range has no frames
+    ASSERT_TRUE(device->extract(clip_path.c_str(), 60000, 120000, { stream }, false));
+    {
+        rs::playback::context clip_context(clip_path.c_str());
+        auto clip = clip_context.get_playback_device();
+        ASSERT_NE(nullptr, clip);
+        EXPECT_EQ(0, clip->get_frame_count(stream));
+    }
+
+    EXPECT_FALSE(device->extract(GetParam().c_str(), 0, 60000, { stream }, false));
+    EXPECT_FALSE(device->extract(clip_path.c_str(), 1000, 1000, { stream }, false));
+    ::remove(clip_path.c_str());
+}
+
+TEST_P(playback_streaming_fixture, export_mcap)
+{
+    const std::string export_path = "rstest_export.mcap";
+    const char magic[] = { '\x89', 'M', 'C', 'A', 'P', '0', '\r', '\n' };
+    std::vector<rs::stream> streams;
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+        streams.push_back(it->first);
+
+    for(auto decode_frames : { false, true })
+    {
+        ASSERT_TRUE(device->export_mcap(export_path.c_str(), streams, true, decode_frames));
+        std::ifstream file(export_path, std::ios::binary | std::ios::ate);
+        ASSERT_TRUE(file.good());
+        auto size = static_cast<size_t>(file.tellg());
+        ASSERT_LT(2 * sizeof(magic), size);
+        char head[sizeof(magic)] = {};
+        char tail[sizeof(magic)] = {};
+        file.seekg(0);
+        file.read(head, sizeof(head));
+        file.seekg(size - sizeof(tail));
+        file.read(tail, sizeof(tail));
+        EXPECT_EQ(0, memcmp(magic, head, sizeof(magic)));
+        EXPECT_EQ(0, memcmp(magic, tail, sizeof(magic)));
+    }
+
+    EXPECT_FALSE(device->export_mcap(GetParam().c_str(), streams, true, false));
+    ::remove(export_path.c_str());
+}
+
+TEST_P(playback_streaming_fixture, verify_checksums)
+{
+    rs::playback::verification_result result = {};
+    ASSERT_TRUE(device->verify(result));
+    EXPECT_LT(0u, result.verified_samples_count);
+    EXPECT_EQ(0u, result.corrupted_samples_count);
+
+    //a byte flipped in the middle of the recording corrupts a single sample
+    const std::string copy_path = "rstest_corrupted.rssdk";
+    {
+        std::ifstream source(GetParam(), std::ios::binary);
+        std::ofstream copy(copy_path, std::ios::binary);
+        copy << source.rdbuf();
+    }
+    std::streamoff middle = 0;
+    {
+        std::fstream copy(copy_path, std::ios::binary | std::ios::in | std::ios::out);
+        copy.seekg(0, std::ios::end);
+        middle = static_cast<std::streamoff>(copy.tellg()) / 2;
+        char byte = 0;
+        copy.seekg(middle);
+        copy.read(&byte, 1);
+        byte = static_cast<char>(~byte);
+        copy.seekp(middle);
+        copy.write(&byte, 1);
+    }
+    {
+        rs::playback::context copy_context(copy_path.c_str());
+        auto copy = copy_context.get_playback_device();
+        ASSERT_NE(nullptr, copy);
+        rs::playback::verification_result copy_result = {};
+        ASSERT_TRUE(copy->verify(copy_result));
+        EXPECT_EQ(1u, copy_result.corrupted_samples_count);
+        EXPECT_EQ(result.verified_samples_count, copy_result.verified_samples_count + 1);
+        EXPECT_LT(copy_result.first_corrupted_offset, static_cast<uint64_t>(middle));
+    }
+    ::remove(copy_path.c_str());
+}
+
+TEST_P(playback_streaming_fixture, synchronized_playback)
+{
+    const char * file_paths[] = { GetParam().c_str(), GetParam().c_str() };
+    rs::playback::context synchronized_context(file_paths, 2);
+    ASSERT_EQ(2, synchronized_context.get_device_count());
+    EXPECT_EQ(0u, synchronized_context.get_start_time(0));
+    EXPECT_EQ(0u, synchronized_context.get_start_time(1));
+    EXPECT_EQ(nullptr, synchronized_context.get_playback_device(2));
+
+    rs::stream stream = rs::stream::depth;
+    std::mutex mutex;
+    std::vector<int> frames_count(2, 0);
+    for(int i = 0; i < 2; i++)
+    {
+        auto synchronized_device = synchronized_context.get_playback_device(i);
+        ASSERT_NE(nullptr, synchronized_device);
+        ASSERT_NE(0, playback_tests_util::enable_available_streams(synchronized_device));
+        synchronized_device->set_frame_callback(stream, [&mutex, &frames_count, i](rs::frame f)
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            frames_count[i]++;
+        });
+    }
+
+    //both devices are set to the same frame of the common time line
+    ASSERT_TRUE(synchronized_context.set_time(2000000));
+    auto first_index = synchronized_context.get_playback_device(0)->get_frame_index(stream);
+    EXPECT_LT(0, first_index);
+    EXPECT_EQ(first_index, synchronized_context.get_playback_device(1)->get_frame_index(stream));
+    EXPECT_FALSE(synchronized_context.set_time(1000000000));
+
+    ASSERT_TRUE(synchronized_context.set_time(0));
+    for(int i = 0; i < 2; i++)
+        synchronized_context.get_playback_device(i)->start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    for(int i = 0; i < 2; i++)
+        synchronized_context.get_playback_device(i)->stop();
+
+    //the devices play by the same clock
+    std::lock_guard<std::mutex> guard(mutex);
+    EXPECT_LT(0, frames_count[0]);
+    EXPECT_GE(2, std::abs(frames_count[0] - frames_count[1]));
+}
+
+TEST_P(playback_streaming_fixture, looped_playback)
+{
+    auto stream_count = playback_tests_util::enable_available_streams(device);
+    ASSERT_NE(0, stream_count);
+    rs::stream stream = rs::stream::depth;
+    const int frames_count = device->get_frame_count(stream);
+    ASSERT_LT(0, frames_count);
+    device->set_real_time(false);
+
+    //the loops held in memory and the loops which read the file again continue the frame numbers and the time stamps
+    for(uint64_t memory_size : { 1024ull * 1024 * 1024, 0ull })
+    {
+        ASSERT_TRUE(device->set_looped_playback(true, memory_size));
+        std::mutex mutex;
+        std::vector<std::pair<unsigned long long, double>> frames;
+        device->set_frame_callback(stream, [&mutex, &frames](rs::frame f)
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            frames.emplace_back(f.get_frame_number(), f.get_timestamp());
+        });
+        device->start();
+        EXPECT_FALSE(device->set_looped_playback(false, 0));
+        for(;;)
+        {
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                if(frames.size() >= static_cast<size_t>(frames_count) * 3)
+                    break;
+            }
+            ASSERT_TRUE(device->is_streaming());
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        device->stop();
+        std::lock_guard<std::mutex> guard(mutex);
+        for(size_t i = 1; i < frames.size(); i++)
+        {
+            EXPECT_LT(frames[i - 1].first, frames[i].first);
+            EXPECT_LT(frames[i - 1].second, frames[i].second);
+        }
+    }
+    ASSERT_TRUE(device->set_looped_playback(false, 0));
+}
+
+TEST_P(playback_streaming_fixture, scan_frames)
+{
+    //the scan describes each recorded frame once, in stream order, and continues from its position
+    std::map<rs::stream, int32_t> frames_count;
+    std::vector<rs::playback::frame_descriptor> frames;
+    uint64_t position = 0;
+    uint64_t previous_capture_time = 0;
+    while(device->scan_frames(position, frames, 64, true) > 0)
+    {
+        for(auto & frame : frames)
+        {
+            EXPECT_EQ(frames_count[frame.stream]++, frame.frame_index);
+            EXPECT_LE(previous_capture_time, frame.capture_time);
+            previous_capture_time = frame.capture_time;
+        }
+    }
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+        EXPECT_EQ(device->get_frame_count(it->first), frames_count[it->first]);
+
+    //the scan matches the frames which are played, and doesn't move the playback position
+    auto stream_count = playback_tests_util::enable_available_streams(device);
+    ASSERT_NE(0, stream_count);
+    rs::stream stream = rs::stream::depth;
+    position = 0;
+    ASSERT_LT(0u, device->scan_frames(position, frames, 1024, false));
+    auto first = std::find_if(frames.begin(), frames.end(), [stream](const rs::playback::frame_descriptor & f) { return f.stream == stream; });
+    ASSERT_NE(frames.end(), first);
+    EXPECT_EQ(0u, first->metadata_mask);
+    ASSERT_TRUE(device->set_frame_by_index(0, stream));
+    EXPECT_EQ(first->frame_number, device->get_frame_number(stream));
+    EXPECT_EQ(0, device->get_frame_index(stream));
+
+    device->start();
+    EXPECT_EQ(0u, device->scan_frames(position, frames, 1, false));
+    device->stop();
+}
+
+TEST_P(playback_streaming_fixture, recover_from_checkpoint)
+{
+    using namespace rs::core::file_types;
+    const std::string copy_path = "rstest_checkpoint.rssdk";
+    {
+        std::ifstream source(GetParam(), std::ios::binary);
+        std::ofstream copy(copy_path, std::ios::binary);
+        copy << source.rdbuf();
+    }
+
+    //an index of a recording which wasn't closed, the last checkpoint covers the first half of the samples
+    std::ifstream index(samples_index_path(GetParam()), std::ios::binary);
+    ASSERT_TRUE(index.good());
+    disk_format::samples_index_header header = {};
+    index.read(reinterpret_cast<char*>(&header), sizeof(header));
+    std::vector<disk_format::sample_index_entry> entries(header.samples_count);
+    index.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(disk_format::sample_index_entry));
+    ASSERT_TRUE(index.good());
+    auto checkpoint = entries.size() / 2;
+    while(checkpoint < entries.size() && entries[checkpoint].info.type != sample_type::st_image)
+        checkpoint++;
+    ASSERT_LT(checkpoint, entries.size());
+    header.completed = 0;
+    header.samples_count = checkpoint;
+    header.checkpoint_position = entries[checkpoint].info.offset;
+    {
+        std::ofstream copy_index(samples_index_path(copy_path), std::ios::binary);
+        copy_index.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        copy_index.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(disk_format::sample_index_entry));
+    }
+
+    {
+        rs::playback::context copy_context(copy_path.c_str());
+        auto copy = copy_context.get_playback_device();
+        ASSERT_NE(nullptr, copy);
+        for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+            EXPECT_EQ(device->get_frame_count(it->first), copy->get_frame_count(it->first));
+    }
+    ::remove(samples_index_path(copy_path).c_str());
+    ::remove(copy_path.c_str());
+}
+
+TEST_P(playback_streaming_fixture, range_file_read)
+{
+    //serves the ranges from the local recording, as a remote source would
+    class local_range_source : public rs::core::range_source
+    {
+    public:
+        rs::core::status open(const std::string& location) override { return m_file.open(location, rs::core::open_file_option::read); }
+        uint64_t query_size() override
+        {
+            uint64_t size = 0;
+            m_file.set_position(0, rs::core::move_method::end, &size);
+            return size;
+        }
+        rs::core::status read_range(uint64_t offset, uint8_t * data, uint32_t number_of_bytes) override
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            uint32_t number_of_bytes_read = 0;
+            m_file.set_position(offset, rs::core::move_method::begin);
+            return m_file.read_bytes(data, number_of_bytes, number_of_bytes_read);
+        }
+    private:
+        std::mutex m_mutex;
+        rs::core::file m_file;
+    };
+
+    rs::core::file local;
+    ASSERT_EQ(rs::core::status_no_error, local.open(GetParam(), rs::core::open_file_option::read));
+    rs::core::range_file remote(std::unique_ptr<rs::core::range_source>(new local_range_source()));
+    ASSERT_EQ(rs::core::status_no_error, remote.open(GetParam(), rs::core::open_file_option::read));
+
+    uint64_t size = 0;
+    ASSERT_EQ(rs::core::status_no_error, remote.set_position(0, rs::core::move_method::end, &size));
+    //reads across the blocks boundaries, with and without read ahead hints
+    std::vector<uint64_t> offsets = { 0, rs::core::range_file::BLOCK_SIZE - 100, size / 2, size - 1000 };
+    remote.read_ahead(size / 2, 2 * rs::core::range_file::BLOCK_SIZE);
+    for(auto offset : offsets)
+    {
+        std::vector<uint8_t> expected(std::min<uint64_t>(1000, size - offset)), actual(expected.size());
+        local.set_position(offset, rs::core::move_method::begin);
+        remote.set_position(offset, rs::core::move_method::begin);
+        uint32_t number_of_bytes_read = 0;
+        ASSERT_EQ(rs::core::status_no_error, local.read_bytes(expected.data(), static_cast<uint32_t>(expected.size()), number_of_bytes_read));
+        ASSERT_EQ(rs::core::status_no_error, remote.read_bytes(actual.data(), static_cast<uint32_t>(actual.size()), number_of_bytes_read));
+        EXPECT_EQ(expected, actual);
+    }
+
+    //reading past the end fails until the file is reset
+    uint8_t byte = 0;
+    uint32_t number_of_bytes_read = 0;
+    remote.set_position(0, rs::core::move_method::end);
+    EXPECT_NE(rs::core::status_no_error, remote.read_bytes(&byte, 1, number_of_bytes_read));
+    EXPECT_FALSE(remote.is_good());
+    remote.reset();
+    EXPECT_TRUE(remote.is_good());
+}
+
+TEST_P(playback_streaming_fixture, direct_io_range_read)
+{
+    rs::core::file local;
+    ASSERT_EQ(rs::core::status_no_error, local.open(GetParam(), rs::core::open_file_option::read));
+    rs::core::range_file direct(std::unique_ptr<rs::core::range_source>(new rs::core::direct_range_source()));
+    //file systems such as tmpfs don't support direct io
+    if(direct.open(GetParam(), rs::core::open_file_option::read) != rs::core::status_no_error)
+        return;
+
+    uint64_t size = 0;
+    ASSERT_EQ(rs::core::status_no_error, direct.set_position(0, rs::core::move_method::end, &size));
+    //unaligned reads across the blocks boundaries and at the unaligned end of the file
+    std::vector<uint64_t> offsets = { 1, rs::core::range_file::BLOCK_SIZE - 100, size / 2 + 7, size - 1000 };
+    for(auto offset : offsets)
+    {
+        std::vector<uint8_t> expected(std::min<uint64_t>(1000, size - offset)), actual(expected.size());
+        local.set_position(offset, rs::core::move_method::begin);
+        direct.set_position(offset, rs::core::move_method::begin);
+        uint32_t number_of_bytes_read = 0;
+        ASSERT_EQ(rs::core::status_no_error, local.read_bytes(expected.data(), static_cast<uint32_t>(expected.size()), number_of_bytes_read));
+        ASSERT_EQ(rs::core::status_no_error, direct.read_bytes(actual.data(), static_cast<uint32_t>(actual.size()), number_of_bytes_read));
+        EXPECT_EQ(expected, actual);
+    }
+}
+
+TEST_P(playback_streaming_fixture, shared_frames_cache_evicts_least_recently_used)
+{
+    using rs::playback::shared_frames_cache;
+    const std::string name = "/rs_sdk_tests_frames_" + std::to_string(getpid());
+    const uint32_t slot_size = 64 * 48;
+    shm_unlink(name.c_str());
+
+    shared_frames_cache::frame_key key = {};
+    ASSERT_TRUE(shared_frames_cache::query_file_key(GetParam(), key));
+    //two caches of the same segment, as two processes which read the recording
+    auto first = shared_frames_cache::open(name, 4 * slot_size, slot_size);
+    auto second = shared_frames_cache::open(name, 4 * slot_size, slot_size);
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+
+    std::vector<uint8_t> data(slot_size);
+    rs::core::file_types::frame_info info = {};
+    info.width = 64;
+    info.height = 48;
+    info.stride = 64;
+    rs::core::file_types::frame_sample frame(info, 0);
+    frame.data = data.data();
+    //the segment header takes a part of the size, three slots fit
+    for(uint32_t index = 0; index < 3; index++)
+    {
+        key.index = index;
+        std::fill(data.begin(), data.end(), static_cast<uint8_t>(index + 1));
+        ASSERT_TRUE(first->add(key, frame));
+    }
+
+    key.index = 0;
+    auto held = second->find(key, frame);
+    ASSERT_NE(nullptr, held);
+    EXPECT_EQ(1, held->data[0]);
+    EXPECT_EQ(1, held->data[slot_size - 1]);
+
+    //the least recently used slot which isn't held is evicted
+    key.index = 3;
+    ASSERT_TRUE(first->add(key, frame));
+    key.index = 1;
+    EXPECT_EQ(nullptr, second->find(key, frame));
+    key.index = 0;
+    EXPECT_NE(nullptr, second->find(key, frame));
+
+    //a frame which doesn't fit the slots isn't cached
+    std::vector<uint8_t> large_data(2 * slot_size);
+    rs::core::file_types::frame_sample large_frame(&frame);
+    large_frame.finfo.stride = 128;
+    large_frame.data = large_data.data();
+    key.index = 4;
+    EXPECT_FALSE(first->add(key, large_frame));
+
+    held.reset();
+    first.reset();
+    second.reset();
+    shm_unlink(name.c_str());
+}
+
 TEST_P(playback_streaming_fixture, playback_set_frames)
 {
     auto stream_count = playback_tests_util::enable_available_streams(device);
@@ -966,6 +1687,21 @@ TEST_P(playback_streaming_fixture, motions_callback)
     EXPECT_NEAR(static_cast<double>(time_stamps_events.size()), static_cast<double>(pb_time_stamp_events.size()), static_cast<double>(time_stamps_events.size()) * 0.01);
 }
 
+TEST_P(playback_streaming_fixture, read_motions)
+{
+    if(!device->supports(rs::capabilities::motion_events))return;
+
+    rs::playback::motion_columns columns;
+    ASSERT_TRUE(device->read_motions(rs::event::event_imu_gyro, 0, std::numeric_limits<uint64_t>::max(), columns));
+    EXPECT_LT(0u, columns.capture_times.size());
+    EXPECT_EQ(columns.capture_times.size(), columns.time_stamps.size());
+    EXPECT_EQ(columns.capture_times.size(), columns.frame_numbers.size());
+    EXPECT_EQ(columns.capture_times.size(), columns.x.size());
+    EXPECT_EQ(columns.capture_times.size(), columns.y.size());
+    EXPECT_EQ(columns.capture_times.size(), columns.z.size());
+    EXPECT_TRUE(std::is_sorted(columns.capture_times.begin(), columns.capture_times.end()));
+}
+
 TEST_P(playback_streaming_fixture, frames_callback)
 {
     auto stream_count = playback_tests_util::enable_available_streams(device);
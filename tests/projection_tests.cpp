@@ -6,8 +6,15 @@
 #include <stdlib.h>
 #include <locale>
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <thread>
+#include <tuple>
+#include "rs/core/fisheye_projection_interface.h"
 #include "rs/utils/librealsense_conversion_utils.h"
 #include "rs/utils/smart_ptr_helpers.h"
+#include "../sdk/src/core/projection/projection_solution_cache.h"
 
 #ifdef WIN32
 #define NOMINMAX
@@ -1457,3 +1464,1117 @@ TEST_F(projection_fixture, create_color_image_mapped_to_depth_query_uvmap)
         }
     }
 }
+
+
+/*
+    Test:
+        query_vertices_uvmap_batch
+
+    Target:
+        Checks QueryVerticesBatch and QueryUVMapBatch against QueryVertices and QueryUVMap
+
+    Scope:
+        Sequential depth frames of the recorded file
+
+    Description:
+        Gets the vertices and the UV maps of several depth frames with one batch call each,
+        and compares them to the results of the single frame calls.
+
+    Pass Criteria:
+        Test passes if the batch results are identical to the single frame results.
+*/
+TEST_F(projection_fixture, query_vertices_uvmap_batch)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t batch_size = 8;
+    const int32_t depth_points = m_depth_intrin.width * m_depth_intrin.height;
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    image_info DepthInfo = {m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch};
+
+    std::vector<std::vector<uint16_t>> depth_data(batch_size, std::vector<uint16_t>(depth_points));
+    std::vector<rs::utils::unique_ptr<image_interface>> depth_images;
+    std::vector<image_interface*> depth(batch_size);
+    for (int32_t i = 0; i < batch_size; i++)
+    {
+        m_device->set_frame_by_index(skipped_frames_at_begin + i, rs::stream::depth);
+        memcpy(depth_data[i].data(), m_device->get_frame_data(rs::stream::depth), depth_points * sizeof(uint16_t));
+        depth_images.push_back(get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&DepthInfo,
+                               {depth_data[i].data(), nullptr},
+                               stream_type::depth,
+                               image_interface::flag::any,
+                               m_device->get_frame_timestamp(rs::stream::depth),
+                               m_device->get_frame_number(rs::stream::depth))));
+        depth[i] = depth_images.back().get();
+    }
+
+    std::vector<std::vector<point3dF32>> vertices(batch_size, std::vector<point3dF32>(depth_points));
+    std::vector<std::vector<pointF32>> uvmaps(batch_size, std::vector<pointF32>(depth_points));
+    std::vector<point3dF32*> vertices_ptrs(batch_size);
+    std::vector<pointF32*> uvmaps_ptrs(batch_size);
+    for (int32_t i = 0; i < batch_size; i++)
+    {
+        vertices_ptrs[i] = vertices[i].data();
+        uvmaps_ptrs[i] = uvmaps[i].data();
+    }
+
+    ASSERT_EQ(status_no_error, m_projection->query_vertices_batch(batch_size, depth.data(), vertices_ptrs.data()));
+    ASSERT_EQ(status_no_error, m_projection->query_uvmap_batch(batch_size, depth.data(), uvmaps_ptrs.data()));
+
+    std::vector<point3dF32> frame_vertices(depth_points);
+    std::vector<pointF32> frame_uvmap(depth_points);
+    for (int32_t i = 0; i < batch_size; i++)
+    {
+        ASSERT_EQ(status_no_error, m_projection->query_vertices(depth[i], frame_vertices.data()));
+        ASSERT_EQ(status_no_error, m_projection->query_uvmap(depth[i], frame_uvmap.data()));
+        EXPECT_EQ(0, memcmp(frame_vertices.data(), vertices[i].data(), depth_points * sizeof(point3dF32))) << "frame " << i;
+        EXPECT_EQ(0, memcmp(frame_uvmap.data(), uvmaps[i].data(), depth_points * sizeof(pointF32))) << "frame " << i;
+    }
+
+    EXPECT_EQ(status_param_unsupported, m_projection->query_vertices_batch(0, depth.data(), vertices_ptrs.data()));
+    EXPECT_EQ(status_handle_invalid, m_projection->query_uvmap_batch(batch_size, depth.data(), nullptr));
+}
+
+
+/*
+    Test:
+        resident_outputs_release
+
+    Target:
+        Checks the reference counting of the QueryUVMapResident and QueryVerticesResident outputs
+
+    Scope:
+        Sequential depth frames of the recorded file
+
+    Description:
+        Gets the resident UV map of a depth frame and, while it's held, of the next frame, then releases both and gets
+        the UV map again. Gets the resident vertices of a projection instance and releases the instance before the vertices.
+
+    Pass Criteria:
+        Test passes if the outputs match QueryUVMap and QueryVertices, a held output is neither reused nor changed by the
+        next query, a released output is reused, and the vertices stay valid after the projection instance is released.
+*/
+TEST_F(projection_fixture, resident_outputs_release)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t frames_count = 2;
+    const int32_t depth_points = m_depth_intrin.width * m_depth_intrin.height;
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    image_info DepthInfo = {m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch};
+
+    std::vector<std::vector<uint16_t>> depth_data(frames_count, std::vector<uint16_t>(depth_points));
+    std::vector<rs::utils::unique_ptr<image_interface>> depth;
+    std::vector<std::vector<pointF32>> uvmaps(frames_count, std::vector<pointF32>(depth_points));
+    for (int32_t i = 0; i < frames_count; i++)
+    {
+        m_device->set_frame_by_index(skipped_frames_at_begin + i, rs::stream::depth);
+        memcpy(depth_data[i].data(), m_device->get_frame_data(rs::stream::depth), depth_points * sizeof(uint16_t));
+        depth.push_back(get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&DepthInfo,
+                        {depth_data[i].data(), nullptr},
+                        stream_type::depth,
+                        image_interface::flag::any,
+                        m_device->get_frame_timestamp(rs::stream::depth),
+                        m_device->get_frame_number(rs::stream::depth))));
+        ASSERT_EQ(status_no_error, m_projection->query_uvmap(depth[i].get(), uvmaps[i].data()));
+    }
+
+    const projection_output_interface * first_uvmap = nullptr;
+    ASSERT_EQ(status_no_error, m_projection->query_uvmap_resident(depth[0].get(), &first_uvmap));
+    ASSERT_NE(nullptr, first_uvmap);
+    auto first_uvmap_holder = get_unique_ptr_with_releaser(first_uvmap);
+    EXPECT_EQ(depth_points, first_uvmap->query_points_count());
+    EXPECT_EQ(2, first_uvmap->ref_count()) << "the projection keeps the last output besides the caller reference";
+    const void * first_uvmap_data = first_uvmap->query_data();
+
+    //the held output isn't written by the query of the next frame
+    const projection_output_interface * second_uvmap = nullptr;
+    ASSERT_EQ(status_no_error, m_projection->query_uvmap_resident(depth[1].get(), &second_uvmap));
+    ASSERT_NE(nullptr, second_uvmap);
+    auto second_uvmap_holder = get_unique_ptr_with_releaser(second_uvmap);
+    EXPECT_NE(first_uvmap_data, second_uvmap->query_data());
+    EXPECT_EQ(1, first_uvmap->ref_count());
+    EXPECT_EQ(0, memcmp(uvmaps[0].data(), first_uvmap_data, depth_points * sizeof(pointF32)));
+    EXPECT_EQ(0, memcmp(uvmaps[1].data(), second_uvmap->query_data(), depth_points * sizeof(pointF32)));
+
+    //once released, the last output is reused by the next query
+    const void * second_uvmap_data = second_uvmap->query_data();
+    first_uvmap_holder.reset();
+    second_uvmap_holder.reset();
+    const projection_output_interface * reused_uvmap = nullptr;
+    ASSERT_EQ(status_no_error, m_projection->query_uvmap_resident(depth[0].get(), &reused_uvmap));
+    ASSERT_NE(nullptr, reused_uvmap);
+    auto reused_uvmap_holder = get_unique_ptr_with_releaser(reused_uvmap);
+    EXPECT_EQ(second_uvmap_data, reused_uvmap->query_data());
+    EXPECT_EQ(0, memcmp(uvmaps[0].data(), reused_uvmap->query_data(), depth_points * sizeof(pointF32)));
+
+    //the vertices outlive the projection instance which wrote them
+    std::vector<point3dF32> vertices(depth_points);
+    ASSERT_EQ(status_no_error, m_projection->query_vertices(depth[0].get(), vertices.data()));
+    auto projection = get_unique_ptr_with_releaser(projection_interface::create_instance(&m_color_intrin, &m_depth_intrin, &m_extrinsics));
+    ASSERT_NE(nullptr, projection);
+    const projection_output_interface * resident_vertices = nullptr;
+    ASSERT_EQ(status_no_error, projection->query_vertices_resident(depth[0].get(), &resident_vertices));
+    ASSERT_NE(nullptr, resident_vertices);
+    auto resident_vertices_holder = get_unique_ptr_with_releaser(resident_vertices);
+    projection.reset();
+    EXPECT_EQ(1, resident_vertices->ref_count());
+    EXPECT_EQ(depth_points, resident_vertices->query_points_count());
+    EXPECT_EQ(0, memcmp(vertices.data(), resident_vertices->query_data(), depth_points * sizeof(point3dF32)));
+
+    const projection_output_interface * invalid_output = nullptr;
+    EXPECT_EQ(status_handle_invalid, m_projection->query_uvmap_resident(nullptr, &invalid_output));
+    EXPECT_EQ(nullptr, invalid_output);
+    EXPECT_EQ(status_handle_invalid, m_projection->query_vertices_resident(depth[0].get(), nullptr));
+}
+
+
+/*
+    Test:
+        query_roi
+
+    Target:
+        Checks the region of interest variants of QueryVertices, QueryUVMap and CreateColorImageMappedToDepth
+
+    Scope:
+        A depth and color frame of the recorded file
+
+    Description:
+        Gets the vertices, the UV map and the color image mapped to depth of the lower band of the depth image,
+        into buffers with a pitch larger than the roi row, and of the whole depth image.
+
+    Pass Criteria:
+        Test passes if the roi results are identical to the roi of the whole image results, and an roi outside
+        of the depth image or a pitch smaller than the roi row is rejected.
+*/
+TEST_F(projection_fixture, query_roi)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t padding = 3;
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    int colorPitch = m_color_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::color_format));
+    image_info depthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+    image_info colorInfo = { m_color_intrin.width, m_color_intrin.height, convert_pixel_format(projection_tests_util::color_format), colorPitch };
+    const rect roi = { m_depth_intrin.width / 8, m_depth_intrin.height * 2 / 3, m_depth_intrin.width * 3 / 4, m_depth_intrin.height / 3 };
+
+    m_device->start();
+    m_device->set_frame_by_index(skipped_frames_at_begin, rs::stream::depth);
+    auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                       {m_device->get_frame_data(rs::stream::depth), nullptr}, stream_type::depth, image_interface::flag::any, 0, 0));
+    auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&colorInfo,
+                       {m_device->get_frame_data(rs::stream::color), nullptr}, stream_type::color, image_interface::flag::any, 0, 0));
+
+    const int32_t depth_points = m_depth_intrin.width * m_depth_intrin.height;
+    std::vector<point3dF32> vertices(depth_points);
+    std::vector<pointF32> uvmap(depth_points);
+    ASSERT_EQ(status_no_error, m_projection->query_vertices(depth.get(), vertices.data()));
+    ASSERT_EQ(status_no_error, m_projection->query_uvmap(depth.get(), uvmap.data()));
+
+    const int32_t roi_row_points = roi.width + padding;
+    std::vector<point3dF32> roi_vertices(roi_row_points * roi.height);
+    std::vector<pointF32> roi_uvmap(roi_row_points * roi.height);
+    ASSERT_EQ(status_no_error, m_projection->query_vertices(depth.get(), roi, roi_vertices.data(), static_cast<int32_t>(roi_row_points * sizeof(point3dF32))));
+    ASSERT_EQ(status_no_error, m_projection->query_uvmap(depth.get(), roi, roi_uvmap.data(), static_cast<int32_t>(roi_row_points * sizeof(pointF32))));
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        const int32_t full_row = (roi.y + y) * m_depth_intrin.width + roi.x;
+        ASSERT_EQ(0, memcmp(&vertices[full_row], &roi_vertices[y * roi_row_points], roi.width * sizeof(point3dF32))) << "row " << y;
+        ASSERT_EQ(0, memcmp(&uvmap[full_row], &roi_uvmap[y * roi_row_points], roi.width * sizeof(pointF32))) << "row " << y;
+    }
+
+    auto color2depth = get_unique_ptr_with_releaser(m_projection->create_color_image_mapped_to_depth(depth.get(), color.get()));
+    auto roi_color2depth = get_unique_ptr_with_releaser(m_projection->create_color_image_mapped_to_depth(depth.get(), color.get(), roi, nullptr, 0));
+    ASSERT_NE(nullptr, color2depth);
+    ASSERT_NE(nullptr, roi_color2depth);
+    ASSERT_EQ(roi.width, roi_color2depth->query_info().width);
+    ASSERT_EQ(roi.height, roi_color2depth->query_info().height);
+    const int32_t pixel_size = get_pixel_size(colorInfo.format);
+    for (int32_t y = 0; y < roi.height; y++)
+    {
+        ASSERT_EQ(0, memcmp(static_cast<const uint8_t*>(color2depth->query_data()) + (roi.y + y) * color2depth->query_info().pitch + roi.x * pixel_size,
+                            static_cast<const uint8_t*>(roi_color2depth->query_data()) + y * roi_color2depth->query_info().pitch,
+                            roi.width * pixel_size)) << "row " << y;
+    }
+
+    auto roi_depth2color = get_unique_ptr_with_releaser(m_projection->create_depth_image_mapped_to_color(depth.get(), color.get(), roi, nullptr, 0));
+    ASSERT_NE(nullptr, roi_depth2color);
+    EXPECT_EQ(m_color_intrin.width, roi_depth2color->query_info().width);
+    m_device->stop();
+
+    const rect outside_roi = { roi.x, m_depth_intrin.height - roi.height + 1, roi.width, roi.height };
+    EXPECT_EQ(status_param_unsupported, m_projection->query_vertices(depth.get(), outside_roi, roi_vertices.data(), static_cast<int32_t>(roi_row_points * sizeof(point3dF32))));
+    EXPECT_EQ(status_param_unsupported, m_projection->query_uvmap(depth.get(), roi, roi_uvmap.data(), 1));
+    EXPECT_EQ(nullptr, m_projection->create_color_image_mapped_to_depth(depth.get(), color.get(), outside_roi, nullptr, 0));
+}
+
+
+/*
+    Test:
+        query_vertices_compact_formats
+
+    Target:
+        Checks QueryVertices with the 16-bit vertex formats and QueryDepthRays against QueryVertices
+
+    Scope:
+        Sequential depth frames of the recorded file
+
+    Description:
+        Gets the vertices of each frame as 32-bit floats, as half floats and as 16-bit integers,
+        and computes the vertices from the depth rays.
+
+    Pass Criteria:
+        Test passes if the half float vertices are within the half precision of the float vertices, the integer vertices
+        are within half a millimeter of the float vertices and the depth rays scaled by the depth equal the float vertices.
+*/
+TEST_F(projection_fixture, query_vertices_compact_formats)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t frames = 3;
+    const float half_relative_precision = 1.f / 2048.f;
+    const float half_min_subnormal = std::ldexp(1.f, -24);
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    image_info depthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+    const rect roi = { 0, 0, m_depth_intrin.width, m_depth_intrin.height };
+    const int32_t depth_points = m_depth_intrin.width * m_depth_intrin.height;
+    const int32_t compact_pitch = m_depth_intrin.width * 3 * static_cast<int32_t>(sizeof(int16_t));
+
+    auto half_to_float = [](uint16_t half)
+    {
+        const int exponent = (half >> 10) & 0x1f;
+        const float mantissa = static_cast<float>(half & 0x3ff);
+        const float magnitude = exponent == 0 ? std::ldexp(mantissa, -24) : std::ldexp(mantissa + 1024.f, exponent - 25);
+        return (half & 0x8000) ? -magnitude : magnitude;
+    };
+
+    std::vector<pointF32> rays(depth_points);
+    ASSERT_EQ(status_no_error, m_projection->query_depth_rays(rays.data()));
+
+    std::vector<point3dF32> vertices(depth_points);
+    std::vector<uint16_t> half_vertices(3 * depth_points);
+    std::vector<int16_t> int16_vertices(3 * depth_points);
+    m_device->start();
+    for (int i = skipped_frames_at_begin; i < skipped_frames_at_begin + frames; i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+        const uint16_t* depth_data = reinterpret_cast<const uint16_t*>(m_device->get_frame_data(rs::stream::depth));
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                           {depth_data, nullptr}, stream_type::depth, image_interface::flag::any, 0, 0));
+
+        ASSERT_EQ(status_no_error, m_projection->query_vertices(depth.get(), vertices.data()));
+        ASSERT_EQ(status_no_error, m_projection->query_vertices(depth.get(), roi, vertex_format::xyz16f, half_vertices.data(), compact_pitch));
+        ASSERT_EQ(status_no_error, m_projection->query_vertices(depth.get(), roi, vertex_format::xyz16s, int16_vertices.data(), compact_pitch));
+        for (int32_t n = 0; n < depth_points; n++)
+        {
+            const float expected[3] = { vertices[n].x, vertices[n].y, vertices[n].z };
+            for (int32_t c = 0; c < 3; c++)
+            {
+                ASSERT_LE(fabs(half_to_float(half_vertices[3 * n + c]) - expected[c]),
+                          std::max(std::fabs(expected[c]) * half_relative_precision, half_min_subnormal)) << "frame " << i << " point " << n;
+                ASSERT_LE(fabs(static_cast<float>(int16_vertices[3 * n + c]) - expected[c]), 0.5f) << "frame " << i << " point " << n;
+            }
+            const float z = static_cast<float>(depth_data[n]);
+            ASSERT_FLOAT_EQ(vertices[n].x, rays[n].x * z) << "frame " << i << " point " << n;
+            ASSERT_FLOAT_EQ(vertices[n].y, rays[n].y * z) << "frame " << i << " point " << n;
+        }
+    }
+    m_device->stop();
+
+    auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                       {m_device->get_frame_data(rs::stream::depth), nullptr}, stream_type::depth, image_interface::flag::any, 0, 0));
+    EXPECT_EQ(status_param_unsupported, m_projection->query_vertices(depth.get(), roi, vertex_format::xyz32f, vertices.data(), compact_pitch));
+    EXPECT_EQ(status_handle_invalid, m_projection->query_depth_rays(nullptr));
+}
+
+
+/*
+    Test:
+        query_valid_vertices
+
+    Target:
+        Checks QueryValidVertices against QueryVertices
+
+    Scope:
+        Sequential depth frames of the recorded file
+
+    Description:
+        Gets the vertices of the valid depth pixels with their pixel indices, and the vertices of all the pixels.
+
+    Pass Criteria:
+        Test passes if a vertex is returned for each nonzero depth pixel, in pixel order, and each returned vertex
+        equals the vertex of its pixel.
+*/
+TEST_F(projection_fixture, query_valid_vertices)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t frames = 3;
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    image_info depthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+    const int32_t depth_points = m_depth_intrin.width * m_depth_intrin.height;
+
+    std::vector<point3dF32> vertices(depth_points);
+    std::vector<point3dF32> valid_vertices(depth_points);
+    std::vector<int32_t> pixel_indices(depth_points);
+    m_device->start();
+    for (int i = skipped_frames_at_begin; i < skipped_frames_at_begin + frames; i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+        const uint16_t* depth_data = reinterpret_cast<const uint16_t*>(m_device->get_frame_data(rs::stream::depth));
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                           {depth_data, nullptr}, stream_type::depth, image_interface::flag::any, 0, 0));
+
+        int32_t nvertices = -1;
+        ASSERT_EQ(status_no_error, m_projection->query_vertices(depth.get(), vertices.data()));
+        ASSERT_EQ(status_no_error, m_projection->query_valid_vertices(depth.get(), valid_vertices.data(), pixel_indices.data(), &nvertices));
+        ASSERT_EQ(depth_points - std::count(depth_data, depth_data + depth_points, 0), nvertices) << "frame " << i;
+        for (int32_t n = 0; n < nvertices; n++)
+        {
+            const int32_t pixel = pixel_indices[n];
+            ASSERT_TRUE(n == 0 || pixel > pixel_indices[n - 1]) << "frame " << i << " vertex " << n;
+            ASSERT_NE(0, depth_data[pixel]) << "frame " << i << " vertex " << n;
+            ASSERT_EQ(0, memcmp(&vertices[pixel], &valid_vertices[n], sizeof(point3dF32))) << "frame " << i << " vertex " << n;
+        }
+    }
+    m_device->stop();
+
+    int32_t nvertices = 0;
+    EXPECT_EQ(status_handle_invalid, m_projection->query_valid_vertices(nullptr, valid_vertices.data(), pixel_indices.data(), &nvertices));
+}
+
+
+/*
+    Test:
+        query_voxelized_vertices
+
+    Target:
+        Checks QueryVoxelizedVertices against QueryVertices binned to voxels
+
+    Scope:
+        Sequential depth frames of the recorded file
+
+    Description:
+        Gets the voxel centroids of each frame, and bins the vertices of the valid pixels of the frame to voxels of the same size.
+
+    Pass Criteria:
+        Test passes if the voxels are the occupied voxels, in the order they are first hit, and each centroid is the mean
+        of the vertices in its voxel.
+*/
+TEST_F(projection_fixture, query_voxelized_vertices)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t frames = 3;
+    const float voxel_size = 64.f; // a power of two, so the voxel edges are exact
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    image_info depthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+    const int32_t depth_points = m_depth_intrin.width * m_depth_intrin.height;
+
+    std::vector<point3dF32> vertices(depth_points);
+    std::vector<point3dF32> voxels(depth_points);
+    m_device->start();
+    for (int i = skipped_frames_at_begin; i < skipped_frames_at_begin + frames; i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                           {m_device->get_frame_data(rs::stream::depth), nullptr}, stream_type::depth, image_interface::flag::any, 0, 0));
+
+        int32_t nvoxels = -1;
+        ASSERT_EQ(status_no_error, m_projection->query_vertices(depth.get(), vertices.data()));
+        ASSERT_EQ(status_no_error, m_projection->query_voxelized_vertices(depth.get(), voxel_size, voxels.data(), &nvoxels));
+
+        std::map<std::tuple<int, int, int>, size_t> voxel_index;
+        std::vector<std::pair<std::array<double, 3>, int32_t>> expected;
+        for (const auto & vertex : vertices)
+        {
+            if (vertex.z == 0) continue;
+            auto key = std::make_tuple(static_cast<int>(std::floor(vertex.x / voxel_size)), static_cast<int>(std::floor(vertex.y / voxel_size)),
+                                       static_cast<int>(std::floor(vertex.z / voxel_size)));
+            auto inserted = voxel_index.insert(std::make_pair(key, expected.size()));
+            if (inserted.second)
+                expected.push_back(std::make_pair(std::array<double, 3>{{0., 0., 0.}}, 0));
+            auto & voxel = expected[inserted.first->second];
+            voxel.first[0] += vertex.x;
+            voxel.first[1] += vertex.y;
+            voxel.first[2] += vertex.z;
+            voxel.second++;
+        }
+
+        ASSERT_EQ(static_cast<int32_t>(expected.size()), nvoxels) << "frame " << i;
+        for (int32_t n = 0; n < nvoxels; n++)
+        {
+            const double count = expected[n].second;
+            EXPECT_NEAR(expected[n].first[0] / count, voxels[n].x, 0.01) << "frame " << i << " voxel " << n;
+            EXPECT_NEAR(expected[n].first[1] / count, voxels[n].y, 0.01) << "frame " << i << " voxel " << n;
+            EXPECT_NEAR(expected[n].first[2] / count, voxels[n].z, 0.01) << "frame " << i << " voxel " << n;
+        }
+    }
+    m_device->stop();
+
+    int32_t nvoxels = 0;
+    auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                       {m_device->get_frame_data(rs::stream::depth), nullptr}, stream_type::depth, image_interface::flag::any, 0, 0));
+    EXPECT_EQ(status_param_unsupported, m_projection->query_voxelized_vertices(depth.get(), 0.f, voxels.data(), &nvoxels));
+}
+
+
+/*
+    Test:
+        create_mapped_images_into_buffers
+
+    Target:
+        Checks CreateColorImageMappedToDepth and CreateDepthImageMappedToColor with a caller buffer and with the projection pool
+
+    Scope:
+        Sequential frames of the recorded file
+
+    Description:
+        Maps the images with the default functions, with a caller buffer of a pitch larger than the image row,
+        and with the projection pool, repeatedly, so the pooled buffers are reused.
+
+    Pass Criteria:
+        Test passes if all the mapped images are identical and the caller buffer images point to the caller buffer.
+*/
+TEST_F(projection_fixture, create_mapped_images_into_buffers)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t frames = 10;
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    int colorPitch = m_color_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::color_format));
+    image_info depthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+    image_info colorInfo = { m_color_intrin.width, m_color_intrin.height, convert_pixel_format(projection_tests_util::color_format), colorPitch };
+
+    const int32_t padding = 64;
+    const int32_t color2depth_pitch = m_depth_intrin.width * get_pixel_size(colorInfo.format) + padding;
+    const int32_t depth2color_pitch = m_color_intrin.width * get_pixel_size(depthInfo.format) + padding;
+    std::vector<uint8_t> color2depth_buffer(color2depth_pitch * m_depth_intrin.height);
+    std::vector<uint8_t> depth2color_buffer(depth2color_pitch * m_color_intrin.height);
+
+    auto compare_images = [](image_interface * expected, image_interface * actual)
+    {
+        ASSERT_NE(nullptr, expected);
+        ASSERT_NE(nullptr, actual);
+        image_info expected_info = expected->query_info();
+        image_info actual_info = actual->query_info();
+        ASSERT_EQ(expected_info.width, actual_info.width);
+        ASSERT_EQ(expected_info.height, actual_info.height);
+        ASSERT_EQ(expected_info.format, actual_info.format);
+        const int32_t row_size = expected_info.width * get_pixel_size(expected_info.format);
+        for (int32_t y = 0; y < expected_info.height; y++)
+        {
+            ASSERT_EQ(0, memcmp(static_cast<const uint8_t*>(expected->query_data()) + y * expected_info.pitch,
+                                static_cast<const uint8_t*>(actual->query_data()) + y * actual_info.pitch, row_size)) << "row " << y;
+        }
+    };
+
+    m_device->start();
+    for (int i = skipped_frames_at_begin; i < skipped_frames_at_begin + frames; i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                           {m_device->get_frame_data(rs::stream::depth), nullptr},
+                           stream_type::depth,
+                           image_interface::flag::any,
+                           m_device->get_frame_timestamp(rs::stream::depth),
+                           m_device->get_frame_number(rs::stream::depth)));
+        auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&colorInfo,
+                           {m_device->get_frame_data(rs::stream::color), nullptr},
+                           stream_type::color,
+                           image_interface::flag::any,
+                           m_device->get_frame_timestamp(rs::stream::color),
+                           m_device->get_frame_number(rs::stream::color)));
+
+        auto color2depth = get_unique_ptr_with_releaser(m_projection->create_color_image_mapped_to_depth(depth.get(), color.get()));
+        auto color2depth_into_buffer = get_unique_ptr_with_releaser(m_projection->create_color_image_mapped_to_depth(
+                                           depth.get(), color.get(), color2depth_buffer.data(), color2depth_pitch));
+        auto color2depth_pooled = get_unique_ptr_with_releaser(m_projection->create_color_image_mapped_to_depth(depth.get(), color.get(), nullptr, 0));
+        compare_images(color2depth.get(), color2depth_into_buffer.get());
+        compare_images(color2depth.get(), color2depth_pooled.get());
+        EXPECT_EQ(color2depth_buffer.data(), color2depth_into_buffer->query_data());
+        EXPECT_EQ(color2depth_pitch, color2depth_into_buffer->query_info().pitch);
+
+        auto depth2color = get_unique_ptr_with_releaser(m_projection->create_depth_image_mapped_to_color(depth.get(), color.get()));
+        auto depth2color_into_buffer = get_unique_ptr_with_releaser(m_projection->create_depth_image_mapped_to_color(
+                                           depth.get(), color.get(), depth2color_buffer.data(), depth2color_pitch));
+        compare_images(depth2color.get(), depth2color_into_buffer.get());
+        EXPECT_EQ(depth2color_buffer.data(), depth2color_into_buffer->query_data());
+    }
+    m_device->stop();
+
+    auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                       {m_device->get_frame_data(rs::stream::depth), nullptr}, stream_type::depth, image_interface::flag::any, 0, 0));
+    auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&colorInfo,
+                       {m_device->get_frame_data(rs::stream::color), nullptr}, stream_type::color, image_interface::flag::any, 0, 0));
+    EXPECT_EQ(nullptr, m_projection->create_color_image_mapped_to_depth(depth.get(), color.get(), color2depth_buffer.data(), 1));
+}
+
+
+/*
+    Test:
+        map_color_to_depth_sparse
+
+    Target:
+        Checks MapColorToDepthSparse against MapColorToDepth
+
+    Scope:
+        Sequential frames of the recorded file
+
+    Description:
+        Maps a grid of color pixels to depth with the sparse and the dense functions,
+        maps the sparse results back to color.
+
+    Pass Criteria:
+        Test passes if every sparse result maps back to its color pixel within one pixel
+        and the sparse function matches most of the color pixels matched by the dense function.
+*/
+TEST_F(projection_fixture, map_color_to_depth_sparse)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t frames = 10;
+    const int32_t grid_step = 16;
+    const float min_matched_ratio = 0.9f;
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    image_info depthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+
+    std::vector<pointF32> pos_ij;
+    for (int32_t y = grid_step / 2; y < m_color_intrin.height; y += grid_step)
+        for (int32_t x = grid_step / 2; x < m_color_intrin.width; x += grid_step)
+            pos_ij.push_back({static_cast<float>(x), static_cast<float>(y)});
+    const int32_t npoints = static_cast<int32_t>(pos_ij.size());
+    std::vector<pointF32> sparse_uv(npoints), dense_uv(npoints);
+
+    m_device->start();
+    for (int i = skipped_frames_at_begin; i < skipped_frames_at_begin + frames; i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+        const uint16_t* depth_data = reinterpret_cast<const uint16_t*>(m_device->get_frame_data(rs::stream::depth));
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                           {depth_data, nullptr},
+                           stream_type::depth,
+                           image_interface::flag::any,
+                           m_device->get_frame_timestamp(rs::stream::depth),
+                           m_device->get_frame_number(rs::stream::depth)));
+
+        ASSERT_EQ(status_no_error, m_projection->map_color_to_depth_sparse(depth.get(), npoints, pos_ij.data(), sparse_uv.data()));
+        ASSERT_EQ(status_no_error, m_projection->map_color_to_depth(depth.get(), npoints, pos_ij.data(), dense_uv.data()));
+
+        std::vector<point3dF32> matched_uvz;
+        std::vector<pointF32> matched_ij;
+        int32_t ndense = 0;
+        for (int32_t n = 0; n < npoints; n++)
+        {
+            if (dense_uv[n].x >= 0.f) ndense++;
+            if (sparse_uv[n].x < 0.f) continue;
+            const int u = static_cast<int>(sparse_uv[n].x), v = static_cast<int>(sparse_uv[n].y);
+            matched_uvz.push_back({sparse_uv[n].x, sparse_uv[n].y, static_cast<float>(depth_data[v * m_depth_intrin.width + u])});
+            matched_ij.push_back(pos_ij[n]);
+        }
+        const int32_t nsparse = static_cast<int32_t>(matched_uvz.size());
+        EXPECT_GE(static_cast<float>(nsparse), min_matched_ratio * static_cast<float>(ndense)) << "frame " << i;
+        if (!nsparse) continue;
+
+        std::vector<pointF32> back_ij(nsparse);
+        ASSERT_EQ(status_no_error, m_projection->map_depth_to_color(nsparse, matched_uvz.data(), back_ij.data()));
+        for (int32_t n = 0; n < nsparse; n++)
+        {
+            EXPECT_LE(fabs(back_ij[n].x - matched_ij[n].x), 1.f) << "frame " << i << " point " << n;
+            EXPECT_LE(fabs(back_ij[n].y - matched_ij[n].y), 1.f) << "frame " << i << " point " << n;
+        }
+    }
+    m_device->stop();
+
+    EXPECT_EQ(status_handle_invalid, m_projection->map_color_to_depth_sparse(nullptr, npoints, pos_ij.data(), sparse_uv.data()));
+}
+
+
+/*
+    Test:
+        incremental_registration_depth_mapped_to_color
+
+    Target:
+        Checks CreateDepthImageMappedToColor with the incremental registration
+
+    Scope:
+        Sequential frames of the recorded file, each frame mapped twice
+
+    Description:
+        Maps each depth frame to color with the full registration and with a second projection using the incremental registration
+        with a zero threshold, so only the changed tiles are registered again, then maps the same frame again, which reuses the whole registration.
+
+    Pass Criteria:
+        Test passes if all the incremental images are identical to the full registration images.
+*/
+TEST_F(projection_fixture, incremental_registration_depth_mapped_to_color)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t frames = 10;
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    int colorPitch = m_color_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::color_format));
+    image_info depthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+    image_info colorInfo = { m_color_intrin.width, m_color_intrin.height, convert_pixel_format(projection_tests_util::color_format), colorPitch };
+    const int32_t depth2color_size = m_color_intrin.width * m_color_intrin.height * static_cast<int32_t>(sizeof(uint16_t));
+
+    auto incremental_projection = get_unique_ptr_with_releaser(projection_interface::create_instance(&m_color_intrin, &m_depth_intrin, &m_extrinsics));
+    ASSERT_NE(nullptr, incremental_projection);
+    ASSERT_EQ(status_no_error, incremental_projection->set_incremental_registration(true, 0));
+
+    m_device->start();
+    for (int i = skipped_frames_at_begin; i < skipped_frames_at_begin + frames; i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                           {m_device->get_frame_data(rs::stream::depth), nullptr},
+                           stream_type::depth,
+                           image_interface::flag::any,
+                           m_device->get_frame_timestamp(rs::stream::depth),
+                           m_device->get_frame_number(rs::stream::depth)));
+        auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&colorInfo,
+                           {m_device->get_frame_data(rs::stream::color), nullptr},
+                           stream_type::color,
+                           image_interface::flag::any,
+                           m_device->get_frame_timestamp(rs::stream::color),
+                           m_device->get_frame_number(rs::stream::color)));
+
+        auto full = get_unique_ptr_with_releaser(m_projection->create_depth_image_mapped_to_color(depth.get(), color.get()));
+        ASSERT_NE(nullptr, full);
+        for (int repeat = 0; repeat < 2; repeat++)
+        {
+            auto incremental = get_unique_ptr_with_releaser(incremental_projection->create_depth_image_mapped_to_color(depth.get(), color.get()));
+            ASSERT_NE(nullptr, incremental);
+            EXPECT_EQ(0, memcmp(full->query_data(), incremental->query_data(), depth2color_size)) << "frame " << i << " repeat " << repeat;
+        }
+    }
+    m_device->stop();
+}
+
+/*
+    Test:
+        incremental_registration_invuvmap
+
+    Target:
+        Checks QueryInvUVMap and MapColorToDepth with the incremental registration
+
+    Scope:
+        Sequential frames of the recorded file, each frame queried twice
+
+    Description:
+        Queries the inverse UV map and maps a grid of color pixels to depth with the full registration and with a second projection
+        using the incremental registration with a zero threshold, then queries the same frame again, which reuses the inverse mappings.
+
+    Pass Criteria:
+        Test passes if all the incremental inverse UV maps and mapped depth pixels are identical to the full registration ones.
+*/
+TEST_F(projection_fixture, incremental_registration_invuvmap)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t frames = 5;
+    const int32_t grid_step = 16;
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    image_info depthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+    const int32_t color_points = m_color_intrin.width * m_color_intrin.height;
+
+    auto incremental_projection = get_unique_ptr_with_releaser(projection_interface::create_instance(&m_color_intrin, &m_depth_intrin, &m_extrinsics));
+    ASSERT_NE(nullptr, incremental_projection);
+    ASSERT_EQ(status_no_error, incremental_projection->set_incremental_registration(true, 0));
+
+    std::vector<pointF32> color_pixels;
+    for (int32_t y = 0; y < m_color_intrin.height; y += grid_step)
+        for (int32_t x = 0; x < m_color_intrin.width; x += grid_step)
+            color_pixels.push_back({ static_cast<float>(x), static_cast<float>(y) });
+    const int32_t npoints = static_cast<int32_t>(color_pixels.size());
+
+    std::vector<pointF32> invuvmap(color_points), incremental_invuvmap(color_points);
+    std::vector<pointF32> depth_pixels(npoints), incremental_depth_pixels(npoints);
+    m_device->start();
+    for (int i = skipped_frames_at_begin; i < skipped_frames_at_begin + frames; i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                           {m_device->get_frame_data(rs::stream::depth), nullptr}, stream_type::depth, image_interface::flag::any, 0, 0));
+
+        ASSERT_EQ(status_no_error, m_projection->query_invuvmap(depth.get(), invuvmap.data()));
+        const status map_status = m_projection->map_color_to_depth(depth.get(), npoints, color_pixels.data(), depth_pixels.data());
+        for (int repeat = 0; repeat < 2; repeat++)
+        {
+            ASSERT_EQ(status_no_error, incremental_projection->query_invuvmap(depth.get(), incremental_invuvmap.data()));
+            EXPECT_EQ(0, memcmp(invuvmap.data(), incremental_invuvmap.data(), color_points * sizeof(pointF32))) << "frame " << i << " repeat " << repeat;
+            EXPECT_EQ(map_status, incremental_projection->map_color_to_depth(depth.get(), npoints, color_pixels.data(), incremental_depth_pixels.data()));
+            EXPECT_EQ(0, memcmp(depth_pixels.data(), incremental_depth_pixels.data(), npoints * sizeof(pointF32))) << "frame " << i << " repeat " << repeat;
+        }
+    }
+    m_device->stop();
+}
+
+
+/*
+    Test:
+        splatted_registration_depth_mapped_to_color
+
+    Target:
+        Checks CreateDepthImageMappedToColor with the splatted registration
+
+    Scope:
+        A depth frame of the recorded file, splatted with one and two pixel splats
+
+    Description:
+        Maps the depth frame to color with the depth pixels splatted, and computes the splatted image serially from QueryUVMap,
+        keeping the nearest depth of each color pixel.
+
+    Pass Criteria:
+        Test passes if the splatted images are identical to the serial reference images, and an out of range splat size is rejected.
+*/
+TEST_F(projection_fixture, splatted_registration_depth_mapped_to_color)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    int colorPitch = m_color_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::color_format));
+    image_info depthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+    image_info colorInfo = { m_color_intrin.width, m_color_intrin.height, convert_pixel_format(projection_tests_util::color_format), colorPitch };
+
+    m_device->start();
+    m_device->set_frame_by_index(skipped_frames_at_begin, rs::stream::depth);
+    auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                       {m_device->get_frame_data(rs::stream::depth), nullptr}, stream_type::depth, image_interface::flag::any, 0, 0));
+    auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&colorInfo,
+                       {m_device->get_frame_data(rs::stream::color), nullptr}, stream_type::color, image_interface::flag::any, 0, 0));
+
+    const int32_t depth_points = m_depth_intrin.width * m_depth_intrin.height;
+    std::vector<pointF32> uvmap(depth_points);
+    ASSERT_EQ(status_no_error, m_projection->query_uvmap(depth.get(), uvmap.data()));
+    const uint16_t* depth_data = static_cast<const uint16_t*>(depth->query_data());
+
+    for (int32_t splat_size = 1; splat_size <= 2; splat_size++)
+    {
+        std::vector<uint16_t> reference(m_color_intrin.width * m_color_intrin.height, 0);
+        for (int32_t i = 0; i < depth_points; i++)
+        {
+            if (uvmap[i].x < 0.f || depth_data[i] == 0) continue;
+            const int32_t column = static_cast<int32_t>(uvmap[i].x * static_cast<float>(m_color_intrin.width));
+            const int32_t row = static_cast<int32_t>(uvmap[i].y * static_cast<float>(m_color_intrin.height));
+            for (int32_t y = row - (splat_size - 1) / 2; y <= row + splat_size / 2; y++)
+            {
+                for (int32_t x = column - (splat_size - 1) / 2; x <= column + splat_size / 2; x++)
+                {
+                    if (x < 0 || y < 0 || x >= m_color_intrin.width || y >= m_color_intrin.height) continue;
+                    uint16_t & target = reference[y * m_color_intrin.width + x];
+                    if (target == 0 || depth_data[i] < target) target = depth_data[i];
+                }
+            }
+        }
+
+        ASSERT_EQ(status_no_error, m_projection->set_splatted_registration(true, splat_size));
+        auto splatted = get_unique_ptr_with_releaser(m_projection->create_depth_image_mapped_to_color(depth.get(), color.get()));
+        ASSERT_NE(nullptr, splatted);
+        for (int32_t y = 0; y < m_color_intrin.height; y++)
+        {
+            ASSERT_EQ(0, memcmp(&reference[y * m_color_intrin.width],
+                                static_cast<const uint8_t*>(splatted->query_data()) + y * splatted->query_info().pitch,
+                                m_color_intrin.width * sizeof(uint16_t))) << "splat size " << splat_size << " row " << y;
+        }
+    }
+    m_device->stop();
+
+    EXPECT_EQ(status_param_unsupported, m_projection->set_splatted_registration(true, 0));
+    EXPECT_EQ(status_no_error, m_projection->set_splatted_registration(false, 0));
+}
+
+/*
+    Test:
+        fixed_point_projection
+
+    Target:
+        Checks QueryVertices and QueryUVMap with the fixed point projection
+
+    Scope:
+        Sequential frames of the recorded file
+
+    Description:
+        Gets the vertices, as 32-bit floats and as 16-bit integers, and the UV map of each frame in floating point and with
+        a second projection selecting the fixed point projection.
+
+    Pass Criteria:
+        Test passes if the fixed point vertices are within z / 65536 of the float vertices, the integer vertices within 1,
+        and the coordinates mapped inside the color image by both projections are within 1 / 8192 of each other.
+*/
+TEST_F(projection_fixture, fixed_point_projection)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t frames = 3;
+    const float uv_precision = 1.f / 8192.f;
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    image_info depthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+    const rect roi = { 0, 0, m_depth_intrin.width, m_depth_intrin.height };
+    const int32_t depth_points = m_depth_intrin.width * m_depth_intrin.height;
+    const int32_t compact_pitch = m_depth_intrin.width * 3 * static_cast<int32_t>(sizeof(int16_t));
+
+    auto fixed_point_projection = get_unique_ptr_with_releaser(projection_interface::create_instance(&m_color_intrin, &m_depth_intrin, &m_extrinsics));
+    ASSERT_NE(nullptr, fixed_point_projection);
+    ASSERT_EQ(status_no_error, fixed_point_projection->set_fixed_point_projection(true));
+
+    std::vector<point3dF32> vertices(depth_points), fixed_point_vertices(depth_points);
+    std::vector<int16_t> int16_vertices(3 * depth_points), fixed_point_int16_vertices(3 * depth_points);
+    std::vector<pointF32> uvmap(depth_points), fixed_point_uvmap(depth_points);
+    m_device->start();
+    for (int i = skipped_frames_at_begin; i < skipped_frames_at_begin + frames; i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+        const uint16_t* depth_data = reinterpret_cast<const uint16_t*>(m_device->get_frame_data(rs::stream::depth));
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                           {depth_data, nullptr}, stream_type::depth, image_interface::flag::any, 0, 0));
+
+        ASSERT_EQ(status_no_error, m_projection->query_vertices(depth.get(), vertices.data()));
+        ASSERT_EQ(status_no_error, fixed_point_projection->query_vertices(depth.get(), fixed_point_vertices.data()));
+        ASSERT_EQ(status_no_error, m_projection->query_vertices(depth.get(), roi, vertex_format::xyz16s, int16_vertices.data(), compact_pitch));
+        ASSERT_EQ(status_no_error, fixed_point_projection->query_vertices(depth.get(), roi, vertex_format::xyz16s, fixed_point_int16_vertices.data(), compact_pitch));
+        ASSERT_EQ(status_no_error, m_projection->query_uvmap(depth.get(), uvmap.data()));
+        ASSERT_EQ(status_no_error, fixed_point_projection->query_uvmap(depth.get(), fixed_point_uvmap.data()));
+        for (int32_t n = 0; n < depth_points; n++)
+        {
+            const float vertex_precision = static_cast<float>(depth_data[n]) / 65536.f;
+            ASSERT_LE(fabs(fixed_point_vertices[n].x - vertices[n].x), vertex_precision) << "frame " << i << " point " << n;
+            ASSERT_LE(fabs(fixed_point_vertices[n].y - vertices[n].y), vertex_precision) << "frame " << i << " point " << n;
+            ASSERT_EQ(vertices[n].z, fixed_point_vertices[n].z) << "frame " << i << " point " << n;
+            for (int32_t c = 0; c < 3; c++)
+                ASSERT_LE(std::abs(fixed_point_int16_vertices[3 * n + c] - int16_vertices[3 * n + c]), 1) << "frame " << i << " point " << n;
+            if (uvmap[n].x < 0.f || fixed_point_uvmap[n].x < 0.f) continue;
+            ASSERT_LE(fabs(fixed_point_uvmap[n].x - uvmap[n].x), uv_precision) << "frame " << i << " point " << n;
+            ASSERT_LE(fabs(fixed_point_uvmap[n].y - uvmap[n].y), uv_precision) << "frame " << i << " point " << n;
+        }
+    }
+    m_device->stop();
+}
+
+/*
+    Test:
+        project_camera_to_image_arrays
+
+    Target:
+        Checks ProjectCameraToColor and ProjectCameraToDepth with the points in separate arrays
+
+    Scope:
+        A large array of points spread over the depth range, including points on the camera plane
+
+    Description:
+        Projects the points to color and to depth as point arrays and as coordinate arrays.
+
+    Pass Criteria:
+        Test passes if the pixels of the coordinate arrays are identical to the pixels of the point arrays.
+*/
+TEST_F(projection_fixture, project_camera_to_image_arrays)
+{
+    const int32_t npoints = 100003;
+    std::vector<point3dF32> points(npoints);
+    std::vector<float> x(npoints), y(npoints), z(npoints);
+    for (int32_t n = 0; n < npoints; n++)
+    {
+        points[n] = { static_cast<float>(n % 401) * 10.f - 2000.f, static_cast<float>(n % 307) * 10.f - 1500.f, static_cast<float>(n % 5000) };
+        x[n] = points[n].x;
+        y[n] = points[n].y;
+        z[n] = points[n].z;
+    }
+
+    std::vector<pointF32> pixels(npoints);
+    std::vector<float> i(npoints), j(npoints);
+    ASSERT_EQ(status_no_error, m_projection->project_camera_to_color(npoints, points.data(), pixels.data()));
+    ASSERT_EQ(status_no_error, m_projection->project_camera_to_color(npoints, x.data(), y.data(), z.data(), i.data(), j.data()));
+    for (int32_t n = 0; n < npoints; n++)
+    {
+        ASSERT_EQ(pixels[n].x, i[n]) << "point " << n;
+        ASSERT_EQ(pixels[n].y, j[n]) << "point " << n;
+    }
+
+    ASSERT_EQ(status_no_error, m_projection->project_camera_to_depth(npoints, points.data(), pixels.data()));
+    ASSERT_EQ(status_no_error, m_projection->project_camera_to_depth(npoints, x.data(), y.data(), z.data(), i.data(), j.data()));
+    for (int32_t n = 0; n < npoints; n++)
+    {
+        ASSERT_EQ(pixels[n].x, i[n]) << "point " << n;
+        ASSERT_EQ(pixels[n].y, j[n]) << "point " << n;
+    }
+
+    EXPECT_EQ(status_handle_invalid, m_projection->project_camera_to_color(npoints, x.data(), nullptr, z.data(), i.data(), j.data()));
+    EXPECT_EQ(status_param_unsupported, m_projection->project_camera_to_depth(0, x.data(), y.data(), z.data(), i.data(), j.data()));
+}
+
+/*
+    Test:
+        shared_instance_concurrent_queries
+
+    Target:
+        Checks QueryUVMap, QueryVertices, QueryInvUVMap, CreateDepthImageMappedToColor and MapColorToDepth of an instance
+        shared by threads
+
+    Scope:
+        A depth frame of the recorded file, queried by several threads at once
+
+    Description:
+        Queries the frame serially, then queries it repeatedly from several threads sharing the projection instance.
+
+    Pass Criteria:
+        Test passes if the outputs of every thread are identical to the serial outputs.
+*/
+TEST_F(projection_fixture, shared_instance_concurrent_queries)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t threads_count = 4;
+    const int32_t repeats = 8;
+    const int32_t grid_step = 16;
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    int colorPitch = m_color_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::color_format));
+    image_info depthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+    image_info colorInfo = { m_color_intrin.width, m_color_intrin.height, convert_pixel_format(projection_tests_util::color_format), colorPitch };
+    const int32_t depth_points = m_depth_intrin.width * m_depth_intrin.height;
+    const int32_t color_points = m_color_intrin.width * m_color_intrin.height;
+
+    m_device->start();
+    m_device->set_frame_by_index(skipped_frames_at_begin, rs::stream::depth);
+    auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depthInfo,
+                       {m_device->get_frame_data(rs::stream::depth), nullptr}, stream_type::depth, image_interface::flag::any, 0, 0));
+    auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&colorInfo,
+                       {m_device->get_frame_data(rs::stream::color), nullptr}, stream_type::color, image_interface::flag::any, 0, 0));
+
+    std::vector<pointF32> color_pixels;
+    for (int32_t y = 0; y < m_color_intrin.height; y += grid_step)
+        for (int32_t x = 0; x < m_color_intrin.width; x += grid_step)
+            color_pixels.push_back({ static_cast<float>(x), static_cast<float>(y) });
+    const int32_t npoints = static_cast<int32_t>(color_pixels.size());
+
+    std::vector<pointF32> uvmap(depth_points), invuvmap(color_points), depth_pixels(npoints);
+    std::vector<point3dF32> vertices(depth_points);
+    ASSERT_EQ(status_no_error, m_projection->query_uvmap(depth.get(), uvmap.data()));
+    ASSERT_EQ(status_no_error, m_projection->query_vertices(depth.get(), vertices.data()));
+    ASSERT_EQ(status_no_error, m_projection->query_invuvmap(depth.get(), invuvmap.data()));
+    const status map_status = m_projection->map_color_to_depth(depth.get(), npoints, color_pixels.data(), depth_pixels.data());
+    auto depth2color = get_unique_ptr_with_releaser(m_projection->create_depth_image_mapped_to_color(depth.get(), color.get()));
+    ASSERT_NE(nullptr, depth2color);
+    const size_t depth2color_size = depth2color->query_info().height * depth2color->query_info().pitch;
+
+    std::vector<int32_t> mismatches(threads_count, 0);
+    std::vector<std::thread> threads;
+    for (int32_t t = 0; t < threads_count; t++)
+    {
+        threads.emplace_back([&, t]()
+        {
+            std::vector<pointF32> thread_uvmap(depth_points), thread_invuvmap(color_points), thread_depth_pixels(npoints);
+            std::vector<point3dF32> thread_vertices(depth_points);
+            for (int32_t r = 0; r < repeats; r++)
+            {
+                if (m_projection->query_uvmap(depth.get(), thread_uvmap.data()) != status_no_error ||
+                        memcmp(uvmap.data(), thread_uvmap.data(), depth_points * sizeof(pointF32)) != 0)
+                    mismatches[t]++;
+                if (m_projection->query_vertices(depth.get(), thread_vertices.data()) != status_no_error ||
+                        memcmp(vertices.data(), thread_vertices.data(), depth_points * sizeof(point3dF32)) != 0)
+                    mismatches[t]++;
+                if (m_projection->query_invuvmap(depth.get(), thread_invuvmap.data()) != status_no_error ||
+                        memcmp(invuvmap.data(), thread_invuvmap.data(), color_points * sizeof(pointF32)) != 0)
+                    mismatches[t]++;
+                if (m_projection->map_color_to_depth(depth.get(), npoints, color_pixels.data(), thread_depth_pixels.data()) != map_status ||
+                        memcmp(depth_pixels.data(), thread_depth_pixels.data(), npoints * sizeof(pointF32)) != 0)
+                    mismatches[t]++;
+                auto thread_depth2color = get_unique_ptr_with_releaser(m_projection->create_depth_image_mapped_to_color(depth.get(), color.get()));
+                if (!thread_depth2color || memcmp(depth2color->query_data(), thread_depth2color->query_data(), depth2color_size) != 0)
+                    mismatches[t]++;
+            }
+        });
+    }
+    for (auto & thread : threads)
+        thread.join();
+    m_device->stop();
+
+    for (int32_t t = 0; t < threads_count; t++)
+        EXPECT_EQ(0, mismatches[t]) << "thread " << t;
+}
+
+TEST(projection_solution_cache_tests, solution_is_found_by_its_calibration)
+{
+    auto & cache = projection_solution_cache::instance();
+    cache.set_directory("");
+
+    projection_solution_key key = {};
+    for(int i = 0; i < 9; i++) key.rotation[i] = 0.5f + static_cast<float>(i);
+    key.translation[0] = -58.f;
+    key.color_distortion[0] = 0.125f;
+    projection_solution solution = {};
+    solution.invtrans_color[0] = 58.f;
+    solution.invdist_color_coeffs[0] = -0.125f;
+
+    projection_solution found = {};
+    ASSERT_FALSE(cache.find(key, found));
+    cache.insert(key, solution);
+    ASSERT_TRUE(cache.find(key, found));
+    EXPECT_EQ(0, memcmp(&solution, &found, sizeof(projection_solution)));
+
+    //another calibration is not matched by the cached solution
+    projection_solution_key other_key = key;
+    other_key.translation[0] = -57.f;
+    EXPECT_FALSE(cache.find(other_key, found));
+}
+
+TEST(fisheye_projection_tests, rectified_image_follows_the_fisheye_projection)
+{
+    intrinsics fisheye = { 640, 480, 320.5f, 240.5f, 180.f, 180.f, distortion_type::distortion_ftheta, { 0.93f, 0.f, 0.f, 0.f, 0.f } };
+    intrinsics rectified = { 320, 240, 160.f, 120.f, 140.f, 140.f, distortion_type::none, { 0.f, 0.f, 0.f, 0.f, 0.f } };
+
+    intrinsics brown = fisheye;
+    brown.model = distortion_type::modified_brown_conrady;
+    EXPECT_EQ(nullptr, fisheye_projection_interface::create_instance(&brown, &rectified));
+    EXPECT_EQ(nullptr, fisheye_projection_interface::create_instance(&fisheye, &brown));
+
+    auto projection = get_unique_ptr_with_releaser(fisheye_projection_interface::create_instance(&fisheye, &rectified));
+    ASSERT_NE(nullptr, projection);
+
+    //the points unprojected from their fisheye pixels are the projected points
+    point3dF32 points[] = { { 0.f, 0.f, 1000.f }, { 400.f, -300.f, 900.f }, { -1500.f, 800.f, 600.f } };
+    const int32_t npoints = sizeof(points) / sizeof(points[0]);
+    pointF32 pixels[npoints];
+    ASSERT_EQ(status_no_error, projection->project_camera_to_fisheye(npoints, points, pixels));
+    point3dF32 pixels_depth[npoints], unprojected[npoints];
+    for (int32_t i = 0; i < npoints; i++)
+        pixels_depth[i] = { pixels[i].x, pixels[i].y, points[i].z };
+    ASSERT_EQ(status_no_error, projection->project_fisheye_to_camera(npoints, pixels_depth, unprojected));
+    for (int32_t i = 0; i < npoints; i++)
+    {
+        EXPECT_NEAR(points[i].x, unprojected[i].x, 0.05f) << "point " << i;
+        EXPECT_NEAR(points[i].y, unprojected[i].y, 0.05f) << "point " << i;
+    }
+    EXPECT_NEAR(fisheye.ppx, pixels[0].x, 1e-4f);
+    EXPECT_NEAR(fisheye.ppy, pixels[0].y, 1e-4f);
+
+    //each rectified pixel maps to the fisheye pixel of its pinhole ray
+    std::vector<pointF32> map(rectified.width * rectified.height);
+    ASSERT_EQ(status_no_error, projection->query_rectification_map(map.data()));
+    for (int y = 0; y < rectified.height; y += 17)
+        for (int x = 0; x < rectified.width; x += 13)
+        {
+            point3dF32 ray = { (static_cast<float>(x) - rectified.ppx) / rectified.fx, (static_cast<float>(y) - rectified.ppy) / rectified.fy, 1.f };
+            pointF32 pixel;
+            ASSERT_EQ(status_no_error, projection->project_camera_to_fisheye(1, &ray, &pixel));
+            EXPECT_NEAR(pixel.x, map[y * rectified.width + x].x, 1e-3f);
+            EXPECT_NEAR(pixel.y, map[y * rectified.width + x].y, 1e-3f);
+        }
+
+    //a horizontal ramp is rectified to the ramp value at the mapped coordinates, interpolated bilinearly
+    std::vector<uint8_t> ramp(fisheye.width * fisheye.height);
+    for (int y = 0; y < fisheye.height; y++)
+        for (int x = 0; x < fisheye.width; x++)
+            ramp[y * fisheye.width + x] = static_cast<uint8_t>(x * 255 / (fisheye.width - 1));
+    image_info fisheye_info = { fisheye.width, fisheye.height, pixel_format::raw8, fisheye.width };
+    auto fisheye_image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&fisheye_info, { ramp.data(), nullptr },
+                                                      stream_type::fisheye, image_interface::flag::any, 33., 7));
+    auto rectified_image = get_unique_ptr_with_releaser(projection->create_rectified_image(fisheye_image.get()));
+    ASSERT_NE(nullptr, rectified_image);
+    image_info rectified_info = rectified_image->query_info();
+    ASSERT_EQ(rectified.width, rectified_info.width);
+    ASSERT_EQ(rectified.height, rectified_info.height);
+    EXPECT_EQ(pixel_format::raw8, rectified_info.format);
+    EXPECT_EQ(7u, rectified_image->query_frame_number());
+    const uint8_t *rectified_data = static_cast<const uint8_t*>(rectified_image->query_data());
+    for (int y = 0; y < rectified.height; y++)
+        for (int x = 0; x < rectified.width; x++)
+        {
+            const pointF32 & source = map[y * rectified.width + x];
+            const float expected = source.x * 255.f / static_cast<float>(fisheye.width - 1);
+            ASSERT_NEAR(expected, rectified_data[y * rectified_info.pitch + x], 2.f) << "pixel " << x << ", " << y;
+        }
+
+    //the image of another size isn't rectified
+    image_info small_info = { fisheye.width / 2, fisheye.height / 2, pixel_format::raw8, fisheye.width / 2 };
+    auto small_image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&small_info, { ramp.data(), nullptr },
+                                                    stream_type::fisheye, image_interface::flag::any, 0., 0));
+    EXPECT_EQ(nullptr, projection->create_rectified_image(small_image.get()));
+}
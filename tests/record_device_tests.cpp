@@ -3,12 +3,22 @@
 
 #include <stdio.h>
 #include <map>
+#include <thread>
+#include <fstream>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
 #include <librealsense/rs.hpp>
 #include "gtest/gtest.h"
 #include "utilities/utilities.h"
 #include "rs/record/record_device.h"
 #include "rs/record/record_context.h"
+#include "rs/playback/playback_context.h"
+#include "rs/playback/playback_device.h"
 #include "file_types.h"
+#include "stream_file.h"
+#include "frame_slots.h"
 #include "viewer.h"
 
 using namespace std;
@@ -103,6 +113,601 @@ TEST_F(record_fixture, wait_for_frames)
     m_device->stop();
 }
 
+TEST_F(record_fixture, recording_statistics)
+{
+    auto stream = rs::stream::depth;
+    auto sp = setup::profiles[stream];
+    m_device->enable_stream(stream, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+
+    m_device->start();
+    auto frame_count = 0;
+    while(frame_count++ < setup::frames)
+    {
+        m_device->wait_for_frames();
+    }
+    m_device->stop();
+
+    rs::record::recording_statistics statistics = {};
+    ASSERT_EQ(status_no_error, m_device->query_recording_statistics(stream, statistics));
+    EXPECT_GT(statistics.recorded_frames_count, 0u);
+    EXPECT_LE(statistics.recorded_frames_count + statistics.dropped_frames_count, static_cast<uint64_t>(setup::frames) + 1);
+    EXPECT_GE(statistics.raw_bytes, statistics.recorded_frames_count * sp.info.width * sp.info.height * 2);
+    //the depth stream is compressed by default
+    EXPECT_LT(statistics.written_bytes, statistics.raw_bytes);
+    EXPECT_GT(statistics.encode_time, 0u);
+
+    rs::record::recorder_statistics recorder_statistics = {};
+    ASSERT_EQ(status_no_error, m_device->query_recorder_statistics(recorder_statistics));
+    EXPECT_EQ(0u, recorder_statistics.queued_samples_count);
+    EXPECT_LT(0u, recorder_statistics.queue_high_watermark);
+    EXPECT_LE(recorder_statistics.queue_high_watermark, recorder_statistics.queue_capacity);
+    EXPECT_EQ(statistics.dropped_frames_count, recorder_statistics.dropped_frames_count);
+    EXPECT_GT(recorder_statistics.written_bytes, statistics.written_bytes);
+
+    rs::record::recording_statistics color_statistics = {};
+    ASSERT_EQ(status_no_error, m_device->query_recording_statistics(rs::stream::color, color_statistics));
+    EXPECT_EQ(0u, color_statistics.recorded_frames_count);
+    EXPECT_EQ(status_invalid_argument, m_device->query_recording_statistics(static_cast<rs::stream>(RS_STREAM_COUNT), color_statistics));
+}
+
+TEST_F(record_fixture, record_with_file_preallocation)
+{
+    ASSERT_EQ(status_no_error, m_device->set_file_preallocation(1));
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        m_device->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+    }
+
+    m_device->start();
+    EXPECT_EQ(status_invalid_state, m_device->set_file_preallocation(0));
+    for(auto i = 0; i < setup::frames; i++)
+        m_device->wait_for_frames();
+    m_device->stop();
+    m_context.reset();
+
+    //the reserved extents beyond the recording were released
+    struct stat file_stat = {};
+    ASSERT_EQ(0, stat(setup::file_path.c_str(), &file_stat));
+    EXPECT_LT(static_cast<uint64_t>(file_stat.st_blocks) * 512, static_cast<uint64_t>(file_stat.st_size) + 1024 * 1024);
+
+    rs::playback::context playback_context(setup::file_path.c_str());
+    auto playback = playback_context.get_playback_device();
+    ASSERT_NE(nullptr, playback);
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        EXPECT_LT(0, playback->get_frame_count(it->first));
+    }
+}
+
+TEST_F(record_fixture, record_striped_files)
+{
+    const char * directories[] = { ".", "." };
+    ASSERT_EQ(status_no_error, m_device->set_file_striping(directories, 2));
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        m_device->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+    }
+
+    m_device->start();
+    EXPECT_EQ(status_invalid_state, m_device->set_file_striping(directories, 1));
+    for(auto i = 0; i < setup::frames; i++)
+        m_device->wait_for_frames();
+    m_device->stop();
+    m_context.reset();
+
+    //the image data is in the stripe files, the recording plays back through its references
+    std::map<rs::stream, uint32_t> frames_count;
+    rs::playback::context playback_context(setup::file_path.c_str());
+    auto playback = playback_context.get_playback_device();
+    ASSERT_NE(nullptr, playback);
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        EXPECT_LT(0, playback->get_frame_count(it->first));
+        stream_profile sp = it->second;
+        playback->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+        playback->set_frame_callback(it->first, [&frames_count, it](rs::frame f) { frames_count[it->first]++; });
+    }
+    playback->set_real_time(false);
+    playback->start();
+    while(playback->is_streaming())
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    playback->stop();
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        EXPECT_EQ(static_cast<uint32_t>(playback->get_frame_count(it->first)), frames_count[it->first]);
+    }
+}
+
+TEST_F(record_fixture, record_stream_data_files)
+{
+    ASSERT_EQ(status_no_error, m_device->set_stream_data_files(true));
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        m_device->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+    }
+
+    m_device->start();
+    EXPECT_EQ(status_invalid_state, m_device->set_stream_data_files(false));
+    for(auto i = 0; i < setup::frames; i++)
+        m_device->wait_for_frames();
+    m_device->stop();
+    m_context.reset();
+
+    //each stream has a data file next to the recording file
+    struct stat file_stat = {};
+    for(size_t i = 0; i < setup::profiles.size(); i++)
+    {
+        EXPECT_EQ(0, stat((setup::file_path + ".stripe" + std::to_string(i)).c_str(), &file_stat));
+    }
+
+    //a single stream plays back from its own data file
+    auto stream = setup::profiles.begin()->first;
+    stream_profile sp = setup::profiles.begin()->second;
+    uint32_t frames_count = 0;
+    rs::playback::context playback_context(setup::file_path.c_str());
+    auto playback = playback_context.get_playback_device();
+    ASSERT_NE(nullptr, playback);
+    playback->enable_stream(stream, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+    playback->set_frame_callback(stream, [&frames_count](rs::frame f) { frames_count++; });
+    playback->set_real_time(false);
+    playback->start();
+    while(playback->is_streaming())
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    playback->stop();
+    EXPECT_EQ(static_cast<uint32_t>(playback->get_frame_count(stream)), frames_count);
+}
+
+TEST_F(record_fixture, record_preview_track)
+{
+    const uint32_t scale = 8;
+    const uint32_t interval = 5;
+    EXPECT_EQ(status_invalid_argument, m_device->set_preview(1, interval));
+    EXPECT_EQ(status_invalid_argument, m_device->set_preview(scale, 0));
+    ASSERT_EQ(status_no_error, m_device->set_preview(scale, interval));
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        m_device->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+    }
+
+    m_device->start();
+    EXPECT_EQ(status_invalid_state, m_device->set_preview(scale, interval));
+    for(auto i = 0; i < setup::frames; i++)
+        m_device->wait_for_frames();
+    m_device->stop();
+    m_context.reset();
+
+    //every interval frame of a stream has a preview, which references the recorded frame
+    rs::playback::context playback_context(setup::file_path.c_str());
+    auto playback = playback_context.get_playback_device();
+    ASSERT_NE(nullptr, playback);
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        auto frames_count = playback->get_frame_count(it->first);
+        int previews_count = 0;
+        rs::playback::preview_frame preview = {};
+        while(playback->get_preview_frame(it->first, previews_count, preview))
+        {
+            EXPECT_EQ(sp.info.height / static_cast<int>(scale), preview.height);
+            EXPECT_EQ(static_cast<int>(scale), preview.scale);
+            EXPECT_EQ(static_cast<rs::format>(sp.info.format), preview.format);
+            EXPECT_EQ(previews_count * static_cast<int>(interval), preview.frame_index);
+            EXPECT_NE(nullptr, preview.data);
+            previews_count++;
+        }
+        EXPECT_EQ((frames_count + static_cast<int>(interval) - 1) / static_cast<int>(interval), previews_count);
+    }
+    //the first preview is read again after the scan is complete
+    rs::playback::preview_frame first = {};
+    EXPECT_TRUE(playback->get_preview_frame(setup::profiles.begin()->first, 0, first));
+    EXPECT_EQ(0, first.frame_index);
+}
+
+TEST_F(record_fixture, record_change_gated_frames)
+{
+    //no tile of a byte image differs by more than 255 on average, every frame after the first of a stream is a repeat
+    const uint32_t threshold = 255;
+    ASSERT_EQ(status_no_error, m_device->set_change_gate(threshold));
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        m_device->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+        //temporal compression streams aren't gated
+        m_device->set_compression(it->first, rs::record::compression_level::low);
+    }
+
+    m_device->start();
+    EXPECT_EQ(status_invalid_state, m_device->set_change_gate(0));
+    for(auto i = 0; i < setup::frames; i++)
+        m_device->wait_for_frames();
+    m_device->stop();
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        rs::record::recording_statistics statistics = {};
+        ASSERT_EQ(status_no_error, m_device->query_recording_statistics(it->first, statistics));
+        EXPECT_LT(0u, statistics.recorded_frames_count);
+        EXPECT_EQ(statistics.recorded_frames_count - 1, statistics.repeated_frames_count);
+    }
+    m_context.reset();
+
+    //the repeated frames are played back with the data of the first frame of their stream
+    std::map<rs::stream, int> frames_count;
+    std::map<rs::stream, int> empty_frames_count;
+    rs::playback::context playback_context(setup::file_path.c_str());
+    auto playback = playback_context.get_playback_device();
+    ASSERT_NE(nullptr, playback);
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        playback->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+        playback->set_frame_callback(it->first, [&frames_count, &empty_frames_count, it](rs::frame f)
+        {
+            frames_count[it->first]++;
+            if(f.get_data() == nullptr)
+                empty_frames_count[it->first]++;
+        });
+    }
+    playback->set_real_time(false);
+    playback->start();
+    while(playback->is_streaming())
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    playback->stop();
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        EXPECT_EQ(playback->get_frame_count(it->first), frames_count[it->first]);
+        EXPECT_EQ(0, empty_frames_count[it->first]);
+    }
+}
+
+TEST_F(record_fixture, record_transformed_streams)
+{
+    const rs::record::stream_transform transform = {2, 2, 0, 0, 2};
+    EXPECT_EQ(status_invalid_argument, m_device->set_stream_transform(rs::stream::depth, {-1, 0, 0, 0, 1}));
+    EXPECT_EQ(status_invalid_argument, m_device->set_stream_transform(rs::stream::depth, {0, 0, 0, 0, 9}));
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        m_device->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+        ASSERT_EQ(status_no_error, m_device->set_stream_transform(it->first, transform));
+    }
+
+    m_device->start();
+    EXPECT_EQ(status_invalid_state, m_device->set_stream_transform(rs::stream::depth, transform));
+    for(auto i = 0; i < setup::frames; i++)
+        m_device->wait_for_frames();
+    m_device->stop();
+    m_context.reset();
+
+    //the recorded profile and frames are of the cropped and downscaled size
+    std::map<rs::stream, int> frames_count;
+    std::map<rs::stream, int> wrong_size_frames_count;
+    rs::playback::context playback_context(setup::file_path.c_str());
+    auto playback = playback_context.get_playback_device();
+    ASSERT_NE(nullptr, playback);
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        const int width = (sp.info.width - transform.x) / transform.scale;
+        const int height = (sp.info.height - transform.y) / transform.scale;
+        playback->enable_stream(it->first, width, height, (rs::format)sp.info.format, sp.frame_rate);
+        EXPECT_EQ(width, playback->get_stream_width(it->first));
+        EXPECT_EQ(height, playback->get_stream_height(it->first));
+        playback->set_frame_callback(it->first, [&frames_count, &wrong_size_frames_count, it, width, height](rs::frame f)
+        {
+            frames_count[it->first]++;
+            if(f.get_width() != width || f.get_height() != height)
+                wrong_size_frames_count[it->first]++;
+        });
+    }
+    playback->set_real_time(false);
+    playback->start();
+    while(playback->is_streaming())
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    playback->stop();
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        EXPECT_LT(0, frames_count[it->first]);
+        EXPECT_EQ(0, wrong_size_frames_count[it->first]);
+    }
+}
+
+TEST_F(record_fixture, record_default_format_version)
+{
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        m_device->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+    }
+
+    m_device->start();
+    for(auto i = 0; i < setup::frames; i++)
+        m_device->wait_for_frames();
+    m_device->stop();
+    m_context.reset();
+
+    //without format extensions the recording is read by the earlier sdk versions
+    rs::playback::context playback_context(setup::file_path.c_str());
+    auto playback = playback_context.get_playback_device();
+    ASSERT_NE(nullptr, playback);
+    EXPECT_EQ(2, playback->get_file_info().version);
+}
+
+TEST_F(record_fixture, set_format_extensions)
+{
+    EXPECT_EQ(status_invalid_argument, m_device->set_format_extensions(1u << 31));
+    EXPECT_EQ(status_no_error, m_device->set_format_extensions(rs::record::format_extension::extension_motion_blocks));
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        m_device->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+    }
+
+    m_device->start();
+    EXPECT_EQ(status_invalid_state, m_device->set_format_extensions(0));
+    m_device->stop();
+}
+
+TEST_F(record_fixture, record_sample_bundles)
+{
+    EXPECT_EQ(status_invalid_argument, m_device->set_format_extensions(1u << 31));
+    ASSERT_EQ(status_no_error, m_device->set_format_extensions(rs::record::format_extension::extension_sample_bundles));
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        m_device->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+    }
+
+    m_device->start();
+    for(auto i = 0; i < setup::frames; i++)
+        m_device->wait_for_frames();
+    m_device->stop();
+    m_context.reset();
+
+    //without the samples index, the recording is indexed from the bundles of its samples
+    ::remove(samples_index_path(setup::file_path).c_str());
+    std::map<rs::stream, int> frames_count;
+    rs::playback::context playback_context(setup::file_path.c_str());
+    auto playback = playback_context.get_playback_device();
+    ASSERT_NE(nullptr, playback);
+    EXPECT_EQ(3, playback->get_file_info().version);
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        EXPECT_LT(0, playback->get_frame_count(it->first));
+        stream_profile sp = it->second;
+        playback->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+        playback->set_frame_callback(it->first, [&frames_count, it](rs::frame f) { frames_count[it->first]++; });
+    }
+    playback->set_real_time(false);
+    playback->start();
+    while(playback->is_streaming())
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    playback->stop();
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        EXPECT_EQ(playback->get_frame_count(it->first), frames_count[it->first]);
+    }
+}
+
+TEST_F(record_fixture, record_frame_metadata_mask)
+{
+    ASSERT_EQ(status_no_error, m_device->set_format_extensions(rs::record::format_extension::extension_frame_metadata));
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        m_device->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+    }
+
+    m_device->start();
+    for(auto i = 0; i < setup::frames; i++)
+        m_device->wait_for_frames();
+    m_device->stop();
+    m_context.reset();
+
+    std::map<rs::stream, int> frames_count;
+    std::map<rs::stream, int> no_metadata_frames_count;
+    rs::playback::context playback_context(setup::file_path.c_str());
+    auto playback = playback_context.get_playback_device();
+    ASSERT_NE(nullptr, playback);
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        playback->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+        playback->set_frame_callback(it->first, [&frames_count, &no_metadata_frames_count, it](rs::frame f)
+        {
+            frames_count[it->first]++;
+            if(!f.supports_frame_metadata(rs_frame_metadata::RS_FRAME_METADATA_ACTUAL_EXPOSURE))
+                no_metadata_frames_count[it->first]++;
+        });
+    }
+    playback->set_real_time(false);
+    playback->start();
+    while(playback->is_streaming())
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    playback->stop();
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        EXPECT_LT(0, frames_count[it->first]);
+        EXPECT_EQ(0, no_metadata_frames_count[it->first]);
+    }
+}
+
+TEST_F(record_fixture, record_segmented_files)
+{
+    ASSERT_EQ(status_no_error, m_device->set_file_segmentation(0, 1));
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        m_device->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+    }
+
+    m_device->start();
+    for(auto i = 0; i < setup::frames; i++)
+        m_device->wait_for_frames();
+    m_device->stop();
+    m_context.reset();
+
+    //about 3 seconds were recorded, each segment plays back on its own, the pre-opened segment which wasn't recorded was removed
+    std::vector<std::string> segments = { setup::file_path };
+    struct stat file_stat = {};
+    for(auto segment_index = 1; segment_index < 10; segment_index++)
+    {
+        auto segment = "rstest_000" + std::to_string(segment_index) + ".rssdk";
+        if(stat(segment.c_str(), &file_stat) != 0)
+            break;
+        segments.push_back(segment);
+    }
+    EXPECT_LE(3u, segments.size());
+    for(auto & segment : segments)
+    {
+        rs::playback::context playback_context(segment.c_str());
+        auto playback = playback_context.get_playback_device();
+        ASSERT_NE(nullptr, playback) << segment;
+        for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+        {
+            EXPECT_LT(0, playback->get_frame_count(it->first)) << segment;
+        }
+    }
+
+    for(size_t segment_index = 1; segment_index < segments.size(); segment_index++)
+    {
+        ::remove(segments[segment_index].c_str());
+        ::remove(samples_index_path(segments[segment_index]).c_str());
+    }
+}
+
+TEST_F(record_fixture, pre_trigger_recording)
+{
+    EXPECT_EQ(status_invalid_state, m_device->trigger_recording());
+    ASSERT_EQ(status_no_error, m_device->set_pre_trigger_recording(1, 1));
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        stream_profile sp = it->second;
+        m_device->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+    }
+
+    //about 3 seconds are captured, the second before the trigger and the second after it are recorded
+    m_device->start();
+    for(auto i = 0; i < setup::frames; i++)
+    {
+        if(i == setup::frames / 2)
+            EXPECT_EQ(status_no_error, m_device->trigger_recording());
+        m_device->wait_for_frames();
+    }
+    m_device->stop();
+    m_context.reset();
+
+    rs::playback::context playback_context(setup::file_path.c_str());
+    auto playback = playback_context.get_playback_device();
+    ASSERT_NE(nullptr, playback);
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        EXPECT_LT(0, playback->get_frame_count(it->first));
+        EXPECT_GT(setup::frames * 3 / 4, playback->get_frame_count(it->first));
+    }
+}
+
+TEST_F(record_fixture, record_to_pipe)
+{
+    const std::string pipe_path = "rstest_record.fifo";
+    const std::string received_path = "rstest_received.rssdk";
+    ::remove(pipe_path.c_str());
+    ASSERT_EQ(0, mkfifo(pipe_path.c_str(), 0600));
+
+    //the receiver stores the stream as is, the recording is written without seeking
+    std::thread receiver([&]()
+    {
+        std::ifstream pipe(pipe_path, std::ios::binary);
+        std::ofstream received(received_path, std::ios::binary);
+        received << pipe.rdbuf();
+    });
+
+    std::map<rs::stream, int> frame_counter;
+    {
+        m_context.reset();
+        rs::record::context context(pipe_path.c_str());
+        ASSERT_NE(0, context.get_device_count()) << "no device detected";
+        auto device = context.get_record_device(0);
+        ASSERT_NE(nullptr, device);
+        for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+        {
+            stream_profile sp = it->second;
+            device->enable_stream(it->first, sp.info.width, sp.info.height, (rs::format)sp.info.format, sp.frame_rate);
+        }
+        device->start();
+        for(auto i = 0; i < setup::frames; i++)
+            device->wait_for_frames();
+        device->stop();
+    }
+    receiver.join();
+
+    rs::playback::context playback_context(received_path.c_str());
+    auto playback = playback_context.get_playback_device();
+    ASSERT_NE(nullptr, playback);
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        EXPECT_NE(0, playback->get_stream_mode_count(it->first));
+        EXPECT_LT(0, playback->get_frame_count(it->first));
+    }
+
+    ::remove(pipe_path.c_str());
+    ::remove(received_path.c_str());
+}
+
+TEST(record_frame_slots, released_slot_is_reused)
+{
+    rs::record::frame_slots slots(2);
+    auto first = slots.acquire(64);
+    auto second = slots.acquire(64);
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    EXPECT_NE(first, second);
+
+    //all the slots hold frames which wait to be written, the next frame isn't copied
+    EXPECT_EQ(nullptr, slots.acquire(64));
+
+    //the written frame frees its slot for the next frame, a larger frame than the slots doesn't fit
+    slots.release(first);
+    EXPECT_EQ(nullptr, slots.acquire(128));
+    EXPECT_EQ(first, slots.acquire(32));
+    EXPECT_EQ(nullptr, slots.acquire(64));
+    EXPECT_EQ(2u, slots.query_slots_count());
+}
+
+TEST(record_stream_file, closed_pipe_reader_fails_the_write)
+{
+    const std::string pipe_path = "rstest_closed_reader.fifo";
+    ::remove(pipe_path.c_str());
+    ASSERT_EQ(0, mkfifo(pipe_path.c_str(), 0600));
+
+    //the reader opens without blocking, so the sink can open the pipe, and goes away before the sink writes
+    int reader = ::open(pipe_path.c_str(), O_RDONLY | O_NONBLOCK);
+    ASSERT_LE(0, reader);
+    rs::core::stream_file sink;
+    ASSERT_EQ(rs::core::status_no_error, sink.open(pipe_path, rs::core::open_file_option::write));
+    ::close(reader);
+
+    const char data[16] = {};
+    unsigned int bytes_written = 0;
+    EXPECT_EQ(rs::core::status_file_write_failed, sink.write_bytes(data, sizeof(data), bytes_written));
+    EXPECT_FALSE(sink.is_good());
+
+    //the SIGPIPE the write raised was consumed, and SIGPIPE isn't left blocked
+    sigset_t pending;
+    sigemptyset(&pending);
+    sigpending(&pending);
+    EXPECT_EQ(0, sigismember(&pending, SIGPIPE));
+    sigset_t mask;
+    pthread_sigmask(SIG_SETMASK, nullptr, &mask);
+    EXPECT_EQ(0, sigismember(&mask, SIGPIPE));
+
+    sink.close();
+    ::remove(pipe_path.c_str());
+}
+
 TEST_F(record_fixture, frames_callback)
 {
     for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
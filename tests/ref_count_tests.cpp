@@ -2,6 +2,8 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "rs/core/ref_count_interface.h"
@@ -111,3 +113,34 @@ GTEST_TEST(reference_count_base_tests, unique_ptr_wrapper)
     ASSERT_EQ(1, object->ref_count());
     initially_empty_unique_object.reset();
 }
+
+GTEST_TEST(reference_count_base_tests, concurrent_references_and_single_owner_release)
+{
+    mock::ref_counted_derived_interface * object = new mock::ref_counted_derived();
+
+    //the references of other threads are counted atomically
+    std::vector<std::thread> referencing_threads;
+    for(int thread = 0; thread < 4; thread++)
+    {
+        object->add_ref();
+        referencing_threads.emplace_back([object]()
+        {
+            for(int reference = 0; reference < 10000; reference++)
+            {
+                object->add_ref();
+                object->release();
+            }
+            object->release();
+        });
+    }
+    for(auto & referencing_thread : referencing_threads)
+    {
+        referencing_thread.join();
+    }
+    ASSERT_EQ(1, object->ref_count());
+
+    //the single owner release deletes the object
+    ASSERT_EQ(2, object->add_ref());
+    ASSERT_EQ(1, object->release());
+    ASSERT_EQ(0, object->release());
+}
@@ -2,7 +2,18 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include "gtest/gtest.h"
+#include <thread>
+#include <mutex>
 #include "rs/utils/cyclic_array.h"
+#include "rs/utils/concurrent_cyclic_array.h"
+#include "rs/utils/thread_config.h"
+#include "rs/utils/thread_profiler.h"
+#include "rs/utils/numa_topology.h"
+#include "rs/utils/memory_accounting.h"
+#include "rs/utils/timebase.h"
+#include "rs/utils/async_video_module_base.h"
+#include "rs/core/image_interface.h"
+#include "spsc_queue.h"
 #include "utilities/version.h"
 
 using namespace std;
@@ -205,4 +216,374 @@ TEST(cyclic_array, cyclic_array_test)
     
 }
     
-    
\ No newline at end of file
+    
+
+TEST(spsc_queue, bounded_push_pop)
+{
+    rs::core::spsc_queue<int> queue(2);
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(queue.capacity(), 2u);
+
+    ASSERT_TRUE(queue.push(1));
+    ASSERT_TRUE(queue.push(2));
+    ASSERT_FALSE(queue.push(3));
+    ASSERT_EQ(queue.size(), 2u);
+    ASSERT_EQ(queue.high_watermark(), 2u);
+
+    int value = 0;
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(value, 1);
+    ASSERT_TRUE(queue.push(3));
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(value, 2);
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(value, 3);
+    ASSERT_FALSE(queue.pop(value));
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(queue.high_watermark(), 2u);
+}
+
+TEST(spsc_queue, concurrent_producer_consumer)
+{
+    const int number_of_elements = 10000;
+    rs::core::spsc_queue<int> queue(64);
+    std::thread producer([&queue, number_of_elements]()
+    {
+        for(int i = 0; i < number_of_elements;)
+        {
+            if(queue.push(i)) i++;
+            else std::this_thread::yield();
+        }
+    });
+
+    int expected = 0;
+    while(expected < number_of_elements)
+    {
+        int value = -1;
+        if(!queue.pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT_EQ(value, expected);
+        expected++;
+    }
+    producer.join();
+    ASSERT_TRUE(queue.empty());
+    ASSERT_LE(queue.high_watermark(), queue.capacity());
+}
+
+TEST(concurrent_cyclic_array, bounded_push_pop)
+{
+    ASSERT_THROW(concurrent_cyclic_array<int>(0), std::out_of_range);
+
+    concurrent_cyclic_array<int> array(3);
+    ASSERT_TRUE(array.empty());
+    ASSERT_EQ(array.capacity(), 4u);
+
+    for(int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(array.push_back(i));
+    }
+    int element = 4;
+    ASSERT_FALSE(array.push_back(element));
+    ASSERT_EQ(array.size(), 4u);
+
+    int value = -1;
+    ASSERT_TRUE(array.pop_front(value));
+    ASSERT_EQ(value, 0);
+    ASSERT_TRUE(array.push_back(element));
+    for(int i = 1; i <= 4; i++)
+    {
+        ASSERT_TRUE(array.pop_front(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_FALSE(array.pop_front(value));
+    ASSERT_TRUE(array.empty());
+}
+
+TEST(concurrent_cyclic_array, concurrent_producers_keep_their_order)
+{
+    const int number_of_producers = 4;
+    const int number_of_elements = 10000;
+    concurrent_cyclic_array<std::pair<int, int>, producers_model::multiple> array(64);
+    std::vector<std::thread> producers;
+    for(int producer = 0; producer < number_of_producers; producer++)
+    {
+        producers.emplace_back([&array, producer, number_of_elements]()
+        {
+            for(int i = 0; i < number_of_elements;)
+            {
+                auto element = std::make_pair(producer, i);
+                if(array.push_back(element)) i++;
+                else std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<int> expected(number_of_producers, 0);
+    for(int popped = 0; popped < number_of_producers * number_of_elements;)
+    {
+        std::pair<int, int> element;
+        if(!array.pop_front(element))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT_EQ(element.second, expected[element.first]);
+        expected[element.first] = element.second + 1;
+        popped++;
+    }
+    for(auto & producer : producers)
+    {
+        producer.join();
+    }
+    ASSERT_TRUE(array.empty());
+}
+
+TEST(thread_configuration, validates_the_configuration)
+{
+    EXPECT_EQ(rs::core::status_invalid_argument, thread_configuration::set_config(thread_role::max, thread_config()));
+    EXPECT_EQ(rs::core::status_invalid_argument, thread_configuration::set_config(thread_role::viewer, { 0, thread_scheduling::normal, 20 }));
+    EXPECT_EQ(rs::core::status_invalid_argument, thread_configuration::set_config(thread_role::viewer, { 0, thread_scheduling::real_time, 0 }));
+    EXPECT_EQ(rs::core::status_invalid_argument, thread_configuration::set_config(thread_role::viewer, { 0, thread_scheduling::real_time, 100 }));
+
+    thread_config config = { 1, thread_scheduling::normal, 5 };
+    ASSERT_EQ(rs::core::status_no_error, thread_configuration::set_config(thread_role::viewer, config));
+    thread_config queried_config = thread_configuration::query_config(thread_role::viewer);
+    EXPECT_EQ(config.cpu_affinity_mask, queried_config.cpu_affinity_mask);
+    EXPECT_EQ(config.scheduling, queried_config.scheduling);
+    EXPECT_EQ(config.priority, queried_config.priority);
+    ASSERT_EQ(rs::core::status_no_error, thread_configuration::set_config(thread_role::viewer, thread_config()));
+}
+
+TEST(thread_configuration, applies_the_role_configuration_to_the_calling_thread)
+{
+    //lowering the priority and pinning to the first cpu don't require privileges
+    ASSERT_EQ(rs::core::status_no_error, thread_configuration::set_config(thread_role::cv_module, { 1, thread_scheduling::normal, 10 }));
+    rs::core::status apply_status = rs::core::status_no_error;
+    std::thread configured_thread([&]()
+    {
+        apply_status = thread_configuration::apply(thread_role::cv_module, "rs-test-thread");
+    });
+    configured_thread.join();
+    EXPECT_EQ(rs::core::status_no_error, apply_status);
+
+    //the default configuration leaves the thread settings
+    ASSERT_EQ(rs::core::status_no_error, thread_configuration::set_config(thread_role::cv_module, thread_config()));
+    EXPECT_EQ(rs::core::status_no_error, thread_configuration::apply(thread_role::cv_module, nullptr));
+    EXPECT_EQ(rs::core::status_invalid_argument, thread_configuration::apply(thread_role::max, nullptr));
+}
+
+TEST(numa_topology, binds_the_calling_thread_to_a_node_of_the_host)
+{
+    ASSERT_GE(numa_topology::query_nodes_count(), 1);
+    EXPECT_EQ(numa_topology::UNKNOWN_NODE, numa_topology::query_usb_port_node(nullptr));
+    EXPECT_EQ(numa_topology::UNKNOWN_NODE, numa_topology::query_usb_port_node("../../devices"));
+    EXPECT_EQ(0u, numa_topology::query_node_cpus(numa_topology::query_nodes_count() + 1000));
+
+    rs::core::status bind_status = rs::core::status_exec_aborted;
+    rs::core::status unknown_node_status = rs::core::status_exec_aborted;
+    std::thread bound_thread([&]()
+    {
+        unknown_node_status = numa_topology::bind_thread(numa_topology::UNKNOWN_NODE, thread_role::recording);
+        if(numa_topology::query_node_cpus(0) != 0)
+            bind_status = numa_topology::bind_thread(0, thread_role::recording);
+        else
+            bind_status = rs::core::status_no_error;
+    });
+    bound_thread.join();
+    EXPECT_EQ(rs::core::status_no_error, unknown_node_status);
+    EXPECT_EQ(rs::core::status_no_error, bind_status);
+}
+
+TEST(timebase, is_monotonic_and_keeps_the_pace_of_the_steady_clock)
+{
+    auto start = timebase::now();
+    auto steady_start = std::chrono::steady_clock::now();
+    auto previous = start;
+    for(int i = 0; i < 1000; i++)
+    {
+        auto now = timebase::now();
+        ASSERT_GE(now, previous);
+        previous = now;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto elapsed = timebase::microseconds_since(start);
+    auto steady_elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - steady_start).count();
+    EXPECT_GE(elapsed, 50000u);
+    EXPECT_NEAR(static_cast<double>(steady_elapsed), static_cast<double>(elapsed), 5000);
+    EXPECT_EQ(0u, timebase::microseconds_since(timebase::now() + std::chrono::seconds(1)));
+}
+
+TEST(thread_profiler, counts_the_profiled_thread_waits_and_items)
+{
+    auto role_statistics_before = thread_profiler::query_role_statistics(thread_role::viewer);
+    thread_profiler profiler(thread_role::viewer);
+    std::mutex mutex;
+    std::thread profiled_thread([&]()
+    {
+        profiler.start();
+        {
+            thread_profiler::wait_scope input_wait(profiler, thread_wait::input);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        profiler.lock(mutex);
+        mutex.unlock();
+        volatile uint64_t sum = 0;
+        for(uint64_t i = 0; i < 10000000; i++)
+            sum += i;
+        profiler.add_processed_items(3);
+        profiler.stop();
+    });
+    profiled_thread.join();
+
+    //the waits of other threads aren't counted
+    profiler.add_wait_time(thread_wait::io, 1000);
+    profiler.add_processed_items();
+
+    auto statistics = profiler.query_statistics();
+    EXPECT_EQ(0u, statistics.threads_count);
+    EXPECT_EQ(3u, statistics.processed_items_count);
+    EXPECT_GE(statistics.wait_time[static_cast<int32_t>(thread_wait::input)], 20000u);
+    EXPECT_EQ(0u, statistics.wait_time[static_cast<int32_t>(thread_wait::io)]);
+    EXPECT_GE(statistics.running_time, statistics.wait_time[static_cast<int32_t>(thread_wait::input)]);
+    EXPECT_LE(statistics.cpu_time, statistics.running_time + 1000);
+
+    auto role_statistics = thread_profiler::query_role_statistics(thread_role::viewer);
+    EXPECT_EQ(role_statistics_before.processed_items_count + 3, role_statistics.processed_items_count);
+    EXPECT_EQ(role_statistics_before.threads_count, role_statistics.threads_count);
+    EXPECT_EQ(0u, thread_profiler::query_role_statistics(thread_role::max).processed_items_count);
+}
+
+TEST(memory_accounting, accounts_the_subsystems_bytes_within_the_budget)
+{
+    const uint64_t bytes = 1000;
+    auto usage_before = memory_accounting::query_usage(memory_subsystem::recording);
+    auto total_before = memory_accounting::query_total_bytes();
+
+    memory_accounting::add(memory_subsystem::recording, bytes);
+    auto usage = memory_accounting::query_usage(memory_subsystem::recording);
+    EXPECT_EQ(usage_before.bytes + bytes, usage.bytes);
+    EXPECT_LE(usage.bytes, usage.peak_bytes);
+    EXPECT_EQ(total_before + bytes, memory_accounting::query_total_bytes());
+
+    //the budget bounds the bytes of all the subsystems
+    EXPECT_TRUE(memory_accounting::is_within_budget(bytes));
+    ASSERT_EQ(rs::core::status_no_error, memory_accounting::set_budget(memory_accounting::query_total_bytes() + bytes));
+    EXPECT_TRUE(memory_accounting::is_within_budget(bytes));
+    EXPECT_FALSE(memory_accounting::is_within_budget(bytes + 1));
+    ASSERT_EQ(rs::core::status_no_error, memory_accounting::set_budget(0));
+    EXPECT_EQ(0u, memory_accounting::query_budget());
+
+    memory_accounting::add_dropped(memory_subsystem::recording, bytes);
+    memory_accounting::remove(memory_subsystem::recording, bytes);
+    usage = memory_accounting::query_usage(memory_subsystem::recording);
+    EXPECT_EQ(usage_before.bytes, usage.bytes);
+    EXPECT_EQ(usage_before.dropped_bytes + bytes, usage.dropped_bytes);
+    EXPECT_EQ(total_before, memory_accounting::query_total_bytes());
+    EXPECT_EQ(0u, memory_accounting::query_usage(memory_subsystem::max).bytes);
+}
+
+namespace
+{
+    struct depth_frame_output
+    {
+        uint64_t frame_number;
+        std::vector<uint8_t> buffer;
+    };
+
+    //counts the images data released by the images
+    class counting_data_releaser : public rs::core::release_interface
+    {
+    public:
+        counting_data_releaser() : m_count(0) {}
+        int release() const override { return ++m_count; }
+        int count() const { return m_count.load(); }
+    private:
+        mutable std::atomic<int> m_count;
+    };
+
+    //processes the depth images once its gate is open
+    class gated_module : public async_video_module_base<depth_frame_output>
+    {
+    public:
+        gated_module(uint32_t queue_depth) : async_video_module_base("rs-gated-module", queue_depth), m_is_open(false), m_processing_count(0) {}
+        ~gated_module() { stop_processing(); }
+
+        int32_t query_module_uid() override { return 0; }
+        rs::core::status query_supported_module_config(int32_t, supported_module_config &) override { return rs::core::status_item_unavailable; }
+        rs::core::status query_current_module_config(actual_module_config &) override { return rs::core::status_no_error; }
+        rs::core::status set_module_config(const actual_module_config &) override { return rs::core::status_no_error; }
+        rs::core::status reset_config() override { return rs::core::status_no_error; }
+
+        void open()
+        {
+            std::lock_guard<std::mutex> lock(m_gate_lock);
+            m_is_open = true;
+            m_gate.notify_all();
+        }
+        int processing_count() const { return m_processing_count.load(); }
+
+    protected:
+        rs::core::status process_samples(const rs::core::correlated_sample_set & sample_set, depth_frame_output & output) override
+        {
+            m_processing_count++;
+            std::unique_lock<std::mutex> lock(m_gate_lock);
+            m_gate.wait(lock, [this]() { return m_is_open; });
+            auto depth = sample_set[rs::core::stream_type::depth];
+            if(!depth)
+                return rs::core::status_item_unavailable;
+            output.frame_number = depth->query_frame_number();
+            output.buffer.resize(1024);
+            return rs::core::status_no_error;
+        }
+
+    private:
+        std::mutex m_gate_lock;
+        std::condition_variable m_gate;
+        bool m_is_open;
+        std::atomic<int> m_processing_count;
+    };
+}
+
+TEST(async_video_module_base, processes_the_queued_sample_sets_and_drops_the_overflow)
+{
+    uint16_t depth_data[4 * 4] = {};
+    rs::core::image_info info = { 4, 4, rs::core::pixel_format::z16, 4 * sizeof(uint16_t) };
+    counting_data_releaser releaser;
+    const int frames_count = 5;
+    {
+        gated_module module(2);
+        for(int frame = 1; frame <= frames_count; frame++)
+        {
+            auto image = rs::core::image_interface::create_instance_from_raw_data(&info, { depth_data, &releaser }, rs::core::stream_type::depth,
+                                                                                 rs::core::image_interface::flag::any, 0., frame);
+            rs::core::correlated_sample_set sample_set;
+            sample_set[rs::core::stream_type::depth] = image;
+            ASSERT_EQ(rs::core::status_no_error, module.process_sample_set(sample_set));
+            image->release();
+            //the first frame is being processed, the next frames wait in the queue
+            while(frame == 1 && module.processing_count() == 0)
+                std::this_thread::yield();
+        }
+        EXPECT_EQ(nullptr, module.query_output());
+        module.open();
+        auto output = module.wait_for_output();
+        while(output && output->frame_number != 3)
+            output = module.wait_for_output();
+        ASSERT_NE(nullptr, output);
+        EXPECT_EQ(1024u, output->buffer.size());
+        EXPECT_EQ(output, module.query_output());
+
+        auto statistics = module.query_statistics();
+        EXPECT_EQ(static_cast<uint64_t>(frames_count), statistics.received_sample_sets_count);
+        EXPECT_EQ(3u, statistics.processed_sample_sets_count);
+        EXPECT_EQ(0u, statistics.failed_sample_sets_count);
+        EXPECT_EQ(2u, statistics.dropped_sample_sets_count);
+        EXPECT_EQ(1u, statistics.threads.threads_count);
+        EXPECT_GE(statistics.max_processing_time * 3, statistics.total_processing_time);
+    }
+    //the queued and the dropped images were released
+    EXPECT_EQ(frames_count, releaser.count());
+}
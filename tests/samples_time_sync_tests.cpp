@@ -6,6 +6,8 @@
 #include "gtest/gtest.h"
 #include "utilities/utilities.h"
 #include <thread>
+#include <atomic>
+#include <chrono>
 
 //librealsense api
 #include "librealsense/rs.hpp"
@@ -456,6 +458,528 @@ TEST_F(samples_sync_external_camera_tests, dont_sync_newest_with_oldest)
     }
 }
 
+TEST_F(samples_sync_external_camera_tests, concurrent_inserts)
+{
+    int streams[static_cast<int>(rs::core::stream_type::max)] = {0};
+    int motions[static_cast<int>(rs::core::motion_type::max)] = {0};
+
+    streams[static_cast<int>(rs::core::stream_type::color)] = 30;
+    streams[static_cast<int>(rs::core::stream_type::depth)] = 30;
+
+    const int frames_count = 2000;
+    std::vector<std::shared_ptr<image_interface>> images;
+    std::atomic<int> sets_count(0);
+    std::atomic<bool> sets_valid(true);
+    {
+        rs::utils::unique_ptr<rs::utils::samples_time_sync_interface> samples_sync = rs::utils::get_unique_ptr_with_releaser(
+            rs::utils::samples_time_sync_interface::create_instance(streams, motions, rs::utils::samples_time_sync_interface::external_device_name));
+
+        auto insert_frames = [&](size_t first_image)
+        {
+            for(int i = 0; i < frames_count; i++)
+            {
+                smart_correlated_sample_set sample_set;
+                if(samples_sync->insert(images[first_image + i].get(), sample_set.get()))
+                {
+                    sets_count++;
+                    if(!sample_set.get()[stream_type::color] || !sample_set.get()[stream_type::depth])
+                        sets_valid = false;
+                }
+            }
+        };
+
+        for(int i = 0; i < frames_count; i++)
+            images.push_back(create_dummy_image(rs::core::stream_type::color, i));
+        for(int i = 0; i < frames_count; i++)
+            images.push_back(create_dummy_image(rs::core::stream_type::depth, i));
+
+        //each stream inserts from its own thread, as the camera callbacks do
+        std::thread color_thread(insert_frames, 0);
+        std::thread depth_thread(insert_frames, frames_count);
+        color_thread.join();
+        depth_thread.join();
+    }
+
+    ASSERT_TRUE(sets_valid);
+    ASSERT_GT(sets_count, 0);
+    //the sync utility released every image, including the queued ones
+    for(auto & image : images)
+        ASSERT_EQ(1, image->ref_count());
+}
+
+TEST_F(samples_sync_external_camera_tests, last_matched_sets_are_returned)
+{
+    int streams[static_cast<int>(rs::core::stream_type::max)] = {0};
+    int motions[static_cast<int>(rs::core::motion_type::max)] = {0};
+
+    streams[static_cast<int>(rs::core::stream_type::color)] = 30;
+    streams[static_cast<int>(rs::core::stream_type::depth)] = 30;
+    streams[static_cast<int>(rs::core::stream_type::infrared)] = 30;
+
+    const int frames_count = 200;
+    const int repeats_count = 50;
+    for(int repeat = 0; repeat < repeats_count; repeat++)
+    {
+        std::vector<std::shared_ptr<image_interface>> images;
+        for(int i = 0; i < frames_count; i++)
+            images.push_back(create_dummy_image(rs::core::stream_type::color, i));
+        for(int i = 0; i < frames_count; i++)
+            images.push_back(create_dummy_image(rs::core::stream_type::depth, i));
+        for(int i = 0; i < frames_count; i++)
+            images.push_back(create_dummy_image(rs::core::stream_type::infrared, i));
+
+        std::mutex last_frame_mutex;
+        uint64_t last_frame = 0;
+        auto on_matched_set = [&](smart_correlated_sample_set & sample_set)
+        {
+            std::lock_guard<std::mutex> lock(last_frame_mutex);
+            last_frame = std::max(last_frame, sample_set.get()[stream_type::depth]->query_frame_number());
+        };
+        {
+            rs::utils::unique_ptr<rs::utils::samples_time_sync_interface> samples_sync = rs::utils::get_unique_ptr_with_releaser(
+                rs::utils::samples_time_sync_interface::create_instance(streams, motions, rs::utils::samples_time_sync_interface::frame_counter_device_name));
+
+            smart_correlated_sample_set no_sample_set;
+            ASSERT_FALSE(samples_sync->get_matched_sample_set(no_sample_set.get()));
+
+            auto insert_frames = [&](size_t first_image)
+            {
+                for(int i = 0; i < frames_count; i++)
+                {
+                    smart_correlated_sample_set sample_set;
+                    if(samples_sync->insert(images[first_image + i].get(), sample_set.get()))
+                        on_matched_set(sample_set);
+                }
+            };
+            std::thread color_thread(insert_frames, 0);
+            std::thread depth_thread(insert_frames, frames_count);
+            std::thread infrared_thread(insert_frames, 2 * frames_count);
+            color_thread.join();
+            depth_thread.join();
+            infrared_thread.join();
+
+            //a set matched for an insert queued by the other thread is left for the caller
+            while(true)
+            {
+                smart_correlated_sample_set sample_set;
+                if(!samples_sync->get_matched_sample_set(sample_set.get()))
+                    break;
+                on_matched_set(sample_set);
+            }
+        }
+
+        ASSERT_EQ(static_cast<uint64_t>(frames_count - 1), last_frame) << "repeat - " << repeat;
+        for(auto & image : images)
+            ASSERT_EQ(1, image->ref_count());
+    }
+}
+
+TEST_F(samples_sync_external_camera_tests, drifting_clock_sync)
+{
+    int streams[static_cast<int>(rs::core::stream_type::max)] = {0};
+    int motions[static_cast<int>(rs::core::motion_type::max)] = {0};
+
+    streams[static_cast<int>(rs::core::stream_type::color)] = 30;
+    streams[static_cast<int>(rs::core::stream_type::depth)] = 30;
+
+    rs::utils::unique_ptr<rs::utils::samples_time_sync_interface> samples_sync = rs::utils::get_unique_ptr_with_releaser(
+        rs::utils::samples_time_sync_interface::create_instance(streams, motions, rs::utils::samples_time_sync_interface::external_device_name));
+
+    //the color clock is offset from the depth clock, and runs faster by 300 ppm
+    auto create_image = [](rs::core::stream_type stream, uint64_t frame)
+    {
+        const double period = 1000.0 / 30;
+        double timestamp = stream == stream_type::depth ? static_cast<double>(frame) * period : 5000 + static_cast<double>(frame) * period * 1.0003;
+        image_info info = {};
+        rs::core::image_interface::image_data_with_data_releaser image(nullptr, nullptr);
+        return rs::utils::get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, image, stream, image_interface::flag::any,
+                                                                                                       timestamp, frame));
+    };
+
+    //the images of a frame arrive together until the clocks are estimated
+    const uint64_t estimation_frames = 100;
+    for(uint64_t frame = 0; frame < estimation_frames; frame++)
+    {
+        smart_correlated_sample_set sample_set;
+        ASSERT_FALSE(samples_sync->insert(create_image(stream_type::color, frame).get(), sample_set.get()));
+        ASSERT_TRUE(samples_sync->insert(create_image(stream_type::depth, frame).get(), sample_set.get()));
+        ASSERT_EQ(frame, sample_set.get()[stream_type::color]->query_frame_number());
+    }
+
+    //the color images are delayed by two frames, the images of the same frame are still matched
+    const uint64_t color_delay = 2;
+    int sets_count = 0;
+    for(uint64_t frame = estimation_frames; frame < estimation_frames + 200; frame++)
+    {
+        smart_correlated_sample_set sample_set;
+        ASSERT_FALSE(samples_sync->insert(create_image(stream_type::depth, frame).get(), sample_set.get()));
+        if(frame < estimation_frames + color_delay)
+            continue;
+        ASSERT_TRUE(samples_sync->insert(create_image(stream_type::color, frame - color_delay).get(), sample_set.get()));
+        ASSERT_EQ(frame - color_delay, sample_set.get()[stream_type::depth]->query_frame_number());
+        ASSERT_EQ(frame - color_delay, sample_set.get()[stream_type::color]->query_frame_number());
+        sets_count++;
+    }
+    ASSERT_EQ(198, sets_count);
+    samples_sync->flush();
+}
+
+TEST_F(samples_sync_external_camera_tests, frame_counter_sync)
+{
+    int streams[static_cast<int>(rs::core::stream_type::max)] = {0};
+    int motions[static_cast<int>(rs::core::motion_type::max)] = {0};
+
+    streams[static_cast<int>(rs::core::stream_type::color)] = 30;
+    streams[static_cast<int>(rs::core::stream_type::depth)] = 30;
+    streams[static_cast<int>(rs::core::stream_type::infrared)] = 30;
+
+    rs::utils::unique_ptr<rs::utils::samples_time_sync_interface> samples_sync = rs::utils::get_unique_ptr_with_releaser(
+        rs::utils::samples_time_sync_interface::create_instance(streams, motions, rs::utils::samples_time_sync_interface::frame_counter_device_name, 150, 10));
+
+    {
+        //the timestamps of the streams differ, the frame numbers match
+        auto c1 = create_dummy_image(rs::core::stream_type::color, 1);
+        auto c2 = create_dummy_image(rs::core::stream_type::color, 2);
+        auto d2 = create_dummy_image(rs::core::stream_type::depth, 2);
+        auto i2 = create_dummy_image(rs::core::stream_type::infrared, 2);
+
+        smart_correlated_sample_set sample_set;
+        ASSERT_FALSE(samples_sync->insert(c1.get(), sample_set.get()));
+        ASSERT_FALSE(samples_sync->insert(c2.get(), sample_set.get()));
+        ASSERT_FALSE(samples_sync->insert(d2.get(), sample_set.get()));
+        //matched by the insert of the last image of the frame
+        ASSERT_TRUE(samples_sync->insert(i2.get(), sample_set.get()));
+        ASSERT_EQ(2u, sample_set.get()[stream_type::color]->query_frame_number());
+        ASSERT_EQ(2u, sample_set.get()[stream_type::depth]->query_frame_number());
+        ASSERT_EQ(2u, sample_set.get()[stream_type::infrared]->query_frame_number());
+
+        image_interface * not_matched = nullptr;
+        samples_sync->get_not_matched_frame(stream_type::color, &not_matched);
+        ASSERT_NE(nullptr, not_matched);
+        ASSERT_EQ(1u, not_matched->query_frame_number());
+        not_matched->release();
+    }
+
+    {
+        //the depth image of frame 3 was dropped, frame 4 is matched
+        auto c3 = create_dummy_image(rs::core::stream_type::color, 3);
+        auto i3 = create_dummy_image(rs::core::stream_type::infrared, 3);
+        auto d4 = create_dummy_image(rs::core::stream_type::depth, 4);
+        auto c4 = create_dummy_image(rs::core::stream_type::color, 4);
+        auto i4 = create_dummy_image(rs::core::stream_type::infrared, 4);
+
+        smart_correlated_sample_set sample_set;
+        ASSERT_FALSE(samples_sync->insert(c3.get(), sample_set.get()));
+        ASSERT_FALSE(samples_sync->insert(i3.get(), sample_set.get()));
+        ASSERT_FALSE(samples_sync->insert(d4.get(), sample_set.get()));
+        ASSERT_FALSE(samples_sync->insert(c4.get(), sample_set.get()));
+        ASSERT_TRUE(samples_sync->insert(i4.get(), sample_set.get()));
+        ASSERT_EQ(4u, sample_set.get()[stream_type::color]->query_frame_number());
+        ASSERT_EQ(4u, sample_set.get()[stream_type::depth]->query_frame_number());
+        ASSERT_EQ(4u, sample_set.get()[stream_type::infrared]->query_frame_number());
+    }
+    samples_sync->flush();
+}
+
+TEST_F(samples_sync_external_camera_tests, partial_sample_set_of_stalled_stream)
+{
+    int streams[static_cast<int>(rs::core::stream_type::max)] = {0};
+    int motions[static_cast<int>(rs::core::motion_type::max)] = {0};
+
+    streams[static_cast<int>(rs::core::stream_type::color)] = 30;
+    streams[static_cast<int>(rs::core::stream_type::depth)] = 30;
+    streams[static_cast<int>(rs::core::stream_type::fisheye)] = 30;
+
+    rs::utils::unique_ptr<rs::utils::samples_time_sync_interface> samples_sync = rs::utils::get_unique_ptr_with_releaser(
+        rs::utils::samples_time_sync_interface::create_instance(streams, motions, "Intel RealSense ZR300", 1000));
+
+    auto create_image = [](rs::core::stream_type stream, double timestamp, uint64_t frame)
+    {
+        image_info info = {};
+        rs::core::image_interface::image_data_with_data_releaser image(nullptr, nullptr);
+        return rs::utils::get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, image, stream, image_interface::flag::any,
+                                                                                                       timestamp, frame));
+    };
+
+    //the fisheye stream stalls, color and depth frames keep arriving
+    const unsigned int deadline = 100;
+    for(int frame = 0; frame < 10; frame++)
+    {
+        smart_correlated_sample_set sample_set;
+        ASSERT_FALSE(samples_sync->insert(create_image(stream_type::color, frame * 33.0, frame).get(), sample_set.get()));
+        ASSERT_FALSE(samples_sync->insert(create_image(stream_type::depth, frame * 33.0, frame).get(), sample_set.get()));
+
+        //the frames older than the deadline are removed as partial sets of color and depth
+        smart_correlated_sample_set partial_sample_set;
+        bool is_partial_set_expected = frame * 33 >= static_cast<int>(deadline);
+        ASSERT_EQ(is_partial_set_expected, samples_sync->get_partial_sample_set(deadline, partial_sample_set.get()));
+        if(is_partial_set_expected)
+        {
+            ASSERT_EQ(static_cast<uint64_t>(frame - 4), partial_sample_set.get()[stream_type::color]->query_frame_number());
+            ASSERT_EQ(partial_sample_set.get()[stream_type::color]->query_frame_number(), partial_sample_set.get()[stream_type::depth]->query_frame_number());
+            ASSERT_EQ(nullptr, partial_sample_set.get()[stream_type::fisheye]);
+        }
+    }
+
+    //the fisheye stream resumes, the sets are full again
+    {
+        smart_correlated_sample_set sample_set;
+        ASSERT_TRUE(samples_sync->insert(create_image(stream_type::fisheye, 7 * 33.0, 7).get(), sample_set.get()));
+        ASSERT_EQ(7u, sample_set.get()[stream_type::color]->query_frame_number());
+        ASSERT_EQ(7u, sample_set.get()[stream_type::fisheye]->query_frame_number());
+    }
+}
+
+TEST_F(samples_sync_external_camera_tests, zr300_matched_motions)
+{
+    int streams[static_cast<int>(rs::core::stream_type::max)] = {0};
+    int motions[static_cast<int>(rs::core::motion_type::max)] = {0};
+
+    streams[static_cast<int>(rs::core::stream_type::color)] = 30;
+    streams[static_cast<int>(rs::core::stream_type::depth)] = 30;
+    motions[static_cast<int>(rs::core::motion_type::gyro)] = 200;
+
+    rs::utils::unique_ptr<rs::utils::samples_time_sync_interface> samples_sync = rs::utils::get_unique_ptr_with_releaser(
+        rs::utils::samples_time_sync_interface::create_instance(streams, motions, "Intel RealSense ZR300", 1000));
+
+    auto create_image = [](rs::core::stream_type stream, double timestamp, uint64_t frame)
+    {
+        image_info info = {};
+        rs::core::image_interface::image_data_with_data_releaser image(nullptr, nullptr);
+        return rs::utils::get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, image, stream, image_interface::flag::any,
+                                                                                                       timestamp, frame));
+    };
+
+    //gyro samples every 5 ms, from 0 to 60 ms
+    for(int i = 0; i <= 12; i++)
+    {
+        smart_correlated_sample_set sample_set;
+        rs::core::motion_sample gyro = {motion_type::gyro, i * 5.0, static_cast<uint64_t>(i), {}};
+        ASSERT_FALSE(samples_sync->insert(gyro, sample_set.get()));
+    }
+
+    const rs::core::motion_sample * matched_motions = nullptr;
+    {
+        smart_correlated_sample_set sample_set;
+        ASSERT_FALSE(samples_sync->insert(create_image(stream_type::color, 33, 1).get(), sample_set.get()));
+        ASSERT_TRUE(samples_sync->insert(create_image(stream_type::depth, 33, 1).get(), sample_set.get()));
+        ASSERT_EQ(35, sample_set.get()[motion_type::gyro].timestamp);
+
+        //all the samples up to the closest one to the images
+        ASSERT_EQ(8u, samples_sync->get_matched_motions(motion_type::gyro, &matched_motions));
+        for(int i = 0; i < 8; i++)
+            ASSERT_EQ(i * 5.0, matched_motions[i].timestamp);
+        ASSERT_EQ(0u, samples_sync->get_matched_motions(motion_type::accel, &matched_motions));
+        ASSERT_EQ(nullptr, matched_motions);
+
+        //the sample set refers to the same batches
+        const rs::core::motion_sample * batch = nullptr;
+        ASSERT_EQ(8u, sample_set.get().get_motion_batch(motion_type::gyro, &batch));
+        ASSERT_EQ(0.0, batch[0].timestamp);
+        ASSERT_EQ(35.0, batch[7].timestamp);
+        ASSERT_EQ(0u, sample_set.get().get_motion_batch(motion_type::accel, &batch));
+        ASSERT_EQ(nullptr, batch);
+    }
+
+    {
+        smart_correlated_sample_set sample_set;
+        ASSERT_FALSE(samples_sync->insert(create_image(stream_type::color, 66, 2).get(), sample_set.get()));
+        ASSERT_TRUE(samples_sync->insert(create_image(stream_type::depth, 66, 2).get(), sample_set.get()));
+        ASSERT_EQ(60, sample_set.get()[motion_type::gyro].timestamp);
+
+        //the samples since the previous set
+        ASSERT_EQ(5u, samples_sync->get_matched_motions(motion_type::gyro, &matched_motions));
+        ASSERT_EQ(40, matched_motions[0].timestamp);
+        ASSERT_EQ(60, matched_motions[4].timestamp);
+    }
+
+    samples_sync->flush();
+    ASSERT_EQ(0u, samples_sync->get_matched_motions(motion_type::gyro, &matched_motions));
+}
+
+TEST_F(samples_sync_external_camera_tests, matched_motions_of_each_thread)
+{
+    int streams[static_cast<int>(rs::core::stream_type::max)] = {0};
+    int motions[static_cast<int>(rs::core::motion_type::max)] = {0};
+
+    streams[static_cast<int>(rs::core::stream_type::color)] = 30;
+    streams[static_cast<int>(rs::core::stream_type::depth)] = 30;
+    motions[static_cast<int>(rs::core::motion_type::gyro)] = 200;
+
+    rs::utils::unique_ptr<rs::utils::samples_time_sync_interface> samples_sync = rs::utils::get_unique_ptr_with_releaser(
+        rs::utils::samples_time_sync_interface::create_instance(streams, motions, "Intel RealSense ZR300", 1000));
+
+    auto create_image = [](rs::core::stream_type stream, double timestamp, uint64_t frame)
+    {
+        image_info info = {};
+        rs::core::image_interface::image_data_with_data_releaser image(nullptr, nullptr);
+        return rs::utils::get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, image, stream, image_interface::flag::any,
+                                                                                                       timestamp, frame));
+    };
+
+    //gyro samples every 5 ms, from 0 to 60 ms
+    for(int i = 0; i <= 12; i++)
+    {
+        smart_correlated_sample_set sample_set;
+        rs::core::motion_sample gyro = {motion_type::gyro, i * 5.0, static_cast<uint64_t>(i), {}};
+        ASSERT_FALSE(samples_sync->insert(gyro, sample_set.get()));
+    }
+
+    smart_correlated_sample_set sample_set;
+    ASSERT_FALSE(samples_sync->insert(create_image(stream_type::color, 33, 1).get(), sample_set.get()));
+    ASSERT_TRUE(samples_sync->insert(create_image(stream_type::depth, 33, 1).get(), sample_set.get()));
+
+    //another thread gets the next set, with the samples since this set
+    std::thread other_thread([&]()
+    {
+        smart_correlated_sample_set other_sample_set;
+        samples_sync->insert(create_image(stream_type::color, 66, 2).get(), other_sample_set.get());
+        ASSERT_TRUE(samples_sync->insert(create_image(stream_type::depth, 66, 2).get(), other_sample_set.get()));
+        const rs::core::motion_sample * other_motions = nullptr;
+        ASSERT_EQ(5u, samples_sync->get_matched_motions(motion_type::gyro, &other_motions));
+        ASSERT_EQ(40, other_motions[0].timestamp);
+    });
+    other_thread.join();
+
+    //the motions returned to this thread aren't overwritten by the set of the other thread
+    const rs::core::motion_sample * matched_motions = nullptr;
+    ASSERT_EQ(8u, samples_sync->get_matched_motions(motion_type::gyro, &matched_motions));
+    const rs::core::motion_sample * batch = nullptr;
+    ASSERT_EQ(8u, sample_set.get().get_motion_batch(motion_type::gyro, &batch));
+    for(int i = 0; i < 8; i++)
+    {
+        ASSERT_EQ(i * 5.0, matched_motions[i].timestamp);
+        ASSERT_EQ(i * 5.0, batch[i].timestamp);
+    }
+}
+
+TEST_F(samples_sync_external_camera_tests, adaptive_latency)
+{
+    int streams[static_cast<int>(rs::core::stream_type::max)] = {0};
+    int motions[static_cast<int>(rs::core::motion_type::max)] = {0};
+
+    streams[static_cast<int>(rs::core::stream_type::color)] = 30;
+    streams[static_cast<int>(rs::core::stream_type::depth)] = 30;
+
+    const unsigned int max_input_latency = 1000;
+    const unsigned int min_input_latency = 50;
+    rs::utils::unique_ptr<rs::utils::samples_time_sync_interface> samples_sync = rs::utils::get_unique_ptr_with_releaser(
+        rs::utils::samples_time_sync_interface::create_instance(streams, motions, "Intel RealSense ZR300", max_input_latency, 10));
+    ASSERT_EQ(max_input_latency, samples_sync->query_input_latency());
+    samples_sync->set_adaptive_latency(min_input_latency);
+
+    auto create_image = [](rs::core::stream_type stream, uint64_t frame)
+    {
+        image_info info = {};
+        rs::core::image_interface::image_data_with_data_releaser image(nullptr, nullptr);
+        return rs::utils::get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, image, stream, image_interface::flag::any,
+                                                                                                       static_cast<double>(frame) * 1000.0 / 30, frame));
+    };
+
+    //the streams arrive together, the latency decays to the minimum
+    uint64_t frame = 0;
+    for(; frame < 1000; frame++)
+    {
+        smart_correlated_sample_set sample_set;
+        ASSERT_FALSE(samples_sync->insert(create_image(stream_type::color, frame).get(), sample_set.get()));
+        ASSERT_TRUE(samples_sync->insert(create_image(stream_type::depth, frame).get(), sample_set.get()));
+        ASSERT_EQ(frame, sample_set.get()[stream_type::depth]->query_frame_number());
+    }
+    ASSERT_EQ(min_input_latency, samples_sync->query_input_latency());
+
+    //the depth stream lags by 3 frames, the color frames buffered before the lag was measured are dropped,
+    //the latency follows the lag at once and the next frames are matched
+    const uint64_t depth_lag = 3;
+    for(uint64_t lagged = frame; lagged < frame + 100; lagged++)
+    {
+        smart_correlated_sample_set sample_set;
+        ASSERT_FALSE(samples_sync->insert(create_image(stream_type::color, lagged).get(), sample_set.get()));
+        if(lagged < frame + depth_lag)
+            continue;
+        bool matched = samples_sync->insert(create_image(stream_type::depth, lagged - depth_lag).get(), sample_set.get());
+        if(lagged < frame + 2 * depth_lag)
+            continue;
+        ASSERT_TRUE(matched);
+        ASSERT_EQ(lagged - depth_lag, sample_set.get()[stream_type::color]->query_frame_number());
+        ASSERT_GT(samples_sync->query_input_latency(), depth_lag * 1000 / 30);
+    }
+    samples_sync->flush();
+
+    //the adaptive mode is disabled, the buffers are sized by the max latency again
+    samples_sync->set_adaptive_latency(0);
+    ASSERT_EQ(max_input_latency, samples_sync->query_input_latency());
+}
+
+TEST_F(samples_sync_external_camera_tests, zr300_sync_of_lagging_stream)
+{
+    int streams[static_cast<int>(rs::core::stream_type::max)] = {0};
+    int motions[static_cast<int>(rs::core::motion_type::max)] = {0};
+
+    const int fps = 60;
+    const std::vector<rs::core::stream_type> streams_types = {stream_type::color, stream_type::depth, stream_type::infrared, stream_type::infrared2};
+    for(auto stream : streams_types)
+        streams[static_cast<int>(stream)] = fps;
+    streams[static_cast<int>(rs::core::stream_type::fisheye)] = fps;
+    motions[static_cast<int>(rs::core::motion_type::gyro)] = 200;
+    motions[static_cast<int>(rs::core::motion_type::accel)] = 200;
+
+    const unsigned int max_input_latency = 1000;
+    rs::utils::unique_ptr<rs::utils::samples_time_sync_interface> samples_sync = rs::utils::get_unique_ptr_with_releaser(
+        rs::utils::samples_time_sync_interface::create_instance(streams, motions, "Intel RealSense ZR300", max_input_latency));
+
+    auto create_image = [](rs::core::stream_type stream, int frame)
+    {
+        image_info info = {};
+        rs::core::image_interface::image_data_with_data_releaser image(nullptr, nullptr);
+        return rs::utils::get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, image, stream, image_interface::flag::any,
+                                                                                                       frame * 1000.0 / fps, static_cast<uint64_t>(frame)));
+    };
+
+    //the depth stream lags half of the buffer behind the other streams, and drops every 10th frame,
+    //each depth frame completes the set of its frame number, the frames of the dropped depth frames are never matched
+    const int frames_count = 3000;
+    const int depth_lag = fps * max_input_latency / 1000 / 2;
+    int sets_count = 0;
+    for(int frame = 0; frame < frames_count + depth_lag; frame++)
+    {
+        auto insert = [&](rs::core::image_interface * image, rs::core::motion_sample * motion)
+        {
+            smart_correlated_sample_set sample_set;
+            bool matched = image ? samples_sync->insert(image, sample_set.get()) : samples_sync->insert(*motion, sample_set.get());
+            if(!matched)
+                return;
+            ASSERT_EQ(stream_type::depth, image->query_stream_type());
+            const uint64_t depth_frame = image->query_frame_number();
+            ASSERT_EQ(depth_frame, static_cast<uint64_t>(sets_count + sets_count / 9));
+            for(auto stream : {stream_type::color, stream_type::infrared, stream_type::infrared2, stream_type::fisheye})
+            {
+                ASSERT_NE(nullptr, sample_set.get()[stream]);
+                ASSERT_EQ(depth_frame, sample_set.get()[stream]->query_frame_number());
+            }
+            sets_count++;
+        };
+
+        for(auto stream : streams_types)
+        {
+            const int stream_frame = stream == stream_type::depth ? frame - depth_lag : frame;
+            if(stream_frame < 0 || stream_frame >= frames_count || (stream == stream_type::depth && stream_frame % 10 == 9))
+                continue;
+            insert(create_image(stream, stream_frame).get(), nullptr);
+        }
+        if(frame < frames_count)
+            insert(create_image(stream_type::fisheye, frame).get(), nullptr);
+        for(int i = 0; i < 3 && frame < frames_count; i++)
+        {
+            rs::core::motion_sample gyro = {motion_type::gyro, (frame + i / 3.0) * 1000.0 / fps, 0, {}};
+            rs::core::motion_sample accel = {motion_type::accel, (frame + i / 3.0) * 1000.0 / fps, 0, {}};
+            insert(nullptr, &gyro);
+            insert(nullptr, &accel);
+        }
+    }
+
+    ASSERT_EQ(frames_count - frames_count / 10, sets_count);
+}
+
 int samples_sync_tests::m_frames_sent=0;
 int samples_sync_tests::m_sets_received=0;
 int samples_sync_tests::m_max_fps=0;
@@ -0,0 +1,103 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "rs/core/image_interface.h"
+#include "rs/utils/smart_ptr_helpers.h"
+#include "rs/utils/shared_memory_image_transport.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+
+namespace
+{
+    const char * SEGMENT_NAME = "/rs_shared_memory_transport_tests";
+    const int WIDTH = 32, HEIGHT = 24;
+
+    image_interface * create_image(vector<uint8_t> & data, uint64_t frame_number)
+    {
+        image_info info = { WIDTH, HEIGHT, pixel_format::y8, WIDTH };
+        data.assign(WIDTH * HEIGHT, static_cast<uint8_t>(frame_number));
+        auto image = image_interface::create_instance_from_raw_data(&info, {data.data(), nullptr}, stream_type::depth,
+                                                                    image_interface::flag::any, 10.0 * static_cast<double>(frame_number), frame_number);
+        float exposure = 5.0f;
+        image->query_metadata()->add_metadata(metadata_type::actual_exposure, reinterpret_cast<uint8_t *>(&exposure), sizeof(exposure));
+        return image;
+    }
+}
+
+GTEST_TEST(shared_memory_transport_tests, received_image_references_the_published_slot)
+{
+    auto publisher = get_unique_ptr_with_releaser(shared_memory_image_publisher_interface::create_instance(SEGMENT_NAME, 2, WIDTH * HEIGHT));
+    ASSERT_NE(nullptr, publisher);
+    auto subscriber = get_unique_ptr_with_releaser(shared_memory_image_subscriber_interface::create_instance(SEGMENT_NAME));
+    ASSERT_NE(nullptr, subscriber);
+    EXPECT_EQ(nullptr, subscriber->receive());
+
+    vector<uint8_t> data;
+    auto image = get_unique_ptr_with_releaser(create_image(data, 1));
+    ASSERT_TRUE(publisher->publish(image.get()));
+
+    uint32_t skipped = 1;
+    auto received = get_unique_ptr_with_releaser(subscriber->receive(&skipped));
+    ASSERT_NE(nullptr, received);
+    EXPECT_EQ(0u, skipped);
+    EXPECT_NE(image->query_data(), received->query_data());
+    EXPECT_EQ(WIDTH, received->query_info().width);
+    EXPECT_EQ(stream_type::depth, received->query_stream_type());
+    EXPECT_EQ(1u, received->query_frame_number());
+    EXPECT_DOUBLE_EQ(10.0, received->query_time_stamp());
+    EXPECT_EQ(1, static_cast<const uint8_t *>(received->query_data())[WIDTH * HEIGHT - 1]);
+    float exposure = 0;
+    ASSERT_TRUE(received->query_metadata()->is_metadata_available(metadata_type::actual_exposure));
+    received->query_metadata()->get_metadata(metadata_type::actual_exposure, reinterpret_cast<uint8_t *>(&exposure));
+    EXPECT_FLOAT_EQ(5.0f, exposure);
+    EXPECT_EQ(nullptr, subscriber->receive());
+
+    //the slot of the third image is held by the received image, so it's dropped until the image is released
+    auto second = get_unique_ptr_with_releaser(create_image(data, 2));
+    auto third = get_unique_ptr_with_releaser(create_image(data, 3));
+    EXPECT_TRUE(publisher->publish(second.get()));
+    EXPECT_FALSE(publisher->publish(third.get()));
+    received.reset();
+    EXPECT_TRUE(publisher->publish(third.get()));
+
+    auto received_second = get_unique_ptr_with_releaser(subscriber->receive());
+    ASSERT_NE(nullptr, received_second);
+    EXPECT_EQ(2u, received_second->query_frame_number());
+}
+
+GTEST_TEST(shared_memory_transport_tests, slow_subscriber_skips_overwritten_images)
+{
+    auto publisher = get_unique_ptr_with_releaser(shared_memory_image_publisher_interface::create_instance(SEGMENT_NAME, 3, WIDTH * HEIGHT));
+    ASSERT_NE(nullptr, publisher);
+    auto subscriber = get_unique_ptr_with_releaser(shared_memory_image_subscriber_interface::create_instance(SEGMENT_NAME));
+    ASSERT_NE(nullptr, subscriber);
+
+    vector<uint8_t> data;
+    for(uint64_t frame_number = 1; frame_number <= 5; frame_number++)
+    {
+        auto image = get_unique_ptr_with_releaser(create_image(data, frame_number));
+        ASSERT_TRUE(publisher->publish(image.get()));
+    }
+
+    uint32_t skipped = 0;
+    auto received = get_unique_ptr_with_releaser(subscriber->receive(&skipped));
+    ASSERT_NE(nullptr, received);
+    EXPECT_EQ(2u, skipped);
+    EXPECT_EQ(3u, received->query_frame_number());
+
+    //an image larger than the slot isn't published
+    image_info large_info = { WIDTH * 2, HEIGHT, pixel_format::y8, WIDTH * 2 };
+    vector<uint8_t> large_data(WIDTH * 2 * HEIGHT);
+    auto large = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&large_info, {large_data.data(), nullptr},
+                                                  stream_type::depth, image_interface::flag::any, 0, 6));
+    EXPECT_FALSE(publisher->publish(large.get()));
+}
+
+GTEST_TEST(shared_memory_transport_tests, subscriber_fails_without_publisher)
+{
+    EXPECT_EQ(nullptr, shared_memory_image_subscriber_interface::create_instance(SEGMENT_NAME));
+}
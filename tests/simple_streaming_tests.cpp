@@ -26,6 +26,17 @@ GTEST_TEST(StreamingTests, device_details)
     std::cout << "Motion Module Firmware Version : " << device->get_info(rs::camera_info::motion_module_firmware_version) << std::endl;
 }
 
+GTEST_TEST(StreamingTests, concurrent_contexts_share_the_devices_enumeration)
+{
+    rs::core::context first_context;
+    ASSERT_NE(first_context.get_device_count(), 0) << "No camera is connected";
+
+    //the devices weren't connected or disconnected, the enumeration of the live context is shared by the registry
+    rs::core::context context;
+    ASSERT_NE(context.get_device_count(), 0) << "No camera is connected";
+    EXPECT_EQ(first_context.get_device(0), context.get_device(0));
+}
+
 GTEST_TEST(StreamingTests, basic_streaming_sync)
 {
     rs::core::context context;
@@ -0,0 +1,149 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "rs/synthetic/synthetic_context.h"
+#include "rs/synthetic/synthetic_device.h"
+
+using namespace std;
+using namespace rs::synthetic;
+
+namespace
+{
+    vector<double> collect_timestamps(device_configuration configuration, size_t frames_count)
+    {
+        configuration.real_time = false;
+        context ctx(configuration);
+        auto device = ctx.get_synthetic_device();
+        device->enable_stream(rs::stream::depth, 480, 360, rs::format::z16, 30);
+        vector<double> timestamps;
+        mutex timestamps_mutex;
+        device->set_frame_callback(rs::stream::depth, [&](rs::frame frame)
+        {
+            lock_guard<mutex> guard(timestamps_mutex);
+            if(timestamps.size() < frames_count)
+                timestamps.push_back(frame.get_timestamp());
+        });
+        device->start();
+        while(true)
+        {
+            {
+                lock_guard<mutex> guard(timestamps_mutex);
+                if(timestamps.size() == frames_count)
+                    break;
+            }
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        device->stop();
+        return timestamps;
+    }
+}
+
+TEST(synthetic_device_tests, advertises_configured_modes)
+{
+    device_configuration configuration;
+    configuration.modes.clear();
+    configuration.modes[rs::stream::depth] = { {320, 240, rs::format::z16, 90} };
+    context ctx(configuration);
+    ASSERT_EQ(1, ctx.get_device_count());
+    auto device = ctx.get_device(0);
+    ASSERT_EQ(1, device->get_stream_mode_count(rs::stream::depth));
+    ASSERT_EQ(0, device->get_stream_mode_count(rs::stream::color));
+    int width, height, fps;
+    rs::format format;
+    device->get_stream_mode(rs::stream::depth, 0, width, height, format, fps);
+    EXPECT_EQ(320, width);
+    EXPECT_EQ(240, height);
+    EXPECT_EQ(rs::format::z16, format);
+    EXPECT_EQ(90, fps);
+    EXPECT_THROW(device->enable_stream(rs::stream::depth, 640, 480, rs::format::z16, 30), rs::error);
+    EXPECT_THROW(device->enable_stream(rs::stream::color, 640, 480, rs::format::rgb8, 30), rs::error);
+}
+
+TEST(synthetic_device_tests, same_seed_reproduces_timestamps)
+{
+    device_configuration configuration;
+    configuration.max_jitter = 5;
+    configuration.seed = 7;
+    auto first = collect_timestamps(configuration, 50);
+    auto second = collect_timestamps(configuration, 50);
+    EXPECT_EQ(first, second);
+
+    for(size_t i = 0; i < first.size(); i++)
+    {
+        auto nominal = static_cast<double>(i) * 1000.0 / 30;
+        EXPECT_LE(abs(first[i] - nominal), configuration.max_jitter);
+    }
+
+    configuration.seed = 8;
+    EXPECT_NE(first, collect_timestamps(configuration, 50));
+}
+
+TEST(synthetic_device_tests, slow_callback_drops_frames)
+{
+    context ctx;
+    auto device = ctx.get_synthetic_device();
+    device->enable_stream(rs::stream::depth, 480, 360, rs::format::z16, 60);
+    atomic<uint64_t> delivered(0);
+    device->set_frame_callback(rs::stream::depth, [&](rs::frame frame)
+    {
+        delivered++;
+        this_thread::sleep_for(chrono::milliseconds(50));
+    });
+    device->start();
+    this_thread::sleep_for(chrono::milliseconds(500));
+    device->stop();
+
+    auto generated = device->get_generated_frames_count(rs::stream::depth);
+    auto dropped = device->get_dropped_frames_count(rs::stream::depth);
+    EXPECT_GT(dropped, 0u);
+    EXPECT_EQ(generated, delivered.load() + dropped);
+    EXPECT_EQ(dropped, static_cast<uint64_t>(device->get_option(rs::option::total_frame_drops)));
+}
+
+TEST(synthetic_device_tests, wait_for_frames_returns_all_streams)
+{
+    context ctx;
+    auto device = ctx.get_synthetic_device();
+    ASSERT_TRUE(device->set_real_time(false));
+    device->enable_stream(rs::stream::depth, 480, 360, rs::format::z16, 30);
+    device->enable_stream(rs::stream::color, 640, 480, rs::format::rgb8, 30);
+    device->start();
+    for(uint64_t i = 1; i <= 10; i++)
+    {
+        device->wait_for_frames();
+        EXPECT_EQ(i, device->get_frame_number(rs::stream::depth));
+        EXPECT_EQ(i, device->get_frame_number(rs::stream::color));
+        EXPECT_NE(nullptr, device->get_frame_data(rs::stream::color));
+    }
+    EXPECT_FALSE(device->set_real_time(true));
+    device->stop();
+    EXPECT_EQ(0u, device->get_dropped_frames_count(rs::stream::depth));
+}
+
+TEST(synthetic_device_tests, motion_samples_are_generated)
+{
+    device_configuration configuration;
+    configuration.motion_rate = 100;
+    context ctx(configuration);
+    auto device = ctx.get_synthetic_device();
+    ASSERT_TRUE(device->supports(rs::capabilities::motion_events));
+    atomic<int> accel_count(0), gyro_count(0);
+    device->enable_motion_tracking([&](rs::motion_data data)
+    {
+        if(data.timestamp_data.source_id == RS_EVENT_IMU_ACCEL) accel_count++;
+        if(data.timestamp_data.source_id == RS_EVENT_IMU_GYRO) gyro_count++;
+    });
+    device->start(rs::source::motion_data);
+    this_thread::sleep_for(chrono::milliseconds(300));
+    device->stop(rs::source::motion_data);
+    EXPECT_GT(accel_count.load(), 10);
+    EXPECT_EQ(accel_count.load(), gyro_count.load());
+}